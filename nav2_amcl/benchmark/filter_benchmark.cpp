@@ -0,0 +1,274 @@
+// Copyright (c) 2019 Samsung Research America
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <benchmark/benchmark.h>
+#include <stdlib.h>
+
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <memory>
+#include <random>
+#include <vector>
+
+#include "nav2_amcl/angleutils.hpp"
+#include "nav2_amcl/map/map.hpp"
+#include "nav2_amcl/motion_model/differential_motion_model.hpp"
+#include "nav2_amcl/pf/pf.hpp"
+#include "nav2_amcl/sensors/laser/laser.hpp"
+
+// Offline replay of the AMCL filter pipeline: odometry, laser update, resampling and
+// cluster statistics, as run by AmclNode::laserReceived for each scan that moves
+// the robot past the update thresholds. The log and the filter draw from fixed
+// seeds, so that runs of two builds are comparable.
+
+namespace
+{
+
+constexpr unsigned int LOG_SEED = 42;
+constexpr long FILTER_SEED = 7;  // NOLINT
+
+struct LogEntry
+{
+  pf_vector_t odom_pose;
+  pf_vector_t true_pose;
+  std::vector<double> ranges;
+};
+
+struct ReplayLog
+{
+  map_t * map;
+  double angle_min;
+  double angle_increment;
+  double range_max;
+  std::vector<LogEntry> entries;
+};
+
+// A 20m x 20m floor with a few rooms and pillars, at 5cm
+map_t * makeMap()
+{
+  map_t * map = map_alloc();
+  map->size_x = 400;
+  map->size_y = 400;
+  map->scale = 0.05;
+  map->origin_x = (map->size_x / 2) * map->scale;
+  map->origin_y = (map->size_y / 2) * map->scale;
+  map->cells =
+    reinterpret_cast<map_cell_t *>(malloc(sizeof(map_cell_t) * map->size_x * map->size_y));
+
+  for (int y = 0; y < map->size_y; y++) {
+    for (int x = 0; x < map->size_x; x++) {
+      const bool border = x < 2 || y < 2 || x >= map->size_x - 2 || y >= map->size_y - 2;
+      const bool wall = (x == 130 && (y < 150 || y > 190)) || (y == 270 && (x < 220 || x > 260));
+      const bool pillar = (x % 80 > 68 && y % 80 > 68 && x > 150 && y > 20 && y < 250);
+      map->cells[MAP_INDEX(map, x, y)].occ_state = (border || wall || pillar) ? +1 : -1;
+    }
+  }
+  return map;
+}
+
+// A loop through the rooms, the odometry drifting from the true poses, each scan
+// cast from the true pose on the map with noisy ranges
+const ReplayLog & getLog()
+{
+  static ReplayLog log = [] {
+      ReplayLog log;
+      log.map = makeMap();
+      log.angle_min = -0.75 * M_PI;
+      log.angle_increment = 1.5 * M_PI / 540;
+      log.range_max = 12.0;
+
+      std::mt19937 generator(LOG_SEED);
+      std::normal_distribution<double> range_noise(0.0, 0.02);
+      std::normal_distribution<double> odom_noise(0.0, 0.01);
+
+      const double waypoints[][2] = {{3.0, 3.0}, {17.0, 3.0}, {17.0, 17.0}, {3.0, 17.0},
+        {3.0, 3.0}};
+      const double step = 0.2;
+      pf_vector_t odom = pf_vector_zero();
+      pf_vector_t last_true = pf_vector_zero();
+      bool first = true;
+      for (int w = 0; w + 1 < 5; w++) {
+        const double dx = waypoints[w + 1][0] - waypoints[w][0];
+        const double dy = waypoints[w + 1][1] - waypoints[w][1];
+        const int steps = static_cast<int>(std::hypot(dx, dy) / step);
+        for (int i = 0; i < steps; i++) {
+          LogEntry entry;
+          entry.true_pose.v[0] = waypoints[w][0] + dx * i / steps;
+          entry.true_pose.v[1] = waypoints[w][1] + dy * i / steps;
+          entry.true_pose.v[2] = atan2(dy, dx);
+
+          if (first) {
+            odom = entry.true_pose;
+            first = false;
+          } else {
+            // Relative motion in the previous robot frame, with noise, applied to the odometry
+            const double c = cos(last_true.v[2]);
+            const double s = sin(last_true.v[2]);
+            const double gx = entry.true_pose.v[0] - last_true.v[0];
+            const double gy = entry.true_pose.v[1] - last_true.v[1];
+            const double lx = c * gx + s * gy + odom_noise(generator);
+            const double ly = -s * gx + c * gy + odom_noise(generator);
+            const double la = nav2_amcl::angleutils::angle_diff(
+              entry.true_pose.v[2], last_true.v[2]) + odom_noise(generator);
+            odom.v[0] += cos(odom.v[2]) * lx - sin(odom.v[2]) * ly;
+            odom.v[1] += sin(odom.v[2]) * lx + cos(odom.v[2]) * ly;
+            odom.v[2] = nav2_amcl::angleutils::normalize(odom.v[2] + la);
+          }
+          entry.odom_pose = odom;
+          last_true = entry.true_pose;
+
+          entry.ranges.resize(540);
+          for (size_t j = 0; j < entry.ranges.size(); j++) {
+            const double range = map_calc_range(
+              log.map, entry.true_pose.v[0], entry.true_pose.v[1],
+              entry.true_pose.v[2] + log.angle_min + j * log.angle_increment, log.range_max);
+            entry.ranges[j] = range < log.range_max ?
+              std::max(range + range_noise(generator), 0.0) : log.range_max;
+          }
+          log.entries.push_back(std::move(entry));
+        }
+      }
+      return log;
+    }();
+  return log;
+}
+
+pf_vector_t uniformPoseGenerator(void * arg)
+{
+  map_t * map = reinterpret_cast<map_t *>(arg);
+  int x, y;
+  do {
+    x = static_cast<int>(drand48() * map->size_x);
+    y = static_cast<int>(drand48() * map->size_y);
+  } while (map->cells[MAP_INDEX(map, x, y)].occ_state != -1);
+
+  pf_vector_t p;
+  p.v[0] = MAP_WXGX(map, x);
+  p.v[1] = MAP_WYGY(map, y);
+  p.v[2] = drand48() * 2 * M_PI - M_PI;
+  return p;
+}
+
+double elapsedMs(const std::chrono::steady_clock::time_point & start)
+{
+  return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start)
+         .count();
+}
+
+}  // namespace
+
+// Arguments: particle count, beam count, sensor update threads
+static void BM_FilterReplay(benchmark::State & state)
+{
+  const int particles = static_cast<int>(state.range(0));
+  const int beams = static_cast<int>(state.range(1));
+  const unsigned int threads = static_cast<unsigned int>(state.range(2));
+  const ReplayLog & log = getLog();
+
+  nav2_amcl::DifferentialMotionModel motion_model;
+  motion_model.initialize(0.2, 0.2, 0.2, 0.2, 0.2);
+  nav2_amcl::LikelihoodFieldModel laser(0.5, 0.5, 0.2, 2.0, beams, log.map);
+  pf_vector_t laser_pose = pf_vector_zero();
+  laser.SetLaserPose(laser_pose);
+  laser.setNumThreads(threads);
+
+  double motion_ms = 0.0, sensor_ms = 0.0, resample_ms = 0.0, cluster_ms = 0.0;
+  double error = 0.0;
+  int updates = 0;
+  for (auto _ : state) {
+    srand48(FILTER_SEED);
+    pf_t * pf = pf_alloc(particles, particles, 0.0, 0.0, uniformPoseGenerator);
+    pf->pop_err = 0.01;
+    pf->pop_z = 0.99;
+    pf_matrix_t cov = pf_matrix_zero();
+    cov.m[0][0] = 0.25;
+    cov.m[1][1] = 0.25;
+    cov.m[2][2] = 0.07;
+    pf_init(pf, log.entries.front().true_pose, cov);
+
+    pf_vector_t pf_odom_pose = log.entries.front().odom_pose;
+    pf_vector_t mean = pf_vector_zero();
+    for (size_t i = 1; i < log.entries.size(); i++) {
+      const LogEntry & entry = log.entries[i];
+      pf_vector_t delta;
+      delta.v[0] = entry.odom_pose.v[0] - pf_odom_pose.v[0];
+      delta.v[1] = entry.odom_pose.v[1] - pf_odom_pose.v[1];
+      delta.v[2] = nav2_amcl::angleutils::angle_diff(entry.odom_pose.v[2], pf_odom_pose.v[2]);
+
+      auto start = std::chrono::steady_clock::now();
+      motion_model.odometryUpdate(pf, entry.odom_pose, delta);
+      motion_ms += elapsedMs(start);
+      pf_odom_pose = entry.odom_pose;
+
+      nav2_amcl::LaserData ldata;
+      ldata.laser = &laser;
+      ldata.range_count = static_cast<int>(entry.ranges.size());
+      ldata.range_max = log.range_max;
+      ldata.ranges = new double[ldata.range_count][2];
+      for (int j = 0; j < ldata.range_count; j++) {
+        ldata.ranges[j][0] = entry.ranges[j];
+        ldata.ranges[j][1] = log.angle_min + j * log.angle_increment;
+      }
+      start = std::chrono::steady_clock::now();
+      laser.sensorUpdate(pf, &ldata);
+      sensor_ms += elapsedMs(start);
+
+      // Resampling computes the cluster statistics of the new set too
+      start = std::chrono::steady_clock::now();
+      pf_update_resample(pf, reinterpret_cast<void *>(log.map));
+      resample_ms += elapsedMs(start);
+
+      start = std::chrono::steady_clock::now();
+      pf_cluster_stats(pf, pf->sets + pf->current_set);
+      double max_weight = -1.0;
+      for (int hyp = 0; ; hyp++) {
+        double weight;
+        pf_vector_t hyp_mean;
+        pf_matrix_t hyp_cov;
+        if (!pf_get_cluster_stats(pf, hyp, &weight, &hyp_mean, &hyp_cov)) {
+          break;
+        }
+        if (weight > max_weight) {
+          max_weight = weight;
+          mean = hyp_mean;
+        }
+      }
+      pf_update_converged(pf);
+      cluster_ms += elapsedMs(start);
+      updates++;
+    }
+
+    const pf_vector_t & truth = log.entries.back().true_pose;
+    error += std::hypot(mean.v[0] - truth.v[0], mean.v[1] - truth.v[1]);
+    pf_free(pf);
+  }
+
+  // Mean times of a filter update, and the final position error for regressions
+  state.counters["motion_ms"] = benchmark::Counter(motion_ms / std::max(updates, 1));
+  state.counters["sensor_ms"] = benchmark::Counter(sensor_ms / std::max(updates, 1));
+  state.counters["resample_ms"] = benchmark::Counter(resample_ms / std::max(updates, 1));
+  state.counters["cluster_ms"] = benchmark::Counter(cluster_ms / std::max(updates, 1));
+  state.counters["error_m"] = benchmark::Counter(error, benchmark::Counter::kAvgIterations);
+}
+
+BENCHMARK(BM_FilterReplay)
+->ArgsProduct({{500, 2000, 8000, 32000}, {30, 60, 120}, {1}})
+->Unit(benchmark::kMillisecond);
+
+BENCHMARK(BM_FilterReplay)
+->ArgsProduct({{8000, 32000}, {60}, {2, 4}})
+->Unit(benchmark::kMillisecond);
+
+BENCHMARK_MAIN();
@@ -31,6 +31,7 @@
 #include "geometry_msgs/msg/pose_stamped.hpp"
 #include "message_filters/subscriber.h"
 #include "nav2_util/lifecycle_node.hpp"
+#include "nav2_amcl/global_scan_matcher.hpp"
 #include "nav2_amcl/motion_model/motion_model.hpp"
 #include "nav2_amcl/sensors/laser/laser.hpp"
 #include "nav2_msgs/msg/particle.hpp"
@@ -125,7 +126,7 @@ protected:
    * @brief Get new map from ROS topic to localize in
    * @param msg Map message
    */
-  void mapReceived(const nav_msgs::msg::OccupancyGrid::SharedPtr msg);
+  void mapReceived(const nav_msgs::msg::OccupancyGrid::ConstSharedPtr msg);
   /*
    * @brief Handle a new map message
    * @param msg Map message
@@ -140,6 +141,8 @@ protected:
    */
   void freeMapDependentMemory();
   map_t * map_{nullptr};
+  // Range table of the map for the beam model, if enabled
+  std::shared_ptr<nav2_amcl::RangeTable> range_table_;
   /*
    * @brief Convert an occupancy grid map to an AMCL map
    * @param map_msg Map message
@@ -152,8 +155,8 @@ protected:
   std::recursive_mutex mutex_;
   rclcpp::Subscription<nav_msgs::msg::OccupancyGrid>::ConstSharedPtr map_sub_;
 #if NEW_UNIFORM_SAMPLING
-  struct Point2D { int32_t x; int32_t y; };
-  static std::vector<Point2D> free_space_indices;
+  // Map indices of the free cells, half the size of their coordinates on large maps
+  static std::vector<uint32_t> free_space_indices;
 #endif
 
   // Transforms
@@ -266,6 +269,16 @@ protected:
    * @brief Pose-generating function used to uniformly distribute particles over the map
    */
   static pf_vector_t uniformPoseGenerator(void * arg);
+  /*
+   * @brief Pose-generating function used to distribute particles around scan match candidates
+   * @param arg Vector of the nav2_amcl::GlobalScanMatcher::Candidate to sample around
+   */
+  static pf_vector_t candidatePoseGenerator(void * arg);
+  /*
+   * @brief Initialize the particles around the best poses of the latest scan on the whole map
+   * @return False if there is no scan to match or no pose matched well enough
+   */
+  bool initFromScanMatch();
   pf_t * pf_{nullptr};
   bool pf_init_;
   pf_vector_t pf_odom_pose_;
@@ -285,6 +298,9 @@ protected:
   std::vector<bool> lasers_update_;
   std::map<std::string, int> frame_to_laser_;
   rclcpp::Time last_laser_received_ts_;
+  // Latest scan of each laser and the model of their fused updates, see updateFilterFused
+  std::vector<sensor_msgs::msg::LaserScan::ConstSharedPtr> latest_scans_;
+  std::unique_ptr<nav2_amcl::Laser> fused_laser_;
 
   /*
    * @brief Check if sufficient time has elapsed to get an update
@@ -310,6 +326,28 @@ protected:
     const int & laser_index,
     const sensor_msgs::msg::LaserScan::ConstSharedPtr & laser_scan,
     const pf_vector_t & pose);
+  /*
+   * @brief Update the PF once with the latest scans of all the lasers. Their beam
+   * endpoints are moved to the robot frame at the time of the triggering scan, using
+   * the odometry between the scans, and evaluated as a single scan from the robot
+   * @param laser_scan Scan triggering the update
+   * @param pose Odometry pose of the robot at the time of this scan
+   */
+  bool updateFilterFused(
+    const sensor_msgs::msg::LaserScan::ConstSharedPtr & laser_scan,
+    const pf_vector_t & pose);
+  /*
+   * @brief Convert a scan to laser data, with the bearings in the robot frame and
+   * the range limits applied
+   * @param laser_index Index of the laser of the scan, for logging
+   * @param laser_scan Scan to convert
+   * @param ldata Laser data to fill
+   * @return False if the scan could not be converted
+   */
+  bool convertScan(
+    const int & laser_index,
+    const sensor_msgs::msg::LaserScan::ConstSharedPtr & laser_scan,
+    nav2_amcl::LaserData & ldata);
   /*
    * @brief Publish particle cloud
    */
@@ -371,6 +409,23 @@ protected:
   double laser_min_range_;
   std::string sensor_model_type_;
   int max_beams_;
+  int sensor_threads_;
+  int motion_threads_;
+  int min_beams_;
+  bool fuse_lasers_;
+  double particle_cloud_max_rate_;
+  int particle_cloud_max_particles_;
+  bool particle_cloud_clusters_;
+  rclcpp::Time last_particle_cloud_time_{0, 0, RCL_ROS_TIME};
+  bool scan_match_global_localization_;
+  double scan_match_min_score_;
+  int scan_match_hypotheses_;
+  double fuse_lasers_tolerance_;
+  bool use_likelihood_table_;
+  bool beam_range_table_;
+  int beam_range_table_headings_;
+  std::string beam_range_table_file_;
+  std::string map_cache_directory_;
   int max_particles_;
   int min_particles_;
   std::string odom_frame_id_;
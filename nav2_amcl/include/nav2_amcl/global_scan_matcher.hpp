@@ -0,0 +1,102 @@
+// Copyright (c) 2019 Samsung Research America
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef NAV2_AMCL__GLOBAL_SCAN_MATCHER_HPP_
+#define NAV2_AMCL__GLOBAL_SCAN_MATCHER_HPP_
+
+#include <array>
+#include <cstdint>
+#include <vector>
+
+#include "nav2_amcl/map/map.hpp"
+#include "nav2_amcl/pf/pf_vector.hpp"
+
+namespace nav2_amcl
+{
+
+/**
+ * @class nav2_amcl::GlobalScanMatcher
+ * @brief Search of the poses of a scan over a whole map, by a branch and bound
+ * correlative scan match (Hess et al., Real-Time Loop Closure in 2D LIDAR SLAM).
+ * The endpoints are scored on the likelihood field of the map, and the bound of
+ * a square of translations is their score on a grid max-pooled over the square,
+ * so most of the map is pruned at coarse resolutions.
+ */
+class GlobalScanMatcher
+{
+public:
+  /**
+   * @struct Candidate
+   * @brief A pose of the scan and its score
+   */
+  struct Candidate
+  {
+    pf_vector_t pose;
+    // Mean likelihood of the endpoints, in [0, 1]
+    double score;
+  };
+
+  /**
+   * @brief A constructor for nav2_amcl::GlobalScanMatcher
+   * @param map Map to match on, with its cspace distances computed
+   * @param sigma_hit Standard deviation (m) of the endpoints around the obstacles
+   * @param depth Number of coarser resolutions, a square of 2^depth cells at the coarsest
+   */
+  GlobalScanMatcher(const map_t * map, double sigma_hit, int depth = 7);
+
+  /**
+   * @brief Find the best distinct poses of a scan on the map
+   * @param points Scan endpoints (m), in the robot frame
+   * @param min_score Lowest score of a candidate
+   * @param max_candidates Most candidates returned
+   * @return Candidates by decreasing score, poses of the robot in the map frame
+   */
+  std::vector<Candidate> match(
+    const std::vector<std::array<double, 2>> & points,
+    double min_score, int max_candidates);
+
+protected:
+  /**
+   * @struct Node
+   * @brief Square of 2^level by 2^level robot cells, at one heading
+   */
+  struct Node
+  {
+    int angle;
+    int x, y;
+    int level;
+    int bound;
+  };
+
+  /**
+   * @brief Sum of the pooled likelihoods of the endpoints of a node
+   */
+  int score(const Node & node, const std::vector<std::array<int, 2>> & offsets) const;
+
+  /**
+   * @brief Keep a leaf among the candidates, if not near a better one
+   */
+  void addCandidate(
+    const Node & leaf, double angle, double score, int max_candidates,
+    std::vector<Candidate> & candidates) const;
+
+  const map_t * map_;
+  int depth_;
+  // Likelihoods scaled to 255, max-pooled over squares of 2^level cells per level
+  std::vector<std::vector<uint8_t>> grids_;
+};
+
+}  // namespace nav2_amcl
+
+#endif  // NAV2_AMCL__GLOBAL_SCAN_MATCHER_HPP_
@@ -91,6 +91,17 @@ void map_free(map_t * map);
 // Update the cspace distances
 void map_update_cspace(map_t * map, double max_occ_dist);
 
+// Update the cspace distances, splitting the work over several threads
+void map_update_cspace_threads(map_t * map, double max_occ_dist, int num_threads);
+
+// Update the cspace distances, loaded from a cache directory when computed there
+// before for the same map, and saved there otherwise
+void map_update_cspace_cached(
+  map_t * map, double max_occ_dist, int num_threads, const char * cache_directory);
+
+// Hash of the occupancy of the cells, identifying the map in cache files
+uint64_t map_occ_hash(const map_t * map);
+
 
 /**************************************************************************
  * Range functions
@@ -0,0 +1,101 @@
+// Copyright (c) 2024 Open Navigation LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef NAV2_AMCL__MAP__RANGE_TABLE_HPP_
+#define NAV2_AMCL__MAP__RANGE_TABLE_HPP_
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "nav2_amcl/map/map.hpp"
+
+namespace nav2_amcl
+{
+
+/**
+ * @class nav2_amcl::RangeTable
+ * @brief Compressed directional distance table of a map (Walsh and Karaman, CDDT: Fast
+ * Approximate 2D Ray Casting for Accelerated Localization). For each of a set of
+ * discretized headings, the map is cut into lanes of a cell wide along the heading, and
+ * each lane keeps the sorted positions along the heading of the obstacles crossing it.
+ * A range reading is then a binary search in the lane of its origin rather than a
+ * raytrace cell by cell. As map_calc_range, unknown cells and the outside of the map
+ * are obstacles. Only the obstacles next to a free cell are kept, the others can only
+ * be hit from inside an obstacle
+ */
+class RangeTable
+{
+public:
+  /**
+   * @brief A constructor for nav2_amcl::RangeTable, computing the table of a map
+   * @param map Map to compute the table of
+   * @param headings Number of discretized headings over half a turn, each lane being
+   * read in both directions
+   */
+  RangeTable(const map_t * map, int headings);
+
+  /**
+   * @brief Load the table of a map from a file, when saved there for the same cells
+   * and number of headings
+   * @param map Map the table is loaded for
+   * @param headings Number of discretized headings over half a turn
+   * @param filename File the table was saved to
+   * @return The table, or nullptr if the file cannot be read or is for another map
+   */
+  static std::unique_ptr<RangeTable> load(
+    const map_t * map, int headings, const std::string & filename);
+
+  /**
+   * @brief Save the table to a file
+   * @param filename File to save the table to
+   * @return Whether the table was saved
+   */
+  bool save(const std::string & filename) const;
+
+  /**
+   * @brief Extract a single range reading from the table, as map_calc_range
+   * @param ox X of the origin of the reading (m), in the map frame
+   * @param oy Y of the origin of the reading (m), in the map frame
+   * @param oa Heading of the reading (rad), in the map frame
+   * @param max_range Range returned when no obstacle is hit closer (m)
+   * @return Range to the first obstacle (m)
+   */
+  double calcRange(double ox, double oy, double oa, double max_range) const;
+
+protected:
+  explicit RangeTable(const map_t * map);
+
+  /**
+   * @brief Hash of the occupancy of the cells of the map, identifying it in files
+   */
+  uint64_t hash() const;
+
+  const map_t * map_;
+  int headings_;
+  double heading_resolution_;
+  // Direction and lane coordinate of the first lane, per heading
+  std::vector<double> cos_, sin_, lane_origin_;
+  // Lanes of each heading, in lane_begin_, from first_lane_[heading]
+  std::vector<uint32_t> first_lane_;
+  // Obstacles of each lane, in obstacles_, from lane_begin_[lane]
+  std::vector<uint32_t> lane_begin_;
+  // Positions of the obstacle cell centers along the heading (cells), sorted per lane
+  std::vector<float> obstacles_;
+};
+
+}  // namespace nav2_amcl
+
+#endif  // NAV2_AMCL__MAP__RANGE_TABLE_HPP_
@@ -0,0 +1,88 @@
+// Copyright (c) 2024 Open Navigation LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef NAV2_AMCL__MOTION_MODEL__GAUSSIAN_SAMPLER_HPP_
+#define NAV2_AMCL__MOTION_MODEL__GAUSSIAN_SAMPLER_HPP_
+
+#include <math.h>
+#include <cstddef>
+#include <cstdint>
+
+namespace nav2_amcl
+{
+
+/**
+ * @class nav2_amcl::GaussianSampler
+ * @brief Counter based generator of standard normal variates: the n-th variate of a stream
+ * is a pure function of the seed and n, hashed with the SplitMix64 finalizer and turned
+ * into a normal by the trigonometric Box-Muller transform. Unlike the drand48 polar method
+ * of pf_ran_gaussian, there is no state, no rejection loop and no branch, so ranges of
+ * variates can be drawn in any order, from several threads, and in loops the compiler
+ * can vectorize.
+ */
+class GaussianSampler
+{
+public:
+  /**
+   * @brief A constructor for nav2_amcl::GaussianSampler
+   * @param seed Seed of the stream
+   */
+  explicit GaussianSampler(uint64_t seed = 0)
+  : seed_(seed) {}
+
+  /**
+   * @brief Set the seed of the stream
+   * @param seed Seed of the stream
+   */
+  void seed(uint64_t seed) {seed_ = seed;}
+
+  /**
+   * @brief Get the n-th standard normal variate of the stream
+   * @param n Counter of the variate
+   * @return Variate of mean 0 and standard deviation 1
+   */
+  double operator()(uint64_t n) const
+  {
+    // SplitMix64 of the counter
+    uint64_t z = seed_ + (n + 1) * 0x9e3779b97f4a7c15ull;
+    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ull;
+    z = (z ^ (z >> 27)) * 0x94d049bb133111ebull;
+    z ^= z >> 31;
+
+    // Two uniforms of 32 bits, the first in (0, 1) for the logarithm
+    const double u1 = (static_cast<double>(z >> 32) + 0.5) * (1.0 / 4294967296.0);
+    const double u2 = static_cast<double>(z & 0xffffffffull) * (1.0 / 4294967296.0);
+    return sqrt(-2.0 * log(u1)) * cos(2.0 * M_PI * u2);
+  }
+
+  /**
+   * @brief Fill an array with the variates [n, n + count) of the stream
+   * @param n Counter of the first variate
+   * @param values Array to fill
+   * @param count Number of variates
+   */
+  void fill(uint64_t n, double * values, size_t count) const
+  {
+    for (size_t i = 0; i < count; i++) {
+      values[i] = (*this)(n + i);
+    }
+  }
+
+protected:
+  uint64_t seed_;
+};
+
+}  // namespace nav2_amcl
+
+#endif  // NAV2_AMCL__MOTION_MODEL__GAUSSIAN_SAMPLER_HPP_
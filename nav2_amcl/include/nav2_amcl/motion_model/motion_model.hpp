@@ -17,11 +17,16 @@
 #ifndef NAV2_AMCL__MOTION_MODEL__MOTION_MODEL_HPP_
 #define NAV2_AMCL__MOTION_MODEL__MOTION_MODEL_HPP_
 
+#include <cstdint>
+#include <functional>
 #include <string>
 #include <memory>
+#include <vector>
 
+#include "nav2_amcl/motion_model/gaussian_sampler.hpp"
 #include "nav2_amcl/pf/pf.hpp"
 #include "nav2_amcl/pf/pf_pdf.hpp"
+#include "nav2_util/thread_pool.hpp"
 
 namespace nav2_amcl
 {
@@ -33,6 +38,11 @@ namespace nav2_amcl
 class MotionModel
 {
 public:
+  /**
+   * @brief A constructor for nav2_amcl::MotionModel, seeding its noise from drand48
+   */
+  MotionModel();
+
   virtual ~MotionModel() = default;
 
   /**
@@ -56,6 +66,46 @@ public:
    * @param delta change in pose in odometry update
    */
   virtual void odometryUpdate(pf_t * pf, const pf_vector_t & pose, const pf_vector_t & delta) = 0;
+
+  /**
+   * @brief Set the number of threads sampling the particles in odometry updates
+   * @param num_threads Number of threads, the updating thread included
+   */
+  void setNumThreads(unsigned int num_threads);
+
+protected:
+  /**
+   * @brief Reserve the Gaussian noise of an odometry update, drawn by drawNoise
+   * @param draws Number of standard normal variates per sample
+   * @param sample_count Number of samples
+   */
+  void reserveNoise(int draws, int sample_count);
+
+  /**
+   * @brief Draw the noise reserved for the samples [begin, end), noise_[k * sample_count + i]
+   * being the k-th variate of sample i. The variates only depend on the seed and on the
+   * sample index, not on the blocks the samples are split in
+   * @param begin First sample of the block
+   * @param end Sample after the last one of the block
+   */
+  void drawNoise(int begin, int end);
+
+  /**
+   * @brief Run fn(begin, end) on consecutive blocks of samples, on several threads if set,
+   * and wait for all of them
+   * @param sample_count Number of samples to split in blocks
+   * @param fn Function processing the samples [begin, end) of a block
+   */
+  void forEachSampleBlock(int sample_count, const std::function<void(int, int)> & fn);
+
+  std::unique_ptr<nav2_util::ThreadPool> thread_pool_;
+  GaussianSampler sampler_;
+  // Counter of the first variate of the current update
+  uint64_t noise_counter_ = 0;
+  int noise_draws_ = 0;
+  int noise_samples_ = 0;
+  // Noise of the current update, one array per variate of a sample
+  std::vector<double> noise_;
 };
 }  // namespace nav2_amcl
 
@@ -57,15 +57,16 @@ typedef double (* pf_sensor_model_fn_t) (
   struct _pf_sample_set_t * set);
 
 
-// Information for a single sample
-typedef struct
-{
-  // Pose represented by this sample
-  pf_vector_t pose;
+// Scalar of the sample arrays, float if PF_SAMPLE_FLOAT is defined (AMCL_FLOAT_SAMPLES
+// option) to halve the memory traffic of the passes over the samples
+#ifdef PF_SAMPLE_FLOAT
+typedef float pf_real_t;
+#else
+typedef double pf_real_t;
+#endif
 
-  // Weight for this pose
-  double weight;
-} pf_sample_t;
+// Alignment of the sample arrays, in bytes
+#define PF_SAMPLE_ALIGNMENT 64
 
 
 // Information for a cluster of samples
@@ -89,9 +90,15 @@ typedef struct
 // Information for a set of samples
 typedef struct _pf_sample_set_t
 {
-  // The samples
+  // The samples, as separate aligned arrays of their pose components and weights
   int sample_count;
-  pf_sample_t * samples;
+  pf_real_t * x;
+  pf_real_t * y;
+  pf_real_t * theta;
+  pf_real_t * weight;
+
+  // Allocation holding the sample arrays
+  void * sample_buffer;
 
   // A kdtree encoding the histogram
   pf_kdtree_t * kdtree;
@@ -107,6 +114,22 @@ typedef struct _pf_sample_set_t
 } pf_sample_set_t;
 
 
+// Get the pose of a sample
+static inline pf_vector_t pf_sample_get_pose(const pf_sample_set_t * set, int i)
+{
+  pf_vector_t pose = {{set->x[i], set->y[i], set->theta[i]}};
+  return pose;
+}
+
+// Set the pose of a sample
+static inline void pf_sample_set_pose(pf_sample_set_t * set, int i, pf_vector_t pose)
+{
+  set->x[i] = (pf_real_t)pose.v[0];
+  set->y[i] = (pf_real_t)pose.v[1];
+  set->theta[i] = (pf_real_t)pose.v[2];
+}
+
+
 // Information for an entire filter
 typedef struct _pf_t
 {
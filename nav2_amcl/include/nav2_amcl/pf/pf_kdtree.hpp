@@ -33,44 +33,40 @@
 #endif
 
 
-// Info for a node in the tree
+// Info for a histogram bin. The histogram used to be a kd tree, it is now a
+// hash grid over the bin keys, the bins being stored contiguously.
 typedef struct pf_kdtree_node
 {
-  // Depth in the tree
-  int leaf, depth;
-
-  // Pivot dimension and value
-  int pivot_dim;
-  double pivot_value;
-
   // The key for this node
   int key[3];
 
   // The value for this node
   double value;
 
-  // The cluster label (leaf nodes)
+  // The cluster label
   int cluster;
 
-  // Child nodes
-  struct pf_kdtree_node * children[2];
+  // Slot of the node in the hash table
+  int slot;
 } pf_kdtree_node_t;
 
 
-// A kd tree
+// A histogram of poses
 typedef struct
 {
   // Cell size
   double size[3];
 
-  // The root node of the tree
-  pf_kdtree_node_t * root;
-
   // The number of nodes in the tree
   int node_count, node_max_count;
   pf_kdtree_node_t * nodes;
 
-  // The number of leaf nodes in the tree
+  // Open addressing hash table of node indices, -1 if empty, with a power
+  // of two size
+  int table_size;
+  int * table;
+
+  // The number of leaf nodes (bins) in the tree
   int leaf_count;
 } pf_kdtree_t;
 
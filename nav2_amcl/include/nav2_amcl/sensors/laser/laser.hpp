@@ -18,10 +18,15 @@
 #ifndef NAV2_AMCL__SENSORS__LASER__LASER_HPP_
 #define NAV2_AMCL__SENSORS__LASER__LASER_HPP_
 
+#include <functional>
+#include <memory>
 #include <string>
+#include <vector>
 #include "nav2_amcl/pf/pf.hpp"
 #include "nav2_amcl/pf/pf_pdf.hpp"
 #include "nav2_amcl/map/map.hpp"
+#include "nav2_amcl/map/range_table.hpp"
+#include "nav2_util/thread_pool.hpp"
 
 namespace nav2_amcl
 {
@@ -62,6 +67,43 @@ public:
    */
   void SetLaserPose(pf_vector_t & laser_pose);
 
+  /*
+   * @brief Get the laser pose
+   * @return Pose of the laser, relative to the robot
+   */
+  pf_vector_t getLaserPose() const {return laser_pose_;}
+
+  /*
+   * @brief Set the number of threads evaluating the particles in sensor updates
+   * @param num_threads Number of threads, the updating thread included
+   */
+  void setNumThreads(unsigned int num_threads);
+
+  /*
+   * @brief Set whether the likelihood field models look up the Gaussian of the obstacle
+   * distance of the beam endpoints in a per cell table, computed here from the map,
+   * rather than evaluating it for every beam
+   * @param use_table Whether to use the table
+   */
+  void setLikelihoodTable(bool use_table);
+
+  /*
+   * @brief Set the adaptive beam selection: the scans are cut into as many sectors as beams
+   * to use, and each sector keeps its beam of steepest obstacle distance around its
+   * expected endpoint from the mean pose, the beams carrying the most information
+   * about the position. The beam count shrinks from max_beams to min_beams as the
+   * particles converge. Needs the map distances of the likelihood field models.
+   * @param min_beams Fewest beams used, 0 to disable the selection
+   */
+  void setAdaptiveBeams(int min_beams);
+
+  /*
+   * @brief Replace the ranges of a scan by the beams selected for an update, if enabled
+   * @param pf Particle filter to update, giving the mean pose and spread
+   * @param data Laser data to select the beams of
+   */
+  void selectBeams(pf_t * pf, LaserData * data);
+
 protected:
   double z_hit_;
   double z_rand_;
@@ -73,12 +115,46 @@ protected:
    * @param max_obs number of observations
    */
   void reallocTempData(int max_samples, int max_obs);
+
+  /*
+   * @brief Get the number of blocks forEachSampleBlock splits the samples in
+   */
+  int getNumSampleBlocks() const;
+
+  /*
+   * @brief Store the ranges, bearing cosines and sines, and indices of the beams of a scan
+   * used by the models, skipping the max range and NaN readings
+   * @param data Laser data to use
+   * @param step Step between the beams used
+   */
+  void prepareBeams(LaserData * data, int step);
+
+  /*
+   * @brief Run fn(block, begin, end) on consecutive blocks of samples, on several
+   * threads if set, and wait for all of them
+   * @param sample_count Number of samples to split in blocks
+   * @param fn Function processing the samples [begin, end) of a block
+   */
+  void forEachSampleBlock(
+    int sample_count, const std::function<void(int, int, int)> & fn);
+
   map_t * map_;
   pf_vector_t laser_pose_;
   int max_beams_;
   int max_samples_;
   int max_obs_;
   double ** temp_obs_;
+  int min_beams_;
+  std::unique_ptr<nav2_util::ThreadPool> thread_pool_;
+
+  // Gaussian of the obstacle distance of each map cell, empty if not used
+  std::vector<float> likelihood_table_;
+
+  // Beams of the current scan, see prepareBeams
+  std::vector<double> beam_ranges_;
+  std::vector<double> beam_cos_;
+  std::vector<double> beam_sin_;
+  std::vector<int> beam_indices_;
 };
 
 /*
@@ -127,12 +203,20 @@ public:
    */
   bool sensorUpdate(pf_t * pf, LaserData * data);
 
+  /*
+   * @brief Set the range table the expected ranges are read from, rather than
+   * raytraced in the map
+   * @param range_table Table of the map of the model, or nullptr to raytrace
+   */
+  void setRangeTable(std::shared_ptr<const RangeTable> range_table);
+
 private:
   static double sensorFunction(LaserData * data, pf_sample_set_t * set);
   double z_short_;
   double z_max_;
   double lambda_short_;
   double chi_outlier_;
+  std::shared_ptr<const RangeTable> range_table_;
 };
 
 /*
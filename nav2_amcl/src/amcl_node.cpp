@@ -23,7 +23,10 @@
 #include "nav2_amcl/amcl_node.hpp"
 
 #include <algorithm>
+#include <array>
+#include <cmath>
 #include <memory>
+#include <sstream>
 #include <string>
 #include <utility>
 #include <vector>
@@ -33,6 +36,7 @@
 #include "nav2_util/geometry_utils.hpp"
 #include "nav2_amcl/pf/pf.hpp"
 #include "nav2_util/string_utils.hpp"
+#include "nav2_util/tracing.hpp"
 #include "nav2_amcl/sensors/laser/laser.hpp"
 #include "tf2/convert.h"
 #include "tf2_geometry_msgs/tf2_geometry_msgs.hpp"
@@ -145,6 +149,79 @@ AmclNode::AmclNode(const rclcpp::NodeOptions & options)
     "max_beams", rclcpp::ParameterValue(60),
     "How many evenly-spaced beams in each scan to be used when updating the filter");
 
+  add_parameter(
+    "sensor_threads", rclcpp::ParameterValue(1),
+    "Number of threads evaluating the particles in laser updates");
+
+  add_parameter(
+    "motion_threads", rclcpp::ParameterValue(1),
+    "Number of threads sampling the particles in odometry updates");
+
+  add_parameter(
+    "min_beams", rclcpp::ParameterValue(0),
+    "Fewest beams used by the likelihood field models once the particles converged, "
+    "picking the beams of most information about the position; 0 always uses max_beams "
+    "evenly spaced beams");
+
+  add_parameter(
+    "fuse_lasers", rclcpp::ParameterValue(false),
+    "Whether the scans of several lasers are merged into a single filter update of the "
+    "likelihood field models, rather than each updating the filter");
+
+  add_parameter(
+    "fuse_lasers_tolerance", rclcpp::ParameterValue(0.2),
+    "Largest time difference (s) of the scans merged into a single update");
+
+  add_parameter(
+    "scan_match_global_localization", rclcpp::ParameterValue(false),
+    "Whether global localization seeds the particles around the best matches of the "
+    "latest scan on the map, rather than uniformly over the free space");
+
+  add_parameter(
+    "scan_match_min_score", rclcpp::ParameterValue(0.5),
+    "Lowest mean endpoint likelihood of a global localization scan match");
+
+  add_parameter(
+    "scan_match_hypotheses", rclcpp::ParameterValue(3),
+    "Most distinct poses global localization seeds the particles around");
+
+  add_parameter(
+    "particle_cloud_max_rate", rclcpp::ParameterValue(0.0),
+    "Maximum rate (Hz) the particle cloud is published at, 0 for every filter update");
+
+  add_parameter(
+    "particle_cloud_max_particles", rclcpp::ParameterValue(0),
+    "Most particles in the published particle cloud, downsampled evenly, 0 for all");
+
+  add_parameter(
+    "particle_cloud_clusters", rclcpp::ParameterValue(false),
+    "Whether the particle cloud holds one particle per cluster rather than the particles");
+
+  add_parameter(
+    "use_likelihood_table", rclcpp::ParameterValue(false),
+    "Whether the likelihood field models look up the Gaussian of the obstacle distance "
+    "in a per cell float table rather than evaluating it per beam");
+
+  add_parameter(
+    "beam_range_table", rclcpp::ParameterValue(false),
+    "Whether the beam model looks its expected ranges up in a compressed directional "
+    "distance table computed at map load, rather than raytracing them cell by cell");
+
+  add_parameter(
+    "beam_range_table_headings", rclcpp::ParameterValue(180),
+    "Number of discretized headings over half a turn of the beam range table");
+
+  add_parameter(
+    "beam_range_table_file", rclcpp::ParameterValue(std::string("")),
+    "File the range table of the beam model is loaded from when saved there for the same "
+    "map, and saved to otherwise; empty not to cache it");
+
+  add_parameter(
+    "map_cache_directory", rclcpp::ParameterValue(std::string("")),
+    "Directory the likelihood field and beam range table of a map are loaded from when "
+    "computed there before for the same map and parameters, and saved to otherwise. May be "
+    "shared by the nodes of several robots using the same map; empty not to cache them");
+
   add_parameter(
     "max_particles", rclcpp::ParameterValue(2000),
     "Maximum allowed number of particles");
@@ -346,7 +423,7 @@ AmclNode::on_cleanup(const rclcpp_lifecycle::State & /*state*/)
     map_ = nullptr;
   }
   first_map_received_ = false;
-  free_space_indices.resize(0);
+  std::vector<uint32_t>().swap(free_space_indices);
 
   // Transforms
   tf_broadcaster_.reset();
@@ -409,7 +486,7 @@ AmclNode::checkElapsedTime(std::chrono::seconds check_interval, rclcpp::Time las
 }
 
 #if NEW_UNIFORM_SAMPLING
-std::vector<AmclNode::Point2D> AmclNode::free_space_indices;
+std::vector<uint32_t> AmclNode::free_space_indices;
 #endif
 
 bool
@@ -451,10 +528,10 @@ AmclNode::uniformPoseGenerator(void * arg)
 
 #if NEW_UNIFORM_SAMPLING
   unsigned int rand_index = drand48() * free_space_indices.size();
-  AmclNode::Point2D free_point = free_space_indices[rand_index];
+  const uint32_t free_index = free_space_indices[rand_index];
   pf_vector_t p;
-  p.v[0] = MAP_WXGX(map, free_point.x);
-  p.v[1] = MAP_WYGY(map, free_point.y);
+  p.v[0] = MAP_WXGX(map, static_cast<int>(free_index % map->size_x));
+  p.v[1] = MAP_WYGY(map, static_cast<int>(free_index / map->size_x));
   p.v[2] = drand48() * 2 * M_PI - M_PI;
 #else
   double min_x, max_x, min_y, max_y;
@@ -491,16 +568,101 @@ AmclNode::globalLocalizationCallback(
 {
   std::lock_guard<std::recursive_mutex> cfl(mutex_);
 
-  RCLCPP_INFO(get_logger(), "Initializing with uniform distribution");
+  if (!scan_match_global_localization_ || !initFromScanMatch()) {
+    RCLCPP_INFO(get_logger(), "Initializing with uniform distribution");
 
-  pf_init_model(
-    pf_, (pf_init_model_fn_t)AmclNode::uniformPoseGenerator,
-    reinterpret_cast<void *>(map_));
+    pf_init_model(
+      pf_, (pf_init_model_fn_t)AmclNode::uniformPoseGenerator,
+      reinterpret_cast<void *>(map_));
+  }
   RCLCPP_INFO(get_logger(), "Global initialisation done!");
   initial_pose_is_known_ = true;
   pf_init_ = false;
 }
 
+bool
+AmclNode::initFromScanMatch()
+{
+  if (map_ == NULL) {
+    return false;
+  }
+
+  // Latest scan of any laser
+  int laser_index = -1;
+  for (unsigned int i = 0; i < latest_scans_.size(); i++) {
+    if (latest_scans_[i] && (laser_index < 0 ||
+      rclcpp::Time(latest_scans_[i]->header.stamp) >
+      rclcpp::Time(latest_scans_[laser_index]->header.stamp)))
+    {
+      laser_index = i;
+    }
+  }
+  nav2_amcl::LaserData ldata;
+  if (laser_index < 0 || !convertScan(laser_index, latest_scans_[laser_index], ldata)) {
+    RCLCPP_WARN(get_logger(), "No laser scan to match for global localization");
+    return false;
+  }
+
+  // Endpoints in the robot frame, as many as the sensor models use
+  const pf_vector_t laser_pose = lasers_[laser_index]->getLaserPose();
+  const int step = std::max(ldata.range_count / std::max(max_beams_, 1), 1);
+  std::vector<std::array<double, 2>> points;
+  for (int i = 0; i < ldata.range_count; i += step) {
+    const double range = ldata.ranges[i][0];
+    if (range >= ldata.range_max || range != range) {
+      continue;
+    }
+    points.push_back(
+      {laser_pose.v[0] + range * cos(ldata.ranges[i][1]),
+        laser_pose.v[1] + range * sin(ldata.ranges[i][1])});
+  }
+
+  // The beam model does not compute the distances, already computed otherwise
+  map_update_cspace(map_, laser_likelihood_max_dist_);
+  nav2_amcl::GlobalScanMatcher matcher(map_, sigma_hit_);
+  auto candidates = matcher.match(points, scan_match_min_score_, scan_match_hypotheses_);
+  if (candidates.empty()) {
+    RCLCPP_WARN(get_logger(), "No pose of the laser scan matches the map");
+    return false;
+  }
+
+  for (const auto & candidate : candidates) {
+    RCLCPP_INFO(
+      get_logger(), "Scan match candidate (%.3f, %.3f, %.3f) with score %.3f",
+      candidate.pose.v[0], candidate.pose.v[1], candidate.pose.v[2], candidate.score);
+  }
+  pf_init_model(
+    pf_, (pf_init_model_fn_t)AmclNode::candidatePoseGenerator,
+    reinterpret_cast<void *>(&candidates));
+  return true;
+}
+
+pf_vector_t
+AmclNode::candidatePoseGenerator(void * arg)
+{
+  const auto & candidates =
+    *reinterpret_cast<std::vector<nav2_amcl::GlobalScanMatcher::Candidate> *>(arg);
+
+  // Candidates drawn in proportion to their score
+  double total = 0.0;
+  for (const auto & candidate : candidates) {
+    total += candidate.score;
+  }
+  double r = drand48() * total;
+  size_t i = 0;
+  while (i + 1 < candidates.size() && r >= candidates[i].score) {
+    r -= candidates[i].score;
+    i++;
+  }
+
+  // Spread over the resolution of the search, a few cells and a fraction of the hypotheses
+  pf_vector_t p = candidates[i].pose;
+  p.v[0] += pf_ran_gaussian(0.2);
+  p.v[1] += pf_ran_gaussian(0.2);
+  p.v[2] = angleutils::normalize(p.v[2] + pf_ran_gaussian(0.1));
+  return p;
+}
+
 void
 AmclNode::initialPoseReceivedSrv(
   const std::shared_ptr<rmw_request_id_t>/*request_header*/,
@@ -642,6 +804,8 @@ AmclNode::laserReceived(sensor_msgs::msg::LaserScan::ConstSharedPtr laser_scan)
     return;
   }
 
+  NAV2_TRACE_SCOPE_ID(
+    "amcl.laserReceived", rclcpp::Time(laser_scan->header.stamp).nanoseconds());
   std::string laser_scan_frame_id = nav2_util::strip_leading_slash(laser_scan->header.frame_id);
   last_laser_received_ts_ = now();
   int laser_index = -1;
@@ -656,6 +820,7 @@ AmclNode::laserReceived(sensor_msgs::msg::LaserScan::ConstSharedPtr laser_scan)
     // we have the laser pose, retrieve laser index
     laser_index = frame_to_laser_[laser_scan->header.frame_id];
   }
+  latest_scans_[laser_index] = laser_scan;
 
   // Where was the robot when this scan was taken?
   pf_vector_t pose;
@@ -688,6 +853,7 @@ AmclNode::laserReceived(sensor_msgs::msg::LaserScan::ConstSharedPtr laser_scan)
       }
     }
     if (lasers_update_[laser_index]) {
+      NAV2_TRACE_SCOPE("amcl.motionUpdate");
       motion_model_->odometryUpdate(pf_, pose, delta);
     }
     force_update_ = false;
@@ -697,10 +863,15 @@ AmclNode::laserReceived(sensor_msgs::msg::LaserScan::ConstSharedPtr laser_scan)
 
   // If the robot has moved, update the filter
   if (lasers_update_[laser_index]) {
-    updateFilter(laser_index, laser_scan, pose);
+    if (fuse_lasers_ && sensor_model_type_ != "beam" && lasers_.size() > 1) {
+      updateFilterFused(laser_scan, pose);
+    } else {
+      updateFilter(laser_index, laser_scan, pose);
+    }
 
     // Resample the particles
     if (!(++resample_count_ % resample_interval_)) {
+      NAV2_TRACE_SCOPE("amcl.resample");
       pf_update_resample(pf_, reinterpret_cast<void *>(map_));
       resampled = true;
     }
@@ -750,6 +921,7 @@ bool AmclNode::addNewScanner(
 {
   lasers_.push_back(createLaserObject());
   lasers_update_.push_back(true);
+  latest_scans_.push_back(nullptr);
   laser_index = frame_to_laser_.size();
 
   geometry_msgs::msg::PoseStamped ident;
@@ -791,13 +963,11 @@ bool AmclNode::shouldUpdateFilter(const pf_vector_t pose, pf_vector_t & delta)
   return update;
 }
 
-bool AmclNode::updateFilter(
+bool AmclNode::convertScan(
   const int & laser_index,
   const sensor_msgs::msg::LaserScan::ConstSharedPtr & laser_scan,
-  const pf_vector_t & pose)
+  nav2_amcl::LaserData & ldata)
 {
-  nav2_amcl::LaserData ldata;
-  ldata.laser = lasers_[laser_index];
   ldata.range_count = laser_scan->ranges.size();
   // To account for lasers that are mounted upside-down, we determine the
   // min, max, and increment angles of the laser in the base frame.
@@ -866,29 +1036,171 @@ bool AmclNode::updateFilter(
     ldata.ranges[i][1] = angle_min +
       (i * angle_increment);
   }
+  return true;
+}
+
+bool AmclNode::updateFilter(
+  const int & laser_index,
+  const sensor_msgs::msg::LaserScan::ConstSharedPtr & laser_scan,
+  const pf_vector_t & pose)
+{
+  NAV2_TRACE_SCOPE("amcl.sensorUpdate");
+  nav2_amcl::LaserData ldata;
+  ldata.laser = lasers_[laser_index];
+  if (!convertScan(laser_index, laser_scan, ldata)) {
+    return false;
+  }
+  lasers_[laser_index]->selectBeams(pf_, &ldata);
   lasers_[laser_index]->sensorUpdate(pf_, reinterpret_cast<nav2_amcl::LaserData *>(&ldata));
   lasers_update_[laser_index] = false;
   pf_odom_pose_ = pose;
   return true;
 }
 
+bool AmclNode::updateFilterFused(
+  const sensor_msgs::msg::LaserScan::ConstSharedPtr & laser_scan,
+  const pf_vector_t & pose)
+{
+  NAV2_TRACE_SCOPE("amcl.sensorUpdate");
+  if (!fused_laser_) {
+    // Evaluates the endpoints from the robot itself
+    fused_laser_.reset(createLaserObject());
+    pf_vector_t robot_pose = pf_vector_zero();
+    fused_laser_->SetLaserPose(robot_pose);
+  }
+
+  const rclcpp::Time stamp(laser_scan->header.stamp);
+  std::vector<std::pair<double, double>> beams;
+  double range_max = 0.0;
+  for (unsigned int i = 0; i < latest_scans_.size(); i++) {
+    const auto & scan = latest_scans_[i];
+    if (!scan ||
+      std::abs((stamp - rclcpp::Time(scan->header.stamp)).seconds()) > fuse_lasers_tolerance_)
+    {
+      continue;
+    }
+
+    nav2_amcl::LaserData ldata;
+    if (!convertScan(i, scan, ldata)) {
+      continue;
+    }
+
+    // Pose of the laser at the time of its scan, in the robot frame at the time of this one
+    pf_vector_t laser_pose = lasers_[i]->getLaserPose();
+    if (scan != laser_scan) {
+      geometry_msgs::msg::PoseStamped odom_pose;
+      pf_vector_t scan_pose;
+      if (!getOdomPose(
+          odom_pose, scan_pose.v[0], scan_pose.v[1], scan_pose.v[2],
+          scan->header.stamp, base_frame_id_))
+      {
+        continue;
+      }
+      const double dx = scan_pose.v[0] - pose.v[0];
+      const double dy = scan_pose.v[1] - pose.v[1];
+      const double c = cos(pose.v[2]), s = sin(pose.v[2]);
+      pf_vector_t relative;
+      relative.v[0] = c * dx + s * dy;
+      relative.v[1] = -s * dx + c * dy;
+      relative.v[2] = angleutils::normalize(scan_pose.v[2] - pose.v[2]);
+      laser_pose = pf_vector_coord_add(laser_pose, relative);
+    }
+
+    // The models skip the max range and NaN readings, so they are not carried over
+    const double c = cos(laser_pose.v[2]), s = sin(laser_pose.v[2]);
+    for (int j = 0; j < ldata.range_count; j++) {
+      const double range = ldata.ranges[j][0];
+      if (range >= ldata.range_max || range != range) {
+        continue;
+      }
+      const double x = range * cos(ldata.ranges[j][1]);
+      const double y = range * sin(ldata.ranges[j][1]);
+      const double ex = laser_pose.v[0] + c * x - s * y;
+      const double ey = laser_pose.v[1] + s * x + c * y;
+      beams.emplace_back(std::hypot(ex, ey), std::atan2(ey, ex));
+    }
+    range_max = std::max(
+      range_max, ldata.range_max + std::hypot(laser_pose.v[0], laser_pose.v[1]));
+  }
+
+  if (beams.empty()) {
+    return false;
+  }
+
+  // Beams interleave across the lasers in bearing order, so that the models
+  // subsampling of max_beams takes from all of them
+  std::sort(
+    beams.begin(), beams.end(), [](const auto & a, const auto & b) {
+      return a.second < b.second;
+    });
+  nav2_amcl::LaserData ldata;
+  ldata.laser = fused_laser_.get();
+  ldata.range_count = beams.size();
+  ldata.range_max = range_max;
+  ldata.ranges = new double[ldata.range_count][2];
+  for (int i = 0; i < ldata.range_count; i++) {
+    ldata.ranges[i][0] = beams[i].first;
+    ldata.ranges[i][1] = beams[i].second;
+  }
+
+  fused_laser_->selectBeams(pf_, &ldata);
+  fused_laser_->sensorUpdate(pf_, reinterpret_cast<nav2_amcl::LaserData *>(&ldata));
+  std::fill(lasers_update_.begin(), lasers_update_.end(), false);
+  pf_odom_pose_ = pose;
+  return true;
+}
+
 void
 AmclNode::publishParticleCloud(const pf_sample_set_t * set)
 {
   // If initial pose is not known, AMCL does not know the current pose
   if (!initial_pose_is_known_) {return;}
+
+  // Nothing to build if nobody listens, nor more often than the maximum rate
+  if (particle_cloud_pub_->get_subscription_count() == 0 &&
+    particle_cloud_pub_->get_intra_process_subscription_count() == 0)
+  {
+    return;
+  }
+  const rclcpp::Time stamp = this->now();
+  if (particle_cloud_max_rate_ > 0.0 && last_particle_cloud_time_.nanoseconds() != 0 &&
+    (stamp - last_particle_cloud_time_).seconds() < 1.0 / particle_cloud_max_rate_)
+  {
+    return;
+  }
+  last_particle_cloud_time_ = stamp;
+
   auto cloud_with_weights_msg = std::make_unique<nav2_msgs::msg::ParticleCloud>();
-  cloud_with_weights_msg->header.stamp = this->now();
+  cloud_with_weights_msg->header.stamp = stamp;
   cloud_with_weights_msg->header.frame_id = global_frame_id_;
-  cloud_with_weights_msg->particles.resize(set->sample_count);
-
-  for (int i = 0; i < set->sample_count; i++) {
-    cloud_with_weights_msg->particles[i].pose.position.x = set->samples[i].pose.v[0];
-    cloud_with_weights_msg->particles[i].pose.position.y = set->samples[i].pose.v[1];
-    cloud_with_weights_msg->particles[i].pose.position.z = 0;
-    cloud_with_weights_msg->particles[i].pose.orientation = orientationAroundZAxis(
-      set->samples[i].pose.v[2]);
-    cloud_with_weights_msg->particles[i].weight = set->samples[i].weight;
+  auto add_particle = [&](const pf_vector_t & pose, double weight) {
+      nav2_msgs::msg::Particle particle;
+      particle.pose.position.x = pose.v[0];
+      particle.pose.position.y = pose.v[1];
+      particle.pose.position.z = 0;
+      particle.pose.orientation = orientationAroundZAxis(pose.v[2]);
+      particle.weight = weight;
+      cloud_with_weights_msg->particles.push_back(particle);
+    };
+
+  if (particle_cloud_clusters_) {
+    // One particle per cluster, at its mean and with its total weight
+    cloud_with_weights_msg->particles.reserve(set->cluster_count);
+    for (int i = 0; i < set->cluster_count; i++) {
+      add_particle(set->clusters[i].mean, set->clusters[i].weight);
+    }
+  } else {
+    // Every stride-th particle, carrying the weight of the ones skipped
+    const int stride = particle_cloud_max_particles_ > 0 ?
+      (set->sample_count + particle_cloud_max_particles_ - 1) / particle_cloud_max_particles_ : 1;
+    cloud_with_weights_msg->particles.reserve(set->sample_count / stride + 1);
+    for (int i = 0; i < set->sample_count; i += stride) {
+      double weight = 0.0;
+      for (int j = i; j < std::min(i + stride, set->sample_count); j++) {
+        weight += set->weight[j];
+      }
+      add_particle(pf_sample_get_pose(set, i), weight);
+    }
   }
 
   particle_cloud_pub_->publish(std::move(cloud_with_weights_msg));
@@ -1042,22 +1354,28 @@ AmclNode::createLaserObject()
 {
   RCLCPP_INFO(get_logger(), "createLaserObject");
 
+  nav2_amcl::Laser * laser;
   if (sensor_model_type_ == "beam") {
-    return new nav2_amcl::BeamModel(
+    auto beam_model = new nav2_amcl::BeamModel(
       z_hit_, z_short_, z_max_, z_rand_, sigma_hit_, lambda_short_,
       0.0, max_beams_, map_);
-  }
-
-  if (sensor_model_type_ == "likelihood_field_prob") {
-    return new nav2_amcl::LikelihoodFieldModelProb(
+    beam_model->setRangeTable(range_table_);
+    laser = beam_model;
+  } else if (sensor_model_type_ == "likelihood_field_prob") {
+    laser = new nav2_amcl::LikelihoodFieldModelProb(
       z_hit_, z_rand_, sigma_hit_,
       laser_likelihood_max_dist_, do_beamskip_, beam_skip_distance_, beam_skip_threshold_,
       beam_skip_error_threshold_, max_beams_, map_);
+  } else {
+    laser = new nav2_amcl::LikelihoodFieldModel(
+      z_hit_, z_rand_, sigma_hit_,
+      laser_likelihood_max_dist_, max_beams_, map_);
   }
 
-  return new nav2_amcl::LikelihoodFieldModel(
-    z_hit_, z_rand_, sigma_hit_,
-    laser_likelihood_max_dist_, max_beams_, map_);
+  laser->setNumThreads(std::max(sensor_threads_, 1));
+  laser->setLikelihoodTable(use_likelihood_table_ && sensor_model_type_ != "beam");
+  laser->setAdaptiveBeams(sensor_model_type_ != "beam" ? min_beams_ : 0);
+  return laser;
 }
 
 void
@@ -1088,6 +1406,22 @@ AmclNode::initParameters()
   get_parameter("initial_pose.z", initial_pose_z_);
   get_parameter("initial_pose.yaw", initial_pose_yaw_);
   get_parameter("max_beams", max_beams_);
+  get_parameter("sensor_threads", sensor_threads_);
+  get_parameter("motion_threads", motion_threads_);
+  get_parameter("min_beams", min_beams_);
+  get_parameter("use_likelihood_table", use_likelihood_table_);
+  get_parameter("beam_range_table", beam_range_table_);
+  get_parameter("beam_range_table_headings", beam_range_table_headings_);
+  get_parameter("beam_range_table_file", beam_range_table_file_);
+  get_parameter("map_cache_directory", map_cache_directory_);
+  get_parameter("fuse_lasers", fuse_lasers_);
+  get_parameter("particle_cloud_max_rate", particle_cloud_max_rate_);
+  get_parameter("particle_cloud_max_particles", particle_cloud_max_particles_);
+  get_parameter("particle_cloud_clusters", particle_cloud_clusters_);
+  get_parameter("scan_match_global_localization", scan_match_global_localization_);
+  get_parameter("scan_match_min_score", scan_match_min_score_);
+  get_parameter("scan_match_hypotheses", scan_match_hypotheses_);
+  get_parameter("fuse_lasers_tolerance", fuse_lasers_tolerance_);
   get_parameter("max_particles", max_particles_);
   get_parameter("min_particles", min_particles_);
   get_parameter("odom_frame_id", odom_frame_id_);
@@ -1297,6 +1631,12 @@ AmclNode::dynamicParametersCallback(
       } else if (param_name == "z_short") {
         z_short_ = parameter.as_double();
         reinit_laser = true;
+      } else if (param_name == "fuse_lasers_tolerance") {
+        fuse_lasers_tolerance_ = parameter.as_double();
+      } else if (param_name == "particle_cloud_max_rate") {
+        particle_cloud_max_rate_ = parameter.as_double();
+      } else if (param_name == "scan_match_min_score") {
+        scan_match_min_score_ = parameter.as_double();
       }
     } else if (param_type == ParameterType::PARAMETER_STRING) {
       if (param_name == "base_frame_id") {
@@ -1329,11 +1669,33 @@ AmclNode::dynamicParametersCallback(
         set_initial_pose_ = parameter.as_bool();
       } else if (param_name == "first_map_only") {
         first_map_only_ = parameter.as_bool();
+      } else if (param_name == "use_likelihood_table") {
+        use_likelihood_table_ = parameter.as_bool();
+        reinit_laser = true;
+      } else if (param_name == "fuse_lasers") {
+        fuse_lasers_ = parameter.as_bool();
+      } else if (param_name == "particle_cloud_clusters") {
+        particle_cloud_clusters_ = parameter.as_bool();
+      } else if (param_name == "scan_match_global_localization") {
+        scan_match_global_localization_ = parameter.as_bool();
       }
     } else if (param_type == ParameterType::PARAMETER_INTEGER) {
       if (param_name == "max_beams") {
         max_beams_ = parameter.as_int();
         reinit_laser = true;
+      } else if (param_name == "sensor_threads") {
+        sensor_threads_ = parameter.as_int();
+        reinit_laser = true;
+      } else if (param_name == "motion_threads") {
+        motion_threads_ = parameter.as_int();
+        reinit_odom = true;
+      } else if (param_name == "min_beams") {
+        min_beams_ = parameter.as_int();
+        reinit_laser = true;
+      } else if (param_name == "scan_match_hypotheses") {
+        scan_match_hypotheses_ = parameter.as_int();
+      } else if (param_name == "particle_cloud_max_particles") {
+        particle_cloud_max_particles_ = parameter.as_int();
       } else if (param_name == "max_particles") {
         max_particles_ = parameter.as_int();
         reinit_pf = true;
@@ -1379,6 +1741,8 @@ AmclNode::dynamicParametersCallback(
     lasers_.clear();
     lasers_update_.clear();
     frame_to_laser_.clear();
+    latest_scans_.clear();
+    fused_laser_.reset();
     laser_scan_connection_.disconnect();
     laser_scan_filter_.reset();
     laser_scan_sub_.reset();
@@ -1399,7 +1763,7 @@ AmclNode::dynamicParametersCallback(
 }
 
 void
-AmclNode::mapReceived(const nav_msgs::msg::OccupancyGrid::SharedPtr msg)
+AmclNode::mapReceived(const nav_msgs::msg::OccupancyGrid::ConstSharedPtr msg)
 {
   RCLCPP_DEBUG(get_logger(), "AmclNode: A new map was received.");
   if (!nav2_util::validateMsg(*msg)) {
@@ -1433,6 +1797,37 @@ AmclNode::handleMapMessage(const nav_msgs::msg::OccupancyGrid & msg)
   freeMapDependentMemory();
   map_ = convertMap(msg);
 
+  // Compute the likelihood field once per map, on the sensor threads. The laser
+  // models created for this map then reuse it rather than computing it again
+  if (sensor_model_type_ != "beam") {
+    map_update_cspace_cached(
+      map_, laser_likelihood_max_dist_, std::max(sensor_threads_, 1),
+      map_cache_directory_.c_str());
+  } else if (beam_range_table_) {
+    // The range table is computed once per map, or loaded from its file when it was
+    // saved there for the same map. Without a file, the cache directory names one after
+    // the map and number of headings
+    std::string range_table_file = beam_range_table_file_;
+    if (range_table_file.empty() && !map_cache_directory_.empty()) {
+      std::ostringstream path;
+      path << map_cache_directory_ << "/amcl_range_table_" << std::hex << map_occ_hash(map_) <<
+        std::dec << "_" << beam_range_table_headings_ << ".bin";
+      range_table_file = path.str();
+    }
+    if (!range_table_file.empty()) {
+      range_table_ = nav2_amcl::RangeTable::load(
+        map_, beam_range_table_headings_, range_table_file);
+    }
+    if (!range_table_) {
+      range_table_ = std::make_shared<nav2_amcl::RangeTable>(map_, beam_range_table_headings_);
+      if (!range_table_file.empty() && !range_table_->save(range_table_file)) {
+        RCLCPP_WARN(
+          get_logger(), "Could not save the beam range table to %s",
+          range_table_file.c_str());
+      }
+    }
+  }
+
 #if NEW_UNIFORM_SAMPLING
   createFreeSpaceVector();
 #endif
@@ -1442,13 +1837,19 @@ void
 AmclNode::createFreeSpaceVector()
 {
   int delta = freespace_downsampling_ ? 2 : 1;
-  // Index of free space
-  free_space_indices.resize(0);
-  for (int i = 0; i < map_->size_x; i += delta) {
-    for (int j = 0; j < map_->size_y; j += delta) {
+  // Index of free space, counted first to allocate it exactly rather than by doubling
+  size_t free_count = 0;
+  for (int j = 0; j < map_->size_y; j += delta) {
+    for (int i = 0; i < map_->size_x; i += delta) {
+      free_count += map_->cells[MAP_INDEX(map_, i, j)].occ_state == -1;
+    }
+  }
+  std::vector<uint32_t>().swap(free_space_indices);
+  free_space_indices.reserve(free_count);
+  for (int j = 0; j < map_->size_y; j += delta) {
+    for (int i = 0; i < map_->size_x; i += delta) {
       if (map_->cells[MAP_INDEX(map_, i, j)].occ_state == -1) {
-        AmclNode::Point2D point = {i, j};
-        free_space_indices.push_back(point);
+        free_space_indices.push_back(MAP_INDEX(map_, i, j));
       }
     }
   }
@@ -1457,6 +1858,7 @@ AmclNode::createFreeSpaceVector()
 void
 AmclNode::freeMapDependentMemory()
 {
+  range_table_.reset();
   if (map_ != NULL) {
     map_free(map_);
     map_ = NULL;
@@ -1467,6 +1869,8 @@ AmclNode::freeMapDependentMemory()
   lasers_.clear();
   lasers_update_.clear();
   frame_to_laser_.clear();
+  latest_scans_.clear();
+  fused_laser_.reset();
 }
 
 // Convert an OccupancyGrid map message into the internal representation. This function
@@ -1604,6 +2008,7 @@ AmclNode::initOdometry()
 
   motion_model_ = plugin_loader_.createSharedInstance(robot_model_type_);
   motion_model_->initialize(alpha1_, alpha2_, alpha3_, alpha4_, alpha5_);
+  motion_model_->setNumThreads(std::max(motion_threads_, 1));
 
   latest_odom_pose_ = geometry_msgs::msg::PoseStamped();
 }
@@ -0,0 +1,234 @@
+// Copyright (c) 2019 Samsung Research America
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+#include "nav2_amcl/global_scan_matcher.hpp"
+
+namespace nav2_amcl
+{
+
+GlobalScanMatcher::GlobalScanMatcher(const map_t * map, double sigma_hit, int depth)
+: map_(map), depth_(std::max(depth, 0))
+{
+  const int size_x = map->size_x;
+  const int size_y = map->size_y;
+  const size_t size = static_cast<size_t>(size_x) * size_y;
+  grids_.resize(depth_ + 1);
+
+  const double z_hit_denom = 2 * sigma_hit * sigma_hit;
+  grids_[0].resize(size);
+  for (size_t i = 0; i < size; i++) {
+    const double z = map->cells[i].occ_dist;
+    grids_[0][i] = static_cast<uint8_t>(std::lround(255.0 * exp(-(z * z) / z_hit_denom)));
+  }
+
+  // The square of a level is the union of four squares of the previous level
+  for (int level = 1; level <= depth_; level++) {
+    const int shift = 1 << (level - 1);
+    const std::vector<uint8_t> & previous = grids_[level - 1];
+    std::vector<uint8_t> & grid = grids_[level];
+    grid.resize(size);
+    for (int y = 0; y < size_y; y++) {
+      for (int x = 0; x < size_x; x++) {
+        const size_t index = static_cast<size_t>(y) * size_x + x;
+        uint8_t value = previous[index];
+        if (x + shift < size_x) {
+          value = std::max(value, previous[index + shift]);
+        }
+        if (y + shift < size_y) {
+          value = std::max(value, previous[index + static_cast<size_t>(shift) * size_x]);
+          if (x + shift < size_x) {
+            value = std::max(
+              value, previous[index + static_cast<size_t>(shift) * size_x + shift]);
+          }
+        }
+        grid[index] = value;
+      }
+    }
+  }
+}
+
+std::vector<GlobalScanMatcher::Candidate> GlobalScanMatcher::match(
+  const std::vector<std::array<double, 2>> & points,
+  double min_score, int max_candidates)
+{
+  std::vector<Candidate> candidates;
+  if (points.empty() || max_candidates <= 0) {
+    return candidates;
+  }
+
+  // Angular step moving the farthest endpoint by about a cell, no finer than half a degree
+  double max_range = 0.0;
+  for (const auto & point : points) {
+    max_range = std::max(max_range, std::hypot(point[0], point[1]));
+  }
+  double step = M_PI;
+  if (max_range > map_->scale) {
+    step = acos(1.0 - (map_->scale * map_->scale) / (2.0 * max_range * max_range));
+  }
+  step = std::max(step, 0.5 * M_PI / 180.0);
+  const int angles = static_cast<int>(std::ceil(2.0 * M_PI / step));
+  step = 2.0 * M_PI / angles;
+
+  // Endpoint offsets, in cells from the robot cell, at each heading
+  std::vector<std::vector<std::array<int, 2>>> offsets(angles);
+  for (int a = 0; a < angles; a++) {
+    const double c = cos(a * step - M_PI);
+    const double s = sin(a * step - M_PI);
+    offsets[a].reserve(points.size());
+    for (const auto & point : points) {
+      offsets[a].push_back(
+        {static_cast<int>(std::floor((c * point[0] - s * point[1]) / map_->scale + 0.5)),
+          static_cast<int>(std::floor((s * point[0] + c * point[1]) / map_->scale + 0.5))});
+    }
+  }
+
+  const int min_sum = static_cast<int>(std::ceil(min_score * 255.0 * points.size()));
+  auto pruned = [&](int bound) {
+      if (bound < min_sum) {
+        return true;
+      }
+      return static_cast<int>(candidates.size()) == max_candidates &&
+             bound <= candidates.back().score * 255.0 * points.size();
+    };
+
+  // Depth first, the best node first at each level, so that good leaves are found
+  // early and prune the rest
+  std::vector<Node> stack;
+  const int top = 1 << depth_;
+  for (int a = 0; a < angles; a++) {
+    for (int y = 0; y < map_->size_y; y += top) {
+      for (int x = 0; x < map_->size_x; x += top) {
+        Node node{a, x, y, depth_, 0};
+        node.bound = score(node, offsets[a]);
+        if (node.bound >= min_sum) {
+          stack.push_back(node);
+        }
+      }
+    }
+  }
+  std::sort(
+    stack.begin(), stack.end(), [](const Node & a, const Node & b) {
+      return a.bound < b.bound;
+    });
+
+  std::array<Node, 4> children;
+  while (!stack.empty()) {
+    const Node node = stack.back();
+    stack.pop_back();
+    if (pruned(node.bound)) {
+      continue;
+    }
+
+    if (node.level == 0) {
+      if (map_->cells[MAP_INDEX(map_, node.x, node.y)].occ_state == -1) {
+        addCandidate(
+          node, node.angle * step - M_PI,
+          node.bound / (255.0 * points.size()), max_candidates, candidates);
+      }
+      continue;
+    }
+
+    const int shift = 1 << (node.level - 1);
+    int children_count = 0;
+    for (int i = 0; i < 4; i++) {
+      Node child{node.angle, node.x + (i % 2) * shift, node.y + (i / 2) * shift,
+        node.level - 1, 0};
+      if (child.x >= map_->size_x || child.y >= map_->size_y) {
+        continue;
+      }
+      child.bound = score(child, offsets[node.angle]);
+      children[children_count++] = child;
+    }
+    std::sort(
+      children.begin(), children.begin() + children_count,
+      [](const Node & a, const Node & b) {
+        return a.bound < b.bound;
+      });
+    for (int i = 0; i < children_count; i++) {
+      if (!pruned(children[i].bound)) {
+        stack.push_back(children[i]);
+      }
+    }
+  }
+
+  return candidates;
+}
+
+int GlobalScanMatcher::score(
+  const Node & node, const std::vector<std::array<int, 2>> & offsets) const
+{
+  const std::vector<uint8_t> & grid = grids_[node.level];
+  const int width = 1 << node.level;
+  int sum = 0;
+  for (const auto & offset : offsets) {
+    // A square overlapping the map from below is bounded by the square at its edge
+    int x = node.x + offset[0];
+    int y = node.y + offset[1];
+    if (x < 0 && x + width > 0) {
+      x = 0;
+    }
+    if (y < 0 && y + width > 0) {
+      y = 0;
+    }
+    if (MAP_VALID(map_, x, y)) {
+      sum += grid[MAP_INDEX(map_, x, y)];
+    }
+  }
+  return sum;
+}
+
+void GlobalScanMatcher::addCandidate(
+  const Node & leaf, double angle, double score, int max_candidates,
+  std::vector<Candidate> & candidates) const
+{
+  Candidate candidate;
+  candidate.pose.v[0] = MAP_WXGX(map_, leaf.x);
+  candidate.pose.v[1] = MAP_WYGY(map_, leaf.y);
+  candidate.pose.v[2] = angle;
+  candidate.score = score;
+
+  // Poses within a meter and 30 degrees are the same hypothesis, keep the best one
+  bool replaced = false;
+  for (auto & other : candidates) {
+    const double dx = other.pose.v[0] - candidate.pose.v[0];
+    const double dy = other.pose.v[1] - candidate.pose.v[1];
+    const double da = atan2(
+      sin(other.pose.v[2] - candidate.pose.v[2]), cos(other.pose.v[2] - candidate.pose.v[2]));
+    if (dx * dx + dy * dy < 1.0 && std::abs(da) < M_PI / 6.0) {
+      if (candidate.score <= other.score) {
+        return;
+      }
+      other = candidate;
+      replaced = true;
+      break;
+    }
+  }
+  if (!replaced) {
+    candidates.push_back(candidate);
+  }
+
+  std::sort(
+    candidates.begin(), candidates.end(), [](const Candidate & a, const Candidate & b) {
+      return a.score > b.score;
+    });
+  if (static_cast<int>(candidates.size()) > max_candidates) {
+    candidates.resize(max_candidates);
+  }
+}
+
+}  // namespace nav2_amcl
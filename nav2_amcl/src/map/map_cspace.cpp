@@ -20,129 +20,218 @@
  */
 
 #include <math.h>
+#include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
-#include <queue>
+#include <algorithm>
+#include <fstream>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <vector>
 #include "nav2_amcl/map/map.hpp"
+#include "nav2_util/thread_pool.hpp"
 
 /*
- * @class CellData
- * @brief Data about map cells
+ * @class CspaceCache
+ * @brief Key of the last map whose cspace was computed, so that the cspace of the
+ * same map is not computed again, e.g. by each laser. Only a hash of the cells, with
+ * their distances, is kept rather than a copy of the map, not to grow the memory used
+ * by large maps. Hashing the distances too, a new map with the same occupancy does not
+ * match until its distances are computed
  */
-class CellData
-{
-public:
-  map_t * map_;
-  unsigned int i_, j_;
-  unsigned int src_i_, src_j_;
-};
-
-/*
- * @class CachedDistanceMap
- * @brief Cached map with distances
- */
-class CachedDistanceMap
+class CspaceCache
 {
 public:
   /*
-   * @brief CachedDistanceMap constructor
+   * @brief Hash of the cells of a map
    */
-  CachedDistanceMap(double scale, double max_dist)
-  : distances_(NULL), scale_(scale), max_dist_(max_dist)
+  static uint64_t hash(const map_t * map)
   {
-    cell_radius_ = max_dist / scale;
-    distances_ = new double *[cell_radius_ + 2];
-    for (int i = 0; i <= cell_radius_ + 1; i++) {
-      distances_[i] = new double[cell_radius_ + 2];
-      for (int j = 0; j <= cell_radius_ + 1; j++) {
-        distances_[i][j] = sqrt(i * i + j * j);
-      }
+    // FNV-1a
+    uint64_t hash = 14695981039346656037ull;
+    const uint8_t * bytes = reinterpret_cast<const uint8_t *>(map->cells);
+    const size_t size = static_cast<size_t>(map->size_x) * map->size_y * sizeof(map_cell_t);
+    for (size_t i = 0; i < size; i++) {
+      hash = (hash ^ bytes[i]) * 1099511628211ull;
     }
+    return hash;
   }
 
   /*
-   * @brief CachedDistanceMap destructor
+   * @brief Whether the cells of a map already hold its distances
    */
-  ~CachedDistanceMap()
+  bool matches(const map_t * map, double max_occ_dist, uint64_t hash) const
   {
-    if (distances_) {
-      for (int i = 0; i <= cell_radius_ + 1; i++) {
-        delete[] distances_[i];
-      }
-      delete[] distances_;
-    }
+    return size_x_ == map->size_x && size_y_ == map->size_y && scale_ == map->scale &&
+           max_occ_dist_ == max_occ_dist && hash_ == hash;
   }
-  double ** distances_;
-  double scale_;
-  double max_dist_;
-  int cell_radius_;
+
+  std::mutex mutex_;
+  int size_x_{0}, size_y_{0};
+  double scale_{0.0};
+  double max_occ_dist_{0.0};
+  uint64_t hash_{0};
 };
 
 /*
- * @brief operator<
+ * @brief Lower envelope of the parabolas rooted at each sample of a line,
+ * giving the squared distance transform of the line in linear time
+ * (Felzenszwalb and Huttenlocher, Distance Transforms of Sampled Functions)
+ * @param f Squared distances of the samples, input
+ * @param n Number of samples
+ * @param d Squared distances of the samples, output
+ * @param v Scratch, n parabola roots
+ * @param z Scratch, n + 1 parabola boundaries
  */
-bool operator<(const CellData & a, const CellData & b)
+static void distance_transform_1d(const double * f, int n, double * d, int * v, double * z)
 {
-  return a.map_->cells[MAP_INDEX(
-             a.map_, a.i_,
-             a.j_)].occ_dist > a.map_->cells[MAP_INDEX(b.map_, b.i_, b.j_)].occ_dist;
+  int k = 0;
+  v[0] = 0;
+  z[0] = -HUGE_VAL;
+  z[1] = HUGE_VAL;
+  for (int q = 1; q < n; q++) {
+    const double fq = f[q] + static_cast<double>(q) * q;
+    double s = (fq - (f[v[k]] + static_cast<double>(v[k]) * v[k])) / (2.0 * (q - v[k]));
+    while (s <= z[k]) {
+      k--;
+      s = (fq - (f[v[k]] + static_cast<double>(v[k]) * v[k])) / (2.0 * (q - v[k]));
+    }
+    k++;
+    v[k] = q;
+    z[k] = s;
+    z[k + 1] = HUGE_VAL;
+  }
+
+  k = 0;
+  for (int q = 0; q < n; q++) {
+    while (z[k + 1] < q) {
+      k++;
+    }
+    const double dq = q - v[k];
+    d[q] = dq * dq + f[v[k]];
+  }
 }
 
 /*
- * @brief get_distance_map
- * @param scale of cost information wrt distance
- * @param max_dist Maximum distance to cache from occupied information
- * @return Pointer to cached distance map
+ * @brief Header of a cspace cache file, identifying the map and distance it was
+ * computed for. The distances follow as a raw array of floats, row by row, so that the
+ * file can also be memory mapped
  */
-CachedDistanceMap *
-get_distance_map(double scale, double max_dist)
+struct CspaceFileHeader
 {
-  static CachedDistanceMap * cdm = NULL;
+  char magic[8];
+  int32_t size_x;
+  int32_t size_y;
+  double scale;
+  double max_occ_dist;
+  uint64_t occ_hash;
+};
 
-  if (!cdm || (cdm->scale_ != scale) || (cdm->max_dist_ != max_dist)) {
-    if (cdm) {
-      delete cdm;
-    }
-    cdm = new CachedDistanceMap(scale, max_dist);
-  }
+static const char kCspaceMagic[8] = {'A', 'M', 'C', 'L', 'C', 'S', 'P', '1'};
 
-  return cdm;
+/*
+ * @brief Path of the cache file of the cspace of a map, named after a hash of the
+ * occupancy of its cells and of the parameters of the cspace
+ */
+static std::string cspace_cache_path(
+  const map_t * map, double max_occ_dist, const char * cache_directory)
+{
+  // FNV-1a, continued from the hash of the cells
+  uint64_t hash = map_occ_hash(map);
+  auto add = [&hash](const void * data, size_t size) {
+      const uint8_t * bytes = static_cast<const uint8_t *>(data);
+      for (size_t i = 0; i < size; i++) {
+        hash = (hash ^ bytes[i]) * 1099511628211ull;
+      }
+    };
+  add(&map->size_x, sizeof(map->size_x));
+  add(&map->size_y, sizeof(map->size_y));
+  add(&map->scale, sizeof(map->scale));
+  add(&max_occ_dist, sizeof(max_occ_dist));
+
+  std::ostringstream path;
+  path << cache_directory << "/amcl_cspace_" << std::hex << hash << ".bin";
+  return path.str();
 }
 
 /*
- * @brief enqueue cell data for caching
+ * @brief Load the cspace distances of a map from its cache file
+ * @return Whether the file held the distances of this map and max_occ_dist
  */
-void enqueue(
-  map_t * map, int i, int j,
-  int src_i, int src_j,
-  std::priority_queue<CellData> & Q,
-  CachedDistanceMap * cdm,
-  unsigned char * marked)
+static bool load_cspace(map_t * map, double max_occ_dist, const std::string & filepath)
 {
-  if (marked[MAP_INDEX(map, i, j)]) {
-    return;
+  std::ifstream file(filepath, std::ios::binary);
+  CspaceFileHeader header;
+  if (!file.read(reinterpret_cast<char *>(&header), sizeof(header)) ||
+    memcmp(header.magic, kCspaceMagic, sizeof(kCspaceMagic)) != 0 ||
+    header.size_x != map->size_x || header.size_y != map->size_y ||
+    header.scale != map->scale || header.max_occ_dist != max_occ_dist ||
+    header.occ_hash != map_occ_hash(map))
+  {
+    return false;
   }
 
-  int di = abs(i - src_i);
-  int dj = abs(j - src_j);
-  double distance = cdm->distances_[di][dj];
-
-  if (distance > cdm->cell_radius_) {
-    return;
+  const size_t size = static_cast<size_t>(map->size_x) * map->size_y;
+  std::vector<float> distances(size);
+  if (!file.read(reinterpret_cast<char *>(distances.data()), sizeof(float) * size)) {
+    return false;
   }
+  for (size_t i = 0; i < size; i++) {
+    map->cells[i].occ_dist = distances[i];
+  }
+  return true;
+}
 
-  map->cells[MAP_INDEX(map, i, j)].occ_dist = distance * map->scale;
-
-  CellData cell;
-  cell.map_ = map;
-  cell.i_ = i;
-  cell.j_ = j;
-  cell.src_i_ = src_i;
-  cell.src_j_ = src_j;
+/*
+ * @brief Save the cspace distances of a map to its cache file, replacing it atomically
+ * so that nodes sharing the cache never read a partial file
+ */
+static void save_cspace(const map_t * map, double max_occ_dist, const std::string & filepath)
+{
+  const std::string tmp_filepath = filepath + ".tmp";
+  {
+    std::ofstream file(tmp_filepath, std::ios::binary | std::ios::trunc);
+    CspaceFileHeader header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, kCspaceMagic, sizeof(kCspaceMagic));
+    header.size_x = map->size_x;
+    header.size_y = map->size_y;
+    header.scale = map->scale;
+    header.max_occ_dist = max_occ_dist;
+    header.occ_hash = map_occ_hash(map);
+    file.write(reinterpret_cast<const char *>(&header), sizeof(header));
 
-  Q.push(cell);
+    const size_t size = static_cast<size_t>(map->size_x) * map->size_y;
+    std::vector<float> distances(size);
+    for (size_t i = 0; i < size; i++) {
+      distances[i] = map->cells[i].occ_dist;
+    }
+    file.write(reinterpret_cast<const char *>(distances.data()), sizeof(float) * size);
+    if (!file) {
+      file.close();
+      remove(tmp_filepath.c_str());
+      return;
+    }
+  }
+  rename(tmp_filepath.c_str(), filepath.c_str());
+}
 
-  marked[MAP_INDEX(map, i, j)] = 1;
+/*
+ * @brief Hash of the occupancy of the cells of a map
+ * @param map Map to hash
+ */
+uint64_t map_occ_hash(const map_t * map)
+{
+  // FNV-1a
+  uint64_t hash = 14695981039346656037ull;
+  const size_t size = static_cast<size_t>(map->size_x) * map->size_y;
+  for (size_t i = 0; i < size; i++) {
+    hash = (hash ^ static_cast<uint8_t>(map->cells[i].occ_state)) * 1099511628211ull;
+  }
+  return hash;
 }
 
 /*
@@ -152,62 +241,128 @@ void enqueue(
  */
 void map_update_cspace(map_t * map, double max_occ_dist)
 {
-  unsigned char * marked;
-  std::priority_queue<CellData> Q;
+  map_update_cspace_cached(map, max_occ_dist, 1, nullptr);
+}
+
+/*
+ * @brief Update the cspace distance values, splitting the lines over several threads
+ * @param map Map to update
+ * @param max_occ_distance Maximum distance for occpuancy interest
+ * @param num_threads Number of threads computing the distances, the calling one included
+ */
+void map_update_cspace_threads(map_t * map, double max_occ_dist, int num_threads)
+{
+  map_update_cspace_cached(map, max_occ_dist, num_threads, nullptr);
+}
 
-  marked = new unsigned char[map->size_x * map->size_y];
-  memset(marked, 0, sizeof(unsigned char) * map->size_x * map->size_y);
+/*
+ * @brief Update the cspace distance values, loading them from a cache directory when
+ * computed before for the same map, and saving them there otherwise
+ * @param map Map to update
+ * @param max_occ_distance Maximum distance for occpuancy interest
+ * @param num_threads Number of threads computing the distances, the calling one included
+ * @param cache_directory Directory of the cache files, null or empty not to cache
+ */
+void map_update_cspace_cached(
+  map_t * map, double max_occ_dist, int num_threads, const char * cache_directory)
+{
+  static CspaceCache cache;
+  std::lock_guard<std::mutex> lock(cache.mutex_);
 
   map->max_occ_dist = max_occ_dist;
+  const int size_x = map->size_x;
+  const int size_y = map->size_y;
+  const size_t size = static_cast<size_t>(size_x) * size_y;
 
-  CachedDistanceMap * cdm = get_distance_map(map->scale, map->max_occ_dist);
-
-  // Enqueue all the obstacle cells
-  CellData cell;
-  cell.map_ = map;
-  for (int i = 0; i < map->size_x; i++) {
-    cell.src_i_ = cell.i_ = i;
-    for (int j = 0; j < map->size_y; j++) {
-      if (map->cells[MAP_INDEX(map, i, j)].occ_state == +1) {
-        map->cells[MAP_INDEX(map, i, j)].occ_dist = 0.0;
-        cell.src_j_ = cell.j_ = j;
-        marked[MAP_INDEX(map, i, j)] = 1;
-        Q.push(cell);
-      } else {
-        map->cells[MAP_INDEX(map, i, j)].occ_dist = max_occ_dist;
-      }
-    }
+  if (cache.matches(map, max_occ_dist, CspaceCache::hash(map))) {
+    return;
   }
 
-  while (!Q.empty()) {
-    CellData current_cell = Q.top();
-    if (current_cell.i_ > 0) {
-      enqueue(
-        map, current_cell.i_ - 1, current_cell.j_,
-        current_cell.src_i_, current_cell.src_j_,
-        Q, cdm, marked);
-    }
-    if (current_cell.j_ > 0) {
-      enqueue(
-        map, current_cell.i_, current_cell.j_ - 1,
-        current_cell.src_i_, current_cell.src_j_,
-        Q, cdm, marked);
-    }
-    if (static_cast<int>(current_cell.i_) < map->size_x - 1) {
-      enqueue(
-        map, current_cell.i_ + 1, current_cell.j_,
-        current_cell.src_i_, current_cell.src_j_,
-        Q, cdm, marked);
-    }
-    if (static_cast<int>(current_cell.j_) < map->size_y - 1) {
-      enqueue(
-        map, current_cell.i_, current_cell.j_ + 1,
-        current_cell.src_i_, current_cell.src_j_,
-        Q, cdm, marked);
+  auto remember = [&]() {
+      cache.size_x_ = size_x;
+      cache.size_y_ = size_y;
+      cache.scale_ = map->scale;
+      cache.max_occ_dist_ = max_occ_dist;
+      cache.hash_ = CspaceCache::hash(map);
+    };
+
+  std::string cache_filepath;
+  if (cache_directory && cache_directory[0] != '\0') {
+    cache_filepath = cspace_cache_path(map, max_occ_dist, cache_directory);
+    if (load_cspace(map, max_occ_dist, cache_filepath)) {
+      remember();
+      return;
     }
+  }
+
+  // Exact squared Euclidean distances in cells, rows then columns. Cells with
+  // no obstacle start at a bound larger than any distance on the map, so that
+  // the arithmetic stays exact in double precision
+  const double far = 2.0 * (static_cast<double>(size_x) * size_x +
+    static_cast<double>(size_y) * size_y) + 1.0;
+  std::vector<double> squared(size);
+  for (size_t i = 0; i < size; i++) {
+    squared[i] = map->cells[i].occ_state == +1 ? 0.0 : far;
+  }
 
-    Q.pop();
+  // Each block of lines gets its own scratch buffers
+  std::unique_ptr<nav2_util::ThreadPool> pool;
+  if (num_threads > 1) {
+    pool = std::make_unique<nav2_util::ThreadPool>(num_threads - 1);
   }
+  auto for_each_line = [&](int lines, const std::function<void(int, int)> & fn) {
+      if (!pool) {
+        fn(0, lines);
+        return;
+      }
+      const int blocks = std::min(lines, 4 * num_threads);
+      pool->parallelFor(
+        0, blocks, [&](size_t block) {
+          fn(
+            static_cast<int>(block * lines / blocks),
+            static_cast<int>((block + 1) * lines / blocks));
+        });
+    };
 
-  delete[] marked;
+  const int max_size = std::max(size_x, size_y);
+  for_each_line(
+    size_y, [&](int begin, int end) {
+      std::vector<double> d(max_size);
+      std::vector<int> v(max_size);
+      std::vector<double> z(max_size + 1);
+      for (int j = begin; j < end; j++) {
+        double * row = squared.data() + static_cast<size_t>(j) * size_x;
+        distance_transform_1d(row, size_x, d.data(), v.data(), z.data());
+        std::copy(d.begin(), d.begin() + size_x, row);
+      }
+    });
+
+  for_each_line(
+    size_x, [&](int begin, int end) {
+      std::vector<double> f(max_size), d(max_size);
+      std::vector<int> v(max_size);
+      std::vector<double> z(max_size + 1);
+      for (int i = begin; i < end; i++) {
+        for (int j = 0; j < size_y; j++) {
+          f[j] = squared[MAP_INDEX(map, i, j)];
+        }
+        distance_transform_1d(f.data(), size_y, d.data(), v.data(), z.data());
+        for (int j = 0; j < size_y; j++) {
+          squared[MAP_INDEX(map, i, j)] = d[j];
+        }
+      }
+    });
+
+  // Cells farther than the whole number of cells of max_occ_dist are at max_occ_dist
+  const int cell_radius = max_occ_dist / map->scale;
+  const double max_squared = static_cast<double>(cell_radius) * cell_radius;
+  for (size_t i = 0; i < size; i++) {
+    map->cells[i].occ_dist = squared[i] > max_squared ?
+      max_occ_dist : sqrt(squared[i]) * map->scale;
+  }
+
+  if (!cache_filepath.empty()) {
+    save_cspace(map, max_occ_dist, cache_filepath);
+  }
+  remember();
 }
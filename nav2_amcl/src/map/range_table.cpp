@@ -0,0 +1,268 @@
+// Copyright (c) 2024 Open Navigation LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "nav2_amcl/map/range_table.hpp"
+
+#include <math.h>
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace nav2_amcl
+{
+
+namespace
+{
+
+const char kMagic[8] = {'A', 'M', 'C', 'L', 'C', 'D', 'T', '1'};
+
+/*
+ * @brief Header of a table file, identifying the map and headings it was computed for
+ */
+struct FileHeader
+{
+  char magic[8];
+  int32_t size_x;
+  int32_t size_y;
+  double scale;
+  int32_t headings;
+  uint64_t hash;
+  uint64_t lanes;
+  uint64_t obstacles;
+};
+
+template<typename T>
+bool readVector(std::ifstream & file, std::vector<T> & values, size_t size)
+{
+  values.resize(size);
+  file.read(reinterpret_cast<char *>(values.data()), sizeof(T) * size);
+  return static_cast<bool>(file);
+}
+
+template<typename T>
+void writeVector(std::ofstream & file, const std::vector<T> & values)
+{
+  file.write(reinterpret_cast<const char *>(values.data()), sizeof(T) * values.size());
+}
+
+}  // namespace
+
+RangeTable::RangeTable(const map_t * map)
+: map_(map), headings_(0), heading_resolution_(0.0)
+{
+}
+
+RangeTable::RangeTable(const map_t * map, int headings)
+: RangeTable(map)
+{
+  headings_ = std::max(headings, 1);
+  heading_resolution_ = M_PI / headings_;
+
+  // Obstacles next to a free cell, including the cells just outside the map
+  auto free = [map](int i, int j) {
+      return MAP_VALID(map, i, j) && map->cells[MAP_INDEX(map, i, j)].occ_state == -1;
+    };
+  std::vector<std::array<int, 2>> edges;
+  for (int j = -1; j <= map->size_y; j++) {
+    for (int i = -1; i <= map->size_x; i++) {
+      if (free(i, j)) {
+        continue;
+      }
+      bool edge = false;
+      for (int dj = -1; dj <= 1 && !edge; dj++) {
+        for (int di = -1; di <= 1 && !edge; di++) {
+          edge = free(i + di, j + dj);
+        }
+      }
+      if (edge) {
+        edges.push_back({i, j});
+      }
+    }
+  }
+
+  first_lane_.assign(1, 0);
+  lane_begin_.assign(1, 0);
+  std::vector<uint32_t> lane_obstacles;
+  for (int heading = 0; heading < headings_; heading++) {
+    const double c = cos(heading * heading_resolution_), s = sin(heading * heading_resolution_);
+    cos_.push_back(c);
+    sin_.push_back(s);
+
+    // Lanes of a cell wide across the map. An obstacle is in the lanes whose center
+    // line crosses its cell, of a half width r across the heading
+    const double r = 0.5 * (fabs(c) + fabs(s));
+    double v_min = 0.0, v_max = 0.0;
+    for (const auto & corner : std::array<std::array<int, 2>, 4>{
+        {{-1, -1}, {map->size_x, -1}, {-1, map->size_y}, {map->size_x, map->size_y}}})
+    {
+      const double v = -corner[0] * s + corner[1] * c;
+      v_min = std::min(v_min, v);
+      v_max = std::max(v_max, v);
+    }
+    const double origin = v_min - r;
+    const size_t lanes = static_cast<size_t>(floor(v_max + r - origin)) + 1;
+    lane_origin_.push_back(origin);
+
+    // Counted, then filled and sorted per lane
+    lane_obstacles.assign(lanes, 0);
+    for (const auto & cell : edges) {
+      const double v = -cell[0] * s + cell[1] * c - origin;
+      const size_t last = std::min(static_cast<size_t>(v + r - 0.5), lanes - 1);
+      for (size_t lane = static_cast<size_t>(ceil(v - r - 0.5)); lane <= last; lane++) {
+        lane_obstacles[lane]++;
+      }
+    }
+    const size_t first = lane_begin_.size() - 1;
+    for (size_t lane = 0; lane < lanes; lane++) {
+      lane_begin_.push_back(lane_begin_.back() + lane_obstacles[lane]);
+      lane_obstacles[lane] = lane_begin_[first + lane];
+    }
+    first_lane_.push_back(lane_begin_.size() - 1);
+
+    obstacles_.resize(lane_begin_.back());
+    for (const auto & cell : edges) {
+      const double u = cell[0] * c + cell[1] * s;
+      const double v = -cell[0] * s + cell[1] * c - origin;
+      const size_t last = std::min(static_cast<size_t>(v + r - 0.5), lanes - 1);
+      for (size_t lane = static_cast<size_t>(ceil(v - r - 0.5)); lane <= last; lane++) {
+        obstacles_[lane_obstacles[lane]++] = static_cast<float>(u);
+      }
+    }
+    for (size_t lane = first; lane < first + lanes; lane++) {
+      std::sort(
+        obstacles_.begin() + lane_begin_[lane], obstacles_.begin() + lane_begin_[lane + 1]);
+    }
+  }
+}
+
+std::unique_ptr<RangeTable>
+RangeTable::load(const map_t * map, int headings, const std::string & filename)
+{
+  std::ifstream file(filename, std::ios::binary);
+  FileHeader header;
+  if (!file.read(reinterpret_cast<char *>(&header), sizeof(header))) {
+    return nullptr;
+  }
+
+  std::unique_ptr<RangeTable> table(new RangeTable(map));
+  if (memcmp(header.magic, kMagic, sizeof(kMagic)) != 0 ||
+    header.size_x != map->size_x || header.size_y != map->size_y ||
+    header.scale != map->scale || header.headings != std::max(headings, 1) ||
+    header.hash != table->hash())
+  {
+    return nullptr;
+  }
+
+  table->headings_ = header.headings;
+  table->heading_resolution_ = M_PI / table->headings_;
+  for (int heading = 0; heading < table->headings_; heading++) {
+    table->cos_.push_back(cos(heading * table->heading_resolution_));
+    table->sin_.push_back(sin(heading * table->heading_resolution_));
+  }
+  if (!readVector(file, table->lane_origin_, header.headings) ||
+    !readVector(file, table->first_lane_, header.headings + 1) ||
+    !readVector(file, table->lane_begin_, header.lanes + 1) ||
+    !readVector(file, table->obstacles_, header.obstacles) ||
+    table->first_lane_.back() != header.lanes || table->lane_begin_.back() != header.obstacles)
+  {
+    return nullptr;
+  }
+  return table;
+}
+
+bool
+RangeTable::save(const std::string & filename) const
+{
+  std::ofstream file(filename, std::ios::binary | std::ios::trunc);
+  FileHeader header;
+  memcpy(header.magic, kMagic, sizeof(kMagic));
+  header.size_x = map_->size_x;
+  header.size_y = map_->size_y;
+  header.scale = map_->scale;
+  header.headings = headings_;
+  header.hash = hash();
+  header.lanes = lane_begin_.size() - 1;
+  header.obstacles = obstacles_.size();
+  file.write(reinterpret_cast<const char *>(&header), sizeof(header));
+  writeVector(file, lane_origin_);
+  writeVector(file, first_lane_);
+  writeVector(file, lane_begin_);
+  writeVector(file, obstacles_);
+  file.close();
+  return static_cast<bool>(file);
+}
+
+double
+RangeTable::calcRange(double ox, double oy, double oa, double max_range) const
+{
+  // As map_calc_range, nothing is seen from outside the map or inside an obstacle
+  const int i = MAP_GXWX(map_, ox), j = MAP_GYWY(map_, oy);
+  if (!MAP_VALID(map_, i, j) || map_->cells[MAP_INDEX(map_, i, j)].occ_state > -1) {
+    return 0.0;
+  }
+
+  // Nearest heading, the half turn above being read backwards
+  double a = fmod(oa, 2.0 * M_PI);
+  if (a < 0.0) {
+    a += 2.0 * M_PI;
+  }
+  int heading = static_cast<int>(a / heading_resolution_ + 0.5) % (2 * headings_);
+  const bool forward = heading < headings_;
+  if (!forward) {
+    heading -= headings_;
+  }
+
+  // Cell coordinates, of the cell centers at integers
+  const double x = (ox - map_->origin_x) / map_->scale + map_->size_x / 2;
+  const double y = (oy - map_->origin_y) / map_->scale + map_->size_y / 2;
+  const double u = x * cos_[heading] + y * sin_[heading];
+  const double v = -x * sin_[heading] + y * cos_[heading] - lane_origin_[heading];
+  const uint32_t lane = first_lane_[heading] + static_cast<uint32_t>(v);
+  const auto begin = obstacles_.begin() + lane_begin_[lane];
+  const auto end = obstacles_.begin() + lane_begin_[lane + 1];
+
+  double range;
+  if (forward) {
+    const auto hit = std::upper_bound(begin, end, static_cast<float>(u));
+    if (hit == end) {
+      return max_range;
+    }
+    range = *hit - u;
+  } else {
+    const auto hit = std::lower_bound(begin, end, static_cast<float>(u));
+    if (hit == begin) {
+      return max_range;
+    }
+    range = u - *(hit - 1);
+  }
+  return std::min(range * map_->scale, max_range);
+}
+
+uint64_t
+RangeTable::hash() const
+{
+  // FNV-1a
+  uint64_t hash = 14695981039346656037ull;
+  const size_t size = static_cast<size_t>(map_->size_x) * map_->size_y;
+  for (size_t i = 0; i < size; i++) {
+    hash = (hash ^ static_cast<uint8_t>(map_->cells[i].occ_state)) * 1099511628211ull;
+  }
+  return hash;
+}
+
+}  // namespace nav2_amcl
@@ -24,6 +24,22 @@
 namespace nav2_amcl
 {
 
+namespace
+{
+
+/*
+ * @brief Wrap an angle in [-pi, pi], as angleutils::normalize without the trigonometry
+ */
+inline double wrapAngle(double a)
+{
+  if (a > M_PI || a < -M_PI) {
+    a -= 2.0 * M_PI * floor((a + M_PI) / (2.0 * M_PI));
+  }
+  return a;
+}
+
+}  // namespace
+
 void
 DifferentialMotionModel::initialize(
   double alpha1, double alpha2, double alpha3, double alpha4,
@@ -49,7 +65,6 @@ DifferentialMotionModel::odometryUpdate(
 
   // Implement sample_motion_odometry (Prob Rob p 136)
   double delta_rot1, delta_trans, delta_rot2;
-  double delta_rot1_hat, delta_trans_hat, delta_rot2_hat;
   double delta_rot1_noise, delta_rot2_noise;
 
   // Avoid computing a bearing from two poses that are extremely near each
@@ -79,36 +94,41 @@ DifferentialMotionModel::odometryUpdate(
     fabs(angleutils::angle_diff(delta_rot2, 0.0)),
     fabs(angleutils::angle_diff(delta_rot2, M_PI)));
 
-  for (int i = 0; i < set->sample_count; i++) {
-    pf_sample_t * sample = set->samples + i;
-
-    // Sample pose differences
-    delta_rot1_hat = angleutils::angle_diff(
-      delta_rot1,
-      pf_ran_gaussian(
-        sqrt(
-          alpha1_ * delta_rot1_noise * delta_rot1_noise +
-          alpha2_ * delta_trans * delta_trans)));
-    delta_trans_hat = delta_trans -
-      pf_ran_gaussian(
-      sqrt(
-        alpha3_ * delta_trans * delta_trans +
-        alpha4_ * delta_rot1_noise * delta_rot1_noise +
-        alpha4_ * delta_rot2_noise * delta_rot2_noise));
-    delta_rot2_hat = angleutils::angle_diff(
-      delta_rot2,
-      pf_ran_gaussian(
-        sqrt(
-          alpha1_ * delta_rot2_noise * delta_rot2_noise +
-          alpha2_ * delta_trans * delta_trans)));
-
-    // Apply sampled update to particle pose
-    sample->pose.v[0] += delta_trans_hat *
-      cos(sample->pose.v[2] + delta_rot1_hat);
-    sample->pose.v[1] += delta_trans_hat *
-      sin(sample->pose.v[2] + delta_rot1_hat);
-    sample->pose.v[2] += delta_rot1_hat + delta_rot2_hat;
-  }
+  // Standard deviations of the sampled pose differences, the same for all samples
+  const double rot1_stddev = sqrt(
+    alpha1_ * delta_rot1_noise * delta_rot1_noise +
+    alpha2_ * delta_trans * delta_trans);
+  const double trans_stddev = sqrt(
+    alpha3_ * delta_trans * delta_trans +
+    alpha4_ * delta_rot1_noise * delta_rot1_noise +
+    alpha4_ * delta_rot2_noise * delta_rot2_noise);
+  const double rot2_stddev = sqrt(
+    alpha1_ * delta_rot2_noise * delta_rot2_noise +
+    alpha2_ * delta_trans * delta_trans);
+
+  const int count = set->sample_count;
+  reserveNoise(3, count);
+  forEachSampleBlock(
+    count, [&](int begin, int end) {
+      drawNoise(begin, end);
+      const double * rot1_noise = noise_.data();
+      const double * trans_noise = rot1_noise + count;
+      const double * rot2_noise = trans_noise + count;
+
+      for (int i = begin; i < end; i++) {
+        // Sample pose differences. delta_rot1 and delta_rot2 being normalized already,
+        // their angle_diff to the noise only wraps the difference
+        double delta_rot1_hat = wrapAngle(delta_rot1 - rot1_stddev * rot1_noise[i]);
+        double delta_trans_hat = delta_trans - trans_stddev * trans_noise[i];
+        double delta_rot2_hat = wrapAngle(delta_rot2 - rot2_stddev * rot2_noise[i]);
+
+        // Apply sampled update to particle pose
+        const double theta = set->theta[i];
+        set->x[i] += delta_trans_hat * cos(theta + delta_rot1_hat);
+        set->y[i] += delta_trans_hat * sin(theta + delta_rot1_hat);
+        set->theta[i] = theta + delta_rot1_hat + delta_rot2_hat;
+      }
+    });
 }
 
 }  // namespace nav2_amcl
@@ -0,0 +1,75 @@
+// Copyright (c) 2024 Open Navigation LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "nav2_amcl/motion_model/motion_model.hpp"
+
+#include <stdlib.h>
+#include <algorithm>
+#include <memory>
+
+namespace nav2_amcl
+{
+
+MotionModel::MotionModel()
+{
+  // Seeded as the particle filter, so that runs seeded alike sample alike
+  sampler_.seed(static_cast<uint64_t>(drand48() * 9007199254740992.0));
+}
+
+void
+MotionModel::setNumThreads(unsigned int num_threads)
+{
+  thread_pool_.reset();
+  if (num_threads > 1) {
+    // The updating thread samples particles as well
+    thread_pool_ = std::make_unique<nav2_util::ThreadPool>(num_threads - 1);
+  }
+}
+
+void
+MotionModel::reserveNoise(int draws, int sample_count)
+{
+  noise_counter_ += static_cast<uint64_t>(noise_draws_) * noise_samples_;
+  noise_draws_ = draws;
+  noise_samples_ = sample_count;
+  noise_.resize(static_cast<size_t>(draws) * sample_count);
+}
+
+void
+MotionModel::drawNoise(int begin, int end)
+{
+  for (int draw = 0; draw < noise_draws_; draw++) {
+    const size_t offset = static_cast<size_t>(draw) * noise_samples_ + begin;
+    sampler_.fill(noise_counter_ + offset, noise_.data() + offset, end - begin);
+  }
+}
+
+void
+MotionModel::forEachSampleBlock(int sample_count, const std::function<void(int, int)> & fn)
+{
+  if (!thread_pool_) {
+    fn(0, sample_count);
+    return;
+  }
+
+  const int num_blocks = static_cast<int>(thread_pool_->size()) + 1;
+  const int block_size = (sample_count + num_blocks - 1) / num_blocks;
+  thread_pool_->parallelFor(
+    0, num_blocks, [&](size_t block) {
+      const int begin = std::min(static_cast<int>(block) * block_size, sample_count);
+      fn(begin, std::min(begin + block_size, sample_count));
+    });
+}
+
+}  // namespace nav2_amcl
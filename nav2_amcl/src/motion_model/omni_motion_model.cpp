@@ -47,8 +47,7 @@ OmniMotionModel::odometryUpdate(
   set = pf->sets + pf->current_set;
   pf_vector_t old_pose = pf_vector_sub(pose, delta);
 
-  double delta_trans, delta_rot, delta_bearing;
-  double delta_trans_hat, delta_rot_hat, delta_strafe_hat;
+  double delta_trans, delta_rot;
 
   delta_trans = sqrt(
     delta.v[0] * delta.v[0] +
@@ -66,26 +65,37 @@ OmniMotionModel::odometryUpdate(
     alpha4_ * (delta_rot * delta_rot) +
     alpha5_ * (delta_trans * delta_trans) );
 
-  for (int i = 0; i < set->sample_count; i++) {
-    pf_sample_t * sample = set->samples + i;
+  // Bearing of the motion relative to the robot heading, the same for all samples
+  const double delta_bearing = angleutils::angle_diff(
+    atan2(delta.v[1], delta.v[0]),
+    old_pose.v[2]);
 
-    delta_bearing = angleutils::angle_diff(
-      atan2(delta.v[1], delta.v[0]),
-      old_pose.v[2]) + sample->pose.v[2];
-    double cs_bearing = cos(delta_bearing);
-    double sn_bearing = sin(delta_bearing);
+  const int count = set->sample_count;
+  reserveNoise(3, count);
+  forEachSampleBlock(
+    count, [&](int begin, int end) {
+      drawNoise(begin, end);
+      const double * trans_noise = noise_.data();
+      const double * rot_noise = trans_noise + count;
+      const double * strafe_noise = rot_noise + count;
 
-    // Sample pose differences
-    delta_trans_hat = delta_trans + pf_ran_gaussian(trans_hat_stddev);
-    delta_rot_hat = delta_rot + pf_ran_gaussian(rot_hat_stddev);
-    delta_strafe_hat = 0 + pf_ran_gaussian(strafe_hat_stddev);
-    // Apply sampled update to particle pose
-    sample->pose.v[0] += (delta_trans_hat * cs_bearing +
-      delta_strafe_hat * sn_bearing);
-    sample->pose.v[1] += (delta_trans_hat * sn_bearing -
-      delta_strafe_hat * cs_bearing);
-    sample->pose.v[2] += delta_rot_hat;
-  }
+      for (int i = begin; i < end; i++) {
+        const double theta = set->theta[i];
+        double cs_bearing = cos(delta_bearing + theta);
+        double sn_bearing = sin(delta_bearing + theta);
+
+        // Sample pose differences
+        double delta_trans_hat = delta_trans + trans_hat_stddev * trans_noise[i];
+        double delta_rot_hat = delta_rot + rot_hat_stddev * rot_noise[i];
+        double delta_strafe_hat = 0 + strafe_hat_stddev * strafe_noise[i];
+        // Apply sampled update to particle pose
+        set->x[i] += (delta_trans_hat * cs_bearing +
+          delta_strafe_hat * sn_bearing);
+        set->y[i] += (delta_trans_hat * sn_bearing -
+          delta_strafe_hat * cs_bearing);
+        set->theta[i] = theta + delta_rot_hat;
+      }
+    });
 }
 
 }  // namespace nav2_amcl
@@ -28,6 +28,7 @@
 #include <float.h>
 #include <assert.h>
 #include <math.h>
+#include <stdint.h>
 #include <stdlib.h>
 #include <time.h>
 
@@ -42,6 +43,9 @@
 // with samples in them.
 static int pf_resample_limit(pf_t * pf, int k);
 
+// Allocate the sample arrays of a set, each aligned and holding max_samples
+static void pf_sample_set_alloc(pf_sample_set_t * set, int max_samples);
+
 
 // Create a new filter
 pf_t * pf_alloc(
@@ -52,7 +56,6 @@ pf_t * pf_alloc(
   int i, j;
   pf_t * pf;
   pf_sample_set_t * set;
-  pf_sample_t * sample;
 
   srand48(time(NULL));
 
@@ -77,14 +80,13 @@ pf_t * pf_alloc(
     set = pf->sets + j;
 
     set->sample_count = max_samples;
-    set->samples = calloc(max_samples, sizeof(pf_sample_t));
+    pf_sample_set_alloc(set, max_samples);
 
     for (i = 0; i < set->sample_count; i++) {
-      sample = set->samples + i;
-      sample->pose.v[0] = 0.0;
-      sample->pose.v[1] = 0.0;
-      sample->pose.v[2] = 0.0;
-      sample->weight = 1.0 / max_samples;
+      set->x[i] = 0.0;
+      set->y[i] = 0.0;
+      set->theta[i] = 0.0;
+      set->weight[i] = 1.0 / max_samples;
     }
 
     // HACK: is 3 times max_samples enough?
@@ -118,7 +120,7 @@ void pf_free(pf_t * pf)
   for (i = 0; i < 2; i++) {
     free(pf->sets[i].clusters);
     pf_kdtree_free(pf->sets[i].kdtree);
-    free(pf->sets[i].samples);
+    free(pf->sets[i].sample_buffer);
   }
   free(pf);
 }
@@ -128,7 +130,6 @@ void pf_init(pf_t * pf, pf_vector_t mean, pf_matrix_t cov)
 {
   int i;
   pf_sample_set_t * set;
-  pf_sample_t * sample;
   pf_pdf_gaussian_t * pdf;
 
   set = pf->sets + pf->current_set;
@@ -142,12 +143,11 @@ void pf_init(pf_t * pf, pf_vector_t mean, pf_matrix_t cov)
 
   // Compute the new sample poses
   for (i = 0; i < set->sample_count; i++) {
-    sample = set->samples + i;
-    sample->weight = 1.0 / pf->max_samples;
-    sample->pose = pf_pdf_gaussian_sample(pdf);
+    set->weight[i] = 1.0 / pf->max_samples;
+    pf_sample_set_pose(set, i, pf_pdf_gaussian_sample(pdf));
 
     // Add sample to histogram
-    pf_kdtree_insert(set->kdtree, sample->pose, sample->weight);
+    pf_kdtree_insert(set->kdtree, pf_sample_get_pose(set, i), set->weight[i]);
   }
 
   pf->w_slow = pf->w_fast = 0.0;
@@ -167,7 +167,6 @@ void pf_init_model(pf_t * pf, pf_init_model_fn_t init_fn, void * init_data)
 {
   int i;
   pf_sample_set_t * set;
-  pf_sample_t * sample;
 
   set = pf->sets + pf->current_set;
 
@@ -178,12 +177,11 @@ void pf_init_model(pf_t * pf, pf_init_model_fn_t init_fn, void * init_data)
 
   // Compute the new sample poses
   for (i = 0; i < set->sample_count; i++) {
-    sample = set->samples + i;
-    sample->weight = 1.0 / pf->max_samples;
-    sample->pose = (*init_fn)(init_data);
+    set->weight[i] = 1.0 / pf->max_samples;
+    pf_sample_set_pose(set, i, (*init_fn)(init_data));
 
     // Add sample to histogram
-    pf_kdtree_insert(set->kdtree, sample->pose, sample->weight);
+    pf_kdtree_insert(set->kdtree, pf_sample_get_pose(set, i), set->weight[i]);
   }
 
   pf->w_slow = pf->w_fast = 0.0;
@@ -207,24 +205,20 @@ int pf_update_converged(pf_t * pf)
 {
   int i;
   pf_sample_set_t * set;
-  pf_sample_t * sample;
 
   set = pf->sets + pf->current_set;
   double mean_x = 0, mean_y = 0;
 
   for (i = 0; i < set->sample_count; i++) {
-    sample = set->samples + i;
-
-    mean_x += sample->pose.v[0];
-    mean_y += sample->pose.v[1];
+    mean_x += set->x[i];
+    mean_y += set->y[i];
   }
   mean_x /= set->sample_count;
   mean_y /= set->sample_count;
 
   for (i = 0; i < set->sample_count; i++) {
-    sample = set->samples + i;
-    if (fabs(sample->pose.v[0] - mean_x) > pf->dist_threshold ||
-      fabs(sample->pose.v[1] - mean_y) > pf->dist_threshold)
+    if (fabs(set->x[i] - mean_x) > pf->dist_threshold ||
+      fabs(set->y[i] - mean_y) > pf->dist_threshold)
     {
       set->converged = 0;
       pf->converged = 0;
@@ -251,7 +245,6 @@ void pf_update_sensor(pf_t * pf, pf_sensor_model_fn_t sensor_fn, void * sensor_d
 {
   int i;
   pf_sample_set_t * set;
-  pf_sample_t * sample;
   double total;
 
   set = pf->sets + pf->current_set;
@@ -262,10 +255,10 @@ void pf_update_sensor(pf_t * pf, pf_sensor_model_fn_t sensor_fn, void * sensor_d
   if (total > 0.0) {
     // Normalize weights
     double w_avg = 0.0;
+    const double total_inv = 1.0 / total;
     for (i = 0; i < set->sample_count; i++) {
-      sample = set->samples + i;
-      w_avg += sample->weight;
-      sample->weight /= total;
+      w_avg += set->weight[i];
+      set->weight[i] *= total_inv;
     }
     // Update running averages of likelihood of samples (Prob Rob p258)
     w_avg /= set->sample_count;
@@ -282,8 +275,7 @@ void pf_update_sensor(pf_t * pf, pf_sensor_model_fn_t sensor_fn, void * sensor_d
   } else {
     // Handle zero total
     for (i = 0; i < set->sample_count; i++) {
-      sample = set->samples + i;
-      sample->weight = 1.0 / set->sample_count;
+      set->weight[i] = 1.0 / set->sample_count;
     }
   }
 }
@@ -292,15 +284,15 @@ void pf_update_sensor(pf_t * pf, pf_sensor_model_fn_t sensor_fn, void * sensor_d
 // Resample the distribution
 void pf_update_resample(pf_t * pf, void * random_pose_data)
 {
-  int i;
+  int i, m, n;
   double total;
   pf_sample_set_t * set_a, * set_b;
-  pf_sample_t * sample_a, * sample_b;
+  pf_vector_t pose;
 
-  // double r,c,U;
-  // int m;
-  // double count_inv;
+  double r, U, count_inv;
   double * c;
+  int * draws;
+  int draw_count;
 
   double w_diff;
 
@@ -308,14 +300,30 @@ void pf_update_resample(pf_t * pf, void * random_pose_data)
   set_b = pf->sets + (pf->current_set + 1) % 2;
 
   // Build up cumulative probability table for resampling.
-  // TODO(?): Replace this with a more efficient procedure
-  // (e.g., http://www.network-theory.co.uk/docs/gslref/GeneralDiscreteDistributions.html)
   c = (double *)malloc(sizeof(double) * (set_a->sample_count + 1));
   c[0] = 0.0;
   for (i = 0; i < set_a->sample_count; i++) {
-    c[i + 1] = c[i] + set_a->samples[i].weight;
+    c[i + 1] = c[i] + set_a->weight[i];
   }
 
+  // Low-variance resampler, taken from Probabilistic Robotics, p110: one
+  // random offset for a comb of max_samples evenly spaced draws, found in a
+  // single walk over the cumulative weights. The draws are taken in a random
+  // order, shuffling as they go, so that stopping at the KLD bound still takes
+  // a sample of the whole distribution rather than of the first particles only.
+  draws = (int *)malloc(sizeof(int) * pf->max_samples);
+  count_inv = 1.0 / pf->max_samples;
+  r = drand48() * count_inv;
+  i = 0;
+  for (m = 0; m < pf->max_samples; m++) {
+    U = (r + m * count_inv) * c[set_a->sample_count];
+    while (i < set_a->sample_count - 1 && U >= c[i + 1]) {
+      i++;
+    }
+    draws[m] = i;
+  }
+  draw_count = 0;
+
   // Create the kd tree for adaptive sampling
   pf_kdtree_clear(set_b->kdtree);
 
@@ -329,69 +337,32 @@ void pf_update_resample(pf_t * pf, void * random_pose_data)
   }
   // printf("w_diff: %9.6f\n", w_diff);
 
-  // Can't (easily) combine low-variance sampler with KLD adaptive
-  // sampling, so we'll take the more traditional route.
-  /*
-  // Low-variance resampler, taken from Probabilistic Robotics, p110
-  count_inv = 1.0/set_a->sample_count;
-  r = drand48() * count_inv;
-  c = set_a->samples[0].weight;
-  i = 0;
-  m = 0;
-  */
   while (set_b->sample_count < pf->max_samples) {
-    sample_b = set_b->samples + set_b->sample_count++;
+    m = set_b->sample_count++;
 
     if (drand48() < w_diff) {
-      sample_b->pose = (pf->random_pose_fn)(random_pose_data);
+      pose = (pf->random_pose_fn)(random_pose_data);
+      pf_sample_set_pose(set_b, m, pose);
     } else {
-      // Can't (easily) combine low-variance sampler with KLD adaptive
-      // sampling, so we'll take the more traditional route.
-      /*
-      // Low-variance resampler, taken from Probabilistic Robotics, p110
-      U = r + m * count_inv;
-      while(U>c)
-      {
-        i++;
-        // Handle wrap-around by resetting counters and picking a new random
-        // number
-        if(i >= set_a->sample_count)
-        {
-          r = drand48() * count_inv;
-          c = set_a->samples[0].weight;
-          i = 0;
-          m = 0;
-          U = r + m * count_inv;
-          continue;
-        }
-        c += set_a->samples[i].weight;
-      }
-      m++;
-      */
-
-      // Naive discrete event sampler
-      double r;
-      r = drand48();
-      for (i = 0; i < set_a->sample_count; i++) {
-        if ((c[i] <= r) && (r < c[i + 1])) {
-          break;
-        }
-      }
-      assert(i < set_a->sample_count);
+      n = draw_count + (int)(drand48() * (pf->max_samples - draw_count));
+      i = draws[n];
+      draws[n] = draws[draw_count];
+      draws[draw_count++] = i;
 
-      sample_a = set_a->samples + i;
-
-      assert(sample_a->weight > 0);
+      assert(set_a->weight[i] > 0);
 
       // Add sample to list
-      sample_b->pose = sample_a->pose;
+      set_b->x[m] = set_a->x[i];
+      set_b->y[m] = set_a->y[i];
+      set_b->theta[m] = set_a->theta[i];
+      pose = pf_sample_get_pose(set_b, m);
     }
 
-    sample_b->weight = 1.0;
-    total += sample_b->weight;
+    set_b->weight[m] = 1.0;
+    total += set_b->weight[m];
 
     // Add sample to histogram
-    pf_kdtree_insert(set_b->kdtree, sample_b->pose, sample_b->weight);
+    pf_kdtree_insert(set_b->kdtree, pose, set_b->weight[m]);
 
     // See if we have enough samples yet
     if (set_b->sample_count > pf_resample_limit(pf, set_b->kdtree->leaf_count)) {
@@ -408,8 +379,7 @@ void pf_update_resample(pf_t * pf, void * random_pose_data)
 
   // Normalize weights
   for (i = 0; i < set_b->sample_count; i++) {
-    sample_b = set_b->samples + i;
-    sample_b->weight /= total;
+    set_b->weight[i] /= total;
   }
 
   // Re-compute cluster statistics
@@ -420,10 +390,28 @@ void pf_update_resample(pf_t * pf, void * random_pose_data)
 
   pf_update_converged(pf);
 
+  free(draws);
   free(c);
 }
 
 
+// Allocate the sample arrays of a set, in a single buffer
+void pf_sample_set_alloc(pf_sample_set_t * set, int max_samples)
+{
+  const size_t per_line = PF_SAMPLE_ALIGNMENT / sizeof(pf_real_t);
+  const size_t stride = (max_samples + per_line - 1) / per_line * per_line;
+  uintptr_t aligned;
+
+  set->sample_buffer = calloc(4 * stride * sizeof(pf_real_t) + PF_SAMPLE_ALIGNMENT, 1);
+  aligned = ((uintptr_t)set->sample_buffer + PF_SAMPLE_ALIGNMENT - 1) &
+    ~(uintptr_t)(PF_SAMPLE_ALIGNMENT - 1);
+  set->x = (pf_real_t *)aligned;
+  set->y = set->x + stride;
+  set->theta = set->y + stride;
+  set->weight = set->theta + stride;
+}
+
+
 // Compute the required number of samples, given that there are k bins
 // with samples in them.  This is taken directly from Fox et al.
 int pf_resample_limit(pf_t * pf, int k)
@@ -458,8 +446,9 @@ void pf_cluster_stats(pf_t * pf, pf_sample_set_t * set)
 {
   (void)pf;
   int i, j, k, cidx;
-  pf_sample_t * sample;
   pf_cluster_t * cluster;
+  pf_vector_t pose;
+  double w, cos_theta, sin_theta;
 
   // Workspace
   double m[4], c[2][2];
@@ -502,12 +491,13 @@ void pf_cluster_stats(pf_t * pf, pf_sample_set_t * set)
 
   // Compute cluster stats
   for (i = 0; i < set->sample_count; i++) {
-    sample = set->samples + i;
+    pose = pf_sample_get_pose(set, i);
+    w = set->weight[i];
 
-    // printf("%d %f %f %f\n", i, sample->pose.v[0], sample->pose.v[1], sample->pose.v[2]);
+    // printf("%d %f %f %f\n", i, pose.v[0], pose.v[1], pose.v[2]);
 
     // Get the cluster label for this sample
-    cidx = pf_kdtree_get_cluster(set->kdtree, sample->pose);
+    cidx = pf_kdtree_get_cluster(set->kdtree, pose);
     assert(cidx >= 0);
     if (cidx >= set->cluster_max_count) {
       continue;
@@ -518,26 +508,28 @@ void pf_cluster_stats(pf_t * pf, pf_sample_set_t * set)
 
     cluster = set->clusters + cidx;
 
-    cluster->weight += sample->weight;
+    cluster->weight += w;
 
-    weight += sample->weight;
+    weight += w;
 
     // Compute mean
-    cluster->m[0] += sample->weight * sample->pose.v[0];
-    cluster->m[1] += sample->weight * sample->pose.v[1];
-    cluster->m[2] += sample->weight * cos(sample->pose.v[2]);
-    cluster->m[3] += sample->weight * sin(sample->pose.v[2]);
-
-    m[0] += sample->weight * sample->pose.v[0];
-    m[1] += sample->weight * sample->pose.v[1];
-    m[2] += sample->weight * cos(sample->pose.v[2]);
-    m[3] += sample->weight * sin(sample->pose.v[2]);
+    cos_theta = cos(pose.v[2]);
+    sin_theta = sin(pose.v[2]);
+    cluster->m[0] += w * pose.v[0];
+    cluster->m[1] += w * pose.v[1];
+    cluster->m[2] += w * cos_theta;
+    cluster->m[3] += w * sin_theta;
+
+    m[0] += w * pose.v[0];
+    m[1] += w * pose.v[1];
+    m[2] += w * cos_theta;
+    m[3] += w * sin_theta;
 
     // Compute covariance in linear components
     for (j = 0; j < 2; j++) {
       for (k = 0; k < 2; k++) {
-        cluster->c[j][k] += sample->weight * sample->pose.v[j] * sample->pose.v[k];
-        c[j][k] += sample->weight * sample->pose.v[j] * sample->pose.v[k];
+        cluster->c[j][k] += w * pose.v[j] * pose.v[k];
+        c[j][k] += w * pose.v[j] * pose.v[k];
       }
     }
   }
@@ -49,17 +49,14 @@ void pf_draw_samples(pf_t * pf, rtk_fig_t * fig, int max_samples)
   int i;
   double px, py, pa;
   pf_sample_set_t * set;
-  pf_sample_t * sample;
 
   set = pf->sets + pf->current_set;
   max_samples = MIN(max_samples, set->sample_count);
 
   for (i = 0; i < max_samples; i++) {
-    sample = set->samples + i;
-
-    px = sample->pose.v[0];
-    py = sample->pose.v[1];
-    pa = sample->pose.v[2];
+    px = set->x[i];
+    py = set->y[i];
+    pa = set->theta[i];
 
     // printf("%f %f\n", px, py);
 
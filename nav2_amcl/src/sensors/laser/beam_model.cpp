@@ -21,6 +21,7 @@
 
 #include <math.h>
 #include <assert.h>
+#include <memory>
 
 #include "nav2_amcl/sensors/laser/laser.hpp"
 
@@ -52,7 +53,6 @@ BeamModel::sensorFunction(LaserData * data, pf_sample_set_t * set)
   double map_range;
   double obs_range, obs_bearing;
   double total_weight;
-  pf_sample_t * sample;
   pf_vector_t pose;
 
   self = reinterpret_cast<BeamModel *>(data->laser);
@@ -61,8 +61,7 @@ BeamModel::sensorFunction(LaserData * data, pf_sample_set_t * set)
 
   // Compute the sample weights
   for (j = 0; j < set->sample_count; j++) {
-    sample = set->samples + j;
-    pose = sample->pose;
+    pose = pf_sample_get_pose(set, j);
 
     // Take account of the laser pose relative to the robot
     pose = pf_vector_coord_add(self->laser_pose_, pose);
@@ -80,10 +79,15 @@ BeamModel::sensorFunction(LaserData * data, pf_sample_set_t * set)
 
       obs_bearing = data->ranges[i][1];
 
-      // Compute the range according to the map
-      map_range = map_calc_range(
-        self->map_, pose.v[0], pose.v[1],
-        pose.v[2] + obs_bearing, data->range_max);
+      // Compute the range according to the map, looked up in its range table if any
+      if (self->range_table_) {
+        map_range = self->range_table_->calcRange(
+          pose.v[0], pose.v[1], pose.v[2] + obs_bearing, data->range_max);
+      } else {
+        map_range = map_calc_range(
+          self->map_, pose.v[0], pose.v[1],
+          pose.v[2] + obs_bearing, data->range_max);
+      }
       pz = 0.0;
 
       // Part 1: good, but noisy, hit
@@ -115,13 +119,19 @@ BeamModel::sensorFunction(LaserData * data, pf_sample_set_t * set)
       p += pz * pz * pz;
     }
 
-    sample->weight *= p;
-    total_weight += sample->weight;
+    set->weight[j] *= p;
+    total_weight += set->weight[j];
   }
 
   return total_weight;
 }
 
+void
+BeamModel::setRangeTable(std::shared_ptr<const RangeTable> range_table)
+{
+  range_table_ = range_table;
+}
+
 bool
 BeamModel::sensorUpdate(pf_t * pf, LaserData * data)
 {
@@ -23,6 +23,7 @@
 #include <math.h>
 #include <stdlib.h>
 #include <assert.h>
+#include <algorithm>
 
 #include "nav2_amcl/sensors/laser/laser.hpp"
 
@@ -30,7 +31,7 @@ namespace nav2_amcl
 {
 
 Laser::Laser(size_t max_beams, map_t * map)
-: max_samples_(0), max_obs_(0), temp_obs_(NULL)
+: max_samples_(0), max_obs_(0), temp_obs_(NULL), min_beams_(0)
 {
   max_beams_ = max_beams;
   map_ = map;
@@ -70,4 +71,150 @@ Laser::SetLaserPose(pf_vector_t & laser_pose)
   laser_pose_ = laser_pose;
 }
 
+void
+Laser::setNumThreads(unsigned int num_threads)
+{
+  thread_pool_.reset();
+  if (num_threads > 1) {
+    // The updating thread evaluates samples as well
+    thread_pool_ = std::make_unique<nav2_util::ThreadPool>(num_threads - 1);
+  }
+}
+
+void
+Laser::setLikelihoodTable(bool use_table)
+{
+  likelihood_table_.clear();
+  if (!use_table) {
+    return;
+  }
+
+  const double z_hit_denom = 2 * sigma_hit_ * sigma_hit_;
+  likelihood_table_.resize(static_cast<size_t>(map_->size_x) * map_->size_y);
+  for (size_t i = 0; i < likelihood_table_.size(); i++) {
+    const double z = map_->cells[i].occ_dist;
+    likelihood_table_[i] = static_cast<float>(exp(-(z * z) / z_hit_denom));
+  }
+}
+
+void
+Laser::setAdaptiveBeams(int min_beams)
+{
+  min_beams_ = std::max(min_beams, 0);
+}
+
+void
+Laser::selectBeams(pf_t * pf, LaserData * data)
+{
+  const int max_beams = std::min(max_beams_, data->range_count);
+  if (min_beams_ <= 0 || min_beams_ >= max_beams) {
+    return;
+  }
+
+  // As many beams as the particles spread, relative to the convergence distance
+  pf_sample_set_t * set = pf->sets + pf->current_set;
+  const double spread = sqrt(std::max(set->cov.m[0][0] + set->cov.m[1][1], 0.0));
+  const double ratio = pf->dist_threshold > 0.0 ?
+    std::min(spread / pf->dist_threshold, 1.0) : 1.0;
+  const int beam_count = min_beams_ + static_cast<int>(ratio * (max_beams - min_beams_));
+
+  // Expected endpoints from the mean pose of the laser
+  const pf_vector_t pose = pf_vector_coord_add(laser_pose_, set->mean);
+  auto information = [&](int i) {
+      const double obs_range = data->ranges[i][0];
+      if (obs_range >= data->range_max || obs_range != obs_range) {
+        return -1.0;
+      }
+      const double angle = pose.v[2] + data->ranges[i][1];
+      const int mi = MAP_GXWX(map_, pose.v[0] + obs_range * cos(angle));
+      const int mj = MAP_GYWY(map_, pose.v[1] + obs_range * sin(angle));
+      if (mi < 1 || mj < 1 || mi >= map_->size_x - 1 || mj >= map_->size_y - 1) {
+        return 0.0;
+      }
+
+      // The Fisher information of a likelihood field beam grows with the squared
+      // gradient of the obstacle distance, nil where it saturates
+      const double gx = map_->cells[MAP_INDEX(map_, mi + 1, mj)].occ_dist -
+        map_->cells[MAP_INDEX(map_, mi - 1, mj)].occ_dist;
+      const double gy = map_->cells[MAP_INDEX(map_, mi, mj + 1)].occ_dist -
+        map_->cells[MAP_INDEX(map_, mi, mj - 1)].occ_dist;
+      return gx * gx + gy * gy;
+    };
+
+  // The best beam of each sector, the one closest to its middle among equals
+  double(*ranges)[2] = new double[beam_count][2];
+  for (int k = 0; k < beam_count; k++) {
+    const int begin = k * data->range_count / beam_count;
+    const int end = (k + 1) * data->range_count / beam_count;
+    const int middle = (begin + end) / 2;
+    int best = middle;
+    double best_information = information(middle);
+    for (int i = begin; i < end; i++) {
+      const double info = information(i);
+      if (info > best_information + 1e-9 ||
+        (info >= best_information - 1e-9 && abs(i - middle) < abs(best - middle)))
+      {
+        best = i;
+        best_information = info;
+      }
+    }
+    ranges[k][0] = data->ranges[best][0];
+    ranges[k][1] = data->ranges[best][1];
+  }
+
+  delete[] data->ranges;
+  data->ranges = ranges;
+  data->range_count = beam_count;
+}
+
+void
+Laser::prepareBeams(LaserData * data, int step)
+{
+  beam_ranges_.clear();
+  beam_cos_.clear();
+  beam_sin_.clear();
+  beam_indices_.clear();
+
+  int beam_ind = 0;
+  for (int i = 0; i < data->range_count; i += step, beam_ind++) {
+    const double obs_range = data->ranges[i][0];
+    const double obs_bearing = data->ranges[i][1];
+
+    // The models ignore max range readings, and NaN
+    if (obs_range >= data->range_max || obs_range != obs_range) {
+      continue;
+    }
+
+    beam_ranges_.push_back(obs_range);
+    beam_cos_.push_back(cos(obs_bearing));
+    beam_sin_.push_back(sin(obs_bearing));
+    beam_indices_.push_back(beam_ind);
+  }
+}
+
+int
+Laser::getNumSampleBlocks() const
+{
+  // A few blocks per thread, to balance the beams thrown out of the map
+  return thread_pool_ ? 4 * (thread_pool_->size() + 1) : 1;
+}
+
+void
+Laser::forEachSampleBlock(
+  int sample_count, const std::function<void(int, int, int)> & fn)
+{
+  if (!thread_pool_) {
+    fn(0, 0, sample_count);
+    return;
+  }
+
+  const int num_blocks = getNumSampleBlocks();
+  const int block_size = (sample_count + num_blocks - 1) / num_blocks;
+  thread_pool_->parallelFor(
+    0, num_blocks, [&](size_t block) {
+      const int begin = std::min(static_cast<int>(block) * block_size, sample_count);
+      fn(static_cast<int>(block), begin, std::min(begin + block_size, sample_count));
+    });
+}
+
 }  // namespace nav2_amcl
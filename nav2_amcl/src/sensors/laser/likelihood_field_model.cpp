@@ -42,14 +42,8 @@ double
 LikelihoodFieldModel::sensorFunction(LaserData * data, pf_sample_set_t * set)
 {
   LikelihoodFieldModel * self;
-  int i, j, step;
-  double z, pz;
-  double p;
-  double obs_range, obs_bearing;
+  int j, step;
   double total_weight;
-  pf_sample_t * sample;
-  pf_vector_t pose;
-  pf_vector_t hit;
 
   self = reinterpret_cast<LikelihoodFieldModel *>(data->laser);
 
@@ -64,68 +58,116 @@ LikelihoodFieldModel::sensorFunction(LaserData * data, pf_sample_set_t * set)
     step = 1;
   }
 
-  total_weight = 0.0;
-
-  // Compute the sample weights
-  for (j = 0; j < set->sample_count; j++) {
-    sample = set->samples + j;
-    pose = sample->pose;
-
-    // Take account of the laser pose relative to the robot
-    pose = pf_vector_coord_add(self->laser_pose_, pose);
-
-    p = 1.0;
-
-    for (i = 0; i < data->range_count; i += step) {
-      obs_range = data->ranges[i][0];
-      obs_bearing = data->ranges[i][1];
-
-      // This model ignores max range readings
-      if (obs_range >= data->range_max) {
-        continue;
-      }
+  // With the likelihood table, the beam endpoints are rotated by the sample heading
+  // with the bearing cosines and sines, and their Gaussian is a lookup
+  const bool use_table = !self->likelihood_table_.empty();
+  const double max_dist_prob =
+    exp(-(self->map_->max_occ_dist * self->map_->max_occ_dist) / z_hit_denom);
+  if (use_table) {
+    self->prepareBeams(data, step);
+  }
 
-      // Check for NaN
-      if (obs_range != obs_range) {
-        continue;
+  // Compute the sample weights, each sample independently of the others
+  self->forEachSampleBlock(
+    set->sample_count, [&](int, int begin, int end) {
+      int i;
+      double z, pz;
+      double p;
+      double obs_range, obs_bearing;
+      pf_vector_t pose;
+      pf_vector_t hit;
+
+      for (int j = begin; j < end; j++) {
+        pose = pf_sample_get_pose(set, j);
+
+        // Take account of the laser pose relative to the robot
+        pose = pf_vector_coord_add(self->laser_pose_, pose);
+
+        p = 1.0;
+
+        if (use_table) {
+          const double * ranges = self->beam_ranges_.data();
+          const double * beam_cos = self->beam_cos_.data();
+          const double * beam_sin = self->beam_sin_.data();
+          const float * table = self->likelihood_table_.data();
+          const double cos_a = cos(pose.v[2]);
+          const double sin_a = sin(pose.v[2]);
+          const size_t num_beams = self->beam_ranges_.size();
+          for (size_t b = 0; b < num_beams; b++) {
+            hit.v[0] = pose.v[0] + ranges[b] * (cos_a * beam_cos[b] - sin_a * beam_sin[b]);
+            hit.v[1] = pose.v[1] + ranges[b] * (sin_a * beam_cos[b] + cos_a * beam_sin[b]);
+
+            int mi, mj;
+            mi = MAP_GXWX(self->map_, hit.v[0]);
+            mj = MAP_GYWY(self->map_, hit.v[1]);
+
+            // Off-map penalized as max distance
+            pz = self->z_hit_ * (MAP_VALID(self->map_, mi, mj) ?
+              table[MAP_INDEX(self->map_, mi, mj)] : max_dist_prob);
+            pz += self->z_rand_ * z_rand_mult;
+            p += pz * pz * pz;
+          }
+
+          set->weight[j] *= p;
+          continue;
+        }
+
+        for (i = 0; i < data->range_count; i += step) {
+          obs_range = data->ranges[i][0];
+          obs_bearing = data->ranges[i][1];
+
+          // This model ignores max range readings
+          if (obs_range >= data->range_max) {
+            continue;
+          }
+
+          // Check for NaN
+          if (obs_range != obs_range) {
+            continue;
+          }
+
+          pz = 0.0;
+
+          // Compute the endpoint of the beam
+          hit.v[0] = pose.v[0] + obs_range * cos(pose.v[2] + obs_bearing);
+          hit.v[1] = pose.v[1] + obs_range * sin(pose.v[2] + obs_bearing);
+
+          // Convert to map grid coords.
+          int mi, mj;
+          mi = MAP_GXWX(self->map_, hit.v[0]);
+          mj = MAP_GYWY(self->map_, hit.v[1]);
+
+          // Part 1: Get distance from the hit to closest obstacle.
+          // Off-map penalized as max distance
+          if (!MAP_VALID(self->map_, mi, mj)) {
+            z = self->map_->max_occ_dist;
+          } else {
+            z = self->map_->cells[MAP_INDEX(self->map_, mi, mj)].occ_dist;
+          }
+          // Gaussian model
+          // NOTE: this should have a normalization of 1/(sqrt(2pi)*sigma)
+          pz += self->z_hit_ * exp(-(z * z) / z_hit_denom);
+          // Part 2: random measurements
+          pz += self->z_rand_ * z_rand_mult;
+
+          // TODO(?): outlier rejection for short readings
+
+          assert(pz <= 1.0);
+          assert(pz >= 0.0);
+          //      p *= pz;
+          // here we have an ad-hoc weighting scheme for combining beam probs
+          // works well, though...
+          p += pz * pz * pz;
+        }
+
+        set->weight[j] *= p;
       }
+    });
 
-      pz = 0.0;
-
-      // Compute the endpoint of the beam
-      hit.v[0] = pose.v[0] + obs_range * cos(pose.v[2] + obs_bearing);
-      hit.v[1] = pose.v[1] + obs_range * sin(pose.v[2] + obs_bearing);
-
-      // Convert to map grid coords.
-      int mi, mj;
-      mi = MAP_GXWX(self->map_, hit.v[0]);
-      mj = MAP_GYWY(self->map_, hit.v[1]);
-
-      // Part 1: Get distance from the hit to closest obstacle.
-      // Off-map penalized as max distance
-      if (!MAP_VALID(self->map_, mi, mj)) {
-        z = self->map_->max_occ_dist;
-      } else {
-        z = self->map_->cells[MAP_INDEX(self->map_, mi, mj)].occ_dist;
-      }
-      // Gaussian model
-      // NOTE: this should have a normalization of 1/(sqrt(2pi)*sigma)
-      pz += self->z_hit_ * exp(-(z * z) / z_hit_denom);
-      // Part 2: random measurements
-      pz += self->z_rand_ * z_rand_mult;
-
-      // TODO(?): outlier rejection for short readings
-
-      assert(pz <= 1.0);
-      assert(pz >= 0.0);
-      //      p *= pz;
-      // here we have an ad-hoc weighting scheme for combining beam probs
-      // works well, though...
-      p += pz * pz * pz;
-    }
-
-    sample->weight *= p;
-    total_weight += sample->weight;
+  // Sum the weights in the samples order, for the same total on any number of threads
+  total_weight = 0.0;
+  for (j = 0; j < set->sample_count; j++) {
+    total_weight += set->weight[j];
   }
 
   return total_weight;
@@ -22,6 +22,7 @@
 
 #include <math.h>
 #include <assert.h>
+#include <vector>
 
 #include "nav2_amcl/sensors/laser/laser.hpp"
 
@@ -52,14 +53,9 @@ double
 LikelihoodFieldModelProb::sensorFunction(LaserData * data, pf_sample_set_t * set)
 {
   LikelihoodFieldModelProb * self;
-  int i, j, step;
-  double z, pz;
+  int j, step;
   double log_p;
-  double obs_range, obs_bearing;
   double total_weight;
-  pf_sample_t * sample;
-  pf_vector_t pose;
-  pf_vector_t hit;
 
   self = reinterpret_cast<LikelihoodFieldModelProb *>(data->laser);
 
@@ -118,76 +114,149 @@ LikelihoodFieldModelProb::sensorFunction(LaserData * data, pf_sample_set_t * set
     }
   }
 
-  // Compute the sample weights
-  for (j = 0; j < set->sample_count; j++) {
-    sample = set->samples + j;
-    pose = sample->pose;
+  // With the likelihood table, the beam endpoints are rotated by the sample heading
+  // with the bearing cosines and sines, and their Gaussian is a lookup
+  const bool use_table = !self->likelihood_table_.empty();
+  if (use_table) {
+    self->prepareBeams(data, step);
+  }
 
-    // Take account of the laser pose relative to the robot
-    pose = pf_vector_coord_add(self->laser_pose_, pose);
+  // Compute the sample weights, each sample independently of the others,
+  // counting the beams agreeing with the map per block of samples
+  const int num_blocks = self->getNumSampleBlocks();
+  std::vector<int> blocks_obs_count(num_blocks * self->max_beams_, 0);
+  self->forEachSampleBlock(
+    set->sample_count, [&](int block, int begin, int end) {
+      int i, beam_ind;
+      double z, pz;
+      double log_p;
+      double obs_range, obs_bearing;
+      pf_vector_t pose;
+      pf_vector_t hit;
+      int * block_obs_count = blocks_obs_count.data() + block * self->max_beams_;
+
+      for (int j = begin; j < end; j++) {
+        pose = pf_sample_get_pose(set, j);
+
+        // Take account of the laser pose relative to the robot
+        pose = pf_vector_coord_add(self->laser_pose_, pose);
+
+        log_p = 0;
+
+        if (use_table) {
+          const double * ranges = self->beam_ranges_.data();
+          const double * beam_cos = self->beam_cos_.data();
+          const double * beam_sin = self->beam_sin_.data();
+          const float * table = self->likelihood_table_.data();
+          const double cos_a = cos(pose.v[2]);
+          const double sin_a = sin(pose.v[2]);
+          const size_t num_beams = self->beam_ranges_.size();
+          for (size_t b = 0; b < num_beams; b++) {
+            hit.v[0] = pose.v[0] + ranges[b] * (cos_a * beam_cos[b] - sin_a * beam_sin[b]);
+            hit.v[1] = pose.v[1] + ranges[b] * (sin_a * beam_cos[b] + cos_a * beam_sin[b]);
+
+            int mi, mj;
+            mi = MAP_GXWX(self->map_, hit.v[0]);
+            mj = MAP_GYWY(self->map_, hit.v[1]);
+
+            // Off-map penalized as max distance
+            if (!MAP_VALID(self->map_, mi, mj)) {
+              pz = self->z_hit_ * max_dist_prob;
+            } else {
+              const int index = MAP_INDEX(self->map_, mi, mj);
+              if (do_beamskip && self->map_->cells[index].occ_dist < beam_skip_distance) {
+                block_obs_count[self->beam_indices_[b]] += 1;
+              }
+              pz = self->z_hit_ * table[index];
+            }
+            pz += self->z_rand_ * z_rand_mult;
+
+            if (!do_beamskip) {
+              log_p += log(pz);
+            } else {
+              self->temp_obs_[j][self->beam_indices_[b]] = pz;
+            }
+          }
+
+          if (!do_beamskip) {
+            set->weight[j] *= exp(log_p);
+          }
+          continue;
+        }
 
-    log_p = 0;
+        beam_ind = 0;
 
-    beam_ind = 0;
+        for (i = 0; i < data->range_count; i += step, beam_ind++) {
+          obs_range = data->ranges[i][0];
+          obs_bearing = data->ranges[i][1];
 
-    for (i = 0; i < data->range_count; i += step, beam_ind++) {
-      obs_range = data->ranges[i][0];
-      obs_bearing = data->ranges[i][1];
+          // This model ignores max range readings
+          if (obs_range >= data->range_max) {
+            continue;
+          }
 
-      // This model ignores max range readings
-      if (obs_range >= data->range_max) {
-        continue;
-      }
+          // Check for NaN
+          if (obs_range != obs_range) {
+            continue;
+          }
 
-      // Check for NaN
-      if (obs_range != obs_range) {
-        continue;
-      }
+          pz = 0.0;
 
-      pz = 0.0;
+          // Compute the endpoint of the beam
+          hit.v[0] = pose.v[0] + obs_range * cos(pose.v[2] + obs_bearing);
+          hit.v[1] = pose.v[1] + obs_range * sin(pose.v[2] + obs_bearing);
 
-      // Compute the endpoint of the beam
-      hit.v[0] = pose.v[0] + obs_range * cos(pose.v[2] + obs_bearing);
-      hit.v[1] = pose.v[1] + obs_range * sin(pose.v[2] + obs_bearing);
+          // Convert to map grid coords.
+          int mi, mj;
+          mi = MAP_GXWX(self->map_, hit.v[0]);
+          mj = MAP_GYWY(self->map_, hit.v[1]);
 
-      // Convert to map grid coords.
-      int mi, mj;
-      mi = MAP_GXWX(self->map_, hit.v[0]);
-      mj = MAP_GYWY(self->map_, hit.v[1]);
+          // Part 1: Get distance from the hit to closest obstacle.
+          // Off-map penalized as max distance
 
-      // Part 1: Get distance from the hit to closest obstacle.
-      // Off-map penalized as max distance
+          if (!MAP_VALID(self->map_, mi, mj)) {
+            pz += self->z_hit_ * max_dist_prob;
+          } else {
+            z = self->map_->cells[MAP_INDEX(self->map_, mi, mj)].occ_dist;
+            if (z < beam_skip_distance) {
+              block_obs_count[beam_ind] += 1;
+            }
+            pz += self->z_hit_ * exp(-(z * z) / z_hit_denom);
+          }
 
-      if (!MAP_VALID(self->map_, mi, mj)) {
-        pz += self->z_hit_ * max_dist_prob;
-      } else {
-        z = self->map_->cells[MAP_INDEX(self->map_, mi, mj)].occ_dist;
-        if (z < beam_skip_distance) {
-          obs_count[beam_ind] += 1;
-        }
-        pz += self->z_hit_ * exp(-(z * z) / z_hit_denom);
-      }
+          // Gaussian model
+          // NOTE: this should have a normalization of 1/(sqrt(2pi)*sigma)
 
-      // Gaussian model
-      // NOTE: this should have a normalization of 1/(sqrt(2pi)*sigma)
+          // Part 2: random measurements
+          pz += self->z_rand_ * z_rand_mult;
 
-      // Part 2: random measurements
-      pz += self->z_rand_ * z_rand_mult;
+          assert(pz <= 1.0);
+          assert(pz >= 0.0);
 
-      assert(pz <= 1.0);
-      assert(pz >= 0.0);
+          // TODO(?): outlier rejection for short readings
 
-      // TODO(?): outlier rejection for short readings
-
-      if (!do_beamskip) {
-        log_p += log(pz);
-      } else {
-        self->temp_obs_[j][beam_ind] = pz;
+          if (!do_beamskip) {
+            log_p += log(pz);
+          } else {
+            self->temp_obs_[j][beam_ind] = pz;
+          }
+        }
+        if (!do_beamskip) {
+          set->weight[j] *= exp(log_p);
+        }
       }
+    });
+
+  for (int block = 0; block < num_blocks; block++) {
+    for (beam_ind = 0; beam_ind < self->max_beams_; beam_ind++) {
+      obs_count[beam_ind] += blocks_obs_count[block * self->max_beams_ + beam_ind];
     }
-    if (!do_beamskip) {
-      sample->weight *= exp(log_p);
-      total_weight += sample->weight;
+  }
+
+  // Sum the weights in the samples order, for the same total on any number of threads
+  if (!do_beamskip) {
+    for (j = 0; j < set->sample_count; j++) {
+      total_weight += set->weight[j];
     }
   }
 
@@ -218,9 +287,6 @@ LikelihoodFieldModelProb::sensorFunction(LaserData * data, pf_sample_set_t * set
     }
 
     for (j = 0; j < set->sample_count; j++) {
-      sample = set->samples + j;
-      pose = sample->pose;
-
       log_p = 0;
 
       for (beam_ind = 0; beam_ind < self->max_beams_; beam_ind++) {
@@ -229,9 +295,9 @@ LikelihoodFieldModelProb::sensorFunction(LaserData * data, pf_sample_set_t * set
         }
       }
 
-      sample->weight *= exp(log_p);
+      set->weight[j] *= exp(log_p);
 
-      total_weight += sample->weight;
+      total_weight += set->weight[j];
     }
   }
 
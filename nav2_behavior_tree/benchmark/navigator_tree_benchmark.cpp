@@ -0,0 +1,469 @@
+// Copyright (c) 2024 Open Navigation LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Measures the overhead of the behavior tree framework over navigator trees, against mock
+// planner, controller and behavior servers answering at once:
+//
+//   navigator_tree_benchmark [--tree=<bt.xml>]...
+//
+// Without trees, the navigate to pose and through poses trees of nav2_bt_navigator are used.
+// For each tree, it times its loading through BehaviorTreeEngine::createTreeFromFile, its
+// ticks while the controller is following the path, and whole navigations run at the fixed
+// rate of the BT loop or ticked on events. Allocations are counted over all the threads,
+// those of the mock servers included.
+
+#include <benchmark/benchmark.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "ament_index_cpp/get_package_share_directory.hpp"
+#include "behaviortree_cpp/bt_factory.h"
+#include "geometry_msgs/msg/pose_stamped.hpp"
+#include "geometry_msgs/msg/transform_stamped.hpp"
+#include "nav_msgs/msg/path.hpp"
+#include "nav2_behavior_tree/action_client_registry.hpp"
+#include "nav2_behavior_tree/behavior_tree_engine.hpp"
+#include "nav2_msgs/action/back_up.hpp"
+#include "nav2_msgs/action/compute_path_through_poses.hpp"
+#include "nav2_msgs/action/compute_path_to_pose.hpp"
+#include "nav2_msgs/action/follow_path.hpp"
+#include "nav2_msgs/action/spin.hpp"
+#include "nav2_msgs/action/wait.hpp"
+#include "nav2_msgs/srv/clear_entire_costmap.hpp"
+#include "nav2_util/string_utils.hpp"
+#include "plugins_list.hpp"
+#include "rclcpp/rclcpp.hpp"
+#include "rclcpp_action/rclcpp_action.hpp"
+#include "tf2_ros/buffer.h"
+
+namespace
+{
+
+// Calls of the global operator new of all threads
+std::atomic<int64_t> g_allocations{0};
+
+}  // namespace
+
+void * operator new(std::size_t size)
+{
+  void * ptr = std::malloc(size ? size : 1);
+  if (!ptr) {
+    throw std::bad_alloc();
+  }
+  g_allocations.fetch_add(1, std::memory_order_relaxed);
+  return ptr;
+}
+
+void operator delete(void * ptr) noexcept
+{
+  std::free(ptr);
+}
+
+void operator delete(void * ptr, std::size_t) noexcept
+{
+  std::free(ptr);
+}
+
+namespace
+{
+
+/**
+ * @brief Action server succeeding its goals at once, or holding them while told to until
+ * they are canceled or preempted, as a controller following a path
+ */
+template<class ActionT>
+class MockActionServer
+{
+public:
+  using GoalHandle = rclcpp_action::ServerGoalHandle<ActionT>;
+
+  MockActionServer(
+    const rclcpp::Node::SharedPtr & node, const std::string & name,
+    std::function<void(typename ActionT::Result &)> fill_result = nullptr)
+  : fill_result_(fill_result)
+  {
+    server_ = rclcpp_action::create_server<ActionT>(
+      node, name,
+      [](const rclcpp_action::GoalUUID &, std::shared_ptr<const typename ActionT::Goal>) {
+        return rclcpp_action::GoalResponse::ACCEPT_AND_EXECUTE;
+      },
+      [](const std::shared_ptr<GoalHandle>) {
+        return rclcpp_action::CancelResponse::ACCEPT;
+      },
+      [this](const std::shared_ptr<GoalHandle> goal_handle) {
+        accepted(goal_handle);
+      });
+  }
+
+  void setHold(bool hold)
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    hold_ = hold;
+    if (!hold_) {
+      for (auto & goal_handle : held_) {
+        if (goal_handle->is_active()) {
+          goal_handle->succeed(makeResult());
+        }
+      }
+      held_.clear();
+    }
+  }
+
+  // Completes the cancels of the held goals
+  void completeCancels()
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (auto it = held_.begin(); it != held_.end(); ) {
+      if ((*it)->is_canceling()) {
+        (*it)->canceled(makeResult());
+        it = held_.erase(it);
+      } else {
+        ++it;
+      }
+    }
+  }
+
+private:
+  void accepted(const std::shared_ptr<GoalHandle> & goal_handle)
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!hold_) {
+      goal_handle->succeed(makeResult());
+      return;
+    }
+    // A new goal preempts the held ones, whose results the client ignores
+    for (auto & preempted : held_) {
+      if (preempted->is_executing()) {
+        preempted->succeed(makeResult());
+      }
+    }
+    held_.clear();
+    held_.push_back(goal_handle);
+  }
+
+  std::shared_ptr<typename ActionT::Result> makeResult()
+  {
+    auto result = std::make_shared<typename ActionT::Result>();
+    if (fill_result_) {
+      fill_result_(*result);
+    }
+    return result;
+  }
+
+  typename rclcpp_action::Server<ActionT>::SharedPtr server_;
+  std::function<void(typename ActionT::Result &)> fill_result_;
+  std::mutex mutex_;
+  bool hold_{false};
+  std::vector<std::shared_ptr<GoalHandle>> held_;
+};
+
+nav_msgs::msg::Path makePath()
+{
+  nav_msgs::msg::Path path;
+  path.header.frame_id = "map";
+  path.poses.resize(100);
+  for (size_t i = 0; i < path.poses.size(); i++) {
+    path.poses[i].header.frame_id = "map";
+    path.poses[i].pose.position.x = 0.05 * i;
+    path.poses[i].pose.orientation.w = 1.0;
+  }
+  return path;
+}
+
+/**
+ * @brief The servers the navigator trees call, on a node spun by a thread of their own
+ */
+class MockServers
+{
+public:
+  MockServers()
+  : node_(std::make_shared<rclcpp::Node>("navigator_tree_benchmark_servers")),
+    path_(makePath()),
+    compute_path_to_pose_(node_, "compute_path_to_pose",
+      [this](nav2_msgs::action::ComputePathToPose::Result & result) {result.path = path_;}),
+    compute_path_through_poses_(node_, "compute_path_through_poses",
+      [this](nav2_msgs::action::ComputePathThroughPoses::Result & result) {result.path = path_;}),
+    follow_path_(node_, "follow_path"),
+    spin_(node_, "spin"),
+    back_up_(node_, "backup"),
+    wait_(node_, "wait")
+  {
+    for (const auto & name : {"local_costmap/clear_entirely_local_costmap",
+        "global_costmap/clear_entirely_global_costmap"})
+    {
+      clear_services_.push_back(
+        node_->create_service<nav2_msgs::srv::ClearEntireCostmap>(
+          name,
+          [](const std::shared_ptr<nav2_msgs::srv::ClearEntireCostmap::Request>,
+          std::shared_ptr<nav2_msgs::srv::ClearEntireCostmap::Response>) {}));
+    }
+    cancel_timer_ = node_->create_wall_timer(
+      std::chrono::milliseconds(10), [this]() {follow_path_.completeCancels();});
+
+    executor_.add_node(node_);
+    spin_thread_ = std::thread([this]() {executor_.spin();});
+  }
+
+  ~MockServers()
+  {
+    executor_.cancel();
+    spin_thread_.join();
+  }
+
+  // Whether the controller keeps following the path rather than arriving at once
+  void holdFollowPath(bool hold)
+  {
+    follow_path_.setHold(hold);
+  }
+
+private:
+  rclcpp::Node::SharedPtr node_;
+  nav_msgs::msg::Path path_;
+  MockActionServer<nav2_msgs::action::ComputePathToPose> compute_path_to_pose_;
+  MockActionServer<nav2_msgs::action::ComputePathThroughPoses> compute_path_through_poses_;
+  MockActionServer<nav2_msgs::action::FollowPath> follow_path_;
+  MockActionServer<nav2_msgs::action::Spin> spin_;
+  MockActionServer<nav2_msgs::action::BackUp> back_up_;
+  MockActionServer<nav2_msgs::action::Wait> wait_;
+  std::vector<rclcpp::ServiceBase::SharedPtr> clear_services_;
+  rclcpp::TimerBase::SharedPtr cancel_timer_;
+  rclcpp::executors::SingleThreadedExecutor executor_;
+  std::thread spin_thread_;
+};
+
+std::unique_ptr<MockServers> g_servers;
+rclcpp::Node::SharedPtr g_node;
+std::shared_ptr<tf2_ros::Buffer> g_tf;
+
+const auto kLoopDuration = std::chrono::milliseconds(10);
+
+/**
+ * @brief An engine and blackboard set up as by the BT navigator, with its action clients
+ * spun in the ticks or by a thread of their own waking the engine up
+ */
+struct Navigator
+{
+  explicit Navigator(bool async_action_clients)
+  {
+    engine = std::make_unique<nav2_behavior_tree::BehaviorTreeEngine>(
+      nav2_util::split(nav2::details::BT_BUILTIN_PLUGINS, ';'), g_node);
+
+    blackboard = BT::Blackboard::create();
+    blackboard->set<rclcpp::Node::SharedPtr>("node", g_node);
+    blackboard->set<std::shared_ptr<tf2_ros::Buffer>>("tf_buffer", g_tf);
+    blackboard->set<std::chrono::milliseconds>("server_timeout", std::chrono::milliseconds(20));
+    blackboard->set<std::chrono::milliseconds>("bt_loop_duration", kLoopDuration);
+    blackboard->set<std::chrono::milliseconds>(
+      "wait_for_service_timeout", std::chrono::milliseconds(1000));
+    blackboard->set<nav2_behavior_tree::ActionClientRegistry::Ptr>(
+      "action_client_registry",
+      std::make_shared<nav2_behavior_tree::ActionClientRegistry>(
+        g_node, async_action_clients,
+        [this]() {engine->wakeUp();}));
+
+    geometry_msgs::msg::PoseStamped goal;
+    goal.header.frame_id = "map";
+    goal.pose.position.x = 5.0;
+    goal.pose.orientation.w = 1.0;
+    blackboard->set("goal", goal);
+    std::vector<geometry_msgs::msg::PoseStamped> goals(3, goal);
+    for (size_t i = 0; i < goals.size(); i++) {
+      goals[i].pose.position.x = 2.0 * (i + 1);
+    }
+    blackboard->set("goals", goals);
+  }
+
+  std::unique_ptr<nav2_behavior_tree::BehaviorTreeEngine> engine;
+  BT::Blackboard::Ptr blackboard;
+};
+
+double percentileUs(std::vector<double> & latencies, double fraction)
+{
+  if (latencies.empty()) {
+    return 0.0;
+  }
+  const size_t rank = std::min(
+    latencies.size() - 1, static_cast<size_t>(std::ceil(fraction * latencies.size())) - 1);
+  std::nth_element(latencies.begin(), latencies.begin() + rank, latencies.end());
+  return latencies[rank] * 1e6;
+}
+
+// Loading of the tree, with the construction of all its nodes
+void BM_CreateTreeFromFile(benchmark::State & state, const std::string & tree_file)
+{
+  Navigator navigator(false);
+  // The first load creates the shared action clients, which later loads reuse
+  navigator.engine->createTreeFromFile(tree_file, navigator.blackboard);
+
+  const int64_t allocations = g_allocations.load();
+  for (auto _ : state) {
+    BT::Tree tree = navigator.engine->createTreeFromFile(tree_file, navigator.blackboard);
+    benchmark::DoNotOptimize(tree);
+  }
+  state.counters["allocations"] = benchmark::Counter(
+    g_allocations.load() - allocations, benchmark::Counter::kAvgIterations);
+}
+
+// Ticks while the controller follows the path, replanning at the rate of the tree
+void BM_TickWhileFollowing(
+  benchmark::State & state, const std::string & tree_file, bool async_action_clients)
+{
+  Navigator navigator(async_action_clients);
+  BT::Tree tree = navigator.engine->createTreeFromFile(tree_file, navigator.blackboard);
+  g_servers->holdFollowPath(true);
+
+  // Ticks until the path was sent to the controller
+  nav_msgs::msg::Path path;
+  const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+  while (std::chrono::steady_clock::now() < deadline && !navigator.blackboard->get("path", path)) {
+    tree.tickOnce();
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+  if (path.poses.empty()) {
+    tree.haltTree();
+    g_servers->holdFollowPath(false);
+    state.SkipWithError("The tree did not get a path to follow");
+    return;
+  }
+
+  std::vector<double> latencies;
+  latencies.reserve(state.max_iterations);
+  const int64_t allocations = g_allocations.load();
+  for (auto _ : state) {
+    const auto start = std::chrono::steady_clock::now();
+    const BT::NodeStatus status = tree.tickOnce();
+    latencies.push_back(
+      std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count());
+    if (status != BT::NodeStatus::RUNNING) {
+      state.SkipWithError("The tree stopped following the path");
+      break;
+    }
+  }
+  const int64_t tick_allocations = g_allocations.load() - allocations;
+
+  navigator.engine->haltAllActions(tree);
+  g_servers->holdFollowPath(false);
+
+  state.counters["ticks_per_s"] = benchmark::Counter(
+    state.iterations(), benchmark::Counter::kIsRate);
+  state.counters["allocations_per_tick"] = benchmark::Counter(
+    tick_allocations, benchmark::Counter::kAvgIterations);
+  state.counters["p50_us"] = percentileUs(latencies, 0.5);
+  state.counters["p99_us"] = percentileUs(latencies, 0.99);
+  state.counters["max_us"] = percentileUs(latencies, 1.0);
+}
+
+// Whole navigations to a controller arriving at once, ticked at the fixed rate of the
+// BT loop or as soon as the servers answer
+void BM_Navigate(benchmark::State & state, const std::string & tree_file, bool event_driven)
+{
+  Navigator navigator(event_driven);
+  BT::Tree tree = navigator.engine->createTreeFromFile(tree_file, navigator.blackboard);
+  const auto max_idle_duration = std::chrono::milliseconds(event_driven ? 100 : 0);
+
+  int64_t ticks = 0;
+  for (auto _ : state) {
+    const nav2_behavior_tree::BtStatus status = navigator.engine->run(
+      &tree, [&ticks]() {ticks++;}, []() {return false;}, kLoopDuration, max_idle_duration);
+    navigator.engine->haltAllActions(tree);
+    if (status != nav2_behavior_tree::BtStatus::SUCCEEDED) {
+      state.SkipWithError("The navigation failed");
+      break;
+    }
+  }
+  state.counters["ticks"] = benchmark::Counter(ticks, benchmark::Counter::kAvgIterations);
+}
+
+}  // namespace
+
+int main(int argc, char ** argv)
+{
+  benchmark::Initialize(&argc, argv);
+  const std::vector<std::string> args = rclcpp::init_and_remove_ros_arguments(argc, argv);
+
+  std::vector<std::string> tree_files;
+  for (size_t i = 1; i < args.size(); i++) {
+    if (args[i].rfind("--tree=", 0) == 0) {
+      tree_files.push_back(args[i].substr(7));
+    } else {
+      std::cerr << "Unknown argument " << args[i] << std::endl;
+      return 1;
+    }
+  }
+  if (tree_files.empty()) {
+    try {
+      const std::string trees =
+        ament_index_cpp::get_package_share_directory("nav2_bt_navigator") + "/behavior_trees/";
+      tree_files.push_back(trees + "navigate_to_pose_w_replanning_and_recovery.xml");
+      tree_files.push_back(trees + "navigate_through_poses_w_replanning_and_recovery.xml");
+    } catch (const std::exception &) {
+      std::cerr << "nav2_bt_navigator is not installed, give the trees with --tree" << std::endl;
+      return 1;
+    }
+  }
+
+  g_node = std::make_shared<rclcpp::Node>("navigator_tree_benchmark");
+  g_node->declare_parameter("global_frame", "map");
+  g_node->declare_parameter("robot_base_frame", "base_link");
+  g_node->declare_parameter("transform_tolerance", 0.1);
+  g_tf = std::make_shared<tf2_ros::Buffer>(g_node->get_clock());
+  geometry_msgs::msg::TransformStamped robot;
+  robot.header.frame_id = "map";
+  robot.child_frame_id = "base_link";
+  robot.transform.rotation.w = 1.0;
+  g_tf->setTransform(robot, "navigator_tree_benchmark", true);
+  g_servers = std::make_unique<MockServers>();
+
+  for (const auto & tree_file : tree_files) {
+    const size_t slash = tree_file.find_last_of('/');
+    std::string name = tree_file.substr(slash == std::string::npos ? 0 : slash + 1);
+    name = name.substr(0, name.rfind('.'));
+
+    benchmark::RegisterBenchmark(
+      ("BM_CreateTreeFromFile/" + name).c_str(), BM_CreateTreeFromFile, tree_file)
+    ->Unit(benchmark::kMillisecond);
+    for (bool async_action_clients : {false, true}) {
+      benchmark::RegisterBenchmark(
+        ("BM_TickWhileFollowing/" + name + (async_action_clients ? "/async" : "/sync")).c_str(),
+        BM_TickWhileFollowing, tree_file, async_action_clients)
+      ->Unit(benchmark::kMicrosecond);
+    }
+    for (bool event_driven : {false, true}) {
+      benchmark::RegisterBenchmark(
+        ("BM_Navigate/" + name + (event_driven ? "/event_driven" : "/fixed_rate")).c_str(),
+        BM_Navigate, tree_file, event_driven)
+      ->UseRealTime()->Unit(benchmark::kMillisecond);
+    }
+  }
+
+  benchmark::RunSpecifiedBenchmarks();
+
+  g_servers.reset();
+  g_tf.reset();
+  g_node.reset();
+  benchmark::Shutdown();
+  rclcpp::shutdown();
+  return 0;
+}
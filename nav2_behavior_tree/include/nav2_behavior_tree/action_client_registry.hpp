@@ -0,0 +1,212 @@
+// Copyright (c) 2024 Open Navigation LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef NAV2_BEHAVIOR_TREE__ACTION_CLIENT_REGISTRY_HPP_
+#define NAV2_BEHAVIOR_TREE__ACTION_CLIENT_REGISTRY_HPP_
+
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <unordered_map>
+
+#include "rclcpp/rclcpp.hpp"
+#include "rclcpp_action/rclcpp_action.hpp"
+
+namespace nav2_behavior_tree
+{
+
+/**
+ * @class nav2_behavior_tree::ActionClientRegistry
+ * @brief Action clients of a navigator, one per action name, with the callback
+ * group and executor serving them. The BT action nodes of all the trees of the
+ * navigator borrow them, so that reloading a tree or using an action in many
+ * nodes does not create a client, wait for its server and discover it again.
+ *
+ * The clients can be spun by a thread of the registry rather than by the ticks
+ * of the nodes, which then only read what the thread received and never wait
+ * on their executor.
+ */
+class ActionClientRegistry
+{
+public:
+  using Ptr = std::shared_ptr<ActionClientRegistry>;
+
+  /**
+   * @brief A client of the registry with the executor spinning its callback group
+   */
+  template<class ActionT>
+  struct Entry
+  {
+    typename rclcpp_action::Client<ActionT>::SharedPtr client;
+    std::shared_ptr<rclcpp::executors::SingleThreadedExecutor> executor;
+  };
+
+  /**
+   * @brief A constructor for nav2_behavior_tree::ActionClientRegistry
+   * @param node The node the clients are created on
+   * @param spin_in_thread Whether to spin all the clients in a thread of the registry
+   * @param on_event Called by the nodes when the thread received something for them
+   */
+  explicit ActionClientRegistry(
+    const rclcpp::Node::SharedPtr & node,
+    bool spin_in_thread = false,
+    std::function<void()> on_event = nullptr)
+  : node_(node), on_event_(on_event)
+  {
+    if (spin_in_thread) {
+      executor_ = std::make_shared<rclcpp::executors::SingleThreadedExecutor>();
+      spin_thread_ = std::make_unique<std::thread>(
+        [this]() {
+          while (rclcpp::ok() && !stop_) {
+            executor_->spin_once(std::chrono::milliseconds(100));
+          }
+        });
+    }
+  }
+
+  ~ActionClientRegistry()
+  {
+    stopSpinning();
+  }
+
+  /**
+   * @brief Whether the clients are spun by the thread of the registry, in which
+   * case their executor must not be spun by the nodes
+   */
+  bool isSpinning() const
+  {
+    return spin_thread_ != nullptr && !stop_;
+  }
+
+  /**
+   * @brief Stop the thread spinning the clients, if any
+   */
+  void stopSpinning()
+  {
+    if (spin_thread_) {
+      stop_ = true;
+      if (spin_thread_->joinable()) {
+        spin_thread_->join();
+      }
+    }
+    std::lock_guard<std::mutex> lock(event_mutex_);
+    on_event_ = nullptr;
+  }
+
+  /**
+   * @brief Signal that the thread received something for a node, to be called
+   * from the callbacks of the clients
+   */
+  void notifyEvent()
+  {
+    std::lock_guard<std::mutex> lock(event_mutex_);
+    if (on_event_) {
+      on_event_();
+    }
+  }
+
+  /**
+   * @brief Get the client of an action, creating it and waiting for its server
+   * on first use. A client whose server was not found is not kept, so that the
+   * next request waits again.
+   * @param action_name Name of the action
+   * @param wait_for_server_timeout Time to wait for the server of a new client
+   * @return Entry The client and its executor
+   */
+  template<class ActionT>
+  Entry<ActionT> getClient(
+    const std::string & action_name,
+    const std::chrono::milliseconds & wait_for_server_timeout)
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = clients_.find(action_name);
+    if (it != clients_.end()) {
+      auto client = std::dynamic_pointer_cast<rclcpp_action::Client<ActionT>>(it->second.client);
+      if (!client) {
+        throw std::runtime_error(
+                std::string("Action ") + action_name + " is already used with another type");
+      }
+      return Entry<ActionT>{client, it->second.executor};
+    }
+
+    // The groups spun by the thread are flagged as added with the node, which is never
+    // spun, so that they are not waited on by the BehaviorTreeEngine as well
+    StoredClient stored;
+    stored.callback_group = node_->create_callback_group(
+      rclcpp::CallbackGroupType::MutuallyExclusive, executor_ != nullptr);
+    stored.executor = executor_ ? executor_ :
+      std::make_shared<rclcpp::executors::SingleThreadedExecutor>();
+    stored.executor->add_callback_group(stored.callback_group, node_->get_node_base_interface());
+    auto client = rclcpp_action::create_client<ActionT>(node_, action_name, stored.callback_group);
+
+    RCLCPP_DEBUG(node_->get_logger(), "Waiting for \"%s\" action server", action_name.c_str());
+    if (!client->wait_for_action_server(wait_for_server_timeout)) {
+      RCLCPP_ERROR(
+        node_->get_logger(), "\"%s\" action server not available after waiting for %.2fs",
+        action_name.c_str(), wait_for_server_timeout.count() / 1000.0);
+      throw std::runtime_error(
+              std::string("Action server ") + action_name + std::string(" not available"));
+    }
+
+    stored.client = client;
+    clients_.emplace(action_name, stored);
+    return Entry<ActionT>{client, stored.executor};
+  }
+
+  /**
+   * @brief Number of clients in the registry
+   */
+  size_t size()
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return clients_.size();
+  }
+
+  /**
+   * @brief Destroy all the clients of the registry
+   */
+  void clear()
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    clients_.clear();
+  }
+
+protected:
+  struct StoredClient
+  {
+    rclcpp_action::ClientBase::SharedPtr client;
+    rclcpp::CallbackGroup::SharedPtr callback_group;
+    std::shared_ptr<rclcpp::executors::SingleThreadedExecutor> executor;
+  };
+
+  rclcpp::Node::SharedPtr node_;
+  std::mutex mutex_;
+  std::unordered_map<std::string, StoredClient> clients_;
+
+  // Executor of all the clients and its thread, when spinning in a thread
+  std::shared_ptr<rclcpp::executors::SingleThreadedExecutor> executor_;
+  std::unique_ptr<std::thread> spin_thread_;
+  std::atomic<bool> stop_{false};
+  std::mutex event_mutex_;
+  std::function<void()> on_event_;
+};
+
+}  // namespace nav2_behavior_tree
+
+#endif  // NAV2_BEHAVIOR_TREE__ACTION_CLIENT_REGISTRY_HPP_
@@ -18,6 +18,7 @@
 
 #include <memory>
 #include <string>
+#include <unordered_set>
 #include <vector>
 
 #include "behaviortree_cpp/behavior_tree.h"
@@ -44,7 +45,8 @@ class BehaviorTreeEngine
 public:
   /**
    * @brief A constructor for nav2_behavior_tree::BehaviorTreeEngine
-   * @param plugin_libraries vector of BT plugin library names to load
+   * @param plugin_libraries vector of BT plugin library names to load, once per process
+   * for all the engines using the same ones
    */
   explicit BehaviorTreeEngine(
     const std::vector<std::string> & plugin_libraries,
@@ -57,13 +59,23 @@ public:
    * @param onLoop Function to execute on each iteration of BT execution
    * @param cancelRequested Function to check if cancel was requested during BT execution
    * @param loopTimeout Time period for each iteration of BT execution
+   * @param maxIdleDuration If positive, the tree is ticked as soon as an event of the BT
+   * nodes or a wakeUp call arrives, and at least once per maxIdleDuration, rather than at
+   * the fixed loopTimeout rate
    * @return nav2_behavior_tree::BtStatus Status of BT execution
    */
   BtStatus run(
     BT::Tree * tree,
     std::function<void()> onLoop,
     std::function<bool()> cancelRequested,
-    std::chrono::milliseconds loopTimeout = std::chrono::milliseconds(10));
+    std::chrono::milliseconds loopTimeout = std::chrono::milliseconds(10),
+    std::chrono::milliseconds maxIdleDuration = std::chrono::milliseconds(0));
+
+  /**
+   * @brief Wake a run waiting for events up, so that the tree is ticked at once.
+   * Can be called from any thread, typically on goal, preemption or cancel requests
+   */
+  void wakeUp();
 
   /**
    * @brief Function to create a BT from a XML string
@@ -91,12 +103,35 @@ public:
    */
   void haltAllActions(BT::Tree & tree);
 
+  /**
+   * @brief Get the factory of the process with the nodes of the plugins registered, created
+   * by the first engine using them and kept while an engine uses it. Trees are created
+   * from their XML by a parser of their own, so the factory is only read once created
+   * @param plugin_libraries vector of BT plugin library names to load
+   * @return std::shared_ptr<BT::BehaviorTreeFactory> The factory
+   */
+  static std::shared_ptr<BT::BehaviorTreeFactory> getSharedFactory(
+    const std::vector<std::string> & plugin_libraries);
+
 protected:
+  /**
+   * @brief Wait until a callback of the BT nodes is ready, wakeUp is called or a timeout
+   * @param timeout Longest wait
+   */
+  void waitForEvent(std::chrono::milliseconds timeout);
+
   // The factory that will be used to dynamically construct the behavior tree
-  BT::BehaviorTreeFactory factory_;
+  std::shared_ptr<BT::BehaviorTreeFactory> factory_;
 
   // Clock
   rclcpp::Clock::SharedPtr clock_;
+
+  // Node of the BT nodes, whose own callback groups are the events waited for
+  rclcpp::node_interfaces::NodeBaseInterface::SharedPtr node_base_;
+  rclcpp::GuardCondition::SharedPtr wake_up_;
+  // Entities left ready by the last tick, such as the topics of BT nodes not ticked,
+  // which are no longer waited for until they are consumed
+  std::unordered_set<const void *> stale_events_;
 };
 
 }  // namespace nav2_behavior_tree
@@ -0,0 +1,152 @@
+// Copyright (c) 2024 Open Navigation LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef NAV2_BEHAVIOR_TREE__BEHAVIOR_TREE_PROFILER_HPP_
+#define NAV2_BEHAVIOR_TREE__BEHAVIOR_TREE_PROFILER_HPP_
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "behaviortree_cpp/behavior_tree.h"
+#include "rclcpp/rclcpp.hpp"
+#include "nav2_msgs/msg/behavior_tree_profile.hpp"
+
+namespace nav2_behavior_tree
+{
+
+/**
+ * @class nav2_behavior_tree::BehaviorTreeProfiler
+ * @brief Records the number and duration of the ticks of each node of a BT, through the
+ * pre and post tick callbacks of its nodes. The durations of a node are recorded with and
+ * without those of its children, and as a histogram, then published on behavior_tree_profile
+ * or written as folded stacks, the input of flame graph tools.
+ */
+class BehaviorTreeProfiler
+{
+public:
+  static constexpr size_t kHistogramSize = 24;
+
+  /**
+   * @struct NodeProfile
+   * @brief The tick durations of a node
+   */
+  struct NodeProfile
+  {
+    const BT::TreeNode * node{nullptr};
+    std::string path;
+    uint64_t tick_count{0};
+    std::chrono::nanoseconds total_duration{0};
+    std::chrono::nanoseconds self_duration{0};
+    std::chrono::nanoseconds max_duration{0};
+    std::array<uint64_t, kHistogramSize> histogram{};
+  };
+
+  /**
+   * @brief A constructor for nav2_behavior_tree::BehaviorTreeProfiler, setting the tick
+   * callbacks of the nodes of the tree, which must not be set by anything else
+   * @param ros_node Weak pointer to parent rclcpp::Node
+   * @param tree BT to profile
+   * @param publish_period Shortest period between two profiles published by publishIfDue
+   */
+  BehaviorTreeProfiler(
+    const rclcpp::Node::WeakPtr & ros_node, BT::Tree & tree,
+    std::chrono::milliseconds publish_period = std::chrono::milliseconds(1000));
+
+  /**
+   * @brief A destructor for nav2_behavior_tree::BehaviorTreeProfiler, removing the tick
+   * callbacks of the nodes
+   */
+  ~BehaviorTreeProfiler();
+
+  BehaviorTreeProfiler(const BehaviorTreeProfiler &) = delete;
+  BehaviorTreeProfiler & operator=(const BehaviorTreeProfiler &) = delete;
+
+  /**
+   * @brief Publish the profile if the last one is older than the publish period
+   */
+  void publishIfDue();
+
+  /**
+   * @brief Publish the profile of all the nodes ticked at least once
+   */
+  void publish();
+
+  /**
+   * @brief Write the self durations of the nodes as folded stacks, one line per node
+   * with its path and the microseconds spent in its own ticks
+   * @param filename The file to write, replaced if it exists
+   * @return bool true if the file was written
+   */
+  bool writeFoldedStacks(const std::string & filename) const;
+
+  /**
+   * @brief Getter function for the profiles of the nodes, in depth-first order
+   */
+  const std::vector<NodeProfile> & getProfiles() const
+  {
+    return profiles_;
+  }
+
+  /**
+   * @brief Forget the ticks recorded so far
+   */
+  void reset();
+
+  /**
+   * @brief Get the histogram bucket of a tick duration
+   * @param duration The duration of the tick
+   * @return size_t The bucket, ticks shorter than 2^i microseconds being in bucket i
+   */
+  static size_t histogramBucket(std::chrono::nanoseconds duration);
+
+protected:
+  /**
+   * @struct Frame
+   * @brief A tick in progress, in the stack of the ticks of the ancestors of a node
+   */
+  struct Frame
+  {
+    size_t index;
+    std::chrono::steady_clock::time_point start;
+    std::chrono::nanoseconds children_duration;
+  };
+
+  /**
+   * @brief Start timing a tick of a node
+   * @param index The index of the node in the profiles
+   */
+  void onPreTick(size_t index);
+
+  /**
+   * @brief Record the tick of a node, and its duration in the children duration of its parent
+   * @param index The index of the node in the profiles
+   */
+  void onPostTick(size_t index);
+
+  std::vector<BT::TreeNode *> nodes_;
+  std::vector<NodeProfile> profiles_;
+  std::vector<Frame> stack_;
+
+  rclcpp::Clock::SharedPtr clock_;
+  rclcpp::Publisher<nav2_msgs::msg::BehaviorTreeProfile>::SharedPtr profile_pub_;
+  std::chrono::milliseconds publish_period_;
+  std::chrono::steady_clock::time_point last_publish_time_;
+};
+
+}  // namespace nav2_behavior_tree
+
+#endif  // NAV2_BEHAVIOR_TREE__BEHAVIOR_TREE_PROFILER_HPP_
@@ -15,7 +15,10 @@
 #ifndef NAV2_BEHAVIOR_TREE__BT_ACTION_NODE_HPP_
 #define NAV2_BEHAVIOR_TREE__BT_ACTION_NODE_HPP_
 
+#include <atomic>
 #include <memory>
+#include <mutex>
+#include <optional>
 #include <string>
 #include <chrono>
 
@@ -23,6 +26,7 @@
 #include "nav2_util/node_utils.hpp"
 #include "rclcpp_action/rclcpp_action.hpp"
 #include "nav2_behavior_tree/bt_utils.hpp"
+#include "nav2_behavior_tree/action_client_registry.hpp"
 
 namespace nav2_behavior_tree
 {
@@ -50,10 +54,19 @@ public:
   : BT::ActionNodeBase(xml_tag_name, conf), action_name_(action_name), should_send_goal_(true)
   {
     node_ = config().blackboard->template get<rclcpp::Node::SharedPtr>("node");
-    callback_group_ = node_->create_callback_group(
-      rclcpp::CallbackGroupType::MutuallyExclusive,
-      false);
-    callback_group_executor_.add_callback_group(callback_group_, node_->get_node_base_interface());
+
+    // Borrow the client of the action from the navigator when it shares them,
+    // otherwise this node has its own
+    if (!config().blackboard->get("action_client_registry", client_registry_) ||
+      !client_registry_)
+    {
+      callback_group_ = node_->create_callback_group(
+        rclcpp::CallbackGroupType::MutuallyExclusive,
+        false);
+      callback_group_executor_ = std::make_shared<rclcpp::executors::SingleThreadedExecutor>();
+      callback_group_executor_->add_callback_group(
+        callback_group_, node_->get_node_base_interface());
+    }
 
     // Get the required items from the blackboard
     auto bt_loop_duration =
@@ -93,6 +106,15 @@ public:
    */
   void createActionClient(const std::string & action_name)
   {
+    if (client_registry_) {
+      auto entry = client_registry_->template getClient<ActionT>(
+        action_name, wait_for_service_timeout_);
+      action_client_ = entry.client;
+      callback_group_executor_ = entry.executor;
+      async_spin_ = client_registry_->isSpinning();
+      return;
+    }
+
     // Now that we have the ROS node to use, create the action client for this BT action
     action_client_ = rclcpp_action::create_client<ActionT>(node_, action_name, callback_group_);
 
@@ -259,7 +281,11 @@ public:
           }
         }
 
-        callback_group_executor_.spin_some();
+        if (async_spin_) {
+          take_async_updates();
+        } else {
+          callback_group_executor_->spin_some();
+        }
 
         // check if, after invoking spin_some(), we finally received the result
         if (!goal_result_available_) {
@@ -308,22 +334,27 @@ public:
   void halt() override
   {
     if (should_cancel_goal()) {
-      auto future_result = action_client_->async_get_result(goal_handle_);
-      auto future_cancel = action_client_->async_cancel_goal(goal_handle_);
-      if (callback_group_executor_.spin_until_future_complete(future_cancel, server_timeout_) !=
-        rclcpp::FutureReturnCode::SUCCESS)
-      {
-        RCLCPP_ERROR(
-          node_->get_logger(),
-          "Failed to cancel action server for %s", action_name_.c_str());
-      }
+      if (async_spin_) {
+        // The thread spinning the client completes the cancel, the tree does not wait for it
+        action_client_->async_cancel_goal(goal_handle_);
+      } else {
+        auto future_result = action_client_->async_get_result(goal_handle_);
+        auto future_cancel = action_client_->async_cancel_goal(goal_handle_);
+        if (callback_group_executor_->spin_until_future_complete(future_cancel, server_timeout_) !=
+          rclcpp::FutureReturnCode::SUCCESS)
+        {
+          RCLCPP_ERROR(
+            node_->get_logger(),
+            "Failed to cancel action server for %s", action_name_.c_str());
+        }
 
-      if (callback_group_executor_.spin_until_future_complete(future_result, server_timeout_) !=
-        rclcpp::FutureReturnCode::SUCCESS)
-      {
-        RCLCPP_ERROR(
-          node_->get_logger(),
-          "Failed to get result for %s in node halt!", action_name_.c_str());
+        if (callback_group_executor_->spin_until_future_complete(future_result, server_timeout_) !=
+          rclcpp::FutureReturnCode::SUCCESS)
+        {
+          RCLCPP_ERROR(
+            node_->get_logger(),
+            "Failed to get result for %s in node halt!", action_name_.c_str());
+        }
       }
 
       on_cancelled();
@@ -351,7 +382,11 @@ protected:
       return false;
     }
 
-    callback_group_executor_.spin_some();
+    if (async_spin_) {
+      take_async_updates();
+    } else {
+      callback_group_executor_->spin_some();
+    }
     auto status = goal_handle_->get_status();
 
     // Check if the goal is still executing
@@ -366,8 +401,24 @@ protected:
   {
     goal_result_available_ = false;
     auto send_goal_options = typename rclcpp_action::Client<ActionT>::SendGoalOptions();
+    if (async_spin_) {
+      set_async_callbacks(send_goal_options);
+      future_goal_handle_ = std::make_shared<
+        std::shared_future<typename rclcpp_action::ClientGoalHandle<ActionT>::SharedPtr>>(
+        action_client_->async_send_goal(goal_, send_goal_options));
+      time_goal_sent_ = node_->now();
+      return;
+    }
+
+    // The client may be shared and outlive this node, the alive token keeps its
+    // callbacks from reaching a destroyed node
+    std::weak_ptr<void> alive = alive_;
     send_goal_options.result_callback =
-      [this](const typename rclcpp_action::ClientGoalHandle<ActionT>::WrappedResult & result) {
+      [this, alive](
+      const typename rclcpp_action::ClientGoalHandle<ActionT>::WrappedResult & result) {
+        if (alive.expired()) {
+          return;
+        }
         if (future_goal_handle_) {
           RCLCPP_DEBUG(
             node_->get_logger(),
@@ -386,8 +437,11 @@ protected:
         }
       };
     send_goal_options.feedback_callback =
-      [this](typename rclcpp_action::ClientGoalHandle<ActionT>::SharedPtr,
+      [this, alive](typename rclcpp_action::ClientGoalHandle<ActionT>::SharedPtr,
       const std::shared_ptr<const typename ActionT::Feedback> feedback) {
+        if (alive.expired()) {
+          return;
+        }
         feedback_ = feedback;
         emitWakeUpSignal();
       };
@@ -414,26 +468,105 @@ protected:
       return false;
     }
 
-    auto timeout = remaining > max_timeout_ ? max_timeout_ : remaining;
-    auto result =
-      callback_group_executor_.spin_until_future_complete(*future_goal_handle_, timeout);
-    elapsed += timeout;
+    if (async_spin_) {
+      // The thread spinning the client completes the future, the tick only checks it
+      if (future_goal_handle_->wait_for(std::chrono::seconds(0)) != std::future_status::ready) {
+        return false;
+      }
+    } else {
+      auto timeout = remaining > max_timeout_ ? max_timeout_ : remaining;
+      auto result =
+        callback_group_executor_->spin_until_future_complete(*future_goal_handle_, timeout);
+      elapsed += timeout;
+
+      if (result == rclcpp::FutureReturnCode::INTERRUPTED) {
+        future_goal_handle_.reset();
+        throw std::runtime_error("send_goal failed");
+      }
 
-    if (result == rclcpp::FutureReturnCode::INTERRUPTED) {
-      future_goal_handle_.reset();
-      throw std::runtime_error("send_goal failed");
+      if (result != rclcpp::FutureReturnCode::SUCCESS) {
+        return false;
+      }
     }
 
-    if (result == rclcpp::FutureReturnCode::SUCCESS) {
-      goal_handle_ = future_goal_handle_->get();
-      future_goal_handle_.reset();
-      if (!goal_handle_) {
-        throw std::runtime_error("Goal was rejected by the action server");
-      }
-      return true;
+    goal_handle_ = future_goal_handle_->get();
+    future_goal_handle_.reset();
+    if (!goal_handle_) {
+      throw std::runtime_error("Goal was rejected by the action server");
+    }
+    return true;
+  }
+
+  /**
+   * @brief Function to set the callbacks of a goal when the client is spun by a thread of
+   * the registry. They only hand the result and feedback over to the next tick.
+   * @param options Options of the goal to send
+   */
+  void set_async_callbacks(typename rclcpp_action::Client<ActionT>::SendGoalOptions & options)
+  {
+    {
+      std::lock_guard<std::mutex> lock(async_updates_->mutex);
+      async_updates_->result.reset();
+      async_updates_->feedback.reset();
+      async_updates_->pending = false;
+    }
+
+    auto updates = async_updates_;
+    std::weak_ptr<ActionClientRegistry> registry = client_registry_;
+    options.result_callback =
+      [updates, registry](
+      const typename rclcpp_action::ClientGoalHandle<ActionT>::WrappedResult & result) {
+        {
+          std::lock_guard<std::mutex> lock(updates->mutex);
+          updates->result = result;
+        }
+        updates->pending = true;
+        if (auto shared_registry = registry.lock()) {
+          shared_registry->notifyEvent();
+        }
+      };
+    options.feedback_callback =
+      [updates, registry](typename rclcpp_action::ClientGoalHandle<ActionT>::SharedPtr,
+      const std::shared_ptr<const typename ActionT::Feedback> feedback) {
+        {
+          std::lock_guard<std::mutex> lock(updates->mutex);
+          updates->feedback = feedback;
+        }
+        updates->pending = true;
+        if (auto shared_registry = registry.lock()) {
+          shared_registry->notifyEvent();
+        }
+      };
+  }
+
+  /**
+   * @brief Function to take the result and feedback received by the thread spinning the
+   * client since the last call. A result is kept until the goal handle is known.
+   */
+  void take_async_updates()
+  {
+    if (!async_updates_->pending.exchange(false)) {
+      return;
     }
 
-    return false;
+    {
+      std::lock_guard<std::mutex> lock(async_updates_->mutex);
+      if (async_updates_->feedback) {
+        feedback_ = std::move(async_updates_->feedback);
+      }
+      if (async_updates_->result && goal_handle_) {
+        // if goal ids are not matched, the result is from an older goal, ignore it
+        if (goal_handle_->get_goal_id() == async_updates_->result->goal_id) {
+          goal_result_available_ = true;
+          result_ = *async_updates_->result;
+        }
+        async_updates_->result.reset();
+      }
+      if (async_updates_->result) {
+        async_updates_->pending = true;
+      }
+    }
+    emitWakeUpSignal();
   }
 
   /**
@@ -463,7 +596,22 @@ protected:
   // The node that will be used for any ROS operations
   rclcpp::Node::SharedPtr node_;
   rclcpp::CallbackGroup::SharedPtr callback_group_;
-  rclcpp::executors::SingleThreadedExecutor callback_group_executor_;
+  std::shared_ptr<rclcpp::executors::SingleThreadedExecutor> callback_group_executor_;
+
+  // Clients shared by the nodes of the navigator, if any
+  ActionClientRegistry::Ptr client_registry_;
+  std::shared_ptr<void> alive_{std::make_shared<bool>(true)};
+
+  // Result and feedback received by the thread of the registry, when it spins the client
+  struct AsyncUpdates
+  {
+    std::mutex mutex;
+    std::atomic<bool> pending{false};
+    std::optional<typename rclcpp_action::ClientGoalHandle<ActionT>::WrappedResult> result;
+    std::shared_ptr<const typename ActionT::Feedback> feedback;
+  };
+  bool async_spin_{false};
+  std::shared_ptr<AsyncUpdates> async_updates_{std::make_shared<AsyncUpdates>()};
 
   // The timeout value while waiting for response from a server when a
   // new action goal is sent or canceled
@@ -17,10 +17,13 @@
 
 #include <memory>
 #include <string>
+#include <unordered_map>
 #include <vector>
 
 #include "geometry_msgs/msg/pose_stamped.hpp"
+#include "nav2_behavior_tree/action_client_registry.hpp"
 #include "nav2_behavior_tree/behavior_tree_engine.hpp"
+#include "nav2_behavior_tree/behavior_tree_profiler.hpp"
 #include "nav2_behavior_tree/ros_topic_logger.hpp"
 #include "nav2_util/lifecycle_node.hpp"
 #include "nav2_util/simple_action_server.hpp"
@@ -185,6 +188,30 @@ public:
   }
 
 protected:
+  /**
+   * @struct CachedTree
+   * @brief An instantiated behavior tree not being executed, its logger and profiler
+   */
+  struct CachedTree
+  {
+    BT::Tree tree;
+    std::unique_ptr<RosTopicLogger> topic_logger;
+    std::unique_ptr<BehaviorTreeProfiler> profiler;
+  };
+
+  /**
+   * @brief Create a BT from its file, with the blackboards of its subtrees set up
+   * @param filename The file containing the BT
+   * @param cached Output tree, logger and profiler
+   * @return bool true if the BT was created
+   */
+  bool createTree(const std::string & filename, CachedTree & cached);
+
+  /**
+   * @brief Halt the current BT and move it to the cache, to be reused by later goals
+   */
+  void cacheCurrentTree();
+
   /**
    * @brief Action server callback
    */
@@ -230,6 +257,9 @@ protected:
   // A regular, non-spinning ROS node that we can use for calls to the action client
   rclcpp::Node::SharedPtr client_node_;
 
+  // The action clients of the BT nodes, one per action
+  ActionClientRegistry::Ptr action_client_registry_;
+
   // Parent node
   rclcpp_lifecycle::LifecycleNode::WeakPtr node_;
 
@@ -242,9 +272,26 @@ protected:
   // To publish BT logs
   std::unique_ptr<RosTopicLogger> topic_logger_;
 
+  // Whether the BT logs refer to the nodes by uid, how often and by how many they are published
+  bool compact_log_ = false;
+  std::chrono::milliseconds log_flush_period_;
+  size_t log_buffer_size_;
+
+  // To record the tick durations of the BT nodes, if profiling
+  std::unique_ptr<BehaviorTreeProfiler> profiler_;
+  bool profiling_ = false;
+  std::chrono::milliseconds profiling_publish_period_;
+  std::string profiling_output_file_;
+
   // Duration for each iteration of BT execution
   std::chrono::milliseconds bt_loop_duration_;
 
+  // Longest period without a tick when ticking on events, or 0 to tick at a fixed rate
+  std::chrono::milliseconds bt_max_idle_duration_;
+
+  // Whether the action clients are spun by a thread rather than by the ticks of the BT nodes
+  bool async_action_clients_ = false;
+
   // Default timeout value while waiting for response from a server
   std::chrono::milliseconds default_server_timeout_;
 
@@ -254,6 +301,10 @@ protected:
   // should the BT be reloaded even if the same xml filename is requested?
   bool always_reload_bt_xml_ = false;
 
+  // Instantiated BTs other than the current one, by filename, and those created at activation
+  std::unordered_map<std::string, CachedTree> tree_cache_;
+  std::vector<std::string> preload_bt_xml_filenames_;
+
   // User-provided callbacks
   OnGoalReceivedCallback on_goal_received_callback_;
   OnLoopCallback on_loop_callback_;
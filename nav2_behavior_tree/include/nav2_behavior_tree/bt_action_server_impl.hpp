@@ -15,6 +15,7 @@
 #ifndef NAV2_BEHAVIOR_TREE__BT_ACTION_SERVER_IMPL_HPP_
 #define NAV2_BEHAVIOR_TREE__BT_ACTION_SERVER_IMPL_HPP_
 
+#include <algorithm>
 #include <memory>
 #include <string>
 #include <fstream>
@@ -58,6 +59,12 @@ BtActionServer<ActionT>::BtActionServer(
   if (!node->has_parameter("bt_loop_duration")) {
     node->declare_parameter("bt_loop_duration", 10);
   }
+  if (!node->has_parameter("bt_max_idle_duration")) {
+    node->declare_parameter("bt_max_idle_duration", 0);
+  }
+  if (!node->has_parameter("bt_async_action_clients")) {
+    node->declare_parameter("bt_async_action_clients", false);
+  }
   if (!node->has_parameter("default_server_timeout")) {
     node->declare_parameter("default_server_timeout", 20);
   }
@@ -67,9 +74,30 @@ BtActionServer<ActionT>::BtActionServer(
   if (!node->has_parameter("always_reload_bt_xml")) {
     node->declare_parameter("always_reload_bt_xml", false);
   }
+  if (!node->has_parameter("preload_bt_xml_filenames")) {
+    node->declare_parameter("preload_bt_xml_filenames", std::vector<std::string>{});
+  }
   if (!node->has_parameter("wait_for_service_timeout")) {
     node->declare_parameter("wait_for_service_timeout", 1000);
   }
+  if (!node->has_parameter("bt_compact_log")) {
+    node->declare_parameter("bt_compact_log", false);
+  }
+  if (!node->has_parameter("bt_log_flush_period")) {
+    node->declare_parameter("bt_log_flush_period", 0);
+  }
+  if (!node->has_parameter("bt_log_buffer_size")) {
+    node->declare_parameter("bt_log_buffer_size", 1000);
+  }
+  if (!node->has_parameter("bt_profiling")) {
+    node->declare_parameter("bt_profiling", false);
+  }
+  if (!node->has_parameter("bt_profiling_publish_period")) {
+    node->declare_parameter("bt_profiling_publish_period", 1000);
+  }
+  if (!node->has_parameter("bt_profiling_output_file")) {
+    node->declare_parameter("bt_profiling_output_file", std::string(""));
+  }
 
   std::vector<std::string> error_code_names = {
     "follow_path_error_code",
@@ -124,6 +152,8 @@ bool BtActionServer<ActionT>::on_configure()
       "-r",
       std::string("__node:=") +
       std::string(node->get_name()) + "_" + client_node_name + "_rclcpp_node",
+      "-r",
+      std::string("__ns:=") + node->get_namespace(),
       "-p",
       "use_sim_time:=" +
       std::string(node->get_parameter("use_sim_time").as_bool() ? "true" : "false"),
@@ -161,6 +191,10 @@ bool BtActionServer<ActionT>::on_configure()
   int bt_loop_duration;
   node->get_parameter("bt_loop_duration", bt_loop_duration);
   bt_loop_duration_ = std::chrono::milliseconds(bt_loop_duration);
+  int bt_max_idle_duration;
+  node->get_parameter("bt_max_idle_duration", bt_max_idle_duration);
+  bt_max_idle_duration_ = std::chrono::milliseconds(bt_max_idle_duration);
+  node->get_parameter("bt_async_action_clients", async_action_clients_);
   int default_server_timeout;
   node->get_parameter("default_server_timeout", default_server_timeout);
   default_server_timeout_ = std::chrono::milliseconds(default_server_timeout);
@@ -168,6 +202,19 @@ bool BtActionServer<ActionT>::on_configure()
   node->get_parameter("wait_for_service_timeout", wait_for_service_timeout);
   wait_for_service_timeout_ = std::chrono::milliseconds(wait_for_service_timeout);
   node->get_parameter("always_reload_bt_xml", always_reload_bt_xml_);
+  node->get_parameter("preload_bt_xml_filenames", preload_bt_xml_filenames_);
+  node->get_parameter("bt_compact_log", compact_log_);
+  int log_flush_period;
+  node->get_parameter("bt_log_flush_period", log_flush_period);
+  log_flush_period_ = std::chrono::milliseconds(log_flush_period);
+  int log_buffer_size;
+  node->get_parameter("bt_log_buffer_size", log_buffer_size);
+  log_buffer_size_ = static_cast<size_t>(std::max(log_buffer_size, 1));
+  node->get_parameter("bt_profiling", profiling_);
+  int profiling_publish_period;
+  node->get_parameter("bt_profiling_publish_period", profiling_publish_period);
+  profiling_publish_period_ = std::chrono::milliseconds(profiling_publish_period);
+  node->get_parameter("bt_profiling_output_file", profiling_output_file_);
 
   // Get error code id names to grab off of the blackboard
   error_code_names_ = node->get_parameter("error_code_names").as_string_array();
@@ -175,6 +222,16 @@ bool BtActionServer<ActionT>::on_configure()
   // Create the class that registers our custom nodes and executes the BT
   bt_ = std::make_unique<nav2_behavior_tree::BehaviorTreeEngine>(plugin_lib_names_, client_node_);
 
+  // Preemptions and cancels are checked at the next tick, so have it happen at once
+  if (bt_max_idle_duration_.count() > 0) {
+    action_server_->setRequestCallback(
+      [this]() {
+        if (bt_) {
+          bt_->wakeUp();
+        }
+      });
+  }
+
   // Create the blackboard that will be shared by all of the nodes in the tree
   blackboard_ = BT::Blackboard::create();
 
@@ -186,6 +243,18 @@ bool BtActionServer<ActionT>::on_configure()
     "wait_for_service_timeout",
     wait_for_service_timeout_);
 
+  // The action clients are shared by all of the nodes of all of the trees, and spun by
+  // a thread of the registry when asynchronous, which then wakes up the tree
+  action_client_registry_ = std::make_shared<ActionClientRegistry>(
+    client_node_, async_action_clients_,
+    [this]() {
+      if (bt_) {
+        bt_->wakeUp();
+      }
+    });
+  blackboard_->set<ActionClientRegistry::Ptr>(
+    "action_client_registry", action_client_registry_);  // NOLINT
+
   return true;
 }
 
@@ -196,6 +265,21 @@ bool BtActionServer<ActionT>::on_activate()
     RCLCPP_ERROR(logger_, "Error loading XML file: %s", default_bt_xml_filename_.c_str());
     return false;
   }
+
+  // Instantiate the BTs that goals may switch to, so that they do not pay for it
+  if (!always_reload_bt_xml_) {
+    for (const auto & filename : preload_bt_xml_filenames_) {
+      if (filename == current_bt_xml_filename_ || tree_cache_.count(filename)) {
+        continue;
+      }
+      CachedTree cached;
+      if (!createTree(filename, cached)) {
+        RCLCPP_ERROR(logger_, "Error preloading XML file: %s", filename.c_str());
+        return false;
+      }
+      tree_cache_.emplace(filename, std::move(cached));
+    }
+  }
   action_server_->activate();
   return true;
 }
@@ -213,10 +297,17 @@ bool BtActionServer<ActionT>::on_cleanup()
   client_node_.reset();
   action_server_.reset();
   topic_logger_.reset();
+  profiler_.reset();
   plugin_lib_names_.clear();
   current_bt_xml_filename_.clear();
   blackboard_.reset();
   bt_->haltAllActions(tree_);
+  for (auto & cached : tree_cache_) {
+    cached.second.tree.haltTree();
+  }
+  tree_cache_.clear();
+  action_client_registry_->stopSpinning();
+  action_client_registry_.reset();
   bt_.reset();
   return true;
 }
@@ -233,6 +324,39 @@ bool BtActionServer<ActionT>::loadBehaviorTree(const std::string & bt_xml_filena
     return true;
   }
 
+  // Switch to the BT of a previous goal, its nodes and action clients already created
+  if (!always_reload_bt_xml_) {
+    auto cached = tree_cache_.find(filename);
+    if (cached != tree_cache_.end()) {
+      CachedTree next = std::move(cached->second);
+      tree_cache_.erase(cached);
+      cacheCurrentTree();
+      profiler_ = std::move(next.profiler);
+      tree_ = std::move(next.tree);
+      topic_logger_ = std::move(next.topic_logger);
+      topic_logger_->publishDescription();
+      current_bt_xml_filename_ = filename;
+      return true;
+    }
+  }
+
+  CachedTree created;
+  if (!createTree(filename, created)) {
+    return false;
+  }
+
+  // The profiler of a tree not cached is released before its nodes
+  cacheCurrentTree();
+  profiler_ = std::move(created.profiler);
+  tree_ = std::move(created.tree);
+  topic_logger_ = std::move(created.topic_logger);
+  current_bt_xml_filename_ = filename;
+  return true;
+}
+
+template<class ActionT>
+bool BtActionServer<ActionT>::createTree(const std::string & filename, CachedTree & cached)
+{
   // Read the input BT XML from the specified file into a string
   std::ifstream xml_file(filename);
 
@@ -243,8 +367,8 @@ bool BtActionServer<ActionT>::loadBehaviorTree(const std::string & bt_xml_filena
 
   // Create the Behavior Tree from the XML input
   try {
-    tree_ = bt_->createTreeFromFile(filename, blackboard_);
-    for (auto & subtree : tree_.subtrees) {
+    cached.tree = bt_->createTreeFromFile(filename, blackboard_);
+    for (auto & subtree : cached.tree.subtrees) {
       auto & blackboard = subtree->blackboard;
       blackboard->set("node", client_node_);
       blackboard->set<std::chrono::milliseconds>("server_timeout", default_server_timeout_);
@@ -252,18 +376,38 @@ bool BtActionServer<ActionT>::loadBehaviorTree(const std::string & bt_xml_filena
       blackboard->set<std::chrono::milliseconds>(
         "wait_for_service_timeout",
         wait_for_service_timeout_);
+      blackboard->set<ActionClientRegistry::Ptr>(
+        "action_client_registry", action_client_registry_);
     }
   } catch (const std::exception & e) {
     RCLCPP_ERROR(logger_, "Exception when loading BT: %s", e.what());
     return false;
   }
 
-  topic_logger_ = std::make_unique<RosTopicLogger>(client_node_, tree_);
-
-  current_bt_xml_filename_ = filename;
+  cached.topic_logger = std::make_unique<RosTopicLogger>(
+    client_node_, cached.tree, compact_log_, log_flush_period_, log_buffer_size_);
+  if (profiling_) {
+    cached.profiler = std::make_unique<BehaviorTreeProfiler>(
+      client_node_, cached.tree, profiling_publish_period_);
+  }
   return true;
 }
 
+template<class ActionT>
+void BtActionServer<ActionT>::cacheCurrentTree()
+{
+  // Trees are reloaded on every switch otherwise, so there is nothing to keep
+  if (always_reload_bt_xml_ || current_bt_xml_filename_.empty()) {
+    return;
+  }
+
+  tree_.haltTree();
+  CachedTree & cached = tree_cache_[current_bt_xml_filename_];
+  cached.tree = std::move(tree_);
+  cached.topic_logger = std::move(topic_logger_);
+  cached.profiler = std::move(profiler_);
+}
+
 template<class ActionT>
 void BtActionServer<ActionT>::executeCallback()
 {
@@ -290,11 +434,27 @@ void BtActionServer<ActionT>::executeCallback()
         on_preempt_callback_(action_server_->get_pending_goal());
       }
       topic_logger_->flush();
+      if (profiler_) {
+        profiler_->publishIfDue();
+      }
       on_loop_callback_();
     };
 
   // Execute the BT that was previously created in the configure step
-  nav2_behavior_tree::BtStatus rc = bt_->run(&tree_, on_loop, is_canceling, bt_loop_duration_);
+  nav2_behavior_tree::BtStatus rc = bt_->run(
+    &tree_, on_loop, is_canceling, bt_loop_duration_, bt_max_idle_duration_);
+
+  // The last transitions may still be buffered, waiting for the flush period
+  topic_logger_->publish();
+  if (profiler_) {
+    profiler_->publish();
+    if (!profiling_output_file_.empty() &&
+      !profiler_->writeFoldedStacks(profiling_output_file_))
+    {
+      RCLCPP_WARN(
+        logger_, "Couldn't write BT profile to file: %s", profiling_output_file_.c_str());
+    }
+  }
 
   // Make sure that the Bt is not in a running state from a previous execution
   // note: if all the ControlNodes are implemented correctly, this is not needed.
@@ -18,11 +18,13 @@
 #include <memory>
 #include <string>
 #include <chrono>
+#include <future>
 
 #include "behaviortree_cpp/action_node.h"
 #include "nav2_util/node_utils.hpp"
 #include "rclcpp_action/rclcpp_action.hpp"
 #include "nav2_behavior_tree/bt_utils.hpp"
+#include "nav2_behavior_tree/action_client_registry.hpp"
 
 namespace nav2_behavior_tree
 {
@@ -50,10 +52,19 @@ public:
   : BT::ActionNodeBase(xml_tag_name, conf), action_name_(action_name)
   {
     node_ = config().blackboard->template get<rclcpp::Node::SharedPtr>("node");
-    callback_group_ = node_->create_callback_group(
-      rclcpp::CallbackGroupType::MutuallyExclusive,
-      false);
-    callback_group_executor_.add_callback_group(callback_group_, node_->get_node_base_interface());
+
+    // Borrow the client of the action from the navigator when it shares them,
+    // otherwise this node has its own
+    if (!config().blackboard->get("action_client_registry", client_registry_) ||
+      !client_registry_)
+    {
+      callback_group_ = node_->create_callback_group(
+        rclcpp::CallbackGroupType::MutuallyExclusive,
+        false);
+      callback_group_executor_ = std::make_shared<rclcpp::executors::SingleThreadedExecutor>();
+      callback_group_executor_->add_callback_group(
+        callback_group_, node_->get_node_base_interface());
+    }
 
     // Get the required items from the blackboard
     server_timeout_ =
@@ -86,6 +97,15 @@ public:
    */
   void createActionClient(const std::string & action_name)
   {
+    if (client_registry_) {
+      auto entry = client_registry_->template getClient<ActionT>(
+        action_name, wait_for_service_timeout_);
+      action_client_ = entry.client;
+      callback_group_executor_ = entry.executor;
+      async_spin_ = client_registry_->isSpinning();
+      return;
+    }
+
     // Now that we have the ROS node to use, create the action client for this BT action
     action_client_ = rclcpp_action::create_client<ActionT>(node_, action_name, callback_group_);
 
@@ -120,6 +140,7 @@ public:
 
   void halt() override
   {
+    future_cancel_ = {};
   }
 
   /**
@@ -145,9 +166,13 @@ public:
 
     rclcpp::Time goal_expiry_time = node_->now() - std::chrono::milliseconds(10);
 
+    if (async_spin_) {
+      return tick_async(goal_expiry_time);
+    }
+
     auto future_cancel = action_client_->async_cancel_goals_before(goal_expiry_time);
 
-    if (callback_group_executor_.spin_until_future_complete(future_cancel, server_timeout_) !=
+    if (callback_group_executor_->spin_until_future_complete(future_cancel, server_timeout_) !=
       rclcpp::FutureReturnCode::SUCCESS)
     {
       RCLCPP_ERROR(
@@ -159,13 +184,58 @@ public:
   }
 
 protected:
+  /**
+   * @brief Tick when the client is spun by a thread of the registry, sending the cancel
+   * request and then checking its response at each tick until the server timeout
+   * @param goal_expiry_time The goals sent before this time are cancelled
+   * @return BT::NodeStatus Status of tick execution
+   */
+  BT::NodeStatus tick_async(const rclcpp::Time & goal_expiry_time)
+  {
+    if (!future_cancel_.valid()) {
+      std::weak_ptr<ActionClientRegistry> registry = client_registry_;
+      future_cancel_ = action_client_->async_cancel_goals_before(
+        goal_expiry_time,
+        [registry](typename rclcpp_action::Client<ActionT>::CancelResponse::SharedPtr) {
+          if (auto shared_registry = registry.lock()) {
+            shared_registry->notifyEvent();
+          }
+        });
+      time_cancel_sent_ = node_->now();
+    }
+
+    if (future_cancel_.wait_for(std::chrono::seconds(0)) == std::future_status::ready) {
+      future_cancel_ = {};
+      return BT::NodeStatus::SUCCESS;
+    }
+
+    if (node_->now() - time_cancel_sent_ < rclcpp::Duration(server_timeout_)) {
+      return BT::NodeStatus::RUNNING;
+    }
+
+    future_cancel_ = {};
+    RCLCPP_ERROR(
+      node_->get_logger(),
+      "Failed to cancel the action server for %s", action_name_.c_str());
+    return BT::NodeStatus::FAILURE;
+  }
+
   std::string action_name_;
   typename std::shared_ptr<rclcpp_action::Client<ActionT>> action_client_;
 
   // The node that will be used for any ROS operations
   rclcpp::Node::SharedPtr node_;
   rclcpp::CallbackGroup::SharedPtr callback_group_;
-  rclcpp::executors::SingleThreadedExecutor callback_group_executor_;
+  std::shared_ptr<rclcpp::executors::SingleThreadedExecutor> callback_group_executor_;
+
+  // Clients shared by the nodes of the navigator, if any
+  ActionClientRegistry::Ptr client_registry_;
+
+  // The pending cancel request, when the client is spun by the thread of the registry
+  bool async_spin_{false};
+  std::shared_future<typename rclcpp_action::Client<ActionT>::CancelResponse::SharedPtr>
+  future_cancel_;
+  rclcpp::Time time_cancel_sent_;
 
   // The timeout value while waiting for response from a server when a
   // new action goal is canceled
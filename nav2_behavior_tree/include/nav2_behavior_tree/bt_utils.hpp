@@ -15,8 +15,11 @@
 #ifndef NAV2_BEHAVIOR_TREE__BT_UTILS_HPP_
 #define NAV2_BEHAVIOR_TREE__BT_UTILS_HPP_
 
+#include <memory>
+#include <mutex>
 #include <string>
 #include <set>
+#include <utility>
 
 #include "rclcpp/time.hpp"
 #include "rclcpp/node.hpp"
@@ -200,6 +203,113 @@ bool getInputPortOrBlackboard(
 #define getInputOrBlackboard(name, value) \
   getInputPortOrBlackboard(*this, *(this->config().blackboard), name, value);
 
+/**
+ * @brief A port of a BT node, or the blackboard entry of the same name if the port is not
+ * set, resolved once to its blackboard entry. Reading it does not look its key up and remap
+ * it again, nor copy the value unless asked to, unlike getInputOrBlackboard.
+ * Ports set to a literal value in the XML are read with getInput instead.
+ */
+template<typename T>
+class BlackboardEntryHandle
+{
+public:
+  /**
+   * @brief A constructor for BT::BlackboardEntryHandle, resolving the remapping of the port
+   * @param bt_node The node of the port
+   * @param blackboard the blackboard obtained with node->config().blackboard
+   * @param name The name of the port and of the blackboard entry used if it is not set
+   */
+  BlackboardEntryHandle(
+    const BT::TreeNode & bt_node,
+    const BT::Blackboard::Ptr & blackboard,
+    const std::string & name)
+  : bt_node_(bt_node), blackboard_(blackboard), name_(name), key_(name)
+  {
+    StringView raw_value;
+    try {
+      raw_value = bt_node.getRawPortValue(name);
+    } catch (const std::exception &) {
+      return;
+    }
+
+    StringView stripped;
+    if (TreeNode::isBlackboardPointer(raw_value, &stripped)) {
+      key_ = std::string(stripped);
+    } else if (!raw_value.empty()) {
+      literal_ = true;
+    }
+  }
+
+  /**
+   * @brief Copy the value of the port or entry
+   * @param value The value read
+   * @return bool true if the value is available
+   */
+  bool get(T & value)
+  {
+    if (literal_) {
+      return bt_node_.getInput<T>(name_, value);
+    }
+    if (!resolve()) {
+      return false;
+    }
+    std::unique_lock<std::mutex> lock(entry_->entry_mutex);
+    const T * current = entry_->value.template castPtr<T>();
+    if (!current) {
+      return false;
+    }
+    value = *current;
+    return true;
+  }
+
+  /**
+   * @brief Copy the value of the port or entry only if it differs from the given one
+   * @param value The last value read, updated if it changed
+   * @return bool true if the value is available and changed
+   */
+  bool updateIfChanged(T & value)
+  {
+    if (literal_) {
+      T current;
+      if (!bt_node_.getInput<T>(name_, current) || current == value) {
+        return false;
+      }
+      value = std::move(current);
+      return true;
+    }
+    if (!resolve()) {
+      return false;
+    }
+    std::unique_lock<std::mutex> lock(entry_->entry_mutex);
+    const T * current = entry_->value.template castPtr<T>();
+    if (!current || *current == value) {
+      return false;
+    }
+    value = *current;
+    return true;
+  }
+
+protected:
+  /**
+   * @brief Find the blackboard entry, until it exists
+   * @return bool true if the entry exists
+   */
+  bool resolve()
+  {
+    if (!entry_) {
+      entry_ = blackboard_->getEntry(key_);
+    }
+    return entry_ != nullptr;
+  }
+
+  const BT::TreeNode & bt_node_;
+  BT::Blackboard::Ptr blackboard_;
+  std::string name_;
+  std::string key_;
+  bool literal_{false};
+  std::shared_ptr<BT::Blackboard::Entry> entry_;
+};
+
 }  // namespace BT
 
 #endif  // NAV2_BEHAVIOR_TREE__BT_UTILS_HPP_
@@ -49,6 +49,12 @@ public:
    */
   void on_tick() override;
 
+  /**
+   * @brief Function to set the provisional path prefix streamed by the planner, if any
+   * @param feedback Latest feedback of the action, nullptr if none was received
+   */
+  void on_wait_for_result(std::shared_ptr<const Action::Feedback> feedback) override;
+
   /**
    * @brief Function to perform some user-defined operation upon successful completion of the action
    */
@@ -84,6 +90,8 @@ public:
           "planner_id", "",
           "Mapped name to the planner plugin type to use"),
         BT::OutputPort<nav_msgs::msg::Path>("path", "Path created by ComputePathToPose node"),
+        BT::OutputPort<nav_msgs::msg::Path>(
+          "partial_path", "Provisional path prefix streamed while the path is computed"),
         BT::OutputPort<ActionResult::_error_code_type>(
           "error_code_id", "The compute path to pose error code"),
       });
@@ -22,6 +22,7 @@
 
 #include "behaviortree_cpp/condition_node.h"
 #include "geometry_msgs/msg/pose_stamped.hpp"
+#include "nav2_behavior_tree/bt_utils.hpp"
 
 
 namespace nav2_behavior_tree
@@ -70,6 +71,9 @@ private:
   rclcpp::Node::SharedPtr node_;
   geometry_msgs::msg::PoseStamped goal_;
   std::vector<geometry_msgs::msg::PoseStamped> goals_;
+  // Resolved once, so that each tick only compares them to the last ones
+  BT::BlackboardEntryHandle<geometry_msgs::msg::PoseStamped> goal_handle_;
+  BT::BlackboardEntryHandle<std::vector<geometry_msgs::msg::PoseStamped>> goals_handle_;
 };
 
 }  // namespace nav2_behavior_tree
@@ -0,0 +1,139 @@
+// Copyright (c) 2024 Open Navigation LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef NAV2_BEHAVIOR_TREE__PLUGINS__CONDITION__IS_PATH_VALID_ON_COSTMAP_UPDATE_CONDITION_HPP_
+#define NAV2_BEHAVIOR_TREE__PLUGINS__CONDITION__IS_PATH_VALID_ON_COSTMAP_UPDATE_CONDITION_HPP_
+
+#include <string>
+#include <memory>
+
+#include "rclcpp/rclcpp.hpp"
+#include "behaviortree_cpp/condition_node.h"
+#include "nav_msgs/msg/path.hpp"
+#include "nav2_msgs/msg/costmap.hpp"
+#include "nav2_msgs/msg/costmap_update.hpp"
+#include "nav2_msgs/srv/is_path_valid.hpp"
+
+namespace nav2_behavior_tree
+{
+
+/**
+ * @brief A BT::ConditionNode that returns SUCCESS when the IsPathValid
+ * service returns true and FAILURE otherwise, like IsPathValid. The service is
+ * only called again when the path changes or the costmap is updated near it,
+ * the last result being returned otherwise
+ */
+class IsPathValidOnCostmapUpdateCondition : public BT::ConditionNode
+{
+public:
+  /**
+   * @brief A constructor for nav2_behavior_tree::IsPathValidOnCostmapUpdateCondition
+   * @param condition_name Name for the XML tag for this node
+   * @param conf BT node configuration
+   */
+  IsPathValidOnCostmapUpdateCondition(
+    const std::string & condition_name,
+    const BT::NodeConfiguration & conf);
+
+  IsPathValidOnCostmapUpdateCondition() = delete;
+
+  /**
+   * @brief The main override required by a BT action
+   * @return BT::NodeStatus Status of tick execution
+   */
+  BT::NodeStatus tick() override;
+
+  /**
+   * @brief Function to read parameters and initialize class variables
+   */
+  void initialize();
+
+  /**
+   * @brief Creates list of BT ports
+   * @return BT::PortsList Containing node-specific ports
+   */
+  static BT::PortsList providedPorts()
+  {
+    return {
+      BT::InputPort<nav_msgs::msg::Path>("path", "Path to Check"),
+      BT::InputPort<std::chrono::milliseconds>("server_timeout"),
+      BT::InputPort<std::string>(
+        "costmap_topic", std::string("global_costmap/costmap_raw"),
+        "Raw costmap checked by the service, whose updates are on its _updates topic"),
+      BT::InputPort<double>(
+        "margin", 0.5,
+        "Distance from the updated bounds of the costmap within which the path is checked again")
+    };
+  }
+
+protected:
+  /**
+   * @brief Callback function for the full costmap, which may have changed anywhere
+   * @param msg Shared pointer to nav2_msgs::msg::Costmap message
+   */
+  void costmapCallback(const nav2_msgs::msg::Costmap::ConstSharedPtr msg);
+
+  /**
+   * @brief Callback function for the costmap updates, expanding the updated bounds
+   * @param msg Shared pointer to nav2_msgs::msg::CostmapUpdate message
+   */
+  void costmapUpdateCallback(const nav2_msgs::msg::CostmapUpdate::ConstSharedPtr msg);
+
+  /**
+   * @brief Whether the costmap was updated near the path since it was last checked
+   * @param path The path to check
+   * @return bool true if the path should be checked again
+   */
+  bool isUpdatedNear(const nav_msgs::msg::Path & path) const;
+
+  /**
+   * @brief Call the IsPathValid service
+   * @param path The path to check
+   * @param is_valid Output result of the service
+   * @return bool true if the service answered in time
+   */
+  bool callService(const nav_msgs::msg::Path & path, bool & is_valid);
+
+  rclcpp::Node::SharedPtr node_;
+  rclcpp::Client<nav2_msgs::srv::IsPathValid>::SharedPtr client_;
+  rclcpp::CallbackGroup::SharedPtr callback_group_;
+  rclcpp::executors::SingleThreadedExecutor callback_group_executor_;
+  rclcpp::Subscription<nav2_msgs::msg::Costmap>::SharedPtr costmap_sub_;
+  rclcpp::Subscription<nav2_msgs::msg::CostmapUpdate>::SharedPtr costmap_update_sub_;
+  // The timeout value while waiting for a responce from the
+  // is path valid service
+  std::chrono::milliseconds server_timeout_;
+  double margin_;
+  bool initialized_;
+
+  // Geometry of the costmap, to convert the bounds of its updates
+  bool has_costmap_;
+  double origin_x_;
+  double origin_y_;
+  double resolution_;
+
+  // Costmap changes since the path was last checked
+  bool costmap_replaced_;
+  bool has_updated_bounds_;
+  double min_x_, min_y_, max_x_, max_y_;
+
+  // Last path checked by the service and its result
+  bool has_result_;
+  bool is_valid_;
+  nav_msgs::msg::Path last_path_;
+};
+
+}  // namespace nav2_behavior_tree
+
+#endif  // NAV2_BEHAVIOR_TREE__PLUGINS__CONDITION__IS_PATH_VALID_ON_COSTMAP_UPDATE_CONDITION_HPP_
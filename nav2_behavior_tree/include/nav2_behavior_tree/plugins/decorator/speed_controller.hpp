@@ -25,6 +25,8 @@
 #include "nav2_util/odometry_utils.hpp"
 
 #include "behaviortree_cpp/decorator_node.h"
+#include "geometry_msgs/msg/pose_stamped.hpp"
+#include "nav2_behavior_tree/bt_utils.hpp"
 
 namespace nav2_behavior_tree
 {
@@ -120,6 +122,9 @@ private:
   // current goal
   geometry_msgs::msg::PoseStamped goal_;
   std::vector<geometry_msgs::msg::PoseStamped> goals_;
+  // Resolved once, so that each tick only compares them to the last ones
+  BT::BlackboardEntryHandle<geometry_msgs::msg::PoseStamped> goal_handle_;
+  BT::BlackboardEntryHandle<std::vector<geometry_msgs::msg::PoseStamped>> goals_handle_;
 };
 
 }  // namespace nav2_behavior_tree
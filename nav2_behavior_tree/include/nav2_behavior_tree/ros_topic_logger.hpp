@@ -15,12 +15,17 @@
 #ifndef NAV2_BEHAVIOR_TREE__ROS_TOPIC_LOGGER_HPP_
 #define NAV2_BEHAVIOR_TREE__ROS_TOPIC_LOGGER_HPP_
 
+#include <algorithm>
+#include <atomic>
+#include <chrono>
 #include <vector>
 #include <memory>
 #include <utility>
 
 #include "behaviortree_cpp/loggers/abstract_logger.h"
 #include "rclcpp/rclcpp.hpp"
+#include "nav2_msgs/msg/behavior_tree_compact_log.hpp"
+#include "nav2_msgs/msg/behavior_tree_description.hpp"
 #include "nav2_msgs/msg/behavior_tree_log.hpp"
 #include "nav2_msgs/msg/behavior_tree_status_change.h"
 #include "tf2_ros/buffer_interface.h"
@@ -30,6 +35,10 @@ namespace nav2_behavior_tree
 
 /**
  * @brief A class to publish BT logs on BT status change
+ *
+ * In compact mode, the status changes are published on behavior_tree_compact_log with the
+ * uids of the nodes only, which behavior_tree_description maps to their names. The changes
+ * are kept in a buffer allocated once, published when full or at the flush period.
  */
 class RosTopicLogger : public BT::StatusChangeLogger
 {
@@ -38,16 +47,63 @@ public:
    * @brief A constructor for nav2_behavior_tree::RosTopicLogger
    * @param ros_node Weak pointer to parent rclcpp::Node
    * @param tree BT to monitor
+   * @param compact Whether to publish the compact logs rather than the full ones
+   * @param flush_period Shortest period between two logs, or 0 to publish at every flush
+   * @param buffer_size Number of status changes the compact log holds before being published
    */
-  RosTopicLogger(const rclcpp::Node::WeakPtr & ros_node, const BT::Tree & tree)
-  : StatusChangeLogger(tree.rootNode())
+  RosTopicLogger(
+    const rclcpp::Node::WeakPtr & ros_node, const BT::Tree & tree,
+    bool compact = false,
+    std::chrono::milliseconds flush_period = std::chrono::milliseconds(0),
+    size_t buffer_size = 1000)
+  : StatusChangeLogger(tree.rootNode()),
+    compact_(compact),
+    flush_period_(flush_period),
+    buffer_size_(std::max<size_t>(buffer_size, 1))
   {
     auto node = ros_node.lock();
     clock_ = node->get_clock();
     logger_ = node->get_logger();
-    log_pub_ = node->create_publisher<nav2_msgs::msg::BehaviorTreeLog>(
-      "behavior_tree_log",
+    if (!compact_) {
+      log_pub_ = node->create_publisher<nav2_msgs::msg::BehaviorTreeLog>(
+        "behavior_tree_log",
+        rclcpp::QoS(10));
+      return;
+    }
+
+    static std::atomic<uint32_t> tree_count{0};
+    compact_log_.tree_id = tree_count++;
+    compact_log_.stamps.reserve(buffer_size_);
+    compact_log_.uids.reserve(buffer_size_);
+    compact_log_.previous_status.reserve(buffer_size_);
+    compact_log_.current_status.reserve(buffer_size_);
+    compact_log_pub_ = node->create_publisher<nav2_msgs::msg::BehaviorTreeCompactLog>(
+      "behavior_tree_compact_log",
       rclcpp::QoS(10));
+
+    description_.tree_id = compact_log_.tree_id;
+    BT::applyRecursiveVisitor(
+      tree.rootNode(), [this](const BT::TreeNode * tree_node) {
+        description_.uids.push_back(tree_node->UID());
+        description_.node_names.push_back(tree_node->name());
+        description_.registration_names.push_back(tree_node->registrationName());
+      });
+    description_pub_ = node->create_publisher<nav2_msgs::msg::BehaviorTreeDescription>(
+      "behavior_tree_description",
+      rclcpp::QoS(1).transient_local());
+    publishDescription();
+  }
+
+  /**
+   * @brief Publish the description of the tree, for the compact logs that follow. To be
+   * called when the tree becomes the one executed.
+   */
+  void publishDescription()
+  {
+    if (description_pub_) {
+      description_.timestamp = clock_->now();
+      description_pub_->publish(description_);
+    }
   }
 
   /**
@@ -63,6 +119,18 @@ public:
     BT::NodeStatus prev_status,
     BT::NodeStatus status) override
   {
+    if (compact_) {
+      if (compact_log_.uids.size() >= buffer_size_) {
+        publish();
+      }
+      compact_log_.stamps.push_back(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(timestamp).count());
+      compact_log_.uids.push_back(node.UID());
+      compact_log_.previous_status.push_back(static_cast<uint8_t>(prev_status));
+      compact_log_.current_status.push_back(static_cast<uint8_t>(status));
+      return;
+    }
+
     nav2_msgs::msg::BehaviorTreeStatusChange event;
 
     // BT timestamps are a duration since the epoch. Need to convert to a time_point
@@ -83,10 +151,37 @@ public:
   }
 
   /**
-   * @brief Clear log buffer if any
+   * @brief Clear log buffer if any, unless the last log is more recent than the flush period
    */
   void flush() override
   {
+    if (flush_period_.count() > 0 &&
+      std::chrono::steady_clock::now() - last_publish_time_ < flush_period_)
+    {
+      return;
+    }
+    publish();
+  }
+
+  /**
+   * @brief Publish the log buffer if any, regardless of the flush period
+   */
+  void publish()
+  {
+    last_publish_time_ = std::chrono::steady_clock::now();
+    if (compact_) {
+      if (!compact_log_.uids.empty()) {
+        // Published by reference, so that the buffer keeps its storage once cleared
+        compact_log_.timestamp = clock_->now();
+        compact_log_pub_->publish(compact_log_);
+        compact_log_.stamps.clear();
+        compact_log_.uids.clear();
+        compact_log_.previous_status.clear();
+        compact_log_.current_status.clear();
+      }
+      return;
+    }
+
     if (!event_log_.empty()) {
       auto log_msg = std::make_unique<nav2_msgs::msg::BehaviorTreeLog>();
       log_msg->timestamp = clock_->now();
@@ -101,6 +196,15 @@ protected:
   rclcpp::Logger logger_{rclcpp::get_logger("bt_navigator")};
   rclcpp::Publisher<nav2_msgs::msg::BehaviorTreeLog>::SharedPtr log_pub_;
   std::vector<nav2_msgs::msg::BehaviorTreeStatusChange> event_log_;
+
+  bool compact_;
+  std::chrono::milliseconds flush_period_;
+  size_t buffer_size_;
+  std::chrono::steady_clock::time_point last_publish_time_;
+  rclcpp::Publisher<nav2_msgs::msg::BehaviorTreeCompactLog>::SharedPtr compact_log_pub_;
+  rclcpp::Publisher<nav2_msgs::msg::BehaviorTreeDescription>::SharedPtr description_pub_;
+  nav2_msgs::msg::BehaviorTreeCompactLog compact_log_;
+  nav2_msgs::msg::BehaviorTreeDescription description_;
 };
 
 }   // namespace nav2_behavior_tree
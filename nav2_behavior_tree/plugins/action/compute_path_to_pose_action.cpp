@@ -37,6 +37,14 @@ void ComputePathToPoseAction::on_tick()
   }
 }
 
+void ComputePathToPoseAction::on_wait_for_result(
+  std::shared_ptr<const Action::Feedback> feedback)
+{
+  if (feedback && !feedback->partial_path.poses.empty()) {
+    setOutput("partial_path", feedback->partial_path);
+  }
+}
+
 BT::NodeStatus ComputePathToPoseAction::on_success()
 {
   setOutput("path", result_.result->path);
@@ -25,7 +25,9 @@ GloballyUpdatedGoalCondition::GloballyUpdatedGoalCondition(
   const std::string & condition_name,
   const BT::NodeConfiguration & conf)
 : BT::ConditionNode(condition_name, conf),
-  first_time(true)
+  first_time(true),
+  goal_handle_(*this, config().blackboard, "goal"),
+  goals_handle_(*this, config().blackboard, "goals")
 {
   node_ = config().blackboard->get<rclcpp::Node::SharedPtr>("node");
 }
@@ -34,19 +36,14 @@ BT::NodeStatus GloballyUpdatedGoalCondition::tick()
 {
   if (first_time) {
     first_time = false;
-    BT::getInputOrBlackboard("goals", goals_);
-    BT::getInputOrBlackboard("goal", goal_);
+    goals_handle_.get(goals_);
+    goal_handle_.get(goal_);
     return BT::NodeStatus::SUCCESS;
   }
 
-  std::vector<geometry_msgs::msg::PoseStamped> current_goals;
-  BT::getInputOrBlackboard("goals", current_goals);
-  geometry_msgs::msg::PoseStamped current_goal;
-  BT::getInputOrBlackboard("goal", current_goal);
-
-  if (goal_ != current_goal || goals_ != current_goals) {
-    goal_ = current_goal;
-    goals_ = current_goals;
+  const bool goal_updated = goal_handle_.updateIfChanged(goal_);
+  const bool goals_updated = goals_handle_.updateIfChanged(goals_);
+  if (goal_updated || goals_updated) {
     return BT::NodeStatus::SUCCESS;
   }
 
@@ -23,25 +23,22 @@ namespace nav2_behavior_tree
 GoalUpdatedCondition::GoalUpdatedCondition(
   const std::string & condition_name,
   const BT::NodeConfiguration & conf)
-: BT::ConditionNode(condition_name, conf)
+: BT::ConditionNode(condition_name, conf),
+  goal_handle_(*this, config().blackboard, "goal"),
+  goals_handle_(*this, config().blackboard, "goals")
 {}
 
 BT::NodeStatus GoalUpdatedCondition::tick()
 {
   if (!BT::isStatusActive(status())) {
-    BT::getInputOrBlackboard("goals", goals_);
-    BT::getInputOrBlackboard("goal", goal_);
+    goals_handle_.get(goals_);
+    goal_handle_.get(goal_);
     return BT::NodeStatus::FAILURE;
   }
 
-  std::vector<geometry_msgs::msg::PoseStamped> current_goals;
-  geometry_msgs::msg::PoseStamped current_goal;
-  BT::getInputOrBlackboard("goals", current_goals);
-  BT::getInputOrBlackboard("goal", current_goal);
-
-  if (goal_ != current_goal || goals_ != current_goals) {
-    goal_ = current_goal;
-    goals_ = current_goals;
+  const bool goal_updated = goal_handle_.updateIfChanged(goal_);
+  const bool goals_updated = goals_handle_.updateIfChanged(goals_);
+  if (goal_updated || goals_updated) {
     return BT::NodeStatus::SUCCESS;
   }
 
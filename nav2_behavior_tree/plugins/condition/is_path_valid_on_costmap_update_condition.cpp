@@ -0,0 +1,185 @@
+// Copyright (c) 2024 Open Navigation LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "nav2_behavior_tree/plugins/condition/is_path_valid_on_costmap_update_condition.hpp"
+#include <algorithm>
+#include <chrono>
+#include <memory>
+#include <string>
+#include <utility>
+
+namespace nav2_behavior_tree
+{
+
+IsPathValidOnCostmapUpdateCondition::IsPathValidOnCostmapUpdateCondition(
+  const std::string & condition_name,
+  const BT::NodeConfiguration & conf)
+: BT::ConditionNode(condition_name, conf),
+  margin_(0.5),
+  initialized_(false),
+  has_costmap_(false),
+  origin_x_(0.0),
+  origin_y_(0.0),
+  resolution_(0.0),
+  costmap_replaced_(false),
+  has_updated_bounds_(false),
+  min_x_(0.0), min_y_(0.0), max_x_(0.0), max_y_(0.0),
+  has_result_(false),
+  is_valid_(false)
+{
+  node_ = config().blackboard->get<rclcpp::Node::SharedPtr>("node");
+  client_ = node_->create_client<nav2_msgs::srv::IsPathValid>("is_path_valid");
+
+  server_timeout_ = config().blackboard->template get<std::chrono::milliseconds>("server_timeout");
+}
+
+void IsPathValidOnCostmapUpdateCondition::initialize()
+{
+  getInput<std::chrono::milliseconds>("server_timeout", server_timeout_);
+  getInput("margin", margin_);
+  std::string costmap_topic;
+  getInput("costmap_topic", costmap_topic);
+
+  callback_group_ = node_->create_callback_group(
+    rclcpp::CallbackGroupType::MutuallyExclusive,
+    false);
+  callback_group_executor_.add_callback_group(callback_group_, node_->get_node_base_interface());
+
+  rclcpp::SubscriptionOptions sub_option;
+  sub_option.callback_group = callback_group_;
+  auto qos = rclcpp::QoS(rclcpp::KeepLast(1)).transient_local().reliable();
+  costmap_sub_ = node_->create_subscription<nav2_msgs::msg::Costmap>(
+    costmap_topic, qos,
+    std::bind(
+      &IsPathValidOnCostmapUpdateCondition::costmapCallback, this, std::placeholders::_1),
+    sub_option);
+  // Keeps the updates received between two ticks
+  costmap_update_sub_ = node_->create_subscription<nav2_msgs::msg::CostmapUpdate>(
+    costmap_topic + "_updates", rclcpp::QoS(rclcpp::KeepLast(10)).transient_local().reliable(),
+    std::bind(
+      &IsPathValidOnCostmapUpdateCondition::costmapUpdateCallback, this, std::placeholders::_1),
+    sub_option);
+  initialized_ = true;
+}
+
+BT::NodeStatus IsPathValidOnCostmapUpdateCondition::tick()
+{
+  if (!initialized_) {
+    initialize();
+  }
+
+  callback_group_executor_.spin_some();
+
+  nav_msgs::msg::Path path;
+  getInput("path", path);
+
+  if (!has_result_ || path != last_path_ || isUpdatedNear(path)) {
+    // The result covers the costmap changes received so far
+    costmap_replaced_ = false;
+    has_updated_bounds_ = false;
+    has_result_ = callService(path, is_valid_);
+    if (!has_result_) {
+      return BT::NodeStatus::FAILURE;
+    }
+    last_path_ = std::move(path);
+  } else {
+    // Updates away from the path do not change its validity
+    has_updated_bounds_ = false;
+  }
+
+  return is_valid_ ? BT::NodeStatus::SUCCESS : BT::NodeStatus::FAILURE;
+}
+
+bool IsPathValidOnCostmapUpdateCondition::isUpdatedNear(const nav_msgs::msg::Path & path) const
+{
+  if (costmap_replaced_) {
+    return true;
+  }
+  if (!has_updated_bounds_) {
+    return false;
+  }
+
+  for (const auto & pose : path.poses) {
+    const auto & position = pose.pose.position;
+    if (position.x >= min_x_ - margin_ && position.x <= max_x_ + margin_ &&
+      position.y >= min_y_ - margin_ && position.y <= max_y_ + margin_)
+    {
+      return true;
+    }
+  }
+  return false;
+}
+
+bool IsPathValidOnCostmapUpdateCondition::callService(
+  const nav_msgs::msg::Path & path, bool & is_valid)
+{
+  auto request = std::make_shared<nav2_msgs::srv::IsPathValid::Request>();
+
+  request->path = path;
+  auto result = client_->async_send_request(request);
+
+  if (rclcpp::spin_until_future_complete(node_, result, server_timeout_) ==
+    rclcpp::FutureReturnCode::SUCCESS)
+  {
+    is_valid = result.get()->is_valid;
+    return true;
+  }
+  return false;
+}
+
+void IsPathValidOnCostmapUpdateCondition::costmapCallback(
+  const nav2_msgs::msg::Costmap::ConstSharedPtr msg)
+{
+  has_costmap_ = true;
+  origin_x_ = msg->metadata.origin.position.x;
+  origin_y_ = msg->metadata.origin.position.y;
+  resolution_ = msg->metadata.resolution;
+  costmap_replaced_ = true;
+}
+
+void IsPathValidOnCostmapUpdateCondition::costmapUpdateCallback(
+  const nav2_msgs::msg::CostmapUpdate::ConstSharedPtr msg)
+{
+  // Without the geometry of the costmap, the update could be anywhere
+  if (!has_costmap_) {
+    costmap_replaced_ = true;
+    return;
+  }
+
+  const double min_x = origin_x_ + msg->x * resolution_;
+  const double min_y = origin_y_ + msg->y * resolution_;
+  const double max_x = origin_x_ + (msg->x + msg->size_x) * resolution_;
+  const double max_y = origin_y_ + (msg->y + msg->size_y) * resolution_;
+  if (!has_updated_bounds_) {
+    min_x_ = min_x;
+    min_y_ = min_y;
+    max_x_ = max_x;
+    max_y_ = max_y;
+    has_updated_bounds_ = true;
+    return;
+  }
+  min_x_ = std::min(min_x_, min_x);
+  min_y_ = std::min(min_y_, min_y);
+  max_x_ = std::max(max_x_, max_x);
+  max_y_ = std::max(max_y_, max_y);
+}
+
+}  // namespace nav2_behavior_tree
+
+#include "behaviortree_cpp/bt_factory.h"
+BT_REGISTER_NODES(factory)
+{
+  factory.registerNodeType<nav2_behavior_tree::IsPathValidOnCostmapUpdateCondition>(
+    "IsPathValidOnCostmapUpdate");
+}
@@ -27,7 +27,9 @@ namespace nav2_behavior_tree
 GoalUpdatedController::GoalUpdatedController(
   const std::string & name,
   const BT::NodeConfiguration & conf)
-: BT::DecoratorNode(name, conf)
+: BT::DecoratorNode(name, conf),
+  goal_handle_(*this, config().blackboard, "goal"),
+  goals_handle_(*this, config().blackboard, "goals")
 {
 }
 
@@ -37,22 +39,17 @@ BT::NodeStatus GoalUpdatedController::tick()
     // Reset since we're starting a new iteration of
     // the goal updated controller (moving from IDLE to RUNNING)
 
-    BT::getInputOrBlackboard("goals", goals_);
-    BT::getInputOrBlackboard("goal", goal_);
+    goals_handle_.get(goals_);
+    goal_handle_.get(goal_);
 
     goal_was_updated_ = true;
   }
 
   setStatus(BT::NodeStatus::RUNNING);
 
-  std::vector<geometry_msgs::msg::PoseStamped> current_goals;
-  BT::getInputOrBlackboard("goals", current_goals);
-  geometry_msgs::msg::PoseStamped current_goal;
-  BT::getInputOrBlackboard("goal", current_goal);
-
-  if (goal_ != current_goal || goals_ != current_goals) {
-    goal_ = current_goal;
-    goals_ = current_goals;
+  const bool goal_updated = goal_handle_.updateIfChanged(goal_);
+  const bool goals_updated = goals_handle_.updateIfChanged(goals_);
+  if (goal_updated || goals_updated) {
     goal_was_updated_ = true;
   }
 
@@ -33,7 +33,9 @@ SpeedController::SpeedController(
   min_rate_(0.1),
   max_rate_(1.0),
   min_speed_(0.0),
-  max_speed_(0.5)
+  max_speed_(0.5),
+  goal_handle_(*this, config().blackboard, "goal"),
+  goals_handle_(*this, config().blackboard, "goals")
 {
   node_ = config().blackboard->get<rclcpp::Node::SharedPtr>("node");
 
@@ -62,25 +64,20 @@ inline BT::NodeStatus SpeedController::tick()
   if (!BT::isStatusActive(status())) {
     // Reset since we're starting a new iteration of
     // the speed controller (moving from IDLE to RUNNING)
-    BT::getInputOrBlackboard("goals", goals_);
-    BT::getInputOrBlackboard("goal", goal_);
+    goals_handle_.get(goals_);
+    goal_handle_.get(goal_);
     period_ = 1.0 / max_rate_;
     start_ = node_->now();
     first_tick_ = true;
   }
 
-  std::vector<geometry_msgs::msg::PoseStamped> current_goals;
-  BT::getInputOrBlackboard("goals", current_goals);
-  geometry_msgs::msg::PoseStamped current_goal;
-  BT::getInputOrBlackboard("goal", current_goal);
-
-  if (goal_ != current_goal || goals_ != current_goals) {
+  const bool goal_updated = goal_handle_.updateIfChanged(goal_);
+  const bool goals_updated = goals_handle_.updateIfChanged(goals_);
+  if (goal_updated || goals_updated) {
     // Reset state and set period to max since we have a new goal
     period_ = 1.0 / max_rate_;
     start_ = node_->now();
     first_tick_ = true;
-    goal_ = current_goal;
-    goals_ = current_goals;
   }
 
   setStatus(BT::NodeStatus::RUNNING);
@@ -15,27 +15,124 @@
 
 #include "nav2_behavior_tree/behavior_tree_engine.hpp"
 
+#include <map>
 #include <memory>
+#include <mutex>
 #include <string>
+#include <variant>
 #include <vector>
 
 #include "rclcpp/rclcpp.hpp"
 #include "behaviortree_cpp/utils/shared_library.h"
+#include "nav2_util/tracing.hpp"
 
 namespace nav2_behavior_tree
 {
 
-BehaviorTreeEngine::BehaviorTreeEngine(
-  const std::vector<std::string> & plugin_libraries, rclcpp::Node::SharedPtr node)
+namespace
+{
+
+using EventSource = std::variant<
+  rclcpp::SubscriptionBase::SharedPtr, rclcpp::TimerBase::SharedPtr,
+  rclcpp::ClientBase::SharedPtr, rclcpp::ServiceBase::SharedPtr,
+  rclcpp::Waitable::SharedPtr>;
+
+const void * getKey(const EventSource & source)
+{
+  return std::visit([](const auto & entity) -> const void * {return entity.get();}, source);
+}
+
+/**
+ * @class EventWaitSet
+ * @brief Wait set of entities spun by the BT nodes, emptied when destroyed since an
+ * entity can only be in a single wait set at a time
+ */
+class EventWaitSet
+{
+public:
+  explicit EventWaitSet(
+    const std::vector<EventSource> & sources,
+    const rclcpp::GuardCondition::SharedPtr & guard_condition = nullptr)
+  : sources_(sources), guard_condition_(guard_condition)
+  {
+    for (const auto & source : sources_) {
+      std::visit([this](const auto & entity) {add(entity);}, source);
+    }
+    if (guard_condition_) {
+      wait_set_.add_guard_condition(guard_condition_);
+    }
+  }
+
+  ~EventWaitSet()
+  {
+    for (const auto & source : sources_) {
+      std::visit([this](const auto & entity) {remove(entity);}, source);
+    }
+    if (guard_condition_) {
+      wait_set_.remove_guard_condition(guard_condition_);
+    }
+  }
+
+  bool wait(std::chrono::nanoseconds timeout)
+  {
+    if (sources_.empty() && !guard_condition_) {
+      return false;
+    }
+    return wait_set_.wait(timeout).kind() == rclcpp::WaitResultKind::Ready;
+  }
+
+protected:
+  void add(const rclcpp::SubscriptionBase::SharedPtr & entity) {wait_set_.add_subscription(entity);}
+  void add(const rclcpp::TimerBase::SharedPtr & entity) {wait_set_.add_timer(entity);}
+  void add(const rclcpp::ClientBase::SharedPtr & entity) {wait_set_.add_client(entity);}
+  void add(const rclcpp::ServiceBase::SharedPtr & entity) {wait_set_.add_service(entity);}
+  void add(const rclcpp::Waitable::SharedPtr & entity) {wait_set_.add_waitable(entity);}
+  void remove(const rclcpp::SubscriptionBase::SharedPtr & e) {wait_set_.remove_subscription(e);}
+  void remove(const rclcpp::TimerBase::SharedPtr & entity) {wait_set_.remove_timer(entity);}
+  void remove(const rclcpp::ClientBase::SharedPtr & entity) {wait_set_.remove_client(entity);}
+  void remove(const rclcpp::ServiceBase::SharedPtr & entity) {wait_set_.remove_service(entity);}
+  void remove(const rclcpp::Waitable::SharedPtr & entity) {wait_set_.remove_waitable(entity);}
+
+  const std::vector<EventSource> & sources_;
+  rclcpp::GuardCondition::SharedPtr guard_condition_;
+  rclcpp::WaitSet wait_set_;
+};
+
+}  // namespace
+
+std::shared_ptr<BT::BehaviorTreeFactory>
+BehaviorTreeEngine::getSharedFactory(const std::vector<std::string> & plugin_libraries)
 {
+  static std::mutex mutex;
+  static std::map<std::vector<std::string>, std::weak_ptr<BT::BehaviorTreeFactory>> factories;
+
+  std::lock_guard<std::mutex> lock(mutex);
+  auto & shared = factories[plugin_libraries];
+  auto factory = shared.lock();
+  if (factory) {
+    return factory;
+  }
+
+  factory = std::make_shared<BT::BehaviorTreeFactory>();
   BT::SharedLibrary loader;
   for (const auto & p : plugin_libraries) {
-    factory_.registerFromPlugin(loader.getOSName(p));
+    factory->registerFromPlugin(loader.getOSName(p));
   }
+  shared = factory;
+  return factory;
+}
+
+BehaviorTreeEngine::BehaviorTreeEngine(
+  const std::vector<std::string> & plugin_libraries, rclcpp::Node::SharedPtr node)
+: factory_(getSharedFactory(plugin_libraries))
+{
 
   // clock for throttled debug log
   clock_ = node->get_clock();
 
+  node_base_ = node->get_node_base_interface();
+  wake_up_ = std::make_shared<rclcpp::GuardCondition>(node_base_->get_context());
+
   // FIXME: the next two line are needed for back-compatibility with BT.CPP 3.8.x
   // Note that the can be removed, once we migrate from BT.CPP 4.5.x to 4.6+
   BT::ReactiveSequence::EnableException(false);
@@ -47,7 +144,8 @@ BehaviorTreeEngine::run(
   BT::Tree * tree,
   std::function<void()> onLoop,
   std::function<bool()> cancelRequested,
-  std::chrono::milliseconds loopTimeout)
+  std::chrono::milliseconds loopTimeout,
+  std::chrono::milliseconds maxIdleDuration)
 {
   rclcpp::WallRate loopRate(loopTimeout);
   BT::NodeStatus result = BT::NodeStatus::RUNNING;
@@ -60,10 +158,20 @@ BehaviorTreeEngine::run(
         return BtStatus::CANCELED;
       }
 
-      result = tree->tickOnce();
+      {
+        NAV2_TRACE_SCOPE("bt.tick");
+        result = tree->tickOnce();
+      }
 
       onLoop();
 
+      if (maxIdleDuration.count() > 0) {
+        if (result == BT::NodeStatus::RUNNING) {
+          waitForEvent(maxIdleDuration);
+        }
+        continue;
+      }
+
       if (!loopRate.sleep()) {
         RCLCPP_DEBUG_THROTTLE(
           rclcpp::get_logger("BehaviorTreeEngine"),
@@ -82,12 +190,64 @@ BehaviorTreeEngine::run(
   return (result == BT::NodeStatus::SUCCESS) ? BtStatus::SUCCEEDED : BtStatus::FAILED;
 }
 
+void
+BehaviorTreeEngine::wakeUp()
+{
+  wake_up_->trigger();
+}
+
+void
+BehaviorTreeEngine::waitForEvent(std::chrono::milliseconds timeout)
+{
+  // The BT nodes spin the callback groups not added to the executor of the node in their
+  // ticks, so that any of their callbacks being ready calls for a tick
+  std::vector<EventSource> waited, stale;
+  auto collect = [&](EventSource source) {
+      (stale_events_.count(getKey(source)) ? stale : waited).push_back(std::move(source));
+    };
+  node_base_->for_each_callback_group(
+    [&](rclcpp::CallbackGroup::SharedPtr group) {
+      if (!group || group->automatically_add_to_executor_with_node()) {
+        return;
+      }
+      group->collect_all_ptrs(
+        [&](const rclcpp::SubscriptionBase::SharedPtr & entity) {collect(entity);},
+        [&](const rclcpp::ServiceBase::SharedPtr & entity) {collect(entity);},
+        [&](const rclcpp::ClientBase::SharedPtr & entity) {collect(entity);},
+        [&](const rclcpp::TimerBase::SharedPtr & entity) {collect(entity);},
+        [&](const rclcpp::Waitable::SharedPtr & entity) {collect(entity);});
+    });
+
+  // Stale entities are waited for again once all of them were consumed
+  if (!stale.empty() && !EventWaitSet(stale).wait(std::chrono::nanoseconds(0))) {
+    stale_events_.clear();
+    waited.insert(waited.end(), stale.begin(), stale.end());
+  }
+
+  // Entities left ready by the last tick would end every wait at once
+  if (EventWaitSet(waited).wait(std::chrono::nanoseconds(0))) {
+    std::vector<EventSource> pending;
+    for (auto it = waited.begin(); it != waited.end(); ) {
+      pending.assign(1, *it);
+      if (EventWaitSet(pending).wait(std::chrono::nanoseconds(0))) {
+        stale_events_.insert(getKey(*it));
+        it = waited.erase(it);
+      } else {
+        ++it;
+      }
+    }
+  }
+
+  EventWaitSet wait_set(waited, wake_up_);
+  wait_set.wait(timeout);
+}
+
 BT::Tree
 BehaviorTreeEngine::createTreeFromText(
   const std::string & xml_string,
   BT::Blackboard::Ptr blackboard)
 {
-  return factory_.createTreeFromText(xml_string, blackboard);
+  return factory_->createTreeFromText(xml_string, blackboard);
 }
 
 BT::Tree
@@ -95,7 +255,7 @@ BehaviorTreeEngine::createTreeFromFile(
   const std::string & file_path,
   BT::Blackboard::Ptr blackboard)
 {
-  return factory_.createTreeFromFile(file_path, blackboard);
+  return factory_->createTreeFromFile(file_path, blackboard);
 }
 
 // In order to re-run a Behavior Tree, we must be able to reset all nodes to the initial state
@@ -0,0 +1,198 @@
+// Copyright (c) 2024 Open Navigation LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "nav2_behavior_tree/behavior_tree_profiler.hpp"
+
+#include <algorithm>
+#include <fstream>
+#include <functional>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace nav2_behavior_tree
+{
+
+BehaviorTreeProfiler::BehaviorTreeProfiler(
+  const rclcpp::Node::WeakPtr & ros_node, BT::Tree & tree,
+  std::chrono::milliseconds publish_period)
+: publish_period_(publish_period),
+  last_publish_time_(std::chrono::steady_clock::now())
+{
+  auto node = ros_node.lock();
+  clock_ = node->get_clock();
+  profile_pub_ = node->create_publisher<nav2_msgs::msg::BehaviorTreeProfile>(
+    "behavior_tree_profile",
+    rclcpp::QoS(10));
+
+  // Number the nodes in depth-first order, each with the names of its ancestors
+  std::function<void(BT::TreeNode *, const std::string &)> visit =
+    [&](BT::TreeNode * tree_node, const std::string & parent_path) {
+      if (!tree_node) {
+        return;
+      }
+      std::string name = tree_node->name().empty() ?
+        tree_node->registrationName() : tree_node->name();
+      std::replace(name.begin(), name.end(), ';', '_');
+
+      NodeProfile profile;
+      profile.node = tree_node;
+      profile.path = parent_path.empty() ? name : parent_path + ";" + name;
+      nodes_.push_back(tree_node);
+      profiles_.push_back(profile);
+
+      if (auto control = dynamic_cast<BT::ControlNode *>(tree_node)) {
+        for (auto child : control->children()) {
+          visit(child, profile.path);
+        }
+      } else if (auto decorator = dynamic_cast<BT::DecoratorNode *>(tree_node)) {
+        visit(decorator->child(), profile.path);
+      }
+    };
+  visit(tree.rootNode(), "");
+  stack_.reserve(nodes_.size());
+
+  for (size_t index = 0; index < nodes_.size(); ++index) {
+    nodes_[index]->setPreTickFunction(
+      [this, index](BT::TreeNode &) {
+        onPreTick(index);
+        return BT::NodeStatus::IDLE;
+      });
+    nodes_[index]->setPostTickFunction(
+      [this, index](BT::TreeNode &, BT::NodeStatus) {
+        onPostTick(index);
+        return BT::NodeStatus::IDLE;
+      });
+  }
+}
+
+BehaviorTreeProfiler::~BehaviorTreeProfiler()
+{
+  for (auto tree_node : nodes_) {
+    tree_node->setPreTickFunction({});
+    tree_node->setPostTickFunction({});
+  }
+}
+
+void BehaviorTreeProfiler::onPreTick(size_t index)
+{
+  // A tick of the root starts over, should a previous one have been interrupted by an exception
+  if (index == 0) {
+    stack_.clear();
+  }
+  stack_.push_back({index, std::chrono::steady_clock::now(), std::chrono::nanoseconds(0)});
+}
+
+void BehaviorTreeProfiler::onPostTick(size_t index)
+{
+  const auto now = std::chrono::steady_clock::now();
+
+  // Frames above this node are the ticks of descendants that never ended
+  while (!stack_.empty() && stack_.back().index != index) {
+    stack_.pop_back();
+  }
+  if (stack_.empty()) {
+    return;
+  }
+
+  const Frame frame = stack_.back();
+  stack_.pop_back();
+  const auto duration = std::chrono::duration_cast<std::chrono::nanoseconds>(now - frame.start);
+  if (!stack_.empty()) {
+    stack_.back().children_duration += duration;
+  }
+
+  NodeProfile & profile = profiles_[index];
+  profile.tick_count++;
+  profile.total_duration += duration;
+  profile.self_duration += std::max(
+    duration - frame.children_duration, std::chrono::nanoseconds(0));
+  profile.max_duration = std::max(profile.max_duration, duration);
+  profile.histogram[histogramBucket(duration)]++;
+}
+
+size_t BehaviorTreeProfiler::histogramBucket(std::chrono::nanoseconds duration)
+{
+  auto microseconds = std::chrono::duration_cast<std::chrono::microseconds>(duration).count();
+  size_t bucket = 0;
+  while (microseconds > 0 && bucket < kHistogramSize - 1) {
+    microseconds >>= 1;
+    bucket++;
+  }
+  return bucket;
+}
+
+void BehaviorTreeProfiler::publishIfDue()
+{
+  if (std::chrono::steady_clock::now() - last_publish_time_ >= publish_period_) {
+    publish();
+  }
+}
+
+void BehaviorTreeProfiler::publish()
+{
+  last_publish_time_ = std::chrono::steady_clock::now();
+
+  auto profile_msg = std::make_unique<nav2_msgs::msg::BehaviorTreeProfile>();
+  profile_msg->timestamp = clock_->now();
+  for (const auto & profile : profiles_) {
+    if (profile.tick_count == 0) {
+      continue;
+    }
+    nav2_msgs::msg::BehaviorTreeNodeProfile node_profile;
+    node_profile.node_name = profile.node->name();
+    node_profile.registration_name = profile.node->registrationName();
+    node_profile.uid = profile.node->UID();
+    node_profile.path = profile.path;
+    node_profile.tick_count = profile.tick_count;
+    node_profile.total_duration_ns = profile.total_duration.count();
+    node_profile.self_duration_ns = profile.self_duration.count();
+    node_profile.max_duration_ns = profile.max_duration.count();
+    node_profile.histogram.assign(profile.histogram.begin(), profile.histogram.end());
+    profile_msg->nodes.push_back(std::move(node_profile));
+  }
+  profile_pub_->publish(std::move(profile_msg));
+}
+
+bool BehaviorTreeProfiler::writeFoldedStacks(const std::string & filename) const
+{
+  std::ofstream file(filename, std::ios::trunc);
+  if (!file.good()) {
+    return false;
+  }
+
+  for (const auto & profile : profiles_) {
+    const auto microseconds =
+      std::chrono::duration_cast<std::chrono::microseconds>(profile.self_duration).count();
+    if (microseconds > 0) {
+      file << profile.path << " " << microseconds << "\n";
+    }
+  }
+  return file.good();
+}
+
+void BehaviorTreeProfiler::reset()
+{
+  stack_.clear();
+  for (auto & profile : profiles_) {
+    const BT::TreeNode * tree_node = profile.node;
+    std::string path = std::move(profile.path);
+    profile = NodeProfile();
+    profile.node = tree_node;
+    profile.path = std::move(path);
+  }
+}
+
+}  // namespace nav2_behavior_tree
@@ -0,0 +1,198 @@
+// Copyright (c) 2024 Open Navigation LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <string>
+#include <thread>
+
+#include "rclcpp/rclcpp.hpp"
+#include "behaviortree_cpp/bt_factory.h"
+#include "utils/test_service.hpp"
+
+#include "nav2_behavior_tree/plugins/condition/is_path_valid_on_costmap_update_condition.hpp"
+
+using namespace std::chrono;  // NOLINT
+using namespace std::chrono_literals;  // NOLINT
+
+class IsPathValidService : public TestService<nav2_msgs::srv::IsPathValid>
+{
+public:
+  IsPathValidService()
+  : TestService("is_path_valid")
+  {}
+
+  virtual void handle_service(
+    const std::shared_ptr<rmw_request_id_t> request_header,
+    const std::shared_ptr<nav2_msgs::srv::IsPathValid::Request> request,
+    const std::shared_ptr<nav2_msgs::srv::IsPathValid::Response> response)
+  {
+    (void)request_header;
+    (void)request;
+    calls++;
+    response->is_valid = true;
+  }
+
+  std::atomic<int> calls{0};
+};
+
+class IsPathValidOnCostmapUpdateTestFixture : public ::testing::Test
+{
+public:
+  void SetUp()
+  {
+    node_ = std::make_shared<rclcpp::Node>("test_is_path_valid_on_costmap_update_condition");
+    factory_ = std::make_shared<BT::BehaviorTreeFactory>();
+    config_ = new BT::NodeConfiguration();
+    config_->blackboard = BT::Blackboard::create();
+    config_->blackboard->set("node", node_);
+    config_->blackboard->set<std::chrono::milliseconds>(
+      "server_timeout",
+      std::chrono::milliseconds(100));
+    factory_->registerNodeType<nav2_behavior_tree::IsPathValidOnCostmapUpdateCondition>(
+      "IsPathValidOnCostmapUpdate");
+
+    auto qos = rclcpp::QoS(rclcpp::KeepLast(1)).transient_local().reliable();
+    costmap_pub_ = node_->create_publisher<nav2_msgs::msg::Costmap>(
+      "global_costmap/costmap_raw", qos);
+    update_pub_ = node_->create_publisher<nav2_msgs::msg::CostmapUpdate>(
+      "global_costmap/costmap_raw_updates", qos);
+  }
+
+  void TearDown()
+  {
+    delete config_;
+    config_ = nullptr;
+    costmap_pub_.reset();
+    update_pub_.reset();
+    node_.reset();
+    factory_.reset();
+    tree_.reset();
+  }
+
+  void publishUpdate(uint32_t x, uint32_t y)
+  {
+    nav2_msgs::msg::CostmapUpdate update;
+    update.x = x;
+    update.y = y;
+    update.size_x = 10;
+    update.size_y = 10;
+    update.data.resize(100, 0);
+    update_pub_->publish(update);
+    std::this_thread::sleep_for(100ms);
+  }
+
+  static std::shared_ptr<IsPathValidService> server_;
+
+protected:
+  static rclcpp::Node::SharedPtr node_;
+  static BT::NodeConfiguration * config_;
+  static std::shared_ptr<BT::BehaviorTreeFactory> factory_;
+  static std::shared_ptr<BT::Tree> tree_;
+  static rclcpp::Publisher<nav2_msgs::msg::Costmap>::SharedPtr costmap_pub_;
+  static rclcpp::Publisher<nav2_msgs::msg::CostmapUpdate>::SharedPtr update_pub_;
+};
+
+std::shared_ptr<IsPathValidService> IsPathValidOnCostmapUpdateTestFixture::server_ = nullptr;
+rclcpp::Node::SharedPtr IsPathValidOnCostmapUpdateTestFixture::node_ = nullptr;
+BT::NodeConfiguration * IsPathValidOnCostmapUpdateTestFixture::config_ = nullptr;
+std::shared_ptr<BT::BehaviorTreeFactory> IsPathValidOnCostmapUpdateTestFixture::factory_ =
+  nullptr;
+std::shared_ptr<BT::Tree> IsPathValidOnCostmapUpdateTestFixture::tree_ = nullptr;
+rclcpp::Publisher<nav2_msgs::msg::Costmap>::SharedPtr
+IsPathValidOnCostmapUpdateTestFixture::costmap_pub_ = nullptr;
+rclcpp::Publisher<nav2_msgs::msg::CostmapUpdate>::SharedPtr
+IsPathValidOnCostmapUpdateTestFixture::update_pub_ = nullptr;
+
+TEST_F(IsPathValidOnCostmapUpdateTestFixture, test_behavior)
+{
+  std::string xml_txt =
+    R"(
+      <root BTCPP_format="4">
+        <BehaviorTree ID="MainTree">
+            <IsPathValidOnCostmapUpdate path="{path}" margin="0.5"/>
+        </BehaviorTree>
+      </root>)";
+
+  // A path along x, from 0 to 5m
+  nav_msgs::msg::Path path;
+  for (int i = 0; i <= 50; ++i) {
+    geometry_msgs::msg::PoseStamped pose;
+    pose.pose.position.x = 0.1 * i;
+    path.poses.push_back(pose);
+  }
+  config_->blackboard->set("path", path);
+
+  // A costmap of 0.1m cells from the origin
+  nav2_msgs::msg::Costmap costmap;
+  costmap.metadata.resolution = 0.1;
+  costmap.metadata.size_x = 200;
+  costmap.metadata.size_y = 200;
+  costmap_pub_->publish(costmap);
+
+  tree_ = std::make_shared<BT::Tree>(factory_->createTreeFromText(xml_txt, config_->blackboard));
+  std::this_thread::sleep_for(500ms);
+
+  // The path is checked at first, then once the costmap is received
+  EXPECT_EQ(tree_->rootNode()->executeTick(), BT::NodeStatus::SUCCESS);
+  std::this_thread::sleep_for(100ms);
+  EXPECT_EQ(tree_->rootNode()->executeTick(), BT::NodeStatus::SUCCESS);
+  int calls = server_->calls;
+
+  // Nothing changed
+  EXPECT_EQ(tree_->rootNode()->executeTick(), BT::NodeStatus::SUCCESS);
+  EXPECT_EQ(server_->calls, calls);
+
+  // An update away from the path
+  publishUpdate(100, 100);
+  EXPECT_EQ(tree_->rootNode()->executeTick(), BT::NodeStatus::SUCCESS);
+  EXPECT_EQ(server_->calls, calls);
+
+  // An update on the path
+  publishUpdate(20, 0);
+  EXPECT_EQ(tree_->rootNode()->executeTick(), BT::NodeStatus::SUCCESS);
+  EXPECT_EQ(server_->calls, calls + 1);
+
+  // A new path
+  path.poses.pop_back();
+  config_->blackboard->set("path", path);
+  EXPECT_EQ(tree_->rootNode()->executeTick(), BT::NodeStatus::SUCCESS);
+  EXPECT_EQ(server_->calls, calls + 2);
+  EXPECT_EQ(tree_->rootNode()->executeTick(), BT::NodeStatus::SUCCESS);
+  EXPECT_EQ(server_->calls, calls + 2);
+}
+
+int main(int argc, char ** argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+
+  // initialize ROS
+  rclcpp::init(argc, argv);
+
+  // initialize service and spin on new thread
+  IsPathValidOnCostmapUpdateTestFixture::server_ = std::make_shared<IsPathValidService>();
+  std::thread server_thread([]() {
+      rclcpp::spin(IsPathValidOnCostmapUpdateTestFixture::server_);
+    });
+
+  bool all_successful = RUN_ALL_TESTS();
+
+  // shutdown ROS
+  rclcpp::shutdown();
+  server_thread.join();
+
+  return all_successful;
+}
@@ -0,0 +1,124 @@
+// Copyright (c) 2024 Open Navigation LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+#include <atomic>
+#include <chrono>
+#include <future>
+#include <memory>
+#include <stdexcept>
+#include <thread>
+
+#include "nav2_msgs/action/spin.hpp"
+#include "nav2_msgs/action/wait.hpp"
+
+#include "utils/test_action_server.hpp"
+#include "nav2_behavior_tree/action_client_registry.hpp"
+
+using namespace std::chrono_literals;  // NOLINT
+
+class WaitActionServer : public TestActionServer<nav2_msgs::action::Wait>
+{
+public:
+  WaitActionServer()
+  : TestActionServer("wait")
+  {}
+
+protected:
+  void execute(
+    const typename std::shared_ptr<rclcpp_action::ServerGoalHandle<nav2_msgs::action::Wait>>
+    goal_handle) override
+  {
+    goal_handle->succeed(std::make_shared<nav2_msgs::action::Wait::Result>());
+  }
+};
+
+TEST(ActionClientRegistryTest, test_shared_clients)
+{
+  auto server = std::make_shared<WaitActionServer>();
+  auto node = std::make_shared<rclcpp::Node>("action_client_registry_test");
+  nav2_behavior_tree::ActionClientRegistry registry(node);
+
+  // The clients of an action are the same, with the same executor
+  auto first = registry.getClient<nav2_msgs::action::Wait>("wait", 1000ms);
+  auto second = registry.getClient<nav2_msgs::action::Wait>("wait", 1000ms);
+  ASSERT_NE(first.client, nullptr);
+  ASSERT_NE(first.executor, nullptr);
+  EXPECT_EQ(first.client, second.client);
+  EXPECT_EQ(first.executor, second.executor);
+  EXPECT_EQ(registry.size(), 1u);
+
+  // An action is bound to a single type
+  EXPECT_THROW(registry.getClient<nav2_msgs::action::Spin>("wait", 1000ms), std::runtime_error);
+
+  // The clients of servers not found are not kept
+  EXPECT_THROW(
+    registry.getClient<nav2_msgs::action::Spin>("spin", 10ms), std::runtime_error);
+  EXPECT_EQ(registry.size(), 1u);
+
+  registry.clear();
+  EXPECT_EQ(registry.size(), 0u);
+  auto third = registry.getClient<nav2_msgs::action::Wait>("wait", 1000ms);
+  EXPECT_NE(first.client, third.client);
+}
+
+TEST(ActionClientRegistryTest, test_spin_in_thread)
+{
+  auto server = std::make_shared<WaitActionServer>();
+  rclcpp::executors::SingleThreadedExecutor server_executor;
+  server_executor.add_node(server);
+  std::thread server_thread([&server_executor]() {server_executor.spin();});
+
+  std::atomic<int> events{0};
+  auto node = std::make_shared<rclcpp::Node>("action_client_registry_spin_test");
+  nav2_behavior_tree::ActionClientRegistry registry(node, true, [&events]() {events++;});
+  EXPECT_TRUE(registry.isSpinning());
+
+  // The goal is completed by the thread of the registry, without spinning here
+  auto entry = registry.getClient<nav2_msgs::action::Wait>("wait", 1000ms);
+  auto future_goal_handle = entry.client->async_send_goal(nav2_msgs::action::Wait::Goal());
+  ASSERT_EQ(future_goal_handle.wait_for(2s), std::future_status::ready);
+  auto goal_handle = future_goal_handle.get();
+  ASSERT_NE(goal_handle, nullptr);
+  auto future_result = entry.client->async_get_result(goal_handle);
+  ASSERT_EQ(future_result.wait_for(2s), std::future_status::ready);
+  EXPECT_EQ(future_result.get().code, rclcpp_action::ResultCode::SUCCEEDED);
+
+  registry.notifyEvent();
+  EXPECT_EQ(events, 1);
+
+  // Nothing is notified once stopped
+  registry.stopSpinning();
+  EXPECT_FALSE(registry.isSpinning());
+  registry.notifyEvent();
+  EXPECT_EQ(events, 1);
+
+  server_executor.cancel();
+  server_thread.join();
+}
+
+int main(int argc, char ** argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+
+  // initialize ROS
+  rclcpp::init(argc, argv);
+
+  int all_successful = RUN_ALL_TESTS();
+
+  // shutdown ROS
+  rclcpp::shutdown();
+
+  return all_successful;
+}
@@ -0,0 +1,135 @@
+// Copyright (c) 2024 Open Navigation LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <thread>
+
+#include "behaviortree_cpp/bt_factory.h"
+#include "nav2_behavior_tree/behavior_tree_profiler.hpp"
+
+using namespace std::chrono_literals;  // NOLINT
+
+class SleepNode : public BT::SyncActionNode
+{
+public:
+  SleepNode(const std::string & name, const BT::NodeConfiguration & config)
+  : SyncActionNode(name, config)
+  {}
+
+  BT::NodeStatus tick() override
+  {
+    std::this_thread::sleep_for(2ms);
+    return BT::NodeStatus::SUCCESS;
+  }
+
+  static BT::PortsList providedPorts()
+  {
+    return {};
+  }
+};
+
+TEST(BehaviorTreeProfilerTest, test_histogram_bucket)
+{
+  using Profiler = nav2_behavior_tree::BehaviorTreeProfiler;
+  EXPECT_EQ(Profiler::histogramBucket(500ns), 0u);
+  EXPECT_EQ(Profiler::histogramBucket(1us), 1u);
+  EXPECT_EQ(Profiler::histogramBucket(3us), 2u);
+  EXPECT_EQ(Profiler::histogramBucket(4us), 3u);
+  EXPECT_EQ(Profiler::histogramBucket(1h), Profiler::kHistogramSize - 1);
+}
+
+TEST(BehaviorTreeProfilerTest, test_tick_durations)
+{
+  std::string xml_txt =
+    R"(
+      <root BTCPP_format="4">
+        <BehaviorTree ID="MainTree">
+          <Sequence name="root">
+            <Sleep name="slow"/>
+            <AlwaysSuccess name="fast"/>
+          </Sequence>
+        </BehaviorTree>
+      </root>)";
+
+  BT::BehaviorTreeFactory factory;
+  factory.registerNodeType<SleepNode>("Sleep");
+  auto tree = factory.createTreeFromText(xml_txt);
+
+  auto node = std::make_shared<rclcpp::Node>("behavior_tree_profiler_test");
+  auto profiler = std::make_unique<nav2_behavior_tree::BehaviorTreeProfiler>(node, tree);
+
+  for (int i = 0; i < 3; ++i) {
+    tree.tickOnce();
+  }
+
+  const auto & profiles = profiler->getProfiles();
+  ASSERT_EQ(profiles.size(), 3u);
+  EXPECT_EQ(profiles[0].path, "root");
+  EXPECT_EQ(profiles[1].path, "root;slow");
+  EXPECT_EQ(profiles[2].path, "root;fast");
+
+  for (const auto & profile : profiles) {
+    EXPECT_EQ(profile.tick_count, 3u);
+    uint64_t histogram_count = 0;
+    for (auto count : profile.histogram) {
+      histogram_count += count;
+    }
+    EXPECT_EQ(histogram_count, 3u);
+  }
+
+  // The sequence spends its time in its children
+  EXPECT_GE(profiles[1].total_duration, 6ms);
+  EXPECT_GE(profiles[0].total_duration, profiles[1].total_duration);
+  EXPECT_LT(profiles[0].self_duration, profiles[1].self_duration);
+  EXPECT_EQ(profiles[1].self_duration, profiles[1].total_duration);
+
+  std::string filename = "/tmp/test_behavior_tree_profiler.folded";
+  ASSERT_TRUE(profiler->writeFoldedStacks(filename));
+  std::ifstream file(filename);
+  std::string line;
+  bool found = false;
+  while (std::getline(file, line)) {
+    found |= line.rfind("root;slow ", 0) == 0;
+  }
+  EXPECT_TRUE(found);
+  std::remove(filename.c_str());
+
+  profiler->reset();
+  EXPECT_EQ(profiler->getProfiles()[1].tick_count, 0u);
+  EXPECT_EQ(profiler->getProfiles()[1].path, "root;slow");
+
+  // The tree is no longer profiled once the profiler is gone
+  profiler.reset();
+  EXPECT_EQ(tree.tickOnce(), BT::NodeStatus::SUCCESS);
+}
+
+int main(int argc, char ** argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+
+  // initialize ROS
+  rclcpp::init(argc, argv);
+
+  int all_successful = RUN_ALL_TESTS();
+
+  // shutdown ROS
+  rclcpp::shutdown();
+
+  return all_successful;
+}
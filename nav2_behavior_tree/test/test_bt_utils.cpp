@@ -248,6 +248,52 @@ TEST(ErrorCodePortTest, test_correct_syntax)
   EXPECT_TRUE(value.find(212) != value.end());
 }
 
+TEST(BlackboardEntryHandleTest, test_remapped_literal_and_unset_ports)
+{
+  std::string xml_txt =
+    R"(
+      <root BTCPP_format="4">
+        <BehaviorTree ID="MainTree">
+          <Sequence>
+            <ParamPort test="{value}" />
+            <ParamPort test="5" />
+            <ParamPort />
+          </Sequence>
+        </BehaviorTree>
+      </root>)";
+
+  BT::BehaviorTreeFactory factory;
+  factory.registerNodeType<TestNode<int>>("ParamPort");
+  auto blackboard = BT::Blackboard::create();
+  auto tree = factory.createTreeFromText(xml_txt, blackboard);
+  auto sequence = dynamic_cast<BT::ControlNode *>(tree.rootNode());
+  ASSERT_NE(sequence, nullptr);
+
+  // The entries of the remapped and unset ports do not exist until they are set
+  BT::BlackboardEntryHandle<int> remapped(*sequence->child(0), blackboard, "test");
+  BT::BlackboardEntryHandle<int> literal(*sequence->child(1), blackboard, "test");
+  BT::BlackboardEntryHandle<int> unset(*sequence->child(2), blackboard, "test");
+  int value = 0;
+  EXPECT_FALSE(remapped.get(value));
+  EXPECT_FALSE(unset.get(value));
+
+  blackboard->set<int>("value", 1);
+  blackboard->set<int>("test", 2);
+  EXPECT_TRUE(remapped.get(value));
+  EXPECT_EQ(value, 1);
+  EXPECT_FALSE(remapped.updateIfChanged(value));
+  blackboard->set<int>("value", 3);
+  EXPECT_TRUE(remapped.updateIfChanged(value));
+  EXPECT_EQ(value, 3);
+
+  EXPECT_TRUE(literal.get(value));
+  EXPECT_EQ(value, 5);
+  EXPECT_FALSE(literal.updateIfChanged(value));
+
+  EXPECT_TRUE(unset.updateIfChanged(value));
+  EXPECT_EQ(value, 2);
+}
+
 TEST(deconflictPortAndParamFrameTest, test_correct_syntax)
 {
   std::string xml_txt =
@@ -72,17 +72,6 @@ protected:
    */
   void onConfigure() override;
 
-  /**
-   * @brief project a position
-   * @param pose initial pose to project
-   * @param twist velocity to project pose by
-   * @param projection_time time to project by
-   */
-  geometry_msgs::msg::Pose2D projectPose(
-    const geometry_msgs::msg::Pose2D & pose,
-    const geometry_msgs::msg::Twist & twist,
-    double projection_time);
-
   /**
    * @brief Callback function to preempt assisted teleop
    * @param msg empty message
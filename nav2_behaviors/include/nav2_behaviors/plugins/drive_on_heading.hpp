@@ -16,7 +16,9 @@
 #ifndef NAV2_BEHAVIORS__PLUGINS__DRIVE_ON_HEADING_HPP_
 #define NAV2_BEHAVIORS__PLUGINS__DRIVE_ON_HEADING_HPP_
 
+#include <algorithm>
 #include <chrono>
+#include <cmath>
 #include <memory>
 #include <utility>
 
@@ -168,30 +170,15 @@ protected:
     const geometry_msgs::msg::Twist & cmd_vel,
     geometry_msgs::msg::Pose2D & pose2d)
   {
-    // Simulate ahead by simulate_ahead_time_ in this->cycle_frequency_ increments
-    int cycle_count = 0;
-    double sim_position_change;
+    // Check the area swept over simulate_ahead_time_, or until the distance is reached
     const double diff_dist = abs(command_x_) - distance;
-    const int max_cycle_count = static_cast<int>(this->cycle_frequency_ * simulate_ahead_time_);
-    geometry_msgs::msg::Pose2D init_pose = pose2d;
-    bool fetch_data = true;
-
-    while (cycle_count < max_cycle_count) {
-      sim_position_change = cmd_vel.linear.x * (cycle_count / this->cycle_frequency_);
-      pose2d.x = init_pose.x + sim_position_change * cos(init_pose.theta);
-      pose2d.y = init_pose.y + sim_position_change * sin(init_pose.theta);
-      cycle_count++;
-
-      if (diff_dist - abs(sim_position_change) <= 0.) {
-        break;
-      }
-
-      if (!this->local_collision_checker_->isCollisionFree(pose2d, fetch_data)) {
-        return false;
-      }
-      fetch_data = false;
+    if (diff_dist <= 0.) {
+      return true;
     }
-    return true;
+    const double sim_distance =
+      std::min(diff_dist, std::fabs(cmd_vel.linear.x) * simulate_ahead_time_);
+    return this->local_collision_checker_->isTranslationCollisionFree(
+      pose2d, std::copysign(sim_distance, cmd_vel.linear.x));
   }
 
   /**
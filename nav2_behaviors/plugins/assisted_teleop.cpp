@@ -113,67 +113,39 @@ ResultStatus AssistedTeleop::onCycleUpdate()
     return ResultStatus{Status::FAILED, AssistedTeleopActionResult::TF_ERROR};
   }
 
-  geometry_msgs::msg::Pose2D projected_pose;
-  projected_pose.x = current_pose.pose.position.x;
-  projected_pose.y = current_pose.pose.position.y;
-  projected_pose.theta = tf2::getYaw(current_pose.pose.orientation);
+  geometry_msgs::msg::Pose2D pose;
+  pose.x = current_pose.pose.position.x;
+  pose.y = current_pose.pose.position.y;
+  pose.theta = tf2::getYaw(current_pose.pose.orientation);
 
   auto scaled_twist = std::make_unique<geometry_msgs::msg::TwistStamped>(teleop_twist_);
-  for (double time = simulation_time_step_; time < projection_time_;
-    time += simulation_time_step_)
-  {
-    projected_pose = projectPose(projected_pose, teleop_twist_.twist, simulation_time_step_);
-
-    if (!local_collision_checker_->isCollisionFree(projected_pose)) {
-      if (time == simulation_time_step_) {
-        RCLCPP_DEBUG_STREAM_THROTTLE(
-          logger_,
-          *clock_,
-          1000,
-          behavior_name_.c_str() << " collided on first time step, setting velocity to zero");
-        scaled_twist->twist.linear.x = 0.0f;
-        scaled_twist->twist.linear.y = 0.0f;
-        scaled_twist->twist.angular.z = 0.0f;
-        break;
-      } else {
-        RCLCPP_DEBUG_STREAM_THROTTLE(
-          logger_,
-          *clock_,
-          1000,
-          behavior_name_.c_str() << " collision approaching in " << time << " seconds");
-        double scale_factor = time / projection_time_;
-        scaled_twist->twist.linear.x *= scale_factor;
-        scaled_twist->twist.linear.y *= scale_factor;
-        scaled_twist->twist.angular.z *= scale_factor;
-        break;
-      }
-    }
+  const double collision_time = local_collision_checker_->getCollisionTime(
+    pose, teleop_twist_.twist, projection_time_, simulation_time_step_);
+  if (collision_time >= 0.0 && collision_time <= simulation_time_step_) {
+    RCLCPP_DEBUG_STREAM_THROTTLE(
+      logger_,
+      *clock_,
+      1000,
+      behavior_name_.c_str() << " collided on first time step, setting velocity to zero");
+    scaled_twist->twist.linear.x = 0.0f;
+    scaled_twist->twist.linear.y = 0.0f;
+    scaled_twist->twist.angular.z = 0.0f;
+  } else if (collision_time > 0.0) {
+    RCLCPP_DEBUG_STREAM_THROTTLE(
+      logger_,
+      *clock_,
+      1000,
+      behavior_name_.c_str() << " collision approaching in " << collision_time << " seconds");
+    double scale_factor = collision_time / projection_time_;
+    scaled_twist->twist.linear.x *= scale_factor;
+    scaled_twist->twist.linear.y *= scale_factor;
+    scaled_twist->twist.angular.z *= scale_factor;
   }
   vel_pub_->publish(std::move(scaled_twist));
 
   return ResultStatus{Status::RUNNING, AssistedTeleopActionResult::NONE};
 }
 
-geometry_msgs::msg::Pose2D AssistedTeleop::projectPose(
-  const geometry_msgs::msg::Pose2D & pose,
-  const geometry_msgs::msg::Twist & twist,
-  double projection_time)
-{
-  geometry_msgs::msg::Pose2D projected_pose = pose;
-
-  projected_pose.x += projection_time * (
-    twist.linear.x * cos(pose.theta) +
-    twist.linear.y * sin(pose.theta));
-
-  projected_pose.y += projection_time * (
-    twist.linear.x * sin(pose.theta) -
-    twist.linear.y * cos(pose.theta));
-
-  projected_pose.theta += projection_time * twist.angular.z;
-
-  return projected_pose;
-}
-
 void AssistedTeleop::preemptTeleopCallback(const std_msgs::msg::Empty::SharedPtr)
 {
   preempt_teleop_ = true;
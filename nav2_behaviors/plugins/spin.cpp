@@ -164,28 +164,14 @@ bool Spin::isCollisionFree(
   const geometry_msgs::msg::Twist & cmd_vel,
   geometry_msgs::msg::Pose2D & pose2d)
 {
-  // Simulate ahead by simulate_ahead_time_ in cycle_frequency_ increments
-  int cycle_count = 0;
-  double sim_position_change;
-  const int max_cycle_count = static_cast<int>(cycle_frequency_ * simulate_ahead_time_);
-  geometry_msgs::msg::Pose2D init_pose = pose2d;
-  bool fetch_data = true;
-
-  while (cycle_count < max_cycle_count) {
-    sim_position_change = cmd_vel.angular.z * (cycle_count / cycle_frequency_);
-    pose2d.theta = init_pose.theta + sim_position_change;
-    cycle_count++;
-
-    if (abs(relative_yaw) - abs(sim_position_change) <= 0.) {
-      break;
-    }
-
-    if (!local_collision_checker_->isCollisionFree(pose2d, fetch_data)) {
-      return false;
-    }
-    fetch_data = false;
+  // Check the area swept over simulate_ahead_time_, or until the remaining yaw is reached
+  if (relative_yaw == 0.0) {
+    return true;
   }
-  return true;
+  const double sim_angle = std::min(
+    std::fabs(relative_yaw), std::fabs(cmd_vel.angular.z) * simulate_ahead_time_);
+  return local_collision_checker_->isRotationCollisionFree(
+    pose2d, std::copysign(sim_angle, cmd_vel.angular.z));
 }
 
 }  // namespace nav2_behaviors
@@ -190,6 +190,7 @@ def generate_launch_description():
                         name='map_server',
                         parameters=[configured_params],
                         remappings=remappings,
+                        extra_arguments=[{'use_intra_process_comms': True}],
                     ),
                 ],
             ),
@@ -208,6 +209,7 @@ def generate_launch_description():
                             {'yaml_filename': map_yaml_file},
                         ],
                         remappings=remappings,
+                        extra_arguments=[{'use_intra_process_comms': True}],
                     ),
                 ],
             ),
@@ -220,6 +222,7 @@ def generate_launch_description():
                         name='amcl',
                         parameters=[configured_params],
                         remappings=remappings,
+                        extra_arguments=[{'use_intra_process_comms': True}],
                     ),
                     ComposableNode(
                         package='nav2_lifecycle_manager',
@@ -248,6 +248,7 @@ def generate_launch_description():
                         name='controller_server',
                         parameters=[configured_params],
                         remappings=remappings + [('cmd_vel', 'cmd_vel_nav')],
+                        extra_arguments=[{'use_intra_process_comms': True}],
                     ),
                     ComposableNode(
                         package='nav2_smoother',
@@ -262,6 +263,7 @@ def generate_launch_description():
                         name='planner_server',
                         parameters=[configured_params],
                         remappings=remappings,
+                        extra_arguments=[{'use_intra_process_comms': True}],
                     ),
                     ComposableNode(
                         package='nav2_behaviors',
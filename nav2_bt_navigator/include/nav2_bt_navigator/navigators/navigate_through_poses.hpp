@@ -27,6 +27,7 @@
 #include "nav2_util/robot_utils.hpp"
 #include "nav2_util/geometry_utils.hpp"
 #include "nav2_util/odometry_utils.hpp"
+#include "nav2_util/path_progress.hpp"
 
 namespace nav2_bt_navigator
 {
@@ -114,6 +115,9 @@ protected:
 
   // Odometry smoother object
   std::shared_ptr<nav2_util::OdomSmoother> odom_smoother_;
+
+  // Progress along the current path, for the distance remaining
+  nav2_util::PathProgress path_progress_;
 };
 
 }  // namespace nav2_bt_navigator
@@ -0,0 +1,76 @@
+// Copyright (c) 2024 Open Navigation LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "nav2_bt_navigator/bt_navigator.hpp"
+#include "rclcpp/rclcpp.hpp"
+
+// Hosts the BT navigators of many robots in one process, one per namespace of the
+// robot_namespaces parameter, each spun by an executor of its own. They share the
+// loaded plugin libraries and the BT factories of their engines.
+int main(int argc, char ** argv)
+{
+  rclcpp::init(argc, argv);
+  auto host = std::make_shared<rclcpp::Node>("bt_navigator_host");
+  auto robot_namespaces = host->declare_parameter(
+    "robot_namespaces", std::vector<std::string>{});
+  if (robot_namespaces.empty()) {
+    RCLCPP_FATAL(host->get_logger(), "No robot_namespaces given to host navigators for");
+    rclcpp::shutdown();
+    return 1;
+  }
+
+  std::vector<std::shared_ptr<nav2_bt_navigator::BtNavigator>> navigators;
+  std::vector<std::shared_ptr<rclcpp::executors::SingleThreadedExecutor>> executors;
+  std::vector<std::thread> threads;
+  for (const auto & robot_namespace : robot_namespaces) {
+    RCLCPP_INFO(
+      host->get_logger(), "Hosting the navigator of namespace %s", robot_namespace.c_str());
+    std::string absolute_namespace = robot_namespace;
+    if (absolute_namespace.empty() || absolute_namespace.front() != '/') {
+      absolute_namespace = "/" + absolute_namespace;
+    }
+    // Each robot has its own transforms, as when launched in its namespace
+    auto options = rclcpp::NodeOptions().arguments(
+      {"--ros-args",
+        "-r", "__ns:=" + absolute_namespace,
+        "-r", "/tf:=tf",
+        "-r", "/tf_static:=tf_static",
+        "--"});
+    navigators.push_back(std::make_shared<nav2_bt_navigator::BtNavigator>(options));
+    executors.push_back(std::make_shared<rclcpp::executors::SingleThreadedExecutor>());
+    executors.back()->add_node(navigators.back()->get_node_base_interface());
+  }
+
+  for (auto & executor : executors) {
+    threads.emplace_back([executor]() {executor->spin();});
+  }
+
+  rclcpp::spin(host);
+
+  for (auto & executor : executors) {
+    executor->cancel();
+  }
+  for (auto & thread : threads) {
+    thread.join();
+  }
+  navigators.clear();
+  rclcpp::shutdown();
+
+  return 0;
+}
@@ -17,6 +17,7 @@
 #include <set>
 #include <memory>
 #include <limits>
+#include <mutex>
 #include "nav2_bt_navigator/navigators/navigate_through_poses.hpp"
 
 namespace nav2_bt_navigator
@@ -102,10 +103,16 @@ NavigateThroughPosesNavigator::onLoop()
 
   auto blackboard = bt_action_server_->getBlackboard();
 
-  Goals goal_poses;
-  [[maybe_unused]] auto res = blackboard->get(goals_blackboard_id_, goal_poses);
+  // Only the number of goals is needed, so they are not copied
+  size_t goals_remaining = 0;
+  if (auto goals_entry = blackboard->getEntry(goals_blackboard_id_)) {
+    std::unique_lock<std::mutex> lock(goals_entry->entry_mutex);
+    if (auto goal_poses = goals_entry->value.castPtr<Goals>()) {
+      goals_remaining = goal_poses->size();
+    }
+  }
 
-  if (goal_poses.size() == 0) {
+  if (goals_remaining == 0) {
     bt_action_server_->publishFeedback(feedback_msg);
     return;
   }
@@ -121,32 +128,26 @@ NavigateThroughPosesNavigator::onLoop()
   }
 
   try {
-    // Get current path points
-    nav_msgs::msg::Path current_path;
-    if (!blackboard->get(path_blackboard_id_, current_path) || current_path.poses.size() == 0u) {
-      // If no path set yet or not meaningful, can't compute ETA or dist remaining yet.
+    // Get current path points, read in place and processed again only once replanned
+    auto path_entry = blackboard->getEntry(path_blackboard_id_);
+    if (!path_entry) {
       throw std::exception();
     }
+    {
+      std::unique_lock<std::mutex> lock(path_entry->entry_mutex);
+      auto current_path = path_entry->value.castPtr<nav_msgs::msg::Path>();
+      if (!current_path || current_path->poses.size() == 0u) {
+        // If no path set yet or not meaningful, can't compute ETA or dist remaining yet.
+        throw std::exception();
+      }
+      path_progress_.updatePath(*current_path);
+    }
 
-    // Find the closest pose to current pose on global path
-    auto find_closest_pose_idx =
-      [&current_pose, &current_path]() {
-        size_t closest_pose_idx = 0;
-        double curr_min_dist = std::numeric_limits<double>::max();
-        for (size_t curr_idx = 0; curr_idx < current_path.poses.size(); ++curr_idx) {
-          double curr_dist = nav2_util::geometry_utils::euclidean_distance(
-            current_pose, current_path.poses[curr_idx]);
-          if (curr_dist < curr_min_dist) {
-            curr_min_dist = curr_dist;
-            closest_pose_idx = curr_idx;
-          }
-        }
-        return closest_pose_idx;
-      };
+    // Find the closest pose to current pose on global path, from the last one found
+    path_progress_.update(current_pose);
 
     // Calculate distance on the path
-    double distance_remaining =
-      nav2_util::geometry_utils::calculate_path_length(current_path, find_closest_pose_idx());
+    double distance_remaining = path_progress_.distanceRemaining();
 
     // Default value for time remaining
     rclcpp::Duration estimated_time_remaining = rclcpp::Duration::from_seconds(0.0);
@@ -169,11 +170,11 @@ NavigateThroughPosesNavigator::onLoop()
   }
 
   int recovery_count = 0;
-  res = blackboard->get("number_recoveries", recovery_count);
+  [[maybe_unused]] auto res = blackboard->get("number_recoveries", recovery_count);
   feedback_msg->number_of_recoveries = recovery_count;
   feedback_msg->current_pose = current_pose;
   feedback_msg->navigation_time = clock_->now() - start_time_;
-  feedback_msg->number_of_poses_remaining = goal_poses.size();
+  feedback_msg->number_of_poses_remaining = goals_remaining;
 
   bt_action_server_->publishFeedback(feedback_msg);
 }
@@ -16,6 +16,7 @@
 #include <string>
 #include <memory>
 #include <limits>
+#include <mutex>
 #include "nav2_bt_navigator/navigators/navigate_to_pose.hpp"
 
 namespace nav2_bt_navigator
@@ -124,32 +125,26 @@ NavigateToPoseNavigator::onLoop()
   auto blackboard = bt_action_server_->getBlackboard();
 
   try {
-    // Get current path points
-    nav_msgs::msg::Path current_path;
-    if (!blackboard->get(path_blackboard_id_, current_path) || current_path.poses.size() == 0u) {
-      // If no path set yet or not meaningful, can't compute ETA or dist remaining yet.
+    // Get current path points, read in place and processed again only once replanned
+    auto path_entry = blackboard->getEntry(path_blackboard_id_);
+    if (!path_entry) {
       throw std::exception();
     }
+    {
+      std::unique_lock<std::mutex> lock(path_entry->entry_mutex);
+      auto current_path = path_entry->value.castPtr<nav_msgs::msg::Path>();
+      if (!current_path || current_path->poses.size() == 0u) {
+        // If no path set yet or not meaningful, can't compute ETA or dist remaining yet.
+        throw std::exception();
+      }
+      path_progress_.updatePath(*current_path);
+    }
 
-    // Find the closest pose to current pose on global path
-    auto find_closest_pose_idx =
-      [&current_pose, &current_path]() {
-        size_t closest_pose_idx = 0;
-        double curr_min_dist = std::numeric_limits<double>::max();
-        for (size_t curr_idx = 0; curr_idx < current_path.poses.size(); ++curr_idx) {
-          double curr_dist = nav2_util::geometry_utils::euclidean_distance(
-            current_pose, current_path.poses[curr_idx]);
-          if (curr_dist < curr_min_dist) {
-            curr_min_dist = curr_dist;
-            closest_pose_idx = curr_idx;
-          }
-        }
-        return closest_pose_idx;
-      };
+    // Find the closest pose to current pose on global path, from the last one found
+    path_progress_.update(current_pose);
 
     // Calculate distance on the path
-    double distance_remaining =
-      nav2_util::geometry_utils::calculate_path_length(current_path, find_closest_pose_idx());
+    double distance_remaining = path_progress_.distanceRemaining();
 
     // Default value for time remaining
     rclcpp::Duration estimated_time_remaining = rclcpp::Duration::from_seconds(0.0);
@@ -31,7 +31,9 @@
 #include "nav2_util/lifecycle_node.hpp"
 #include "nav2_util/twist_publisher.hpp"
 #include "nav2_util/twist_subscriber.hpp"
+#include "nav2_util/thread_pool.hpp"
 #include "nav2_msgs/msg/collision_monitor_state.hpp"
+#include "nav2_msgs/msg/collision_detector_state.hpp"
 
 #include "nav2_collision_monitor/types.hpp"
 #include "nav2_collision_monitor/polygon.hpp"
@@ -42,6 +44,7 @@
 #include "nav2_collision_monitor/pointcloud.hpp"
 #include "nav2_collision_monitor/range.hpp"
 #include "nav2_collision_monitor/polygon_source.hpp"
+#include "nav2_collision_monitor/transform_cache.hpp"
 
 namespace nav2_collision_monitor
 {
@@ -100,7 +103,7 @@ protected:
    * @brief Callback for input cmd_vel
    * @param msg Input cmd_vel message
    */
-  void cmdVelInCallbackStamped(geometry_msgs::msg::TwistStamped::SharedPtr msg);
+  virtual void cmdVelInCallbackStamped(geometry_msgs::msg::TwistStamped::SharedPtr msg);
   void cmdVelInCallbackUnstamped(geometry_msgs::msg::Twist::SharedPtr msg);
   /**
    * @brief Publishes output cmd_vel. If robot was stopped more than stop_pub_timeout_ seconds,
@@ -192,6 +195,15 @@ protected:
   void notifyActionState(
     const Action & robot_action, const std::shared_ptr<Polygon> action_polygon) const;
 
+  /**
+   * @brief Publishes the detections of the polygons with "none" action,
+   * as the collision detector would on the same data
+   * @param collision_points Array of 2D obstacle points
+   * @param velocity Robot velocity the velocity polygons are updated for
+   */
+  void publishDetectorState(
+    const std::vector<Point> & collision_points, const Velocity & velocity);
+
   /**
    * @brief Polygons publishing routine. Made for visualization.
    */
@@ -209,6 +221,19 @@ protected:
 
   /// @brief Data sources array
   std::vector<std::shared_ptr<Source>> sources_;
+  /// @brief Points from the data sources in a robot base frame, kept across
+  /// cmd_vel messages to reuse its storage
+  std::vector<Point> collision_points_;
+  /// @brief Worst-case duration (s) of processing a cmd_vel message since activation
+  double max_process_latency_;
+  /// @brief Transforms of the current cmd_vel message, shared between the sources
+  std::shared_ptr<TransformCache> transform_cache_;
+  /// @brief Workers getting the data of the sources in parallel, with the calling thread
+  std::unique_ptr<nav2_util::ThreadPool> source_pool_;
+  /// @brief Points of each source, when got in parallel
+  std::vector<std::vector<Point>> source_points_;
+  /// @brief Whether each source is valid, when got in parallel
+  std::vector<char> source_valid_;
 
   // Input/output speed controls
   /// @brief Input cmd_vel subscriber
@@ -220,6 +245,10 @@ protected:
   rclcpp_lifecycle::LifecyclePublisher<nav2_msgs::msg::CollisionMonitorState>::SharedPtr
     state_pub_;
 
+  /// @brief Detections of the "none" action polygons publisher, if detector_state_topic is set
+  rclcpp_lifecycle::LifecyclePublisher<nav2_msgs::msg::CollisionDetectorState>::SharedPtr
+    detector_state_pub_;
+
   /// @brief Collision points marker publisher
   rclcpp_lifecycle::LifecyclePublisher<visualization_msgs::msg::MarkerArray>::SharedPtr
     collision_points_marker_pub_;
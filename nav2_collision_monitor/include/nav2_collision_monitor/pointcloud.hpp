@@ -15,9 +15,11 @@
 #ifndef NAV2_COLLISION_MONITOR__POINTCLOUD_HPP_
 #define NAV2_COLLISION_MONITOR__POINTCLOUD_HPP_
 
+#include <cstdint>
 #include <memory>
 #include <vector>
 #include <string>
+#include <unordered_set>
 
 #include "sensor_msgs/msg/point_cloud2.hpp"
 
@@ -82,6 +84,19 @@ protected:
    */
   void getParameters(std::string & source_topic);
 
+  /**
+   * @brief Transforms the points of a cloud within the height range and the crop box,
+   * decimated, and adds them to the data array
+   * @param cloud PointCloud to convert
+   * @param tf_transform Source frame to base frame transform
+   * @param data Array where the points are to be added
+   * @return false if the cloud has no x, y and z float fields
+   */
+  bool convertData(
+    const sensor_msgs::msg::PointCloud2 & cloud,
+    const tf2::Transform & tf_transform,
+    std::vector<Point> & data);
+
   /**
    * @brief PointCloud data callback
    * @param msg Shared pointer to PointCloud message
@@ -95,6 +110,15 @@ protected:
 
   // Minimum and maximum height of PointCloud projected to 2D space
   double min_height_, max_height_;
+  /// @brief Box [min_x, min_y, max_x, max_y] in base frame out of which points are dropped,
+  /// empty for no cropping
+  std::vector<double> crop_box_;
+  /// @brief Only every point_stride_-th point of the cloud is used
+  int64_t point_stride_;
+  /// @brief Size of the 2D voxels keeping one point each, 0.0 for no voxel decimation
+  double voxel_resolution_;
+  /// @brief Voxels already holding a point of the cloud being converted
+  std::unordered_set<int64_t> voxels_;
 
   /// @brief Latest data obtained from pointcloud
   sensor_msgs::msg::PointCloud2::ConstSharedPtr data_;
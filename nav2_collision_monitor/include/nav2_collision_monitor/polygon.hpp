@@ -15,6 +15,7 @@
 #ifndef NAV2_COLLISION_MONITOR__POLYGON_HPP_
 #define NAV2_COLLISION_MONITOR__POLYGON_HPP_
 
+#include <cstdint>
 #include <memory>
 #include <string>
 #include <vector>
@@ -163,6 +164,21 @@ public:
   void publish();
 
 protected:
+  /**
+   * @brief Polygon rasterized over its bounding box
+   */
+  struct Raster
+  {
+    /// @brief Polygon vertices the raster was built from
+    std::vector<Point> poly;
+    /// @brief Cells, row major: RASTER_OUTSIDE, RASTER_INSIDE or RASTER_BOUNDARY
+    std::vector<uint8_t> cells;
+    /// @brief Origin and cell size, the latter no finer than the raster size allows
+    double origin_x{0.0}, origin_y{0.0}, cell_size{0.0};
+    /// @brief Size in cells
+    int size_x{0}, size_y{0};
+  };
+
   /**
    * @brief Supporting routine obtaining ROS-parameters common for all shapes
    * @param polygon_pub_topic Output name of polygon or radius subscription topic.
@@ -227,6 +243,13 @@ protected:
    */
   bool isPointInside(const Point & point) const;
 
+  /**
+   * @brief Rasterizes the polygon into a grid over its bounding box, each cell being
+   * inside, outside or crossed by the polygon boundary. Only the points in boundary
+   * cells then need the exact isPointInside() test.
+   */
+  void rasterize() const;
+
   /**
    * @brief Extracts Polygon points from a string with of the form [[x1,y1],[x2,y2],[x3,y3]...]
    * @param poly_string Input String containing the verteceis of the polygon
@@ -288,6 +311,12 @@ protected:
 
   /// @brief Polygon points (vertices) in a base_frame_id_
   std::vector<Point> poly_;
+
+  // Raster of the polygon, rebuilt when the polygon vertices change
+  /// @brief Requested raster cell size, 0.0 to test the points against the vertices only
+  double raster_resolution_;
+  /// @brief Raster of poly_, possibly outdated
+  mutable Raster raster_;
 };  // class Polygon
 
 }  // namespace nav2_collision_monitor
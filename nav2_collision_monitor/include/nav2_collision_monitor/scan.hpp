@@ -76,6 +76,17 @@ public:
     std::vector<Point> & data);
 
 protected:
+  /**
+   * @brief Transforms the valid ranges of a scan and adds them to the data array
+   * @param scan Laser scan to convert
+   * @param tf_transform Source frame to base frame transform
+   * @param data Array where the points are to be added
+   */
+  void convertData(
+    const sensor_msgs::msg::LaserScan & scan,
+    const tf2::Transform & tf_transform,
+    std::vector<Point> & data) const;
+
   /**
    * @brief Laser scanner data callback
    * @param msg Shared pointer to LaserScan message
@@ -0,0 +1,98 @@
+// Copyright (c) 2022 Samsung R&D Institute Russia
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef NAV2_COLLISION_MONITOR__SMOOTHED_COLLISION_MONITOR_NODE_HPP_
+#define NAV2_COLLISION_MONITOR__SMOOTHED_COLLISION_MONITOR_NODE_HPP_
+
+#include "nav2_velocity_smoother/command_smoother.hpp"
+
+#include "nav2_collision_monitor/collision_monitor_node.hpp"
+
+namespace nav2_collision_monitor
+{
+
+/**
+ * @brief Collision Monitor ROS2 node smoothing the input cmd_vel first, as the velocity
+ * smoother would. Both stages run in the same callback, without a topic between them.
+ */
+class SmoothedCollisionMonitor : public CollisionMonitor
+{
+public:
+  /**
+   * @brief Constructor for the nav2_collision_monitor::SmoothedCollisionMonitor
+   * @param options Additional options to control creation of the node.
+   */
+  explicit SmoothedCollisionMonitor(const rclcpp::NodeOptions & options = rclcpp::NodeOptions());
+  /**
+   * @brief Destructor for the nav2_collision_monitor::SmoothedCollisionMonitor
+   */
+  ~SmoothedCollisionMonitor();
+
+protected:
+  /**
+   * @brief: Configures the Collision Monitor, then the velocity smoothing
+   * from the "velocity_smoother." parameters
+   * @param state Lifecycle Node's state
+   * @return Success or Failure
+   */
+  nav2_util::CallbackReturn on_configure(const rclcpp_lifecycle::State & state) override;
+  /**
+   * @brief: Activates the Collision Monitor and the smoothing timer
+   * @param state Lifecycle Node's state
+   * @return Success or Failure
+   */
+  nav2_util::CallbackReturn on_activate(const rclcpp_lifecycle::State & state) override;
+  /**
+   * @brief: Stops the smoothing timer and deactivates the Collision Monitor
+   * @param state Lifecycle Node's state
+   * @return Success or Failure
+   */
+  nav2_util::CallbackReturn on_deactivate(const rclcpp_lifecycle::State & state) override;
+  /**
+   * @brief: Resets the velocity smoothing and the Collision Monitor
+   * @param state Lifecycle Node's state
+   * @return Success or Failure
+   */
+  nav2_util::CallbackReturn on_cleanup(const rclcpp_lifecycle::State & state) override;
+
+  /**
+   * @brief Callback for input cmd_vel, smoothing and processing it right away
+   * @param msg Input cmd_vel message
+   */
+  void cmdVelInCallbackStamped(geometry_msgs::msg::TwistStamped::SharedPtr msg) override;
+
+  /**
+   * @brief Smoothing timer, ramping the velocity down once input cmd_vel time out.
+   * Only smooths when no cmd_vel was smoothed for a smoothing period.
+   */
+  void smootherTimer();
+
+  /**
+   * @brief Smooths the last input cmd_vel and processes the smoothed one
+   */
+  void smoothAndProcess();
+
+  // ----- Variables -----
+
+  /// @brief Velocity smoothing of the input cmd_vel
+  nav2_velocity_smoother::CommandSmoother smoother_;
+  /// @brief Smoothing timer
+  rclcpp::TimerBase::SharedPtr smoother_timer_;
+  /// @brief Time of the last cmd_vel smoothed
+  rclcpp::Time last_smoothing_time_;
+};  // class SmoothedCollisionMonitor
+
+}  // namespace nav2_collision_monitor
+
+#endif  // NAV2_COLLISION_MONITOR__SMOOTHED_COLLISION_MONITOR_NODE_HPP_
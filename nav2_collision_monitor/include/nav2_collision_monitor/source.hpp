@@ -15,7 +15,10 @@
 #ifndef NAV2_COLLISION_MONITOR__SOURCE_HPP_
 #define NAV2_COLLISION_MONITOR__SOURCE_HPP_
 
+#include <array>
+#include <functional>
 #include <memory>
+#include <mutex>
 #include <vector>
 #include <string>
 
@@ -25,6 +28,7 @@
 #include "tf2_ros/buffer.h"
 
 #include "nav2_collision_monitor/types.hpp"
+#include "nav2_collision_monitor/transform_cache.hpp"
 #include "nav2_util/lifecycle_node.hpp"
 #include "std_msgs/msg/header.hpp"
 
@@ -75,6 +79,21 @@ public:
     const rclcpp::Time & curr_time,
     std::vector<Point> & data) = 0;
 
+  /**
+   * @brief Sets whether the data is transformed into base frame as it arrives.
+   * getData() then only copies the latest transformed points, so that its time does not
+   * depend on the transforms or the size of the raw data. The base frame movement since
+   * the data time is not corrected.
+   * @param convert_on_arrival Whether to convert the data in the source callback
+   */
+  void setConvertOnArrival(bool convert_on_arrival);
+
+  /**
+   * @brief Sets the cache of the transforms of the current cycle, shared with other sources
+   * @param transform_cache Transform cache, or nullptr to look each transform up
+   */
+  void setTransformCache(const std::shared_ptr<TransformCache> & transform_cache);
+
   /**
    * @brief Obtains source enabled state
    * @return Whether source is enabled
@@ -138,6 +157,37 @@ protected:
     const std_msgs::msg::Header & data_header,
     tf2::Transform & tf_transform) const;
 
+  /**
+   * @brief Looks up the transform of getTransform(), bypassing the transform cache
+   * @param curr_time Current node time
+   * @param data_header Current header  which contains the frame_id and the stamp
+   * @param tf_transform Output source->base_frame_id_ transform
+   * @return True if got correct transform, otherwise false
+   */
+  bool lookupTransform(
+    const rclcpp::Time & curr_time,
+    const std_msgs::msg::Header & data_header,
+    tf2::Transform & tf_transform) const;
+
+  /**
+   * @brief Transforms newly arrived data into the back point store, then makes it the
+   * latest one. Points are in base frame at the data time.
+   * @param data_header Header of the arrived data
+   * @param convert Fills the points array with the data transformed by the given transform,
+   * returning false if the data is invalid
+   */
+  void storeData(
+    const std_msgs::msg::Header & data_header,
+    const std::function<bool(const tf2::Transform &, std::vector<Point> &)> & convert);
+
+  /**
+   * @brief Adds the points of the latest point store to the data array
+   * @param curr_time Current node time for source verification
+   * @param data Array where the points are to be added
+   * @return false if no valid recent data was stored
+   */
+  bool getStoredData(const rclcpp::Time & curr_time, std::vector<Point> & data);
+
   // ----- Variables -----
 
   /// @brief Collision Monitor node
@@ -167,6 +217,26 @@ protected:
   bool base_shift_correction_;
   /// @brief Whether source is enabled
   bool enabled_;
+  /// @brief Transforms of the current cycle shared between sources, if any
+  std::shared_ptr<TransformCache> transform_cache_;
+
+  /**
+   * @brief Points of a data message, in base frame
+   */
+  struct PointStore
+  {
+    std::vector<Point> points;
+    rclcpp::Time stamp;
+    bool valid{false};
+  };
+  /// @brief Whether the data is transformed into base frame as it arrives
+  bool convert_on_arrival_{false};
+  /// @brief Double buffered point stores, the callback filling the back one
+  std::array<PointStore, 2> point_stores_;
+  /// @brief Index of the latest point store, swapped and read under point_stores_mutex_
+  int latest_store_{-1};
+  /// @brief Guards the latest point store against it being swapped while read
+  std::mutex point_stores_mutex_;
 };  // class Source
 
 }  // namespace nav2_collision_monitor
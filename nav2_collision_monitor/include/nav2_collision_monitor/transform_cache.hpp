@@ -0,0 +1,86 @@
+// Copyright (c) 2022 Samsung R&D Institute Russia
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef NAV2_COLLISION_MONITOR__TRANSFORM_CACHE_HPP_
+#define NAV2_COLLISION_MONITOR__TRANSFORM_CACHE_HPP_
+
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "rclcpp/rclcpp.hpp"
+#include "tf2/LinearMath/Transform.h"
+
+namespace nav2_collision_monitor
+{
+
+/**
+ * @brief Source frame to base frame transforms looked up during one processing cycle,
+ * shared by the sources so that each transform is looked up once per cycle however
+ * many sources have data in the same frame and at the same time
+ */
+class TransformCache
+{
+public:
+  /**
+   * @brief Drops the transforms of the previous cycle
+   * @param curr_time Current node time of the new cycle
+   */
+  void reset(const rclcpp::Time & curr_time);
+
+  /**
+   * @brief Obtains a transform, looking it up only if not yet looked up in this cycle.
+   * Transforms to other times than the cycle time are not cached.
+   * @param source_frame Frame of the source data
+   * @param source_time Time of the source data, ignored if the transform is not shifted in time
+   * @param curr_time Time of the transform to the base frame
+   * @param base_shift_correction Whether the transform goes from the source time to curr_time
+   * @param lookup Looks the transform up, returning false on failure
+   * @param tf_transform Output source->base frame transform
+   * @return True if got correct transform, otherwise false
+   */
+  bool getTransform(
+    const std::string & source_frame,
+    const rclcpp::Time & source_time,
+    const rclcpp::Time & curr_time,
+    bool base_shift_correction,
+    const std::function<bool(tf2::Transform &)> & lookup,
+    tf2::Transform & tf_transform);
+
+protected:
+  /**
+   * @brief A looked up transform and its key
+   */
+  struct Entry
+  {
+    std::string source_frame;
+    int64_t source_time;
+    bool base_shift_correction;
+    bool valid;
+    tf2::Transform transform;
+  };
+
+  /// @brief Current time of the cycle in nanoseconds, -1 before the first cycle
+  int64_t cycle_time_{-1};
+  /// @brief Transforms of the cycle, few enough for a linear search
+  std::vector<Entry> entries_;
+  /// @brief Guards the entries, the sources being processed in parallel
+  std::mutex mutex_;
+};  // class TransformCache
+
+}  // namespace nav2_collision_monitor
+
+#endif  // NAV2_COLLISION_MONITOR__TRANSFORM_CACHE_HPP_
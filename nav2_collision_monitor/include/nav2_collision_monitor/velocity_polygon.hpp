@@ -100,6 +100,13 @@ protected:
    */
   bool isInRange(const Velocity & cmd_vel_in, const SubPolygonParameter & sub_polygon_param);
 
+  /**
+   * @brief Sets the points of a sub-polygon as the polygon points,
+   * with the raster cached for that sub-polygon
+   * @param index Index of the sub-polygon in sub_polygons_
+   */
+  void setSubPolygon(size_t index);
+
   // Clock
   rclcpp::Clock::SharedPtr clock_;
 
@@ -108,6 +115,10 @@ protected:
   bool holonomic_;
   /// @brief Vector to store the parameters of the sub-polygon
   std::vector<SubPolygonParameter> sub_polygons_;
+  /// @brief Rasters of the sub-polygons, but the current one's being in raster_
+  std::vector<Raster> sub_rasters_;
+  /// @brief Index of the sub-polygon in poly_, -1 if none yet
+  int current_sub_polygon_{-1};
 };  // class VelocityPolygon
 
 }  // namespace nav2_collision_monitor
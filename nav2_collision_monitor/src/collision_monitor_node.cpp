@@ -14,6 +14,7 @@
 
 #include "nav2_collision_monitor/collision_monitor_node.hpp"
 
+#include <chrono>
 #include <exception>
 #include <utility>
 #include <functional>
@@ -22,6 +23,7 @@
 
 #include "nav2_util/node_utils.hpp"
 #include "nav2_util/robot_utils.hpp"
+#include "nav2_util/tracing.hpp"
 
 #include "nav2_collision_monitor/kinematics.hpp"
 
@@ -31,7 +33,8 @@ namespace nav2_collision_monitor
 CollisionMonitor::CollisionMonitor(const rclcpp::NodeOptions & options)
 : nav2_util::LifecycleNode("collision_monitor", "", options),
   process_active_(false), robot_action_prev_{DO_NOTHING, {-1.0, -1.0, -1.0}, ""},
-  stop_stamp_{0, 0, get_clock()->get_clock_type()}, stop_pub_timeout_(1.0, 0.0)
+  max_process_latency_(0.0), stop_stamp_{0, 0, get_clock()->get_clock_type()},
+  stop_pub_timeout_(1.0, 0.0)
 {
 }
 
@@ -78,6 +81,16 @@ CollisionMonitor::on_configure(const rclcpp_lifecycle::State & /*state*/)
       state_topic, 1);
   }
 
+  // Polygons with "none" action report their detections as the collision detector does,
+  // on the sources data already transformed for the monitor
+  nav2_util::declare_parameter_if_not_declared(
+    node, "detector_state_topic", rclcpp::ParameterValue(""));
+  const std::string detector_state_topic = get_parameter("detector_state_topic").as_string();
+  if (!detector_state_topic.empty()) {
+    detector_state_pub_ = this->create_publisher<nav2_msgs::msg::CollisionDetectorState>(
+      detector_state_topic, 1);
+  }
+
   collision_points_marker_pub_ = this->create_publisher<visualization_msgs::msg::MarkerArray>(
     "~/collision_points_marker", 1);
 
@@ -107,6 +120,9 @@ CollisionMonitor::on_activate(const rclcpp_lifecycle::State & /*state*/)
   if (state_pub_) {
     state_pub_->on_activate();
   }
+  if (detector_state_pub_) {
+    detector_state_pub_->on_activate();
+  }
   collision_points_marker_pub_->on_activate();
 
   // Activating polygons
@@ -119,6 +135,7 @@ CollisionMonitor::on_activate(const rclcpp_lifecycle::State & /*state*/)
   publishPolygons();
 
   // Activating main worker
+  max_process_latency_ = 0.0;
   process_active_ = true;
 
   // Creating bond connection
@@ -134,6 +151,8 @@ CollisionMonitor::on_deactivate(const rclcpp_lifecycle::State & /*state*/)
 
   // Deactivating main worker
   process_active_ = false;
+  RCLCPP_INFO(
+    get_logger(), "Worst-case cmd_vel processing latency: %f ms", max_process_latency_ * 1e3);
 
   // Reset action type to default after worker deactivating
   robot_action_prev_ = {DO_NOTHING, {-1.0, -1.0, -1.0}, ""};
@@ -148,6 +167,9 @@ CollisionMonitor::on_deactivate(const rclcpp_lifecycle::State & /*state*/)
   if (state_pub_) {
     state_pub_->on_deactivate();
   }
+  if (detector_state_pub_) {
+    detector_state_pub_->on_deactivate();
+  }
   collision_points_marker_pub_->on_deactivate();
 
   // Destroying bond connection
@@ -164,10 +186,13 @@ CollisionMonitor::on_cleanup(const rclcpp_lifecycle::State & /*state*/)
   cmd_vel_in_sub_.reset();
   cmd_vel_out_pub_.reset();
   state_pub_.reset();
+  detector_state_pub_.reset();
   collision_points_marker_pub_.reset();
 
   polygons_.clear();
   sources_.clear();
+  source_pool_.reset();
+  transform_cache_.reset();
 
   tf_listener_.reset();
   tf_buffer_.reset();
@@ -281,6 +306,28 @@ bool CollisionMonitor::getParameters(
     return false;
   }
 
+  // Transform the sources data as it arrives, rather than on each cmd_vel message
+  nav2_util::declare_parameter_if_not_declared(
+    node, "convert_on_arrival", rclcpp::ParameterValue(false));
+  const bool convert_on_arrival = get_parameter("convert_on_arrival").as_bool();
+  // Sources in the same frame share their transforms of a cmd_vel message
+  transform_cache_ = std::make_shared<TransformCache>();
+  for (std::shared_ptr<Source> source : sources_) {
+    source->setConvertOnArrival(convert_on_arrival);
+    source->setTransformCache(transform_cache_);
+  }
+
+  // Sources with heavy data to convert may be got in parallel
+  nav2_util::declare_parameter_if_not_declared(
+    node, "source_threads", rclcpp::ParameterValue(1));
+  const int source_threads = get_parameter("source_threads").as_int();
+  source_pool_.reset();
+  if (source_threads > 1 && sources_.size() > 1) {
+    // The calling thread gets source data as well
+    source_pool_ = std::make_unique<nav2_util::ThreadPool>(
+      static_cast<unsigned int>(source_threads - 1));
+  }
+
   return true;
 }
 
@@ -403,8 +450,10 @@ bool CollisionMonitor::configureSources(
 
 void CollisionMonitor::process(const Velocity & cmd_vel_in, const std_msgs::msg::Header & header)
 {
+  NAV2_TRACE_SCOPE_ID("collision_monitor.process", rclcpp::Time(header.stamp).nanoseconds());
   // Current timestamp for all inner routines prolongation
   rclcpp::Time curr_time = this->now();
+  const auto process_start = std::chrono::steady_clock::now();
 
   // Do nothing if main worker in non-active state
   if (!process_active_) {
@@ -412,7 +461,8 @@ void CollisionMonitor::process(const Velocity & cmd_vel_in, const std_msgs::msg:
   }
 
   // Points array collected from different data sources in a robot base frame
-  std::vector<Point> collision_points;
+  std::vector<Point> & collision_points = collision_points_;
+  collision_points.clear();
 
   // By default - there is no action
   Action robot_action{DO_NOTHING, cmd_vel_in, ""};
@@ -420,11 +470,33 @@ void CollisionMonitor::process(const Velocity & cmd_vel_in, const std_msgs::msg:
   std::shared_ptr<Polygon> action_polygon;
 
   // Fill collision_points array from different data sources
-  for (std::shared_ptr<Source> source : sources_) {
+  transform_cache_->reset(curr_time);
+  if (source_pool_) {
+    source_points_.resize(sources_.size());
+    source_valid_.assign(sources_.size(), 1);
+    source_pool_->parallelFor(
+      0, sources_.size(), [&](size_t i) {
+        source_points_[i].clear();
+        if (sources_[i]->getEnabled()) {
+          source_valid_[i] = sources_[i]->getData(curr_time, source_points_[i]) ||
+          sources_[i]->getSourceTimeout().seconds() == 0.0;
+        }
+      });
+  }
+  for (size_t i = 0; i < sources_.size(); i++) {
+    std::shared_ptr<Source> source = sources_[i];
     if (source->getEnabled()) {
-      if (!source->getData(curr_time, collision_points) &&
-        source->getSourceTimeout().seconds() != 0.0)
-      {
+      bool valid;
+      if (source_pool_) {
+        // Points in the order of the sources, as if got sequentially
+        collision_points.insert(
+          collision_points.end(), source_points_[i].begin(), source_points_[i].end());
+        valid = source_valid_[i];
+      } else {
+        valid = source->getData(curr_time, collision_points) ||
+          source->getSourceTimeout().seconds() == 0.0;
+      }
+      if (!valid) {
         action_polygon = nullptr;
         robot_action.polygon_name = "invalid source";
         robot_action.action_type = STOP;
@@ -490,6 +562,10 @@ void CollisionMonitor::process(const Velocity & cmd_vel_in, const std_msgs::msg:
     }
   }
 
+  if (detector_state_pub_) {
+    publishDetectorState(collision_points, cmd_vel_in);
+  }
+
   if (robot_action.polygon_name != robot_action_prev_.polygon_name) {
     // Report changed robot behavior
     notifyActionState(robot_action, action_polygon);
@@ -502,6 +578,14 @@ void CollisionMonitor::process(const Velocity & cmd_vel_in, const std_msgs::msg:
   publishPolygons();
 
   robot_action_prev_ = robot_action;
+
+  const double latency =
+    std::chrono::duration<double>(std::chrono::steady_clock::now() - process_start).count();
+  if (latency > max_process_latency_) {
+    max_process_latency_ = latency;
+    RCLCPP_DEBUG(
+      get_logger(), "New worst-case cmd_vel processing latency: %f ms", latency * 1e3);
+  }
 }
 
 bool CollisionMonitor::processStopSlowdownLimit(
@@ -636,6 +720,26 @@ void CollisionMonitor::notifyActionState(
   }
 }
 
+void CollisionMonitor::publishDetectorState(
+  const std::vector<Point> & collision_points, const Velocity & velocity)
+{
+  std::unique_ptr<nav2_msgs::msg::CollisionDetectorState> state_msg =
+    std::make_unique<nav2_msgs::msg::CollisionDetectorState>();
+
+  for (std::shared_ptr<Polygon> polygon : polygons_) {
+    if (!polygon->getEnabled() || polygon->getActionType() != DO_NOTHING) {
+      continue;
+    }
+    // Not updated by the actions processing if a previous polygon stopped the robot
+    polygon->updatePolygon(velocity);
+    state_msg->polygons.push_back(polygon->getName());
+    state_msg->detections.push_back(
+      polygon->getPointsInside(collision_points) >= polygon->getMinPoints());
+  }
+
+  detector_state_pub_->publish(std::move(state_msg));
+}
+
 void CollisionMonitor::publishPolygons() const
 {
   for (std::shared_ptr<Polygon> polygon : polygons_) {
@@ -14,9 +14,13 @@
 
 #include "nav2_collision_monitor/pointcloud.hpp"
 
+#include <algorithm>
+#include <cmath>
+#include <cstring>
 #include <functional>
+#include <stdexcept>
 
-#include "sensor_msgs/point_cloud2_iterator.hpp"
+#include "sensor_msgs/msg/point_field.hpp"
 #include "tf2/transform_datatypes.h"
 
 #include "nav2_util/node_utils.hpp"
@@ -70,6 +74,10 @@ bool PointCloud::getData(
   const rclcpp::Time & curr_time,
   std::vector<Point> & data)
 {
+  if (convert_on_arrival_) {
+    return getStoredData(curr_time, data);
+  }
+
   // Ignore data from the source if it is not being published yet or
   // not published for a long time
   if (data_ == nullptr) {
@@ -84,20 +92,95 @@ bool PointCloud::getData(
     return false;
   }
 
-  sensor_msgs::PointCloud2ConstIterator<float> iter_x(*data_, "x");
-  sensor_msgs::PointCloud2ConstIterator<float> iter_y(*data_, "y");
-  sensor_msgs::PointCloud2ConstIterator<float> iter_z(*data_, "z");
+  return convertData(*data_, tf_transform, data);
+}
+
+bool PointCloud::convertData(
+  const sensor_msgs::msg::PointCloud2 & cloud,
+  const tf2::Transform & tf_transform,
+  std::vector<Point> & data)
+{
+  // Coordinates are read at their offsets in each point
+  int offset_x = -1, offset_y = -1, offset_z = -1;
+  for (const auto & field : cloud.fields) {
+    if (field.datatype != sensor_msgs::msg::PointField::FLOAT32) {
+      continue;
+    }
+    if (field.name == "x") {
+      offset_x = field.offset;
+    } else if (field.name == "y") {
+      offset_y = field.offset;
+    } else if (field.name == "z") {
+      offset_z = field.offset;
+    }
+  }
+  if (offset_x < 0 || offset_y < 0 || offset_z < 0) {
+    RCLCPP_WARN(
+      logger_, "[%s]: PointCloud has no float x, y and z fields. Ignoring the source.",
+      source_name_.c_str());
+    return false;
+  }
+
+  // Box in source frame bounding the crop box, to skip most points before transforming them
+  const bool crop = crop_box_.size() == 4;
+  tf2::Vector3 source_min, source_max;
+  if (crop) {
+    const tf2::Transform tf_inverse = tf_transform.inverse();
+    for (int i = 0; i < 8; i++) {
+      const tf2::Vector3 corner = tf_inverse * tf2::Vector3(
+        crop_box_[(i & 1) ? 2 : 0], crop_box_[(i & 2) ? 3 : 1],
+        (i & 4) ? max_height_ : min_height_);
+      if (i == 0) {
+        source_min = corner;
+        source_max = corner;
+      } else {
+        source_min.setMin(corner);
+        source_max.setMax(corner);
+      }
+    }
+  }
 
   // Refill data array with PointCloud points in base frame
-  for (; iter_x != iter_x.end(); ++iter_x, ++iter_y, ++iter_z) {
+  voxels_.clear();
+  const size_t points_count = static_cast<size_t>(cloud.width) * cloud.height;
+  for (size_t i = 0; i < points_count; i += point_stride_) {
+    const uint8_t * point =
+      &cloud.data[(i / cloud.width) * cloud.row_step + (i % cloud.width) * cloud.point_step];
+    float x, y, z;
+    std::memcpy(&x, point + offset_x, sizeof(float));
+    std::memcpy(&y, point + offset_y, sizeof(float));
+    std::memcpy(&z, point + offset_z, sizeof(float));
+    if (crop &&
+      (x < source_min.x() || x > source_max.x() || y < source_min.y() || y > source_max.y() ||
+      z < source_min.z() || z > source_max.z()))
+    {
+      continue;
+    }
+
     // Transform point coordinates from source frame -> to base frame
-    tf2::Vector3 p_v3_s(*iter_x, *iter_y, *iter_z);
+    tf2::Vector3 p_v3_s(x, y, z);
     tf2::Vector3 p_v3_b = tf_transform * p_v3_s;
+    if (!(p_v3_b.z() >= min_height_ && p_v3_b.z() <= max_height_)) {
+      continue;
+    }
+    if (crop &&
+      (p_v3_b.x() < crop_box_[0] || p_v3_b.y() < crop_box_[1] ||
+      p_v3_b.x() > crop_box_[2] || p_v3_b.y() > crop_box_[3]))
+    {
+      continue;
+    }
 
-    // Refill data array
-    if (p_v3_b.z() >= min_height_ && p_v3_b.z() <= max_height_) {
-      data.push_back({p_v3_b.x(), p_v3_b.y()});
+    // Keep the first point of each voxel
+    if (voxel_resolution_ > 0.0) {
+      const int64_t voxel_x = static_cast<int64_t>(std::floor(p_v3_b.x() / voxel_resolution_));
+      const int64_t voxel_y = static_cast<int64_t>(std::floor(p_v3_b.y() / voxel_resolution_));
+      if (!voxels_.insert((voxel_x << 32) ^ (voxel_y & 0xffffffff)).second) {
+        continue;
+      }
     }
+
+    // Refill data array
+    data.push_back({p_v3_b.x(), p_v3_b.y()});
   }
   return true;
 }
@@ -117,11 +200,31 @@ void PointCloud::getParameters(std::string & source_topic)
   nav2_util::declare_parameter_if_not_declared(
     node, source_name_ + ".max_height", rclcpp::ParameterValue(0.5));
   max_height_ = node->get_parameter(source_name_ + ".max_height").as_double();
+
+  nav2_util::declare_parameter_if_not_declared(
+    node, source_name_ + ".crop_box", rclcpp::ParameterValue(std::vector<double>()));
+  crop_box_ = node->get_parameter(source_name_ + ".crop_box").as_double_array();
+  if (!crop_box_.empty() && crop_box_.size() != 4) {
+    throw std::runtime_error{
+            "[" + source_name_ + "]: crop_box should be [min_x, min_y, max_x, max_y]"};
+  }
+  nav2_util::declare_parameter_if_not_declared(
+    node, source_name_ + ".point_stride", rclcpp::ParameterValue(1));
+  point_stride_ = std::max(node->get_parameter(source_name_ + ".point_stride").as_int(), int64_t{1});
+  nav2_util::declare_parameter_if_not_declared(
+    node, source_name_ + ".voxel_resolution", rclcpp::ParameterValue(0.0));
+  voxel_resolution_ = node->get_parameter(source_name_ + ".voxel_resolution").as_double();
 }
 
 void PointCloud::dataCallback(sensor_msgs::msg::PointCloud2::ConstSharedPtr msg)
 {
   data_ = msg;
+  if (convert_on_arrival_) {
+    storeData(
+      msg->header, [this, &msg](const tf2::Transform & tf_transform, std::vector<Point> & data) {
+        return convertData(*msg, tf_transform, data);
+      });
+  }
 }
 
 }  // namespace nav2_collision_monitor
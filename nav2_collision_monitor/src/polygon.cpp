@@ -14,6 +14,8 @@
 
 #include "nav2_collision_monitor/polygon.hpp"
 
+#include <algorithm>
+#include <cmath>
 #include <exception>
 #include <utility>
 
@@ -21,6 +23,7 @@
 #include "geometry_msgs/msg/point32.hpp"
 #include "tf2/transform_datatypes.h"
 
+#include "nav2_util/geometry_utils.hpp"
 #include "nav2_util/node_utils.hpp"
 #include "nav2_util/robot_utils.hpp"
 #include "nav2_util/array_parser.hpp"
@@ -30,6 +33,13 @@
 namespace nav2_collision_monitor
 {
 
+// Raster cell states
+static constexpr uint8_t RASTER_OUTSIDE = 0;
+static constexpr uint8_t RASTER_INSIDE = 1;
+static constexpr uint8_t RASTER_BOUNDARY = 2;
+// Largest raster side, in cells
+static constexpr int RASTER_MAX_SIZE = 512;
+
 Polygon::Polygon(
   const nav2_util::LifecycleNode::WeakPtr & node,
   const std::string & polygon_name,
@@ -39,7 +49,8 @@ Polygon::Polygon(
 : node_(node), polygon_name_(polygon_name), action_type_(DO_NOTHING),
   slowdown_ratio_(0.0), linear_limit_(0.0), angular_limit_(0.0),
   footprint_sub_(nullptr), tf_buffer_(tf_buffer),
-  base_frame_id_(base_frame_id), transform_tolerance_(transform_tolerance)
+  base_frame_id_(base_frame_id), transform_tolerance_(transform_tolerance),
+  raster_resolution_(0.0)
 {
   RCLCPP_INFO(logger_, "[%s]: Creating Polygon", polygon_name_.c_str());
 }
@@ -221,42 +232,174 @@ void Polygon::updatePolygon(const Velocity & /*cmd_vel_in*/)
 int Polygon::getPointsInside(const std::vector<Point> & points) const
 {
   int num = 0;
+  if (raster_resolution_ <= 0.0 || poly_.size() < 3) {
+    for (const Point & point : points) {
+      if (isPointInside(point)) {
+        num++;
+      }
+    }
+    return num;
+  }
+
+  const bool raster_current = raster_.poly.size() == poly_.size() &&
+    std::equal(
+    poly_.begin(), poly_.end(), raster_.poly.begin(),
+    [](const Point & a, const Point & b) {return a.x == b.x && a.y == b.y;});
+  if (!raster_current) {
+    rasterize();
+  }
+
+  const double inv_cell_size = 1.0 / raster_.cell_size;
   for (const Point & point : points) {
-    if (isPointInside(point)) {
+    const double gx = (point.x - raster_.origin_x) * inv_cell_size;
+    const double gy = (point.y - raster_.origin_y) * inv_cell_size;
+    // Out of the bounding box (or NaN): outside
+    if (!(gx >= 0.0 && gy >= 0.0 && gx < raster_.size_x && gy < raster_.size_y)) {
+      continue;
+    }
+    const uint8_t cell =
+      raster_.cells[static_cast<int>(gy) * raster_.size_x + static_cast<int>(gx)];
+    if (cell == RASTER_INSIDE || (cell == RASTER_BOUNDARY && isPointInside(point))) {
       num++;
     }
   }
   return num;
 }
 
+void Polygon::rasterize() const
+{
+  raster_.poly = poly_;
+
+  double min_x = poly_[0].x, max_x = poly_[0].x;
+  double min_y = poly_[0].y, max_y = poly_[0].y;
+  for (const Point & p : poly_) {
+    min_x = std::min(min_x, p.x);
+    max_x = std::max(max_x, p.x);
+    min_y = std::min(min_y, p.y);
+    max_y = std::max(max_y, p.y);
+  }
+
+  // A margin cell around the bounding box, so that any point off the raster is outside
+  const double extent = std::max(max_x - min_x, max_y - min_y);
+  raster_.cell_size = std::max(raster_resolution_, extent / (RASTER_MAX_SIZE - 3));
+  raster_.origin_x = min_x - raster_.cell_size;
+  raster_.origin_y = min_y - raster_.cell_size;
+  raster_.size_x = static_cast<int>(std::ceil((max_x - min_x) / raster_.cell_size)) + 3;
+  raster_.size_y = static_cast<int>(std::ceil((max_y - min_y) / raster_.cell_size)) + 3;
+  raster_.cells.assign(static_cast<size_t>(raster_.size_x) * raster_.size_y, RASTER_OUTSIDE);
+
+  // Boundary cells: the cells touched by each edge, with a margin against rounding
+  const double margin = 1e-6 * raster_.cell_size;
+  const int poly_size = poly_.size();
+  for (int i = poly_size - 1, j = 0; j < poly_size; i = j++) {
+    const Point & a = poly_[i];
+    const Point & b = poly_[j];
+    const int row_min = static_cast<int>(
+      (std::min(a.y, b.y) - margin - raster_.origin_y) / raster_.cell_size);
+    const int row_max = static_cast<int>(
+      (std::max(a.y, b.y) + margin - raster_.origin_y) / raster_.cell_size);
+    for (int row = row_min; row <= row_max; row++) {
+      // Part of the edge within the row
+      double x_lo = std::min(a.x, b.x), x_hi = std::max(a.x, b.x);
+      if (a.y != b.y) {
+        const double y_lo = std::max(
+          std::min(a.y, b.y), raster_.origin_y + row * raster_.cell_size - margin);
+        const double y_hi = std::min(
+          std::max(a.y, b.y), raster_.origin_y + (row + 1) * raster_.cell_size + margin);
+        const double x_at_lo = a.x + (y_lo - a.y) * (b.x - a.x) / (b.y - a.y);
+        const double x_at_hi = a.x + (y_hi - a.y) * (b.x - a.x) / (b.y - a.y);
+        x_lo = std::min(x_at_lo, x_at_hi);
+        x_hi = std::max(x_at_lo, x_at_hi);
+      }
+      const int col_min = std::max(
+        static_cast<int>((x_lo - margin - raster_.origin_x) / raster_.cell_size), 0);
+      const int col_max = std::min(
+        static_cast<int>((x_hi + margin - raster_.origin_x) / raster_.cell_size),
+        raster_.size_x - 1);
+      std::fill(
+        raster_.cells.begin() + row * raster_.size_x + col_min,
+        raster_.cells.begin() + row * raster_.size_x + col_max + 1, RASTER_BOUNDARY);
+    }
+  }
+
+  // Other cells are wholly inside or outside, as their center is
+  for (int row = 0; row < raster_.size_y; row++) {
+    const double y = raster_.origin_y + (row + 0.5) * raster_.cell_size;
+    for (int col = 0; col < raster_.size_x; col++) {
+      uint8_t & cell = raster_.cells[row * raster_.size_x + col];
+      if (cell != RASTER_BOUNDARY &&
+        isPointInside({raster_.origin_x + (col + 0.5) * raster_.cell_size, y}))
+      {
+        cell = RASTER_INSIDE;
+      }
+    }
+  }
+}
+
 double Polygon::getCollisionTime(
   const std::vector<Point> & collision_points,
   const Velocity & velocity) const
 {
   // Initial robot pose is {0,0} in base_footprint coordinates
-  Pose pose = {0.0, 0.0, 0.0};
-  Velocity vel = velocity;
-
-  // Array of points transformed to the frame concerned with pose on each simulation step
-  std::vector<Point> points_transformed = collision_points;
+  const geometry_msgs::msg::Pose2D start_pose;
 
   // Check static polygon
-  if (getPointsInside(points_transformed) >= min_points_) {
+  if (getPointsInside(collision_points) >= min_points_) {
     return 0.0;
   }
 
   // Robot movement simulation
+  std::vector<std::pair<double, Pose>> simulated_poses;
   for (double time = 0.0; time <= time_before_collision_; time += simulation_time_step_) {
-    // Shift the robot pose towards to the vel during simulation_time_step_ time interval
-    // NOTE: vel is changing during the simulation
-    projectState(simulation_time_step_, pose, vel);
+    // Robot pose after moving with vel for a simulation_time_step_ more, along its arc
+    const geometry_msgs::msg::Pose2D pose = nav2_util::geometry_utils::projectTwist(
+      start_pose, velocity.x, velocity.y, velocity.tw, time + simulation_time_step_);
+    simulated_poses.emplace_back(time, Pose{pose.x, pose.y, pose.theta});
+  }
+  std::vector<Point> vertices;
+  getPolygon(vertices);
+  if (simulated_poses.empty() || vertices.empty()) {
+    return -1.0;
+  }
+
+  // The shape lies within the circle of its farthest vertex around the robot origin, so
+  // only the points this close to the simulated robot positions may ever be inside of it
+  double radius = 0.0;
+  for (const Point & vertex : vertices) {
+    radius = std::max(radius, std::hypot(vertex.x, vertex.y));
+  }
+  radius += 1e-6;  // against rounding
+  double min_x = simulated_poses[0].second.x, max_x = min_x;
+  double min_y = simulated_poses[0].second.y, max_y = min_y;
+  for (const auto & simulated_pose : simulated_poses) {
+    min_x = std::min(min_x, simulated_pose.second.x);
+    max_x = std::max(max_x, simulated_pose.second.x);
+    min_y = std::min(min_y, simulated_pose.second.y);
+    max_y = std::max(max_y, simulated_pose.second.y);
+  }
+  std::vector<Point> reachable_points;
+  for (const Point & point : collision_points) {
+    if (point.x >= min_x - radius && point.x <= max_x + radius &&
+      point.y >= min_y - radius && point.y <= max_y + radius)
+    {
+      reachable_points.push_back(point);
+    }
+  }
+  if (static_cast<int>(reachable_points.size()) < min_points_) {
+    return -1.0;
+  }
+
+  // Array of points transformed to the frame concerned with pose on each simulation step
+  std::vector<Point> points_transformed;
+  points_transformed.reserve(reachable_points.size());
+  for (const auto & simulated_pose : simulated_poses) {
     // Transform collision_points to the frame concerned with current robot pose
-    points_transformed = collision_points;
-    transformPoints(pose, points_transformed);
+    points_transformed.assign(reachable_points.begin(), reachable_points.end());
+    transformPoints(simulated_pose.second, points_transformed);
     // If the collision occurred on this stage, return the actual time before a collision
     // as if robot was moved with given velocity
     if (getPointsInside(points_transformed) >= min_points_) {
-      return time;
+      return simulated_pose.first;
     }
   }
 
@@ -361,6 +504,10 @@ bool Polygon::getCommonParameters(
         node->get_parameter(polygon_name_ + ".simulation_time_step").as_double();
     }
 
+    nav2_util::declare_parameter_if_not_declared(
+      node, polygon_name_ + ".raster_resolution", rclcpp::ParameterValue(0.02));
+    raster_resolution_ = node->get_parameter(polygon_name_ + ".raster_resolution").as_double();
+
     nav2_util::declare_parameter_if_not_declared(
       node, polygon_name_ + ".visualize", rclcpp::ParameterValue(false));
     visualize_ = node->get_parameter(polygon_name_ + ".visualize").as_bool();
@@ -70,6 +70,10 @@ bool Scan::getData(
   const rclcpp::Time & curr_time,
   std::vector<Point> & data)
 {
+  if (convert_on_arrival_) {
+    return getStoredData(curr_time, data);
+  }
+
   // Ignore data from the source if it is not being published yet or
   // not being published for a long time
   if (data_ == nullptr) {
@@ -84,28 +88,43 @@ bool Scan::getData(
     return false;
   }
 
+  convertData(*data_, tf_transform, data);
+  return true;
+}
+
+void Scan::convertData(
+  const sensor_msgs::msg::LaserScan & scan,
+  const tf2::Transform & tf_transform,
+  std::vector<Point> & data) const
+{
   // Calculate poses and refill data array
-  float angle = data_->angle_min;
-  for (size_t i = 0; i < data_->ranges.size(); i++) {
-    if (data_->ranges[i] >= data_->range_min && data_->ranges[i] <= data_->range_max) {
+  float angle = scan.angle_min;
+  for (size_t i = 0; i < scan.ranges.size(); i++) {
+    if (scan.ranges[i] >= scan.range_min && scan.ranges[i] <= scan.range_max) {
       // Transform point coordinates from source frame -> to base frame
       tf2::Vector3 p_v3_s(
-        data_->ranges[i] * std::cos(angle),
-        data_->ranges[i] * std::sin(angle),
+        scan.ranges[i] * std::cos(angle),
+        scan.ranges[i] * std::sin(angle),
         0.0);
       tf2::Vector3 p_v3_b = tf_transform * p_v3_s;
 
       // Refill data array
       data.push_back({p_v3_b.x(), p_v3_b.y()});
     }
-    angle += data_->angle_increment;
+    angle += scan.angle_increment;
   }
-  return true;
 }
 
 void Scan::dataCallback(sensor_msgs::msg::LaserScan::ConstSharedPtr msg)
 {
   data_ = msg;
+  if (convert_on_arrival_) {
+    storeData(
+      msg->header, [this, &msg](const tf2::Transform & tf_transform, std::vector<Point> & data) {
+        convertData(*msg, tf_transform, data);
+        return true;
+      });
+  }
 }
 
 }  // namespace nav2_collision_monitor
@@ -0,0 +1,151 @@
+// Copyright (c) 2022 Samsung R&D Institute Russia
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "nav2_collision_monitor/smoothed_collision_monitor_node.hpp"
+
+#include <chrono>
+#include <memory>
+#include <stdexcept>
+#include <utility>
+
+#include "nav2_util/robot_utils.hpp"
+
+namespace nav2_collision_monitor
+{
+
+SmoothedCollisionMonitor::SmoothedCollisionMonitor(const rclcpp::NodeOptions & options)
+: CollisionMonitor(options),
+  last_smoothing_time_{0, 0, get_clock()->get_clock_type()}
+{
+}
+
+SmoothedCollisionMonitor::~SmoothedCollisionMonitor()
+{
+  if (smoother_timer_) {
+    smoother_timer_->cancel();
+    smoother_timer_.reset();
+  }
+}
+
+nav2_util::CallbackReturn
+SmoothedCollisionMonitor::on_configure(const rclcpp_lifecycle::State & state)
+{
+  const nav2_util::CallbackReturn ret = CollisionMonitor::on_configure(state);
+  if (ret != nav2_util::CallbackReturn::SUCCESS) {
+    return ret;
+  }
+
+  try {
+    smoother_.configure(shared_from_this(), "velocity_smoother.");
+  } catch (const std::runtime_error & e) {
+    RCLCPP_ERROR(get_logger(), "Failed to configure velocity smoothing: %s", e.what());
+    return nav2_util::CallbackReturn::FAILURE;
+  }
+
+  return nav2_util::CallbackReturn::SUCCESS;
+}
+
+nav2_util::CallbackReturn
+SmoothedCollisionMonitor::on_activate(const rclcpp_lifecycle::State & state)
+{
+  const nav2_util::CallbackReturn ret = CollisionMonitor::on_activate(state);
+  if (ret != nav2_util::CallbackReturn::SUCCESS) {
+    return ret;
+  }
+
+  double timer_duration_ms = 1000.0 / smoother_.getSmoothingFrequency();
+  smoother_timer_ = this->create_wall_timer(
+    std::chrono::milliseconds(static_cast<int>(timer_duration_ms)),
+    std::bind(&SmoothedCollisionMonitor::smootherTimer, this));
+
+  return nav2_util::CallbackReturn::SUCCESS;
+}
+
+nav2_util::CallbackReturn
+SmoothedCollisionMonitor::on_deactivate(const rclcpp_lifecycle::State & state)
+{
+  if (smoother_timer_) {
+    smoother_timer_->cancel();
+    smoother_timer_.reset();
+  }
+
+  return CollisionMonitor::on_deactivate(state);
+}
+
+nav2_util::CallbackReturn
+SmoothedCollisionMonitor::on_cleanup(const rclcpp_lifecycle::State & state)
+{
+  smoother_.cleanup();
+
+  return CollisionMonitor::on_cleanup(state);
+}
+
+void SmoothedCollisionMonitor::cmdVelInCallbackStamped(
+  geometry_msgs::msg::TwistStamped::SharedPtr msg)
+{
+  // If message contains NaN or Inf, ignore
+  if (!nav2_util::validateTwist(*msg)) {
+    RCLCPP_ERROR(get_logger(), "Velocity message contains NaNs or Infs! Ignoring as invalid!");
+    return;
+  }
+
+  smoother_.setCommand(std::make_unique<geometry_msgs::msg::TwistStamped>(*msg), now());
+  if (smoother_timer_) {
+    smoothAndProcess();
+  }
+}
+
+void SmoothedCollisionMonitor::smootherTimer()
+{
+  // Input cmd_vel are smoothed as they are received
+  if (last_smoothing_time_.nanoseconds() != 0 &&
+    (now() - last_smoothing_time_).seconds() < 1.0 / smoother_.getSmoothingFrequency())
+  {
+    return;
+  }
+
+  smoothAndProcess();
+}
+
+void SmoothedCollisionMonitor::smoothAndProcess()
+{
+  // Wait until the first cmd_vel is received
+  if (!smoother_.getCommand()) {
+    return;
+  }
+
+  // Bound the velocity changes for the time elapsed since the last cmd_vel smoothed
+  const rclcpp::Time smoothing_time = now();
+  double update_frequency = smoother_.getSmoothingFrequency();
+  if (last_smoothing_time_.nanoseconds() != 0) {
+    update_frequency = smoother_.getEventFrequency(smoothing_time - last_smoothing_time_);
+  }
+  last_smoothing_time_ = smoothing_time;
+
+  geometry_msgs::msg::TwistStamped cmd_vel;
+  if (smoother_.smooth(smoothing_time, update_frequency, cmd_vel)) {
+    process(
+      {cmd_vel.twist.linear.x, cmd_vel.twist.linear.y, cmd_vel.twist.angular.z},
+      cmd_vel.header);
+  }
+}
+
+}  // namespace nav2_collision_monitor
+
+#include "rclcpp_components/register_node_macro.hpp"
+
+// Register the component with class_loader.
+// This acts as a sort of entry point, allowing the component to be discoverable when its library
+// is being loaded into a running process.
+RCLCPP_COMPONENTS_REGISTER_NODE(nav2_collision_monitor::SmoothedCollisionMonitor)
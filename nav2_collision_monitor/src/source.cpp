@@ -97,6 +97,49 @@ bool Source::sourceValid(
   return true;
 }
 
+void Source::setConvertOnArrival(bool convert_on_arrival)
+{
+  convert_on_arrival_ = convert_on_arrival;
+}
+
+void Source::setTransformCache(const std::shared_ptr<TransformCache> & transform_cache)
+{
+  transform_cache_ = transform_cache;
+}
+
+void Source::storeData(
+  const std_msgs::msg::Header & data_header,
+  const std::function<bool(const tf2::Transform &, std::vector<Point> &)> & convert)
+{
+  // Only the callbacks write the back store, the readers never see it
+  PointStore & store = point_stores_[latest_store_ == 0 ? 1 : 0];
+  store.points.clear();
+  store.stamp = data_header.stamp;
+  // Base frame at the data time: the latest transforms may not reach the current time yet
+  tf2::Transform tf_transform;
+  store.valid = getTransform(store.stamp, data_header, tf_transform) &&
+    convert(tf_transform, store.points);
+
+  std::lock_guard<std::mutex> lock(point_stores_mutex_);
+  latest_store_ = latest_store_ == 0 ? 1 : 0;
+}
+
+bool Source::getStoredData(const rclcpp::Time & curr_time, std::vector<Point> & data)
+{
+  std::lock_guard<std::mutex> lock(point_stores_mutex_);
+  if (latest_store_ < 0) {
+    return false;
+  }
+  const PointStore & store = point_stores_[latest_store_];
+  if (!store.valid || !sourceValid(store.stamp, curr_time)) {
+    return false;
+  }
+
+  // No allocation once data has grown to its largest size
+  data.insert(data.end(), store.points.begin(), store.points.end());
+  return true;
+}
+
 bool Source::getEnabled() const
 {
   return enabled_;
@@ -136,6 +179,21 @@ bool Source::getTransform(
   const rclcpp::Time & curr_time,
   const std_msgs::msg::Header & data_header,
   tf2::Transform & tf_transform) const
+{
+  if (transform_cache_) {
+    return transform_cache_->getTransform(
+      data_header.frame_id, data_header.stamp, curr_time, base_shift_correction_,
+      [this, &curr_time, &data_header](tf2::Transform & transform) {
+        return lookupTransform(curr_time, data_header, transform);
+      }, tf_transform);
+  }
+  return lookupTransform(curr_time, data_header, tf_transform);
+}
+
+bool Source::lookupTransform(
+  const rclcpp::Time & curr_time,
+  const std_msgs::msg::Header & data_header,
+  tf2::Transform & tf_transform) const
 {
   if (base_shift_correction_) {
     if (
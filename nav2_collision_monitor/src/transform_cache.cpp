@@ -0,0 +1,61 @@
+// Copyright (c) 2022 Samsung R&D Institute Russia
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "nav2_collision_monitor/transform_cache.hpp"
+
+namespace nav2_collision_monitor
+{
+
+void TransformCache::reset(const rclcpp::Time & curr_time)
+{
+  std::lock_guard<std::mutex> lock(mutex_);
+  cycle_time_ = curr_time.nanoseconds();
+  entries_.clear();
+}
+
+bool TransformCache::getTransform(
+  const std::string & source_frame,
+  const rclcpp::Time & source_time,
+  const rclcpp::Time & curr_time,
+  bool base_shift_correction,
+  const std::function<bool(tf2::Transform &)> & lookup,
+  tf2::Transform & tf_transform)
+{
+  // Only the transform to a base frame in its latest state has no source time
+  const int64_t time = base_shift_correction ? source_time.nanoseconds() : 0;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (curr_time.nanoseconds() == cycle_time_) {
+      for (const Entry & entry : entries_) {
+        if (entry.source_time == time && entry.base_shift_correction == base_shift_correction &&
+          entry.source_frame == source_frame)
+        {
+          tf_transform = entry.transform;
+          return entry.valid;
+        }
+      }
+    }
+  }
+
+  // Looked up unlocked, so that sources in other frames are not waiting on this one
+  const bool valid = lookup(tf_transform);
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (curr_time.nanoseconds() == cycle_time_) {
+    entries_.push_back({source_frame, time, base_shift_correction, valid, tf_transform});
+  }
+  return valid;
+}
+
+}  // namespace nav2_collision_monitor
@@ -14,6 +14,8 @@
 
 #include "nav2_collision_monitor/velocity_polygon.hpp"
 
+#include <utility>
+
 #include "nav2_util/node_utils.hpp"
 
 namespace nav2_collision_monitor
@@ -129,6 +131,8 @@ bool VelocityPolygon::getParameters(
         theta_max, direction_end_angle, direction_start_angle};
       sub_polygons_.push_back(sub_polygon);
     }
+    sub_rasters_.resize(sub_polygons_.size());
+    current_sub_polygon_ = -1;
   } catch (const std::exception & ex) {
     RCLCPP_ERROR(
       logger_, "[%s]: Error while getting polygon parameters: %s", polygon_name_.c_str(),
@@ -140,19 +144,11 @@ bool VelocityPolygon::getParameters(
 
 void VelocityPolygon::updatePolygon(const Velocity & cmd_vel_in)
 {
-  for (auto & sub_polygon : sub_polygons_) {
-    if (isInRange(cmd_vel_in, sub_polygon)) {
-      // Set the polygon that is within the speed range
-      poly_ = sub_polygon.poly_;
-
-      // Update visualization polygon
-      polygon_.polygon.points.clear();
-      for (const Point & p : poly_) {
-        geometry_msgs::msg::Point32 p_s;
-        p_s.x = p.x;
-        p_s.y = p.y;
-        // p_s.z will remain 0.0
-        polygon_.polygon.points.push_back(p_s);
+  for (size_t i = 0; i < sub_polygons_.size(); i++) {
+    if (isInRange(cmd_vel_in, sub_polygons_[i])) {
+      // Set the polygon that is within the speed range, if not already set
+      if (static_cast<int>(i) != current_sub_polygon_) {
+        setSubPolygon(i);
       }
       return;
     }
@@ -166,6 +162,28 @@ void VelocityPolygon::updatePolygon(const Velocity & cmd_vel_in)
   return;
 }
 
+void VelocityPolygon::setSubPolygon(size_t index)
+{
+  // Keep the raster of the previous sub-polygon, and reuse the one of the new sub-polygon
+  if (current_sub_polygon_ >= 0) {
+    std::swap(raster_, sub_rasters_[current_sub_polygon_]);
+  }
+  std::swap(raster_, sub_rasters_[index]);
+  current_sub_polygon_ = static_cast<int>(index);
+
+  poly_ = sub_polygons_[index].poly_;
+
+  // Update visualization polygon
+  polygon_.polygon.points.clear();
+  for (const Point & p : poly_) {
+    geometry_msgs::msg::Point32 p_s;
+    p_s.x = p.x;
+    p_s.y = p.y;
+    // p_s.z will remain 0.0
+    polygon_.polygon.points.push_back(p_s);
+  }
+}
+
 bool VelocityPolygon::isInRange(
   const Velocity & cmd_vel_in, const SubPolygonParameter & sub_polygon)
 {
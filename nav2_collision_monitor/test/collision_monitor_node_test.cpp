@@ -38,6 +38,7 @@
 
 #include "nav2_collision_monitor/types.hpp"
 #include "nav2_collision_monitor/collision_monitor_node.hpp"
+#include "nav2_collision_monitor/smoothed_collision_monitor_node.hpp"
 
 using namespace std::chrono_literals;
 
@@ -1580,6 +1581,67 @@ TEST_F(Tester, testVelocityPolygonStop)
   cm_->stop();
 }
 
+class SmoothedCollisionMonitorWrapper : public nav2_collision_monitor::SmoothedCollisionMonitor
+{
+public:
+  void start()
+  {
+    ASSERT_EQ(on_configure(get_current_state()), nav2_util::CallbackReturn::SUCCESS);
+    ASSERT_EQ(on_activate(get_current_state()), nav2_util::CallbackReturn::SUCCESS);
+  }
+
+  void stop()
+  {
+    ASSERT_EQ(on_deactivate(get_current_state()), nav2_util::CallbackReturn::SUCCESS);
+    ASSERT_EQ(on_cleanup(get_current_state()), nav2_util::CallbackReturn::SUCCESS);
+  }
+};  // SmoothedCollisionMonitorWrapper
+
+TEST(SmoothedCollisionMonitorTest, testSmoothingBeforeProcessing)
+{
+  auto cm = std::make_shared<SmoothedCollisionMonitorWrapper>();
+  cm->declare_parameter("cmd_vel_in_topic", rclcpp::ParameterValue(CMD_VEL_IN_TOPIC));
+  cm->declare_parameter("cmd_vel_out_topic", rclcpp::ParameterValue(CMD_VEL_OUT_TOPIC));
+  cm->declare_parameter("polygons", rclcpp::ParameterValue(std::vector<std::string>{}));
+  cm->declare_parameter(
+    "observation_sources", rclcpp::ParameterValue(std::vector<std::string>{}));
+  cm->declare_parameter(
+    "velocity_smoother.max_accel", rclcpp::ParameterValue(std::vector<double>{1.0, 0.0, 1.0}));
+
+  geometry_msgs::msg::Twist::SharedPtr cmd_vel_out;
+  auto cmd_vel_in_pub = cm->create_publisher<geometry_msgs::msg::Twist>(
+    CMD_VEL_IN_TOPIC, rclcpp::QoS(rclcpp::KeepLast(1)).transient_local().reliable());
+  auto cmd_vel_out_sub = cm->create_subscription<geometry_msgs::msg::Twist>(
+    CMD_VEL_OUT_TOPIC, rclcpp::SystemDefaultsQoS(),
+    [&](geometry_msgs::msg::Twist::SharedPtr msg) {cmd_vel_out = msg;});
+
+  cm->start();
+
+  // With no polygons, the smoothed cmd_vel is published as it is:
+  // limited to the first acceleration step of 1.0 / 20 Hz
+  auto msg = std::make_unique<geometry_msgs::msg::Twist>();
+  msg->linear.x = 0.4;
+  cmd_vel_in_pub->publish(std::move(msg));
+  rclcpp::Time start_time = cm->now();
+  while (!cmd_vel_out && cm->now() - start_time <= rclcpp::Duration(500ms)) {
+    rclcpp::spin_some(cm->get_node_base_interface());
+    std::this_thread::sleep_for(10ms);
+  }
+  ASSERT_TRUE(cmd_vel_out);
+  EXPECT_GT(cmd_vel_out->linear.x, 0.0);
+  EXPECT_LE(cmd_vel_out->linear.x, 0.05 + EPSILON);
+
+  // The velocity keeps ramping up to the command, before it times out
+  start_time = cm->now();
+  while (cm->now() - start_time <= rclcpp::Duration(600ms)) {
+    rclcpp::spin_some(cm->get_node_base_interface());
+    std::this_thread::sleep_for(10ms);
+  }
+  EXPECT_NEAR(cmd_vel_out->linear.x, 0.4, EPSILON);
+
+  cm->stop();
+}
+
 int main(int argc, char ** argv)
 {
   // Initialize the system
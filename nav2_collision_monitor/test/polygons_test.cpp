@@ -200,6 +200,11 @@ public:
   {
     return visualize_;
   }
+
+  void setRasterResolution(double raster_resolution)
+  {
+    raster_resolution_ = raster_resolution;
+  }
 };  // PolygonWrapper
 
 class CircleWrapper : public nav2_collision_monitor::Circle
@@ -835,6 +840,39 @@ TEST_F(Tester, testPolygonGetPointsInsideEdge)
   ASSERT_EQ(polygon_->getPointsInside(points), 1);
 }
 
+TEST_F(Tester, testPolygonGetPointsInsideRaster)
+{
+  // The raster gives the same result as testing each point, on the edges and vertices
+  // of the polygon too
+  setCommonParameters(POLYGON_NAME, "stop");
+  setPolygonParameters(ARBITRARY_POLYGON_STR, true);
+  test_node_->declare_parameter(
+    std::string(POLYGON_NAME) + ".raster_resolution", rclcpp::ParameterValue(0.03));
+  test_node_->set_parameter(
+    rclcpp::Parameter(std::string(POLYGON_NAME) + ".raster_resolution", 0.03));
+
+  polygon_ = std::make_shared<PolygonWrapper>(
+    test_node_, POLYGON_NAME,
+    tf_buffer_, BASE_FRAME_ID, TRANSFORM_TOLERANCE);
+  ASSERT_TRUE(polygon_->configure());
+
+  std::vector<nav2_collision_monitor::Point> points;
+  for (double x = -1.5; x <= 2.5; x += 0.01) {
+    for (double y = -1.5; y <= 1.5; y += 0.01) {
+      points.push_back({x, y});
+    }
+  }
+  points.push_back({-1.0, -1.0});
+  points.push_back({2.0, 0.0});
+  points.push_back({1.0, 0.5});
+  points.push_back({0.0, 1.0});
+
+  const int inside = polygon_->getPointsInside(points);
+  ASSERT_GT(inside, 0);
+  polygon_->setRasterResolution(0.0);
+  ASSERT_EQ(inside, polygon_->getPointsInside(points));
+}
+
 TEST_F(Tester, testCircleGetPointsInside)
 {
   createCircle("stop", true);
@@ -741,6 +741,106 @@ TEST_F(Tester, testIgnoreTimeShift)
   checkPolygon(data);
 }
 
+TEST_F(Tester, testConvertOnArrival)
+{
+  rclcpp::Time curr_time = test_node_->now();
+
+  createSources();
+  scan_->setConvertOnArrival(true);
+  pointcloud_->setConvertOnArrival(true);
+
+  sendTransforms(curr_time);
+
+  // Publish data for sources
+  test_node_->publishScan(curr_time, 1.0);
+  test_node_->publishPointCloud(curr_time);
+
+  // Wait until all sources will receive the data
+  ASSERT_TRUE(waitScan(500ms));
+  ASSERT_TRUE(waitPointCloud(500ms));
+
+  // Data was converted on arrival, the same as converted on request
+  std::vector<nav2_collision_monitor::Point> data;
+  ASSERT_TRUE(scan_->getData(curr_time, data));
+  checkScan(data);
+
+  data.clear();
+  ASSERT_TRUE(pointcloud_->getData(curr_time, data));
+  checkPointCloud(data);
+
+  // Stored data is outdated as the raw data would be
+  data.clear();
+  ASSERT_FALSE(scan_->getData(curr_time + DATA_TIMEOUT + 1s, data));
+  ASSERT_EQ(data.size(), 0u);
+}
+
+TEST_F(Tester, testPointCloudCropBox)
+{
+  rclcpp::Time curr_time = test_node_->now();
+
+  // Box in base frame holding only point 0
+  test_node_->declare_parameter(
+    std::string(POINTCLOUD_NAME) + ".crop_box",
+    rclcpp::ParameterValue(std::vector<double>{0.0, 0.0, 1.0, 1.0}));
+  createSources();
+
+  sendTransforms(curr_time);
+
+  test_node_->publishPointCloud(curr_time);
+  ASSERT_TRUE(waitPointCloud(500ms));
+
+  std::vector<nav2_collision_monitor::Point> data;
+  ASSERT_TRUE(pointcloud_->getData(curr_time, data));
+  ASSERT_EQ(data.size(), 1u);
+  EXPECT_NEAR(data[0].x, 0.6, EPSILON);
+  EXPECT_NEAR(data[0].y, 0.6, EPSILON);
+}
+
+TEST_F(Tester, testTransformCache)
+{
+  nav2_collision_monitor::TransformCache cache;
+  rclcpp::Time curr_time = test_node_->now();
+  rclcpp::Time source_time = curr_time - 100ms;
+  int lookups = 0;
+  auto lookup = [&lookups](tf2::Transform & tf_transform) {
+      lookups++;
+      tf_transform.setIdentity();
+      tf_transform.setOrigin(tf2::Vector3(lookups, 0.0, 0.0));
+      return true;
+    };
+
+  tf2::Transform tf_transform;
+  auto get = [&](
+    const std::string & frame, const rclcpp::Time & stamp, const rclcpp::Time & time, bool shift)
+    {
+      return cache.getTransform(frame, stamp, time, shift, lookup, tf_transform);
+    };
+
+  // The same transform of a cycle is looked up once
+  cache.reset(curr_time);
+  ASSERT_TRUE(get(SOURCE_FRAME_ID, source_time, curr_time, true));
+  ASSERT_TRUE(get(SOURCE_FRAME_ID, source_time, curr_time, true));
+  EXPECT_EQ(lookups, 1);
+  EXPECT_NEAR(tf_transform.getOrigin().x(), 1.0, EPSILON);
+
+  // Other source times, frames and times than the cycle one are looked up
+  ASSERT_TRUE(get(SOURCE_FRAME_ID, curr_time, curr_time, true));
+  ASSERT_TRUE(get(BASE_FRAME_ID, source_time, curr_time, true));
+  ASSERT_TRUE(get(SOURCE_FRAME_ID, source_time, source_time, true));
+  ASSERT_TRUE(get(SOURCE_FRAME_ID, source_time, source_time, true));
+  EXPECT_EQ(lookups, 5);
+
+  // Without time shift, the source time does not matter
+  ASSERT_TRUE(get(SOURCE_FRAME_ID, source_time, curr_time, false));
+  ASSERT_TRUE(get(SOURCE_FRAME_ID, curr_time, curr_time, false));
+  EXPECT_EQ(lookups, 6);
+
+  // A new cycle looks the transforms up again
+  cache.reset(curr_time + 1s);
+  ASSERT_TRUE(get(SOURCE_FRAME_ID, source_time, curr_time + 1s, true));
+  EXPECT_EQ(lookups, 7);
+}
+
 int main(int argc, char ** argv)
 {
   // Initialize the system
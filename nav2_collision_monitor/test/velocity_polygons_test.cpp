@@ -489,6 +489,25 @@ TEST_F(Tester, testVelocityPolygonVelocitySwitching)
   EXPECT_NEAR(poly[3].y, BACKWARD_POLYGON[7], EPSILON);
 }
 
+TEST_F(Tester, testVelocityPolygonSwitchingPointsInside)
+{
+  createVelocityPolygon("stop", IS_NOT_HOLONOMIC);
+
+  // One point in the forward polygon, two in the backward one
+  const std::vector<nav2_collision_monitor::Point> points{
+    {0.25, 0.1}, {-0.25, 0.1}, {-0.25, -0.1}};
+
+  // Each sub-polygon keeps its raster while the other one is used
+  for (int i = 0; i < 3; i++) {
+    velocity_polygon_->updatePolygon({0.3, 0.0, 0.0});
+    EXPECT_EQ(velocity_polygon_->getPointsInside(points), 1);
+    velocity_polygon_->updatePolygon({0.3, 0.0, 0.0});
+    EXPECT_EQ(velocity_polygon_->getPointsInside(points), 1);
+    velocity_polygon_->updatePolygon({-0.3, 0.0, 0.0});
+    EXPECT_EQ(velocity_polygon_->getPointsInside(points), 2);
+  }
+}
+
 TEST_F(Tester, testVelocityPolygonHolonomicVelocitySwitching)
 {
   createVelocityPolygon("stop", IS_HOLONOMIC);
@@ -135,6 +135,8 @@ struct OptimizerParams
   OptimizerParams()
   : debug(false),
     max_iterations(50),
+    num_threads(1),
+    warm_start(false),
     param_tol(1e-8),
     fn_tol(1e-6),
     gradient_tol(1e-10)
@@ -179,6 +181,12 @@ struct OptimizerParams
     nav2_util::declare_parameter_if_not_declared(
       node, local_name + "max_iterations", rclcpp::ParameterValue(100));
     node->get_parameter(local_name + "max_iterations", max_iterations);
+    nav2_util::declare_parameter_if_not_declared(
+      node, local_name + "num_threads", rclcpp::ParameterValue(1));
+    node->get_parameter(local_name + "num_threads", num_threads);
+    nav2_util::declare_parameter_if_not_declared(
+      node, local_name + "warm_start", rclcpp::ParameterValue(false));
+    node->get_parameter(local_name + "warm_start", warm_start);
     nav2_util::declare_parameter_if_not_declared(
       node, local_name + "debug_optimizer", rclcpp::ParameterValue(false));
     node->get_parameter(local_name + "debug_optimizer", debug);
@@ -191,6 +199,8 @@ struct OptimizerParams
   bool debug;
   std::string linear_solver_type;
   int max_iterations;  // Ceres default: 50
+  int num_threads;  // Ceres default: 1
+  bool warm_start;  // Start from the previous solution where paths overlap
 
   double param_tol;  // Ceres default: 1e-8
   double fn_tol;  // Ceres default: 1e-6
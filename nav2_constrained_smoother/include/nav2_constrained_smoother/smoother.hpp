@@ -60,10 +60,12 @@ public:
   void initialize(const OptimizerParams params)
   {
     debug_ = params.debug;
+    warm_start_ = params.warm_start;
 
     options_.linear_solver_type = params.solver_types.at(params.linear_solver_type);
 
     options_.max_num_iterations = params.max_iterations;
+    options_.num_threads = params.num_threads;
 
     options_.function_tolerance = params.fn_tol;
     options_.gradient_tolerance = params.gradient_tol;
@@ -103,7 +105,13 @@ public:
     ceres::Problem problem;
     std::vector<Eigen::Vector3d> path_optim;
     std::vector<bool> optimized;
-    if (buildProblem(path, costmap, params, problem, path_optim, optimized)) {
+    bool has_problem;
+    {
+      // The costmap is only read while building the problem, its region being copied
+      std::lock_guard<nav2_costmap_2d::Costmap2D::mutex_t> lock(*(costmap->getMutex()));
+      has_problem = buildProblem(path, costmap, params, problem, path_optim, optimized);
+    }
+    if (has_problem) {
       // solve the problem
       ceres::Solver::Summary summary;
       ceres::Solve(options_, &problem, &summary);
@@ -111,18 +119,118 @@ public:
         RCLCPP_INFO(rclcpp::get_logger("smoother_server"), "%s", summary.FullReport().c_str());
       }
       if (!summary.IsSolutionUsable() || summary.initial_cost - summary.final_cost < 0.0) {
+        prev_path_.clear();
         throw nav2_core::FailedToSmoothPath("Solution is not usable");
       }
     } else {
       RCLCPP_INFO(rclcpp::get_logger("smoother_server"), "Path too short to optimize");
     }
 
+    if (warm_start_) {
+      prev_path_ = path;
+      prev_path_optim_ = path_optim;
+    }
+
     upsampleAndPopulate(path_optim, optimized, start_dir, end_dir, params, path);
 
     return true;
   }
 
 private:
+  /**
+   * @brief Copy the costmap region around the path into the interpolation grid,
+   * leaving room around the path for the poses to move during optimization
+   * @param path Path to smooth
+   * @param costmap Pointer to costmap
+   * @param params Smoother parameters
+   */
+  void updateCostmapGrid(
+    const std::vector<Eigen::Vector3d> & path,
+    const nav2_costmap_2d::Costmap2D * costmap,
+    const SmootherParams & params)
+  {
+    double min_x = std::numeric_limits<double>::max();
+    double min_y = std::numeric_limits<double>::max();
+    double max_x = std::numeric_limits<double>::lowest();
+    double max_y = std::numeric_limits<double>::lowest();
+    for (const auto & pt : path) {
+      min_x = std::min(min_x, pt[0]);
+      min_y = std::min(min_y, pt[1]);
+      max_x = std::max(max_x, pt[0]);
+      max_y = std::max(max_y, pt[1]);
+    }
+
+    double margin = REGION_MARGIN;
+    for (size_t i = 0; i + 2 < params.cost_check_points.size(); i += 3) {
+      margin = std::max(
+        margin, REGION_MARGIN + std::hypot(
+          params.cost_check_points[i], params.cost_check_points[i + 1]));
+    }
+
+    // Bicubic interpolation reads two cells on each side of a point
+    int min_mx, min_my, max_mx, max_my;
+    costmap->worldToMapEnforceBounds(min_x - margin, min_y - margin, min_mx, min_my);
+    costmap->worldToMapEnforceBounds(max_x + margin, max_y + margin, max_mx, max_my);
+    const int size_x = costmap->getSizeInCellsX();
+    const int size_y = costmap->getSizeInCellsY();
+    min_mx = std::max(0, min_mx - 2);
+    min_my = std::max(0, min_my - 2);
+    max_mx = std::min(size_x - 1, max_mx + 2);
+    max_my = std::min(size_y - 1, max_my + 2);
+
+    const int width = max_mx - min_mx + 1;
+    const int height = max_my - min_my + 1;
+    costmap_region_.resize(static_cast<size_t>(width) * height);
+    const unsigned char * charmap = costmap->getCharMap();
+    for (int my = 0; my < height; my++) {
+      const unsigned char * row = charmap + costmap->getIndex(min_mx, min_my + my);
+      std::copy(row, row + width, costmap_region_.begin() + static_cast<size_t>(my) * width);
+    }
+
+    // Rows and columns keep the costmap indexes, cells out of the region reading its border
+    costmap_grid_ = std::make_shared<ceres::Grid2D<u_char>>(
+      costmap_region_.data(), min_my, max_my + 1, min_mx, max_mx + 1);
+  }
+
+  /**
+   * @brief Start the optimization from the previous solution where the path
+   * overlaps the previous one, e.g. when the same path is smoothed again after
+   * it was trimmed at the robot or extended
+   * @param path Path to smooth
+   * @param params Smoother parameters
+   * @param path_optim Path on which the problem will be solved
+   */
+  void warmStart(
+    const std::vector<Eigen::Vector3d> & path,
+    const SmootherParams & params,
+    std::vector<Eigen::Vector3d> & path_optim) const
+  {
+    if (prev_path_.empty()) {
+      return;
+    }
+
+    // Find the start of the path in the previous one
+    auto same_point = [](const Eigen::Vector3d & a, const Eigen::Vector3d & b) {
+        return (a - b).cwiseAbs().maxCoeff() < 1e-9;
+      };
+    size_t offset = 0;
+    while (offset < prev_path_.size() && !same_point(prev_path_[offset], path[0])) {
+      offset++;
+    }
+
+    // Poses held constant keep their values
+    const size_t first = params.keep_start_orientation ? 2 : 1;
+    const size_t last = path.size() - (params.keep_goal_orientation ? 2 : 1);
+    for (size_t i = 0; i < last && offset + i < prev_path_.size(); i++) {
+      if (!same_point(prev_path_[offset + i], path[i])) {
+        break;
+      }
+      if (i >= first) {
+        path_optim[i] = prev_path_optim_[offset + i];
+      }
+    }
+  }
+
   /**
    * @brief Build problem method
    * @param path Reference to path
@@ -142,8 +250,7 @@ private:
     std::vector<bool> & optimized)
   {
     // Create costmap grid
-    costmap_grid_ = std::make_shared<ceres::Grid2D<u_char>>(
-      costmap->getCharMap(), 0, costmap->getSizeInCellsY(), 0, costmap->getSizeInCellsX());
+    updateCostmapGrid(path, costmap, params);
     auto costmap_interpolator = std::make_shared<ceres::BiCubicInterpolator<ceres::Grid2D<u_char>>>(
       *costmap_grid_);
 
@@ -151,6 +258,9 @@ private:
     const double cusp_half_length = params.cusp_zone_length / 2;
     ceres::LossFunction * loss_function = NULL;
     path_optim = path;
+    if (warm_start_) {
+      warmStart(path, params, path_optim);
+    }
     optimized = std::vector<bool>(path.size());
     optimized[0] = true;
     int prelast_i = -1;
@@ -392,9 +502,17 @@ private:
     return pt;
   }
 
+  // Room left around the path in the costmap region, in meters
+  static constexpr double REGION_MARGIN = 1.0;
+
   bool debug_;
+  bool warm_start_{false};
   ceres::Solver::Options options_;
+  std::vector<u_char> costmap_region_;
   std::shared_ptr<ceres::Grid2D<u_char>> costmap_grid_;
+  // Last path smoothed and its solution, to warm start from
+  std::vector<Eigen::Vector3d> prev_path_;
+  std::vector<Eigen::Vector3d> prev_path_optim_;
 };
 
 }  // namespace nav2_constrained_smoother
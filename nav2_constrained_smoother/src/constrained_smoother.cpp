@@ -130,9 +130,8 @@ bool ConstrainedSmoother::smooth(nav_msgs::msg::Path & path, const rclcpp::Durat
 
   smoother_params_.max_time = max_time.seconds();
 
-  // Smooth plan
+  // Smooth plan, the smoother locking the costmap only to copy the region it needs
   auto costmap = costmap_sub_->getCostmap();
-  std::lock_guard<nav2_costmap_2d::Costmap2D::mutex_t> lock(*(costmap->getMutex()));
   if (!smoother_->smooth(path_world, start_dir, end_dir, costmap.get(), smoother_params_)) {
     RCLCPP_WARN(
       logger_,
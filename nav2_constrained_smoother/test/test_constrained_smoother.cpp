@@ -522,6 +522,45 @@ TEST_F(SmootherTest, testingAnchoringToOriginalPath)
   SUCCEED();
 }
 
+TEST_F(SmootherTest, testingWarmStart)
+{
+  node_lifecycle_->set_parameter(rclcpp::Parameter("SmoothPath.w_curve", 0.0));
+  node_lifecycle_->set_parameter(rclcpp::Parameter("SmoothPath.optimizer.num_threads", 2));
+  node_lifecycle_->set_parameter(rclcpp::Parameter("SmoothPath.optimizer.warm_start", true));
+  reloadParams();
+
+  std::vector<Eigen::Vector3d> sharp_turn_90 =
+  {{0, 0, 0},
+    {0.1, 0, 0},
+    {0.2, 0, 0},
+    {0.3, 0, M_PI / 4},
+    {0.3, 0.1, M_PI / 2},
+    {0.3, 0.2, M_PI / 2},
+    {0.3, 0.3, M_PI / 2}
+  };
+
+  std::vector<Eigen::Vector3d> smoothed_path;
+  EXPECT_TRUE(smoothPath(sharp_turn_90, smoothed_path));
+
+  // Smoothing the same path again starts from its solution, and converges to it
+  std::vector<Eigen::Vector3d> smoothed_again;
+  EXPECT_TRUE(smoothPath(sharp_turn_90, smoothed_again));
+  ASSERT_EQ(smoothed_again.size(), smoothed_path.size());
+  for (size_t i = 0; i < smoothed_path.size(); i++) {
+    EXPECT_NEAR(smoothed_again[i].x(), smoothed_path[i].x(), 0.01);
+    EXPECT_NEAR(smoothed_again[i].y(), smoothed_path[i].y(), 0.01);
+  }
+
+  // A path overlapping the previous one after its start is still smoothed
+  std::vector<Eigen::Vector3d> trimmed(sharp_turn_90.begin() + 1, sharp_turn_90.end());
+  EXPECT_TRUE(smoothPath(trimmed, smoothed_path));
+  double mvmt_smoothness_improvement =
+    assessPathImprovement(trimmed, smoothed_path, mvmt_smoothness_criterion_);
+  EXPECT_GT(mvmt_smoothness_improvement, 0.0);
+
+  SUCCEED();
+}
+
 TEST_F(SmootherTest, testingMaxCurvature)
 {
   node_lifecycle_->set_parameter(rclcpp::Parameter("SmoothPath.w_curve", 30.0));
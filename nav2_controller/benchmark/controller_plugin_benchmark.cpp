@@ -0,0 +1,409 @@
+// Copyright (c) 2024 Open Navigation LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Drives the computeVelocityCommands of any nav2_core::Controller plugin over a costmap,
+// a path and a sequence of odometry samples, as the controller server does for each
+// cycle. The plugins are those of the controller_plugins parameter, loaded with their
+// parameters from the controller_server and local_costmap sections of a params file:
+//
+//   controller_plugin_benchmark [--costmap=<map.yaml>] [--path=<file>] [--odometry=<file>]
+//     --ros-args --params-file nav2_params.yaml
+//
+// The costmap is read with the map server, as raw costs (mode: raw). The path holds a
+// "x y yaw" row per pose and the odometry a "x y yaw vx vy wz" row per control cycle,
+// all in the global frame of the costmap. Without fixtures, a synthetic corridor is used.
+
+#include <benchmark/benchmark.h>
+#include <time.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <new>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "geometry_msgs/msg/pose_stamped.hpp"
+#include "geometry_msgs/msg/twist.hpp"
+#include "nav_msgs/msg/occupancy_grid.hpp"
+#include "nav_msgs/msg/path.hpp"
+#include "nav2_controller/plugins/simple_goal_checker.hpp"
+#include "nav2_core/controller.hpp"
+#include "nav2_core/controller_exceptions.hpp"
+#include "nav2_costmap_2d/cost_values.hpp"
+#include "nav2_costmap_2d/costmap_2d_ros.hpp"
+#include "nav2_map_server/map_io.hpp"
+#include "nav2_util/geometry_utils.hpp"
+#include "nav2_util/lifecycle_node.hpp"
+#include "nav2_util/node_utils.hpp"
+#include "pluginlib/class_loader.hpp"
+#include "rclcpp/rclcpp.hpp"
+#include "tf2_ros/buffer.h"
+
+namespace
+{
+
+// Allocations through the global operator new, of all threads
+std::atomic<uint64_t> g_allocations{0};
+
+}  // namespace
+
+void * operator new(std::size_t size)
+{
+  g_allocations.fetch_add(1, std::memory_order_relaxed);
+  if (void * ptr = std::malloc(size ? size : 1)) {
+    return ptr;
+  }
+  throw std::bad_alloc();
+}
+
+void operator delete(void * ptr) noexcept
+{
+  std::free(ptr);
+}
+
+void operator delete(void * ptr, std::size_t) noexcept
+{
+  std::free(ptr);
+}
+
+namespace
+{
+
+struct OdometrySample
+{
+  geometry_msgs::msg::Pose pose;
+  geometry_msgs::msg::Twist velocity;
+};
+
+struct Fixture
+{
+  nav_msgs::msg::Path path;
+  std::vector<OdometrySample> odometry;
+};
+
+struct BenchmarkedController
+{
+  std::string id;
+  nav2_core::Controller::Ptr controller;
+};
+
+geometry_msgs::msg::Pose makePose(double x, double y, double yaw)
+{
+  geometry_msgs::msg::Pose pose;
+  pose.position.x = x;
+  pose.position.y = y;
+  pose.orientation = nav2_util::geometry_utils::orientationAroundZAxis(yaw);
+  return pose;
+}
+
+double processCpuSeconds()
+{
+  timespec ts;
+  clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &ts);
+  return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+// Rows of numbers of a fixture file, skipping blank lines and # comments
+std::vector<std::vector<double>> readRows(const std::string & filename, size_t columns)
+{
+  std::ifstream file(filename);
+  if (!file) {
+    throw std::runtime_error("Could not open " + filename);
+  }
+
+  std::vector<std::vector<double>> rows;
+  std::string line;
+  while (std::getline(file, line)) {
+    if (line.empty() || line[0] == '#') {
+      continue;
+    }
+    std::istringstream stream(line);
+    std::vector<double> row(columns);
+    for (double & value : row) {
+      if (!(stream >> value)) {
+        throw std::runtime_error("Expected " + std::to_string(columns) + " values: " + line);
+      }
+    }
+    rows.push_back(std::move(row));
+  }
+
+  if (rows.empty()) {
+    throw std::runtime_error(filename + " has no rows");
+  }
+  return rows;
+}
+
+void loadCostmap(const std::string & filename, nav2_costmap_2d::Costmap2DROS & costmap_ros)
+{
+  nav_msgs::msg::OccupancyGrid map;
+  if (nav2_map_server::loadMapFromYaml(filename, map) != nav2_map_server::LOAD_MAP_SUCCESS) {
+    throw std::runtime_error("Could not load the costmap " + filename);
+  }
+
+  costmap_ros.getLayeredCostmap()->resizeMap(
+    map.info.width, map.info.height, map.info.resolution,
+    map.info.origin.position.x, map.info.origin.position.y);
+  unsigned char * costs = costmap_ros.getCostmap()->getCharMap();
+  for (size_t i = 0; i < map.data.size(); i++) {
+    costs[i] = static_cast<unsigned char>(map.data[i]);
+  }
+}
+
+// A 12m x 6m corridor at 5cm, with boxes on either side for the path to weave between
+void makeSyntheticCostmap(nav2_costmap_2d::Costmap2DROS & costmap_ros)
+{
+  costmap_ros.getLayeredCostmap()->resizeMap(240, 120, 0.05, 0.0, 0.0);
+  nav2_costmap_2d::Costmap2D * costmap = costmap_ros.getCostmap();
+  const unsigned int size_x = costmap->getSizeInCellsX();
+  const unsigned int size_y = costmap->getSizeInCellsY();
+  for (unsigned int j = 0; j < size_y; j++) {
+    for (unsigned int i = 0; i < size_x; i++) {
+      const bool wall = j < 4 || j >= size_y - 4;
+      const bool box = (i % 60 >= 30 && i % 60 < 38) &&
+        ((i / 60) % 2 == 0 ? j < 50 : j >= 70);
+      costmap->setCost(
+        i, j, wall || box ? nav2_costmap_2d::LETHAL_OBSTACLE : nav2_costmap_2d::FREE_SPACE);
+    }
+  }
+}
+
+Fixture makeSyntheticFixture()
+{
+  // Path along the corridor, swerving away from the boxes
+  Fixture fixture;
+  const double step = 0.05;
+  for (double x = 0.5; x <= 11.5; x += step) {
+    const double y = 3.0 + 0.8 * std::sin(2.0 * M_PI * (x - 0.5) / 6.0);
+    const double dy = 0.8 * 2.0 * M_PI / 6.0 * std::cos(2.0 * M_PI * (x - 0.5) / 6.0);
+    geometry_msgs::msg::PoseStamped pose;
+    pose.pose = makePose(x, y, std::atan2(dy, 1.0));
+    fixture.path.poses.push_back(pose);
+  }
+
+  // The robot following the path at 0.5m/s, sampled at 20Hz
+  const double speed = 0.5, period = 0.05;
+  const size_t stride = std::max<size_t>(1, std::lround(speed * period / step));
+  for (size_t i = 0; i + 1 < fixture.path.poses.size(); i += stride) {
+    OdometrySample sample;
+    sample.pose = fixture.path.poses[i].pose;
+    sample.velocity.linear.x = speed;
+    fixture.odometry.push_back(sample);
+  }
+  return fixture;
+}
+
+Fixture loadFixture(const std::string & path_file, const std::string & odometry_file)
+{
+  Fixture fixture;
+  for (const auto & row : readRows(path_file, 3)) {
+    geometry_msgs::msg::PoseStamped pose;
+    pose.pose = makePose(row[0], row[1], row[2]);
+    fixture.path.poses.push_back(pose);
+  }
+  for (const auto & row : readRows(odometry_file, 6)) {
+    OdometrySample sample;
+    sample.pose = makePose(row[0], row[1], row[2]);
+    sample.velocity.linear.x = row[3];
+    sample.velocity.linear.y = row[4];
+    sample.velocity.angular.z = row[5];
+    fixture.odometry.push_back(sample);
+  }
+  return fixture;
+}
+
+double percentileMs(std::vector<double> & latencies, double fraction)
+{
+  if (latencies.empty()) {
+    return 0.0;
+  }
+  const size_t rank = std::min(
+    latencies.size() - 1, static_cast<size_t>(std::ceil(fraction * latencies.size())) - 1);
+  std::nth_element(latencies.begin(), latencies.begin() + rank, latencies.end());
+  return latencies[rank] * 1e3;
+}
+
+void runController(
+  benchmark::State & state, const BenchmarkedController & benchmarked,
+  const Fixture & fixture, nav2_costmap_2d::Costmap2DROS & costmap_ros,
+  nav2_core::GoalChecker & goal_checker, double controller_frequency)
+{
+  nav2_core::Controller & controller = *benchmarked.controller;
+  rclcpp::Clock clock;
+  auto path = fixture.path;
+  path.header.frame_id = costmap_ros.getGlobalFrameID();
+
+  std::vector<double> latencies;
+  latencies.reserve(1 << 16);
+  uint64_t allocations = 0;
+  double cpu_seconds = 0.0;
+  int failures = 0;
+  size_t sample = 0;
+
+  geometry_msgs::msg::PoseStamped pose;
+  pose.header.frame_id = costmap_ros.getGlobalFrameID();
+  for (auto _ : state) {
+    // The robot starts over the path from its first sample
+    if (sample % fixture.odometry.size() == 0) {
+      state.PauseTiming();
+      path.header.stamp = clock.now();
+      controller.setPlan(path);
+      goal_checker.reset();
+      state.ResumeTiming();
+    }
+    const OdometrySample & odometry = fixture.odometry[sample++ % fixture.odometry.size()];
+    pose.header.stamp = clock.now();
+    pose.pose = odometry.pose;
+
+    const uint64_t allocations_start = g_allocations.load(std::memory_order_relaxed);
+    const double cpu_start = processCpuSeconds();
+    const auto start = std::chrono::steady_clock::now();
+    try {
+      benchmark::DoNotOptimize(
+        controller.computeVelocityCommands(pose, odometry.velocity, &goal_checker));
+    } catch (const nav2_core::ControllerException &) {
+      failures++;
+    }
+    const auto end = std::chrono::steady_clock::now();
+    cpu_seconds += processCpuSeconds() - cpu_start;
+    allocations += g_allocations.load(std::memory_order_relaxed) - allocations_start;
+    latencies.push_back(std::chrono::duration<double>(end - start).count());
+  }
+
+  const double cycles = static_cast<double>(std::max<size_t>(latencies.size(), 1));
+  state.SetLabel(benchmarked.id);
+  state.counters["p50_ms"] = percentileMs(latencies, 0.5);
+  state.counters["p99_ms"] = percentileMs(latencies, 0.99);
+  state.counters["max_ms"] = percentileMs(latencies, 1.0);
+  state.counters["allocs_per_cycle"] = allocations / cycles;
+  // Share of a core taken per Hz of control rate, and at the configured rate
+  state.counters["cpu_pct_per_hz"] = 100.0 * cpu_seconds / cycles;
+  state.counters["cpu_pct"] = 100.0 * cpu_seconds / cycles * controller_frequency;
+  state.counters["failures"] = failures;
+}
+
+}  // namespace
+
+int main(int argc, char ** argv)
+{
+  benchmark::Initialize(&argc, argv);
+  const std::vector<std::string> args = rclcpp::init_and_remove_ros_arguments(argc, argv);
+
+  std::string costmap_file, path_file, odometry_file;
+  for (size_t i = 1; i < args.size(); i++) {
+    const std::string & arg = args[i];
+    if (arg.rfind("--costmap=", 0) == 0) {
+      costmap_file = arg.substr(10);
+    } else if (arg.rfind("--path=", 0) == 0) {
+      path_file = arg.substr(7);
+    } else if (arg.rfind("--odometry=", 0) == 0) {
+      odometry_file = arg.substr(11);
+    } else {
+      std::cerr << "Unknown argument " << arg << std::endl;
+      return 1;
+    }
+  }
+  if (path_file.empty() != odometry_file.empty()) {
+    std::cerr << "The path and odometry fixtures are given together" << std::endl;
+    return 1;
+  }
+
+  {
+    // Named as the controller server, so that its section of a params file applies
+    auto node = std::make_shared<nav2_util::LifecycleNode>("controller_server");
+    auto costmap_ros = std::make_shared<nav2_costmap_2d::Costmap2DROS>(
+      "local_costmap", std::string{node->get_namespace()}, "local_costmap", false);
+    costmap_ros->on_configure(rclcpp_lifecycle::State{});
+
+    const double controller_frequency =
+      node->declare_parameter("controller_frequency", 20.0);
+    const std::vector<std::string> ids = node->declare_parameter(
+      "controller_plugins", std::vector<std::string>{"FollowPath"});
+
+    Fixture fixture;
+    try {
+      if (costmap_file.empty()) {
+        makeSyntheticCostmap(*costmap_ros);
+      } else {
+        loadCostmap(costmap_file, *costmap_ros);
+      }
+      fixture = path_file.empty() ? makeSyntheticFixture() : loadFixture(path_file, odometry_file);
+    } catch (const std::exception & ex) {
+      std::cerr << ex.what() << std::endl;
+      rclcpp::shutdown();
+      return 1;
+    }
+    {
+      std::unique_lock<nav2_costmap_2d::Costmap2D::mutex_t> lock(
+        *(costmap_ros->getCostmap()->getMutex()));
+      costmap_ros->getLayeredCostmap()->publishSnapshot();
+    }
+
+    // Poses are given in the global frame, so the robot frame is only looked up there
+    auto tf_buffer = std::make_shared<tf2_ros::Buffer>(node->get_clock());
+    geometry_msgs::msg::TransformStamped identity;
+    identity.header.frame_id = costmap_ros->getGlobalFrameID();
+    identity.child_frame_id = costmap_ros->getBaseFrameID();
+    identity.transform.rotation.w = 1.0;
+    tf_buffer->setTransform(identity, "controller_plugin_benchmark", true);
+
+    nav2_controller::SimpleGoalChecker goal_checker;
+    goal_checker.initialize(node, "goal_checker", costmap_ros);
+
+    pluginlib::ClassLoader<nav2_core::Controller> loader("nav2_core", "nav2_core::Controller");
+    std::vector<BenchmarkedController> controllers;
+    try {
+      for (const auto & id : ids) {
+        const std::string type = nav2_util::get_plugin_type_param(node, id);
+        BenchmarkedController benchmarked{id, loader.createUniqueInstance(type)};
+        benchmarked.controller->configure(node, id, tf_buffer, costmap_ros);
+        benchmarked.controller->activate();
+        controllers.push_back(std::move(benchmarked));
+      }
+    } catch (const std::exception & ex) {
+      std::cerr << "Failed to load the controllers: " << ex.what() << std::endl;
+      rclcpp::shutdown();
+      return 1;
+    }
+
+    for (const auto & benchmarked : controllers) {
+      benchmark::RegisterBenchmark(
+        ("BM_Controller/" + benchmarked.id).c_str(),
+        [&](benchmark::State & state) {
+          runController(
+            state, benchmarked, fixture, *costmap_ros, goal_checker, controller_frequency);
+        })->Unit(benchmark::kMillisecond);
+    }
+    benchmark::RunSpecifiedBenchmarks();
+
+    for (auto & benchmarked : controllers) {
+      benchmarked.controller->deactivate();
+      benchmarked.controller->cleanup();
+    }
+    controllers.clear();
+    costmap_ros->on_cleanup(rclcpp_lifecycle::State{});
+  }
+
+  benchmark::Shutdown();
+  rclcpp::shutdown();
+  return 0;
+}
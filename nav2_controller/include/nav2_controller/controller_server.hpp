@@ -15,10 +15,13 @@
 #ifndef NAV2_CONTROLLER__CONTROLLER_SERVER_HPP_
 #define NAV2_CONTROLLER__CONTROLLER_SERVER_HPP_
 
+#include <chrono>
+#include <future>
 #include <memory>
 #include <string>
 #include <thread>
 #include <unordered_map>
+#include <unordered_set>
 #include <vector>
 #include <mutex>
 
@@ -28,10 +31,13 @@
 #include "nav2_costmap_2d/costmap_2d_ros.hpp"
 #include "tf2_ros/transform_listener.h"
 #include "nav2_msgs/action/follow_path.hpp"
+#include "nav2_msgs/msg/controller_latency.hpp"
 #include "nav2_msgs/msg/speed_limit.hpp"
 #include "nav_2d_utils/odom_subscriber.hpp"
+#include "nav2_util/latency_histogram.hpp"
 #include "nav2_util/lifecycle_node.hpp"
 #include "nav2_util/simple_action_server.hpp"
+#include "nav2_util/thread_pool.hpp"
 #include "nav2_util/robot_utils.hpp"
 #include "nav2_util/twist_publisher.hpp"
 #include "pluginlib/class_loader.hpp"
@@ -64,6 +70,17 @@ public:
   ~ControllerServer();
 
 protected:
+  /**
+   * @struct PipelinedVelocity
+   * @brief A command computed ahead of the control cycle publishing it
+   */
+  struct PipelinedVelocity
+  {
+    // Robot pose the command was computed at
+    geometry_msgs::msg::PoseStamped pose;
+    geometry_msgs::msg::TwistStamped cmd_vel;
+  };
+
   /**
    * @brief Configures controller parameters and member variables
    *
@@ -135,6 +152,15 @@ protected:
    */
   bool findControllerId(const std::string & c_name, std::string & name);
 
+  /**
+   * @brief Configure a controller created but left unconfigured with lazy_plugin_loading,
+   * and activate it if the server is active
+   *
+   * @param c_name The controller name
+   * @return bool Whether the controller is configured
+   */
+  bool loadControllerIfUnconfigured(const std::string & c_name);
+
   /**
    * @brief Find the valid goal checker ID name for the specified parameter
    *
@@ -155,13 +181,36 @@ protected:
 
   /**
    * @brief Assigns path to controller
-   * @param path Path received from action server
+   * @param path Path received from action server, shared with the controller
    */
-  void setPlannerPath(const nav_msgs::msg::Path & path);
+  void setPlannerPath(const std::shared_ptr<const nav_msgs::msg::Path> & path);
   /**
    * @brief Calculates velocity and publishes to "cmd_vel" topic
    */
   void computeAndPublishVelocity();
+  /**
+   * @brief Calculates velocity from the current robot pose and odometry
+   * @param pose To store the robot pose the velocity was computed at
+   * @return Velocity command
+   */
+  geometry_msgs::msg::TwistStamped computeVelocity(geometry_msgs::msg::PoseStamped & pose);
+  /**
+   * @brief Publishes a velocity command and the action feedback at its pose
+   * @param pose Robot pose the command was computed at
+   * @param cmd_vel Velocity command
+   */
+  void publishVelocityAndFeedback(
+    const geometry_msgs::msg::PoseStamped & pose,
+    const geometry_msgs::msg::TwistStamped & cmd_vel);
+  /**
+   * @brief Starts computing the command of the next cycle on the pipeline worker
+   * @param cycle_end Time the next cycle starts and publishes the command
+   */
+  void startPipelinedVelocity(std::chrono::steady_clock::time_point cycle_end);
+  /**
+   * @brief Waits for the command computing on the pipeline worker, if any, and discards it
+   */
+  void discardPipelinedVelocity();
   /**
    * @brief Calls setPlannerPath method with an updated path received from
    * action server
@@ -176,6 +225,10 @@ protected:
    * @brief Calls velocity publisher to publish zero velocity
    */
   void publishZeroVelocity();
+  /**
+   * @brief Publishes the latencies of the control loop phases, if the publish period elapsed
+   */
+  void publishLatencies();
   /**
    * @brief Checks if goal is reached
    * @return true or false
@@ -260,6 +313,17 @@ protected:
   std::vector<std::string> controller_types_;
   std::string controller_ids_concat_, current_controller_;
 
+  // Controllers left unconfigured until their first use with lazy_plugin_loading, those
+  // that failed to configure, whether configured controllers are active and the last
+  // speed limit, all guarded by plugin_load_mutex_
+  std::unordered_set<std::string> unconfigured_controllers_;
+  std::unordered_set<std::string> failed_controllers_;
+  bool controllers_active_{false};
+  bool has_speed_limit_{false};
+  double speed_limit_{0.0};
+  bool speed_limit_is_percentage_{false};
+  std::mutex plugin_load_mutex_;
+
   double controller_frequency_;
   double min_x_velocity_threshold_;
   double min_y_velocity_threshold_;
@@ -267,6 +331,26 @@ protected:
 
   double failure_tolerance_;
   bool use_realtime_priority_;
+  int control_loop_cpu_;
+
+  // With pipelined control, the command of a cycle is computed on a worker over the
+  // previous cycle, starting pipeline_lead_time_ before the cycle if not 0
+  bool pipelined_control_;
+  double pipeline_lead_time_;
+  std::unique_ptr<nav2_util::ThreadPool> pipeline_worker_;
+  std::future<PipelinedVelocity> pipelined_velocity_;
+
+  // Latencies of the control loop phases, with latency instrumentation
+  bool latency_instrumentation_;
+  double latency_publish_period_;
+  std::chrono::steady_clock::time_point last_latency_publish_;
+  nav2_util::LatencyHistogram jitter_latency_;
+  nav2_util::LatencyHistogram pose_latency_;
+  nav2_util::LatencyHistogram compute_latency_;
+  nav2_util::LatencyHistogram publish_latency_;
+  nav2_util::LatencyHistogram cycle_latency_;
+  rclcpp_lifecycle::LifecyclePublisher<nav2_msgs::msg::ControllerLatency>::SharedPtr
+    latency_pub_;
 
   // Whether we've published the single controller warning yet
   geometry_msgs::msg::PoseStamped end_pose_;
@@ -274,8 +358,8 @@ protected:
   // Last time the controller generated a valid command
   rclcpp::Time last_valid_cmd_time_;
 
-  // Current path container
-  nav_msgs::msg::Path current_path_;
+  // Current path, owned by the goal it was received in
+  std::shared_ptr<const nav_msgs::msg::Path> current_path_;
 
 private:
   /**
@@ -17,6 +17,8 @@
 #include <memory>
 #include <string>
 #include <utility>
+#include <cmath>
+#include <iterator>
 #include <limits>
 
 #include "lifecycle_msgs/msg/state.hpp"
@@ -25,6 +27,7 @@
 #include "nav_2d_utils/tf_help.hpp"
 #include "nav2_util/node_utils.hpp"
 #include "nav2_util/geometry_utils.hpp"
+#include "nav2_util/tracing.hpp"
 #include "nav2_controller/controller_server.hpp"
 
 using namespace std::chrono_literals;
@@ -63,11 +66,18 @@ ControllerServer::ControllerServer(const rclcpp::NodeOptions & options)
 
   declare_parameter("failure_tolerance", rclcpp::ParameterValue(0.0));
   declare_parameter("use_realtime_priority", rclcpp::ParameterValue(false));
+  declare_parameter("control_loop_cpu", rclcpp::ParameterValue(-1));
+  declare_parameter("pipelined_control", rclcpp::ParameterValue(false));
+  declare_parameter("lazy_plugin_loading", rclcpp::ParameterValue(false));
+  declare_parameter("pipeline_lead_time", rclcpp::ParameterValue(0.0));
+  declare_parameter("latency_instrumentation", rclcpp::ParameterValue(false));
+  declare_parameter("latency_publish_rate", rclcpp::ParameterValue(1.0));
+  declare_parameter("latency_topic", rclcpp::ParameterValue("controller_latency"));
 
   // The costmap node is used in the implementation of the controller
   costmap_ros_ = std::make_shared<nav2_costmap_2d::Costmap2DROS>(
     "local_costmap", std::string{get_namespace()}, "local_costmap",
-    get_parameter("use_sim_time").as_bool());
+    get_parameter("use_sim_time").as_bool(), get_node_options().use_intra_process_comms());
 }
 
 ControllerServer::~ControllerServer()
@@ -128,10 +138,44 @@ ControllerServer::on_configure(const rclcpp_lifecycle::State & /*state*/)
   get_parameter("speed_limit_topic", speed_limit_topic);
   get_parameter("failure_tolerance", failure_tolerance_);
   get_parameter("use_realtime_priority", use_realtime_priority_);
+  get_parameter("control_loop_cpu", control_loop_cpu_);
+  get_parameter("pipelined_control", pipelined_control_);
+  get_parameter("pipeline_lead_time", pipeline_lead_time_);
+  if (pipelined_control_) {
+    pipeline_worker_ = std::make_unique<nav2_util::ThreadPool>(1);
+    // The worker runs the controller, with the scheduling of the control loop
+    pipeline_worker_->enqueue(
+      [this]() {
+        if (use_realtime_priority_) {
+          try {
+            nav2_util::setSoftRealTimePriority();
+          } catch (const std::runtime_error & e) {
+            RCLCPP_WARN(get_logger(), "%s", e.what());
+          }
+        }
+        if (control_loop_cpu_ >= 0) {
+          try {
+            nav2_util::setThreadAffinity(control_loop_cpu_);
+          } catch (const std::runtime_error & e) {
+            RCLCPP_WARN(get_logger(), "%s", e.what());
+          }
+        }
+      });
+  }
+  get_parameter("latency_instrumentation", latency_instrumentation_);
+  double latency_publish_rate;
+  get_parameter("latency_publish_rate", latency_publish_rate);
+  latency_publish_period_ = latency_publish_rate > 0.0 ? 1.0 / latency_publish_rate : 0.0;
+  if (latency_instrumentation_) {
+    std::string latency_topic;
+    get_parameter("latency_topic", latency_topic);
+    latency_pub_ = create_publisher<nav2_msgs::msg::ControllerLatency>(latency_topic, 1);
+  }
 
   costmap_ros_->configure();
   // Launch a thread to run the costmap node
-  costmap_thread_ = std::make_unique<nav2_util::NodeThread>(costmap_ros_);
+  costmap_thread_ = std::make_unique<nav2_util::NodeThread>(
+    costmap_ros_, getThreadSettings("costmap_thread"));
 
   for (size_t i = 0; i != progress_checker_ids_.size(); i++) {
     try {
@@ -186,6 +230,10 @@ ControllerServer::on_configure(const rclcpp_lifecycle::State & /*state*/)
     get_logger(),
     "Controller Server has %s goal checkers available.", goal_checker_ids_concat_.c_str());
 
+  // Lazily, controllers are created now but only configured and activated on their first use
+  bool lazy_plugin_loading = false;
+  get_parameter("lazy_plugin_loading", lazy_plugin_loading);
+
   for (size_t i = 0; i != controller_ids_.size(); i++) {
     try {
       controller_types_[i] = nav2_util::get_plugin_type_param(node, controller_ids_[i]);
@@ -194,9 +242,13 @@ ControllerServer::on_configure(const rclcpp_lifecycle::State & /*state*/)
       RCLCPP_INFO(
         get_logger(), "Created controller : %s of type %s",
         controller_ids_[i].c_str(), controller_types_[i].c_str());
-      controller->configure(
-        node, controller_ids_[i],
-        costmap_ros_->getTfBuffer(), costmap_ros_);
+      if (lazy_plugin_loading) {
+        unconfigured_controllers_.insert(controller_ids_[i]);
+      } else {
+        controller->configure(
+          node, controller_ids_[i],
+          costmap_ros_->getTfBuffer(), costmap_ros_);
+      }
       controllers_.insert({controller_ids_[i], controller});
     } catch (const pluginlib::PluginlibException & ex) {
       RCLCPP_FATAL(
@@ -236,6 +288,8 @@ ControllerServer::on_configure(const rclcpp_lifecycle::State & /*state*/)
     RCLCPP_ERROR(get_logger(), "Error creating action server! %s", e.what());
     return nav2_util::CallbackReturn::FAILURE;
   }
+  // Goals are all computed on the worker thread of the action server
+  action_server_->setCpuAffinity(control_loop_cpu_);
 
   // Set subscribtion to the speed limiting topic
   speed_limit_sub_ = create_subscription<nav2_msgs::msg::SpeedLimit>(
@@ -254,11 +308,21 @@ ControllerServer::on_activate(const rclcpp_lifecycle::State & /*state*/)
   if (costmap_ros_state.id() != lifecycle_msgs::msg::State::PRIMARY_STATE_ACTIVE) {
     return nav2_util::CallbackReturn::FAILURE;
   }
-  ControllerMap::iterator it;
-  for (it = controllers_.begin(); it != controllers_.end(); ++it) {
-    it->second->activate();
+  {
+    std::lock_guard<std::mutex> lock(plugin_load_mutex_);
+    controllers_active_ = true;
+    ControllerMap::iterator it;
+    for (it = controllers_.begin(); it != controllers_.end(); ++it) {
+      if (unconfigured_controllers_.count(it->first) == 0) {
+        it->second->activate();
+      }
+    }
   }
   vel_publisher_->on_activate();
+  if (latency_pub_) {
+    latency_pub_->on_activate();
+    last_latency_publish_ = std::chrono::steady_clock::now();
+  }
   action_server_->activate();
 
   auto node = shared_from_this();
@@ -278,9 +342,15 @@ ControllerServer::on_deactivate(const rclcpp_lifecycle::State & /*state*/)
   RCLCPP_INFO(get_logger(), "Deactivating");
 
   action_server_->deactivate();
-  ControllerMap::iterator it;
-  for (it = controllers_.begin(); it != controllers_.end(); ++it) {
-    it->second->deactivate();
+  {
+    std::lock_guard<std::mutex> lock(plugin_load_mutex_);
+    controllers_active_ = false;
+    ControllerMap::iterator it;
+    for (it = controllers_.begin(); it != controllers_.end(); ++it) {
+      if (unconfigured_controllers_.count(it->first) == 0) {
+        it->second->deactivate();
+      }
+    }
   }
 
   /*
@@ -294,6 +364,9 @@ ControllerServer::on_deactivate(const rclcpp_lifecycle::State & /*state*/)
 
   publishZeroVelocity();
   vel_publisher_->on_deactivate();
+  if (latency_pub_) {
+    latency_pub_->on_deactivate();
+  }
   dyn_params_handler_.reset();
 
   // destroy bond connection
@@ -310,9 +383,14 @@ ControllerServer::on_cleanup(const rclcpp_lifecycle::State & /*state*/)
   // Cleanup the helper classes
   ControllerMap::iterator it;
   for (it = controllers_.begin(); it != controllers_.end(); ++it) {
-    it->second->cleanup();
+    if (unconfigured_controllers_.count(it->first) == 0) {
+      it->second->cleanup();
+    }
   }
   controllers_.clear();
+  unconfigured_controllers_.clear();
+  failed_controllers_.clear();
+  has_speed_limit_ = false;
 
   goal_checkers_.clear();
   progress_checkers_.clear();
@@ -325,7 +403,9 @@ ControllerServer::on_cleanup(const rclcpp_lifecycle::State & /*state*/)
   odom_sub_.reset();
   costmap_thread_.reset();
   vel_publisher_.reset();
+  latency_pub_.reset();
   speed_limit_sub_.reset();
+  pipeline_worker_.reset();
 
   return nav2_util::CallbackReturn::SUCCESS;
 }
@@ -360,6 +440,39 @@ bool ControllerServer::findControllerId(
     current_controller = c_name;
   }
 
+  return loadControllerIfUnconfigured(current_controller);
+}
+
+bool ControllerServer::loadControllerIfUnconfigured(const std::string & c_name)
+{
+  std::lock_guard<std::mutex> lock(plugin_load_mutex_);
+  if (unconfigured_controllers_.count(c_name) == 0) {
+    return true;
+  }
+  if (failed_controllers_.count(c_name) != 0) {
+    RCLCPP_ERROR(get_logger(), "Controller %s failed to configure.", c_name.c_str());
+    return false;
+  }
+
+  RCLCPP_INFO(get_logger(), "Configuring controller %s on its first use", c_name.c_str());
+  auto & controller = controllers_.at(c_name);
+  try {
+    controller->configure(
+      shared_from_this(), c_name, costmap_ros_->getTfBuffer(), costmap_ros_);
+    if (controllers_active_) {
+      controller->activate();
+    }
+    if (has_speed_limit_) {
+      controller->setSpeedLimit(speed_limit_, speed_limit_is_percentage_);
+    }
+  } catch (const std::exception & ex) {
+    RCLCPP_ERROR(
+      get_logger(), "Failed to configure controller %s. Exception: %s",
+      c_name.c_str(), ex.what());
+    failed_controllers_.insert(c_name);
+    return false;
+  }
+  unconfigured_controllers_.erase(c_name);
   return true;
 }
 
@@ -421,6 +534,9 @@ void ControllerServer::computeControl()
 
   RCLCPP_INFO(get_logger(), "Received a goal, begin computing control effort.");
 
+  // A command of the previous goal may still be computing, if it ended on an exception
+  discardPipelinedVelocity();
+
   try {
     std::string c_name = action_server_->get_current_goal()->controller_id;
     std::string current_controller;
@@ -446,13 +562,34 @@ void ControllerServer::computeControl()
       throw nav2_core::ControllerException("Failed to find progress checker name: " + pc_name);
     }
 
-    setPlannerPath(action_server_->get_current_goal()->path);
+    // The goal is immutable, so its path is shared rather than copied
+    auto goal = action_server_->get_current_goal();
+    setPlannerPath(std::shared_ptr<const nav_msgs::msg::Path>(goal, &goal->path));
     progress_checkers_[current_progress_checker_]->reset();
 
     last_valid_cmd_time_ = now();
     rclcpp::WallRate loop_rate(controller_frequency_);
+    const std::chrono::duration<double> period(1.0 / controller_frequency_);
+    std::chrono::steady_clock::time_point last_cycle_start;
     while (rclcpp::ok()) {
+      NAV2_TRACE_SCOPE("controller.cycle");
       auto start_time = this->now();
+      const auto cycle_start = std::chrono::steady_clock::now();
+      if (latency_instrumentation_ && last_cycle_start.time_since_epoch().count() != 0) {
+        // Deviation of the cycle period from the desired one
+        jitter_latency_.record(
+          std::abs((std::chrono::duration<double>(cycle_start - last_cycle_start) - period)
+          .count()));
+      }
+      last_cycle_start = cycle_start;
+
+      // The command computed over the previous cycle is due at its end
+      bool published = false;
+      if (pipelined_velocity_.valid()) {
+        PipelinedVelocity pipelined = pipelined_velocity_.get();
+        publishVelocityAndFeedback(pipelined.pose, pipelined.cmd_vel);
+        published = true;
+      }
 
       if (action_server_ == nullptr || !action_server_->is_server_active()) {
         RCLCPP_DEBUG(get_logger(), "Action server unavailable or inactive. Stopping.");
@@ -479,13 +616,25 @@ void ControllerServer::computeControl()
 
       updateGlobalPath();
 
-      computeAndPublishVelocity();
+      if (!published) {
+        computeAndPublishVelocity();
+      }
+
+      if (latency_instrumentation_) {
+        cycle_latency_.recordSince(cycle_start);
+        publishLatencies();
+      }
 
       if (isGoalReached()) {
         RCLCPP_INFO(get_logger(), "Reached the goal!");
         break;
       }
 
+      if (pipelined_control_) {
+        startPipelinedVelocity(
+          cycle_start + std::chrono::duration_cast<std::chrono::steady_clock::duration>(period));
+      }
+
       auto cycle_duration = this->now() - start_time;
       if (!loop_rate.sleep()) {
         RCLCPP_WARN(
@@ -560,18 +709,18 @@ void ControllerServer::computeControl()
   action_server_->succeeded_current();
 }
 
-void ControllerServer::setPlannerPath(const nav_msgs::msg::Path & path)
+void ControllerServer::setPlannerPath(const std::shared_ptr<const nav_msgs::msg::Path> & path)
 {
   RCLCPP_DEBUG(
     get_logger(),
     "Providing path to the controller %s", current_controller_.c_str());
-  if (path.poses.empty()) {
+  if (path->poses.empty()) {
     throw nav2_core::InvalidPath("Path is empty.");
   }
-  controllers_[current_controller_]->setPlan(path);
+  controllers_[current_controller_]->setSharedPlan(path);
 
-  end_pose_ = path.poses.back();
-  end_pose_.header.frame_id = path.header.frame_id;
+  end_pose_ = path->poses.back();
+  end_pose_.header.frame_id = path->header.frame_id;
   goal_checkers_[current_goal_checker_]->reset();
 
   RCLCPP_DEBUG(
@@ -584,10 +733,45 @@ void ControllerServer::setPlannerPath(const nav_msgs::msg::Path & path)
 void ControllerServer::computeAndPublishVelocity()
 {
   geometry_msgs::msg::PoseStamped pose;
+  const geometry_msgs::msg::TwistStamped cmd_vel_2d = computeVelocity(pose);
+  publishVelocityAndFeedback(pose, cmd_vel_2d);
+}
+
+void ControllerServer::startPipelinedVelocity(std::chrono::steady_clock::time_point cycle_end)
+{
+  const auto start = pipeline_lead_time_ > 0.0 ?
+    cycle_end - std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+    std::chrono::duration<double>(pipeline_lead_time_)) :
+    std::chrono::steady_clock::now();
+  pipelined_velocity_ = pipeline_worker_->enqueue(
+    [this, start]() {
+      // Sample the pose and odometry as late as the lead time allows
+      std::this_thread::sleep_until(start);
+      PipelinedVelocity pipelined;
+      pipelined.cmd_vel = computeVelocity(pipelined.pose);
+      return pipelined;
+    });
+}
+
+void ControllerServer::discardPipelinedVelocity()
+{
+  if (pipelined_velocity_.valid()) {
+    pipelined_velocity_.wait();
+    pipelined_velocity_ = std::future<PipelinedVelocity>();
+  }
+}
 
+geometry_msgs::msg::TwistStamped ControllerServer::computeVelocity(
+  geometry_msgs::msg::PoseStamped & pose)
+{
+  NAV2_TRACE_SCOPE("controller.computeVelocity");
+  auto phase_start = std::chrono::steady_clock::now();
   if (!getRobotPose(pose)) {
     throw nav2_core::ControllerTFError("Failed to obtain robot pose");
   }
+  if (latency_instrumentation_) {
+    pose_latency_.recordSince(phase_start);
+  }
 
   if (!progress_checkers_[current_progress_checker_]->check(pose)) {
     throw nav2_core::FailedToMakeProgress("Failed to make progress");
@@ -597,6 +781,7 @@ void ControllerServer::computeAndPublishVelocity()
 
   geometry_msgs::msg::TwistStamped cmd_vel_2d;
 
+  phase_start = std::chrono::steady_clock::now();
   try {
     cmd_vel_2d =
       controllers_[current_controller_]->computeVelocityCommands(
@@ -628,12 +813,25 @@ void ControllerServer::computeAndPublishVelocity()
       throw nav2_core::NoValidControl(e.what());
     }
   }
+  if (latency_instrumentation_) {
+    compute_latency_.recordSince(phase_start);
+  }
+  return cmd_vel_2d;
+}
 
+void ControllerServer::publishVelocityAndFeedback(
+  const geometry_msgs::msg::PoseStamped & pose,
+  const geometry_msgs::msg::TwistStamped & cmd_vel_2d)
+{
+  // Identified by the stamp of the command, as the collision monitor processing it
+  NAV2_TRACE_SCOPE_ID(
+    "controller.publishVelocity", rclcpp::Time(cmd_vel_2d.header.stamp).nanoseconds());
+  const auto phase_start = std::chrono::steady_clock::now();
   std::shared_ptr<Action::Feedback> feedback = std::make_shared<Action::Feedback>();
   feedback->speed = std::hypot(cmd_vel_2d.twist.linear.x, cmd_vel_2d.twist.linear.y);
 
   // Find the closest pose to current pose on global path
-  nav_msgs::msg::Path & current_path = current_path_;
+  const nav_msgs::msg::Path & current_path = *current_path_;
   auto find_closest_pose_idx =
     [&pose, &current_path]() {
       size_t closest_pose_idx = 0;
@@ -650,15 +848,55 @@ void ControllerServer::computeAndPublishVelocity()
     };
 
   feedback->distance_to_goal =
-    nav2_util::geometry_utils::calculate_path_length(current_path_, find_closest_pose_idx());
+    nav2_util::geometry_utils::calculate_path_length(current_path, find_closest_pose_idx());
   action_server_->publish_feedback(feedback);
 
   RCLCPP_DEBUG(get_logger(), "Publishing velocity at time %.2f", now().seconds());
   publishVelocity(cmd_vel_2d);
+  if (latency_instrumentation_) {
+    publish_latency_.recordSince(phase_start);
+  }
+}
+
+void ControllerServer::publishLatencies()
+{
+  const auto now = std::chrono::steady_clock::now();
+  if (std::chrono::duration<double>(now - last_latency_publish_).count() <
+    latency_publish_period_)
+  {
+    return;
+  }
+  last_latency_publish_ = now;
+
+  const std::pair<const char *, nav2_util::LatencySummary> latencies[] = {
+    {"jitter", jitter_latency_.collect()},
+    {"pose_lookup", pose_latency_.collect()},
+    {"compute", compute_latency_.collect()},
+    {"publish", publish_latency_.collect()},
+    {"cycle", cycle_latency_.collect()}};
+  if (!latency_pub_ || latency_pub_->get_subscription_count() == 0) {
+    return;
+  }
+
+  auto msg = std::make_unique<nav2_msgs::msg::ControllerLatency>();
+  msg->header.stamp = this->now();
+  msg->stages.reserve(std::size(latencies));
+  for (const auto & [stage_name, summary] : latencies) {
+    nav2_msgs::msg::StageLatency stage;
+    stage.name = stage_name;
+    stage.count = summary.count;
+    stage.mean_ms = summary.mean_ms;
+    stage.p50_ms = summary.p50_ms;
+    stage.p99_ms = summary.p99_ms;
+    stage.max_ms = summary.max_ms;
+    msg->stages.push_back(std::move(stage));
+  }
+  latency_pub_->publish(std::move(msg));
 }
 
 void ControllerServer::updateGlobalPath()
 {
+  NAV2_TRACE_SCOPE("controller.updateGlobalPath");
   if (action_server_->is_preempt_requested()) {
     RCLCPP_INFO(get_logger(), "Passing new path to controller.");
     auto goal = action_server_->accept_pending_goal();
@@ -698,7 +936,7 @@ void ControllerServer::updateGlobalPath()
       action_server_->terminate_current();
       return;
     }
-    setPlannerPath(goal->path);
+    setPlannerPath(std::shared_ptr<const nav_msgs::msg::Path>(goal, &goal->path));
   }
 }
 
@@ -724,9 +962,12 @@ void ControllerServer::publishZeroVelocity()
   publishVelocity(velocity);
 
   // Reset the state of the controllers after the task has ended
+  std::lock_guard<std::mutex> lock(plugin_load_mutex_);
   ControllerMap::iterator it;
   for (it = controllers_.begin(); it != controllers_.end(); ++it) {
-    it->second->reset();
+    if (unconfigured_controllers_.count(it->first) == 0) {
+      it->second->reset();
+    }
   }
 }
 
@@ -764,9 +1005,16 @@ bool ControllerServer::getRobotPose(geometry_msgs::msg::PoseStamped & pose)
 
 void ControllerServer::speedLimitCallback(const nav2_msgs::msg::SpeedLimit::SharedPtr msg)
 {
+  // Kept for the controllers configured later on with lazy plugin loading
+  std::lock_guard<std::mutex> lock(plugin_load_mutex_);
+  has_speed_limit_ = true;
+  speed_limit_ = msg->speed_limit;
+  speed_limit_is_percentage_ = msg->percentage;
   ControllerMap::iterator it;
   for (it = controllers_.begin(); it != controllers_.end(); ++it) {
-    it->second->setSpeedLimit(msg->speed_limit, msg->percentage);
+    if (unconfigured_controllers_.count(it->first) == 0) {
+      it->second->setSpeedLimit(msg->speed_limit, msg->percentage);
+    }
   }
 }
 
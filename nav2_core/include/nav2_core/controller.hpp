@@ -98,6 +98,18 @@ public:
    */
   virtual void setPlan(const nav_msgs::msg::Path & path) = 0;
 
+  /**
+   * @brief local setSharedPlan - Sets the global plan, shared with the caller
+   *
+   * The path is never modified by its owner, so controllers may keep the pointer rather
+   * than copy a possibly long path. Defaults to setPlan().
+   * @param path The global plan
+   */
+  virtual void setSharedPlan(const std::shared_ptr<const nav_msgs::msg::Path> & path)
+  {
+    setPlan(*path);
+  }
+
   /**
    * @brief Controller computeVelocityCommands - calculates the best command given the current pose and velocity
    *
@@ -15,6 +15,7 @@
 #ifndef NAV2_CORE__GLOBAL_PLANNER_HPP_
 #define NAV2_CORE__GLOBAL_PLANNER_HPP_
 
+#include <functional>
 #include <memory>
 #include <string>
 #include "rclcpp/rclcpp.hpp"
@@ -78,6 +79,15 @@ public:
     const geometry_msgs::msg::PoseStamped & start,
     const geometry_msgs::msg::PoseStamped & goal,
     std::function<bool()> cancel_checker) = 0;
+
+  /**
+   * @brief Method to set the function a planner may call from createPlan with a provisional
+   * prefix of the path, as soon as one is known, so that the robot may start following it
+   * before the rest of the path is complete. Planners that cannot stream ignore it.
+   * @param callback Function to call with each provisional prefix, from start
+   */
+  virtual void setPartialPathCallback(
+    std::function<void(const nav_msgs::msg::Path &)>/*callback*/) {}
 };
 
 }  // namespace nav2_core
@@ -0,0 +1,497 @@
+// Copyright (c) 2024 Open Navigation LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Microbenchmarks of the costmap layers, filters and publisher, over synthetic maps of
+// several sizes and resolutions, and over a recorded costmap when given one:
+//
+//   costmap_benchmark [--costmap=<map.yaml>] [--benchmark_filter=<regex>]
+//
+// The recorded costmap is read with the map server, as raw costs (mode: raw). Grid
+// benchmarks take the map side in cells and the resolution in cm as arguments, 0 standing
+// for the recorded costmap.
+
+#include <benchmark/benchmark.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "geometry_msgs/msg/point.hpp"
+#include "geometry_msgs/msg/pose2_d.hpp"
+#include "nav_msgs/msg/occupancy_grid.hpp"
+#include "nav2_costmap_2d/cost_values.hpp"
+#include "nav2_costmap_2d/costmap_2d.hpp"
+#include "nav2_costmap_2d/costmap_2d_publisher.hpp"
+#include "nav2_costmap_2d/costmap_filters/keepout_filter.hpp"
+#include "nav2_costmap_2d/costmap_layer.hpp"
+#include "nav2_costmap_2d/denoise_layer.hpp"
+#include "nav2_costmap_2d/inflation_layer.hpp"
+#include "nav2_costmap_2d/layered_costmap.hpp"
+#include "nav2_costmap_2d/observation.hpp"
+#include "nav2_costmap_2d/obstacle_layer.hpp"
+#include "nav2_costmap_2d/voxel_layer.hpp"
+#include "nav2_map_server/map_io.hpp"
+#include "nav2_msgs/msg/costmap.hpp"
+#include "nav2_msgs/msg/costmap_filter_info.hpp"
+#include "nav2_util/lifecycle_node.hpp"
+#include "rclcpp/rclcpp.hpp"
+#include "sensor_msgs/point_cloud2_iterator.hpp"
+#include "tf2_ros/buffer.h"
+
+namespace
+{
+
+using nav2_costmap_2d::Costmap2D;
+
+nav2_util::LifecycleNode::SharedPtr g_node;
+std::shared_ptr<tf2_ros::Buffer> g_tf;
+// Recorded costmap, empty unless given
+nav_msgs::msg::OccupancyGrid g_recorded;
+
+struct GridSpec
+{
+  unsigned int size_x;
+  unsigned int size_y;
+  double resolution;
+};
+
+// Side in cells and resolution in cm from the arguments, 0 for the recorded costmap
+GridSpec gridSpec(const benchmark::State & state)
+{
+  if (state.range(0) == 0) {
+    return {g_recorded.info.width, g_recorded.info.height, g_recorded.info.resolution};
+  }
+  const auto size = static_cast<unsigned int>(state.range(0));
+  return {size, size, state.range(1) * 0.01};
+}
+
+// The recorded costs, or seeded boxes over a tenth of the map
+void fillCosts(Costmap2D & costmap, const benchmark::State & state)
+{
+  unsigned char * costs = costmap.getCharMap();
+  const unsigned int size_x = costmap.getSizeInCellsX(), size_y = costmap.getSizeInCellsY();
+  if (state.range(0) == 0) {
+    std::transform(
+      g_recorded.data.begin(), g_recorded.data.end(), costs,
+      [](int8_t cost) {return static_cast<unsigned char>(cost);});
+    return;
+  }
+
+  std::fill(costs, costs + size_x * size_y, nav2_costmap_2d::FREE_SPACE);
+  std::mt19937 rng(size_x);
+  std::uniform_int_distribution<unsigned int> x(0, size_x - 1), y(0, size_y - 1), side(2, 12);
+  for (size_t lethal = 0; lethal < size_x * size_y / 10; ) {
+    const unsigned int x0 = x(rng), y0 = y(rng);
+    const unsigned int xn = std::min(size_x, x0 + side(rng));
+    const unsigned int yn = std::min(size_y, y0 + side(rng));
+    for (unsigned int j = y0; j < yn; j++) {
+      for (unsigned int i = x0; i < xn; i++) {
+        lethal += costs[j * size_x + i] != nav2_costmap_2d::LETHAL_OBSTACLE;
+        costs[j * size_x + i] = nav2_costmap_2d::LETHAL_OBSTACLE;
+      }
+    }
+  }
+}
+
+template<typename ParameterT>
+void setLayerParameter(const std::string & name, const ParameterT & value)
+{
+  if (!g_node->has_parameter(name)) {
+    g_node->declare_parameter(name, rclcpp::ParameterValue(value));
+  }
+  g_node->set_parameter(rclcpp::Parameter(name, value));
+}
+
+std::vector<geometry_msgs::msg::Point> squareFootprint(double half_side)
+{
+  std::vector<geometry_msgs::msg::Point> footprint(4);
+  for (size_t i = 0; i < 4; i++) {
+    footprint[i].x = (i == 0 || i == 3) ? half_side : -half_side;
+    footprint[i].y = (i < 2) ? half_side : -half_side;
+  }
+  return footprint;
+}
+
+// Points at seeded ranges and bearings around the origin, within max_range
+sensor_msgs::msg::PointCloud2 makeCloud(size_t points, double max_range, double max_z)
+{
+  sensor_msgs::msg::PointCloud2 cloud;
+  sensor_msgs::PointCloud2Modifier modifier(cloud);
+  modifier.setPointCloud2FieldsByString(1, "xyz");
+  modifier.resize(points);
+  sensor_msgs::PointCloud2Iterator<float> iter_x(cloud, "x");
+  sensor_msgs::PointCloud2Iterator<float> iter_y(cloud, "y");
+  sensor_msgs::PointCloud2Iterator<float> iter_z(cloud, "z");
+
+  std::mt19937 rng(points);
+  std::uniform_real_distribution<double> range(0.5, max_range), bearing(-M_PI, M_PI);
+  std::uniform_real_distribution<double> height(0.05, max_z);
+  for (size_t i = 0; i < points; i++, ++iter_x, ++iter_y, ++iter_z) {
+    const double r = range(rng), a = bearing(rng);
+    *iter_x = static_cast<float>(r * std::cos(a));
+    *iter_y = static_cast<float>(r * std::sin(a));
+    *iter_z = static_cast<float>(height(rng));
+  }
+  return cloud;
+}
+
+// Inflation of the obstacles of the whole map, with the cached kernel or the distance transform
+void BM_InflationUpdateCosts(benchmark::State & state, bool distance_transform)
+{
+  const GridSpec spec = gridSpec(state);
+  const std::string name = distance_transform ? "inflation_dt" : "inflation";
+  setLayerParameter(name + ".use_distance_transform", distance_transform);
+
+  nav2_costmap_2d::LayeredCostmap layers("map", false, false);
+  auto inflation = std::make_shared<nav2_costmap_2d::InflationLayer>();
+  layers.addPlugin(inflation);
+  inflation->initialize(&layers, name, g_tf.get(), g_node, nullptr);
+  layers.resizeMap(spec.size_x, spec.size_y, spec.resolution, 0.0, 0.0);
+  layers.setFootprint(squareFootprint(0.2));
+
+  Costmap2D & master = *layers.getCostmap();
+  fillCosts(master, state);
+  const std::vector<unsigned char> obstacles(
+    master.getCharMap(), master.getCharMap() + spec.size_x * spec.size_y);
+
+  for (auto _ : state) {
+    state.PauseTiming();
+    std::copy(obstacles.begin(), obstacles.end(), master.getCharMap());
+    state.ResumeTiming();
+    inflation->updateCosts(master, 0, 0, spec.size_x, spec.size_y);
+  }
+  state.SetItemsProcessed(state.iterations() * spec.size_x * spec.size_y);
+}
+
+// Marking and raytracing of a cloud around the center of the map
+template<typename LayerT>
+void BM_ObservationUpdate(benchmark::State & state, const std::string & name, double max_z)
+{
+  const auto size = static_cast<unsigned int>(state.range(0));
+  const auto points = static_cast<size_t>(state.range(1));
+  const double resolution = 0.05, half_side = size * resolution / 2.0;
+
+  nav2_costmap_2d::LayeredCostmap layers("map", false, false);
+  auto layer = std::make_shared<LayerT>();
+  layer->initialize(&layers, name, g_tf.get(), g_node, nullptr);
+  layers.addPlugin(layer);
+  layers.resizeMap(size, size, resolution, -half_side, -half_side);
+
+  geometry_msgs::msg::Point origin;
+  origin.z = max_z / 2.0;
+  nav2_costmap_2d::Observation observation(
+    origin, makeCloud(points, half_side - resolution, max_z), half_side, 0.0, half_side, 0.0);
+  layer->addStaticObservation(observation, true, true);
+
+  for (auto _ : state) {
+    double min_x = 1e30, min_y = 1e30, max_x = -1e30, max_y = -1e30;
+    layer->updateBounds(0.0, 0.0, 0.0, &min_x, &min_y, &max_x, &max_y);
+    layer->updateCosts(*layers.getCostmap(), 0, 0, size, size);
+  }
+  state.SetItemsProcessed(state.iterations() * points);
+}
+
+// Removal of the isolated obstacles, single cells or groups smaller than a minimal size
+void BM_DenoiseUpdateCosts(benchmark::State & state, int minimal_group_size)
+{
+  const GridSpec spec = gridSpec(state);
+  const std::string name = "denoise_" + std::to_string(minimal_group_size);
+  setLayerParameter(name + ".minimal_group_size", minimal_group_size);
+
+  nav2_costmap_2d::LayeredCostmap layers("map", false, false);
+  auto denoise = std::make_shared<nav2_costmap_2d::DenoiseLayer>();
+  layers.addPlugin(denoise);
+  denoise->initialize(&layers, name, g_tf.get(), g_node, nullptr);
+  layers.resizeMap(spec.size_x, spec.size_y, spec.resolution, 0.0, 0.0);
+
+  // Obstacles with a percent of speckles to remove
+  Costmap2D & master = *layers.getCostmap();
+  fillCosts(master, state);
+  std::mt19937 rng(spec.size_x);
+  std::uniform_int_distribution<size_t> cell(0, spec.size_x * spec.size_y - 1);
+  for (size_t i = 0; i < spec.size_x * spec.size_y / 100; i++) {
+    master.getCharMap()[cell(rng)] = nav2_costmap_2d::LETHAL_OBSTACLE;
+  }
+  const std::vector<unsigned char> noisy(
+    master.getCharMap(), master.getCharMap() + spec.size_x * spec.size_y);
+
+  for (auto _ : state) {
+    state.PauseTiming();
+    std::copy(noisy.begin(), noisy.end(), master.getCharMap());
+    state.ResumeTiming();
+    denoise->updateCosts(master, 0, 0, spec.size_x, spec.size_y);
+  }
+  state.SetItemsProcessed(state.iterations() * spec.size_x * spec.size_y);
+}
+
+// Keepout filter applying a mask of the size of the map, in its frame
+void BM_KeepoutFilterProcess(benchmark::State & state)
+{
+  const GridSpec spec = gridSpec(state);
+  const std::string name = "keepout_" + std::to_string(spec.size_x);
+  const std::string info_topic = name + "_info", mask_topic = name + "_mask";
+  setLayerParameter(name + ".filter_info_topic", info_topic);
+
+  // Latched info and mask, keeping a tenth of the map out
+  auto publisher_node = std::make_shared<rclcpp::Node>(name + "_publisher");
+  const auto latched = rclcpp::QoS(rclcpp::KeepLast(1)).transient_local().reliable();
+  auto info_pub =
+    publisher_node->create_publisher<nav2_msgs::msg::CostmapFilterInfo>(info_topic, latched);
+  auto mask_pub = publisher_node->create_publisher<nav_msgs::msg::OccupancyGrid>(
+    mask_topic, latched);
+  nav2_msgs::msg::CostmapFilterInfo info;
+  info.filter_mask_topic = mask_topic;
+  info.multiplier = 1.0f;
+  info_pub->publish(info);
+
+  nav2_costmap_2d::LayeredCostmap layers("map", false, false);
+  Costmap2D & master = *layers.getCostmap();
+  layers.resizeMap(spec.size_x, spec.size_y, spec.resolution, 0.0, 0.0);
+  fillCosts(master, state);
+  nav_msgs::msg::OccupancyGrid mask;
+  mask.header.frame_id = "map";
+  mask.info.width = spec.size_x;
+  mask.info.height = spec.size_y;
+  mask.info.resolution = spec.resolution;
+  mask.info.origin.orientation.w = 1.0;
+  mask.data.resize(spec.size_x * spec.size_y, 0);
+  for (size_t i = 0; i < mask.data.size(); i++) {
+    mask.data[i] = master.getCharMap()[i] == nav2_costmap_2d::LETHAL_OBSTACLE ? 100 : 0;
+  }
+  mask_pub->publish(mask);
+
+  auto filter = std::make_shared<nav2_costmap_2d::KeepoutFilter>();
+  filter->initialize(&layers, name, g_tf.get(), g_node, nullptr);
+  filter->activate();
+  const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+  while (!filter->isActive() && std::chrono::steady_clock::now() < deadline) {
+    rclcpp::spin_some(g_node->get_node_base_interface());
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  }
+  if (!filter->isActive()) {
+    state.SkipWithError("The keepout mask was not received");
+    return;
+  }
+
+  std::fill(
+    master.getCharMap(), master.getCharMap() + spec.size_x * spec.size_y,
+    nav2_costmap_2d::FREE_SPACE);
+  geometry_msgs::msg::Pose2D pose;
+  for (auto _ : state) {
+    filter->process(master, 0, 0, spec.size_x, spec.size_y, pose);
+  }
+  state.SetItemsProcessed(state.iterations() * spec.size_x * spec.size_y);
+  filter->deactivate();
+}
+
+// Rolling window shift by a few cells per cycle, as when following the robot
+void BM_UpdateOrigin(benchmark::State & state)
+{
+  const GridSpec spec = gridSpec(state);
+  Costmap2D costmap(spec.size_x, spec.size_y, spec.resolution, 0.0, 0.0);
+  fillCosts(costmap, state);
+
+  double x = 0.0;
+  for (auto _ : state) {
+    x += 3.5 * spec.resolution;
+    costmap.updateOrigin(x, 0.5 * x);
+  }
+  state.SetItemsProcessed(state.iterations() * spec.size_x * spec.size_y);
+}
+
+// Exposes the combiners of the costmap layers
+class CombinerLayer : public nav2_costmap_2d::CostmapLayer
+{
+public:
+  using CostmapLayer::updateWithTrueOverwrite;
+  using CostmapLayer::updateWithOverwrite;
+  using CostmapLayer::updateWithMax;
+  using CostmapLayer::updateWithAddition;
+
+  void reset() override {}
+  bool isClearable() override {return false;}
+  void updateBounds(double, double, double, double *, double *, double *, double *) override {}
+  void updateCosts(Costmap2D &, int, int, int, int) override {}
+};
+
+enum class Combiner { TRUE_OVERWRITE, OVERWRITE, MAX, ADDITION };
+
+// Combination of a layer holding obstacles and unknown cells into a master inflated grid
+void BM_CombineLayer(benchmark::State & state, Combiner combiner)
+{
+  const GridSpec spec = gridSpec(state);
+  Costmap2D master(spec.size_x, spec.size_y, spec.resolution, 0.0, 0.0);
+  CombinerLayer layer;
+  layer.resizeMap(spec.size_x, spec.size_y, spec.resolution, 0.0, 0.0);
+  fillCosts(layer, state);
+  fillCosts(master, state);
+  std::replace(
+    master.getCharMap(), master.getCharMap() + spec.size_x * spec.size_y,
+    nav2_costmap_2d::FREE_SPACE, static_cast<unsigned char>(50));
+  unsigned char * layer_costs = layer.getCharMap();
+  for (size_t i = 0; i < spec.size_x * spec.size_y; i += 7) {
+    layer_costs[i] = nav2_costmap_2d::NO_INFORMATION;
+  }
+
+  const int size_x = spec.size_x, size_y = spec.size_y;
+  for (auto _ : state) {
+    switch (combiner) {
+      case Combiner::TRUE_OVERWRITE:
+        layer.updateWithTrueOverwrite(master, 0, 0, size_x, size_y);
+        break;
+      case Combiner::OVERWRITE:
+        layer.updateWithOverwrite(master, 0, 0, size_x, size_y);
+        break;
+      case Combiner::MAX:
+        layer.updateWithMax(master, 0, 0, size_x, size_y);
+        break;
+      case Combiner::ADDITION:
+        layer.updateWithAddition(master, 0, 0, size_x, size_y);
+        break;
+    }
+    benchmark::ClobberMemory();
+  }
+  state.SetItemsProcessed(state.iterations() * spec.size_x * spec.size_y);
+}
+
+// Serialization of the full costmaps, or of updates of a tenth of the map, to a subscriber
+void BM_PublishCostmap(benchmark::State & state, bool full)
+{
+  const GridSpec spec = gridSpec(state);
+  Costmap2D costmap(spec.size_x, spec.size_y, spec.resolution, 0.0, 0.0);
+  fillCosts(costmap, state);
+
+  const std::string topic = std::string(full ? "full_" : "updates_") +
+    std::to_string(spec.size_x);
+  nav2_costmap_2d::Costmap2DPublisher publisher(g_node, &costmap, "map", topic, full);
+  publisher.on_activate();
+
+  auto subscriber_node = std::make_shared<rclcpp::Node>(topic + "_subscriber");
+  auto grid_sub = subscriber_node->create_subscription<nav_msgs::msg::OccupancyGrid>(
+    topic, 1, [](nav_msgs::msg::OccupancyGrid::ConstSharedPtr) {});
+  auto costmap_sub = subscriber_node->create_subscription<nav2_msgs::msg::Costmap>(
+    topic + "_raw", 1, [](nav2_msgs::msg::Costmap::ConstSharedPtr) {});
+  auto grid_update_sub = subscriber_node->create_subscription<map_msgs::msg::OccupancyGridUpdate>(
+    topic + "_updates", 1, [](map_msgs::msg::OccupancyGridUpdate::ConstSharedPtr) {});
+  auto costmap_update_sub = subscriber_node->create_subscription<nav2_msgs::msg::CostmapUpdate>(
+    topic + "_raw_updates", 1, [](nav2_msgs::msg::CostmapUpdate::ConstSharedPtr) {});
+  const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+  while ((grid_sub->get_publisher_count() == 0 || costmap_update_sub->get_publisher_count() == 0) &&
+    std::chrono::steady_clock::now() < deadline)
+  {
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  }
+  // Sends the full costmaps once, the updates are then sent alone
+  publisher.publishCostmap();
+
+  const unsigned int update_x = spec.size_x / 4, update_y = spec.size_y / 4;
+  for (auto _ : state) {
+    publisher.updateBounds(
+      update_x, update_x + spec.size_x / 3, update_y, update_y + spec.size_y / 3);
+    publisher.publishCostmap();
+  }
+  state.SetItemsProcessed(state.iterations() * spec.size_x * spec.size_y);
+  publisher.on_deactivate();
+}
+
+void gridArgs(benchmark::internal::Benchmark * b)
+{
+  b->ArgsProduct({{200, 1000, 2000}, {5}})->Unit(benchmark::kMicrosecond);
+}
+
+void gridResolutionArgs(benchmark::internal::Benchmark * b)
+{
+  b->ArgsProduct({{200, 1000, 2000}, {2, 5, 10}})->Unit(benchmark::kMicrosecond);
+}
+
+void cloudArgs(benchmark::internal::Benchmark * b)
+{
+  b->ArgsProduct({{200, 1000}, {360, 3600, 36000}})->Unit(benchmark::kMicrosecond);
+}
+
+}  // namespace
+
+BENCHMARK_CAPTURE(BM_InflationUpdateCosts, brushfire, false)->Apply(gridResolutionArgs);
+BENCHMARK_CAPTURE(BM_InflationUpdateCosts, distance_transform, true)->Apply(gridResolutionArgs);
+BENCHMARK_CAPTURE(
+  BM_ObservationUpdate<nav2_costmap_2d::ObstacleLayer>, obstacle_layer, "obstacles", 1.0)
+->Apply(cloudArgs);
+BENCHMARK_CAPTURE(
+  BM_ObservationUpdate<nav2_costmap_2d::VoxelLayer>, voxel_layer, "voxels", 1.5)
+->Apply(cloudArgs);
+BENCHMARK_CAPTURE(BM_DenoiseUpdateCosts, single_pixels, 2)->Apply(gridArgs);
+BENCHMARK_CAPTURE(BM_DenoiseUpdateCosts, groups, 5)->Apply(gridArgs);
+BENCHMARK(BM_KeepoutFilterProcess)->Apply(gridArgs);
+BENCHMARK(BM_UpdateOrigin)->Apply(gridArgs);
+BENCHMARK_CAPTURE(BM_CombineLayer, true_overwrite, Combiner::TRUE_OVERWRITE)->Apply(gridArgs);
+BENCHMARK_CAPTURE(BM_CombineLayer, overwrite, Combiner::OVERWRITE)->Apply(gridArgs);
+BENCHMARK_CAPTURE(BM_CombineLayer, max, Combiner::MAX)->Apply(gridArgs);
+BENCHMARK_CAPTURE(BM_CombineLayer, addition, Combiner::ADDITION)->Apply(gridArgs);
+BENCHMARK_CAPTURE(BM_PublishCostmap, full, true)->Apply(gridArgs);
+BENCHMARK_CAPTURE(BM_PublishCostmap, updates, false)->Apply(gridArgs);
+
+int main(int argc, char ** argv)
+{
+  benchmark::Initialize(&argc, argv);
+  const std::vector<std::string> args = rclcpp::init_and_remove_ros_arguments(argc, argv);
+
+  for (size_t i = 1; i < args.size(); i++) {
+    if (args[i].rfind("--costmap=", 0) == 0) {
+      if (nav2_map_server::loadMapFromYaml(args[i].substr(10), g_recorded) !=
+        nav2_map_server::LOAD_MAP_SUCCESS)
+      {
+        std::cerr << "Could not load the costmap " << args[i].substr(10) << std::endl;
+        return 1;
+      }
+    } else {
+      std::cerr << "Unknown argument " << args[i] << std::endl;
+      return 1;
+    }
+  }
+
+  g_node = std::make_shared<nav2_util::LifecycleNode>("costmap_benchmark");
+  g_tf = std::make_shared<tf2_ros::Buffer>(g_node->get_clock());
+
+  // The grid benchmarks again over the recorded costmap
+  if (!g_recorded.data.empty()) {
+    auto recorded = [](benchmark::internal::Benchmark * b) {
+        b->Args({0, 0})->Unit(benchmark::kMicrosecond);
+      };
+    benchmark::RegisterBenchmark(
+      "BM_InflationUpdateCosts/recorded", BM_InflationUpdateCosts, false)->Apply(recorded);
+    benchmark::RegisterBenchmark(
+      "BM_DenoiseUpdateCosts/recorded", BM_DenoiseUpdateCosts, 5)->Apply(recorded);
+    benchmark::RegisterBenchmark(
+      "BM_KeepoutFilterProcess/recorded", BM_KeepoutFilterProcess)->Apply(recorded);
+    benchmark::RegisterBenchmark("BM_UpdateOrigin/recorded", BM_UpdateOrigin)->Apply(recorded);
+    benchmark::RegisterBenchmark(
+      "BM_CombineLayer/recorded", BM_CombineLayer, Combiner::MAX)->Apply(recorded);
+    benchmark::RegisterBenchmark(
+      "BM_PublishCostmap/recorded", BM_PublishCostmap, false)->Apply(recorded);
+  }
+
+  benchmark::RunSpecifiedBenchmarks();
+
+  g_tf.reset();
+  g_node.reset();
+  benchmark::Shutdown();
+  rclcpp::shutdown();
+  return 0;
+}
@@ -15,9 +15,14 @@
 #ifndef NAV2_COSTMAP_2D__CLEAR_COSTMAP_SERVICE_HPP_
 #define NAV2_COSTMAP_2D__CLEAR_COSTMAP_SERVICE_HPP_
 
-#include <vector>
-#include <string>
+#include <chrono>
+#include <deque>
+#include <functional>
+#include <future>
 #include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
 
 #include "rclcpp/rclcpp.hpp"
 #include "nav2_msgs/srv/clear_costmap_except_region.hpp"
@@ -58,7 +63,31 @@ public:
    */
   void clearEntirely();
 
+  /**
+   * @brief Applies the clear requests queued by the service callbacks.
+   * Called by the map update thread between two updates, so requests never
+   * contend with a running layer update.
+   */
+  void applyPendingClears();
+
 private:
+  /**
+   * @brief A clear request waiting for the next map update boundary
+   */
+  struct PendingClear
+  {
+    std::function<void()> apply;
+    std::promise<void> done;
+  };
+
+  /**
+   * @brief Queues a clear for the map update thread and waits until it is applied.
+   * Falls back to applying it in the calling thread when the update loop is not
+   * running or does not pick the request up in time.
+   */
+  void scheduleClear(std::function<void()> apply);
+
+
   // The Logger object for logging
   rclcpp::Logger logger_{rclcpp::get_logger("nav2_costmap_2d")};
 
@@ -68,6 +97,11 @@ private:
   // Clearing parameters
   unsigned char reset_value_;
 
+  // Clear requests waiting for the map update thread
+  std::mutex pending_mutex_;
+  std::deque<std::shared_ptr<PendingClear>> pending_clears_;
+  std::chrono::milliseconds pending_timeout_{2000};
+
   // Server for clearing the costmap
   rclcpp::Service<nav2_msgs::srv::ClearCostmapExceptRegion>::SharedPtr clear_except_service_;
   /**
@@ -0,0 +1,106 @@
+// Copyright (c) 2024 Open Navigation LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef NAV2_COSTMAP_2D__COST_COMBINATION_HPP_
+#define NAV2_COSTMAP_2D__COST_COMBINATION_HPP_
+
+#include <cstring>
+
+#include "nav2_costmap_2d/cost_values.hpp"
+
+namespace nav2_costmap_2d
+{
+
+// Row kernels combining the costs of a layer into the master grid. Each cell is
+// loaded, selected and stored unconditionally so the compiler can turn the loops
+// into SIMD code for whatever instruction set the package is built for.
+
+/**
+ * @brief Keep the highest known cost, unknown master cells take the layer cost
+ */
+inline void combineRowMax(unsigned char * master, const unsigned char * layer, unsigned int n)
+{
+  for (unsigned int i = 0; i < n; ++i) {
+    const unsigned char cost = layer[i];
+    const unsigned char old_cost = master[i];
+    const bool take = cost != NO_INFORMATION && (old_cost == NO_INFORMATION || old_cost < cost);
+    master[i] = take ? cost : old_cost;
+  }
+}
+
+/**
+ * @brief Keep the highest known cost, leaving unknown master cells unknown
+ */
+inline void combineRowMaxWithoutUnknownOverwrite(
+  unsigned char * master, const unsigned char * layer, unsigned int n)
+{
+  for (unsigned int i = 0; i < n; ++i) {
+    const unsigned char cost = layer[i];
+    const unsigned char old_cost = master[i];
+    const bool take = cost != NO_INFORMATION && old_cost != NO_INFORMATION && old_cost < cost;
+    master[i] = take ? cost : old_cost;
+  }
+}
+
+/**
+ * @brief Copy the layer costs, unknown included
+ */
+inline void combineRowTrueOverwrite(
+  unsigned char * master, const unsigned char * layer, unsigned int n)
+{
+  memcpy(master, layer, n);
+}
+
+/**
+ * @brief Copy the known layer costs
+ */
+inline void combineRowOverwrite(unsigned char * master, const unsigned char * layer, unsigned int n)
+{
+  for (unsigned int i = 0; i < n; ++i) {
+    const unsigned char cost = layer[i];
+    master[i] = cost != NO_INFORMATION ? cost : master[i];
+  }
+}
+
+/**
+ * @brief Add the known layer costs, saturating below INSCRIBED_INFLATED_OBSTACLE.
+ * Unknown master cells take the layer cost.
+ */
+inline void combineRowAddition(unsigned char * master, const unsigned char * layer, unsigned int n)
+{
+  for (unsigned int i = 0; i < n; ++i) {
+    const unsigned int cost = layer[i];
+    const unsigned int old_cost = master[i];
+    unsigned int sum = old_cost + cost;
+    sum = sum < INSCRIBED_INFLATED_OBSTACLE ? sum : INSCRIBED_INFLATED_OBSTACLE - 1;
+    const unsigned int known = old_cost == NO_INFORMATION ? cost : sum;
+    master[i] = static_cast<unsigned char>(cost == NO_INFORMATION ? old_cost : known);
+  }
+}
+
+/**
+ * @brief Translate costs through a 256 entry lookup table
+ */
+template<typename OutT, typename TableT>
+inline void translateRow(
+  OutT * output, const unsigned char * costs, const TableT * table, unsigned int n)
+{
+  for (unsigned int i = 0; i < n; ++i) {
+    output[i] = static_cast<OutT>(table[costs[i]]);
+  }
+}
+
+}  // namespace nav2_costmap_2d
+
+#endif  // NAV2_COSTMAP_2D__COST_COMBINATION_HPP_
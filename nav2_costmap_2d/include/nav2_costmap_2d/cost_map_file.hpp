@@ -0,0 +1,129 @@
+// Copyright (c) 2024 Open Navigation LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef NAV2_COSTMAP_2D__COST_MAP_FILE_HPP_
+#define NAV2_COSTMAP_2D__COST_MAP_FILE_HPP_
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+#include "nav2_costmap_2d/costmap_2d.hpp"
+
+namespace nav2_costmap_2d
+{
+
+/**
+ * @struct CostMapFileHeader
+ * @brief Header of a cost map file. It is directly followed by size_x * size_y
+ * costs in row-major order, already in costmap values so the file can be mapped
+ * into memory and used as is.
+ */
+struct CostMapFileHeader
+{
+  static constexpr char MAGIC[8] = {'N', 'A', 'V', '2', 'C', 'M', 'A', 'P'};
+  static constexpr uint32_t VERSION = 1;
+
+  char magic[8];
+  uint32_t version;
+  uint32_t size_x;
+  uint32_t size_y;
+  // Hash of the static map the costs were built over, 0 if unspecified
+  uint32_t map_hash;
+  double resolution;
+  double origin_x;
+  double origin_y;
+  char frame_id[64];
+};
+
+/**
+ * @brief Write a costmap to a cost map file
+ * @param path Path of the file to write
+ * @param costmap Costmap to save
+ * @param frame_id Frame the costmap is expressed in, at most 63 characters
+ * @param map_hash Hash of the static map the costs were built over, 0 if unspecified
+ * @return True if the file was written
+ */
+bool saveCostMapFile(
+  const std::string & path, const Costmap2D & costmap, const std::string & frame_id,
+  uint32_t map_hash = 0);
+
+/**
+ * @brief Hash costs, to tell whether costs saved along with them are still valid
+ * @param costs Costs to hash
+ * @param size Number of costs
+ * @param hash Hash to continue, for costs in several parts
+ * @return FNV-1a hash of the costs, never 0
+ */
+uint32_t hashCosts(const unsigned char * costs, size_t size, uint32_t hash = 2166136261u);
+
+/**
+ * @class MappedCostMapFile
+ * @brief A cost map file mapped into memory. The mapping is private: costs may be
+ * written, but modified pages are copied on write and never reach the file, while
+ * untouched pages stay backed by the file and are only read from disk when accessed.
+ */
+class MappedCostMapFile
+{
+public:
+  MappedCostMapFile() = default;
+  ~MappedCostMapFile();
+
+  MappedCostMapFile(const MappedCostMapFile &) = delete;
+  MappedCostMapFile & operator=(const MappedCostMapFile &) = delete;
+
+  /**
+   * @brief Map a cost map file, unmapping any previously mapped one
+   * @param path Path of the file to map
+   * @param error Set to the reason of the failure, if any
+   * @return True if the file is valid and was mapped
+   */
+  bool open(const std::string & path, std::string & error);
+
+  /**
+   * @brief Unmap the file
+   */
+  void close();
+
+  /**
+   * @brief Drop all modified pages, so the costs read back as stored in the file
+   */
+  void revert();
+
+  bool isOpen() const {return base_ != nullptr;}
+
+  /**
+   * @brief Header of the mapped file, only valid while it is open
+   */
+  const CostMapFileHeader & getHeader() const
+  {
+    return *static_cast<const CostMapFileHeader *>(base_);
+  }
+
+  /**
+   * @brief Costs of the mapped file, only valid while it is open
+   */
+  unsigned char * getData() const
+  {
+    return static_cast<unsigned char *>(base_) + sizeof(CostMapFileHeader);
+  }
+
+protected:
+  void * base_{nullptr};
+  size_t length_{0};
+};
+
+}  // namespace nav2_costmap_2d
+
+#endif  // NAV2_COSTMAP_2D__COST_MAP_FILE_HPP_
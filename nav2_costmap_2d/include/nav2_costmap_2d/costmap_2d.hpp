@@ -302,6 +302,19 @@ public:
     return default_value_;
   }
 
+  /**
+   * @brief Store the costmap sparsely from its next allocation on, for maps left
+   * at their default value almost everywhere. The map is mapped copy-on-write over
+   * pages of the default value shared by all sparse maps, so only the pages written
+   * to take memory, and resetting the map releases them. Falls back to a dense map
+   * where memory mapping is not available.
+   * @param sparse Whether to store the costmap sparsely
+   */
+  void setSparseStorage(bool sparse)
+  {
+    sparse_storage_ = sparse;
+  }
+
   /**
    * @brief  Sets the cost of a convex polygon to a desired value
    * @param polygon The polygon to perform the operation on
@@ -409,6 +422,52 @@ protected:
     }
   }
 
+  /**
+   * @brief  Shift a map in place by a whole number of cells, so that the cell at
+   * (x + cell_ox, y + cell_oy) moves to (x, y). Only the newly exposed strips are set
+   * to the fill value, no scratch copy or full reset is needed.
+   * @param map The map to shift, of size_x_ by size_y_ cells
+   * @param cell_ox The shift of the window in x, in cells
+   * @param cell_oy The shift of the window in y, in cells
+   * @param fill_value The value for cells that were outside of the old window
+   */
+  template<typename data_type>
+  void shiftMapRegion(data_type * map, int cell_ox, int cell_oy, data_type fill_value)
+  {
+    const int size_x = size_x_;
+    const int size_y = size_y_;
+    if (cell_ox == 0 && cell_oy == 0) {
+      return;
+    }
+    if (std::abs(cell_ox) >= size_x || std::abs(cell_oy) >= size_y) {
+      std::fill_n(map, static_cast<size_t>(size_x) * size_y, fill_value);
+      return;
+    }
+
+    // columns of each destination row that keep data, and where that data comes from
+    const int keep_x0 = std::max(0, -cell_ox);
+    const int keep_xn = std::min(size_x, size_x - cell_ox);
+    const size_t keep_size = keep_xn - keep_x0;
+
+    // walk rows away from the source rows still to be read, so memmove never
+    // overwrites data that has not been moved yet
+    const int first_y = cell_oy >= 0 ? 0 : size_y - 1;
+    const int step_y = cell_oy >= 0 ? 1 : -1;
+    for (int i = 0, y = first_y; i < size_y; ++i, y += step_y) {
+      data_type * row = map + static_cast<size_t>(y) * size_x;
+      const int source_y = y + cell_oy;
+      if (source_y < 0 || source_y >= size_y) {
+        std::fill_n(row, size_x, fill_value);
+        continue;
+      }
+
+      const data_type * source_row = map + static_cast<size_t>(source_y) * size_x;
+      memmove(row + keep_x0, source_row + keep_x0 + cell_ox, keep_size * sizeof(data_type));
+      std::fill(row, row + keep_x0, fill_value);
+      std::fill(row + keep_xn, row + size_x, fill_value);
+    }
+  }
+
   /**
    * @brief  Deletes the costmap, static_map, and markers data structures
    */
@@ -426,6 +485,17 @@ protected:
    */
   virtual void initMaps(unsigned int size_x, unsigned int size_y);
 
+  /**
+   * @brief  Allocates the costmap, mapping it sparsely if sparse storage is set
+   * @param size The number of cells
+   */
+  void allocateMap(size_t size);
+
+  /**
+   * @brief  Frees the costmap, however it was allocated
+   */
+  void freeMap();
+
   /**
    * @brief  Raytrace a line and apply some action at each step
    * @param  at The action to take... a functor
@@ -536,6 +606,10 @@ protected:
   unsigned char * costmap_;
   unsigned char default_value_;
 
+  // With sparse storage, size of the mapping of the costmap if mapped, 0 if allocated
+  bool sparse_storage_{false};
+  size_t mapped_size_{0};
+
   // *INDENT-OFF* Uncrustify doesn't handle indented public/private labels
   class MarkCell
   {
@@ -42,6 +42,7 @@
 #include <algorithm>
 #include <string>
 #include <memory>
+#include <vector>
 
 #include "rclcpp_lifecycle/lifecycle_node.hpp"
 #include "nav2_costmap_2d/costmap_2d.hpp"
@@ -49,6 +50,7 @@
 #include "map_msgs/msg/occupancy_grid_update.hpp"
 #include "nav2_msgs/msg/costmap.hpp"
 #include "nav2_msgs/msg/costmap_update.hpp"
+#include "nav2_msgs/msg/costmap_compressed_update.hpp"
 #include "nav2_msgs/srv/get_costmap.hpp"
 #include "tf2/transform_datatypes.h"
 #include "nav2_util/lifecycle_node.hpp"
@@ -66,13 +68,18 @@ class Costmap2DPublisher
 public:
   /**
    * @brief  Constructor for the Costmap2DPublisher
+   * @param publish_compressed_updates Also stream run-length encoded keyframes and
+   * deltas on <topic_name>_raw_compressed_updates
+   * @param keyframe_interval Maximum number of deltas sent between two keyframes
    */
   Costmap2DPublisher(
     const nav2_util::LifecycleNode::WeakPtr & parent,
     Costmap2D * costmap,
     std::string global_frame,
     std::string topic_name,
-    bool always_send_full_costmap = false);
+    bool always_send_full_costmap = false,
+    bool publish_compressed_updates = false,
+    unsigned int keyframe_interval = 10);
 
   /**
    * @brief  Destructor
@@ -93,6 +100,9 @@ public:
     costmap_update_pub_->on_activate();
     costmap_raw_pub_->on_activate();
     costmap_raw_update_pub_->on_activate();
+    if (costmap_compressed_update_pub_) {
+      costmap_compressed_update_pub_->on_activate();
+    }
   }
 
   /**
@@ -104,6 +114,9 @@ public:
     costmap_update_pub_->on_deactivate();
     costmap_raw_pub_->on_deactivate();
     costmap_raw_update_pub_->on_deactivate();
+    if (costmap_compressed_update_pub_) {
+      costmap_compressed_update_pub_->on_deactivate();
+    }
   }
 
   /**
@@ -139,11 +152,25 @@ private:
   void prepareGrid();
   void prepareCostmap();
 
+  /**
+   * @brief Fill a grid message in place from the current costmap, so the
+   * same code serves heap allocated and middleware loaned messages.
+   */
+  void fillGrid(nav_msgs::msg::OccupancyGrid & grid);
+  /** @brief Fill a raw costmap message in place from the current costmap. */
+  void fillCostmap(nav2_msgs::msg::Costmap & costmap);
+
   /** @brief Prepare OccupancyGridUpdate msg for publication. */
   std::unique_ptr<map_msgs::msg::OccupancyGridUpdate> createGridUpdateMsg();
   /** @brief Prepare CostmapUpdate msg for publication. */
   std::unique_ptr<nav2_msgs::msg::CostmapUpdate> createCostmapUpdateMsg();
 
+  /**
+   * @brief Publish a compressed keyframe or delta of the changed-rectangle.
+   * @param force_keyframe Send the whole costmap even if no keyframe is due
+   */
+  void publishCompressedUpdate(bool force_keyframe);
+
   /** @brief Publish the latest full costmap to the new subscriber. */
   // void onNewSubscription(const ros::SingleSubscriberPublisher& pub);
 
@@ -177,6 +204,17 @@ private:
   rclcpp_lifecycle::LifecyclePublisher<nav2_msgs::msg::CostmapUpdate>::SharedPtr
     costmap_raw_update_pub_;
 
+  // Publisher for compressed keyframes and deltas of the raw costmap
+  rclcpp_lifecycle::LifecyclePublisher<nav2_msgs::msg::CostmapCompressedUpdate>::SharedPtr
+    costmap_compressed_update_pub_;
+  unsigned int keyframe_interval_;
+  unsigned int deltas_since_keyframe_{0};
+  uint64_t compressed_sequence_{0};
+  bool had_compressed_subscribers_{false};
+  // Costs as last sent on the compressed stream, the reference for deltas
+  std::vector<unsigned char> compressed_reference_;
+  std::vector<unsigned char> compressed_delta_;
+
   // Service for getting the costmaps
   rclcpp::Service<nav2_msgs::srv::GetCostmap>::SharedPtr costmap_service_;
 
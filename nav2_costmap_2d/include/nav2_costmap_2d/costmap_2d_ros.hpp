@@ -39,19 +39,26 @@
 #define NAV2_COSTMAP_2D__COSTMAP_2D_ROS_HPP_
 
 #include <atomic>
+#include <chrono>
+#include <condition_variable>
 #include <memory>
+#include <mutex>
 #include <string>
 #include <vector>
 
 #include "geometry_msgs/msg/polygon.h"
 #include "geometry_msgs/msg/polygon_stamped.h"
 #include "nav2_costmap_2d/costmap_2d_publisher.hpp"
+#include "nav2_costmap_2d/costmap_pyramid.hpp"
+#include "nav2_costmap_2d/costmap_queries.hpp"
 #include "nav2_costmap_2d/footprint.hpp"
 #include "nav2_costmap_2d/clear_costmap_service.hpp"
 #include "nav2_costmap_2d/layered_costmap.hpp"
 #include "nav2_costmap_2d/layer.hpp"
 #include "nav2_util/lifecycle_node.hpp"
+#include "nav2_util/robot_pose_cache.hpp"
 #include "pluginlib/class_loader.hpp"
+#include "std_msgs/msg/float64.hpp"
 #include "tf2/convert.h"
 #include "tf2/LinearMath/Transform.h"
 #include "tf2_ros/buffer.h"
@@ -93,12 +100,15 @@ public:
    * @param parent_namespace Absolute namespace of the node hosting the costmap node
    * @param local_namespace Namespace to append to the parent namespace
    * @param use_sim_time Whether to use simulation or real time
+   * @param use_intra_process_comms Whether to use intra-process communication, e.g.
+   * as the node hosting the costmap node does
    */
   explicit Costmap2DROS(
     const std::string & name,
     const std::string & parent_namespace,
     const std::string & local_namespace,
-    const bool & use_sim_time);
+    const bool & use_sim_time,
+    const bool & use_intra_process_comms = false);
 
   /**
    * @brief Common initialization for constructors
@@ -189,6 +199,15 @@ public:
    */
   void resetLayers();
 
+  /**
+   * @brief Whether the map update thread is running and updating the layers
+   */
+  bool isUpdateLoopRunning() const
+  {
+    return map_update_thread_ && !map_update_thread_shutdown_ && !stopped_ &&
+           map_update_frequency_ > 0.0;
+  }
+
   /** @brief Same as getLayeredCostmap()->isCurrent(). */
   bool isCurrent()
   {
@@ -234,6 +253,37 @@ public:
     return layered_costmap_->getCostmap();
   }
 
+  /**
+   * @brief Return the latest immutable snapshot of the "master" costmap.
+   *
+   * Unlike getCostmap(), the snapshot may be read without locking the costmap mutex,
+   * so readers are never blocked by a running map update.
+   */
+  CostmapSnapshot::ConstPtr getCostmapSnapshot()
+  {
+    return layered_costmap_->getSnapshot();
+  }
+
+  /**
+   * @brief Return the shared queries on the latest snapshot of the "master" costmap.
+   *
+   * Every caller gets the same object until the snapshot is replaced, so footprint
+   * rasterizations and distance fields are computed once for all the plugins
+   * reading this costmap.
+   */
+  CostmapQueries::ConstPtr getCostmapQueries();
+
+  /**
+   * @brief Return the max-pooled pyramid of the "master" costmap, kept up to date
+   * after every map update, with level i downsampled by 2^(i+1).
+   * Lock the mutex of a level while reading it.
+   * @return Pointer to the pyramid, nullptr if pyramid_levels is 0
+   */
+  CostmapPyramid * getCostmapPyramid()
+  {
+    return costmap_pyramid_.get();
+  }
+
   /**
    * @brief  Returns the global frame of the costmap
    * @return The global frame of the costmap
@@ -292,7 +342,8 @@ public:
   }
 
   /**
-   * @brief  Build the oriented footprint of the robot at the robot's current pose
+   * @brief  Build the oriented footprint of the robot at the robot's current pose, transformed
+   * only once per pose for all the callers
    * @param  oriented_footprint Will be filled with the points in the oriented footprint of the robot
    */
   void getOrientedFootprint(std::vector<geometry_msgs::msg::Point> & oriented_footprint);
@@ -343,10 +394,19 @@ protected:
   // Publishers and subscribers
   rclcpp_lifecycle::LifecyclePublisher<geometry_msgs::msg::PolygonStamped>::SharedPtr
     footprint_pub_;
+  // Duration of each map update in seconds, when publish_update_time is set
+  rclcpp_lifecycle::LifecyclePublisher<std_msgs::msg::Float64>::SharedPtr update_time_pub_;
   std::unique_ptr<Costmap2DPublisher> costmap_publisher_;
 
   std::vector<std::unique_ptr<Costmap2DPublisher>> layer_publishers_;
 
+  std::unique_ptr<CostmapPyramid> costmap_pyramid_;
+
+  // Queries on the latest snapshot handed out, replaced along with the snapshot
+  std::mutex costmap_queries_mutex_;
+  CostmapQueries::ConstPtr costmap_queries_;
+  std::vector<std::unique_ptr<Costmap2DPublisher>> pyramid_publishers_;
+
   rclcpp::Subscription<geometry_msgs::msg::Polygon>::SharedPtr footprint_sub_;
   rclcpp::Subscription<rcl_interfaces::msg::ParameterEvent>::SharedPtr parameter_sub_;
 
@@ -367,11 +427,73 @@ protected:
    * @brief Function on timer for costmap update
    */
   void mapUpdateLoop(double frequency);
-  bool map_update_thread_shutdown_{false};
+
+  /**
+   * @brief Wake the map update loop in event driven mode
+   */
+  void requestMapUpdate();
+
+  /**
+   * @brief Whether an update is due in event driven mode: new data was signaled,
+   * the robot moved beyond the thresholds or the minimum update rate is due.
+   * Consumes the pending update request.
+   */
+  bool isMapUpdateDue();
+
+  /**
+   * @brief Sleep until the next update is allowed by the maximum rate, then wait
+   * for an update request for at most one period
+   */
+  void waitForMapUpdateRequest(std::chrono::nanoseconds period);
+
+  /**
+   * @brief Save the master costmap and the grids of the layers built from observations
+   * to the state persistence directory, along with the hash of the static maps
+   */
+  void saveState();
+
+  /**
+   * @brief Restore the costmaps saved by saveState, if the static maps are received and
+   * the saved costmaps are still valid for them and for the costmap geometry
+   * @return True if the master costmap was restored
+   */
+  bool restoreState();
+
+  /**
+   * @brief Restore a costmap from a saved state file
+   * @param path Path of the file
+   * @param costmap Costmap to restore, locked while written
+   * @param map_hash Hash of the current static maps
+   * @return True if the file was valid and restored
+   */
+  bool restoreCostmap(const std::string & path, Costmap2D & costmap, uint32_t map_hash);
+
+  /**
+   * @brief Get the path of the state file of a costmap
+   * @param layer_name Name of the layer, empty for the master costmap
+   */
+  std::string getStateFilePath(const std::string & layer_name) const;
+
+  /**
+   * @brief Get the hash of the grids of the static map layers, 0 if there are none
+   * @param ready Set to whether all the static maps were received
+   */
+  uint32_t getStaticMapHash(bool & ready);
+
+  std::atomic<bool> map_update_thread_shutdown_{false};
   std::atomic<bool> stop_updates_{false};
   std::atomic<bool> initialized_{false};
   std::atomic<bool> stopped_{true};
   std::mutex _dynamic_parameter_mutex;
+  std::mutex update_request_mutex_;
+  std::condition_variable update_request_cv_;
+  bool update_requested_{false};
+  bool has_last_update_pose_{false};
+  double last_update_x_{0};
+  double last_update_y_{0};
+  double last_update_yaw_{0};
+  std::chrono::steady_clock::time_point last_update_time_;
+  std::chrono::steady_clock::time_point last_state_save_;
   std::unique_ptr<std::thread> map_update_thread_;  ///< @brief A thread for updating the map
   rclcpp::Time last_publish_{0, 0, RCL_ROS_TIME};
   rclcpp::Duration publish_cycle_{1, 0};
@@ -382,15 +504,25 @@ protected:
    */
   void getParameters();
   bool always_send_full_costmap_{false};
+  bool publish_compressed_updates_{false};
+  bool publish_update_time_{false};
+  unsigned int compressed_keyframe_interval_{10};  ///< Max deltas between keyframes, 0 for none
   std::string footprint_;
   float footprint_padding_{0};
   std::string global_frame_;                ///< The global frame for the costmap
   int map_height_meters_{0};
   double map_publish_frequency_{0};
   double map_update_frequency_{0};
+  bool event_driven_updates_{false};  ///< Update on new data or motion, update_frequency is the max
+  double min_update_frequency_{0};  ///< Minimum rate of event driven updates, 0 for none
+  double update_distance_threshold_{0};  ///< Robot motion triggering an event driven update
+  double update_angle_threshold_{0};  ///< Robot rotation triggering an event driven update
+  int update_tile_size_{0};  ///< Side of the dirty tracking tiles in cells, 0 for bounding box
+  int pyramid_levels_{0};  ///< Number of downsampled levels to maintain, 0 for none
   int map_width_meters_{0};
   double origin_x_{0};
   double origin_y_{0};
+  int parallel_update_threads_{0};  ///< Threads for concurrent layer updates, 0 for serial
   std::vector<std::string> default_plugins_;
   std::vector<std::string> default_types_;
   std::vector<std::string> plugin_names_;
@@ -401,9 +533,13 @@ protected:
   std::string robot_base_frame_;            ///< The frame_id of the robot base
   double robot_radius_;
   bool rolling_window_{false};          ///< Whether to use a rolling window version of the costmap
+  std::string state_persistence_directory_;  ///< Where costmaps are saved for restarts, or empty
+  double state_save_period_{0};  ///< Period of the state saves, 0 to save on deactivation only
   bool track_unknown_space_{false};
   double transform_tolerance_{0};           ///< The timeout before transform errors
   double initial_transform_timeout_{0};   ///< The timeout before activation of the node errors
+  double robot_pose_cache_period_{0};  ///< Age of a shared robot pose before a lookup, 0 for none
+  std::shared_ptr<nav2_util::RobotPoseCache> robot_pose_cache_;
 
   bool is_lifecycle_follower_{true};   ///< whether is a child-LifecycleNode or an independent node
 
@@ -411,6 +547,8 @@ protected:
   bool use_radius_{false};
   std::vector<geometry_msgs::msg::Point> unpadded_footprint_;
   std::vector<geometry_msgs::msg::Point> padded_footprint_;
+  // Padded footprint at the last pose it was oriented for
+  OrientedFootprintCache oriented_footprint_cache_;
 
   std::unique_ptr<ClearCostmapService> clear_costmap_service_;
 
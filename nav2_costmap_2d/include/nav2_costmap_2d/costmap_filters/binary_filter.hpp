@@ -94,7 +94,11 @@ private:
   /**
    * @brief Callback for the filter mask
    */
-  void maskCallback(const nav_msgs::msg::OccupancyGrid::SharedPtr msg);
+  void maskCallback(const nav_msgs::msg::OccupancyGrid::ConstSharedPtr msg);
+  /**
+   * @brief Callback for the filter mask, when published as a sparse one
+   */
+  void sparseMaskCallback(const nav2_msgs::msg::SparseFilterMask::ConstSharedPtr msg);
   /**
    * @brief Changes binary state of filter. Sends a message with new state.
    * @param state New binary state
@@ -104,10 +108,13 @@ private:
   // Working with filter info and mask
   rclcpp::Subscription<nav2_msgs::msg::CostmapFilterInfo>::SharedPtr filter_info_sub_;
   rclcpp::Subscription<nav_msgs::msg::OccupancyGrid>::SharedPtr mask_sub_;
+  rclcpp::Subscription<nav2_msgs::msg::SparseFilterMask>::SharedPtr sparse_mask_sub_;
 
   rclcpp_lifecycle::LifecyclePublisher<std_msgs::msg::Bool>::SharedPtr binary_state_pub_;
 
-  nav_msgs::msg::OccupancyGrid::SharedPtr filter_mask_;
+  nav_msgs::msg::OccupancyGrid::ConstSharedPtr filter_mask_;
+  // Filter mask received as a sparse one, instead of filter_mask_
+  nav2_msgs::msg::SparseFilterMask::ConstSharedPtr sparse_mask_;
 
   std::string global_frame_;  // Frame of currnet layer (master_grid)
 
@@ -49,6 +49,7 @@
 #include "std_srvs/srv/set_bool.hpp"
 #include "nav2_costmap_2d/layer.hpp"
 #include "nav_msgs/msg/occupancy_grid.hpp"
+#include "nav2_msgs/msg/sparse_filter_mask.hpp"
 
 namespace nav2_costmap_2d
 {
@@ -198,6 +199,19 @@ protected:
     nav_msgs::msg::OccupancyGrid::ConstSharedPtr filter_mask,
     double wx, double wy, unsigned int & mx, unsigned int & my) const;
 
+  /**
+   * @brief: Convert from world coordinates to the coordinates of a mask described by info
+   * @param  info Metadata of the filter mask on which to convert
+   * @param  wx The x world coordinate
+   * @param  wy The y world coordinate
+   * @param  mx Will be set to the associated mask x coordinate
+   * @param  my Will be set to the associated mask y coordinate
+   * @return True if the conversion was successful (legal bounds) false otherwise
+   */
+  bool worldToMask(
+    const nav_msgs::msg::MapMetaData & info,
+    double wx, double wy, unsigned int & mx, unsigned int & my) const;
+
   /**
    * @brief  Get the data of a cell in the filter mask
    * @param  filter_mask Filter mask to get the data from
@@ -223,6 +237,24 @@ protected:
     nav_msgs::msg::OccupancyGrid::ConstSharedPtr filter_mask,
     const unsigned int mx, const unsigned int & my) const;
 
+  /**
+   * @brief  Get the data of a cell in a sparse filter mask, by bisection of its runs
+   * @param  sparse_mask Sparse filter mask to get the data from
+   * @param  mx The x coordinate of the cell
+   * @param  my The y coordinate of the cell
+   * @return The data of the selected cell
+   */
+  int8_t getMaskData(
+    nav2_msgs::msg::SparseFilterMask::ConstSharedPtr sparse_mask,
+    const unsigned int mx, const unsigned int my) const;
+
+  /**
+   * @brief  Convert filter mask data to a cost
+   * @param  data OccupancyGrid value of a filter mask cell
+   * @return The cost to set the cell to
+   */
+  unsigned char dataToCost(const int8_t data) const;
+
   /**
    * @brief: Name of costmap filter info topic
    */
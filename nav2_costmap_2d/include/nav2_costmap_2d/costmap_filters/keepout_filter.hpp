@@ -40,6 +40,7 @@
 
 #include <string>
 #include <memory>
+#include <vector>
 
 #include "nav2_costmap_2d/costmap_filters/costmap_filter.hpp"
 
@@ -94,12 +95,69 @@ private:
   /**
    * @brief Callback for the filter mask
    */
-  void maskCallback(const nav_msgs::msg::OccupancyGrid::SharedPtr msg);
+  void maskCallback(const nav_msgs::msg::OccupancyGrid::ConstSharedPtr msg);
+  /**
+   * @brief Callback for the filter mask, when published as a sparse one
+   */
+  void sparseMaskCallback(const nav2_msgs::msg::SparseFilterMask::ConstSharedPtr msg);
+
+  /**
+   * @brief Split every row of filter_mask_ into runs of cells with equal cost,
+   * leaving out unknown cells which never change the master grid
+   */
+  void buildMaskRuns();
+
+  /**
+   * @brief Get the runs of sparse_mask_ rows, filling the cells between the
+   * runs of the message with its default value
+   */
+  void buildSparseMaskRuns();
+
+  /**
+   * @brief Get the cost of a mask cell from the mask runs
+   * @param mx The x coordinate of the cell
+   * @param my The y coordinate of the cell
+   * @return The cost of the cell, NO_INFORMATION out of any run
+   */
+  unsigned char getMaskRunCost(unsigned int mx, unsigned int my) const;
+
+  /**
+   * @brief Get the metadata of the filter mask received, dense or sparse
+   */
+  const nav_msgs::msg::MapMetaData & getMaskInfo() const
+  {
+    return filter_mask_ ? filter_mask_->info : sparse_mask_->info;
+  }
+
+  /**
+   * @brief Apply the mask runs to a master_grid window, when master_grid and
+   * filter_mask_ share their frame. Only cells covered by a run are visited.
+   */
+  void applyMaskRuns(
+    nav2_costmap_2d::Costmap2D & master_grid,
+    unsigned int min_i, unsigned int min_j, unsigned int max_i, unsigned int max_j);
+
+  /**
+   * @struct MaskRun
+   * @brief Cells [x0, xn) of a filter mask row sharing the same cost
+   */
+  struct MaskRun
+  {
+    unsigned int x0;
+    unsigned int xn;
+    unsigned char cost;
+  };
 
   rclcpp::Subscription<nav2_msgs::msg::CostmapFilterInfo>::SharedPtr filter_info_sub_;
   rclcpp::Subscription<nav_msgs::msg::OccupancyGrid>::SharedPtr mask_sub_;
-
-  nav_msgs::msg::OccupancyGrid::SharedPtr filter_mask_;
+  rclcpp::Subscription<nav2_msgs::msg::SparseFilterMask>::SharedPtr sparse_mask_sub_;
+
+  nav_msgs::msg::OccupancyGrid::ConstSharedPtr filter_mask_;
+  // Filter mask received as a sparse one, instead of filter_mask_
+  nav2_msgs::msg::SparseFilterMask::ConstSharedPtr sparse_mask_;
+  // Runs of filter_mask_ rows, row y owning runs [mask_row_start_[y], mask_row_start_[y + 1])
+  std::vector<MaskRun> mask_runs_;
+  std::vector<size_t> mask_row_start_;
 
   std::string global_frame_;  // Frame of currnet layer (master_grid)
 };
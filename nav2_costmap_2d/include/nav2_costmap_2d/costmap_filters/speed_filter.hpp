@@ -94,14 +94,21 @@ private:
   /**
    * @brief Callback for the filter mask
    */
-  void maskCallback(const nav_msgs::msg::OccupancyGrid::SharedPtr msg);
+  void maskCallback(const nav_msgs::msg::OccupancyGrid::ConstSharedPtr msg);
+  /**
+   * @brief Callback for the filter mask, when published as a sparse one
+   */
+  void sparseMaskCallback(const nav2_msgs::msg::SparseFilterMask::ConstSharedPtr msg);
 
   rclcpp::Subscription<nav2_msgs::msg::CostmapFilterInfo>::SharedPtr filter_info_sub_;
   rclcpp::Subscription<nav_msgs::msg::OccupancyGrid>::SharedPtr mask_sub_;
+  rclcpp::Subscription<nav2_msgs::msg::SparseFilterMask>::SharedPtr sparse_mask_sub_;
 
   rclcpp_lifecycle::LifecyclePublisher<nav2_msgs::msg::SpeedLimit>::SharedPtr speed_limit_pub_;
 
-  nav_msgs::msg::OccupancyGrid::SharedPtr filter_mask_;
+  nav_msgs::msg::OccupancyGrid::ConstSharedPtr filter_mask_;
+  // Filter mask received as a sparse one, instead of filter_mask_
+  nav2_msgs::msg::SparseFilterMask::ConstSharedPtr sparse_mask_;
 
   std::string global_frame_;  // Frame of currnet layer (master_grid)
 
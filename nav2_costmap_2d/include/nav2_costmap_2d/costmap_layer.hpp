@@ -81,6 +81,17 @@ public:
    */
   virtual void clearArea(int start_x, int start_y, int end_x, int end_y, bool invert);
 
+  /**
+   * @brief Whether the grid of the layer is a static map, which the layer rebuilds on its
+   * own when restarted and which the grids of the other layers are built over
+   */
+  virtual bool isStaticMap() {return false;}
+
+  /**
+   * @brief Whether the layer has its grid yet, static maps being received asynchronously
+   */
+  virtual bool isMapReady() {return true;}
+
   /**
    * If an external source changes values in the costmap,
    * it should call this method with the area that it changed
@@ -0,0 +1,114 @@
+// Copyright (c) 2024 Open Navigation LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef NAV2_COSTMAP_2D__COSTMAP_PYRAMID_HPP_
+#define NAV2_COSTMAP_2D__COSTMAP_PYRAMID_HPP_
+
+#include <memory>
+#include <vector>
+
+#include "nav2_costmap_2d/costmap_2d.hpp"
+#include "nav2_costmap_2d/dirty_tiles.hpp"
+
+namespace nav2_costmap_2d
+{
+
+/**
+ * @class CostmapPyramid
+ * @brief A stack of coarser copies of a costmap, where each level halves the
+ * resolution of the one below it by taking the maximum cost of every 2x2 block.
+ * Level 0 is downsampled by 2 from the source costmap, level 1 by 4 and so on.
+ * Since unknown space has the highest cost value, unknown cells propagate upwards.
+ */
+class CostmapPyramid
+{
+public:
+  /**
+   * @brief A constructor
+   * @param num_levels Number of coarse levels to maintain
+   */
+  explicit CostmapPyramid(unsigned int num_levels);
+
+  /**
+   * @brief Bring the pyramid up to date after the source costmap changed over a region.
+   * If the size, resolution or origin of the source costmap changed since the last
+   * call, the whole pyramid is rebuilt instead. The caller must hold the mutex of
+   * the source costmap, the mutex of each level is taken while it is written.
+   * @param costmap Source costmap
+   * @param x0 Lower x-boundary of the changed region, in source cells
+   * @param xn Upper x-boundary of the changed region (exclusive), in source cells
+   * @param y0 Lower y-boundary of the changed region, in source cells
+   * @param yn Upper y-boundary of the changed region (exclusive), in source cells
+   */
+  void update(
+    const Costmap2D & costmap,
+    unsigned int x0, unsigned int xn, unsigned int y0, unsigned int yn);
+
+  /**
+   * @brief Recompute every level from the whole source costmap
+   * @param costmap Source costmap, the caller must hold its mutex
+   */
+  void rebuild(const Costmap2D & costmap);
+
+  /**
+   * @brief Get a level of the pyramid. Lock its mutex while reading it.
+   * @param level Index of the level, 0 being the finest
+   * @return Pointer to the level costmap, which stays valid for the pyramid lifetime
+   */
+  Costmap2D * getLevel(unsigned int level) {return levels_[level].get();}
+
+  /**
+   * @brief Get the region of a level, in its own cells, changed by the last update
+   */
+  const CellRegion & getUpdatedRegion(unsigned int level) const {return updated_[level];}
+
+  /**
+   * @brief Get the downsampling factor of a level with respect to the source costmap
+   */
+  static unsigned int getScale(unsigned int level) {return 2u << level;}
+
+  unsigned int getNumLevels() const {return static_cast<unsigned int>(levels_.size());}
+
+protected:
+  /**
+   * @brief Check whether the levels are laid out for the given source costmap
+   */
+  bool matches(const Costmap2D & costmap) const;
+
+  /**
+   * @brief Max-pool a region of a fine grid into the next coarser level
+   * @param fine Grid to pool from
+   * @param fine_size_x Size of the fine grid in cells along X
+   * @param fine_size_y Size of the fine grid in cells along Y
+   * @param coarse Level to write, of size ceil(fine_size / 2)
+   * @param region Region of the coarse level to write, in coarse cells
+   */
+  static void pool(
+    const unsigned char * fine, unsigned int fine_size_x, unsigned int fine_size_y,
+    Costmap2D & coarse, const CellRegion & region);
+
+  std::vector<std::unique_ptr<Costmap2D>> levels_;
+  std::vector<CellRegion> updated_;
+
+  // Layout of the source costmap the levels were last built for
+  unsigned int size_x_{0};
+  unsigned int size_y_{0};
+  double resolution_{0.0};
+  double origin_x_{0.0};
+  double origin_y_{0.0};
+};
+
+}  // namespace nav2_costmap_2d
+
+#endif  // NAV2_COSTMAP_2D__COSTMAP_PYRAMID_HPP_
@@ -0,0 +1,113 @@
+// Copyright (c) 2024 Open Navigation LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef NAV2_COSTMAP_2D__COSTMAP_QUERIES_HPP_
+#define NAV2_COSTMAP_2D__COSTMAP_QUERIES_HPP_
+
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "geometry_msgs/msg/pose2_d.hpp"
+#include "nav2_costmap_2d/costmap_snapshot.hpp"
+#include "nav2_costmap_2d/footprint_collision_checker.hpp"
+
+namespace nav2_costmap_2d
+{
+
+/**
+ * @class CostmapQueries
+ * @brief Cost queries on a costmap snapshot, shared by all its readers, such as the
+ * controller plugins of a server, chained or not. Footprint rasterizations and the
+ * obstacle distance field are computed on first use only, and the rasterizations are
+ * carried over to the queries of the next snapshot. All methods are thread safe.
+ */
+class CostmapQueries
+{
+public:
+  using ConstPtr = std::shared_ptr<const CostmapQueries>;
+  using Checker = FootprintCollisionChecker<CostmapSnapshot::ConstPtr>;
+
+  /**
+   * @brief A constructor
+   * @param snapshot Snapshot to query
+   * @param previous Queries of an earlier snapshot to take the rasterizations of, if any
+   */
+  explicit CostmapQueries(
+    CostmapSnapshot::ConstPtr snapshot, const CostmapQueries * previous = nullptr);
+
+  /**
+   * @brief Snapshot the queries are answered on
+   */
+  const CostmapSnapshot::ConstPtr & getSnapshot() const {return snapshot_;}
+
+  /**
+   * @brief Get a collision checker on the snapshot, with a footprint cached for a number
+   * of headings, rasterized once for all the callers asking for the same footprint
+   * @param footprint Unoriented footprint
+   * @param num_headings Number of discretized headings, must be positive
+   * @return Checker to call footprintCostAtPoseCached() and footprintCostsAtPoses() on
+   */
+  std::shared_ptr<const Checker> getFootprintChecker(
+    const Footprint & footprint, unsigned int num_headings) const;
+
+  /**
+   * @brief Find the cost of a footprint at a batch of poses
+   * @param footprint Unoriented footprint
+   * @param num_headings Number of discretized headings of the cached footprint
+   * @param poses Poses to evaluate, in the frame of the costmap
+   * @param costs Will be resized and filled with the cost of each pose
+   */
+  void costAtPoses(
+    const Footprint & footprint, unsigned int num_headings,
+    const std::vector<geometry_msgs::msg::Pose2D> & poses, std::vector<double> & costs) const;
+
+  /**
+   * @brief Get the distance from each cell to the closest lethal cell
+   * @return Row-major distances (m), infinite if the snapshot has no lethal cell
+   */
+  const std::vector<float> & getObstacleDistances() const;
+
+  /**
+   * @brief Get the distance from a cell to the closest lethal cell
+   * @return Distance (m), infinite if the snapshot has no lethal cell
+   */
+  float getObstacleDistance(unsigned int mx, unsigned int my) const
+  {
+    return getObstacleDistances()[snapshot_->getIndex(mx, my)];
+  }
+
+protected:
+  /**
+   * @struct CachedFootprint
+   * @brief A footprint rasterization and the checker holding it
+   */
+  struct CachedFootprint
+  {
+    Footprint footprint;
+    unsigned int num_headings;
+    std::shared_ptr<Checker> checker;
+  };
+
+  CostmapSnapshot::ConstPtr snapshot_;
+
+  mutable std::mutex mutex_;
+  mutable std::vector<CachedFootprint> footprints_;
+  mutable std::once_flag distances_computed_;
+  mutable std::vector<float> distances_;
+};
+
+}  // namespace nav2_costmap_2d
+
+#endif  // NAV2_COSTMAP_2D__COSTMAP_QUERIES_HPP_
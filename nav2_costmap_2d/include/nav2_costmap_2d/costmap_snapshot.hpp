@@ -0,0 +1,139 @@
+// Copyright (c) 2024 Open Navigation LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef NAV2_COSTMAP_2D__COSTMAP_SNAPSHOT_HPP_
+#define NAV2_COSTMAP_2D__COSTMAP_SNAPSHOT_HPP_
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "nav2_costmap_2d/costmap_2d.hpp"
+#include "nav2_costmap_2d/dirty_tiles.hpp"
+
+namespace nav2_costmap_2d
+{
+
+/**
+ * @class CostmapSnapshot
+ * @brief An immutable copy of a master costmap grid with its metadata.
+ * Snapshots are handed out as shared pointers to const, so readers may hold
+ * and query them for as long as they need without taking the costmap mutex.
+ */
+class CostmapSnapshot
+{
+public:
+  using Ptr = std::shared_ptr<CostmapSnapshot>;
+  using ConstPtr = std::shared_ptr<const CostmapSnapshot>;
+
+  /**
+   * @brief Constructor for an empty snapshot
+   */
+  CostmapSnapshot() = default;
+
+  /**
+   * @brief Copy the contents of a costmap into this snapshot, reusing the
+   * storage already held by this object when sizes match.
+   * The caller must hold the costmap's mutex.
+   * @param costmap Costmap to copy
+   * @param revision Revision number of the costmap at copy time
+   */
+  void copyFrom(const Costmap2D & costmap, uint64_t revision);
+
+  /**
+   * @brief Get the cost of a cell
+   * @param mx The x coordinate of the cell
+   * @param my The y coordinate of the cell
+   * @return The cost of the cell
+   */
+  inline unsigned char getCost(unsigned int mx, unsigned int my) const
+  {
+    return data_[getIndex(mx, my)];
+  }
+
+  /**
+   * @brief Get the cost of a cell
+   * @param index The index of the cell
+   * @return The cost of the cell
+   */
+  inline unsigned char getCost(unsigned int index) const
+  {
+    return data_[index];
+  }
+
+  /**
+   * @brief Given two map coordinates, compute the associated index
+   */
+  inline unsigned int getIndex(unsigned int mx, unsigned int my) const
+  {
+    return my * size_x_ + mx;
+  }
+
+  /**
+   * @brief Convert from world coordinates to map coordinates
+   * @return True if the conversion was successful (legal bounds) false otherwise
+   */
+  bool worldToMap(double wx, double wy, unsigned int & mx, unsigned int & my) const;
+
+  /**
+   * @brief Convert from map coordinates to world coordinates of the cell center
+   */
+  void mapToWorld(unsigned int mx, unsigned int my, double & wx, double & wy) const;
+
+  /**
+   * @brief Pointer to the grid data, valid for the lifetime of the snapshot
+   */
+  const unsigned char * getCharMap() const {return data_.data();}
+
+  unsigned int getSizeInCellsX() const {return size_x_;}
+  unsigned int getSizeInCellsY() const {return size_y_;}
+  double getResolution() const {return resolution_;}
+  double getOriginX() const {return origin_x_;}
+  double getOriginY() const {return origin_y_;}
+
+  /**
+   * @brief Monotonic revision of the master costmap this snapshot was taken from
+   */
+  uint64_t getRevision() const {return revision_;}
+
+  /**
+   * @brief Set the regions updated by the latest revisions, most recent first, so that
+   * readers can tell which cells changed since an earlier snapshot
+   * @param history Region updated by revision getRevision() - i at index i
+   */
+  void setUpdateHistory(const std::vector<CellRegion> & history);
+
+  /**
+   * @brief Get the bounding box of the cells changed since an earlier revision
+   * @param revision Earlier revision of the costmap
+   * @param bounds Output union of the regions updated after revision, empty if none
+   * @return False if unknown, e.g. older than the recorded history or across a resize,
+   * in which case any cell may have changed
+   */
+  bool getChangedBounds(uint64_t revision, CellRegion & bounds) const;
+
+protected:
+  std::vector<unsigned char> data_;
+  unsigned int size_x_{0};
+  unsigned int size_y_{0};
+  double resolution_{0.0};
+  double origin_x_{0.0};
+  double origin_y_{0.0};
+  uint64_t revision_{0};
+  std::vector<CellRegion> update_history_;
+};
+
+}  // namespace nav2_costmap_2d
+
+#endif  // NAV2_COSTMAP_2D__COSTMAP_SNAPSHOT_HPP_
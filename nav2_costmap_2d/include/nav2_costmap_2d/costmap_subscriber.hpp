@@ -17,11 +17,13 @@
 
 #include <string>
 #include <memory>
+#include <vector>
 
 #include "rclcpp/rclcpp.hpp"
 #include "nav2_costmap_2d/costmap_2d.hpp"
 #include "nav2_msgs/msg/costmap.hpp"
 #include "nav2_msgs/msg/costmap_update.hpp"
+#include "nav2_msgs/msg/costmap_compressed_update.hpp"
 #include "nav2_util/lifecycle_node.hpp"
 
 namespace nav2_costmap_2d
@@ -35,17 +37,23 @@ class CostmapSubscriber
 public:
   /**
    * @brief A constructor
+   * @param use_compressed_updates Rebuild the costmap from the compressed
+   * <topic_name>_compressed_updates stream instead of full costmaps and patches
    */
   CostmapSubscriber(
     const nav2_util::LifecycleNode::WeakPtr & parent,
-    const std::string & topic_name);
+    const std::string & topic_name,
+    bool use_compressed_updates = false);
 
   /**
    * @brief A constructor
+   * @param use_compressed_updates Rebuild the costmap from the compressed
+   * <topic_name>_compressed_updates stream instead of full costmaps and patches
    */
   CostmapSubscriber(
     const rclcpp::Node::WeakPtr & parent,
-    const std::string & topic_name);
+    const std::string & topic_name,
+    bool use_compressed_updates = false);
 
   /**
    * @brief A destructor
@@ -64,10 +72,19 @@ public:
    * @brief Callback for the costmap's update topic
    */
   void costmapUpdateCallback(const nav2_msgs::msg::CostmapUpdate::SharedPtr update_msg);
+  /**
+   * @brief Callback for the costmap's compressed update topic
+   */
+  void costmapCompressedUpdateCallback(
+    const nav2_msgs::msg::CostmapCompressedUpdate::SharedPtr update_msg);
 
 protected:
   bool isCostmapReceived() {return costmap_ != nullptr;}
   void processCurrentCostmapMsg();
+  template<typename NodeT>
+  void createSubscriptions(const NodeT & node, bool use_compressed_updates);
+  bool decodeCompressedPatch(
+    const nav2_msgs::msg::CostmapCompressedUpdate & update_msg, unsigned char * data);
 
   bool haveCostmapParametersChanged();
   bool hasCostmapSizeChanged();
@@ -76,12 +93,18 @@ protected:
 
   rclcpp::Subscription<nav2_msgs::msg::Costmap>::SharedPtr costmap_sub_;
   rclcpp::Subscription<nav2_msgs::msg::CostmapUpdate>::SharedPtr costmap_update_sub_;
+  rclcpp::Subscription<nav2_msgs::msg::CostmapCompressedUpdate>::SharedPtr
+    costmap_compressed_update_sub_;
 
   std::shared_ptr<Costmap2D> costmap_;
   nav2_msgs::msg::Costmap::SharedPtr costmap_msg_;
 
   std::string topic_name_;
   std::mutex costmap_msg_mutex_;
+  // Compressed stream state: deltas apply only directly on top of last_sequence_
+  bool compressed_synced_{false};
+  uint64_t last_sequence_{0};
+  std::vector<unsigned char> compressed_patch_;
   rclcpp::Logger logger_{rclcpp::get_logger("nav2_costmap_2d")};
 };
 
@@ -25,6 +25,7 @@
 #include "rclcpp/rclcpp.hpp"
 #include "geometry_msgs/msg/pose_stamped.hpp"
 #include "geometry_msgs/msg/pose2_d.hpp"
+#include "geometry_msgs/msg/twist.hpp"
 #include "nav2_costmap_2d/costmap_2d.hpp"
 #include "nav2_costmap_2d/footprint_collision_checker.hpp"
 #include "nav2_costmap_2d/costmap_subscriber.hpp"
@@ -75,6 +76,64 @@ public:
     const geometry_msgs::msg::Pose2D & pose,
     bool fetch_costmap_and_footprint = true);
 
+  /**
+   * @brief Returns the obstacle footprint scores of a batch of poses, fetching the costmap
+   * and footprint once for all of them
+   *
+   * @param poses Poses to get scores at
+   * @param scores Will be resized and filled with the score of each pose, LETHAL_OBSTACLE
+   * for the poses off the grid
+   */
+  void scorePoses(
+    const std::vector<geometry_msgs::msg::Pose2D> & poses,
+    std::vector<double> & scores);
+
+  /**
+   * @brief Returns when a pose moving with a constant twist first collides, projecting it
+   * in closed form along its arc and fetching the costmap and footprint once for all of
+   * the projected poses
+   *
+   * @param pose Pose to start from
+   * @param twist Twist to project the pose with
+   * @param projection_time Time to project the pose for
+   * @param time_step Time between the projected poses
+   * @return Time of the first projected pose in collision or off the grid, -1.0 if there is
+   * none, 0.0 if the costmap or footprint is not available
+   */
+  double getCollisionTime(
+    const geometry_msgs::msg::Pose2D & pose,
+    const geometry_msgs::msg::Twist & twist,
+    double projection_time, double time_step);
+
+  /**
+   * @brief Returns if the area swept by the footprint driving straight from a pose along
+   * its heading is collision free, checking each of its cells once
+   *
+   * @param pose Pose to start from
+   * @param distance Distance driven, negative backwards
+   */
+  bool isTranslationCollisionFree(
+    const geometry_msgs::msg::Pose2D & pose, double distance);
+
+  /**
+   * @brief Returns if the area swept by the footprint rotating in place from a pose is
+   * collision free, checking each of its cells once
+   *
+   * @param pose Pose to start from
+   * @param angle Angle rotated, negative clockwise
+   */
+  bool isRotationCollisionFree(
+    const geometry_msgs::msg::Pose2D & pose, double angle);
+
+  /**
+   * @brief Orients the footprint for a number of evenly spaced headings once, rather than
+   * for every pose, the footprint of the nearest heading being used at each pose
+   *
+   * @param orientation_bins Number of headings, 0 (the default) to orient the footprint
+   * exactly at each pose
+   */
+  void setOrientationBins(unsigned int orientation_bins);
+
 protected:
   /**
    * @brief Get a footprint at a set pose
@@ -87,6 +146,25 @@ protected:
     const geometry_msgs::msg::Pose2D & pose,
     bool fetch_latest_footprint = true);
 
+  /**
+   * @brief Returns if the maximum cost of a swept area is below lethal, once the costmap
+   * and footprint are fetched
+   *
+   * @param swept_cost Cost of the swept area
+   */
+  template<typename SweptCostT>
+  bool isSweptCollisionFree(SweptCostT swept_cost);
+
+  /**
+   * @brief Fetches the latest footprint, in the robot frame
+   */
+  void fetchFootprint();
+
+  /**
+   * @brief Orients the footprint at a pose into oriented_footprint_
+   */
+  void orientFootprint(const geometry_msgs::msg::Pose2D & pose);
+
   // Name used for logging
   std::string name_;
   CostmapSubscriber & costmap_sub_;
@@ -94,6 +172,11 @@ protected:
   FootprintCollisionChecker<std::shared_ptr<Costmap2D>> collision_checker_;
   rclcpp::Clock::SharedPtr clock_;
   Footprint footprint_;
+  Footprint oriented_footprint_;
+  // Footprint rotated for each of the orientation bins, footprint_ as they were rotated for
+  unsigned int orientation_bins_{0};
+  std::vector<Footprint> binned_footprints_;
+  Footprint binned_footprint_spec_;
 };
 
 }  // namespace nav2_costmap_2d
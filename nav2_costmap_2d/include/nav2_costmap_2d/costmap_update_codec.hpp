@@ -0,0 +1,49 @@
+// Copyright (c) 2024 Open Navigation LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef NAV2_COSTMAP_2D__COSTMAP_UPDATE_CODEC_HPP_
+#define NAV2_COSTMAP_2D__COSTMAP_UPDATE_CODEC_HPP_
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace nav2_costmap_2d
+{
+
+/**
+ * @brief Run-length encode a buffer of costs as (count, value) byte pairs.
+ * Costmaps are dominated by long runs of free, unknown or unchanged cells,
+ * which this compresses well without pulling in an external codec.
+ * @param data Costs to encode
+ * @param size Number of costs
+ * @param encoded Output buffer, overwritten
+ */
+void encodeRunLength(
+  const unsigned char * data, size_t size, std::vector<uint8_t> & encoded);
+
+/**
+ * @brief Decode a buffer produced by encodeRunLength
+ * @param encoded Encoded buffer
+ * @param data Output costs, must hold size cells
+ * @param size Expected number of decoded costs
+ * @return False if the encoded buffer is malformed or does not decode to
+ * exactly size cells
+ */
+bool decodeRunLength(
+  const std::vector<uint8_t> & encoded, unsigned char * data, size_t size);
+
+}  // namespace nav2_costmap_2d
+
+#endif  // NAV2_COSTMAP_2D__COSTMAP_UPDATE_CODEC_HPP_
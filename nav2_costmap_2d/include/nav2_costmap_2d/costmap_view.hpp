@@ -0,0 +1,195 @@
+// Copyright (c) 2024 Open Navigation LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef NAV2_COSTMAP_2D__COSTMAP_VIEW_HPP_
+#define NAV2_COSTMAP_2D__COSTMAP_VIEW_HPP_
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+
+#include "nav2_costmap_2d/costmap_2d.hpp"
+#include "nav2_costmap_2d/costmap_snapshot.hpp"
+
+namespace nav2_costmap_2d
+{
+
+/**
+ * @class CostmapView
+ * @brief A non-owning view of a window of costmap cells, with the geometry of the window.
+ * Rows of the window are stride cells apart in memory, so crops share the data of the
+ * costmap they were taken from rather than copying it. Accesses are inline and unchecked,
+ * for the tight loops of planners, controllers and collision checkers; the view is only
+ * valid while the costmap it was taken from is neither resized nor freed, which for a
+ * Costmap2D means holding its mutex, and for a CostmapSnapshot holding the snapshot.
+ */
+class CostmapView
+{
+public:
+  /**
+   * @brief Constructor for an empty view
+   */
+  CostmapView() = default;
+
+  /**
+   * @brief Constructor for a view of raw cells
+   * @param data First cell of the window
+   * @param size_x Width of the window in cells
+   * @param size_y Height of the window in cells
+   * @param stride Distance in cells between the rows of the window, at least size_x
+   * @param resolution Resolution of the cells (m)
+   * @param origin_x X of the lower left corner of the window (m)
+   * @param origin_y Y of the lower left corner of the window (m)
+   */
+  CostmapView(
+    const unsigned char * data, unsigned int size_x, unsigned int size_y, size_t stride,
+    double resolution, double origin_x, double origin_y)
+  : data_(data), size_x_(size_x), size_y_(size_y), stride_(stride),
+    resolution_(resolution), origin_x_(origin_x), origin_y_(origin_y)
+  {
+  }
+
+  /**
+   * @brief Constructor for a view of a whole costmap
+   */
+  explicit CostmapView(const Costmap2D & costmap)
+  : CostmapView(
+      costmap.getCharMap(), costmap.getSizeInCellsX(), costmap.getSizeInCellsY(),
+      costmap.getSizeInCellsX(), costmap.getResolution(), costmap.getOriginX(),
+      costmap.getOriginY())
+  {
+  }
+
+  /**
+   * @brief Constructor for a view of a whole snapshot
+   */
+  explicit CostmapView(const CostmapSnapshot & snapshot)
+  : CostmapView(
+      snapshot.getCharMap(), snapshot.getSizeInCellsX(), snapshot.getSizeInCellsY(),
+      snapshot.getSizeInCellsX(), snapshot.getResolution(), snapshot.getOriginX(),
+      snapshot.getOriginY())
+  {
+  }
+
+  /**
+   * @brief Get a view of the cells [x0, xn) x [y0, yn) of this view, clamped to it,
+   * sharing its data
+   */
+  CostmapView crop(unsigned int x0, unsigned int y0, unsigned int xn, unsigned int yn) const
+  {
+    xn = std::min(xn, size_x_);
+    yn = std::min(yn, size_y_);
+    x0 = std::min(x0, xn);
+    y0 = std::min(y0, yn);
+    return CostmapView(
+      data_ + y0 * stride_ + x0, xn - x0, yn - y0, stride_, resolution_,
+      origin_x_ + x0 * resolution_, origin_y_ + y0 * resolution_);
+  }
+
+  /**
+   * @brief Get a view of the cells of this view overlapping a world bounding box,
+   * sharing its data
+   */
+  CostmapView cropWorld(double min_wx, double min_wy, double max_wx, double max_wy) const
+  {
+    // Cells clamped to [0, size], the end cells being past the cells of the max corner
+    auto to_cell = [this](double w, double origin, unsigned int size, double offset) {
+        const double cell = std::floor((w - origin) / resolution_) + offset;
+        return static_cast<unsigned int>(std::clamp(cell, 0.0, static_cast<double>(size)));
+      };
+    return crop(
+      to_cell(min_wx, origin_x_, size_x_, 0.0), to_cell(min_wy, origin_y_, size_y_, 0.0),
+      to_cell(max_wx, origin_x_, size_x_, 1.0), to_cell(max_wy, origin_y_, size_y_, 1.0));
+  }
+
+  /**
+   * @brief Get the cost of a cell of the view, which must be in it
+   */
+  inline unsigned char operator()(unsigned int mx, unsigned int my) const
+  {
+    return data_[my * stride_ + mx];
+  }
+
+  /**
+   * @brief Get the cost of a cell of the view, which must be in it
+   */
+  inline unsigned char getCost(unsigned int mx, unsigned int my) const
+  {
+    return data_[my * stride_ + mx];
+  }
+
+  /**
+   * @brief Get the size_x cells of a row of the view, which must be in it
+   */
+  inline const unsigned char * row(unsigned int my) const
+  {
+    return data_ + my * stride_;
+  }
+
+  /**
+   * @brief Whether a cell is in the view
+   */
+  inline bool contains(int mx, int my) const
+  {
+    return mx >= 0 && my >= 0 && static_cast<unsigned int>(mx) < size_x_ &&
+           static_cast<unsigned int>(my) < size_y_;
+  }
+
+  /**
+   * @brief Convert from world coordinates to the coordinates of a cell of the view
+   * @return True if the position is in the view
+   */
+  inline bool worldToMap(double wx, double wy, unsigned int & mx, unsigned int & my) const
+  {
+    if (wx < origin_x_ || wy < origin_y_) {
+      return false;
+    }
+
+    mx = static_cast<unsigned int>((wx - origin_x_) / resolution_);
+    my = static_cast<unsigned int>((wy - origin_y_) / resolution_);
+    return mx < size_x_ && my < size_y_;
+  }
+
+  /**
+   * @brief Convert from the coordinates of a cell of the view to the world coordinates
+   * of its center
+   */
+  inline void mapToWorld(unsigned int mx, unsigned int my, double & wx, double & wy) const
+  {
+    wx = origin_x_ + (mx + 0.5) * resolution_;
+    wy = origin_y_ + (my + 0.5) * resolution_;
+  }
+
+  bool empty() const {return size_x_ == 0 || size_y_ == 0;}
+  const unsigned char * getData() const {return data_;}
+  unsigned int getSizeInCellsX() const {return size_x_;}
+  unsigned int getSizeInCellsY() const {return size_y_;}
+  size_t getStride() const {return stride_;}
+  double getResolution() const {return resolution_;}
+  double getOriginX() const {return origin_x_;}
+  double getOriginY() const {return origin_y_;}
+
+protected:
+  const unsigned char * data_{nullptr};
+  unsigned int size_x_{0};
+  unsigned int size_y_{0};
+  size_t stride_{0};
+  double resolution_{0.0};
+  double origin_x_{0.0};
+  double origin_y_{0.0};
+};
+
+}  // namespace nav2_costmap_2d
+
+#endif  // NAV2_COSTMAP_2D__COSTMAP_VIEW_HPP_
@@ -21,6 +21,7 @@
 #include <array>
 #include <memory>
 #include <limits>
+#include <numeric>
 #include <string>
 #include <utility>
 
@@ -489,10 +490,13 @@ private:
   {
     size_t max_labels{};
 
+    /* A new label is only made for a pixel without obstacle neighbors already scanned,
+     * so no two such pixels are neighbors and their count is bounded by the largest
+     * set of pairwise non-neighbor pixels */
     if (connectivity == ConnectivityType::Way4) {
       /* The maximum of individual components will be reached in the chessboard image,
        * where the white cells correspond to obstacle pixels */
-      max_labels = (rows * columns) / 2 + 1;
+      max_labels = (rows * columns + 1) / 2;
     } else {
       /* The maximum of individual components will be reached in image like this:
        * x.x.x.x~
@@ -503,7 +507,7 @@ private:
        * ~
        * where 'x' - pixel with obstacle, '.' - background pixel,
        * '~' - row continuation in the same style */
-      max_labels = (rows * columns) / 3 + 1;
+      max_labels = ((rows + 1) / 2) * ((columns + 1) / 2);
     }
     ++max_labels;  // add zero label
     max_labels = std::min(max_labels, size_t(std::numeric_limits<Label>::max()));
@@ -1031,6 +1035,179 @@ private:
   mutable std::unique_ptr<imgproc_impl::EquivalenceLabelTreesBase> label_trees_;
 };
 
+/**
+ * @brief Object to eliminate grouped noise on the image using several threads
+ * The image is split into horizontal bands labeled independently, then the labels
+ * touching across band borders are merged with a global union-find before the
+ * group sizes are computed. The result is the same as GroupsRemover.
+ * Stores the label trees and buffers that are reused between calls
+ * @sa GroupsRemover
+ */
+class ParallelGroupsRemover
+{
+public:
+  /**
+   * @brief Removes groups of obstacles smaller than minimal_group_size
+   * @tparam IsBg functor with signature bool (uint8_t)
+   * @tparam ParallelFor functor with signature void (size_t count, std::function<void(size_t)>),
+   * calling fn(i) for each i in [0, count) and returning once all calls completed
+   * @param[in,out] image image to be denoised
+   * @param group_connectivity_type pixels connectivity type
+   * @param minimal_group_size the border value of group size. Groups of this and larger
+   * size will be kept
+   * @param is_background returns true if the passed pixel value is background
+   * @param bands number of bands to split the image into
+   * @param parallel_for runs the per-band work
+   */
+  template<class IsBg, class ParallelFor>
+  void removeGroups(
+    Image<uint8_t> & image, ConnectivityType group_connectivity_type,
+    size_t minimal_group_size, const IsBg & is_background, size_t bands,
+    ParallelFor && parallel_for)
+  {
+    if (group_connectivity_type == ConnectivityType::Way4) {
+      removeGroupsImpl<ConnectivityType::Way4>(
+        image, minimal_group_size, is_background, bands, parallel_for);
+    } else {
+      removeGroupsImpl<ConnectivityType::Way8>(
+        image, minimal_group_size, is_background, bands, parallel_for);
+    }
+  }
+
+private:
+  using Label = uint32_t;
+
+  template<ConnectivityType connectivity, class IsBg, class ParallelFor>
+  void removeGroupsImpl(
+    Image<uint8_t> & image, size_t minimal_group_size, const IsBg & is_background,
+    size_t bands, ParallelFor & parallel_for)
+  {
+    if (image.empty()) {
+      return;
+    }
+    const size_t rows = image.rows();
+    const size_t columns = image.columns();
+    bands = std::max<size_t>(1, std::min(bands, rows));
+
+    band_start_.resize(bands + 1);
+    for (size_t k = 0; k <= bands; ++k) {
+      band_start_[k] = k * rows / bands;
+    }
+    band_trees_.resize(bands);
+    band_sizes_.resize(bands);
+    labels_.resize(rows * columns);
+
+    auto band_labels = [&](size_t k) {
+        return Image<Label>(
+          band_start_[k + 1] - band_start_[k], columns,
+          labels_.data() + band_start_[k] * columns, columns);
+      };
+
+    // Label each band and count the pixels of its groups
+    parallel_for(
+      bands, [&](size_t k) {
+        const size_t band_rows = band_start_[k + 1] - band_start_[k];
+        const Image<uint8_t> band_image(
+          band_rows, columns, image.row(band_start_[k]), image.step());
+        Image<Label> labels = band_labels(k);
+        band_trees_[k].reset(band_rows, columns, connectivity);
+        const Label count = connectedComponentsImpl<connectivity>(
+          band_image, labels, band_trees_[k], is_background);
+
+        std::vector<size_t> & sizes = band_sizes_[k];
+        sizes.assign(count, 0);
+        labels.forEach([&sizes](Label l) {++sizes[l];});
+      });
+
+    // Global label of local label l > 0 of band k is band_offset_[k] + l
+    band_offset_.resize(bands + 1);
+    band_offset_[0] = 0;
+    for (size_t k = 0; k < bands; ++k) {
+      band_offset_[k + 1] = band_offset_[k] + band_sizes_[k].size() - 1;
+    }
+    parents_.resize(band_offset_[bands] + 1);
+    std::iota(parents_.begin(), parents_.end(), Label(0));
+
+    // Merge the groups touching across band borders
+    for (size_t k = 1; k < bands; ++k) {
+      const Label * up = labels_.data() + (band_start_[k] - 1) * columns;
+      const Label * down = up + columns;
+      for (size_t c = 0; c < columns; ++c) {
+        if (!down[c]) {
+          continue;
+        }
+        const Label current = band_offset_[k] + down[c];
+        if (up[c]) {
+          unite(current, band_offset_[k - 1] + up[c]);
+        }
+        if (connectivity == ConnectivityType::Way8) {
+          if (c > 0 && up[c - 1]) {
+            unite(current, band_offset_[k - 1] + up[c - 1]);
+          }
+          if (c + 1 < columns && up[c + 1]) {
+            unite(current, band_offset_[k - 1] + up[c + 1]);
+          }
+        }
+      }
+    }
+
+    // Accumulate the group sizes on the roots and mark the noise labels
+    group_sizes_.assign(parents_.size(), 0);
+    for (size_t k = 0; k < bands; ++k) {
+      for (size_t l = 1; l < band_sizes_[k].size(); ++l) {
+        group_sizes_[findRoot(band_offset_[k] + l)] += band_sizes_[k][l];
+      }
+    }
+    noise_.assign(parents_.size(), 0);
+    for (size_t g = 1; g < parents_.size(); ++g) {
+      noise_[g] = group_sizes_[findRoot(g)] < minimal_group_size;
+    }
+
+    // Replace the pixel values from the small groups to background code
+    parallel_for(
+      bands, [&](size_t k) {
+        Image<uint8_t> band_image(
+          band_start_[k + 1] - band_start_[k], columns, image.row(band_start_[k]), image.step());
+        const Label offset = band_offset_[k];
+        band_labels(k).convert(
+          band_image, [&](Label src, uint8_t & trg) {
+            if (src && noise_[offset + src] && !is_background(trg)) {
+              trg = 0;
+            }
+          });
+      });
+  }
+
+  /// @brief Find the root of the global tree of label i, compressing the path
+  Label findRoot(Label i)
+  {
+    while (parents_[i] != i) {
+      parents_[i] = parents_[parents_[i]];
+      i = parents_[i];
+    }
+    return i;
+  }
+
+  /// @brief Unite the global trees containing labels i and j
+  void unite(Label i, Label j)
+  {
+    i = findRoot(i);
+    j = findRoot(j);
+    if (i != j) {
+      parents_[std::max(i, j)] = std::min(i, j);
+    }
+  }
+
+  std::vector<size_t> band_start_;
+  std::vector<Label> band_offset_;
+  std::vector<EquivalenceLabelTrees<Label>> band_trees_;
+  std::vector<std::vector<size_t>> band_sizes_;
+  std::vector<Label> labels_;
+  std::vector<Label> parents_;
+  std::vector<size_t> group_sizes_;
+  std::vector<uint8_t> noise_;
+};
+
 }  // namespace imgproc_impl
 
 template<ConnectivityType connectivity, class Label, class IsBg>
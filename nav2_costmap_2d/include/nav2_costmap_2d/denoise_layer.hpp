@@ -16,7 +16,11 @@
 #define NAV2_COSTMAP_2D__DENOISE_LAYER_HPP_
 
 #include "nav2_costmap_2d/layer.hpp"
+#include <memory>
+#include <vector>
+
 #include "nav2_costmap_2d/denoise/image_processing.hpp"
+#include "nav2_util/thread_pool.hpp"
 
 namespace nav2_costmap_2d
 {
@@ -43,6 +47,11 @@ public:
    */
   bool isClearable() override;
 
+  /**
+   * @brief Reports that costs are only filtered where the previous layers changed them
+   */
+  bool isBoundsExpansion() const override {return true;}
+
   /**
    * @brief Reports that no expansion is required
    * The method is called to ask the plugin: which area of costmap it needs to update.
@@ -100,6 +109,15 @@ private:
    */
   void removeGroups(Image<uint8_t> & image) const;
 
+  /**
+   * @brief Filters the window of the master grid [min_x, max_x) x [min_y, max_y).
+   * With a window margin, the groups are measured over the window grown by
+   * minimal_group_size_ - 1 cells, so that groups crossing the window border are not
+   * taken for noise, while only the cells inside the window are modified.
+   */
+  void denoiseWindow(
+    nav2_costmap_2d::Costmap2D & master_grid, int min_x, int min_y, int max_x, int max_y);
+
   /**
      * @brief Removes from the image freestanding single white pixels
      * Works similarly to removeGroups with minimal_group_size_ = 2, but about 10x faster
@@ -122,6 +140,16 @@ private:
   mutable MemoryBuffer buffer_;
   // Implementing the removal of grouped noise
   imgproc_impl::GroupsRemover groups_remover_;
+  // Implementing the removal of grouped noise in several image bands concurrently
+  mutable imgproc_impl::ParallelGroupsRemover parallel_groups_remover_;
+  // Threads helping the updating thread to remove groups, null for serial processing
+  std::unique_ptr<nav2_util::ThreadPool> thread_pool_;
+  // Number of bands the image is split into for parallel processing
+  size_t parallel_bands_{1};
+  // Measure the groups over a margin around the update window
+  bool use_window_margin_{false};
+  // Copy of the update window grown by the margin
+  std::vector<uint8_t> window_buffer_;
   // Interpret NO_INFORMATION code as obstacle
   bool no_information_is_obstacle_{};
 };
@@ -0,0 +1,106 @@
+// Copyright (c) 2024 Open Navigation LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef NAV2_COSTMAP_2D__DIRTY_TILES_HPP_
+#define NAV2_COSTMAP_2D__DIRTY_TILES_HPP_
+
+#include <cstdint>
+#include <vector>
+
+namespace nav2_costmap_2d
+{
+
+/**
+ * @struct CellRegion
+ * @brief A rectangular region of costmap cells, [x0, xn) x [y0, yn)
+ */
+struct CellRegion
+{
+  unsigned int x0;
+  unsigned int y0;
+  unsigned int xn;
+  unsigned int yn;
+};
+
+/**
+ * @class DirtyTiles
+ * @brief Tracks which fixed-size square tiles of a costmap were touched during an
+ * update cycle, so costs only need to be recomputed over the touched tiles rather
+ * than over the bounding box of all changes.
+ */
+class DirtyTiles
+{
+public:
+  /**
+   * @brief A constructor
+   */
+  DirtyTiles() = default;
+
+  /**
+   * @brief Resize the tile grid to cover a costmap and clear it
+   * @param size_x Size of the costmap in cells along X
+   * @param size_y Size of the costmap in cells along Y
+   * @param tile_size Size of the tile side in cells, must be positive
+   */
+  void resize(unsigned int size_x, unsigned int size_y, unsigned int tile_size);
+
+  /**
+   * @brief Mark all tiles as clean
+   */
+  void clear();
+
+  /**
+   * @brief Mark all tiles overlapping a region of cells as dirty
+   * @param x0 Lower x-boundary of the region, in cells
+   * @param y0 Lower y-boundary of the region, in cells
+   * @param xn Upper x-boundary of the region (exclusive), in cells
+   * @param yn Upper y-boundary of the region (exclusive), in cells
+   */
+  void markCells(unsigned int x0, unsigned int y0, unsigned int xn, unsigned int yn);
+
+  /**
+   * @brief Grow the set of dirty tiles so that every cell within the given
+   * distance of a dirty tile is covered by a dirty tile as well
+   * @param cells Distance to grow by, in cells
+   */
+  void dilate(unsigned int cells);
+
+  /**
+   * @brief Check whether any tile is dirty
+   */
+  bool empty() const;
+
+  /**
+   * @brief Decompose the dirty tiles into a set of disjoint cell regions clipped to the costmap
+   * @param regions Will be filled with the dirty regions
+   */
+  void getRegions(std::vector<CellRegion> & regions) const;
+
+  unsigned int getTileSize() const {return tile_size_;}
+  unsigned int getSizeInCellsX() const {return size_x_;}
+  unsigned int getSizeInCellsY() const {return size_y_;}
+
+protected:
+  unsigned int size_x_{0};
+  unsigned int size_y_{0};
+  unsigned int tile_size_{1};
+  unsigned int tiles_x_{0};
+  unsigned int tiles_y_{0};
+  std::vector<uint8_t> tiles_;
+  std::vector<uint8_t> scratch_;
+};
+
+}  // namespace nav2_costmap_2d
+
+#endif  // NAV2_COSTMAP_2D__DIRTY_TILES_HPP_
@@ -0,0 +1,83 @@
+// Copyright (c) 2024 Open Navigation LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef NAV2_COSTMAP_2D__DISTANCE_TRANSFORM_HPP_
+#define NAV2_COSTMAP_2D__DISTANCE_TRANSFORM_HPP_
+
+#include <cstdint>
+#include <vector>
+
+namespace nav2_costmap_2d
+{
+
+/**
+ * @class DistanceTransform
+ * @brief Exact Euclidean distance transform of a grid of seed cells, after
+ * Meijster et al., "A General Algorithm for Computing Distance Transforms in
+ * Linear Time". The first (column) pass is written as row-major sweeps over
+ * whole rows so that it vectorizes, the second pass computes the lower envelope
+ * of parabolas for each row. Working buffers are kept between calls.
+ */
+class DistanceTransform
+{
+public:
+  /**
+   * @brief A constructor
+   */
+  DistanceTransform() = default;
+
+  /**
+   * @brief Compute the squared distance, in cells, from every cell to the nearest seed
+   * @param seeds Row-major grid where non-zero cells are seeds
+   * @param size_x Size of the grid along X
+   * @param size_y Size of the grid along Y
+   */
+  void compute(const uint8_t * seeds, unsigned int size_x, unsigned int size_y);
+
+  /**
+   * @brief Squared distance of a cell to the nearest seed, from the last compute() call.
+   * Cells of a grid without seeds are set to getInfinity().
+   * @param index Row-major index of the cell
+   */
+  inline uint32_t getSquaredDistance(unsigned int index) const
+  {
+    return squared_distance_[index];
+  }
+
+  /**
+   * @brief Row-major squared distances from the last compute() call
+   */
+  const std::vector<uint32_t> & getSquaredDistances() const
+  {
+    return squared_distance_;
+  }
+
+  /**
+   * @brief Value used for cells that have no seed in the grid
+   */
+  static constexpr uint32_t getInfinity()
+  {
+    return UINT32_MAX;
+  }
+
+protected:
+  std::vector<uint32_t> column_distance_;
+  std::vector<uint32_t> squared_distance_;
+  std::vector<int> envelope_sites_;
+  std::vector<int> envelope_starts_;
+};
+
+}  // namespace nav2_costmap_2d
+
+#endif  // NAV2_COSTMAP_2D__DISTANCE_TRANSFORM_HPP_
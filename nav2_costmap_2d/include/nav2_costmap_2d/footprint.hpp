@@ -38,6 +38,7 @@
 #ifndef NAV2_COSTMAP_2D__FOOTPRINT_HPP_
 #define NAV2_COSTMAP_2D__FOOTPRINT_HPP_
 
+#include <mutex>
 #include <string>
 #include <vector>
 #include <utility>
@@ -96,6 +97,58 @@ void transformFootprint(
   const std::vector<geometry_msgs::msg::Point> & footprint_spec,
   std::vector<geometry_msgs::msg::Point> & oriented_footprint);
 
+/**
+ * @brief  Given a pose, with the cosine and sine of its orientation, and base footprint, build
+ * the oriented footprint of the robot. Does not allocate once oriented_footprint has the size
+ * of footprint_spec, and may be given footprint_spec itself to transform it in place.
+ * @param  x The x position of the robot
+ * @param  y The y position of the robot
+ * @param  cos_th The cosine of the orientation of the robot
+ * @param  sin_th The sine of the orientation of the robot
+ * @param  footprint_spec Basic shape of the footprint
+ * @param  oriented_footprint Will be filled with the points in the oriented footprint of the robot
+*/
+void transformFootprint(
+  double x, double y, double cos_th, double sin_th,
+  const std::vector<geometry_msgs::msg::Point> & footprint_spec,
+  std::vector<geometry_msgs::msg::Point> & oriented_footprint);
+
+/**
+ * @struct FootprintPoint
+ * @brief Compact 2D point of a footprint, for transforming footprints in hot loops
+ */
+struct FootprintPoint
+{
+  float x;
+  float y;
+};
+
+/**
+ * @brief Convert a footprint to compact points
+ * @param footprint Footprint to convert
+ * @param points Will be resized and filled with the points of the footprint
+ */
+void toFootprintPoints(
+  const std::vector<geometry_msgs::msg::Point> & footprint,
+  std::vector<FootprintPoint> & points);
+
+/**
+ * @brief  Given a pose, with the cosine and sine of its orientation, and base footprint of
+ * compact points, build the oriented footprint of the robot without any allocation
+ * @param  x The x position of the robot
+ * @param  y The y position of the robot
+ * @param  cos_th The cosine of the orientation of the robot
+ * @param  sin_th The sine of the orientation of the robot
+ * @param  footprint_spec Points of the basic shape of the footprint
+ * @param  size Number of points of the footprint
+ * @param  oriented_footprint Will be filled with the size points of the oriented footprint,
+ * may be footprint_spec itself
+*/
+void transformFootprint(
+  float x, float y, float cos_th, float sin_th,
+  const FootprintPoint * footprint_spec, size_t size,
+  FootprintPoint * oriented_footprint);
+
 /**
  * @brief  Given a pose and base footprint, build the oriented footprint of the robot (PolygonStamped)
  * @param  x The x position of the robot
@@ -114,6 +167,45 @@ void transformFootprint(
  */
 void padFootprint(std::vector<geometry_msgs::msg::Point> & footprint, double padding);
 
+/**
+ * @class OrientedFootprintCache
+ * @brief Oriented footprint of the robot at the last pose it was built for, so that the
+ * plugins asking for the footprint at the current pose within a cycle share a single transform.
+ * It is rebuilt once the pose or the footprint changes, the sine and cosine of the orientation
+ * only once the orientation changes. Thread-safe.
+ */
+class OrientedFootprintCache
+{
+public:
+  /**
+   * @brief Sets the footprint to orient, invalidating the oriented footprint
+   * @param footprint_spec Basic shape of the footprint
+   */
+  void setFootprint(const std::vector<geometry_msgs::msg::Point> & footprint_spec);
+
+  /**
+   * @brief Gets the oriented footprint at a pose
+   * @param x The x position of the robot
+   * @param y The y position of the robot
+   * @param theta The orientation of the robot
+   * @param oriented_footprint Will be filled with the points in the oriented footprint of the robot
+   */
+  void getOrientedFootprint(
+    double x, double y, double theta,
+    std::vector<geometry_msgs::msg::Point> & oriented_footprint);
+
+protected:
+  std::mutex mutex_;
+  std::vector<geometry_msgs::msg::Point> footprint_spec_;
+  std::vector<geometry_msgs::msg::Point> oriented_footprint_;
+  bool valid_{false};
+  double x_{0.0};
+  double y_{0.0};
+  double theta_{0.0};
+  double cos_th_{1.0};
+  double sin_th_{0.0};
+};
+
 /**
  * @brief Create a circular footprint from a given radius
  */
@@ -68,6 +68,59 @@ public:
    * @brief Get the cost of a point
    */
   double pointCost(int x, int y) const;
+  /**
+   * @brief Precompute the cells covered by a footprint for a number of evenly spaced
+   * headings, for use by footprintCostAtPoseCached() and footprintCostsAtPoses().
+   * Cells are laid out around the center of the cell containing the pose, so the
+   * cached footprint may be off by up to half a cell compared to footprintCostAtPose().
+   * Must be called again if the costmap resolution changes.
+   * @param footprint Unoriented footprint
+   * @param num_headings Number of discretized headings, must be positive
+   * @param fill_interior Whether to include the interior cells, or only the outline
+   */
+  void setFootprintCache(
+    const Footprint & footprint, unsigned int num_headings, bool fill_interior);
+  /**
+   * @brief Check whether a footprint cache was set
+   */
+  bool hasFootprintCache() const {return !cache_heading_start_.empty();}
+  /**
+   * @brief Find the cost of the cached footprint at a pose, or of the cell of the pose
+   * if no footprint cache was set
+   * @return Maximum cost under the footprint, LETHAL_OBSTACLE if it leaves the costmap
+   */
+  double footprintCostAtPoseCached(double x, double y, double theta) const;
+  /**
+   * @brief Find the cost of the cached footprint at a batch of poses
+   * @param poses Poses to evaluate
+   * @param costs Will be resized and filled with the cost of each pose
+   */
+  void footprintCostsAtPoses(
+    const std::vector<geometry_msgs::msg::Pose2D> & poses, std::vector<double> & costs) const;
+  /**
+   * @brief Find the highest cost of the area swept by an unoriented footprint driving
+   * straight along its heading, in a single pass over the cells of the area
+   * @param x X of the start pose
+   * @param y Y of the start pose
+   * @param theta Heading of the start pose
+   * @param distance Distance driven, negative backwards
+   * @param footprint Unoriented footprint
+   * @return Maximum cost, LETHAL_OBSTACLE if the area leaves the costmap
+   */
+  double translationSweptCost(
+    double x, double y, double theta, double distance, const Footprint & footprint);
+  /**
+   * @brief Find the highest cost of the area swept by an unoriented footprint rotating in
+   * place, in a single pass over the cells of the area
+   * @param x X of the pose
+   * @param y Y of the pose
+   * @param theta Heading of the start pose
+   * @param angle Angle rotated, negative clockwise
+   * @param footprint Unoriented footprint
+   * @return Maximum cost, LETHAL_OBSTACLE if the area leaves the costmap
+   */
+  double rotationSweptCost(
+    double x, double y, double theta, double angle, const Footprint & footprint);
   /**
   * @brief Set the current costmap object to use for collision detection
   */
@@ -81,7 +134,40 @@ public:
   }
 
 protected:
+  /**
+   * @brief Highest cost of the cells in a world bounding box of which the center, in the
+   * frame of a pose, passes a test
+   * @param swept Test of a cell center (px, py) in the frame of the pose
+   */
+  template<typename SweptT>
+  double sweptCost(
+    double x, double y, double theta,
+    double min_wx, double min_wy, double max_wx, double max_wy, SweptT swept) const;
+
+  /**
+   * @brief Cost of the cached footprint of a heading bin placed on cell (mx, my)
+   */
+  double cachedCost(unsigned int heading, unsigned int mx, unsigned int my) const;
+
+  /**
+   * @struct CellOffset
+   * @brief Offset of a footprint cell from the cell of the pose
+   */
+  struct CellOffset
+  {
+    int dx;
+    int dy;
+  };
+
   CostmapT costmap_;
+  // Oriented footprint of footprintCostAtPose()
+  Footprint oriented_footprint_;
+
+  // Footprint cells of heading i are cache_cells_[cache_heading_start_[i]..[i + 1]),
+  // with cache_extents_[i] = {min dx, min dy} and {max dx, max dy} at 2 * i and 2 * i + 1
+  std::vector<CellOffset> cache_cells_;
+  std::vector<size_t> cache_heading_start_;
+  std::vector<CellOffset> cache_extents_;
 };
 
 }  // namespace nav2_costmap_2d
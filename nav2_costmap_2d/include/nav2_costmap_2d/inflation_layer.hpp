@@ -38,6 +38,7 @@
 #ifndef NAV2_COSTMAP_2D__INFLATION_LAYER_HPP_
 #define NAV2_COSTMAP_2D__INFLATION_LAYER_HPP_
 
+#include <algorithm>
 #include <map>
 #include <vector>
 #include <mutex>
@@ -48,6 +49,8 @@
 #include "nav2_costmap_2d/layer.hpp"
 #include "nav2_costmap_2d/layered_costmap.hpp"
 #include "nav2_costmap_2d/costmap_2d_ros.hpp"
+#include "nav2_costmap_2d/dirty_tiles.hpp"
+#include "nav2_costmap_2d/distance_transform.hpp"
 
 namespace nav2_costmap_2d
 {
@@ -134,6 +137,11 @@ public:
    */
   bool isClearable() override {return false;}
 
+  /**
+   * @brief Inflation only grows the bounds of the previous layers by the inflation radius
+   */
+  bool isBoundsExpansion() const override {return true;}
+
   /**
    * @brief Reset this costmap
    */
@@ -260,6 +268,73 @@ protected:
     return layered_costmap_->getCostmap()->cellDistance(world_dist);
   }
 
+  /**
+   * @brief Inflate the window using an exact distance transform rather than the
+   * bucketed breadth first search
+   * @param master_grid The master costmap grid to update
+   * @param min_i X min map coord of the window to inflate, including the inflation margin
+   * @param min_j Y min map coord of the window to inflate, including the inflation margin
+   * @param max_i X max map coord of the window to inflate, including the inflation margin
+   * @param max_j Y max map coord of the window to inflate, including the inflation margin
+   * @param base_min_i X min map coord of the window to update
+   * @param base_min_j Y min map coord of the window to update
+   * @param base_max_i X max map coord of the window to update
+   * @param base_max_j Y max map coord of the window to update
+   */
+  void inflateWithDistanceTransform(
+    nav2_costmap_2d::Costmap2D & master_grid,
+    int min_i, int min_j, int max_i, int max_j,
+    int base_min_i, int base_min_j, int base_max_i, int base_max_j);
+
+  /**
+   * @brief Inflate the window from cached inflation costs, only recomputing the costs
+   * within the inflation radius of seed cells that changed since the last cycle
+   * @param master_grid The master costmap grid to update
+   * @param min_i X min map coord of the window to inflate, including the inflation margin
+   * @param min_j Y min map coord of the window to inflate, including the inflation margin
+   * @param max_i X max map coord of the window to inflate, including the inflation margin
+   * @param max_j Y max map coord of the window to inflate, including the inflation margin
+   * @param base_min_i X min map coord of the window to update
+   * @param base_min_j Y min map coord of the window to update
+   * @param base_max_i X max map coord of the window to update
+   * @param base_max_j Y max map coord of the window to update
+   */
+  void inflateIncrementally(
+    nav2_costmap_2d::Costmap2D & master_grid,
+    int min_i, int min_j, int max_i, int max_j,
+    int base_min_i, int base_min_j, int base_max_i, int base_max_j);
+
+  /**
+   * @brief Recompute the cached inflation costs within a region from the known seeds
+   * @param region Region of cells to recompute
+   * @param size_x Size of the costmap in cells along X
+   * @param size_y Size of the costmap in cells along Y
+   */
+  void recomputeInflatedCosts(
+    const CellRegion & region, unsigned int size_x, unsigned int size_y);
+
+  /**
+   * @brief Check whether a master costmap cell is a seed for inflation
+   */
+  inline bool isSeed(unsigned char cost) const
+  {
+    return cost == LETHAL_OBSTACLE || (inflate_around_unknown_ && cost == NO_INFORMATION);
+  }
+
+  /**
+   * @brief Apply an inflation cost to a master costmap cell
+   */
+  inline void applyCost(unsigned char & master_cost, unsigned char cost) const
+  {
+    if (master_cost == NO_INFORMATION &&
+      (inflate_unknown_ ? (cost > FREE_SPACE) : (cost >= INSCRIBED_INFLATED_OBSTACLE)))
+    {
+      master_cost = cost;
+    } else {
+      master_cost = std::max(master_cost, cost);
+    }
+  }
+
   /**
    * @brief Enqueue new cells in cache distance update search
    */
@@ -276,6 +351,8 @@ protected:
 
   double inflation_radius_, inscribed_radius_, cost_scaling_factor_;
   bool inflate_unknown_, inflate_around_unknown_;
+  bool use_distance_transform_;
+  bool incremental_inflation_;
   unsigned int cell_inflation_radius_;
   unsigned int cached_cell_inflation_radius_;
   std::vector<std::vector<CellData>> inflation_cells_;
@@ -287,6 +364,21 @@ protected:
   std::vector<unsigned char> cached_costs_;
   std::vector<double> cached_distances_;
   std::vector<std::vector<int>> distance_matrix_;
+  // Cost by squared cell distance, up to the squared inflation radius
+  std::vector<unsigned char> cached_squared_distance_costs_;
+  DistanceTransform distance_transform_;
+  std::vector<uint8_t> seeds_;
+
+  // Incremental inflation state: the seeds and inflation costs of the whole costmap
+  // as of the last cycle, and the costmap origin they were computed for
+  bool incremental_cache_valid_;
+  std::vector<uint8_t> known_seeds_;
+  std::vector<unsigned char> inflated_costs_;
+  std::vector<uint8_t> seeds_scratch_;
+  std::vector<unsigned char> costs_scratch_;
+  double cache_origin_x_, cache_origin_y_;
+  DirtyTiles changed_tiles_;
+  std::vector<CellRegion> changed_regions_;
   unsigned int cache_length_;
   double last_min_x_, last_min_y_, last_max_x_, last_max_y_;
 
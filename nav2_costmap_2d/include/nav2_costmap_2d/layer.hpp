@@ -103,6 +103,35 @@ public:
     double * max_x,
     double * max_y) = 0;
 
+  /**
+   * @brief Declares whether updateBounds() of this layer is independent of the
+   *        other layers, so it may run concurrently with its neighbours when
+   *        parallel updates are enabled in the LayeredCostmap.
+   *
+   * An independent layer only reads and writes its own private data in
+   * updateBounds() (never the master grid or the parent LayeredCostmap) and only
+   * grows the bounds by the area it touched, without reading the bounds passed
+   * in from previous layers. updateCosts() is always called serially in order.
+   */
+  virtual bool isUpdateIndependent() const
+  {
+    return false;
+  }
+
+  /**
+   * @brief Declares whether updateBounds() of this layer only grows the bounds
+   *        passed in by a margin, and only changes costs within that margin of
+   *        the costs changed by the previous layers (e.g. inflation).
+   *
+   * With tiled updates in the LayeredCostmap, the dirty tiles of such a layer are
+   * the dirty tiles of the previous layers dilated by that margin. Other layers
+   * dirty the whole bounds they report.
+   */
+  virtual bool isBoundsExpansion() const
+  {
+    return false;
+  }
+
   /**
    * @brief Actually update the underlying costmap, only within the bounds
    *        calculated during UpdateBounds().
@@ -38,6 +38,8 @@
 #ifndef NAV2_COSTMAP_2D__LAYERED_COSTMAP_HPP_
 #define NAV2_COSTMAP_2D__LAYERED_COSTMAP_HPP_
 
+#include <atomic>
+#include <functional>
 #include <memory>
 #include <string>
 #include <vector>
@@ -45,6 +47,9 @@
 #include "nav2_costmap_2d/cost_values.hpp"
 #include "nav2_costmap_2d/layer.hpp"
 #include "nav2_costmap_2d/costmap_2d.hpp"
+#include "nav2_costmap_2d/costmap_snapshot.hpp"
+#include "nav2_costmap_2d/dirty_tiles.hpp"
+#include "nav2_util/thread_pool.hpp"
 
 namespace nav2_costmap_2d
 {
@@ -111,6 +116,71 @@ public:
     return &combined_costmap_;
   }
 
+  /**
+   * @brief Enable or disable parallel layer updates. When enabled, consecutive
+   * plugins declaring isUpdateIndependent() run their updateBounds() concurrently
+   * and their bounds are merged in plugin order afterwards. updateCosts() is
+   * still applied serially in plugin order.
+   * @param num_threads Number of threads to use, including the updating thread.
+   * 0 or 1 disables parallel updates.
+   */
+  void setParallelUpdates(unsigned int num_threads);
+
+  /**
+   * @brief Enable or disable tiled updates. When enabled, the bounds reported by each
+   * plugin are tracked as dirty tiles and costs are only updated over the dirty tiles,
+   * instead of over the bounding box of all the plugins' bounds.
+   * @param tile_size Size of the tile side in cells, 0 disables tiled updates
+   */
+  void setTiledUpdates(unsigned int tile_size);
+
+  /**
+   * @brief Get the latest immutable snapshot of the master costmap.
+   * The returned snapshot can be held and read without locking the costmap mutex,
+   * and is replaced (not modified) by subsequent map updates. Snapshots are only
+   * produced once requested for the first time, so costmaps without snapshot readers
+   * do not pay for the copy.
+   * @return Shared pointer to the latest snapshot
+   */
+  CostmapSnapshot::ConstPtr getSnapshot();
+
+  /**
+   * @brief Publish the current state of the master costmap as a new snapshot.
+   * Called at the end of each updateMap(), but may be called by anyone modifying
+   * the master costmap outside of the update cycle, as any cell may have changed
+   * since the previous snapshot. Must be called with the costmap mutex held.
+   */
+  void publishSnapshot();
+
+  /**
+   * @brief Publish the current state of the master costmap as a new snapshot, only
+   * changed over a region since the previous snapshot unless the map moved or resized.
+   * Must be called with the costmap mutex held.
+   * @param updated_region Cells changed since the previous snapshot
+   */
+  void publishSnapshot(const CellRegion & updated_region);
+
+  /**
+   * @brief Set the function called when a plugin or filter asks for a map update,
+   * for owners updating the map on events rather than at a fixed rate.
+   * Must be set before the layers are activated.
+   */
+  void setUpdateRequestCallback(std::function<void()> callback)
+  {
+    update_request_callback_ = std::move(callback);
+  }
+
+  /**
+   * @brief Ask for a map update, e.g. when new sensor data or a new mask arrived.
+   * Thread safe, may be called from any subscription callback.
+   */
+  void requestUpdate()
+  {
+    if (update_request_callback_) {
+      update_request_callback_();
+    }
+  }
+
   /**
    * @brief If this costmap is rolling or not
    */
@@ -212,6 +282,40 @@ public:
   bool isOutofBounds(double robot_x, double robot_y);
 
 private:
+  /**
+   * @brief Update the bounds of a range of consecutive independent plugins concurrently
+   * and expand the costmap bounds with them in order
+   */
+  void updateIndependentBounds(
+    std::vector<std::shared_ptr<Layer>>::iterator first,
+    std::vector<std::shared_ptr<Layer>>::iterator last,
+    double robot_x, double robot_y, double robot_yaw);
+
+  /**
+   * @brief Mark the tiles covered by world bounds as dirty
+   */
+  void markDirtyBounds(double min_x, double min_y, double max_x, double max_y);
+
+  /**
+   * @brief Mark the tiles affected by a layer expanding the bounds from the given
+   * previous bounds to the current ones
+   * @param expansion Whether the layer declares isBoundsExpansion(), otherwise the
+   * whole current bounds are marked
+   */
+  void markDirtyExpansion(
+    double prev_min_x, double prev_min_y, double prev_max_x, double prev_max_y,
+    bool expansion);
+
+  /**
+   * @brief Copy the master costmap into a new snapshot, with the current update history
+   */
+  void copySnapshot();
+
+  /**
+   * @brief Update the costs of all plugins and filters over the dirty regions only
+   */
+  void updateDirtyRegions();
+
   // primary_costmap_ is a bottom costmap used by plugins when costmap filters were enabled.
   // combined_costmap_ is a final costmap where all results produced by plugins and filters (if any)
   // to be merged.
@@ -233,6 +337,23 @@ private:
   bool size_locked_;
   std::atomic<double> circumscribed_radius_, inscribed_radius_;
   std::shared_ptr<std::vector<geometry_msgs::msg::Point>> footprint_;
+
+  std::unique_ptr<nav2_util::ThreadPool> thread_pool_;
+
+  std::function<void()> update_request_callback_;
+
+  unsigned int tile_size_{0};
+  DirtyTiles dirty_tiles_;
+  std::vector<CellRegion> dirty_regions_;
+
+  // The snapshot currently handed out to readers and the previously published one, which
+  // is reused as the back buffer for the next copy once no reader holds it anymore
+  CostmapSnapshot::ConstPtr snapshot_;
+  CostmapSnapshot::Ptr spare_snapshot_;
+  std::atomic<bool> snapshots_requested_{false};
+  uint64_t snapshot_revision_{0};
+  // Regions updated by the latest snapshots, most recent first
+  std::vector<CellRegion> snapshot_history_;
 };
 
 }  // namespace nav2_costmap_2d
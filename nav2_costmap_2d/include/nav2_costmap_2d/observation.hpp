@@ -32,6 +32,8 @@
 #ifndef NAV2_COSTMAP_2D__OBSERVATION_HPP_
 #define NAV2_COSTMAP_2D__OBSERVATION_HPP_
 
+#include <utility>
+
 #include <geometry_msgs/msg/point.hpp>
 #include <sensor_msgs/msg/point_cloud2.hpp>
 
@@ -126,6 +128,20 @@ public:
   {
   }
 
+  /**
+   * @brief  Exchange the contents of two observations, without copying their clouds
+   * @param obs The observation to exchange with
+   */
+  void swap(Observation & obs)
+  {
+    std::swap(origin_, obs.origin_);
+    std::swap(cloud_, obs.cloud_);
+    std::swap(obstacle_max_range_, obs.obstacle_max_range_);
+    std::swap(obstacle_min_range_, obs.obstacle_min_range_);
+    std::swap(raytrace_max_range_, obs.raytrace_max_range_);
+    std::swap(raytrace_min_range_, obs.raytrace_min_range_);
+  }
+
   geometry_msgs::msg::Point origin_;
   sensor_msgs::msg::PointCloud2 * cloud_;
   double obstacle_max_range_, obstacle_min_range_, raytrace_max_range_, raytrace_min_range_;
@@ -37,9 +37,10 @@
 #ifndef NAV2_COSTMAP_2D__OBSERVATION_BUFFER_HPP_
 #define NAV2_COSTMAP_2D__OBSERVATION_BUFFER_HPP_
 
+#include <functional>
 #include <vector>
-#include <list>
 #include <string>
+#include <unordered_set>
 
 #include "tf2_geometry_msgs/tf2_geometry_msgs.hpp"
 #include "rclcpp/time.hpp"
@@ -55,6 +56,7 @@ namespace nav2_costmap_2d
 /**
  * @class ObservationBuffer
  * @brief Takes in point clouds from sensors, transforms them to the desired frame, and stores them
+ * in a ring of observations, whose clouds are reused as new ones come in
  */
 class ObservationBuffer
 {
@@ -87,6 +89,25 @@ public:
     std::string sensor_frame,
     tf2::Duration tf_tolerance);
 
+  /**
+   * @brief  Constructs an observation buffer owned by no lifecycle node
+   * @param  clock The clock to stamp and age observations with
+   * @param  logger The logger of error and warning messages
+   * The other parameters are those of the constructor above
+   */
+  ObservationBuffer(
+    const rclcpp::Clock::SharedPtr & clock,
+    const rclcpp::Logger & logger,
+    std::string topic_name,
+    double observation_keep_time,
+    double expected_update_rate,
+    double min_obstacle_height, double max_obstacle_height, double obstacle_max_range,
+    double obstacle_min_range,
+    double raytrace_max_range, double raytrace_min_range, tf2_ros::Buffer & tf2_buffer,
+    std::string global_frame,
+    std::string sensor_frame,
+    tf2::Duration tf_tolerance);
+
   /**
    * @brief  Destructor... cleans up
    */
@@ -95,16 +116,54 @@ public:
   /**
    * @brief  Transforms a PointCloud to the global frame and buffers it
    * <b>Note: The burden is on the user to make sure the transform is available... ie they should use a MessageNotifier</b>
+   * The transform runs without the buffer lock, which is only taken to hand the finished
+   * observation over, so callers need not lock. Only one thread may feed a buffer.
    * @param  cloud The cloud to be buffered
    */
   void bufferCloud(const sensor_msgs::msg::PointCloud2 & cloud);
 
+  /**
+   * @brief  Keep at most one point per voxel of the buffered clouds, so that marking and
+   * clearing scale with the number of occupied cells rather than raw points.
+   * The voxel grid is anchored at the given origin, which should be the costmap origin
+   * so that voxels line up with costmap cells. Rolling windows stay aligned as they
+   * move by whole cells.
+   * @param  resolution Voxel size in x and y, 0 disables the filter
+   * @param  z_resolution Voxel size in z
+   * @param  origin_x Origin of the voxel grid in the global frame
+   * @param  origin_y Origin of the voxel grid in the global frame
+   * @param  origin_z Origin of the voxel grid in the global frame
+   */
+  void setVoxelFilter(
+    double resolution, double z_resolution,
+    double origin_x, double origin_y, double origin_z = 0.0);
+
+  /**
+   * @brief  Check if voxel downsampling of the buffered clouds is enabled
+   */
+  bool isVoxelFilterEnabled() const {return voxel_resolution_ > 0.0;}
+
   /**
    * @brief  Pushes copies of all current observations onto the end of the vector passed in
    * @param  observations The vector to be filled
    */
   void getObservations(std::vector<Observation> & observations);
 
+  /**
+   * @brief  Call a function on each observation buffered since the last visit, oldest first,
+   * without copying them. Stale observations are purged first. The buffer must be locked
+   * @param  sequence Number of observations buffered at the last visit, 0 to visit all
+   * the current ones, set to the number buffered so far
+   * @param  fn Function to call on the observations
+   */
+  void visitNewObservations(
+    uint64_t & sequence, const std::function<void(const Observation &)> & fn);
+
+  /**
+   * @brief  Get the time observations are kept for, 0 for only the latest
+   */
+  const rclcpp::Duration & getObservationKeepTime() const {return observation_keep_time_;}
+
   /**
    * @brief  Check if the observation buffer is being update at its expected rate
    * @return True if it is being updated at the expected rate, false otherwise
@@ -134,10 +193,15 @@ public:
 
 private:
   /**
-   * @brief  Removes any stale observations from the buffer list
+   * @brief  Removes any stale observations from the ring
    */
   void purgeStaleObservations();
 
+  /**
+   * @brief  Get the observation of a sequence number, which must still be in the ring
+   */
+  Observation & observationAt(uint64_t sequence);
+
   rclcpp::Clock::SharedPtr clock_;
   rclcpp::Logger logger_{rclcpp::get_logger("nav2_costmap_2d")};
   tf2_ros::Buffer & tf2_buffer_;
@@ -146,12 +210,21 @@ private:
   rclcpp::Time last_updated_;
   std::string global_frame_;
   std::string sensor_frame_;
-  std::list<Observation> observation_list_;
+  /// @brief Ring of observations, the newest at head_, the oldest count_ - 1 slots before
+  std::vector<Observation> observation_ring_;
+  size_t head_{0};
+  size_t count_{0};
+  uint64_t sequence_{0};  ///< @brief Number of observations buffered so far
+  Observation spare_;  ///< @brief Filled without the lock, then swapped into the ring
   std::string topic_name_;
   double min_obstacle_height_, max_obstacle_height_;
   std::recursive_mutex lock_;  ///< @brief A lock for accessing data in callbacks safely
   double obstacle_max_range_, obstacle_min_range_, raytrace_max_range_, raytrace_min_range_;
   tf2::Duration tf_tolerance_;
+
+  double voxel_resolution_{0.0}, voxel_z_resolution_{0.0};
+  double voxel_origin_x_{0.0}, voxel_origin_y_{0.0}, voxel_origin_z_{0.0};
+  std::unordered_set<uint64_t> voxel_keys_;  ///< @brief Occupied voxels, reused across clouds
 };
 }  // namespace nav2_costmap_2d
 #endif  // NAV2_COSTMAP_2D__OBSERVATION_BUFFER_HPP_
@@ -56,7 +56,9 @@
 #include "nav2_costmap_2d/costmap_layer.hpp"
 #include "nav2_costmap_2d/layered_costmap.hpp"
 #include "nav2_costmap_2d/observation_buffer.hpp"
+#include "nav2_costmap_2d/shared_observation_source.hpp"
 #include "nav2_costmap_2d/footprint.hpp"
+#include "nav2_util/node_thread.hpp"
 
 namespace nav2_costmap_2d
 {
@@ -131,6 +133,24 @@ public:
    */
   virtual bool isClearable() {return true;}
 
+  /**
+   * @brief  Move the origin of the layer, and of the expiry times of its persisting marks
+   * @param new_origin_x The x coordinate of the new origin
+   * @param new_origin_y The y coordinate of the new origin
+   */
+  void updateOrigin(double new_origin_x, double new_origin_y) override;
+
+  /**
+   * @brief Match the size of the master costmap, and the voxel filters to its cells
+   */
+  void matchSize() override;
+
+  /**
+   * @brief Observations are marked into this layer's own grid only, so bounds
+   * updates may run concurrently with other independent layers
+   */
+  bool isUpdateIndependent() const override {return true;}
+
   /**
    * @brief Callback executed when a parameter change is detected
    * @param event ParameterEvent message
@@ -175,6 +195,23 @@ public:
   void clearStaticObservations(bool marking, bool clearing);
 
 protected:
+  /**
+   * @brief Replace positive infinite ranges of a scan with its max range
+   * @param message The scan to filter in place
+   */
+  static void replaceInfRanges(sensor_msgs::msg::LaserScan & message);
+
+  /**
+   * @brief Project a scan into a point cloud and buffer it
+   * @param message The scan to buffer
+   * @param buffer The observation buffer to update
+   * @param projector The projector to use, owned by the calling source
+   */
+  void bufferLaserScan(
+    const sensor_msgs::msg::LaserScan & message,
+    const std::shared_ptr<nav2_costmap_2d::ObservationBuffer> & buffer,
+    laser_geometry::LaserProjection & projector);
+
   /**
    * @brief  Get the observations used to mark space
    * @param marking_observations A reference to a vector that will be populated with the observations
@@ -191,6 +228,12 @@ protected:
   bool getClearingObservations(
     std::vector<nav2_costmap_2d::Observation> & clearing_observations) const;
 
+  /**
+   * @brief  Anchor the voxel filters of the observation buffers to the cells of the layer,
+   * when its resolution or origin changes
+   */
+  virtual void updateVoxelFilters();
+
   /**
    * @brief  Clear freespace based on one observation
    * @param clearing_observation The observation used to raytrace
@@ -205,6 +248,45 @@ protected:
     double * max_x,
     double * max_y);
 
+  /**
+   * @brief  Mark the obstacles of an observation, kept from clearing until an expiry time
+   * @param obs The marking observation
+   * @param expiry Time until which its marks persist, in seconds from persistence_epoch_
+   */
+  void markObservation(
+    const nav2_costmap_2d::Observation & obs, float expiry,
+    double * min_x, double * min_y, double * max_x, double * max_y);
+
+  /**
+   * @brief  Get the time until which the marks of an observation persist
+   * @param obs The marking observation
+   * @param keep_time How long the observations of its source are kept
+   * @return The expiry time, in seconds from persistence_epoch_
+   */
+  float markExpiry(
+    const nav2_costmap_2d::Observation & obs, const rclcpp::Duration & keep_time) const;
+
+  /// @brief Clears the cells a ray crosses, but those whose persisting mark has not expired
+  class ClearUnexpiredCell
+  {
+  public:
+    ClearUnexpiredCell(unsigned char * costmap, const float * expiry, float now)
+    : costmap_(costmap), expiry_(expiry), now_(now)
+    {
+    }
+    inline void operator()(unsigned int offset)
+    {
+      if (expiry_[offset] <= now_) {
+        costmap_[offset] = FREE_SPACE;
+      }
+    }
+
+  private:
+    unsigned char * costmap_;
+    const float * expiry_;
+    float now_;
+  };
+
   /**
    * @brief Process update costmap with raytracing the window bounds
    */
@@ -228,6 +310,19 @@ protected:
   std::string global_frame_;  ///< @brief The global frame for the costmap
   double min_obstacle_height_;  ///< @brief Max Obstacle Height
   double max_obstacle_height_;  ///< @brief Max Obstacle Height
+  /// @brief Angular width of the raytrace bins in radians, 0 traces every endpoint cell
+  double raytrace_angular_bin_size_{0.0};
+
+  /// @brief Farthest endpoint seen in one angular bin while batching a clearing trace
+  struct RaytraceBin
+  {
+    bool valid{false};
+    unsigned int squared_length{0};
+    unsigned int index{0};
+  };
+  /// @brief Scratch buffers reused across raytraceFreespace calls
+  std::vector<RaytraceBin> raytrace_bins_;
+  std::vector<unsigned int> raytrace_endpoints_;
 
   /// @brief Used to project laser scans into point clouds
   laser_geometry::LaserProjection projector_;
@@ -242,6 +337,20 @@ protected:
   std::vector<std::shared_ptr<nav2_costmap_2d::ObservationBuffer>> marking_buffers_;
   /// @brief Used to store observation buffers used for clearing obstacles
   std::vector<std::shared_ptr<nav2_costmap_2d::ObservationBuffer>> clearing_buffers_;
+  /// @brief Observations of each marking and clearing buffer already applied to the layer
+  std::vector<uint64_t> marking_sequences_, clearing_sequences_;
+
+  /// @brief Time until which the mark of each cell persists, empty without persistence.
+  /// In float seconds from persistence_epoch_, precise to about 10 ms after a day of uptime
+  std::vector<float> mark_expiry_;
+  rclcpp::Time persistence_epoch_;
+
+  /// @brief Executor threads of the sources with a dedicated callback group, if enabled
+  std::vector<std::unique_ptr<nav2_util::NodeThread>> source_threads_;
+  /// @brief Sources shared with the layers of the process, if enabled, and the
+  /// identifiers of the listeners requesting updates of this layer
+  std::vector<std::shared_ptr<SharedObservationSource>> shared_sources_;
+  std::vector<size_t> shared_listeners_;
 
   /// @brief Dynamic parameters handler
   rclcpp::node_interfaces::OnSetParametersCallbackHandle::SharedPtr dyn_params_handler_;
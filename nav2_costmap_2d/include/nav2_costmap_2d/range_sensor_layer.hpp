@@ -123,6 +123,12 @@ public:
    */
   virtual bool isClearable() {return true;}
 
+  /**
+   * @brief Ranges are processed into this layer's own grid only, so bounds
+   * updates may run concurrently with other independent layers
+   */
+  bool isUpdateIndependent() const override {return true;}
+
   /**
    * @brief Handle an incoming Range message to populate into costmap
    */
@@ -162,9 +168,13 @@ protected:
    */
   inline double gamma(double theta);
   /**
-   * @brief Get the delta value for an angle, phi
+   * @brief Get the delta value for an angle, phi, from the table of delta values
    */
   inline double delta(double phi);
+  /**
+   * @brief Tabulate the delta values for the phi parameter, not to evaluate tanh for every cell
+   */
+  void buildDeltaTable();
   /**
    * @brief Apply the sensor model of the layer for range sensors
    */
@@ -182,6 +192,11 @@ protected:
     double ox, double oy, double ot,
     double r, double nx, double ny, bool clear);
 
+  /**
+   * @brief Update the probability of a cell with the sensor model value of a reading
+   */
+  inline void update_cell_probability(unsigned int index, double sensor);
+
   /**
    * @brief Find probability value of a cost
    */
@@ -203,6 +218,9 @@ protected:
   std::list<sensor_msgs::msg::Range> range_msgs_buffer_;
 
   double max_angle_, phi_v_;
+  // Delta values, DELTA_TABLE_SCALE per meter of phi
+  static constexpr double DELTA_TABLE_SCALE = 256.0;
+  std::vector<double> delta_table_;
   double inflate_cone_;
   std::string global_frame_;
 
@@ -0,0 +1,201 @@
+// Copyright (c) 2024 Open Navigation LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef NAV2_COSTMAP_2D__SHARED_OBSERVATION_SOURCE_HPP_
+#define NAV2_COSTMAP_2D__SHARED_OBSERVATION_SOURCE_HPP_
+
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+
+#include "laser_geometry/laser_geometry.hpp"
+#include "message_filters/subscriber.h"
+#include "nav2_costmap_2d/observation_buffer.hpp"
+#include "nav2_util/lifecycle_node.hpp"
+#include "nav2_util/node_thread.hpp"
+#include "rclcpp/rclcpp.hpp"
+#include "sensor_msgs/msg/laser_scan.hpp"
+#include "sensor_msgs/msg/point_cloud2.hpp"
+#include "tf2_ros/buffer.h"
+#include "tf2_ros/message_filter.h"
+#include "tf2_ros/transform_listener.h"
+
+namespace nav2_costmap_2d
+{
+
+/**
+ * @brief Configuration of an observation source, everything its buffered observations
+ * depend on. Layers of a process with the same configuration share one buffer
+ */
+struct ObservationSourceConfig
+{
+  std::string topic;
+  std::string data_type;
+  std::string global_frame;
+  std::string sensor_frame;
+  double observation_keep_time{0.0};
+  double expected_update_rate{0.0};
+  double min_obstacle_height{0.0};
+  double max_obstacle_height{0.0};
+  double obstacle_max_range{0.0};
+  double obstacle_min_range{0.0};
+  double raytrace_max_range{0.0};
+  double raytrace_min_range{0.0};
+  double transform_tolerance{0.0};
+  bool inf_is_valid{false};
+  // Voxel filter of the buffer, off at a resolution of 0
+  double voxel_resolution{0.0};
+  double voxel_origin_x{0.0};
+  double voxel_origin_y{0.0};
+
+  bool operator<(const ObservationSourceConfig & other) const;
+};
+
+class ObservationSourceHub;
+
+/**
+ * @class nav2_costmap_2d::SharedObservationSource
+ * @brief An observation source shared by the costmap layers of a process, such as
+ * the obstacle layers of the local and global costmaps of composed servers. Sensor
+ * topics are subscribed to once per process, on an internal node with its own TF
+ * listener and executor thread, so each message is received once. Each message is
+ * then transformed, filtered and buffered once per distinct source configuration,
+ * rather than once per layer. Layers still mark and clear their own grids from
+ * the shared buffer, tracking what they consumed with their own sequence numbers.
+ */
+class SharedObservationSource
+{
+public:
+  /**
+   * @brief Get the source of a configuration, created on first use
+   * @param config Configuration of the source
+   * @param node Node of the calling layer, whose namespace and time source the
+   * internal node of the process takes when it is first created
+   * @return The source shared by the layers of the process with this configuration,
+   * keeping the internal node and all the sources alive
+   */
+  static std::shared_ptr<SharedObservationSource> get(
+    const ObservationSourceConfig & config,
+    const nav2_util::LifecycleNode::SharedPtr & node);
+
+  /**
+   * @brief Get the buffer the observations are shared in
+   */
+  std::shared_ptr<ObservationBuffer> getBuffer() const {return buffer_;}
+
+  /**
+   * @brief Register a function called after each observation is buffered, from the
+   * thread of the internal node
+   * @param callback Function to call
+   * @return Identifier of the listener, to remove it
+   */
+  size_t addListener(std::function<void()> callback);
+
+  /**
+   * @brief Remove a listener, waiting for a call in progress to return
+   * @param id Identifier returned by addListener
+   */
+  void removeListener(size_t id);
+
+  /**
+   * @brief Start receiving observations on behalf of a layer, subscribing to the topic
+   * when the first of its layers activates
+   */
+  void activate();
+
+  /**
+   * @brief Stop receiving observations on behalf of a layer, unsubscribing from the
+   * topic when the last of its layers deactivates
+   */
+  void deactivate();
+
+  /**
+   * @brief A subscription of the hub, shared by the sources of a topic
+   */
+  struct Topic
+  {
+    std::shared_ptr<message_filters::SubscriberBase<rclcpp::Node>> subscriber;
+    int active{0};
+  };
+
+  /**
+   * @brief A constructor for nav2_costmap_2d::SharedObservationSource, use get()
+   * @param config Configuration of the source
+   * @param hub Hub owning the source
+   * @param topic Subscription of the topic of the source
+   */
+  SharedObservationSource(
+    const ObservationSourceConfig & config, ObservationSourceHub & hub, Topic & topic);
+
+protected:
+  /**
+   * @brief Buffer a cloud and notify the listeners
+   */
+  void bufferCloud(const sensor_msgs::msg::PointCloud2 & cloud);
+
+  /**
+   * @brief Project a scan into a cloud and buffer it
+   */
+  void bufferLaserScan(const sensor_msgs::msg::LaserScan & message);
+
+  ObservationSourceConfig config_;
+  ObservationSourceHub & hub_;
+  Topic & topic_;
+  std::shared_ptr<ObservationBuffer> buffer_;
+  std::shared_ptr<tf2_ros::MessageFilterBase> filter_;
+  laser_geometry::LaserProjection projector_;
+
+  std::mutex listeners_mutex_;
+  std::map<size_t, std::function<void()>> listeners_;
+  size_t next_listener_{0};
+};
+
+/**
+ * @class nav2_costmap_2d::ObservationSourceHub
+ * @brief Internal node, TF listener and executor thread of the shared observation
+ * sources of a process, which it owns. It lives as long as a layer holds one of its
+ * sources, so that no subscription or filter is destroyed while its thread runs
+ */
+class ObservationSourceHub
+{
+public:
+  /**
+   * @brief A constructor for nav2_costmap_2d::ObservationSourceHub
+   * @param node Node whose namespace and time source the internal node takes
+   */
+  explicit ObservationSourceHub(const nav2_util::LifecycleNode::SharedPtr & node);
+
+  /**
+   * @brief Destructor, stopping the executor thread before the sources go away
+   */
+  ~ObservationSourceHub();
+
+protected:
+  friend class SharedObservationSource;
+
+  rclcpp::Node::SharedPtr node_;
+  std::shared_ptr<tf2_ros::Buffer> tf_;
+  std::shared_ptr<tf2_ros::TransformListener> tf_listener_;
+  std::unique_ptr<nav2_util::NodeThread> executor_thread_;
+
+  std::mutex mutex_;  ///< Guards the maps and the activation counts of the topics
+  std::map<std::string, std::unique_ptr<SharedObservationSource::Topic>> topics_;
+  std::map<ObservationSourceConfig, std::unique_ptr<SharedObservationSource>> sources_;
+};
+
+}  // namespace nav2_costmap_2d
+
+#endif  // NAV2_COSTMAP_2D__SHARED_OBSERVATION_SOURCE_HPP_
@@ -44,6 +44,7 @@
 
 #include "map_msgs/msg/occupancy_grid_update.hpp"
 #include "message_filters/subscriber.h"
+#include "nav2_costmap_2d/cost_map_file.hpp"
 #include "nav2_costmap_2d/costmap_layer.hpp"
 #include "nav2_costmap_2d/layered_costmap.hpp"
 #include "nav_msgs/msg/occupancy_grid.hpp"
@@ -93,6 +94,16 @@ public:
    */
   virtual bool isClearable() {return false;}
 
+  /**
+   * @brief The grid of the layer is the static map
+   */
+  bool isStaticMap() override {return true;}
+
+  /**
+   * @brief Whether a map was received, from the map topic or a cost map file
+   */
+  bool isMapReady() override {return map_received_;}
+
   /**
    * @brief Update the bounds of the master costmap by this layer's update dimensions
    * @param robot_x X pose of robot
@@ -135,13 +146,47 @@ protected:
    */
   void processMap(const nav_msgs::msg::OccupancyGrid & new_map);
 
+  /**
+   * @brief Resize the layered costmap, or only this layer if rolling, to a static map geometry
+   */
+  void matchMapGeometry(
+    unsigned int size_x, unsigned int size_y, double resolution,
+    double origin_x, double origin_y);
+
+  /**
+   * @brief Memory map the cost map file given by the map_file parameter and use it
+   * as the costs of this layer, instead of a copy of a map received on a topic
+   * @return True if the file was loaded
+   */
+  bool loadMapFile();
+
+  /**
+   * @brief Whether the costs of this layer currently live in the mapped file
+   */
+  bool usesMappedMap() const;
+
+  /**
+   * @brief Use the mapped file as storage when it matches the requested size
+   */
+  virtual void initMaps(unsigned int size_x, unsigned int size_y);
+
+  /**
+   * @brief Release the costs, leaving the mapped file alone
+   */
+  virtual void deleteMaps();
+
+  /**
+   * @brief Reset the costs, back to the file contents when it is mapped
+   */
+  virtual void resetMaps();
+
   /**
    * @brief  Callback to update the costmap's map from the map_server
    * @param new_map The map to put into the costmap. The origin of the new
    * map along with its size will determine what parts of the costmap's
    * static map are overwritten.
    */
-  void incomingMap(const nav_msgs::msg::OccupancyGrid::SharedPtr new_map);
+  void incomingMap(const nav_msgs::msg::OccupancyGrid::ConstSharedPtr new_map);
   /**
    * @brief Callback to update the costmap's map from the map_server (or SLAM)
    * with an update in a particular area of the map
@@ -197,7 +242,9 @@ protected:
   bool map_received_{false};
   bool map_received_in_update_bounds_{false};
   tf2::Duration transform_tolerance_;
-  nav_msgs::msg::OccupancyGrid::SharedPtr map_buffer_;
+  nav_msgs::msg::OccupancyGrid::ConstSharedPtr map_buffer_;
+  std::string map_file_;
+  MappedCostMapFile mapped_map_;
   // Dynamic parameters handler
   rclcpp::node_interfaces::OnSetParametersCallbackHandle::SharedPtr dyn_params_handler_;
 };
@@ -0,0 +1,141 @@
+// Copyright (c) 2024 Open Navigation LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef NAV2_COSTMAP_2D__VOXEL_GRID_COLUMNS_HPP_
+#define NAV2_COSTMAP_2D__VOXEL_GRID_COLUMNS_HPP_
+
+#include <cstdint>
+#include <vector>
+
+#include "nav2_msgs/msg/voxel_grid.hpp"
+#include "nav2_msgs/msg/voxel_grid_update.hpp"
+
+namespace nav2_costmap_2d
+{
+
+/**
+ * @struct VoxelPoint
+ * @brief Center of a voxel, in the frame of the voxel grid
+ */
+struct VoxelPoint
+{
+  float x;
+  float y;
+  float z;
+};
+
+/**
+ * @class VoxelGridColumns
+ * @brief Copy of a voxel grid received as VoxelGrid or VoxelGridUpdate messages, with the
+ * centers of its marked and unknown voxels. The centers are kept per tile of columns, and
+ * only the tiles of the columns that changed are converted again.
+ */
+class VoxelGridColumns
+{
+public:
+  /**
+   * @brief A constructor
+   * @param tile_size Size of the side of the tiles, in columns
+   */
+  explicit VoxelGridColumns(unsigned int tile_size = 16);
+
+  /**
+   * @brief Sets the whole grid
+   * @param grid Voxel grid message
+   */
+  void setGrid(const nav2_msgs::msg::VoxelGrid & grid);
+
+  /**
+   * @brief Applies a keyframe or the delta following the last message applied
+   * @param update Voxel grid update message
+   * @return False if the delta does not follow the last message applied, waiting for a keyframe
+   */
+  bool applyUpdate(const nav2_msgs::msg::VoxelGridUpdate & update);
+
+  /**
+   * @brief Converts the voxels of the tiles changed since the last call
+   * @return Number of tiles converted
+   */
+  unsigned int convertChangedTiles();
+
+  /**
+   * @brief Gets the centers of the marked voxels, as of the last conversion
+   * @param points Will be filled with the centers
+   */
+  void getMarked(std::vector<VoxelPoint> & points) const;
+
+  /**
+   * @brief Gets the centers of the unknown voxels, as of the last conversion
+   * @param points Will be filled with the centers
+   */
+  void getUnknown(std::vector<VoxelPoint> & points) const;
+
+  /**
+   * @brief Whether a grid was received
+   */
+  bool hasGrid() const {return !columns_.empty();}
+
+  float getResolutionX() const {return resolution_x_;}
+  float getResolutionY() const {return resolution_y_;}
+  float getResolutionZ() const {return resolution_z_;}
+
+protected:
+  /**
+   * @brief Sets the size and placement of the grid, converting every tile again if changed
+   */
+  void setGeometry(
+    const geometry_msgs::msg::Point32 & origin, const geometry_msgs::msg::Vector3 & resolutions,
+    uint32_t size_x, uint32_t size_y, uint32_t size_z);
+
+  /**
+   * @brief Marks the tile of a column as changed
+   */
+  void markColumn(uint32_t index);
+
+  /**
+   * @brief Converts the voxels of a tile
+   */
+  void convertTile(unsigned int tile);
+
+  /**
+   * @brief Appends the points of every tile
+   */
+  static void gatherPoints(
+    const std::vector<std::vector<VoxelPoint>> & tiles, std::vector<VoxelPoint> & points);
+
+  unsigned int tile_size_;
+  uint32_t size_x_{0};
+  uint32_t size_y_{0};
+  uint32_t size_z_{0};
+  float origin_x_{0.0f};
+  float origin_y_{0.0f};
+  float origin_z_{0.0f};
+  float resolution_x_{0.0f};
+  float resolution_y_{0.0f};
+  float resolution_z_{0.0f};
+  unsigned int tiles_x_{0};
+  unsigned int tiles_y_{0};
+
+  std::vector<uint32_t> columns_;
+  std::vector<uint8_t> changed_tiles_;
+  std::vector<std::vector<VoxelPoint>> marked_;
+  std::vector<std::vector<VoxelPoint>> unknown_;
+
+  uint64_t sequence_{0};
+  bool synchronized_{false};
+};
+
+}  // namespace nav2_costmap_2d
+
+#endif  // NAV2_COSTMAP_2D__VOXEL_GRID_COLUMNS_HPP_
@@ -47,12 +47,14 @@
 #include <nav2_costmap_2d/observation_buffer.hpp>
 #include <nav_msgs/msg/occupancy_grid.hpp>
 #include <nav2_msgs/msg/voxel_grid.hpp>
+#include <nav2_msgs/msg/voxel_grid_update.hpp>
 #include <sensor_msgs/msg/laser_scan.hpp>
 #include <laser_geometry/laser_geometry.hpp>
 #include <sensor_msgs/msg/point_cloud.hpp>
 #include <sensor_msgs/msg/point_cloud2.hpp>
 #include <nav2_costmap_2d/obstacle_layer.hpp>
 #include <nav2_voxel_grid/voxel_grid.hpp>
+#include <nav2_voxel_grid/sparse_voxel_grid.hpp>
 
 namespace nav2_costmap_2d
 {
@@ -68,7 +70,7 @@ public:
    * @brief Voxel Layer constructor
    */
   VoxelLayer()
-  : voxel_grid_(0, 0, 0)
+  : voxel_grid_(0, 0, 0), sparse_voxel_grid_(0, 0, 0)
   {
     costmap_ = NULL;  // this is the unsigned char* member of parent class's parent class Costmap2D
   }
@@ -142,9 +144,51 @@ protected:
     double * max_x,
     double * max_y);
 
+  /**
+   * @brief Anchor the voxel filters of the observation buffers to the voxels of the layer
+   */
+  void updateVoxelFilters() override;
+
+  /**
+   * @brief Whether the voxel grid is to be published this update, at voxel_publish_frequency
+   */
+  bool isVoxelPublishDue();
+
+  /**
+   * @brief Publishes the voxel grid, or the columns within voxel_publish_radius of the robot,
+   * if subscribed to
+   * @param robot_x X position of the robot
+   * @param robot_y Y position of the robot
+   */
+  void publishVoxelMap(double robot_x, double robot_y);
+
+  /**
+   * @brief Publishes the voxel columns changed since the last update, or a keyframe
+   */
+  void publishVoxelUpdate();
+
   bool publish_voxel_;
   rclcpp_lifecycle::LifecyclePublisher<nav2_msgs::msg::VoxelGrid>::SharedPtr voxel_pub_;
+  bool publish_voxel_updates_{false};
+  double voxel_publish_frequency_{0.0};
+  double voxel_publish_radius_{0.0};
+  rclcpp::Time last_voxel_publish_time_;
+  unsigned int voxel_keyframe_interval_{10};
+  rclcpp_lifecycle::LifecyclePublisher<nav2_msgs::msg::VoxelGridUpdate>::SharedPtr
+    voxel_update_pub_;
+  // Columns and geometry of the grid as of the last update sent
+  std::vector<uint32_t> voxel_reference_;
+  uint32_t voxel_reference_size_z_{0};
+  geometry_msgs::msg::Point32 voxel_reference_origin_;
+  geometry_msgs::msg::Vector3 voxel_reference_resolutions_;
+  uint64_t voxel_update_sequence_{0};
+  unsigned int voxel_deltas_since_keyframe_{0};
   nav2_voxel_grid::VoxelGrid voxel_grid_;
+  // With a sparse voxel grid, only the blocks of columns observed are stored, and the
+  // dense columns are only built to publish updates
+  bool use_sparse_voxel_grid_{false};
+  nav2_voxel_grid::SparseVoxelGrid sparse_voxel_grid_;
+  std::vector<uint32_t> voxel_columns_;
   double z_resolution_, origin_z_;
   int unknown_threshold_, mark_threshold_, size_z_;
   rclcpp_lifecycle::LifecyclePublisher<sensor_msgs::msg::PointCloud2>::SharedPtr
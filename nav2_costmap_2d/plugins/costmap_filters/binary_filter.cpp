@@ -110,7 +110,7 @@ void BinaryFilter::filterInfoCallback(
     throw std::runtime_error{"Failed to lock node"};
   }
 
-  if (!mask_sub_) {
+  if (!mask_sub_ && !sparse_mask_sub_) {
     RCLCPP_INFO(
       logger_,
       "BinaryFilter: Received filter info from %s topic.", filter_info_topic_.c_str());
@@ -121,6 +121,7 @@ void BinaryFilter::filterInfoCallback(
       filter_info_topic_.c_str());
     // Resetting previous subscriber each time when new costmap filter information arrives
     mask_sub_.reset();
+    sparse_mask_sub_.reset();
   }
 
   if (msg->type != BINARY_FILTER) {
@@ -139,13 +140,19 @@ void BinaryFilter::filterInfoCallback(
     logger_,
     "BinaryFilter: Subscribing to \"%s\" topic for filter mask...",
     mask_topic_.c_str());
-  mask_sub_ = node->create_subscription<nav_msgs::msg::OccupancyGrid>(
-    mask_topic_, rclcpp::QoS(rclcpp::KeepLast(1)).transient_local().reliable(),
-    std::bind(&BinaryFilter::maskCallback, this, std::placeholders::_1));
+  if (msg->sparse_mask) {
+    sparse_mask_sub_ = node->create_subscription<nav2_msgs::msg::SparseFilterMask>(
+      mask_topic_, rclcpp::QoS(rclcpp::KeepLast(1)).transient_local().reliable(),
+      std::bind(&BinaryFilter::sparseMaskCallback, this, std::placeholders::_1));
+  } else {
+    mask_sub_ = node->create_subscription<nav_msgs::msg::OccupancyGrid>(
+      mask_topic_, rclcpp::QoS(rclcpp::KeepLast(1)).transient_local().reliable(),
+      std::bind(&BinaryFilter::maskCallback, this, std::placeholders::_1));
+  }
 }
 
 void BinaryFilter::maskCallback(
-  const nav_msgs::msg::OccupancyGrid::SharedPtr msg)
+  const nav_msgs::msg::OccupancyGrid::ConstSharedPtr msg)
 {
   std::lock_guard<CostmapFilter::mutex_t> guard(*getMutex());
 
@@ -162,6 +169,29 @@ void BinaryFilter::maskCallback(
   }
 
   filter_mask_ = msg;
+  sparse_mask_.reset();
+  layered_costmap_->requestUpdate();
+}
+
+void BinaryFilter::sparseMaskCallback(
+  const nav2_msgs::msg::SparseFilterMask::ConstSharedPtr msg)
+{
+  std::lock_guard<CostmapFilter::mutex_t> guard(*getMutex());
+
+  if (!sparse_mask_) {
+    RCLCPP_INFO(
+      logger_,
+      "BinaryFilter: Received sparse filter mask from %s topic.", mask_topic_.c_str());
+  } else {
+    RCLCPP_WARN(
+      logger_,
+      "BinaryFilter: New sparse filter mask arrived from %s topic. Updating old filter mask.",
+      mask_topic_.c_str());
+  }
+
+  sparse_mask_ = msg;
+  filter_mask_.reset();
+  layered_costmap_->requestUpdate();
 }
 
 void BinaryFilter::process(
@@ -171,7 +201,7 @@ void BinaryFilter::process(
 {
   std::lock_guard<CostmapFilter::mutex_t> guard(*getMutex());
 
-  if (!filter_mask_) {
+  if (!filter_mask_ && !sparse_mask_) {
     // Show warning message every 2 seconds to not litter an output
     RCLCPP_WARN_THROTTLE(
       logger_, *(clock_), 2000,
@@ -181,14 +211,19 @@ void BinaryFilter::process(
 
   geometry_msgs::msg::Pose2D mask_pose;  // robot coordinates in mask frame
 
+  const std::string & mask_frame =
+    filter_mask_ ? filter_mask_->header.frame_id : sparse_mask_->header.frame_id;
+  const nav_msgs::msg::MapMetaData & mask_info =
+    filter_mask_ ? filter_mask_->info : sparse_mask_->info;
+
   // Transforming robot pose from current layer frame to mask frame
-  if (!transformPose(global_frame_, pose, filter_mask_->header.frame_id, mask_pose)) {
+  if (!transformPose(global_frame_, pose, mask_frame, mask_pose)) {
     return;
   }
 
   // Converting mask_pose robot position to filter_mask_ indexes (mask_robot_i, mask_robot_j)
   unsigned int mask_robot_i, mask_robot_j;
-  if (!worldToMask(filter_mask_, mask_pose.x, mask_pose.y, mask_robot_i, mask_robot_j)) {
+  if (!worldToMask(mask_info, mask_pose.x, mask_pose.y, mask_robot_i, mask_robot_j)) {
     // Robot went out of mask range. Set "false" state by-default
     RCLCPP_WARN(
       logger_,
@@ -198,7 +233,9 @@ void BinaryFilter::process(
   }
 
   // Getting filter_mask data from cell where the robot placed
-  int8_t mask_data = getMaskData(filter_mask_, mask_robot_i, mask_robot_j);
+  int8_t mask_data = filter_mask_ ?
+    getMaskData(filter_mask_, mask_robot_i, mask_robot_j) :
+    getMaskData(sparse_mask_, mask_robot_i, mask_robot_j);
   if (mask_data == nav2_util::OCC_GRID_UNKNOWN) {
     // Corresponding filter mask cell is unknown.
     // Warn and do nothing.
@@ -229,6 +266,7 @@ void BinaryFilter::resetFilter()
 
   filter_info_sub_.reset();
   mask_sub_.reset();
+  sparse_mask_sub_.reset();
   if (binary_state_pub_) {
     binary_state_pub_->on_deactivate();
     binary_state_pub_.reset();
@@ -239,7 +277,7 @@ bool BinaryFilter::isActive()
 {
   std::lock_guard<CostmapFilter::mutex_t> guard(*getMutex());
 
-  if (filter_mask_) {
+  if (filter_mask_ || sparse_mask_) {
     return true;
   }
   return false;
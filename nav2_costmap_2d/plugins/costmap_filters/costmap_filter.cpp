@@ -193,11 +193,18 @@ bool CostmapFilter::worldToMask(
   nav_msgs::msg::OccupancyGrid::ConstSharedPtr filter_mask,
   double wx, double wy, unsigned int & mx, unsigned int & my) const
 {
-  const double origin_x = filter_mask->info.origin.position.x;
-  const double origin_y = filter_mask->info.origin.position.y;
-  const double resolution = filter_mask->info.resolution;
-  const unsigned int size_x = filter_mask->info.width;
-  const unsigned int size_y = filter_mask->info.height;
+  return worldToMask(filter_mask->info, wx, wy, mx, my);
+}
+
+bool CostmapFilter::worldToMask(
+  const nav_msgs::msg::MapMetaData & info,
+  double wx, double wy, unsigned int & mx, unsigned int & my) const
+{
+  const double origin_x = info.origin.position.x;
+  const double origin_y = info.origin.position.y;
+  const double resolution = info.resolution;
+  const unsigned int size_x = info.width;
+  const unsigned int size_y = info.height;
 
   if (wx < origin_x || wy < origin_y) {
     return false;
@@ -216,9 +223,37 @@ unsigned char CostmapFilter::getMaskCost(
   nav_msgs::msg::OccupancyGrid::ConstSharedPtr filter_mask,
   const unsigned int mx, const unsigned int & my) const
 {
-  const unsigned int index = my * filter_mask->info.width + mx;
+  return dataToCost(getMaskData(filter_mask, mx, my));
+}
 
-  const char data = filter_mask->data[index];
+int8_t CostmapFilter::getMaskData(
+  nav2_msgs::msg::SparseFilterMask::ConstSharedPtr sparse_mask,
+  const unsigned int mx, const unsigned int my) const
+{
+  // Last run starting at or before (mx, my)
+  const auto & row = sparse_mask->row;
+  const auto & start = sparse_mask->start;
+  size_t lo = 0, hi = row.size();
+  while (lo < hi) {
+    const size_t mid = lo + (hi - lo) / 2;
+    if (row[mid] < my || (row[mid] == my && start[mid] <= mx)) {
+      lo = mid + 1;
+    } else {
+      hi = mid;
+    }
+  }
+
+  if (lo > 0) {
+    const size_t r = lo - 1;
+    if (row[r] == my && mx < start[r] + sparse_mask->length[r]) {
+      return sparse_mask->value[r];
+    }
+  }
+  return sparse_mask->default_value;
+}
+
+unsigned char CostmapFilter::dataToCost(const int8_t data) const
+{
   if (data == nav2_util::OCC_GRID_UNKNOWN) {
     return NO_INFORMATION;
   } else {
@@ -86,7 +86,7 @@ void KeepoutFilter::filterInfoCallback(
     throw std::runtime_error{"Failed to lock node"};
   }
 
-  if (!mask_sub_) {
+  if (!mask_sub_ && !sparse_mask_sub_) {
     RCLCPP_INFO(
       logger_,
       "KeepoutFilter: Received filter info from %s topic.", filter_info_topic_.c_str());
@@ -97,6 +97,7 @@ void KeepoutFilter::filterInfoCallback(
       filter_info_topic_.c_str());
     // Resetting previous subscriber each time when new costmap filter information arrives
     mask_sub_.reset();
+    sparse_mask_sub_.reset();
   }
 
   // Checking that base and multiplier are set to their default values
@@ -115,13 +116,19 @@ void KeepoutFilter::filterInfoCallback(
     logger_,
     "KeepoutFilter: Subscribing to \"%s\" topic for filter mask...",
     mask_topic_.c_str());
-  mask_sub_ = node->create_subscription<nav_msgs::msg::OccupancyGrid>(
-    mask_topic_, rclcpp::QoS(rclcpp::KeepLast(1)).transient_local().reliable(),
-    std::bind(&KeepoutFilter::maskCallback, this, std::placeholders::_1));
+  if (msg->sparse_mask) {
+    sparse_mask_sub_ = node->create_subscription<nav2_msgs::msg::SparseFilterMask>(
+      mask_topic_, rclcpp::QoS(rclcpp::KeepLast(1)).transient_local().reliable(),
+      std::bind(&KeepoutFilter::sparseMaskCallback, this, std::placeholders::_1));
+  } else {
+    mask_sub_ = node->create_subscription<nav_msgs::msg::OccupancyGrid>(
+      mask_topic_, rclcpp::QoS(rclcpp::KeepLast(1)).transient_local().reliable(),
+      std::bind(&KeepoutFilter::maskCallback, this, std::placeholders::_1));
+  }
 }
 
 void KeepoutFilter::maskCallback(
-  const nav_msgs::msg::OccupancyGrid::SharedPtr msg)
+  const nav_msgs::msg::OccupancyGrid::ConstSharedPtr msg)
 {
   std::lock_guard<CostmapFilter::mutex_t> guard(*getMutex());
 
@@ -144,6 +151,174 @@ void KeepoutFilter::maskCallback(
 
   // Store filter_mask_
   filter_mask_ = msg;
+  sparse_mask_.reset();
+  buildMaskRuns();
+  layered_costmap_->requestUpdate();
+}
+
+void KeepoutFilter::sparseMaskCallback(
+  const nav2_msgs::msg::SparseFilterMask::ConstSharedPtr msg)
+{
+  std::lock_guard<CostmapFilter::mutex_t> guard(*getMutex());
+
+  if (!sparse_mask_) {
+    RCLCPP_INFO(
+      logger_,
+      "KeepoutFilter: Received sparse filter mask from %s topic.", mask_topic_.c_str());
+  } else {
+    RCLCPP_WARN(
+      logger_,
+      "KeepoutFilter: New sparse filter mask arrived from %s topic. Updating old filter mask.",
+      mask_topic_.c_str());
+  }
+
+  sparse_mask_ = msg;
+  filter_mask_.reset();
+  buildSparseMaskRuns();
+  layered_costmap_->requestUpdate();
+}
+
+void KeepoutFilter::buildMaskRuns()
+{
+  const unsigned int size_x = filter_mask_->info.width;
+  const unsigned int size_y = filter_mask_->info.height;
+
+  mask_runs_.clear();
+  mask_row_start_.assign(size_y + 1, 0);
+  for (unsigned int my = 0; my < size_y; my++) {
+    mask_row_start_[my] = mask_runs_.size();
+    unsigned int mx = 0;
+    while (mx < size_x) {
+      const unsigned char cost = getMaskCost(filter_mask_, mx, my);
+      unsigned int run_end = mx + 1;
+      while (run_end < size_x && getMaskCost(filter_mask_, run_end, my) == cost) {
+        run_end++;
+      }
+      if (cost != NO_INFORMATION) {
+        mask_runs_.push_back(MaskRun{mx, run_end, cost});
+      }
+      mx = run_end;
+    }
+  }
+  mask_row_start_[size_y] = mask_runs_.size();
+}
+
+void KeepoutFilter::buildSparseMaskRuns()
+{
+  const unsigned int size_x = sparse_mask_->info.width;
+  const unsigned int size_y = sparse_mask_->info.height;
+  const unsigned char default_cost = dataToCost(sparse_mask_->default_value);
+
+  // Runs of the message, with the cells between them taking the default cost
+  auto add_run = [this](unsigned int x0, unsigned int xn, unsigned char cost) {
+      if (x0 < xn && cost != NO_INFORMATION) {
+        mask_runs_.push_back(MaskRun{x0, xn, cost});
+      }
+    };
+
+  mask_runs_.clear();
+  mask_row_start_.assign(size_y + 1, 0);
+  size_t r = 0;
+  const size_t runs = sparse_mask_->row.size();
+  for (unsigned int my = 0; my < size_y; my++) {
+    mask_row_start_[my] = mask_runs_.size();
+    unsigned int mx = 0;
+    for (; r < runs && sparse_mask_->row[r] == my; r++) {
+      const unsigned int x0 = std::min(sparse_mask_->start[r], size_x);
+      const unsigned int xn = std::min(x0 + sparse_mask_->length[r], size_x);
+      add_run(mx, x0, default_cost);
+      add_run(x0, xn, dataToCost(sparse_mask_->value[r]));
+      mx = xn;
+    }
+    add_run(mx, size_x, default_cost);
+  }
+  mask_row_start_[size_y] = mask_runs_.size();
+}
+
+unsigned char KeepoutFilter::getMaskRunCost(unsigned int mx, unsigned int my) const
+{
+  // Last run of the row starting at or before mx
+  auto first = mask_runs_.begin() + mask_row_start_[my];
+  auto last = mask_runs_.begin() + mask_row_start_[my + 1];
+  auto run = std::upper_bound(
+    first, last, mx,
+    [](unsigned int x, const MaskRun & r) {return x < r.x0;});
+  if (run != first && mx < (run - 1)->xn) {
+    return (run - 1)->cost;
+  }
+  return NO_INFORMATION;
+}
+
+void KeepoutFilter::applyMaskRuns(
+  nav2_costmap_2d::Costmap2D & master_grid,
+  unsigned int min_i, unsigned int min_j, unsigned int max_i, unsigned int max_j)
+{
+  if (min_i >= max_i) {
+    return;
+  }
+
+  const nav_msgs::msg::MapMetaData & mask_info = getMaskInfo();
+  const double origin_x = mask_info.origin.position.x;
+  const double origin_y = mask_info.origin.position.y;
+  const double resolution = mask_info.resolution;
+  const unsigned int size_y = mask_info.height;
+
+  // Position of the center of master_grid column i in mask cells, computed as in worldToMask().
+  // It grows with i, so the columns falling into a run can be found by bisection.
+  auto mask_x = [&](unsigned int i) {
+      double wx, wy;
+      master_grid.mapToWorld(i, 0, wx, wy);
+      return (wx - origin_x) / resolution;
+    };
+  // First column of the window whose center lies at or beyond mask column bound
+  auto first_column = [&](unsigned int bound) {
+      unsigned int lo = min_i, hi = max_i;
+      while (lo < hi) {
+        const unsigned int mid = lo + (hi - lo) / 2;
+        if (mask_x(mid) >= bound) {
+          hi = mid;
+        } else {
+          lo = mid + 1;
+        }
+      }
+      return lo;
+    };
+
+  const double window_mask_x0 = mask_x(min_i);
+  const double window_mask_xn = mask_x(max_i - 1);
+  unsigned char * master_array = master_grid.getCharMap();
+
+  for (unsigned int j = min_j; j < max_j; j++) {
+    double wx, wy;
+    master_grid.mapToWorld(min_i, j, wx, wy);
+    if (wy < origin_y) {
+      continue;
+    }
+    const unsigned int my = static_cast<unsigned int>((wy - origin_y) / resolution);
+    if (my >= size_y) {
+      continue;
+    }
+
+    for (size_t r = mask_row_start_[my]; r < mask_row_start_[my + 1]; r++) {
+      const MaskRun & run = mask_runs_[r];
+      if (run.xn <= window_mask_x0) {
+        continue;
+      }
+      if (run.x0 > window_mask_xn) {
+        break;
+      }
+
+      const unsigned int run_min_i = first_column(run.x0);
+      const unsigned int run_max_i = first_column(run.xn);
+      unsigned char * cell = master_array + master_grid.getIndex(run_min_i, j);
+      for (unsigned int i = run_min_i; i < run_max_i; i++, cell++) {
+        // Update if mask_ data is greater than existing master_grid's one
+        if (run.cost > *cell || *cell == NO_INFORMATION) {
+          *cell = run.cost;
+        }
+      }
+    }
+  }
 }
 
 void KeepoutFilter::process(
@@ -153,7 +328,7 @@ void KeepoutFilter::process(
 {
   std::lock_guard<CostmapFilter::mutex_t> guard(*getMutex());
 
-  if (!filter_mask_) {
+  if (!filter_mask_ && !sparse_mask_) {
     // Show warning message every 2 seconds to not litter an output
     RCLCPP_WARN_THROTTLE(
       logger_, *(clock_), 2000,
@@ -166,7 +341,9 @@ void KeepoutFilter::process(
   int mg_min_x, mg_min_y;  // masger_grid indexes of bottom-left window corner
   int mg_max_x, mg_max_y;  // masger_grid indexes of top-right window corner
 
-  const std::string mask_frame = filter_mask_->header.frame_id;
+  const std::string mask_frame =
+    filter_mask_ ? filter_mask_->header.frame_id : sparse_mask_->header.frame_id;
+  const nav_msgs::msg::MapMetaData & mask_info = getMaskInfo();
 
   if (mask_frame != global_frame_) {
     // Filter mask and current layer are in different frames:
@@ -215,9 +392,9 @@ void KeepoutFilter::process(
 
     // Calculating bounds corresponding to bottom-left overlapping (1) corner
     // filter_mask_ -> master_grid indexes conversion
-    const double half_cell_size = 0.5 * filter_mask_->info.resolution;
-    wx = filter_mask_->info.origin.position.x + half_cell_size;
-    wy = filter_mask_->info.origin.position.y + half_cell_size;
+    const double half_cell_size = 0.5 * mask_info.resolution;
+    wx = mask_info.origin.position.x + half_cell_size;
+    wy = mask_info.origin.position.y + half_cell_size;
     master_grid.worldToMapNoBounds(wx, wy, mg_min_x, mg_min_y);
     // Calculation of (1) corner bounds
     if (mg_min_x >= max_i || mg_min_y >= max_j) {
@@ -229,10 +406,10 @@ void KeepoutFilter::process(
 
     // Calculating bounds corresponding to top-right window (2) corner
     // filter_mask_ -> master_grid intexes conversion
-    wx = filter_mask_->info.origin.position.x +
-      filter_mask_->info.width * filter_mask_->info.resolution + half_cell_size;
-    wy = filter_mask_->info.origin.position.y +
-      filter_mask_->info.height * filter_mask_->info.resolution + half_cell_size;
+    wx = mask_info.origin.position.x +
+      mask_info.width * mask_info.resolution + half_cell_size;
+    wy = mask_info.origin.position.y +
+      mask_info.height * mask_info.resolution + half_cell_size;
     master_grid.worldToMapNoBounds(wx, wy, mg_max_x, mg_max_y);
     // Calculation of (2) corner bounds
     if (mg_max_x <= min_i || mg_max_y <= min_j) {
@@ -249,6 +426,12 @@ void KeepoutFilter::process(
   unsigned const int mg_max_x_u = static_cast<unsigned int>(mg_max_x);
   unsigned const int mg_max_y_u = static_cast<unsigned int>(mg_max_y);
 
+  if (mask_frame == global_frame_) {
+    // Mask rows map to master_grid rows directly, so only the cells under runs are touched
+    applyMaskRuns(master_grid, mg_min_x_u, mg_min_y_u, mg_max_x_u, mg_max_y_u);
+    return;
+  }
+
   unsigned int i, j;  // master_grid iterators
   unsigned int index;  // corresponding index of master_grid
   double gl_wx, gl_wy;  // world coordinates in a global_frame_
@@ -266,20 +449,14 @@ void KeepoutFilter::process(
       // Calculating corresponding to (i, j) point at filter_mask_:
       // Get world coordinates in global_frame_
       master_grid.mapToWorld(i, j, gl_wx, gl_wy);
-      if (mask_frame != global_frame_) {
-        // Transform (i, j) point from global_frame_ to mask_frame
-        tf2::Vector3 point(gl_wx, gl_wy, 0);
-        point = tf2_transform * point;
-        msk_wx = point.x();
-        msk_wy = point.y();
-      } else {
-        // In this case master_grid and filter-mask are in the same frame
-        msk_wx = gl_wx;
-        msk_wy = gl_wy;
-      }
+      // Transform (i, j) point from global_frame_ to mask_frame
+      tf2::Vector3 point(gl_wx, gl_wy, 0);
+      point = tf2_transform * point;
+      msk_wx = point.x();
+      msk_wy = point.y();
       // Get mask coordinates corresponding to (i, j) point at filter_mask_
-      if (worldToMask(filter_mask_, msk_wx, msk_wy, mx, my)) {
-        data = getMaskCost(filter_mask_, mx, my);
+      if (worldToMask(mask_info, msk_wx, msk_wy, mx, my)) {
+        data = filter_mask_ ? getMaskCost(filter_mask_, mx, my) : getMaskRunCost(mx, my);
         // Update if mask_ data is valid and greater than existing master_grid's one
         if (data == NO_INFORMATION) {
           continue;
@@ -298,13 +475,14 @@ void KeepoutFilter::resetFilter()
 
   filter_info_sub_.reset();
   mask_sub_.reset();
+  sparse_mask_sub_.reset();
 }
 
 bool KeepoutFilter::isActive()
 {
   std::lock_guard<CostmapFilter::mutex_t> guard(*getMutex());
 
-  if (filter_mask_) {
+  if (filter_mask_ || sparse_mask_) {
     return true;
   }
   return false;
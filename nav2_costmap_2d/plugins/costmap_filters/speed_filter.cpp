@@ -103,7 +103,7 @@ void SpeedFilter::filterInfoCallback(
     throw std::runtime_error{"Failed to lock node"};
   }
 
-  if (!mask_sub_) {
+  if (!mask_sub_ && !sparse_mask_sub_) {
     RCLCPP_INFO(
       logger_,
       "SpeedFilter: Received filter info from %s topic.", filter_info_topic_.c_str());
@@ -114,6 +114,7 @@ void SpeedFilter::filterInfoCallback(
       filter_info_topic_.c_str());
     // Resetting previous subscriber each time when new costmap filter information arrives
     mask_sub_.reset();
+    sparse_mask_sub_.reset();
   }
 
   // Set base_/multiplier_ or use speed limit in % of maximum speed
@@ -146,13 +147,19 @@ void SpeedFilter::filterInfoCallback(
     logger_,
     "SpeedFilter: Subscribing to \"%s\" topic for filter mask...",
     mask_topic_.c_str());
-  mask_sub_ = node->create_subscription<nav_msgs::msg::OccupancyGrid>(
-    mask_topic_, rclcpp::QoS(rclcpp::KeepLast(1)).transient_local().reliable(),
-    std::bind(&SpeedFilter::maskCallback, this, std::placeholders::_1));
+  if (msg->sparse_mask) {
+    sparse_mask_sub_ = node->create_subscription<nav2_msgs::msg::SparseFilterMask>(
+      mask_topic_, rclcpp::QoS(rclcpp::KeepLast(1)).transient_local().reliable(),
+      std::bind(&SpeedFilter::sparseMaskCallback, this, std::placeholders::_1));
+  } else {
+    mask_sub_ = node->create_subscription<nav_msgs::msg::OccupancyGrid>(
+      mask_topic_, rclcpp::QoS(rclcpp::KeepLast(1)).transient_local().reliable(),
+      std::bind(&SpeedFilter::maskCallback, this, std::placeholders::_1));
+  }
 }
 
 void SpeedFilter::maskCallback(
-  const nav_msgs::msg::OccupancyGrid::SharedPtr msg)
+  const nav_msgs::msg::OccupancyGrid::ConstSharedPtr msg)
 {
   std::lock_guard<CostmapFilter::mutex_t> guard(*getMutex());
 
@@ -169,6 +176,29 @@ void SpeedFilter::maskCallback(
   }
 
   filter_mask_ = msg;
+  sparse_mask_.reset();
+  layered_costmap_->requestUpdate();
+}
+
+void SpeedFilter::sparseMaskCallback(
+  const nav2_msgs::msg::SparseFilterMask::ConstSharedPtr msg)
+{
+  std::lock_guard<CostmapFilter::mutex_t> guard(*getMutex());
+
+  if (!sparse_mask_) {
+    RCLCPP_INFO(
+      logger_,
+      "SpeedFilter: Received sparse filter mask from %s topic.", mask_topic_.c_str());
+  } else {
+    RCLCPP_WARN(
+      logger_,
+      "SpeedFilter: New sparse filter mask arrived from %s topic. Updating old filter mask.",
+      mask_topic_.c_str());
+  }
+
+  sparse_mask_ = msg;
+  filter_mask_.reset();
+  layered_costmap_->requestUpdate();
 }
 
 void SpeedFilter::process(
@@ -178,7 +208,7 @@ void SpeedFilter::process(
 {
   std::lock_guard<CostmapFilter::mutex_t> guard(*getMutex());
 
-  if (!filter_mask_) {
+  if (!filter_mask_ && !sparse_mask_) {
     // Show warning message every 2 seconds to not litter an output
     RCLCPP_WARN_THROTTLE(
       logger_, *(clock_), 2000,
@@ -188,20 +218,27 @@ void SpeedFilter::process(
 
   geometry_msgs::msg::Pose2D mask_pose;  // robot coordinates in mask frame
 
+  const std::string & mask_frame =
+    filter_mask_ ? filter_mask_->header.frame_id : sparse_mask_->header.frame_id;
+  const nav_msgs::msg::MapMetaData & mask_info =
+    filter_mask_ ? filter_mask_->info : sparse_mask_->info;
+
   // Transforming robot pose from current layer frame to mask frame
-  if (!transformPose(global_frame_, pose, filter_mask_->header.frame_id, mask_pose)) {
+  if (!transformPose(global_frame_, pose, mask_frame, mask_pose)) {
     return;
   }
 
   // Converting mask_pose robot position to filter_mask_ indexes (mask_robot_i, mask_robot_j)
   unsigned int mask_robot_i, mask_robot_j;
-  if (!worldToMask(filter_mask_, mask_pose.x, mask_pose.y, mask_robot_i, mask_robot_j)) {
+  if (!worldToMask(mask_info, mask_pose.x, mask_pose.y, mask_robot_i, mask_robot_j)) {
     return;
   }
 
   // Getting filter_mask data from cell where the robot placed and
   // calculating speed limit value
-  int8_t speed_mask_data = getMaskData(filter_mask_, mask_robot_i, mask_robot_j);
+  int8_t speed_mask_data = filter_mask_ ?
+    getMaskData(filter_mask_, mask_robot_i, mask_robot_j) :
+    getMaskData(sparse_mask_, mask_robot_i, mask_robot_j);
   if (speed_mask_data == SPEED_MASK_NO_LIMIT) {
     // Corresponding filter mask cell is free.
     // Setting no speed limit there.
@@ -265,6 +302,7 @@ void SpeedFilter::resetFilter()
 
   filter_info_sub_.reset();
   mask_sub_.reset();
+  sparse_mask_sub_.reset();
   if (speed_limit_pub_) {
     speed_limit_pub_->on_deactivate();
     speed_limit_pub_.reset();
@@ -275,7 +313,7 @@ bool SpeedFilter::isActive()
 {
   std::lock_guard<CostmapFilter::mutex_t> guard(*getMutex());
 
-  if (filter_mask_) {
+  if (filter_mask_ || sparse_mask_) {
     return true;
   }
   return false;
@@ -17,6 +17,7 @@
 #include <string>
 #include <vector>
 #include <algorithm>
+#include <functional>
 #include <memory>
 
 #include "rclcpp/rclcpp.hpp"
@@ -33,6 +34,10 @@ DenoiseLayer::onInitialize()
   declareParameter("minimal_group_size", rclcpp::ParameterValue(2));
   // Pixels connectivity type
   declareParameter("group_connectivity_type", rclcpp::ParameterValue(8));
+  // Threads used to remove groups, 1 for serial processing
+  declareParameter("parallel_threads", rclcpp::ParameterValue(1));
+  // Measure groups beyond the update window to not remove groups crossing its border
+  declareParameter("use_window_margin", rclcpp::ParameterValue(false));
 
   const auto node = node_.lock();
 
@@ -77,6 +82,25 @@ DenoiseLayer::onInitialize()
     }
   }
 
+  const int parallel_threads_param = getInt("parallel_threads");
+
+  if (parallel_threads_param < 1) {
+    RCLCPP_WARN(
+      logger_,
+      "DenoiseLayer::onInitialize(): param parallel_threads: %i."
+      " The value must be at least 1, groups will be removed serially.",
+      parallel_threads_param);
+  }
+  thread_pool_.reset();
+  parallel_bands_ = static_cast<size_t>(std::max(parallel_threads_param, 1));
+  if (parallel_bands_ > 1) {
+    // The updating thread processes a band as well
+    thread_pool_ = std::make_unique<nav2_util::ThreadPool>(
+      static_cast<unsigned int>(parallel_bands_ - 1));
+  }
+
+  node->get_parameter(name_ + "." + "use_window_margin", use_window_margin_);
+
   current_ = true;
 }
 
@@ -111,16 +135,8 @@ DenoiseLayer::updateCosts(
   }
   no_information_is_obstacle_ = master_grid.getDefaultValue() != NO_INFORMATION;
 
-  // wrap roi_image over existing costmap2d buffer
-  unsigned char * master_array = master_grid.getCharMap();
-  const int step = static_cast<int>(master_grid.getSizeInCellsX());
-
-  const size_t width = max_x - min_x;
-  const size_t height = max_y - min_y;
-  Image<uint8_t> roi_image(height, width, master_array + min_y * step + min_x, step);
-
   try {
-    denoise(roi_image);
+    denoiseWindow(master_grid, min_x, min_y, max_x, max_y);
   } catch (std::exception & ex) {
     RCLCPP_ERROR(logger_, "%s", (std::string("Inner error: ") + ex.what()).c_str());
   }
@@ -128,6 +144,51 @@ DenoiseLayer::updateCosts(
   current_ = true;
 }
 
+void
+DenoiseLayer::denoiseWindow(
+  nav2_costmap_2d::Costmap2D & master_grid, int min_x, int min_y, int max_x, int max_y)
+{
+  unsigned char * master_array = master_grid.getCharMap();
+  const int step = static_cast<int>(master_grid.getSizeInCellsX());
+
+  // A group smaller than minimal_group_size_ can't reach further than this from the window
+  const int margin = use_window_margin_ ? static_cast<int>(minimal_group_size_) - 1 : 0;
+  const int ex_min_x = std::max(min_x - margin, 0);
+  const int ex_min_y = std::max(min_y - margin, 0);
+  const int ex_max_x = std::min(max_x + margin, step);
+  const int ex_max_y = std::min(
+    max_y + margin, static_cast<int>(master_grid.getSizeInCellsY()));
+
+  if (ex_min_x == min_x && ex_min_y == min_y && ex_max_x == max_x && ex_max_y == max_y) {
+    // wrap roi_image over existing costmap2d buffer
+    const size_t width = max_x - min_x;
+    const size_t height = max_y - min_y;
+    Image<uint8_t> roi_image(height, width, master_array + min_y * step + min_x, step);
+    denoise(roi_image);
+    return;
+  }
+
+  // Denoise a copy of the grown window, then write back the window only
+  const size_t width = ex_max_x - ex_min_x;
+  const size_t height = ex_max_y - ex_min_y;
+  window_buffer_.resize(width * height);
+  for (size_t row = 0; row < height; ++row) {
+    std::copy_n(
+      master_array + (ex_min_y + row) * step + ex_min_x, width,
+      window_buffer_.data() + row * width);
+  }
+
+  Image<uint8_t> window_image(height, width, window_buffer_.data(), width);
+  denoise(window_image);
+
+  const size_t inner_width = max_x - min_x;
+  for (int y = min_y; y < max_y; ++y) {
+    std::copy_n(
+      window_buffer_.data() + (y - ex_min_y) * width + (min_x - ex_min_x), inner_width,
+      master_array + y * step + min_x);
+  }
+}
+
 void
 DenoiseLayer::denoise(Image<uint8_t> & image) const
 {
@@ -151,9 +212,19 @@ DenoiseLayer::denoise(Image<uint8_t> & image) const
 void
 DenoiseLayer::removeGroups(Image<uint8_t> & image) const
 {
+  auto is_background = [this](uint8_t pixel) {return isBackground(pixel);};
+
+  if (thread_pool_ && image.rows() >= 2 * parallel_bands_) {
+    parallel_groups_remover_.removeGroups(
+      image, group_connectivity_type_, minimal_group_size_, is_background, parallel_bands_,
+      [this](size_t count, const std::function<void(size_t)> & fn) {
+        thread_pool_->parallelFor(0, count, fn);
+      });
+    return;
+  }
+
   groups_remover_.removeGroups(
-    image, buffer_, group_connectivity_type_, minimal_group_size_,
-    [this](uint8_t pixel) {return isBackground(pixel);});
+    image, buffer_, group_connectivity_type_, minimal_group_size_, is_background);
 }
 
 void
@@ -37,6 +37,7 @@
  *********************************************************************/
 #include "nav2_costmap_2d/inflation_layer.hpp"
 
+#include <cmath>
 #include <limits>
 #include <map>
 #include <vector>
@@ -64,6 +65,8 @@ InflationLayer::InflationLayer()
   cost_scaling_factor_(0),
   inflate_unknown_(false),
   inflate_around_unknown_(false),
+  use_distance_transform_(false),
+  incremental_inflation_(false),
   cell_inflation_radius_(0),
   cached_cell_inflation_radius_(0),
   resolution_(0),
@@ -71,7 +74,10 @@ InflationLayer::InflationLayer()
   last_min_x_(std::numeric_limits<double>::lowest()),
   last_min_y_(std::numeric_limits<double>::lowest()),
   last_max_x_(std::numeric_limits<double>::max()),
-  last_max_y_(std::numeric_limits<double>::max())
+  last_max_y_(std::numeric_limits<double>::max()),
+  incremental_cache_valid_(false),
+  cache_origin_x_(0.0),
+  cache_origin_y_(0.0)
 {
   access_ = new mutex_t();
 }
@@ -90,6 +96,8 @@ InflationLayer::onInitialize()
   declareParameter("cost_scaling_factor", rclcpp::ParameterValue(10.0));
   declareParameter("inflate_unknown", rclcpp::ParameterValue(false));
   declareParameter("inflate_around_unknown", rclcpp::ParameterValue(false));
+  declareParameter("use_distance_transform", rclcpp::ParameterValue(false));
+  declareParameter("incremental_inflation", rclcpp::ParameterValue(false));
 
   {
     auto node = node_.lock();
@@ -101,6 +109,8 @@ InflationLayer::onInitialize()
     node->get_parameter(name_ + "." + "cost_scaling_factor", cost_scaling_factor_);
     node->get_parameter(name_ + "." + "inflate_unknown", inflate_unknown_);
     node->get_parameter(name_ + "." + "inflate_around_unknown", inflate_around_unknown_);
+    node->get_parameter(name_ + "." + "use_distance_transform", use_distance_transform_);
+    node->get_parameter(name_ + "." + "incremental_inflation", incremental_inflation_);
 
     dyn_params_handler_ = node->add_on_set_parameters_callback(
       std::bind(
@@ -126,6 +136,7 @@ InflationLayer::matchSize()
   cell_inflation_radius_ = cellDistance(inflation_radius_);
   computeCaches();
   seen_ = std::vector<bool>(costmap->getSizeInCellsX() * costmap->getSizeInCellsY(), false);
+  incremental_cache_valid_ = false;
 }
 
 void
@@ -145,6 +156,7 @@ InflationLayer::updateBounds(
     *max_x = std::numeric_limits<double>::max();
     *max_y = std::numeric_limits<double>::max();
     need_reinflation_ = false;
+    incremental_cache_valid_ = false;
   } else {
     double tmp_min_x = last_min_x_;
     double tmp_min_y = last_min_y_;
@@ -233,6 +245,22 @@ InflationLayer::updateCosts(
   max_i = std::min(static_cast<int>(size_x), max_i);
   max_j = std::min(static_cast<int>(size_y), max_j);
 
+  if (incremental_inflation_) {
+    inflateIncrementally(
+      master_grid, min_i, min_j, max_i, max_j,
+      base_min_i, base_min_j, base_max_i, base_max_j);
+    current_ = true;
+    return;
+  }
+
+  if (use_distance_transform_) {
+    inflateWithDistanceTransform(
+      master_grid, min_i, min_j, max_i, max_j,
+      base_min_i, base_min_j, base_max_i, base_max_j);
+    current_ = true;
+    return;
+  }
+
   // Inflation list; we append cells to visit in a list associated with
   // its distance to the nearest obstacle
   // We use a map<distance, list> to emulate the priority queue used before,
@@ -316,6 +344,184 @@ InflationLayer::updateCosts(
   current_ = true;
 }
 
+void
+InflationLayer::inflateWithDistanceTransform(
+  nav2_costmap_2d::Costmap2D & master_grid,
+  int min_i, int min_j, int max_i, int max_j,
+  int base_min_i, int base_min_j, int base_max_i, int base_max_j)
+{
+  if (max_i <= min_i || max_j <= min_j) {
+    return;
+  }
+
+  unsigned char * master_array = master_grid.getCharMap();
+  const unsigned int window_x = static_cast<unsigned int>(max_i - min_i);
+  const unsigned int window_y = static_cast<unsigned int>(max_j - min_j);
+
+  // Seeds are the same cells the search-based inflation starts from
+  seeds_.resize(static_cast<size_t>(window_x) * window_y);
+  for (unsigned int j = 0; j < window_y; ++j) {
+    const unsigned char * row = master_array + master_grid.getIndex(min_i, min_j + j);
+    uint8_t * seed_row = seeds_.data() + j * window_x;
+    for (unsigned int i = 0; i < window_x; ++i) {
+      seed_row[i] = isSeed(row[i]);
+    }
+  }
+
+  distance_transform_.compute(seeds_.data(), window_x, window_y);
+
+  // Only the requested bounds are written, as with the search-based inflation
+  const uint32_t max_squared_distance =
+    static_cast<uint32_t>(cached_squared_distance_costs_.size() - 1);
+  for (int j = base_min_j; j < base_max_j; ++j) {
+    unsigned char * row = master_array + master_grid.getIndex(0, j);
+    const unsigned int window_row = (j - min_j) * window_x - min_i;
+    for (int i = base_min_i; i < base_max_i; ++i) {
+      const uint32_t squared_distance = distance_transform_.getSquaredDistance(window_row + i);
+      if (squared_distance > max_squared_distance) {
+        continue;
+      }
+
+      applyCost(row[i], cached_squared_distance_costs_[squared_distance]);
+    }
+  }
+}
+
+namespace
+{
+
+/**
+ * @brief Shift a row-major grid so that cell (x, y) takes the value of cell
+ * (x + dx, y + dy), filling cells shifted in from outside of the grid
+ */
+template<typename T>
+void shiftGrid(
+  std::vector<T> & grid, std::vector<T> & scratch,
+  unsigned int size_x, unsigned int size_y, int dx, int dy, T fill)
+{
+  scratch.assign(grid.size(), fill);
+  const int sx = static_cast<int>(size_x);
+  const int sy = static_cast<int>(size_y);
+  const int x0 = std::max(0, -dx);
+  const int xn = std::min(sx, sx - dx);
+  if (x0 < xn) {
+    for (int y = std::max(0, -dy); y < std::min(sy, sy - dy); ++y) {
+      std::copy(
+        grid.begin() + (y + dy) * sx + x0 + dx, grid.begin() + (y + dy) * sx + xn + dx,
+        scratch.begin() + y * sx + x0);
+    }
+  }
+  grid.swap(scratch);
+}
+
+}  // namespace
+
+void
+InflationLayer::inflateIncrementally(
+  nav2_costmap_2d::Costmap2D & master_grid,
+  int min_i, int min_j, int max_i, int max_j,
+  int base_min_i, int base_min_j, int base_max_i, int base_max_j)
+{
+  unsigned char * master_array = master_grid.getCharMap();
+  const unsigned int size_x = master_grid.getSizeInCellsX();
+  const unsigned int size_y = master_grid.getSizeInCellsY();
+  const size_t size = static_cast<size_t>(size_x) * size_y;
+
+  if (!incremental_cache_valid_ || known_seeds_.size() != size) {
+    // The master costmap outside of the window still holds the results of the last
+    // cycle, so the whole costmap can seed the cache
+    known_seeds_.resize(size);
+    inflated_costs_.assign(size, FREE_SPACE);
+    for (size_t index = 0; index < size; ++index) {
+      known_seeds_[index] = isSeed(master_array[index]);
+    }
+    recomputeInflatedCosts(CellRegion{0, 0, size_x, size_y}, size_x, size_y);
+    changed_tiles_.resize(size_x, size_y, std::max(16u, cell_inflation_radius_));
+    cache_origin_x_ = master_grid.getOriginX();
+    cache_origin_y_ = master_grid.getOriginY();
+    incremental_cache_valid_ = true;
+  } else {
+    // Follow rolling costmaps, which move their origin by whole cells
+    const int dx = static_cast<int>(
+      std::lround((master_grid.getOriginX() - cache_origin_x_) / resolution_));
+    const int dy = static_cast<int>(
+      std::lround((master_grid.getOriginY() - cache_origin_y_) / resolution_));
+    if (dx != 0 || dy != 0) {
+      shiftGrid<uint8_t>(known_seeds_, seeds_scratch_, size_x, size_y, dx, dy, 0);
+      shiftGrid<unsigned char>(
+        inflated_costs_, costs_scratch_, size_x, size_y, dx, dy, FREE_SPACE);
+      cache_origin_x_ = master_grid.getOriginX();
+      cache_origin_y_ = master_grid.getOriginY();
+    }
+
+    // Find the seeds which changed since the last cycle
+    changed_tiles_.clear();
+    bool changed = false;
+    for (int j = min_j; j < max_j; ++j) {
+      const unsigned int row = master_grid.getIndex(0, j);
+      for (int i = min_i; i < max_i; ++i) {
+        const uint8_t seed = isSeed(master_array[row + i]);
+        if (seed != known_seeds_[row + i]) {
+          known_seeds_[row + i] = seed;
+          changed_tiles_.markCells(i, j, i + 1, j + 1);
+          changed = true;
+        }
+      }
+    }
+
+    // Only cells within the inflation radius of a changed seed can change cost
+    if (changed) {
+      changed_tiles_.dilate(cell_inflation_radius_);
+      changed_tiles_.getRegions(changed_regions_);
+      for (const CellRegion & region : changed_regions_) {
+        recomputeInflatedCosts(region, size_x, size_y);
+      }
+    }
+  }
+
+  for (int j = base_min_j; j < base_max_j; ++j) {
+    const unsigned int row = master_grid.getIndex(0, j);
+    for (int i = base_min_i; i < base_max_i; ++i) {
+      applyCost(master_array[row + i], inflated_costs_[row + i]);
+    }
+  }
+}
+
+void
+InflationLayer::recomputeInflatedCosts(
+  const CellRegion & region, unsigned int size_x, unsigned int size_y)
+{
+  // Seeds up to the inflation radius outside of the region affect costs inside of it
+  const unsigned int r = cell_inflation_radius_;
+  const unsigned int x0 = region.x0 > r ? region.x0 - r : 0;
+  const unsigned int y0 = region.y0 > r ? region.y0 - r : 0;
+  const unsigned int xn = std::min(size_x, region.xn + r);
+  const unsigned int yn = std::min(size_y, region.yn + r);
+  const unsigned int window_x = xn - x0;
+  const unsigned int window_y = yn - y0;
+
+  seeds_.resize(static_cast<size_t>(window_x) * window_y);
+  for (unsigned int j = 0; j < window_y; ++j) {
+    std::copy(
+      known_seeds_.begin() + (y0 + j) * size_x + x0,
+      known_seeds_.begin() + (y0 + j) * size_x + xn,
+      seeds_.begin() + j * window_x);
+  }
+
+  distance_transform_.compute(seeds_.data(), window_x, window_y);
+
+  const uint32_t max_squared_distance =
+    static_cast<uint32_t>(cached_squared_distance_costs_.size() - 1);
+  for (unsigned int j = region.y0; j < region.yn; ++j) {
+    for (unsigned int i = region.x0; i < region.xn; ++i) {
+      const uint32_t squared_distance =
+        distance_transform_.getSquaredDistance((j - y0) * window_x + (i - x0));
+      inflated_costs_[j * size_x + i] = squared_distance > max_squared_distance ?
+        FREE_SPACE : cached_squared_distance_costs_[squared_distance];
+    }
+  }
+}
+
 /**
  * @brief  Given an index of a cell in the costmap, place it into a list pending for obstacle inflation
  * @param  grid The costmap
@@ -379,6 +585,14 @@ InflationLayer::computeCaches()
     }
   }
 
+  const unsigned int max_squared_distance = cell_inflation_radius_ * cell_inflation_radius_;
+  cached_squared_distance_costs_.resize(max_squared_distance + 1);
+  for (unsigned int d = 0; d <= max_squared_distance; ++d) {
+    cached_squared_distance_costs_[d] = computeCost(std::sqrt(static_cast<double>(d)));
+  }
+
+  incremental_cache_valid_ = false;
+
   int max_dist = generateIntegerDistances();
   inflation_cells_.clear();
   inflation_cells_.resize(max_dist + 1);
@@ -470,6 +684,16 @@ InflationLayer::dynamicParametersCallback(
       {
         inflate_around_unknown_ = parameter.as_bool();
         need_reinflation_ = true;
+      } else if (param_name == name_ + "." + "use_distance_transform" && // NOLINT
+        use_distance_transform_ != parameter.as_bool())
+      {
+        use_distance_transform_ = parameter.as_bool();
+        need_reinflation_ = true;
+      } else if (param_name == name_ + "." + "incremental_inflation" && // NOLINT
+        incremental_inflation_ != parameter.as_bool())
+      {
+        incremental_inflation_ = parameter.as_bool();
+        need_reinflation_ = true;
       }
     }
   }
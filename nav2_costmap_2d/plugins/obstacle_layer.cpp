@@ -39,6 +39,7 @@
 #include "nav2_costmap_2d/obstacle_layer.hpp"
 
 #include <algorithm>
+#include <cmath>
 #include <memory>
 #include <string>
 #include <vector>
@@ -62,6 +63,12 @@ namespace nav2_costmap_2d
 
 ObstacleLayer::~ObstacleLayer()
 {
+  // Shared sources outlive the layer, stop them calling it first
+  for (size_t i = 0; i < shared_sources_.size(); ++i) {
+    shared_sources_[i]->removeListener(shared_listeners_[i]);
+  }
+  // Stop the source threads before the buffers and filters they feed go away
+  source_threads_.clear();
   dyn_params_handler_.reset();
   for (auto & notifier : observation_notifiers_) {
     notifier.reset();
@@ -81,17 +88,29 @@ void ObstacleLayer::onInitialize()
   declareParameter("min_obstacle_height", rclcpp::ParameterValue(0.0));
   declareParameter("max_obstacle_height", rclcpp::ParameterValue(2.0));
   declareParameter("combination_method", rclcpp::ParameterValue(1));
+  declareParameter("raytrace_angular_bin_size", rclcpp::ParameterValue(0.0));
+  declareParameter("dedicated_source_threads", rclcpp::ParameterValue(false));
+  declareParameter("share_observation_sources", rclcpp::ParameterValue(false));
+  declareParameter("sparse_storage", rclcpp::ParameterValue(false));
   declareParameter("observation_sources", rclcpp::ParameterValue(std::string("")));
 
   auto node = node_.lock();
   if (!node) {
     throw std::runtime_error{"Failed to lock node"};
   }
+  persistence_epoch_ = clock_->now();
 
   node->get_parameter(name_ + "." + "enabled", enabled_);
   node->get_parameter(name_ + "." + "footprint_clearing_enabled", footprint_clearing_enabled_);
   node->get_parameter(name_ + "." + "min_obstacle_height", min_obstacle_height_);
   node->get_parameter(name_ + "." + "max_obstacle_height", max_obstacle_height_);
+  node->get_parameter(name_ + "." + "raytrace_angular_bin_size", raytrace_angular_bin_size_);
+  bool dedicated_source_threads = false;
+  node->get_parameter(name_ + "." + "dedicated_source_threads", dedicated_source_threads);
+  bool share_observation_sources = false;
+  node->get_parameter(name_ + "." + "share_observation_sources", share_observation_sources);
+  bool sparse_storage = false;
+  node->get_parameter(name_ + "." + "sparse_storage", sparse_storage);
   node->get_parameter("track_unknown_space", track_unknown_space);
   node->get_parameter("transform_tolerance", transform_tolerance);
   node->get_parameter(name_ + "." + "observation_sources", topics_string);
@@ -118,6 +137,8 @@ void ObstacleLayer::onInitialize()
     default_value_ = FREE_SPACE;
   }
 
+  // Obstacles mark little of a large global costmap, so only store the pages marked
+  setSparseStorage(sparse_storage);
   ObstacleLayer::matchSize();
   current_ = true;
   was_reset_ = false;
@@ -135,7 +156,7 @@ void ObstacleLayer::onInitialize()
     // get the parameters for the specific topic
     double observation_keep_time, expected_update_rate, min_obstacle_height, max_obstacle_height;
     std::string topic, sensor_frame, data_type;
-    bool inf_is_valid, clearing, marking;
+    bool inf_is_valid, clearing, marking, voxel_filter;
 
     declareParameter(source + "." + "topic", rclcpp::ParameterValue(source));
     declareParameter(source + "." + "sensor_frame", rclcpp::ParameterValue(std::string("")));
@@ -147,6 +168,7 @@ void ObstacleLayer::onInitialize()
     declareParameter(source + "." + "inf_is_valid", rclcpp::ParameterValue(false));
     declareParameter(source + "." + "marking", rclcpp::ParameterValue(true));
     declareParameter(source + "." + "clearing", rclcpp::ParameterValue(false));
+    declareParameter(source + "." + "voxel_filter", rclcpp::ParameterValue(false));
     declareParameter(source + "." + "obstacle_max_range", rclcpp::ParameterValue(2.5));
     declareParameter(source + "." + "obstacle_min_range", rclcpp::ParameterValue(0.0));
     declareParameter(source + "." + "raytrace_max_range", rclcpp::ParameterValue(3.0));
@@ -166,6 +188,7 @@ void ObstacleLayer::onInitialize()
     node->get_parameter(name_ + "." + source + "." + "inf_is_valid", inf_is_valid);
     node->get_parameter(name_ + "." + source + "." + "marking", marking);
     node->get_parameter(name_ + "." + source + "." + "clearing", clearing);
+    node->get_parameter(name_ + "." + source + "." + "voxel_filter", voxel_filter);
 
     if (!(data_type == "PointCloud2" || data_type == "LaserScan")) {
       RCLCPP_FATAL(
@@ -192,17 +215,50 @@ void ObstacleLayer::onInitialize()
       source.c_str(), topic.c_str(),
       sensor_frame.c_str());
 
-    // create an observation buffer
-    observation_buffers_.push_back(
-      std::shared_ptr<ObservationBuffer
-      >(
-        new ObservationBuffer(
-          node, topic, observation_keep_time, expected_update_rate,
-          min_obstacle_height,
-          max_obstacle_height, obstacle_max_range, obstacle_min_range, raytrace_max_range,
-          raytrace_min_range, *tf_,
-          global_frame_,
-          sensor_frame, tf2::durationFromSec(transform_tolerance))));
+    std::shared_ptr<SharedObservationSource> shared_source;
+    if (share_observation_sources) {
+      // take the buffer of the layers of the process with the same configuration,
+      // fed by the subscription of the process to the topic
+      ObservationSourceConfig config;
+      config.topic = topic;
+      config.data_type = data_type;
+      config.global_frame = global_frame_;
+      config.sensor_frame = sensor_frame;
+      config.observation_keep_time = observation_keep_time;
+      config.expected_update_rate = expected_update_rate;
+      config.min_obstacle_height = min_obstacle_height;
+      config.max_obstacle_height = max_obstacle_height;
+      config.obstacle_max_range = obstacle_max_range;
+      config.obstacle_min_range = obstacle_min_range;
+      config.raytrace_max_range = raytrace_max_range;
+      config.raytrace_min_range = raytrace_min_range;
+      config.transform_tolerance = transform_tolerance;
+      config.inf_is_valid = inf_is_valid && data_type == "LaserScan";
+      if (voxel_filter) {
+        config.voxel_resolution = resolution_;
+        config.voxel_origin_x = origin_x_;
+        config.voxel_origin_y = origin_y_;
+      }
+      shared_source = SharedObservationSource::get(config, node);
+      observation_buffers_.push_back(shared_source->getBuffer());
+    } else {
+      // create an observation buffer
+      observation_buffers_.push_back(
+        std::shared_ptr<ObservationBuffer
+        >(
+          new ObservationBuffer(
+            node, topic, observation_keep_time, expected_update_rate,
+            min_obstacle_height,
+            max_obstacle_height, obstacle_max_range, obstacle_min_range, raytrace_max_range,
+            raytrace_min_range, *tf_,
+            global_frame_,
+            sensor_frame, tf2::durationFromSec(transform_tolerance))));
+
+      // downsample dense clouds to one point per costmap cell and height band
+      if (voxel_filter) {
+        observation_buffers_.back()->setVoxelFilter(resolution_, resolution_, origin_x_, origin_y_);
+      }
+    }
 
     // check if we'll add this buffer to our marking observation buffers
     if (marking) {
@@ -221,13 +277,37 @@ void ObstacleLayer::onInitialize()
       source.c_str(), topic.c_str(),
       global_frame_.c_str(), expected_update_rate, observation_keep_time);
 
+    if (shared_source) {
+      shared_listeners_.push_back(
+        shared_source->addListener([this]() {layered_costmap_->requestUpdate();}));
+      shared_sources_.push_back(shared_source);
+      continue;
+    }
+
     rmw_qos_profile_t custom_qos_profile = rmw_qos_profile_sensor_data;
     custom_qos_profile.depth = 50;
 
+    // Optionally give the source its own callback group and executor thread, so
+    // projection and transforms of several sensors run side by side and off the
+    // costmap executor
+    auto source_sub_opt = sub_opt;
+    rclcpp::executors::SingleThreadedExecutor::SharedPtr source_executor;
+    if (dedicated_source_threads) {
+      source_sub_opt.callback_group = node->create_callback_group(
+        rclcpp::CallbackGroupType::MutuallyExclusive, false);
+      source_executor = std::make_shared<rclcpp::executors::SingleThreadedExecutor>();
+      source_executor->add_callback_group(
+        source_sub_opt.callback_group, node->get_node_base_interface());
+    }
+    // Each source projects with its own projector, which caches per scan geometry
+    // and must not be shared between threads
+    auto projector = std::make_shared<laser_geometry::LaserProjection>();
+    auto buffer = observation_buffers_.back();
+
     // create a callback for the topic
     if (data_type == "LaserScan") {
       auto sub = std::make_shared<message_filters::Subscriber<sensor_msgs::msg::LaserScan,
-          rclcpp_lifecycle::LifecycleNode>>(node, topic, custom_qos_profile, sub_opt);
+          rclcpp_lifecycle::LifecycleNode>>(node, topic, custom_qos_profile, source_sub_opt);
       sub->unsubscribe();
 
       auto filter = std::make_shared<tf2_ros::MessageFilter<sensor_msgs::msg::LaserScan>>(
@@ -238,15 +318,17 @@ void ObstacleLayer::onInitialize()
 
       if (inf_is_valid) {
         filter->registerCallback(
-          std::bind(
-            &ObstacleLayer::laserScanValidInfCallback, this, std::placeholders::_1,
-            observation_buffers_.back()));
+          [this, buffer, projector](sensor_msgs::msg::LaserScan::ConstSharedPtr message) {
+            sensor_msgs::msg::LaserScan filtered_message = *message;
+            replaceInfRanges(filtered_message);
+            bufferLaserScan(filtered_message, buffer, *projector);
+          });
 
       } else {
         filter->registerCallback(
-          std::bind(
-            &ObstacleLayer::laserScanCallback, this, std::placeholders::_1,
-            observation_buffers_.back()));
+          [this, buffer, projector](sensor_msgs::msg::LaserScan::ConstSharedPtr message) {
+            bufferLaserScan(*message, buffer, *projector);
+          });
       }
 
       observation_subscribers_.push_back(sub);
@@ -256,7 +338,7 @@ void ObstacleLayer::onInitialize()
 
     } else {
       auto sub = std::make_shared<message_filters::Subscriber<sensor_msgs::msg::PointCloud2,
-          rclcpp_lifecycle::LifecycleNode>>(node, topic, custom_qos_profile, sub_opt);
+          rclcpp_lifecycle::LifecycleNode>>(node, topic, custom_qos_profile, source_sub_opt);
       sub->unsubscribe();
 
       if (inf_is_valid) {
@@ -286,6 +368,10 @@ void ObstacleLayer::onInitialize()
       target_frames.push_back(sensor_frame);
       observation_notifiers_.back()->setTargetFrames(target_frames);
     }
+
+    if (source_executor) {
+      source_threads_.push_back(std::make_unique<nav2_util::NodeThread>(source_executor));
+    }
   }
 }
 
@@ -305,6 +391,8 @@ ObstacleLayer::dynamicParametersCallback(
         min_obstacle_height_ = parameter.as_double();
       } else if (param_name == name_ + "." + "max_obstacle_height") {
         max_obstacle_height_ = parameter.as_double();
+      } else if (param_name == name_ + "." + "raytrace_angular_bin_size") {
+        raytrace_angular_bin_size_ = parameter.as_double();
       }
     } else if (param_type == ParameterType::PARAMETER_BOOL) {
       if (param_name == name_ + "." + "enabled") {
@@ -328,63 +416,51 @@ ObstacleLayer::laserScanCallback(
   sensor_msgs::msg::LaserScan::ConstSharedPtr message,
   const std::shared_ptr<nav2_costmap_2d::ObservationBuffer> & buffer)
 {
-  // project the laser into a point cloud
-  sensor_msgs::msg::PointCloud2 cloud;
-  cloud.header = message->header;
-
-  // project the scan into a point cloud
-  try {
-    projector_.transformLaserScanToPointCloud(message->header.frame_id, *message, cloud, *tf_);
-  } catch (tf2::TransformException & ex) {
-    RCLCPP_WARN(
-      logger_,
-      "High fidelity enabled, but TF returned a transform exception to frame %s: %s",
-      global_frame_.c_str(),
-      ex.what());
-    projector_.projectLaser(*message, cloud);
-  } catch (std::runtime_error & ex) {
-    RCLCPP_WARN(
-      logger_,
-      "transformLaserScanToPointCloud error, it seems the message from laser is malformed."
-      " Ignore this message. what(): %s",
-      ex.what());
-    return;
-  }
-
-  // buffer the point cloud
-  buffer->lock();
-  buffer->bufferCloud(cloud);
-  buffer->unlock();
+  bufferLaserScan(*message, buffer, projector_);
 }
 
 void
 ObstacleLayer::laserScanValidInfCallback(
   sensor_msgs::msg::LaserScan::ConstSharedPtr raw_message,
   const std::shared_ptr<nav2_costmap_2d::ObservationBuffer> & buffer)
+{
+  sensor_msgs::msg::LaserScan message = *raw_message;
+  replaceInfRanges(message);
+  bufferLaserScan(message, buffer, projector_);
+}
+
+void
+ObstacleLayer::replaceInfRanges(sensor_msgs::msg::LaserScan & message)
 {
   // Filter positive infinities ("Inf"s) to max_range.
   float epsilon = 0.0001;  // a tenth of a millimeter
-  sensor_msgs::msg::LaserScan message = *raw_message;
   for (size_t i = 0; i < message.ranges.size(); i++) {
     float range = message.ranges[i];
     if (!std::isfinite(range) && range > 0) {
       message.ranges[i] = message.range_max - epsilon;
     }
   }
+}
 
+void
+ObstacleLayer::bufferLaserScan(
+  const sensor_msgs::msg::LaserScan & message,
+  const std::shared_ptr<nav2_costmap_2d::ObservationBuffer> & buffer,
+  laser_geometry::LaserProjection & projector)
+{
   // project the laser into a point cloud
   sensor_msgs::msg::PointCloud2 cloud;
   cloud.header = message.header;
 
   // project the scan into a point cloud
   try {
-    projector_.transformLaserScanToPointCloud(message.header.frame_id, message, cloud, *tf_);
+    projector.transformLaserScanToPointCloud(message.header.frame_id, message, cloud, *tf_);
   } catch (tf2::TransformException & ex) {
     RCLCPP_WARN(
       logger_,
       "High fidelity enabled, but TF returned a transform exception to frame %s: %s",
       global_frame_.c_str(), ex.what());
-    projector_.projectLaser(message, cloud);
+    projector.projectLaser(message, cloud);
   } catch (std::runtime_error & ex) {
     RCLCPP_WARN(
       logger_,
@@ -394,10 +470,9 @@ ObstacleLayer::laserScanValidInfCallback(
     return;
   }
 
-  // buffer the point cloud
-  buffer->lock();
+  // buffer the point cloud, the buffer only locks to hand the observation over
   buffer->bufferCloud(cloud);
-  buffer->unlock();
+  layered_costmap_->requestUpdate();
 }
 
 void
@@ -405,10 +480,9 @@ ObstacleLayer::pointCloud2Callback(
   sensor_msgs::msg::PointCloud2::ConstSharedPtr message,
   const std::shared_ptr<ObservationBuffer> & buffer)
 {
-  // buffer the point cloud
-  buffer->lock();
+  // buffer the point cloud, the buffer only locks to hand the observation over
   buffer->bufferCloud(*message);
-  buffer->unlock();
+  layered_costmap_->requestUpdate();
 }
 
 void
@@ -425,85 +499,162 @@ ObstacleLayer::updateBounds(
   }
   useExtraBounds(min_x, min_y, max_x, max_y);
 
+  // Marks persist in the layer rather than by re-marking the buffered observations every
+  // cycle: every observation is applied once, and its marks are kept from clearing by
+  // their per cell expiry time, compared when a ray crosses them
+  bool persistent = false;
+  for (const auto & buffer : marking_buffers_) {
+    persistent = persistent || buffer->getObservationKeepTime() > rclcpp::Duration(0, 0);
+  }
+  const size_t size = static_cast<size_t>(size_x_) * size_y_;
+  if (!persistent) {
+    mark_expiry_.clear();
+  } else if (mark_expiry_.size() != size) {
+    mark_expiry_.assign(size, 0.0f);
+  }
+  marking_sequences_.resize(marking_buffers_.size(), 0);
+  clearing_sequences_.resize(clearing_buffers_.size(), 0);
+
   bool current = true;
-  std::vector<Observation> observations, clearing_observations;
 
-  // get the marking observations
-  current = current && getMarkingObservations(observations);
+  // raytrace freespace with the new clearing observations
+  for (unsigned int i = 0; i < clearing_buffers_.size(); ++i) {
+    clearing_buffers_[i]->lock();
+    clearing_buffers_[i]->visitNewObservations(
+      clearing_sequences_[i], [&](const Observation & obs) {
+        raytraceFreespace(obs, min_x, min_y, max_x, max_y);
+      });
+    current = clearing_buffers_[i]->isCurrent() && current;
+    clearing_buffers_[i]->unlock();
+  }
+  for (const Observation & obs : static_clearing_observations_) {
+    raytraceFreespace(obs, min_x, min_y, max_x, max_y);
+  }
 
-  // get the clearing observations
-  current = current && getClearingObservations(clearing_observations);
+  // then mark the obstacles of the new marking observations
+  for (unsigned int i = 0; i < marking_buffers_.size(); ++i) {
+    marking_buffers_[i]->lock();
+    const rclcpp::Duration & keep_time = marking_buffers_[i]->getObservationKeepTime();
+    marking_buffers_[i]->visitNewObservations(
+      marking_sequences_[i], [&](const Observation & obs) {
+        markObservation(obs, markExpiry(obs, keep_time), min_x, min_y, max_x, max_y);
+      });
+    current = marking_buffers_[i]->isCurrent() && current;
+    marking_buffers_[i]->unlock();
+  }
+  for (const Observation & obs : static_marking_observations_) {
+    markObservation(obs, 0.0f, min_x, min_y, max_x, max_y);
+  }
 
   // update the global current status
   current_ = current;
 
-  // raytrace freespace
-  for (unsigned int i = 0; i < clearing_observations.size(); ++i) {
-    raytraceFreespace(clearing_observations[i], min_x, min_y, max_x, max_y);
-  }
-
-  // place the new obstacles into a priority queue... each with a priority of zero to begin with
-  for (std::vector<Observation>::const_iterator it = observations.begin();
-    it != observations.end(); ++it)
-  {
-    const Observation & obs = *it;
+  updateFootprint(robot_x, robot_y, robot_yaw, min_x, min_y, max_x, max_y);
+}
 
-    const sensor_msgs::msg::PointCloud2 & cloud = *(obs.cloud_);
+void
+ObstacleLayer::markObservation(
+  const Observation & obs, float expiry,
+  double * min_x, double * min_y, double * max_x, double * max_y)
+{
+  const sensor_msgs::msg::PointCloud2 & cloud = *(obs.cloud_);
 
-    double sq_obstacle_max_range = obs.obstacle_max_range_ * obs.obstacle_max_range_;
-    double sq_obstacle_min_range = obs.obstacle_min_range_ * obs.obstacle_min_range_;
+  double sq_obstacle_max_range = obs.obstacle_max_range_ * obs.obstacle_max_range_;
+  double sq_obstacle_min_range = obs.obstacle_min_range_ * obs.obstacle_min_range_;
 
-    sensor_msgs::PointCloud2ConstIterator<float> iter_x(cloud, "x");
-    sensor_msgs::PointCloud2ConstIterator<float> iter_y(cloud, "y");
-    sensor_msgs::PointCloud2ConstIterator<float> iter_z(cloud, "z");
+  sensor_msgs::PointCloud2ConstIterator<float> iter_x(cloud, "x");
+  sensor_msgs::PointCloud2ConstIterator<float> iter_y(cloud, "y");
+  sensor_msgs::PointCloud2ConstIterator<float> iter_z(cloud, "z");
 
-    for (; iter_x != iter_x.end(); ++iter_x, ++iter_y, ++iter_z) {
-      double px = *iter_x, py = *iter_y, pz = *iter_z;
+  for (; iter_x != iter_x.end(); ++iter_x, ++iter_y, ++iter_z) {
+    double px = *iter_x, py = *iter_y, pz = *iter_z;
 
-      // if the obstacle is too low, we won't add it
-      if (pz < min_obstacle_height_) {
-        RCLCPP_DEBUG(logger_, "The point is too low");
-        continue;
-      }
+    // if the obstacle is too low, we won't add it
+    if (pz < min_obstacle_height_) {
+      RCLCPP_DEBUG(logger_, "The point is too low");
+      continue;
+    }
 
-      // if the obstacle is too high or too far away from the robot we won't add it
-      if (pz > max_obstacle_height_) {
-        RCLCPP_DEBUG(logger_, "The point is too high");
-        continue;
-      }
+    // if the obstacle is too high or too far away from the robot we won't add it
+    if (pz > max_obstacle_height_) {
+      RCLCPP_DEBUG(logger_, "The point is too high");
+      continue;
+    }
 
-      // compute the squared distance from the hitpoint to the pointcloud's origin
-      double sq_dist =
-        (px -
-        obs.origin_.x) * (px - obs.origin_.x) + (py - obs.origin_.y) * (py - obs.origin_.y) +
-        (pz - obs.origin_.z) * (pz - obs.origin_.z);
+    // compute the squared distance from the hitpoint to the pointcloud's origin
+    double sq_dist =
+      (px -
+      obs.origin_.x) * (px - obs.origin_.x) + (py - obs.origin_.y) * (py - obs.origin_.y) +
+      (pz - obs.origin_.z) * (pz - obs.origin_.z);
 
-      // if the point is far enough away... we won't consider it
-      if (sq_dist >= sq_obstacle_max_range) {
-        RCLCPP_DEBUG(logger_, "The point is too far away");
-        continue;
-      }
+    // if the point is far enough away... we won't consider it
+    if (sq_dist >= sq_obstacle_max_range) {
+      RCLCPP_DEBUG(logger_, "The point is too far away");
+      continue;
+    }
 
-      // if the point is too close, do not conisder it
-      if (sq_dist < sq_obstacle_min_range) {
-        RCLCPP_DEBUG(logger_, "The point is too close");
-        continue;
-      }
+    // if the point is too close, do not conisder it
+    if (sq_dist < sq_obstacle_min_range) {
+      RCLCPP_DEBUG(logger_, "The point is too close");
+      continue;
+    }
 
-      // now we need to compute the map coordinates for the observation
-      unsigned int mx, my;
-      if (!worldToMap(px, py, mx, my)) {
-        RCLCPP_DEBUG(logger_, "Computing map coords failed");
-        continue;
-      }
+    // now we need to compute the map coordinates for the observation
+    unsigned int mx, my;
+    if (!worldToMap(px, py, mx, my)) {
+      RCLCPP_DEBUG(logger_, "Computing map coords failed");
+      continue;
+    }
 
-      unsigned int index = getIndex(mx, my);
-      costmap_[index] = LETHAL_OBSTACLE;
-      touch(px, py, min_x, min_y, max_x, max_y);
+    unsigned int index = getIndex(mx, my);
+    costmap_[index] = LETHAL_OBSTACLE;
+    if (!mark_expiry_.empty()) {
+      mark_expiry_[index] = std::max(mark_expiry_[index], expiry);
     }
+    touch(px, py, min_x, min_y, max_x, max_y);
   }
+}
 
-  updateFootprint(robot_x, robot_y, robot_yaw, min_x, min_y, max_x, max_y);
+float
+ObstacleLayer::markExpiry(const Observation & obs, const rclcpp::Duration & keep_time) const
+{
+  return static_cast<float>(
+    (rclcpp::Time(obs.cloud_->header.stamp) - persistence_epoch_ + keep_time).seconds());
+}
+
+void
+ObstacleLayer::updateOrigin(double new_origin_x, double new_origin_y)
+{
+  // same cell shift as Costmap2D::updateOrigin, to move the expiry times along
+  const int cell_ox = static_cast<int>((new_origin_x - origin_x_) / resolution_);
+  const int cell_oy = static_cast<int>((new_origin_y - origin_y_) / resolution_);
+  Costmap2D::updateOrigin(new_origin_x, new_origin_y);
+  if (mark_expiry_.size() == static_cast<size_t>(size_x_) * size_y_) {
+    shiftMapRegion(mark_expiry_.data(), cell_ox, cell_oy, 0.0f);
+  }
+  if (cell_ox != 0 || cell_oy != 0) {
+    updateVoxelFilters();
+  }
+}
+
+void
+ObstacleLayer::matchSize()
+{
+  std::lock_guard<Costmap2D::mutex_t> guard(*getMutex());
+  CostmapLayer::matchSize();
+  updateVoxelFilters();
+}
+
+void
+ObstacleLayer::updateVoxelFilters()
+{
+  for (auto & buffer : observation_buffers_) {
+    if (buffer->isVoxelFilterEnabled()) {
+      buffer->lock();
+      buffer->setVoxelFilter(resolution_, resolution_, origin_x_, origin_y_);
+      buffer->unlock();
+    }
+  }
 }
 
 void
@@ -647,6 +798,21 @@ ObstacleLayer::raytraceFreespace(
 
   touch(ox, oy, min_x, min_y, max_x, max_y);
 
+  const unsigned int cell_raytrace_max_range =
+    cellDistance(clearing_observation.raytrace_max_range_);
+  const unsigned int cell_raytrace_min_range =
+    cellDistance(clearing_observation.raytrace_min_range_);
+
+  // Dense clouds hit the same cells many times over. Collect the endpoint cells
+  // first, so every distinct line is traced once in a tight loop afterwards.
+  const bool use_angular_bins = raytrace_angular_bin_size_ > 0.0;
+  if (use_angular_bins) {
+    const size_t num_bins =
+      static_cast<size_t>(std::ceil(2.0 * M_PI / raytrace_angular_bin_size_));
+    raytrace_bins_.assign(num_bins, RaytraceBin());
+  }
+  raytrace_endpoints_.clear();
+
   // for each point in the cloud, we want to trace a line from the origin
   // and clear obstacles along it
   sensor_msgs::PointCloud2ConstIterator<float> iter_x(cloud, "x");
@@ -693,17 +859,63 @@ ObstacleLayer::raytraceFreespace(
       continue;
     }
 
-    unsigned int cell_raytrace_max_range = cellDistance(clearing_observation.raytrace_max_range_);
-    unsigned int cell_raytrace_min_range = cellDistance(clearing_observation.raytrace_min_range_);
-    MarkCell marker(costmap_, FREE_SPACE);
-    // and finally... we can execute our trace to clear obstacles along that line
-    raytraceLine(marker, x0, y0, x1, y1, cell_raytrace_max_range, cell_raytrace_min_range);
+    const unsigned int index = getIndex(x1, y1);
+    if (use_angular_bins) {
+      // Only the farthest endpoint of each bin is traced, nearer ones lie on it
+      const int dx = static_cast<int>(x1) - static_cast<int>(x0);
+      const int dy = static_cast<int>(y1) - static_cast<int>(y0);
+      const unsigned int squared_length = dx * dx + dy * dy;
+      size_t bin = static_cast<size_t>((std::atan2(b, a) + M_PI) / raytrace_angular_bin_size_);
+      bin = std::min(bin, raytrace_bins_.size() - 1);
+      RaytraceBin & raytrace_bin = raytrace_bins_[bin];
+      if (!raytrace_bin.valid || squared_length > raytrace_bin.squared_length) {
+        raytrace_bin.valid = true;
+        raytrace_bin.squared_length = squared_length;
+        raytrace_bin.index = index;
+      }
+    } else {
+      raytrace_endpoints_.push_back(index);
+    }
 
     updateRaytraceBounds(
       ox, oy, wx, wy, clearing_observation.raytrace_max_range_,
       clearing_observation.raytrace_min_range_, min_x, min_y, max_x,
       max_y);
   }
+
+  if (use_angular_bins) {
+    for (const RaytraceBin & raytrace_bin : raytrace_bins_) {
+      if (raytrace_bin.valid) {
+        raytrace_endpoints_.push_back(raytrace_bin.index);
+      }
+    }
+  } else {
+    // Sorting also makes consecutive traces touch neighbouring memory
+    std::sort(raytrace_endpoints_.begin(), raytrace_endpoints_.end());
+    raytrace_endpoints_.erase(
+      std::unique(raytrace_endpoints_.begin(), raytrace_endpoints_.end()),
+      raytrace_endpoints_.end());
+  }
+
+  // and finally... we can execute our traces to clear obstacles along those lines,
+  // sparing the persisting marks that have not expired yet
+  if (mark_expiry_.size() == static_cast<size_t>(size_x_) * size_y_) {
+    const float now = static_cast<float>((clock_->now() - persistence_epoch_).seconds());
+    ClearUnexpiredCell clearer(costmap_, mark_expiry_.data(), now);
+    for (const unsigned int index : raytrace_endpoints_) {
+      unsigned int x1, y1;
+      indexToCells(index, x1, y1);
+      raytraceLine(clearer, x0, y0, x1, y1, cell_raytrace_max_range, cell_raytrace_min_range);
+    }
+    return;
+  }
+
+  MarkCell marker(costmap_, FREE_SPACE);
+  for (const unsigned int index : raytrace_endpoints_) {
+    unsigned int x1, y1;
+    indexToCells(index, x1, y1);
+    raytraceLine(marker, x0, y0, x1, y1, cell_raytrace_max_range, cell_raytrace_min_range);
+  }
 }
 
 void
@@ -719,6 +931,9 @@ ObstacleLayer::activate()
       observation_subscribers_[i]->subscribe();
     }
   }
+  for (auto & source : shared_sources_) {
+    source->activate();
+  }
   resetBuffersLastUpdated();
 }
 
@@ -730,6 +945,9 @@ ObstacleLayer::deactivate()
       observation_subscribers_[i]->unsubscribe();
     }
   }
+  for (auto & source : shared_sources_) {
+    source->deactivate();
+  }
 }
 
 void
@@ -752,6 +970,10 @@ ObstacleLayer::reset()
 {
   resetMaps();
   resetBuffersLastUpdated();
+  // the observations still buffered are applied again, with their remaining persistence
+  std::fill(mark_expiry_.begin(), mark_expiry_.end(), 0.0f);
+  std::fill(marking_sequences_.begin(), marking_sequences_.end(), 0);
+  std::fill(clearing_sequences_.begin(), clearing_sequences_.end(), 0);
   current_ = false;
   was_reset_ = true;
 }
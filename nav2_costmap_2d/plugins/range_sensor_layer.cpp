@@ -77,6 +77,7 @@ void RangeSensorLayer::onInitialize()
   node->get_parameter(name_ + "." + "enabled", enabled_);
   declareParameter("phi", rclcpp::ParameterValue(1.2));
   node->get_parameter(name_ + "." + "phi", phi_v_);
+  buildDeltaTable();
   declareParameter("inflate_cone", rclcpp::ParameterValue(1.0));
   node->get_parameter(name_ + "." + "inflate_cone", inflate_cone_);
   declareParameter("no_readings_timeout", rclcpp::ParameterValue(0.0));
@@ -172,8 +173,26 @@ double RangeSensorLayer::gamma(double theta)
   }
 }
 
+void RangeSensorLayer::buildDeltaTable()
+{
+  // Beyond phi_v_ + 8, tanh has saturated to within 1e-13 of 1
+  const double max_phi = std::max(0.0, phi_v_) + 8.0;
+  delta_table_.resize(static_cast<size_t>(max_phi * DELTA_TABLE_SCALE) + 2);
+  for (size_t i = 0; i < delta_table_.size(); ++i) {
+    const double phi = static_cast<double>(i) / DELTA_TABLE_SCALE;
+    delta_table_[i] = 1 - (1 + tanh(2 * (phi - phi_v_))) / 2;
+  }
+}
+
 double RangeSensorLayer::delta(double phi)
 {
+  // Linear interpolation of the table, within 1e-5 of the exact value
+  const double position = phi * DELTA_TABLE_SCALE;
+  if (position >= 0.0 && position < static_cast<double>(delta_table_.size() - 1)) {
+    const size_t i = static_cast<size_t>(position);
+    const double t = position - static_cast<double>(i);
+    return delta_table_[i] + t * (delta_table_[i + 1] - delta_table_[i]);
+  }
   return 1 - (1 + tanh(2 * (phi - phi_v_))) / 2;
 }
 
@@ -215,15 +234,16 @@ void RangeSensorLayer::bufferIncomingRangeMsg(
   range_message_mutex_.lock();
   range_msgs_buffer_.push_back(*range_message);
   range_message_mutex_.unlock();
+  layered_costmap_->requestUpdate();
 }
 
 void RangeSensorLayer::updateCostmap()
 {
+  // Take all the readings buffered since the last update at once, without copying them
   std::list<sensor_msgs::msg::Range> range_msgs_buffer_copy;
 
   range_message_mutex_.lock();
-  range_msgs_buffer_copy = std::list<sensor_msgs::msg::Range>(range_msgs_buffer_);
-  range_msgs_buffer_.clear();
+  range_msgs_buffer_copy.swap(range_msgs_buffer_);
   range_message_mutex_.unlock();
 
   for (auto & range_msgs_it : range_msgs_buffer_copy) {
@@ -362,13 +382,19 @@ void RangeSensorLayer::updateCostmap(
   // Limit Bounds to Grid
   bx0 = std::max(0, bx0);
   by0 = std::max(0, by0);
-  bx1 = std::min(static_cast<int>(size_x_), bx1);
-  by1 = std::min(static_cast<int>(size_y_), by1);
+  bx1 = std::min(static_cast<int>(size_x_) - 1, bx1);
+  by1 = std::min(static_cast<int>(size_y_) - 1, by1);
+
+  // Barycentric coordinates inside area threshold, see below
+  const float bcciath = -static_cast<float>(inflate_cone_) * area(Ax, Ay, Bx, By, Ox, Oy);
 
-  for (unsigned int x = bx0; x <= (unsigned int)bx1; x++) {
-    for (unsigned int y = by0; y <= (unsigned int)by1; y++) {
-      bool update_xy_cell = true;
+  // Terms of the sensor model shared by all the cells of the reading
+  const double r = range_message.range;
+  const double far_limit = r + resolution_ * r;
+  const double cos_theta = cos(theta), sin_theta = sin(theta);
 
+  for (int y = by0; y <= by1; y++) {
+    for (int x = bx0; x <= bx1; x++) {
       // Unless inflate_cone_ is set to 100 %, we update cells only within the
       // (partially inflated) sensor cone, projected on the costmap as a triangle.
       // 0 % corresponds to just the triangle, but if your sensor fov is very
@@ -382,15 +408,32 @@ void RangeSensorLayer::updateCostmap(
 
         // Barycentric coordinates inside area threshold; this is not mathematically
         // sound at all, but it works!
-        float bcciath = -static_cast<float>(inflate_cone_) * area(Ax, Ay, Bx, By, Ox, Oy);
-        update_xy_cell = w0 >= bcciath && w1 >= bcciath && w2 >= bcciath;
+        if (w0 < bcciath || w1 < bcciath || w2 < bcciath) {
+          continue;
+        }
       }
 
-      if (update_xy_cell) {
+      double sensor = 0.0;
+      if (!clear_sensor_cone) {
         double wx, wy;
         mapToWorld(x, y, wx, wy);
-        update_cell(ox, oy, theta, range_message.range, wx, wy, clear_sensor_cone);
+        const double dx = wx - ox, dy = wy - oy;
+        const double phi = sqrt(dx * dx + dy * dy);
+        if (phi >= far_limit) {
+          // The sensor model gives 0.5 past the reading, leaving the cell unchanged
+          continue;
+        }
+        // Angle from the axis of the sensor, in [-pi, pi]
+        const double cell_theta = atan2(
+          dy * cos_theta - dx * sin_theta, dx * cos_theta + dy * sin_theta);
+        if (fabs(cell_theta) > max_angle_) {
+          // Out of the cone, the sensor model gives 0.5 as well
+          continue;
+        }
+        sensor = sensor_model(r, phi, cell_theta);
       }
+
+      update_cell_probability(getIndex(x, y), sensor);
     }
   }
 
@@ -412,22 +455,19 @@ void RangeSensorLayer::update_cell(
     if (!clear) {
       sensor = sensor_model(r, phi, theta);
     }
-    double prior = to_prob(getCost(x, y));
-    double prob_occ = sensor * prior;
-    double prob_not = (1 - sensor) * (1 - prior);
-    double new_prob = prob_occ / (prob_occ + prob_not);
-
-    RCLCPP_DEBUG(
-      logger_,
-      "%f %f | %f %f = %f", dx, dy, theta, phi, sensor);
-    RCLCPP_DEBUG(
-      logger_,
-      "%f | %f %f | %f", prior, prob_occ, prob_not, new_prob);
-    unsigned char c = to_cost(new_prob);
-    setCost(x, y, c);
+    update_cell_probability(getIndex(x, y), sensor);
   }
 }
 
+void RangeSensorLayer::update_cell_probability(unsigned int index, double sensor)
+{
+  double prior = to_prob(costmap_[index]);
+  double prob_occ = sensor * prior;
+  double prob_not = (1 - sensor) * (1 - prior);
+  double new_prob = prob_occ / (prob_occ + prob_not);
+  costmap_[index] = to_cost(new_prob);
+}
+
 void RangeSensorLayer::resetRange()
 {
   min_x_ = min_y_ = std::numeric_limits<double>::max();
@@ -64,6 +64,10 @@ StaticLayer::StaticLayer()
 
 StaticLayer::~StaticLayer()
 {
+  // Costmap2D's destructor would delete[] the mapped costs
+  if (usesMappedMap()) {
+    costmap_ = nullptr;
+  }
 }
 
 void
@@ -80,20 +84,25 @@ StaticLayer::onInitialize()
     map_qos.keep_last(1);
   }
 
-  RCLCPP_INFO(
-    logger_,
-    "Subscribing to the map topic (%s) with %s durability",
-    map_topic_.c_str(),
-    map_subscribe_transient_local_ ? "transient local" : "volatile");
-
   auto node = node_.lock();
   if (!node) {
     throw std::runtime_error{"Failed to lock node"};
   }
 
-  map_sub_ = node->create_subscription<nav_msgs::msg::OccupancyGrid>(
-    map_topic_, map_qos,
-    std::bind(&StaticLayer::incomingMap, this, std::placeholders::_1));
+  if (!map_file_.empty() && loadMapFile()) {
+    RCLCPP_INFO(
+      logger_, "Using the memory mapped cost map, not subscribing to the map topic");
+  } else {
+    RCLCPP_INFO(
+      logger_,
+      "Subscribing to the map topic (%s) with %s durability",
+      map_topic_.c_str(),
+      map_subscribe_transient_local_ ? "transient local" : "volatile");
+
+    map_sub_ = node->create_subscription<nav_msgs::msg::OccupancyGrid>(
+      map_topic_, map_qos,
+      std::bind(&StaticLayer::incomingMap, this, std::placeholders::_1));
+  }
 
   if (subscribe_to_updates_) {
     RCLCPP_INFO(logger_, "Subscribing to updates");
@@ -134,6 +143,7 @@ StaticLayer::getParameters()
   declareParameter("transform_tolerance", rclcpp::ParameterValue(0.0));
   declareParameter("map_topic", rclcpp::ParameterValue(""));
   declareParameter("footprint_clearing_enabled", rclcpp::ParameterValue(false));
+  declareParameter("map_file", rclcpp::ParameterValue(""));
 
   auto node = node_.lock();
   if (!node) {
@@ -143,6 +153,7 @@ StaticLayer::getParameters()
   node->get_parameter(name_ + "." + "enabled", enabled_);
   node->get_parameter(name_ + "." + "subscribe_to_updates", subscribe_to_updates_);
   node->get_parameter(name_ + "." + "footprint_clearing_enabled", footprint_clearing_enabled_);
+  node->get_parameter(name_ + "." + "map_file", map_file_);
   std::string private_map_topic, global_map_topic;
   node->get_parameter(name_ + "." + "map_topic", private_map_topic);
   node->get_parameter("map_topic", global_map_topic);
@@ -188,62 +199,154 @@ StaticLayer::processMap(const nav_msgs::msg::OccupancyGrid & new_map)
     "StaticLayer: Received a %d X %d map at %f m/pix", size_x, size_y,
     new_map.info.resolution);
 
+  matchMapGeometry(
+    size_x, size_y, new_map.info.resolution,
+    new_map.info.origin.position.x, new_map.info.origin.position.y);
+
+  unsigned int index = 0;
+
+  // we have a new map, update full size of map
+  std::lock_guard<Costmap2D::mutex_t> guard(*getMutex());
+
+  // initialize the costmap with static data
+  for (unsigned int i = 0; i < size_y; ++i) {
+    for (unsigned int j = 0; j < size_x; ++j) {
+      unsigned char value = new_map.data[index];
+      costmap_[index] = interpretValue(value);
+      ++index;
+    }
+  }
+
+  map_frame_ = new_map.header.frame_id;
+
+  x_ = y_ = 0;
+  width_ = size_x_;
+  height_ = size_y_;
+  has_updated_data_ = true;
+
+  current_ = true;
+}
+
+void
+StaticLayer::matchMapGeometry(
+  unsigned int size_x, unsigned int size_y, double resolution,
+  double origin_x, double origin_y)
+{
   // resize costmap if size, resolution or origin do not match
   Costmap2D * master = layered_costmap_->getCostmap();
   if (!layered_costmap_->isRolling() && (master->getSizeInCellsX() != size_x ||
     master->getSizeInCellsY() != size_y ||
-    master->getResolution() != new_map.info.resolution ||
-    master->getOriginX() != new_map.info.origin.position.x ||
-    master->getOriginY() != new_map.info.origin.position.y ||
+    master->getResolution() != resolution ||
+    master->getOriginX() != origin_x ||
+    master->getOriginY() != origin_y ||
     !layered_costmap_->isSizeLocked()))
   {
     // Update the size of the layered costmap (and all layers, including this one)
     RCLCPP_INFO(
       logger_,
       "StaticLayer: Resizing costmap to %d X %d at %f m/pix", size_x, size_y,
-      new_map.info.resolution);
-    layered_costmap_->resizeMap(
-      size_x, size_y, new_map.info.resolution,
-      new_map.info.origin.position.x,
-      new_map.info.origin.position.y,
-      true);
+      resolution);
+    layered_costmap_->resizeMap(size_x, size_y, resolution, origin_x, origin_y, true);
   } else if (size_x_ != size_x || size_y_ != size_y ||  // NOLINT
-    resolution_ != new_map.info.resolution ||
-    origin_x_ != new_map.info.origin.position.x ||
-    origin_y_ != new_map.info.origin.position.y)
+    resolution_ != resolution ||
+    origin_x_ != origin_x ||
+    origin_y_ != origin_y)
   {
     // only update the size of the costmap stored locally in this layer
     RCLCPP_INFO(
       logger_,
       "StaticLayer: Resizing static layer to %d X %d at %f m/pix", size_x, size_y,
-      new_map.info.resolution);
-    resizeMap(
-      size_x, size_y, new_map.info.resolution,
-      new_map.info.origin.position.x, new_map.info.origin.position.y);
+      resolution);
+    resizeMap(size_x, size_y, resolution, origin_x, origin_y);
   }
+}
 
-  unsigned int index = 0;
+bool
+StaticLayer::loadMapFile()
+{
+  std::string error;
+  if (!mapped_map_.open(map_file_, error)) {
+    RCLCPP_ERROR(logger_, "StaticLayer: Failed to map cost map file: %s", error.c_str());
+    return false;
+  }
 
-  // we have a new map, update full size of map
-  std::lock_guard<Costmap2D::mutex_t> guard(*getMutex());
+  const CostMapFileHeader & header = mapped_map_.getHeader();
+  RCLCPP_INFO(
+    logger_,
+    "StaticLayer: Mapped a %d X %d cost map at %f m/pix from %s", header.size_x,
+    header.size_y, header.resolution, map_file_.c_str());
 
-  // initialize the costmap with static data
-  for (unsigned int i = 0; i < size_y; ++i) {
-    for (unsigned int j = 0; j < size_x; ++j) {
-      unsigned char value = new_map.data[index];
-      costmap_[index] = interpretValue(value);
-      ++index;
-    }
+  // Resizing this layer to the file geometry makes initMaps() adopt the mapped costs
+  matchMapGeometry(
+    header.size_x, header.size_y, header.resolution, header.origin_x, header.origin_y);
+
+  std::lock_guard<Costmap2D::mutex_t> guard(*getMutex());
+  if (costmap_ != mapped_map_.getData()) {
+    // The layer already had the geometry of the file, so no resize went through initMaps()
+    initMaps(header.size_x, header.size_y);
   }
 
-  map_frame_ = new_map.header.frame_id;
+  map_frame_ = header.frame_id;
 
   x_ = y_ = 0;
   width_ = size_x_;
   height_ = size_y_;
   has_updated_data_ = true;
+  map_received_ = true;
 
   current_ = true;
+  return true;
+}
+
+bool
+StaticLayer::usesMappedMap() const
+{
+  return mapped_map_.isOpen() && costmap_ == mapped_map_.getData();
+}
+
+void
+StaticLayer::initMaps(unsigned int size_x, unsigned int size_y)
+{
+  std::unique_lock<mutex_t> lock(*access_);
+  if (usesMappedMap()) {
+    // Never hand the mapping over to delete[]
+    costmap_ = nullptr;
+  }
+
+  const bool matches_file = mapped_map_.isOpen() &&
+    size_x == mapped_map_.getHeader().size_x && size_y == mapped_map_.getHeader().size_y;
+  if (!matches_file) {
+    Costmap2D::initMaps(size_x, size_y);
+    return;
+  }
+
+  delete[] costmap_;
+  size_x_ = size_x;
+  size_y_ = size_y;
+  costmap_ = mapped_map_.getData();
+}
+
+void
+StaticLayer::deleteMaps()
+{
+  std::unique_lock<mutex_t> lock(*access_);
+  if (usesMappedMap()) {
+    costmap_ = nullptr;
+    return;
+  }
+  Costmap2D::deleteMaps();
+}
+
+void
+StaticLayer::resetMaps()
+{
+  std::unique_lock<mutex_t> lock(*access_);
+  if (usesMappedMap()) {
+    // Costs can only come back from the file, which also releases any copied pages
+    mapped_map_.revert();
+    return;
+  }
+  Costmap2D::resetMaps();
 }
 
 void
@@ -278,7 +381,7 @@ StaticLayer::interpretValue(unsigned char value)
 }
 
 void
-StaticLayer::incomingMap(const nav_msgs::msg::OccupancyGrid::SharedPtr new_map)
+StaticLayer::incomingMap(const nav_msgs::msg::OccupancyGrid::ConstSharedPtr new_map)
 {
   if (!nav2_util::validateMsg(*new_map)) {
     RCLCPP_ERROR(logger_, "Received map message is malformed. Rejecting.");
@@ -479,7 +582,8 @@ StaticLayer::dynamicParametersCallback(
 
     if (param_name == name_ + "." + "map_subscribe_transient_local" ||
       param_name == name_ + "." + "map_topic" ||
-      param_name == name_ + "." + "subscribe_to_updates")
+      param_name == name_ + "." + "subscribe_to_updates" ||
+      param_name == name_ + "." + "map_file")
     {
       RCLCPP_WARN(
         logger_, "%s is not a dynamic parameter "
@@ -72,6 +72,11 @@ void VoxelLayer::onInitialize()
   declareParameter("mark_threshold", rclcpp::ParameterValue(0));
   declareParameter("combination_method", rclcpp::ParameterValue(1));
   declareParameter("publish_voxel_map", rclcpp::ParameterValue(false));
+  declareParameter("publish_voxel_updates", rclcpp::ParameterValue(false));
+  declareParameter("voxel_publish_frequency", rclcpp::ParameterValue(0.0));
+  declareParameter("voxel_publish_radius", rclcpp::ParameterValue(0.0));
+  declareParameter("voxel_keyframe_interval", rclcpp::ParameterValue(10));
+  declareParameter("sparse_voxel_grid", rclcpp::ParameterValue(false));
 
   auto node = node_.lock();
   if (!node) {
@@ -87,6 +92,14 @@ void VoxelLayer::onInitialize()
   node->get_parameter(name_ + "." + "unknown_threshold", unknown_threshold_);
   node->get_parameter(name_ + "." + "mark_threshold", mark_threshold_);
   node->get_parameter(name_ + "." + "publish_voxel_map", publish_voxel_);
+  node->get_parameter(name_ + "." + "publish_voxel_updates", publish_voxel_updates_);
+  node->get_parameter(name_ + "." + "voxel_publish_frequency", voxel_publish_frequency_);
+  node->get_parameter(name_ + "." + "voxel_publish_radius", voxel_publish_radius_);
+  last_voxel_publish_time_ = rclcpp::Time(0, 0, clock_->get_clock_type());
+  int voxel_keyframe_interval = 10;
+  node->get_parameter(name_ + "." + "voxel_keyframe_interval", voxel_keyframe_interval);
+  voxel_keyframe_interval_ = static_cast<unsigned int>(std::max(0, voxel_keyframe_interval));
+  node->get_parameter(name_ + "." + "sparse_voxel_grid", use_sparse_voxel_grid_);
 
   int combination_method_param{};
   node->get_parameter(name_ + "." + "combination_method", combination_method_param);
@@ -100,11 +113,19 @@ void VoxelLayer::onInitialize()
     voxel_pub_->on_activate();
   }
 
+  if (publish_voxel_updates_) {
+    voxel_update_pub_ = node->create_publisher<nav2_msgs::msg::VoxelGridUpdate>(
+      "voxel_grid_updates", rclcpp::QoS(rclcpp::KeepLast(1)).reliable());
+    voxel_update_pub_->on_activate();
+  }
+
   clearing_endpoints_pub_ = node->create_publisher<sensor_msgs::msg::PointCloud2>(
     "clearing_endpoints", custom_qos);
   clearing_endpoints_pub_->on_activate();
 
   unknown_threshold_ += (VOXEL_BITS - size_z_);
+  // Voxel filtered sources were set up with planar bands, matching the size also anchors
+  // them to the voxel columns instead
   matchSize();
 
   // Add callback for dynamic parameters
@@ -123,6 +144,11 @@ void VoxelLayer::matchSize()
 {
   std::lock_guard<Costmap2D::mutex_t> guard(*getMutex());
   ObstacleLayer::matchSize();
+  if (use_sparse_voxel_grid_) {
+    voxel_grid_.resize(0, 0, 0);
+    sparse_voxel_grid_.resize(size_x_, size_y_, size_z_);
+    return;
+  }
   voxel_grid_.resize(size_x_, size_y_, size_z_);
   assert(voxel_grid_.sizeX() == size_x_ && voxel_grid_.sizeY() == size_y_);
 }
@@ -142,6 +168,7 @@ void VoxelLayer::resetMaps()
   // doesn't implement this, so it actually goes all the way to Costmap2D
   ObstacleLayer::resetMaps();
   voxel_grid_.reset();
+  sparse_voxel_grid_.reset();
 }
 
 void VoxelLayer::updateBounds(
@@ -222,7 +249,10 @@ void VoxelLayer::updateBounds(
       }
 
       // mark the cell in the voxel grid and check if we should also mark it in the costmap
-      if (voxel_grid_.markVoxelInMap(mx, my, mz, mark_threshold_)) {
+      const bool mark_column = use_sparse_voxel_grid_ ?
+        sparse_voxel_grid_.markVoxelInMap(mx, my, mz, mark_threshold_) :
+        voxel_grid_.markVoxelInMap(mx, my, mz, mark_threshold_);
+      if (mark_column) {
         unsigned int index = getIndex(mx, my);
 
         costmap_[index] = LETHAL_OBSTACLE;
@@ -233,31 +263,143 @@ void VoxelLayer::updateBounds(
     }
   }
 
-  if (publish_voxel_) {
-    auto grid_msg = std::make_unique<nav2_msgs::msg::VoxelGrid>();
-    unsigned int size = voxel_grid_.sizeX() * voxel_grid_.sizeY();
-    grid_msg->size_x = voxel_grid_.sizeX();
-    grid_msg->size_y = voxel_grid_.sizeY();
-    grid_msg->size_z = voxel_grid_.sizeZ();
-    grid_msg->data.resize(size);
-    memcpy(&grid_msg->data[0], voxel_grid_.getData(), size * sizeof(unsigned int));
-
-    grid_msg->origin.x = origin_x_;
-    grid_msg->origin.y = origin_y_;
-    grid_msg->origin.z = origin_z_;
-
-    grid_msg->resolutions.x = resolution_;
-    grid_msg->resolutions.y = resolution_;
-    grid_msg->resolutions.z = z_resolution_;
-    grid_msg->header.frame_id = global_frame_;
-    grid_msg->header.stamp = clock_->now();
-
-    voxel_pub_->publish(std::move(grid_msg));
+  if ((publish_voxel_ || publish_voxel_updates_) && isVoxelPublishDue()) {
+    if (publish_voxel_) {
+      publishVoxelMap(robot_x, robot_y);
+    }
+    if (publish_voxel_updates_) {
+      publishVoxelUpdate();
+    }
   }
 
   updateFootprint(robot_x, robot_y, robot_yaw, min_x, min_y, max_x, max_y);
 }
 
+bool VoxelLayer::isVoxelPublishDue()
+{
+  if (voxel_publish_frequency_ <= 0.0) {
+    return true;
+  }
+
+  const rclcpp::Time now = clock_->now();
+  if (last_voxel_publish_time_.nanoseconds() != 0 &&
+    (now - last_voxel_publish_time_).seconds() < 1.0 / voxel_publish_frequency_)
+  {
+    return false;
+  }
+  last_voxel_publish_time_ = now;
+  return true;
+}
+
+void VoxelLayer::publishVoxelMap(double robot_x, double robot_y)
+{
+  if (voxel_pub_->get_subscription_count() == 0) {
+    return;
+  }
+
+  // Window of columns to publish, the whole grid or the columns within the radius of the robot
+  unsigned int x0 = 0, y0 = 0;
+  unsigned int xn = size_x_, yn = size_y_;
+  if (voxel_publish_radius_ > 0.0) {
+    int min_x, min_y, max_x, max_y;
+    worldToMapEnforceBounds(
+      robot_x - voxel_publish_radius_, robot_y - voxel_publish_radius_, min_x, min_y);
+    worldToMapEnforceBounds(
+      robot_x + voxel_publish_radius_, robot_y + voxel_publish_radius_, max_x, max_y);
+    x0 = static_cast<unsigned int>(min_x);
+    y0 = static_cast<unsigned int>(min_y);
+    xn = std::min(static_cast<unsigned int>(max_x) + 1, xn);
+    yn = std::min(static_cast<unsigned int>(max_y) + 1, yn);
+  }
+
+  auto grid_msg = std::make_unique<nav2_msgs::msg::VoxelGrid>();
+  grid_msg->size_x = xn - x0;
+  grid_msg->size_y = yn - y0;
+  grid_msg->size_z =
+    use_sparse_voxel_grid_ ? sparse_voxel_grid_.sizeZ() : voxel_grid_.sizeZ();
+  grid_msg->data.resize(grid_msg->size_x * grid_msg->size_y);
+  if (use_sparse_voxel_grid_) {
+    sparse_voxel_grid_.copyColumns(x0, y0, xn, yn, grid_msg->data.data());
+  } else {
+    const uint32_t * data = voxel_grid_.getData();
+    for (unsigned int y = y0; y < yn; ++y) {
+      memcpy(
+        &grid_msg->data[(y - y0) * grid_msg->size_x], data + y * voxel_grid_.sizeX() + x0,
+        grid_msg->size_x * sizeof(uint32_t));
+    }
+  }
+
+  grid_msg->origin.x = origin_x_ + x0 * resolution_;
+  grid_msg->origin.y = origin_y_ + y0 * resolution_;
+  grid_msg->origin.z = origin_z_;
+
+  grid_msg->resolutions.x = resolution_;
+  grid_msg->resolutions.y = resolution_;
+  grid_msg->resolutions.z = z_resolution_;
+  grid_msg->header.frame_id = global_frame_;
+  grid_msg->header.stamp = clock_->now();
+
+  voxel_pub_->publish(std::move(grid_msg));
+}
+
+void VoxelLayer::publishVoxelUpdate()
+{
+  if (voxel_update_pub_->get_subscription_count() == 0) {
+    // Deltas are not tracked without subscribers, start over with a keyframe
+    voxel_reference_.clear();
+    return;
+  }
+
+  const unsigned int size = size_x_ * size_y_;
+  const uint32_t * data = voxel_grid_.getData();
+  if (use_sparse_voxel_grid_) {
+    // Deltas are found against the dense columns, only built while publishing updates
+    voxel_columns_.resize(size);
+    sparse_voxel_grid_.copyColumns(0, 0, size_x_, size_y_, voxel_columns_.data());
+    data = voxel_columns_.data();
+  }
+
+  auto msg = std::make_unique<nav2_msgs::msg::VoxelGridUpdate>();
+  msg->header.frame_id = global_frame_;
+  msg->header.stamp = clock_->now();
+  msg->sequence = ++voxel_update_sequence_;
+  msg->size_x = size_x_;
+  msg->size_y = size_y_;
+  msg->size_z = use_sparse_voxel_grid_ ? sparse_voxel_grid_.sizeZ() : voxel_grid_.sizeZ();
+  msg->origin.x = origin_x_;
+  msg->origin.y = origin_y_;
+  msg->origin.z = origin_z_;
+  msg->resolutions.x = resolution_;
+  msg->resolutions.y = resolution_;
+  msg->resolutions.z = z_resolution_;
+
+  // Any change of the geometry of the grid, such as a move of a rolling window, needs a keyframe
+  if (voxel_reference_.size() != size || voxel_reference_size_z_ != msg->size_z ||
+    voxel_reference_origin_ != msg->origin || voxel_reference_resolutions_ != msg->resolutions ||
+    (voxel_keyframe_interval_ > 0 && voxel_deltas_since_keyframe_ >= voxel_keyframe_interval_))
+  {
+    msg->keyframe = true;
+    msg->data.assign(data, data + size);
+    voxel_reference_.assign(data, data + size);
+    voxel_reference_size_z_ = msg->size_z;
+    voxel_reference_origin_ = msg->origin;
+    voxel_reference_resolutions_ = msg->resolutions;
+    voxel_deltas_since_keyframe_ = 0;
+  } else {
+    msg->keyframe = false;
+    for (unsigned int i = 0; i < size; ++i) {
+      if (data[i] != voxel_reference_[i]) {
+        msg->indices.push_back(i);
+        msg->data.push_back(data[i]);
+        voxel_reference_[i] = data[i];
+      }
+    }
+    ++voxel_deltas_since_keyframe_;
+  }
+
+  voxel_update_pub_->publish(std::move(msg));
+}
+
 void VoxelLayer::raytraceFreespace(
   const Observation & clearing_observation, double * min_x,
   double * min_y,
@@ -378,11 +520,19 @@ void VoxelLayer::raytraceFreespace(
 
 
       // voxel_grid_.markVoxelLine(sensor_x, sensor_y, sensor_z, point_x, point_y, point_z);
-      voxel_grid_.clearVoxelLineInMap(
-        sensor_x, sensor_y, sensor_z, point_x, point_y, point_z,
-        costmap_,
-        unknown_threshold_, mark_threshold_, FREE_SPACE, NO_INFORMATION,
-        cell_raytrace_max_range, cell_raytrace_min_range);
+      if (use_sparse_voxel_grid_) {
+        sparse_voxel_grid_.clearVoxelLineInMap(
+          sensor_x, sensor_y, sensor_z, point_x, point_y, point_z,
+          costmap_,
+          unknown_threshold_, mark_threshold_, FREE_SPACE, NO_INFORMATION,
+          cell_raytrace_max_range, cell_raytrace_min_range);
+      } else {
+        voxel_grid_.clearVoxelLineInMap(
+          sensor_x, sensor_y, sensor_z, point_x, point_y, point_z,
+          costmap_,
+          unknown_threshold_, mark_threshold_, FREE_SPACE, NO_INFORMATION,
+          cell_raytrace_max_range, cell_raytrace_min_range);
+      }
 
       updateRaytraceBounds(
         ox, oy, wpx, wpy, clearing_observation.raytrace_max_range_,
@@ -423,58 +573,34 @@ void VoxelLayer::updateOrigin(double new_origin_x, double new_origin_y)
   new_grid_ox = origin_x_ + cell_ox * resolution_;
   new_grid_oy = origin_y_ + cell_oy * resolution_;
 
-  // To save casting from unsigned int to int a bunch of times
-  int size_x = size_x_;
-  int size_y = size_y_;
-
-  // we need to compute the overlap of the new and existing windows
-  int lower_left_x, lower_left_y, upper_right_x, upper_right_y;
-  lower_left_x = std::min(std::max(cell_ox, 0), size_x);
-  lower_left_y = std::min(std::max(cell_oy, 0), size_y);
-  upper_right_x = std::min(std::max(cell_ox + size_x, 0), size_x);
-  upper_right_y = std::min(std::max(cell_oy + size_y, 0), size_y);
-
-  unsigned int cell_size_x = upper_right_x - lower_left_x;
-  unsigned int cell_size_y = upper_right_y - lower_left_y;
-
-  // we need a map to store the obstacles in the window temporarily
-  unsigned char * local_map = new unsigned char[cell_size_x * cell_size_y];
-  unsigned int * local_voxel_map = new unsigned int[cell_size_x * cell_size_y];
-  unsigned int * voxel_map = voxel_grid_.getData();
-
-  // copy the local window in the costmap to the local map
-  copyMapRegion(
-    costmap_, lower_left_x, lower_left_y, size_x_, local_map, 0, 0, cell_size_x,
-    cell_size_x,
-    cell_size_y);
-  copyMapRegion(
-    voxel_map, lower_left_x, lower_left_y, size_x_, local_voxel_map, 0, 0, cell_size_x,
-    cell_size_x,
-    cell_size_y);
-
-  // we'll reset our maps to unknown space if appropriate
-  resetMaps();
+  // move the overlapping information in both maps to its new location in place,
+  // cells that were outside of the old window become unknown space
+  std::lock_guard<Costmap2D::mutex_t> guard(*getMutex());
+  const uint32_t unknown_col = ~((uint32_t)0) >> 16;
+  shiftMapRegion(costmap_, cell_ox, cell_oy, default_value_);
+  if (use_sparse_voxel_grid_) {
+    sparse_voxel_grid_.updateOrigin(cell_ox, cell_oy);
+  } else {
+    shiftMapRegion(voxel_grid_.getData(), cell_ox, cell_oy, unknown_col);
+  }
 
   // update the origin with the appropriate world coordinates
   origin_x_ = new_grid_ox;
   origin_y_ = new_grid_oy;
+  if (cell_ox != 0 || cell_oy != 0) {
+    updateVoxelFilters();
+  }
+}
 
-  // compute the starting cell location for copying data back in
-  int start_x = lower_left_x - cell_ox;
-  int start_y = lower_left_y - cell_oy;
-
-  // now we want to copy the overlapping information back into the map, but in its new location
-  copyMapRegion(
-    local_map, 0, 0, cell_size_x, costmap_, start_x, start_y, size_x_, cell_size_x,
-    cell_size_y);
-  copyMapRegion(
-    local_voxel_map, 0, 0, cell_size_x, voxel_map, start_x, start_y, size_x_,
-    cell_size_x,
-    cell_size_y);
-
-  // make sure to clean up
-  delete[] local_map;
-  delete[] local_voxel_map;
+void VoxelLayer::updateVoxelFilters()
+{
+  for (auto & buffer : observation_buffers_) {
+    if (buffer->isVoxelFilterEnabled()) {
+      buffer->lock();
+      buffer->setVoxelFilter(resolution_, z_resolution_, origin_x_, origin_y_, origin_z_);
+      buffer->unlock();
+    }
+  }
 }
 
 /**
@@ -502,6 +628,10 @@ VoxelLayer::dynamicParametersCallback(
       } else if (param_name == name_ + "." + "z_resolution") {
         z_resolution_ = parameter.as_double();
         resize_map_needed = true;
+      } else if (param_name == name_ + "." + "voxel_publish_frequency") {
+        voxel_publish_frequency_ = parameter.as_double();
+      } else if (param_name == name_ + "." + "voxel_publish_radius") {
+        voxel_publish_radius_ = parameter.as_double();
       }
     } else if (param_type == ParameterType::PARAMETER_BOOL) {
       if (param_name == name_ + "." + "enabled") {
@@ -509,7 +639,9 @@ VoxelLayer::dynamicParametersCallback(
         current_ = false;
       } else if (param_name == name_ + "." + "footprint_clearing_enabled") {
         footprint_clearing_enabled_ = parameter.as_bool();
-      } else if (param_name == name_ + "." + "publish_voxel_map") {
+      } else if (param_name == name_ + "." + "publish_voxel_map" ||
+        param_name == name_ + "." + "publish_voxel_updates")
+      {
         RCLCPP_WARN(
           logger_, "publish voxel map is not a dynamic parameter "
           "cannot be changed while running. Rejecting parameter update.");
@@ -526,6 +658,8 @@ VoxelLayer::dynamicParametersCallback(
         mark_threshold_ = parameter.as_int();
       } else if (param_name == name_ + "." + "combination_method") {
         combination_method_ = combination_method_from_int(parameter.as_int());
+      } else if (param_name == name_ + "." + "voxel_keyframe_interval") {
+        voxel_keyframe_interval_ = static_cast<unsigned int>(std::max(0, parameter.as_int()));
       }
     }
   }
@@ -68,7 +68,8 @@ void ClearCostmapService::clearExceptRegionCallback(
     logger_, "%s",
     ("Received request to clear except a region the " + costmap_.getName()).c_str());
 
-  clearRegion(request->reset_distance, true);
+  const double reset_distance = request->reset_distance;
+  scheduleClear([this, reset_distance]() {clearRegion(reset_distance, true);});
 }
 
 void ClearCostmapService::clearAroundRobotCallback(
@@ -76,7 +77,8 @@ void ClearCostmapService::clearAroundRobotCallback(
   const shared_ptr<ClearAroundRobot::Request> request,
   const shared_ptr<ClearAroundRobot::Response>/*response*/)
 {
-  clearRegion(request->reset_distance, false);
+  const double reset_distance = request->reset_distance;
+  scheduleClear([this, reset_distance]() {clearRegion(reset_distance, false);});
 }
 
 void ClearCostmapService::clearEntireCallback(
@@ -88,7 +90,63 @@ void ClearCostmapService::clearEntireCallback(
     logger_, "%s",
     ("Received request to clear entirely the " + costmap_.getName()).c_str());
 
-  clearEntirely();
+  scheduleClear([this]() {clearEntirely();});
+}
+
+void ClearCostmapService::scheduleClear(std::function<void()> apply)
+{
+  if (!costmap_.isUpdateLoopRunning()) {
+    apply();
+    return;
+  }
+
+  auto pending = std::make_shared<PendingClear>();
+  pending->apply = std::move(apply);
+  std::future<void> done = pending->done.get_future();
+  {
+    std::lock_guard<std::mutex> lock(pending_mutex_);
+    pending_clears_.push_back(pending);
+  }
+  costmap_.getLayeredCostmap()->requestUpdate();
+
+  if (done.wait_for(pending_timeout_) == std::future_status::ready) {
+    return;
+  }
+
+  // The update loop stalled or stopped: take the request back if it was not
+  // picked up yet, otherwise it is being applied and will complete shortly
+  bool reclaimed = false;
+  {
+    std::lock_guard<std::mutex> lock(pending_mutex_);
+    auto it = std::find(pending_clears_.begin(), pending_clears_.end(), pending);
+    if (it != pending_clears_.end()) {
+      pending_clears_.erase(it);
+      reclaimed = true;
+    }
+  }
+
+  if (reclaimed) {
+    RCLCPP_WARN(
+      logger_, "Map update loop of %s did not apply the clear request in time, "
+      "applying it directly", costmap_.getName().c_str());
+    pending->apply();
+  } else {
+    done.wait();
+  }
+}
+
+void ClearCostmapService::applyPendingClears()
+{
+  std::deque<std::shared_ptr<PendingClear>> pending;
+  {
+    std::lock_guard<std::mutex> lock(pending_mutex_);
+    pending.swap(pending_clears_);
+  }
+
+  for (auto & request : pending) {
+    request->apply();
+    request->done.set_value();
+  }
 }
 
 void ClearCostmapService::clearRegion(const double reset_distance, bool invert)
@@ -133,8 +191,16 @@ void ClearCostmapService::clearLayerRegion(
   costmap->clearArea(start_x, start_y, end_x, end_y, invert);
 
   double ox = costmap->getOriginX(), oy = costmap->getOriginY();
-  double width = costmap->getSizeInMetersX(), height = costmap->getSizeInMetersY();
-  costmap->addExtraBounds(ox, oy, ox + width, oy + height);
+  if (invert) {
+    double width = costmap->getSizeInMetersX(), height = costmap->getSizeInMetersY();
+    costmap->addExtraBounds(ox, oy, ox + width, oy + height);
+  } else {
+    // Only the cleared window changed, so only it needs to be recombined
+    double resolution = costmap->getResolution();
+    costmap->addExtraBounds(
+      ox + start_x * resolution, oy + start_y * resolution,
+      ox + end_x * resolution, oy + end_y * resolution);
+  }
 }
 
 void ClearCostmapService::clearEntirely()
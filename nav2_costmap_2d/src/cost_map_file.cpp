@@ -0,0 +1,147 @@
+// Copyright (c) 2024 Open Navigation LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "nav2_costmap_2d/cost_map_file.hpp"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstring>
+#include <fstream>
+
+namespace nav2_costmap_2d
+{
+
+constexpr char CostMapFileHeader::MAGIC[8];
+constexpr uint32_t CostMapFileHeader::VERSION;
+
+bool saveCostMapFile(
+  const std::string & path, const Costmap2D & costmap, const std::string & frame_id,
+  uint32_t map_hash)
+{
+  CostMapFileHeader header;
+  memset(&header, 0, sizeof(header));
+  memcpy(header.magic, CostMapFileHeader::MAGIC, sizeof(header.magic));
+  header.version = CostMapFileHeader::VERSION;
+  header.size_x = costmap.getSizeInCellsX();
+  header.size_y = costmap.getSizeInCellsY();
+  header.map_hash = map_hash;
+  header.resolution = costmap.getResolution();
+  header.origin_x = costmap.getOriginX();
+  header.origin_y = costmap.getOriginY();
+  if (frame_id.size() >= sizeof(header.frame_id)) {
+    return false;
+  }
+  memcpy(header.frame_id, frame_id.c_str(), frame_id.size());
+
+  std::ofstream file(path, std::ios::binary | std::ios::trunc);
+  if (!file) {
+    return false;
+  }
+  file.write(reinterpret_cast<const char *>(&header), sizeof(header));
+  file.write(
+    reinterpret_cast<const char *>(costmap.getCharMap()),
+    static_cast<std::streamsize>(header.size_x) * header.size_y);
+  return static_cast<bool>(file);
+}
+
+uint32_t hashCosts(const unsigned char * costs, size_t size, uint32_t hash)
+{
+  for (size_t i = 0; i < size; ++i) {
+    hash = (hash ^ costs[i]) * 16777619u;
+  }
+  return hash == 0 ? 1 : hash;
+}
+
+MappedCostMapFile::~MappedCostMapFile()
+{
+  close();
+}
+
+bool MappedCostMapFile::open(const std::string & path, std::string & error)
+{
+  close();
+
+  int fd = ::open(path.c_str(), O_RDONLY);
+  if (fd < 0) {
+    error = "cannot open " + path + ": " + strerror(errno);
+    return false;
+  }
+
+  struct stat file_stat;
+  if (fstat(fd, &file_stat) != 0) {
+    error = "cannot stat " + path + ": " + strerror(errno);
+    ::close(fd);
+    return false;
+  }
+  const size_t length = static_cast<size_t>(file_stat.st_size);
+  if (length < sizeof(CostMapFileHeader)) {
+    error = path + " is too short to be a cost map file";
+    ::close(fd);
+    return false;
+  }
+
+  // Private writable mapping of a read-only file: writes are copied on write
+  void * base = mmap(nullptr, length, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+  // The mapping keeps its own reference to the file
+  ::close(fd);
+  if (base == MAP_FAILED) {
+    error = "cannot map " + path + ": " + strerror(errno);
+    return false;
+  }
+
+  const auto * header = static_cast<const CostMapFileHeader *>(base);
+  if (memcmp(header->magic, CostMapFileHeader::MAGIC, sizeof(header->magic)) != 0 ||
+    header->version != CostMapFileHeader::VERSION)
+  {
+    error = path + " is not a cost map file of a supported version";
+    munmap(base, length);
+    return false;
+  }
+  const uint64_t cells = static_cast<uint64_t>(header->size_x) * header->size_y;
+  if (length - sizeof(CostMapFileHeader) < cells ||
+    header->frame_id[sizeof(header->frame_id) - 1] != '\0')
+  {
+    error = path + " is truncated or corrupted";
+    munmap(base, length);
+    return false;
+  }
+
+  base_ = base;
+  length_ = length;
+  return true;
+}
+
+void MappedCostMapFile::close()
+{
+  if (base_) {
+    munmap(base_, length_);
+    base_ = nullptr;
+    length_ = 0;
+  }
+}
+
+void MappedCostMapFile::revert()
+{
+  if (base_) {
+    // On private file mappings this discards the copied pages, which are read
+    // again from the file on the next access
+    madvise(base_, length_, MADV_DONTNEED);
+  }
+}
+
+}  // namespace nav2_costmap_2d
@@ -38,14 +38,100 @@
 #include "nav2_costmap_2d/costmap_2d.hpp"
 
 #include <algorithm>
+#include <array>
 #include <cstdio>
+#include <mutex>
 #include <string>
 #include <vector>
 #include "nav2_costmap_2d/cost_values.hpp"
 #include "nav2_util/occ_grid_values.hpp"
 
+#ifdef __linux__
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
 namespace nav2_costmap_2d
 {
+
+namespace
+{
+
+#ifdef __linux__
+// Sparse maps are mapped copy-on-write over a shared file of default values, in chunks
+constexpr size_t kDefaultChunkSize = 1 << 21;
+
+/**
+ * @brief Get the file of a chunk of a default value, created on first use
+ * @param value Default value
+ * @return File descriptor, -1 if it could not be created
+ */
+int getDefaultChunkFile(unsigned char value)
+{
+  static std::mutex mutex;
+  static std::array<int, 256> files;
+  static std::array<bool, 256> created{};
+  std::lock_guard<std::mutex> lock(mutex);
+  if (created[value]) {
+    return files[value];
+  }
+  created[value] = true;
+
+  int fd = memfd_create("costmap_default_values", MFD_CLOEXEC);
+  if (fd >= 0) {
+    std::vector<unsigned char> chunk(kDefaultChunkSize, value);
+    size_t written = 0;
+    while (written < chunk.size()) {
+      ssize_t n = write(fd, chunk.data() + written, chunk.size() - written);
+      if (n <= 0) {
+        close(fd);
+        fd = -1;
+        break;
+      }
+      written += n;
+    }
+  }
+  files[value] = fd;
+  return fd;
+}
+
+/**
+ * @brief Map the chunk of a default value over a region, replacing what was mapped
+ * there, or over a new region
+ * @param address Start of the region, nullptr for a new one
+ * @param size Size of the region, a multiple of the page size
+ * @param value Default value
+ * @return Start of the region, nullptr on failure
+ */
+unsigned char * mapDefaultValues(unsigned char * address, size_t size, unsigned char value)
+{
+  const int fd = getDefaultChunkFile(value);
+  if (fd < 0) {
+    return nullptr;
+  }
+  if (address == nullptr) {
+    void * region = mmap(
+      nullptr, size, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+    if (region == MAP_FAILED) {
+      return nullptr;
+    }
+    address = static_cast<unsigned char *>(region);
+  }
+  for (size_t offset = 0; offset < size; offset += kDefaultChunkSize) {
+    void * chunk = mmap(
+      address + offset, std::min(kDefaultChunkSize, size - offset), PROT_READ | PROT_WRITE,
+      MAP_PRIVATE | MAP_FIXED | MAP_NORESERVE, fd, 0);
+    if (chunk == MAP_FAILED) {
+      munmap(address, size);
+      return nullptr;
+    }
+  }
+  return address;
+}
+#endif
+
+}  // namespace
+
 Costmap2D::Costmap2D(
   unsigned int cells_size_x, unsigned int cells_size_y, double resolution,
   double origin_x, double origin_y, unsigned char default_value)
@@ -72,7 +158,7 @@ Costmap2D::Costmap2D(const nav_msgs::msg::OccupancyGrid & map)
   origin_y_ = map.info.origin.position.y;
 
   // create the costmap
-  costmap_ = new unsigned char[size_x_ * size_y_];
+  allocateMap(size_x_ * size_y_);
 
   // fill the costmap with a data
   int8_t data;
@@ -94,17 +180,46 @@ void Costmap2D::deleteMaps()
 {
   // clean up data
   std::unique_lock<mutex_t> lock(*access_);
-  delete[] costmap_;
-  costmap_ = NULL;
+  freeMap();
 }
 
 void Costmap2D::initMaps(unsigned int size_x, unsigned int size_y)
 {
   std::unique_lock<mutex_t> lock(*access_);
-  delete[] costmap_;
+  freeMap();
   size_x_ = size_x;
   size_y_ = size_y;
-  costmap_ = new unsigned char[size_x * size_y];
+  allocateMap(static_cast<size_t>(size_x) * size_y);
+}
+
+void Costmap2D::allocateMap(size_t size)
+{
+#ifdef __linux__
+  if (sparse_storage_ && size > 0) {
+    const size_t page_size = sysconf(_SC_PAGESIZE);
+    const size_t mapped_size = (size + page_size - 1) / page_size * page_size;
+    costmap_ = mapDefaultValues(nullptr, mapped_size, default_value_);
+    if (costmap_) {
+      mapped_size_ = mapped_size;
+      return;
+    }
+  }
+#endif
+  costmap_ = new unsigned char[size];
+}
+
+void Costmap2D::freeMap()
+{
+#ifdef __linux__
+  if (mapped_size_ > 0) {
+    munmap(costmap_, mapped_size_);
+    mapped_size_ = 0;
+    costmap_ = NULL;
+    return;
+  }
+#endif
+  delete[] costmap_;
+  costmap_ = NULL;
 }
 
 void Costmap2D::resizeMap(
@@ -124,6 +239,17 @@ void Costmap2D::resizeMap(
 void Costmap2D::resetMaps()
 {
   std::unique_lock<mutex_t> lock(*access_);
+#ifdef __linux__
+  // Mapping the default values again releases the pages written to
+  if (mapped_size_ > 0 && mapDefaultValues(costmap_, mapped_size_, default_value_)) {
+    return;
+  }
+  if (mapped_size_ > 0) {
+    // The region was unmapped on failure, so allocate it densely instead
+    mapped_size_ = 0;
+    costmap_ = new unsigned char[size_x_ * size_y_];
+  }
+#endif
   memset(costmap_, default_value_, size_x_ * size_y_ * sizeof(unsigned char));
 }
 
@@ -352,47 +478,14 @@ void Costmap2D::updateOrigin(double new_origin_x, double new_origin_y)
   new_grid_ox = origin_x_ + cell_ox * resolution_;
   new_grid_oy = origin_y_ + cell_oy * resolution_;
 
-  // To save casting from unsigned int to int a bunch of times
-  int size_x = size_x_;
-  int size_y = size_y_;
-
-  // we need to compute the overlap of the new and existing windows
-  int lower_left_x, lower_left_y, upper_right_x, upper_right_y;
-  lower_left_x = std::min(std::max(cell_ox, 0), size_x);
-  lower_left_y = std::min(std::max(cell_oy, 0), size_y);
-  upper_right_x = std::min(std::max(cell_ox + size_x, 0), size_x);
-  upper_right_y = std::min(std::max(cell_oy + size_y, 0), size_y);
-
-  unsigned int cell_size_x = upper_right_x - lower_left_x;
-  unsigned int cell_size_y = upper_right_y - lower_left_y;
-
-  // we need a map to store the obstacles in the window temporarily
-  unsigned char * local_map = new unsigned char[cell_size_x * cell_size_y];
-
-  // copy the local window in the costmap to the local map
-  copyMapRegion(
-    costmap_, lower_left_x, lower_left_y, size_x_, local_map, 0, 0, cell_size_x,
-    cell_size_x,
-    cell_size_y);
-
-  // now we'll set the costmap to be completely unknown if we track unknown space
-  resetMaps();
+  // move the overlapping information to its new location in place, any cells that
+  // were outside of the old window are set to unknown if we track unknown space
+  std::unique_lock<mutex_t> lock(*access_);
+  shiftMapRegion(costmap_, cell_ox, cell_oy, default_value_);
 
   // update the origin with the appropriate world coordinates
   origin_x_ = new_grid_ox;
   origin_y_ = new_grid_oy;
-
-  // compute the starting cell location for copying data back in
-  int start_x = lower_left_x - cell_ox;
-  int start_y = lower_left_y - cell_oy;
-
-  // now we want to copy the overlapping information back into the map, but in its new location
-  copyMapRegion(
-    local_map, 0, 0, cell_size_x, costmap_, start_x, start_y, size_x_, cell_size_x,
-    cell_size_y);
-
-  // make sure to clean up
-  delete[] local_map;
 }
 
 bool Costmap2D::setConvexPolygonCost(
@@ -35,38 +35,18 @@
 #include "sensor_msgs/point_cloud2_iterator.hpp"
 #include "nav2_voxel_grid/voxel_grid.hpp"
 #include "nav2_msgs/msg/voxel_grid.hpp"
+#include "nav2_msgs/msg/voxel_grid_update.hpp"
+#include "nav2_costmap_2d/voxel_grid_columns.hpp"
 #include "nav2_util/execution_timer.hpp"
 
-static inline void mapToWorld3D(
-  const unsigned int mx,
-  const unsigned int my, const unsigned int mz,
-  const double origin_x, const double origin_y, const double origin_z,
-  const double x_resolution, const double y_resolution,
-  const double z_resolution,
-  double & wx, double & wy, double & wz)
-{
-  // returns the center point of the cell
-  wx = origin_x + (mx + 0.5) * x_resolution;
-  wy = origin_y + (my + 0.5) * y_resolution;
-  wz = origin_z + (mz + 0.5) * z_resolution;
-}
-
-struct Cell
-{
-  double x;
-  double y;
-  double z;
-  nav2_voxel_grid::VoxelStatus status;
-};
-typedef std::vector<Cell> V_Cell;
-
 float g_colors_r[] = {0.0f, 0.0f, 1.0f};
 float g_colors_g[] = {0.0f, 0.0f, 0.0f};
 float g_colors_b[] = {0.0f, 1.0f, 0.0f};
 float g_colors_a[] = {0.0f, 0.5f, 1.0f};
 
-V_Cell g_marked;
-V_Cell g_unknown;
+nav2_costmap_2d::VoxelGridColumns g_columns;
+std::vector<nav2_costmap_2d::VoxelPoint> g_marked;
+std::vector<nav2_costmap_2d::VoxelPoint> g_unknown;
 
 rclcpp::Node::SharedPtr g_node;
 
@@ -76,16 +56,17 @@ rclcpp::Publisher<sensor_msgs::msg::PointCloud2>::SharedPtr pub_unknown;
 /**
  * @brief An helper function to fill pointcloud2 of both the marked and unknown points from voxel_grid
  * @param cloud PointCloud2 Ptr which needs to be filled
- * @param num_channels Represents the total number of points that are going to be filled
  * @param header Carries the header information that needs to be assigned to PointCloud2 header
- * @param g_cells contains the x, y, z values that needs to be added to the PointCloud2
+ * @param points contains the x, y, z values that needs to be added to the PointCloud2
+ * @param status Status of the voxels, giving their color
  */
 void pointCloud2Helper(
   std::unique_ptr<sensor_msgs::msg::PointCloud2> & cloud,
-  uint32_t num_channels,
-  std_msgs::msg::Header header,
-  V_Cell & g_cells)
+  const std_msgs::msg::Header & header,
+  const std::vector<nav2_costmap_2d::VoxelPoint> & points,
+  nav2_voxel_grid::VoxelStatus status)
 {
+  const uint32_t num_channels = points.size();
   cloud->header = header;
   cloud->width = num_channels;
   cloud->height = 1;
@@ -109,15 +90,18 @@ void pointCloud2Helper(
   sensor_msgs::PointCloud2Iterator<uint8_t> iter_g(*cloud, "g");
   sensor_msgs::PointCloud2Iterator<uint8_t> iter_b(*cloud, "b");
 
+  const uint8_t r = g_colors_r[status] * 255.0;
+  const uint8_t g = g_colors_g[status] * 255.0;
+  const uint8_t b = g_colors_b[status] * 255.0;
   for (uint32_t i = 0; i < num_channels; ++i) {
-    Cell & c = g_cells[i];
+    const nav2_costmap_2d::VoxelPoint & c = points[i];
     // assigning value to the point cloud2's iterator
     *iter_x = c.x;
     *iter_y = c.y;
     *iter_z = c.z;
-    *iter_r = g_colors_r[c.status] * 255.0;
-    *iter_g = g_colors_g[c.status] * 255.0;
-    *iter_b = g_colors_b[c.status] * 255.0;
+    *iter_r = r;
+    *iter_g = g;
+    *iter_b = b;
 
     ++iter_x;
     ++iter_y;
@@ -128,86 +112,58 @@ void pointCloud2Helper(
   }
 }
 
-void voxelCallback(const nav2_msgs::msg::VoxelGrid::ConstSharedPtr grid)
+/**
+ * @brief Converts the voxel columns changed and publishes the marked and unknown voxels
+ * @param header Header of the voxel grid
+ */
+void publishClouds(const std_msgs::msg::Header & header)
 {
-  if (grid->data.empty()) {
-    RCLCPP_ERROR(g_node->get_logger(), "Received empty voxel grid");
-    return;
-  }
-
   nav2_util::ExecutionTimer timer;
   timer.start();
 
-  RCLCPP_DEBUG(g_node->get_logger(), "Received voxel grid");
-  const std::string frame_id = grid->header.frame_id;
-  const rclcpp::Time stamp = grid->header.stamp;
-  const uint32_t * data = &grid->data.front();
-  const double x_origin = grid->origin.x;
-  const double y_origin = grid->origin.y;
-  const double z_origin = grid->origin.z;
-  const double x_res = grid->resolutions.x;
-  const double y_res = grid->resolutions.y;
-  const double z_res = grid->resolutions.z;
-  const uint32_t x_size = grid->size_x;
-  const uint32_t y_size = grid->size_y;
-  const uint32_t z_size = grid->size_z;
-
-  g_marked.clear();
-  g_unknown.clear();
-  uint32_t num_marked = 0;
-  uint32_t num_unknown = 0;
-  for (uint32_t y_grid = 0; y_grid < y_size; ++y_grid) {
-    for (uint32_t x_grid = 0; x_grid < x_size; ++x_grid) {
-      for (uint32_t z_grid = 0; z_grid < z_size; ++z_grid) {
-        nav2_voxel_grid::VoxelStatus status =
-          nav2_voxel_grid::VoxelGrid::getVoxel(
-          x_grid, y_grid,
-          z_grid, x_size, y_size, z_size, data);
-        if (status == nav2_voxel_grid::UNKNOWN) {
-          Cell c;
-          c.status = status;
-          mapToWorld3D(
-            x_grid, y_grid, z_grid, x_origin, y_origin,
-            z_origin, x_res, y_res, z_res, c.x, c.y, c.z);
-
-          g_unknown.push_back(c);
-
-          ++num_unknown;
-        } else if (status == nav2_voxel_grid::MARKED) {
-          Cell c;
-          c.status = status;
-          mapToWorld3D(
-            x_grid, y_grid, z_grid, x_origin, y_origin,
-            z_origin, x_res, y_res, z_res, c.x, c.y, c.z);
-
-          g_marked.push_back(c);
-
-          ++num_marked;
-        }
-      }
-    }
+  if (g_columns.convertChangedTiles() == 0) {
+    return;
   }
-
-  std_msgs::msg::Header pcl_header;
-  pcl_header.frame_id = frame_id;
-  pcl_header.stamp = stamp;
+  g_columns.getMarked(g_marked);
+  g_columns.getUnknown(g_unknown);
 
   {
     auto cloud = std::make_unique<sensor_msgs::msg::PointCloud2>();
-    pointCloud2Helper(cloud, num_marked, pcl_header, g_marked);
+    pointCloud2Helper(cloud, header, g_marked, nav2_voxel_grid::MARKED);
     pub_marked->publish(std::move(cloud));
   }
 
   {
     auto cloud = std::make_unique<sensor_msgs::msg::PointCloud2>();
-    pointCloud2Helper(cloud, num_unknown, pcl_header, g_unknown);
+    pointCloud2Helper(cloud, header, g_unknown, nav2_voxel_grid::UNKNOWN);
     pub_unknown->publish(std::move(cloud));
   }
 
   timer.end();
   RCLCPP_DEBUG(
-    g_node->get_logger(), "Published %d points in %f seconds",
-    num_marked + num_unknown, timer.elapsed_time_in_seconds());
+    g_node->get_logger(), "Published %zu points in %f seconds",
+    g_marked.size() + g_unknown.size(), timer.elapsed_time_in_seconds());
+}
+
+void voxelCallback(const nav2_msgs::msg::VoxelGrid::ConstSharedPtr grid)
+{
+  if (grid->data.empty()) {
+    RCLCPP_ERROR(g_node->get_logger(), "Received empty voxel grid");
+    return;
+  }
+
+  RCLCPP_DEBUG(g_node->get_logger(), "Received voxel grid");
+  g_columns.setGrid(*grid);
+  publishClouds(grid->header);
+}
+
+void voxelUpdateCallback(const nav2_msgs::msg::VoxelGridUpdate::ConstSharedPtr update)
+{
+  if (!g_columns.applyUpdate(*update)) {
+    RCLCPP_DEBUG(g_node->get_logger(), "Voxel grid update out of sequence, waiting for a keyframe");
+    return;
+  }
+  publishClouds(update->header);
 }
 
 int main(int argc, char ** argv)
@@ -221,8 +177,16 @@ int main(int argc, char ** argv)
     "voxel_marked_cloud", 1);
   pub_unknown = g_node->create_publisher<sensor_msgs::msg::PointCloud2>(
     "voxel_unknown_cloud", 1);
-  auto sub = g_node->create_subscription<nav2_msgs::msg::VoxelGrid>(
-    "voxel_grid", rclcpp::SystemDefaultsQoS(), voxelCallback);
+  // Only the columns changed are received with voxel_grid_updates
+  const bool voxel_updates = g_node->declare_parameter("voxel_updates", false);
+  rclcpp::SubscriptionBase::SharedPtr sub;
+  if (voxel_updates) {
+    sub = g_node->create_subscription<nav2_msgs::msg::VoxelGridUpdate>(
+      "voxel_grid_updates", rclcpp::SystemDefaultsQoS(), voxelUpdateCallback);
+  } else {
+    sub = g_node->create_subscription<nav2_msgs::msg::VoxelGrid>(
+      "voxel_grid", rclcpp::SystemDefaultsQoS(), voxelCallback);
+  }
 
   rclcpp::spin(g_node->get_node_base_interface());
 
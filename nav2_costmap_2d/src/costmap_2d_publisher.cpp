@@ -38,11 +38,14 @@
  *********************************************************************/
 #include "nav2_costmap_2d/costmap_2d_publisher.hpp"
 
+#include <cstring>
 #include <string>
 #include <memory>
 #include <utility>
 
+#include "nav2_costmap_2d/cost_combination.hpp"
 #include "nav2_costmap_2d/cost_values.hpp"
+#include "nav2_costmap_2d/costmap_update_codec.hpp"
 
 namespace nav2_costmap_2d
 {
@@ -54,12 +57,15 @@ Costmap2DPublisher::Costmap2DPublisher(
   Costmap2D * costmap,
   std::string global_frame,
   std::string topic_name,
-  bool always_send_full_costmap)
+  bool always_send_full_costmap,
+  bool publish_compressed_updates,
+  unsigned int keyframe_interval)
 : costmap_(costmap),
   global_frame_(global_frame),
   topic_name_(topic_name),
   active_(false),
-  always_send_full_costmap_(always_send_full_costmap)
+  always_send_full_costmap_(always_send_full_costmap),
+  keyframe_interval_(keyframe_interval)
 {
   auto node = parent.lock();
   clock_ = node->get_clock();
@@ -78,6 +84,11 @@ Costmap2DPublisher::Costmap2DPublisher(
     topic_name + "_updates", custom_qos);
   costmap_raw_update_pub_ = node->create_publisher<nav2_msgs::msg::CostmapUpdate>(
     topic_name + "_raw_updates", custom_qos);
+  if (publish_compressed_updates) {
+    costmap_compressed_update_pub_ =
+      node->create_publisher<nav2_msgs::msg::CostmapCompressedUpdate>(
+      topic_name + "_raw_compressed_updates", custom_qos);
+  }
 
   // Create a service that will use the callback function to handle requests.
   costmap_service_ = node->create_service<nav2_msgs::srv::GetCostmap>(
@@ -130,62 +141,68 @@ void Costmap2DPublisher::updateGridParams()
 // prepare grid_ message for publication.
 void Costmap2DPublisher::prepareGrid()
 {
-  std::unique_lock<Costmap2D::mutex_t> lock(*(costmap_->getMutex()));
-
   grid_ = std::make_unique<nav_msgs::msg::OccupancyGrid>();
+  fillGrid(*grid_);
+}
+
+void Costmap2DPublisher::fillGrid(nav_msgs::msg::OccupancyGrid & grid)
+{
+  std::unique_lock<Costmap2D::mutex_t> lock(*(costmap_->getMutex()));
 
-  grid_->header.frame_id = global_frame_;
-  grid_->header.stamp = clock_->now();
+  grid.header.frame_id = global_frame_;
+  grid.header.stamp = clock_->now();
 
-  grid_->info.resolution = grid_resolution_;
+  grid.info.resolution = grid_resolution_;
 
-  grid_->info.width = grid_width_;
-  grid_->info.height = grid_height_;
+  grid.info.width = grid_width_;
+  grid.info.height = grid_height_;
 
   double wx, wy;
   costmap_->mapToWorld(0, 0, wx, wy);
-  grid_->info.origin.position.x = wx - grid_resolution_ / 2;
-  grid_->info.origin.position.y = wy - grid_resolution_ / 2;
-  grid_->info.origin.position.z = 0.0;
-  grid_->info.origin.orientation.w = 1.0;
-
-  grid_->data.resize(grid_->info.width * grid_->info.height);
-
-  unsigned char * data = costmap_->getCharMap();
-  for (unsigned int i = 0; i < grid_->data.size(); i++) {
-    grid_->data[i] = cost_translation_table_[data[i]];
-  }
+  grid.info.origin.position.x = wx - grid_resolution_ / 2;
+  grid.info.origin.position.y = wy - grid_resolution_ / 2;
+  grid.info.origin.position.z = 0.0;
+  grid.info.origin.orientation.w = 1.0;
+
+  grid.data.resize(grid.info.width * grid.info.height);
+
+  // Single pass translation straight into the message buffer
+  const unsigned char * data = costmap_->getCharMap();
+  std::transform(
+    data, data + grid.data.size(), grid.data.begin(),
+    [](unsigned char cost) {return cost_translation_table_[cost];});
 }
 
 void Costmap2DPublisher::prepareCostmap()
+{
+  costmap_raw_ = std::make_unique<nav2_msgs::msg::Costmap>();
+  fillCostmap(*costmap_raw_);
+}
+
+void Costmap2DPublisher::fillCostmap(nav2_msgs::msg::Costmap & costmap)
 {
   std::unique_lock<Costmap2D::mutex_t> lock(*(costmap_->getMutex()));
   double resolution = costmap_->getResolution();
 
-  costmap_raw_ = std::make_unique<nav2_msgs::msg::Costmap>();
-
-  costmap_raw_->header.frame_id = global_frame_;
-  costmap_raw_->header.stamp = clock_->now();
+  costmap.header.frame_id = global_frame_;
+  costmap.header.stamp = clock_->now();
 
-  costmap_raw_->metadata.layer = "master";
-  costmap_raw_->metadata.resolution = resolution;
+  costmap.metadata.layer = "master";
+  costmap.metadata.resolution = resolution;
 
-  costmap_raw_->metadata.size_x = costmap_->getSizeInCellsX();
-  costmap_raw_->metadata.size_y = costmap_->getSizeInCellsY();
+  costmap.metadata.size_x = costmap_->getSizeInCellsX();
+  costmap.metadata.size_y = costmap_->getSizeInCellsY();
 
   double wx, wy;
   costmap_->mapToWorld(0, 0, wx, wy);
-  costmap_raw_->metadata.origin.position.x = wx - resolution / 2;
-  costmap_raw_->metadata.origin.position.y = wy - resolution / 2;
-  costmap_raw_->metadata.origin.position.z = 0.0;
-  costmap_raw_->metadata.origin.orientation.w = 1.0;
-
-  costmap_raw_->data.resize(costmap_raw_->metadata.size_x * costmap_raw_->metadata.size_y);
-
-  unsigned char * data = costmap_->getCharMap();
-  for (unsigned int i = 0; i < costmap_raw_->data.size(); i++) {
-    costmap_raw_->data[i] = data[i];
-  }
+  costmap.metadata.origin.position.x = wx - resolution / 2;
+  costmap.metadata.origin.position.y = wy - resolution / 2;
+  costmap.metadata.origin.position.z = 0.0;
+  costmap.metadata.origin.orientation.w = 1.0;
+
+  // Raw costs need no translation, so copy the grid as one block
+  const unsigned char * data = costmap_->getCharMap();
+  costmap.data.assign(data, data + costmap.metadata.size_x * costmap.metadata.size_y);
 }
 
 std::unique_ptr<map_msgs::msg::OccupancyGridUpdate> Costmap2DPublisher::createGridUpdateMsg()
@@ -200,11 +217,12 @@ std::unique_ptr<map_msgs::msg::OccupancyGridUpdate> Costmap2DPublisher::createGr
   update->height = yn_ - y0_;
   update->data.resize(update->width * update->height);
 
-  std::uint32_t i = 0;
+  const unsigned char * data = costmap_->getCharMap();
+  const unsigned int size_x = costmap_->getSizeInCellsX();
   for (std::uint32_t y = y0_; y < yn_; y++) {
-    for (std::uint32_t x = x0_; x < xn_; x++) {
-      update->data[i++] = cost_translation_table_[costmap_->getCost(x, y)];
-    }
+    translateRow(
+      update->data.data() + (y - y0_) * update->width, data + y * size_x + x0_,
+      cost_translation_table_, update->width);
   }
   return update;
 }
@@ -221,11 +239,12 @@ std::unique_ptr<nav2_msgs::msg::CostmapUpdate> Costmap2DPublisher::createCostmap
   msg->size_y = yn_ - y0_;
   msg->data.resize(msg->size_x * msg->size_y);
 
-  std::uint32_t i = 0;
+  // Raw costs need no translation, so copy the window row by row
+  const unsigned char * data = costmap_->getCharMap();
+  const unsigned int size_x = costmap_->getSizeInCellsX();
   for (std::uint32_t y = y0_; y < yn_; y++) {
-    for (std::uint32_t x = x0_; x < xn_; x++) {
-      msg->data[i++] = costmap_->getCost(x, y);
-    }
+    memcpy(
+      msg->data.data() + (y - y0_) * msg->size_x, data + y * size_x + x0_, msg->size_x);
   }
   return msg;
 }
@@ -240,14 +259,30 @@ void Costmap2DPublisher::publishCostmap()
     saved_origin_y_ != costmap_->getOriginY())
   {
     updateGridParams();
+    // Write straight into middleware owned memory when the transport supports
+    // loaning, otherwise hand over ownership so intra-process subscribers
+    // receive the message without a further copy
     if (costmap_pub_->get_subscription_count() > 0) {
-      prepareGrid();
-      costmap_pub_->publish(std::move(grid_));
+      if (costmap_pub_->can_loan_messages()) {
+        auto loaned_grid = costmap_pub_->borrow_loaned_message();
+        fillGrid(loaned_grid.get());
+        costmap_pub_->publish(std::move(loaned_grid));
+      } else {
+        prepareGrid();
+        costmap_pub_->publish(std::move(grid_));
+      }
     }
     if (costmap_raw_pub_->get_subscription_count() > 0) {
-      prepareCostmap();
-      costmap_raw_pub_->publish(std::move(costmap_raw_));
+      if (costmap_raw_pub_->can_loan_messages()) {
+        auto loaned_costmap = costmap_raw_pub_->borrow_loaned_message();
+        fillCostmap(loaned_costmap.get());
+        costmap_raw_pub_->publish(std::move(loaned_costmap));
+      } else {
+        prepareCostmap();
+        costmap_raw_pub_->publish(std::move(costmap_raw_));
+      }
     }
+    publishCompressedUpdate(true);
   } else if (x0_ < xn_) {
     // Publish just update msgs
     std::unique_lock<Costmap2D::mutex_t> lock(*(costmap_->getMutex()));
@@ -257,6 +292,10 @@ void Costmap2DPublisher::publishCostmap()
     if (costmap_raw_update_pub_->get_subscription_count() > 0) {
       costmap_raw_update_pub_->publish(createCostmapUpdateMsg());
     }
+    publishCompressedUpdate(false);
+  } else if (keyframe_interval_ > 0 && deltas_since_keyframe_ >= keyframe_interval_) {
+    // Nothing changed, but late joiners still need a periodic keyframe
+    publishCompressedUpdate(true);
   }
 
   xn_ = yn_ = 0;
@@ -264,6 +303,86 @@ void Costmap2DPublisher::publishCostmap()
   y0_ = costmap_->getSizeInCellsY();
 }
 
+void Costmap2DPublisher::publishCompressedUpdate(bool force_keyframe)
+{
+  if (!costmap_compressed_update_pub_) {
+    return;
+  }
+  if (costmap_compressed_update_pub_->get_subscription_count() == 0) {
+    // Deltas are not tracked without subscribers, start over with a keyframe
+    had_compressed_subscribers_ = false;
+    return;
+  }
+
+  std::unique_lock<Costmap2D::mutex_t> lock(*(costmap_->getMutex()));
+  const unsigned int size_x = costmap_->getSizeInCellsX();
+  const unsigned int size_y = costmap_->getSizeInCellsY();
+  const size_t size = static_cast<size_t>(size_x) * size_y;
+  const unsigned char * data = costmap_->getCharMap();
+
+  auto msg = std::make_unique<nav2_msgs::msg::CostmapCompressedUpdate>();
+  msg->header.stamp = clock_->now();
+  msg->header.frame_id = global_frame_;
+  msg->sequence = ++compressed_sequence_;
+
+  const unsigned char * patch;
+  size_t patch_size;
+  if (force_keyframe || !had_compressed_subscribers_ ||
+    compressed_reference_.size() != size ||
+    (keyframe_interval_ > 0 && deltas_since_keyframe_ >= keyframe_interval_))
+  {
+    msg->keyframe = true;
+    msg->metadata.layer = "master";
+    msg->metadata.resolution = costmap_->getResolution();
+    msg->metadata.size_x = size_x;
+    msg->metadata.size_y = size_y;
+    msg->metadata.update_time = msg->header.stamp;
+    msg->metadata.origin.position.x = costmap_->getOriginX();
+    msg->metadata.origin.position.y = costmap_->getOriginY();
+    msg->metadata.origin.orientation.w = 1.0;
+    msg->x = 0;
+    msg->y = 0;
+    msg->size_x = size_x;
+    msg->size_y = size_y;
+
+    compressed_reference_.assign(data, data + size);
+    patch = compressed_reference_.data();
+    patch_size = size;
+    deltas_since_keyframe_ = 0;
+    had_compressed_subscribers_ = true;
+  } else {
+    msg->keyframe = false;
+    msg->x = x0_;
+    msg->y = y0_;
+    msg->size_x = xn_ - x0_;
+    msg->size_y = yn_ - y0_;
+
+    // XOR against what subscribers already hold, so unchanged cells form zero runs
+    compressed_delta_.resize(static_cast<size_t>(msg->size_x) * msg->size_y);
+    size_t i = 0;
+    for (unsigned int y = y0_; y < yn_; y++) {
+      const size_t row = static_cast<size_t>(y) * size_x;
+      for (unsigned int x = x0_; x < xn_; x++) {
+        compressed_delta_[i++] = data[row + x] ^ compressed_reference_[row + x];
+        compressed_reference_[row + x] = data[row + x];
+      }
+    }
+    patch = compressed_delta_.data();
+    patch_size = compressed_delta_.size();
+    ++deltas_since_keyframe_;
+  }
+
+  encodeRunLength(patch, patch_size, msg->data);
+  msg->encoding = nav2_msgs::msg::CostmapCompressedUpdate::ENCODING_RLE;
+  if (msg->data.size() >= patch_size) {
+    // Noisy patches may not compress, never send more than the raw costs
+    msg->data.assign(patch, patch + patch_size);
+    msg->encoding = nav2_msgs::msg::CostmapCompressedUpdate::ENCODING_RAW;
+  }
+
+  costmap_compressed_update_pub_->publish(std::move(msg));
+}
+
 void
 Costmap2DPublisher::costmap_service_callback(
   const std::shared_ptr<rmw_request_id_t>/*request_header*/,
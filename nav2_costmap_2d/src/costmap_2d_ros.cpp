@@ -38,12 +38,19 @@
 
 #include "nav2_costmap_2d/costmap_2d_ros.hpp"
 
+#include <algorithm>
 #include <memory>
 #include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
 #include <string>
+#include <thread>
 #include <vector>
 #include <utility>
 
+#include "nav2_costmap_2d/cost_map_file.hpp"
+#include "nav2_costmap_2d/costmap_layer.hpp"
 #include "nav2_costmap_2d/layered_costmap.hpp"
 #include "nav2_util/execution_timer.hpp"
 #include "nav2_util/node_utils.hpp"
@@ -79,7 +86,8 @@ Costmap2DROS::Costmap2DROS(
   const std::string & name,
   const std::string & parent_namespace,
   const std::string & local_namespace,
-  const bool & use_sim_time)
+  const bool & use_sim_time,
+  const bool & use_intra_process_comms)
 : nav2_util::LifecycleNode(name, "",
     // NodeOption arguments take precedence over the ones provided on the command line
     // use this to make sure the node is placed on the provided namespace
@@ -90,7 +98,7 @@ Costmap2DROS::Costmap2DROS(
     nav2_util::add_namespaces(parent_namespace, local_namespace),
     "--ros-args", "-r", name + ":" + std::string("__node:=") + name,
     "--ros-args", "-p", "use_sim_time:=" + std::string(use_sim_time ? "true" : "false"),
-  })),
+  }).use_intra_process_comms(use_intra_process_comms)),
   name_(name),
   parent_namespace_(parent_namespace),
   default_plugins_{"static_layer", "obstacle_layer", "inflation_layer"},
@@ -116,22 +124,35 @@ void Costmap2DROS::init()
   declare_parameter("height", rclcpp::ParameterValue(5));
   declare_parameter("width", rclcpp::ParameterValue(5));
   declare_parameter("lethal_cost_threshold", rclcpp::ParameterValue(100));
+  declare_parameter("min_update_frequency", rclcpp::ParameterValue(0.2));
+  declare_parameter("compressed_keyframe_interval", rclcpp::ParameterValue(10));
+  declare_parameter("event_driven_updates", rclcpp::ParameterValue(false));
   declare_parameter("observation_sources", rclcpp::ParameterValue(std::string("")));
   declare_parameter("origin_x", rclcpp::ParameterValue(0.0));
   declare_parameter("origin_y", rclcpp::ParameterValue(0.0));
+  declare_parameter("parallel_update_threads", rclcpp::ParameterValue(0));
   declare_parameter("plugins", rclcpp::ParameterValue(default_plugins_));
   declare_parameter("filters", rclcpp::ParameterValue(std::vector<std::string>()));
   declare_parameter("publish_frequency", rclcpp::ParameterValue(1.0));
+  declare_parameter("publish_compressed_updates", rclcpp::ParameterValue(false));
+  declare_parameter("publish_update_time", rclcpp::ParameterValue(false));
+  declare_parameter("pyramid_levels", rclcpp::ParameterValue(0));
   declare_parameter("resolution", rclcpp::ParameterValue(0.1));
   declare_parameter("robot_base_frame", rclcpp::ParameterValue(std::string("base_link")));
+  declare_parameter("robot_pose_cache_period", rclcpp::ParameterValue(0.0));
   declare_parameter("robot_radius", rclcpp::ParameterValue(0.1));
   declare_parameter("rolling_window", rclcpp::ParameterValue(false));
+  declare_parameter("state_persistence_directory", rclcpp::ParameterValue(std::string("")));
+  declare_parameter("state_save_period", rclcpp::ParameterValue(0.0));
   declare_parameter("track_unknown_space", rclcpp::ParameterValue(false));
   declare_parameter("transform_tolerance", rclcpp::ParameterValue(0.3));
   declare_parameter("initial_transform_timeout", rclcpp::ParameterValue(60.0));
   declare_parameter("trinary_costmap", rclcpp::ParameterValue(true));
   declare_parameter("unknown_cost_value", rclcpp::ParameterValue(static_cast<unsigned char>(0xff)));
+  declare_parameter("update_angle_threshold", rclcpp::ParameterValue(0.05));
+  declare_parameter("update_distance_threshold", rclcpp::ParameterValue(0.05));
   declare_parameter("update_frequency", rclcpp::ParameterValue(5.0));
+  declare_parameter("update_tile_size", rclcpp::ParameterValue(0));
   declare_parameter("use_maximum", rclcpp::ParameterValue(false));
 }
 
@@ -164,6 +185,35 @@ Costmap2DROS::on_configure(const rclcpp_lifecycle::State & /*state*/)
       (unsigned int)(map_height_meters_ / resolution_), resolution_, origin_x_, origin_y_);
   }
 
+  if (parallel_update_threads_ < 0) {
+    RCLCPP_WARN(
+      get_logger(), "parallel_update_threads must be non-negative, disabling parallel updates");
+    parallel_update_threads_ = 0;
+  }
+  layered_costmap_->setParallelUpdates(static_cast<unsigned int>(parallel_update_threads_));
+
+  if (update_tile_size_ < 0) {
+    RCLCPP_WARN(
+      get_logger(), "update_tile_size must be non-negative, disabling tiled updates");
+    update_tile_size_ = 0;
+  }
+  layered_costmap_->setTiledUpdates(static_cast<unsigned int>(update_tile_size_));
+
+  if (event_driven_updates_) {
+    layered_costmap_->setUpdateRequestCallback(
+      std::bind(&Costmap2DROS::requestMapUpdate, this));
+  }
+
+  if (pyramid_levels_ < 0) {
+    RCLCPP_WARN(
+      get_logger(), "pyramid_levels must be non-negative, disabling the costmap pyramid");
+    pyramid_levels_ = 0;
+  }
+  if (pyramid_levels_ > 0) {
+    costmap_pyramid_ = std::make_unique<CostmapPyramid>(
+      static_cast<unsigned int>(pyramid_levels_));
+  }
+
   // Create the transform-related objects
   tf_buffer_ = std::make_shared<tf2_ros::Buffer>(get_clock());
   auto timer_interface = std::make_shared<tf2_ros::CreateTimerROS>(
@@ -222,10 +272,16 @@ Costmap2DROS::on_configure(const rclcpp_lifecycle::State & /*state*/)
   footprint_pub_ = create_publisher<geometry_msgs::msg::PolygonStamped>(
     "published_footprint", rclcpp::SystemDefaultsQoS());
 
+  if (publish_update_time_) {
+    update_time_pub_ = create_publisher<std_msgs::msg::Float64>(
+      "update_time", rclcpp::SystemDefaultsQoS());
+  }
+
   costmap_publisher_ = std::make_unique<Costmap2DPublisher>(
     shared_from_this(),
     layered_costmap_->getCostmap(), global_frame_,
-    "costmap", always_send_full_costmap_);
+    "costmap", always_send_full_costmap_, publish_compressed_updates_,
+    compressed_keyframe_interval_);
 
   auto layers = layered_costmap_->getPlugins();
 
@@ -236,7 +292,21 @@ Costmap2DROS::on_configure(const rclcpp_lifecycle::State & /*state*/)
         std::make_unique<Costmap2DPublisher>(
           shared_from_this(),
           costmap_layer.get(), global_frame_,
-          layer->getName(), always_send_full_costmap_)
+          layer->getName(), always_send_full_costmap_, publish_compressed_updates_,
+          compressed_keyframe_interval_)
+      );
+    }
+  }
+
+  if (costmap_pyramid_) {
+    for (unsigned int i = 0; i < costmap_pyramid_->getNumLevels(); ++i) {
+      pyramid_publishers_.emplace_back(
+        std::make_unique<Costmap2DPublisher>(
+          shared_from_this(),
+          costmap_pyramid_->getLevel(i), global_frame_,
+          "costmap_x" + std::to_string(CostmapPyramid::getScale(i)),
+          always_send_full_costmap_, publish_compressed_updates_,
+          compressed_keyframe_interval_)
       );
     }
   }
@@ -255,7 +325,8 @@ Costmap2DROS::on_configure(const rclcpp_lifecycle::State & /*state*/)
 
   executor_ = std::make_shared<rclcpp::executors::SingleThreadedExecutor>();
   executor_->add_callback_group(callback_group_, get_node_base_interface());
-  executor_thread_ = std::make_unique<nav2_util::NodeThread>(executor_);
+  executor_thread_ = std::make_unique<nav2_util::NodeThread>(
+    executor_, getThreadSettings("executor_thread"));
   return nav2_util::CallbackReturn::SUCCESS;
 }
 
@@ -302,12 +373,26 @@ Costmap2DROS::on_activate(const rclcpp_lifecycle::State & /*state*/)
 
   // Activate publishers
   footprint_pub_->on_activate();
+  if (update_time_pub_) {
+    update_time_pub_->on_activate();
+  }
   costmap_publisher_->on_activate();
 
   for (auto & layer_pub : layer_publishers_) {
     layer_pub->on_activate();
   }
 
+  for (auto & pyramid_pub : pyramid_publishers_) {
+    pyramid_pub->on_activate();
+  }
+
+  // Resume from the costmaps saved before the last restart, if still valid, so that the
+  // costmap is served without waiting for the first update
+  if (!state_persistence_directory_.empty() && restoreState()) {
+    initialized_ = true;
+  }
+  last_state_save_ = std::chrono::steady_clock::now();
+
   // Create a thread to handle updating the map
   stopped_ = true;  // to active plugins
   stop_updates_ = false;
@@ -335,18 +420,30 @@ Costmap2DROS::on_deactivate(const rclcpp_lifecycle::State & /*state*/)
 
   // Map thread stuff
   map_update_thread_shutdown_ = true;
+  update_request_cv_.notify_all();
 
   if (map_update_thread_->joinable()) {
     map_update_thread_->join();
   }
 
+  if (!state_persistence_directory_.empty()) {
+    saveState();
+  }
+
   footprint_pub_->on_deactivate();
+  if (update_time_pub_) {
+    update_time_pub_->on_deactivate();
+  }
   costmap_publisher_->on_deactivate();
 
   for (auto & layer_pub : layer_publishers_) {
     layer_pub->on_deactivate();
   }
 
+  for (auto & pyramid_pub : pyramid_publishers_) {
+    pyramid_pub->on_deactivate();
+  }
+
   return nav2_util::CallbackReturn::SUCCESS;
 }
 
@@ -360,14 +457,21 @@ Costmap2DROS::on_cleanup(const rclcpp_lifecycle::State & /*state*/)
   clear_costmap_service_.reset();
 
   layer_publishers_.clear();
+  pyramid_publishers_.clear();
 
   layered_costmap_.reset();
+  costmap_pyramid_.reset();
+  {
+    std::lock_guard<std::mutex> lock(costmap_queries_mutex_);
+    costmap_queries_.reset();
+  }
 
   tf_listener_.reset();
   tf_buffer_.reset();
 
   footprint_sub_.reset();
   footprint_pub_.reset();
+  update_time_pub_.reset();
 
   return nav2_util::CallbackReturn::SUCCESS;
 }
@@ -392,15 +496,37 @@ Costmap2DROS::getParameters()
   get_parameter("height", map_height_meters_);
   get_parameter("origin_x", origin_x_);
   get_parameter("origin_y", origin_y_);
+  get_parameter("parallel_update_threads", parallel_update_threads_);
   get_parameter("publish_frequency", map_publish_frequency_);
+  get_parameter("publish_compressed_updates", publish_compressed_updates_);
+  get_parameter("publish_update_time", publish_update_time_);
+  get_parameter("pyramid_levels", pyramid_levels_);
+  int compressed_keyframe_interval = 10;
+  get_parameter("compressed_keyframe_interval", compressed_keyframe_interval);
+  if (compressed_keyframe_interval < 0) {
+    RCLCPP_WARN(
+      get_logger(), "compressed_keyframe_interval must not be negative, keyframes will only "
+      "be sent on map changes and new subscribers");
+    compressed_keyframe_interval = 0;
+  }
+  compressed_keyframe_interval_ = static_cast<unsigned int>(compressed_keyframe_interval);
   get_parameter("resolution", resolution_);
   get_parameter("robot_base_frame", robot_base_frame_);
   get_parameter("robot_radius", robot_radius_);
   get_parameter("rolling_window", rolling_window_);
+  get_parameter("state_persistence_directory", state_persistence_directory_);
+  get_parameter("state_save_period", state_save_period_);
   get_parameter("track_unknown_space", track_unknown_space_);
   get_parameter("transform_tolerance", transform_tolerance_);
+  get_parameter("robot_pose_cache_period", robot_pose_cache_period_);
+  robot_pose_cache_ = nav2_util::RobotPoseCache::get(global_frame_, robot_base_frame_);
   get_parameter("initial_transform_timeout", initial_transform_timeout_);
   get_parameter("update_frequency", map_update_frequency_);
+  get_parameter("event_driven_updates", event_driven_updates_);
+  get_parameter("min_update_frequency", min_update_frequency_);
+  get_parameter("update_distance_threshold", update_distance_threshold_);
+  get_parameter("update_angle_threshold", update_angle_threshold_);
+  get_parameter("update_tile_size", update_tile_size_);
   get_parameter("width", map_width_meters_);
   get_parameter("plugins", plugin_names_);
   get_parameter("filters", filter_names_);
@@ -468,6 +594,7 @@ Costmap2DROS::setRobotFootprint(const std::vector<geometry_msgs::msg::Point> & p
   padded_footprint_ = points;
   padFootprint(padded_footprint_, footprint_padding_);
   layered_costmap_->setFootprint(padded_footprint_);
+  oriented_footprint_cache_.setFootprint(padded_footprint_);
 }
 
 void
@@ -477,6 +604,17 @@ Costmap2DROS::setRobotFootprintPolygon(
   setRobotFootprint(toPointVector(footprint));
 }
 
+CostmapQueries::ConstPtr
+Costmap2DROS::getCostmapQueries()
+{
+  CostmapSnapshot::ConstPtr snapshot = getCostmapSnapshot();
+  std::lock_guard<std::mutex> lock(costmap_queries_mutex_);
+  if (!costmap_queries_ || costmap_queries_->getSnapshot() != snapshot) {
+    costmap_queries_ = std::make_shared<const CostmapQueries>(snapshot, costmap_queries_.get());
+  }
+  return costmap_queries_;
+}
+
 void
 Costmap2DROS::getOrientedFootprint(std::vector<geometry_msgs::msg::Point> & oriented_footprint)
 {
@@ -486,9 +624,8 @@ Costmap2DROS::getOrientedFootprint(std::vector<geometry_msgs::msg::Point> & orie
   }
 
   double yaw = tf2::getYaw(global_pose.pose.orientation);
-  transformFootprint(
-    global_pose.pose.position.x, global_pose.pose.position.y, yaw,
-    padded_footprint_, oriented_footprint);
+  oriented_footprint_cache_.getOrientedFootprint(
+    global_pose.pose.position.x, global_pose.pose.position.y, yaw, oriented_footprint);
 }
 
 void
@@ -513,19 +650,35 @@ Costmap2DROS::mapUpdateLoop(double frequency)
       // Lock while modifying layered costmap and publishing values
       std::scoped_lock<std::mutex> lock(_dynamic_parameter_mutex);
 
-      // Measure the execution time of the updateMap method
-      timer.start();
-      updateMap();
-      timer.end();
+      // In event driven mode, skip the cycles where nothing changed
+      const bool update = !event_driven_updates_ || isMapUpdateDue();
+      if (update) {
+        // Measure the execution time of the updateMap method
+        timer.start();
+        updateMap();
+        timer.end();
+        RCLCPP_DEBUG(get_logger(), "Map update time: %.9f", timer.elapsed_time_in_seconds());
+        if (update_time_pub_) {
+          auto update_time = std::make_unique<std_msgs::msg::Float64>();
+          update_time->data = timer.elapsed_time_in_seconds();
+          update_time_pub_->publish(std::move(update_time));
+        }
+      }
 
-      RCLCPP_DEBUG(get_logger(), "Map update time: %.9f", timer.elapsed_time_in_seconds());
       if (publish_cycle_ > rclcpp::Duration(0s) && layered_costmap_->isInitialized()) {
-        unsigned int x0, y0, xn, yn;
-        layered_costmap_->getBounds(&x0, &xn, &y0, &yn);
-        costmap_publisher_->updateBounds(x0, xn, y0, yn);
+        if (update) {
+          unsigned int x0, y0, xn, yn;
+          layered_costmap_->getBounds(&x0, &xn, &y0, &yn);
+          costmap_publisher_->updateBounds(x0, xn, y0, yn);
+
+          for (auto & layer_pub : layer_publishers_) {
+            layer_pub->updateBounds(x0, xn, y0, yn);
+          }
 
-        for (auto & layer_pub : layer_publishers_) {
-          layer_pub->updateBounds(x0, xn, y0, yn);
+          for (unsigned int i = 0; i < pyramid_publishers_.size(); ++i) {
+            const CellRegion & region = costmap_pyramid_->getUpdatedRegion(i);
+            pyramid_publishers_[i]->updateBounds(region.x0, region.xn, region.y0, region.yn);
+          }
         }
 
         auto current_time = now();
@@ -540,13 +693,30 @@ Costmap2DROS::mapUpdateLoop(double frequency)
             layer_pub->publishCostmap();
           }
 
+          for (auto & pyramid_pub : pyramid_publishers_) {
+            pyramid_pub->publishCostmap();
+          }
+
           last_publish_ = current_time;
         }
       }
+
+      if (state_save_period_ > 0.0 && !state_persistence_directory_.empty() &&
+        layered_costmap_->isInitialized() &&
+        std::chrono::steady_clock::now() - last_state_save_ >=
+        std::chrono::duration<double>(state_save_period_))
+      {
+        saveState();
+        last_state_save_ = std::chrono::steady_clock::now();
+      }
     }
 
     // Make sure to sleep for the remainder of our cycle time
-    r.sleep();
+    if (event_driven_updates_) {
+      waitForMapUpdateRequest(r.period());
+    } else {
+      r.sleep();
+    }
 
 #if 0
     // TODO(bpwilcox): find ROS2 equivalent or port for r.cycletime()
@@ -560,11 +730,197 @@ Costmap2DROS::mapUpdateLoop(double frequency)
   }
 }
 
+void
+Costmap2DROS::requestMapUpdate()
+{
+  {
+    std::lock_guard<std::mutex> lock(update_request_mutex_);
+    update_requested_ = true;
+  }
+  update_request_cv_.notify_one();
+}
+
+bool
+Costmap2DROS::isMapUpdateDue()
+{
+  bool requested = false;
+  {
+    std::lock_guard<std::mutex> lock(update_request_mutex_);
+    std::swap(requested, update_requested_);
+  }
+
+  if (requested || !initialized_ || !has_last_update_pose_) {
+    return true;
+  }
+
+  if (min_update_frequency_ > 0.0 &&
+    std::chrono::steady_clock::now() - last_update_time_ >=
+    std::chrono::duration<double>(1.0 / min_update_frequency_))
+  {
+    return true;
+  }
+
+  geometry_msgs::msg::PoseStamped pose;
+  if (!getRobotPose(pose)) {
+    return false;
+  }
+
+  const double dx = pose.pose.position.x - last_update_x_;
+  const double dy = pose.pose.position.y - last_update_y_;
+  const double dyaw = std::remainder(
+    tf2::getYaw(pose.pose.orientation) - last_update_yaw_, 2.0 * M_PI);
+  return std::hypot(dx, dy) >= update_distance_threshold_ ||
+         std::fabs(dyaw) >= update_angle_threshold_;
+}
+
+void
+Costmap2DROS::waitForMapUpdateRequest(std::chrono::nanoseconds period)
+{
+  // Never update faster than update_frequency, even if requests keep coming
+  std::this_thread::sleep_until(
+    std::min(
+      last_update_time_ + period,
+      std::chrono::steady_clock::now() + period));
+
+  // Wake up on a request, or after one period to check the robot motion
+  std::unique_lock<std::mutex> lock(update_request_mutex_);
+  update_request_cv_.wait_for(
+    lock, period, [this]() {return update_requested_ || map_update_thread_shutdown_;});
+}
+
+std::string
+Costmap2DROS::getStateFilePath(const std::string & layer_name) const
+{
+  std::string file_name = layer_name.empty() ? name_ : name_ + "_" + layer_name;
+  std::replace(file_name.begin(), file_name.end(), '/', '_');
+  return state_persistence_directory_ + "/" + file_name + ".cmap";
+}
+
+uint32_t
+Costmap2DROS::getStaticMapHash(bool & ready)
+{
+  ready = true;
+  uint32_t hash = 0;
+  for (auto & plugin : *layered_costmap_->getPlugins()) {
+    auto layer = std::dynamic_pointer_cast<CostmapLayer>(plugin);
+    if (!layer || !layer->isStaticMap()) {
+      continue;
+    }
+    if (!layer->isMapReady()) {
+      ready = false;
+      return 0;
+    }
+    std::unique_lock<Costmap2D::mutex_t> lock(*(layer->getMutex()));
+    const size_t size =
+      static_cast<size_t>(layer->getSizeInCellsX()) * layer->getSizeInCellsY();
+    hash = hash == 0 ? hashCosts(layer->getCharMap(), size) :
+      hashCosts(layer->getCharMap(), size, hash);
+  }
+  return hash;
+}
+
+void
+Costmap2DROS::saveState()
+{
+  bool ready;
+  const uint32_t map_hash = getStaticMapHash(ready);
+  if (!ready) {
+    return;
+  }
+
+  // Written aside then renamed, so that a crash never leaves a partial state file
+  auto save = [&](const std::string & path, Costmap2D & costmap) {
+      const std::string tmp_path = path + ".tmp";
+      std::unique_lock<Costmap2D::mutex_t> lock(*(costmap.getMutex()));
+      if (!saveCostMapFile(tmp_path, costmap, global_frame_, map_hash) ||
+        std::rename(tmp_path.c_str(), path.c_str()) != 0)
+      {
+        RCLCPP_WARN(get_logger(), "Failed to save the costmap state to %s", path.c_str());
+        std::remove(tmp_path.c_str());
+      }
+    };
+
+  save(getStateFilePath(""), *layered_costmap_->getCostmap());
+  for (auto & plugin : *layered_costmap_->getPlugins()) {
+    auto layer = std::dynamic_pointer_cast<CostmapLayer>(plugin);
+    if (layer && !layer->isStaticMap()) {
+      save(getStateFilePath(layer->getName()), *layer);
+    }
+  }
+  RCLCPP_DEBUG(get_logger(), "Saved the costmap state of %s", name_.c_str());
+}
+
+bool
+Costmap2DROS::restoreCostmap(const std::string & path, Costmap2D & costmap, uint32_t map_hash)
+{
+  MappedCostMapFile file;
+  std::string error;
+  if (!file.open(path, error)) {
+    RCLCPP_DEBUG(
+      get_logger(), "No costmap state restored from %s: %s", path.c_str(), error.c_str());
+    return false;
+  }
+
+  std::unique_lock<Costmap2D::mutex_t> lock(*(costmap.getMutex()));
+  const CostMapFileHeader & header = file.getHeader();
+  if (header.size_x != costmap.getSizeInCellsX() || header.size_y != costmap.getSizeInCellsY() ||
+    header.resolution != costmap.getResolution() || header.origin_x != costmap.getOriginX() ||
+    header.origin_y != costmap.getOriginY() || header.map_hash != map_hash ||
+    strncmp(header.frame_id, global_frame_.c_str(), sizeof(header.frame_id)) != 0)
+  {
+    RCLCPP_INFO(
+      get_logger(), "Costmap state %s is outdated for the current map, not restored",
+      path.c_str());
+    return false;
+  }
+
+  memcpy(
+    costmap.getCharMap(), file.getData(),
+    static_cast<size_t>(header.size_x) * header.size_y);
+  return true;
+}
+
+bool
+Costmap2DROS::restoreState()
+{
+  bool ready;
+  const uint32_t map_hash = getStaticMapHash(ready);
+  if (!ready) {
+    RCLCPP_INFO(
+      get_logger(), "Static map not received yet, not restoring the costmap state");
+    return false;
+  }
+
+  for (auto & plugin : *layered_costmap_->getPlugins()) {
+    auto layer = std::dynamic_pointer_cast<CostmapLayer>(plugin);
+    if (layer && !layer->isStaticMap() &&
+      restoreCostmap(getStateFilePath(layer->getName()), *layer, map_hash))
+    {
+      // Have the restored grid combined into the master costmap on the first update
+      layer->addExtraBounds(
+        layer->getOriginX(), layer->getOriginY(),
+        layer->getOriginX() + layer->getSizeInCellsX() * layer->getResolution(),
+        layer->getOriginY() + layer->getSizeInCellsY() * layer->getResolution());
+    }
+  }
+
+  if (!restoreCostmap(getStateFilePath(""), *layered_costmap_->getCostmap(), map_hash)) {
+    return false;
+  }
+  RCLCPP_INFO(get_logger(), "Restored the costmap state of %s", name_.c_str());
+  return true;
+}
+
 void
 Costmap2DROS::updateMap()
 {
   RCLCPP_DEBUG(get_logger(), "Updating map...");
 
+  // Apply clear requests between updates so they never race a layer update
+  if (clear_costmap_service_) {
+    clear_costmap_service_->applyPendingClears();
+  }
+
   if (!stop_updates_) {
     // get global pose
     geometry_msgs::msg::PoseStamped pose;
@@ -573,6 +929,19 @@ Costmap2DROS::updateMap()
       const double & y = pose.pose.position.y;
       const double yaw = tf2::getYaw(pose.pose.orientation);
       layered_costmap_->updateMap(x, y, yaw);
+      last_update_x_ = x;
+      last_update_y_ = y;
+      last_update_yaw_ = yaw;
+      last_update_time_ = std::chrono::steady_clock::now();
+      has_last_update_pose_ = true;
+
+      if (costmap_pyramid_ && layered_costmap_->isInitialized()) {
+        Costmap2D * costmap = layered_costmap_->getCostmap();
+        std::unique_lock<Costmap2D::mutex_t> lock(*(costmap->getMutex()));
+        unsigned int x0, y0, xn, yn;
+        layered_costmap_->getBounds(&x0, &xn, &y0, &yn);
+        costmap_pyramid_->update(*costmap, x0, xn, y0, yn);
+      }
 
       auto footprint = std::make_unique<geometry_msgs::msg::PolygonStamped>();
       footprint->header = pose.header;
@@ -688,6 +1057,10 @@ Costmap2DROS::resetLayers()
 bool
 Costmap2DROS::getRobotPose(geometry_msgs::msg::PoseStamped & global_pose)
 {
+  if (robot_pose_cache_period_ > 0.0 && robot_pose_cache_) {
+    return robot_pose_cache_->getPose(
+      *tf_buffer_, global_pose, transform_tolerance_, robot_pose_cache_period_);
+  }
   return nav2_util::getCurrentPose(
     global_pose, *tf_buffer_,
     global_frame_, robot_base_frame_, transform_tolerance_);
@@ -731,8 +1104,11 @@ Costmap2DROS::dynamicParametersCallback(std::vector<rclcpp::Parameter> parameter
         padded_footprint_ = unpadded_footprint_;
         padFootprint(padded_footprint_, footprint_padding_);
         layered_costmap_->setFootprint(padded_footprint_);
+        oriented_footprint_cache_.setFootprint(padded_footprint_);
       } else if (name == "transform_tolerance") {
         transform_tolerance_ = parameter.as_double();
+      } else if (name == "robot_pose_cache_period") {
+        robot_pose_cache_period_ = parameter.as_double();
       } else if (name == "publish_frequency") {
         map_publish_frequency_ = parameter.as_double();
         if (map_publish_frequency_ > 0) {
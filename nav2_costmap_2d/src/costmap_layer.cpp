@@ -40,6 +40,8 @@
 #include <stdexcept>
 #include <algorithm>
 
+#include "nav2_costmap_2d/cost_combination.hpp"
+
 namespace nav2_costmap_2d
 {
 
@@ -118,21 +120,13 @@ void CostmapLayer::updateWithMax(
 
   unsigned char * master_array = master_grid.getCharMap();
   unsigned int span = master_grid.getSizeInCellsX();
+  if (max_i <= min_i) {
+    return;
+  }
 
   for (int j = min_j; j < max_j; j++) {
     unsigned int it = j * span + min_i;
-    for (int i = min_i; i < max_i; i++) {
-      if (costmap_[it] == NO_INFORMATION) {
-        it++;
-        continue;
-      }
-
-      unsigned char old_cost = master_array[it];
-      if (old_cost == NO_INFORMATION || old_cost < costmap_[it]) {
-        master_array[it] = costmap_[it];
-      }
-      it++;
-    }
+    combineRowMax(master_array + it, costmap_ + it, max_i - min_i);
   }
 }
 
@@ -147,21 +141,13 @@ void CostmapLayer::updateWithMaxWithoutUnknownOverwrite(
 
   unsigned char * master_array = master_grid.getCharMap();
   unsigned int span = master_grid.getSizeInCellsX();
+  if (max_i <= min_i) {
+    return;
+  }
 
   for (int j = min_j; j < max_j; j++) {
     unsigned int it = j * span + min_i;
-    for (int i = min_i; i < max_i; i++) {
-      if (costmap_[it] == NO_INFORMATION) {
-        it++;
-        continue;
-      }
-
-      unsigned char old_cost = master_array[it];
-      if (old_cost != NO_INFORMATION && old_cost < costmap_[it]) {
-        master_array[it] = costmap_[it];
-      }
-      it++;
-    }
+    combineRowMaxWithoutUnknownOverwrite(master_array + it, costmap_ + it, max_i - min_i);
   }
 }
 
@@ -181,13 +167,13 @@ void CostmapLayer::updateWithTrueOverwrite(
 
   unsigned char * master = master_grid.getCharMap();
   unsigned int span = master_grid.getSizeInCellsX();
+  if (max_i <= min_i) {
+    return;
+  }
 
   for (int j = min_j; j < max_j; j++) {
     unsigned int it = span * j + min_i;
-    for (int i = min_i; i < max_i; i++) {
-      master[it] = costmap_[it];
-      it++;
-    }
+    combineRowTrueOverwrite(master + it, costmap_ + it, max_i - min_i);
   }
 }
 
@@ -200,15 +186,13 @@ void CostmapLayer::updateWithOverwrite(
   }
   unsigned char * master = master_grid.getCharMap();
   unsigned int span = master_grid.getSizeInCellsX();
+  if (max_i <= min_i) {
+    return;
+  }
 
   for (int j = min_j; j < max_j; j++) {
     unsigned int it = span * j + min_i;
-    for (int i = min_i; i < max_i; i++) {
-      if (costmap_[it] != NO_INFORMATION) {
-        master[it] = costmap_[it];
-      }
-      it++;
-    }
+    combineRowOverwrite(master + it, costmap_ + it, max_i - min_i);
   }
 }
 
@@ -221,28 +205,13 @@ void CostmapLayer::updateWithAddition(
   }
   unsigned char * master_array = master_grid.getCharMap();
   unsigned int span = master_grid.getSizeInCellsX();
+  if (max_i <= min_i) {
+    return;
+  }
 
   for (int j = min_j; j < max_j; j++) {
     unsigned int it = j * span + min_i;
-    for (int i = min_i; i < max_i; i++) {
-      if (costmap_[it] == NO_INFORMATION) {
-        it++;
-        continue;
-      }
-
-      unsigned char old_cost = master_array[it];
-      if (old_cost == NO_INFORMATION) {
-        master_array[it] = costmap_[it];
-      } else {
-        int sum = old_cost + costmap_[it];
-        if (sum >= nav2_costmap_2d::INSCRIBED_INFLATED_OBSTACLE) {
-          master_array[it] = nav2_costmap_2d::INSCRIBED_INFLATED_OBSTACLE - 1;
-        } else {
-          master_array[it] = sum;
-        }
-      }
-      it++;
-    }
+    combineRowAddition(master_array + it, costmap_ + it, max_i - min_i);
   }
 }
 
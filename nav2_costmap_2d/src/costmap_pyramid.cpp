@@ -0,0 +1,122 @@
+// Copyright (c) 2024 Open Navigation LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "nav2_costmap_2d/costmap_pyramid.hpp"
+
+#include <algorithm>
+#include <mutex>
+
+namespace nav2_costmap_2d
+{
+
+CostmapPyramid::CostmapPyramid(unsigned int num_levels)
+: updated_(num_levels, CellRegion{0, 0, 0, 0})
+{
+  levels_.reserve(num_levels);
+  for (unsigned int i = 0; i < num_levels; ++i) {
+    levels_.push_back(std::make_unique<Costmap2D>());
+  }
+}
+
+bool CostmapPyramid::matches(const Costmap2D & costmap) const
+{
+  return size_x_ == costmap.getSizeInCellsX() && size_y_ == costmap.getSizeInCellsY() &&
+         resolution_ == costmap.getResolution() &&
+         origin_x_ == costmap.getOriginX() && origin_y_ == costmap.getOriginY();
+}
+
+void CostmapPyramid::rebuild(const Costmap2D & costmap)
+{
+  size_x_ = costmap.getSizeInCellsX();
+  size_y_ = costmap.getSizeInCellsY();
+  resolution_ = costmap.getResolution();
+  origin_x_ = costmap.getOriginX();
+  origin_y_ = costmap.getOriginY();
+
+  unsigned int size_x = size_x_;
+  unsigned int size_y = size_y_;
+  for (unsigned int i = 0; i < levels_.size(); ++i) {
+    std::unique_lock<Costmap2D::mutex_t> lock(*(levels_[i]->getMutex()));
+    size_x = (size_x + 1) / 2;
+    size_y = (size_y + 1) / 2;
+    levels_[i]->resizeMap(size_x, size_y, resolution_ * getScale(i), origin_x_, origin_y_);
+  }
+
+  update(costmap, 0, size_x_, 0, size_y_);
+}
+
+void CostmapPyramid::update(
+  const Costmap2D & costmap,
+  unsigned int x0, unsigned int xn, unsigned int y0, unsigned int yn)
+{
+  if (levels_.empty()) {
+    return;
+  }
+  if (!matches(costmap)) {
+    // Rolling windows and resizes shift the 2x2 blocks, so nothing can be reused
+    rebuild(costmap);
+    return;
+  }
+
+  const unsigned char * fine = costmap.getCharMap();
+  unsigned int fine_size_x = size_x_;
+  unsigned int fine_size_y = size_y_;
+  CellRegion region{std::min(x0, size_x_), std::min(y0, size_y_),
+    std::min(xn, size_x_), std::min(yn, size_y_)};
+
+  for (unsigned int i = 0; i < levels_.size(); ++i) {
+    Costmap2D & coarse = *levels_[i];
+    region.x0 /= 2;
+    region.y0 /= 2;
+    region.xn = (region.xn + 1) / 2;
+    region.yn = (region.yn + 1) / 2;
+    if (region.xn <= region.x0 || region.yn <= region.y0) {
+      region = CellRegion{0, 0, 0, 0};
+    } else {
+      std::unique_lock<Costmap2D::mutex_t> lock(*(coarse.getMutex()));
+      pool(fine, fine_size_x, fine_size_y, coarse, region);
+    }
+    updated_[i] = region;
+
+    // Only this thread writes the levels, so the previous level can be read unlocked
+    fine = coarse.getCharMap();
+    fine_size_x = coarse.getSizeInCellsX();
+    fine_size_y = coarse.getSizeInCellsY();
+  }
+}
+
+void CostmapPyramid::pool(
+  const unsigned char * fine, unsigned int fine_size_x, unsigned int fine_size_y,
+  Costmap2D & coarse, const CellRegion & region)
+{
+  unsigned char * grid = coarse.getCharMap();
+  const unsigned int coarse_size_x = coarse.getSizeInCellsX();
+
+  for (unsigned int y = region.y0; y < region.yn; ++y) {
+    const unsigned char * row0 = fine + static_cast<size_t>(2 * y) * fine_size_x;
+    // The last coarse row of an odd sized grid only covers a single fine row
+    const unsigned char * row1 = 2 * y + 1 < fine_size_y ? row0 + fine_size_x : row0;
+    unsigned char * out = grid + static_cast<size_t>(y) * coarse_size_x;
+
+    for (unsigned int x = region.x0; x < region.xn; ++x) {
+      const unsigned int fx0 = 2 * x;
+      const unsigned int fx1 = fx0 + 1 < fine_size_x ? fx0 + 1 : fx0;
+      out[x] = std::max(
+        std::max(row0[fx0], row0[fx1]),
+        std::max(row1[fx0], row1[fx1]));
+    }
+  }
+}
+
+}  // namespace nav2_costmap_2d
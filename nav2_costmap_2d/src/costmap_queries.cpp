@@ -0,0 +1,98 @@
+// Copyright (c) 2024 Open Navigation LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "nav2_costmap_2d/costmap_queries.hpp"
+
+#include <cmath>
+#include <limits>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "nav2_costmap_2d/cost_values.hpp"
+#include "nav2_costmap_2d/distance_transform.hpp"
+
+namespace nav2_costmap_2d
+{
+
+CostmapQueries::CostmapQueries(
+  CostmapSnapshot::ConstPtr snapshot, const CostmapQueries * previous)
+: snapshot_(std::move(snapshot))
+{
+  if (!previous || previous->snapshot_->getResolution() != snapshot_->getResolution()) {
+    return;
+  }
+
+  // The footprint cells are relative to the cell of the pose, so they only depend on
+  // the resolution and may be moved to the new snapshot as they are
+  std::lock_guard<std::mutex> lock(previous->mutex_);
+  footprints_.reserve(previous->footprints_.size());
+  for (const auto & cached : previous->footprints_) {
+    auto checker = std::make_shared<Checker>(*cached.checker);
+    checker->setCostmap(snapshot_);
+    footprints_.push_back(CachedFootprint{cached.footprint, cached.num_headings, checker});
+  }
+}
+
+std::shared_ptr<const CostmapQueries::Checker> CostmapQueries::getFootprintChecker(
+  const Footprint & footprint, unsigned int num_headings) const
+{
+  std::lock_guard<std::mutex> lock(mutex_);
+  for (const auto & cached : footprints_) {
+    if (cached.num_headings == num_headings && cached.footprint == footprint) {
+      return cached.checker;
+    }
+  }
+
+  auto checker = std::make_shared<Checker>(snapshot_);
+  checker->setFootprintCache(footprint, num_headings, false);
+  footprints_.push_back(CachedFootprint{footprint, num_headings, checker});
+  return checker;
+}
+
+void CostmapQueries::costAtPoses(
+  const Footprint & footprint, unsigned int num_headings,
+  const std::vector<geometry_msgs::msg::Pose2D> & poses, std::vector<double> & costs) const
+{
+  getFootprintChecker(footprint, num_headings)->footprintCostsAtPoses(poses, costs);
+}
+
+const std::vector<float> & CostmapQueries::getObstacleDistances() const
+{
+  std::call_once(
+    distances_computed_, [this]() {
+      const unsigned int size_x = snapshot_->getSizeInCellsX();
+      const unsigned int size_y = snapshot_->getSizeInCellsY();
+      const size_t size = static_cast<size_t>(size_x) * size_y;
+      const unsigned char * costs = snapshot_->getCharMap();
+      std::vector<uint8_t> seeds(size);
+      for (size_t i = 0; i < size; i++) {
+        seeds[i] = costs[i] == LETHAL_OBSTACLE;
+      }
+
+      DistanceTransform transform;
+      transform.compute(seeds.data(), size_x, size_y);
+      const std::vector<uint32_t> & squared = transform.getSquaredDistances();
+      const double resolution = snapshot_->getResolution();
+      distances_.resize(size);
+      for (size_t i = 0; i < size; i++) {
+        distances_[i] = squared[i] == DistanceTransform::getInfinity() ?
+        std::numeric_limits<float>::infinity() :
+        static_cast<float>(std::sqrt(static_cast<double>(squared[i])) * resolution);
+      }
+    });
+  return distances_;
+}
+
+}  // namespace nav2_costmap_2d
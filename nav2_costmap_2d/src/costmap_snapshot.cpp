@@ -0,0 +1,91 @@
+// Copyright (c) 2024 Open Navigation LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "nav2_costmap_2d/costmap_snapshot.hpp"
+
+#include <algorithm>
+#include <cstring>
+
+namespace nav2_costmap_2d
+{
+
+void CostmapSnapshot::copyFrom(const Costmap2D & costmap, uint64_t revision)
+{
+  size_x_ = costmap.getSizeInCellsX();
+  size_y_ = costmap.getSizeInCellsY();
+  resolution_ = costmap.getResolution();
+  origin_x_ = costmap.getOriginX();
+  origin_y_ = costmap.getOriginY();
+  revision_ = revision;
+
+  // resize() keeps the existing allocation when the size is unchanged
+  const size_t size = static_cast<size_t>(size_x_) * size_y_;
+  data_.resize(size);
+  if (size > 0) {
+    memcpy(data_.data(), costmap.getCharMap(), size * sizeof(unsigned char));
+  }
+}
+
+bool CostmapSnapshot::worldToMap(
+  double wx, double wy, unsigned int & mx, unsigned int & my) const
+{
+  if (wx < origin_x_ || wy < origin_y_) {
+    return false;
+  }
+
+  mx = static_cast<unsigned int>((wx - origin_x_) / resolution_);
+  my = static_cast<unsigned int>((wy - origin_y_) / resolution_);
+
+  return mx < size_x_ && my < size_y_;
+}
+
+void CostmapSnapshot::mapToWorld(
+  unsigned int mx, unsigned int my, double & wx, double & wy) const
+{
+  wx = origin_x_ + (mx + 0.5) * resolution_;
+  wy = origin_y_ + (my + 0.5) * resolution_;
+}
+
+void CostmapSnapshot::setUpdateHistory(const std::vector<CellRegion> & history)
+{
+  update_history_.assign(history.begin(), history.end());
+}
+
+bool CostmapSnapshot::getChangedBounds(uint64_t revision, CellRegion & bounds) const
+{
+  bounds = CellRegion{0, 0, 0, 0};
+  if (revision > revision_ || revision_ - revision > update_history_.size()) {
+    return false;
+  }
+
+  bool empty = true;
+  for (size_t i = 0; i != revision_ - revision; i++) {
+    const CellRegion & r = update_history_[i];
+    if (r.xn <= r.x0 || r.yn <= r.y0) {
+      continue;
+    }
+    if (empty) {
+      bounds = r;
+      empty = false;
+    } else {
+      bounds.x0 = std::min(bounds.x0, r.x0);
+      bounds.y0 = std::min(bounds.y0, r.y0);
+      bounds.xn = std::max(bounds.xn, r.xn);
+      bounds.yn = std::max(bounds.yn, r.yn);
+    }
+  }
+  return true;
+}
+
+}  // namespace nav2_costmap_2d
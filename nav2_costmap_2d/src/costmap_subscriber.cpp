@@ -17,6 +17,7 @@
 #include <mutex>
 
 #include "nav2_costmap_2d/costmap_subscriber.hpp"
+#include "nav2_costmap_2d/costmap_update_codec.hpp"
 
 namespace nav2_costmap_2d
 {
@@ -25,33 +26,44 @@ constexpr int costmapUpdateQueueDepth = 10;
 
 CostmapSubscriber::CostmapSubscriber(
   const nav2_util::LifecycleNode::WeakPtr & parent,
-  const std::string & topic_name)
+  const std::string & topic_name,
+  bool use_compressed_updates)
 : topic_name_(topic_name)
 {
   auto node = parent.lock();
   logger_ = node->get_logger();
-  costmap_sub_ = node->create_subscription<nav2_msgs::msg::Costmap>(
-    topic_name_,
-    rclcpp::QoS(rclcpp::KeepLast(1)).transient_local().reliable(),
-    std::bind(&CostmapSubscriber::costmapCallback, this, std::placeholders::_1));
-  costmap_update_sub_ = node->create_subscription<nav2_msgs::msg::CostmapUpdate>(
-    topic_name_ + "_updates",
-    rclcpp::QoS(rclcpp::KeepLast(costmapUpdateQueueDepth)).transient_local().reliable(),
-    std::bind(&CostmapSubscriber::costmapUpdateCallback, this, std::placeholders::_1));
+  createSubscriptions(node, use_compressed_updates);
 }
 
 CostmapSubscriber::CostmapSubscriber(
   const rclcpp::Node::WeakPtr & parent,
-  const std::string & topic_name)
+  const std::string & topic_name,
+  bool use_compressed_updates)
 : topic_name_(topic_name)
 {
   auto node = parent.lock();
   logger_ = node->get_logger();
-  costmap_sub_ = node->create_subscription<nav2_msgs::msg::Costmap>(
+  createSubscriptions(node, use_compressed_updates);
+}
+
+template<typename NodeT>
+void CostmapSubscriber::createSubscriptions(const NodeT & node, bool use_compressed_updates)
+{
+  if (use_compressed_updates) {
+    costmap_compressed_update_sub_ =
+      node->template create_subscription<nav2_msgs::msg::CostmapCompressedUpdate>(
+      topic_name_ + "_compressed_updates",
+      rclcpp::QoS(rclcpp::KeepLast(costmapUpdateQueueDepth)).transient_local().reliable(),
+      std::bind(
+        &CostmapSubscriber::costmapCompressedUpdateCallback, this, std::placeholders::_1));
+    return;
+  }
+
+  costmap_sub_ = node->template create_subscription<nav2_msgs::msg::Costmap>(
     topic_name_,
     rclcpp::QoS(rclcpp::KeepLast(1)).transient_local().reliable(),
     std::bind(&CostmapSubscriber::costmapCallback, this, std::placeholders::_1));
-  costmap_update_sub_ = node->create_subscription<nav2_msgs::msg::CostmapUpdate>(
+  costmap_update_sub_ = node->template create_subscription<nav2_msgs::msg::CostmapUpdate>(
     topic_name_ + "_updates",
     rclcpp::QoS(rclcpp::KeepLast(costmapUpdateQueueDepth)).transient_local().reliable(),
     std::bind(&CostmapSubscriber::costmapUpdateCallback, this, std::placeholders::_1));
@@ -121,6 +133,90 @@ void CostmapSubscriber::costmapUpdateCallback(
   }
 }
 
+void CostmapSubscriber::costmapCompressedUpdateCallback(
+  const nav2_msgs::msg::CostmapCompressedUpdate::SharedPtr update_msg)
+{
+  if (update_msg->keyframe) {
+    const auto & metadata = update_msg->metadata;
+    if (!isCostmapReceived()) {
+      costmap_ = std::make_shared<Costmap2D>(
+        metadata.size_x, metadata.size_y, metadata.resolution,
+        metadata.origin.position.x, metadata.origin.position.y);
+    }
+
+    std::lock_guard<Costmap2D::mutex_t> lock(*(costmap_->getMutex()));
+    if (costmap_->getSizeInCellsX() != metadata.size_x ||
+      costmap_->getSizeInCellsY() != metadata.size_y ||
+      costmap_->getResolution() != metadata.resolution ||
+      costmap_->getOriginX() != metadata.origin.position.x ||
+      costmap_->getOriginY() != metadata.origin.position.y)
+    {
+      costmap_->resizeMap(
+        metadata.size_x, metadata.size_y, metadata.resolution,
+        metadata.origin.position.x, metadata.origin.position.y);
+    }
+
+    compressed_synced_ = decodeCompressedPatch(*update_msg, costmap_->getCharMap());
+    last_sequence_ = update_msg->sequence;
+    return;
+  }
+
+  if (!compressed_synced_ || update_msg->sequence != last_sequence_ + 1) {
+    // A delta on top of an unknown state would corrupt the map, wait for a keyframe
+    if (compressed_synced_) {
+      RCLCPP_WARN(logger_, "Missed a compressed costmap update, waiting for the next keyframe");
+    }
+    compressed_synced_ = false;
+    return;
+  }
+  last_sequence_ = update_msg->sequence;
+
+  std::lock_guard<Costmap2D::mutex_t> lock(*(costmap_->getMutex()));
+  auto map_cell_size_x = costmap_->getSizeInCellsX();
+  if (map_cell_size_x < update_msg->x + update_msg->size_x ||
+    costmap_->getSizeInCellsY() < update_msg->y + update_msg->size_y)
+  {
+    RCLCPP_WARN(logger_, "Compressed update area outside of original map area.");
+    compressed_synced_ = false;
+    return;
+  }
+
+  compressed_patch_.resize(static_cast<size_t>(update_msg->size_x) * update_msg->size_y);
+  if (!decodeCompressedPatch(*update_msg, compressed_patch_.data())) {
+    compressed_synced_ = false;
+    return;
+  }
+
+  unsigned char * master_array = costmap_->getCharMap();
+  size_t i = 0;
+  for (size_t y = 0; y < update_msg->size_y; ++y) {
+    unsigned char * row = master_array + (y + update_msg->y) * map_cell_size_x + update_msg->x;
+    for (size_t x = 0; x < update_msg->size_x; ++x) {
+      row[x] ^= compressed_patch_[i++];
+    }
+  }
+}
+
+bool CostmapSubscriber::decodeCompressedPatch(
+  const nav2_msgs::msg::CostmapCompressedUpdate & update_msg, unsigned char * data)
+{
+  const size_t size = static_cast<size_t>(update_msg.size_x) * update_msg.size_y;
+  bool valid = false;
+  if (update_msg.encoding == nav2_msgs::msg::CostmapCompressedUpdate::ENCODING_RLE) {
+    valid = decodeRunLength(update_msg.data, data, size);
+  } else if (update_msg.encoding == nav2_msgs::msg::CostmapCompressedUpdate::ENCODING_RAW) {
+    valid = update_msg.data.size() == size;
+    if (valid) {
+      std::copy(update_msg.data.begin(), update_msg.data.end(), data);
+    }
+  }
+
+  if (!valid) {
+    RCLCPP_WARN(logger_, "Received a malformed compressed costmap update, ignoring it.");
+  }
+  return valid;
+}
+
 void CostmapSubscriber::processCurrentCostmapMsg()
 {
   std::scoped_lock lock(*(costmap_->getMutex()), costmap_msg_mutex_);
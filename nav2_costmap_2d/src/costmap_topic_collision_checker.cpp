@@ -18,6 +18,7 @@
 #include <string>
 #include <vector>
 #include <algorithm>
+#include <cmath>
 #include <iostream>
 
 #include "nav2_costmap_2d/costmap_topic_collision_checker.hpp"
@@ -25,6 +26,7 @@
 #include "nav2_costmap_2d/cost_values.hpp"
 #include "nav2_costmap_2d/exceptions.hpp"
 #include "nav2_costmap_2d/footprint.hpp"
+#include "nav2_util/geometry_utils.hpp"
 #include "nav2_util/line_iterator.hpp"
 
 using namespace std::chrono_literals;
@@ -81,7 +83,109 @@ double CostmapTopicCollisionChecker::scorePose(
     throw IllegalPoseException(name_, "Pose Goes Off Grid.");
   }
 
-  return collision_checker_.footprintCost(getFootprint(pose, fetch_costmap_and_footprint));
+  if (fetch_costmap_and_footprint) {
+    fetchFootprint();
+  }
+  orientFootprint(pose);
+  return collision_checker_.footprintCost(oriented_footprint_);
+}
+
+void CostmapTopicCollisionChecker::scorePoses(
+  const std::vector<geometry_msgs::msg::Pose2D> & poses,
+  std::vector<double> & scores)
+{
+  try {
+    collision_checker_.setCostmap(costmap_sub_.getCostmap());
+  } catch (const std::runtime_error & e) {
+    throw CollisionCheckerException(e.what());
+  }
+  fetchFootprint();
+
+  scores.resize(poses.size());
+  unsigned int cell_x, cell_y;
+  for (size_t i = 0; i < poses.size(); ++i) {
+    if (!collision_checker_.worldToMap(poses[i].x, poses[i].y, cell_x, cell_y)) {
+      scores[i] = static_cast<double>(LETHAL_OBSTACLE);
+      continue;
+    }
+    orientFootprint(poses[i]);
+    scores[i] = collision_checker_.footprintCost(oriented_footprint_);
+  }
+}
+
+double CostmapTopicCollisionChecker::getCollisionTime(
+  const geometry_msgs::msg::Pose2D & pose,
+  const geometry_msgs::msg::Twist & twist,
+  double projection_time, double time_step)
+{
+  try {
+    collision_checker_.setCostmap(costmap_sub_.getCostmap());
+    fetchFootprint();
+  } catch (const std::exception & e) {
+    RCLCPP_ERROR(rclcpp::get_logger(name_), "%s", e.what());
+    return 0.0;
+  }
+
+  unsigned int cell_x, cell_y;
+  for (int step = 1; step * time_step < projection_time; ++step) {
+    const double time = step * time_step;
+    const geometry_msgs::msg::Pose2D projected_pose = nav2_util::geometry_utils::projectTwist(
+      pose, twist.linear.x, twist.linear.y, twist.angular.z, time);
+    if (!collision_checker_.worldToMap(projected_pose.x, projected_pose.y, cell_x, cell_y)) {
+      return time;
+    }
+    orientFootprint(projected_pose);
+    if (collision_checker_.footprintCost(oriented_footprint_) >= LETHAL_OBSTACLE) {
+      return time;
+    }
+  }
+  return -1.0;
+}
+
+bool CostmapTopicCollisionChecker::isTranslationCollisionFree(
+  const geometry_msgs::msg::Pose2D & pose, double distance)
+{
+  return isSweptCollisionFree(
+    [&]() {
+      return collision_checker_.translationSweptCost(
+        pose.x, pose.y, pose.theta, distance, footprint_);
+    });
+}
+
+bool CostmapTopicCollisionChecker::isRotationCollisionFree(
+  const geometry_msgs::msg::Pose2D & pose, double angle)
+{
+  return isSweptCollisionFree(
+    [&]() {
+      return collision_checker_.rotationSweptCost(
+        pose.x, pose.y, pose.theta, angle, footprint_);
+    });
+}
+
+template<typename SweptCostT>
+bool CostmapTopicCollisionChecker::isSweptCollisionFree(SweptCostT swept_cost)
+{
+  try {
+    try {
+      collision_checker_.setCostmap(costmap_sub_.getCostmap());
+    } catch (const std::runtime_error & e) {
+      throw CollisionCheckerException(e.what());
+    }
+    fetchFootprint();
+    return swept_cost() < LETHAL_OBSTACLE;
+  } catch (const CollisionCheckerException & e) {
+    RCLCPP_ERROR(rclcpp::get_logger(name_), "%s", e.what());
+    return false;
+  } catch (...) {
+    RCLCPP_ERROR(rclcpp::get_logger(name_), "Failed to check swept area score!");
+    return false;
+  }
+}
+
+void CostmapTopicCollisionChecker::setOrientationBins(unsigned int orientation_bins)
+{
+  orientation_bins_ = orientation_bins;
+  binned_footprints_.clear();
 }
 
 Footprint CostmapTopicCollisionChecker::getFootprint(
@@ -89,15 +193,49 @@ Footprint CostmapTopicCollisionChecker::getFootprint(
   bool fetch_latest_footprint)
 {
   if (fetch_latest_footprint) {
-    std_msgs::msg::Header header;
-    if (!footprint_sub_.getFootprintInRobotFrame(footprint_, header)) {
-      throw CollisionCheckerException("Current footprint not available.");
+    fetchFootprint();
+  }
+  orientFootprint(pose);
+
+  return oriented_footprint_;
+}
+
+void CostmapTopicCollisionChecker::fetchFootprint()
+{
+  std_msgs::msg::Header header;
+  if (!footprint_sub_.getFootprintInRobotFrame(footprint_, header)) {
+    throw CollisionCheckerException("Current footprint not available.");
+  }
+}
+
+void CostmapTopicCollisionChecker::orientFootprint(const geometry_msgs::msg::Pose2D & pose)
+{
+  if (orientation_bins_ == 0) {
+    transformFootprint(pose.x, pose.y, pose.theta, footprint_, oriented_footprint_);
+    return;
+  }
+
+  // Rotate the footprint for every bin again once it changed
+  if (binned_footprints_.empty() || binned_footprint_spec_ != footprint_) {
+    binned_footprint_spec_ = footprint_;
+    binned_footprints_.resize(orientation_bins_);
+    for (unsigned int bin = 0; bin < orientation_bins_; ++bin) {
+      transformFootprint(
+        0.0, 0.0, 2.0 * M_PI * bin / orientation_bins_, footprint_, binned_footprints_[bin]);
     }
   }
-  Footprint footprint;
-  transformFootprint(pose.x, pose.y, pose.theta, footprint_, footprint);
 
-  return footprint;
+  // Translate the footprint of the nearest bin
+  const double bin_size = 2.0 * M_PI / orientation_bins_;
+  const double heading = pose.theta - 2.0 * M_PI * std::floor(pose.theta / (2.0 * M_PI));
+  const unsigned int bin =
+    static_cast<unsigned int>(std::lround(heading / bin_size)) % orientation_bins_;
+  const Footprint & rotated = binned_footprints_[bin];
+  oriented_footprint_.resize(rotated.size());
+  for (size_t i = 0; i < rotated.size(); ++i) {
+    oriented_footprint_[i].x = pose.x + rotated[i].x;
+    oriented_footprint_[i].y = pose.y + rotated[i].y;
+  }
 }
 
 }  // namespace nav2_costmap_2d
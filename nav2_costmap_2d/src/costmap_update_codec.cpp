@@ -0,0 +1,58 @@
+// Copyright (c) 2024 Open Navigation LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "nav2_costmap_2d/costmap_update_codec.hpp"
+
+#include <cstring>
+
+namespace nav2_costmap_2d
+{
+
+void encodeRunLength(
+  const unsigned char * data, size_t size, std::vector<uint8_t> & encoded)
+{
+  encoded.clear();
+  size_t i = 0;
+  while (i < size) {
+    const unsigned char value = data[i];
+    size_t run = 1;
+    while (i + run < size && run < 255 && data[i + run] == value) {
+      ++run;
+    }
+    encoded.push_back(static_cast<uint8_t>(run));
+    encoded.push_back(value);
+    i += run;
+  }
+}
+
+bool decodeRunLength(
+  const std::vector<uint8_t> & encoded, unsigned char * data, size_t size)
+{
+  if (encoded.size() % 2 != 0) {
+    return false;
+  }
+
+  size_t decoded = 0;
+  for (size_t i = 0; i < encoded.size(); i += 2) {
+    const size_t run = encoded[i];
+    if (run == 0 || decoded + run > size) {
+      return false;
+    }
+    memset(data + decoded, encoded[i + 1], run);
+    decoded += run;
+  }
+  return decoded == size;
+}
+
+}  // namespace nav2_costmap_2d
@@ -0,0 +1,139 @@
+// Copyright (c) 2024 Open Navigation LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "nav2_costmap_2d/dirty_tiles.hpp"
+
+#include <algorithm>
+
+namespace nav2_costmap_2d
+{
+
+void DirtyTiles::resize(unsigned int size_x, unsigned int size_y, unsigned int tile_size)
+{
+  size_x_ = size_x;
+  size_y_ = size_y;
+  tile_size_ = std::max(1u, tile_size);
+  tiles_x_ = (size_x_ + tile_size_ - 1) / tile_size_;
+  tiles_y_ = (size_y_ + tile_size_ - 1) / tile_size_;
+  tiles_.assign(static_cast<size_t>(tiles_x_) * tiles_y_, 0);
+}
+
+void DirtyTiles::clear()
+{
+  std::fill(tiles_.begin(), tiles_.end(), 0);
+}
+
+void DirtyTiles::markCells(unsigned int x0, unsigned int y0, unsigned int xn, unsigned int yn)
+{
+  xn = std::min(xn, size_x_);
+  yn = std::min(yn, size_y_);
+  if (x0 >= xn || y0 >= yn) {
+    return;
+  }
+
+  const unsigned int tx0 = x0 / tile_size_;
+  const unsigned int ty0 = y0 / tile_size_;
+  const unsigned int txn = (xn - 1) / tile_size_;
+  const unsigned int tyn = (yn - 1) / tile_size_;
+  for (unsigned int ty = ty0; ty <= tyn; ++ty) {
+    uint8_t * row = &tiles_[ty * tiles_x_];
+    std::fill(row + tx0, row + txn + 1, 1);
+  }
+}
+
+void DirtyTiles::dilate(unsigned int cells)
+{
+  if (cells == 0 || tiles_.empty()) {
+    return;
+  }
+
+  // Separable dilation with a square structuring element, in whole tiles
+  const int r = static_cast<int>((cells + tile_size_ - 1) / tile_size_);
+  const int tx = static_cast<int>(tiles_x_);
+  const int ty = static_cast<int>(tiles_y_);
+  scratch_.assign(tiles_.size(), 0);
+
+  for (int y = 0; y < ty; ++y) {
+    const uint8_t * src = &tiles_[y * tx];
+    uint8_t * dst = &scratch_[y * tx];
+    for (int x = 0; x < tx; ++x) {
+      if (src[x]) {
+        std::fill(dst + std::max(0, x - r), dst + std::min(tx, x + r + 1), 1);
+      }
+    }
+  }
+
+  std::fill(tiles_.begin(), tiles_.end(), 0);
+  for (int y = 0; y < ty; ++y) {
+    const uint8_t * src = &scratch_[y * tx];
+    const int y_min = std::max(0, y - r);
+    const int y_max = std::min(ty, y + r + 1);
+    for (int x = 0; x < tx; ++x) {
+      if (src[x]) {
+        for (int yy = y_min; yy < y_max; ++yy) {
+          tiles_[yy * tx + x] = 1;
+        }
+      }
+    }
+  }
+}
+
+bool DirtyTiles::empty() const
+{
+  return std::find(tiles_.begin(), tiles_.end(), 1) == tiles_.end();
+}
+
+void DirtyTiles::getRegions(std::vector<CellRegion> & regions) const
+{
+  regions.clear();
+
+  // Rows of tiles are split into runs of dirty tiles, and runs spanning the same
+  // columns on consecutive rows are merged into a single region
+  std::vector<size_t> open;  // indices into regions still extendable by the next row
+  std::vector<size_t> next_open;
+  for (unsigned int y = 0; y < tiles_y_; ++y) {
+    next_open.clear();
+    const uint8_t * row = &tiles_[y * tiles_x_];
+    unsigned int x = 0;
+    while (x < tiles_x_) {
+      if (!row[x]) {
+        ++x;
+        continue;
+      }
+      const unsigned int run_start = x;
+      while (x < tiles_x_ && row[x]) {
+        ++x;
+      }
+
+      const unsigned int x0 = run_start * tile_size_;
+      const unsigned int xn = std::min(x * tile_size_, size_x_);
+      const unsigned int yn = std::min((y + 1) * tile_size_, size_y_);
+
+      auto match = std::find_if(
+        open.begin(), open.end(), [&](size_t i) {
+          return regions[i].x0 == x0 && regions[i].xn == xn;
+        });
+      if (match != open.end()) {
+        regions[*match].yn = yn;
+        next_open.push_back(*match);
+      } else {
+        regions.push_back(CellRegion{x0, y * tile_size_, xn, yn});
+        next_open.push_back(regions.size() - 1);
+      }
+    }
+    open.swap(next_open);
+  }
+}
+
+}  // namespace nav2_costmap_2d
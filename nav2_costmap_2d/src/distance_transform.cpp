@@ -0,0 +1,123 @@
+// Copyright (c) 2024 Open Navigation LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "nav2_costmap_2d/distance_transform.hpp"
+
+#include <algorithm>
+
+namespace nav2_costmap_2d
+{
+
+namespace
+{
+
+inline int64_t floorDiv(int64_t a, int64_t b)
+{
+  int64_t q = a / b;
+  if ((a % b != 0) && ((a < 0) != (b < 0))) {
+    --q;
+  }
+  return q;
+}
+
+}  // namespace
+
+void DistanceTransform::compute(const uint8_t * seeds, unsigned int size_x, unsigned int size_y)
+{
+  const size_t size = static_cast<size_t>(size_x) * size_y;
+  squared_distance_.resize(size);
+  column_distance_.resize(size);
+  if (size == 0) {
+    return;
+  }
+
+  // Larger than any real distance in the grid, small enough to square without overflow
+  const uint32_t inf = size_x + size_y;
+
+  // 1. Distance to the nearest seed along each column, sweeping whole rows at a time
+  uint32_t * g = column_distance_.data();
+  for (unsigned int i = 0; i < size_x; ++i) {
+    g[i] = seeds[i] ? 0 : inf;
+  }
+  for (unsigned int j = 1; j < size_y; ++j) {
+    const uint8_t * s = seeds + j * size_x;
+    const uint32_t * prev = g + (j - 1) * size_x;
+    uint32_t * cur = g + j * size_x;
+    for (unsigned int i = 0; i < size_x; ++i) {
+      cur[i] = s[i] ? 0 : std::min(prev[i] + 1, inf);
+    }
+  }
+  for (int j = static_cast<int>(size_y) - 2; j >= 0; --j) {
+    const uint32_t * next = g + (j + 1) * size_x;
+    uint32_t * cur = g + j * size_x;
+    for (unsigned int i = 0; i < size_x; ++i) {
+      cur[i] = std::min(cur[i], next[i] + 1);
+    }
+  }
+
+  // 2. Lower envelope of the parabolas (x - i)^2 + g(i)^2 along each row
+  envelope_sites_.resize(size_x);
+  envelope_starts_.resize(size_x);
+  int * s = envelope_sites_.data();
+  int * t = envelope_starts_.data();
+  const int m = static_cast<int>(size_x);
+
+  for (unsigned int j = 0; j < size_y; ++j) {
+    const uint32_t * row_g = g + j * size_x;
+    uint32_t * row_dt = squared_distance_.data() + j * size_x;
+
+    auto f = [row_g](int64_t x, int64_t i) {
+        const int64_t gi = row_g[i];
+        return (x - i) * (x - i) + gi * gi;
+      };
+    auto sep = [row_g](int64_t i, int64_t u) {
+        const int64_t gi = row_g[i];
+        const int64_t gu = row_g[u];
+        return floorDiv(u * u - i * i + gu * gu - gi * gi, 2 * (u - i));
+      };
+
+    int q = 0;
+    s[0] = 0;
+    t[0] = 0;
+    for (int u = 1; u < m; ++u) {
+      while (q >= 0 && f(t[q], s[q]) > f(t[q], u)) {
+        --q;
+      }
+      if (q < 0) {
+        q = 0;
+        s[0] = u;
+      } else {
+        const int64_t w = 1 + sep(s[q], u);
+        if (w < m) {
+          ++q;
+          s[q] = u;
+          t[q] = static_cast<int>(w);
+        }
+      }
+    }
+
+    for (int u = m - 1; u >= 0; --u) {
+      if (row_g[s[q]] >= inf) {
+        row_dt[u] = getInfinity();
+      } else {
+        row_dt[u] = static_cast<uint32_t>(f(u, s[q]));
+      }
+      if (u == t[q]) {
+        --q;
+      }
+    }
+  }
+}
+
+}  // namespace nav2_costmap_2d
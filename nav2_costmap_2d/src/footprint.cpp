@@ -111,11 +111,17 @@ void transformFootprint(
   double x, double y, double theta,
   const std::vector<geometry_msgs::msg::Point> & footprint_spec,
   std::vector<geometry_msgs::msg::Point> & oriented_footprint)
+{
+  transformFootprint(x, y, cos(theta), sin(theta), footprint_spec, oriented_footprint);
+}
+
+void transformFootprint(
+  double x, double y, double cos_th, double sin_th,
+  const std::vector<geometry_msgs::msg::Point> & footprint_spec,
+  std::vector<geometry_msgs::msg::Point> & oriented_footprint)
 {
   // build the oriented footprint at a given location
   oriented_footprint.resize(footprint_spec.size());
-  double cos_th = cos(theta);
-  double sin_th = sin(theta);
   for (unsigned int i = 0; i < footprint_spec.size(); ++i) {
     double new_x = x + (footprint_spec[i].x * cos_th - footprint_spec[i].y * sin_th);
     double new_y = y + (footprint_spec[i].x * sin_th + footprint_spec[i].y * cos_th);
@@ -125,6 +131,59 @@ void transformFootprint(
   }
 }
 
+void toFootprintPoints(
+  const std::vector<geometry_msgs::msg::Point> & footprint,
+  std::vector<FootprintPoint> & points)
+{
+  points.resize(footprint.size());
+  for (unsigned int i = 0; i < footprint.size(); ++i) {
+    points[i].x = static_cast<float>(footprint[i].x);
+    points[i].y = static_cast<float>(footprint[i].y);
+  }
+}
+
+void transformFootprint(
+  float x, float y, float cos_th, float sin_th,
+  const FootprintPoint * footprint_spec, size_t size,
+  FootprintPoint * oriented_footprint)
+{
+  for (size_t i = 0; i < size; ++i) {
+    const float new_x = x + (footprint_spec[i].x * cos_th - footprint_spec[i].y * sin_th);
+    const float new_y = y + (footprint_spec[i].x * sin_th + footprint_spec[i].y * cos_th);
+    oriented_footprint[i].x = new_x;
+    oriented_footprint[i].y = new_y;
+  }
+}
+
+void OrientedFootprintCache::setFootprint(
+  const std::vector<geometry_msgs::msg::Point> & footprint_spec)
+{
+  std::lock_guard<std::mutex> lock(mutex_);
+  footprint_spec_ = footprint_spec;
+  valid_ = false;
+}
+
+void OrientedFootprintCache::getOrientedFootprint(
+  double x, double y, double theta,
+  std::vector<geometry_msgs::msg::Point> & oriented_footprint)
+{
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (!valid_ || x != x_ || y != y_ || theta != theta_) {
+    if (!valid_ || theta != theta_) {
+      cos_th_ = cos(theta);
+      sin_th_ = sin(theta);
+    }
+    transformFootprint(x, y, cos_th_, sin_th_, footprint_spec_, oriented_footprint_);
+    x_ = x;
+    y_ = y;
+    theta_ = theta;
+    valid_ = true;
+  }
+
+  // Copying into a vector of the same size does not allocate
+  oriented_footprint.assign(oriented_footprint_.begin(), oriented_footprint_.end());
+}
+
 void transformFootprint(
   double x, double y, double theta,
   const std::vector<geometry_msgs::msg::Point> & footprint_spec,
@@ -18,10 +18,14 @@
 #include <string>
 #include <vector>
 #include <algorithm>
+#include <cmath>
+#include <limits>
 
 #include "nav2_costmap_2d/footprint_collision_checker.hpp"
 
 #include "nav2_costmap_2d/cost_values.hpp"
+#include "nav2_costmap_2d/costmap_snapshot.hpp"
+#include "nav2_costmap_2d/costmap_view.hpp"
 #include "nav2_costmap_2d/exceptions.hpp"
 #include "nav2_costmap_2d/footprint.hpp"
 #include "nav2_util/line_iterator.hpp"
@@ -31,6 +35,27 @@ using namespace std::chrono_literals;
 namespace nav2_costmap_2d
 {
 
+namespace
+{
+
+// Highest cost of the cells of a line in a view, with inline unchecked accesses
+inline double viewLineCost(const CostmapView & view, int x0, int x1, int y0, int y1)
+{
+  unsigned char line_cost = 0;
+  for (nav2_util::LineIterator line(x0, y0, x1, y1); line.isValid(); line.advance()) {
+    const unsigned char point_cost = view(line.getX(), line.getY());
+
+    // if in collision, no need to continue
+    if (point_cost == LETHAL_OBSTACLE) {
+      return static_cast<double>(LETHAL_OBSTACLE);
+    }
+    line_cost = std::max(line_cost, point_cost);
+  }
+  return static_cast<double>(line_cost);
+}
+
+}  // namespace
+
 template<typename CostmapT>
 FootprintCollisionChecker<CostmapT>::FootprintCollisionChecker()
 : costmap_(nullptr)
@@ -48,11 +73,12 @@ template<typename CostmapT>
 double FootprintCollisionChecker<CostmapT>::footprintCost(const Footprint & footprint)
 {
   // now we really have to lay down the footprint in the costmap_ grid
+  const CostmapView view(*costmap_);
   unsigned int x0, x1, y0, y1;
   double footprint_cost = 0.0;
 
   // get the cell coord of the first point
-  if (!worldToMap(footprint[0].x, footprint[0].y, x0, y0)) {
+  if (!view.worldToMap(footprint[0].x, footprint[0].y, x0, y0)) {
     return static_cast<double>(LETHAL_OBSTACLE);
   }
 
@@ -63,11 +89,11 @@ double FootprintCollisionChecker<CostmapT>::footprintCost(const Footprint & foot
   // we need to rasterize each line in the footprint
   for (unsigned int i = 0; i < footprint.size() - 1; ++i) {
     // get the cell coord of the second point
-    if (!worldToMap(footprint[i + 1].x, footprint[i + 1].y, x1, y1)) {
+    if (!view.worldToMap(footprint[i + 1].x, footprint[i + 1].y, x1, y1)) {
       return static_cast<double>(LETHAL_OBSTACLE);
     }
 
-    footprint_cost = std::max(lineCost(x0, x1, y0, y1), footprint_cost);
+    footprint_cost = std::max(viewLineCost(view, x0, x1, y0, y1), footprint_cost);
 
     // the second point is next iteration's first point
     x0 = x1;
@@ -81,29 +107,13 @@ double FootprintCollisionChecker<CostmapT>::footprintCost(const Footprint & foot
 
   // we also need to connect the first point in the footprint to the last point
   // the last iteration's x1, y1 are the last footprint point's coordinates
-  return std::max(lineCost(xstart, x1, ystart, y1), footprint_cost);
+  return std::max(viewLineCost(view, xstart, x1, ystart, y1), footprint_cost);
 }
 
 template<typename CostmapT>
 double FootprintCollisionChecker<CostmapT>::lineCost(int x0, int x1, int y0, int y1) const
 {
-  double line_cost = 0.0;
-  double point_cost = -1.0;
-
-  for (nav2_util::LineIterator line(x0, y0, x1, y1); line.isValid(); line.advance()) {
-    point_cost = pointCost(line.getX(), line.getY());   // Score the current point
-
-    // if in collision, no need to continue
-    if (point_cost == static_cast<double>(LETHAL_OBSTACLE)) {
-      return point_cost;
-    }
-
-    if (line_cost < point_cost) {
-      line_cost = point_cost;
-    }
-  }
-
-  return line_cost;
+  return viewLineCost(CostmapView(*costmap_), x0, x1, y0, y1);
 }
 
 template<typename CostmapT>
@@ -129,22 +139,335 @@ template<typename CostmapT>
 double FootprintCollisionChecker<CostmapT>::footprintCostAtPose(
   double x, double y, double theta, const Footprint & footprint)
 {
-  double cos_th = cos(theta);
-  double sin_th = sin(theta);
-  Footprint oriented_footprint;
-  oriented_footprint.reserve(footprint.size());
-  geometry_msgs::msg::Point new_pt;
-  for (unsigned int i = 0; i < footprint.size(); ++i) {
-    new_pt.x = x + (footprint[i].x * cos_th - footprint[i].y * sin_th);
-    new_pt.y = y + (footprint[i].x * sin_th + footprint[i].y * cos_th);
-    oriented_footprint.push_back(new_pt);
+  // Reuse the buffer of the previous calls, not to allocate once per pose
+  transformFootprint(x, y, cos(theta), sin(theta), footprint, oriented_footprint_);
+
+  return footprintCost(oriented_footprint_);
+}
+
+template<typename CostmapT>
+void FootprintCollisionChecker<CostmapT>::setFootprintCache(
+  const Footprint & footprint, unsigned int num_headings, bool fill_interior)
+{
+  cache_cells_.clear();
+  cache_heading_start_.clear();
+  cache_extents_.clear();
+  if (num_headings == 0 || footprint.empty()) {
+    return;
   }
 
-  return footprintCost(oriented_footprint);
+  const double resolution = costmap_->getResolution();
+  std::vector<CellOffset> vertices(footprint.size());
+  std::vector<CellOffset> cells;
+
+  for (unsigned int h = 0; h < num_headings; ++h) {
+    const double theta = 2.0 * M_PI * h / num_headings;
+    const double cos_th = cos(theta);
+    const double sin_th = sin(theta);
+
+    // The pose is at the center of cell (0, 0), which spans [-0.5, 0.5) cells
+    for (unsigned int i = 0; i < footprint.size(); ++i) {
+      const double x = (footprint[i].x * cos_th - footprint[i].y * sin_th) / resolution;
+      const double y = (footprint[i].x * sin_th + footprint[i].y * cos_th) / resolution;
+      vertices[i].dx = static_cast<int>(std::floor(x + 0.5));
+      vertices[i].dy = static_cast<int>(std::floor(y + 0.5));
+    }
+
+    // Rasterize the outline, closing it from the last vertex back to the first
+    cells.clear();
+    for (unsigned int i = 0; i < vertices.size(); ++i) {
+      const CellOffset & v0 = vertices[i];
+      const CellOffset & v1 = vertices[(i + 1) % vertices.size()];
+      for (nav2_util::LineIterator line(v0.dx, v0.dy, v1.dx, v1.dy); line.isValid();
+        line.advance())
+      {
+        cells.push_back(CellOffset{line.getX(), line.getY()});
+      }
+    }
+
+    auto row_major = [](const CellOffset & a, const CellOffset & b) {
+        return a.dy < b.dy || (a.dy == b.dy && a.dx < b.dx);
+      };
+    std::sort(cells.begin(), cells.end(), row_major);
+
+    const size_t start = cache_cells_.size();
+    cache_heading_start_.push_back(start);
+    if (fill_interior) {
+      // Fill each row between its extreme outline cells. This is exact for convex
+      // footprints and errs on the side of covering more cells otherwise.
+      for (size_t i = 0; i < cells.size(); ) {
+        size_t row_end = i;
+        while (row_end + 1 < cells.size() && cells[row_end + 1].dy == cells[i].dy) {
+          ++row_end;
+        }
+        for (int dx = cells[i].dx; dx <= cells[row_end].dx; ++dx) {
+          cache_cells_.push_back(CellOffset{dx, cells[i].dy});
+        }
+        i = row_end + 1;
+      }
+    } else {
+      for (size_t i = 0; i < cells.size(); ++i) {
+        if (i == 0 || row_major(cells[i - 1], cells[i])) {
+          cache_cells_.push_back(cells[i]);
+        }
+      }
+    }
+
+    CellOffset lo{std::numeric_limits<int>::max(), std::numeric_limits<int>::max()};
+    CellOffset hi{std::numeric_limits<int>::min(), std::numeric_limits<int>::min()};
+    for (size_t i = start; i < cache_cells_.size(); ++i) {
+      lo.dx = std::min(lo.dx, cache_cells_[i].dx);
+      lo.dy = std::min(lo.dy, cache_cells_[i].dy);
+      hi.dx = std::max(hi.dx, cache_cells_[i].dx);
+      hi.dy = std::max(hi.dy, cache_cells_[i].dy);
+    }
+    cache_extents_.push_back(lo);
+    cache_extents_.push_back(hi);
+  }
+  cache_heading_start_.push_back(cache_cells_.size());
+}
+
+template<typename CostmapT>
+double FootprintCollisionChecker<CostmapT>::cachedCost(
+  unsigned int heading, unsigned int mx, unsigned int my) const
+{
+  const CellOffset & lo = cache_extents_[2 * heading];
+  const CellOffset & hi = cache_extents_[2 * heading + 1];
+  const CostmapView view(*costmap_);
+  const int x = static_cast<int>(mx);
+  const int y = static_cast<int>(my);
+
+  // A footprint partially off the map is treated as in collision, as in footprintCost()
+  if (!view.contains(x + lo.dx, y + lo.dy) || !view.contains(x + hi.dx, y + hi.dy)) {
+    return static_cast<double>(LETHAL_OBSTACLE);
+  }
+
+  const unsigned char * center = view.row(my) + mx;
+  const int stride = static_cast<int>(view.getStride());
+  unsigned char footprint_cost = 0;
+  for (size_t i = cache_heading_start_[heading]; i < cache_heading_start_[heading + 1]; ++i) {
+    const unsigned char cost = center[cache_cells_[i].dy * stride + cache_cells_[i].dx];
+    // if in collision, no need to continue
+    if (cost == LETHAL_OBSTACLE) {
+      return static_cast<double>(LETHAL_OBSTACLE);
+    }
+    footprint_cost = std::max(footprint_cost, cost);
+  }
+  return static_cast<double>(footprint_cost);
+}
+
+template<typename CostmapT>
+double FootprintCollisionChecker<CostmapT>::footprintCostAtPoseCached(
+  double x, double y, double theta) const
+{
+  unsigned int mx, my;
+  if (!CostmapView(*costmap_).worldToMap(x, y, mx, my)) {
+    return static_cast<double>(LETHAL_OBSTACLE);
+  }
+
+  // Without a footprint cache, only the cell of the pose is checked
+  if (!hasFootprintCache()) {
+    return pointCost(mx, my);
+  }
+
+  const int num_headings = static_cast<int>(cache_heading_start_.size()) - 1;
+  int heading = static_cast<int>(std::lround(theta * num_headings / (2.0 * M_PI))) %
+    num_headings;
+  if (heading < 0) {
+    heading += num_headings;
+  }
+  return cachedCost(static_cast<unsigned int>(heading), mx, my);
+}
+
+template<typename CostmapT>
+void FootprintCollisionChecker<CostmapT>::footprintCostsAtPoses(
+  const std::vector<geometry_msgs::msg::Pose2D> & poses, std::vector<double> & costs) const
+{
+  costs.resize(poses.size());
+  for (size_t i = 0; i < poses.size(); ++i) {
+    costs[i] = footprintCostAtPoseCached(poses[i].x, poses[i].y, poses[i].theta);
+  }
 }
 
 // declare our valid template parameters
+template<typename CostmapT>
+template<typename SweptT>
+double FootprintCollisionChecker<CostmapT>::sweptCost(
+  double x, double y, double theta,
+  double min_wx, double min_wy, double max_wx, double max_wy, SweptT swept) const
+{
+  const CostmapView view(*costmap_);
+  const double resolution = view.getResolution();
+  const double origin_x = view.getOriginX();
+  const double origin_y = view.getOriginY();
+  const int size_x = static_cast<int>(view.getSizeInCellsX());
+  const int size_y = static_cast<int>(view.getSizeInCellsY());
+  const int mx0 = std::max(0, static_cast<int>(std::floor((min_wx - origin_x) / resolution)));
+  const int my0 = std::max(0, static_cast<int>(std::floor((min_wy - origin_y) / resolution)));
+  const int mxn =
+    std::min(size_x - 1, static_cast<int>(std::floor((max_wx - origin_x) / resolution)));
+  const int myn =
+    std::min(size_y - 1, static_cast<int>(std::floor((max_wy - origin_y) / resolution)));
+
+  const double cos_th = cos(theta);
+  const double sin_th = sin(theta);
+  unsigned char cost = 0;
+  for (int my = my0; my <= myn; ++my) {
+    const double dy = origin_y + (my + 0.5) * resolution - y;
+    const unsigned char * row = view.row(my);
+    for (int mx = mx0; mx <= mxn; ++mx) {
+      const double dx = origin_x + (mx + 0.5) * resolution - x;
+      // Cell center in the frame of the pose
+      if (!swept(dx * cos_th + dy * sin_th, dy * cos_th - dx * sin_th)) {
+        continue;
+      }
+      cost = std::max(cost, row[mx]);
+      if (cost == LETHAL_OBSTACLE) {
+        return static_cast<double>(cost);
+      }
+    }
+  }
+  return static_cast<double>(cost);
+}
+
+template<typename CostmapT>
+double FootprintCollisionChecker<CostmapT>::translationSweptCost(
+  double x, double y, double theta, double distance, const Footprint & footprint)
+{
+  if (footprint.empty()) {
+    return 0.0;
+  }
+
+  // The area is bounded by the footprint at both ends, which must be on the costmap
+  const double cos_th = cos(theta);
+  const double sin_th = sin(theta);
+  double min_wx = std::numeric_limits<double>::max(), min_wy = min_wx;
+  double max_wx = std::numeric_limits<double>::lowest(), max_wy = max_wx;
+  unsigned int mx, my;
+  for (const double d : {0.0, distance}) {
+    for (const auto & pt : footprint) {
+      const double wx = x + (pt.x + d) * cos_th - pt.y * sin_th;
+      const double wy = y + (pt.x + d) * sin_th + pt.y * cos_th;
+      if (!costmap_->worldToMap(wx, wy, mx, my)) {
+        return static_cast<double>(LETHAL_OBSTACLE);
+      }
+      min_wx = std::min(min_wx, wx);
+      min_wy = std::min(min_wy, wy);
+      max_wx = std::max(max_wx, wx);
+      max_wy = std::max(max_wy, wy);
+    }
+  }
+
+  // A point is swept if the segment of the positions it had relative to the footprint,
+  // from (px - distance, py) to (px, py), meets the footprint
+  const double seg_min_offset = std::min(0.0, distance);
+  const double seg_max_offset = std::max(0.0, distance);
+  auto swept = [&](double px, double py) {
+      const double a = px - seg_max_offset;
+      const double b = px - seg_min_offset;
+      bool inside_at_a = false;
+      for (size_t i = 0, j = footprint.size() - 1; i < footprint.size(); j = i++) {
+        const auto & p0 = footprint[j];
+        const auto & p1 = footprint[i];
+        if ((p0.y > py) == (p1.y > py)) {
+          continue;
+        }
+        // Crossing of the edge with the line of the segment
+        const double cx = p0.x + (py - p0.y) * (p1.x - p0.x) / (p1.y - p0.y);
+        if (cx >= a && cx <= b) {
+          return true;
+        }
+        if (cx < a) {
+          inside_at_a = !inside_at_a;
+        }
+      }
+      return inside_at_a;
+    };
+
+  return sweptCost(x, y, theta, min_wx, min_wy, max_wx, max_wy, swept);
+}
+
+template<typename CostmapT>
+double FootprintCollisionChecker<CostmapT>::rotationSweptCost(
+  double x, double y, double theta, double angle, const Footprint & footprint)
+{
+  if (footprint.empty()) {
+    return 0.0;
+  }
+
+  // The area is bounded by the circle through the farthest footprint point, and the
+  // footprint must stay on the costmap at both ends and every eighth of a turn in between
+  double radius = 0.0;
+  for (const auto & pt : footprint) {
+    radius = std::max(radius, std::hypot(pt.x, pt.y));
+  }
+  const int steps = static_cast<int>(std::ceil(std::fabs(angle) / (M_PI / 4.0)));
+  unsigned int mx, my;
+  for (int step = 0; step <= steps; ++step) {
+    const double heading = theta + (steps == 0 ? 0.0 : angle * step / steps);
+    const double cos_th = cos(heading);
+    const double sin_th = sin(heading);
+    for (const auto & pt : footprint) {
+      if (!costmap_->worldToMap(
+          x + pt.x * cos_th - pt.y * sin_th, y + pt.x * sin_th + pt.y * cos_th, mx, my))
+      {
+        return static_cast<double>(LETHAL_OBSTACLE);
+      }
+    }
+  }
+
+  // A point is swept if the arc of the positions it had relative to the footprint,
+  // rotating it back by up to the angle, meets the footprint
+  const double sweep = std::min(std::fabs(angle), 2.0 * M_PI);
+  const double direction = angle < 0.0 ? -1.0 : 1.0;
+  auto in_arc = [&](double qx, double qy, double px, double py) {
+      // Angle rotating q onto p, in the direction of the rotation, within [0, 2 pi)
+      double phi = direction * std::atan2(qx * py - qy * px, qx * px + qy * py);
+      if (phi < 0.0) {
+        phi += 2.0 * M_PI;
+      }
+      return phi <= sweep;
+    };
+  auto swept = [&](double px, double py) {
+      const double rho2 = px * px + py * py;
+      bool inside = false;
+      for (size_t i = 0, j = footprint.size() - 1; i < footprint.size(); j = i++) {
+        const auto & p0 = footprint[j];
+        const auto & p1 = footprint[i];
+        if ((p0.y > py) != (p1.y > py) &&
+          px < p0.x + (py - p0.y) * (p1.x - p0.x) / (p1.y - p0.y))
+        {
+          inside = !inside;
+        }
+
+        // Intersections of the edge with the circle of the point, |p0 + s (p1 - p0)| = rho
+        const double ex = p1.x - p0.x, ey = p1.y - p0.y;
+        const double qa = ex * ex + ey * ey;
+        if (qa == 0.0) {
+          continue;
+        }
+        const double qb = 2.0 * (p0.x * ex + p0.y * ey);
+        const double qc = p0.x * p0.x + p0.y * p0.y - rho2;
+        const double discriminant = qb * qb - 4.0 * qa * qc;
+        if (discriminant < 0.0) {
+          continue;
+        }
+        const double root = std::sqrt(discriminant);
+        for (const double s : {(-qb - root) / (2.0 * qa), (-qb + root) / (2.0 * qa)}) {
+          if (s >= 0.0 && s <= 1.0 && in_arc(p0.x + s * ex, p0.y + s * ey, px, py)) {
+            return true;
+          }
+        }
+      }
+      return inside;
+    };
+
+  return sweptCost(
+    x, y, theta, x - radius, y - radius, x + radius, y + radius, swept);
+}
+
 template class FootprintCollisionChecker<std::shared_ptr<nav2_costmap_2d::Costmap2D>>;
 template class FootprintCollisionChecker<nav2_costmap_2d::Costmap2D *>;
+template class FootprintCollisionChecker<nav2_costmap_2d::CostmapSnapshot::ConstPtr>;
 
 }  // namespace nav2_costmap_2d
@@ -12,6 +12,7 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+#include <cmath>
 #include <string>
 #include <vector>
 #include <memory>
@@ -67,8 +68,11 @@ FootprintSubscriber::getFootprintRaw(
   }
 
   auto current_footprint = std::atomic_load(&footprint_);
-  footprint = toPointVector(
-    std::make_shared<geometry_msgs::msg::Polygon>(current_footprint->polygon));
+  const auto & points = current_footprint->polygon.points;
+  footprint.resize(points.size());
+  for (unsigned int i = 0; i < points.size(); ++i) {
+    footprint[i] = toPoint(points[i]);
+  }
   footprint_header = current_footprint->header;
 
   return true;
@@ -95,9 +99,12 @@ FootprintSubscriber::getFootprintInRobotFrame(
   double y = current_pose.pose.position.y;
   double theta = tf2::getYaw(current_pose.pose.orientation);
 
-  std::vector<geometry_msgs::msg::Point> temp;
-  transformFootprint(-x, -y, 0, footprint, temp);
-  transformFootprint(0, 0, -theta, temp, footprint);
+  // Translate by (-x, -y) then rotate by -theta, as a single transform in place
+  double cos_th = cos(theta);
+  double sin_th = sin(theta);
+  transformFootprint(
+    -(x * cos_th + y * sin_th), x * sin_th - y * cos_th, cos_th, -sin_th,
+    footprint, footprint);
 
   footprint_header.frame_id = robot_base_frame_;
   footprint_header.stamp = current_pose.header.stamp;
@@ -38,6 +38,7 @@
 #include "nav2_costmap_2d/layered_costmap.hpp"
 
 #include <algorithm>
+#include <cmath>
 #include <cstdio>
 #include <memory>
 #include <string>
@@ -45,6 +46,7 @@
 #include <limits>
 
 #include "nav2_costmap_2d/footprint.hpp"
+#include "nav2_util/tracing.hpp"
 
 
 using std::vector;
@@ -122,6 +124,167 @@ void LayeredCostmap::resizeMap(
   {
     (*filter)->matchSize();
   }
+
+  if (snapshots_requested_) {
+    publishSnapshot();
+  }
+}
+
+void LayeredCostmap::setParallelUpdates(unsigned int num_threads)
+{
+  std::unique_lock<Costmap2D::mutex_t> lock(*(combined_costmap_.getMutex()));
+  if (num_threads <= 1) {
+    thread_pool_.reset();
+  } else if (!thread_pool_ || thread_pool_->size() != num_threads - 1) {
+    // The updating thread takes part in the work, so it needs one less worker
+    thread_pool_ = std::make_unique<nav2_util::ThreadPool>(num_threads - 1);
+  }
+}
+
+void LayeredCostmap::updateIndependentBounds(
+  std::vector<std::shared_ptr<Layer>>::iterator first,
+  std::vector<std::shared_ptr<Layer>>::iterator last,
+  double robot_x, double robot_y, double robot_yaw)
+{
+  // Independent layers only grow the bounds by what they touched, so each starts from
+  // empty bounds and the results are merged afterwards in the plugins' order
+  struct Bounds
+  {
+    double min_x{std::numeric_limits<double>::max()};
+    double min_y{std::numeric_limits<double>::max()};
+    double max_x{std::numeric_limits<double>::lowest()};
+    double max_y{std::numeric_limits<double>::lowest()};
+  };
+  std::vector<Bounds> bounds(last - first);
+
+  auto update = [&](size_t i) {
+      Bounds & b = bounds[i];
+      (*(first + i))->updateBounds(
+        robot_x, robot_y, robot_yaw, &b.min_x, &b.min_y, &b.max_x, &b.max_y);
+    };
+  if (thread_pool_ && bounds.size() > 1) {
+    thread_pool_->parallelFor(0, bounds.size(), update);
+  } else {
+    for (size_t i = 0; i < bounds.size(); ++i) {
+      update(i);
+    }
+  }
+
+  for (const Bounds & b : bounds) {
+    minx_ = std::min(minx_, b.min_x);
+    miny_ = std::min(miny_, b.min_y);
+    maxx_ = std::max(maxx_, b.max_x);
+    maxy_ = std::max(maxy_, b.max_y);
+    if (tile_size_ > 0) {
+      markDirtyBounds(b.min_x, b.min_y, b.max_x, b.max_y);
+    }
+  }
+}
+
+void LayeredCostmap::setTiledUpdates(unsigned int tile_size)
+{
+  std::unique_lock<Costmap2D::mutex_t> lock(*(combined_costmap_.getMutex()));
+  tile_size_ = tile_size;
+}
+
+void LayeredCostmap::markDirtyBounds(double min_x, double min_y, double max_x, double max_y)
+{
+  if (min_x > max_x || min_y > max_y) {
+    return;
+  }
+
+  int x0, xn, y0, yn;
+  combined_costmap_.worldToMapEnforceBounds(min_x, min_y, x0, y0);
+  combined_costmap_.worldToMapEnforceBounds(max_x, max_y, xn, yn);
+  dirty_tiles_.markCells(
+    std::max(0, x0), std::max(0, y0), std::max(0, xn + 1), std::max(0, yn + 1));
+}
+
+void LayeredCostmap::markDirtyExpansion(
+  double prev_min_x, double prev_min_y, double prev_max_x, double prev_max_y,
+  bool expansion)
+{
+  // Other layers may change costs anywhere in the bounds they report, even within the
+  // incoming bounds, and layers with no incoming bounds report a plain region of their own
+  if (!expansion || prev_min_x > prev_max_x || prev_min_y > prev_max_y) {
+    markDirtyBounds(minx_, miny_, maxx_, maxy_);
+    return;
+  }
+
+  // Layers depending on the incoming bounds (e.g. inflation) are assumed to grow them by
+  // a margin, so the dirty tiles are grown by the smallest margin the bounds grew by
+  const double margin = std::min(
+    std::min(prev_min_x - minx_, prev_min_y - miny_),
+    std::min(maxx_ - prev_max_x, maxy_ - prev_max_y));
+  if (margin < 0.0) {
+    // Illegal bounds change, fall back to the full bounds
+    markDirtyBounds(minx_, miny_, maxx_, maxy_);
+    return;
+  }
+
+  Costmap2D & costmap = combined_costmap_;
+  if (margin >= std::max(costmap.getSizeInMetersX(), costmap.getSizeInMetersY())) {
+    markDirtyBounds(minx_, miny_, maxx_, maxy_);
+    return;
+  }
+  dirty_tiles_.dilate(static_cast<unsigned int>(std::ceil(margin / costmap.getResolution())));
+
+  // Anything the layer added beyond that margin is marked as well
+  const double grown_min_x = prev_min_x - margin;
+  const double grown_min_y = prev_min_y - margin;
+  const double grown_max_x = prev_max_x + margin;
+  const double grown_max_y = prev_max_y + margin;
+  if (minx_ < grown_min_x) {
+    markDirtyBounds(minx_, miny_, grown_min_x, maxy_);
+  }
+  if (maxx_ > grown_max_x) {
+    markDirtyBounds(grown_max_x, miny_, maxx_, maxy_);
+  }
+  if (miny_ < grown_min_y) {
+    markDirtyBounds(minx_, miny_, maxx_, grown_min_y);
+  }
+  if (maxy_ > grown_max_y) {
+    markDirtyBounds(minx_, grown_max_y, maxx_, maxy_);
+  }
+}
+
+void LayeredCostmap::updateDirtyRegions()
+{
+  dirty_tiles_.getRegions(dirty_regions_);
+  if (dirty_regions_.empty()) {
+    return;
+  }
+
+  // Each plugin updates all regions before the next plugin runs, so the plugins read
+  // the same neighbourhood results as with a single bounding box update
+  Costmap2D & plugins_costmap = filters_.size() == 0 ? combined_costmap_ : primary_costmap_;
+  for (const CellRegion & r : dirty_regions_) {
+    plugins_costmap.resetMap(r.x0, r.y0, r.xn, r.yn);
+  }
+  for (auto & plugin : plugins_) {
+    for (const CellRegion & r : dirty_regions_) {
+      plugin->updateCosts(plugins_costmap, r.x0, r.y0, r.xn, r.yn);
+    }
+  }
+
+  if (filters_.size() == 0) {
+    return;
+  }
+
+  for (const CellRegion & r : dirty_regions_) {
+    if (!combined_costmap_.copyWindow(primary_costmap_, r.x0, r.y0, r.xn, r.yn, r.x0, r.y0)) {
+      RCLCPP_ERROR(
+        rclcpp::get_logger("nav2_costmap_2d"),
+        "Can not copy costmap (%u,%u)..(%u,%u) window",
+        r.x0, r.y0, r.xn, r.yn);
+      throw std::runtime_error{"Can not copy costmap"};
+    }
+  }
+  for (auto & filter : filters_) {
+    for (const CellRegion & r : dirty_regions_) {
+      filter->updateCosts(combined_costmap_, r.x0, r.y0, r.xn, r.yn);
+    }
+  }
 }
 
 bool LayeredCostmap::isOutofBounds(double robot_x, double robot_y)
@@ -132,6 +295,7 @@ bool LayeredCostmap::isOutofBounds(double robot_x, double robot_y)
 
 void LayeredCostmap::updateMap(double robot_x, double robot_y, double robot_yaw)
 {
+  NAV2_TRACE_SCOPE("costmap.updateMap");
   // Lock for the remainder of this function, some plugins (e.g. VoxelLayer)
   // implement thread unsafe updateBounds() functions.
   std::unique_lock<Costmap2D::mutex_t> lock(*(combined_costmap_.getMutex()));
@@ -158,13 +322,38 @@ void LayeredCostmap::updateMap(double robot_x, double robot_y, double robot_yaw)
   minx_ = miny_ = std::numeric_limits<double>::max();
   maxx_ = maxy_ = std::numeric_limits<double>::lowest();
 
+  if (tile_size_ > 0) {
+    if (dirty_tiles_.getSizeInCellsX() != combined_costmap_.getSizeInCellsX() ||
+      dirty_tiles_.getSizeInCellsY() != combined_costmap_.getSizeInCellsY() ||
+      dirty_tiles_.getTileSize() != tile_size_)
+    {
+      dirty_tiles_.resize(
+        combined_costmap_.getSizeInCellsX(), combined_costmap_.getSizeInCellsY(), tile_size_);
+    } else {
+      dirty_tiles_.clear();
+    }
+  }
+
   for (vector<std::shared_ptr<Layer>>::iterator plugin = plugins_.begin();
     plugin != plugins_.end(); ++plugin)
   {
+    if ((thread_pool_ || tile_size_ > 0) && (*plugin)->isUpdateIndependent()) {
+      auto last = plugin + 1;
+      while (last != plugins_.end() && (*last)->isUpdateIndependent()) {
+        ++last;
+      }
+      if (last - plugin > 1 || tile_size_ > 0) {
+        updateIndependentBounds(plugin, last, robot_x, robot_y, robot_yaw);
+        plugin = last - 1;
+        continue;
+      }
+    }
+
     double prev_minx = minx_;
     double prev_miny = miny_;
     double prev_maxx = maxx_;
     double prev_maxy = maxy_;
+    NAV2_TRACE_SCOPE_ID("costmap.layer.updateBounds", plugin - plugins_.begin());
     (*plugin)->updateBounds(robot_x, robot_y, robot_yaw, &minx_, &miny_, &maxx_, &maxy_);
     if (minx_ > prev_minx || miny_ > prev_miny || maxx_ < prev_maxx || maxy_ < prev_maxy) {
       RCLCPP_WARN(
@@ -175,6 +364,10 @@ void LayeredCostmap::updateMap(double robot_x, double robot_y, double robot_yaw)
         minx_, miny_, maxx_, maxy_,
         (*plugin)->getName().c_str());
     }
+    if (tile_size_ > 0) {
+      markDirtyExpansion(
+        prev_minx, prev_miny, prev_maxx, prev_maxy, (*plugin)->isBoundsExpansion());
+    }
   }
   for (vector<std::shared_ptr<Layer>>::iterator filter = filters_.begin();
     filter != filters_.end(); ++filter)
@@ -193,6 +386,10 @@ void LayeredCostmap::updateMap(double robot_x, double robot_y, double robot_yaw)
         minx_, miny_, maxx_, maxy_,
         (*filter)->getName().c_str());
     }
+    if (tile_size_ > 0) {
+      markDirtyExpansion(
+        prev_minx, prev_miny, prev_maxx, prev_maxy, (*filter)->isBoundsExpansion());
+    }
   }
 
   int x0, xn, y0, yn;
@@ -212,12 +409,15 @@ void LayeredCostmap::updateMap(double robot_x, double robot_y, double robot_yaw)
     return;
   }
 
-  if (filters_.size() == 0) {
+  if (tile_size_ > 0) {
+    updateDirtyRegions();
+  } else if (filters_.size() == 0) {
     // If there are no filters enabled just update costmap sequentially by each plugin
     combined_costmap_.resetMap(x0, y0, xn, yn);
     for (vector<std::shared_ptr<Layer>>::iterator plugin = plugins_.begin();
       plugin != plugins_.end(); ++plugin)
     {
+      NAV2_TRACE_SCOPE_ID("costmap.layer.updateCosts", plugin - plugins_.begin());
       (*plugin)->updateCosts(combined_costmap_, x0, y0, xn, yn);
     }
   } else {
@@ -227,6 +427,7 @@ void LayeredCostmap::updateMap(double robot_x, double robot_y, double robot_yaw)
     for (vector<std::shared_ptr<Layer>>::iterator plugin = plugins_.begin();
       plugin != plugins_.end(); ++plugin)
     {
+      NAV2_TRACE_SCOPE_ID("costmap.layer.updateCosts", plugin - plugins_.begin());
       (*plugin)->updateCosts(primary_costmap_, x0, y0, xn, yn);
     }
 
@@ -249,12 +450,97 @@ void LayeredCostmap::updateMap(double robot_x, double robot_y, double robot_yaw)
     }
   }
 
+  if (tile_size_ > 0) {
+    // Report the extent of the regions actually updated rather than the overall bounds
+    if (dirty_regions_.empty()) {
+      return;
+    }
+    x0 = y0 = std::numeric_limits<int>::max();
+    xn = yn = 0;
+    for (const CellRegion & r : dirty_regions_) {
+      x0 = std::min(x0, static_cast<int>(r.x0));
+      y0 = std::min(y0, static_cast<int>(r.y0));
+      xn = std::max(xn, static_cast<int>(r.xn));
+      yn = std::max(yn, static_cast<int>(r.yn));
+    }
+  }
+
   bx0_ = x0;
   bxn_ = xn;
   by0_ = y0;
   byn_ = yn;
 
   initialized_ = true;
+
+  if (snapshots_requested_) {
+    publishSnapshot(CellRegion{bx0_, by0_, bxn_, byn_});
+  }
+}
+
+CostmapSnapshot::ConstPtr LayeredCostmap::getSnapshot()
+{
+  CostmapSnapshot::ConstPtr snapshot = std::atomic_load(&snapshot_);
+  if (snapshot) {
+    return snapshot;
+  }
+
+  // First request: take a snapshot synchronously and have updates maintain it from now on
+  std::unique_lock<Costmap2D::mutex_t> lock(*(combined_costmap_.getMutex()));
+  snapshots_requested_ = true;
+  snapshot = std::atomic_load(&snapshot_);
+  if (!snapshot) {
+    publishSnapshot();
+    snapshot = std::atomic_load(&snapshot_);
+  }
+  return snapshot;
+}
+
+void LayeredCostmap::publishSnapshot()
+{
+  // Any cell may have changed, so earlier updates no longer tell what did
+  snapshot_history_.clear();
+  copySnapshot();
+}
+
+void LayeredCostmap::publishSnapshot(const CellRegion & updated_region)
+{
+  // Only histories of the same grid can be compared, rolling windows move it
+  static constexpr size_t kHistorySize = 32;
+  CostmapSnapshot::ConstPtr current = std::atomic_load(&snapshot_);
+  if (!current ||
+    current->getSizeInCellsX() != combined_costmap_.getSizeInCellsX() ||
+    current->getSizeInCellsY() != combined_costmap_.getSizeInCellsY() ||
+    current->getResolution() != combined_costmap_.getResolution() ||
+    current->getOriginX() != combined_costmap_.getOriginX() ||
+    current->getOriginY() != combined_costmap_.getOriginY())
+  {
+    snapshot_history_.clear();
+  } else {
+    snapshot_history_.insert(snapshot_history_.begin(), updated_region);
+    if (snapshot_history_.size() > kHistorySize) {
+      snapshot_history_.pop_back();
+    }
+  }
+  copySnapshot();
+}
+
+void LayeredCostmap::copySnapshot()
+{
+  // Reuse the previous snapshot's storage if no reader is holding it anymore. Once it has been
+  // swapped out of snapshot_ nobody can acquire a new reference to it, so the check is race free.
+  CostmapSnapshot::Ptr next;
+  if (spare_snapshot_ && spare_snapshot_.use_count() == 1) {
+    next = std::move(spare_snapshot_);
+  } else {
+    next = std::make_shared<CostmapSnapshot>();
+  }
+  spare_snapshot_.reset();
+
+  next->copyFrom(combined_costmap_, ++snapshot_revision_);
+  next->setUpdateHistory(snapshot_history_);
+  CostmapSnapshot::ConstPtr previous =
+    std::atomic_exchange(&snapshot_, CostmapSnapshot::ConstPtr(next));
+  spare_snapshot_ = std::const_pointer_cast<CostmapSnapshot>(previous);
 }
 
 bool LayeredCostmap::isCurrent()
@@ -37,7 +37,7 @@
 #include "nav2_costmap_2d/observation_buffer.hpp"
 
 #include <algorithm>
-#include <list>
+#include <cmath>
 #include <string>
 #include <vector>
 #include <chrono>
@@ -59,7 +59,29 @@ ObservationBuffer::ObservationBuffer(
   std::string global_frame,
   std::string sensor_frame,
   tf2::Duration tf_tolerance)
-: tf2_buffer_(tf2_buffer),
+: ObservationBuffer(
+    parent.lock()->get_clock(), parent.lock()->get_logger(), topic_name,
+    observation_keep_time, expected_update_rate, min_obstacle_height, max_obstacle_height,
+    obstacle_max_range, obstacle_min_range, raytrace_max_range, raytrace_min_range,
+    tf2_buffer, global_frame, sensor_frame, tf_tolerance)
+{
+}
+
+ObservationBuffer::ObservationBuffer(
+  const rclcpp::Clock::SharedPtr & clock,
+  const rclcpp::Logger & logger,
+  std::string topic_name,
+  double observation_keep_time,
+  double expected_update_rate,
+  double min_obstacle_height, double max_obstacle_height, double obstacle_max_range,
+  double obstacle_min_range,
+  double raytrace_max_range, double raytrace_min_range, tf2_ros::Buffer & tf2_buffer,
+  std::string global_frame,
+  std::string sensor_frame,
+  tf2::Duration tf_tolerance)
+: clock_(clock),
+  logger_(logger),
+  tf2_buffer_(tf2_buffer),
   observation_keep_time_(rclcpp::Duration::from_seconds(observation_keep_time)),
   expected_update_rate_(rclcpp::Duration::from_seconds(expected_update_rate)),
   global_frame_(global_frame),
@@ -70,10 +92,16 @@ ObservationBuffer::ObservationBuffer(
   raytrace_max_range_(raytrace_max_range), raytrace_min_range_(
     raytrace_min_range), tf_tolerance_(tf_tolerance)
 {
-  auto node = parent.lock();
-  clock_ = node->get_clock();
-  logger_ = node->get_logger();
-  last_updated_ = node->now();
+  last_updated_ = clock_->now();
+
+  // Room for the observations of the keep time at the expected rate, the ring grows
+  // if more come in
+  size_t capacity = 1;
+  if (observation_keep_time > 0.0) {
+    capacity = expected_update_rate > 0.0 ?
+      static_cast<size_t>(std::ceil(observation_keep_time / expected_update_rate)) + 1 : 8;
+  }
+  observation_ring_.resize(capacity);
 }
 
 ObservationBuffer::~ObservationBuffer()
@@ -84,8 +112,10 @@ void ObservationBuffer::bufferCloud(const sensor_msgs::msg::PointCloud2 & cloud)
 {
   geometry_msgs::msg::PointStamped global_origin;
 
-  // create a new observation on the list to be populated
-  observation_list_.push_front(Observation());
+  // populate the spare observation off the ring, so the buffer lock is only held for
+  // the hand over and never across the transform. Its cloud is the one of the last
+  // observation dropped from the ring, so its points are written in place.
+  Observation & observation = spare_;
 
   // check whether the origin frame has been set explicitly
   // or whether we should get it from the cloud
@@ -101,61 +131,104 @@ void ObservationBuffer::bufferCloud(const sensor_msgs::msg::PointCloud2 & cloud)
     local_origin.point.y = 0;
     local_origin.point.z = 0;
     tf2_buffer_.transform(local_origin, global_origin, global_frame_, tf_tolerance_);
-    tf2::convert(global_origin.point, observation_list_.front().origin_);
+    tf2::convert(global_origin.point, observation.origin_);
 
     // make sure to pass on the raytrace/obstacle range
     // of the observation buffer to the observations
-    observation_list_.front().raytrace_max_range_ = raytrace_max_range_;
-    observation_list_.front().raytrace_min_range_ = raytrace_min_range_;
-    observation_list_.front().obstacle_max_range_ = obstacle_max_range_;
-    observation_list_.front().obstacle_min_range_ = obstacle_min_range_;
-
-    sensor_msgs::msg::PointCloud2 global_frame_cloud;
+    observation.raytrace_max_range_ = raytrace_max_range_;
+    observation.raytrace_min_range_ = raytrace_min_range_;
+    observation.obstacle_max_range_ = obstacle_max_range_;
+    observation.obstacle_min_range_ = obstacle_min_range_;
 
-    // transform the point cloud
-    tf2_buffer_.transform(cloud, global_frame_cloud, global_frame_, tf_tolerance_);
-    global_frame_cloud.header.stamp = cloud.header.stamp;
+    // one lookup for the whole cloud, the points are then transformed in a single
+    // pass over the message buffer instead of through an intermediate copy
+    geometry_msgs::msg::TransformStamped transform_msg = tf2_buffer_.lookupTransform(
+      global_frame_, cloud.header.frame_id, tf2_ros::fromMsg(cloud.header.stamp),
+      tf_tolerance_);
+    tf2::Transform transform;
+    tf2::fromMsg(transform_msg.transform, transform);
+    const tf2::Matrix3x3 & basis = transform.getBasis();
+    const tf2::Vector3 & translation = transform.getOrigin();
+    const float r00 = basis[0][0], r01 = basis[0][1], r02 = basis[0][2];
+    const float r10 = basis[1][0], r11 = basis[1][1], r12 = basis[1][2];
+    const float r20 = basis[2][0], r21 = basis[2][1], r22 = basis[2][2];
+    const float tx = translation.x(), ty = translation.y(), tz = translation.z();
 
     // now we need to remove observations from the cloud that are below
     // or above our height thresholds
-    sensor_msgs::msg::PointCloud2 & observation_cloud = *(observation_list_.front().cloud_);
-    observation_cloud.height = global_frame_cloud.height;
-    observation_cloud.width = global_frame_cloud.width;
-    observation_cloud.fields = global_frame_cloud.fields;
-    observation_cloud.is_bigendian = global_frame_cloud.is_bigendian;
-    observation_cloud.point_step = global_frame_cloud.point_step;
-    observation_cloud.row_step = global_frame_cloud.row_step;
-    observation_cloud.is_dense = global_frame_cloud.is_dense;
-
-    unsigned int cloud_size = global_frame_cloud.height * global_frame_cloud.width;
+    sensor_msgs::msg::PointCloud2 & observation_cloud = *(observation.cloud_);
+    observation_cloud.height = cloud.height;
+    observation_cloud.width = cloud.width;
+    observation_cloud.fields = cloud.fields;
+    observation_cloud.is_bigendian = cloud.is_bigendian;
+    observation_cloud.point_step = cloud.point_step;
+    observation_cloud.row_step = cloud.row_step;
+    observation_cloud.is_dense = cloud.is_dense;
+
+    unsigned int cloud_size = cloud.height * cloud.width;
     sensor_msgs::PointCloud2Modifier modifier(observation_cloud);
     modifier.resize(cloud_size);
     unsigned int point_count = 0;
 
+    const bool voxel_filter = voxel_resolution_ > 0.0;
+    if (voxel_filter) {
+      voxel_keys_.clear();
+    }
+
     // copy over the points that are within our height bounds
-    sensor_msgs::PointCloud2Iterator<float> iter_z(global_frame_cloud, "z");
-    std::vector<unsigned char>::const_iterator iter_global = global_frame_cloud.data.begin(),
-      iter_global_end = global_frame_cloud.data.end();
+    sensor_msgs::PointCloud2ConstIterator<float> iter_x(cloud, "x");
+    sensor_msgs::PointCloud2ConstIterator<float> iter_y(cloud, "y");
+    sensor_msgs::PointCloud2ConstIterator<float> iter_z(cloud, "z");
+    sensor_msgs::PointCloud2Iterator<float> iter_obs_x(observation_cloud, "x");
+    sensor_msgs::PointCloud2Iterator<float> iter_obs_y(observation_cloud, "y");
+    sensor_msgs::PointCloud2Iterator<float> iter_obs_z(observation_cloud, "z");
+    std::vector<unsigned char>::const_iterator iter_global = cloud.data.begin(),
+      iter_global_end = cloud.data.begin() + cloud_size * cloud.point_step;
     std::vector<unsigned char>::iterator iter_obs = observation_cloud.data.begin();
-    for (; iter_global != iter_global_end; ++iter_z, iter_global +=
-      global_frame_cloud.point_step)
+    for (; iter_global != iter_global_end;
+      ++iter_x, ++iter_y, ++iter_z, iter_global += cloud.point_step)
     {
-      if ((*iter_z) <= max_obstacle_height_ &&
-        (*iter_z) >= min_obstacle_height_)
-      {
-        std::copy(iter_global, iter_global + global_frame_cloud.point_step, iter_obs);
-        iter_obs += global_frame_cloud.point_step;
-        ++point_count;
+      const float x = *iter_x, y = *iter_y, z = *iter_z;
+      const float gz = r20 * x + r21 * y + r22 * z + tz;
+      if (gz > max_obstacle_height_ || gz < min_obstacle_height_) {
+        continue;
       }
+      const float gx = r00 * x + r01 * y + r02 * z + tx;
+      const float gy = r10 * x + r11 * y + r12 * z + ty;
+
+      if (voxel_filter) {
+        // 21 bits per axis, wrapping only for clouds spanning over a million voxels
+        const uint64_t vx =
+          static_cast<int64_t>(std::floor((gx - voxel_origin_x_) / voxel_resolution_));
+        const uint64_t vy =
+          static_cast<int64_t>(std::floor((gy - voxel_origin_y_) / voxel_resolution_));
+        const uint64_t vz =
+          static_cast<int64_t>(std::floor((gz - voxel_origin_z_) / voxel_z_resolution_));
+        const uint64_t key =
+          ((vx & 0x1FFFFF) << 42) | ((vy & 0x1FFFFF) << 21) | (vz & 0x1FFFFF);
+        if (!voxel_keys_.insert(key).second) {
+          continue;
+        }
+      }
+
+      // keep any extra fields of the point, then overwrite its position
+      std::copy(iter_global, iter_global + cloud.point_step, iter_obs);
+      *iter_obs_x = gx;
+      *iter_obs_y = gy;
+      *iter_obs_z = gz;
+      iter_obs += cloud.point_step;
+      ++iter_obs_x;
+      ++iter_obs_y;
+      ++iter_obs_z;
+      ++point_count;
     }
 
     // resize the cloud for the number of legal points
     modifier.resize(point_count);
     observation_cloud.header.stamp = cloud.header.stamp;
-    observation_cloud.header.frame_id = global_frame_cloud.header.frame_id;
+    observation_cloud.header.frame_id = global_frame_;
   } catch (tf2::TransformException & ex) {
-    // if an exception occurs, we need to remove the empty observation from the list
-    observation_list_.pop_front();
+    // if an exception occurs, the pending observation is simply dropped
     RCLCPP_ERROR(
       logger_,
       "TF Exception that should never happen for sensor frame: %s, cloud frame: %s, %s",
@@ -164,11 +237,36 @@ void ObservationBuffer::bufferCloud(const sensor_msgs::msg::PointCloud2 & cloud)
     return;
   }
 
+  std::lock_guard<std::recursive_mutex> guard(lock_);
+  purgeStaleObservations();
+  if (count_ == observation_ring_.size() && observation_keep_time_ > rclcpp::Duration(0.0s)) {
+    // every observation is still fresh, double the ring, the oldest first
+    std::vector<Observation> ring(2 * observation_ring_.size());
+    for (size_t i = 0; i < count_; ++i) {
+      ring[i].swap(observationAt(sequence_ - count_ + i));
+    }
+    observation_ring_.swap(ring);
+    head_ = count_ - 1;
+  }
+  head_ = (head_ + 1) % observation_ring_.size();
+  observation_ring_[head_].swap(spare_);
+  count_ = std::min(count_ + 1, observation_ring_.size());
+  ++sequence_;
+
   // if the update was successful, we want to update the last updated time
   last_updated_ = clock_->now();
 
-  // we'll also remove any stale observations from the list
-  purgeStaleObservations();
+}
+
+void ObservationBuffer::setVoxelFilter(
+  double resolution, double z_resolution,
+  double origin_x, double origin_y, double origin_z)
+{
+  voxel_resolution_ = resolution;
+  voxel_z_resolution_ = z_resolution > 0.0 ? z_resolution : resolution;
+  voxel_origin_x_ = origin_x;
+  voxel_origin_y_ = origin_y;
+  voxel_origin_z_ = origin_z;
 }
 
 // returns a copy of the observations
@@ -177,35 +275,45 @@ void ObservationBuffer::getObservations(std::vector<Observation> & observations)
   // first... let's make sure that we don't have any stale observations
   purgeStaleObservations();
 
-  // now we'll just copy the observations for the caller
-  std::list<Observation>::iterator obs_it;
-  for (obs_it = observation_list_.begin(); obs_it != observation_list_.end(); ++obs_it) {
-    observations.push_back(*obs_it);
+  // now we'll just copy the observations for the caller, the newest first
+  for (size_t i = 0; i < count_; ++i) {
+    observations.push_back(observationAt(sequence_ - 1 - i));
+  }
+}
+
+void ObservationBuffer::visitNewObservations(
+  uint64_t & sequence, const std::function<void(const Observation &)> & fn)
+{
+  purgeStaleObservations();
+
+  // observations dropped from the ring before the visit are skipped
+  for (uint64_t i = std::max(sequence, sequence_ - count_); i < sequence_; ++i) {
+    fn(observationAt(i));
   }
+  sequence = sequence_;
+}
+
+Observation & ObservationBuffer::observationAt(uint64_t sequence)
+{
+  const size_t age = static_cast<size_t>(sequence_ - 1 - sequence);
+  return observation_ring_[(head_ + observation_ring_.size() - age) % observation_ring_.size()];
 }
 
 void ObservationBuffer::purgeStaleObservations()
 {
-  if (!observation_list_.empty()) {
-    std::list<Observation>::iterator obs_it = observation_list_.begin();
-    // if we're keeping observations for no time... then we'll only keep one observation
-    if (observation_keep_time_ == rclcpp::Duration(0.0s)) {
-      observation_list_.erase(++obs_it, observation_list_.end());
-      return;
-    }
+  // if we're keeping observations for no time... then we'll only keep one observation
+  if (observation_keep_time_ == rclcpp::Duration(0.0s)) {
+    count_ = std::min<size_t>(count_, 1);
+    return;
+  }
 
-    // otherwise... we'll have to loop through the observations to see which ones are stale
-    for (obs_it = observation_list_.begin(); obs_it != observation_list_.end(); ++obs_it) {
-      Observation & obs = *obs_it;
-      // check if the observation is out of date... and if it is,
-      // remove it and those that follow from the list
-      if ((clock_->now() - obs.cloud_->header.stamp) >
-        observation_keep_time_)
-      {
-        observation_list_.erase(obs_it, observation_list_.end());
-        return;
-      }
-    }
+  // otherwise... the oldest observations are dropped as long as they are out of date,
+  // their slots are only reused by the next observations
+  const rclcpp::Time now = clock_->now();
+  while (count_ > 0 &&
+    (now - observationAt(sequence_ - count_).cloud_->header.stamp) > observation_keep_time_)
+  {
+    --count_;
   }
 }
 
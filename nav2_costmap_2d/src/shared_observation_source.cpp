@@ -0,0 +1,256 @@
+// Copyright (c) 2024 Open Navigation LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "nav2_costmap_2d/shared_observation_source.hpp"
+
+#include <cmath>
+#include <memory>
+#include <string>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+#include "nav2_util/node_utils.hpp"
+#include "tf2_ros/create_timer_ros.h"
+
+namespace nav2_costmap_2d
+{
+
+bool
+ObservationSourceConfig::operator<(const ObservationSourceConfig & other) const
+{
+  auto tie = [](const ObservationSourceConfig & c) {
+      return std::tie(
+        c.topic, c.data_type, c.global_frame, c.sensor_frame, c.observation_keep_time,
+        c.expected_update_rate, c.min_obstacle_height, c.max_obstacle_height,
+        c.obstacle_max_range, c.obstacle_min_range, c.raytrace_max_range,
+        c.raytrace_min_range, c.transform_tolerance, c.inf_is_valid, c.voxel_resolution,
+        c.voxel_origin_x, c.voxel_origin_y);
+    };
+  return tie(*this) < tie(other);
+}
+
+ObservationSourceHub::ObservationSourceHub(const nav2_util::LifecycleNode::SharedPtr & node)
+{
+  bool use_sim_time = false;
+  node->get_parameter("use_sim_time", use_sim_time);
+  auto options =
+    rclcpp::NodeOptions()
+    .start_parameter_services(false)
+    .start_parameter_event_publisher(false)
+    .use_global_arguments(false)
+    .parameter_overrides({rclcpp::Parameter("use_sim_time", use_sim_time)});
+  node_ = std::make_shared<rclcpp::Node>(
+    nav2_util::generate_internal_node_name("costmap_observation_sources"),
+    node->get_namespace(), options);
+
+  tf_ = std::make_shared<tf2_ros::Buffer>(node_->get_clock());
+  auto timer_interface = std::make_shared<tf2_ros::CreateTimerROS>(
+    node_->get_node_base_interface(), node_->get_node_timers_interface());
+  tf_->setCreateTimerInterface(timer_interface);
+  tf_listener_ = std::make_shared<tf2_ros::TransformListener>(*tf_);
+  executor_thread_ = std::make_unique<nav2_util::NodeThread>(node_);
+}
+
+ObservationSourceHub::~ObservationSourceHub()
+{
+  // No callback may run while the filters and subscriptions go away
+  executor_thread_.reset();
+  sources_.clear();
+  topics_.clear();
+  tf_listener_.reset();
+  tf_.reset();
+}
+
+std::shared_ptr<SharedObservationSource>
+SharedObservationSource::get(
+  const ObservationSourceConfig & config,
+  const nav2_util::LifecycleNode::SharedPtr & node)
+{
+  static std::mutex hub_mutex;
+  static std::weak_ptr<ObservationSourceHub> weak_hub;
+
+  std::shared_ptr<ObservationSourceHub> hub;
+  {
+    std::lock_guard<std::mutex> lock(hub_mutex);
+    hub = weak_hub.lock();
+    if (!hub) {
+      hub = std::make_shared<ObservationSourceHub>(node);
+      weak_hub = hub;
+    }
+  }
+
+  std::lock_guard<std::mutex> lock(hub->mutex_);
+  auto & source = hub->sources_[config];
+  if (!source) {
+    rmw_qos_profile_t custom_qos_profile = rmw_qos_profile_sensor_data;
+    custom_qos_profile.depth = 50;
+
+    auto & topic = hub->topics_[config.data_type + ":" + config.topic];
+    if (!topic) {
+      topic = std::make_unique<Topic>();
+      if (config.data_type == "LaserScan") {
+        topic->subscriber =
+          std::make_shared<message_filters::Subscriber<sensor_msgs::msg::LaserScan>>(
+          hub->node_, config.topic, custom_qos_profile);
+      } else {
+        topic->subscriber =
+          std::make_shared<message_filters::Subscriber<sensor_msgs::msg::PointCloud2>>(
+          hub->node_, config.topic, custom_qos_profile);
+      }
+      topic->subscriber->unsubscribe();
+    }
+    source = std::make_unique<SharedObservationSource>(config, *hub, *topic);
+  }
+
+  // Holding a source holds the hub, which owns it
+  return std::shared_ptr<SharedObservationSource>(hub, source.get());
+}
+
+SharedObservationSource::SharedObservationSource(
+  const ObservationSourceConfig & config, ObservationSourceHub & hub, Topic & topic)
+: config_(config), hub_(hub), topic_(topic)
+{
+  buffer_ = std::make_shared<ObservationBuffer>(
+    hub.node_->get_clock(), hub.node_->get_logger(), config.topic,
+    config.observation_keep_time, config.expected_update_rate,
+    config.min_obstacle_height, config.max_obstacle_height,
+    config.obstacle_max_range, config.obstacle_min_range,
+    config.raytrace_max_range, config.raytrace_min_range, *hub.tf_,
+    config.global_frame, config.sensor_frame,
+    tf2::durationFromSec(config.transform_tolerance));
+  if (config.voxel_resolution > 0.0) {
+    buffer_->setVoxelFilter(
+      config.voxel_resolution, config.voxel_resolution,
+      config.voxel_origin_x, config.voxel_origin_y);
+  }
+
+  if (config.data_type == "LaserScan") {
+    auto sub = std::static_pointer_cast<
+      message_filters::Subscriber<sensor_msgs::msg::LaserScan>>(topic.subscriber);
+    auto filter = std::make_shared<tf2_ros::MessageFilter<sensor_msgs::msg::LaserScan>>(
+      *sub, *hub.tf_, config.global_frame, 50,
+      hub.node_->get_node_logging_interface(),
+      hub.node_->get_node_clock_interface(),
+      tf2::durationFromSec(config.transform_tolerance));
+    filter->registerCallback(
+      [this](sensor_msgs::msg::LaserScan::ConstSharedPtr message) {
+        bufferLaserScan(*message);
+      });
+    filter->setTolerance(rclcpp::Duration::from_seconds(0.05));
+    filter_ = filter;
+  } else {
+    auto sub = std::static_pointer_cast<
+      message_filters::Subscriber<sensor_msgs::msg::PointCloud2>>(topic.subscriber);
+    auto filter = std::make_shared<tf2_ros::MessageFilter<sensor_msgs::msg::PointCloud2>>(
+      *sub, *hub.tf_, config.global_frame, 50,
+      hub.node_->get_node_logging_interface(),
+      hub.node_->get_node_clock_interface(),
+      tf2::durationFromSec(config.transform_tolerance));
+    filter->registerCallback(
+      [this](sensor_msgs::msg::PointCloud2::ConstSharedPtr message) {
+        bufferCloud(*message);
+      });
+    filter_ = filter;
+  }
+
+  if (config.sensor_frame != "") {
+    filter_->setTargetFrames({config.global_frame, config.sensor_frame});
+  }
+}
+
+size_t
+SharedObservationSource::addListener(std::function<void()> callback)
+{
+  std::lock_guard<std::mutex> lock(listeners_mutex_);
+  listeners_[next_listener_] = std::move(callback);
+  return next_listener_++;
+}
+
+void
+SharedObservationSource::removeListener(size_t id)
+{
+  std::lock_guard<std::mutex> lock(listeners_mutex_);
+  listeners_.erase(id);
+}
+
+void
+SharedObservationSource::activate()
+{
+  std::lock_guard<std::mutex> lock(hub_.mutex_);
+  if (topic_.active++ == 0) {
+    filter_->clear();
+    topic_.subscriber->subscribe();
+  }
+  buffer_->resetLastUpdated();
+}
+
+void
+SharedObservationSource::deactivate()
+{
+  std::lock_guard<std::mutex> lock(hub_.mutex_);
+  if (topic_.active > 0 && --topic_.active == 0) {
+    topic_.subscriber->unsubscribe();
+  }
+}
+
+void
+SharedObservationSource::bufferCloud(const sensor_msgs::msg::PointCloud2 & cloud)
+{
+  buffer_->bufferCloud(cloud);
+
+  std::lock_guard<std::mutex> lock(listeners_mutex_);
+  for (auto & listener : listeners_) {
+    listener.second();
+  }
+}
+
+void
+SharedObservationSource::bufferLaserScan(const sensor_msgs::msg::LaserScan & message)
+{
+  sensor_msgs::msg::LaserScan filtered_message;
+  const sensor_msgs::msg::LaserScan * scan = &message;
+  if (config_.inf_is_valid) {
+    // Positive infinities to max range, as the obstacle layer
+    filtered_message = message;
+    for (auto & range : filtered_message.ranges) {
+      if (!std::isfinite(range) && range > 0) {
+        range = filtered_message.range_max - 0.0001;
+      }
+    }
+    scan = &filtered_message;
+  }
+
+  sensor_msgs::msg::PointCloud2 cloud;
+  cloud.header = scan->header;
+  try {
+    projector_.transformLaserScanToPointCloud(scan->header.frame_id, *scan, cloud, *hub_.tf_);
+  } catch (tf2::TransformException & ex) {
+    RCLCPP_WARN(
+      hub_.node_->get_logger(),
+      "High fidelity enabled, but TF returned a transform exception to frame %s: %s",
+      config_.global_frame.c_str(), ex.what());
+    projector_.projectLaser(*scan, cloud);
+  } catch (std::runtime_error & ex) {
+    RCLCPP_WARN(
+      hub_.node_->get_logger(),
+      "transformLaserScanToPointCloud error, it seems the message from laser is malformed."
+      " Ignore this message. what(): %s",
+      ex.what());
+    return;
+  }
+  bufferCloud(cloud);
+}
+
+}  // namespace nav2_costmap_2d
@@ -0,0 +1,203 @@
+// Copyright (c) 2024 Open Navigation LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "nav2_costmap_2d/voxel_grid_columns.hpp"
+
+#include <algorithm>
+
+namespace nav2_costmap_2d
+{
+
+VoxelGridColumns::VoxelGridColumns(unsigned int tile_size)
+: tile_size_(std::max(1u, tile_size))
+{
+}
+
+void VoxelGridColumns::setGrid(const nav2_msgs::msg::VoxelGrid & grid)
+{
+  if (grid.data.size() != static_cast<size_t>(grid.size_x) * grid.size_y) {
+    return;
+  }
+
+  setGeometry(grid.origin, grid.resolutions, grid.size_x, grid.size_y, grid.size_z);
+  for (uint32_t i = 0; i < grid.data.size(); ++i) {
+    if (columns_[i] != grid.data[i]) {
+      columns_[i] = grid.data[i];
+      markColumn(i);
+    }
+  }
+
+  // A whole grid is not part of the update stream
+  synchronized_ = false;
+}
+
+bool VoxelGridColumns::applyUpdate(const nav2_msgs::msg::VoxelGridUpdate & update)
+{
+  if (update.keyframe) {
+    if (update.data.size() != static_cast<size_t>(update.size_x) * update.size_y) {
+      synchronized_ = false;
+      return false;
+    }
+
+    setGeometry(update.origin, update.resolutions, update.size_x, update.size_y, update.size_z);
+    for (uint32_t i = 0; i < update.data.size(); ++i) {
+      if (columns_[i] != update.data[i]) {
+        columns_[i] = update.data[i];
+        markColumn(i);
+      }
+    }
+    sequence_ = update.sequence;
+    synchronized_ = true;
+    return true;
+  }
+
+  // Deltas never change the geometry, the publisher sends a keyframe instead
+  if (!synchronized_ || update.sequence != sequence_ + 1 ||
+    update.size_x != size_x_ || update.size_y != size_y_ || update.size_z != size_z_ ||
+    update.indices.size() != update.data.size())
+  {
+    synchronized_ = false;
+    return false;
+  }
+
+  for (size_t i = 0; i < update.indices.size(); ++i) {
+    const uint32_t index = update.indices[i];
+    if (index < columns_.size() && columns_[index] != update.data[i]) {
+      columns_[index] = update.data[i];
+      markColumn(index);
+    }
+  }
+  sequence_ = update.sequence;
+  return true;
+}
+
+void VoxelGridColumns::setGeometry(
+  const geometry_msgs::msg::Point32 & origin, const geometry_msgs::msg::Vector3 & resolutions,
+  uint32_t size_x, uint32_t size_y, uint32_t size_z)
+{
+  if (size_x == size_x_ && size_y == size_y_ && size_z == size_z_ &&
+    origin.x == origin_x_ && origin.y == origin_y_ && origin.z == origin_z_ &&
+    static_cast<float>(resolutions.x) == resolution_x_ &&
+    static_cast<float>(resolutions.y) == resolution_y_ &&
+    static_cast<float>(resolutions.z) == resolution_z_)
+  {
+    return;
+  }
+
+  size_x_ = size_x;
+  size_y_ = size_y;
+  size_z_ = size_z;
+  origin_x_ = origin.x;
+  origin_y_ = origin.y;
+  origin_z_ = origin.z;
+  resolution_x_ = static_cast<float>(resolutions.x);
+  resolution_y_ = static_cast<float>(resolutions.y);
+  resolution_z_ = static_cast<float>(resolutions.z);
+
+  // Every voxel center moves, convert every tile again
+  tiles_x_ = (size_x_ + tile_size_ - 1) / tile_size_;
+  tiles_y_ = (size_y_ + tile_size_ - 1) / tile_size_;
+  const size_t num_tiles = static_cast<size_t>(tiles_x_) * tiles_y_;
+  columns_.assign(static_cast<size_t>(size_x_) * size_y_, 0);
+  changed_tiles_.assign(num_tiles, 1);
+  marked_.resize(num_tiles);
+  unknown_.resize(num_tiles);
+}
+
+void VoxelGridColumns::markColumn(uint32_t index)
+{
+  const unsigned int x = index % size_x_;
+  const unsigned int y = index / size_x_;
+  changed_tiles_[(y / tile_size_) * tiles_x_ + x / tile_size_] = 1;
+}
+
+unsigned int VoxelGridColumns::convertChangedTiles()
+{
+  unsigned int converted = 0;
+  for (unsigned int tile = 0; tile < changed_tiles_.size(); ++tile) {
+    if (changed_tiles_[tile]) {
+      convertTile(tile);
+      changed_tiles_[tile] = 0;
+      ++converted;
+    }
+  }
+  return converted;
+}
+
+void VoxelGridColumns::convertTile(unsigned int tile)
+{
+  std::vector<VoxelPoint> & marked = marked_[tile];
+  std::vector<VoxelPoint> & unknown = unknown_[tile];
+  marked.clear();
+  unknown.clear();
+
+  const uint32_t z_mask = size_z_ >= 16 ? 0xFFFFu : (1u << size_z_) - 1u;
+  const unsigned int x0 = (tile % tiles_x_) * tile_size_;
+  const unsigned int y0 = (tile / tiles_x_) * tile_size_;
+  const unsigned int xn = std::min(x0 + tile_size_, size_x_);
+  const unsigned int yn = std::min(y0 + tile_size_, size_y_);
+
+  for (unsigned int y = y0; y < yn; ++y) {
+    const float wy = origin_y_ + (y + 0.5f) * resolution_y_;
+    for (unsigned int x = x0; x < xn; ++x) {
+      const uint32_t column = columns_[y * size_x_ + x];
+      // Voxel z is marked with both bits z and z + 16 set, unknown with only one of them
+      const uint32_t low = column & 0xFFFFu;
+      const uint32_t high = column >> 16;
+      uint32_t marked_bits = low & high & z_mask;
+      uint32_t unknown_bits = (low ^ high) & z_mask;
+      if ((marked_bits | unknown_bits) == 0) {
+        continue;
+      }
+
+      const float wx = origin_x_ + (x + 0.5f) * resolution_x_;
+      while (marked_bits) {
+        const unsigned int z = __builtin_ctz(marked_bits);
+        marked.push_back(VoxelPoint{wx, wy, origin_z_ + (z + 0.5f) * resolution_z_});
+        marked_bits &= marked_bits - 1;
+      }
+      while (unknown_bits) {
+        const unsigned int z = __builtin_ctz(unknown_bits);
+        unknown.push_back(VoxelPoint{wx, wy, origin_z_ + (z + 0.5f) * resolution_z_});
+        unknown_bits &= unknown_bits - 1;
+      }
+    }
+  }
+}
+
+void VoxelGridColumns::getMarked(std::vector<VoxelPoint> & points) const
+{
+  gatherPoints(marked_, points);
+}
+
+void VoxelGridColumns::getUnknown(std::vector<VoxelPoint> & points) const
+{
+  gatherPoints(unknown_, points);
+}
+
+void VoxelGridColumns::gatherPoints(
+  const std::vector<std::vector<VoxelPoint>> & tiles, std::vector<VoxelPoint> & points)
+{
+  size_t size = 0;
+  for (const auto & tile : tiles) {
+    size += tile.size();
+  }
+  points.clear();
+  points.reserve(size);
+  for (const auto & tile : tiles) {
+    points.insert(points.end(), tile.begin(), tile.end());
+  }
+}
+
+}  // namespace nav2_costmap_2d
@@ -402,6 +402,105 @@ TEST_F(TestNode, testCostFunctionCorrectness)
       ASSERT_EQ(map->getCost(i, j), nav2_costmap_2d::FREE_SPACE);*/
 }
 
+/**
+ * Test that the distance transform inflation gives the same costs as the search based one
+ */
+TEST_F(TestNode, testDistanceTransformInflation)
+{
+  std::vector<rclcpp::Parameter> parameters;
+  parameters.push_back(rclcpp::Parameter("inflation.cost_scaling_factor", 1.0));
+  parameters.push_back(rclcpp::Parameter("inflation.inflation_radius", 10.5));
+  parameters.push_back(rclcpp::Parameter("inflation.use_distance_transform", true));
+  initNode(parameters);
+
+  tf2_ros::Buffer tf(node_->get_clock());
+  nav2_costmap_2d::LayeredCostmap layers("frame", false, false);
+  layers.resizeMap(100, 100, 1, 0, 0);
+  std::vector<Point> polygon = setRadii(layers, 5.0, 6.25);
+
+  std::shared_ptr<nav2_costmap_2d::ObstacleLayer> olayer = nullptr;
+  addObstacleLayer(layers, tf, node_, olayer);
+  std::shared_ptr<nav2_costmap_2d::InflationLayer> ilayer = nullptr;
+  addInflationLayer(layers, tf, node_, ilayer);
+  layers.setFootprint(polygon);
+
+  addObservation(olayer, 30, 30, MAX_Z, 0.0, 0.0, MAX_Z, true, false);
+  addObservation(olayer, 70, 60, MAX_Z, 0.0, 0.0, MAX_Z, true, false);
+  layers.updateMap(0, 0, 0);
+  nav2_costmap_2d::Costmap2D transform_costmap(*layers.getCostmap());
+
+  for (unsigned int i = (unsigned int)(ceil(5.0) + 1); i <= (unsigned int)ceil(10.5); i++) {
+    ASSERT_EQ(transform_costmap.getCost(30 + i, 30), ilayer->computeCost(i / 1.0));
+  }
+
+  // Reinflate the same obstacles with the search based inflation
+  node_->set_parameter(rclcpp::Parameter("inflation.use_distance_transform", false));
+  layers.updateMap(0, 0, 0);
+  nav2_costmap_2d::Costmap2D * search_costmap = layers.getCostmap();
+
+  for (unsigned int j = 0; j < 100; j++) {
+    for (unsigned int i = 0; i < 100; i++) {
+      ASSERT_EQ(transform_costmap.getCost(i, j), search_costmap->getCost(i, j));
+    }
+  }
+}
+
+/**
+ * Test that incremental inflation follows changing obstacles like a full reinflation does
+ */
+TEST_F(TestNode, testIncrementalInflation)
+{
+  std::vector<rclcpp::Parameter> parameters;
+  parameters.push_back(rclcpp::Parameter("inflation.cost_scaling_factor", 1.0));
+  parameters.push_back(rclcpp::Parameter("inflation.inflation_radius", 5.5));
+  parameters.push_back(rclcpp::Parameter("inflation.incremental_inflation", true));
+  parameters.push_back(rclcpp::Parameter("inflation_search.cost_scaling_factor", 1.0));
+  parameters.push_back(rclcpp::Parameter("inflation_search.inflation_radius", 5.5));
+  initNode(parameters);
+
+  tf2_ros::Buffer tf(node_->get_clock());
+  nav2_costmap_2d::LayeredCostmap incremental_layers("frame", false, false);
+  nav2_costmap_2d::LayeredCostmap search_layers("frame", false, false);
+  incremental_layers.resizeMap(50, 50, 1, 0, 0);
+  search_layers.resizeMap(50, 50, 1, 0, 0);
+  std::vector<Point> polygon = setRadii(incremental_layers, 2.1, 2.3);
+  setRadii(search_layers, 2.1, 2.3);
+
+  std::shared_ptr<nav2_costmap_2d::InflationLayer> ilayer = nullptr;
+  addInflationLayer(incremental_layers, tf, node_, ilayer);
+  auto slayer = std::make_shared<nav2_costmap_2d::InflationLayer>();
+  slayer->initialize(&search_layers, "inflation_search", &tf, node_, nullptr);
+  search_layers.addPlugin(slayer);
+  incremental_layers.setFootprint(polygon);
+  search_layers.setFootprint(polygon);
+
+  const std::vector<std::vector<std::pair<unsigned int, unsigned int>>> cycles = {
+    {{10, 10}, {40, 40}},
+    {{10, 10}, {25, 30}},
+    {{25, 30}},
+    {}
+  };
+
+  nav2_costmap_2d::Costmap2D * incremental = incremental_layers.getCostmap();
+  nav2_costmap_2d::Costmap2D * search = search_layers.getCostmap();
+  for (const auto & obstacles : cycles) {
+    incremental->resetMap(0, 0, 50, 50);
+    search->resetMap(0, 0, 50, 50);
+    for (const auto & obstacle : obstacles) {
+      incremental->setCost(obstacle.first, obstacle.second, nav2_costmap_2d::LETHAL_OBSTACLE);
+      search->setCost(obstacle.first, obstacle.second, nav2_costmap_2d::LETHAL_OBSTACLE);
+    }
+    ilayer->updateCosts(*incremental, 0, 0, 50, 50);
+    slayer->updateCosts(*search, 0, 0, 50, 50);
+
+    for (unsigned int j = 0; j < 50; j++) {
+      for (unsigned int i = 0; i < 50; i++) {
+        ASSERT_EQ(incremental->getCost(i, j), search->getCost(i, j));
+      }
+    }
+  }
+}
+
 /**
  * Test that there is no regression and that costs do not get
  * underestimated with the distance-as-key map used to replace
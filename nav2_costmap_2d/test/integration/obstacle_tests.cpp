@@ -408,6 +408,59 @@ TEST_F(TestNode, testRaytracing) {
   ASSERT_EQ(lethal_count, 1);
 }
 
+/**
+ * Test for ray tracing free space with angular binning of the endpoints
+ */
+TEST_F(TestNode, testRaytracingAngularBins) {
+  tf2_ros::Buffer tf(node_->get_clock());
+
+  nav2_costmap_2d::LayeredCostmap layers("frame", false, false);
+  layers.resizeMap(10, 10, 1, 0, 0);
+
+  std::shared_ptr<nav2_costmap_2d::ObstacleLayer> olayer = nullptr;
+  addObstacleLayer(layers, tf, node_, olayer);
+  node_->set_parameter(rclcpp::Parameter("obstacles.raytrace_angular_bin_size", 0.1));
+
+  // One obstacle on the diagonal ray and one beside it
+  olayer->setCost(3, 3, nav2_costmap_2d::LETHAL_OBSTACLE);
+  olayer->setCost(3, 6, nav2_costmap_2d::LETHAL_OBSTACLE);
+
+  // Duplicated endpoints in one bin, only the farthest needs tracing
+  sensor_msgs::msg::PointCloud2 cloud;
+  sensor_msgs::PointCloud2Modifier modifier(cloud);
+  modifier.setPointCloud2FieldsByString(1, "xyz");
+  modifier.resize(3);
+  sensor_msgs::PointCloud2Iterator<float> iter_x(cloud, "x");
+  sensor_msgs::PointCloud2Iterator<float> iter_y(cloud, "y");
+  sensor_msgs::PointCloud2Iterator<float> iter_z(cloud, "z");
+  const double points[3] = {5.5, 9.5, 9.5};
+  for (double point : points) {
+    *iter_x = point;
+    *iter_y = point;
+    *iter_z = MAX_Z / 2;
+    ++iter_x;
+    ++iter_y;
+    ++iter_z;
+  }
+
+  geometry_msgs::msg::Point p;
+  p.x = 0.5;
+  p.y = 0.5;
+  p.z = MAX_Z / 2;
+  nav2_costmap_2d::Observation obs(p, cloud, 100.0, 0.0, 100.0, 0.0);
+  olayer->addStaticObservation(obs, true, true);
+
+  layers.updateMap(0, 0, 0);
+
+  // <3,3> is cleared by the trace to <9,9>, <5,5> and <9,9> are marked
+  nav2_costmap_2d::Costmap2D * costmap = layers.getCostmap();
+  ASSERT_EQ(countValues(*costmap, nav2_costmap_2d::LETHAL_OBSTACLE), 3);
+  ASSERT_EQ(costmap->getCost(3, 3), nav2_costmap_2d::FREE_SPACE);
+  ASSERT_EQ(costmap->getCost(3, 6), nav2_costmap_2d::LETHAL_OBSTACLE);
+  ASSERT_EQ(costmap->getCost(5, 5), nav2_costmap_2d::LETHAL_OBSTACLE);
+  ASSERT_EQ(costmap->getCost(9, 9), nav2_costmap_2d::LETHAL_OBSTACLE);
+}
+
 /**
  * Test dynamic parameter setting of obstacle layer
  */
@@ -438,7 +491,8 @@ TEST_F(TestNode, testDynParamsSetObstacle)
     rclcpp::Parameter("obstacle_layer.combination_method", 5),
     rclcpp::Parameter("obstacle_layer.max_obstacle_height", 4.0),
     rclcpp::Parameter("obstacle_layer.enabled", false),
-    rclcpp::Parameter("obstacle_layer.footprint_clearing_enabled", false)
+    rclcpp::Parameter("obstacle_layer.footprint_clearing_enabled", false),
+    rclcpp::Parameter("obstacle_layer.raytrace_angular_bin_size", 0.05)
   });
 
   rclcpp::spin_until_future_complete(
@@ -449,6 +503,8 @@ TEST_F(TestNode, testDynParamsSetObstacle)
   EXPECT_EQ(costmap->get_parameter("obstacle_layer.max_obstacle_height").as_double(), 4.0);
   EXPECT_EQ(costmap->get_parameter("obstacle_layer.enabled").as_bool(), false);
   EXPECT_EQ(costmap->get_parameter("obstacle_layer.footprint_clearing_enabled").as_bool(), false);
+  EXPECT_EQ(
+    costmap->get_parameter("obstacle_layer.raytrace_angular_bin_size").as_double(), 0.05);
 
   costmap->on_deactivate(rclcpp_lifecycle::State());
   costmap->on_cleanup(rclcpp_lifecycle::State());
@@ -190,6 +190,49 @@ TEST_F(TestCostmapSubscriberShould, handleCostmapUpdateMsgs)
   costmapPublisher->on_deactivate();
 }
 
+TEST_F(TestCostmapSubscriberShould, handleCompressedCostmapUpdateMsgs)
+{
+  bool always_send_full_costmap = false;
+  bool publish_compressed_updates = true;
+  unsigned int keyframe_interval = 2;
+
+  auto compressedSubscriber = std::make_unique<nav2_costmap_2d::CostmapSubscriber>(
+    node, topicName + "_raw", true);
+
+  std::vector<std::vector<std::uint8_t>> expectedCostmaps;
+  std::vector<std::vector<std::uint8_t>> recievedCostmaps;
+
+  auto costmapPublisher = std::make_shared<nav2_costmap_2d::Costmap2DPublisher>(
+    node, costmapToSend.get(), "", topicName, always_send_full_costmap,
+    publish_compressed_updates, keyframe_interval);
+  costmapPublisher->on_activate();
+
+  // Cycle the changes so both keyframes and deltas on top of them are exercised
+  for (int cycle = 0; cycle < 2; ++cycle) {
+    for (const auto & mapChange : mapChanges) {
+      for (const auto & observation : mapChange.observations) {
+        costmapToSend->setCost(observation.x, observation.y, observation.cost);
+      }
+
+      expectedCostmaps.emplace_back(getCurrentCharMapToSend());
+
+      costmapPublisher->updateBounds(mapChange.x0, mapChange.xn, mapChange.y0, mapChange.yn);
+      costmapPublisher->publishCostmap();
+
+      rclcpp::spin_some(node->get_node_base_interface());
+
+      auto costmap = compressedSubscriber->getCostmap();
+      recievedCostmaps.emplace_back(
+        costmap->getCharMap(),
+        costmap->getCharMap() + costmap->getSizeInCellsX() * costmap->getSizeInCellsY());
+    }
+  }
+
+  ASSERT_EQ(expectedCostmaps, recievedCostmaps);
+
+  costmapPublisher->on_deactivate();
+}
+
 TEST_F(
   TestCostmapSubscriberShould,
   throwExceptionIfGetCostmapMethodIsCalledBeforeAnyCostmapMsgReceived)
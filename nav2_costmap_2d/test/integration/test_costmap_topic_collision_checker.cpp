@@ -203,6 +203,22 @@ public:
     return collision_checker_->isCollisionFree(pose);
   }
 
+  std::vector<double> scorePoses(
+    const std::vector<geometry_msgs::msg::Pose2D> & poses, unsigned int orientation_bins)
+  {
+    rclcpp::Time stamp = now();
+    publishPose(poses[0].x, poses[0].y, poses[0].theta, stamp);
+    setPose(poses[0].x, poses[0].y, poses[0].theta, stamp);
+    publishFootprint();
+    publishCostmap();
+    rclcpp::sleep_for(std::chrono::milliseconds(1000));
+
+    std::vector<double> scores;
+    collision_checker_->setOrientationBins(orientation_bins);
+    collision_checker_->scorePoses(poses, scores);
+    return scores;
+  }
+
   void setFootprint(double footprint_padding, double robot_radius)
   {
     std::vector<geometry_msgs::msg::Point> new_footprint;
@@ -362,3 +378,26 @@ TEST_F(TestNode, CollisionSpace)
   // Partially in obstacle
   ASSERT_EQ(collision_checker_->testPose(4.5, 4.5, 0), false);
 }
+
+TEST_F(TestNode, BatchedScores)
+{
+  collision_checker_->setFootprint(0, 1);
+
+  std::vector<geometry_msgs::msg::Pose2D> poses(3);
+  // Free, in obstacle and off the grid
+  poses[0].x = 2.0;
+  poses[0].y = 8.5;
+  poses[1].x = 8.5;
+  poses[1].y = 6.5;
+  poses[1].theta = 0.3;
+  poses[2].x = -5.0;
+  poses[2].y = -5.0;
+
+  for (unsigned int orientation_bins : {0u, 16u}) {
+    std::vector<double> scores = collision_checker_->scorePoses(poses, orientation_bins);
+    ASSERT_EQ(scores.size(), 3u);
+    EXPECT_LT(scores[0], nav2_costmap_2d::LETHAL_OBSTACLE);
+    EXPECT_GE(scores[1], nav2_costmap_2d::LETHAL_OBSTACLE);
+    EXPECT_EQ(scores[2], nav2_costmap_2d::LETHAL_OBSTACLE);
+  }
+}
@@ -0,0 +1,118 @@
+// Copyright (c) 2024 Open Navigation LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+
+#include <functional>
+#include <vector>
+
+#include "nav2_costmap_2d/cost_combination.hpp"
+
+using nav2_costmap_2d::NO_INFORMATION;
+using nav2_costmap_2d::INSCRIBED_INFLATED_OBSTACLE;
+
+using RowKernel = std::function<void(unsigned char *, const unsigned char *, unsigned int)>;
+using CellReference = std::function<unsigned char(unsigned char, unsigned char)>;
+
+// Run a row kernel over every (master, layer) cost pair and compare to a per cell reference
+static void checkAllPairs(const RowKernel & kernel, const CellReference & reference)
+{
+  std::vector<unsigned char> master(256 * 256), layer(256 * 256);
+  for (unsigned int m = 0; m < 256; ++m) {
+    for (unsigned int l = 0; l < 256; ++l) {
+      master[m * 256 + l] = m;
+      layer[m * 256 + l] = l;
+    }
+  }
+  // Odd length to exercise the scalar tail of vectorized loops
+  kernel(master.data(), layer.data(), 256 * 256 - 3);
+
+  for (unsigned int m = 0; m < 256; ++m) {
+    for (unsigned int l = 0; l < 256; ++l) {
+      const unsigned int index = m * 256 + l;
+      const unsigned char expected = index < 256 * 256 - 3 ? reference(m, l) : m;
+      ASSERT_EQ(master[index], expected) << "master " << m << " layer " << l;
+    }
+  }
+}
+
+TEST(CostCombination, max)
+{
+  checkAllPairs(
+    nav2_costmap_2d::combineRowMax,
+    [](unsigned char m, unsigned char l) -> unsigned char {
+      if (l == NO_INFORMATION) {
+        return m;
+      }
+      return (m == NO_INFORMATION || m < l) ? l : m;
+    });
+}
+
+TEST(CostCombination, maxWithoutUnknownOverwrite)
+{
+  checkAllPairs(
+    nav2_costmap_2d::combineRowMaxWithoutUnknownOverwrite,
+    [](unsigned char m, unsigned char l) -> unsigned char {
+      if (l == NO_INFORMATION) {
+        return m;
+      }
+      return (m != NO_INFORMATION && m < l) ? l : m;
+    });
+}
+
+TEST(CostCombination, overwrite)
+{
+  checkAllPairs(
+    nav2_costmap_2d::combineRowOverwrite,
+    [](unsigned char m, unsigned char l) -> unsigned char {
+      return l != NO_INFORMATION ? l : m;
+    });
+  checkAllPairs(
+    nav2_costmap_2d::combineRowTrueOverwrite,
+    [](unsigned char, unsigned char l) -> unsigned char {return l;});
+}
+
+TEST(CostCombination, addition)
+{
+  checkAllPairs(
+    nav2_costmap_2d::combineRowAddition,
+    [](unsigned char m, unsigned char l) -> unsigned char {
+      if (l == NO_INFORMATION) {
+        return m;
+      }
+      if (m == NO_INFORMATION) {
+        return l;
+      }
+      int sum = m + l;
+      return sum >= INSCRIBED_INFLATED_OBSTACLE ? INSCRIBED_INFLATED_OBSTACLE - 1 : sum;
+    });
+}
+
+TEST(CostCombination, translate)
+{
+  std::vector<char> table(256);
+  for (unsigned int i = 0; i < 256; ++i) {
+    table[i] = static_cast<char>(255 - i);
+  }
+  std::vector<unsigned char> costs(300);
+  for (unsigned int i = 0; i < costs.size(); ++i) {
+    costs[i] = static_cast<unsigned char>(i * 7);
+  }
+  std::vector<int8_t> output(300, 0);
+  nav2_costmap_2d::translateRow(output.data(), costs.data(), table.data(), 299);
+  for (unsigned int i = 0; i < 299; ++i) {
+    EXPECT_EQ(output[i], static_cast<int8_t>(table[costs[i]]));
+  }
+  EXPECT_EQ(output[299], 0);
+}
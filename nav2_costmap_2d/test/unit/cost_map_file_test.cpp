@@ -0,0 +1,127 @@
+// Copyright (c) 2024 Open Navigation LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+
+#include <cstdio>
+#include <fstream>
+#include <iterator>
+#include <string>
+
+#include "nav2_costmap_2d/cost_map_file.hpp"
+#include "nav2_costmap_2d/cost_values.hpp"
+
+using nav2_costmap_2d::Costmap2D;
+using nav2_costmap_2d::MappedCostMapFile;
+
+static std::string tempPath(const std::string & name)
+{
+  return "/tmp/" + name + "_" + std::to_string(::testing::UnitTest::GetInstance()->random_seed());
+}
+
+TEST(CostMapFile, saveAndMap)
+{
+  Costmap2D costmap(13, 7, 0.05, -3.0, 4.5);
+  for (unsigned int y = 0; y < 7; ++y) {
+    for (unsigned int x = 0; x < 13; ++x) {
+      costmap.setCost(x, y, static_cast<unsigned char>(x * 13 + y));
+    }
+  }
+  const std::string path = tempPath("cost_map_file_test");
+  ASSERT_TRUE(nav2_costmap_2d::saveCostMapFile(path, costmap, "map"));
+
+  MappedCostMapFile file;
+  std::string error;
+  ASSERT_TRUE(file.open(path, error)) << error;
+  EXPECT_EQ(file.getHeader().size_x, 13u);
+  EXPECT_EQ(file.getHeader().size_y, 7u);
+  EXPECT_DOUBLE_EQ(file.getHeader().resolution, 0.05);
+  EXPECT_DOUBLE_EQ(file.getHeader().origin_x, -3.0);
+  EXPECT_DOUBLE_EQ(file.getHeader().origin_y, 4.5);
+  EXPECT_EQ(std::string(file.getHeader().frame_id), "map");
+  for (unsigned int i = 0; i < 13 * 7; ++i) {
+    ASSERT_EQ(file.getData()[i], costmap.getCharMap()[i]);
+  }
+
+  // Writes stay private to the mapping and can be reverted
+  file.getData()[5] = nav2_costmap_2d::LETHAL_OBSTACLE;
+  MappedCostMapFile other;
+  ASSERT_TRUE(other.open(path, error)) << error;
+  EXPECT_EQ(other.getData()[5], costmap.getCharMap()[5]);
+  file.revert();
+  EXPECT_EQ(file.getData()[5], costmap.getCharMap()[5]);
+
+  file.close();
+  EXPECT_FALSE(file.isOpen());
+  std::remove(path.c_str());
+}
+
+TEST(CostMapFile, rejectInvalidFiles)
+{
+  MappedCostMapFile file;
+  std::string error;
+  EXPECT_FALSE(file.open("/nonexistent/cost_map_file", error));
+  EXPECT_FALSE(error.empty());
+
+  const std::string path = tempPath("cost_map_file_invalid");
+  {
+    std::ofstream out(path, std::ios::binary);
+    out << "not a cost map file, but long enough to hold the header of one. "
+      "not a cost map file, but long enough to hold the header of one.";
+  }
+  EXPECT_FALSE(file.open(path, error));
+  EXPECT_FALSE(file.isOpen());
+
+  // A valid header with missing costs
+  Costmap2D costmap(10, 10, 0.1, 0.0, 0.0);
+  ASSERT_TRUE(nav2_costmap_2d::saveCostMapFile(path, costmap, "map"));
+  {
+    std::ifstream in(path, std::ios::binary);
+    std::string contents((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+    contents.resize(contents.size() - 1);
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    out << contents;
+  }
+  EXPECT_FALSE(file.open(path, error));
+
+  EXPECT_FALSE(
+    nav2_costmap_2d::saveCostMapFile(path, costmap, std::string(64, 'x')));
+  std::remove(path.c_str());
+}
+
+TEST(CostMapFile, mapHash)
+{
+  Costmap2D costmap(10, 10, 0.1, 0.0, 0.0);
+  const size_t size = 100;
+  const uint32_t hash = nav2_costmap_2d::hashCosts(costmap.getCharMap(), size);
+  EXPECT_NE(hash, 0u);
+
+  // Hashing in parts gives the hash of the whole
+  EXPECT_EQ(
+    nav2_costmap_2d::hashCosts(
+      costmap.getCharMap() + 40, size - 40,
+      nav2_costmap_2d::hashCosts(costmap.getCharMap(), 40)), hash);
+
+  costmap.setCost(3, 4, nav2_costmap_2d::LETHAL_OBSTACLE);
+  EXPECT_NE(nav2_costmap_2d::hashCosts(costmap.getCharMap(), size), hash);
+
+  const std::string path = tempPath("cost_map_file_hash");
+  ASSERT_TRUE(nav2_costmap_2d::saveCostMapFile(path, costmap, "map", hash));
+  MappedCostMapFile file;
+  std::string error;
+  ASSERT_TRUE(file.open(path, error)) << error;
+  EXPECT_EQ(file.getHeader().map_hash, hash);
+  file.close();
+  std::remove(path.c_str());
+}
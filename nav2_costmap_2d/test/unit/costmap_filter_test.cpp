@@ -16,6 +16,7 @@
 
 #include <string>
 #include <memory>
+#include <vector>
 
 #include "rclcpp/rclcpp.hpp"
 #include "nav2_util/occ_grid_values.hpp"
@@ -44,6 +45,13 @@ public:
     return nav2_costmap_2d::CostmapFilter::getMaskCost(filter_mask, mx, my);
   }
 
+  int8_t getMaskData(
+    nav2_msgs::msg::SparseFilterMask::ConstSharedPtr sparse_mask,
+    const unsigned int mx, const unsigned int my) const
+  {
+    return nav2_costmap_2d::CostmapFilter::getMaskData(sparse_mask, mx, my);
+  }
+
   // API coverage
   void initializeFilter(const std::string &) {}
   void process(
@@ -129,6 +137,35 @@ TEST(CostmapFilter, testGetMaskCost)
   ASSERT_EQ(cf.getMaskCost(mask, 1, 1), nav2_costmap_2d::LETHAL_OBSTACLE);
 }
 
+TEST(CostmapFilter, testGetSparseMaskData)
+{
+  // Create sparse mask for test as follows:
+  // [0,  0, 100, 100,
+  //  -1, 0,   0,  50]
+
+  auto mask = std::make_shared<nav2_msgs::msg::SparseFilterMask>();
+  mask->header.frame_id = "map";
+  mask->info.resolution = 1.0;
+  mask->info.width = 4;
+  mask->info.height = 2;
+  mask->default_value = nav2_util::OCC_GRID_FREE;
+  mask->row = {0, 1, 1};
+  mask->start = {2, 0, 3};
+  mask->length = {2, 1, 1};
+  mask->value = {nav2_util::OCC_GRID_OCCUPIED, nav2_util::OCC_GRID_UNKNOWN, 50};
+
+  CostmapFilterWrapper cf;
+
+  const std::vector<int8_t> expected = {
+    0, 0, nav2_util::OCC_GRID_OCCUPIED, nav2_util::OCC_GRID_OCCUPIED,
+    nav2_util::OCC_GRID_UNKNOWN, 0, 0, 50};
+  for (unsigned int my = 0; my < 2; my++) {
+    for (unsigned int mx = 0; mx < 4; mx++) {
+      ASSERT_EQ(cf.getMaskData(mask, mx, my), expected[my * 4 + mx]);
+    }
+  }
+}
+
 int main(int argc, char ** argv)
 {
   // Initialize the system
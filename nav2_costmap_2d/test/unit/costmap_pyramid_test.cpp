@@ -0,0 +1,116 @@
+// Copyright (c) 2024 Open Navigation LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+
+#include "nav2_costmap_2d/costmap_pyramid.hpp"
+#include "nav2_costmap_2d/cost_values.hpp"
+
+using nav2_costmap_2d::Costmap2D;
+using nav2_costmap_2d::CostmapPyramid;
+
+// Max over the source cells covered by a coarse cell of the given scale
+static unsigned char pooledCost(
+  const Costmap2D & costmap, unsigned int scale, unsigned int cx, unsigned int cy)
+{
+  unsigned char cost = 0;
+  for (unsigned int y = cy * scale; y < std::min((cy + 1) * scale, costmap.getSizeInCellsY());
+    ++y)
+  {
+    for (unsigned int x = cx * scale; x < std::min((cx + 1) * scale, costmap.getSizeInCellsX());
+      ++x)
+    {
+      cost = std::max(cost, costmap.getCost(x, y));
+    }
+  }
+  return cost;
+}
+
+static void expectPooled(const Costmap2D & costmap, CostmapPyramid & pyramid)
+{
+  for (unsigned int i = 0; i < pyramid.getNumLevels(); ++i) {
+    const unsigned int scale = CostmapPyramid::getScale(i);
+    Costmap2D * level = pyramid.getLevel(i);
+    ASSERT_EQ(level->getSizeInCellsX(), (costmap.getSizeInCellsX() + scale - 1) / scale);
+    ASSERT_EQ(level->getSizeInCellsY(), (costmap.getSizeInCellsY() + scale - 1) / scale);
+    EXPECT_DOUBLE_EQ(level->getResolution(), costmap.getResolution() * scale);
+    EXPECT_DOUBLE_EQ(level->getOriginX(), costmap.getOriginX());
+    EXPECT_DOUBLE_EQ(level->getOriginY(), costmap.getOriginY());
+
+    for (unsigned int y = 0; y < level->getSizeInCellsY(); ++y) {
+      for (unsigned int x = 0; x < level->getSizeInCellsX(); ++x) {
+        ASSERT_EQ(level->getCost(x, y), pooledCost(costmap, scale, x, y)) <<
+          "level " << i << " cell (" << x << ", " << y << ")";
+      }
+    }
+  }
+}
+
+TEST(CostmapPyramid, rebuildOddSizes)
+{
+  Costmap2D costmap(37, 21, 0.05, -1.0, 2.0);
+  for (unsigned int y = 0; y < 21; ++y) {
+    for (unsigned int x = 0; x < 37; ++x) {
+      costmap.setCost(x, y, static_cast<unsigned char>((x * 31 + y * 7) % 200));
+    }
+  }
+  costmap.setCost(36, 20, nav2_costmap_2d::LETHAL_OBSTACLE);
+
+  CostmapPyramid pyramid(3);
+  pyramid.update(costmap, 0, 37, 0, 21);
+  expectPooled(costmap, pyramid);
+  EXPECT_EQ(
+    pyramid.getLevel(2)->getCost(4, 2), nav2_costmap_2d::LETHAL_OBSTACLE);
+}
+
+TEST(CostmapPyramid, incrementalUpdate)
+{
+  Costmap2D costmap(40, 40, 0.1, 0.0, 0.0);
+  CostmapPyramid pyramid(3);
+  pyramid.update(costmap, 0, 40, 0, 40);
+  expectPooled(costmap, pyramid);
+
+  // Lowering a cost must lower the pooled value as well
+  costmap.setCost(17, 9, nav2_costmap_2d::LETHAL_OBSTACLE);
+  pyramid.update(costmap, 17, 18, 9, 10);
+  expectPooled(costmap, pyramid);
+  costmap.setCost(17, 9, nav2_costmap_2d::FREE_SPACE);
+  pyramid.update(costmap, 17, 18, 9, 10);
+  expectPooled(costmap, pyramid);
+
+  costmap.setCost(3, 33, nav2_costmap_2d::NO_INFORMATION);
+  pyramid.update(costmap, 2, 5, 30, 35);
+  expectPooled(costmap, pyramid);
+
+  const nav2_costmap_2d::CellRegion & region = pyramid.getUpdatedRegion(0);
+  EXPECT_EQ(region.x0, 1u);
+  EXPECT_EQ(region.xn, 3u);
+  EXPECT_EQ(region.y0, 15u);
+  EXPECT_EQ(region.yn, 18u);
+}
+
+TEST(CostmapPyramid, rebuildOnOriginChange)
+{
+  Costmap2D costmap(20, 20, 0.1, 0.0, 0.0);
+  CostmapPyramid pyramid(2);
+  pyramid.update(costmap, 0, 20, 0, 20);
+
+  costmap.setCost(10, 10, nav2_costmap_2d::LETHAL_OBSTACLE);
+  costmap.updateOrigin(0.3, 0.0);
+  // Even an empty update region must trigger a rebuild after the window moved
+  pyramid.update(costmap, 0, 0, 0, 0);
+  expectPooled(costmap, pyramid);
+}
@@ -0,0 +1,120 @@
+// Copyright (c) 2024 Open Navigation LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <mutex>
+#include <vector>
+
+#include "rclcpp/rclcpp.hpp"
+#include "nav2_costmap_2d/costmap_queries.hpp"
+#include "nav2_costmap_2d/layered_costmap.hpp"
+
+class RclCppFixture
+{
+public:
+  RclCppFixture() {rclcpp::init(0, nullptr);}
+  ~RclCppFixture() {rclcpp::shutdown();}
+};
+RclCppFixture g_rclcppfixture;
+
+nav2_costmap_2d::Footprint squareFootprint(double half_side)
+{
+  nav2_costmap_2d::Footprint footprint(4);
+  footprint[0].x = half_side;
+  footprint[0].y = half_side;
+  footprint[1].x = half_side;
+  footprint[1].y = -half_side;
+  footprint[2].x = -half_side;
+  footprint[2].y = -half_side;
+  footprint[3].x = -half_side;
+  footprint[3].y = half_side;
+  return footprint;
+}
+
+TEST(CostmapQueries, footprintCheckerIsShared)
+{
+  nav2_costmap_2d::LayeredCostmap layers("map", false, false);
+  layers.resizeMap(20, 20, 0.1, 0.0, 0.0);
+  layers.getCostmap()->setCost(10, 13, nav2_costmap_2d::LETHAL_OBSTACLE);
+
+  nav2_costmap_2d::CostmapQueries queries(layers.getSnapshot());
+  const auto footprint = squareFootprint(0.3);
+  auto checker = queries.getFootprintChecker(footprint, 16);
+  EXPECT_EQ(queries.getFootprintChecker(footprint, 16), checker);
+  EXPECT_NE(queries.getFootprintChecker(footprint, 8), checker);
+  EXPECT_NE(queries.getFootprintChecker(squareFootprint(0.2), 16), checker);
+
+  // The outline of the footprint centered on (10, 10) runs along row 13
+  std::vector<geometry_msgs::msg::Pose2D> poses(2);
+  poses[0].x = 1.05;
+  poses[0].y = 1.05;
+  poses[1].x = 1.05;
+  poses[1].y = 0.55;
+  std::vector<double> costs;
+  queries.costAtPoses(footprint, 16, poses, costs);
+  ASSERT_EQ(costs.size(), 2u);
+  EXPECT_EQ(costs[0], nav2_costmap_2d::LETHAL_OBSTACLE);
+  EXPECT_EQ(costs[1], nav2_costmap_2d::FREE_SPACE);
+}
+
+TEST(CostmapQueries, rasterizationsCarriedOver)
+{
+  nav2_costmap_2d::LayeredCostmap layers("map", false, false);
+  layers.resizeMap(20, 20, 0.1, 0.0, 0.0);
+
+  nav2_costmap_2d::CostmapQueries first(layers.getSnapshot());
+  const auto footprint = squareFootprint(0.3);
+  EXPECT_EQ(first.getFootprintChecker(footprint, 16)->footprintCostAtPoseCached(1.05, 1.05, 0.0),
+    nav2_costmap_2d::FREE_SPACE);
+
+  {
+    std::unique_lock<nav2_costmap_2d::Costmap2D::mutex_t> lock(
+      *(layers.getCostmap()->getMutex()));
+    layers.getCostmap()->setCost(10, 13, nav2_costmap_2d::LETHAL_OBSTACLE);
+    layers.publishSnapshot();
+  }
+
+  // The carried over checker reads the new snapshot
+  nav2_costmap_2d::CostmapQueries second(layers.getSnapshot(), &first);
+  auto checker = second.getFootprintChecker(footprint, 16);
+  EXPECT_TRUE(checker->hasFootprintCache());
+  EXPECT_EQ(checker->footprintCostAtPoseCached(1.05, 1.05, 0.0),
+    nav2_costmap_2d::LETHAL_OBSTACLE);
+  EXPECT_EQ(first.getFootprintChecker(footprint, 16)->footprintCostAtPoseCached(1.05, 1.05, 0.0),
+    nav2_costmap_2d::FREE_SPACE);
+}
+
+TEST(CostmapQueries, obstacleDistances)
+{
+  nav2_costmap_2d::LayeredCostmap layers("map", false, false);
+  layers.resizeMap(10, 10, 0.5, 0.0, 0.0);
+
+  nav2_costmap_2d::CostmapQueries empty(layers.getSnapshot());
+  EXPECT_TRUE(std::isinf(empty.getObstacleDistance(5, 5)));
+
+  {
+    std::unique_lock<nav2_costmap_2d::Costmap2D::mutex_t> lock(
+      *(layers.getCostmap()->getMutex()));
+    layers.getCostmap()->setCost(2, 3, nav2_costmap_2d::LETHAL_OBSTACLE);
+    layers.getCostmap()->setCost(8, 8, nav2_costmap_2d::INSCRIBED_INFLATED_OBSTACLE);
+    layers.publishSnapshot();
+  }
+  nav2_costmap_2d::CostmapQueries queries(layers.getSnapshot());
+  EXPECT_FLOAT_EQ(queries.getObstacleDistance(2, 3), 0.0f);
+  EXPECT_FLOAT_EQ(queries.getObstacleDistance(5, 7), 2.5f);
+  EXPECT_FLOAT_EQ(queries.getObstacleDistance(8, 8), 0.5f * std::hypot(6.0f, 5.0f));
+  EXPECT_EQ(&queries.getObstacleDistances(), &queries.getObstacleDistances());
+}
@@ -0,0 +1,187 @@
+// Copyright (c) 2024 Open Navigation LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+
+#include <mutex>
+
+#include "rclcpp/rclcpp.hpp"
+#include "nav2_costmap_2d/costmap_view.hpp"
+#include "nav2_costmap_2d/layered_costmap.hpp"
+
+class RclCppFixture
+{
+public:
+  RclCppFixture() {rclcpp::init(0, nullptr);}
+  ~RclCppFixture() {rclcpp::shutdown();}
+};
+RclCppFixture g_rclcppfixture;
+
+TEST(CostmapSnapshot, snapshotCopiesMasterGrid)
+{
+  nav2_costmap_2d::LayeredCostmap layers("map", false, false);
+  layers.resizeMap(10, 20, 0.5, 1.0, 2.0);
+  layers.getCostmap()->setCost(3, 4, 100);
+
+  auto snapshot = layers.getSnapshot();
+  ASSERT_NE(snapshot, nullptr);
+  EXPECT_EQ(snapshot->getSizeInCellsX(), 10u);
+  EXPECT_EQ(snapshot->getSizeInCellsY(), 20u);
+  EXPECT_DOUBLE_EQ(snapshot->getResolution(), 0.5);
+  EXPECT_DOUBLE_EQ(snapshot->getOriginX(), 1.0);
+  EXPECT_DOUBLE_EQ(snapshot->getOriginY(), 2.0);
+  EXPECT_EQ(snapshot->getCost(3, 4), 100);
+  EXPECT_EQ(snapshot->getCost(0, 0), nav2_costmap_2d::FREE_SPACE);
+
+  unsigned int mx, my;
+  ASSERT_TRUE(snapshot->worldToMap(2.75, 4.25, mx, my));
+  EXPECT_EQ(mx, 3u);
+  EXPECT_EQ(my, 4u);
+  EXPECT_FALSE(snapshot->worldToMap(0.0, 0.0, mx, my));
+
+  // Repeated requests return the same published snapshot
+  EXPECT_EQ(layers.getSnapshot(), snapshot);
+}
+
+TEST(CostmapSnapshot, heldSnapshotIsImmutable)
+{
+  nav2_costmap_2d::LayeredCostmap layers("map", false, false);
+  layers.resizeMap(10, 10, 0.1, 0.0, 0.0);
+
+  auto old_snapshot = layers.getSnapshot();
+  {
+    std::unique_lock<nav2_costmap_2d::Costmap2D::mutex_t> lock(
+      *(layers.getCostmap()->getMutex()));
+    layers.getCostmap()->setCost(5, 5, nav2_costmap_2d::LETHAL_OBSTACLE);
+    layers.publishSnapshot();
+  }
+  auto new_snapshot = layers.getSnapshot();
+
+  EXPECT_EQ(old_snapshot->getCost(5, 5), nav2_costmap_2d::FREE_SPACE);
+  EXPECT_EQ(new_snapshot->getCost(5, 5), nav2_costmap_2d::LETHAL_OBSTACLE);
+  EXPECT_GT(new_snapshot->getRevision(), old_snapshot->getRevision());
+}
+
+TEST(CostmapSnapshot, releasedSnapshotStorageIsReused)
+{
+  nav2_costmap_2d::LayeredCostmap layers("map", false, false);
+  layers.resizeMap(10, 10, 0.1, 0.0, 0.0);
+
+  const unsigned char * first_data = layers.getSnapshot()->getCharMap();
+  layers.publishSnapshot();
+  // The first snapshot is no longer held by anyone, so it becomes the back buffer
+  layers.publishSnapshot();
+  EXPECT_EQ(layers.getSnapshot()->getCharMap(), first_data);
+
+  // While a reader holds a snapshot, its storage must not be recycled
+  auto held = layers.getSnapshot();
+  layers.publishSnapshot();
+  layers.publishSnapshot();
+  EXPECT_NE(layers.getSnapshot()->getCharMap(), held->getCharMap());
+  EXPECT_EQ(held->getCharMap(), first_data);
+}
+
+TEST(CostmapSnapshot, changedBoundsSinceEarlierRevisions)
+{
+  nav2_costmap_2d::LayeredCostmap layers("map", false, false);
+  layers.resizeMap(10, 10, 0.1, 0.0, 0.0);
+
+  const uint64_t first = layers.getSnapshot()->getRevision();
+  layers.publishSnapshot(nav2_costmap_2d::CellRegion{1, 2, 3, 4});
+  layers.publishSnapshot(nav2_costmap_2d::CellRegion{5, 0, 6, 1});
+  auto snapshot = layers.getSnapshot();
+
+  nav2_costmap_2d::CellRegion bounds;
+  ASSERT_TRUE(snapshot->getChangedBounds(first, bounds));
+  EXPECT_EQ(bounds.x0, 1u);
+  EXPECT_EQ(bounds.y0, 0u);
+  EXPECT_EQ(bounds.xn, 6u);
+  EXPECT_EQ(bounds.yn, 4u);
+
+  ASSERT_TRUE(snapshot->getChangedBounds(first + 1, bounds));
+  EXPECT_EQ(bounds.x0, 5u);
+  EXPECT_EQ(bounds.yn, 1u);
+
+  ASSERT_TRUE(snapshot->getChangedBounds(snapshot->getRevision(), bounds));
+  EXPECT_EQ(bounds.xn, bounds.x0);
+
+  // Unknown changes and resizes reset the history
+  layers.publishSnapshot();
+  EXPECT_FALSE(layers.getSnapshot()->getChangedBounds(first, bounds));
+  layers.publishSnapshot(nav2_costmap_2d::CellRegion{1, 2, 3, 4});
+  EXPECT_TRUE(
+    layers.getSnapshot()->getChangedBounds(layers.getSnapshot()->getRevision() - 1, bounds));
+  layers.resizeMap(20, 10, 0.1, 0.0, 0.0);
+  layers.publishSnapshot(nav2_costmap_2d::CellRegion{1, 2, 3, 4});
+  EXPECT_FALSE(
+    layers.getSnapshot()->getChangedBounds(layers.getSnapshot()->getRevision() - 2, bounds));
+}
+
+TEST(CostmapView, viewMatchesCostmap)
+{
+  nav2_costmap_2d::Costmap2D costmap(10, 20, 0.5, 1.0, 2.0);
+  costmap.setCost(3, 4, 100);
+  costmap.setCost(9, 19, nav2_costmap_2d::LETHAL_OBSTACLE);
+
+  const nav2_costmap_2d::CostmapView view(costmap);
+  EXPECT_EQ(view.getData(), costmap.getCharMap());
+  EXPECT_EQ(view.getStride(), 10u);
+  for (unsigned int my = 0; my < 20; my++) {
+    for (unsigned int mx = 0; mx < 10; mx++) {
+      EXPECT_EQ(view(mx, my), costmap.getCost(mx, my));
+    }
+  }
+
+  unsigned int mx, my;
+  ASSERT_TRUE(view.worldToMap(2.75, 4.25, mx, my));
+  EXPECT_EQ(mx, 3u);
+  EXPECT_EQ(my, 4u);
+  EXPECT_FALSE(view.worldToMap(0.0, 0.0, mx, my));
+  EXPECT_FALSE(view.worldToMap(6.0, 4.25, mx, my));
+  EXPECT_TRUE(view.contains(9, 19));
+  EXPECT_FALSE(view.contains(-1, 0));
+  EXPECT_FALSE(view.contains(10, 0));
+}
+
+TEST(CostmapView, cropsShareData)
+{
+  nav2_costmap_2d::Costmap2D costmap(10, 20, 0.5, 1.0, 2.0);
+  costmap.setCost(3, 4, 100);
+  const nav2_costmap_2d::CostmapView view(costmap);
+
+  // The crop is clamped to the view, and its cells are the cells of the costmap
+  auto crop = view.crop(2, 3, 12, 5);
+  EXPECT_EQ(crop.getSizeInCellsX(), 8u);
+  EXPECT_EQ(crop.getSizeInCellsY(), 2u);
+  EXPECT_EQ(crop.getStride(), 10u);
+  EXPECT_DOUBLE_EQ(crop.getOriginX(), 2.0);
+  EXPECT_DOUBLE_EQ(crop.getOriginY(), 3.5);
+  EXPECT_EQ(crop.row(1) + 1, view.row(4) + 3);
+  EXPECT_EQ(crop(1, 1), 100);
+
+  double wx, wy;
+  unsigned int mx, my;
+  crop.mapToWorld(1, 1, wx, wy);
+  ASSERT_TRUE(view.worldToMap(wx, wy, mx, my));
+  EXPECT_EQ(mx, 3u);
+  EXPECT_EQ(my, 4u);
+
+  // World crops cover the cells overlapping the box, clamped to the view
+  auto world_crop = view.cropWorld(2.25, 3.75, 2.75, 100.0);
+  EXPECT_EQ(world_crop.getData(), view.row(3) + 2);
+  EXPECT_EQ(world_crop.getSizeInCellsX(), 2u);
+  EXPECT_EQ(world_crop.getSizeInCellsY(), 17u);
+  EXPECT_TRUE(view.cropWorld(-10.0, -10.0, 0.0, 0.0).empty());
+  EXPECT_TRUE(view.cropWorld(50.0, 50.0, 60.0, 60.0).empty());
+}
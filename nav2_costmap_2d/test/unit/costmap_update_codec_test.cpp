@@ -0,0 +1,66 @@
+// Copyright (c) 2024 Open Navigation LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+
+#include <vector>
+
+#include "nav2_costmap_2d/costmap_update_codec.hpp"
+
+using nav2_costmap_2d::encodeRunLength;
+using nav2_costmap_2d::decodeRunLength;
+
+TEST(CostmapUpdateCodec, roundTrip)
+{
+  // Long runs split at 255 cells, mixed with single cells
+  std::vector<unsigned char> costs(1000, 0);
+  for (size_t i = 300; i < 310; ++i) {
+    costs[i] = 254;
+  }
+  costs[500] = 17;
+  costs[999] = 255;
+
+  std::vector<uint8_t> encoded;
+  encodeRunLength(costs.data(), costs.size(), encoded);
+  EXPECT_LT(encoded.size(), costs.size());
+  EXPECT_EQ(encoded.size() % 2, 0u);
+
+  std::vector<unsigned char> decoded(costs.size(), 1);
+  ASSERT_TRUE(decodeRunLength(encoded, decoded.data(), decoded.size()));
+  EXPECT_EQ(decoded, costs);
+}
+
+TEST(CostmapUpdateCodec, emptyInput)
+{
+  std::vector<uint8_t> encoded{1, 2};
+  encodeRunLength(nullptr, 0, encoded);
+  EXPECT_TRUE(encoded.empty());
+  EXPECT_TRUE(decodeRunLength(encoded, nullptr, 0));
+}
+
+TEST(CostmapUpdateCodec, rejectsMalformedInput)
+{
+  std::vector<unsigned char> decoded(4);
+
+  // Odd length
+  EXPECT_FALSE(decodeRunLength({2, 5, 1}, decoded.data(), decoded.size()));
+  // Zero length run
+  EXPECT_FALSE(decodeRunLength({0, 5, 4, 5}, decoded.data(), decoded.size()));
+  // Overflows the output
+  EXPECT_FALSE(decodeRunLength({5, 5}, decoded.data(), decoded.size()));
+  // Too short
+  EXPECT_FALSE(decodeRunLength({3, 5}, decoded.data(), decoded.size()));
+  EXPECT_TRUE(decodeRunLength({3, 5, 1, 6}, decoded.data(), decoded.size()));
+  EXPECT_EQ(decoded, std::vector<unsigned char>({5, 5, 5, 6}));
+}
@@ -19,6 +19,7 @@
 #include <tuple>
 #include <stdexcept>
 #include <algorithm>
+#include <memory>
 
 #include "nav2_costmap_2d/denoise_layer.hpp"
 #include "image_tests_helper.hpp"
@@ -87,6 +88,11 @@ public:
     d.minimal_group_size_ = minimal_group_size;
   }
 
+  static void setWindowMargin(nav2_costmap_2d::DenoiseLayer & d, bool use_window_margin)
+  {
+    d.use_window_margin_ = use_window_margin;
+  }
+
   static std::tuple<bool, ConnectivityType, size_t> getParameters(
     const nav2_costmap_2d::DenoiseLayer & d)
   {
@@ -452,6 +458,39 @@ TEST_F(DenoiseLayerTester, updateCosts) {
   ASSERT_EQ(costmap.getCost(0), FREE_SPACE);
 }
 
+TEST_F(DenoiseLayerTester, updateCostsWithWindowMargin) {
+  auto makeCostmap = []() {
+      auto costmap = std::make_unique<nav2_costmap_2d::Costmap2D>(8, 8, 1., 0., 0.);
+      // A group of 4 crossing the window border at x = 4
+      for (unsigned int x = 2; x < 6; ++x) {
+        costmap->setCost(x, 2, LETHAL_OBSTACLE);
+      }
+      // A group of 2 inside the window
+      costmap->setCost(6, 6, LETHAL_OBSTACLE);
+      costmap->setCost(7, 6, LETHAL_OBSTACLE);
+      return costmap;
+    };
+
+  for (bool use_window_margin : {false, true}) {
+    nav2_costmap_2d::DenoiseLayer layer;
+    DenoiseLayerTester::configure(layer, ConnectivityType::Way8, 3);
+    DenoiseLayerTester::setWindowMargin(layer, use_window_margin);
+    auto costmap = makeCostmap();
+
+    layer.updateCosts(*costmap, 4, 0, 8, 8);
+
+    // Without the margin, the window part of the crossing group is taken for noise
+    const unsigned char crossing_cost = use_window_margin ? LETHAL_OBSTACLE : FREE_SPACE;
+    ASSERT_EQ(costmap->getCost(4, 2), crossing_cost);
+    ASSERT_EQ(costmap->getCost(5, 2), crossing_cost);
+    // Cells outside of the window are never modified
+    ASSERT_EQ(costmap->getCost(2, 2), LETHAL_OBSTACLE);
+    ASSERT_EQ(costmap->getCost(3, 2), LETHAL_OBSTACLE);
+    ASSERT_EQ(costmap->getCost(6, 6), FREE_SPACE);
+    ASSERT_EQ(costmap->getCost(7, 6), FREE_SPACE);
+  }
+}
+
 // Copy paste from declare_parameter_test.cpp
 class RclCppFixture
 {
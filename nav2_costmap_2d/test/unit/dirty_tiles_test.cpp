@@ -0,0 +1,176 @@
+// Copyright (c) 2024 Open Navigation LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <memory>
+#include <tuple>
+#include <vector>
+
+#include "rclcpp/rclcpp.hpp"
+#include "nav2_costmap_2d/dirty_tiles.hpp"
+#include "nav2_costmap_2d/layer.hpp"
+#include "nav2_costmap_2d/layered_costmap.hpp"
+
+using nav2_costmap_2d::CellRegion;
+using nav2_costmap_2d::DirtyTiles;
+
+class RclCppFixture
+{
+public:
+  RclCppFixture() {rclcpp::init(0, nullptr);}
+  ~RclCppFixture() {rclcpp::shutdown();}
+};
+RclCppFixture g_rclcppfixture;
+
+// Layer of single cells, on a costmap with a 1m resolution and its origin at 0
+class CellLayer : public nav2_costmap_2d::Layer
+{
+public:
+  explicit CellLayer(bool independent)
+  : independent_(independent) {}
+
+  void reset() {}
+  bool isClearable() {return false;}
+  bool isUpdateIndependent() const override {return independent_;}
+
+  void setCell(unsigned int mx, unsigned int my, unsigned char cost)
+  {
+    cells_.emplace_back(mx, my, cost);
+    changed_.emplace_back(mx, my, cost);
+  }
+
+  void updateBounds(
+    double, double, double, double * min_x, double * min_y, double * max_x, double * max_y)
+  {
+    for (const auto & [mx, my, cost] : changed_) {
+      *min_x = std::min(*min_x, mx + 0.5);
+      *min_y = std::min(*min_y, my + 0.5);
+      *max_x = std::max(*max_x, mx + 0.5);
+      *max_y = std::max(*max_y, my + 0.5);
+    }
+    changed_.clear();
+  }
+
+  void updateCosts(
+    nav2_costmap_2d::Costmap2D & master_grid, int min_i, int min_j, int max_i, int max_j)
+  {
+    for (const auto & [mx, my, cost] : cells_) {
+      if (static_cast<int>(mx) >= min_i && static_cast<int>(mx) < max_i &&
+        static_cast<int>(my) >= min_j && static_cast<int>(my) < max_j)
+      {
+        master_grid.setCost(mx, my, std::max(master_grid.getCost(mx, my), cost));
+      }
+    }
+  }
+
+protected:
+  bool independent_;
+  std::vector<std::tuple<unsigned int, unsigned int, unsigned char>> cells_, changed_;
+};
+
+TEST(DirtyTiles, farApartRegionsStaySeparate)
+{
+  DirtyTiles tiles;
+  tiles.resize(100, 100, 10);
+  EXPECT_TRUE(tiles.empty());
+
+  tiles.markCells(2, 3, 5, 6);
+  tiles.markCells(91, 92, 95, 96);
+  EXPECT_FALSE(tiles.empty());
+
+  std::vector<CellRegion> regions;
+  tiles.getRegions(regions);
+  ASSERT_EQ(regions.size(), 2u);
+  EXPECT_EQ(regions[0].x0, 0u);
+  EXPECT_EQ(regions[0].y0, 0u);
+  EXPECT_EQ(regions[0].xn, 10u);
+  EXPECT_EQ(regions[0].yn, 10u);
+  EXPECT_EQ(regions[1].x0, 90u);
+  EXPECT_EQ(regions[1].y0, 90u);
+  EXPECT_EQ(regions[1].xn, 100u);
+  EXPECT_EQ(regions[1].yn, 100u);
+
+  tiles.clear();
+  EXPECT_TRUE(tiles.empty());
+}
+
+TEST(DirtyTiles, regionsAreClippedAndMerged)
+{
+  DirtyTiles tiles;
+  tiles.resize(25, 25, 10);
+
+  // Spans three tile rows with the same columns and is clipped to the map size
+  tiles.markCells(12, 0, 100, 100);
+  std::vector<CellRegion> regions;
+  tiles.getRegions(regions);
+  ASSERT_EQ(regions.size(), 1u);
+  EXPECT_EQ(regions[0].x0, 10u);
+  EXPECT_EQ(regions[0].y0, 0u);
+  EXPECT_EQ(regions[0].xn, 25u);
+  EXPECT_EQ(regions[0].yn, 25u);
+
+  // Empty regions are ignored
+  tiles.clear();
+  tiles.markCells(5, 5, 5, 10);
+  EXPECT_TRUE(tiles.empty());
+}
+
+TEST(DirtyTiles, dilateGrowsByWholeTiles)
+{
+  DirtyTiles tiles;
+  tiles.resize(50, 50, 10);
+  tiles.markCells(20, 20, 21, 21);
+
+  tiles.dilate(3);
+  std::vector<CellRegion> regions;
+  tiles.getRegions(regions);
+  ASSERT_EQ(regions.size(), 1u);
+  EXPECT_EQ(regions[0].x0, 10u);
+  EXPECT_EQ(regions[0].y0, 10u);
+  EXPECT_EQ(regions[0].xn, 40u);
+  EXPECT_EQ(regions[0].yn, 40u);
+}
+
+TEST(DirtyTiles, dependentLayerChangesAreUpdated)
+{
+  nav2_costmap_2d::LayeredCostmap layers("map", false, false);
+  layers.resizeMap(100, 100, 1.0, 0.0, 0.0);
+  layers.setTiledUpdates(10);
+  auto obstacles = std::make_shared<CellLayer>(true);
+  auto other = std::make_shared<CellLayer>(false);
+  layers.addPlugin(obstacles);
+  layers.addPlugin(other);
+
+  // The second layer changes a cell within the bounds of the first layer, but away from
+  // the tiles it dirtied
+  obstacles->setCell(5, 5, 100);
+  obstacles->setCell(95, 95, 100);
+  other->setCell(50, 50, 200);
+  layers.updateMap(0.0, 0.0, 0.0);
+
+  auto costmap = layers.getCostmap();
+  EXPECT_EQ(costmap->getCost(5, 5), 100);
+  EXPECT_EQ(costmap->getCost(95, 95), 100);
+  EXPECT_EQ(costmap->getCost(50, 50), 200);
+
+  // And again once the tiles are tracked from a clean state
+  other->setCell(30, 70, 150);
+  obstacles->setCell(5, 6, 100);
+  obstacles->setCell(95, 94, 100);
+  layers.updateMap(0.0, 0.0, 0.0);
+  EXPECT_EQ(costmap->getCost(30, 70), 150);
+  EXPECT_EQ(costmap->getCost(50, 50), 200);
+}
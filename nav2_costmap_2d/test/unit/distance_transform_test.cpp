@@ -0,0 +1,63 @@
+// Copyright (c) 2024 Open Navigation LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <random>
+#include <vector>
+
+#include "nav2_costmap_2d/distance_transform.hpp"
+
+using nav2_costmap_2d::DistanceTransform;
+
+TEST(DistanceTransform, noSeeds)
+{
+  std::vector<uint8_t> seeds(30, 0);
+  DistanceTransform dt;
+  dt.compute(seeds.data(), 5, 6);
+  for (unsigned int i = 0; i < seeds.size(); ++i) {
+    EXPECT_EQ(dt.getSquaredDistance(i), DistanceTransform::getInfinity());
+  }
+}
+
+TEST(DistanceTransform, matchesBruteForce)
+{
+  const unsigned int size_x = 37, size_y = 23;
+  std::mt19937 gen(42);
+  std::uniform_int_distribution<int> dist(0, 40);
+  std::vector<uint8_t> seeds(size_x * size_y, 0);
+  for (auto & seed : seeds) {
+    seed = dist(gen) == 0;
+  }
+
+  DistanceTransform dt;
+  dt.compute(seeds.data(), size_x, size_y);
+
+  for (unsigned int y = 0; y < size_y; ++y) {
+    for (unsigned int x = 0; x < size_x; ++x) {
+      uint32_t best = DistanceTransform::getInfinity();
+      for (unsigned int sy = 0; sy < size_y; ++sy) {
+        for (unsigned int sx = 0; sx < size_x; ++sx) {
+          if (seeds[sy * size_x + sx]) {
+            const int dx = static_cast<int>(x) - static_cast<int>(sx);
+            const int dy = static_cast<int>(y) - static_cast<int>(sy);
+            best = std::min(best, static_cast<uint32_t>(dx * dx + dy * dy));
+          }
+        }
+      }
+      EXPECT_EQ(dt.getSquaredDistance(y * size_x + x), best) << x << ", " << y;
+    }
+  }
+}
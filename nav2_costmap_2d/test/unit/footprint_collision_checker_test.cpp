@@ -15,6 +15,7 @@
 #include <string>
 #include <vector>
 #include <memory>
+#include <cmath>
 
 #include "gtest/gtest.h"
 #include "nav2_costmap_2d/footprint_collision_checker.hpp"
@@ -158,6 +159,131 @@ TEST(collision_footprint, test_point_and_line_cost)
   EXPECT_NEAR(right_value, 254.0, 0.001);
 }
 
+TEST(collision_footprint, test_cached_footprint_cost)
+{
+  std::shared_ptr<nav2_costmap_2d::Costmap2D> costmap_ =
+    std::make_shared<nav2_costmap_2d::Costmap2D>(100, 100, 0.1, 0, 0, 0);
+
+  geometry_msgs::msg::Point p1;
+  p1.x = -1.0;
+  p1.y = 1.0;
+  geometry_msgs::msg::Point p2;
+  p2.x = 1.0;
+  p2.y = 1.0;
+  geometry_msgs::msg::Point p3;
+  p3.x = 1.0;
+  p3.y = -1.0;
+  geometry_msgs::msg::Point p4;
+  p4.x = -1.0;
+  p4.y = -1.0;
+
+  nav2_costmap_2d::Footprint footprint = {p1, p2, p3, p4};
+
+  nav2_costmap_2d::FootprintCollisionChecker<std::shared_ptr<nav2_costmap_2d::Costmap2D>>
+  outline_checker(costmap_), filled_checker(costmap_);
+  EXPECT_FALSE(outline_checker.hasFootprintCache());
+  outline_checker.setFootprintCache(footprint, 72, false);
+  filled_checker.setFootprintCache(footprint, 72, true);
+  EXPECT_TRUE(outline_checker.hasFootprintCache());
+
+  // Cell (50, 50) is inside the footprint, only the filled variant sees it
+  costmap_->setCost(50, 50, 200);
+  EXPECT_NEAR(outline_checker.footprintCostAtPoseCached(5.05, 5.05, 0.0), 0.0, 0.001);
+  EXPECT_NEAR(filled_checker.footprintCostAtPoseCached(5.05, 5.05, 0.0), 200.0, 0.001);
+
+  // Cell (60, 52) is on the outline, and matches the uncached cost
+  costmap_->setCost(60, 52, 254);
+  EXPECT_NEAR(outline_checker.footprintCostAtPoseCached(5.05, 5.05, 0.0), 254.0, 0.001);
+  EXPECT_NEAR(filled_checker.footprintCostAtPoseCached(5.05, 5.05, 0.0), 254.0, 0.001);
+  EXPECT_NEAR(outline_checker.footprintCostAtPose(5.05, 5.05, 0.0, footprint), 254.0, 0.001);
+
+  // A quarter turn of a square footprint covers the same cells
+  EXPECT_NEAR(outline_checker.footprintCostAtPoseCached(5.05, 5.05, M_PI_2), 254.0, 0.001);
+  EXPECT_NEAR(outline_checker.footprintCostAtPoseCached(5.05, 5.05, -M_PI_2), 254.0, 0.001);
+
+  // Moving away clears the obstacles, leaving the map is a collision
+  EXPECT_NEAR(outline_checker.footprintCostAtPoseCached(3.05, 3.05, 0.3), 0.0, 0.001);
+  EXPECT_NEAR(outline_checker.footprintCostAtPoseCached(0.55, 5.05, 0.0), 254.0, 0.001);
+  EXPECT_NEAR(outline_checker.footprintCostAtPoseCached(-1.0, 5.05, 0.0), 254.0, 0.001);
+
+  std::vector<geometry_msgs::msg::Pose2D> poses(4);
+  poses[0].x = 5.05;
+  poses[0].y = 5.05;
+  poses[1].x = 3.05;
+  poses[1].y = 3.05;
+  poses[1].theta = 0.3;
+  poses[2].x = 0.55;
+  poses[2].y = 5.05;
+  poses[3].x = 4.35;
+  poses[3].y = 4.75;
+  std::vector<double> costs;
+  filled_checker.footprintCostsAtPoses(poses, costs);
+  ASSERT_EQ(costs.size(), 4u);
+  for (size_t i = 0; i < poses.size(); ++i) {
+    EXPECT_NEAR(
+      costs[i], filled_checker.footprintCostAtPoseCached(poses[i].x, poses[i].y, poses[i].theta),
+      0.001);
+  }
+  EXPECT_NEAR(costs[3], 200.0, 0.001);
+
+  // Without a footprint cache, only the cell of the pose is checked
+  nav2_costmap_2d::FootprintCollisionChecker<std::shared_ptr<nav2_costmap_2d::Costmap2D>>
+  uncached_checker(costmap_);
+  EXPECT_NEAR(uncached_checker.footprintCostAtPoseCached(5.05, 5.05, 0.0), 200.0, 0.001);
+  EXPECT_NEAR(uncached_checker.footprintCostAtPoseCached(3.05, 3.05, 0.3), 0.0, 0.001);
+  EXPECT_NEAR(uncached_checker.footprintCostAtPoseCached(-1.0, 5.05, 0.0), 254.0, 0.001);
+  uncached_checker.footprintCostsAtPoses(poses, costs);
+  ASSERT_EQ(costs.size(), 4u);
+  EXPECT_NEAR(costs[0], 200.0, 0.001);
+  EXPECT_NEAR(costs[1], 0.0, 0.001);
+}
+
+TEST(collision_footprint, test_swept_cost)
+{
+  std::shared_ptr<nav2_costmap_2d::Costmap2D> costmap_ =
+    std::make_shared<nav2_costmap_2d::Costmap2D>(100, 100, 0.1, 0, 0, 0);
+  // Obstacles ahead of the footprint and diagonally beside it
+  costmap_->setCost(40, 50, 254);
+  costmap_->setCost(31, 51, 254);
+
+  geometry_msgs::msg::Point p1;
+  p1.x = 0.2;
+  p1.y = 0.1;
+  geometry_msgs::msg::Point p2;
+  p2.x = 0.2;
+  p2.y = -0.1;
+  geometry_msgs::msg::Point p3;
+  p3.x = -0.2;
+  p3.y = -0.1;
+  geometry_msgs::msg::Point p4;
+  p4.x = -0.2;
+  p4.y = 0.1;
+
+  nav2_costmap_2d::Footprint footprint = {p1, p2, p3, p4};
+
+  nav2_costmap_2d::FootprintCollisionChecker<std::shared_ptr<nav2_costmap_2d::Costmap2D>>
+  collision_checker(costmap_);
+
+  EXPECT_NEAR(collision_checker.translationSweptCost(3.0, 5.0, 0.0, 0.5, footprint), 0.0, 0.001);
+  EXPECT_NEAR(
+    collision_checker.translationSweptCost(3.0, 5.0, 0.0, 1.0, footprint), 254.0, 0.001);
+  EXPECT_NEAR(
+    collision_checker.translationSweptCost(3.0, 5.0, 0.0, -1.0, footprint), 0.0, 0.001);
+  EXPECT_NEAR(
+    collision_checker.translationSweptCost(3.0, 5.0, M_PI, -1.0, footprint), 254.0, 0.001);
+
+  // The obstacle beside is reached rotating 17 deg counterclockwise, or 107 deg clockwise
+  EXPECT_NEAR(collision_checker.rotationSweptCost(3.0, 5.0, 0.0, 0.2, footprint), 0.0, 0.001);
+  EXPECT_NEAR(collision_checker.rotationSweptCost(3.0, 5.0, 0.0, 0.4, footprint), 254.0, 0.001);
+  EXPECT_NEAR(collision_checker.rotationSweptCost(3.0, 5.0, 0.0, -1.0, footprint), 0.0, 0.001);
+  EXPECT_NEAR(
+    collision_checker.rotationSweptCost(3.0, 5.0, 0.0, -2.0, footprint), 254.0, 0.001);
+
+  // Sweeping off the costmap is a collision
+  EXPECT_NEAR(
+    collision_checker.translationSweptCost(3.0, 5.0, M_PI, 3.0, footprint), 254.0, 0.001);
+}
+
 TEST(collision_footprint, not_enough_points)
 {
   geometry_msgs::msg::Point p1;
@@ -250,3 +376,65 @@ TEST(collision_footprint, make_footprint_from_string_not_pairs) {
     "[[1, 2.2], [.3, -4e4], [-.3, -4e4], [-1, 2.2, 5.6]]", footprint);
   EXPECT_EQ(result, false);
 }
+
+TEST(collision_footprint, transform_footprint_variants) {
+  std::vector<geometry_msgs::msg::Point> footprint;
+  ASSERT_TRUE(
+    nav2_costmap_2d::makeFootprintFromString(
+      "[[0.5, 0.25], [-0.5, 0.25], [-0.5, -0.25], [0.5, -0.3]]", footprint));
+
+  std::vector<geometry_msgs::msg::Point> expected;
+  nav2_costmap_2d::transformFootprint(1.0, -2.0, 0.7, footprint, expected);
+
+  // With the cosine and sine given, in place
+  std::vector<geometry_msgs::msg::Point> in_place = footprint;
+  nav2_costmap_2d::transformFootprint(1.0, -2.0, cos(0.7), sin(0.7), in_place, in_place);
+
+  // With compact points
+  std::vector<nav2_costmap_2d::FootprintPoint> points;
+  nav2_costmap_2d::toFootprintPoints(footprint, points);
+  ASSERT_EQ(points.size(), footprint.size());
+  std::vector<nav2_costmap_2d::FootprintPoint> oriented(points.size());
+  nav2_costmap_2d::transformFootprint(
+    1.0f, -2.0f, std::cos(0.7f), std::sin(0.7f), points.data(), points.size(), oriented.data());
+
+  for (unsigned int i = 0; i < footprint.size(); ++i) {
+    EXPECT_DOUBLE_EQ(in_place[i].x, expected[i].x);
+    EXPECT_DOUBLE_EQ(in_place[i].y, expected[i].y);
+    EXPECT_NEAR(oriented[i].x, expected[i].x, 1e-5);
+    EXPECT_NEAR(oriented[i].y, expected[i].y, 1e-5);
+  }
+}
+
+TEST(collision_footprint, oriented_footprint_cache) {
+  std::vector<geometry_msgs::msg::Point> footprint;
+  ASSERT_TRUE(
+    nav2_costmap_2d::makeFootprintFromString(
+      "[[0.5, 0.25], [-0.5, 0.25], [-0.5, -0.25], [0.5, -0.25]]", footprint));
+
+  nav2_costmap_2d::OrientedFootprintCache cache;
+  cache.setFootprint(footprint);
+
+  std::vector<geometry_msgs::msg::Point> oriented, expected;
+  for (double theta : {0.3, 0.3, -1.2}) {
+    for (double x : {1.0, 1.0, 2.5}) {
+      cache.getOrientedFootprint(x, 0.5, theta, oriented);
+      nav2_costmap_2d::transformFootprint(x, 0.5, theta, footprint, expected);
+      ASSERT_EQ(oriented.size(), expected.size());
+      for (unsigned int i = 0; i < expected.size(); ++i) {
+        EXPECT_DOUBLE_EQ(oriented[i].x, expected[i].x);
+        EXPECT_DOUBLE_EQ(oriented[i].y, expected[i].y);
+      }
+    }
+  }
+
+  // A new footprint is oriented again at the same pose
+  nav2_costmap_2d::padFootprint(footprint, 0.1);
+  cache.setFootprint(footprint);
+  cache.getOrientedFootprint(2.5, 0.5, -1.2, oriented);
+  nav2_costmap_2d::transformFootprint(2.5, 0.5, -1.2, footprint, expected);
+  for (unsigned int i = 0; i < expected.size(); ++i) {
+    EXPECT_DOUBLE_EQ(oriented[i].x, expected[i].x);
+    EXPECT_DOUBLE_EQ(oriented[i].y, expected[i].y);
+  }
+}
@@ -14,6 +14,9 @@
 
 #include <gtest/gtest.h>
 #include <cmath>
+#include <cstdlib>
+#include <functional>
+#include <vector>
 
 #include "nav2_costmap_2d/denoise/image_processing.hpp"
 #include "image_tests_helper.hpp"
@@ -424,6 +427,39 @@ TEST_F(ConnectedComponentsTester, groupsRemoverUint16LabelOverflow) {
   image.forEach([bg](uint8_t v) {ASSERT_EQ(v, bg);});
 }
 
+TEST_F(ConnectedComponentsTester, parallelGroupsRemoverMatchesSerial) {
+  // Bands are processed in turn here: the result must not depend on the band split
+  auto serial_for = [](size_t count, const std::function<void(size_t)> & fn) {
+      for (size_t i = 0; i < count; ++i) {
+        fn(i);
+      }
+    };
+
+  std::vector<uint8_t> expected_buffer;
+  std::vector<uint8_t> actual_buffer;
+  GroupsRemover remover;
+  ParallelGroupsRemover parallel_remover;
+  unsigned int seed = 42;
+
+  for (auto connectivity : {ConnectivityType::Way4, ConnectivityType::Way8}) {
+    for (size_t bands : {1, 2, 3, 7, 40}) {
+      for (int density : {20, 45, 70}) {
+        Image<uint8_t> expected = makeImage<uint8_t>(37, 23, expected_buffer);
+        expected.forEach(
+          [&](uint8_t & v) {
+            v = rand_r(&seed) % 100 < density ? FOREGROUND_CODE : BACKGROUND_CODE;
+          });
+        Image<uint8_t> actual = clone(expected, actual_buffer);
+
+        remover.removeGroups(expected, buffer_, connectivity, 5, isBackground);
+        parallel_remover.removeGroups(
+          actual, connectivity, 5, isBackground, bands, serial_for);
+        ASSERT_TRUE(isEqual(expected, actual)) << "bands " << bands << " density " << density;
+      }
+    }
+  }
+}
+
 ShapeBuffer3x3 shape_buffer{};
 const Image<uint8_t> cross_shape = createShape(shape_buffer, ConnectivityType::Way4);
 
@@ -102,6 +102,7 @@ public:
 
 protected:
   void createMaps(unsigned char master_value, int8_t mask_value, const std::string & mask_frame);
+  void setMaskValue(unsigned int mx, unsigned int my, int8_t value);
   void publishMaps();
   void rePublishInfo(double base, double multiplier);
   void rePublishMask();
@@ -174,6 +175,11 @@ void TestNode::createMaps(
   mask_->data.resize(width * height, mask_value);
 }
 
+void TestNode::setMaskValue(unsigned int mx, unsigned int my, int8_t value)
+{
+  mask_->data[my * mask_->info.width + mx] = value;
+}
+
 void TestNode::publishMaps()
 {
   info_publisher_ = std::make_shared<InfoPublisher>(0.0, 1.0);
@@ -412,6 +418,42 @@ TEST_F(TestNode, testUnknownKeepout)
   reset();
 }
 
+TEST_F(TestNode, testMixedKeepout)
+{
+  // Initialize test system
+  createMaps(nav2_costmap_2d::NO_INFORMATION, nav2_util::OCC_GRID_FREE, "map");
+  setMaskValue(0, 1, nav2_util::OCC_GRID_OCCUPIED);
+  setMaskValue(1, 1, nav2_util::OCC_GRID_OCCUPIED);
+  setMaskValue(2, 1, nav2_util::OCC_GRID_UNKNOWN);
+  setMaskValue(1, 2, (nav2_util::OCC_GRID_OCCUPIED - nav2_util::OCC_GRID_FREE) / 2);
+  publishMaps();
+  createKeepoutFilter("map");
+
+  // Test KeepoutFilter
+  geometry_msgs::msg::Pose2D pose;
+  keepout_filter_->process(*master_grid_, 0, 0, 10, 10, pose);
+  for (unsigned int y = 0; y < 10; y++) {
+    for (unsigned int x = 0; x < 10; x++) {
+      unsigned char expected = nav2_costmap_2d::NO_INFORMATION;
+      if (x >= 3 && x < 6 && y >= 3 && y < 6) {
+        expected = nav2_costmap_2d::FREE_SPACE;
+      }
+      if ((x == 3 || x == 4) && y == 4) {
+        expected = nav2_costmap_2d::LETHAL_OBSTACLE;
+      } else if (x == 5 && y == 4) {
+        expected = nav2_costmap_2d::NO_INFORMATION;
+      } else if (x == 4 && y == 5) {
+        expected = (nav2_costmap_2d::LETHAL_OBSTACLE - nav2_costmap_2d::FREE_SPACE) / 2;
+      }
+      EXPECT_EQ(master_grid_->getCost(x, y), expected) << "cell (" << x << ", " << y << ")";
+    }
+  }
+
+  // Clean-up
+  keepout_filter_->resetFilter();
+  reset();
+}
+
 TEST_F(TestNode, testInfoRePublish)
 {
   // Initialize test system
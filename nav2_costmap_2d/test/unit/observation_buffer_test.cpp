@@ -0,0 +1,168 @@
+// Copyright (c) 2024 Open Navigation LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <memory>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include "rclcpp/rclcpp.hpp"
+#include "sensor_msgs/point_cloud2_iterator.hpp"
+#include "nav2_costmap_2d/observation_buffer.hpp"
+
+class RclCppFixture
+{
+public:
+  RclCppFixture() {rclcpp::init(0, nullptr);}
+  ~RclCppFixture() {rclcpp::shutdown();}
+};
+RclCppFixture g_rclcppfixture;
+
+class ObservationBufferTest : public ::testing::Test
+{
+public:
+  ObservationBufferTest()
+  : node_(nav2_util::LifecycleNode::make_shared("observation_buffer_test")),
+    tf_(node_->get_clock())
+  {
+    // Sensor one meter ahead of the map origin
+    geometry_msgs::msg::TransformStamped transform;
+    transform.header.frame_id = "map";
+    transform.child_frame_id = "sensor";
+    transform.transform.translation.x = 1.0;
+    transform.transform.rotation.w = 1.0;
+    tf_.setTransform(transform, "test", true);
+
+    buffer_ = std::make_unique<nav2_costmap_2d::ObservationBuffer>(
+      node_, "cloud", 0.0, 0.0, 0.0, 2.0, 10.0, 0.0, 10.0, 0.0, tf_, "map", "",
+      tf2::durationFromSec(0.1));
+  }
+
+  sensor_msgs::msg::PointCloud2 makeCloud(const std::vector<std::vector<float>> & points)
+  {
+    sensor_msgs::msg::PointCloud2 cloud;
+    cloud.header.frame_id = "sensor";
+    sensor_msgs::PointCloud2Modifier modifier(cloud);
+    modifier.setPointCloud2FieldsByString(1, "xyz");
+    modifier.resize(points.size());
+    sensor_msgs::PointCloud2Iterator<float> iter_x(cloud, "x");
+    sensor_msgs::PointCloud2Iterator<float> iter_y(cloud, "y");
+    sensor_msgs::PointCloud2Iterator<float> iter_z(cloud, "z");
+    for (const auto & point : points) {
+      *iter_x = point[0];
+      *iter_y = point[1];
+      *iter_z = point[2];
+      ++iter_x;
+      ++iter_y;
+      ++iter_z;
+    }
+    return cloud;
+  }
+
+protected:
+  nav2_util::LifecycleNode::SharedPtr node_;
+  tf2_ros::Buffer tf_;
+  std::unique_ptr<nav2_costmap_2d::ObservationBuffer> buffer_;
+};
+
+TEST_F(ObservationBufferTest, transformsAndFiltersHeight)
+{
+  buffer_->bufferCloud(makeCloud({{0.0, 0.0, 1.0}, {2.0, 1.0, 0.5}, {0.0, 0.0, 3.0}}));
+
+  std::vector<nav2_costmap_2d::Observation> observations;
+  buffer_->getObservations(observations);
+  ASSERT_EQ(observations.size(), 1u);
+  EXPECT_DOUBLE_EQ(observations[0].origin_.x, 1.0);
+
+  const sensor_msgs::msg::PointCloud2 & cloud = *observations[0].cloud_;
+  EXPECT_EQ(cloud.header.frame_id, "map");
+  ASSERT_EQ(cloud.width * cloud.height, 2u);
+  sensor_msgs::PointCloud2ConstIterator<float> iter_x(cloud, "x");
+  sensor_msgs::PointCloud2ConstIterator<float> iter_y(cloud, "y");
+  EXPECT_FLOAT_EQ(*iter_x, 1.0);
+  ++iter_x;
+  ++iter_y;
+  EXPECT_FLOAT_EQ(*iter_x, 3.0);
+  EXPECT_FLOAT_EQ(*iter_y, 1.0);
+}
+
+TEST_F(ObservationBufferTest, voxelFilterKeepsOnePointPerVoxel)
+{
+  buffer_->setVoxelFilter(0.5, 0.5, 0.0, 0.0);
+  EXPECT_TRUE(buffer_->isVoxelFilterEnabled());
+
+  // The first three points share a voxel once shifted into the map frame
+  buffer_->bufferCloud(
+    makeCloud(
+      {{0.05, 0.05, 0.1}, {0.2, 0.3, 0.2}, {0.45, 0.45, 0.45},
+        {0.05, 0.05, 0.6}, {0.7, 0.05, 0.1}}));
+
+  std::vector<nav2_costmap_2d::Observation> observations;
+  buffer_->getObservations(observations);
+  ASSERT_EQ(observations.size(), 1u);
+  EXPECT_EQ(observations[0].cloud_->width * observations[0].cloud_->height, 3u);
+
+  buffer_->setVoxelFilter(0.0, 0.0, 0.0, 0.0);
+  EXPECT_FALSE(buffer_->isVoxelFilterEnabled());
+}
+
+TEST_F(ObservationBufferTest, visitsNewObservationsOnce)
+{
+  uint64_t sequence = 0;
+  size_t visited = 0;
+  auto visit = [&](const nav2_costmap_2d::Observation &) {visited++;};
+
+  // Without persistence only the latest observation is kept
+  buffer_->bufferCloud(makeCloud({{0.0, 0.0, 1.0}}));
+  buffer_->bufferCloud(makeCloud({{0.0, 0.0, 1.0}, {1.0, 0.0, 1.0}}));
+  buffer_->visitNewObservations(sequence, visit);
+  EXPECT_EQ(visited, 1u);
+  EXPECT_EQ(sequence, 2u);
+
+  buffer_->visitNewObservations(sequence, visit);
+  EXPECT_EQ(visited, 1u);
+
+  buffer_->bufferCloud(makeCloud({{0.0, 0.0, 1.0}}));
+  buffer_->visitNewObservations(sequence, visit);
+  EXPECT_EQ(visited, 2u);
+}
+
+TEST_F(ObservationBufferTest, ringGrowsWithPersistence)
+{
+  auto buffer = std::make_unique<nav2_costmap_2d::ObservationBuffer>(
+    node_, "cloud", 10.0, 0.0, 0.0, 2.0, 10.0, 0.0, 10.0, 0.0, tf_, "map", "",
+    tf2::durationFromSec(0.1));
+
+  // More fresh observations than the initial ring holds, each of i + 1 points
+  for (unsigned int i = 0; i < 20; i++) {
+    auto cloud = makeCloud(std::vector<std::vector<float>>(i + 1, {0.0, 0.0, 1.0}));
+    cloud.header.stamp = node_->now();
+    buffer->bufferCloud(cloud);
+  }
+
+  std::vector<nav2_costmap_2d::Observation> observations;
+  buffer->getObservations(observations);
+  ASSERT_EQ(observations.size(), 20u);
+  EXPECT_EQ(observations.front().cloud_->width, 20u);
+  EXPECT_EQ(observations.back().cloud_->width, 1u);
+
+  // Visited oldest first, from the last visit on
+  uint64_t sequence = 15;
+  std::vector<unsigned int> widths;
+  buffer->visitNewObservations(
+    sequence, [&](const nav2_costmap_2d::Observation & obs) {
+      widths.push_back(obs.cloud_->width);
+    });
+  EXPECT_EQ(widths, (std::vector<unsigned int>{16, 17, 18, 19, 20}));
+}
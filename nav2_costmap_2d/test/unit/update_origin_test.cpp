@@ -0,0 +1,120 @@
+// Copyright (c) 2024 Open Navigation LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+
+#include <cstring>
+
+#include "nav2_costmap_2d/costmap_2d.hpp"
+#include "nav2_costmap_2d/cost_values.hpp"
+
+static void fillPattern(nav2_costmap_2d::Costmap2D & costmap)
+{
+  for (unsigned int j = 0; j < costmap.getSizeInCellsY(); ++j) {
+    for (unsigned int i = 0; i < costmap.getSizeInCellsX(); ++i) {
+      costmap.setCost(i, j, static_cast<unsigned char>((j * 17 + i) % 250));
+    }
+  }
+}
+
+TEST(UpdateOrigin, shiftMatchesWindowMove)
+{
+  const int size_x = 9;
+  const int size_y = 7;
+  for (int dy = -8; dy <= 8; ++dy) {
+    for (int dx = -10; dx <= 10; ++dx) {
+      nav2_costmap_2d::Costmap2D reference(
+        size_x, size_y, 1.0, 0.0, 0.0, nav2_costmap_2d::NO_INFORMATION);
+      nav2_costmap_2d::Costmap2D costmap(
+        size_x, size_y, 1.0, 0.0, 0.0, nav2_costmap_2d::NO_INFORMATION);
+      fillPattern(reference);
+      fillPattern(costmap);
+
+      costmap.updateOrigin(dx, dy);
+      EXPECT_DOUBLE_EQ(costmap.getOriginX(), dx);
+      EXPECT_DOUBLE_EQ(costmap.getOriginY(), dy);
+
+      for (int y = 0; y < size_y; ++y) {
+        for (int x = 0; x < size_x; ++x) {
+          const int old_x = x + dx;
+          const int old_y = y + dy;
+          unsigned char expected = nav2_costmap_2d::NO_INFORMATION;
+          if (old_x >= 0 && old_x < size_x && old_y >= 0 && old_y < size_y) {
+            expected = reference.getCost(old_x, old_y);
+          }
+          ASSERT_EQ(costmap.getCost(x, y), expected) <<
+            "shift (" << dx << ", " << dy << ") cell (" << x << ", " << y << ")";
+        }
+      }
+    }
+  }
+}
+
+TEST(UpdateOrigin, subCellMoveKeepsMap)
+{
+  nav2_costmap_2d::Costmap2D costmap(5, 5, 1.0, 0.0, 0.0);
+  fillPattern(costmap);
+  nav2_costmap_2d::Costmap2D reference(costmap);
+
+  costmap.updateOrigin(0.4, 0.9);
+  EXPECT_DOUBLE_EQ(costmap.getOriginX(), 0.0);
+  EXPECT_DOUBLE_EQ(costmap.getOriginY(), 0.0);
+  for (unsigned int j = 0; j < 5; ++j) {
+    for (unsigned int i = 0; i < 5; ++i) {
+      EXPECT_EQ(costmap.getCost(i, j), reference.getCost(i, j));
+    }
+  }
+}
+
+TEST(SparseStorage, matchesDenseStorage)
+{
+  // Spans several chunks of shared default values
+  const unsigned int size_x = 3000;
+  const unsigned int size_y = 1500;
+  for (unsigned char default_value : {nav2_costmap_2d::FREE_SPACE,
+      nav2_costmap_2d::NO_INFORMATION})
+  {
+    nav2_costmap_2d::Costmap2D dense;
+    nav2_costmap_2d::Costmap2D sparse;
+    dense.setDefaultValue(default_value);
+    sparse.setDefaultValue(default_value);
+    sparse.setSparseStorage(true);
+    dense.resizeMap(size_x, size_y, 0.05, 0.0, 0.0);
+    sparse.resizeMap(size_x, size_y, 0.05, 0.0, 0.0);
+
+    for (unsigned int k = 0; k < 2000; ++k) {
+      const unsigned int x = (k * 7919) % size_x;
+      const unsigned int y = (k * 104729) % size_y;
+      dense.setCost(x, y, nav2_costmap_2d::LETHAL_OBSTACLE);
+      sparse.setCost(x, y, nav2_costmap_2d::LETHAL_OBSTACLE);
+    }
+    dense.updateOrigin(3.3, -1.7);
+    sparse.updateOrigin(3.3, -1.7);
+    ASSERT_EQ(
+      memcmp(dense.getCharMap(), sparse.getCharMap(), size_x * size_y), 0);
+
+    // Resetting maps the default values again
+    sparse.resetMaps();
+    dense.resetMaps();
+    ASSERT_EQ(
+      memcmp(dense.getCharMap(), sparse.getCharMap(), size_x * size_y), 0);
+
+    // Copies are dense, and may outlive the sparse map
+    sparse.setCost(10, 20, nav2_costmap_2d::INSCRIBED_INFLATED_OBSTACLE);
+    nav2_costmap_2d::Costmap2D copy(sparse);
+    sparse.resizeMap(100, 100, 0.05, 0.0, 0.0);
+    EXPECT_EQ(copy.getCost(10, 20), nav2_costmap_2d::INSCRIBED_INFLATED_OBSTACLE);
+    EXPECT_EQ(sparse.getCost(10, 20), default_value);
+  }
+}
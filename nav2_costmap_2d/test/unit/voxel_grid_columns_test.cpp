@@ -0,0 +1,125 @@
+// Copyright (c) 2024 Open Navigation LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+
+#include <vector>
+
+#include "nav2_costmap_2d/voxel_grid_columns.hpp"
+
+using nav2_costmap_2d::VoxelGridColumns;
+using nav2_costmap_2d::VoxelPoint;
+
+namespace
+{
+
+nav2_msgs::msg::VoxelGridUpdate makeKeyframe(uint64_t sequence, uint32_t size_x, uint32_t size_y)
+{
+  nav2_msgs::msg::VoxelGridUpdate update;
+  update.sequence = sequence;
+  update.keyframe = true;
+  update.origin.x = 1.0;
+  update.origin.y = -1.0;
+  update.resolutions.x = 0.5;
+  update.resolutions.y = 0.5;
+  update.resolutions.z = 0.25;
+  update.size_x = size_x;
+  update.size_y = size_y;
+  update.size_z = 4;
+  update.data.assign(size_x * size_y, 0);
+  return update;
+}
+
+}  // namespace
+
+TEST(VoxelGridColumns, convertsMarkedAndUnknownVoxels)
+{
+  VoxelGridColumns columns(4);
+  auto update = makeKeyframe(1, 10, 10);
+  // Column (3, 2): z = 0 marked (both bits), z = 2 unknown (low bit only),
+  // z = 5 marked but above size_z
+  update.data[2 * 10 + 3] = (1u << 16) | 1u | (1u << 2) | (1u << 21) | (1u << 5);
+  ASSERT_TRUE(columns.applyUpdate(update));
+  EXPECT_EQ(columns.convertChangedTiles(), 9u);
+
+  std::vector<VoxelPoint> marked, unknown;
+  columns.getMarked(marked);
+  columns.getUnknown(unknown);
+  ASSERT_EQ(marked.size(), 1u);
+  ASSERT_EQ(unknown.size(), 1u);
+  EXPECT_FLOAT_EQ(marked[0].x, 1.0f + 3.5f * 0.5f);
+  EXPECT_FLOAT_EQ(marked[0].y, -1.0f + 2.5f * 0.5f);
+  EXPECT_FLOAT_EQ(marked[0].z, 0.5f * 0.25f);
+  EXPECT_FLOAT_EQ(unknown[0].z, 2.5f * 0.25f);
+
+  // Nothing changed
+  EXPECT_EQ(columns.convertChangedTiles(), 0u);
+}
+
+TEST(VoxelGridColumns, appliesDeltasInSequence)
+{
+  VoxelGridColumns columns(4);
+  ASSERT_TRUE(columns.applyUpdate(makeKeyframe(5, 10, 10)));
+  columns.convertChangedTiles();
+
+  nav2_msgs::msg::VoxelGridUpdate delta = makeKeyframe(6, 10, 10);
+  delta.keyframe = false;
+  delta.data.clear();
+  delta.indices = {9 * 10 + 9};
+  delta.data = {(1u << 17) | (1u << 1)};
+  ASSERT_TRUE(columns.applyUpdate(delta));
+  // Only the tile of the changed column
+  EXPECT_EQ(columns.convertChangedTiles(), 1u);
+
+  std::vector<VoxelPoint> marked;
+  columns.getMarked(marked);
+  ASSERT_EQ(marked.size(), 1u);
+  EXPECT_FLOAT_EQ(marked[0].x, 1.0f + 9.5f * 0.5f);
+
+  // A gap in the sequence waits for a keyframe
+  delta.sequence = 8;
+  EXPECT_FALSE(columns.applyUpdate(delta));
+  delta.sequence = 9;
+  EXPECT_FALSE(columns.applyUpdate(delta));
+
+  // A keyframe of the same geometry only converts the tiles changed
+  auto keyframe = makeKeyframe(10, 10, 10);
+  EXPECT_TRUE(columns.applyUpdate(keyframe));
+  EXPECT_EQ(columns.convertChangedTiles(), 1u);
+  columns.getMarked(marked);
+  EXPECT_TRUE(marked.empty());
+}
+
+TEST(VoxelGridColumns, setsWholeGrids)
+{
+  VoxelGridColumns columns;
+  nav2_msgs::msg::VoxelGrid grid;
+  grid.size_x = 3;
+  grid.size_y = 2;
+  grid.size_z = 16;
+  grid.resolutions.x = grid.resolutions.y = grid.resolutions.z = 1.0;
+  grid.data.assign(6, 0xFFFFFFFFu);
+  columns.setGrid(grid);
+  EXPECT_TRUE(columns.hasGrid());
+  columns.convertChangedTiles();
+
+  std::vector<VoxelPoint> marked;
+  columns.getMarked(marked);
+  EXPECT_EQ(marked.size(), 6u * 16u);
+
+  // Whole grids are not part of the update stream
+  auto delta = makeKeyframe(1, 3, 2);
+  delta.keyframe = false;
+  EXPECT_FALSE(columns.applyUpdate(delta));
+}
@@ -16,12 +16,17 @@
 #define OPENNAV_DOCKING__CONTROLLER_HPP_
 
 #include <memory>
+#include <string>
 #include <vector>
 
 #include "geometry_msgs/msg/pose.hpp"
 #include "geometry_msgs/msg/twist.hpp"
+#include "nav2_costmap_2d/costmap_subscriber.hpp"
+#include "nav2_costmap_2d/footprint_collision_checker.hpp"
+#include "nav2_costmap_2d/footprint_subscriber.hpp"
 #include "nav2_graceful_controller/smooth_control_law.hpp"
 #include "nav2_util/lifecycle_node.hpp"
+#include "tf2_ros/buffer.h"
 
 namespace opennav_docking
 {
@@ -34,19 +39,28 @@ class Controller
 public:
   /**
    * @brief Create a controller instance. Configure ROS 2 parameters.
+   * @param node Node to get the parameters of, and to subscribe from
+   * @param tf TF buffer, required for collision detection
+   * @param fixed_frame Fixed frame the approach is simulated in, that of the costmap
+   * @param base_frame Robot base frame
    */
-  explicit Controller(const rclcpp_lifecycle::LifecycleNode::SharedPtr & node);
+  explicit Controller(
+    const nav2_util::LifecycleNode::SharedPtr & node,
+    std::shared_ptr<tf2_ros::Buffer> tf = nullptr,
+    std::string fixed_frame = "odom", std::string base_frame = "base_link");
 
   /**
    * @brief Compute a velocity command using control law.
    * @param pose Target pose, in robot centric coordinates.
    * @param cmd Command velocity.
    * @param backward If true, robot will drive backwards to goal.
-   * @returns True if command is valid, false otherwise.
+   * @param is_docking If true, the target is the dock, else the robot leaves it.
+   * @returns True if command is valid, false otherwise, e.g. if collision detection
+   * is enabled and the approach to the target is in collision.
    */
   bool computeVelocityCommand(
     const geometry_msgs::msg::Pose & pose, geometry_msgs::msg::Twist & cmd,
-    bool backward = false);
+    bool backward = false, bool is_docking = true);
 
   /**
    * @brief Callback executed when a parameter change is detected
@@ -60,10 +74,75 @@ public:
   std::mutex dynamic_params_lock_;
 
 protected:
+  /**
+   * @brief Check that the approach to the target is collision free in the costmap,
+   * simulating it again only if the target drifted or the robot left it
+   * @param target_pose Target pose, in robot centric coordinates
+   * @param is_docking If true, the target is the dock, else the robot leaves it
+   * @param backward If true, robot will drive backwards to goal
+   * @return True if collision free, false if in collision or unable to check
+   */
+  bool isTrajectoryCollisionFree(
+    const geometry_msgs::msg::Pose & target_pose, bool is_docking, bool backward);
+
+  /**
+   * @brief Check whether the approach has to be simulated again
+   * @param robot_pose Robot pose, in fixed frame
+   * @param target_pose Target pose, in fixed frame
+   * @param backward If true, robot will drive backwards to goal
+   * @return True if no approach was simulated, or if it is no longer valid
+   */
+  bool needsSimulation(
+    const geometry_msgs::msg::Pose & robot_pose, const geometry_msgs::msg::Pose & target_pose,
+    bool backward);
+
+  /**
+   * @brief Simulate the approach to the target with the control law, for up to the
+   * projection time
+   * @param robot_pose Robot pose, in fixed frame
+   * @param target_pose Target pose, in fixed frame
+   * @param backward If true, robot will drive backwards to goal
+   * @param tolerance Distance to the target it is considered reached at
+   */
+  void simulateTrajectory(
+    const geometry_msgs::msg::Pose & robot_pose, const geometry_msgs::msg::Pose & target_pose,
+    bool backward, double tolerance);
+
+  /**
+   * @brief Rasterize the footprint for the collision checks again, if it or the
+   * costmap resolution changed
+   * @param footprint Unoriented robot footprint
+   * @param resolution Costmap resolution
+   */
+  void updateFootprintCache(const nav2_costmap_2d::Footprint & footprint, double resolution);
+
   std::unique_ptr<nav2_graceful_controller::SmoothControlLaw> control_law_;
 
   double k_phi_, k_delta_, beta_, lambda_;
   double slowdown_radius_, v_linear_min_, v_linear_max_, v_angular_max_;
+
+  // Collision detection of the simulated approach
+  bool use_collision_detection_;
+  double projection_time_, simulation_time_step_, transform_tolerance_;
+  double dock_collision_threshold_, resimulation_threshold_;
+  int collision_footprint_headings_;
+  std::shared_ptr<tf2_ros::Buffer> tf2_buffer_;
+  std::string fixed_frame_, base_frame_;
+  std::unique_ptr<nav2_costmap_2d::CostmapSubscriber> costmap_sub_;
+  std::unique_ptr<nav2_costmap_2d::FootprintSubscriber> footprint_sub_;
+  nav2_costmap_2d::FootprintCollisionChecker<std::shared_ptr<nav2_costmap_2d::Costmap2D>>
+  collision_checker_;
+  nav2_costmap_2d::Footprint cached_footprint_;
+  double cached_resolution_{0.0};
+  rclcpp::Logger logger_{rclcpp::get_logger("DockingController")};
+
+  // Approach last simulated in fixed frame, checked every cycle from the pose
+  // closest to the robot until the target drifts or the robot leaves it
+  std::vector<geometry_msgs::msg::Pose> trajectory_;
+  geometry_msgs::msg::Pose trajectory_target_;
+  bool trajectory_backward_{false};
+  bool trajectory_reaches_target_{false};
+  size_t trajectory_index_{0};
 };
 
 }  // namespace opennav_docking
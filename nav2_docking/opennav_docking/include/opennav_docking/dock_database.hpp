@@ -15,9 +15,12 @@
 #ifndef OPENNAV_DOCKING__DOCK_DATABASE_HPP_
 #define OPENNAV_DOCKING__DOCK_DATABASE_HPP_
 
+#include <cstdint>
+#include <functional>
 #include <vector>
 #include <memory>
 #include <string>
+#include <unordered_map>
 
 #include "rclcpp/rclcpp.hpp"
 #include "pluginlib/class_loader.hpp"
@@ -75,6 +78,19 @@ public:
    */
   Dock * findDock(const std::string & dock_id);
 
+  /**
+   * @brief Find the nearest dock instance & plugin of a type in the database,
+   * searching the spatial index of the docks of that type in each of their frames
+   * @param type Dock type to find, may be empty if only using one type of dock
+   * @param get_robot_position Gets the position of the robot in a dock frame
+   * @param dock_id Id of the dock found
+   * @return Dock pointer
+   */
+  Dock * findNearestDock(
+    const std::string & type,
+    const std::function<geometry_msgs::msg::Point(const std::string &)> & get_robot_position,
+    std::string & dock_id);
+
   /**
    * @brief Find a dock plugin to use for a given type
    * @param type Dock type to find plugin for
@@ -117,6 +133,27 @@ protected:
    */
   Dock * findDockInstance(const std::string & dock_id);
 
+  /**
+   * @brief Index the dock instances by type, frame and grid cell of their position
+   */
+  void indexDockInstances();
+
+  /**
+   * @brief Get the type the docks of a type are indexed by, that of the only dock
+   * plugin if the type is not set
+   * @param type Dock type
+   * @return Type indexed
+   */
+  std::string getIndexedType(const std::string & type) const;
+
+  /**
+   * @brief Get the key of a grid cell of the spatial index
+   * @param cell_x Cell column
+   * @param cell_y Cell row
+   * @return Cell key
+   */
+  static int64_t getCellKey(const int cell_x, const int cell_y);
+
   /**
    * @brief Service request to reload database of docks
    * @param request Service request
@@ -129,6 +166,23 @@ protected:
   rclcpp_lifecycle::LifecycleNode::WeakPtr node_;
   DockPluginMap dock_plugins_;
   DockMap dock_instances_;
+
+  // Spatial index of the dock instances of a type in a frame, bucketing them in grid cells
+  struct IndexedDock
+  {
+    double x, y;
+    const std::string * id;
+    Dock * dock;
+  };
+  struct DockGrid
+  {
+    std::unordered_map<int64_t, std::vector<IndexedDock>> cells;
+    int min_cell_x, max_cell_x, min_cell_y, max_cell_y;
+  };
+  // Index of the dock grids by type, then frame
+  std::unordered_map<std::string, std::unordered_map<std::string, DockGrid>> dock_index_;
+  // Size (m) of the grid cells of the spatial index
+  static constexpr double INDEX_CELL_SIZE = 5.0;
   pluginlib::ClassLoader<opennav_docking_core::ChargingDock> dock_loader_;
   rclcpp::Service<nav2_msgs::srv::ReloadDockDatabase>::SharedPtr reload_db_service_;
 };
@@ -17,10 +17,12 @@
 
 #include <vector>
 #include <memory>
+#include <mutex>
 #include <string>
 
 #include "rclcpp/rclcpp.hpp"
 #include "nav2_util/lifecycle_node.hpp"
+#include "nav2_util/node_thread.hpp"
 #include "nav2_util/node_utils.hpp"
 #include "nav2_util/simple_action_server.hpp"
 #include "nav2_util/twist_publisher.hpp"
@@ -208,6 +210,31 @@ protected:
    */
   void undockRobot();
 
+  /**
+   * @brief Starts detecting the dock in the background, on the detection callback group,
+   * when asynchronous detection is enabled
+   * @param dock Dock to detect
+   * @param dock_pose Initial estimate of the dock pose, in fixed frame
+   */
+  void startDetection(Dock * dock, const geometry_msgs::msg::PoseStamped & dock_pose);
+
+  /**
+   * @brief Stops detecting the dock in the background, waiting for a detection in progress
+   */
+  void stopDetection();
+
+  /**
+   * @brief Detection timer callback, refining the dock pose and storing it as the latest one
+   */
+  void detectDock();
+
+  /**
+   * @brief Gets the latest dock pose refined in the background
+   * @param dock_pose Latest refined dock pose
+   * @return False if the latest detection failed
+   */
+  bool getDetectedPose(geometry_msgs::msg::PoseStamped & dock_pose);
+
   /**
    * @brief Callback executed when a parameter change is detected
    * @param event ParameterEvent message
@@ -240,6 +267,8 @@ protected:
   bool dock_backwards_;
   // The tolerance to the dock's staging pose not requiring navigation
   double dock_prestaging_tolerance_;
+  // Whether to detect the dock in the background while approaching it
+  bool async_detection_;
 
   // This is a class member so it can be accessed in publish feedback
   rclcpp::Time action_start_time_;
@@ -255,6 +284,19 @@ protected:
 
   std::shared_ptr<tf2_ros::Buffer> tf2_buffer_;
   std::unique_ptr<tf2_ros::TransformListener> tf2_listener_;
+
+  // Background dock detection, so the approach never waits on perception
+  rclcpp::CallbackGroup::SharedPtr detection_callback_group_;
+  rclcpp::executors::SingleThreadedExecutor::SharedPtr detection_executor_;
+  std::unique_ptr<nav2_util::NodeThread> detection_thread_;
+  rclcpp::TimerBase::SharedPtr detection_timer_;
+  // Held while detecting, so the dock is not released mid-detection
+  std::mutex detection_mutex_;
+  opennav_docking_core::ChargingDock::Ptr detection_plugin_;
+  geometry_msgs::msg::PoseStamped detection_pose_;
+  // Latest refined dock pose, nullptr if the latest detection failed. Only
+  // accessed through std::atomic_load / std::atomic_store
+  std::shared_ptr<const geometry_msgs::msg::PoseStamped> detected_pose_;
 };
 
 }  // namespace opennav_docking
@@ -17,6 +17,7 @@
 
 #include <string>
 #include <memory>
+#include <mutex>
 #include <vector>
 
 #include "geometry_msgs/msg/pose_stamped.hpp"
@@ -116,6 +117,8 @@ protected:
   // This is the actual dock pose once it has the specified translation/rotation applied
   // If not subscribed to a topic, this is simply the database dock pose
   geometry_msgs::msg::PoseStamped dock_pose_;
+  // Guards the detected and actual dock poses, refined and checked on different threads
+  std::mutex pose_mutex_;
 
   // Subscribe to battery message, used to determine if charging
   rclcpp::Subscription<sensor_msgs::msg::BatteryState>::SharedPtr battery_sub_;
@@ -12,16 +12,25 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+#include <cmath>
 #include <memory>
+#include <string>
 
 #include "rclcpp/rclcpp.hpp"
+#include "angles/angles.h"
 #include "opennav_docking/controller.hpp"
+#include "nav2_costmap_2d/cost_values.hpp"
 #include "nav2_util/node_utils.hpp"
+#include "tf2/utils.h"
+#include "tf2_geometry_msgs/tf2_geometry_msgs.hpp"
 
 namespace opennav_docking
 {
 
-Controller::Controller(const rclcpp_lifecycle::LifecycleNode::SharedPtr & node)
+Controller::Controller(
+  const nav2_util::LifecycleNode::SharedPtr & node, std::shared_ptr<tf2_ros::Buffer> tf,
+  std::string fixed_frame, std::string base_frame)
+: tf2_buffer_(tf), fixed_frame_(fixed_frame), base_frame_(base_frame)
 {
   nav2_util::declare_parameter_if_not_declared(
     node, "controller.k_phi", rclcpp::ParameterValue(3.0));
@@ -39,6 +48,26 @@ Controller::Controller(const rclcpp_lifecycle::LifecycleNode::SharedPtr & node)
     node, "controller.v_angular_max", rclcpp::ParameterValue(0.75));
   nav2_util::declare_parameter_if_not_declared(
     node, "controller.slowdown_radius", rclcpp::ParameterValue(0.25));
+  nav2_util::declare_parameter_if_not_declared(
+    node, "controller.use_collision_detection", rclcpp::ParameterValue(false));
+  nav2_util::declare_parameter_if_not_declared(
+    node, "controller.costmap_topic",
+    rclcpp::ParameterValue(std::string("local_costmap/costmap_raw")));
+  nav2_util::declare_parameter_if_not_declared(
+    node, "controller.footprint_topic",
+    rclcpp::ParameterValue(std::string("local_costmap/published_footprint")));
+  nav2_util::declare_parameter_if_not_declared(
+    node, "controller.transform_tolerance", rclcpp::ParameterValue(0.1));
+  nav2_util::declare_parameter_if_not_declared(
+    node, "controller.projection_time", rclcpp::ParameterValue(5.0));
+  nav2_util::declare_parameter_if_not_declared(
+    node, "controller.simulation_time_step", rclcpp::ParameterValue(0.1));
+  nav2_util::declare_parameter_if_not_declared(
+    node, "controller.dock_collision_threshold", rclcpp::ParameterValue(0.3));
+  nav2_util::declare_parameter_if_not_declared(
+    node, "controller.resimulation_threshold", rclcpp::ParameterValue(0.05));
+  nav2_util::declare_parameter_if_not_declared(
+    node, "controller.collision_footprint_headings", rclcpp::ParameterValue(72));
 
   node->get_parameter("controller.k_phi", k_phi_);
   node->get_parameter("controller.k_delta", k_delta_);
@@ -48,6 +77,33 @@ Controller::Controller(const rclcpp_lifecycle::LifecycleNode::SharedPtr & node)
   node->get_parameter("controller.v_linear_max", v_linear_max_);
   node->get_parameter("controller.v_angular_max", v_angular_max_);
   node->get_parameter("controller.slowdown_radius", slowdown_radius_);
+  node->get_parameter("controller.use_collision_detection", use_collision_detection_);
+  node->get_parameter("controller.transform_tolerance", transform_tolerance_);
+  node->get_parameter("controller.projection_time", projection_time_);
+  node->get_parameter("controller.simulation_time_step", simulation_time_step_);
+  node->get_parameter("controller.dock_collision_threshold", dock_collision_threshold_);
+  node->get_parameter("controller.resimulation_threshold", resimulation_threshold_);
+  node->get_parameter(
+    "controller.collision_footprint_headings", collision_footprint_headings_);
+  logger_ = node->get_logger();
+
+  if (use_collision_detection_) {
+    if (!tf2_buffer_) {
+      throw std::runtime_error("Collision detection of the docking controller needs TF");
+    }
+    if (simulation_time_step_ <= 0.0 || collision_footprint_headings_ <= 0) {
+      throw std::runtime_error(
+              "Simulation time step and collision footprint headings must be positive");
+    }
+
+    std::string costmap_topic, footprint_topic;
+    node->get_parameter("controller.costmap_topic", costmap_topic);
+    node->get_parameter("controller.footprint_topic", footprint_topic);
+    costmap_sub_ = std::make_unique<nav2_costmap_2d::CostmapSubscriber>(node, costmap_topic);
+    footprint_sub_ = std::make_unique<nav2_costmap_2d::FootprintSubscriber>(
+      node, footprint_topic, *tf2_buffer_, base_frame_, transform_tolerance_);
+  }
+
   control_law_ = std::make_unique<nav2_graceful_controller::SmoothControlLaw>(
     k_phi_, k_delta_, beta_, lambda_, slowdown_radius_, v_linear_min_, v_linear_max_,
     v_angular_max_);
@@ -58,13 +114,157 @@ Controller::Controller(const rclcpp_lifecycle::LifecycleNode::SharedPtr & node)
 }
 
 bool Controller::computeVelocityCommand(
-  const geometry_msgs::msg::Pose & pose, geometry_msgs::msg::Twist & cmd, bool backward)
+  const geometry_msgs::msg::Pose & pose, geometry_msgs::msg::Twist & cmd, bool backward,
+  bool is_docking)
 {
   std::lock_guard<std::mutex> lock(dynamic_params_lock_);
   cmd = control_law_->calculateRegularVelocity(pose, backward);
+  return !use_collision_detection_ || isTrajectoryCollisionFree(pose, is_docking, backward);
+}
+
+bool Controller::isTrajectoryCollisionFree(
+  const geometry_msgs::msg::Pose & target_pose, bool is_docking, bool backward)
+{
+  // Get the robot and the target in the fixed frame of the costmap
+  geometry_msgs::msg::TransformStamped base_to_fixed;
+  try {
+    base_to_fixed = tf2_buffer_->lookupTransform(
+      fixed_frame_, base_frame_, tf2::TimePointZero,
+      tf2::durationFromSec(transform_tolerance_));
+  } catch (const tf2::TransformException & ex) {
+    RCLCPP_WARN(logger_, "Could not get the robot pose to check collisions: %s", ex.what());
+    return false;
+  }
+  geometry_msgs::msg::Pose robot_pose, target;
+  robot_pose.position.x = base_to_fixed.transform.translation.x;
+  robot_pose.position.y = base_to_fixed.transform.translation.y;
+  robot_pose.orientation = base_to_fixed.transform.rotation;
+  tf2::doTransform(target_pose, target, base_to_fixed);
+
+  std::shared_ptr<nav2_costmap_2d::Costmap2D> costmap;
+  try {
+    costmap = costmap_sub_->getCostmap();
+  } catch (const std::runtime_error & ex) {
+    RCLCPP_WARN(logger_, "Could not check collisions: %s", ex.what());
+    return false;
+  }
+  nav2_costmap_2d::Footprint footprint;
+  std_msgs::msg::Header footprint_header;
+  if (!footprint_sub_->getFootprintInRobotFrame(footprint, footprint_header)) {
+    RCLCPP_WARN(logger_, "Could not check collisions: robot footprint not available");
+    return false;
+  }
+  collision_checker_.setCostmap(costmap);
+  updateFootprintCache(footprint, costmap->getResolution());
+
+  if (needsSimulation(robot_pose, target, backward)) {
+    simulateTrajectory(robot_pose, target, backward, costmap->getResolution());
+  }
+
+  // The costmap changes every cycle, so the rest of the approach is always checked.
+  // Near the dock, its own cells are expected under the footprint.
+  const geometry_msgs::msg::Pose & dock = is_docking ? trajectory_target_ : trajectory_.front();
+  for (size_t i = trajectory_index_; i < trajectory_.size(); ++i) {
+    const geometry_msgs::msg::Pose & pose = trajectory_[i];
+    if (std::hypot(pose.position.x - dock.position.x, pose.position.y - dock.position.y) <
+      dock_collision_threshold_)
+    {
+      continue;
+    }
+
+    const double cost = collision_checker_.footprintCostAtPoseCached(
+      pose.position.x, pose.position.y, tf2::getYaw(pose.orientation));
+    if (cost == static_cast<double>(nav2_costmap_2d::LETHAL_OBSTACLE) ||
+      cost == static_cast<double>(nav2_costmap_2d::NO_INFORMATION))
+    {
+      RCLCPP_WARN(logger_, "Collision detected in the approach trajectory");
+      return false;
+    }
+  }
+
   return true;
 }
 
+bool Controller::needsSimulation(
+  const geometry_msgs::msg::Pose & robot_pose, const geometry_msgs::msg::Pose & target_pose,
+  bool backward)
+{
+  if (trajectory_.empty() || backward != trajectory_backward_) {
+    return true;
+  }
+
+  // Simulate again once the refined target drifted
+  const double target_drift = std::hypot(
+    target_pose.position.x - trajectory_target_.position.x,
+    target_pose.position.y - trajectory_target_.position.y);
+  const double target_rotation = std::fabs(
+    angles::shortest_angular_distance(
+      tf2::getYaw(target_pose.orientation), tf2::getYaw(trajectory_target_.orientation)));
+  if (target_drift > resimulation_threshold_ || target_rotation > resimulation_threshold_) {
+    return true;
+  }
+
+  // Follow the robot along the trajectory, simulating again once it left it, or once it
+  // reached the end of a trajectory cut at the projection time
+  auto distance_to = [&robot_pose](const geometry_msgs::msg::Pose & pose) {
+      return std::hypot(
+        pose.position.x - robot_pose.position.x, pose.position.y - robot_pose.position.y);
+    };
+  while (trajectory_index_ + 1 < trajectory_.size() &&
+    distance_to(trajectory_[trajectory_index_ + 1]) <=
+    distance_to(trajectory_[trajectory_index_]))
+  {
+    ++trajectory_index_;
+  }
+  if (distance_to(trajectory_[trajectory_index_]) > resimulation_threshold_) {
+    return true;
+  }
+  return !trajectory_reaches_target_ && trajectory_index_ + 1 == trajectory_.size();
+}
+
+void Controller::simulateTrajectory(
+  const geometry_msgs::msg::Pose & robot_pose, const geometry_msgs::msg::Pose & target_pose,
+  bool backward, double tolerance)
+{
+  trajectory_.clear();
+  trajectory_.push_back(robot_pose);
+  trajectory_target_ = target_pose;
+  trajectory_backward_ = backward;
+  trajectory_reaches_target_ = false;
+  trajectory_index_ = 0;
+
+  const int steps = static_cast<int>(std::ceil(projection_time_ / simulation_time_step_));
+  geometry_msgs::msg::Pose next_pose = robot_pose;
+  for (int i = 0; i < steps; ++i) {
+    next_pose = control_law_->calculateNextPose(
+      simulation_time_step_, target_pose, next_pose, backward);
+    trajectory_.push_back(next_pose);
+
+    if (std::hypot(
+        target_pose.position.x - next_pose.position.x,
+        target_pose.position.y - next_pose.position.y) < tolerance)
+    {
+      trajectory_reaches_target_ = true;
+      break;
+    }
+  }
+}
+
+void Controller::updateFootprintCache(
+  const nav2_costmap_2d::Footprint & footprint, double resolution)
+{
+  if (collision_checker_.hasFootprintCache() && footprint == cached_footprint_ &&
+    resolution == cached_resolution_)
+  {
+    return;
+  }
+
+  collision_checker_.setFootprintCache(
+    footprint, static_cast<unsigned int>(collision_footprint_headings_), true);
+  cached_footprint_ = footprint;
+  cached_resolution_ = resolution;
+}
+
 rcl_interfaces::msg::SetParametersResult
 Controller::dynamicParametersCallback(std::vector<rclcpp::Parameter> parameters)
 {
@@ -98,6 +298,9 @@ Controller::dynamicParametersCallback(std::vector<rclcpp::Parameter> parameters)
       control_law_->setCurvatureConstants(k_phi_, k_delta_, beta_, lambda_);
       control_law_->setSlowdownRadius(slowdown_radius_);
       control_law_->setSpeedLimit(v_linear_min_, v_linear_max_, v_angular_max_);
+
+      // The approach simulated with the previous params no longer holds
+      trajectory_.clear();
     }
   }
 
@@ -14,6 +14,10 @@
 
 #include "opennav_docking/dock_database.hpp"
 
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
 namespace opennav_docking
 {
 
@@ -23,6 +27,7 @@ DockDatabase::DockDatabase()
 
 DockDatabase::~DockDatabase()
 {
+  dock_index_.clear();
   dock_instances_.clear();
   dock_plugins_.clear();
 }
@@ -47,6 +52,7 @@ bool DockDatabase::initialize(
       "An error occurred while getting the dock instances!");
     return false;
   }
+  indexDockInstances();
 
   RCLCPP_INFO(
     node->get_logger(),
@@ -86,6 +92,7 @@ void DockDatabase::reloadDbCb(
   DockMap dock_instances;
   if (utils::parseDockFile(request->filepath, node, dock_instances)) {
     dock_instances_ = dock_instances;
+    indexDockInstances();
     response->success = true;
     RCLCPP_INFO(
       node->get_logger(),
@@ -121,6 +128,67 @@ Dock * DockDatabase::findDockInstance(const std::string & dock_id)
   return nullptr;
 }
 
+Dock * DockDatabase::findNearestDock(
+  const std::string & type,
+  const std::function<geometry_msgs::msg::Point(const std::string &)> & get_robot_position,
+  std::string & dock_id)
+{
+  auto type_it = dock_index_.find(getIndexedType(type));
+  if (type_it == dock_index_.end()) {
+    throw opennav_docking_core::DockNotInDB("No dock of the type requested is in database!");
+  }
+
+  const IndexedDock * nearest = nullptr;
+  double nearest_dist = std::numeric_limits<double>::max();
+  for (const auto & frame_grid : type_it->second) {
+    const DockGrid & grid = frame_grid.second;
+    const geometry_msgs::msg::Point position = get_robot_position(frame_grid.first);
+    const int cell_x = static_cast<int>(std::floor(position.x / INDEX_CELL_SIZE));
+    const int cell_y = static_cast<int>(std::floor(position.y / INDEX_CELL_SIZE));
+
+    // Search the rings of cells around the robot's one, until no dock of the next ring
+    // can be nearer than the nearest one found, or the grid is covered
+    const int max_ring = std::max(
+      std::max(std::abs(grid.min_cell_x - cell_x), std::abs(grid.max_cell_x - cell_x)),
+      std::max(std::abs(grid.min_cell_y - cell_y), std::abs(grid.max_cell_y - cell_y)));
+    for (int ring = 0; ring <= max_ring; ++ring) {
+      for (int dy = -ring; dy <= ring; ++dy) {
+        // Only the first and last rows of the ring are full, the others only have both ends
+        const int step = (dy == -ring || dy == ring) ? 1 : 2 * ring;
+        for (int dx = -ring; dx <= ring; dx += step) {
+          auto cell_it = grid.cells.find(getCellKey(cell_x + dx, cell_y + dy));
+          if (cell_it == grid.cells.end()) {
+            continue;
+          }
+          for (const IndexedDock & indexed : cell_it->second) {
+            const double dist = std::hypot(indexed.x - position.x, indexed.y - position.y);
+            if (dist < nearest_dist) {
+              nearest_dist = dist;
+              nearest = &indexed;
+            }
+          }
+        }
+      }
+
+      if (nearest_dist <= ring * INDEX_CELL_SIZE) {
+        break;
+      }
+    }
+  }
+
+  if (!nearest) {
+    throw opennav_docking_core::DockNotInDB("No dock of the type requested is in database!");
+  }
+
+  ChargingDock::Ptr dock_plugin = findDockPlugin(nearest->dock->type);
+  if (!dock_plugin) {
+    throw opennav_docking_core::DockNotValid("Dock requested has no valid plugin!");
+  }
+  nearest->dock->plugin = dock_plugin;
+  dock_id = *nearest->id;
+  return nearest->dock;
+}
+
 ChargingDock::Ptr DockDatabase::findDockPlugin(const std::string & type)
 {
   // If only one dock plugin and type not set, use the default dock
@@ -217,6 +285,47 @@ bool DockDatabase::getDockInstances(const rclcpp_lifecycle::LifecycleNode::Share
   return true;
 }
 
+void DockDatabase::indexDockInstances()
+{
+  dock_index_.clear();
+  for (auto & instance : dock_instances_) {
+    Dock & dock = instance.second;
+    const int cell_x = static_cast<int>(std::floor(dock.pose.position.x / INDEX_CELL_SIZE));
+    const int cell_y = static_cast<int>(std::floor(dock.pose.position.y / INDEX_CELL_SIZE));
+
+    auto & frame_grids = dock_index_[getIndexedType(dock.type)];
+    auto grid_it = frame_grids.find(dock.frame);
+    if (grid_it == frame_grids.end()) {
+      grid_it = frame_grids.emplace(
+        dock.frame, DockGrid{{}, cell_x, cell_x, cell_y, cell_y}).first;
+    }
+
+    DockGrid & grid = grid_it->second;
+    grid.cells[getCellKey(cell_x, cell_y)].push_back(
+      {dock.pose.position.x, dock.pose.position.y, &instance.first, &dock});
+    grid.min_cell_x = std::min(grid.min_cell_x, cell_x);
+    grid.max_cell_x = std::max(grid.max_cell_x, cell_x);
+    grid.min_cell_y = std::min(grid.min_cell_y, cell_y);
+    grid.max_cell_y = std::max(grid.max_cell_y, cell_y);
+  }
+}
+
+std::string DockDatabase::getIndexedType(const std::string & type) const
+{
+  // If only one dock plugin and type not set, the docks are of the default dock
+  if (type.empty() && dock_plugins_.size() == 1) {
+    return dock_plugins_.begin()->first;
+  }
+  return type;
+}
+
+int64_t DockDatabase::getCellKey(const int cell_x, const int cell_y)
+{
+  return static_cast<int64_t>(
+    (static_cast<uint64_t>(static_cast<uint32_t>(cell_x)) << 32) |
+    static_cast<uint32_t>(cell_y));
+}
+
 unsigned int DockDatabase::plugin_size() const
 {
   return dock_plugins_.size();
@@ -40,6 +40,7 @@ DockingServer::DockingServer(const rclcpp::NodeOptions & options)
   declare_parameter("fixed_frame", "odom");
   declare_parameter("dock_backwards", false);
   declare_parameter("dock_prestaging_tolerance", 0.5);
+  declare_parameter("async_detection", false);
 }
 
 nav2_util::CallbackReturn
@@ -59,6 +60,7 @@ DockingServer::on_configure(const rclcpp_lifecycle::State & /*state*/)
   get_parameter("fixed_frame", fixed_frame_);
   get_parameter("dock_backwards", dock_backwards_);
   get_parameter("dock_prestaging_tolerance", dock_prestaging_tolerance_);
+  get_parameter("async_detection", async_detection_);
   RCLCPP_INFO(get_logger(), "Controller frequency set to %.4fHz", controller_frequency_);
 
   vel_publisher_ = std::make_unique<nav2_util::TwistPublisher>(node, "cmd_vel", 1);
@@ -85,13 +87,24 @@ DockingServer::on_configure(const rclcpp_lifecycle::State & /*state*/)
     true, server_options);
 
   // Create composed utilities
-  controller_ = std::make_unique<Controller>(node);
+  controller_ = std::make_unique<Controller>(node, tf2_buffer_, fixed_frame_, base_frame_);
   navigator_ = std::make_unique<Navigator>(node);
   dock_db_ = std::make_unique<DockDatabase>();
   if (!dock_db_->initialize(node, tf2_buffer_)) {
     return nav2_util::CallbackReturn::FAILURE;
   }
 
+  // Separate callback group and executor to detect the dock while the docking action
+  // is controlling the approach
+  if (async_detection_) {
+    detection_callback_group_ = create_callback_group(
+      rclcpp::CallbackGroupType::MutuallyExclusive, false);
+    detection_executor_ = std::make_shared<rclcpp::executors::SingleThreadedExecutor>();
+    detection_executor_->add_callback_group(
+      detection_callback_group_, get_node_base_interface());
+    detection_thread_ = std::make_unique<nav2_util::NodeThread>(detection_executor_);
+  }
+
   return nav2_util::CallbackReturn::SUCCESS;
 }
 
@@ -144,6 +157,10 @@ nav2_util::CallbackReturn
 DockingServer::on_cleanup(const rclcpp_lifecycle::State & /*state*/)
 {
   RCLCPP_INFO(get_logger(), "Cleaning up %s", get_name());
+  stopDetection();
+  detection_thread_.reset();
+  detection_executor_.reset();
+  detection_callback_group_.reset();
   tf2_buffer_.reset();
   docking_action_server_.reset();
   undocking_action_server_.reset();
@@ -219,10 +236,20 @@ void DockingServer::dockRobot()
   getPreemptedGoalIfRequested(goal, docking_action_server_);
   Dock * dock{nullptr};
   num_retries_ = 0;
+  // Docks found in the database are kept, docks from the request are temporary
+  const bool dock_in_db = goal->use_dock_id || goal->use_nearest_dock;
 
   try {
     // Get dock (instance and plugin information) from request
-    if (goal->use_dock_id) {
+    if (goal->use_nearest_dock) {
+      dock = dock_db_->findNearestDock(
+        goal->dock_type,
+        [this](const std::string & frame) {return getRobotPoseInFrame(frame).pose.position;},
+        result->dock_id);
+      RCLCPP_INFO(
+        get_logger(),
+        "Attempting to dock robot at nearest charger %s.", result->dock_id.c_str());
+    } else if (goal->use_dock_id) {
       RCLCPP_INFO(
         get_logger(),
         "Attempting to dock robot at charger %s.", goal->dock_id.c_str());
@@ -276,7 +303,7 @@ void DockingServer::dockRobot()
             RCLCPP_INFO(get_logger(), "Robot is charging!");
             result->success = true;
             result->num_retries = num_retries_;
-            stashDockData(goal->use_dock_id, dock, true);
+            stashDockData(dock_in_db, dock, true);
             publishZeroVelocity();
             docking_action_server_->succeeded_current(result);
             return;
@@ -284,7 +311,7 @@ void DockingServer::dockRobot()
         }
 
         // Cancelled, preempted, or shutting down (recoverable errors throw DockingException)
-        stashDockData(goal->use_dock_id, dock, false);
+        stashDockData(dock_in_db, dock, false);
         publishZeroVelocity();
         docking_action_server_->terminate_all(result);
         return;
@@ -299,7 +326,7 @@ void DockingServer::dockRobot()
       // Reset to staging pose to try again
       if (!resetApproach(dock->getStagingPose())) {
         // Cancelled, preempted, or shutting down
-        stashDockData(goal->use_dock_id, dock, false);
+        stashDockData(dock_in_db, dock, false);
         publishZeroVelocity();
         docking_action_server_->terminate_all(result);
         return;
@@ -336,7 +363,7 @@ void DockingServer::dockRobot()
   }
 
   // Store dock state for later undocking and delete temp dock, if applicable
-  stashDockData(goal->use_dock_id, dock, false);
+  stashDockData(dock_in_db, dock, false);
   result->num_retries = num_retries_;
   publishZeroVelocity();
   docking_action_server_->terminate_current(result);
@@ -387,6 +414,10 @@ void DockingServer::doInitialPerception(Dock * dock, geometry_msgs::msg::PoseSta
 
 bool DockingServer::approachDock(Dock * dock, geometry_msgs::msg::PoseStamped & dock_pose)
 {
+  // Detect in the background for the approach, however it ends
+  startDetection(dock, dock_pose);
+  std::shared_ptr<void> detection_guard(nullptr, [this](void *) {stopDetection();});
+
   rclcpp::Rate loop_rate(controller_frequency_);
   auto start = this->now();
   auto timeout = rclcpp::Duration::from_seconds(dock_approach_timeout_);
@@ -406,7 +437,9 @@ bool DockingServer::approachDock(Dock * dock, geometry_msgs::msg::PoseStamped &
     }
 
     // Update perception
-    if (!dock->plugin->getRefinedPose(dock_pose)) {
+    const bool detected = detection_timer_ ?
+      getDetectedPose(dock_pose) : dock->plugin->getRefinedPose(dock_pose);
+    if (!detected) {
       throw opennav_docking_core::FailedToDetectDock("Failed dock detection");
     }
 
@@ -442,6 +475,68 @@ bool DockingServer::approachDock(Dock * dock, geometry_msgs::msg::PoseStamped &
   return false;
 }
 
+void DockingServer::startDetection(Dock * dock, const geometry_msgs::msg::PoseStamped & dock_pose)
+{
+  if (!detection_executor_) {
+    return;
+  }
+
+  stopDetection();
+  {
+    std::lock_guard<std::mutex> lock(detection_mutex_);
+    detection_plugin_ = dock->plugin;
+    detection_pose_ = dock_pose;
+  }
+  std::atomic_store(
+    &detected_pose_, std::make_shared<const geometry_msgs::msg::PoseStamped>(dock_pose));
+
+  detection_timer_ = create_wall_timer(
+    std::chrono::duration<double>(1.0 / controller_frequency_),
+    std::bind(&DockingServer::detectDock, this), detection_callback_group_);
+}
+
+void DockingServer::stopDetection()
+{
+  if (!detection_timer_) {
+    return;
+  }
+
+  detection_timer_->cancel();
+  detection_timer_.reset();
+  std::lock_guard<std::mutex> lock(detection_mutex_);
+  detection_plugin_.reset();
+}
+
+void DockingServer::detectDock()
+{
+  std::lock_guard<std::mutex> lock(detection_mutex_);
+  if (!detection_plugin_) {
+    return;
+  }
+
+  // The last refined pose is the estimate of the next detection
+  geometry_msgs::msg::PoseStamped dock_pose = detection_pose_;
+  if (!detection_plugin_->getRefinedPose(dock_pose)) {
+    std::atomic_store(&detected_pose_, std::shared_ptr<const geometry_msgs::msg::PoseStamped>());
+    return;
+  }
+
+  detection_pose_ = dock_pose;
+  std::atomic_store(
+    &detected_pose_, std::make_shared<const geometry_msgs::msg::PoseStamped>(dock_pose));
+}
+
+bool DockingServer::getDetectedPose(geometry_msgs::msg::PoseStamped & dock_pose)
+{
+  auto detected_pose = std::atomic_load(&detected_pose_);
+  if (!detected_pose) {
+    return false;
+  }
+
+  dock_pose = *detected_pose;
+  return true;
+}
+
 bool DockingServer::waitForCharge(Dock * dock)
 {
   rclcpp::Rate loop_rate(controller_frequency_);
@@ -529,7 +624,7 @@ bool DockingServer::getCommandToPose(
   tf2_buffer_->transform(target_pose, target_pose, base_frame_);
 
   // Compute velocity command
-  if (!controller_->computeVelocityCommand(target_pose.pose, cmd, backward)) {
+  if (!controller_->computeVelocityCommand(target_pose.pose, cmd, backward, false)) {
     throw opennav_docking_core::FailedToControl("Failed to get control");
   }
 
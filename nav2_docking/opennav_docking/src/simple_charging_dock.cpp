@@ -115,6 +115,7 @@ void SimpleChargingDock::configure(
     dock_pose_sub_ = node_->create_subscription<geometry_msgs::msg::PoseStamped>(
       "detected_dock_pose", 1,
       [this](const geometry_msgs::msg::PoseStamped::SharedPtr pose) {
+        std::lock_guard<std::mutex> lock(pose_mutex_);
         detected_dock_pose_ = *pose;
       });
   }
@@ -171,12 +172,18 @@ bool SimpleChargingDock::getRefinedPose(geometry_msgs::msg::PoseStamped & pose)
   // If using not detection, set the dock pose to the static fixed-frame version
   if (!use_external_detection_pose_) {
     dock_pose_pub_->publish(pose);
+    std::lock_guard<std::mutex> lock(pose_mutex_);
     dock_pose_ = pose;
     return true;
   }
 
-  // If using detections, get current detections, transform to frame, and apply offsets
-  geometry_msgs::msg::PoseStamped detected = detected_dock_pose_;
+  // If using detections, get current detections, transform to frame, and apply offsets.
+  // Detections may be refined on another thread than the one receiving them
+  geometry_msgs::msg::PoseStamped detected;
+  {
+    std::lock_guard<std::mutex> lock(pose_mutex_);
+    detected = detected_dock_pose_;
+  }
 
   // Validate that external pose is new enough
   auto timeout = rclcpp::Duration::from_seconds(external_detection_timeout_);
@@ -215,23 +222,28 @@ bool SimpleChargingDock::getRefinedPose(geometry_msgs::msg::PoseStamped & pose)
   transform.transform.rotation = detected.pose.orientation;
   tf2::doTransform(just_orientation, just_orientation, transform);
 
+  geometry_msgs::msg::PoseStamped dock_pose;
   tf2::Quaternion orientation;
   orientation.setEuler(0.0, 0.0, tf2::getYaw(just_orientation.pose.orientation));
-  dock_pose_.pose.orientation = tf2::toMsg(orientation);
+  dock_pose.pose.orientation = tf2::toMsg(orientation);
 
-  // Construct dock_pose_ by applying translation/rotation
-  dock_pose_.header = detected.header;
-  dock_pose_.pose.position = detected.pose.position;
-  const double yaw = tf2::getYaw(dock_pose_.pose.orientation);
-  dock_pose_.pose.position.x += cos(yaw) * external_detection_translation_x_ -
+  // Construct dock_pose by applying translation/rotation
+  dock_pose.header = detected.header;
+  dock_pose.pose.position = detected.pose.position;
+  const double yaw = tf2::getYaw(dock_pose.pose.orientation);
+  dock_pose.pose.position.x += cos(yaw) * external_detection_translation_x_ -
     sin(yaw) * external_detection_translation_y_;
-  dock_pose_.pose.position.y += sin(yaw) * external_detection_translation_x_ +
+  dock_pose.pose.position.y += sin(yaw) * external_detection_translation_x_ +
     cos(yaw) * external_detection_translation_y_;
-  dock_pose_.pose.position.z = 0.0;
+  dock_pose.pose.position.z = 0.0;
+  {
+    std::lock_guard<std::mutex> lock(pose_mutex_);
+    dock_pose_ = dock_pose;
+  }
 
   // Publish & return dock pose for debugging purposes
-  dock_pose_pub_->publish(dock_pose_);
-  pose = dock_pose_;
+  dock_pose_pub_->publish(dock_pose);
+  pose = dock_pose;
   return true;
 }
 
@@ -242,7 +254,13 @@ bool SimpleChargingDock::isDocked()
     return is_stalled_;
   }
 
-  if (dock_pose_.header.frame_id.empty()) {
+  geometry_msgs::msg::PoseStamped dock_pose;
+  {
+    std::lock_guard<std::mutex> lock(pose_mutex_);
+    dock_pose = dock_pose_;
+  }
+
+  if (dock_pose.header.frame_id.empty()) {
     // Dock pose is not yet valid
     return false;
   }
@@ -253,15 +271,15 @@ bool SimpleChargingDock::isDocked()
   base_pose.header.frame_id = "base_link";
   base_pose.pose.orientation.w = 1.0;
   try {
-    tf2_buffer_->transform(base_pose, base_pose, dock_pose_.header.frame_id);
+    tf2_buffer_->transform(base_pose, base_pose, dock_pose.header.frame_id);
   } catch (const tf2::TransformException & ex) {
     return false;
   }
 
   // If we are close enough, pretend we are charging
   double d = std::hypot(
-    base_pose.pose.position.x - dock_pose_.pose.position.x,
-    base_pose.pose.position.y - dock_pose_.pose.position.y);
+    base_pose.pose.position.x - dock_pose.pose.position.x,
+    base_pose.pose.position.y - dock_pose.pose.position.y);
   return d < docking_threshold_;
 }
 
@@ -17,6 +17,7 @@
 #include "geometry_msgs/msg/twist.hpp"
 #include "geometry_msgs/msg/pose.hpp"
 #include "opennav_docking/controller.hpp"
+#include "nav2_util/lifecycle_node.hpp"
 #include "ament_index_cpp/get_package_share_directory.hpp"
 
 // Testing the controller at high level; the nav2_graceful_controller
@@ -35,7 +36,7 @@ namespace opennav_docking
 
 TEST(ControllerTests, ObjectLifecycle)
 {
-  auto node = std::make_shared<rclcpp_lifecycle::LifecycleNode>("test");
+  auto node = std::make_shared<nav2_util::LifecycleNode>("test");
   auto controller = std::make_unique<opennav_docking::Controller>(node);
 
   geometry_msgs::msg::Pose pose;
@@ -45,8 +46,23 @@ TEST(ControllerTests, ObjectLifecycle)
   controller.reset();
 }
 
+TEST(ControllerTests, CollisionDetectionUnavailable)
+{
+  auto node = std::make_shared<nav2_util::LifecycleNode>("test");
+  node->declare_parameter("controller.use_collision_detection", rclcpp::ParameterValue(true));
+  EXPECT_THROW(opennav_docking::Controller controller(node), std::runtime_error);
+
+  // Without costmap, footprint or robot pose, collisions cannot be checked
+  auto tf = std::make_shared<tf2_ros::Buffer>(node->get_clock());
+  auto controller = std::make_unique<opennav_docking::Controller>(node, tf, "odom", "base_link");
+  geometry_msgs::msg::Pose pose;
+  pose.position.x = 1.0;
+  geometry_msgs::msg::Twist cmd_out;
+  EXPECT_FALSE(controller->computeVelocityCommand(pose, cmd_out));
+}
+
 TEST(ControllerTests, DynamicParameters) {
-  auto node = std::make_shared<rclcpp_lifecycle::LifecycleNode>("test");
+  auto node = std::make_shared<nav2_util::LifecycleNode>("test");
   auto controller = std::make_shared<opennav_docking::Controller>(node);
 
   auto params = std::make_shared<rclcpp::AsyncParametersClient>(
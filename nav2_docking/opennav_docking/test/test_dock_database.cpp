@@ -13,6 +13,9 @@
 // limitations under the License.
 
 #include <chrono>
+#include <cmath>
+#include <limits>
+#include <string>
 #include "gtest/gtest.h"
 #include "rclcpp/rclcpp.hpp"
 #include "opennav_docking/dock_database.hpp"
@@ -57,6 +60,37 @@ public:
     dock_plugins_.insert({"second_dock_t", nullptr});
     dock_instances_.insert({"second_dock", dock});
   }
+
+  void populateGrid(const std::string & type, const std::string & frame)
+  {
+    // Docks spread unevenly over 300 m, in rows getting sparser
+    for (int i = 0; i < 20; ++i) {
+      for (int j = 0; j < 15; ++j) {
+        Dock dock;
+        dock.type = type;
+        dock.frame = frame;
+        dock.pose.position.x = -150.0 + i * 15.0 + 0.37 * j;
+        dock.pose.position.y = -100.0 + j * j * 1.3;
+        dock_instances_.insert({type + std::to_string(i) + "_" + std::to_string(j), dock});
+      }
+    }
+    indexDockInstances();
+  }
+
+  std::string findNearestBruteForce(const std::string & type, double x, double y)
+  {
+    std::string nearest_id;
+    double nearest_dist = std::numeric_limits<double>::max();
+    for (const auto & instance : dock_instances_) {
+      const double dist = std::hypot(
+        instance.second.pose.position.x - x, instance.second.pose.position.y - y);
+      if (instance.second.type == type && dist < nearest_dist) {
+        nearest_dist = dist;
+        nearest_id = instance.first;
+      }
+    }
+    return nearest_id;
+  }
 };
 
 TEST(DatabaseTests, ObjectLifecycle)
@@ -99,6 +133,47 @@ TEST(DatabaseTests, findTests)
   db.findDockPlugin("");
 }
 
+TEST(DatabaseTests, findNearestDock)
+{
+  auto node = std::make_shared<rclcpp_lifecycle::LifecycleNode>("test");
+  std::vector<std::string> plugins{"dockv1"};
+  node->declare_parameter("dock_plugins", rclcpp::ParameterValue(plugins));
+  node->declare_parameter(
+    "dockv1.plugin",
+    rclcpp::ParameterValue("opennav_docking::SimpleChargingDock"));
+  DbShim db;
+  db.initialize(node, nullptr);
+
+  std::string dock_id;
+  geometry_msgs::msg::Point robot;
+  auto get_robot_position = [&robot](const std::string &) {return robot;};
+  EXPECT_THROW(
+    db.findNearestDock("dockv1", get_robot_position, dock_id),
+    opennav_docking_core::DockNotInDB);
+
+  db.populateGrid("dockv1", "map");
+  EXPECT_EQ(db.instance_size(), 300u);
+  for (double x = -200.0; x <= 200.0; x += 17.3) {
+    for (double y = -150.0; y <= 250.0; y += 11.9) {
+      robot.x = x;
+      robot.y = y;
+      Dock * dock = db.findNearestDock("dockv1", get_robot_position, dock_id);
+      ASSERT_NE(dock, nullptr);
+      EXPECT_NE(dock->plugin, nullptr);
+      EXPECT_EQ(dock_id, db.findNearestBruteForce("dockv1", x, y));
+    }
+  }
+
+  // The only dock type is used when not set
+  robot.x = 0.0;
+  robot.y = 0.0;
+  db.findNearestDock("", get_robot_position, dock_id);
+  EXPECT_EQ(dock_id, db.findNearestBruteForce("dockv1", 0.0, 0.0));
+  EXPECT_THROW(
+    db.findNearestDock("bogus_dock_t", get_robot_position, dock_id),
+    opennav_docking_core::DockNotInDB);
+}
+
 TEST(DatabaseTests, reloadDbService)
 {
   auto node = std::make_shared<rclcpp_lifecycle::LifecycleNode>("test");
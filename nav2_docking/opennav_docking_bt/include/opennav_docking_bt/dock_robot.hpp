@@ -84,6 +84,9 @@ public:
         BT::InputPort<bool>(
           "use_dock_id", true,
           "Whether to use the dock's ID or dock pose fields"),
+        BT::InputPort<bool>(
+          "use_nearest_dock", false,
+          "Whether to use the nearest dock of the dock type in the database instead"),
         BT::InputPort<std::string>("dock_id", "Dock ID or name to use"),
         BT::InputPort<geometry_msgs::msg::PoseStamped>(
           "dock_pose", "The dock pose, if not using dock id"),
@@ -99,6 +102,8 @@ public:
           "error_code", "Error code"),
         BT::OutputPort<ActionResult::_num_retries_type>(
           "num_retries", "The number of retries executed"),
+        BT::OutputPort<std::string>(
+          "dock_id", "The nearest dock found, if using the nearest dock"),
       });
   }
 };
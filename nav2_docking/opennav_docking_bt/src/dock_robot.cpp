@@ -31,7 +31,11 @@ DockRobotAction::DockRobotAction(
 void DockRobotAction::on_tick()
 {
   // Get core inputs about what to perform
-  if (getInput("use_dock_id", goal_.use_dock_id)) {
+  getInput("use_nearest_dock", goal_.use_nearest_dock);
+  if (goal_.use_nearest_dock) {
+    getInput("dock_type", goal_.dock_type);
+    getInput("max_staging_time", goal_.max_staging_time);
+  } else if (getInput("use_dock_id", goal_.use_dock_id)) {
     getInput("dock_id", goal_.dock_id);
   } else {
     getInput("dock_pose", goal_.dock_pose);
@@ -45,6 +49,7 @@ BT::NodeStatus DockRobotAction::on_success()
 {
   setOutput("success", result_.result->success);
   setOutput("num_retries", result_.result->num_retries);
+  setOutput("dock_id", result_.result->dock_id);
   setOutput("error_code_id", ActionResult::NONE);
   return BT::NodeStatus::SUCCESS;
 }
@@ -53,6 +58,7 @@ BT::NodeStatus DockRobotAction::on_aborted()
 {
   setOutput("success", result_.result->success);
   setOutput("num_retries", result_.result->num_retries);
+  setOutput("dock_id", result_.result->dock_id);
   setOutput("error_code_id", result_.result->error_code);
   return BT::NodeStatus::FAILURE;
 }
@@ -0,0 +1,155 @@
+/*
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2017, Locus Robotics
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of the copyright holder nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef COSTMAP_QUEUE__BUCKET_QUEUE_HPP_
+#define COSTMAP_QUEUE__BUCKET_QUEUE_HPP_
+
+#include <stdexcept>
+#include <vector>
+
+namespace costmap_queue
+{
+/**
+ * @brief Templatized priority queue over a fixed set of priorities
+ *
+ * Same interface as MapBasedQueue, but priorities are indices into a flat array of bins, the
+ * rank of the priority among the known ones, so enqueueing and iterating never search or
+ * allocate map nodes. Items of equal priority come out last in, first out, the bins keeping
+ * their storage across resets.
+ */
+template<class item_t>
+class BucketQueue
+{
+public:
+  /**
+   * @brief Default virtual Destructor
+   */
+  virtual ~BucketQueue() = default;
+
+  /**
+   * @brief Clear the queue
+   */
+  virtual void reset()
+  {
+    for (size_t i = front_bucket_; i < buckets_.size() && i <= back_bucket_; i++) {
+      buckets_[i].clear();
+    }
+    item_count_ = 0;
+    front_bucket_ = buckets_.size();
+    back_bucket_ = 0;
+  }
+
+  /**
+   * @brief Set the number of priorities, clearing the queue
+   * @param count Number of bins, one past the highest priority
+   */
+  void setBucketCount(const size_t count)
+  {
+    reset();
+    buckets_.resize(count);
+    front_bucket_ = buckets_.size();
+  }
+
+  /**
+   * @brief Add a new item to the queue with a set priority
+   * @param bucket Priority of the item, less than the number of bins
+   * @param item Payload item
+   */
+  void enqueue(const size_t bucket, item_t item)
+  {
+    buckets_[bucket].push_back(item);
+    item_count_++;
+    if (bucket < front_bucket_) {
+      front_bucket_ = bucket;
+    }
+    if (bucket > back_bucket_) {
+      back_bucket_ = bucket;
+    }
+  }
+
+  /**
+   * @brief Check to see if there is anything in the queue
+   * @return True if there is nothing in the queue
+   *
+   * Must be called prior to front/pop.
+   */
+  bool isEmpty()
+  {
+    return item_count_ == 0;
+  }
+
+  /**
+   * @brief Return the item at the front of the queue
+   * @return The item at the front of the queue
+   */
+  item_t & front()
+  {
+    if (item_count_ == 0) {
+      throw std::out_of_range("front() called on empty costmap_queue::BucketQueue!");
+    }
+
+    return buckets_[front_bucket_].back();
+  }
+
+  /**
+   * @brief Remove (and destroy) the item at the front of the queue
+   */
+  void pop()
+  {
+    if (item_count_ == 0) {
+      return;
+    }
+    buckets_[front_bucket_].pop_back();
+    item_count_--;
+
+    if (item_count_ == 0) {
+      front_bucket_ = buckets_.size();
+      back_bucket_ = 0;
+      return;
+    }
+    while (buckets_[front_bucket_].empty()) {
+      front_bucket_++;
+    }
+  }
+
+protected:
+  std::vector<std::vector<item_t>> buckets_;
+  size_t item_count_{0};
+  // Lowest and highest bins holding items, if any
+  size_t front_bucket_{0};
+  size_t back_bucket_{0};
+};
+}  // namespace costmap_queue
+
+#endif  // COSTMAP_QUEUE__BUCKET_QUEUE_HPP_
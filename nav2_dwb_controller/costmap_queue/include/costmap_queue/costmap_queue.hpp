@@ -40,7 +40,7 @@
 #include <limits>
 #include <memory>
 #include "nav2_costmap_2d/costmap_2d.hpp"
-#include "costmap_queue/map_based_queue.hpp"
+#include "costmap_queue/bucket_queue.hpp"
 
 namespace costmap_queue
 {
@@ -99,13 +99,14 @@ public:
  * retreive the other cells with the isEmpty/getNextCell iterator-like functionality. getNextCell
  * returns an object that contains the coordinates of this cell and the origin cell, as well as
  * the distance between them. By default, the Euclidean distance is used for ordering, but passing in
- * manhattan=true to the constructor will use the Manhattan distance.
+ * manhattan=true to the constructor will use the Manhattan distance. The cells are kept in a
+ * BucketQueue, each distance of the lookup table having its own bin.
  *
  * The validCellToQueue overridable-function allows for deriving classes to limit the queue traversal
  * to a subset of all costmap cells. LimitedCostmapQueue does this by ignoring distances above a limit.
  *
  */
-class CostmapQueue : public MapBasedQueue<CellData>
+class CostmapQueue : public BucketQueue<CellData>
 {
 public:
   /**
@@ -181,7 +182,20 @@ protected:
     unsigned int dy = CellData::absolute_difference(cur_y, src_y);
     return cached_distances_[dx][dy];
   }
+
+  /**
+   * @brief  Lookup the queue bin of pre-computed distances, their rank among the distances
+   */
+  inline size_t bucketLookup(
+    const unsigned int cur_x, const unsigned int cur_y,
+    const unsigned int src_x, const unsigned int src_y)
+  {
+    unsigned int dx = CellData::absolute_difference(cur_x, src_x);
+    unsigned int dy = CellData::absolute_difference(cur_y, src_y);
+    return cached_buckets_[dx][dy];
+  }
   std::vector<std::vector<double>> cached_distances_;
+  std::vector<std::vector<unsigned int>> cached_buckets_;
   int cached_max_distance_;
 };
 }  // namespace costmap_queue
@@ -42,7 +42,7 @@ namespace costmap_queue
 {
 
 CostmapQueue::CostmapQueue(nav2_costmap_2d::Costmap2D & costmap, bool manhattan)
-: MapBasedQueue(), costmap_(costmap), max_distance_(-1), manhattan_(manhattan),
+: BucketQueue(), costmap_(costmap), max_distance_(-1), manhattan_(manhattan),
   cached_max_distance_(-1)
 {
   reset();
@@ -56,7 +56,7 @@ void CostmapQueue::reset()
   }
   std::fill(seen_.begin(), seen_.end(), false);
   computeCache();
-  MapBasedQueue::reset();
+  BucketQueue::reset();
 }
 
 void CostmapQueue::enqueueCell(unsigned int x, unsigned int y)
@@ -77,7 +77,7 @@ void CostmapQueue::enqueueCell(
   CellData data(distance, index, cur_x, cur_y, src_x, src_y);
   if (validCellToQueue(data)) {
     seen_[index] = true;
-    enqueue(distance, data);
+    enqueue(bucketLookup(cur_x, cur_y, src_x, src_y), data);
   }
 }
 
@@ -131,6 +131,26 @@ void CostmapQueue::computeCache()
       }
     }
   }
+
+  // Bins of the queue, equal distances sharing one
+  std::vector<double> distances;
+  distances.reserve(cached_distances_.size() * cached_distances_.size());
+  for (const auto & row : cached_distances_) {
+    distances.insert(distances.end(), row.begin(), row.end());
+  }
+  std::sort(distances.begin(), distances.end());
+  distances.erase(std::unique(distances.begin(), distances.end()), distances.end());
+
+  cached_buckets_.resize(cached_distances_.size());
+  for (unsigned int i = 0; i < cached_distances_.size(); ++i) {
+    cached_buckets_[i].resize(cached_distances_[i].size());
+    for (unsigned int j = 0; j < cached_distances_[i].size(); ++j) {
+      cached_buckets_[i][j] = static_cast<unsigned int>(
+        std::lower_bound(
+          distances.begin(), distances.end(), cached_distances_[i][j]) - distances.begin());
+    }
+  }
+  setBucketCount(distances.size());
   cached_max_distance_ = max_distance_;
 }
 
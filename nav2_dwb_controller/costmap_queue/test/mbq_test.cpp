@@ -34,8 +34,10 @@
 
 #include <string>
 #include "gtest/gtest.h"
+#include "costmap_queue/bucket_queue.hpp"
 #include "costmap_queue/map_based_queue.hpp"
 
+using costmap_queue::BucketQueue;
 using costmap_queue::MapBasedQueue;
 
 void letter_test(MapBasedQueue<char> & q, const char test_letter)
@@ -46,6 +48,14 @@ void letter_test(MapBasedQueue<char> & q, const char test_letter)
   q.pop();
 }
 
+void letter_test(BucketQueue<char> & q, const char test_letter)
+{
+  ASSERT_FALSE(q.isEmpty());
+  char c = q.front();
+  EXPECT_EQ(c, test_letter);
+  q.pop();
+}
+
 TEST(MapBasedQueue, emptyQueue)
 {
   MapBasedQueue<char> q;
@@ -110,6 +120,32 @@ TEST(MapBasedQueue, checkDynamicOrdering3)
   letter_test(q, 'D');
 }
 
+TEST(BucketQueue, checkDynamicOrdering)
+{
+  BucketQueue<char> q;
+  q.setBucketCount(6);
+  EXPECT_TRUE(q.isEmpty());
+  q.enqueue(1, 'A');
+  q.enqueue(2, 'B');
+  q.enqueue(5, 'D');
+  letter_test(q, 'A');
+  letter_test(q, 'B');
+  q.enqueue(1, 'C');
+  q.enqueue(0, 'E');
+  letter_test(q, 'E');
+  letter_test(q, 'C');
+  letter_test(q, 'D');
+  EXPECT_TRUE(q.isEmpty());
+
+  q.enqueue(3, 'F');
+  q.enqueue(4, 'G');
+  q.reset();
+  EXPECT_TRUE(q.isEmpty());
+  q.enqueue(4, 'H');
+  letter_test(q, 'H');
+  EXPECT_TRUE(q.isEmpty());
+}
+
 int main(int argc, char ** argv)
 {
   testing::InitGoogleTest(&argc, argv);
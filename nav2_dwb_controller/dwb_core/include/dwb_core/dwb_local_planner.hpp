@@ -36,16 +36,19 @@
 #define DWB_CORE__DWB_LOCAL_PLANNER_HPP_
 
 #include <memory>
+#include <optional>
 #include <string>
 #include <vector>
 
 #include "nav2_core/controller.hpp"
 #include "nav2_core/goal_checker.hpp"
+#include "dwb_core/exceptions.hpp"
 #include "dwb_core/publisher.hpp"
 #include "dwb_core/trajectory_critic.hpp"
 #include "dwb_core/trajectory_generator.hpp"
 #include "nav_2d_msgs/msg/pose2_d_stamped.hpp"
 #include "nav_2d_msgs/msg/twist2_d_stamped.hpp"
+#include "nav2_util/thread_pool.hpp"
 #include "rclcpp/rclcpp.hpp"
 #include "rclcpp_lifecycle/lifecycle_node.hpp"
 #include "pluginlib/class_loader.hpp"
@@ -178,6 +181,29 @@ protected:
     const nav_2d_msgs::msg::Twist2D velocity,
     std::shared_ptr<dwb_msgs::msg::LocalPlanEvaluation> & results);
 
+  /**
+   * @brief Generate all the trajectories at once and score them critic by critic
+   *
+   * Used by coreScoringAlgorithm when batch_trajectory_scoring_ is set or scoring threads
+   * are used. The trajectories and scores are kept in buffers reused across iterations,
+   * and short circuiting does not apply. With scoring threads, the trajectories are
+   * partitioned over the pool and each is scored with scoreTrajectory by every critic.
+   */
+  dwb_msgs::msg::TrajectoryScore batchScoringAlgorithm(
+    const geometry_msgs::msg::Pose2D & pose,
+    const nav_2d_msgs::msg::Twist2D velocity,
+    std::shared_ptr<dwb_msgs::msg::LocalPlanEvaluation> & results);
+
+  /**
+   * @brief Score a trajectory of the batch with every critic, on a scoring thread
+   */
+  void scoreBatchTrajectory(size_t index);
+
+  /**
+   * @brief Full scoring of a trajectory of the last batch
+   */
+  dwb_msgs::msg::TrajectoryScore makeBatchScore(size_t index);
+
   /**
    * @brief Transforms global plan into same frame as pose, clips far away poses and possibly prunes passed poses
    *
@@ -237,6 +263,15 @@ protected:
   std::string dwb_plugin_name_;
 
   bool short_circuit_trajectory_evaluation_;
+  bool batch_trajectory_scoring_;
+
+  // Buffers of the batch scoring, raw scores by critic then trajectory
+  std::vector<nav_2d_msgs::msg::Twist2D> batch_twists_;
+  std::vector<dwb_msgs::msg::Trajectory2D> batch_trajs_;
+  std::vector<std::vector<double>> batch_scores_;
+  std::vector<std::optional<IllegalTrajectoryException>> batch_errors_;
+  std::vector<double> batch_totals_;
+  std::unique_ptr<nav2_util::ThreadPool> scoring_pool_;
 };
 
 }  // namespace dwb_core
@@ -80,9 +80,13 @@ public:
 
   /**
    * @brief Does the publisher require that the LocalPlanEvaluation be saved
+   *
+   * Only when the evaluation or the trajectories have a subscriber and, if throttled, the
+   * evaluation period elapsed since the last published evaluation.
+   *
    * @return True if the Evaluation is needed to publish either directly or as trajectories
    */
-  bool shouldRecordEvaluation() {return publish_evaluation_ || publish_trajectories_;}
+  bool shouldRecordEvaluation();
 
   /**
    * @brief If the pointer is not null, publish the evaluation and trajectories as needed
@@ -101,6 +105,11 @@ public:
 protected:
   void publishTrajectories(const dwb_msgs::msg::LocalPlanEvaluation & results);
 
+  /**
+   * @brief Keep only the best legal trajectories of an evaluation, by increasing score
+   */
+  void compactEvaluation(dwb_msgs::msg::LocalPlanEvaluation & results);
+
   // Helper function for publishing other plans
   void publishGenericPlan(
     const nav_2d_msgs::msg::Path2D plan,
@@ -118,6 +127,11 @@ protected:
   // Marker Lifetime
   builtin_interfaces::msg::Duration marker_lifetime_;
 
+  // Throttling and size of the evaluations, 0 for every cycle and every trajectory
+  double evaluation_period_;
+  int evaluation_max_trajectories_;
+  rclcpp::Time last_evaluation_time_;
+
   // Publisher Objects
   std::shared_ptr<LifecyclePublisher<dwb_msgs::msg::LocalPlanEvaluation>> eval_pub_;
   std::shared_ptr<LifecyclePublisher<nav_msgs::msg::Path>> global_pub_;
@@ -38,6 +38,7 @@
 #include <string>
 #include <vector>
 #include <memory>
+#include <optional>
 #include <utility>
 
 #include "rclcpp/rclcpp.hpp"
@@ -48,6 +49,7 @@
 #include "dwb_msgs/msg/trajectory2_d.hpp"
 #include "sensor_msgs/msg/point_cloud.hpp"
 #include "nav2_util/lifecycle_node.hpp"
+#include "dwb_core/exceptions.hpp"
 
 namespace dwb_core
 {
@@ -66,7 +68,10 @@ namespace dwb_core
  *       It is presumed that there are multiple trajectories that we want to evaluate,
  *       and there may be some shared work that can be done beforehand to optimize
  *       the scoring of each individual trajectory.
- *  3) scoreTrajectory is called once per trajectory and returns the score.
+ *  3) scoreTrajectory is called once per trajectory and returns the score,
+ *       or scoreTrajectories once for all of them when the planner scores in batches.
+ *       With scoring threads, scoreTrajectory is called concurrently on several
+ *       trajectories and may only read the state set by prepare.
  *  4) debrief is called after each set of trajectories with the chosen trajectory.
  *       This can be used for stateful critics that monitor the trajectory through time.
  *
@@ -146,6 +151,34 @@ public:
    */
   virtual double scoreTrajectory(const dwb_msgs::msg::Trajectory2D & traj) = 0;
 
+  /**
+   * @brief Compute the raw scores of a batch of trajectories
+   *
+   * The default scores each trajectory with scoreTrajectory. Subclasses may override this
+   * to share work between the trajectories of an iteration.
+   *
+   * @param trajs Trajectories to score
+   * @param scores Output raw score of each trajectory, the size of trajs
+   * @param errors Error of each illegal trajectory, the size of trajs. The trajectories
+   *   with an error already are skipped, and those found illegal get theirs set.
+   */
+  virtual void scoreTrajectories(
+    const std::vector<dwb_msgs::msg::Trajectory2D> & trajs,
+    std::vector<double> & scores,
+    std::vector<std::optional<IllegalTrajectoryException>> & errors)
+  {
+    for (size_t i = 0; i < trajs.size(); i++) {
+      if (errors[i]) {
+        continue;
+      }
+      try {
+        scores[i] = scoreTrajectory(trajs[i]);
+      } catch (const IllegalTrajectoryException & e) {
+        errors[i] = e;
+      }
+    }
+  }
+
   /**
    * @brief debrief informs the critic what the chosen cmd_vel was (if it cares)
    */
@@ -124,6 +124,29 @@ public:
     const nav_2d_msgs::msg::Twist2D & start_vel,
     const nav_2d_msgs::msg::Twist2D & cmd_vel) = 0;
 
+  /**
+   * @brief Generate the trajectories of a set of cmd_vels at once
+   *
+   * trajs is resized to the number of cmd_vels. Generators may override this to fill the
+   * trajectories in place, reusing the storage of the previous iteration.
+   *
+   * @param start_pose Current robot location
+   * @param start_vel Current robot velocity
+   * @param cmd_vels The desired command velocities
+   * @param trajs Output trajectories, one per cmd_vel
+   */
+  virtual void generateTrajectories(
+    const geometry_msgs::msg::Pose2D & start_pose,
+    const nav_2d_msgs::msg::Twist2D & start_vel,
+    const std::vector<nav_2d_msgs::msg::Twist2D> & cmd_vels,
+    std::vector<dwb_msgs::msg::Trajectory2D> & trajs)
+  {
+    trajs.resize(cmd_vels.size());
+    for (size_t i = 0; i < cmd_vels.size(); i++) {
+      trajs[i] = generateTrajectory(start_pose, start_vel, cmd_vels[i]);
+    }
+  }
+
   /**
    * @brief Limits the maximum linear speed of the robot.
    * @param speed_limit expressed in absolute value (in m/s)
@@ -108,6 +108,12 @@ void DWBLocalPlanner::configure(
   declare_parameter_if_not_declared(
     node, dwb_plugin_name_ + ".short_circuit_trajectory_evaluation",
     rclcpp::ParameterValue(true));
+  declare_parameter_if_not_declared(
+    node, dwb_plugin_name_ + ".batch_trajectory_scoring",
+    rclcpp::ParameterValue(false));
+  declare_parameter_if_not_declared(
+    node, dwb_plugin_name_ + ".scoring_threads",
+    rclcpp::ParameterValue(1));
 
   std::string traj_generator_name;
 
@@ -130,8 +136,20 @@ void DWBLocalPlanner::configure(
   node->get_parameter(
     dwb_plugin_name_ + ".short_circuit_trajectory_evaluation",
     short_circuit_trajectory_evaluation_);
+  node->get_parameter(
+    dwb_plugin_name_ + ".batch_trajectory_scoring",
+    batch_trajectory_scoring_);
+  int scoring_threads;
+  node->get_parameter(dwb_plugin_name_ + ".scoring_threads", scoring_threads);
   node->get_parameter(dwb_plugin_name_ + ".shorten_transformed_plan", shorten_transformed_plan_);
 
+  scoring_pool_.reset();
+  if (scoring_threads > 1) {
+    // The calling thread scores trajectories as well
+    scoring_pool_ = std::make_unique<nav2_util::ThreadPool>(
+      static_cast<unsigned int>(scoring_threads - 1));
+  }
+
   pub_ = std::make_unique<DWBPublisher>(node, dwb_plugin_name_);
   pub_->on_configure();
 
@@ -167,6 +185,7 @@ DWBLocalPlanner::cleanup()
   pub_->on_cleanup();
 
   traj_generator_.reset();
+  scoring_pool_.reset();
 }
 
 std::string
@@ -368,6 +387,10 @@ DWBLocalPlanner::coreScoringAlgorithm(
   const nav_2d_msgs::msg::Twist2D velocity,
   std::shared_ptr<dwb_msgs::msg::LocalPlanEvaluation> & results)
 {
+  if (batch_trajectory_scoring_ || scoring_pool_) {
+    return batchScoringAlgorithm(pose, velocity, results);
+  }
+
   nav_2d_msgs::msg::Twist2D twist;
   dwb_msgs::msg::Trajectory2D traj;
   dwb_msgs::msg::TrajectoryScore best, worst;
@@ -430,6 +453,140 @@ DWBLocalPlanner::coreScoringAlgorithm(
   return best;
 }
 
+dwb_msgs::msg::TrajectoryScore
+DWBLocalPlanner::batchScoringAlgorithm(
+  const geometry_msgs::msg::Pose2D & pose,
+  const nav_2d_msgs::msg::Twist2D velocity,
+  std::shared_ptr<dwb_msgs::msg::LocalPlanEvaluation> & results)
+{
+  batch_twists_.clear();
+  traj_generator_->startNewIteration(velocity);
+  while (traj_generator_->hasMoreTwists()) {
+    batch_twists_.push_back(traj_generator_->nextTwist());
+  }
+  traj_generator_->generateTrajectories(pose, velocity, batch_twists_, batch_trajs_);
+
+  const size_t count = batch_trajs_.size();
+  batch_errors_.assign(count, std::nullopt);
+  batch_totals_.assign(count, 0.0);
+  batch_scores_.resize(critics_.size());
+  for (auto & scores : batch_scores_) {
+    scores.assign(count, 0.0);
+  }
+
+  if (scoring_pool_) {
+    // Each trajectory is scored by all the critics on one thread, the critics only
+    // reading the state of their prepare() while scoring
+    scoring_pool_->parallelFor(
+      0, count, [this](size_t i) {
+        scoreBatchTrajectory(i);
+      });
+  } else {
+    for (size_t c = 0; c < critics_.size(); c++) {
+      const double scale = critics_[c]->getScale();
+      if (scale == 0.0) {
+        continue;
+      }
+
+      critics_[c]->scoreTrajectories(batch_trajs_, batch_scores_[c], batch_errors_);
+      for (size_t i = 0; i < count; i++) {
+        if (!batch_errors_[i]) {
+          batch_totals_[i] += batch_scores_[c][i] * scale;
+        }
+      }
+    }
+  }
+
+  // Only the best trajectory, or all of them when requested, are made into score messages
+  IllegalTrajectoryTracker tracker;
+  int best_index = -1, worst_index = -1;
+  for (size_t i = 0; i < count; i++) {
+    if (batch_errors_[i]) {
+      tracker.addIllegalTrajectory(*batch_errors_[i]);
+      if (results) {
+        dwb_msgs::msg::TrajectoryScore failed_score;
+        failed_score.traj = batch_trajs_[i];
+
+        dwb_msgs::msg::CriticScore cs;
+        cs.name = batch_errors_[i]->getCriticName();
+        cs.raw_score = -1.0;
+        failed_score.scores.push_back(cs);
+        failed_score.total = -1.0;
+        results->twists.push_back(failed_score);
+      }
+      continue;
+    }
+
+    tracker.addLegalTrajectory();
+    if (results) {
+      results->twists.push_back(makeBatchScore(i));
+    }
+    if (best_index < 0 || batch_totals_[i] < batch_totals_[best_index]) {
+      best_index = static_cast<int>(i);
+      if (results) {
+        results->best_index = results->twists.size() - 1;
+      }
+    }
+    if (worst_index < 0 || batch_totals_[i] > batch_totals_[worst_index]) {
+      worst_index = static_cast<int>(i);
+      if (results) {
+        results->worst_index = results->twists.size() - 1;
+      }
+    }
+  }
+
+  if (best_index < 0) {
+    if (debug_trajectory_details_) {
+      RCLCPP_ERROR(rclcpp::get_logger("DWBLocalPlanner"), "%s", tracker.getMessage().c_str());
+      for (auto const & x : tracker.getPercentages()) {
+        RCLCPP_ERROR(
+          rclcpp::get_logger(
+            "DWBLocalPlanner"), "%.2f: %10s/%s", x.second,
+          x.first.first.c_str(), x.first.second.c_str());
+      }
+    }
+    throw NoLegalTrajectoriesException(tracker);
+  }
+
+  return makeBatchScore(best_index);
+}
+
+void
+DWBLocalPlanner::scoreBatchTrajectory(size_t index)
+{
+  for (size_t c = 0; c < critics_.size(); c++) {
+    const double scale = critics_[c]->getScale();
+    if (scale == 0.0) {
+      continue;
+    }
+
+    try {
+      batch_scores_[c][index] = critics_[c]->scoreTrajectory(batch_trajs_[index]);
+    } catch (const IllegalTrajectoryException & e) {
+      batch_errors_[index] = e;
+      return;
+    }
+    batch_totals_[index] += batch_scores_[c][index] * scale;
+  }
+}
+
+dwb_msgs::msg::TrajectoryScore
+DWBLocalPlanner::makeBatchScore(size_t index)
+{
+  dwb_msgs::msg::TrajectoryScore score;
+  score.traj = batch_trajs_[index];
+  score.scores.reserve(critics_.size());
+  for (size_t c = 0; c < critics_.size(); c++) {
+    dwb_msgs::msg::CriticScore cs;
+    cs.name = critics_[c]->getName();
+    cs.scale = critics_[c]->getScale();
+    cs.raw_score = batch_scores_[c][index];
+    score.scores.push_back(cs);
+  }
+  score.total = batch_totals_[index];
+  return score;
+}
+
 dwb_msgs::msg::TrajectoryScore
 DWBLocalPlanner::scoreTrajectory(
   const dwb_msgs::msg::Trajectory2D & traj,
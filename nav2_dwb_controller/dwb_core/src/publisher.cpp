@@ -62,6 +62,7 @@ DWBPublisher::DWBPublisher(
 {
   auto node = node_.lock();
   clock_ = node->get_clock();
+  last_evaluation_time_ = rclcpp::Time(0, 0, clock_->get_clock_type());
 }
 
 nav2_util::CallbackReturn
@@ -93,6 +94,12 @@ DWBPublisher::on_configure()
   declare_parameter_if_not_declared(
     node, plugin_name_ + ".marker_lifetime",
     rclcpp::ParameterValue(0.1));
+  declare_parameter_if_not_declared(
+    node, plugin_name_ + ".evaluation_period",
+    rclcpp::ParameterValue(0.0));
+  declare_parameter_if_not_declared(
+    node, plugin_name_ + ".evaluation_max_trajectories",
+    rclcpp::ParameterValue(0));
 
   node->get_parameter(plugin_name_ + ".publish_evaluation", publish_evaluation_);
   node->get_parameter(plugin_name_ + ".publish_global_plan", publish_global_plan_);
@@ -100,6 +107,9 @@ DWBPublisher::on_configure()
   node->get_parameter(plugin_name_ + ".publish_local_plan", publish_local_plan_);
   node->get_parameter(plugin_name_ + ".publish_trajectories", publish_trajectories_);
   node->get_parameter(plugin_name_ + ".publish_cost_grid_pc", publish_cost_grid_pc_);
+  node->get_parameter(plugin_name_ + ".evaluation_period", evaluation_period_);
+  node->get_parameter(
+    plugin_name_ + ".evaluation_max_trajectories", evaluation_max_trajectories_);
 
   eval_pub_ = node->create_publisher<dwb_msgs::msg::LocalPlanEvaluation>("evaluation", 1);
   global_pub_ = node->create_publisher<nav_msgs::msg::Path>("received_global_plan", 1);
@@ -154,18 +164,58 @@ DWBPublisher::on_cleanup()
   return nav2_util::CallbackReturn::SUCCESS;
 }
 
+bool
+DWBPublisher::shouldRecordEvaluation()
+{
+  const bool evaluation_needed =
+    publish_evaluation_ && eval_pub_->get_subscription_count() > 0;
+  const bool trajectories_needed =
+    publish_trajectories_ && marker_pub_->get_subscription_count() > 0;
+  if (!evaluation_needed && !trajectories_needed) {
+    return false;
+  }
+
+  return evaluation_period_ <= 0.0 ||
+         (clock_->now() - last_evaluation_time_).seconds() >= evaluation_period_;
+}
+
 void
 DWBPublisher::publishEvaluation(std::shared_ptr<dwb_msgs::msg::LocalPlanEvaluation> results)
 {
   if (results) {
+    last_evaluation_time_ = clock_->now();
+    if (evaluation_max_trajectories_ > 0) {
+      compactEvaluation(*results);
+    }
+    publishTrajectories(*results);
     if (publish_evaluation_ && eval_pub_->get_subscription_count() > 0) {
-      auto msg = std::make_unique<dwb_msgs::msg::LocalPlanEvaluation>(*results);
+      auto msg = std::make_unique<dwb_msgs::msg::LocalPlanEvaluation>(std::move(*results));
       eval_pub_->publish(std::move(msg));
     }
-    publishTrajectories(*results);
   }
 }
 
+void
+DWBPublisher::compactEvaluation(dwb_msgs::msg::LocalPlanEvaluation & results)
+{
+  auto & twists = results.twists;
+  twists.erase(
+    std::remove_if(
+      twists.begin(), twists.end(), [](const dwb_msgs::msg::TrajectoryScore & twist) {
+        return twist.total < 0;
+      }), twists.end());
+
+  const size_t count = std::min(twists.size(), static_cast<size_t>(evaluation_max_trajectories_));
+  std::partial_sort(
+    twists.begin(), twists.begin() + count, twists.end(),
+    [](const dwb_msgs::msg::TrajectoryScore & a, const dwb_msgs::msg::TrajectoryScore & b) {
+      return a.total < b.total;
+    });
+  twists.resize(count);
+  results.best_index = 0;
+  results.worst_index = count > 0 ? count - 1 : 0;
+}
+
 void
 DWBPublisher::publishTrajectories(const dwb_msgs::msg::LocalPlanEvaluation & results)
 {
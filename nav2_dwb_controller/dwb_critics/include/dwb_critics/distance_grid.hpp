@@ -0,0 +1,108 @@
+/*
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2017, Locus Robotics
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of the copyright holder nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#ifndef DWB_CRITICS__DISTANCE_GRID_HPP_
+#define DWB_CRITICS__DISTANCE_GRID_HPP_
+
+#include <memory>
+#include <vector>
+
+namespace dwb_critics
+{
+/**
+ * @class DistanceGrid
+ * @brief Manhattan distances, in cells, of all the cells of a grid to a set of seed cells
+ *
+ * The distances only depend on the grid size and the seeds, so critics seeding the same
+ * cells in a cycle, such as PathDistCritic and PathAlignCritic, share one grid. Grids are
+ * pooled and those no critic holds anymore are recomputed in place for the next seeds.
+ */
+class DistanceGrid
+{
+public:
+  using Ptr = std::shared_ptr<DistanceGrid>;
+
+  /**
+   * @brief Get a grid of the distances to the given seeds, computing it if no critic holds one
+   * @param size_x Number of cells along x
+   * @param size_y Number of cells along y
+   * @param seeds Indices of the seed cells
+   * @param unreachable_value Value of all the cells when there are no seeds
+   * @return The shared grid, to be treated as read only
+   */
+  static Ptr get(
+    unsigned int size_x, unsigned int size_y,
+    const std::vector<unsigned int> & seeds, double unreachable_value);
+
+  /**
+   * @brief Get the distance of a cell to its closest seed
+   * @param index Index of the cell in the grid
+   */
+  inline double getValue(unsigned int index) const
+  {
+    return values_[index];
+  }
+
+  /**
+   * @brief Set the value of a cell, only on a grid no other critic holds
+   */
+  inline void setValue(unsigned int index, double value)
+  {
+    values_[index] = value;
+  }
+
+protected:
+  /**
+   * @brief Compute the distances with a two pass distance transform
+   */
+  void compute(
+    unsigned int size_x, unsigned int size_y,
+    const std::vector<unsigned int> & seeds, double unreachable_value);
+
+  /**
+   * @brief Whether the grid holds the distances to these seeds
+   */
+  bool matches(
+    unsigned int size_x, unsigned int size_y,
+    const std::vector<unsigned int> & seeds, double unreachable_value) const;
+
+  unsigned int size_x_{0}, size_y_{0};
+  std::vector<unsigned int> seeds_;
+  double unreachable_value_{0.0};
+  std::vector<double> values_;
+};
+}  // namespace dwb_critics
+
+#endif  // DWB_CRITICS__DISTANCE_GRID_HPP_
@@ -41,7 +41,8 @@
 #include <utility>
 
 #include "dwb_core/trajectory_critic.hpp"
-#include "costmap_queue/costmap_queue.hpp"
+#include "dwb_critics/distance_grid.hpp"
+#include "nav2_costmap_2d/costmap_2d.hpp"
 
 namespace dwb_critics
 {
@@ -56,7 +57,8 @@ namespace dwb_critics
  * breadth-first exploration of the cells of the costmap.
  *
  * This approach was chosen for computational efficiency, such that each trajectory
- * need not be compared to the list of source points.
+ * need not be compared to the list of source points. The scores are held in a DistanceGrid,
+ * shared by the critics with the same source points.
  */
 class MapGridCritic : public dwb_core::TrajectoryCritic
 {
@@ -84,11 +86,14 @@ public:
    */
   inline double getScore(unsigned int x, unsigned int y)
   {
-    return cell_values_[costmap_->getIndex(x, y)];
+    return grid_ ? grid_->getValue(costmap_->getIndex(x, y)) : unreachable_score_;
   }
 
   /**
    * @brief Sets the score of a particular cell to the obstacle cost
+   *
+   * Done on a copy of the scores, if they are shared with other critics
+   *
    * @param index Index of the cell to mark
    */
   void setAsObstacle(unsigned int index);
@@ -105,34 +110,18 @@ protected:
   enum class ScoreAggregationType {Last, Sum, Product};
 
   /**
-   * @class MapGridQueue
-   * @brief Subclass of CostmapQueue that avoids Obstacles and Unknown Values
-   */
-  class MapGridQueue : public costmap_queue::CostmapQueue
-  {
-public:
-    MapGridQueue(nav2_costmap_2d::Costmap2D & costmap, MapGridCritic & parent)
-    : costmap_queue::CostmapQueue(costmap, true), parent_(parent) {}
-    virtual ~MapGridQueue() = default;
-    bool validCellToQueue(const costmap_queue::CellData & cell) override;
-
-protected:
-    MapGridCritic & parent_;
-  };
-
-  /**
-   * @brief Clear the queuDWB_CRITICS_MAP_GRID_He and set cell_values_ to the appropriate number of unreachableCellScore
+   * @brief Clear the source cells and the scores, all cells being unreachable until propagated
    */
   void reset() override;
 
   /**
-   * @brief Go through the queue and set the cells to the Manhattan distance from their parents
+   * @brief Set the cells to the Manhattan distance from the closest source cell
    */
   void propogateManhattanDistances();
 
-  std::shared_ptr<MapGridQueue> queue_;
   nav2_costmap_2d::Costmap2D * costmap_;
-  std::vector<double> cell_values_;
+  std::vector<unsigned int> source_cells_;  ///< Indices of the source cells, scored 0
+  DistanceGrid::Ptr grid_;
   double obstacle_score_, unreachable_score_;  ///< Special cell_values
   bool stop_on_failure_;
   ScoreAggregationType aggregationType_;
@@ -31,6 +31,7 @@
  *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
  *  POSSIBILITY OF SUCH DAMAGE.
  */
+#include <algorithm>
 #include <vector>
 #include <string>
 #include <utility>
@@ -39,6 +40,7 @@
 #include "dwb_core/exceptions.hpp"
 #include "pluginlib/class_list_macros.hpp"
 #include "nav2_costmap_2d/cost_values.hpp"
+#include "nav2_costmap_2d/costmap_view.hpp"
 #include "nav2_util/node_utils.hpp"
 
 PLUGINLIB_EXPORT_CLASS(dwb_critics::BaseObstacleCritic, dwb_core::TrajectoryCritic)
@@ -101,15 +103,13 @@ void BaseObstacleCritic::addCriticVisualization(
   std::pair<std::string, std::vector<float>> grid_scores;
   grid_scores.first = name_;
 
-  unsigned int size_x = costmap_->getSizeInCellsX();
-  unsigned int size_y = costmap_->getSizeInCellsY();
+  const nav2_costmap_2d::CostmapView view(*costmap_);
+  unsigned int size_x = view.getSizeInCellsX();
+  unsigned int size_y = view.getSizeInCellsY();
   grid_scores.second.resize(size_x * size_y);
-  unsigned int i = 0;
+  auto it = grid_scores.second.begin();
   for (unsigned int cy = 0; cy < size_y; cy++) {
-    for (unsigned int cx = 0; cx < size_x; cx++) {
-      grid_scores.second[i] = costmap_->getCost(cx, cy);
-      i++;
-    }
+    it = std::copy(view.row(cy), view.row(cy) + size_x, it);
   }
   cost_channels.push_back(grid_scores);
 }
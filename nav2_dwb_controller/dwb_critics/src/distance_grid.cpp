@@ -0,0 +1,133 @@
+/*
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2017, Locus Robotics
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of the copyright holder nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#include "dwb_critics/distance_grid.hpp"
+#include <algorithm>
+#include <limits>
+#include <mutex>
+#include <vector>
+
+namespace dwb_critics
+{
+
+DistanceGrid::Ptr DistanceGrid::get(
+  unsigned int size_x, unsigned int size_y,
+  const std::vector<unsigned int> & seeds, double unreachable_value)
+{
+  static std::mutex mutex;
+  static std::vector<Ptr> pool;
+  std::lock_guard<std::mutex> lock(mutex);
+
+  for (const auto & grid : pool) {
+    if (grid->matches(size_x, size_y, seeds, unreachable_value)) {
+      return grid;
+    }
+  }
+
+  // Grids only the pool holds are free to recompute, those of another size are dropped
+  Ptr free_grid;
+  for (auto it = pool.begin(); it != pool.end(); ) {
+    if (it->use_count() != 1) {
+      ++it;
+    } else if (!free_grid && (*it)->size_x_ == size_x && (*it)->size_y_ == size_y) {
+      free_grid = *it++;
+    } else {
+      it = pool.erase(it);
+    }
+  }
+  if (!free_grid) {
+    free_grid = std::make_shared<DistanceGrid>();
+    pool.push_back(free_grid);
+  }
+  free_grid->compute(size_x, size_y, seeds, unreachable_value);
+  return free_grid;
+}
+
+void DistanceGrid::compute(
+  unsigned int size_x, unsigned int size_y,
+  const std::vector<unsigned int> & seeds, double unreachable_value)
+{
+  size_x_ = size_x;
+  size_y_ = size_y;
+  seeds_ = seeds;
+  unreachable_value_ = unreachable_value;
+  values_.resize(static_cast<size_t>(size_x) * size_y);
+  if (seeds.empty()) {
+    std::fill(values_.begin(), values_.end(), unreachable_value);
+    return;
+  }
+
+  std::fill(values_.begin(), values_.end(), std::numeric_limits<double>::max());
+  for (unsigned int index : seeds) {
+    values_[index] = 0.0;
+  }
+
+  // Nothing obstructs the expansion, so the Manhattan distances come from the
+  // closest neighbor above or left of each cell, then below or right of it
+  for (unsigned int y = 0; y < size_y; y++) {
+    double * row = &values_[static_cast<size_t>(y) * size_x];
+    const double * previous_row = y > 0 ? row - size_x : nullptr;
+    for (unsigned int x = 0; x < size_x; x++) {
+      if (x > 0) {
+        row[x] = std::min(row[x], row[x - 1] + 1.0);
+      }
+      if (previous_row) {
+        row[x] = std::min(row[x], previous_row[x] + 1.0);
+      }
+    }
+  }
+  for (unsigned int y = size_y; y-- > 0; ) {
+    double * row = &values_[static_cast<size_t>(y) * size_x];
+    const double * next_row = y + 1 < size_y ? row + size_x : nullptr;
+    for (unsigned int x = size_x; x-- > 0; ) {
+      if (x + 1 < size_x) {
+        row[x] = std::min(row[x], row[x + 1] + 1.0);
+      }
+      if (next_row) {
+        row[x] = std::min(row[x], next_row[x] + 1.0);
+      }
+    }
+  }
+}
+
+bool DistanceGrid::matches(
+  unsigned int size_x, unsigned int size_y,
+  const std::vector<unsigned int> & seeds, double unreachable_value) const
+{
+  return size_x_ == size_x && size_y_ == size_y &&
+         unreachable_value_ == unreachable_value && seeds_ == seeds;
+}
+
+}  // namespace dwb_critics
@@ -44,21 +44,13 @@
 #include "nav2_util/node_utils.hpp"
 
 using std::abs;
-using costmap_queue::CellData;
 
 namespace dwb_critics
 {
 
-// Customization of the CostmapQueue validCellToQueue method
-bool MapGridCritic::MapGridQueue::validCellToQueue(const costmap_queue::CellData & /*cell*/)
-{
-  return true;
-}
-
 void MapGridCritic::onInit()
 {
   costmap_ = costmap_ros_->getCostmap();
-  queue_ = std::make_shared<MapGridQueue>(*costmap_, *this);
 
   // Always set to true, but can be overriden by subclasses
   stop_on_failure_ = true;
@@ -93,25 +85,27 @@ void MapGridCritic::onInit()
 
 void MapGridCritic::setAsObstacle(unsigned int index)
 {
-  cell_values_[index] = obstacle_score_;
+  if (!grid_) {
+    return;
+  }
+  grid_ = std::make_shared<DistanceGrid>(*grid_);
+  grid_->setValue(index, obstacle_score_);
 }
 
 void MapGridCritic::reset()
 {
-  queue_->reset();
-  cell_values_.resize(costmap_->getSizeInCellsX() * costmap_->getSizeInCellsY());
-  obstacle_score_ = static_cast<double>(cell_values_.size());
+  source_cells_.clear();
+  grid_.reset();
+  obstacle_score_ = static_cast<double>(
+    costmap_->getSizeInCellsX() * costmap_->getSizeInCellsY());
   unreachable_score_ = obstacle_score_ + 1.0;
-  std::fill(cell_values_.begin(), cell_values_.end(), unreachable_score_);
 }
 
 void MapGridCritic::propogateManhattanDistances()
 {
-  while (!queue_->isEmpty()) {
-    costmap_queue::CellData cell = queue_->getNextCell();
-    cell_values_[cell.index_] = CellData::absolute_difference(cell.src_x_, cell.x_) +
-      CellData::absolute_difference(cell.src_y_, cell.y_);
-  }
+  grid_ = DistanceGrid::get(
+    costmap_->getSizeInCellsX(), costmap_->getSizeInCellsY(), source_cells_,
+    unreachable_score_);
 }
 
 double MapGridCritic::scoreTrajectory(const dwb_msgs::msg::Trajectory2D & traj)
@@ -39,6 +39,7 @@
 #include "dwb_core/exceptions.hpp"
 #include "pluginlib/class_list_macros.hpp"
 #include "nav2_costmap_2d/cost_values.hpp"
+#include "nav2_costmap_2d/costmap_view.hpp"
 
 PLUGINLIB_EXPORT_CLASS(dwb_critics::ObstacleFootprintCritic, dwb_core::TrajectoryCritic)
 
@@ -89,6 +90,7 @@ double ObstacleFootprintCritic::scorePose(
   const Footprint & footprint)
 {
   // now we really have to lay down the footprint in the costmap grid
+  const nav2_costmap_2d::CostmapView view(*costmap_);
   unsigned int x0, x1, y0, y1;
   double line_cost = 0.0;
   double footprint_cost = 0.0;
@@ -96,13 +98,13 @@ double ObstacleFootprintCritic::scorePose(
   // we need to rasterize each line in the footprint
   for (unsigned int i = 0; i < footprint.size() - 1; ++i) {
     // get the cell coord of the first point
-    if (!costmap_->worldToMap(footprint[i].x, footprint[i].y, x0, y0)) {
+    if (!view.worldToMap(footprint[i].x, footprint[i].y, x0, y0)) {
       throw dwb_core::
             IllegalTrajectoryException(name_, "Footprint Goes Off Grid.");
     }
 
     // get the cell coord of the second point
-    if (!costmap_->worldToMap(footprint[i + 1].x, footprint[i + 1].y, x1, y1)) {
+    if (!view.worldToMap(footprint[i + 1].x, footprint[i + 1].y, x1, y1)) {
       throw dwb_core::
             IllegalTrajectoryException(name_, "Footprint Goes Off Grid.");
     }
@@ -113,13 +115,13 @@ double ObstacleFootprintCritic::scorePose(
 
   // we also need to connect the first point in the footprint to the last point
   // get the cell coord of the last point
-  if (!costmap_->worldToMap(footprint.back().x, footprint.back().y, x0, y0)) {
+  if (!view.worldToMap(footprint.back().x, footprint.back().y, x0, y0)) {
     throw dwb_core::
           IllegalTrajectoryException(name_, "Footprint Goes Off Grid.");
   }
 
   // get the cell coord of the first point
-  if (!costmap_->worldToMap(footprint.front().x, footprint.front().y, x1, y1)) {
+  if (!view.worldToMap(footprint.front().x, footprint.front().y, x1, y1)) {
     throw dwb_core::
           IllegalTrajectoryException(name_, "Footprint Goes Off Grid.");
   }
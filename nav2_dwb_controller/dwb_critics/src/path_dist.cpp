@@ -68,9 +68,7 @@ bool PathDistCritic::prepare(
         g_x, g_y, map_x,
         map_y) && costmap_->getCost(map_x, map_y) != nav2_costmap_2d::NO_INFORMATION)
     {
-      int index = costmap_->getIndex(map_x, map_y);
-      cell_values_[index] = 0.0;
-      queue_->enqueueCell(map_x, map_y);
+      source_cells_.push_back(costmap_->getIndex(map_x, map_y));
       started_path = true;
     } else if (started_path) {
       break;
@@ -0,0 +1,81 @@
+/*
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2020, Samsung Research America
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of the copyright holder nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <algorithm>
+#include <cstdlib>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "dwb_critics/distance_grid.hpp"
+
+using dwb_critics::DistanceGrid;
+
+TEST(DistanceGrid, ManhattanDistances)
+{
+  const unsigned int size_x = 13, size_y = 7;
+  std::vector<unsigned int> seeds = {0, 2 * size_x + 9, 6 * size_x + 3};
+  DistanceGrid::Ptr grid = DistanceGrid::get(size_x, size_y, seeds, 1000.0);
+
+  for (unsigned int y = 0; y < size_y; y++) {
+    for (unsigned int x = 0; x < size_x; x++) {
+      int expected = size_x + size_y;
+      for (unsigned int seed : seeds) {
+        const int dx = static_cast<int>(x) - static_cast<int>(seed % size_x);
+        const int dy = static_cast<int>(y) - static_cast<int>(seed / size_x);
+        expected = std::min(expected, std::abs(dx) + std::abs(dy));
+      }
+      EXPECT_EQ(grid->getValue(y * size_x + x), expected);
+    }
+  }
+
+  DistanceGrid::Ptr empty = DistanceGrid::get(size_x, size_y, {}, 1000.0);
+  EXPECT_EQ(empty->getValue(0), 1000.0);
+  EXPECT_EQ(empty->getValue(size_x * size_y - 1), 1000.0);
+}
+
+TEST(DistanceGrid, Sharing)
+{
+  std::vector<unsigned int> seeds = {5, 6, 7};
+  DistanceGrid::Ptr grid = DistanceGrid::get(10, 10, seeds, 101.0);
+  EXPECT_EQ(DistanceGrid::get(10, 10, seeds, 101.0), grid);
+  EXPECT_NE(DistanceGrid::get(10, 10, {5, 6}, 101.0), grid);
+
+  // A grid no one holds anymore is recomputed for the next seeds
+  DistanceGrid * released = grid.get();
+  grid.reset();
+  DistanceGrid::Ptr other = DistanceGrid::get(10, 10, {50}, 101.0);
+  EXPECT_EQ(other.get(), released);
+  EXPECT_EQ(other->getValue(50), 0.0);
+  EXPECT_EQ(other->getValue(0), 5.0);
+}
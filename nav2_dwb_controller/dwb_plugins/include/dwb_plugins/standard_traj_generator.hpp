@@ -35,6 +35,9 @@
 #ifndef DWB_PLUGINS__STANDARD_TRAJ_GENERATOR_HPP_
 #define DWB_PLUGINS__STANDARD_TRAJ_GENERATOR_HPP_
 
+#include <array>
+#include <deque>
+#include <map>
 #include <vector>
 #include <memory>
 #include <string>
@@ -68,6 +71,12 @@ public:
     const nav_2d_msgs::msg::Twist2D & start_vel,
     const nav_2d_msgs::msg::Twist2D & cmd_vel) override;
 
+  void generateTrajectories(
+    const geometry_msgs::msg::Pose2D & start_pose,
+    const nav_2d_msgs::msg::Twist2D & start_vel,
+    const std::vector<nav_2d_msgs::msg::Twist2D> & cmd_vels,
+    std::vector<dwb_msgs::msg::Trajectory2D> & trajs) override;
+
   /**
    * @brief Limits the maximum linear speed of the robot.
    * @param speed_limit expressed in absolute value (in m/s)
@@ -88,6 +97,20 @@ protected:
    */
   virtual void initializeIterator(const nav2_util::LifecycleNode::SharedPtr & nh);
 
+  /**
+   * @brief Simulate a cmd_vel into the given trajectory, reusing its storage
+   *
+   * @param start_pose Current robot location
+   * @param start_vel Current robot velocity
+   * @param cmd_vel The desired command velocity
+   * @param traj Output trajectory, its previous poses discarded
+   */
+  void simulateTrajectory(
+    const geometry_msgs::msg::Pose2D & start_pose,
+    const nav_2d_msgs::msg::Twist2D & start_vel,
+    const nav_2d_msgs::msg::Twist2D & cmd_vel,
+    dwb_msgs::msg::Trajectory2D & traj);
+
   /**
    * @brief Calculate the velocity after a set period of time, given the desired velocity and acceleration limits
    *
@@ -127,6 +150,38 @@ protected:
    */
   virtual std::vector<double> getTimeSteps(const nav_2d_msgs::msg::Twist2D & cmd_vel);
 
+  /**
+   * @brief Snap a velocity to its bin of the trajectory library, so that the twists sampled
+   * around it and the trajectories simulated from it are the same for the whole bin
+   *
+   * @param vel Velocity to snap
+   * @return The center of its bin, or the velocity itself if the library is disabled
+   */
+  nav_2d_msgs::msg::Twist2D quantizeVelocity(const nav_2d_msgs::msg::Twist2D & vel) const;
+
+  /**
+   * @brief Trajectories simulated from the origin, in the robot frame, for a start
+   * velocity bin and the twists sampled for it
+   */
+  struct TrajectoryLibrary
+  {
+    std::vector<nav_2d_msgs::msg::Twist2D> cmd_vels;
+    std::array<double, 6> accelerations;
+    std::vector<dwb_msgs::msg::Trajectory2D> trajectories;
+  };
+
+  /**
+   * @brief Get the library of a start velocity, simulating it if it is not cached or
+   * was cached for other twists or acceleration limits
+   *
+   * @param start_vel Current robot velocity, snapped to its bin
+   * @param cmd_vels The desired command velocities
+   * @return Library of robot frame trajectories, one per cmd_vel
+   */
+  const TrajectoryLibrary & getTrajectoryLibrary(
+    const nav_2d_msgs::msg::Twist2D & start_vel,
+    const std::vector<nav_2d_msgs::msg::Twist2D> & cmd_vels);
+
   KinematicsHandler::Ptr kinematics_handler_;
   std::shared_ptr<VelocityIterator> velocity_iterator_;
 
@@ -161,6 +216,15 @@ protected:
    * were not projected out as far as they intended.
    */
   bool include_last_point_;
+
+  /// @brief Number of start velocity bins whose trajectories are kept, 0 to disable the library
+  int trajectory_cache_size_;
+  /// @brief Sizes of the start velocity bins (m/s and rad/s)
+  double trajectory_cache_linear_resolution_;
+  double trajectory_cache_angular_resolution_;
+  /// @brief Libraries by start velocity bin, evicted oldest first
+  std::map<std::array<int64_t, 3>, TrajectoryLibrary> trajectory_libraries_;
+  std::deque<std::array<int64_t, 3>> trajectory_library_order_;
 };
 
 
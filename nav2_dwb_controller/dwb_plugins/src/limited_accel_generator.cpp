@@ -82,7 +82,7 @@ void LimitedAccelGenerator::initialize(
 void LimitedAccelGenerator::startNewIteration(const nav_2d_msgs::msg::Twist2D & current_velocity)
 {
   // Limit our search space to just those within the limited acceleration_time
-  velocity_iterator_->startNewIteration(current_velocity, acceleration_time_);
+  velocity_iterator_->startNewIteration(quantizeVelocity(current_velocity), acceleration_time_);
 }
 
 nav_2d_msgs::msg::Twist2D LimitedAccelGenerator::computeNewVelocity(
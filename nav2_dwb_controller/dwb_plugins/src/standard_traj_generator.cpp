@@ -33,6 +33,8 @@
  */
 
 #include "dwb_plugins/standard_traj_generator.hpp"
+#include <array>
+#include <cmath>
 #include <string>
 #include <vector>
 #include <algorithm>
@@ -74,6 +76,15 @@ void StandardTrajectoryGenerator::initialize(
   nav2_util::declare_parameter_if_not_declared(
     nh,
     plugin_name + ".include_last_point", rclcpp::ParameterValue(true));
+  nav2_util::declare_parameter_if_not_declared(
+    nh,
+    plugin_name + ".trajectory_cache_size", rclcpp::ParameterValue(0));
+  nav2_util::declare_parameter_if_not_declared(
+    nh,
+    plugin_name + ".trajectory_cache_linear_resolution", rclcpp::ParameterValue(0.02));
+  nav2_util::declare_parameter_if_not_declared(
+    nh,
+    plugin_name + ".trajectory_cache_angular_resolution", rclcpp::ParameterValue(0.05));
 
   /*
    * If discretize_by_time, then sim_granularity represents the amount of time that should be between
@@ -89,6 +100,28 @@ void StandardTrajectoryGenerator::initialize(
   nh->get_parameter(plugin_name + ".linear_granularity", linear_granularity_);
   nh->get_parameter(plugin_name + ".angular_granularity", angular_granularity_);
   nh->get_parameter(plugin_name + ".include_last_point", include_last_point_);
+
+  /*
+   * With trajectory_cache_size, the current velocity is snapped to bins of the given
+   * resolutions, so that the twists sampled and the trajectories simulated are the same
+   * for all the cycles of a bin. Those trajectories are simulated once from the origin,
+   * and then only moved to the robot pose.
+   */
+  nh->get_parameter(plugin_name + ".trajectory_cache_size", trajectory_cache_size_);
+  nh->get_parameter(
+    plugin_name + ".trajectory_cache_linear_resolution", trajectory_cache_linear_resolution_);
+  nh->get_parameter(
+    plugin_name + ".trajectory_cache_angular_resolution", trajectory_cache_angular_resolution_);
+  if (trajectory_cache_size_ > 0 &&
+    (trajectory_cache_linear_resolution_ <= 0.0 || trajectory_cache_angular_resolution_ <= 0.0))
+  {
+    RCLCPP_WARN(
+      rclcpp::get_logger("StandardTrajectoryGenerator"),
+      "Trajectory cache resolutions must be positive, disabling the trajectory cache");
+    trajectory_cache_size_ = 0;
+  }
+  trajectory_libraries_.clear();
+  trajectory_library_order_.clear();
 }
 
 void StandardTrajectoryGenerator::initializeIterator(
@@ -101,7 +134,7 @@ void StandardTrajectoryGenerator::initializeIterator(
 void StandardTrajectoryGenerator::startNewIteration(
   const nav_2d_msgs::msg::Twist2D & current_velocity)
 {
-  velocity_iterator_->startNewIteration(current_velocity, sim_time_);
+  velocity_iterator_->startNewIteration(quantizeVelocity(current_velocity), sim_time_);
 }
 
 bool StandardTrajectoryGenerator::hasMoreTwists()
@@ -149,7 +182,105 @@ dwb_msgs::msg::Trajectory2D StandardTrajectoryGenerator::generateTrajectory(
   const nav_2d_msgs::msg::Twist2D & cmd_vel)
 {
   dwb_msgs::msg::Trajectory2D traj;
+  simulateTrajectory(start_pose, start_vel, cmd_vel, traj);
+  return traj;
+}
+
+void StandardTrajectoryGenerator::generateTrajectories(
+  const geometry_msgs::msg::Pose2D & start_pose,
+  const nav_2d_msgs::msg::Twist2D & start_vel,
+  const std::vector<nav_2d_msgs::msg::Twist2D> & cmd_vels,
+  std::vector<dwb_msgs::msg::Trajectory2D> & trajs)
+{
+  trajs.resize(cmd_vels.size());
+  if (trajectory_cache_size_ <= 0) {
+    for (size_t i = 0; i < cmd_vels.size(); i++) {
+      simulateTrajectory(start_pose, start_vel, cmd_vels[i], trajs[i]);
+    }
+    return;
+  }
+
+  // Move the robot frame trajectories of the bin to the start pose
+  const TrajectoryLibrary & library = getTrajectoryLibrary(quantizeVelocity(start_vel), cmd_vels);
+  const double c = cos(start_pose.theta), s = sin(start_pose.theta);
+  for (size_t i = 0; i < cmd_vels.size(); i++) {
+    const dwb_msgs::msg::Trajectory2D & local = library.trajectories[i];
+    dwb_msgs::msg::Trajectory2D & traj = trajs[i];
+    traj.velocity = local.velocity;
+    traj.time_offsets = local.time_offsets;
+    traj.poses.resize(local.poses.size());
+    for (size_t j = 0; j < local.poses.size(); j++) {
+      const geometry_msgs::msg::Pose2D & p = local.poses[j];
+      traj.poses[j].x = start_pose.x + c * p.x - s * p.y;
+      traj.poses[j].y = start_pose.y + s * p.x + c * p.y;
+      traj.poses[j].theta = start_pose.theta + p.theta;
+    }
+  }
+}
+
+nav_2d_msgs::msg::Twist2D StandardTrajectoryGenerator::quantizeVelocity(
+  const nav_2d_msgs::msg::Twist2D & vel) const
+{
+  if (trajectory_cache_size_ <= 0) {
+    return vel;
+  }
+  nav_2d_msgs::msg::Twist2D bin;
+  bin.x = std::round(vel.x / trajectory_cache_linear_resolution_) *
+    trajectory_cache_linear_resolution_;
+  bin.y = std::round(vel.y / trajectory_cache_linear_resolution_) *
+    trajectory_cache_linear_resolution_;
+  bin.theta = std::round(vel.theta / trajectory_cache_angular_resolution_) *
+    trajectory_cache_angular_resolution_;
+  return bin;
+}
+
+const StandardTrajectoryGenerator::TrajectoryLibrary &
+StandardTrajectoryGenerator::getTrajectoryLibrary(
+  const nav_2d_msgs::msg::Twist2D & start_vel,
+  const std::vector<nav_2d_msgs::msg::Twist2D> & cmd_vels)
+{
+  const std::array<int64_t, 3> key = {
+    std::llround(start_vel.x / trajectory_cache_linear_resolution_),
+    std::llround(start_vel.y / trajectory_cache_linear_resolution_),
+    std::llround(start_vel.theta / trajectory_cache_angular_resolution_)};
+  KinematicParameters kinematics = kinematics_handler_->getKinematics();
+  const std::array<double, 6> accelerations = {
+    kinematics.getAccX(), kinematics.getDecelX(), kinematics.getAccY(),
+    kinematics.getDecelY(), kinematics.getAccTheta(), kinematics.getDecelTheta()};
+
+  auto it = trajectory_libraries_.find(key);
+  if (it == trajectory_libraries_.end()) {
+    if (trajectory_libraries_.size() >= static_cast<size_t>(trajectory_cache_size_)) {
+      trajectory_libraries_.erase(trajectory_library_order_.front());
+      trajectory_library_order_.pop_front();
+    }
+    it = trajectory_libraries_.emplace(key, TrajectoryLibrary()).first;
+    trajectory_library_order_.push_back(key);
+  } else if (it->second.cmd_vels == cmd_vels && it->second.accelerations == accelerations) {
+    return it->second;
+  }
+
+  // Twists or limits changed, as with a speed limit, or a new bin
+  TrajectoryLibrary & library = it->second;
+  library.cmd_vels = cmd_vels;
+  library.accelerations = accelerations;
+  library.trajectories.resize(cmd_vels.size());
+  const geometry_msgs::msg::Pose2D origin;
+  for (size_t i = 0; i < cmd_vels.size(); i++) {
+    simulateTrajectory(origin, start_vel, cmd_vels[i], library.trajectories[i]);
+  }
+  return library;
+}
+
+void StandardTrajectoryGenerator::simulateTrajectory(
+  const geometry_msgs::msg::Pose2D & start_pose,
+  const nav_2d_msgs::msg::Twist2D & start_vel,
+  const nav_2d_msgs::msg::Twist2D & cmd_vel,
+  dwb_msgs::msg::Trajectory2D & traj)
+{
   traj.velocity = cmd_vel;
+  traj.poses.clear();
+  traj.time_offsets.clear();
   //  simulate the trajectory
   geometry_msgs::msg::Pose2D pose = start_pose;
   nav_2d_msgs::msg::Twist2D vel = start_vel;
@@ -172,8 +303,6 @@ dwb_msgs::msg::Trajectory2D StandardTrajectoryGenerator::generateTrajectory(
     traj.poses.push_back(pose);
     traj.time_offsets.push_back(rclcpp::Duration::from_seconds(running_time));
   }
-
-  return traj;
 }
 
 /**
@@ -362,6 +362,69 @@ TEST(TrajectoryGenerator, basic_no_last_point)
   matchPose(res.poses[n - 2], 0.255, 0, 0);
 }
 
+TEST(TrajectoryGenerator, batch)
+{
+  auto nh = makeTestNode("batch", {rclcpp::Parameter("dwb.linear_granularity", 0.5)});
+  StandardTrajectoryGenerator gen;
+  gen.initialize(nh, "dwb");
+  std::vector<nav_2d_msgs::msg::Twist2D> twists = gen.getTwists(forward);
+  ASSERT_GT(twists.size(), 1u);
+
+  // Trajectories refilled in place, from longer ones, match the ones generated alone
+  std::vector<dwb_msgs::msg::Trajectory2D> trajs(twists.size());
+  for (auto & traj : trajs) {
+    traj.poses.resize(100);
+    traj.time_offsets.resize(100);
+  }
+  gen.generateTrajectories(origin, forward, twists, trajs);
+  ASSERT_EQ(trajs.size(), twists.size());
+  for (size_t i = 0; i < twists.size(); i++) {
+    dwb_msgs::msg::Trajectory2D res = gen.generateTrajectory(origin, forward, twists[i]);
+    EXPECT_EQ(trajs[i], res);
+  }
+}
+
+TEST(TrajectoryGenerator, batch_cached)
+{
+  auto nh = makeTestNode(
+    "batch_cached", {rclcpp::Parameter("dwb.linear_granularity", 0.5),
+      rclcpp::Parameter("dwb.trajectory_cache_size", 4)});
+  StandardTrajectoryGenerator gen;
+  gen.initialize(nh, "dwb");
+
+  // The twists and trajectories of a velocity are those of its bin, moved to the pose
+  nav_2d_msgs::msg::Twist2D start_vel;
+  start_vel.x = 0.307;
+  start_vel.theta = 0.26;
+  nav_2d_msgs::msg::Twist2D bin_vel;
+  bin_vel.x = 0.3;
+  bin_vel.theta = 0.25;
+  std::vector<nav_2d_msgs::msg::Twist2D> twists = gen.getTwists(start_vel);
+  ASSERT_EQ(twists, gen.getTwists(bin_vel));
+  ASSERT_GT(twists.size(), 1u);
+
+  geometry_msgs::msg::Pose2D pose;
+  pose.x = 1.5;
+  pose.y = -2.0;
+  pose.theta = 0.7;
+  std::vector<dwb_msgs::msg::Trajectory2D> trajs;
+  for (int cycle = 0; cycle < 2; cycle++) {
+    gen.generateTrajectories(pose, start_vel, twists, trajs);
+    ASSERT_EQ(trajs.size(), twists.size());
+    for (size_t i = 0; i < twists.size(); i++) {
+      dwb_msgs::msg::Trajectory2D res = gen.generateTrajectory(pose, bin_vel, twists[i]);
+      EXPECT_EQ(trajs[i].velocity, res.velocity);
+      EXPECT_EQ(trajs[i].time_offsets, res.time_offsets);
+      ASSERT_EQ(trajs[i].poses.size(), res.poses.size());
+      for (size_t j = 0; j < res.poses.size(); j++) {
+        EXPECT_NEAR(trajs[i].poses[j].x, res.poses[j].x, 1e-9);
+        EXPECT_NEAR(trajs[i].poses[j].y, res.poses[j].y, 1e-9);
+        EXPECT_NEAR(trajs[i].poses[j].theta, res.poses[j].theta, 1e-9);
+      }
+    }
+  }
+}
+
 TEST(TrajectoryGenerator, too_slow)
 {
   auto nh = makeTestNode("too_slow", {rclcpp::Parameter("dwb.linear_granularity", 0.5)});
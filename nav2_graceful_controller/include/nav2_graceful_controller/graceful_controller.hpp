@@ -17,12 +17,14 @@
 
 #include <string>
 #include <limits>
+#include <array>
 #include <vector>
 #include <memory>
 #include <algorithm>
 #include <mutex>
 
 #include "nav2_core/controller.hpp"
+#include "nav2_costmap_2d/costmap_queries.hpp"
 #include "nav2_costmap_2d/footprint_collision_checker.hpp"
 #include "rclcpp/rclcpp.hpp"
 #include "pluginlib/class_loader.hpp"
@@ -153,6 +155,32 @@ protected:
    */
   bool inCollision(const double & x, const double & y, const double & theta);
 
+  /**
+   * @brief Get the footprint checker of the latest costmap snapshot if enabled,
+   * its footprint cache shared with the other plugins using this costmap
+   */
+  void updateFootprintCache();
+
+  /**
+   * @struct SimulationInputs
+   * @brief Everything a simulated trajectory depends on, in the robot frame
+   */
+  struct SimulationInputs
+  {
+    // Motion target x, y and yaw
+    std::array<double, 3> target;
+    // Time step, control law constants and speed limits
+    std::array<double, 9> settings;
+    bool backward;
+  };
+
+  /**
+   * @brief Check whether the cached trajectory can be reused for these inputs
+   * @param inputs Inputs of the trajectory to simulate
+   * @return Whether the cached trajectory was simulated with the same inputs
+   */
+  bool isSimulationCached(const SimulationInputs & inputs) const;
+
   std::shared_ptr<tf2_ros::Buffer> tf_buffer_;
   std::string plugin_name_;
   std::shared_ptr<nav2_costmap_2d::Costmap2DROS> costmap_ros_;
@@ -164,6 +192,14 @@ protected:
   double goal_dist_tolerance_;
   bool goal_reached_;
 
+  // Checker with the footprint cached on the costmap snapshot, null if not cached
+  std::shared_ptr<const nav2_costmap_2d::CostmapQueries::Checker> cached_checker_;
+
+  // Last simulated trajectory in the robot frame, reused while its inputs do not change
+  bool simulation_cached_{false};
+  SimulationInputs simulation_inputs_;
+  std::vector<geometry_msgs::msg::PoseStamped> simulated_poses_;
+
   std::shared_ptr<rclcpp_lifecycle::LifecyclePublisher<nav_msgs::msg::Path>> transformed_plan_pub_;
   std::shared_ptr<rclcpp_lifecycle::LifecyclePublisher<nav_msgs::msg::Path>> local_plan_pub_;
   std::shared_ptr<rclcpp_lifecycle::LifecyclePublisher<geometry_msgs::msg::PointStamped>>
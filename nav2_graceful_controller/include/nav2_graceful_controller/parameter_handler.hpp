@@ -50,6 +50,8 @@ struct Parameters
   bool final_rotation;
   double rotation_scaling_factor;
   bool allow_backward;
+  int collision_footprint_headings;
+  double simulation_cache_tolerance;
 };
 
 /**
@@ -264,6 +264,8 @@ bool GracefulController::simulateTrajectory(
   const geometry_msgs::msg::TransformStamped & costmap_transform,
   nav_msgs::msg::Path & trajectory, const bool & backward)
 {
+  updateFootprintCache();
+
   // Check for collision before moving
   if (inCollision(
       robot_pose.pose.position.x, robot_pose.pose.position.y,
@@ -272,44 +274,84 @@ bool GracefulController::simulateTrajectory(
     return false;
   }
 
-  // First pose
-  geometry_msgs::msg::PoseStamped next_pose;
-  next_pose.header.frame_id = costmap_ros_->getBaseFrameID();
-  next_pose.pose.orientation.w = 1.0;
-  trajectory.poses.push_back(next_pose);
-
-  double distance = std::numeric_limits<double>::max();
   double resolution_ = costmap_ros_->getCostmap()->getResolution();
   double dt = (params_->v_linear_max > 0.0) ? resolution_ / params_->v_linear_max : 0.0;
 
-  // Set max iter to avoid infinite loop
-  unsigned int max_iter = 2 * sqrt(
-    motion_target.pose.position.x * motion_target.pose.position.x +
-    motion_target.pose.position.y * motion_target.pose.position.y) / resolution_;
-
-  // Generate path
-  do{
-    // Apply velocities to calculate next pose
-    next_pose.pose = control_law_->calculateNextPose(
-      dt, motion_target.pose, next_pose.pose, backward);
+  // The trajectory only depends on the motion target relative to the robot and on the
+  // control law, so it is simulated again only when they change. The collisions are
+  // always checked, the costmap and the robot pose in it changing every cycle.
+  SimulationInputs inputs;
+  inputs.target = {motion_target.pose.position.x, motion_target.pose.position.y,
+    tf2::getYaw(motion_target.pose.orientation)};
+  inputs.settings = {dt, params_->k_phi, params_->k_delta, params_->beta, params_->lambda,
+    params_->slowdown_radius, params_->v_linear_min, params_->v_linear_max,
+    params_->v_angular_max};
+  inputs.backward = backward;
+  if (!isSimulationCached(inputs)) {
+    simulated_poses_.clear();
+
+    // First pose
+    geometry_msgs::msg::PoseStamped next_pose;
+    next_pose.header.frame_id = costmap_ros_->getBaseFrameID();
+    next_pose.pose.orientation.w = 1.0;
+    simulated_poses_.push_back(next_pose);
+
+    double distance = std::numeric_limits<double>::max();
+
+    // Set max iter to avoid infinite loop
+    unsigned int max_iter = 2 * sqrt(
+      motion_target.pose.position.x * motion_target.pose.position.x +
+      motion_target.pose.position.y * motion_target.pose.position.y) / resolution_;
+
+    // Generate path
+    do{
+      // Apply velocities to calculate next pose
+      next_pose.pose = control_law_->calculateNextPose(
+        dt, motion_target.pose, next_pose.pose, backward);
+      simulated_poses_.push_back(next_pose);
+
+      // Check if we reach the goal
+      distance = nav2_util::geometry_utils::euclidean_distance(motion_target.pose, next_pose.pose);
+    }while(distance > resolution_ && simulated_poses_.size() < max_iter);
+
+    simulation_inputs_ = inputs;
+    simulation_cached_ = true;
+  }
 
-    // Add the pose to the trajectory for visualization
-    trajectory.poses.push_back(next_pose);
+  // Add the poses to the trajectory for visualization, up to the first collision
+  trajectory.poses.push_back(simulated_poses_.front());
+  for (size_t i = 1; i < simulated_poses_.size(); i++) {
+    trajectory.poses.push_back(simulated_poses_[i]);
 
     // Check for collision
     geometry_msgs::msg::PoseStamped global_pose;
-    tf2::doTransform(next_pose, global_pose, costmap_transform);
+    tf2::doTransform(simulated_poses_[i], global_pose, costmap_transform);
     if (inCollision(
         global_pose.pose.position.x, global_pose.pose.position.y,
         tf2::getYaw(global_pose.pose.orientation)))
     {
       return false;
     }
+  }
 
-    // Check if we reach the goal
-    distance = nav2_util::geometry_utils::euclidean_distance(motion_target.pose, next_pose.pose);
-  }while(distance > resolution_ && trajectory.poses.size() < max_iter);
+  return true;
+}
+
+bool GracefulController::isSimulationCached(const SimulationInputs & inputs) const
+{
+  if (!simulation_cached_ || inputs.backward != simulation_inputs_.backward ||
+    inputs.settings != simulation_inputs_.settings)
+  {
+    return false;
+  }
 
+  // Within the tolerance, meters for the position and radians for the yaw
+  const double tolerance = params_->simulation_cache_tolerance;
+  for (size_t i = 0; i < inputs.target.size(); i++) {
+    if (std::abs(inputs.target[i] - simulation_inputs_.target[i]) > tolerance) {
+      return false;
+    }
+  }
   return true;
 }
 
@@ -338,7 +380,9 @@ bool GracefulController::inCollision(const double & x, const double & y, const d
   bool consider_footprint = !costmap_ros_->getUseRadius();
 
   double footprint_cost;
-  if (consider_footprint) {
+  if (consider_footprint && cached_checker_) {
+    footprint_cost = cached_checker_->footprintCostAtPoseCached(x, y, theta);
+  } else if (consider_footprint) {
     footprint_cost = collision_checker_->footprintCostAtPose(
       x, y, theta, costmap_ros_->getRobotFootprint());
   } else {
@@ -357,6 +401,19 @@ bool GracefulController::inCollision(const double & x, const double & y, const d
   return false;
 }
 
+void GracefulController::updateFootprintCache()
+{
+  const int headings = params_->collision_footprint_headings;
+  if (headings <= 0 || costmap_ros_->getUseRadius()) {
+    cached_checker_.reset();
+    return;
+  }
+
+  // Rasterized again by the queries if the footprint or the costmap resolution changed
+  cached_checker_ = costmap_ros_->getCostmapQueries()->getFootprintChecker(
+    costmap_ros_->getRobotFootprint(), static_cast<unsigned int>(headings));
+}
+
 }  // namespace nav2_graceful_controller
 
 // Register this controller as a nav2_core plugin
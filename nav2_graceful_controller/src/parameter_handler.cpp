@@ -63,6 +63,10 @@ ParameterHandler::ParameterHandler(
     node, plugin_name_ + ".rotation_scaling_factor", rclcpp::ParameterValue(0.5));
   declare_parameter_if_not_declared(
     node, plugin_name_ + ".allow_backward", rclcpp::ParameterValue(false));
+  declare_parameter_if_not_declared(
+    node, plugin_name_ + ".collision_footprint_headings", rclcpp::ParameterValue(0));
+  declare_parameter_if_not_declared(
+    node, plugin_name_ + ".simulation_cache_tolerance", rclcpp::ParameterValue(0.0));
 
   node->get_parameter(plugin_name_ + ".transform_tolerance", params_.transform_tolerance);
   node->get_parameter(plugin_name_ + ".motion_target_dist", params_.motion_target_dist);
@@ -91,6 +95,10 @@ ParameterHandler::ParameterHandler(
   node->get_parameter(plugin_name_ + ".final_rotation", params_.final_rotation);
   node->get_parameter(plugin_name_ + ".rotation_scaling_factor", params_.rotation_scaling_factor);
   node->get_parameter(plugin_name_ + ".allow_backward", params_.allow_backward);
+  node->get_parameter(
+    plugin_name_ + ".collision_footprint_headings", params_.collision_footprint_headings);
+  node->get_parameter(
+    plugin_name_ + ".simulation_cache_tolerance", params_.simulation_cache_tolerance);
 
   if (params_.initial_rotation && params_.allow_backward) {
     RCLCPP_WARN(
@@ -140,6 +148,12 @@ ParameterHandler::dynamicParametersCallback(std::vector<rclcpp::Parameter> param
         params_.initial_rotation_min_angle = parameter.as_double();
       } else if (name == plugin_name_ + ".rotation_scaling_factor") {
         params_.rotation_scaling_factor = parameter.as_double();
+      } else if (name == plugin_name_ + ".simulation_cache_tolerance") {
+        params_.simulation_cache_tolerance = parameter.as_double();
+      }
+    } else if (type == ParameterType::PARAMETER_INTEGER) {
+      if (name == plugin_name_ + ".collision_footprint_headings") {
+        params_.collision_footprint_headings = parameter.as_int();
       }
     } else if (type == ParameterType::PARAMETER_BOOL) {
       if (name == plugin_name_ + ".initial_rotation") {
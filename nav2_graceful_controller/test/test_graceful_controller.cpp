@@ -302,7 +302,9 @@ TEST(GracefulControllerTest, dynamicParameters) {
       rclcpp::Parameter("test.initial_rotation_min_angle", 12.0),
       rclcpp::Parameter("test.final_rotation", false),
       rclcpp::Parameter("test.rotation_scaling_factor", 13.0),
-      rclcpp::Parameter("test.allow_backward", true)});
+      rclcpp::Parameter("test.allow_backward", true),
+      rclcpp::Parameter("test.collision_footprint_headings", 36),
+      rclcpp::Parameter("test.simulation_cache_tolerance", 0.01)});
 
   // Spin
   rclcpp::spin_until_future_complete(node->get_node_base_interface(), results);
@@ -323,6 +325,8 @@ TEST(GracefulControllerTest, dynamicParameters) {
   EXPECT_EQ(node->get_parameter("test.final_rotation").as_bool(), false);
   EXPECT_EQ(node->get_parameter("test.rotation_scaling_factor").as_double(), 13.0);
   EXPECT_EQ(node->get_parameter("test.allow_backward").as_bool(), true);
+  EXPECT_EQ(node->get_parameter("test.collision_footprint_headings").as_int(), 36);
+  EXPECT_EQ(node->get_parameter("test.simulation_cache_tolerance").as_double(), 0.01);
 
   // Set initial rotation to true
   results = params->set_parameters_atomically(
@@ -1204,6 +1208,68 @@ TEST(GracefulControllerTest, computeVelocityCommandFinal) {
   EXPECT_LE(cmd_vel.twist.angular.x, 0.5);
 }
 
+TEST(GracefulControllerTest, cachedSimulation) {
+  auto node = std::make_shared<rclcpp_lifecycle::LifecycleNode>("testGraceful");
+  auto tf = std::make_shared<tf2_ros::Buffer>(node->get_clock());
+
+  // Create a costmap of 10x10 meters
+  auto costmap_ros = std::make_shared<nav2_costmap_2d::Costmap2DROS>("test_costmap");
+  auto results = costmap_ros->set_parameters(
+    {rclcpp::Parameter("global_frame", "test_global_frame"),
+      rclcpp::Parameter("robot_base_frame", "test_robot_frame"),
+      rclcpp::Parameter("width", 10),
+      rclcpp::Parameter("height", 10),
+      rclcpp::Parameter("resolution", 0.1),
+      rclcpp::Parameter("origin_x", -5.0),
+      rclcpp::Parameter("origin_y", -5.0)});
+  for (const auto & result : results) {
+    EXPECT_TRUE(result.successful) << result.reason;
+  }
+  costmap_ros->on_configure(rclcpp_lifecycle::State());
+
+  // Create controller
+  auto controller = std::make_shared<GMControllerFixture>();
+  controller->configure(node, "test", tf, costmap_ros);
+  controller->activate();
+
+  geometry_msgs::msg::PoseStamped robot_pose;
+  robot_pose.header.frame_id = "test_global_frame";
+  robot_pose.pose.orientation.w = 1.0;
+
+  geometry_msgs::msg::PoseStamped motion_target;
+  motion_target.header.frame_id = "test_robot_frame";
+  motion_target.pose.position.x = 1.0;
+  motion_target.pose.position.y = 0.5;
+  motion_target.pose.orientation.w = 1.0;
+
+  geometry_msgs::msg::TransformStamped costmap_transform;
+  costmap_transform.transform.rotation.w = 1.0;
+
+  nav_msgs::msg::Path first, second;
+  EXPECT_TRUE(
+    controller->simulateTrajectory(
+      robot_pose, motion_target, costmap_transform, first, false));
+  EXPECT_TRUE(
+    controller->simulateTrajectory(
+      robot_pose, motion_target, costmap_transform, second, false));
+  ASSERT_GT(first.poses.size(), 2u);
+  ASSERT_EQ(first.poses.size(), second.poses.size());
+  for (size_t i = 0; i < first.poses.size(); i++) {
+    EXPECT_EQ(first.poses[i].pose, second.poses[i].pose);
+  }
+
+  // The cached trajectory is still checked against the current costmap
+  const auto & middle = first.poses[first.poses.size() / 2].pose.position;
+  unsigned int mx, my;
+  ASSERT_TRUE(costmap_ros->getCostmap()->worldToMap(middle.x, middle.y, mx, my));
+  costmap_ros->getCostmap()->setCost(mx, my, nav2_costmap_2d::LETHAL_OBSTACLE);
+  nav_msgs::msg::Path blocked;
+  EXPECT_FALSE(
+    controller->simulateTrajectory(
+      robot_pose, motion_target, costmap_transform, blocked, false));
+  EXPECT_LT(blocked.poses.size(), first.poses.size());
+}
+
 int main(int argc, char ** argv)
 {
   testing::InitGoogleTest(&argc, argv);
@@ -16,8 +16,10 @@
 #ifndef NAV2_LIFECYCLE_MANAGER__LIFECYCLE_MANAGER_HPP_
 #define NAV2_LIFECYCLE_MANAGER__LIFECYCLE_MANAGER_HPP_
 
+#include <atomic>
 #include <map>
 #include <memory>
+#include <mutex>
 #include <string>
 #include <thread>
 #include <unordered_map>
@@ -29,6 +31,7 @@
 #include "std_srvs/srv/empty.hpp"
 #include "nav2_msgs/srv/manage_lifecycle_nodes.hpp"
 #include "std_srvs/srv/trigger.hpp"
+#include "std_msgs/msg/empty.hpp"
 #include "bondcpp/bond.hpp"
 #include "diagnostic_updater/diagnostic_updater.hpp"
 
@@ -170,6 +173,16 @@ protected:
    */
   bool createBondConnection(const std::string & node_name);
 
+  /**
+   * @brief Support function for monitoring the DDS liveliness of a node instead of a bond
+   */
+  bool createLivelinessConnection(const std::string & node_name);
+
+  /**
+   * @brief Whether the bond or liveliness connection of a node was lost
+   */
+  bool isConnectionBroken(const std::string & node_name);
+
   // Support function for killing bond connections
   /**
    * @brief Support function for killing bond connections
@@ -202,6 +215,20 @@ protected:
    */
   bool changeStateForAllNodes(std::uint8_t transition, bool hard_change = false);
 
+  /**
+   * @brief Transition the groups of nodes to the new target state, the nodes of a
+   * group concurrently. Groups are transitioned in order for bringup transitions,
+   * and in reverse order otherwise.
+   */
+  bool changeStateForGroups(std::uint8_t transition, bool hard_change = false);
+
+  /**
+   * @brief Sort the nodes in groups from their declared dependencies, each node
+   * being in the group following the last of its dependencies
+   * @return False if a dependency is not managed or dependencies are circular
+   */
+  bool computeTransitionGroups();
+
   // Convenience function to highlight the output on the console
   /**
    * @brief Helper function to highlight the output on the console
@@ -236,6 +263,19 @@ protected:
   // A map of all nodes to check bond connection
   std::map<std::string, std::shared_ptr<bond::Bond>> bond_map_;
 
+  /// @brief Liveliness of a node, asserted by the node on its "liveliness" topic
+  struct LivelinessMonitor
+  {
+    rclcpp::Subscription<std_msgs::msg::Empty>::SharedPtr subscription;
+    std::atomic<int> alive_count{0};
+    std::atomic<bool> formed{false};
+  };
+
+  // Whether the liveliness of the nodes is monitored instead of bonds
+  bool use_liveliness_heartbeat_;
+  // A map of all nodes to check the liveliness of, instead of bond_map_
+  std::map<std::string, std::shared_ptr<LivelinessMonitor>> liveliness_map_;
+
   // A map of all nodes to be controlled
   std::map<std::string, std::shared_ptr<nav2_util::LifecycleServiceClient>> node_map_;
 
@@ -247,6 +287,15 @@ protected:
   // The names of the nodes to be managed, in the order of desired bring-up
   std::vector<std::string> node_names_;
 
+  // Whether nodes are transitioned concurrently, only waiting for their dependencies
+  bool parallel_transitions_;
+  // The managed nodes each node depends on
+  std::map<std::string, std::vector<std::string>> node_dependencies_;
+  // The nodes, in groups transitioned one after the other
+  std::vector<std::vector<std::string>> transition_groups_;
+  // Guards bond_map_ from concurrent transitions
+  std::mutex bond_mutex_;
+
   // Whether to automatically start up the system
   bool autostart_;
   bool attempt_respawn_reconnection_;
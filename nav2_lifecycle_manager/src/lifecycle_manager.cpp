@@ -15,9 +15,13 @@
 
 #include "nav2_lifecycle_manager/lifecycle_manager.hpp"
 
+#include <algorithm>
 #include <chrono>
+#include <future>
 #include <memory>
+#include <set>
 #include <string>
+#include <thread>
 #include <vector>
 
 #include "rclcpp/rclcpp.hpp"
@@ -44,6 +48,8 @@ LifecycleManager::LifecycleManager(const rclcpp::NodeOptions & options)
   declare_parameter("bond_timeout", 4.0);
   declare_parameter("bond_respawn_max_duration", 10.0);
   declare_parameter("attempt_respawn_reconnection", true);
+  declare_parameter("parallel_transitions", false);
+  declare_parameter("use_liveliness_heartbeat", false);
 
   registerRclPreshutdownCallback();
 
@@ -59,6 +65,20 @@ LifecycleManager::LifecycleManager(const rclcpp::NodeOptions & options)
   bond_respawn_max_duration_ = rclcpp::Duration::from_seconds(respawn_timeout_s);
 
   get_parameter("attempt_respawn_reconnection", attempt_respawn_reconnection_);
+  get_parameter("use_liveliness_heartbeat", use_liveliness_heartbeat_);
+
+  get_parameter("parallel_transitions", parallel_transitions_);
+  if (parallel_transitions_) {
+    for (const auto & node_name : node_names_) {
+      node_dependencies_[node_name] = declare_parameter(
+        "dependencies." + node_name, std::vector<std::string>());
+    }
+    if (!computeTransitionGroups()) {
+      RCLCPP_ERROR(
+        get_logger(), "Invalid node dependencies, transitioning nodes one after the other");
+      parallel_transitions_ = false;
+    }
+  }
 
   callback_group_ = create_callback_group(rclcpp::CallbackGroupType::MutuallyExclusive, false);
   manager_srv_ = create_service<ManageLifecycleNodes>(
@@ -213,18 +233,24 @@ LifecycleManager::destroyLifecycleServiceClients()
 bool
 LifecycleManager::createBondConnection(const std::string & node_name)
 {
+  if (use_liveliness_heartbeat_) {
+    return createLivelinessConnection(node_name);
+  }
+
   const double timeout_ns =
     std::chrono::duration_cast<std::chrono::nanoseconds>(bond_timeout_).count();
   const double timeout_s = timeout_ns / 1e9;
 
+  std::unique_lock<std::mutex> lock(bond_mutex_);
   if (bond_map_.find(node_name) == bond_map_.end() && bond_timeout_.count() > 0.0) {
-    bond_map_[node_name] =
-      std::make_shared<bond::Bond>("bond", node_name, shared_from_this());
-    bond_map_[node_name]->setHeartbeatTimeout(timeout_s);
-    bond_map_[node_name]->setHeartbeatPeriod(0.10);
-    bond_map_[node_name]->start();
+    auto bond = std::make_shared<bond::Bond>("bond", node_name, shared_from_this());
+    bond_map_[node_name] = bond;
+    lock.unlock();
+    bond->setHeartbeatTimeout(timeout_s);
+    bond->setHeartbeatPeriod(0.10);
+    bond->start();
     if (
-      !bond_map_[node_name]->waitUntilFormed(
+      !bond->waitUntilFormed(
         rclcpp::Duration(rclcpp::Duration::from_nanoseconds(timeout_ns / 2))))
     {
       RCLCPP_ERROR(
@@ -240,30 +266,108 @@ LifecycleManager::createBondConnection(const std::string & node_name)
   return true;
 }
 
+bool
+LifecycleManager::createLivelinessConnection(const std::string & node_name)
+{
+  const double timeout_s = std::chrono::duration<double>(bond_timeout_).count();
+
+  std::unique_lock<std::mutex> lock(bond_mutex_);
+  if (liveliness_map_.find(node_name) != liveliness_map_.end() || bond_timeout_.count() <= 0) {
+    return true;
+  }
+  auto monitor = std::make_shared<LivelinessMonitor>();
+  liveliness_map_[node_name] = monitor;
+  lock.unlock();
+
+  // The node asserts its liveliness without publishing, the lease of its publisher
+  // being no longer than the bond timeout for them to match
+  rclcpp::SubscriptionOptions options;
+  options.event_callbacks.liveliness_callback =
+    [weak_monitor = std::weak_ptr<LivelinessMonitor>(monitor)](
+    rclcpp::QOSLivelinessChangedInfo & event) {
+      auto monitor = weak_monitor.lock();
+      if (!monitor) {
+        return;
+      }
+      monitor->alive_count = event.alive_count;
+      if (event.alive_count > 0) {
+        monitor->formed = true;
+      }
+    };
+  monitor->subscription = create_subscription<std_msgs::msg::Empty>(
+    node_name + "/liveliness",
+    rclcpp::QoS(1)
+    .liveliness(RMW_QOS_POLICY_LIVELINESS_MANUAL_BY_TOPIC)
+    .liveliness_lease_duration(rclcpp::Duration(bond_timeout_)),
+    [](std_msgs::msg::Empty::ConstSharedPtr) {},
+    options);
+
+  const auto deadline = std::chrono::steady_clock::now() + bond_timeout_ / 2;
+  while (!monitor->formed && std::chrono::steady_clock::now() < deadline) {
+    std::this_thread::sleep_for(10ms);
+  }
+  if (!monitor->formed) {
+    RCLCPP_ERROR(
+      get_logger(),
+      "Server %s was unable to be reached after %0.2fs by liveliness. "
+      "This server may be misconfigured.",
+      node_name.c_str(), timeout_s);
+    return false;
+  }
+  RCLCPP_INFO(get_logger(), "Server %s connected with liveliness.", node_name.c_str());
+  return true;
+}
+
+bool
+LifecycleManager::isConnectionBroken(const std::string & node_name)
+{
+  std::lock_guard<std::mutex> lock(bond_mutex_);
+  auto bond = bond_map_.find(node_name);
+  if (bond != bond_map_.end() && bond->second->isBroken()) {
+    return true;
+  }
+  auto monitor = liveliness_map_.find(node_name);
+  return monitor != liveliness_map_.end() &&
+         monitor->second->formed && monitor->second->alive_count == 0;
+}
+
 bool
 LifecycleManager::changeStateForNode(const std::string & node_name, std::uint8_t transition)
 {
-  message(transition_label_map_[transition] + node_name);
+  message(transition_label_map_.at(transition) + node_name);
+  const auto start_time = std::chrono::steady_clock::now();
 
-  if (!node_map_[node_name]->change_state(transition) ||
-    !(node_map_[node_name]->get_state() == transition_state_map_[transition]))
+  auto & client = node_map_.at(node_name);
+  if (!client->change_state(transition) ||
+    !(client->get_state() == transition_state_map_.at(transition)))
   {
     RCLCPP_ERROR(get_logger(), "Failed to change state for node: %s", node_name.c_str());
     return false;
   }
 
+  bool success = true;
   if (transition == Transition::TRANSITION_ACTIVATE) {
-    return createBondConnection(node_name);
+    success = createBondConnection(node_name);
   } else if (transition == Transition::TRANSITION_DEACTIVATE) {
+    std::lock_guard<std::mutex> lock(bond_mutex_);
     bond_map_.erase(node_name);
+    liveliness_map_.erase(node_name);
   }
 
-  return true;
+  RCLCPP_INFO(
+    get_logger(), "%s%s took %.3f s", transition_label_map_.at(transition).c_str(),
+    node_name.c_str(),
+    std::chrono::duration<double>(std::chrono::steady_clock::now() - start_time).count());
+  return success;
 }
 
 bool
 LifecycleManager::changeStateForAllNodes(std::uint8_t transition, bool hard_change)
 {
+  if (parallel_transitions_) {
+    return changeStateForGroups(transition, hard_change);
+  }
+
   // Hard change will continue even if a node fails
   if (transition == Transition::TRANSITION_CONFIGURE ||
     transition == Transition::TRANSITION_ACTIVATE)
@@ -298,6 +402,100 @@ LifecycleManager::changeStateForAllNodes(std::uint8_t transition, bool hard_chan
   return true;
 }
 
+bool
+LifecycleManager::changeStateForGroups(std::uint8_t transition, bool hard_change)
+{
+  const auto start_time = std::chrono::steady_clock::now();
+  const bool bringup = transition == Transition::TRANSITION_CONFIGURE ||
+    transition == Transition::TRANSITION_ACTIVATE;
+
+  // Hard change will continue even if a node fails
+  bool success = true;
+  for (size_t i = 0; i < transition_groups_.size(); ++i) {
+    const auto & group =
+      transition_groups_[bringup ? i : transition_groups_.size() - 1 - i];
+
+    std::vector<std::future<bool>> transitions;
+    transitions.reserve(group.size());
+    for (const auto & node_name : group) {
+      transitions.push_back(
+        std::async(
+          std::launch::async, [this, node_name, transition]() -> bool {
+            try {
+              return changeStateForNode(node_name, transition);
+            } catch (const std::runtime_error & e) {
+              RCLCPP_ERROR(
+                get_logger(),
+                "Failed to change state for node: %s. Exception: %s.", node_name.c_str(),
+                e.what());
+              return false;
+            }
+          }));
+    }
+
+    // All the transitions started are waited for, even after a failure
+    bool group_success = true;
+    for (auto & node_transition : transitions) {
+      group_success = node_transition.get() && group_success;
+    }
+    success = success && group_success;
+    if (!group_success && !hard_change) {
+      return false;
+    }
+  }
+
+  RCLCPP_INFO(
+    get_logger(), "%sall nodes took %.3f s", transition_label_map_.at(transition).c_str(),
+    std::chrono::duration<double>(std::chrono::steady_clock::now() - start_time).count());
+  return success || hard_change;
+}
+
+bool
+LifecycleManager::computeTransitionGroups()
+{
+  transition_groups_.clear();
+  std::set<std::string> grouped;
+  while (grouped.size() < node_names_.size()) {
+    // Next group: the nodes all the dependencies of which are in previous groups
+    std::vector<std::string> group;
+    for (const auto & node_name : node_names_) {
+      if (grouped.count(node_name)) {
+        continue;
+      }
+      const auto & dependencies = node_dependencies_[node_name];
+      const bool ready = std::all_of(
+        dependencies.begin(), dependencies.end(),
+        [&grouped](const std::string & dependency) {return grouped.count(dependency) > 0;});
+      if (ready) {
+        group.push_back(node_name);
+      }
+    }
+
+    if (group.empty()) {
+      for (const auto & node_name : node_names_) {
+        if (!grouped.count(node_name)) {
+          RCLCPP_ERROR(
+            get_logger(), "Dependencies of %s are circular or not managed", node_name.c_str());
+        }
+      }
+      transition_groups_.clear();
+      return false;
+    }
+
+    grouped.insert(group.begin(), group.end());
+    transition_groups_.push_back(group);
+  }
+
+  for (size_t i = 0; i < transition_groups_.size(); ++i) {
+    std::string names;
+    for (const auto & node_name : transition_groups_[i]) {
+      names += " " + node_name;
+    }
+    RCLCPP_INFO(get_logger(), "Transition group %zu:%s", i, names.c_str());
+  }
+  return true;
+}
+
 void
 LifecycleManager::shutdownAllNodes()
 {
@@ -459,8 +657,10 @@ LifecycleManager::onRclPreshutdown()
    */
   service_thread_.reset();
   node_names_.clear();
+  transition_groups_.clear();
   node_map_.clear();
   bond_map_.clear();
+  liveliness_map_.clear();
 }
 
 void
@@ -476,7 +676,7 @@ LifecycleManager::registerRclPreshutdownCallback()
 void
 LifecycleManager::checkBondConnections()
 {
-  if (!isActive() || !rclcpp::ok() || bond_map_.empty()) {
+  if (!isActive() || !rclcpp::ok() || (bond_map_.empty() && liveliness_map_.empty())) {
     return;
   }
 
@@ -485,7 +685,7 @@ LifecycleManager::checkBondConnections()
       return;
     }
 
-    if (bond_map_[node_name]->isBroken()) {
+    if (isConnectionBroken(node_name)) {
       message(
         std::string(
           "Have not received a heartbeat from " + node_name + "."));
@@ -499,6 +699,7 @@ LifecycleManager::checkBondConnections()
       reset(true);  // hard reset to transition all still active down
       // if a server crashed, it won't get cleared due to failed transition, clear manually
       bond_map_.clear();
+      liveliness_map_.clear();
 
       // Initialize the bond respawn timer to check if server comes back online
       // after a failure, within a maximum timeout period.
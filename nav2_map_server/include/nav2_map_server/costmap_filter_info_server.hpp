@@ -20,6 +20,7 @@
 #include "rclcpp/rclcpp.hpp"
 #include "nav2_util/lifecycle_node.hpp"
 #include "nav2_msgs/msg/costmap_filter_info.hpp"
+#include "nav2_msgs/msg/sparse_filter_mask.hpp"
 
 namespace nav2_map_server
 {
@@ -40,13 +41,14 @@ public:
 
 protected:
   /**
-   * @brief Creates CostmapFilterInfo publisher and forms published message from ROS parameters
+   * @brief Creates CostmapFilterInfo publisher and forms published message from ROS parameters.
+   * Loads and encodes the sparse filter mask when mask_yaml_filename is set
    * @param state Lifecycle Node's state
    * @return Success or Failure
    */
   nav2_util::CallbackReturn on_configure(const rclcpp_lifecycle::State & state) override;
   /**
-   * @brief Publishes a CostmapFilterInfo message
+   * @brief Publishes a CostmapFilterInfo message, and the sparse filter mask if any
    * @param state Lifecycle Node's state
    * @return Success or Failure
    */
@@ -74,6 +76,10 @@ private:
   rclcpp_lifecycle::LifecyclePublisher<nav2_msgs::msg::CostmapFilterInfo>::SharedPtr publisher_;
 
   nav2_msgs::msg::CostmapFilterInfo msg_;
+
+  rclcpp_lifecycle::LifecyclePublisher<nav2_msgs::msg::SparseFilterMask>::SharedPtr
+    sparse_mask_publisher_;
+  std::unique_ptr<nav2_msgs::msg::SparseFilterMask> sparse_mask_;
 };  // CostmapFilterInfoServer
 
 }  // namespace nav2_map_server
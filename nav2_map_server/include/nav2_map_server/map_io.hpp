@@ -65,9 +65,34 @@ void loadMapFromFile(
   const LoadParameters & load_parameters,
   nav_msgs::msg::OccupancyGrid & map);
 
+/**
+ * @brief Image format, and extension, of the native nav2 map files. They hold a header with
+ * the size and origin of the map and its YAML metadata, then the occupancy values of the map
+ * as they are, so that they are loaded without any image decoding
+ */
+constexpr char NATIVE_MAP_FORMAT[] = "nav2map";
+
+/**
+ * @brief Whether a file is a native nav2 map file, from its extension
+ * @param file_name Name of the file
+ * @return true if the file has the native map extension
+ */
+bool isNativeMapFile(const std::string & file_name);
+
+/**
+ * @brief Load a native nav2 map file into an OccupancyGrid
+ * @param file_name Name of the native map file
+ * @param map Output loaded map
+ * @throw std::exception
+ */
+void loadNativeMapFile(
+  const std::string & file_name,
+  nav_msgs::msg::OccupancyGrid & map);
+
 /**
  * @brief Load the map YAML, image from map file and
- * generate an OccupancyGrid
+ * generate an OccupancyGrid. A native map file may be given
+ * instead of the YAML file, as it holds its metadata
  * @param yaml_file Name of input YAML file
  * @param map Output loaded map
  * @return status of map loaded
@@ -88,6 +113,18 @@ struct SaveParameters
   MapMode mode{MapMode::Trinary};
 };
 
+/**
+ * @brief Write OccupancyGrid map to a native nav2 map file
+ * @param map OccupancyGrid map data
+ * @param file_name Name of the native map file
+ * @param metadata YAML metadata of the map, embedded in the file
+ * @throw std::exception
+ */
+void saveNativeMapFile(
+  const nav_msgs::msg::OccupancyGrid & map,
+  const std::string & file_name,
+  const std::string & metadata);
+
 /**
  * @brief Write OccupancyGrid map to file
  * @param map OccupancyGrid map data
@@ -16,12 +16,15 @@
 #ifndef NAV2_MAP_SERVER__MAP_SAVER_HPP_
 #define NAV2_MAP_SERVER__MAP_SAVER_HPP_
 
+#include <atomic>
 #include <string>
 #include <memory>
+#include <thread>
 
 #include "rclcpp/rclcpp.hpp"
 #include "nav2_util/lifecycle_node.hpp"
 #include "nav2_msgs/srv/save_map.hpp"
+#include "nav2_msgs/msg/save_map_result.hpp"
 
 #include "map_io.hpp"
 
@@ -99,6 +102,22 @@ protected:
     const std::shared_ptr<nav2_msgs::srv::SaveMap::Request> request,
     std::shared_ptr<nav2_msgs::srv::SaveMap::Response> response);
 
+  /**
+   * @brief Save a map to a file in a thread, reporting its completion on the
+   * save_map_result topic
+   * @param map Map to save
+   * @param save_parameters Map saving parameters
+   * @return true if the saving started
+   */
+  bool startAsyncSave(
+    const nav_msgs::msg::OccupancyGrid::ConstSharedPtr map,
+    const SaveParameters & save_parameters);
+
+  /**
+   * @brief Wait for the asynchronous saving of a map to finish
+   */
+  void joinAsyncSave();
+
   // The timeout for saving the map in service
   std::shared_ptr<rclcpp::Duration> save_map_timeout_;
   // Default values for map thresholds
@@ -106,11 +125,20 @@ protected:
   double occupied_thresh_default_;
   // param for handling QoS configuration
   bool map_subscribe_transient_local_;
+  // Whether the save_map service returns once the map is received, before it is saved
+  bool save_map_async_;
 
   // The name of the service for saving a map from topic
   const std::string save_map_service_name_{"save_map"};
   // A service to save the map to a file at run time (SaveMap)
   rclcpp::Service<nav2_msgs::srv::SaveMap>::SharedPtr save_map_service_;
+
+  // Thread saving the map in asynchronous mode, and whether it is saving one
+  std::thread save_thread_;
+  std::atomic<bool> saving_{false};
+  // A topic on which the completion of the asynchronous saves is published
+  rclcpp_lifecycle::LifecyclePublisher<nav2_msgs::msg::SaveMapResult>::SharedPtr
+    save_result_pub_;
 };
 
 }  // namespace nav2_map_server
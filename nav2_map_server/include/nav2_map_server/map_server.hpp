@@ -15,15 +15,25 @@
 #ifndef NAV2_MAP_SERVER__MAP_SERVER_HPP_
 #define NAV2_MAP_SERVER__MAP_SERVER_HPP_
 
+#include <atomic>
 #include <string>
 #include <memory>
 #include <functional>
+#include <future>
+#include <list>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <vector>
 
 #include "rclcpp/rclcpp.hpp"
 #include "nav2_util/lifecycle_node.hpp"
 #include "nav_msgs/msg/occupancy_grid.hpp"
 #include "nav_msgs/srv/get_map.hpp"
 #include "nav2_msgs/srv/load_map.hpp"
+#include "nav2_msgs/srv/get_map_tile.hpp"
+#include "nav2_msgs/srv/get_map_region.hpp"
+#include "nav2_map_server/map_io.hpp"
 
 namespace nav2_map_server
 {
@@ -79,10 +89,55 @@ protected:
    */
   nav2_util::CallbackReturn on_shutdown(const rclcpp_lifecycle::State & state) override;
 
+  /**
+   * @brief A map loaded from its YAML file, with the levels of its pyramid
+   */
+  struct LoadedMap
+  {
+    LOAD_MAP_STATUS status{LOAD_MAP_SUCCESS};
+    nav_msgs::msg::OccupancyGrid msg;
+    // Levels of the map pyramid, from half the resolution of msg
+    std::vector<nav_msgs::msg::OccupancyGrid> levels;
+  };
+
+  /**
+   * @brief Load a map and build its pyramid. Called from the preloading thread too
+   * @param yaml_file name of input YAML file
+   * @return The loaded map, whose status tells whether it was loaded
+   */
+  std::shared_ptr<LoadedMap> loadMap(const std::string & yaml_file);
+
+  /**
+   * @brief Get a map from the cache, waiting for it if it is being preloaded, or load it
+   * @param yaml_file name of input YAML file
+   * @return The loaded map, whose status tells whether it was loaded
+   */
+  std::shared_ptr<LoadedMap> getMap(const std::string & yaml_file);
+
+  /**
+   * @brief Add a map to the cache, evicting the least recently used ones beyond its size
+   * @param yaml_file name of input YAML file
+   * @param map The map, loaded or being loaded
+   */
+  void cacheMap(
+    const std::string & yaml_file,
+    std::shared_future<std::shared_ptr<LoadedMap>> map);
+
+  /**
+   * @brief Start loading maps into the cache, one after the other in a thread
+   * @param preload_files names of the input YAML files
+   */
+  void preloadMaps(const std::vector<std::string> & preload_files);
+
+  /**
+   * @brief Stop loading maps into the cache and wait for the thread to finish
+   */
+  void stopPreloading();
+
   /**
    * @brief Load the map YAML, image from map file name and
    * generate output response containing an OccupancyGrid.
-   * Update msg_ class variable.
+   * Update map_ class variable, from the map cache if the map is in it.
    * @param yaml_file name of input YAML file
    * @param response Output response with loaded OccupancyGrid map
    * @return true or false
@@ -92,7 +147,7 @@ protected:
     std::shared_ptr<nav2_msgs::srv::LoadMap::Response> response);
 
   /**
-   * @brief Method correcting msg_ header when it belongs to instantiated object
+   * @brief Method correcting map_ header when it belongs to instantiated object
    */
   void updateMsgHeader();
 
@@ -107,6 +162,41 @@ protected:
     const std::shared_ptr<nav_msgs::srv::GetMap::Request> request,
     std::shared_ptr<nav_msgs::srv::GetMap::Response> response);
 
+  /**
+   * @brief Map tile getting service callback
+   * @param request_header Service request header
+   * @param request Service request
+   * @param response Service response
+   */
+  void getMapTileCallback(
+    const std::shared_ptr<rmw_request_id_t> request_header,
+    const std::shared_ptr<nav2_msgs::srv::GetMapTile::Request> request,
+    std::shared_ptr<nav2_msgs::srv::GetMapTile::Response> response);
+
+  /**
+   * @brief Map region getting service callback
+   * @param request_header Service request header
+   * @param request Service request
+   * @param response Service response
+   */
+  void getMapRegionCallback(
+    const std::shared_ptr<rmw_request_id_t> request_header,
+    const std::shared_ptr<nav2_msgs::srv::GetMapRegion::Request> request,
+    std::shared_ptr<nav2_msgs::srv::GetMapRegion::Response> response);
+
+  /**
+   * @brief Build the lower resolution levels of the pyramid of a map
+   * @param map The map, whose levels are set
+   */
+  void updateMapLevels(LoadedMap & map) const;
+
+  /**
+   * @brief Get a level of the map pyramid
+   * @param level Level of the pyramid, 0 for the map itself
+   * @return Pointer to the map of the level, nullptr if there is no such level
+   */
+  const nav_msgs::msg::OccupancyGrid * getMapLevel(unsigned int level) const;
+
   /**
    * @brief Map loading service callback
    * @param request_header Service request header
@@ -124,23 +214,46 @@ protected:
   // The name of the service for loading a map
   const std::string load_map_service_name_{"load_map"};
 
+  // The names of the services for getting tiles and regions of the map
+  const std::string tile_service_name_{"map_tile"};
+  const std::string region_service_name_{"map_region"};
+
   // A service to provide the occupancy grid (GetMap) and the message to return
   rclcpp::Service<nav_msgs::srv::GetMap>::SharedPtr occ_service_;
 
   // A service to load the occupancy grid from file at run time (LoadMap)
   rclcpp::Service<nav2_msgs::srv::LoadMap>::SharedPtr load_map_service_;
 
+  // Services to provide tiles and regions of the occupancy grid, at any level of its pyramid
+  rclcpp::Service<nav2_msgs::srv::GetMapTile>::SharedPtr tile_service_;
+  rclcpp::Service<nav2_msgs::srv::GetMapRegion>::SharedPtr region_service_;
+
   // A topic on which the occupancy grid will be published
   rclcpp_lifecycle::LifecyclePublisher<nav_msgs::msg::OccupancyGrid>::SharedPtr occ_pub_;
 
   // The frame ID used in the returned OccupancyGrid message
   std::string frame_id_;
 
-  // The message to publish on the occupancy grid topic
-  nav_msgs::msg::OccupancyGrid msg_;
+  // The map whose message is published on the occupancy grid topic
+  std::shared_ptr<LoadedMap> map_;
 
-  // true if msg_ was initialized
+  // true if map_ was initialized
   bool map_available_;
+
+  // Size of the square tiles (cells) and number of levels of the map pyramid below map_
+  int tile_size_;
+  int tile_levels_;
+
+  // Maps kept loaded, or being preloaded, by YAML file, so that switching to them is
+  // immediate, and their YAML files from the most recently used
+  std::unordered_map<std::string, std::shared_future<std::shared_ptr<LoadedMap>>> map_cache_;
+  std::list<std::string> map_cache_order_;
+  size_t map_cache_size_;
+
+  // Thread preloading maps into the cache, and the lock serializing the loading of maps
+  std::thread preload_thread_;
+  std::atomic<bool> stop_preloading_{false};
+  std::mutex load_mutex_;
 };
 
 }  // namespace nav2_map_server
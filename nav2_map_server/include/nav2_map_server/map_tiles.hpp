@@ -0,0 +1,68 @@
+// Copyright (c) 2024 Open Navigation LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+/* OccupancyGrid map tiling library */
+
+#ifndef NAV2_MAP_SERVER__MAP_TILES_HPP_
+#define NAV2_MAP_SERVER__MAP_TILES_HPP_
+
+#include <cstdint>
+
+#include "nav_msgs/msg/occupancy_grid.hpp"
+
+namespace nav2_map_server
+{
+
+/**
+ * @brief Get the next level of a map pyramid, of half the resolution of the map.
+ * Each cell takes the highest occupancy of the known cells it covers, so that
+ * obstacles are kept, and is unknown only if all of them are
+ * @param map The map to downsample
+ * @return The downsampled map
+ */
+nav_msgs::msg::OccupancyGrid downsampleMap(const nav_msgs::msg::OccupancyGrid & map);
+
+/**
+ * @brief Get a window of cells of a map, clipped to the map
+ * @param map The map
+ * @param min_x First column of the window
+ * @param min_y First row of the window
+ * @param max_x Column past the last one of the window
+ * @param max_y Row past the last one of the window
+ * @param window Output window, with its origin at its first cell
+ * @return true if the window has cells in the map
+ */
+bool getMapWindow(
+  const nav_msgs::msg::OccupancyGrid & map,
+  int64_t min_x, int64_t min_y, int64_t max_x, int64_t max_y,
+  nav_msgs::msg::OccupancyGrid & window);
+
+/**
+ * @brief Get the region of a map covering bounds in the frame of the map
+ * @param map The map
+ * @param min_x Lowest x of the region (m)
+ * @param min_y Lowest y of the region (m)
+ * @param max_x Highest x of the region (m)
+ * @param max_y Highest y of the region (m)
+ * @param region Output region, with its origin at its first cell
+ * @return true if the region has cells in the map
+ */
+bool getMapRegion(
+  const nav_msgs::msg::OccupancyGrid & map,
+  double min_x, double min_y, double max_x, double max_y,
+  nav_msgs::msg::OccupancyGrid & region);
+
+}  // namespace nav2_map_server
+
+#endif  // NAV2_MAP_SERVER__MAP_TILES_HPP_
@@ -0,0 +1,44 @@
+// Copyright (c) 2024 Open Navigation LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+/* Sparse filter mask encoding library */
+
+#ifndef NAV2_MAP_SERVER__SPARSE_MASK_HPP_
+#define NAV2_MAP_SERVER__SPARSE_MASK_HPP_
+
+#include "nav_msgs/msg/occupancy_grid.hpp"
+#include "nav2_msgs/msg/sparse_filter_mask.hpp"
+
+namespace nav2_map_server
+{
+
+/**
+ * @brief Encode a filter mask as runs of equal cells along its rows. The most
+ * frequent value of the mask becomes the default value, left out of the runs
+ * @param mask The filter mask to encode
+ * @return The sparse filter mask
+ */
+nav2_msgs::msg::SparseFilterMask encodeSparseMask(const nav_msgs::msg::OccupancyGrid & mask);
+
+/**
+ * @brief Decode a sparse filter mask back to an OccupancyGrid
+ * @param sparse_mask The sparse filter mask to decode
+ * @return The filter mask
+ */
+nav_msgs::msg::OccupancyGrid decodeSparseMask(
+  const nav2_msgs::msg::SparseFilterMask & sparse_mask);
+
+}  // namespace nav2_map_server
+
+#endif  // NAV2_MAP_SERVER__SPARSE_MASK_HPP_
@@ -21,6 +21,9 @@
 #include <memory>
 #include <utility>
 
+#include "nav2_map_server/map_io.hpp"
+#include "nav2_map_server/sparse_mask.hpp"
+
 namespace nav2_map_server
 {
 
@@ -32,6 +35,8 @@ CostmapFilterInfoServer::CostmapFilterInfoServer(const rclcpp::NodeOptions & opt
   declare_parameter("mask_topic", "filter_mask");
   declare_parameter("base", 0.0);
   declare_parameter("multiplier", 1.0);
+  declare_parameter("mask_yaml_filename", "");
+  declare_parameter("mask_frame_id", "map");
 }
 
 CostmapFilterInfoServer::~CostmapFilterInfoServer()
@@ -56,6 +61,28 @@ CostmapFilterInfoServer::on_configure(const rclcpp_lifecycle::State & /*state*/)
   msg_.base = static_cast<float>(get_parameter("base").as_double());
   msg_.multiplier = static_cast<float>(get_parameter("multiplier").as_double());
 
+  // Serve the filter mask as a sparse one, instead of through a separate map_server
+  std::string mask_yaml_filename = get_parameter("mask_yaml_filename").as_string();
+  if (!mask_yaml_filename.empty()) {
+    nav_msgs::msg::OccupancyGrid mask;
+    if (loadMapFromYaml(mask_yaml_filename, mask) != LOAD_MAP_SUCCESS) {
+      RCLCPP_ERROR(
+        get_logger(), "Failed to load filter mask from %s", mask_yaml_filename.c_str());
+      return nav2_util::CallbackReturn::FAILURE;
+    }
+    mask.header.frame_id = get_parameter("mask_frame_id").as_string();
+    mask.header.stamp = now();
+
+    sparse_mask_ = std::make_unique<nav2_msgs::msg::SparseFilterMask>(encodeSparseMask(mask));
+    RCLCPP_INFO(
+      get_logger(), "Encoded %ux%u filter mask from %s in %zu runs",
+      mask.info.width, mask.info.height, mask_yaml_filename.c_str(), sparse_mask_->row.size());
+
+    sparse_mask_publisher_ = this->create_publisher<nav2_msgs::msg::SparseFilterMask>(
+      msg_.filter_mask_topic, rclcpp::QoS(rclcpp::KeepLast(1)).transient_local().reliable());
+    msg_.sparse_mask = true;
+  }
+
   return nav2_util::CallbackReturn::SUCCESS;
 }
 
@@ -67,6 +94,10 @@ CostmapFilterInfoServer::on_activate(const rclcpp_lifecycle::State & /*state*/)
   publisher_->on_activate();
   auto costmap_filter_info = std::make_unique<nav2_msgs::msg::CostmapFilterInfo>(msg_);
   publisher_->publish(std::move(costmap_filter_info));
+  if (sparse_mask_publisher_) {
+    sparse_mask_publisher_->on_activate();
+    sparse_mask_publisher_->publish(*sparse_mask_);
+  }
 
   // create bond connection
   createBond();
@@ -80,6 +111,9 @@ CostmapFilterInfoServer::on_deactivate(const rclcpp_lifecycle::State & /*state*/
   RCLCPP_INFO(get_logger(), "Deactivating");
 
   publisher_->on_deactivate();
+  if (sparse_mask_publisher_) {
+    sparse_mask_publisher_->on_deactivate();
+  }
 
   // destroy bond connection
   destroyBond();
@@ -93,6 +127,8 @@ CostmapFilterInfoServer::on_cleanup(const rclcpp_lifecycle::State & /*state*/)
   RCLCPP_INFO(get_logger(), "Cleaning up");
 
   publisher_.reset();
+  sparse_mask_publisher_.reset();
+  sparse_mask_.reset();
 
   return nav2_util::CallbackReturn::SUCCESS;
 }
@@ -34,8 +34,15 @@
 #ifndef _WIN32
 #include <libgen.h>
 #endif
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <functional>
 #include <iostream>
+#include <limits>
 #include <string>
+#include <thread>
+#include <utility>
 #include <vector>
 #include <fstream>
 #include <stdexcept>
@@ -98,6 +105,30 @@ namespace nav2_map_server
 {
 using nav2_util::geometry_utils::orientationAroundZAxis;
 
+/// Rows of map images processed at once, so that the buffers of large maps stay small
+size_t getBlockRows(size_t width)
+{
+  return std::max<size_t>(1, (size_t{1} << 22) / std::max<size_t>(1, width));
+}
+
+/// Call a function over ranges of rows in parallel, with the first row of each range
+/// and the row past its last one
+void parallelForRows(size_t rows, const std::function<void(size_t, size_t)> & function)
+{
+  if (rows == 0) {
+    return;
+  }
+  const size_t num_threads = std::max(1u, std::thread::hardware_concurrency());
+  const size_t rows_per_thread = (rows + num_threads - 1) / num_threads;
+  std::vector<std::thread> threads;
+  for (size_t first_row = 0; first_row < rows; first_row += rows_per_thread) {
+    threads.emplace_back(function, first_row, std::min(rows, first_row + rows_per_thread));
+  }
+  for (auto & thread : threads) {
+    thread.join();
+  }
+}
+
 // === Map input part ===
 
 /// Get the given subnode value.
@@ -194,10 +225,147 @@ LoadParameters loadMapYaml(const std::string & yaml_filename)
   return load_parameters;
 }
 
+/// Header of the native map files, followed by the YAML metadata then the map data.
+/// The values are in the byte order of the machine which wrote the file, the version
+/// being read back wrong from a file of the other order
+struct NativeMapHeader
+{
+  char magic[8];
+  uint32_t version;
+  uint32_t width;
+  uint32_t height;
+  uint32_t metadata_size;
+  double resolution;
+  // Position then orientation of the origin
+  double origin[7];
+};
+static_assert(sizeof(NativeMapHeader) == 88, "Native map header must not be padded");
+
+constexpr char NATIVE_MAP_MAGIC[8] = {'N', 'A', 'V', '2', 'M', 'A', 'P', '\n'};
+constexpr uint32_t NATIVE_MAP_VERSION = 1;
+
+bool isNativeMapFile(const std::string & file_name)
+{
+  const std::string extension = std::string(".") + NATIVE_MAP_FORMAT;
+  return file_name.size() > extension.size() &&
+         file_name.compare(file_name.size() - extension.size(), extension.size(), extension) == 0;
+}
+
+void loadNativeMapFile(
+  const std::string & file_name,
+  nav_msgs::msg::OccupancyGrid & map)
+{
+  std::cout << "[INFO] [map_io]: Loading native map file: " << file_name << std::endl;
+  std::ifstream file(file_name, std::ios::binary);
+  if (!file) {
+    throw std::runtime_error("Failed to open native map file " + file_name);
+  }
+
+  NativeMapHeader header;
+  file.read(reinterpret_cast<char *>(&header), sizeof(header));
+  if (!file || std::memcmp(header.magic, NATIVE_MAP_MAGIC, sizeof(header.magic)) != 0) {
+    throw std::runtime_error(file_name + " is not a native map file");
+  }
+  if (header.version != NATIVE_MAP_VERSION) {
+    throw std::runtime_error(
+            "Unsupported native map version " + std::to_string(header.version) + " in " +
+            file_name);
+  }
+
+  nav_msgs::msg::OccupancyGrid msg;
+  msg.info.width = header.width;
+  msg.info.height = header.height;
+  msg.info.resolution = header.resolution;
+  msg.info.origin.position.x = header.origin[0];
+  msg.info.origin.position.y = header.origin[1];
+  msg.info.origin.position.z = header.origin[2];
+  msg.info.origin.orientation.x = header.origin[3];
+  msg.info.origin.orientation.y = header.origin[4];
+  msg.info.origin.orientation.z = header.origin[5];
+  msg.info.origin.orientation.w = header.origin[6];
+
+  // The metadata is for the readers of the file, the header has all that is loaded.
+  // The data is read at once into the map, without any decoding
+  file.seekg(header.metadata_size, std::ios::cur);
+  msg.data.resize(static_cast<size_t>(msg.info.width) * msg.info.height);
+  file.read(reinterpret_cast<char *>(msg.data.data()), msg.data.size());
+  if (!file) {
+    throw std::runtime_error("Truncated map data in native map file " + file_name);
+  }
+
+  // Since loadNativeMapFile() does not belong to any node, publishing in a system time.
+  rclcpp::Clock clock(RCL_SYSTEM_TIME);
+  msg.info.map_load_time = clock.now();
+  msg.header.frame_id = "map";
+  msg.header.stamp = clock.now();
+
+  std::cout <<
+    "[DEBUG] [map_io]: Read map " << file_name << ": " << msg.info.width <<
+    " X " << msg.info.height << " map @ " << msg.info.resolution << " m/cell" << std::endl;
+
+  map = std::move(msg);
+}
+
+/**
+ * @brief Get the value of a map cell from the brightness of its pixel
+ * @param shade Brightness of the pixel, on a scale from 0.0 to 1.0
+ * @param load_parameters Parameters of the map, with its mode and thresholds
+ * @return int8_t Value of the map cell
+ * @throw std::runtime_error in case of invalid map mode
+ */
+int8_t shadeToMapCell(double shade, const LoadParameters & load_parameters)
+{
+  // If negate is true, we consider blacker pixels free, and whiter
+  // pixels occupied. Otherwise, it's vice versa.
+  /// on a scale from 0.0 to 1.0, how occupied is the map cell (before thresholding)?
+  double occ = (load_parameters.negate ? shade : 1.0 - shade);
+
+  switch (load_parameters.mode) {
+    case MapMode::Trinary:
+      if (load_parameters.occupied_thresh < occ) {
+        return nav2_util::OCC_GRID_OCCUPIED;
+      } else if (occ < load_parameters.free_thresh) {
+        return nav2_util::OCC_GRID_FREE;
+      }
+      return nav2_util::OCC_GRID_UNKNOWN;
+    case MapMode::Scale:
+      if (load_parameters.occupied_thresh < occ) {
+        return nav2_util::OCC_GRID_OCCUPIED;
+      } else if (occ < load_parameters.free_thresh) {
+        return nav2_util::OCC_GRID_FREE;
+      }
+      return std::rint(
+        (occ - load_parameters.free_thresh) /
+        (load_parameters.occupied_thresh - load_parameters.free_thresh) * 100.0);
+    case MapMode::Raw: {
+        double occ_percent = std::round(shade * 255);
+        if (nav2_util::OCC_GRID_FREE <= occ_percent &&
+          occ_percent <= nav2_util::OCC_GRID_OCCUPIED)
+        {
+          return static_cast<int8_t>(occ_percent);
+        }
+        return nav2_util::OCC_GRID_UNKNOWN;
+      }
+    default:
+      throw std::runtime_error("Invalid map mode");
+  }
+}
+
 void loadMapFromFile(
   const LoadParameters & load_parameters,
   nav_msgs::msg::OccupancyGrid & map)
 {
+  if (isNativeMapFile(load_parameters.image_file_name)) {
+    // Native maps hold occupancy values already, so only the metadata is taken from the YAML
+    loadNativeMapFile(load_parameters.image_file_name, map);
+    map.info.resolution = load_parameters.resolution;
+    map.info.origin.position.x = load_parameters.origin[0];
+    map.info.origin.position.y = load_parameters.origin[1];
+    map.info.origin.position.z = 0.0;
+    map.info.origin.orientation = orientationAroundZAxis(load_parameters.origin[2]);
+    return;
+  }
+
   Magick::InitializeMagick(nullptr);
   nav_msgs::msg::OccupancyGrid msg;
 
@@ -218,70 +386,55 @@ void loadMapFromFile(
   // Allocate space to hold the data
   msg.data.resize(msg.info.width * msg.info.height);
 
-  // Copy pixel data into the map structure
-  for (size_t y = 0; y < msg.info.height; y++) {
-    for (size_t x = 0; x < msg.info.width; x++) {
-      auto pixel = img.pixelColor(x, y);
-
-      std::vector<Magick::Quantum> channels = {pixel.redQuantum(), pixel.greenQuantum(),
-        pixel.blueQuantum()};
-      if (load_parameters.mode == MapMode::Trinary && img.matte()) {
-        // To preserve existing behavior, average in alpha with color channels in Trinary mode.
-        // CAREFUL. alpha is inverted from what you might expect. High = transparent, low = opaque
-        channels.push_back(MaxRGB - pixel.alphaQuantum());
-      }
-      double sum = 0;
-      for (auto c : channels) {
-        sum += c;
-      }
-      /// on a scale from 0.0 to 1.0 how bright is the pixel?
-      double shade = Magick::ColorGray::scaleQuantumToDouble(sum / channels.size());
-
-      // If negate is true, we consider blacker pixels free, and whiter
-      // pixels occupied. Otherwise, it's vice versa.
-      /// on a scale from 0.0 to 1.0, how occupied is the map cell (before thresholding)?
-      double occ = (load_parameters.negate ? shade : 1.0 - shade);
-
-      int8_t map_cell;
-      switch (load_parameters.mode) {
-        case MapMode::Trinary:
-          if (load_parameters.occupied_thresh < occ) {
-            map_cell = nav2_util::OCC_GRID_OCCUPIED;
-          } else if (occ < load_parameters.free_thresh) {
-            map_cell = nav2_util::OCC_GRID_FREE;
-          } else {
-            map_cell = nav2_util::OCC_GRID_UNKNOWN;
-          }
-          break;
-        case MapMode::Scale:
-          if (pixel.alphaQuantum() != OpaqueOpacity) {
-            map_cell = nav2_util::OCC_GRID_UNKNOWN;
-          } else if (load_parameters.occupied_thresh < occ) {
-            map_cell = nav2_util::OCC_GRID_OCCUPIED;
-          } else if (occ < load_parameters.free_thresh) {
-            map_cell = nav2_util::OCC_GRID_FREE;
-          } else {
-            map_cell = std::rint(
-              (occ - load_parameters.free_thresh) /
-              (load_parameters.occupied_thresh - load_parameters.free_thresh) * 100.0);
-          }
-          break;
-        case MapMode::Raw: {
-            double occ_percent = std::round(shade * 255);
-            if (nav2_util::OCC_GRID_FREE <= occ_percent &&
-              occ_percent <= nav2_util::OCC_GRID_OCCUPIED)
-            {
-              map_cell = static_cast<int8_t>(occ_percent);
-            } else {
-              map_cell = nav2_util::OCC_GRID_UNKNOWN;
+  // To preserve existing behavior, average in alpha with color channels in Trinary mode.
+  // Alpha is exported as opacity, high = opaque, low = transparent
+  const bool average_alpha = load_parameters.mode == MapMode::Trinary && img.matte();
+  // In Scale mode, pixels which are not opaque are unknown
+  const bool check_alpha = load_parameters.mode == MapMode::Scale && img.matte();
+  const std::string channel_map = (average_alpha || check_alpha) ? "RGBA" : "RGB";
+  const size_t channels = channel_map.size();
+  const size_t averaged_channels = average_alpha ? 4 : 3;
+  constexpr uint32_t max_value = std::numeric_limits<uint16_t>::max();
+
+  // The value of a cell only depends on the sum of its averaged 16 bits channels,
+  // so it is computed once for each sum
+  std::vector<int8_t> lut(averaged_channels * max_value + 1);
+  for (size_t sum = 0; sum < lut.size(); ++sum) {
+    /// on a scale from 0.0 to 1.0 how bright is the pixel?
+    double shade = static_cast<double>(sum) / averaged_channels / max_value;
+    lut[sum] = shadeToMapCell(shade, load_parameters);
+  }
+
+  // Copy pixel data into the map structure, exporting blocks of rows at once from the
+  // pixel cache and converting the rows of each block in parallel
+  const size_t width = msg.info.width;
+  const size_t height = msg.info.height;
+  const size_t block_rows = getBlockRows(width);
+  std::vector<uint16_t> pixels(std::min(block_rows, height) * width * channels);
+
+  for (size_t block_y = 0; block_y < height; block_y += block_rows) {
+    const size_t rows = std::min(block_rows, height - block_y);
+    img.write(0, block_y, width, rows, channel_map, Magick::ShortPixel, pixels.data());
+
+    parallelForRows(
+      rows, [&](size_t first_row, size_t last_row) {
+        for (size_t row = first_row; row < last_row; ++row) {
+          const uint16_t * pixel = pixels.data() + row * width * channels;
+          const size_t y = block_y + row;
+          int8_t * cell = msg.data.data() + width * (height - y - 1);
+          for (size_t x = 0; x < width; ++x, pixel += channels) {
+            if (check_alpha && pixel[3] != max_value) {
+              cell[x] = nav2_util::OCC_GRID_UNKNOWN;
+              continue;
             }
-            break;
+            uint32_t sum = static_cast<uint32_t>(pixel[0]) + pixel[1] + pixel[2];
+            if (average_alpha) {
+              sum += pixel[3];
+            }
+            cell[x] = lut[sum];
           }
-        default:
-          throw std::runtime_error("Invalid map mode");
-      }
-      msg.data[msg.info.width * (msg.info.height - y - 1) + x] = map_cell;
-    }
+        }
+      });
   }
 
   // Since loadMapFromFile() does not belong to any node, publishing in a system time.
@@ -305,6 +458,17 @@ LOAD_MAP_STATUS loadMapFromYaml(
     std::cerr << "[ERROR] [map_io]: YAML file name is empty, can't load!" << std::endl;
     return MAP_DOES_NOT_EXIST;
   }
+  if (isNativeMapFile(yaml_file)) {
+    try {
+      loadNativeMapFile(expand_user_home_dir_if_needed(yaml_file, get_home_dir()), map);
+    } catch (std::exception & e) {
+      std::cerr <<
+        "[ERROR] [map_io]: Failed to load native map file " << yaml_file <<
+        " for reason: " << e.what() << std::endl;
+      return INVALID_MAP_DATA;
+    }
+    return LOAD_MAP_SUCCESS;
+  }
   std::cout << "[INFO] [map_io]: Loading yaml file: " << yaml_file << std::endl;
   LoadParameters load_parameters;
   try {
@@ -392,6 +556,11 @@ void checkSaveParameters(SaveParameters & save_parameters)
     save_parameters.image_format.begin(),
     [](unsigned char c) {return std::tolower(c);});
 
+  // Native maps are written without GraphicsMagick, whatever their mode
+  if (save_parameters.image_format == NATIVE_MAP_FORMAT) {
+    return;
+  }
+
   const std::vector<std::string> BLESSED_FORMATS{"bmp", "pgm", "png"};
   if (
     std::find(BLESSED_FORMATS.begin(), BLESSED_FORMATS.end(), save_parameters.image_format) ==
@@ -441,6 +610,131 @@ void checkSaveParameters(SaveParameters & save_parameters)
   }
 }
 
+void saveNativeMapFile(
+  const nav_msgs::msg::OccupancyGrid & map,
+  const std::string & file_name,
+  const std::string & metadata)
+{
+  if (map.data.size() != static_cast<size_t>(map.info.width) * map.info.height) {
+    throw std::runtime_error("Map data does not match the size of the map");
+  }
+
+  NativeMapHeader header;
+  std::memcpy(header.magic, NATIVE_MAP_MAGIC, sizeof(header.magic));
+  header.version = NATIVE_MAP_VERSION;
+  header.width = map.info.width;
+  header.height = map.info.height;
+  header.metadata_size = metadata.size();
+  header.resolution = map.info.resolution;
+  header.origin[0] = map.info.origin.position.x;
+  header.origin[1] = map.info.origin.position.y;
+  header.origin[2] = map.info.origin.position.z;
+  header.origin[3] = map.info.origin.orientation.x;
+  header.origin[4] = map.info.origin.orientation.y;
+  header.origin[5] = map.info.origin.orientation.z;
+  header.origin[6] = map.info.origin.orientation.w;
+
+  std::ofstream file(file_name, std::ios::binary);
+  file.write(reinterpret_cast<const char *>(&header), sizeof(header));
+  file.write(metadata.data(), metadata.size());
+  file.write(reinterpret_cast<const char *>(map.data.data()), map.data.size());
+  if (!file) {
+    throw std::runtime_error("Failed to write native map file " + file_name);
+  }
+}
+
+/**
+ * @brief Get the YAML metadata of a map
+ * @param map Occupancy grid data
+ * @param save_parameters Map saving parameters
+ * @param image_name Name of the map data file, relative to the metadata file
+ * @return std::string The YAML metadata
+ */
+std::string getMapMetadata(
+  const nav_msgs::msg::OccupancyGrid & map,
+  const SaveParameters & save_parameters,
+  const std::string & image_name)
+{
+  geometry_msgs::msg::Quaternion orientation = map.info.origin.orientation;
+  tf2::Matrix3x3 mat(tf2::Quaternion(orientation.x, orientation.y, orientation.z, orientation.w));
+  double yaw, pitch, roll;
+  mat.getEulerYPR(yaw, pitch, roll);
+
+  YAML::Emitter e;
+  e << YAML::Precision(3);
+  e << YAML::BeginMap;
+  e << YAML::Key << "image" << YAML::Value << image_name;
+  e << YAML::Key << "mode" << YAML::Value << map_mode_to_string(save_parameters.mode);
+  e << YAML::Key << "resolution" << YAML::Value << map.info.resolution;
+  e << YAML::Key << "origin" << YAML::Flow << YAML::BeginSeq << map.info.origin.position.x <<
+    map.info.origin.position.y << yaw << YAML::EndSeq;
+  e << YAML::Key << "negate" << YAML::Value << 0;
+  e << YAML::Key << "occupied_thresh" << YAML::Value << save_parameters.occupied_thresh;
+  e << YAML::Key << "free_thresh" << YAML::Value << save_parameters.free_thresh;
+
+  if (!e.good()) {
+    std::cout <<
+      "[WARN] [map_io]: YAML writer failed with an error " << e.GetLastError() <<
+      ". The map metadata may be invalid." << std::endl;
+  }
+  return e.c_str();
+}
+
+/**
+ * @brief Get the pixels of map cells, for each value of a cell
+ * @param save_parameters Map saving parameters
+ * @return Pixels indexed by the value of the cell, as an unsigned byte
+ * @throw std::runtime_error in case of invalid map mode
+ */
+std::vector<Magick::PixelPacket> getCellPixels(const SaveParameters & save_parameters)
+{
+  int free_thresh_int = std::rint(save_parameters.free_thresh * 100.0);
+  int occupied_thresh_int = std::rint(save_parameters.occupied_thresh * 100.0);
+
+  std::vector<Magick::PixelPacket> pixels(256);
+  for (int value = 0; value < 256; ++value) {
+    const int8_t map_cell = static_cast<int8_t>(static_cast<uint8_t>(value));
+
+    Magick::Color pixel;
+
+    switch (save_parameters.mode) {
+      case MapMode::Trinary:
+        if (map_cell < 0 || 100 < map_cell) {
+          pixel = Magick::ColorGray(205 / 255.0);
+        } else if (map_cell <= free_thresh_int) {
+          pixel = Magick::ColorGray(254 / 255.0);
+        } else if (occupied_thresh_int <= map_cell) {
+          pixel = Magick::ColorGray(0 / 255.0);
+        } else {
+          pixel = Magick::ColorGray(205 / 255.0);
+        }
+        break;
+      case MapMode::Scale:
+        if (map_cell < 0 || 100 < map_cell) {
+          pixel = Magick::ColorGray{0.5};
+          pixel.alphaQuantum(TransparentOpacity);
+        } else {
+          pixel = Magick::ColorGray{(100.0 - map_cell) / 100.0};
+        }
+        break;
+      case MapMode::Raw:
+        Magick::Quantum q;
+        if (map_cell < 0 || 100 < map_cell) {
+          q = MaxRGB;
+        } else {
+          q = map_cell / 255.0 * MaxRGB;
+        }
+        pixel = Magick::Color(q, q, q);
+        break;
+      default:
+        std::cerr << "[ERROR] [map_io]: Map mode should be Trinary, Scale or Raw" << std::endl;
+        throw std::runtime_error("Invalid map mode");
+    }
+    pixels[value] = pixel;
+  }
+  return pixels;
+}
+
 /**
  * @brief Tries to write map data into a file
  * @param map Occupancy grid data
@@ -456,103 +750,83 @@ void tryWriteMapToFile(
     map.info.resolution << " m/pix" << std::endl;
 
   std::string mapdatafile = save_parameters.map_file_name + "." + save_parameters.image_format;
-  {
-    // should never see this color, so the initialization value is just for debugging
-    Magick::Image image({map.info.width, map.info.height}, "red");
-
-    // In scale mode, we need the alpha (matte) channel. Else, we don't.
-    // NOTE: GraphicsMagick seems to have trouble loading the alpha channel when saved with
-    // Magick::GreyscaleMatte, so we use TrueColorMatte instead.
-    image.type(
-      save_parameters.mode == MapMode::Scale ?
-      Magick::TrueColorMatteType : Magick::GrayscaleType);
-
-    // Since we only need to support 100 different pixel levels, 8 bits is fine
-    image.depth(8);
-
-    int free_thresh_int = std::rint(save_parameters.free_thresh * 100.0);
-    int occupied_thresh_int = std::rint(save_parameters.occupied_thresh * 100.0);
-
-    for (size_t y = 0; y < map.info.height; y++) {
-      for (size_t x = 0; x < map.info.width; x++) {
-        int8_t map_cell = map.data[map.info.width * (map.info.height - y - 1) + x];
-
-        Magick::Color pixel;
-
-        switch (save_parameters.mode) {
-          case MapMode::Trinary:
-            if (map_cell < 0 || 100 < map_cell) {
-              pixel = Magick::ColorGray(205 / 255.0);
-            } else if (map_cell <= free_thresh_int) {
-              pixel = Magick::ColorGray(254 / 255.0);
-            } else if (occupied_thresh_int <= map_cell) {
-              pixel = Magick::ColorGray(0 / 255.0);
-            } else {
-              pixel = Magick::ColorGray(205 / 255.0);
-            }
-            break;
-          case MapMode::Scale:
-            if (map_cell < 0 || 100 < map_cell) {
-              pixel = Magick::ColorGray{0.5};
-              pixel.alphaQuantum(TransparentOpacity);
-            } else {
-              pixel = Magick::ColorGray{(100.0 - map_cell) / 100.0};
+  const int file_name_index = mapdatafile.find_last_of("/\\");
+  const std::string metadata =
+    getMapMetadata(map, save_parameters, mapdatafile.substr(file_name_index + 1));
+
+  if (save_parameters.image_format == NATIVE_MAP_FORMAT) {
+    std::cout << "[INFO] [map_io]: Writing native map to " << mapdatafile << std::endl;
+    saveNativeMapFile(map, mapdatafile, metadata);
+  } else {
+    // The pixel of a cell only depends on its value, so it is computed once for each value
+    const std::vector<Magick::PixelPacket> pixels = getCellPixels(save_parameters);
+    const size_t width = map.info.width;
+    const size_t height = map.info.height;
+
+    if (save_parameters.image_format == "pgm" && save_parameters.mode != MapMode::Scale) {
+      // Grayscale maps are written directly, without GraphicsMagick encoding
+      std::cout << "[INFO] [map_io]: Writing map occupancy data to " << mapdatafile << std::endl;
+      std::vector<uint8_t> data(width * height);
+      parallelForRows(
+        height, [&](size_t first_row, size_t last_row) {
+          for (size_t y = first_row; y < last_row; ++y) {
+            const int8_t * cell = map.data.data() + width * (height - y - 1);
+            uint8_t * gray = data.data() + width * y;
+            for (size_t x = 0; x < width; ++x) {
+              const Magick::Quantum q = pixels[static_cast<uint8_t>(cell[x])].red;
+              gray[x] = (static_cast<uint64_t>(q) * 255 + MaxRGB / 2) / MaxRGB;
             }
-            break;
-          case MapMode::Raw:
-            Magick::Quantum q;
-            if (map_cell < 0 || 100 < map_cell) {
-              q = MaxRGB;
-            } else {
-              q = map_cell / 255.0 * MaxRGB;
+          }
+        });
+
+      std::ofstream file(mapdatafile, std::ios::binary);
+      file << "P5\n" << width << " " << height << "\n255\n";
+      file.write(reinterpret_cast<const char *>(data.data()), data.size());
+      if (!file) {
+        throw std::runtime_error("Failed to write " + mapdatafile);
+      }
+    } else {
+      // should never see this color, so the initialization value is just for debugging
+      Magick::Image image({map.info.width, map.info.height}, "red");
+
+      // In scale mode, we need the alpha (matte) channel. Else, we don't.
+      // NOTE: GraphicsMagick seems to have trouble loading the alpha channel when saved with
+      // Magick::GreyscaleMatte, so we use TrueColorMatte instead.
+      image.type(
+        save_parameters.mode == MapMode::Scale ?
+        Magick::TrueColorMatteType : Magick::GrayscaleType);
+
+      // Since we only need to support 100 different pixel levels, 8 bits is fine
+      image.depth(8);
+
+      // Blocks of rows are set at once in the pixel cache, their rows in parallel
+      image.modifyImage();
+      const size_t block_rows = getBlockRows(width);
+      for (size_t block_y = 0; block_y < height; block_y += block_rows) {
+        const size_t rows = std::min(block_rows, height - block_y);
+        Magick::PixelPacket * block = image.getPixels(0, block_y, width, rows);
+        parallelForRows(
+          rows, [&](size_t first_row, size_t last_row) {
+            for (size_t row = first_row; row < last_row; ++row) {
+              const size_t y = block_y + row;
+              const int8_t * cell = map.data.data() + width * (height - y - 1);
+              Magick::PixelPacket * pixel = block + width * row;
+              for (size_t x = 0; x < width; ++x) {
+                pixel[x] = pixels[static_cast<uint8_t>(cell[x])];
+              }
             }
-            pixel = Magick::Color(q, q, q);
-            break;
-          default:
-            std::cerr << "[ERROR] [map_io]: Map mode should be Trinary, Scale or Raw" << std::endl;
-            throw std::runtime_error("Invalid map mode");
-        }
-        image.pixelColor(x, y, pixel);
+          });
+        image.syncPixels();
       }
-    }
 
-    std::cout << "[INFO] [map_io]: Writing map occupancy data to " << mapdatafile << std::endl;
-    image.write(mapdatafile);
+      std::cout << "[INFO] [map_io]: Writing map occupancy data to " << mapdatafile << std::endl;
+      image.write(mapdatafile);
+    }
   }
 
   std::string mapmetadatafile = save_parameters.map_file_name + ".yaml";
-  {
-    std::ofstream yaml(mapmetadatafile);
-
-    geometry_msgs::msg::Quaternion orientation = map.info.origin.orientation;
-    tf2::Matrix3x3 mat(tf2::Quaternion(orientation.x, orientation.y, orientation.z, orientation.w));
-    double yaw, pitch, roll;
-    mat.getEulerYPR(yaw, pitch, roll);
-
-    const int file_name_index = mapdatafile.find_last_of("/\\");
-    std::string image_name = mapdatafile.substr(file_name_index + 1);
-
-    YAML::Emitter e;
-    e << YAML::Precision(3);
-    e << YAML::BeginMap;
-    e << YAML::Key << "image" << YAML::Value << image_name;
-    e << YAML::Key << "mode" << YAML::Value << map_mode_to_string(save_parameters.mode);
-    e << YAML::Key << "resolution" << YAML::Value << map.info.resolution;
-    e << YAML::Key << "origin" << YAML::Flow << YAML::BeginSeq << map.info.origin.position.x <<
-      map.info.origin.position.y << yaw << YAML::EndSeq;
-    e << YAML::Key << "negate" << YAML::Value << 0;
-    e << YAML::Key << "occupied_thresh" << YAML::Value << save_parameters.occupied_thresh;
-    e << YAML::Key << "free_thresh" << YAML::Value << save_parameters.free_thresh;
-
-    if (!e.good()) {
-      std::cout <<
-        "[WARN] [map_io]: YAML writer failed with an error " << e.GetLastError() <<
-        ". The map metadata may be invalid." << std::endl;
-    }
-
-    std::cout << "[INFO] [map_io]: Writing map metadata to " << mapmetadatafile << std::endl;
-    std::ofstream(mapmetadatafile) << e.c_str();
-  }
+  std::cout << "[INFO] [map_io]: Writing map metadata to " << mapmetadatafile << std::endl;
+  std::ofstream(mapmetadatafile) << metadata;
   std::cout << "[INFO] [map_io]: Map saved" << std::endl;
 }
 
@@ -51,10 +51,12 @@ MapSaver::MapSaver(const rclcpp::NodeOptions & options)
   declare_parameter("free_thresh_default", 0.25);
   declare_parameter("occupied_thresh_default", 0.65);
   declare_parameter("map_subscribe_transient_local", true);
+  declare_parameter("save_map_async", false);
 }
 
 MapSaver::~MapSaver()
 {
+  joinAsyncSave();
 }
 
 nav2_util::CallbackReturn
@@ -70,12 +72,16 @@ MapSaver::on_configure(const rclcpp_lifecycle::State & /*state*/)
   free_thresh_default_ = get_parameter("free_thresh_default").as_double();
   occupied_thresh_default_ = get_parameter("occupied_thresh_default").as_double();
   map_subscribe_transient_local_ = get_parameter("map_subscribe_transient_local").as_bool();
+  save_map_async_ = get_parameter("save_map_async").as_bool();
 
   // Create a service that saves the occupancy grid from map topic to a file
   save_map_service_ = create_service<nav2_msgs::srv::SaveMap>(
     service_prefix + save_map_service_name_,
     std::bind(&MapSaver::saveMapCallback, this, _1, _2, _3));
 
+  save_result_pub_ = create_publisher<nav2_msgs::msg::SaveMapResult>(
+    service_prefix + "save_map_result", rclcpp::QoS(10).reliable());
+
   return nav2_util::CallbackReturn::SUCCESS;
 }
 
@@ -84,6 +90,8 @@ MapSaver::on_activate(const rclcpp_lifecycle::State & /*state*/)
 {
   RCLCPP_INFO(get_logger(), "Activating");
 
+  save_result_pub_->on_activate();
+
   // create bond connection
   createBond();
 
@@ -95,6 +103,8 @@ MapSaver::on_deactivate(const rclcpp_lifecycle::State & /*state*/)
 {
   RCLCPP_INFO(get_logger(), "Deactivating");
 
+  save_result_pub_->on_deactivate();
+
   // destroy bond connection
   destroyBond();
 
@@ -107,6 +117,8 @@ MapSaver::on_cleanup(const rclcpp_lifecycle::State & /*state*/)
   RCLCPP_INFO(get_logger(), "Cleaning up");
 
   save_map_service_.reset();
+  joinAsyncSave();
+  save_result_pub_.reset();
 
   return nav2_util::CallbackReturn::SUCCESS;
 }
@@ -178,11 +190,11 @@ bool MapSaver::saveMapTopicToFile(
       save_parameters_loc.occupied_thresh = occupied_thresh_default_;
     }
 
-    std::promise<nav_msgs::msg::OccupancyGrid::SharedPtr> prom;
-    std::future<nav_msgs::msg::OccupancyGrid::SharedPtr> future_result = prom.get_future();
+    std::promise<nav_msgs::msg::OccupancyGrid::ConstSharedPtr> prom;
+    std::future<nav_msgs::msg::OccupancyGrid::ConstSharedPtr> future_result = prom.get_future();
     // A callback function that receives map message from subscribed topic
     auto mapCallback = [&prom](
-      const nav_msgs::msg::OccupancyGrid::SharedPtr msg) -> void {
+      const nav_msgs::msg::OccupancyGrid::ConstSharedPtr msg) -> void {
         prom.set_value(msg);
       };
 
@@ -216,7 +228,10 @@ bool MapSaver::saveMapTopicToFile(
     // map_sub is no more needed
     map_sub.reset();
     // Map message received. Saving it to file
-    nav_msgs::msg::OccupancyGrid::SharedPtr map_msg = future_result.get();
+    nav_msgs::msg::OccupancyGrid::ConstSharedPtr map_msg = future_result.get();
+    if (save_map_async_) {
+      return startAsyncSave(map_msg, save_parameters_loc);
+    }
     if (saveMapToFile(*map_msg, save_parameters_loc)) {
       RCLCPP_INFO(get_logger(), "Map saved successfully");
       return true;
@@ -232,6 +247,45 @@ bool MapSaver::saveMapTopicToFile(
   return false;
 }
 
+bool MapSaver::startAsyncSave(
+  const nav_msgs::msg::OccupancyGrid::ConstSharedPtr map,
+  const SaveParameters & save_parameters)
+{
+  if (saving_) {
+    RCLCPP_ERROR(get_logger(), "Failed to save the map: a map is being saved already");
+    return false;
+  }
+  joinAsyncSave();
+
+  RCLCPP_INFO(
+    get_logger(), "Map received, saving it to \'%s\' in the background",
+    save_parameters.map_file_name.c_str());
+  saving_ = true;
+  save_thread_ = std::thread(
+    [this, map, save_parameters]() {
+      nav2_msgs::msg::SaveMapResult result;
+      result.map_url = save_parameters.map_file_name;
+      result.result = saveMapToFile(*map, save_parameters);
+      if (result.result) {
+        RCLCPP_INFO(get_logger(), "Map saved successfully");
+      } else {
+        RCLCPP_ERROR(get_logger(), "Failed to save the map");
+      }
+      if (save_result_pub_ && save_result_pub_->is_activated()) {
+        save_result_pub_->publish(result);
+      }
+      saving_ = false;
+    });
+  return true;
+}
+
+void MapSaver::joinAsyncSave()
+{
+  if (save_thread_.joinable()) {
+    save_thread_.join();
+  }
+}
+
 }  // namespace nav2_map_server
 
 #include "rclcpp_components/register_node_macro.hpp"
@@ -46,15 +46,18 @@
 
 #include "nav2_map_server/map_server.hpp"
 
+#include <algorithm>
 #include <string>
 #include <memory>
 #include <fstream>
 #include <stdexcept>
 #include <utility>
+#include <vector>
 
 #include "yaml-cpp/yaml.h"
 #include "lifecycle_msgs/msg/state.hpp"
 #include "nav2_map_server/map_io.hpp"
+#include "nav2_map_server/map_tiles.hpp"
 
 using namespace std::chrono_literals;
 using namespace std::placeholders;
@@ -71,10 +74,15 @@ MapServer::MapServer(const rclcpp::NodeOptions & options)
   declare_parameter("yaml_filename", rclcpp::PARAMETER_STRING);
   declare_parameter("topic_name", "map");
   declare_parameter("frame_id", "map");
+  declare_parameter("tile_size", 256);
+  declare_parameter("tile_levels", 4);
+  declare_parameter("preload_maps", std::vector<std::string>{});
+  declare_parameter("map_cache_size", 0);
 }
 
 MapServer::~MapServer()
 {
+  stopPreloading();
 }
 
 nav2_util::CallbackReturn
@@ -86,6 +94,15 @@ MapServer::on_configure(const rclcpp_lifecycle::State & /*state*/)
   std::string yaml_filename = get_parameter("yaml_filename").as_string();
   std::string topic_name = get_parameter("topic_name").as_string();
   frame_id_ = get_parameter("frame_id").as_string();
+  tile_size_ = get_parameter("tile_size").as_int();
+  tile_levels_ = get_parameter("tile_levels").as_int();
+  if (tile_size_ <= 0) {
+    throw std::runtime_error("tile_size must be positive");
+  }
+  auto preload_maps = get_parameter("preload_maps").as_string_array();
+  // The preloaded maps are kept in the cache, along with the last ones loaded on request
+  map_cache_size_ = std::max<size_t>(
+    std::max<int64_t>(get_parameter("map_cache_size").as_int(), 0), preload_maps.size());
 
   // only try to load map if parameter was set
   if (!yaml_filename.empty()) {
@@ -104,6 +121,9 @@ MapServer::on_configure(const rclcpp_lifecycle::State & /*state*/)
       load_map_service_name_.c_str());
   }
 
+  // Preloaded once the initial map is loaded, so that it is not delayed
+  preloadMaps(preload_maps);
+
   // Make name prefix for services
   const std::string service_prefix = get_name() + std::string("/");
 
@@ -122,6 +142,15 @@ MapServer::on_configure(const rclcpp_lifecycle::State & /*state*/)
     service_prefix + std::string(load_map_service_name_),
     std::bind(&MapServer::loadMapCallback, this, _1, _2, _3));
 
+  // Create services that provide parts of the occupancy grid, for clients which do not
+  // need the whole of a large map
+  tile_service_ = create_service<nav2_msgs::srv::GetMapTile>(
+    service_prefix + std::string(tile_service_name_),
+    std::bind(&MapServer::getMapTileCallback, this, _1, _2, _3));
+  region_service_ = create_service<nav2_msgs::srv::GetMapRegion>(
+    service_prefix + std::string(region_service_name_),
+    std::bind(&MapServer::getMapRegionCallback, this, _1, _2, _3));
+
   return nav2_util::CallbackReturn::SUCCESS;
 }
 
@@ -130,10 +159,11 @@ MapServer::on_activate(const rclcpp_lifecycle::State & /*state*/)
 {
   RCLCPP_INFO(get_logger(), "Activating");
 
-  // Publish the map using the latched topic
+  // Publish the map using the latched topic. Published as a unique_ptr, it is shared
+  // with all the intra-process subscribers taking it as ConstSharedPtr, without a copy each
   occ_pub_->on_activate();
   if (map_available_) {
-    auto occ_grid = std::make_unique<nav_msgs::msg::OccupancyGrid>(msg_);
+    auto occ_grid = std::make_unique<nav_msgs::msg::OccupancyGrid>(map_->msg);
     occ_pub_->publish(std::move(occ_grid));
   }
 
@@ -164,8 +194,13 @@ MapServer::on_cleanup(const rclcpp_lifecycle::State & /*state*/)
   occ_pub_.reset();
   occ_service_.reset();
   load_map_service_.reset();
+  tile_service_.reset();
+  region_service_.reset();
   map_available_ = false;
-  msg_ = nav_msgs::msg::OccupancyGrid();
+  map_.reset();
+  stopPreloading();
+  map_cache_.clear();
+  map_cache_order_.clear();
 
   return nav2_util::CallbackReturn::SUCCESS;
 }
@@ -190,7 +225,55 @@ void MapServer::getMapCallback(
     return;
   }
   RCLCPP_INFO(get_logger(), "Handling GetMap request");
-  response->map = msg_;
+  response->map = map_->msg;
+}
+
+void MapServer::getMapTileCallback(
+  const std::shared_ptr<rmw_request_id_t>/*request_header*/,
+  const std::shared_ptr<nav2_msgs::srv::GetMapTile::Request> request,
+  std::shared_ptr<nav2_msgs::srv::GetMapTile::Response> response)
+{
+  response->success = false;
+  // if not in ACTIVE state, ignore request
+  if (get_current_state().id() != lifecycle_msgs::msg::State::PRIMARY_STATE_ACTIVE) {
+    RCLCPP_WARN(
+      get_logger(),
+      "Received GetMapTile request but not in ACTIVE state, ignoring!");
+    return;
+  }
+  RCLCPP_DEBUG(
+    get_logger(), "Handling GetMapTile request for tile (%u, %u) of level %u",
+    request->x, request->y, request->level);
+  const nav_msgs::msg::OccupancyGrid * map = getMapLevel(request->level);
+  if (!map) {
+    return;
+  }
+  const int64_t min_x = static_cast<int64_t>(request->x) * tile_size_;
+  const int64_t min_y = static_cast<int64_t>(request->y) * tile_size_;
+  response->success = getMapWindow(
+    *map, min_x, min_y, min_x + tile_size_, min_y + tile_size_, response->tile);
+}
+
+void MapServer::getMapRegionCallback(
+  const std::shared_ptr<rmw_request_id_t>/*request_header*/,
+  const std::shared_ptr<nav2_msgs::srv::GetMapRegion::Request> request,
+  std::shared_ptr<nav2_msgs::srv::GetMapRegion::Response> response)
+{
+  response->success = false;
+  // if not in ACTIVE state, ignore request
+  if (get_current_state().id() != lifecycle_msgs::msg::State::PRIMARY_STATE_ACTIVE) {
+    RCLCPP_WARN(
+      get_logger(),
+      "Received GetMapRegion request but not in ACTIVE state, ignoring!");
+    return;
+  }
+  RCLCPP_DEBUG(get_logger(), "Handling GetMapRegion request");
+  const nav_msgs::msg::OccupancyGrid * map = getMapLevel(request->level);
+  if (!map) {
+    return;
+  }
+  response->success = getMapRegion(
+    *map, request->min_x, request->min_y, request->max_x, request->max_y, response->map);
 }
 
 void MapServer::loadMapCallback(
@@ -209,7 +292,7 @@ void MapServer::loadMapCallback(
   RCLCPP_INFO(get_logger(), "Handling LoadMap request");
   // Load from file
   if (loadMapResponseFromYaml(request->map_url, response)) {
-    auto occ_grid = std::make_unique<nav_msgs::msg::OccupancyGrid>(msg_);
+    auto occ_grid = std::make_unique<nav_msgs::msg::OccupancyGrid>(map_->msg);
     occ_pub_->publish(std::move(occ_grid));  // publish new map
   }
 }
@@ -218,7 +301,8 @@ bool MapServer::loadMapResponseFromYaml(
   const std::string & yaml_file,
   std::shared_ptr<nav2_msgs::srv::LoadMap::Response> response)
 {
-  switch (loadMapFromYaml(yaml_file, msg_)) {
+  std::shared_ptr<LoadedMap> map = getMap(yaml_file);
+  switch (map->status) {
     case MAP_DOES_NOT_EXIST:
       response->result = nav2_msgs::srv::LoadMap::Response::RESULT_MAP_DOES_NOT_EXIST;
       return false;
@@ -229,22 +313,149 @@ bool MapServer::loadMapResponseFromYaml(
       response->result = nav2_msgs::srv::LoadMap::Response::RESULT_INVALID_MAP_DATA;
       return false;
     case LOAD_MAP_SUCCESS:
-      // Correcting msg_ header when it belongs to specific node
+      map_ = map;
+      // Correcting map_ header when it belongs to specific node
       updateMsgHeader();
 
       map_available_ = true;
-      response->map = msg_;
+      response->map = map_->msg;
       response->result = nav2_msgs::srv::LoadMap::Response::RESULT_SUCCESS;
   }
 
   return true;
 }
 
+std::shared_ptr<MapServer::LoadedMap> MapServer::loadMap(const std::string & yaml_file)
+{
+  std::lock_guard<std::mutex> lock(load_mutex_);
+  auto map = std::make_shared<LoadedMap>();
+  map->status = loadMapFromYaml(yaml_file, map->msg);
+  if (map->status == LOAD_MAP_SUCCESS) {
+    updateMapLevels(*map);
+  }
+  return map;
+}
+
+std::shared_ptr<MapServer::LoadedMap> MapServer::getMap(const std::string & yaml_file)
+{
+  auto it = map_cache_.find(yaml_file);
+  if (it != map_cache_.end()) {
+    RCLCPP_INFO(get_logger(), "Switching to the cached map %s", yaml_file.c_str());
+    map_cache_order_.remove(yaml_file);
+    map_cache_order_.push_front(yaml_file);
+    std::shared_ptr<LoadedMap> map = it->second.get();
+    if (map->status != LOAD_MAP_SUCCESS) {
+      map_cache_order_.remove(yaml_file);
+      map_cache_.erase(yaml_file);
+    }
+    return map;
+  }
+
+  std::shared_ptr<LoadedMap> map = loadMap(yaml_file);
+  if (map->status == LOAD_MAP_SUCCESS && map_cache_size_ > 0) {
+    std::promise<std::shared_ptr<LoadedMap>> loaded;
+    loaded.set_value(map);
+    cacheMap(yaml_file, loaded.get_future().share());
+  }
+  return map;
+}
+
+void MapServer::cacheMap(
+  const std::string & yaml_file,
+  std::shared_future<std::shared_ptr<LoadedMap>> map)
+{
+  map_cache_[yaml_file] = std::move(map);
+  map_cache_order_.remove(yaml_file);
+  map_cache_order_.push_front(yaml_file);
+  while (map_cache_order_.size() > map_cache_size_) {
+    map_cache_.erase(map_cache_order_.back());
+    map_cache_order_.pop_back();
+  }
+}
+
+void MapServer::preloadMaps(const std::vector<std::string> & preload_files)
+{
+  // The initial map may be one of them, and loaded already
+  std::vector<std::string> yaml_files;
+  for (const auto & yaml_file : preload_files) {
+    if (map_cache_.find(yaml_file) == map_cache_.end()) {
+      yaml_files.push_back(yaml_file);
+    }
+  }
+  if (yaml_files.empty()) {
+    return;
+  }
+
+  // The cache is only accessed from the node's callbacks: the thread only fulfills the
+  // promises of the maps, the services waiting for those they need
+  auto promises = std::make_shared<std::vector<std::promise<std::shared_ptr<LoadedMap>>>>(
+    yaml_files.size());
+  for (size_t i = 0; i < yaml_files.size(); ++i) {
+    cacheMap(yaml_files[i], (*promises)[i].get_future().share());
+  }
+
+  RCLCPP_INFO(get_logger(), "Preloading %zu maps", yaml_files.size());
+  stop_preloading_ = false;
+  preload_thread_ = std::thread(
+    [this, yaml_files, promises]() {
+      for (size_t i = 0; i < yaml_files.size(); ++i) {
+        if (stop_preloading_) {
+          auto map = std::make_shared<LoadedMap>();
+          map->status = MAP_DOES_NOT_EXIST;
+          (*promises)[i].set_value(map);
+          continue;
+        }
+        auto map = loadMap(yaml_files[i]);
+        if (map->status != LOAD_MAP_SUCCESS) {
+          RCLCPP_ERROR(get_logger(), "Failed to preload map %s", yaml_files[i].c_str());
+        }
+        (*promises)[i].set_value(map);
+      }
+    });
+}
+
+void MapServer::stopPreloading()
+{
+  stop_preloading_ = true;
+  if (preload_thread_.joinable()) {
+    preload_thread_.join();
+  }
+}
+
 void MapServer::updateMsgHeader()
 {
-  msg_.info.map_load_time = now();
-  msg_.header.frame_id = frame_id_;
-  msg_.header.stamp = now();
+  map_->msg.info.map_load_time = now();
+  map_->msg.header.frame_id = frame_id_;
+  map_->msg.header.stamp = now();
+  for (auto & level : map_->levels) {
+    level.header = map_->msg.header;
+    level.info.map_load_time = map_->msg.info.map_load_time;
+  }
+}
+
+void MapServer::updateMapLevels(LoadedMap & map) const
+{
+  map.levels.clear();
+  map.levels.reserve(std::max(tile_levels_, 0));
+  const nav_msgs::msg::OccupancyGrid * level_map = &map.msg;
+  for (int level = 0;
+    level < tile_levels_ && (level_map->info.width > 1 || level_map->info.height > 1);
+    ++level)
+  {
+    map.levels.push_back(downsampleMap(*level_map));
+    level_map = &map.levels.back();
+  }
+}
+
+const nav_msgs::msg::OccupancyGrid * MapServer::getMapLevel(unsigned int level) const
+{
+  if (!map_available_) {
+    return nullptr;
+  }
+  if (level == 0) {
+    return &map_->msg;
+  }
+  return level <= map_->levels.size() ? &map_->levels[level - 1] : nullptr;
 }
 
 }  // namespace nav2_map_server
@@ -0,0 +1,141 @@
+// Copyright (c) 2024 Open Navigation LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "nav2_map_server/map_tiles.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+#include "tf2/LinearMath/Matrix3x3.h"
+#include "tf2/LinearMath/Quaternion.h"
+#include "nav2_util/occ_grid_values.hpp"
+
+namespace nav2_map_server
+{
+
+/**
+ * @brief Get the yaw of the origin of a map
+ * @param map The map
+ * @return double Yaw of the grid of the map in its frame (rad)
+ */
+double getMapYaw(const nav_msgs::msg::OccupancyGrid & map)
+{
+  const auto & orientation = map.info.origin.orientation;
+  tf2::Matrix3x3 mat(tf2::Quaternion(orientation.x, orientation.y, orientation.z, orientation.w));
+  double yaw, pitch, roll;
+  mat.getEulerYPR(yaw, pitch, roll);
+  return yaw;
+}
+
+nav_msgs::msg::OccupancyGrid downsampleMap(const nav_msgs::msg::OccupancyGrid & map)
+{
+  nav_msgs::msg::OccupancyGrid level;
+  level.header = map.header;
+  level.info = map.info;
+  level.info.resolution = map.info.resolution * 2.0;
+  level.info.width = (map.info.width + 1) / 2;
+  level.info.height = (map.info.height + 1) / 2;
+  level.data.assign(
+    static_cast<size_t>(level.info.width) * level.info.height, nav2_util::OCC_GRID_UNKNOWN);
+
+  for (size_t y = 0; y < map.info.height; ++y) {
+    const int8_t * row = map.data.data() + y * map.info.width;
+    int8_t * level_row = level.data.data() + (y / 2) * level.info.width;
+    for (size_t x = 0; x < map.info.width; ++x) {
+      // Unknown cells are below any known occupancy
+      level_row[x / 2] = std::max(level_row[x / 2], row[x]);
+    }
+  }
+  return level;
+}
+
+bool getMapWindow(
+  const nav_msgs::msg::OccupancyGrid & map,
+  int64_t min_x, int64_t min_y, int64_t max_x, int64_t max_y,
+  nav_msgs::msg::OccupancyGrid & window)
+{
+  min_x = std::max<int64_t>(min_x, 0);
+  min_y = std::max<int64_t>(min_y, 0);
+  max_x = std::min<int64_t>(max_x, map.info.width);
+  max_y = std::min<int64_t>(max_y, map.info.height);
+  if (min_x >= max_x || min_y >= max_y) {
+    return false;
+  }
+
+  window.header = map.header;
+  window.info = map.info;
+  window.info.width = max_x - min_x;
+  window.info.height = max_y - min_y;
+
+  const double yaw = getMapYaw(map);
+  const double dx = min_x * map.info.resolution;
+  const double dy = min_y * map.info.resolution;
+  window.info.origin.position.x += dx * std::cos(yaw) - dy * std::sin(yaw);
+  window.info.origin.position.y += dx * std::sin(yaw) + dy * std::cos(yaw);
+
+  window.data.resize(static_cast<size_t>(window.info.width) * window.info.height);
+  for (int64_t y = min_y; y < max_y; ++y) {
+    const auto row = map.data.begin() + y * map.info.width;
+    std::copy(
+      row + min_x, row + max_x,
+      window.data.begin() + (y - min_y) * window.info.width);
+  }
+  return true;
+}
+
+bool getMapRegion(
+  const nav_msgs::msg::OccupancyGrid & map,
+  double min_x, double min_y, double max_x, double max_y,
+  nav_msgs::msg::OccupancyGrid & region)
+{
+  if (map.info.resolution <= 0.0 || min_x > max_x || min_y > max_y) {
+    return false;
+  }
+
+  // Bounds of the region in the grid of the map, which may be rotated
+  const double yaw = getMapYaw(map);
+  const double cos_yaw = std::cos(yaw);
+  const double sin_yaw = std::sin(yaw);
+  double grid_min_x = std::numeric_limits<double>::max();
+  double grid_min_y = std::numeric_limits<double>::max();
+  double grid_max_x = std::numeric_limits<double>::lowest();
+  double grid_max_y = std::numeric_limits<double>::lowest();
+  for (const double x : {min_x, max_x}) {
+    for (const double y : {min_y, max_y}) {
+      const double dx = x - map.info.origin.position.x;
+      const double dy = y - map.info.origin.position.y;
+      const double grid_x = (dx * cos_yaw + dy * sin_yaw) / map.info.resolution;
+      const double grid_y = (-dx * sin_yaw + dy * cos_yaw) / map.info.resolution;
+      grid_min_x = std::min(grid_min_x, grid_x);
+      grid_min_y = std::min(grid_min_y, grid_y);
+      grid_max_x = std::max(grid_max_x, grid_x);
+      grid_max_y = std::max(grid_max_y, grid_y);
+    }
+  }
+
+  // Clamped before the conversion, as the bounds may be far from the map
+  auto to_cell = [](double value, int64_t size) {
+      return static_cast<int64_t>(std::clamp(value, -1.0, static_cast<double>(size) + 1.0));
+    };
+  return getMapWindow(
+    map,
+    to_cell(std::floor(grid_min_x), map.info.width),
+    to_cell(std::floor(grid_min_y), map.info.height),
+    to_cell(std::ceil(grid_max_x), map.info.width),
+    to_cell(std::ceil(grid_max_y), map.info.height),
+    region);
+}
+
+}  // namespace nav2_map_server
@@ -0,0 +1,79 @@
+// Copyright (c) 2024 Open Navigation LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "nav2_map_server/sparse_mask.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+
+namespace nav2_map_server
+{
+
+nav2_msgs::msg::SparseFilterMask encodeSparseMask(const nav_msgs::msg::OccupancyGrid & mask)
+{
+  nav2_msgs::msg::SparseFilterMask sparse_mask;
+  sparse_mask.header = mask.header;
+  sparse_mask.info = mask.info;
+
+  // The most frequent value costs no run
+  std::array<size_t, 256> counts{};
+  for (const int8_t value : mask.data) {
+    counts[static_cast<uint8_t>(value)]++;
+  }
+  sparse_mask.default_value = static_cast<int8_t>(
+    std::max_element(counts.begin(), counts.end()) - counts.begin());
+
+  const uint32_t width = mask.info.width;
+  const uint32_t height = mask.info.height;
+  for (uint32_t y = 0; y < height; y++) {
+    const int8_t * row = mask.data.data() + static_cast<size_t>(y) * width;
+    uint32_t x = 0;
+    while (x < width) {
+      const int8_t value = row[x];
+      uint32_t run_end = x + 1;
+      while (run_end < width && row[run_end] == value) {
+        run_end++;
+      }
+      if (value != sparse_mask.default_value) {
+        sparse_mask.row.push_back(y);
+        sparse_mask.start.push_back(x);
+        sparse_mask.length.push_back(run_end - x);
+        sparse_mask.value.push_back(value);
+      }
+      x = run_end;
+    }
+  }
+
+  return sparse_mask;
+}
+
+nav_msgs::msg::OccupancyGrid decodeSparseMask(
+  const nav2_msgs::msg::SparseFilterMask & sparse_mask)
+{
+  nav_msgs::msg::OccupancyGrid mask;
+  mask.header = sparse_mask.header;
+  mask.info = sparse_mask.info;
+
+  const size_t width = mask.info.width;
+  mask.data.assign(width * mask.info.height, sparse_mask.default_value);
+  for (size_t r = 0; r < sparse_mask.row.size(); r++) {
+    auto first = mask.data.begin() + sparse_mask.row[r] * width + sparse_mask.start[r];
+    std::fill(first, first + sparse_mask.length[r], sparse_mask.value[r]);
+  }
+
+  return mask;
+}
+
+}  // namespace nav2_map_server
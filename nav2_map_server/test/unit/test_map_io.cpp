@@ -232,6 +232,47 @@ TEST_F(MapIOTester, loadSaveMapModes)
   verifyMapMsg(map_msg);
 }
 
+// Load map from a valid file. Save it in the native format, then load it back through its
+// YAML file and directly from the native file.
+// Succeeds all steps were passed without a problem or expection.
+TEST_F(MapIOTester, loadSaveNativeMap)
+{
+  // 1. Load map from YAML file
+  nav_msgs::msg::OccupancyGrid map_msg;
+  LOAD_MAP_STATUS status = loadMapFromYaml(path(TEST_DIR) / path(g_valid_yaml_file), map_msg);
+  ASSERT_EQ(status, LOAD_MAP_SUCCESS);
+
+  // 2. Save map in the native format
+  SaveParameters saveParameters;
+  fillSaveParameters(path(g_tmp_dir) / path(g_valid_map_name), NATIVE_MAP_FORMAT, saveParameters);
+
+  ASSERT_TRUE(saveMapToFile(map_msg, saveParameters));
+
+  // 3. Load saved map through its YAML file and verify it
+  status = loadMapFromYaml(path(g_tmp_dir) / path(g_valid_yaml_file), map_msg);
+  ASSERT_EQ(status, LOAD_MAP_SUCCESS);
+
+  verifyMapMsg(map_msg);
+
+  // 4. Load saved map directly and verify it
+  const std::string native_file =
+    path(g_tmp_dir) / path(std::string(g_valid_map_name) + "." + NATIVE_MAP_FORMAT);
+  ASSERT_TRUE(isNativeMapFile(native_file));
+  status = loadMapFromYaml(native_file, map_msg);
+  ASSERT_EQ(status, LOAD_MAP_SUCCESS);
+
+  verifyMapMsg(map_msg);
+  EXPECT_DOUBLE_EQ(map_msg.info.origin.position.x, g_valid_origin[0]);
+  EXPECT_DOUBLE_EQ(map_msg.info.origin.position.y, g_valid_origin[1]);
+
+  // 5. Try to load a file which is not a native map
+  const std::string invalid_file =
+    path(g_tmp_dir) / path("invalid." + std::string(NATIVE_MAP_FORMAT));
+  std::ofstream(invalid_file) << "not a map";
+  status = loadMapFromYaml(invalid_file, map_msg);
+  ASSERT_EQ(status, INVALID_MAP_DATA);
+}
+
 // Try to load an invalid file with different ways.
 // Succeeds if all cases are got expected fail behaviours.
 TEST_F(MapIOTester, loadInvalidFile)
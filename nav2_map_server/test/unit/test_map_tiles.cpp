@@ -0,0 +1,98 @@
+// Copyright (c) 2024 Open Navigation LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+
+#include "nav2_map_server/map_tiles.hpp"
+#include "nav2_util/occ_grid_values.hpp"
+
+using namespace nav2_map_server;  // NOLINT
+
+// A 5x4 map of 0.5m cells, where the value of each cell is its index
+nav_msgs::msg::OccupancyGrid makeMap()
+{
+  nav_msgs::msg::OccupancyGrid map;
+  map.info.width = 5;
+  map.info.height = 4;
+  map.info.resolution = 0.5;
+  map.info.origin.position.x = -1.0;
+  map.info.origin.position.y = 2.0;
+  map.info.origin.orientation.w = 1.0;
+  for (int8_t i = 0; i < 20; ++i) {
+    map.data.push_back(i);
+  }
+  return map;
+}
+
+TEST(MapTilesTest, downsampleMap)
+{
+  auto map = makeMap();
+  map.data[0] = nav2_util::OCC_GRID_UNKNOWN;
+  map.data[1] = nav2_util::OCC_GRID_UNKNOWN;
+  map.data[5] = nav2_util::OCC_GRID_UNKNOWN;
+  map.data[6] = nav2_util::OCC_GRID_UNKNOWN;
+  map.data[2] = nav2_util::OCC_GRID_UNKNOWN;
+
+  auto level = downsampleMap(map);
+  EXPECT_EQ(level.info.width, 3u);
+  EXPECT_EQ(level.info.height, 2u);
+  EXPECT_DOUBLE_EQ(level.info.resolution, 1.0);
+  EXPECT_DOUBLE_EQ(level.info.origin.position.x, -1.0);
+  EXPECT_DOUBLE_EQ(level.info.origin.position.y, 2.0);
+
+  // Unknown only where all the cells are, the highest occupancy of the known ones otherwise
+  std::vector<int8_t> expected = {nav2_util::OCC_GRID_UNKNOWN, 8, 9, 16, 18, 19};
+  EXPECT_EQ(level.data, expected);
+}
+
+TEST(MapTilesTest, getMapWindow)
+{
+  auto map = makeMap();
+  nav_msgs::msg::OccupancyGrid window;
+
+  ASSERT_TRUE(getMapWindow(map, 1, 1, 3, 3, window));
+  EXPECT_EQ(window.info.width, 2u);
+  EXPECT_EQ(window.info.height, 2u);
+  EXPECT_DOUBLE_EQ(window.info.origin.position.x, -0.5);
+  EXPECT_DOUBLE_EQ(window.info.origin.position.y, 2.5);
+  std::vector<int8_t> expected = {6, 7, 11, 12};
+  EXPECT_EQ(window.data, expected);
+
+  // Clipped to the map
+  ASSERT_TRUE(getMapWindow(map, 4, 3, 8, 8, window));
+  EXPECT_EQ(window.info.width, 1u);
+  EXPECT_EQ(window.info.height, 1u);
+  EXPECT_EQ(window.data[0], 19);
+
+  EXPECT_FALSE(getMapWindow(map, 5, 0, 8, 4, window));
+  EXPECT_FALSE(getMapWindow(map, -4, 0, 0, 4, window));
+}
+
+TEST(MapTilesTest, getMapRegion)
+{
+  auto map = makeMap();
+  nav_msgs::msg::OccupancyGrid region;
+
+  // Covers the cells (1, 1) to (2, 2)
+  ASSERT_TRUE(getMapRegion(map, -0.4, 2.6, 0.4, 3.4, region));
+  EXPECT_EQ(region.info.width, 2u);
+  EXPECT_EQ(region.info.height, 2u);
+  std::vector<int8_t> expected = {6, 7, 11, 12};
+  EXPECT_EQ(region.data, expected);
+
+  // Far from the map
+  EXPECT_FALSE(getMapRegion(map, 1e9, 1e9, 2e9, 2e9, region));
+  // Inverted bounds
+  EXPECT_FALSE(getMapRegion(map, 0.4, 2.6, -0.4, 3.4, region));
+}
@@ -0,0 +1,72 @@
+// Copyright (c) 2024 Open Navigation LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+
+#include <vector>
+
+#include "nav2_map_server/sparse_mask.hpp"
+#include "nav2_util/occ_grid_values.hpp"
+
+using namespace nav2_map_server;  // NOLINT
+
+TEST(SparseMaskTest, encodeDecode)
+{
+  // A 6x3 free mask with a keepout zone and a speed zone
+  nav_msgs::msg::OccupancyGrid mask;
+  mask.header.frame_id = "map";
+  mask.info.width = 6;
+  mask.info.height = 3;
+  mask.info.resolution = 0.5;
+  mask.info.origin.position.x = 1.0;
+  mask.data = {
+    0, 0, 100, 100, 0, 0,
+    0, 0, 100, 100, 0, 40,
+    nav2_util::OCC_GRID_UNKNOWN, 0, 0, 0, 0, 40};
+
+  auto sparse_mask = encodeSparseMask(mask);
+  EXPECT_EQ(sparse_mask.header.frame_id, "map");
+  EXPECT_EQ(sparse_mask.info.width, 6u);
+  EXPECT_EQ(sparse_mask.info.height, 3u);
+  EXPECT_EQ(sparse_mask.default_value, 0);
+
+  EXPECT_EQ(sparse_mask.row, (std::vector<uint32_t>{0, 1, 1, 2, 2}));
+  EXPECT_EQ(sparse_mask.start, (std::vector<uint32_t>{2, 2, 5, 0, 5}));
+  EXPECT_EQ(sparse_mask.length, (std::vector<uint32_t>{2, 2, 1, 1, 1}));
+  EXPECT_EQ(
+    sparse_mask.value,
+    (std::vector<int8_t>{100, 100, 40, nav2_util::OCC_GRID_UNKNOWN, 40}));
+
+  auto decoded = decodeSparseMask(sparse_mask);
+  EXPECT_EQ(decoded.info, mask.info);
+  EXPECT_EQ(decoded.data, mask.data);
+}
+
+TEST(SparseMaskTest, unknownDefault)
+{
+  nav_msgs::msg::OccupancyGrid mask;
+  mask.info.width = 3;
+  mask.info.height = 2;
+  mask.data = {-1, -1, -1, -1, 100, -1};
+
+  auto sparse_mask = encodeSparseMask(mask);
+  EXPECT_EQ(sparse_mask.default_value, nav2_util::OCC_GRID_UNKNOWN);
+  ASSERT_EQ(sparse_mask.row.size(), 1u);
+  EXPECT_EQ(sparse_mask.row[0], 1u);
+  EXPECT_EQ(sparse_mask.start[0], 1u);
+  EXPECT_EQ(sparse_mask.length[0], 1u);
+  EXPECT_EQ(sparse_mask.value[0], 100);
+
+  EXPECT_EQ(decodeSparseMask(sparse_mask).data, mask.data);
+}
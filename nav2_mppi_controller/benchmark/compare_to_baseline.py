@@ -0,0 +1,96 @@
+#!/usr/bin/python3
+# Copyright (c) 2022 Samsung Research America, @artofnothingness Alexey Budyakov
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+# This tool compares the JSON results of a MPPI benchmark run against a stored
+# baseline, and fails if any benchmark or stage regressed beyond a tolerance or
+# exceeds a latency budget. Run compare_to_baseline.py -h for instructions
+
+import argparse
+import json
+import sys
+
+TIME_UNIT_TO_MS = {'ns': 1e-6, 'us': 1e-3, 'ms': 1.0, 's': 1e3}
+
+
+def load_results(filename):
+    with open(filename) as f:
+        benchmarks = json.load(f)['benchmarks']
+
+    # Keep the aggregates such as the median when repetitions were used
+    medians = [b for b in benchmarks if b.get('aggregate_name') == 'median']
+    if medians:
+        benchmarks = medians
+
+    results = {}
+    for b in benchmarks:
+        name = b.get('run_name', b['name'])
+        timings = {'time_ms': b['real_time'] * TIME_UNIT_TO_MS[b['time_unit']]}
+        for key, value in b.items():
+            if key.endswith('_ms') and isinstance(value, (int, float)):
+                timings[key] = value
+        results[name] = timings
+    return results
+
+
+def main():
+    parser = argparse.ArgumentParser(
+        description='Compare MPPI benchmark results against a baseline. Results are '
+                    'produced with --benchmark_out=<file> --benchmark_out_format=json')
+    parser.add_argument('results', help='JSON results of the run to check')
+    parser.add_argument('baseline', help='JSON results of the baseline run')
+    parser.add_argument('--tolerance', type=float, default=0.1,
+                        help='Allowed relative slowdown over the baseline (default 0.1)')
+    parser.add_argument('--min-delta-ms', type=float, default=0.05,
+                        help='Ignore slowdowns smaller than this, to skip timer noise')
+    parser.add_argument('--budget-ms', type=float, default=None,
+                        help='Latency budget that no benchmark total time may exceed')
+    args = parser.parse_args()
+
+    results = load_results(args.results)
+    baseline = load_results(args.baseline)
+
+    failures = []
+    print(f'{"benchmark":<60} {"stage":<28} {"baseline":>10} {"result":>10} {"change":>8}')
+    for name, timings in sorted(results.items()):
+        if args.budget_ms is not None and timings['time_ms'] > args.budget_ms:
+            failures.append(f'{name}: {timings["time_ms"]:.3f}ms over the '
+                            f'{args.budget_ms:.3f}ms budget')
+
+        if name not in baseline:
+            print(f'{name:<60} not in baseline')
+            continue
+
+        for stage, value in sorted(timings.items()):
+            reference = baseline[name].get(stage)
+            if reference is None:
+                continue
+            change = (value - reference) / reference if reference > 0.0 else 0.0
+            print(f'{name:<60} {stage:<28} {reference:>10.3f} {value:>10.3f} {change:>+8.1%}')
+            if change > args.tolerance and value - reference > args.min_delta_ms:
+                failures.append(f'{name} {stage}: {reference:.3f}ms -> {value:.3f}ms '
+                                f'({change:+.1%})')
+
+    if failures:
+        print('\nRegressions:')
+        for failure in failures:
+            print('  ' + failure)
+        return 1
+
+    print('\nNo regression')
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
@@ -0,0 +1,285 @@
+// Copyright (c) 2022 Samsung Research America, @artofnothingness Alexey Budyakov
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Canonical MPPI scenarios swept over the batch size, time steps and rollout threads,
+// reporting the time of each optimizer stage and critic as counters. Results can be
+// exported with --benchmark_out=<file> --benchmark_out_format=json and gated against
+// a stored baseline with compare_to_baseline.py.
+
+#include <benchmark/benchmark.h>
+#include <chrono>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <geometry_msgs/msg/pose_stamped.hpp>
+#include <geometry_msgs/msg/twist.hpp>
+#include <nav_msgs/msg/path.hpp>
+
+#include <nav2_costmap_2d/cost_values.hpp>
+#include <nav2_costmap_2d/costmap_2d.hpp>
+#include <nav2_costmap_2d/costmap_2d_ros.hpp>
+
+#include "nav2_mppi_controller/critic_manager.hpp"
+#include "nav2_mppi_controller/optimizer.hpp"
+#include "nav2_mppi_controller/tools/parameters_handler.hpp"
+
+#include "utils.hpp"
+
+class RosLockGuard
+{
+public:
+  RosLockGuard() {rclcpp::init(0, nullptr);}
+  ~RosLockGuard() {rclcpp::shutdown();}
+};
+
+RosLockGuard g_rclcpp;
+
+using Clock = std::chrono::steady_clock;
+
+inline double secondsSince(const Clock::time_point & start)
+{
+  return std::chrono::duration<double>(Clock::now() - start).count();
+}
+
+/**
+ * Accumulated time of each stage of the optimization, in seconds
+ */
+struct StageTimings
+{
+  double noise{0.0};
+  double rollout{0.0};
+  double weighting{0.0};
+  std::vector<double> critics;
+};
+
+/**
+ * Critic manager timing each of its critics, running them sequentially
+ */
+class TimedCriticManager : public mppi::CriticManager
+{
+public:
+  void evalTrajectoriesScoresByCritic(mppi::CriticData & data, std::vector<double> & times) const
+  {
+    times.resize(critics_.size(), 0.0);
+    for (size_t i = 0; i < critics_.size(); ++i) {
+      if (data.fail_flag) {
+        break;
+      }
+      const auto start = Clock::now();
+      critics_[i]->score(data);
+      times[i] += secondsSince(start);
+    }
+  }
+};
+
+/**
+ * Optimizer running the stages of its iterations one by one, to time them
+ */
+class StageTimedOptimizer : public mppi::Optimizer
+{
+public:
+  void initialize(
+    rclcpp_lifecycle::LifecycleNode::WeakPtr parent, const std::string & name,
+    std::shared_ptr<nav2_costmap_2d::Costmap2DROS> costmap_ros,
+    mppi::ParametersHandler * param_handler)
+  {
+    mppi::Optimizer::initialize(parent, name, costmap_ros, param_handler);
+    timed_critic_manager_.on_configure(parent, name, costmap_ros, param_handler);
+  }
+
+  const std::vector<std::string> & getCriticNames() const
+  {
+    return timed_critic_manager_.getCriticNames();
+  }
+
+  /**
+   * Same stages as evalControl, without the fallback on failure
+   */
+  void evalControlByStage(
+    const geometry_msgs::msg::PoseStamped & robot_pose,
+    const geometry_msgs::msg::Twist & robot_speed,
+    const nav_msgs::msg::Path & plan, StageTimings & timings)
+  {
+    prepare(robot_pose, robot_speed, plan, nullptr);
+
+    for (size_t i = 0; i < settings_.iteration_count; ++i) {
+      auto start = Clock::now();
+      noise_generator_.setNoisedControls(state_, control_sequence_);
+      noise_generator_.generateNextNoises();
+      injectKeptSamples();
+      timings.noise += secondsSince(start);
+
+      start = Clock::now();
+      updateStateVelocities(state_);
+      integrateStateVelocities(generated_trajectories_, state_);
+      timings.rollout += secondsSince(start);
+
+      timed_critic_manager_.evalTrajectoriesScoresByCritic(critics_data_, timings.critics);
+
+      start = Clock::now();
+      updateControlSequence();
+      timings.weighting += secondsSince(start);
+    }
+
+    mppi::utils::savitskyGolayFilter(control_sequence_, control_history_, settings_);
+    if (settings_.shift_control_sequence) {
+      shiftControlSequence();
+    }
+  }
+
+protected:
+  TimedCriticManager timed_critic_manager_;
+};
+
+enum class Scenario : int64_t
+{
+  OpenField = 0,
+  NarrowCorridor = 1,
+  DenseClutter = 2,
+  LongPath = 3
+};
+
+std::string getScenarioName(Scenario scenario)
+{
+  switch (scenario) {
+    case Scenario::OpenField:
+      return "open_field";
+    case Scenario::NarrowCorridor:
+      return "narrow_corridor";
+    case Scenario::DenseClutter:
+      return "dense_clutter";
+    case Scenario::LongPath:
+      return "long_path";
+  }
+  return "unknown";
+}
+
+/**
+ * Fill the costmap with the obstacles of a scenario and get the path to follow through it
+ */
+template<typename TNode>
+nav_msgs::msg::Path setUpScenario(
+  Scenario scenario, nav2_costmap_2d::Costmap2D * costmap,
+  const TestCostmapSettings & costmap_settings, TNode node)
+{
+  const unsigned int cells_x = costmap_settings.cells_x;
+  const unsigned int cells_y = costmap_settings.cells_y;
+  const double resolution = costmap_settings.resolution;
+  TestPose start_pose{1.0, static_cast<double>(cells_y) * resolution / 2.0};
+
+  switch (scenario) {
+    case Scenario::OpenField:
+      break;
+    case Scenario::NarrowCorridor:
+      // Walls 1.2m apart, a cell of inflation on their inner side
+      for (unsigned int i = 0; i < cells_x; i++) {
+        for (unsigned int j = 0; j < 2; j++) {
+          costmap->setCost(i, cells_y / 2 - 6 - j, nav2_costmap_2d::LETHAL_OBSTACLE);
+          costmap->setCost(i, cells_y / 2 + 6 + j, nav2_costmap_2d::LETHAL_OBSTACLE);
+        }
+        costmap->setCost(i, cells_y / 2 - 5, nav2_costmap_2d::INSCRIBED_INFLATED_OBSTACLE);
+        costmap->setCost(i, cells_y / 2 + 5, nav2_costmap_2d::INSCRIBED_INFLATED_OBSTACLE);
+      }
+      break;
+    case Scenario::DenseClutter:
+      // Staggered 3x3 cells obstacles every 0.8m, away from the path
+      for (unsigned int i = 20; i + 3 < cells_x; i += 8) {
+        for (unsigned int j = (i / 8) % 2 == 0 ? 4 : 8; j + 3 < cells_y; j += 8) {
+          if (j + 3 >= cells_y / 2 - 2 && j <= cells_y / 2 + 2) {
+            continue;
+          }
+          addObstacle(costmap, i, j, 3, nav2_costmap_2d::LETHAL_OBSTACLE);
+        }
+      }
+      break;
+    case Scenario::LongPath:
+      // Densely sampled path, to weigh the path critics
+      return getIncrementalDummyPath(
+        node, TestPathSettings{start_pose, 1600u, resolution / 20.0, 0.0});
+  }
+
+  return getIncrementalDummyPath(
+    node, TestPathSettings{start_pose, 70u, resolution, 0.0});
+}
+
+static void BM_Scenario(benchmark::State & state)
+{
+  const auto scenario = static_cast<Scenario>(state.range(0));
+  const int batch_size = static_cast<int>(state.range(1));
+  const int time_steps = static_cast<int>(state.range(2));
+  const int threads = static_cast<int>(state.range(3));
+  const int iteration_count = 1;
+  const double lookahead_distance = 10.0;
+  const std::string motion_model = "DiffDrive";
+  const std::vector<std::string> critics = {{"ConstraintCritic"}, {"CostCritic"},
+    {"GoalCritic"}, {"GoalAngleCritic"}, {"PathAlignCritic"}, {"PathFollowCritic"},
+    {"PathAngleCritic"}, {"PreferForwardCritic"}};
+
+  TestCostmapSettings costmap_settings{100, 100};
+  auto costmap_ros = getDummyCostmapRos(costmap_settings);
+  auto costmap = costmap_ros->getCostmap();
+
+  TestOptimizerSettings optimizer_settings{batch_size, time_steps, iteration_count,
+    lookahead_distance, motion_model, true};
+  std::vector<rclcpp::Parameter> params;
+  setUpOptimizerParams(optimizer_settings, critics, params);
+  params.emplace_back(rclcpp::Parameter("dummy.rollout_threads", threads));
+  params.emplace_back(rclcpp::Parameter("dummy.noise_threads", threads));
+  params.emplace_back(rclcpp::Parameter("dummy.CostCritic.consider_footprint", true));
+  rclcpp::NodeOptions options;
+  options.parameter_overrides(params);
+  auto node = getDummyNode(options);
+
+  auto path = setUpScenario(scenario, costmap, costmap_settings, node);
+  auto parameters_handler = std::make_unique<mppi::ParametersHandler>(node);
+  auto optimizer = std::make_shared<StageTimedOptimizer>();
+  optimizer->initialize(node, node->get_name(), costmap_ros, parameters_handler.get());
+
+  const auto & start = path.poses.front().pose.position;
+  auto pose = getDummyPointStamped(node, TestPose{start.x, start.y});
+  auto velocity = getDummyTwist();
+
+  StageTimings timings;
+  for (auto _ : state) {
+    optimizer->evalControlByStage(pose, velocity, path, timings);
+  }
+
+  // Per cycle averages, in milliseconds
+  state.SetLabel(getScenarioName(scenario));
+  auto perCycleMs = [](double seconds) {
+      return benchmark::Counter(seconds * 1e3, benchmark::Counter::kAvgIterations);
+    };
+  state.counters["noise_ms"] = perCycleMs(timings.noise);
+  state.counters["rollout_ms"] = perCycleMs(timings.rollout);
+  state.counters["weighting_ms"] = perCycleMs(timings.weighting);
+  const auto & critic_names = optimizer->getCriticNames();
+  for (size_t i = 0; i < timings.critics.size() && i < critic_names.size(); ++i) {
+    state.counters[critic_names[i] + "_ms"] = perCycleMs(timings.critics[i]);
+  }
+
+  optimizer->shutdown();
+}
+
+BENCHMARK(BM_Scenario)
+->ArgNames({"scenario", "batch", "steps", "threads"})
+->ArgsProduct({
+    {static_cast<int64_t>(Scenario::OpenField), static_cast<int64_t>(Scenario::NarrowCorridor),
+      static_cast<int64_t>(Scenario::DenseClutter), static_cast<int64_t>(Scenario::LongPath)},
+    {500, 1000, 2000},
+    {28, 56},
+    {1, 4}})
+->Unit(benchmark::kMillisecond);
+
+BENCHMARK_MAIN();
@@ -27,6 +27,8 @@
 #include "nav2_core/controller.hpp"
 #include "nav2_core/goal_checker.hpp"
 #include "rclcpp/rclcpp.hpp"
+#include "std_msgs/msg/u_int32.hpp"
+#include "nav2_msgs/msg/controller_latency.hpp"
 
 namespace nav2_mppi_controller
 {
@@ -108,6 +110,13 @@ protected:
     */
   void visualize(nav_msgs::msg::Path transformed_plan);
 
+  /**
+    * @brief Publish the latencies of the control cycles and of the optimizer stages
+    * since the last publication, if the publish period elapsed
+    * @param cycle_start Start of the control cycle
+    */
+  void publishLatencies(const std::chrono::steady_clock::time_point & cycle_start);
+
   std::string name_;
   rclcpp_lifecycle::LifecycleNode::WeakPtr parent_;
   rclcpp::Logger logger_{rclcpp::get_logger("MPPIController")};
@@ -119,6 +128,14 @@ protected:
   PathHandler path_handler_;
   TrajectoryVisualizer trajectory_visualizer_;
 
+  std::shared_ptr<rclcpp_lifecycle::LifecyclePublisher<std_msgs::msg::UInt32>> batch_size_pub_;
+  std::shared_ptr<rclcpp_lifecycle::LifecyclePublisher<nav2_msgs::msg::ControllerLatency>>
+  latency_pub_;
+  double latency_publish_period_{1.0};
+  std::chrono::steady_clock::time_point last_latency_publish_;
+  LatencyHistogram cycle_latency_;
+  std::vector<std::pair<std::string, LatencySummary>> latencies_;
+
   bool visualize_;
 };
 
@@ -31,6 +31,8 @@
 #include "nav2_mppi_controller/models/trajectories.hpp"
 #include "nav2_mppi_controller/models/path.hpp"
 #include "nav2_mppi_controller/motion_models.hpp"
+#include "nav2_mppi_controller/tools/distance_field.hpp"
+#include "nav2_mppi_controller/tools/path_index.hpp"
 
 
 namespace mppi
@@ -55,6 +57,8 @@ struct CriticData
   std::shared_ptr<MotionModel> motion_model;
   std::optional<std::vector<bool>> path_pts_valid;
   std::optional<size_t> furthest_reached_path_point;
+  std::shared_ptr<CostmapDistanceField> distance_field{nullptr};  ///< Lazily updated per cycle
+  std::shared_ptr<PathSpatialIndex> path_index{nullptr};  ///< Lazily updated per cycle
 };
 
 }  // namespace mppi
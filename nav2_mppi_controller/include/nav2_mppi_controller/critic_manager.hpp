@@ -17,6 +17,7 @@
 
 #include <memory>
 #include <string>
+#include <utility>
 #include <vector>
 #include <pluginlib/class_loader.hpp>
 
@@ -31,8 +32,10 @@
 #include "geometry_msgs/msg/twist_stamped.hpp"
 
 #include "nav2_costmap_2d/costmap_2d_ros.hpp"
+#include "nav2_util/thread_pool.hpp"
 #include "rclcpp_lifecycle/lifecycle_node.hpp"
 
+#include "nav2_mppi_controller/tools/latency_histogram.hpp"
 #include "nav2_mppi_controller/tools/parameters_handler.hpp"
 #include "nav2_mppi_controller/tools/utils.hpp"
 #include "nav2_mppi_controller/critic_data.hpp"
@@ -77,6 +80,19 @@ public:
     */
   void evalTrajectoriesScores(CriticData & data) const;
 
+  /**
+    * @brief Get the names of the loaded critics, in scoring order
+    * @return Critic names
+    */
+  const std::vector<std::string> & getCriticNames() const;
+
+  /**
+    * @brief Summarize the latencies of the critics since the last collection,
+    * if instrumented with latency_instrumentation
+    * @param latencies Summaries to append the critics ones to, in scoring order
+    */
+  void collectLatencies(std::vector<std::pair<std::string, LatencySummary>> & latencies);
+
 protected:
   /**
     * @brief Get parameters (critics to load)
@@ -93,6 +109,20 @@ protected:
     */
   std::string getFullName(const std::string & name);
 
+  /**
+    * @brief Score trajectories by running the critics concurrently, each into its own
+    * costs buffer, then summing the buffers into the costs in critic order
+    * @param CriticData Struct of necessary information to pass to the critic functions
+    */
+  void evalTrajectoriesScoresParallel(CriticData & data) const;
+
+  /**
+    * @brief Score trajectories by a critic, recording its latency if instrumented
+    * @param index Index of the critic
+    * @param CriticData Struct of necessary information to pass to the critic function
+    */
+  void scoreCritic(size_t index, CriticData & data) const;
+
 protected:
   rclcpp_lifecycle::LifecycleNode::WeakPtr parent_;
   std::shared_ptr<nav2_costmap_2d::Costmap2DROS> costmap_ros_;
@@ -103,6 +133,14 @@ protected:
   std::unique_ptr<pluginlib::ClassLoader<critics::CriticFunction>> loader_;
   Critics critics_;
 
+  int critic_threads_{1};
+  std::unique_ptr<nav2_util::ThreadPool> thread_pool_;
+  mutable std::vector<xt::xtensor<float, 1>> critic_costs_;
+  mutable std::vector<char> critic_fail_flags_;
+
+  bool latency_instrumentation_{false};
+  mutable std::vector<LatencyHistogram> critic_latencies_;
+
   rclcpp::Logger logger_{rclcpp::get_logger("MPPIController")};
 };
 
@@ -17,7 +17,9 @@
 
 #include <memory>
 #include <string>
+#include <vector>
 
+#include "nav2_costmap_2d/costmap_view.hpp"
 #include "nav2_costmap_2d/footprint_collision_checker.hpp"
 #include "nav2_costmap_2d/inflation_layer.hpp"
 
@@ -63,9 +65,16 @@ protected:
     if (consider_footprint_ &&
       (cost >= possible_collision_cost_ || possible_collision_cost_ < 1.0f))
     {
-      score_cost = static_cast<float>(collision_checker_.footprintCostAtPose(
-          static_cast<double>(x), static_cast<double>(y), static_cast<double>(theta),
-          costmap_ros_->getRobotFootprint()));
+      if (distance_field_) {
+        // Footprint approximated by circles, only falling back on the center cost otherwise
+        if (distance_field_->clearance(x, y, theta, footprint_circles_) <= 0.0f) {
+          return true;
+        }
+      } else {
+        score_cost = static_cast<float>(collision_checker_.footprintCostAtPose(
+            static_cast<double>(x), static_cast<double>(y), static_cast<double>(theta),
+            costmap_ros_->getRobotFootprint()));
+      }
     }
 
     switch (static_cast<unsigned char>(score_cost)) {
@@ -112,17 +121,6 @@ protected:
     return false;
   }
 
-  /**
-    * @brief A local implementation of getIndex
-    * @param mx unsigned int map X coord
-    * @param my unsigned into map Y coord
-    * @return Index
-    */
-  inline unsigned int getIndex(unsigned int mx, unsigned int my) const
-  {
-    return my * size_x_ + mx;
-  }
-
   nav2_costmap_2d::FootprintCollisionChecker<nav2_costmap_2d::Costmap2D *>
   collision_checker_{nullptr};
   float possible_collision_cost_;
@@ -142,6 +140,10 @@ protected:
   float near_goal_distance_;
   std::string inflation_layer_name_;
 
+  bool use_distance_field_{false};
+  CostmapDistanceField * distance_field_{nullptr};
+  std::vector<FootprintCircle> footprint_circles_;
+
   unsigned int power_{0};
 };
 
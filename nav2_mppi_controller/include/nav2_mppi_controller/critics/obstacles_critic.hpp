@@ -17,6 +17,7 @@
 
 #include <memory>
 #include <string>
+#include <vector>
 
 #include "nav2_costmap_2d/footprint_collision_checker.hpp"
 #include "nav2_costmap_2d/inflation_layer.hpp"
@@ -82,6 +83,12 @@ protected:
     */
   float findCircumscribedCost(std::shared_ptr<nav2_costmap_2d::Costmap2DROS> costmap);
 
+  /**
+    * @brief Approximate the robot, or its inscribed circle if not considering the
+    * footprint, by circles to check against the distance field
+    */
+  void setFootprintCircles();
+
 protected:
   nav2_costmap_2d::FootprintCollisionChecker<nav2_costmap_2d::Costmap2D *>
   collision_checker_{nullptr};
@@ -98,6 +105,9 @@ protected:
   unsigned int power_{0};
   float repulsion_weight_, critical_weight_{0};
   std::string inflation_layer_name_;
+
+  bool use_distance_field_{false};
+  std::vector<FootprintCircle> footprint_circles_;
 };
 
 }  // namespace mppi::critics
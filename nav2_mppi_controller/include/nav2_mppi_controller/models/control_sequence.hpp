@@ -20,6 +20,7 @@
 #pragma GCC diagnostic ignored "-Warray-bounds"
 #pragma GCC diagnostic ignored "-Wstringop-overflow"
 #include <xtensor/xtensor.hpp>
+#include <xtensor/xnoalias.hpp>
 #pragma GCC diagnostic pop
 
 namespace mppi::models
@@ -46,9 +47,9 @@ struct ControlSequence
 
   void reset(unsigned int time_steps)
   {
-    vx = xt::zeros<float>({time_steps});
-    vy = xt::zeros<float>({time_steps});
-    wz = xt::zeros<float>({time_steps});
+    xt::noalias(vx) = xt::zeros<float>({time_steps});
+    xt::noalias(vy) = xt::zeros<float>({time_steps});
+    xt::noalias(wz) = xt::zeros<float>({time_steps});
   }
 };
 
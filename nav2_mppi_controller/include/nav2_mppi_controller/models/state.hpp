@@ -20,6 +20,7 @@
 #pragma GCC diagnostic ignored "-Warray-bounds"
 #pragma GCC diagnostic ignored "-Wstringop-overflow"
 #include <xtensor/xtensor.hpp>
+#include <xtensor/xnoalias.hpp>
 #pragma GCC diagnostic pop
 
 #include <geometry_msgs/msg/pose_stamped.hpp>
@@ -46,17 +47,17 @@ struct State
   geometry_msgs::msg::Twist speed;
 
   /**
-    * @brief Reset state data
+    * @brief Reset state data, reusing the storage when the size is unchanged
     */
   void reset(unsigned int batch_size, unsigned int time_steps)
   {
-    vx = xt::zeros<float>({batch_size, time_steps});
-    vy = xt::zeros<float>({batch_size, time_steps});
-    wz = xt::zeros<float>({batch_size, time_steps});
+    xt::noalias(vx) = xt::zeros<float>({batch_size, time_steps});
+    xt::noalias(vy) = xt::zeros<float>({batch_size, time_steps});
+    xt::noalias(wz) = xt::zeros<float>({batch_size, time_steps});
 
-    cvx = xt::zeros<float>({batch_size, time_steps});
-    cvy = xt::zeros<float>({batch_size, time_steps});
-    cwz = xt::zeros<float>({batch_size, time_steps});
+    xt::noalias(cvx) = xt::zeros<float>({batch_size, time_steps});
+    xt::noalias(cvy) = xt::zeros<float>({batch_size, time_steps});
+    xt::noalias(cwz) = xt::zeros<float>({batch_size, time_steps});
   }
 };
 }  // namespace mppi::models
@@ -20,6 +20,7 @@
 #pragma GCC diagnostic ignored "-Warray-bounds"
 #pragma GCC diagnostic ignored "-Wstringop-overflow"
 #include <xtensor/xtensor.hpp>
+#include <xtensor/xnoalias.hpp>
 #include <xtensor/xview.hpp>
 #pragma GCC diagnostic pop
 
@@ -37,13 +38,13 @@ struct Trajectories
   xt::xtensor<float, 2> yaws;
 
   /**
-    * @brief Reset state data
+    * @brief Reset state data, reusing the storage when the size is unchanged
     */
   void reset(unsigned int batch_size, unsigned int time_steps)
   {
-    x = xt::zeros<float>({batch_size, time_steps});
-    y = xt::zeros<float>({batch_size, time_steps});
-    yaws = xt::zeros<float>({batch_size, time_steps});
+    xt::noalias(x) = xt::zeros<float>({batch_size, time_steps});
+    xt::noalias(y) = xt::zeros<float>({batch_size, time_steps});
+    xt::noalias(yaws) = xt::zeros<float>({batch_size, time_steps});
   }
 };
 
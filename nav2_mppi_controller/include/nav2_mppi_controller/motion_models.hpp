@@ -15,6 +15,8 @@
 #ifndef NAV2_MPPI_CONTROLLER__MOTION_MODELS_HPP_
 #define NAV2_MPPI_CONTROLLER__MOTION_MODELS_HPP_
 
+#include <algorithm>
+#include <cstddef>
 #include <cstdint>
 #include <string>
 
@@ -82,33 +84,11 @@ public:
     //     xt::noalias(xt::view(state.cvy, xt::all(), xt::range(0, -1)));
     // }
 
-    const bool is_holo = isHolonomic();
-    float max_delta_vx = model_dt_ * control_constraints_.ax_max;
-    float min_delta_vx = model_dt_ * control_constraints_.ax_min;
-    float max_delta_vy = model_dt_ * control_constraints_.ay_max;
-    float max_delta_wz = model_dt_ * control_constraints_.az_max;
-    for (unsigned int i = 0; i != state.vx.shape(0); i++) {
-      float vx_last = state.vx(i, 0);
-      float vy_last = state.vy(i, 0);
-      float wz_last = state.wz(i, 0);
-      for (unsigned int j = 1; j != state.vx.shape(1); j++) {
-        float & cvx_curr = state.cvx(i, j - 1);
-        cvx_curr = std::clamp(cvx_curr, vx_last + min_delta_vx, vx_last + max_delta_vx);
-        state.vx(i, j) = cvx_curr;
-        vx_last = cvx_curr;
-
-        float & cwz_curr = state.cwz(i, j - 1);
-        cwz_curr = std::clamp(cwz_curr, wz_last - max_delta_wz, wz_last + max_delta_wz);
-        state.wz(i, j) = cwz_curr;
-        wz_last = cwz_curr;
-
-        if (is_holo) {
-          float & cvy_curr = state.cvy(i, j - 1);
-          cvy_curr = std::clamp(cvy_curr, vy_last - max_delta_vy, vy_last + max_delta_vy);
-          state.vy(i, j) = cvy_curr;
-          vy_last = cvy_curr;
-        }
-      }
+    // Specialized on the holonomic axis, so the per point loops have no branches
+    if (isHolonomic()) {
+      predictVelocities<true>(state);
+    } else {
+      predictVelocities<false>(state);
     }
   }
 
@@ -125,6 +105,48 @@ public:
   virtual void applyConstraints(models::ControlSequence & /*control_sequence*/) {}
 
 protected:
+  /**
+   * @brief Propagate the control velocities of each sample within the acceleration limits
+   * @param state Contains control velocities to use to populate vehicle velocities
+   */
+  template<bool holonomic>
+  void predictVelocities(models::State & state) const
+  {
+    const float max_delta_vx = model_dt_ * control_constraints_.ax_max;
+    const float min_delta_vx = model_dt_ * control_constraints_.ax_min;
+    const float max_delta_vy = model_dt_ * control_constraints_.ay_max;
+    const float max_delta_wz = model_dt_ * control_constraints_.az_max;
+    const size_t time_steps = state.vx.shape(1);
+    for (size_t i = 0; i != state.vx.shape(0); i++) {
+      float * vx = &state.vx(i, 0);
+      float * wz = &state.wz(i, 0);
+      float * cvx = &state.cvx(i, 0);
+      float * cwz = &state.cwz(i, 0);
+      float vx_last = vx[0];
+      float wz_last = wz[0];
+      for (size_t j = 1; j < time_steps; j++) {
+        vx_last = std::clamp(cvx[j - 1], vx_last + min_delta_vx, vx_last + max_delta_vx);
+        cvx[j - 1] = vx_last;
+        vx[j] = vx_last;
+
+        wz_last = std::clamp(cwz[j - 1], wz_last - max_delta_wz, wz_last + max_delta_wz);
+        cwz[j - 1] = wz_last;
+        wz[j] = wz_last;
+      }
+
+      if constexpr (holonomic) {
+        float * vy = &state.vy(i, 0);
+        float * cvy = &state.cvy(i, 0);
+        float vy_last = vy[0];
+        for (size_t j = 1; j < time_steps; j++) {
+          vy_last = std::clamp(cvy[j - 1], vy_last - max_delta_vy, vy_last + max_delta_vy);
+          cvy[j - 1] = vy_last;
+          vy[j] = vy_last;
+        }
+      }
+    }
+  }
+
   float model_dt_{0.0};
   models::ControlConstraints control_constraints_{0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f,
     0.0f};
@@ -134,7 +156,7 @@ protected:
  * @class mppi::AckermannMotionModel
  * @brief Ackermann motion model
  */
-class AckermannMotionModel : public MotionModel
+class AckermannMotionModel final : public MotionModel
 {
 public:
   /**
@@ -182,7 +204,7 @@ private:
  * @class mppi::DiffDriveMotionModel
  * @brief Differential drive motion model
  */
-class DiffDriveMotionModel : public MotionModel
+class DiffDriveMotionModel final : public MotionModel
 {
 public:
   /**
@@ -204,7 +226,7 @@ public:
  * @class mppi::OmniMotionModel
  * @brief Omnidirectional motion model
  */
-class OmniMotionModel : public MotionModel
+class OmniMotionModel final : public MotionModel
 {
 public:
   /**
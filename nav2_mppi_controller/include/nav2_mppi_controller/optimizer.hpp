@@ -15,8 +15,12 @@
 #ifndef NAV2_MPPI_CONTROLLER__OPTIMIZER_HPP_
 #define NAV2_MPPI_CONTROLLER__OPTIMIZER_HPP_
 
+#include <array>
+#include <chrono>
 #include <string>
 #include <memory>
+#include <utility>
+#include <vector>
 
 // xtensor creates warnings that needs to be ignored as we are building with -Werror
 #pragma GCC diagnostic push
@@ -43,9 +47,12 @@
 #include "nav2_mppi_controller/models/state.hpp"
 #include "nav2_mppi_controller/models/trajectories.hpp"
 #include "nav2_mppi_controller/models/path.hpp"
+#include "nav2_mppi_controller/tools/latency_histogram.hpp"
 #include "nav2_mppi_controller/tools/noise_generator.hpp"
 #include "nav2_mppi_controller/tools/parameters_handler.hpp"
 #include "nav2_mppi_controller/tools/utils.hpp"
+#include "nav2_util/execution_timer.hpp"
+#include "nav2_util/thread_pool.hpp"
 
 namespace mppi
 {
@@ -122,6 +129,32 @@ public:
    */
   void reset();
 
+  /**
+   * @brief Get the number of trajectories sampled per iteration, which varies
+   * within its bounds to fit the cycle time budget with adaptive sampling
+   * @return Batch size
+   */
+  unsigned int getBatchSize() const;
+
+  /**
+   * @brief Whether the batch size adapts to the cycle time budget
+   * @return Bool if adaptive sampling is enabled
+   */
+  bool isAdaptiveSampling() const;
+
+  /**
+   * @brief Whether the latencies of the optimizer stages and critics are recorded
+   * @return Bool if latency instrumentation is enabled
+   */
+  bool isLatencyInstrumented() const;
+
+  /**
+   * @brief Summarize the latencies of the optimizer stages and critics per iteration
+   * since the last collection
+   * @param latencies Summaries to append the stages then the critics ones to
+   */
+  void collectLatencies(std::vector<std::pair<std::string, LatencySummary>> & latencies);
+
 protected:
   /**
    * @brief Main function to generate, score, and return trajectories
@@ -196,6 +229,17 @@ protected:
     models::Trajectories & trajectories,
     const models::State & state) const;
 
+  /**
+   * @brief Rollout velocities in state to poses, specialized on the Y axis
+   * @tparam holonomic Whether to consider the Y axis
+   * @param trajectories to rollout, sized to the state
+   * @param state fill state
+   */
+  template<bool holonomic>
+  void integrateSamples(
+    models::Trajectories & trajectories,
+    const models::State & state) const;
+
   /**
    * @brief Rollout velocities in state to poses
    * @param trajectories to rollout
@@ -211,6 +255,20 @@ protected:
    */
   void updateControlSequence();
 
+  /**
+   * @brief Add the control costs of the samples relative to the control sequence
+   * @tparam holonomic Whether to consider the Y axis
+   */
+  template<bool holonomic>
+  void addControlCosts();
+
+  /**
+   * @brief Set the control sequence to the samples controls weighted by their softmax weights
+   * @tparam holonomic Whether to consider the Y axis
+   */
+  template<bool holonomic>
+  void weightControlSequence();
+
   /**
    * @brief Convert control sequence to a twist commant
    * @param stamp Timestamp to use
@@ -219,12 +277,78 @@ protected:
   geometry_msgs::msg::TwistStamped
   getControlFromSequenceAsTwist(const builtin_interfaces::msg::Time & stamp);
 
+  /**
+   * @brief Keep the controls of the lowest cost samples, to sample them again
+   * in the next iteration alongside the noised ones
+   */
+  void keepBestSamples();
+
+  /**
+   * @brief Replace the first noised samples by the kept ones, and the last one by
+   * a braking primitive if enabled
+   */
+  void injectKeptSamples();
+
+  /**
+   * @brief Shift the kept samples by a time step, as for the control sequence
+   */
+  void shiftKeptSamples();
+
+  /**
+   * @brief Resize the sampled batch, keeping the control sequence to warm start from
+   * @param batch_size New number of trajectories sampled per iteration
+   */
+  void resizeBatch(unsigned int batch_size);
+
+  /**
+   * @brief Choose the batch size of the next cycle from the measured cost of the
+   * samples of this one, to fit the cycle time budget
+   * @param elapsed_time Time spent optimizing this cycle (s)
+   */
+  void adaptBatchSize(double elapsed_time);
+
+  /**
+   * @brief Whether the optimization ran out of its cycle time budget
+   * @return Bool if another iteration would exceed the budget
+   */
+  bool isOutOfTimeBudget();
+
+  /**
+   * @brief Record the latency of a stage if instrumented
+   * @param stage Stage to record the latency of
+   * @param start Start of the stage
+   * @return End of the stage, to start the next one from
+   */
+  std::chrono::steady_clock::time_point recordStageLatency(
+    size_t stage, const std::chrono::steady_clock::time_point & start);
+
   /**
    * @brief Whether the motion model is holonomic
    * @return Bool if holonomic to populate `y` axis of state
    */
   bool isHolonomic() const;
 
+  /**
+   * @brief Run fn(begin, end) over contiguous ranges of the batch samples,
+   * spread over the rollout threads when more than one is configured
+   * @param batch_size Number of samples to cover
+   * @param fn Callable processing the samples in [begin, end)
+   */
+  template<typename F>
+  void forEachSampleRange(size_t batch_size, F && fn) const
+  {
+    if (!rollout_pool_) {
+      fn(size_t{0}, batch_size);
+      return;
+    }
+
+    const size_t ranges = rollout_pool_->size() + 1;
+    rollout_pool_->parallelFor(
+      0, ranges, [&](size_t range) {
+        fn(batch_size * range / ranges, batch_size * (range + 1) / ranges);
+      });
+  }
+
   /**
    * @brief Using control frequence and time step size, determine if trajectory
    * offset should be used to populate initial state of the next cycle
@@ -249,6 +373,32 @@ protected:
   CriticManager critic_manager_;
   NoiseGenerator noise_generator_;
 
+  int rollout_threads_{1};
+  std::unique_ptr<nav2_util::ThreadPool> rollout_pool_;
+
+  std::shared_ptr<CostmapDistanceField> distance_field_;
+  std::shared_ptr<PathSpatialIndex> path_index_;
+
+  unsigned int kept_samples_{0};
+  bool braking_sample_{false};
+  size_t kept_count_{0};
+  xt::xtensor<float, 2> kept_vx_, kept_vy_, kept_wz_;
+  std::vector<unsigned int> ranked_samples_;
+
+  bool adaptive_sampling_{false};
+  double controller_period_{0.0};
+  float time_budget_fraction_{0.5f};
+  unsigned int min_batch_size_{0}, max_batch_size_{0};
+  size_t cycle_iterations_{0};
+  nav2_util::ExecutionTimer cycle_timer_;
+
+  enum LatencyStage : size_t {NOISE_STAGE = 0, ROLLOUT_STAGE, CRITICS_STAGE, WEIGHTING_STAGE,
+    STAGES_COUNT};
+  static constexpr std::array<const char *, STAGES_COUNT> stage_names_{
+    "noise", "rollout", "critics", "weighting"};
+  bool latency_instrumentation_{false};
+  std::array<LatencyHistogram, STAGES_COUNT> stage_latencies_;
+
   models::OptimizerSettings settings_;
 
   models::State state_;
@@ -257,6 +407,7 @@ protected:
   models::Trajectories generated_trajectories_;
   models::Path path_;
   xt::xtensor<float, 1> costs_;
+  xt::xtensor<float, 1> weights_;  ///< Softmax weights of the trajectories, reused per iteration
 
   CriticData critics_data_ =
   {state_, generated_trajectories_, path_, costs_, settings_.model_dt, false, nullptr, nullptr,
@@ -0,0 +1,297 @@
+// Copyright (c) 2022 Samsung Research America, @artofnothingness Alexey Budyakov
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef NAV2_MPPI_CONTROLLER__TOOLS__DISTANCE_FIELD_HPP_
+#define NAV2_MPPI_CONTROLLER__TOOLS__DISTANCE_FIELD_HPP_
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <mutex>
+#include <vector>
+
+#include "geometry_msgs/msg/point.hpp"
+#include "nav2_costmap_2d/cost_values.hpp"
+#include "nav2_costmap_2d/costmap_2d.hpp"
+
+namespace mppi
+{
+
+/**
+ * @struct mppi::FootprintCircle
+ * @brief Circle of a footprint approximation, in the robot frame
+ */
+struct FootprintCircle
+{
+  float x;
+  float y;
+  float radius;
+};
+
+/**
+ * @brief Cover a footprint with circles along the longest side of its bounding box,
+ * so that a footprint collision check becomes a few distance lookups
+ * @param footprint Footprint polygon in the robot frame
+ * @return Circles covering the footprint
+ */
+inline std::vector<FootprintCircle> approximateFootprintWithCircles(
+  const std::vector<geometry_msgs::msg::Point> & footprint)
+{
+  if (footprint.empty()) {
+    return {};
+  }
+
+  float min_x = std::numeric_limits<float>::max(), max_x = std::numeric_limits<float>::lowest();
+  float min_y = min_x, max_y = max_x;
+  for (const auto & pt : footprint) {
+    min_x = std::min(min_x, static_cast<float>(pt.x));
+    max_x = std::max(max_x, static_cast<float>(pt.x));
+    min_y = std::min(min_y, static_cast<float>(pt.y));
+    max_y = std::max(max_y, static_cast<float>(pt.y));
+  }
+
+  const bool along_x = (max_x - min_x) >= (max_y - min_y);
+  const float length = along_x ? max_x - min_x : max_y - min_y;
+  const float width = along_x ? max_y - min_y : max_x - min_x;
+  const unsigned int count =
+    std::max(1u, static_cast<unsigned int>(std::ceil(length / std::max(width, 1e-3f))));
+  const float step = length / static_cast<float>(count);
+  const float radius = std::hypot(0.5f * step, 0.5f * width);
+
+  std::vector<FootprintCircle> circles;
+  circles.reserve(count);
+  for (unsigned int i = 0; i != count; i++) {
+    const float offset = (i + 0.5f) * step;
+    if (along_x) {
+      circles.push_back({min_x + offset, 0.5f * (min_y + max_y), radius});
+    } else {
+      circles.push_back({0.5f * (min_x + max_x), min_y + offset, radius});
+    }
+  }
+  return circles;
+}
+
+/**
+ * @class mppi::CostmapDistanceField
+ * @brief Distance to the nearest obstacle of the costmap, computed once per control
+ * cycle and optionally downsampled, shared by the critics needing it
+ */
+class CostmapDistanceField
+{
+public:
+  /**
+   * @brief Constructor for mppi::CostmapDistanceField
+   * @param downsampling Number of costmap cells per side of a field cell
+   */
+  explicit CostmapDistanceField(unsigned int downsampling = 1)
+  : downsampling_(std::max(1u, downsampling)) {}
+
+  /**
+   * @brief Mark the field as outdated, to be recomputed on its next use
+   */
+  void invalidate()
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    valid_ = false;
+  }
+
+  /**
+   * @brief Compute the field from the costmap if outdated. Safe to call from
+   * critics scoring concurrently.
+   * @param costmap Costmap to compute the field of, expected to be locked
+   * @param is_tracking_unknown If false, unknown cells are obstacles as well
+   */
+  void updateIfInvalid(const nav2_costmap_2d::Costmap2D & costmap, bool is_tracking_unknown)
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (valid_) {
+      return;
+    }
+    update(costmap, is_tracking_unknown);
+    valid_ = true;
+  }
+
+  /**
+   * @brief Distance to the nearest obstacle, bilinearly interpolated. Points off the
+   * field use its closest border cells.
+   * @param wx World X coord
+   * @param wy World Y coord
+   * @return Distance (m), conservative by the extent of a field cell
+   */
+  inline float distance(float wx, float wy) const
+  {
+    if (size_x_ == 0 || size_y_ == 0) {
+      return std::numeric_limits<float>::max();
+    }
+
+    const float fx = std::clamp(
+      (wx - origin_x_) / resolution_ - 0.5f, 0.0f, static_cast<float>(size_x_ - 1));
+    const float fy = std::clamp(
+      (wy - origin_y_) / resolution_ - 0.5f, 0.0f, static_cast<float>(size_y_ - 1));
+    const unsigned int x0 = static_cast<unsigned int>(fx);
+    const unsigned int y0 = static_cast<unsigned int>(fy);
+    const unsigned int x1 = std::min(x0 + 1, size_x_ - 1);
+    const unsigned int y1 = std::min(y0 + 1, size_y_ - 1);
+    const float ax = fx - x0;
+    const float ay = fy - y0;
+
+    const float top = (1.0f - ax) * at(x0, y0) + ax * at(x1, y0);
+    const float bottom = (1.0f - ax) * at(x0, y1) + ax * at(x1, y1);
+    return (1.0f - ay) * top + ay * bottom - margin_;
+  }
+
+  /**
+   * @brief Smallest clearance of circles placed at a pose
+   * @param x X of pose
+   * @param y Y of pose
+   * @param theta theta of pose
+   * @param circles Circles in the robot frame
+   * @return Smallest distance between a circle and an obstacle, negative if overlapping one
+   */
+  inline float clearance(
+    float x, float y, float theta, const std::vector<FootprintCircle> & circles) const
+  {
+    const float cos_theta = cosf(theta);
+    const float sin_theta = sinf(theta);
+    float min_clearance = std::numeric_limits<float>::max();
+    for (const auto & circle : circles) {
+      const float cx = x + circle.x * cos_theta - circle.y * sin_theta;
+      const float cy = y + circle.x * sin_theta + circle.y * cos_theta;
+      min_clearance = std::min(min_clearance, distance(cx, cy) - circle.radius);
+    }
+    return min_clearance;
+  }
+
+protected:
+  inline float at(unsigned int mx, unsigned int my) const
+  {
+    return distances_[my * size_x_ + mx];
+  }
+
+  /**
+   * @brief Exact Euclidean distance transform of the obstacle cells, by separable
+   * squared distance transforms over the columns then the rows (Felzenszwalb & Huttenlocher)
+   */
+  void update(const nav2_costmap_2d::Costmap2D & costmap, bool is_tracking_unknown)
+  {
+    const unsigned int costmap_size_x = costmap.getSizeInCellsX();
+    const unsigned int costmap_size_y = costmap.getSizeInCellsY();
+    size_x_ = (costmap_size_x + downsampling_ - 1) / downsampling_;
+    size_y_ = (costmap_size_y + downsampling_ - 1) / downsampling_;
+    resolution_ = static_cast<float>(costmap.getResolution()) * downsampling_;
+    origin_x_ = static_cast<float>(costmap.getOriginX());
+    origin_y_ = static_cast<float>(costmap.getOriginY());
+    // Obstacles may lie anywhere in their field cell and queries anywhere between
+    // the cell centers, so keep the distances conservative by half a cell diagonal
+    margin_ = resolution_ * static_cast<float>(M_SQRT1_2);
+
+    // A field cell is an obstacle if any of the costmap cells it covers is
+    const float inf = 1e20f;
+    distances_.assign(static_cast<size_t>(size_x_) * size_y_, inf);
+    const unsigned char * charmap = costmap.getCharMap();
+    for (unsigned int my = 0; my < costmap_size_y; my++) {
+      for (unsigned int mx = 0; mx < costmap_size_x; mx++) {
+        const unsigned char cost = charmap[my * costmap_size_x + mx];
+        if (cost == nav2_costmap_2d::LETHAL_OBSTACLE ||
+          (cost == nav2_costmap_2d::NO_INFORMATION && !is_tracking_unknown))
+        {
+          distances_[(my / downsampling_) * size_x_ + mx / downsampling_] = 0.0f;
+        }
+      }
+    }
+
+    const unsigned int max_size = std::max(size_x_, size_y_);
+    line_.resize(max_size);
+    line_result_.resize(max_size);
+    parabolas_.resize(max_size);
+    boundaries_.resize(max_size + 1);
+
+    for (unsigned int x = 0; x < size_x_; x++) {
+      for (unsigned int y = 0; y < size_y_; y++) {
+        line_[y] = distances_[y * size_x_ + x];
+      }
+      transformLine(size_y_);
+      for (unsigned int y = 0; y < size_y_; y++) {
+        distances_[y * size_x_ + x] = line_result_[y];
+      }
+    }
+
+    // Fields without any obstacle keep a finite distance, to stay usable in interpolation
+    const float max_distance = std::hypot(
+      static_cast<float>(size_x_), static_cast<float>(size_y_)) * resolution_;
+    for (unsigned int y = 0; y < size_y_; y++) {
+      std::copy_n(&distances_[y * size_x_], size_x_, line_.begin());
+      transformLine(size_x_);
+      for (unsigned int x = 0; x < size_x_; x++) {
+        distances_[y * size_x_ + x] =
+          std::min(std::sqrt(line_result_[x]) * resolution_, max_distance);
+      }
+    }
+  }
+
+  /**
+   * @brief 1D squared distance transform of line_ into line_result_, in cells
+   */
+  void transformLine(unsigned int size)
+  {
+    // Lower envelope of the parabolas rooted at each cell
+    unsigned int k = 0;
+    parabolas_[0] = 0;
+    boundaries_[0] = std::numeric_limits<float>::lowest();
+    boundaries_[1] = std::numeric_limits<float>::max();
+    for (unsigned int q = 1; q < size; q++) {
+      float s = intersection(q, parabolas_[k]);
+      while (s <= boundaries_[k]) {
+        k--;
+        s = intersection(q, parabolas_[k]);
+      }
+      k++;
+      parabolas_[k] = q;
+      boundaries_[k] = s;
+      boundaries_[k + 1] = std::numeric_limits<float>::max();
+    }
+
+    k = 0;
+    for (unsigned int q = 0; q < size; q++) {
+      while (boundaries_[k + 1] < static_cast<float>(q)) {
+        k++;
+      }
+      const float delta = static_cast<float>(q) - static_cast<float>(parabolas_[k]);
+      line_result_[q] = delta * delta + line_[parabolas_[k]];
+    }
+  }
+
+  /**
+   * @brief Abscissa of the intersection of the parabolas rooted at cells q and p
+   */
+  inline float intersection(unsigned int q, unsigned int p) const
+  {
+    const float fq = static_cast<float>(q), fp = static_cast<float>(p);
+    return ((line_[q] + fq * fq) - (line_[p] + fp * fp)) / (2.0f * fq - 2.0f * fp);
+  }
+
+  unsigned int downsampling_;
+  unsigned int size_x_{0}, size_y_{0};
+  float resolution_{0}, origin_x_{0}, origin_y_{0}, margin_{0};
+  std::vector<float> distances_;
+  std::vector<float> line_, line_result_, boundaries_;
+  std::vector<unsigned int> parabolas_;
+
+  std::mutex mutex_;
+  bool valid_{false};
+};
+
+}  // namespace mppi
+
+#endif  // NAV2_MPPI_CONTROLLER__TOOLS__DISTANCE_FIELD_HPP_
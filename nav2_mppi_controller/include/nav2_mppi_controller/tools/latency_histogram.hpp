@@ -0,0 +1,28 @@
+// Copyright (c) 2022 Samsung Research America, @artofnothingness Alexey Budyakov
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef NAV2_MPPI_CONTROLLER__TOOLS__LATENCY_HISTOGRAM_HPP_
+#define NAV2_MPPI_CONTROLLER__TOOLS__LATENCY_HISTOGRAM_HPP_
+
+#include "nav2_util/latency_histogram.hpp"
+
+namespace mppi
+{
+
+using LatencySummary = nav2_util::LatencySummary;
+using LatencyHistogram = nav2_util::LatencyHistogram;
+
+}  // namespace mppi
+
+#endif  // NAV2_MPPI_CONTROLLER__TOOLS__LATENCY_HISTOGRAM_HPP_
@@ -15,6 +15,8 @@
 #ifndef NAV2_MPPI_CONTROLLER__TOOLS__NOISE_GENERATOR_HPP_
 #define NAV2_MPPI_CONTROLLER__TOOLS__NOISE_GENERATOR_HPP_
 
+#include <array>
+#include <atomic>
 #include <string>
 #include <memory>
 #include <thread>
@@ -33,6 +35,7 @@
 #include "nav2_mppi_controller/tools/parameters_handler.hpp"
 #include "nav2_mppi_controller/models/control_sequence.hpp"
 #include "nav2_mppi_controller/models/state.hpp"
+#include "nav2_util/thread_pool.hpp"
 
 namespace mppi
 {
@@ -72,7 +75,9 @@ public:
   void generateNextNoises();
 
   /**
-   * @brief set noised control_sequence to state controls
+   * @brief set noised control_sequence to state controls. Uses the latest
+   * noises published by the noise thread without waiting on it, or the
+   * previous ones if no new noises are ready yet
    * @return noises vx, vy, wz
    */
   void setNoisedControls(models::State & state, const models::ControlSequence & control_sequence);
@@ -99,16 +104,45 @@ protected:
    */
   void generateNoisedControls();
 
-  xt::xtensor<float, 2> noises_vx_;
-  xt::xtensor<float, 2> noises_vy_;
-  xt::xtensor<float, 2> noises_wz_;
+  /**
+   * @brief Fill each row of the noises of an axis from its own Philox stream,
+   * so that rows can be generated in any order or concurrently
+   * @param noises Noises of the axis, of shape [batch_size, time_steps]
+   * @param stddev Standard deviation of the noises
+   * @param axis Index of the axis, to use distinct streams per axis
+   */
+  void generateAxisNoises(xt::xtensor<float, 2> & noises, float stddev, uint32_t axis);
+
+  /**
+   * @brief Noises of one iteration
+   */
+  struct Noises
+  {
+    xt::xtensor<float, 2> vx;
+    xt::xtensor<float, 2> vy;
+    xt::xtensor<float, 2> wz;
+  };
+
+  // Triple buffer of noises: the generator fills the back set and the optimizer
+  // reads the front set, each exchanging its own with the middle set to hand them over
+  static constexpr unsigned int fresh_noises_flag_ = 4;
+  std::array<Noises, 3> noises_;
+  unsigned int front_noises_{0};
+  unsigned int back_noises_{1};
+  std::atomic<unsigned int> middle_noises_{2};
 
   mppi::models::OptimizerSettings settings_;
   bool is_holonomic_;
 
+  int noise_seed_{0};
+  uint32_t noise_generation_{0};
+  int noise_threads_{1};
+  std::unique_ptr<nav2_util::ThreadPool> noise_pool_;
+
   std::thread noise_thread_;
   std::condition_variable noise_cond_;
   std::mutex noise_lock_;
+  std::mutex generate_lock_;
   bool active_{false}, ready_{false}, regenerate_noises_{false};
 };
 
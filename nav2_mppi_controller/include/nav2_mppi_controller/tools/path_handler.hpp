@@ -24,7 +24,9 @@
 
 #include "rclcpp_lifecycle/lifecycle_node.hpp"
 #include "tf2_ros/buffer.h"
+#include "tf2_geometry_msgs/tf2_geometry_msgs.hpp"
 #include "geometry_msgs/msg/pose_stamped.hpp"
+#include "geometry_msgs/msg/transform_stamped.hpp"
 #include "nav_msgs/msg/path.hpp"
 #include "builtin_interfaces/msg/time.hpp"
 #include "nav2_costmap_2d/costmap_2d_ros.hpp"
@@ -102,6 +104,17 @@ protected:
     const std::string & frame, const geometry_msgs::msg::PoseStamped & in_pose,
     geometry_msgs::msg::PoseStamped & out_pose) const;
 
+  /**
+    * @brief Lookup the transform from the plan frame to another frame
+    * @param frame Frame to transform to
+    * @param stamp Time of the transform
+    * @param transform Output transform
+    * @return Bool if successful
+    */
+  bool lookupPlanTransform(
+    const std::string & frame, const builtin_interfaces::msg::Time & stamp,
+    geometry_msgs::msg::TransformStamped & transform) const;
+
   /**
     * @brief Get largest dimension of costmap (radially)
     * @return Max distance from center of costmap to edge
@@ -132,6 +145,14 @@ protected:
     */
   void prunePlan(nav_msgs::msg::Path & plan, const PathIterator end);
 
+  /**
+    * @brief Prune the poses of the plan up to inversion before a pose. Poses are only
+    * erased once they make up most of the plan, to keep long plans from being
+    * shifted on every cycle.
+    * @param end Final path iterator
+    */
+  void prunePlanUpToInversion(const PathIterator end);
+
   /**
     * @brief Check if the robot pose is within the set inversion tolerances
     * @param robot_pose Robot's current pose to check
@@ -146,6 +167,8 @@ protected:
 
   nav_msgs::msg::Path global_plan_;
   nav_msgs::msg::Path global_plan_up_to_inversion_;
+  // Number of leading poses of global_plan_up_to_inversion_ already pruned
+  size_t pruned_poses_{0};
   rclcpp::Logger logger_{rclcpp::get_logger("MPPIController")};
 
   double max_robot_pose_search_dist_{0};
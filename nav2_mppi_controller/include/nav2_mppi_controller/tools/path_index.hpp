@@ -0,0 +1,204 @@
+// Copyright (c) 2024 Open Navigation LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef NAV2_MPPI_CONTROLLER__TOOLS__PATH_INDEX_HPP_
+#define NAV2_MPPI_CONTROLLER__TOOLS__PATH_INDEX_HPP_
+
+#include <algorithm>
+#include <cmath>
+#include <initializer_list>
+#include <limits>
+#include <mutex>
+#include <vector>
+
+#include "nav2_mppi_controller/models/path.hpp"
+
+namespace mppi
+{
+
+/**
+ * @class mppi::PathSpatialIndex
+ * @brief Uniform grid of buckets over the points of the path, built once per control
+ * cycle and shared by the critics looking up the path points closest to trajectories,
+ * so that lookups do not scan the whole path
+ */
+class PathSpatialIndex
+{
+public:
+  /**
+   * @brief Constructor for mppi::PathSpatialIndex
+   * @param cell_size Size of the side of a bucket (m)
+   */
+  explicit PathSpatialIndex(float cell_size)
+  : cell_size_(std::max(cell_size, 1e-3f)) {}
+
+  /**
+   * @brief Mark the index as outdated, to be rebuilt on its next use
+   */
+  void invalidate()
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    valid_ = false;
+  }
+
+  /**
+   * @brief Build the index over the path if outdated. Safe to call from
+   * critics scoring concurrently.
+   * @param path Path to index
+   */
+  void updateIfInvalid(const models::Path & path)
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (valid_) {
+      return;
+    }
+    update(path);
+    valid_ = true;
+  }
+
+  /**
+   * @brief Find the path point closest to a position, among the points from an index on.
+   * Ties are broken towards the smallest index, as a linear scan of the path would.
+   * @param path Path the index was built over
+   * @param x X of the position
+   * @param y Y of the position
+   * @param first Index of the first path point to consider, less than the path size
+   * @return Index of the closest path point
+   */
+  size_t findClosest(const models::Path & path, float x, float y, size_t first) const
+  {
+    const int cx = std::clamp(cellX(x), 0, size_x_ - 1);
+    const int cy = std::clamp(cellY(y), 0, size_y_ - 1);
+    size_t best = first;
+    float best_dist = std::numeric_limits<float>::max();
+
+    auto check_cell = [&](int i, int j) {
+        const unsigned int cell = static_cast<unsigned int>(j * size_x_ + i);
+        for (unsigned int k = cell_starts_[cell]; k != cell_starts_[cell + 1]; k++) {
+          const size_t idx = points_[k];
+          if (idx < first) {
+            continue;
+          }
+          const float dx = path.x(idx) - x;
+          const float dy = path.y(idx) - y;
+          const float dist = dx * dx + dy * dy;
+          if (dist < best_dist || (dist == best_dist && idx < best)) {
+            best_dist = dist;
+            best = idx;
+          }
+        }
+      };
+
+    // Points of ring r are at least (r - 1) cells away, also when the position is off
+    // the grid and clamped to its border
+    const int max_ring = std::max(size_x_, size_y_);
+    for (int r = 0; r <= max_ring; r++) {
+      if (r > 1) {
+        const float min_dist = (r - 1) * cell_size_;
+        if (min_dist * min_dist > best_dist) {
+          break;
+        }
+      }
+
+      // Rows of the ring, then its columns between them
+      const int min_i = std::max(cx - r, 0), max_i = std::min(cx + r, size_x_ - 1);
+      for (const int j : {cy - r, cy + r}) {
+        if (j >= 0 && j < size_y_) {
+          for (int i = min_i; i <= max_i; i++) {
+            check_cell(i, j);
+          }
+        }
+        if (r == 0) {
+          break;
+        }
+      }
+      const int min_j = std::max(cy - r + 1, 0), max_j = std::min(cy + r - 1, size_y_ - 1);
+      for (const int i : {cx - r, cx + r}) {
+        if (r > 0 && i >= 0 && i < size_x_) {
+          for (int j = min_j; j <= max_j; j++) {
+            check_cell(i, j);
+          }
+        }
+      }
+    }
+    return best;
+  }
+
+protected:
+  inline int cellX(float x) const
+  {
+    return static_cast<int>(std::floor((x - origin_x_) / cell_size_));
+  }
+
+  inline int cellY(float y) const
+  {
+    return static_cast<int>(std::floor((y - origin_y_) / cell_size_));
+  }
+
+  /**
+   * @brief Bucket the path points by cell, each cell listing its points contiguously
+   */
+  void update(const models::Path & path)
+  {
+    const size_t size = path.x.shape(0);
+    if (size == 0) {
+      size_x_ = size_y_ = 1;
+      cell_starts_.assign(2, 0u);
+      points_.clear();
+      return;
+    }
+
+    float min_x = path.x(0), max_x = path.x(0), min_y = path.y(0), max_y = path.y(0);
+    for (size_t i = 1; i < size; i++) {
+      min_x = std::min(min_x, path.x(i));
+      max_x = std::max(max_x, path.x(i));
+      min_y = std::min(min_y, path.y(i));
+      max_y = std::max(max_y, path.y(i));
+    }
+    origin_x_ = min_x;
+    origin_y_ = min_y;
+    size_x_ = cellX(max_x) + 1;
+    size_y_ = cellY(max_y) + 1;
+
+    cell_starts_.assign(static_cast<size_t>(size_x_) * size_y_ + 1, 0u);
+    cells_.resize(size);
+    for (size_t i = 0; i < size; i++) {
+      cells_[i] = static_cast<unsigned int>(cellY(path.y(i)) * size_x_ + cellX(path.x(i)));
+      cell_starts_[cells_[i] + 1]++;
+    }
+    for (size_t c = 1; c < cell_starts_.size(); c++) {
+      cell_starts_[c] += cell_starts_[c - 1];
+    }
+
+    // Points in increasing index order within each cell
+    points_.resize(size);
+    fill_.assign(cell_starts_.begin(), cell_starts_.end() - 1);
+    for (size_t i = 0; i < size; i++) {
+      points_[fill_[cells_[i]]++] = static_cast<unsigned int>(i);
+    }
+  }
+
+  float cell_size_;
+  float origin_x_{0.0f}, origin_y_{0.0f};
+  int size_x_{1}, size_y_{1};
+  std::vector<unsigned int> cell_starts_{0u, 0u};
+  std::vector<unsigned int> points_;
+  std::vector<unsigned int> cells_, fill_;
+  bool valid_{false};
+  std::mutex mutex_;
+};
+
+}  // namespace mppi
+
+#endif  // NAV2_MPPI_CONTROLLER__TOOLS__PATH_INDEX_HPP_
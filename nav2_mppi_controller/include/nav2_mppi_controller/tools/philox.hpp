@@ -0,0 +1,96 @@
+// Copyright (c) 2024 Open Navigation LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef NAV2_MPPI_CONTROLLER__TOOLS__PHILOX_HPP_
+#define NAV2_MPPI_CONTROLLER__TOOLS__PHILOX_HPP_
+
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+
+namespace mppi::utils
+{
+
+using PhiloxCounter = std::array<uint32_t, 4>;
+using PhiloxKey = std::array<uint32_t, 2>;
+
+/**
+ * @brief Philox4x32-10 counter based random number generator (Salmon et al.,
+ * "Parallel random numbers: as easy as 1, 2, 3"). The output only depends on
+ * the counter and the key, so any block of a random stream can be generated
+ * independently of the others.
+ * @param counter Counter of the block to generate
+ * @param key Key, i.e. seed, of the stream
+ * @return 4 uniformly distributed 32 bit integers
+ */
+inline PhiloxCounter philox4x32(PhiloxCounter counter, PhiloxKey key)
+{
+  constexpr uint32_t m0 = 0xD2511F53, m1 = 0xCD9E8D57;
+  constexpr uint32_t w0 = 0x9E3779B9, w1 = 0xBB67AE85;
+
+  for (unsigned int round = 0; round != 10; round++) {
+    const uint64_t product0 = static_cast<uint64_t>(m0) * counter[0];
+    const uint64_t product1 = static_cast<uint64_t>(m1) * counter[2];
+    counter = {
+      static_cast<uint32_t>(product1 >> 32) ^ counter[1] ^ key[0],
+      static_cast<uint32_t>(product1),
+      static_cast<uint32_t>(product0 >> 32) ^ counter[3] ^ key[1],
+      static_cast<uint32_t>(product0)};
+    key[0] += w0;
+    key[1] += w1;
+  }
+  return counter;
+}
+
+/**
+ * @brief Fill a buffer with normally distributed values from the Philox stream
+ * of a key, using the Box-Muller transform. Values are generated 4 at a time
+ * from the counters {block, subsequence[0], subsequence[1], subsequence[2]}.
+ * @param out Buffer to fill
+ * @param size Number of values to fill
+ * @param stddev Standard deviation of the values, with mean 0
+ * @param subsequence Identifier of the stream to use, e.g. row and axis
+ * @param key Key, i.e. seed, of the stream
+ */
+inline void fillNormal(
+  float * out, size_t size, float stddev,
+  const std::array<uint32_t, 3> & subsequence, const PhiloxKey & key)
+{
+  constexpr float two_pi = 6.28318530717958647692f;
+  constexpr float to_unit = 2.3283064365386963e-10f;  // 2^-32
+
+  for (size_t i = 0; i < size; i += 4) {
+    const PhiloxCounter bits = philox4x32(
+      {static_cast<uint32_t>(i / 4), subsequence[0], subsequence[1], subsequence[2]}, key);
+
+    float normals[4];
+    for (unsigned int j = 0; j != 4; j += 2) {
+      // Shifted by half a step to lie in (0, 1) so that the log is finite
+      const float u1 = (static_cast<float>(bits[j]) + 0.5f) * to_unit;
+      const float u2 = (static_cast<float>(bits[j + 1]) + 0.5f) * to_unit;
+      const float radius = stddev * sqrtf(-2.0f * logf(u1));
+      normals[j] = radius * cosf(two_pi * u2);
+      normals[j + 1] = radius * sinf(two_pi * u2);
+    }
+
+    for (size_t j = 0; j != 4 && i + j < size; j++) {
+      out[i + j] = normals[j];
+    }
+  }
+}
+
+}  // namespace mppi::utils
+
+#endif  // NAV2_MPPI_CONTROLLER__TOOLS__PHILOX_HPP_
@@ -76,13 +76,13 @@ public:
   void on_deactivate();
 
   /**
-    * @brief Add an optimal trajectory to visualize
+    * @brief Add an optimal trajectory to visualize, as a single line strip marker
     * @param trajectory Optimal trajectory
     */
   void add(const xt::xtensor<float, 2> & trajectory, const std::string & marker_namespace);
 
   /**
-    * @brief Add candidate trajectories to visualize
+    * @brief Add candidate trajectories to visualize, as a line strip marker each
     * @param trajectories Candidate trajectories
     */
   void add(const models::Trajectories & trajectories, const std::string & marker_namespace);
@@ -99,12 +99,29 @@ public:
   void reset();
 
 protected:
+  /**
+    * @brief Get the next line strip marker of the message to publish, reusing the
+    * markers and point buffers of the previous cycles
+    * @param marker_namespace Namespace of the marker
+    * @param width Width of the line
+    * @return Marker, without points
+    */
+  visualization_msgs::msg::Marker & nextMarker(
+    const std::string & marker_namespace, double width);
+
+  /**
+    * @brief Whether the trajectories are subscribed to, so worth building
+    */
+  bool isSubscribed() const;
+
   std::string frame_id_;
   std::shared_ptr<rclcpp_lifecycle::LifecyclePublisher<visualization_msgs::msg::MarkerArray>>
   trajectories_publisher_;
   std::shared_ptr<rclcpp_lifecycle::LifecyclePublisher<nav_msgs::msg::Path>> transformed_path_pub_;
 
-  std::unique_ptr<visualization_msgs::msg::MarkerArray> points_;
+  // Markers kept across cycles, of which the first markers_used_ are to publish
+  visualization_msgs::msg::MarkerArray points_;
+  size_t markers_used_{0};
   int marker_id_ = 0;
 
   ParametersHandler * parameters_handler_;
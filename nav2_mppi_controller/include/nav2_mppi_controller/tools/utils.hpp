@@ -309,6 +309,21 @@ auto shortest_angular_distance(
  */
 inline size_t findPathFurthestReachedPoint(const CriticData & data)
 {
+  if (data.path_index && data.path.x.shape(0) > 0) {
+    // Same search as below, the index only visiting the path points near each trajectory
+    data.path_index->updateIfInvalid(data.path);
+    const size_t last = data.trajectories.x.shape(1) - 1;
+    size_t max_id_by_trajectories = 0;
+    for (size_t i = 0; i < data.trajectories.x.shape(0); i++) {
+      max_id_by_trajectories = std::max(
+        max_id_by_trajectories,
+        data.path_index->findClosest(
+          data.path, data.trajectories.x(i, last), data.trajectories.y(i, last),
+          max_id_by_trajectories));
+    }
+    return max_id_by_trajectories;
+  }
+
   const auto traj_x = xt::view(data.trajectories.x, xt::all(), -1, xt::newaxis());
   const auto traj_y = xt::view(data.trajectories.y, xt::all(), -1, xt::newaxis());
 
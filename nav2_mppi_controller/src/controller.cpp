@@ -45,6 +45,19 @@ void MPPIController::configure(
     parent_, name_,
     costmap_ros_->getGlobalFrameID(), parameters_handler_.get());
 
+  if (optimizer_.isAdaptiveSampling()) {
+    batch_size_pub_ = node->create_publisher<std_msgs::msg::UInt32>(name_ + "/batch_size", 1);
+  }
+
+  if (optimizer_.isLatencyInstrumented()) {
+    double latency_publish_rate;
+    std::string latency_topic;
+    getParam(latency_publish_rate, "latency_publish_rate", 1.0, ParameterType::Static);
+    getParam(latency_topic, "latency_topic", name_ + "/latency", ParameterType::Static);
+    latency_publish_period_ = latency_publish_rate > 0.0 ? 1.0 / latency_publish_rate : 0.0;
+    latency_pub_ = node->create_publisher<nav2_msgs::msg::ControllerLatency>(latency_topic, 1);
+  }
+
   RCLCPP_INFO(logger_, "Configured MPPI Controller: %s", name_.c_str());
 }
 
@@ -52,6 +65,8 @@ void MPPIController::cleanup()
 {
   optimizer_.shutdown();
   trajectory_visualizer_.on_cleanup();
+  batch_size_pub_.reset();
+  latency_pub_.reset();
   parameters_handler_.reset();
   RCLCPP_INFO(logger_, "Cleaned up MPPI Controller: %s", name_.c_str());
 }
@@ -59,6 +74,13 @@ void MPPIController::cleanup()
 void MPPIController::activate()
 {
   trajectory_visualizer_.on_activate();
+  if (batch_size_pub_) {
+    batch_size_pub_->on_activate();
+  }
+  if (latency_pub_) {
+    latency_pub_->on_activate();
+    last_latency_publish_ = std::chrono::steady_clock::now();
+  }
   parameters_handler_->start();
   RCLCPP_INFO(logger_, "Activated MPPI Controller: %s", name_.c_str());
 }
@@ -66,6 +88,12 @@ void MPPIController::activate()
 void MPPIController::deactivate()
 {
   trajectory_visualizer_.on_deactivate();
+  if (batch_size_pub_) {
+    batch_size_pub_->on_deactivate();
+  }
+  if (latency_pub_) {
+    latency_pub_->on_deactivate();
+  }
   RCLCPP_INFO(logger_, "Deactivated MPPI Controller: %s", name_.c_str());
 }
 
@@ -82,6 +110,7 @@ geometry_msgs::msg::TwistStamped MPPIController::computeVelocityCommands(
 #ifdef BENCHMARK_TESTING
   auto start = std::chrono::system_clock::now();
 #endif
+  const auto cycle_start = std::chrono::steady_clock::now();
 
   std::lock_guard<std::mutex> param_lock(*parameters_handler_->getLock());
   nav_msgs::msg::Path transformed_plan = path_handler_.transformPath(robot_pose);
@@ -102,6 +131,16 @@ geometry_msgs::msg::TwistStamped MPPIController::computeVelocityCommands(
     visualize(std::move(transformed_plan));
   }
 
+  if (batch_size_pub_ && batch_size_pub_->get_subscription_count() > 0) {
+    auto batch_size = std::make_unique<std_msgs::msg::UInt32>();
+    batch_size->data = optimizer_.getBatchSize();
+    batch_size_pub_->publish(std::move(batch_size));
+  }
+
+  if (latency_pub_) {
+    publishLatencies(cycle_start);
+  }
+
   return cmd;
 }
 
@@ -112,6 +151,40 @@ void MPPIController::visualize(nav_msgs::msg::Path transformed_plan)
   trajectory_visualizer_.visualize(std::move(transformed_plan));
 }
 
+void MPPIController::publishLatencies(const std::chrono::steady_clock::time_point & cycle_start)
+{
+  const auto now = std::chrono::steady_clock::now();
+  cycle_latency_.record(std::chrono::duration<double>(now - cycle_start).count());
+  if (std::chrono::duration<double>(now - last_latency_publish_).count() <
+    latency_publish_period_)
+  {
+    return;
+  }
+  last_latency_publish_ = now;
+
+  latencies_.clear();
+  latencies_.emplace_back("cycle", cycle_latency_.collect());
+  optimizer_.collectLatencies(latencies_);
+  if (latency_pub_->get_subscription_count() == 0) {
+    return;
+  }
+
+  auto msg = std::make_unique<nav2_msgs::msg::ControllerLatency>();
+  msg->header.stamp = parent_.lock()->now();
+  msg->stages.reserve(latencies_.size());
+  for (const auto & [stage_name, summary] : latencies_) {
+    nav2_msgs::msg::StageLatency stage;
+    stage.name = stage_name;
+    stage.count = summary.count;
+    stage.mean_ms = summary.mean_ms;
+    stage.p50_ms = summary.p50_ms;
+    stage.p99_ms = summary.p99_ms;
+    stage.max_ms = summary.max_ms;
+    msg->stages.push_back(std::move(stage));
+  }
+  latency_pub_->publish(std::move(msg));
+}
+
 void MPPIController::setPlan(const nav_msgs::msg::Path & path)
 {
   path_handler_.setPath(path);
@@ -30,6 +30,15 @@ void CriticManager::on_configure(
 
   getParams();
   loadCritics();
+  critic_latencies_ = std::vector<LatencyHistogram>(
+    latency_instrumentation_ ? critics_.size() : 0);
+
+  thread_pool_.reset();
+  if (critic_threads_ > 1) {
+    // The calling thread runs critics as well
+    thread_pool_ = std::make_unique<nav2_util::ThreadPool>(
+      static_cast<unsigned int>(critic_threads_ - 1));
+  }
 }
 
 void CriticManager::getParams()
@@ -37,6 +46,8 @@ void CriticManager::getParams()
   auto node = parent_.lock();
   auto getParam = parameters_handler_->getParamGetter(name_);
   getParam(critic_names_, "critics", std::vector<std::string>{}, ParameterType::Static);
+  getParam(critic_threads_, "critic_threads", 1, ParameterType::Static);
+  getParam(latency_instrumentation_, "latency_instrumentation", false, ParameterType::Static);
 }
 
 void CriticManager::loadCritics()
@@ -67,11 +78,81 @@ std::string CriticManager::getFullName(const std::string & name)
 void CriticManager::evalTrajectoriesScores(
   CriticData & data) const
 {
-  for (const auto & critic : critics_) {
+  if (thread_pool_ && critics_.size() > 1) {
+    evalTrajectoriesScoresParallel(data);
+    return;
+  }
+
+  for (size_t i = 0; i < critics_.size(); ++i) {
     if (data.fail_flag) {
       break;
     }
-    critic->score(data);
+    scoreCritic(i, data);
+  }
+}
+
+void CriticManager::scoreCritic(size_t index, CriticData & data) const
+{
+  if (!latency_instrumentation_) {
+    critics_[index]->score(data);
+    return;
+  }
+
+  const auto start = std::chrono::steady_clock::now();
+  critics_[index]->score(data);
+  critic_latencies_[index].recordSince(start);
+}
+
+void CriticManager::evalTrajectoriesScoresParallel(
+  CriticData & data) const
+{
+  if (data.fail_flag) {
+    return;
+  }
+
+  // The path data is lazily shared between critics, so set it before they run concurrently
+  if (data.path.x.shape(0) >= 2) {
+    if (data.path_index) {
+      data.path_index->updateIfInvalid(data.path);
+    }
+    utils::setPathFurthestPointIfNotSet(data);
+    utils::setPathCostsIfNotSet(data, costmap_ros_);
+  }
+
+  critic_costs_.resize(critics_.size());
+  critic_fail_flags_.assign(critics_.size(), 0);
+
+  thread_pool_->parallelFor(
+    0, critics_.size(), [&](size_t i) {
+      xt::xtensor<float, 1> & costs = critic_costs_[i];
+      costs = xt::zeros<float>(data.costs.shape());
+      CriticData critic_data =
+      {data.state, data.trajectories, data.path, costs, data.model_dt, false,
+        data.goal_checker, data.motion_model, data.path_pts_valid,
+        data.furthest_reached_path_point, data.distance_field, data.path_index};
+      scoreCritic(i, critic_data);
+      critic_fail_flags_[i] = critic_data.fail_flag;
+    });
+
+  // Reduce in critic order so that the result does not depend on the scheduling
+  for (size_t i = 0; i < critics_.size(); ++i) {
+    data.costs += critic_costs_[i];
+    data.fail_flag = data.fail_flag || critic_fail_flags_[i];
+  }
+}
+
+const std::vector<std::string> & CriticManager::getCriticNames() const
+{
+  return critic_names_;
+}
+
+void CriticManager::collectLatencies(
+  std::vector<std::pair<std::string, LatencySummary>> & latencies)
+{
+  for (size_t i = 0; i < critic_latencies_.size(); ++i) {
+    latencies.emplace_back(
+      i < critic_names_.size() ? critic_names_[i] : "critic_" + std::to_string(i),
+      critic_latencies_[i].collect());
   }
 }
 
@@ -30,6 +30,7 @@ void CostCritic::initialize()
   getParam(near_goal_distance_, "near_goal_distance", 0.5f);
   getParam(inflation_layer_name_, "inflation_layer_name", std::string(""));
   getParam(trajectory_point_step_, "trajectory_point_step", 2);
+  getParam(use_distance_field_, "use_distance_field", false);
 
   // Normalized by cost value to put in same regime as other weights
   weight_ /= 254.0f;
@@ -110,12 +111,21 @@ void CostCritic::score(CriticData & data)
   resolution_ = static_cast<float>(costmap->getResolution());
   size_x_ = costmap->getSizeInCellsX();
   size_y_ = costmap->getSizeInCellsY();
+  const nav2_costmap_2d::CostmapView view(*costmap);
 
   if (consider_footprint_) {
     // footprint may have changed since initialization if user has dynamic footprints
     possible_collision_cost_ = findCircumscribedCost(costmap_ros_);
   }
 
+  // Footprint collisions are checked against the shared distance field
+  distance_field_ = nullptr;
+  if (use_distance_field_ && consider_footprint_ && data.distance_field) {
+    data.distance_field->updateIfInvalid(*costmap, is_tracking_unknown_);
+    distance_field_ = data.distance_field.get();
+    footprint_circles_ = approximateFootprintWithCircles(costmap_ros_->getRobotFootprint());
+  }
+
   // If near the goal, don't apply the preferential term since the goal is near obstacles
   bool near_goal = false;
   if (utils::withinPositionGoalTolerance(near_goal_distance_, data.state.pose.pose, data.path)) {
@@ -155,7 +165,7 @@ void CostCritic::score(CriticData & data)
         }
         pose_cost = 255.0f;  // NO_INFORMATION in float
       } else {
-        pose_cost = static_cast<float>(costmap->getCost(getIndex(x_i, y_i)));
+        pose_cost = static_cast<float>(view(x_i, y_i));
         if (pose_cost < 1.0f) {
           continue;  // In free space
         }
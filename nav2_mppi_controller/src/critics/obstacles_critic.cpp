@@ -30,6 +30,7 @@ void ObstaclesCritic::initialize()
   getParam(collision_margin_distance_, "collision_margin_distance", 0.10f);
   getParam(near_goal_distance_, "near_goal_distance", 0.5f);
   getParam(inflation_layer_name_, "inflation_layer_name", std::string(""));
+  getParam(use_distance_field_, "use_distance_field", false);
 
   collision_checker_.setCostmap(costmap_);
   possible_collision_cost_ = findCircumscribedCost(costmap_ros_);
@@ -120,6 +121,14 @@ void ObstaclesCritic::score(CriticData & data)
     near_goal = true;
   }
 
+  // Distances are looked up from the shared distance field rather than recovered from costs
+  const bool use_distance_field = use_distance_field_ && data.distance_field;
+  if (use_distance_field) {
+    data.distance_field->updateIfInvalid(
+      *costmap_, costmap_ros_->getLayeredCostmap()->isTrackingUnknown());
+    setFootprintCircles();
+  }
+
   auto && raw_cost = xt::xtensor<float, 1>::from_shape({data.costs.shape(0)});
   auto && repulsive_cost = xt::xtensor<float, 1>::from_shape({data.costs.shape(0)});
 
@@ -134,21 +143,45 @@ void ObstaclesCritic::score(CriticData & data)
     repulsive_cost[i] = 0.0f;
 
     for (size_t j = 0; j < traj_len; j++) {
-      pose_cost = costAtPose(traj.x(i, j), traj.y(i, j), traj.yaws(i, j));
-      if (pose_cost.cost < 1.0f) {continue;}  // In free space
-
-      if (inCollision(pose_cost.cost)) {
-        trajectory_collide = true;
-        break;
+      float dist_to_obj;
+      if (use_distance_field) {
+        unsigned int x_i, y_i;
+        if (!collision_checker_.worldToMap(traj.x(i, j), traj.y(i, j), x_i, y_i)) {
+          if (inCollision(nav2_costmap_2d::NO_INFORMATION)) {
+            trajectory_collide = true;
+            break;
+          }
+          continue;
+        }
+
+        dist_to_obj = data.distance_field->clearance(
+          traj.x(i, j), traj.y(i, j), traj.yaws(i, j), footprint_circles_);
+        if (dist_to_obj <= 0.0f) {
+          trajectory_collide = true;
+          break;
+        }
+
+        // Cannot process repulsion if inflation layer does not exist
+        if (dist_to_obj >= inflation_radius_ || inflation_scale_factor_ == 0.0f) {
+          continue;  // In free space
+        }
+      } else {
+        pose_cost = costAtPose(traj.x(i, j), traj.y(i, j), traj.yaws(i, j));
+        if (pose_cost.cost < 1.0f) {continue;}  // In free space
+
+        if (inCollision(pose_cost.cost)) {
+          trajectory_collide = true;
+          break;
+        }
+
+        // Cannot process repulsion if inflation layer does not exist
+        if (inflation_radius_ == 0.0f || inflation_scale_factor_ == 0.0f) {
+          continue;
+        }
+
+        dist_to_obj = distanceToObstacle(pose_cost);
       }
 
-      // Cannot process repulsion if inflation layer does not exist
-      if (inflation_radius_ == 0.0f || inflation_scale_factor_ == 0.0f) {
-        continue;
-      }
-
-      const float dist_to_obj = distanceToObstacle(pose_cost);
-
       // Let near-collision trajectory points be punished severely
       if (dist_to_obj < collision_margin_distance_) {
         traj_cost += (collision_margin_distance_ - dist_to_obj);
@@ -205,6 +238,17 @@ bool ObstaclesCritic::inCollision(float cost) const
   return false;
 }
 
+void ObstaclesCritic::setFootprintCircles()
+{
+  // The circular check considers the robot's inscribed circle, as the costmap costs do
+  if (consider_footprint_) {
+    footprint_circles_ = approximateFootprintWithCircles(costmap_ros_->getRobotFootprint());
+  } else {
+    footprint_circles_ = {{0.0f, 0.0f,
+        static_cast<float>(costmap_ros_->getLayeredCostmap()->getInscribedRadius())}};
+  }
+}
+
 CollisionCost ObstaclesCritic::costAtPose(float x, float y, float theta)
 {
   CollisionCost collision_cost;
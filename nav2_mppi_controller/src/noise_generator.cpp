@@ -17,9 +17,10 @@
 #include <memory>
 #include <mutex>
 #include <xtensor/xmath.hpp>
-#include <xtensor/xrandom.hpp>
 #include <xtensor/xnoalias.hpp>
 
+#include "nav2_mppi_controller/tools/philox.hpp"
+
 namespace mppi
 {
 
@@ -33,6 +34,16 @@ void NoiseGenerator::initialize(
 
   auto getParam = param_handler->getParamGetter(name);
   getParam(regenerate_noises_, "regenerate_noises", false);
+  getParam(noise_seed_, "noise_seed", 0);
+  getParam(noise_threads_, "noise_threads", 1);
+  noise_generation_ = 0;
+
+  noise_pool_.reset();
+  if (noise_threads_ > 1) {
+    // The generating thread fills rows as well
+    noise_pool_ = std::make_unique<nav2_util::ThreadPool>(
+      static_cast<unsigned int>(noise_threads_ - 1));
+  }
 
   if (regenerate_noises_) {
     noise_thread_ = std::thread(std::bind(&NoiseGenerator::noiseThread, this));
@@ -66,11 +77,15 @@ void NoiseGenerator::setNoisedControls(
   models::State & state,
   const models::ControlSequence & control_sequence)
 {
-  std::unique_lock<std::mutex> guard(noise_lock_);
+  if (middle_noises_.load(std::memory_order_acquire) & fresh_noises_flag_) {
+    front_noises_ =
+      middle_noises_.exchange(front_noises_, std::memory_order_acq_rel) & ~fresh_noises_flag_;
+  }
 
-  xt::noalias(state.cvx) = control_sequence.vx + noises_vx_;
-  xt::noalias(state.cvy) = control_sequence.vy + noises_vy_;
-  xt::noalias(state.cwz) = control_sequence.wz + noises_wz_;
+  const Noises & noises = noises_[front_noises_];
+  xt::noalias(state.cvx) = control_sequence.vx + noises.vx;
+  xt::noalias(state.cvy) = control_sequence.vy + noises.vy;
+  xt::noalias(state.cwz) = control_sequence.wz + noises.wz;
 }
 
 void NoiseGenerator::reset(mppi::models::OptimizerSettings & settings, bool is_holonomic)
@@ -79,11 +94,20 @@ void NoiseGenerator::reset(mppi::models::OptimizerSettings & settings, bool is_h
   is_holonomic_ = is_holonomic;
 
   // Recompute the noises on reset, initialization, and fallback
+  {
+    std::unique_lock<std::mutex> generate_guard(generate_lock_);
+    for (auto & noises : noises_) {
+      xt::noalias(noises.vx) = xt::zeros<float>({settings_.batch_size, settings_.time_steps});
+      xt::noalias(noises.vy) = xt::zeros<float>({settings_.batch_size, settings_.time_steps});
+      xt::noalias(noises.wz) = xt::zeros<float>({settings_.batch_size, settings_.time_steps});
+    }
+    front_noises_ = 0;
+    back_noises_ = 1;
+    middle_noises_.store(2, std::memory_order_release);
+  }
+
   {
     std::unique_lock<std::mutex> guard(noise_lock_);
-    xt::noalias(noises_vx_) = xt::zeros<float>({settings_.batch_size, settings_.time_steps});
-    xt::noalias(noises_vy_) = xt::zeros<float>({settings_.batch_size, settings_.time_steps});
-    xt::noalias(noises_wz_) = xt::zeros<float>({settings_.batch_size, settings_.time_steps});
     ready_ = true;
   }
 
@@ -97,28 +121,57 @@ void NoiseGenerator::reset(mppi::models::OptimizerSettings & settings, bool is_h
 void NoiseGenerator::noiseThread()
 {
   do {
-    std::unique_lock<std::mutex> guard(noise_lock_);
-    noise_cond_.wait(guard, [this]() {return ready_;});
-    ready_ = false;
+    {
+      std::unique_lock<std::mutex> guard(noise_lock_);
+      noise_cond_.wait(guard, [this]() {return ready_;});
+      ready_ = false;
+    }
+    // Generated outside of the lock, so the optimizer does not wait on it
     generateNoisedControls();
   } while (active_);
 }
 
 void NoiseGenerator::generateNoisedControls()
 {
+  std::unique_lock<std::mutex> generate_guard(generate_lock_);
   auto & s = settings_;
+  Noises & noises = noises_[back_noises_];
 
-  xt::noalias(noises_vx_) = xt::random::randn<float>(
-    {s.batch_size, s.time_steps}, 0.0f,
-    s.sampling_std.vx);
-  xt::noalias(noises_wz_) = xt::random::randn<float>(
-    {s.batch_size, s.time_steps}, 0.0f,
-    s.sampling_std.wz);
+  noises.vx.resize({s.batch_size, s.time_steps});
+  noises.wz.resize({s.batch_size, s.time_steps});
+  generateAxisNoises(noises.vx, s.sampling_std.vx, 0);
+  generateAxisNoises(noises.wz, s.sampling_std.wz, 1);
   if (is_holonomic_) {
-    xt::noalias(noises_vy_) = xt::random::randn<float>(
-      {s.batch_size, s.time_steps}, 0.0f,
-      s.sampling_std.vy);
+    noises.vy.resize({s.batch_size, s.time_steps});
+    generateAxisNoises(noises.vy, s.sampling_std.vy, 2);
+  }
+  noise_generation_++;
+
+  // Publish the new noises, taking back the set the optimizer is no longer reading
+  back_noises_ = middle_noises_.exchange(
+    back_noises_ | fresh_noises_flag_, std::memory_order_acq_rel) & ~fresh_noises_flag_;
+}
+
+void NoiseGenerator::generateAxisNoises(
+  xt::xtensor<float, 2> & noises, float stddev, uint32_t axis)
+{
+  const size_t rows = noises.shape(0);
+  const size_t cols = noises.shape(1);
+  const uint32_t seed = static_cast<uint32_t>(noise_seed_);
+  const utils::PhiloxKey key = {seed, 0};
+  auto fillRow = [&](size_t row) {
+      utils::fillNormal(
+        &noises(row, 0), cols, stddev,
+        {noise_generation_, static_cast<uint32_t>(row), axis}, key);
+    };
+
+  if (!noise_pool_) {
+    for (size_t row = 0; row < rows; row++) {
+      fillRow(row);
+    }
+    return;
   }
+  noise_pool_->parallelFor(0, rows, fillRow);
 }
 
 }  // namespace mppi
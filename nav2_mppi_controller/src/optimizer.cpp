@@ -14,8 +14,10 @@
 
 #include "nav2_mppi_controller/optimizer.hpp"
 
+#include <algorithm>
 #include <limits>
 #include <memory>
+#include <numeric>
 #include <stdexcept>
 #include <string>
 #include <vector>
@@ -85,6 +87,22 @@ void Optimizer::getParams()
   getParam(s.sampling_std.vy, "vy_std", 0.2f);
   getParam(s.sampling_std.wz, "wz_std", 0.4f);
   getParam(s.retry_attempt_limit, "retry_attempt_limit", 1);
+  getParam(rollout_threads_, "rollout_threads", 1, ParameterType::Static);
+  int distance_field_downsampling;
+  getParam(distance_field_downsampling, "distance_field_downsampling", 1, ParameterType::Static);
+  distance_field_ = std::make_shared<CostmapDistanceField>(
+    static_cast<unsigned int>(std::max(1, distance_field_downsampling)));
+  float path_index_cell_size;
+  getParam(path_index_cell_size, "path_index_cell_size", 0.0f, ParameterType::Static);
+  path_index_ = path_index_cell_size > 0.0f ?
+    std::make_shared<PathSpatialIndex>(path_index_cell_size) : nullptr;
+
+  rollout_pool_.reset();
+  if (rollout_threads_ > 1) {
+    // The calling thread rolls out samples as well
+    rollout_pool_ = std::make_unique<nav2_util::ThreadPool>(
+      static_cast<unsigned int>(rollout_threads_ - 1));
+  }
 
   s.base_constraints.ax_max = std::abs(s.base_constraints.ax_max);
   if (s.base_constraints.ax_min > 0.0) {
@@ -94,6 +112,22 @@ void Optimizer::getParams()
       "Sign of the parameter ax_min is incorrect, consider setting it negative.");
   }
 
+  getParam(kept_samples_, "kept_samples", 0);
+  getParam(braking_sample_, "braking_sample", false);
+  getParam(adaptive_sampling_, "adaptive_sampling", false, ParameterType::Static);
+  getParam(time_budget_fraction_, "time_budget_fraction", 0.5f, ParameterType::Static);
+  getParam(min_batch_size_, "min_batch_size", 200, ParameterType::Static);
+  getParam(
+    max_batch_size_, "max_batch_size", static_cast<int>(s.batch_size), ParameterType::Static);
+  if (adaptive_sampling_ && min_batch_size_ > max_batch_size_) {
+    RCLCPP_WARN(
+      logger_,
+      "min_batch_size is larger than max_batch_size, using max_batch_size for both.");
+    min_batch_size_ = max_batch_size_;
+  }
+
+  getParam(latency_instrumentation_, "latency_instrumentation", false, ParameterType::Static);
+
   getParam(motion_model_name, "motion_model", std::string("DiffDrive"));
 
   s.constraints = s.base_constraints;
@@ -109,6 +143,7 @@ void Optimizer::setOffset(double controller_frequency)
 {
   const double controller_period = 1.0 / controller_frequency;
   constexpr double eps = 1e-6;
+  controller_period_ = controller_period;
 
   if ((controller_period + eps) < settings_.model_dt) {
     RCLCPP_WARN(
@@ -137,8 +172,10 @@ void Optimizer::reset()
 
   settings_.constraints = settings_.base_constraints;
 
-  costs_ = xt::zeros<float>({settings_.batch_size});
+  xt::noalias(costs_) = xt::zeros<float>({settings_.batch_size});
+  xt::noalias(weights_) = xt::zeros<float>({settings_.batch_size});
   generated_trajectories_.reset(settings_.batch_size, settings_.time_steps);
+  kept_count_ = 0;
 
   noise_generator_.reset(settings_, isHolonomic());
   RCLCPP_INFO(logger_, "Optimizer reset");
@@ -156,10 +193,17 @@ geometry_msgs::msg::TwistStamped Optimizer::evalControl(
 {
   prepare(robot_pose, robot_speed, plan, goal_checker);
 
+  cycle_timer_.start();
+  cycle_iterations_ = 0;
   do {
     optimize();
   } while (fallback(critics_data_.fail_flag));
 
+  if (adaptive_sampling_) {
+    cycle_timer_.end();
+    adaptBatchSize(cycle_timer_.elapsed_time_in_seconds());
+  }
+
   utils::savitskyGolayFilter(control_sequence_, control_history_, settings_);
   auto control = getControlFromSequenceAsTwist(plan.header.stamp);
 
@@ -174,11 +218,72 @@ void Optimizer::optimize()
 {
   for (size_t i = 0; i < settings_.iteration_count; ++i) {
     generateNoisedTrajectories();
+    auto stage_start = std::chrono::steady_clock::now();
     critic_manager_.evalTrajectoriesScores(critics_data_);
+    stage_start = recordStageLatency(CRITICS_STAGE, stage_start);
     updateControlSequence();
+    recordStageLatency(WEIGHTING_STAGE, stage_start);
+    cycle_iterations_++;
+
+    // Anytime behavior, keep the solution so far rather than missing the control deadline
+    if (adaptive_sampling_ && isOutOfTimeBudget()) {
+      break;
+    }
   }
 }
 
+bool Optimizer::isOutOfTimeBudget()
+{
+  cycle_timer_.end();
+  const double elapsed_time = cycle_timer_.elapsed_time_in_seconds();
+  const double iteration_time = elapsed_time / static_cast<double>(cycle_iterations_);
+  return elapsed_time + iteration_time > time_budget_fraction_ * controller_period_;
+}
+
+void Optimizer::adaptBatchSize(double elapsed_time)
+{
+  if (cycle_iterations_ == 0 || elapsed_time <= 0.0) {
+    return;
+  }
+
+  const double sample_time =
+    elapsed_time / static_cast<double>(cycle_iterations_ * settings_.batch_size);
+  const double budget = time_budget_fraction_ * controller_period_;
+  const double budget_batch_size = budget / (sample_time * settings_.iteration_count);
+
+  // Move halfway to the size fitting the budget to damp measurement noise, and only
+  // reallocate when the change is significant
+  const double target = std::clamp(
+    0.5 * (settings_.batch_size + budget_batch_size),
+    static_cast<double>(min_batch_size_), static_cast<double>(max_batch_size_));
+  const auto batch_size = static_cast<unsigned int>(std::lround(target));
+  const unsigned int change = batch_size > settings_.batch_size ?
+    batch_size - settings_.batch_size : settings_.batch_size - batch_size;
+  if (change * 20u > settings_.batch_size) {
+    resizeBatch(batch_size);
+  }
+}
+
+void Optimizer::resizeBatch(unsigned int batch_size)
+{
+  settings_.batch_size = batch_size;
+  state_.reset(settings_.batch_size, settings_.time_steps);
+  xt::noalias(costs_) = xt::zeros<float>({settings_.batch_size});
+  xt::noalias(weights_) = xt::zeros<float>({settings_.batch_size});
+  generated_trajectories_.reset(settings_.batch_size, settings_.time_steps);
+  noise_generator_.reset(settings_, isHolonomic());
+}
+
+unsigned int Optimizer::getBatchSize() const
+{
+  return settings_.batch_size;
+}
+
+bool Optimizer::isAdaptiveSampling() const
+{
+  return adaptive_sampling_;
+}
+
 bool Optimizer::fallback(bool fail)
 {
   static size_t counter = 0;
@@ -213,6 +318,13 @@ void Optimizer::prepare(
   critics_data_.motion_model = motion_model_;
   critics_data_.furthest_reached_path_point.reset();
   critics_data_.path_pts_valid.reset();
+  // Only computed if a critic uses it, from the costmap of this cycle
+  distance_field_->invalidate();
+  critics_data_.distance_field = distance_field_;
+  if (path_index_) {
+    path_index_->invalidate();
+  }
+  critics_data_.path_index = path_index_;
 }
 
 void Optimizer::shiftControlSequence()
@@ -234,14 +346,128 @@ void Optimizer::shiftControlSequence()
     xt::view(control_sequence_.vy, -1) =
       xt::view(control_sequence_.vy, -2);
   }
+
+  shiftKeptSamples();
 }
 
 void Optimizer::generateNoisedTrajectories()
 {
+  auto stage_start = std::chrono::steady_clock::now();
   noise_generator_.setNoisedControls(state_, control_sequence_);
   noise_generator_.generateNextNoises();
+  injectKeptSamples();
+  stage_start = recordStageLatency(NOISE_STAGE, stage_start);
   updateStateVelocities(state_);
   integrateStateVelocities(generated_trajectories_, state_);
+  recordStageLatency(ROLLOUT_STAGE, stage_start);
+}
+
+std::chrono::steady_clock::time_point Optimizer::recordStageLatency(
+  size_t stage, const std::chrono::steady_clock::time_point & start)
+{
+  if (!latency_instrumentation_) {
+    return start;
+  }
+
+  const auto end = std::chrono::steady_clock::now();
+  stage_latencies_[stage].record(std::chrono::duration<double>(end - start).count());
+  return end;
+}
+
+bool Optimizer::isLatencyInstrumented() const
+{
+  return latency_instrumentation_;
+}
+
+void Optimizer::collectLatencies(
+  std::vector<std::pair<std::string, LatencySummary>> & latencies)
+{
+  if (!latency_instrumentation_) {
+    return;
+  }
+
+  for (size_t i = 0; i < STAGES_COUNT; ++i) {
+    latencies.emplace_back(stage_names_[i], stage_latencies_[i].collect());
+  }
+  critic_manager_.collectLatencies(latencies);
+}
+
+void Optimizer::keepBestSamples()
+{
+  const size_t batch_size = costs_.shape(0);
+  // Keep at least one noised sample, and room for the braking one
+  const size_t reserved = braking_sample_ ? 2 : 1;
+  const size_t count =
+    batch_size > reserved ? std::min<size_t>(kept_samples_, batch_size - reserved) : 0;
+  kept_count_ = count;
+  if (count == 0) {
+    return;
+  }
+
+  ranked_samples_.resize(batch_size);
+  std::iota(ranked_samples_.begin(), ranked_samples_.end(), 0u);
+  std::partial_sort(
+    ranked_samples_.begin(), ranked_samples_.begin() + count, ranked_samples_.end(),
+    [this](unsigned int a, unsigned int b) {return costs_(a) < costs_(b);});
+
+  const bool is_holo = isHolonomic();
+  const size_t time_steps = state_.cvx.shape(1);
+  kept_vx_.resize({count, time_steps});
+  kept_wz_.resize({count, time_steps});
+  kept_vy_.resize({count, time_steps});
+  for (size_t k = 0; k < count; ++k) {
+    const unsigned int i = ranked_samples_[k];
+    std::copy_n(&state_.cvx(i, 0), time_steps, &kept_vx_(k, 0));
+    std::copy_n(&state_.cwz(i, 0), time_steps, &kept_wz_(k, 0));
+    if (is_holo) {
+      std::copy_n(&state_.cvy(i, 0), time_steps, &kept_vy_(k, 0));
+    }
+  }
+}
+
+void Optimizer::injectKeptSamples()
+{
+  const size_t batch_size = state_.cvx.shape(0);
+  const size_t time_steps = state_.cvx.shape(1);
+  const bool is_holo = isHolonomic();
+
+  // Kept samples of a different horizon or batch are stale, e.g. after a resize
+  const size_t count = kept_count_ < batch_size && kept_vx_.shape(1) == time_steps ?
+    kept_count_ : 0;
+  for (size_t k = 0; k < count; ++k) {
+    std::copy_n(&kept_vx_(k, 0), time_steps, &state_.cvx(k, 0));
+    std::copy_n(&kept_wz_(k, 0), time_steps, &state_.cwz(k, 0));
+    if (is_holo) {
+      std::copy_n(&kept_vy_(k, 0), time_steps, &state_.cvy(k, 0));
+    }
+  }
+
+  if (braking_sample_ && batch_size > count) {
+    const size_t i = batch_size - 1;
+    std::fill_n(&state_.cvx(i, 0), time_steps, 0.0f);
+    std::fill_n(&state_.cwz(i, 0), time_steps, 0.0f);
+    if (is_holo) {
+      std::fill_n(&state_.cvy(i, 0), time_steps, 0.0f);
+    }
+  }
+}
+
+void Optimizer::shiftKeptSamples()
+{
+  const size_t time_steps = kept_vx_.shape(1);
+  if (kept_count_ == 0 || time_steps < 2) {
+    return;
+  }
+
+  // Advance each kept sample by a time step, repeating its last control
+  const bool is_holo = isHolonomic();
+  for (size_t k = 0; k < kept_count_; ++k) {
+    std::copy(&kept_vx_(k, 1), &kept_vx_(k, 0) + time_steps, &kept_vx_(k, 0));
+    std::copy(&kept_wz_(k, 1), &kept_wz_(k, 0) + time_steps, &kept_wz_(k, 0));
+    if (is_holo) {
+      std::copy(&kept_vy_(k, 1), &kept_vy_(k, 0) + time_steps, &kept_vy_(k, 0));
+    }
+  }
 }
 
 void Optimizer::applyControlSequenceConstraints()
@@ -249,11 +475,14 @@ void Optimizer::applyControlSequenceConstraints()
   auto & s = settings_;
 
   if (isHolonomic()) {
-    control_sequence_.vy = xt::clip(control_sequence_.vy, -s.constraints.vy, s.constraints.vy);
+    xt::noalias(control_sequence_.vy) =
+      xt::clip(control_sequence_.vy, -s.constraints.vy, s.constraints.vy);
   }
 
-  control_sequence_.vx = xt::clip(control_sequence_.vx, s.constraints.vx_min, s.constraints.vx_max);
-  control_sequence_.wz = xt::clip(control_sequence_.wz, -s.constraints.wz, s.constraints.wz);
+  xt::noalias(control_sequence_.vx) =
+    xt::clip(control_sequence_.vx, s.constraints.vx_min, s.constraints.vx_max);
+  xt::noalias(control_sequence_.wz) =
+    xt::clip(control_sequence_.wz, -s.constraints.wz, s.constraints.wz);
 
   float max_delta_vx = s.model_dt * s.constraints.ax_max;
   float min_delta_vx = s.model_dt * s.constraints.ax_min;
@@ -342,28 +571,68 @@ void Optimizer::integrateStateVelocities(
   models::Trajectories & trajectories,
   const models::State & state) const
 {
-  const float initial_yaw = static_cast<float>(tf2::getYaw(state.pose.pose.orientation));
-
-  xt::noalias(trajectories.yaws) =
-    xt::cumsum(state.wz * settings_.model_dt, {1}) + initial_yaw;
-
-  auto yaw_cos = xt::roll(xt::eval(xt::cos(trajectories.yaws)), 1, 1);
-  auto yaw_sin = xt::roll(xt::eval(xt::sin(trajectories.yaws)), 1, 1);
-  xt::view(yaw_cos, xt::all(), 0) = cosf(initial_yaw);
-  xt::view(yaw_sin, xt::all(), 0) = sinf(initial_yaw);
-
-  auto && dx = xt::eval(state.vx * yaw_cos);
-  auto && dy = xt::eval(state.vx * yaw_sin);
+  const size_t batch_size = state.vx.shape(0);
+  const size_t time_steps = state.vx.shape(1);
+  trajectories.x.resize({batch_size, time_steps});
+  trajectories.y.resize({batch_size, time_steps});
+  trajectories.yaws.resize({batch_size, time_steps});
 
   if (isHolonomic()) {
-    dx = dx - state.vy * yaw_sin;
-    dy = dy + state.vy * yaw_cos;
+    integrateSamples<true>(trajectories, state);
+  } else {
+    integrateSamples<false>(trajectories, state);
   }
+}
 
-  xt::noalias(trajectories.x) = state.pose.pose.position.x +
-    xt::cumsum(dx * settings_.model_dt, {1});
-  xt::noalias(trajectories.y) = state.pose.pose.position.y +
-    xt::cumsum(dy * settings_.model_dt, {1});
+template<bool holonomic>
+void Optimizer::integrateSamples(
+  models::Trajectories & trajectories,
+  const models::State & state) const
+{
+  const float initial_yaw = static_cast<float>(tf2::getYaw(state.pose.pose.orientation));
+  const float initial_yaw_cos = cosf(initial_yaw);
+  const float initial_yaw_sin = sinf(initial_yaw);
+  const double initial_x = state.pose.pose.position.x;
+  const double initial_y = state.pose.pose.position.y;
+  const float dt = settings_.model_dt;
+  const size_t batch_size = state.vx.shape(0);
+  const size_t time_steps = state.vx.shape(1);
+
+  // Rolls out each trajectory in a single pass over its row instead of materializing
+  // the yaw cos/sin and displacement tensors of the whole batch. The sums are evaluated
+  // in the same order as the cumulative sums of the tensor expressions they replace.
+  forEachSampleRange(
+    batch_size, [&](size_t begin, size_t end) {
+      for (size_t i = begin; i < end; ++i) {
+        const float * vx = &state.vx(i, 0);
+        const float * vy = &state.vy(i, 0);
+        const float * wz = &state.wz(i, 0);
+        float * traj_x = &trajectories.x(i, 0);
+        float * traj_y = &trajectories.y(i, 0);
+        float * traj_yaws = &trajectories.yaws(i, 0);
+
+        float yaw_sum = 0.0f, x_sum = 0.0f, y_sum = 0.0f;
+        float yaw_cos = initial_yaw_cos, yaw_sin = initial_yaw_sin;
+        for (size_t t = 0; t < time_steps; ++t) {
+          float dx = vx[t] * yaw_cos;
+          float dy = vx[t] * yaw_sin;
+          if constexpr (holonomic) {
+            dx = dx - vy[t] * yaw_sin;
+            dy = dy + vy[t] * yaw_cos;
+          }
+          x_sum += dx * dt;
+          y_sum += dy * dt;
+          traj_x[t] = initial_x + x_sum;
+          traj_y[t] = initial_y + y_sum;
+
+          yaw_sum += wz[t] * dt;
+          traj_yaws[t] = yaw_sum + initial_yaw;
+          // The displacement of the next step uses the heading reached at this one
+          yaw_cos = cosf(traj_yaws[t]);
+          yaw_sin = sinf(traj_yaws[t]);
+        }
+      }
+    });
 }
 
 xt::xtensor<float, 2> Optimizer::getOptimizedTrajectory()
@@ -384,36 +653,100 @@ xt::xtensor<float, 2> Optimizer::getOptimizedTrajectory()
   return std::move(trajectories);
 }
 
+template<bool holonomic>
+void Optimizer::addControlCosts()
+{
+  auto & s = settings_;
+  const size_t batch_size = costs_.shape(0);
+  const size_t time_steps = control_sequence_.vx.shape(0);
+  const float vx_scale = s.gamma / powf(s.sampling_std.vx, 2);
+  const float vy_scale = s.gamma / powf(s.sampling_std.vy, 2);
+  const float wz_scale = s.gamma / powf(s.sampling_std.wz, 2);
+  const float * vx = control_sequence_.vx.data();
+  const float * vy = control_sequence_.vy.data();
+  const float * wz = control_sequence_.wz.data();
+
+  // Evaluated row by row into the preallocated buffers, so that the iteration
+  // does not allocate batch sized temporaries
+  forEachSampleRange(
+    batch_size, [&](size_t begin, size_t end) {
+      for (size_t i = begin; i < end; ++i) {
+        const float * cvx = &state_.cvx(i, 0);
+        const float * cvy = &state_.cvy(i, 0);
+        const float * cwz = &state_.cwz(i, 0);
+        float vx_cost = 0.0f, vy_cost = 0.0f, wz_cost = 0.0f;
+        for (size_t t = 0; t < time_steps; ++t) {
+          vx_cost += vx[t] * (cvx[t] - vx[t]);
+          wz_cost += wz[t] * (cwz[t] - wz[t]);
+          if constexpr (holonomic) {
+            vy_cost += vy[t] * (cvy[t] - vy[t]);
+          }
+        }
+        costs_(i) += vx_scale * vx_cost;
+        costs_(i) += wz_scale * wz_cost;
+        if constexpr (holonomic) {
+          costs_(i) += vy_scale * vy_cost;
+        }
+      }
+    });
+}
+
+template<bool holonomic>
+void Optimizer::weightControlSequence()
+{
+  const size_t batch_size = weights_.shape(0);
+  const size_t time_steps = control_sequence_.vx.shape(0);
+  float * vx = control_sequence_.vx.data();
+  float * vy = control_sequence_.vy.data();
+  float * wz = control_sequence_.wz.data();
+
+  std::fill_n(vx, time_steps, 0.0f);
+  std::fill_n(wz, time_steps, 0.0f);
+  if constexpr (holonomic) {
+    std::fill_n(vy, time_steps, 0.0f);
+  }
+  for (size_t i = 0; i < batch_size; ++i) {
+    const float weight = weights_(i);
+    const float * cvx = &state_.cvx(i, 0);
+    const float * cvy = &state_.cvy(i, 0);
+    const float * cwz = &state_.cwz(i, 0);
+    for (size_t t = 0; t < time_steps; ++t) {
+      vx[t] += cvx[t] * weight;
+      wz[t] += cwz[t] * weight;
+      if constexpr (holonomic) {
+        vy[t] += cvy[t] * weight;
+      }
+    }
+  }
+}
+
 void Optimizer::updateControlSequence()
 {
   const bool is_holo = isHolonomic();
-  auto & s = settings_;
-  auto bounded_noises_vx = state_.cvx - control_sequence_.vx;
-  auto bounded_noises_wz = state_.cwz - control_sequence_.wz;
-  xt::noalias(costs_) +=
-    s.gamma / powf(s.sampling_std.vx, 2) * xt::sum(
-    xt::view(control_sequence_.vx, xt::newaxis(), xt::all()) * bounded_noises_vx, 1, immediate);
-  xt::noalias(costs_) +=
-    s.gamma / powf(s.sampling_std.wz, 2) * xt::sum(
-    xt::view(control_sequence_.wz, xt::newaxis(), xt::all()) * bounded_noises_wz, 1, immediate);
+  const size_t batch_size = costs_.shape(0);
 
   if (is_holo) {
-    auto bounded_noises_vy = state_.cvy - control_sequence_.vy;
-    xt::noalias(costs_) +=
-      s.gamma / powf(s.sampling_std.vy, 2) * xt::sum(
-      xt::view(control_sequence_.vy, xt::newaxis(), xt::all()) * bounded_noises_vy,
-      1, immediate);
+    addControlCosts<true>();
+  } else {
+    addControlCosts<false>();
   }
 
-  auto && costs_normalized = costs_ - xt::amin(costs_, immediate);
-  auto && exponents = xt::eval(xt::exp(-1 / settings_.temperature * costs_normalized));
-  auto && softmaxes = xt::eval(exponents / xt::sum(exponents, immediate));
-  auto && softmaxes_extened = xt::eval(xt::view(softmaxes, xt::all(), xt::newaxis()));
+  keepBestSamples();
+
+  const float min_cost = *std::min_element(costs_.begin(), costs_.end());
+  float exponents_sum = 0.0f;
+  for (size_t i = 0; i < batch_size; ++i) {
+    weights_(i) = expf(-1 / settings_.temperature * (costs_(i) - min_cost));
+    exponents_sum += weights_(i);
+  }
+  for (size_t i = 0; i < batch_size; ++i) {
+    weights_(i) /= exponents_sum;
+  }
 
-  xt::noalias(control_sequence_.vx) = xt::sum(state_.cvx * softmaxes_extened, 0, immediate);
-  xt::noalias(control_sequence_.wz) = xt::sum(state_.cwz * softmaxes_extened, 0, immediate);
   if (is_holo) {
-    xt::noalias(control_sequence_.vy) = xt::sum(state_.cvy * softmaxes_extened, 0, immediate);
+    weightControlSequence<true>();
+  } else {
+    weightControlSequence<false>();
   }
 
   applyControlSequenceConstraints();
@@ -51,13 +51,13 @@ PathHandler::getGlobalPlanConsideringBoundsInCostmapFrame(
 {
   using nav2_util::geometry_utils::euclidean_distance;
 
-  auto begin = global_plan_up_to_inversion_.poses.begin();
+  // The search starts from the closest pose of the previous cycle
+  auto begin = global_plan_up_to_inversion_.poses.begin() + pruned_poses_;
 
   // Limit the search for the closest pose up to max_robot_pose_search_dist on the path
   auto closest_pose_upper_bound =
     nav2_util::geometry_utils::first_after_integrated_distance(
-    global_plan_up_to_inversion_.poses.begin(), global_plan_up_to_inversion_.poses.end(),
-    max_robot_pose_search_dist_);
+    begin, global_plan_up_to_inversion_.poses.end(), max_robot_pose_search_dist_);
 
   // Find closest point to the robot
   auto closest_point = nav2_util::geometry_utils::min_by(
@@ -74,6 +74,17 @@ PathHandler::getGlobalPlanConsideringBoundsInCostmapFrame(
     nav2_util::geometry_utils::first_after_integrated_distance(
     closest_point, global_plan_up_to_inversion_.poses.end(), prune_distance_);
 
+  // All the poses share the plan frame, so a single transform is looked up
+  // for the cycle and applied to each of them
+  geometry_msgs::msg::TransformStamped plan_to_costmap;
+  if (!lookupPlanTransform(
+      transformed_plan.header.frame_id, global_pose.header.stamp, plan_to_costmap))
+  {
+    throw nav2_core::ControllerTFError(
+            "Unable to transform global plan into costmap's frame");
+  }
+
+  transformed_plan.poses.reserve(std::distance(closest_point, pruned_plan_end));
   unsigned int mx, my;
   // Find the furthest relevent pose on the path to consider within costmap
   // bounds
@@ -83,9 +94,8 @@ PathHandler::getGlobalPlanConsideringBoundsInCostmapFrame(
   {
     // Transform from global plan frame to costmap frame
     geometry_msgs::msg::PoseStamped costmap_plan_pose;
-    global_plan_pose->header.stamp = global_pose.header.stamp;
-    global_plan_pose->header.frame_id = global_plan_.header.frame_id;
-    transformPose(costmap_->getGlobalFrameID(), *global_plan_pose, costmap_plan_pose);
+    tf2::doTransform(global_plan_pose->pose, costmap_plan_pose.pose, plan_to_costmap);
+    costmap_plan_pose.header = transformed_plan.header;
 
     // Check if pose is inside the costmap
     if (!costmap_->getCostmap()->worldToMap(
@@ -125,12 +135,13 @@ nav_msgs::msg::Path PathHandler::transformPath(
     transformToGlobalPlanFrame(robot_pose);
   auto [transformed_plan, lower_bound] = getGlobalPlanConsideringBoundsInCostmapFrame(global_pose);
 
-  prunePlan(global_plan_up_to_inversion_, lower_bound);
+  prunePlanUpToInversion(lower_bound);
 
   if (enforce_path_inversion_ && inversion_locale_ != 0u) {
     if (isWithinInversionTolerances(global_pose)) {
       prunePlan(global_plan_, global_plan_.poses.begin() + inversion_locale_);
       global_plan_up_to_inversion_ = global_plan_;
+      pruned_poses_ = 0;
       inversion_locale_ = utils::removePosesAfterFirstInversion(global_plan_up_to_inversion_);
     }
   }
@@ -163,6 +174,28 @@ bool PathHandler::transformPose(
   return false;
 }
 
+bool PathHandler::lookupPlanTransform(
+  const std::string & frame, const builtin_interfaces::msg::Time & stamp,
+  geometry_msgs::msg::TransformStamped & transform) const
+{
+  const std::string & plan_frame = global_plan_up_to_inversion_.header.frame_id;
+  if (plan_frame == frame) {
+    transform = geometry_msgs::msg::TransformStamped();
+    transform.transform.rotation.w = 1.0;
+    return true;
+  }
+
+  try {
+    transform = tf_buffer_->lookupTransform(
+      frame, plan_frame, tf2_ros::fromMsg(stamp),
+      tf2::durationFromSec(transform_tolerance_));
+    return true;
+  } catch (tf2::TransformException & ex) {
+    RCLCPP_ERROR(logger_, "Exception in lookupPlanTransform: %s", ex.what());
+  }
+  return false;
+}
+
 double PathHandler::getMaxCostmapDist()
 {
   const auto & costmap = costmap_->getCostmap();
@@ -174,6 +207,7 @@ void PathHandler::setPath(const nav_msgs::msg::Path & plan)
 {
   global_plan_ = plan;
   global_plan_up_to_inversion_ = global_plan_;
+  pruned_poses_ = 0;
   if (enforce_path_inversion_) {
     inversion_locale_ = utils::removePosesAfterFirstInversion(global_plan_up_to_inversion_);
   }
@@ -186,6 +220,19 @@ void PathHandler::prunePlan(nav_msgs::msg::Path & plan, const PathIterator end)
   plan.poses.erase(plan.poses.begin(), end);
 }
 
+void PathHandler::prunePlanUpToInversion(const PathIterator end)
+{
+  auto & poses = global_plan_up_to_inversion_.poses;
+  pruned_poses_ = static_cast<size_t>(std::distance(poses.begin(), end));
+
+  // Erasing once the pruned poses outnumber the others keeps the cost of
+  // shifting the remaining poses amortized constant per pruned pose
+  if (pruned_poses_ > poses.size() / 2) {
+    prunePlan(global_plan_up_to_inversion_, end);
+    pruned_poses_ = 0;
+  }
+}
+
 bool PathHandler::isWithinInversionTolerances(const geometry_msgs::msg::PoseStamped & robot_pose)
 {
   // Keep full path if we are within tolerance of the inversion pose
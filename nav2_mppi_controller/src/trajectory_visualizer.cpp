@@ -60,63 +60,85 @@ void TrajectoryVisualizer::add(
   const xt::xtensor<float, 2> & trajectory, const std::string & marker_namespace)
 {
   auto & size = trajectory.shape()[0];
-  if (!size) {
+  if (!size || !isSubscribed()) {
     return;
   }
 
-  auto add_marker = [&](auto i) {
-      float component = static_cast<float>(i) / static_cast<float>(size);
-
-      auto pose = utils::createPose(trajectory(i, 0), trajectory(i, 1), 0.06);
-      auto scale =
-        i != size - 1 ?
-        utils::createScale(0.03, 0.03, 0.07) :
-        utils::createScale(0.07, 0.07, 0.09);
-      auto color = utils::createColor(0, component, component, 1);
-      auto marker = utils::createMarker(
-        marker_id_++, pose, scale, color, frame_id_, marker_namespace);
-      points_->markers.push_back(marker);
-    };
-
+  auto & marker = nextMarker(marker_namespace, 0.05);
+  marker.points.resize(size);
+  marker.colors.resize(size);
   for (size_t i = 0; i < size; i++) {
-    add_marker(i);
+    float component = static_cast<float>(i) / static_cast<float>(size);
+    marker.points[i].x = trajectory(i, 0);
+    marker.points[i].y = trajectory(i, 1);
+    marker.points[i].z = 0.06;
+    marker.colors[i] = utils::createColor(0, component, component, 1);
   }
 }
 
 void TrajectoryVisualizer::add(
   const models::Trajectories & trajectories, const std::string & marker_namespace)
 {
+  if (!isSubscribed()) {
+    return;
+  }
+
   auto & shape = trajectories.x.shape();
   const float shape_1 = static_cast<float>(shape[1]);
-  points_->markers.reserve(floor(shape[0] / trajectory_step_) * floor(shape[1] * time_step_));
+  const size_t points_count = (shape[1] + time_step_ - 1) / time_step_;
 
   for (size_t i = 0; i < shape[0]; i += trajectory_step_) {
-    for (size_t j = 0; j < shape[1]; j += time_step_) {
+    auto & marker = nextMarker(marker_namespace, 0.01);
+    marker.points.resize(points_count);
+    marker.colors.resize(points_count);
+    for (size_t j = 0, k = 0; j < shape[1]; j += time_step_, k++) {
       const float j_flt = static_cast<float>(j);
       float blue_component = 1.0f - j_flt / shape_1;
       float green_component = j_flt / shape_1;
 
-      auto pose = utils::createPose(trajectories.x(i, j), trajectories.y(i, j), 0.03);
-      auto scale = utils::createScale(0.03, 0.03, 0.03);
-      auto color = utils::createColor(0, green_component, blue_component, 1);
-      auto marker = utils::createMarker(
-        marker_id_++, pose, scale, color, frame_id_, marker_namespace);
-
-      points_->markers.push_back(marker);
+      marker.points[k].x = trajectories.x(i, j);
+      marker.points[k].y = trajectories.y(i, j);
+      marker.points[k].z = 0.03;
+      marker.colors[k] = utils::createColor(0, green_component, blue_component, 1);
     }
   }
 }
 
+visualization_msgs::msg::Marker & TrajectoryVisualizer::nextMarker(
+  const std::string & marker_namespace, double width)
+{
+  using visualization_msgs::msg::Marker;
+  if (markers_used_ == points_.markers.size()) {
+    points_.markers.emplace_back();
+  }
+  Marker & marker = points_.markers[markers_used_++];
+  marker.header.frame_id = frame_id_;
+  marker.ns = marker_namespace;
+  marker.id = marker_id_++;
+  marker.type = Marker::LINE_STRIP;
+  marker.action = Marker::ADD;
+  marker.pose.orientation.w = 1.0;
+  marker.scale.x = width;
+  return marker;
+}
+
+bool TrajectoryVisualizer::isSubscribed() const
+{
+  return trajectories_publisher_ && trajectories_publisher_->get_subscription_count() > 0;
+}
+
 void TrajectoryVisualizer::reset()
 {
   marker_id_ = 0;
-  points_ = std::make_unique<visualization_msgs::msg::MarkerArray>();
+  markers_used_ = 0;
 }
 
 void TrajectoryVisualizer::visualize(const nav_msgs::msg::Path & plan)
 {
-  if (trajectories_publisher_->get_subscription_count() > 0) {
-    trajectories_publisher_->publish(std::move(points_));
+  if (isSubscribed()) {
+    // Drop the markers left over from a cycle with more trajectories
+    points_.markers.resize(markers_used_);
+    trajectories_publisher_->publish(points_);
   }
 
   reset();
@@ -84,6 +84,87 @@ public:
   }
 };
 
+class AddingCritic : public CriticFunction
+{
+public:
+  explicit AddingCritic(float value, bool fail = false)
+  : value_(value), fail_(fail) {}
+  virtual void initialize() {}
+  virtual void score(CriticData & data)
+  {
+    data.costs += xt::arange<float>(data.costs.shape(0)) * value_;
+    data.fail_flag = data.fail_flag || fail_;
+  }
+  float value_;
+  bool fail_;
+};
+
+class CriticManagerWrapperAdding : public CriticManager
+{
+public:
+  virtual void loadCritics()
+  {
+    critics_.clear();
+    critics_.push_back(std::make_unique<AddingCritic>(0.1f));
+    critics_.push_back(std::make_unique<AddingCritic>(0.7f, true));
+    critics_.push_back(std::make_unique<AddingCritic>(1.3f));
+    for (auto & critic : critics_) {
+      critic->on_configure(
+        parent_, name_, name_ + "." + "AddingCritic", costmap_ros_,
+        parameters_handler_);
+    }
+  }
+};
+
+class DistanceFieldCritic : public CriticFunction
+{
+public:
+  virtual void initialize()
+  {
+    auto getParam = parameters_handler_->getParamGetter(name_);
+    getParam(use_distance_field_, "use_distance_field", false);
+  }
+
+  virtual void score(CriticData & data)
+  {
+    // As the obstacle critics, falling back to the costmap without a shared field
+    if (use_distance_field_ && data.distance_field) {
+      data.distance_field->updateIfInvalid(*costmap_ros_->getCostmap(), true);
+      used_field_ = data.distance_field.get();
+    }
+    used_path_index_ = data.path_index.get();
+  }
+
+  bool use_distance_field_{false};
+  CostmapDistanceField * used_field_{nullptr};
+  PathSpatialIndex * used_path_index_{nullptr};
+};
+
+class CriticManagerWrapperDistanceField : public CriticManager
+{
+public:
+  virtual void loadCritics()
+  {
+    critics_.clear();
+    for (int i = 0; i < 3; ++i) {
+      critics_.push_back(std::make_unique<DistanceFieldCritic>());
+      critics_.back()->on_configure(
+        parent_, name_, name_ + "." + "DistanceFieldCritic", costmap_ros_,
+        parameters_handler_);
+    }
+  }
+
+  CostmapDistanceField * getUsedField(size_t index)
+  {
+    return dynamic_cast<DistanceFieldCritic *>(critics_[index].get())->used_field_;
+  }
+
+  PathSpatialIndex * getUsedPathIndex(size_t index)
+  {
+    return dynamic_cast<DistanceFieldCritic *>(critics_[index].get())->used_path_index_;
+  }
+};
+
 class CriticManagerWrapperEnum : public CriticManager
 {
 public:
@@ -150,3 +231,113 @@ TEST(CriticManagerTests, CriticLoadingTest)
   critic_manager.on_configure(node, "critic_manager", costmap_ros, &param_handler);
   EXPECT_EQ(critic_manager.getCriticNum(), 2u);
 }
+
+TEST(CriticManagerTests, ParallelCriticsScoring)
+{
+  auto node = std::make_shared<rclcpp_lifecycle::LifecycleNode>("my_node");
+  node->declare_parameter("critic_manager.critic_threads", rclcpp::ParameterValue(3));
+  auto costmap_ros = std::make_shared<nav2_costmap_2d::Costmap2DROS>(
+    "dummy_costmap", "", "dummy_costmap", true);
+  ParametersHandler param_handler(node);
+  rclcpp_lifecycle::State lstate;
+  costmap_ros->on_configure(lstate);
+
+  CriticManagerWrapperAdding critic_manager;
+  critic_manager.on_configure(node, "critic_manager", costmap_ros, &param_handler);
+
+  models::State state;
+  models::Trajectories generated_trajectories;
+  models::Path path;
+  xt::xtensor<float, 1> costs = xt::ones<float>({100});
+  float model_dt = 0.1;
+  CriticData data =
+  {state, generated_trajectories, path, costs, model_dt, false, nullptr, nullptr,
+    std::nullopt, std::nullopt};
+  critic_manager.evalTrajectoriesScores(data);
+
+  // All critics are scored and summed in order, the failure of one is reported
+  xt::xtensor<float, 1> expected = xt::ones<float>({100});
+  for (float value : {0.1f, 0.7f, 1.3f}) {
+    expected += xt::arange<float>(100) * value;
+  }
+  EXPECT_TRUE(data.fail_flag);
+  for (size_t i = 0; i < costs.shape(0); ++i) {
+    EXPECT_EQ(costs(i), expected(i));
+  }
+}
+
+TEST(CriticManagerTests, ParallelCriticsShareCycleData)
+{
+  auto node = std::make_shared<rclcpp_lifecycle::LifecycleNode>("my_node");
+  node->declare_parameter("critic_manager.critic_threads", rclcpp::ParameterValue(3));
+  node->declare_parameter(
+    "critic_manager.DistanceFieldCritic.use_distance_field", rclcpp::ParameterValue(true));
+  auto costmap_ros = std::make_shared<nav2_costmap_2d::Costmap2DROS>(
+    "dummy_costmap", "", "dummy_costmap", true);
+  ParametersHandler param_handler(node);
+  rclcpp_lifecycle::State lstate;
+  costmap_ros->on_configure(lstate);
+
+  CriticManagerWrapperDistanceField critic_manager;
+  critic_manager.on_configure(node, "critic_manager", costmap_ros, &param_handler);
+
+  models::State state;
+  models::Trajectories generated_trajectories;
+  models::Path path;
+  xt::xtensor<float, 1> costs = xt::zeros<float>({10});
+  float model_dt = 0.1;
+  CriticData data =
+  {state, generated_trajectories, path, costs, model_dt, false, nullptr, nullptr,
+    std::nullopt, std::nullopt};
+  data.distance_field = std::make_shared<CostmapDistanceField>();
+  data.path_index = std::make_shared<PathSpatialIndex>(0.5f);
+  critic_manager.evalTrajectoriesScores(data);
+
+  // Every critic scored concurrently uses the field and path index shared by the optimizer
+  for (size_t i = 0; i < 3; ++i) {
+    EXPECT_EQ(critic_manager.getUsedField(i), data.distance_field.get());
+    EXPECT_EQ(critic_manager.getUsedPathIndex(i), data.path_index.get());
+  }
+}
+
+TEST(CriticManagerTests, CriticLatencyInstrumentation)
+{
+  auto node = std::make_shared<rclcpp_lifecycle::LifecycleNode>("my_node");
+  node->declare_parameter("critic_manager.latency_instrumentation", rclcpp::ParameterValue(true));
+  auto costmap_ros = std::make_shared<nav2_costmap_2d::Costmap2DROS>(
+    "dummy_costmap", "", "dummy_costmap", true);
+  ParametersHandler param_handler(node);
+  rclcpp_lifecycle::State lstate;
+  costmap_ros->on_configure(lstate);
+
+  CriticManagerWrapperAdding critic_manager;
+  critic_manager.on_configure(node, "critic_manager", costmap_ros, &param_handler);
+
+  models::State state;
+  models::Trajectories generated_trajectories;
+  models::Path path;
+  xt::xtensor<float, 1> costs = xt::zeros<float>({10});
+  float model_dt = 0.1;
+  CriticData data =
+  {state, generated_trajectories, path, costs, model_dt, false, nullptr, nullptr,
+    std::nullopt, std::nullopt};
+
+  // The second critic fails, so the third one is not scored
+  critic_manager.evalTrajectoriesScores(data);
+  data.fail_flag = false;
+  critic_manager.evalTrajectoriesScores(data);
+
+  std::vector<std::pair<std::string, LatencySummary>> latencies;
+  critic_manager.collectLatencies(latencies);
+  ASSERT_EQ(latencies.size(), 3u);
+  EXPECT_EQ(latencies[0].second.count, 2u);
+  EXPECT_EQ(latencies[1].second.count, 2u);
+  EXPECT_EQ(latencies[2].second.count, 0u);
+  EXPECT_GE(latencies[0].second.max_ms, latencies[0].second.mean_ms);
+
+  // Collecting restarts the window
+  latencies.clear();
+  critic_manager.collectLatencies(latencies);
+  ASSERT_EQ(latencies.size(), 3u);
+  EXPECT_EQ(latencies[0].second.count, 0u);
+}
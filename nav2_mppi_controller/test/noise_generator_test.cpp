@@ -24,6 +24,13 @@
 #include "nav2_mppi_controller/models/state.hpp"
 #include "nav2_mppi_controller/models/control_sequence.hpp"
 
+// xtensor creates warnings that needs to be ignored as we are building with -Werror
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Warray-bounds"
+#pragma GCC diagnostic ignored "-Wstringop-overflow"
+#include <xtensor/xmath.hpp>
+#pragma GCC diagnostic pop
+
 // Tests noise generator object
 
 class RosLockGuard
@@ -129,3 +136,92 @@ TEST(NoiseGeneratorTest, NoiseGeneratorMain)
 
   generator.shutdown();
 }
+
+TEST(NoiseGeneratorTest, NoiseGeneratorReusesReadyNoises)
+{
+  auto node = std::make_shared<rclcpp_lifecycle::LifecycleNode>("node");
+  node->declare_parameter("test_name.regenerate_noises", rclcpp::ParameterValue(true));
+  ParametersHandler handler(node);
+  NoiseGenerator generator;
+  mppi::models::OptimizerSettings settings;
+  settings.batch_size = 100;
+  settings.time_steps = 25;
+  settings.sampling_std.vx = 0.1;
+  settings.sampling_std.vy = 0.1;
+  settings.sampling_std.wz = 0.1;
+
+  mppi::models::ControlSequence control_sequence;
+  control_sequence.reset(25);
+  mppi::models::State first_state, second_state;
+  first_state.reset(settings.batch_size, settings.time_steps);
+  second_state.reset(settings.batch_size, settings.time_steps);
+
+  generator.initialize(settings, false, "test_name", &handler);
+  generator.reset(settings, false);
+  std::this_thread::sleep_for(std::chrono::milliseconds(100));
+
+  // Without a new generation requested, the same noises are handed out again
+  generator.setNoisedControls(first_state, control_sequence);
+  generator.setNoisedControls(second_state, control_sequence);
+  EXPECT_EQ(first_state.cvx, second_state.cvx);
+  EXPECT_EQ(first_state.cwz, second_state.cwz);
+
+  // Once generated, the next noises are picked up
+  generator.generateNextNoises();
+  std::this_thread::sleep_for(std::chrono::milliseconds(100));
+  generator.setNoisedControls(second_state, control_sequence);
+  EXPECT_NE(first_state.cvx, second_state.cvx);
+  EXPECT_NE(first_state.cwz, second_state.cwz);
+
+  generator.shutdown();
+}
+
+TEST(NoiseGeneratorTest, NoiseGeneratorReproducibleFromSeed)
+{
+  auto node = std::make_shared<rclcpp_lifecycle::LifecycleNode>("node");
+  node->declare_parameter("serial.noise_seed", rclcpp::ParameterValue(7));
+  node->declare_parameter("parallel.noise_seed", rclcpp::ParameterValue(7));
+  node->declare_parameter("parallel.noise_threads", rclcpp::ParameterValue(4));
+  node->declare_parameter("other_seed.noise_seed", rclcpp::ParameterValue(8));
+  ParametersHandler handler(node);
+  mppi::models::OptimizerSettings settings;
+  settings.batch_size = 100;
+  settings.time_steps = 25;
+  settings.sampling_std.vx = 0.1;
+  settings.sampling_std.vy = 0.1;
+  settings.sampling_std.wz = 0.1;
+
+  mppi::models::ControlSequence control_sequence;
+  control_sequence.reset(25);
+  mppi::models::State serial_state, parallel_state, other_seed_state;
+  serial_state.reset(settings.batch_size, settings.time_steps);
+  parallel_state.reset(settings.batch_size, settings.time_steps);
+  other_seed_state.reset(settings.batch_size, settings.time_steps);
+
+  NoiseGenerator serial, parallel, other_seed;
+  serial.initialize(settings, true, "serial", &handler);
+  parallel.initialize(settings, true, "parallel", &handler);
+  other_seed.initialize(settings, true, "other_seed", &handler);
+  serial.reset(settings, true);
+  parallel.reset(settings, true);
+  other_seed.reset(settings, true);
+  serial.setNoisedControls(serial_state, control_sequence);
+  parallel.setNoisedControls(parallel_state, control_sequence);
+  other_seed.setNoisedControls(other_seed_state, control_sequence);
+
+  // Same seed gives the same noises, however many threads generate them
+  EXPECT_EQ(serial_state.cvx, parallel_state.cvx);
+  EXPECT_EQ(serial_state.cvy, parallel_state.cvy);
+  EXPECT_EQ(serial_state.cwz, parallel_state.cwz);
+  EXPECT_NE(serial_state.cvx, other_seed_state.cvx);
+
+  // Rows and axes draw from distinct streams
+  EXPECT_NE(serial_state.cvx(0, 0), serial_state.cvx(1, 0));
+  EXPECT_NE(serial_state.cvx(0, 0), serial_state.cwz(0, 0));
+  EXPECT_NEAR(xt::mean(serial_state.cvx)(), 0.0, 0.01);
+  EXPECT_NEAR(xt::stddev(serial_state.cvx)(), 0.1, 0.01);
+
+  serial.shutdown();
+  parallel.shutdown();
+  other_seed.shutdown();
+}
@@ -12,15 +12,53 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+#include <atomic>
 #include <chrono>
+#include <cstdlib>
+#include <new>
 #include <thread>
 
 #include "gtest/gtest.h"
 #include "rclcpp/rclcpp.hpp"
 #include "nav2_mppi_controller/optimizer.hpp"
 
+// xtensor creates warnings that needs to be ignored as we are building with -Werror
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Warray-bounds"
+#pragma GCC diagnostic ignored "-Wstringop-overflow"
+#include <xtensor/xmath.hpp>
+#include <xtensor/xrandom.hpp>
+#include <xtensor/xview.hpp>
+#pragma GCC diagnostic pop
+
 // Tests main optimizer functions
 
+// Counts heap allocations made while g_count_allocations is set, so the
+// steady state of the optimization loop can be checked to be allocation free
+std::atomic<bool> g_count_allocations{false};
+std::atomic<size_t> g_allocations{0};
+
+void * operator new(std::size_t size)
+{
+  if (g_count_allocations) {
+    g_allocations++;
+  }
+  if (void * ptr = std::malloc(size == 0 ? 1 : size)) {
+    return ptr;
+  }
+  throw std::bad_alloc();
+}
+
+void operator delete(void * ptr) noexcept
+{
+  std::free(ptr);
+}
+
+void operator delete(void * ptr, std::size_t) noexcept
+{
+  std::free(ptr);
+}
+
 class RosLockGuard
 {
 public:
@@ -216,6 +254,47 @@ public:
     return getControlFromSequenceAsTwist(stamp);
   }
 
+  void optimizeWrapper()
+  {
+    optimize();
+  }
+
+  void testKeptSamples()
+  {
+    // Sample i has cost 1000 - i, so the last samples are the best ones
+    for (unsigned int i = 0; i != 1000; i++) {
+      costs_(i) = 1000.0f - i;
+      xt::view(state_.cvx, i, xt::all()) = static_cast<float>(i);
+      xt::view(state_.cwz, i, xt::all()) = -static_cast<float>(i);
+    }
+    state_.cvx(999, 1) = 42.0f;
+    keepBestSamples();
+
+    state_.cvx.fill(0.5f);
+    state_.cwz.fill(0.5f);
+    injectKeptSamples();
+    EXPECT_EQ(state_.cvx(0, 0), 999.0f);
+    EXPECT_EQ(state_.cvx(0, 1), 42.0f);
+    EXPECT_EQ(state_.cwz(0, 0), -999.0f);
+    EXPECT_EQ(state_.cvx(2, 0), 997.0f);
+    EXPECT_EQ(state_.cvx(3, 0), 0.5f);  // Only kept_samples are reused
+    EXPECT_EQ(state_.cvx(999, 10), 0.0f);  // Braking sample
+    EXPECT_EQ(state_.cwz(999, 10), 0.0f);
+
+    // Between cycles, kept samples advance by a time step
+    shiftKeptSamples();
+    injectKeptSamples();
+    EXPECT_EQ(state_.cvx(0, 0), 42.0f);
+    EXPECT_EQ(state_.cvx(0, 1), 999.0f);
+    EXPECT_EQ(state_.cvx(0, 49), 999.0f);
+
+    // And are dropped on reset
+    reset();
+    state_.cvx.fill(0.5f);
+    injectKeptSamples();
+    EXPECT_EQ(state_.cvx(0, 0), 0.5f);
+  }
+
   void integrateStateVelocitiesWrapper(
     models::Trajectories & traj,
     const models::State & state)
@@ -651,4 +730,155 @@ TEST(OptimizerTests, integrateStateVelocitiesTests)
     EXPECT_NEAR(traj.x(1, i), x, 1e-6);
     EXPECT_NEAR(traj.y(1, i), y, 1e-6);
   }
+
+  // The single pass rollout matches the batch tensor expressions it replaced
+  state.pose.pose.position.x = 1.5;
+  state.pose.pose.position.y = -0.5;
+  state.pose.pose.orientation.z = sin(0.35);
+  state.pose.pose.orientation.w = cos(0.35);
+  state.vx = xt::random::rand<float>({1000, 50}, -0.5, 0.5);
+  state.vy = xt::random::rand<float>({1000, 50}, -0.5, 0.5);
+  state.wz = xt::random::rand<float>({1000, 50}, -1.0, 1.0);
+  optimizer_tester.integrateStateVelocitiesWrapper(traj, state);
+
+  const float dt = 0.1f;
+  const float initial_yaw = static_cast<float>(tf2::getYaw(state.pose.pose.orientation));
+  xt::xtensor<float, 2> yaws = xt::cumsum(state.wz * dt, {1}) + initial_yaw;
+  auto yaw_cos = xt::roll(xt::eval(xt::cos(yaws)), 1, 1);
+  auto yaw_sin = xt::roll(xt::eval(xt::sin(yaws)), 1, 1);
+  xt::view(yaw_cos, xt::all(), 0) = cosf(initial_yaw);
+  xt::view(yaw_sin, xt::all(), 0) = sinf(initial_yaw);
+  auto && dx = xt::eval(state.vx * yaw_cos - state.vy * yaw_sin);
+  auto && dy = xt::eval(state.vx * yaw_sin + state.vy * yaw_cos);
+  xt::xtensor<float, 2> xs = state.pose.pose.position.x + xt::cumsum(dx * dt, {1});
+  xt::xtensor<float, 2> ys = state.pose.pose.position.y + xt::cumsum(dy * dt, {1});
+
+  EXPECT_TRUE(xt::allclose(traj.yaws, yaws, 1e-5, 1e-6));
+  EXPECT_TRUE(xt::allclose(traj.x, xs, 1e-5, 1e-6));
+  EXPECT_TRUE(xt::allclose(traj.y, ys, 1e-5, 1e-6));
+}
+
+TEST(OptimizerTests, parallelRolloutTests)
+{
+  auto node = std::make_shared<rclcpp_lifecycle::LifecycleNode>("my_node");
+  OptimizerTester serial_tester, parallel_tester;
+  node->declare_parameter("controller_frequency", rclcpp::ParameterValue(30.0));
+  node->declare_parameter("mppic.batch_size", rclcpp::ParameterValue(1000));
+  node->declare_parameter("mppic.model_dt", rclcpp::ParameterValue(0.1));
+  node->declare_parameter("mppic.time_steps", rclcpp::ParameterValue(50));
+  node->declare_parameter("mppic.motion_model", rclcpp::ParameterValue("Omni"));
+  auto costmap_ros = std::make_shared<nav2_costmap_2d::Costmap2DROS>(
+    "dummy_costmap", "", "dummy_costmap", true);
+  ParametersHandler param_handler(node);
+  rclcpp_lifecycle::State lstate;
+  costmap_ros->on_configure(lstate);
+  serial_tester.initialize(node, "mppic", costmap_ros, &param_handler);
+  node->declare_parameter("mppic2.batch_size", rclcpp::ParameterValue(1000));
+  node->declare_parameter("mppic2.model_dt", rclcpp::ParameterValue(0.1));
+  node->declare_parameter("mppic2.time_steps", rclcpp::ParameterValue(50));
+  node->declare_parameter("mppic2.motion_model", rclcpp::ParameterValue("Omni"));
+  node->declare_parameter("mppic2.rollout_threads", rclcpp::ParameterValue(4));
+  parallel_tester.initialize(node, "mppic2", costmap_ros, &param_handler);
+
+  // Rolling out in ranges of the batch gives the same trajectories as the serial rollout
+  models::State state;
+  state.reset(1000, 50);
+  state.pose.pose.orientation.z = sin(0.2);
+  state.pose.pose.orientation.w = cos(0.2);
+  state.vx = xt::random::rand<float>({1000, 50}, -0.5, 0.5);
+  state.vy = xt::random::rand<float>({1000, 50}, -0.5, 0.5);
+  state.wz = xt::random::rand<float>({1000, 50}, -1.0, 1.0);
+  models::Trajectories serial_traj, parallel_traj;
+  serial_tester.integrateStateVelocitiesWrapper(serial_traj, state);
+  parallel_tester.integrateStateVelocitiesWrapper(parallel_traj, state);
+
+  EXPECT_EQ(serial_traj.x, parallel_traj.x);
+  EXPECT_EQ(serial_traj.y, parallel_traj.y);
+  EXPECT_EQ(serial_traj.yaws, parallel_traj.yaws);
+}
+
+TEST(OptimizerTests, optimizeDoesNotAllocateTests)
+{
+  auto node = std::make_shared<rclcpp_lifecycle::LifecycleNode>("my_node");
+  OptimizerTester optimizer_tester;
+  node->declare_parameter("controller_frequency", rclcpp::ParameterValue(30.0));
+  node->declare_parameter("mppic.batch_size", rclcpp::ParameterValue(1000));
+  node->declare_parameter("mppic.time_steps", rclcpp::ParameterValue(50));
+  node->declare_parameter("mppic.iteration_count", rclcpp::ParameterValue(2));
+  auto costmap_ros = std::make_shared<nav2_costmap_2d::Costmap2DROS>(
+    "dummy_costmap", "", "dummy_costmap", true);
+  ParametersHandler param_handler(node);
+  rclcpp_lifecycle::State lstate;
+  costmap_ros->on_configure(lstate);
+  optimizer_tester.initialize(node, "mppic", costmap_ros, &param_handler);
+
+  geometry_msgs::msg::PoseStamped pose;
+  pose.pose.position.x = 999;
+  geometry_msgs::msg::Twist speed;
+  speed.linear.y = 4.0;
+  nav_msgs::msg::Path path;
+  path.poses.resize(17);
+  optimizer_tester.testPrepare(pose, speed, path, nullptr);
+
+  // The first iteration may still size the buffers, the following ones must reuse them
+  optimizer_tester.optimizeWrapper();
+  g_allocations = 0;
+  g_count_allocations = true;
+  optimizer_tester.optimizeWrapper();
+  g_count_allocations = false;
+  EXPECT_EQ(g_allocations.load(), 0u);
+}
+
+TEST(OptimizerTests, adaptiveSamplingTests)
+{
+  auto node = std::make_shared<rclcpp_lifecycle::LifecycleNode>("my_node");
+  OptimizerTester optimizer_tester;
+  node->declare_parameter("controller_frequency", rclcpp::ParameterValue(30.0));
+  node->declare_parameter("mppic.batch_size", rclcpp::ParameterValue(1000));
+  node->declare_parameter("mppic.time_steps", rclcpp::ParameterValue(50));
+  node->declare_parameter("mppic.iteration_count", rclcpp::ParameterValue(3));
+  node->declare_parameter("mppic.adaptive_sampling", rclcpp::ParameterValue(true));
+  node->declare_parameter("mppic.min_batch_size", rclcpp::ParameterValue(100));
+  node->declare_parameter("mppic.max_batch_size", rclcpp::ParameterValue(1000));
+  // A budget far too small for any batch size
+  node->declare_parameter("mppic.time_budget_fraction", rclcpp::ParameterValue(1e-6));
+  auto costmap_ros = std::make_shared<nav2_costmap_2d::Costmap2DROS>(
+    "dummy_costmap", "", "dummy_costmap", true);
+  ParametersHandler param_handler(node);
+  rclcpp_lifecycle::State lstate;
+  costmap_ros->on_configure(lstate);
+  optimizer_tester.initialize(node, "mppic", costmap_ros, &param_handler);
+  EXPECT_TRUE(optimizer_tester.isAdaptiveSampling());
+  EXPECT_EQ(optimizer_tester.getBatchSize(), 1000u);
+
+  geometry_msgs::msg::PoseStamped pose;
+  geometry_msgs::msg::Twist speed;
+  nav_msgs::msg::Path path;
+  path.poses.resize(17);
+
+  // Shrinks down to the smallest batch size, keeping a valid optimization throughout
+  for (unsigned int i = 0; i != 10; i++) {
+    EXPECT_NO_THROW(optimizer_tester.evalControl(pose, speed, path, nullptr));
+  }
+  EXPECT_EQ(optimizer_tester.getBatchSize(), 100u);
+  EXPECT_EQ(optimizer_tester.getGeneratedTrajectories().x.shape(0), 100u);
+}
+
+TEST(OptimizerTests, keptSamplesTests)
+{
+  auto node = std::make_shared<rclcpp_lifecycle::LifecycleNode>("my_node");
+  OptimizerTester optimizer_tester;
+  node->declare_parameter("controller_frequency", rclcpp::ParameterValue(30.0));
+  node->declare_parameter("mppic.batch_size", rclcpp::ParameterValue(1000));
+  node->declare_parameter("mppic.time_steps", rclcpp::ParameterValue(50));
+  node->declare_parameter("mppic.kept_samples", rclcpp::ParameterValue(3));
+  node->declare_parameter("mppic.braking_sample", rclcpp::ParameterValue(true));
+  auto costmap_ros = std::make_shared<nav2_costmap_2d::Costmap2DROS>(
+    "dummy_costmap", "", "dummy_costmap", true);
+  ParametersHandler param_handler(node);
+  rclcpp_lifecycle::State lstate;
+  costmap_ros->on_configure(lstate);
+  optimizer_tester.initialize(node, "mppic", costmap_ros, &param_handler);
+
+  optimizer_tester.testKeptSamples();
 }
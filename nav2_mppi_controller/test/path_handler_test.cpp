@@ -205,6 +205,63 @@ TEST(PathHandlerTests, TestTransforms)
   EXPECT_EQ(final_path.poses.size(), path_out.poses.size());
 }
 
+TEST(PathHandlerTests, TestIncrementalPruning)
+{
+  PathHandlerWrapper handler;
+  auto node = std::make_shared<rclcpp_lifecycle::LifecycleNode>("my_node");
+  node->declare_parameter("dummy.max_robot_pose_search_dist", rclcpp::ParameterValue(99999.9));
+  auto costmap_ros = std::make_shared<nav2_costmap_2d::Costmap2DROS>(
+    "dummy_costmap", "", "dummy_costmap", true);
+  ParametersHandler param_handler(node);
+  rclcpp_lifecycle::State state;
+  costmap_ros->on_configure(state);
+  handler.initialize(node, "dummy", costmap_ros, costmap_ros->getTfBuffer(), &param_handler);
+
+  // Plan, robot and costmap share the map frame
+  nav_msgs::msg::Path path;
+  path.header.frame_id = "map";
+  path.poses.resize(100);
+  for (unsigned int i = 0; i != path.poses.size(); i++) {
+    path.poses[i].pose.position.x = 0.05 * i;
+    path.poses[i].pose.position.y = 1.0;
+  }
+  handler.setPath(path);
+
+  geometry_msgs::msg::PoseStamped robot_pose;
+  robot_pose.header.frame_id = "map";
+  robot_pose.pose.position.x = 1.0;
+  robot_pose.pose.position.y = 1.0;
+
+  // Pruned poses are skipped, but kept while they are not most of the plan
+  auto plan = handler.transformPath(robot_pose);
+  EXPECT_EQ(plan.header.frame_id, "map");
+  EXPECT_NEAR(plan.poses.front().pose.position.x, 1.0, 1e-6);
+  EXPECT_EQ(handler.getInvertedPath().poses.size(), 100u);
+
+  // Going backwards does not unprune poses
+  robot_pose.pose.position.x = 0.0;
+  plan = handler.transformPath(robot_pose);
+  EXPECT_NEAR(plan.poses.front().pose.position.x, 1.0, 1e-6);
+
+  // Then erased once they are
+  robot_pose.pose.position.x = 3.0;
+  plan = handler.transformPath(robot_pose);
+  EXPECT_NEAR(plan.poses.front().pose.position.x, 3.0, 1e-6);
+  EXPECT_EQ(handler.getInvertedPath().poses.size(), 40u);
+
+  // Search continues from the remaining poses
+  robot_pose.pose.position.x = 3.5;
+  plan = handler.transformPath(robot_pose);
+  EXPECT_NEAR(plan.poses.front().pose.position.x, 3.5, 1e-6);
+  EXPECT_EQ(handler.getInvertedPath().poses.size(), 40u);
+
+  // A new path resets the pruning
+  handler.setPath(path);
+  robot_pose.pose.position.x = 0.5;
+  plan = handler.transformPath(robot_pose);
+  EXPECT_NEAR(plan.poses.front().pose.position.x, 0.5, 1e-6);
+}
+
 TEST(PathHandlerTests, TestInversionToleranceChecks)
 {
   nav_msgs::msg::Path path;
@@ -95,36 +95,39 @@ TEST(TrajectoryVisualizerTests, VisOptimalTrajectory)
 
   rclcpp::spin_some(node->get_node_base_interface());
 
-  // Should have 20 trajectory points in the map frame
-  EXPECT_EQ(recieved_msg.markers.size(), 20u);
-  EXPECT_EQ(recieved_msg.markers[0].header.frame_id, "fkmap");
-
-  // Check IDs are properly populated
-  EXPECT_EQ(recieved_msg.markers[0].id, 0);
-  EXPECT_EQ(recieved_msg.markers[1].id, 1);
-  EXPECT_EQ(recieved_msg.markers[10].id, 10);
-
-  // Check poses are correct
-  EXPECT_EQ(recieved_msg.markers[0].pose.position.x, 1);
-  EXPECT_EQ(recieved_msg.markers[0].pose.position.y, 1);
-  EXPECT_EQ(recieved_msg.markers[0].pose.position.z, 0.06);
-
-  // Check that scales are rational
-  EXPECT_EQ(recieved_msg.markers[0].scale.x, 0.03);
-  EXPECT_EQ(recieved_msg.markers[0].scale.y, 0.03);
-  EXPECT_EQ(recieved_msg.markers[0].scale.z, 0.07);
-
-  EXPECT_EQ(recieved_msg.markers[19].scale.x, 0.07);
-  EXPECT_EQ(recieved_msg.markers[19].scale.y, 0.07);
-  EXPECT_EQ(recieved_msg.markers[19].scale.z, 0.09);
+  // Should have a line of 20 trajectory points in the map frame
+  ASSERT_EQ(recieved_msg.markers.size(), 1u);
+  const auto & marker = recieved_msg.markers[0];
+  EXPECT_EQ(marker.header.frame_id, "fkmap");
+  EXPECT_EQ(marker.id, 0);
+  EXPECT_EQ(marker.type, visualization_msgs::msg::Marker::LINE_STRIP);
+  ASSERT_EQ(marker.points.size(), 20u);
+  ASSERT_EQ(marker.colors.size(), 20u);
+
+  // Check points are correct
+  EXPECT_EQ(marker.points[0].x, 1);
+  EXPECT_EQ(marker.points[0].y, 1);
+  EXPECT_EQ(marker.points[0].z, 0.06);
+
+  // Check that the scale is rational
+  EXPECT_GT(marker.scale.x, 0.0);
 
   // Check that the colors are rational
-  for (unsigned int i = 0; i != recieved_msg.markers.size() - 1; i++) {
-    EXPECT_LT(recieved_msg.markers[i].color.g, recieved_msg.markers[i + 1].color.g);
-    EXPECT_LT(recieved_msg.markers[i].color.b, recieved_msg.markers[i + 1].color.b);
-    EXPECT_EQ(recieved_msg.markers[i].color.r, recieved_msg.markers[i + 1].color.r);
-    EXPECT_EQ(recieved_msg.markers[i].color.a, recieved_msg.markers[i + 1].color.a);
+  for (unsigned int i = 0; i != marker.colors.size() - 1; i++) {
+    EXPECT_LT(marker.colors[i].g, marker.colors[i + 1].g);
+    EXPECT_LT(marker.colors[i].b, marker.colors[i + 1].b);
+    EXPECT_EQ(marker.colors[i].r, marker.colors[i + 1].r);
+    EXPECT_EQ(marker.colors[i].a, marker.colors[i + 1].a);
   }
+
+  // The markers are reused on the next cycle
+  vis.add(optimal_trajectory, "Optimal Trajectory");
+  vis.visualize(bogus_path);
+
+  rclcpp::spin_some(node->get_node_base_interface());
+  ASSERT_EQ(recieved_msg.markers.size(), 1u);
+  EXPECT_EQ(recieved_msg.markers[0].id, 0);
+  EXPECT_EQ(recieved_msg.markers[0].points.size(), 20u);
 }
 
 TEST(TrajectoryVisualizerTests, VisCandidateTrajectories)
@@ -150,6 +153,39 @@ TEST(TrajectoryVisualizerTests, VisCandidateTrajectories)
   vis.visualize(bogus_path);
 
   rclcpp::spin_some(node->get_node_base_interface());
-  // 40 * 4, for 5 trajectory steps + 3 point steps
-  EXPECT_EQ(recieved_msg.markers.size(), 160u);
+  // 40 lines of 4 points, for 5 trajectory steps + 3 point steps
+  ASSERT_EQ(recieved_msg.markers.size(), 40u);
+  EXPECT_EQ(recieved_msg.markers[39].id, 39);
+  EXPECT_EQ(recieved_msg.markers[0].points.size(), 4u);
+  EXPECT_EQ(recieved_msg.markers[0].colors.size(), 4u);
+}
+
+TEST(TrajectoryVisualizerTests, VisOnlyWhenSubscribed)
+{
+  auto node = std::make_shared<rclcpp_lifecycle::LifecycleNode>("my_node");
+  auto parameters_handler = std::make_unique<ParametersHandler>(node);
+
+  models::Trajectories candidate_trajectories;
+  candidate_trajectories.x = xt::ones<float>({200, 12});
+  candidate_trajectories.y = xt::ones<float>({200, 12});
+  candidate_trajectories.yaws = xt::ones<float>({200, 12});
+
+  // No markers are built without a subscription
+  TrajectoryVisualizer vis;
+  vis.on_configure(node, "my_name", "fkmap", parameters_handler.get());
+  vis.on_activate();
+  vis.add(candidate_trajectories, "Candidate Trajectories");
+  nav_msgs::msg::Path bogus_path;
+  vis.visualize(bogus_path);
+
+  visualization_msgs::msg::MarkerArray recieved_msg;
+  auto my_sub = node->create_subscription<visualization_msgs::msg::MarkerArray>(
+    "/trajectories", 10,
+    [&](const visualization_msgs::msg::MarkerArray msg) {recieved_msg = msg;});
+
+  vis.add(candidate_trajectories, "Candidate Trajectories");
+  vis.visualize(bogus_path);
+
+  rclcpp::spin_some(node->get_node_base_interface());
+  EXPECT_EQ(recieved_msg.markers.size(), 40u);
 }
@@ -22,6 +22,7 @@
 
 #include "gtest/gtest.h"
 #include "rclcpp/rclcpp.hpp"
+#include "nav2_mppi_controller/tools/latency_histogram.hpp"
 #include "nav2_mppi_controller/tools/utils.hpp"
 #include "nav2_mppi_controller/models/path.hpp"
 
@@ -261,6 +262,12 @@ TEST(UtilsTests, FurthestAndClosestReachedPoint)
   {state, generated_trajectories, path, costs, model_dt, false, nullptr, nullptr,
     std::nullopt, std::nullopt};  /// Caution, keep references
   EXPECT_EQ(findPathFurthestReachedPoint(data3), 5u);
+
+  // Same point found with the spatial index of the path
+  data3.path_index = std::make_shared<PathSpatialIndex>(0.25f);
+  EXPECT_EQ(findPathFurthestReachedPoint(data3), 5u);
+  generated_trajectories.x(50, 1) = 1.45f;
+  EXPECT_EQ(findPathFurthestReachedPoint(data3), 7u);
 }
 
 TEST(UtilsTests, findPathCosts)
@@ -446,3 +453,112 @@ TEST(UtilsTests, RemovePosesAfterPathInversionTest)
   EXPECT_EQ(path.poses.size(), 11u);
   EXPECT_EQ(path.poses.back().pose.position.x, 10);
 }
+
+TEST(UtilsTests, CostmapDistanceFieldTest)
+{
+  nav2_costmap_2d::Costmap2D costmap(100, 80, 0.05, -1.0, 2.0, 0);
+  costmap.setCost(20, 30, nav2_costmap_2d::LETHAL_OBSTACLE);
+  costmap.setCost(70, 10, nav2_costmap_2d::LETHAL_OBSTACLE);
+  costmap.setCost(50, 75, nav2_costmap_2d::NO_INFORMATION);
+
+  auto trueDistance = [&](float wx, float wy, bool unknown_is_obstacle) {
+      float closest = std::numeric_limits<float>::max();
+      std::vector<std::pair<unsigned int, unsigned int>> cells = {{20, 30}, {70, 10}};
+      if (unknown_is_obstacle) {
+        cells.push_back({50, 75});
+      }
+      for (const auto & cell : cells) {
+        double cx, cy;
+        costmap.mapToWorld(cell.first, cell.second, cx, cy);
+        closest = std::min(
+          closest, std::hypot(wx - static_cast<float>(cx), wy - static_cast<float>(cy)));
+      }
+      return closest;
+    };
+
+  // Distances never overestimate the true ones, and stay within a cell diagonal of them
+  for (unsigned int downsampling : {1u, 3u}) {
+    CostmapDistanceField field(downsampling);
+    field.updateIfInvalid(costmap, true);
+    const float tolerance = 0.05f * downsampling * 1.5f;
+    for (float wx = -0.95f; wx < 4.0f; wx += 0.13f) {
+      for (float wy = 2.05f; wy < 6.0f; wy += 0.11f) {
+        const float distance = field.distance(wx, wy);
+        EXPECT_LE(distance, trueDistance(wx, wy, false) + 1e-4f);
+        EXPECT_GE(distance, trueDistance(wx, wy, false) - tolerance);
+      }
+    }
+  }
+
+  // Unknown space is an obstacle when not tracking it, and it only updates once invalidated
+  CostmapDistanceField field;
+  double wx, wy;
+  costmap.mapToWorld(50, 75, wx, wy);
+  field.updateIfInvalid(costmap, true);
+  EXPECT_GT(field.distance(wx, wy), 0.5f);
+  field.updateIfInvalid(costmap, false);
+  EXPECT_GT(field.distance(wx, wy), 0.5f);
+  field.invalidate();
+  field.updateIfInvalid(costmap, false);
+  EXPECT_LT(field.distance(wx, wy), 0.0f);
+  EXPECT_LE(field.distance(wx + 0.5, wy), trueDistance(wx + 0.5, wy, true) + 1e-4f);
+
+  // Circles cover the whole footprint and are placed with the pose
+  std::vector<geometry_msgs::msg::Point> footprint(4);
+  footprint[0].x = 0.5; footprint[0].y = 0.2;
+  footprint[1].x = 0.5; footprint[1].y = -0.2;
+  footprint[2].x = -0.3; footprint[2].y = -0.2;
+  footprint[3].x = -0.3; footprint[3].y = 0.2;
+  auto circles = approximateFootprintWithCircles(footprint);
+  EXPECT_EQ(circles.size(), 2u);
+  for (const auto & pt : footprint) {
+    bool covered = false;
+    for (const auto & circle : circles) {
+      covered |= std::hypot(pt.x - circle.x, pt.y - circle.y) <= circle.radius + 1e-5;
+    }
+    EXPECT_TRUE(covered);
+  }
+
+  double obstacle_x, obstacle_y;
+  costmap.mapToWorld(20, 30, obstacle_x, obstacle_y);
+  EXPECT_LT(field.clearance(obstacle_x - 0.4f, obstacle_y, 0.0f, circles), 0.0f);
+  EXPECT_GT(field.clearance(obstacle_x - 0.4f, obstacle_y + 0.6f, 0.0f, circles), 0.0f);
+}
+
+TEST(UtilsTests, LatencyHistogramTest)
+{
+  LatencyHistogram histogram;
+  EXPECT_EQ(histogram.collect().count, 0u);
+
+  // 0.1ms to 10ms
+  for (unsigned int i = 1; i <= 100; i++) {
+    histogram.record(i * 1e-4);
+  }
+  auto summary = histogram.collect();
+  EXPECT_EQ(summary.count, 100u);
+  EXPECT_NEAR(summary.mean_ms, 5.05f, 1e-3f);
+  EXPECT_NEAR(summary.max_ms, 10.0f, 1e-3f);
+  // Percentiles are within a bucket, i.e. a factor sqrt(2), above the exact ones
+  EXPECT_GE(summary.p50_ms, 5.0f);
+  EXPECT_LE(summary.p50_ms, 5.0f * 1.415f);
+  EXPECT_GE(summary.p99_ms, 9.9f);
+  EXPECT_LE(summary.p99_ms, summary.max_ms);
+  EXPECT_EQ(histogram.collect().count, 0u);
+
+  // Concurrent recordings are all accounted
+  std::vector<std::thread> threads;
+  for (unsigned int i = 0; i != 4; i++) {
+    threads.emplace_back(
+      [&histogram]() {
+        for (unsigned int j = 0; j != 1000; j++) {
+          histogram.record(1e-3);
+        }
+      });
+  }
+  for (auto & thread : threads) {
+    thread.join();
+  }
+  summary = histogram.collect();
+  EXPECT_EQ(summary.count, 4000u);
+  EXPECT_NEAR(summary.mean_ms, 1.0f, 1e-3f);
+}
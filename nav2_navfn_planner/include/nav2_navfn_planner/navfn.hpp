@@ -114,7 +114,8 @@ public:
   ~NavFn();
 
   /**
-   * @brief  Sets or resets the size of the map
+   * @brief  Sets or resets the size of the map, the cell arrays are only
+   * reallocated if the number of cells changed
    * @param nx The x size of the map
    * @param ny The y size of the map
    */
@@ -140,8 +141,12 @@ public:
   /**
    * @brief Calculates the full navigation function using Dijkstra
    * @param cancelChecker Function to check if the task has been canceled
+   * @param atStart Whether or not to stop when the start point is reached
+   * @param margin Potential beyond the start one to keep propagating to once reached
    */
-  bool calcNavFnDijkstra(std::function<bool()> cancelChecker, bool atStart = false);
+  bool calcNavFnDijkstra(
+    std::function<bool()> cancelChecker, bool atStart = false,
+    float margin = 0.0f);
 
   /**
    * @brief  Accessor for the x-coordinates of a path
@@ -237,9 +242,13 @@ public:
    * @param cycles The maximum number of iterations to run for
    * @param cancelChecker Function to check if the task has been canceled
    * @param atStart Whether or not to stop when the start point is reached
+   * @param margin Potential beyond the start one to keep propagating to once reached,
+   * so that the potentials of the cells around the start are settled as well
    * @return true if the start point is reached
    */
-  bool propNavFnDijkstra(int cycles, std::function<bool()> cancelChecker, bool atStart = false);
+  bool propNavFnDijkstra(
+    int cycles, std::function<bool()> cancelChecker, bool atStart = false,
+    float margin = 0.0f);
 
   /**
    * @brief  Run propagation for <cycles> iterations, or until start is reached using
@@ -105,6 +105,21 @@ protected:
     std::function<bool()> cancel_checker,
     nav_msgs::msg::Path & plan);
 
+  /**
+   * @brief Compute a plan by descending a Dijkstra potential propagated from the goal.
+   * The potential is kept for the next plans to the same goal on unchanged costs, which
+   * only extract a path from their start if the kept potential spans it.
+   * @param map_start Start cell
+   * @param map_goal Goal cell
+   * @param cancel_checker Function to check if the task has been canceled
+   * @param plan Path to be computed
+   * @return true if the start is reachable from the goal
+   */
+  bool makePlanFromGoalPotential(
+    int * map_start, int * map_goal,
+    std::function<bool()> cancel_checker,
+    nav_msgs::msg::Path & plan);
+
   /**
    * @brief Compute the navigation function given a seed point in the world to start from
    * @param world_point Point in world coordinate frame
@@ -220,6 +235,18 @@ protected:
   // Whether to use the astar planner or default dijkstras
   bool use_astar_;
 
+  // Whether to propagate the dijkstras potential from the goal and keep it across plans
+  bool reuse_potential_;
+
+  // Distance (m) to keep propagating the dijkstras potential past the cell to reach
+  double propagation_margin_;
+
+  // Costs, goal cell and highest spanned potential of the kept goal potential
+  std::vector<COSTTYPE> kept_costs_;
+  int kept_goal_index_{-1};
+  float kept_potential_bound_{0.0f};
+  bool potential_kept_{false};
+
   // parent node weak ptr
   rclcpp_lifecycle::LifecycleNode::WeakPtr node_;
 
@@ -208,6 +208,16 @@ NavFn::setNavArr(int xs, int ys)
 {
   RCLCPP_DEBUG(rclcpp::get_logger("rclcpp"), "[NavFn] Array is %d x %d\n", xs, ys);
 
+  // keep the buffers of the previous plans if the number of cells did not change,
+  // reallocating and faulting them in on every plan is as slow as the propagation
+  if (costarr && xs * ys == ns) {
+    nx = xs;
+    ny = ys;
+    std::fill_n(costarr, ns, 0);
+    std::fill_n(pending, ns, false);
+    return;
+  }
+
   nx = xs;
   ny = ys;
   ns = nx * ny;
@@ -294,12 +304,12 @@ NavFn::setCostmap(const COSTTYPE * cmap, bool isROS, bool allow_unknown)
 }
 
 bool
-NavFn::calcNavFnDijkstra(std::function<bool()> cancelChecker, bool atStart)
+NavFn::calcNavFnDijkstra(std::function<bool()> cancelChecker, bool atStart, float margin)
 {
   setupNavFn(true);
 
   // calculate the nav fn and path
-  return propNavFnDijkstra(std::max(nx * ny / 20, nx + ny), cancelChecker, atStart);
+  return propNavFnDijkstra(std::max(nx * ny / 20, nx + ny), cancelChecker, atStart, margin);
 }
 
 
@@ -341,14 +351,13 @@ int NavFn::getPathLen() {return npath;}
 void
 NavFn::setupNavFn(bool keepit)
 {
-  // reset values in propagation arrays
-  for (int i = 0; i < ns; i++) {
-    potarr[i] = POT_HIGH;
-    if (!keepit) {
-      costarr[i] = COST_NEUTRAL;
-    }
-    gradx[i] = grady[i] = 0.0;
+  // reset values in propagation arrays, one array at a time so that the fills vectorize
+  std::fill_n(potarr, ns, POT_HIGH);
+  if (!keepit) {
+    std::fill_n(costarr, ns, COST_NEUTRAL);
   }
+  std::fill_n(gradx, ns, 0.0f);
+  std::fill_n(grady, ns, 0.0f);
 
   // outer bounds of cost array
   COSTTYPE * pc;
@@ -384,14 +393,8 @@ NavFn::setupNavFn(bool keepit)
   initCost(k, 0);
 
   // find # of obstacle cells
-  pc = costarr;
-  int ntot = 0;
-  for (int i = 0; i < ns; i++, pc++) {
-    if (*pc >= COST_OBS) {
-      ntot++;  // number of cells that are obstacles
-    }
-  }
-  nobs = ntot;
+  nobs = static_cast<int>(
+    std::count_if(costarr, costarr + ns, [](COSTTYPE c) {return c >= COST_OBS;}));
 }
 
 
@@ -572,7 +575,9 @@ NavFn::updateCellAstar(int n)
 //
 
 bool
-NavFn::propNavFnDijkstra(int cycles, std::function<bool()> cancelChecker, bool atStart)
+NavFn::propNavFnDijkstra(
+  int cycles, std::function<bool()> cancelChecker, bool atStart,
+  float margin)
 {
   int nwv = 0;  // max priority block size
   int nc = 0;  // number of cells put into priority blocks
@@ -631,9 +636,11 @@ NavFn::propNavFnDijkstra(int cycles, std::function<bool()> cancelChecker, bool a
       overP = pb;
     }
 
-    // check if we've hit the Start cell
+    // check if we've hit the Start cell, and propagated past it by the margin
     if (atStart) {
-      if (potarr[startCell] < POT_HIGH) {
+      if (potarr[startCell] < POT_HIGH &&
+        (margin <= 0.0f || curT > potarr[startCell] + margin))
+      {
         break;
       }
     }
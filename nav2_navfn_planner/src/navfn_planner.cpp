@@ -23,6 +23,7 @@
 
 #include "nav2_navfn_planner/navfn_planner.hpp"
 
+#include <algorithm>
 #include <chrono>
 #include <cmath>
 #include <iomanip>
@@ -90,6 +91,12 @@ NavfnPlanner::configure(
   declare_parameter_if_not_declared(
     node, name + ".use_final_approach_orientation", rclcpp::ParameterValue(false));
   node->get_parameter(name + ".use_final_approach_orientation", use_final_approach_orientation_);
+  declare_parameter_if_not_declared(
+    node, name + ".reuse_potential", rclcpp::ParameterValue(false));
+  node->get_parameter(name + ".reuse_potential", reuse_potential_);
+  declare_parameter_if_not_declared(
+    node, name + ".propagation_margin", rclcpp::ParameterValue(0.0));
+  node->get_parameter(name + ".propagation_margin", propagation_margin_);
 
   // Create a planner based on the new costmap size
   planner_ = std::make_unique<NavFn>(
@@ -260,88 +267,170 @@ NavfnPlanner::makePlan(
   map_goal[0] = mx;
   map_goal[1] = my;
 
-  planner_->setStart(map_goal);
-  planner_->setGoal(map_start);
-  if (use_astar_) {
-    planner_->calcNavFnAstar(cancel_checker);
-  } else {
-    planner_->calcNavFnDijkstra(cancel_checker, true);
+  geometry_msgs::msg::Pose best_pose = goal;
+  bool planned = false;
+  if (!use_astar_ && reuse_potential_) {
+    planned = makePlanFromGoalPotential(map_start, map_goal, cancel_checker, plan);
   }
 
-  double resolution = costmap_->getResolution();
-  geometry_msgs::msg::Pose p, best_pose;
+  if (!planned) {
+    potential_kept_ = false;
+    planner_->setStart(map_goal);
+    planner_->setGoal(map_start);
+    if (use_astar_) {
+      planner_->calcNavFnAstar(cancel_checker);
+    } else {
+      const float margin = propagation_margin_ / costmap_->getResolution() * COST_NEUTRAL;
+      planner_->calcNavFnDijkstra(cancel_checker, true, margin);
+    }
+
+    double resolution = costmap_->getResolution();
+    geometry_msgs::msg::Pose p;
 
-  bool found_legal = false;
+    bool found_legal = false;
 
-  p = goal;
-  double potential = getPointPotential(p.position);
-  if (potential < POT_HIGH) {
-    // Goal is reachable by itself
-    best_pose = p;
-    found_legal = true;
-  } else {
-    // Goal is not reachable. Trying to find nearest to the goal
-    // reachable point within its tolerance region
-    double best_sdist = std::numeric_limits<double>::max();
-
-    p.position.y = goal.position.y - tolerance;
-    while (p.position.y <= goal.position.y + tolerance) {
-      p.position.x = goal.position.x - tolerance;
-      while (p.position.x <= goal.position.x + tolerance) {
-        potential = getPointPotential(p.position);
-        double sdist = squared_distance(p, goal);
-        if (potential < POT_HIGH && sdist < best_sdist) {
-          best_sdist = sdist;
-          best_pose = p;
-          found_legal = true;
+    p = goal;
+    double potential = getPointPotential(p.position);
+    if (potential < POT_HIGH) {
+      // Goal is reachable by itself
+      best_pose = p;
+      found_legal = true;
+    } else {
+      // Goal is not reachable. Trying to find nearest to the goal
+      // reachable point within its tolerance region
+      double best_sdist = std::numeric_limits<double>::max();
+
+      p.position.y = goal.position.y - tolerance;
+      while (p.position.y <= goal.position.y + tolerance) {
+        p.position.x = goal.position.x - tolerance;
+        while (p.position.x <= goal.position.x + tolerance) {
+          potential = getPointPotential(p.position);
+          double sdist = squared_distance(p, goal);
+          if (potential < POT_HIGH && sdist < best_sdist) {
+            best_sdist = sdist;
+            best_pose = p;
+            found_legal = true;
+          }
+          p.position.x += resolution;
         }
-        p.position.x += resolution;
+        p.position.y += resolution;
+      }
+    }
+
+    if (found_legal) {
+      // extract the plan
+      planned = getPlanFromPotential(best_pose, plan);
+      if (!planned) {
+        RCLCPP_ERROR(
+          logger_,
+          "Failed to create a plan from potential when a legal"
+          " potential was found. This shouldn't happen.");
       }
-      p.position.y += resolution;
     }
   }
 
-  if (found_legal) {
-    // extract the plan
-    if (getPlanFromPotential(best_pose, plan)) {
-      smoothApproachToGoal(best_pose, plan);
-
-      // If use_final_approach_orientation=true, interpolate the last pose orientation from the
-      // previous pose to set the orientation to the 'final approach' orientation of the robot so
-      // it does not rotate.
-      // And deal with corner case of plan of length 1
-      if (use_final_approach_orientation_) {
-        size_t plan_size = plan.poses.size();
-        if (plan_size == 1) {
-          plan.poses.back().pose.orientation = start.orientation;
-        } else if (plan_size > 1) {
-          double dx, dy, theta;
-          auto last_pose = plan.poses.back().pose.position;
-          auto approach_pose = plan.poses[plan_size - 2].pose.position;
-          // Deal with the case of NavFn producing a path with two equal last poses
-          if (std::abs(last_pose.x - approach_pose.x) < 0.0001 &&
-            std::abs(last_pose.y - approach_pose.y) < 0.0001 && plan_size > 2)
-          {
-            approach_pose = plan.poses[plan_size - 3].pose.position;
-          }
-          dx = last_pose.x - approach_pose.x;
-          dy = last_pose.y - approach_pose.y;
-          theta = atan2(dy, dx);
-          plan.poses.back().pose.orientation =
-            nav2_util::geometry_utils::orientationAroundZAxis(theta);
+  if (planned) {
+    smoothApproachToGoal(best_pose, plan);
+
+    // If use_final_approach_orientation=true, interpolate the last pose orientation from the
+    // previous pose to set the orientation to the 'final approach' orientation of the robot so
+    // it does not rotate.
+    // And deal with corner case of plan of length 1
+    if (use_final_approach_orientation_) {
+      size_t plan_size = plan.poses.size();
+      if (plan_size == 1) {
+        plan.poses.back().pose.orientation = start.orientation;
+      } else if (plan_size > 1) {
+        double dx, dy, theta;
+        auto last_pose = plan.poses.back().pose.position;
+        auto approach_pose = plan.poses[plan_size - 2].pose.position;
+        // Deal with the case of NavFn producing a path with two equal last poses
+        if (std::abs(last_pose.x - approach_pose.x) < 0.0001 &&
+          std::abs(last_pose.y - approach_pose.y) < 0.0001 && plan_size > 2)
+        {
+          approach_pose = plan.poses[plan_size - 3].pose.position;
         }
+        dx = last_pose.x - approach_pose.x;
+        dy = last_pose.y - approach_pose.y;
+        theta = atan2(dy, dx);
+        plan.poses.back().pose.orientation =
+          nav2_util::geometry_utils::orientationAroundZAxis(theta);
       }
-    } else {
-      RCLCPP_ERROR(
-        logger_,
-        "Failed to create a plan from potential when a legal"
-        " potential was found. This shouldn't happen.");
     }
   }
 
   return !plan.poses.empty();
 }
 
+bool
+NavfnPlanner::makePlanFromGoalPotential(
+  int * map_start, int * map_goal,
+  std::function<bool()> cancel_checker,
+  nav_msgs::msg::Path & plan)
+{
+  const int ns = planner_->ns;
+  const int start_index = map_start[1] * planner_->nx + map_start[0];
+  const int goal_index = map_goal[1] * planner_->nx + map_goal[0];
+  const COSTTYPE * costs = planner_->costarr;
+
+  // The kept potential is still valid on the same costs, but for the start cell
+  // which is cleared on every plan, if it spans the new start
+  const bool reuse = potential_kept_ && kept_goal_index_ == goal_index &&
+    static_cast<int>(kept_costs_.size()) == ns &&
+    planner_->potarr[start_index] <= kept_potential_bound_ &&
+    std::equal(costs, costs + start_index, kept_costs_.begin()) &&
+    std::equal(costs + start_index + 1, costs + ns, kept_costs_.begin() + start_index + 1);
+
+  if (reuse) {
+    planner_->setStart(map_start);
+  } else {
+    potential_kept_ = false;
+
+    // A goal in an obstacle is only reachable within the tolerance, from the start side
+    if (costs[goal_index] >= COST_OBS) {
+      return false;
+    }
+
+    // Costs are kept before the propagation, which sets the map borders as obstacles
+    kept_costs_.assign(costs, costs + ns);
+    planner_->setStart(map_start);
+    planner_->setGoal(map_goal);
+    const float margin = propagation_margin_ / costmap_->getResolution() * COST_NEUTRAL;
+    planner_->calcNavFnDijkstra(cancel_checker, true, margin);
+    if (planner_->potarr[start_index] >= POT_HIGH) {
+      return false;
+    }
+
+    kept_goal_index_ = goal_index;
+    kept_potential_bound_ = planner_->potarr[start_index] + margin;
+    potential_kept_ = true;
+  }
+
+  plan.poses.clear();
+  const int max_cycles = std::max(planner_->nx, planner_->ny) * 4;
+  if (planner_->calcPath(max_cycles) == 0) {
+    return false;
+  }
+
+  // extract the plan, from the start to the goal
+  float * x = planner_->getPathX();
+  float * y = planner_->getPathY();
+  int len = planner_->getPathLen();
+  for (int i = 0; i < len; ++i) {
+    double world_x, world_y;
+    mapToWorld(x[i], y[i], world_x, world_y);
+
+    geometry_msgs::msg::PoseStamped pose;
+    pose.pose.position.x = world_x;
+    pose.pose.position.y = world_y;
+    pose.pose.position.z = 0.0;
+    pose.pose.orientation.w = 1.0;
+    plan.poses.push_back(pose);
+  }
+
+  return !plan.poses.empty();
+}
+
 void
 NavfnPlanner::smoothApproachToGoal(
   const geometry_msgs::msg::Pose & goal,
@@ -523,6 +612,8 @@ NavfnPlanner::dynamicParametersCallback(std::vector<rclcpp::Parameter> parameter
     if (type == ParameterType::PARAMETER_DOUBLE) {
       if (name == name_ + ".tolerance") {
         tolerance_ = parameter.as_double();
+      } else if (name == name_ + ".propagation_margin") {
+        propagation_margin_ = parameter.as_double();
       }
     } else if (type == ParameterType::PARAMETER_BOOL) {
       if (name == name_ + ".use_astar") {
@@ -531,6 +622,8 @@ NavfnPlanner::dynamicParametersCallback(std::vector<rclcpp::Parameter> parameter
         allow_unknown_ = parameter.as_bool();
       } else if (name == name_ + ".use_final_approach_orientation") {
         use_final_approach_orientation_ = parameter.as_bool();
+      } else if (name == name_ + ".reuse_potential") {
+        reuse_potential_ = parameter.as_bool();
       }
     }
   }
@@ -0,0 +1,442 @@
+// Copyright (c) 2024 Open Navigation LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Runs the createPlan of any nav2_core::GlobalPlanner plugin over a library of costmaps,
+// each with the same seeded set of random start and goal queries for all the plugins. The
+// plugins are those of the planner_plugins parameter, loaded with their parameters from the
+// planner_server and global_costmap sections of a params file:
+//
+//   planner_plugin_benchmark [--costmap=<map.yaml>]... [--queries=<n>] [--seed=<n>]
+//     --ros-args --params-file nav2_params.yaml
+//
+// The costmaps are read with the map server, as raw costs (mode: raw). Without any, three
+// synthetic inflated maps of increasing clutter are used. Google Benchmark writes the
+// results as JSON with --benchmark_out=<file> --benchmark_out_format=json.
+
+#include <benchmark/benchmark.h>
+#include <malloc.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <memory>
+#include <new>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "geometry_msgs/msg/pose_stamped.hpp"
+#include "nav_msgs/msg/occupancy_grid.hpp"
+#include "nav_msgs/msg/path.hpp"
+#include "nav2_core/global_planner.hpp"
+#include "nav2_costmap_2d/cost_values.hpp"
+#include "nav2_costmap_2d/costmap_2d_ros.hpp"
+#include "nav2_map_server/map_io.hpp"
+#include "nav2_util/geometry_utils.hpp"
+#include "nav2_util/lifecycle_node.hpp"
+#include "nav2_util/node_utils.hpp"
+#include "pluginlib/class_loader.hpp"
+#include "rclcpp/rclcpp.hpp"
+#include "tf2_ros/buffer.h"
+
+namespace
+{
+
+// Live bytes allocated through the global operator new of all threads, and their peak
+std::atomic<int64_t> g_live_bytes{0};
+std::atomic<int64_t> g_peak_bytes{0};
+
+}  // namespace
+
+void * operator new(std::size_t size)
+{
+  void * ptr = std::malloc(size ? size : 1);
+  if (!ptr) {
+    throw std::bad_alloc();
+  }
+  const int64_t size_allocated = malloc_usable_size(ptr);
+  const int64_t live =
+    g_live_bytes.fetch_add(size_allocated, std::memory_order_relaxed) + size_allocated;
+  int64_t peak = g_peak_bytes.load(std::memory_order_relaxed);
+  while (live > peak &&
+    !g_peak_bytes.compare_exchange_weak(peak, live, std::memory_order_relaxed))
+  {
+  }
+  return ptr;
+}
+
+void operator delete(void * ptr) noexcept
+{
+  if (ptr) {
+    g_live_bytes.fetch_sub(malloc_usable_size(ptr), std::memory_order_relaxed);
+  }
+  std::free(ptr);
+}
+
+void operator delete(void * ptr, std::size_t) noexcept
+{
+  operator delete(ptr);
+}
+
+namespace
+{
+
+struct Query
+{
+  geometry_msgs::msg::PoseStamped start;
+  geometry_msgs::msg::PoseStamped goal;
+};
+
+struct MapCase
+{
+  std::string name;
+  nav_msgs::msg::OccupancyGrid costs;
+  std::vector<Query> queries;
+};
+
+struct BenchmarkedPlanner
+{
+  std::string id;
+  nav2_core::GlobalPlanner::Ptr planner;
+};
+
+geometry_msgs::msg::Pose makePose(double x, double y, double yaw)
+{
+  geometry_msgs::msg::Pose pose;
+  pose.position.x = x;
+  pose.position.y = y;
+  pose.orientation = nav2_util::geometry_utils::orientationAroundZAxis(yaw);
+  return pose;
+}
+
+MapCase loadMapCase(const std::string & filename)
+{
+  MapCase map_case;
+  if (nav2_map_server::loadMapFromYaml(filename, map_case.costs) !=
+    nav2_map_server::LOAD_MAP_SUCCESS)
+  {
+    throw std::runtime_error("Could not load the costmap " + filename);
+  }
+  const size_t slash = filename.find_last_of('/');
+  map_case.name = filename.substr(slash == std::string::npos ? 0 : slash + 1);
+  map_case.name = map_case.name.substr(0, map_case.name.rfind('.'));
+  return map_case;
+}
+
+// A 10m x 10m map at 5cm, with boxes covering about the given share of its cells and
+// inflated as the inflation layer would, for a 0.2m inscribed radius
+MapCase makeSyntheticMapCase(double clutter, std::mt19937 & rng)
+{
+  MapCase map_case;
+  map_case.name = "synthetic_" + std::to_string(static_cast<int>(clutter * 100.0));
+  auto & info = map_case.costs.info;
+  info.width = 200;
+  info.height = 200;
+  info.resolution = 0.05;
+  std::vector<bool> lethal(info.width * info.height, false);
+
+  std::uniform_int_distribution<unsigned int> position(0, info.width - 1);
+  std::uniform_int_distribution<unsigned int> side(4, 16);
+  size_t lethal_cells = 0;
+  while (lethal_cells < clutter * lethal.size()) {
+    const unsigned int x0 = position(rng), y0 = position(rng);
+    const unsigned int x1 = std::min(x0 + side(rng), info.width);
+    const unsigned int y1 = std::min(y0 + side(rng), info.height);
+    for (unsigned int y = y0; y < y1; y++) {
+      for (unsigned int x = x0; x < x1; x++) {
+        lethal_cells += !lethal[y * info.width + x];
+        lethal[y * info.width + x] = true;
+      }
+    }
+  }
+
+  const double inscribed_radius = 0.2, inflation_radius = 0.55, cost_scaling = 3.0;
+  const int radius_cells = static_cast<int>(std::ceil(inflation_radius / info.resolution));
+  std::vector<unsigned char> costs(lethal.size(), nav2_costmap_2d::FREE_SPACE);
+  for (int y = 0; y < static_cast<int>(info.height); y++) {
+    for (int x = 0; x < static_cast<int>(info.width); x++) {
+      if (!lethal[y * info.width + x]) {
+        continue;
+      }
+      costs[y * info.width + x] = nav2_costmap_2d::LETHAL_OBSTACLE;
+      for (int dy = -radius_cells; dy <= radius_cells; dy++) {
+        for (int dx = -radius_cells; dx <= radius_cells; dx++) {
+          const int nx = x + dx, ny = y + dy;
+          const double distance = std::hypot(dx, dy) * info.resolution;
+          if (nx < 0 || ny < 0 || nx >= static_cast<int>(info.width) ||
+            ny >= static_cast<int>(info.height) || distance > inflation_radius)
+          {
+            continue;
+          }
+          const unsigned char cost = distance <= inscribed_radius ?
+            nav2_costmap_2d::INSCRIBED_INFLATED_OBSTACLE :
+            static_cast<unsigned char>(
+            (nav2_costmap_2d::INSCRIBED_INFLATED_OBSTACLE - 1) *
+            std::exp(-cost_scaling * (distance - inscribed_radius)));
+          unsigned char & cell = costs[ny * info.width + nx];
+          cell = std::max(cell, cost);
+        }
+      }
+    }
+  }
+  map_case.costs.data.assign(costs.begin(), costs.end());
+  return map_case;
+}
+
+// Starts and goals in cells cheaper than max_cost, at least min_distance apart
+void makeQueries(
+  MapCase & map_case, size_t count, unsigned char max_cost, double min_distance,
+  std::mt19937 & rng)
+{
+  const auto & info = map_case.costs.info;
+  std::uniform_int_distribution<unsigned int> mx(0, info.width - 1), my(0, info.height - 1);
+  std::uniform_real_distribution<double> yaw(-M_PI, M_PI);
+  auto randomPose = [&]() {
+      for (int attempt = 0; attempt < 100000; attempt++) {
+        const unsigned int x = mx(rng), y = my(rng);
+        const auto cost = static_cast<unsigned char>(map_case.costs.data[y * info.width + x]);
+        if (cost < max_cost) {
+          geometry_msgs::msg::PoseStamped pose;
+          pose.pose = makePose(
+            info.origin.position.x + (x + 0.5) * info.resolution,
+            info.origin.position.y + (y + 0.5) * info.resolution, yaw(rng));
+          return pose;
+        }
+      }
+      throw std::runtime_error(map_case.name + " has no free cells for the queries");
+    };
+
+  while (map_case.queries.size() < count) {
+    Query query{randomPose(), randomPose()};
+    if (nav2_util::geometry_utils::euclidean_distance(query.start, query.goal) >=
+      min_distance)
+    {
+      map_case.queries.push_back(std::move(query));
+    }
+  }
+}
+
+void setCostmap(const MapCase & map_case, nav2_costmap_2d::Costmap2DROS & costmap_ros)
+{
+  const auto & info = map_case.costs.info;
+  costmap_ros.getLayeredCostmap()->resizeMap(
+    info.width, info.height, info.resolution, info.origin.position.x, info.origin.position.y);
+  unsigned char * costs = costmap_ros.getCostmap()->getCharMap();
+  for (size_t i = 0; i < map_case.costs.data.size(); i++) {
+    costs[i] = static_cast<unsigned char>(map_case.costs.data[i]);
+  }
+  std::unique_lock<nav2_costmap_2d::Costmap2D::mutex_t> lock(
+    *(costmap_ros.getCostmap()->getMutex()));
+  costmap_ros.getLayeredCostmap()->publishSnapshot();
+}
+
+double percentileMs(std::vector<double> & latencies, double fraction)
+{
+  if (latencies.empty()) {
+    return 0.0;
+  }
+  const size_t rank = std::min(
+    latencies.size() - 1, static_cast<size_t>(std::ceil(fraction * latencies.size())) - 1);
+  std::nth_element(latencies.begin(), latencies.begin() + rank, latencies.end());
+  return latencies[rank] * 1e3;
+}
+
+// Total heading change along the path, in radians
+double totalTurning(const nav_msgs::msg::Path & path)
+{
+  double turning = 0.0, previous_heading = 0.0;
+  bool has_heading = false;
+  for (size_t i = 1; i < path.poses.size(); i++) {
+    const auto & a = path.poses[i - 1].pose.position;
+    const auto & b = path.poses[i].pose.position;
+    if (std::hypot(b.x - a.x, b.y - a.y) < 1e-6) {
+      continue;
+    }
+    const double heading = std::atan2(b.y - a.y, b.x - a.x);
+    if (has_heading) {
+      turning += std::abs(std::remainder(heading - previous_heading, 2.0 * M_PI));
+    }
+    previous_heading = heading;
+    has_heading = true;
+  }
+  return turning;
+}
+
+void runPlanner(
+  benchmark::State & state, const BenchmarkedPlanner & benchmarked,
+  const MapCase & map_case, nav2_costmap_2d::Costmap2DROS & costmap_ros)
+{
+  setCostmap(map_case, costmap_ros);
+  nav2_core::GlobalPlanner & planner = *benchmarked.planner;
+  auto never_cancel = []() {return false;};
+
+  std::vector<double> latencies;
+  latencies.reserve(map_case.queries.size());
+  double path_length = 0.0, turning = 0.0;
+  int64_t peak_heap = 0;
+  int successes = 0;
+  size_t query_index = 0;
+
+  for (auto _ : state) {
+    Query query = map_case.queries[query_index++ % map_case.queries.size()];
+    query.start.header.frame_id = costmap_ros.getGlobalFrameID();
+    query.goal.header.frame_id = costmap_ros.getGlobalFrameID();
+
+    const int64_t live_start = g_live_bytes.load(std::memory_order_relaxed);
+    g_peak_bytes.store(live_start, std::memory_order_relaxed);
+    nav_msgs::msg::Path path;
+    const auto start = std::chrono::steady_clock::now();
+    try {
+      path = planner.createPlan(query.start, query.goal, never_cancel);
+    } catch (const std::exception &) {
+      path.poses.clear();
+    }
+    const auto end = std::chrono::steady_clock::now();
+    latencies.push_back(std::chrono::duration<double>(end - start).count());
+    peak_heap = std::max(peak_heap, g_peak_bytes.load(std::memory_order_relaxed) - live_start);
+
+    state.PauseTiming();
+    if (!path.poses.empty()) {
+      successes++;
+      path_length += nav2_util::geometry_utils::calculate_path_length(path);
+      turning += totalTurning(path);
+    }
+    state.ResumeTiming();
+  }
+
+  const double queries = static_cast<double>(std::max<size_t>(latencies.size(), 1));
+  state.SetLabel(map_case.name + "/" + benchmarked.id);
+  state.counters["p50_ms"] = percentileMs(latencies, 0.5);
+  state.counters["p95_ms"] = percentileMs(latencies, 0.95);
+  state.counters["p99_ms"] = percentileMs(latencies, 0.99);
+  state.counters["max_ms"] = percentileMs(latencies, 1.0);
+  state.counters["success_rate"] = successes / queries;
+  state.counters["heap_peak_mb"] = peak_heap / 1e6;
+  if (successes > 0) {
+    state.counters["path_length_m"] = path_length / successes;
+    // Heading change per meter travelled, lower for smoother paths
+    state.counters["turning_rad_per_m"] = path_length > 0.0 ? turning / path_length : 0.0;
+  }
+}
+
+}  // namespace
+
+int main(int argc, char ** argv)
+{
+  benchmark::Initialize(&argc, argv);
+  const std::vector<std::string> args = rclcpp::init_and_remove_ros_arguments(argc, argv);
+
+  std::vector<std::string> costmap_files;
+  size_t query_count = 100;
+  unsigned int seed = 33;
+  for (size_t i = 1; i < args.size(); i++) {
+    const std::string & arg = args[i];
+    if (arg.rfind("--costmap=", 0) == 0) {
+      costmap_files.push_back(arg.substr(10));
+    } else if (arg.rfind("--queries=", 0) == 0) {
+      query_count = std::stoul(arg.substr(10));
+    } else if (arg.rfind("--seed=", 0) == 0) {
+      seed = std::stoul(arg.substr(7));
+    } else {
+      std::cerr << "Unknown argument " << arg << std::endl;
+      return 1;
+    }
+  }
+
+  {
+    // Named as the planner server, so that its section of a params file applies
+    auto node = std::make_shared<nav2_util::LifecycleNode>("planner_server");
+    auto costmap_ros = std::make_shared<nav2_costmap_2d::Costmap2DROS>(
+      "global_costmap", std::string{node->get_namespace()}, "global_costmap", false);
+    costmap_ros->on_configure(rclcpp_lifecycle::State{});
+
+    const std::vector<std::string> ids = node->declare_parameter(
+      "planner_plugins", std::vector<std::string>{"GridBased"});
+
+    // The same queries for every plugin, from the seed
+    std::vector<MapCase> map_cases;
+    try {
+      std::mt19937 rng(seed);
+      if (costmap_files.empty()) {
+        for (const double clutter : {0.10, 0.15, 0.20}) {
+          map_cases.push_back(makeSyntheticMapCase(clutter, rng));
+        }
+      } else {
+        for (const auto & file : costmap_files) {
+          map_cases.push_back(loadMapCase(file));
+        }
+      }
+      for (auto & map_case : map_cases) {
+        makeQueries(map_case, query_count, nav2_costmap_2d::MAX_NON_OBSTACLE, 3.0, rng);
+      }
+    } catch (const std::exception & ex) {
+      std::cerr << ex.what() << std::endl;
+      rclcpp::shutdown();
+      return 1;
+    }
+
+    // Poses are given in the global frame, so the robot frame is only looked up there
+    auto tf_buffer = std::make_shared<tf2_ros::Buffer>(node->get_clock());
+    geometry_msgs::msg::TransformStamped identity;
+    identity.header.frame_id = costmap_ros->getGlobalFrameID();
+    identity.child_frame_id = costmap_ros->getBaseFrameID();
+    identity.transform.rotation.w = 1.0;
+    tf_buffer->setTransform(identity, "planner_plugin_benchmark", true);
+
+    pluginlib::ClassLoader<nav2_core::GlobalPlanner> loader(
+      "nav2_core", "nav2_core::GlobalPlanner");
+    std::vector<BenchmarkedPlanner> planners;
+    try {
+      for (const auto & id : ids) {
+        const std::string type = nav2_util::get_plugin_type_param(node, id);
+        BenchmarkedPlanner benchmarked{id, loader.createUniqueInstance(type)};
+        benchmarked.planner->configure(node, id, tf_buffer, costmap_ros);
+        benchmarked.planner->activate();
+        planners.push_back(std::move(benchmarked));
+      }
+    } catch (const std::exception & ex) {
+      std::cerr << "Failed to load the planners: " << ex.what() << std::endl;
+      rclcpp::shutdown();
+      return 1;
+    }
+
+    // Each query is planned once per plugin
+    for (const auto & map_case : map_cases) {
+      for (const auto & benchmarked : planners) {
+        benchmark::RegisterBenchmark(
+          ("BM_Planner/" + map_case.name + "/" + benchmarked.id).c_str(),
+          [&](benchmark::State & state) {
+            runPlanner(state, benchmarked, map_case, *costmap_ros);
+          })->Iterations(map_case.queries.size())->Unit(benchmark::kMillisecond);
+      }
+    }
+    benchmark::RunSpecifiedBenchmarks();
+
+    for (auto & benchmarked : planners) {
+      benchmarked.planner->deactivate();
+      benchmarked.planner->cleanup();
+    }
+    planners.clear();
+    costmap_ros->on_cleanup(rclcpp_lifecycle::State{});
+  }
+
+  benchmark::Shutdown();
+  rclcpp::shutdown();
+  return 0;
+}
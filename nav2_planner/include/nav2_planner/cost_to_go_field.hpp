@@ -0,0 +1,94 @@
+// Copyright (c) 2019 Samsung Research America
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef NAV2_PLANNER__COST_TO_GO_FIELD_HPP_
+#define NAV2_PLANNER__COST_TO_GO_FIELD_HPP_
+
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+#include "geometry_msgs/msg/pose_stamped.hpp"
+#include "nav_msgs/msg/path.hpp"
+#include "nav2_costmap_2d/costmap_snapshot.hpp"
+
+namespace nav2_planner
+{
+
+/**
+ * @class nav2_planner::CostToGoField
+ * @brief Shortest path lengths from every cell of a costmap to a goal, computed once
+ * by a Dijkstra search from the goal over the 8-connected free cells. Afterwards,
+ * distance queries are a lookup and path queries a gradient descent, for any start.
+ */
+class CostToGoField
+{
+public:
+  /**
+   * @brief A constructor for nav2_planner::CostToGoField
+   * @param allow_unknown Whether the search may go through unknown cells
+   */
+  explicit CostToGoField(bool allow_unknown);
+
+  /**
+   * @brief Compute the field of a goal, unless already computed on the same costmap revision
+   * @param costmap Snapshot of the costmap to search
+   * @param goal_x Goal world X coord, in the costmap frame
+   * @param goal_y Goal world Y coord, in the costmap frame
+   * @return False if the goal is off the costmap
+   */
+  bool update(
+    const nav2_costmap_2d::CostmapSnapshot::ConstPtr & costmap,
+    double goal_x, double goal_y);
+
+  /**
+   * @brief Path length from a start to the goal
+   * @param wx Start world X coord
+   * @param wy Start world Y coord
+   * @return Length (m), infinity if unreachable or off the costmap
+   */
+  float getDistance(double wx, double wy) const;
+
+  /**
+   * @brief Extract the shortest path from a start to the goal, through the cell centers
+   * @param wx Start world X coord
+   * @param wy Start world Y coord
+   * @param path Output path, poses without header
+   * @return False if unreachable or off the costmap
+   */
+  bool getPath(double wx, double wy, nav_msgs::msg::Path & path) const;
+
+  /**
+   * @brief Revision of the costmap the field was computed on
+   */
+  uint64_t getRevision() const
+  {
+    return costmap_ ? costmap_->getRevision() : 0;
+  }
+
+protected:
+  /**
+   * @brief Whether the robot center may lie in a cell of a given cost
+   */
+  bool isTraversable(unsigned char cost) const;
+
+  bool allow_unknown_;
+  nav2_costmap_2d::CostmapSnapshot::ConstPtr costmap_;
+  unsigned int goal_index_{0};
+  std::vector<float> distances_;
+};
+
+}  // namespace nav2_planner
+
+#endif  // NAV2_PLANNER__COST_TO_GO_FIELD_HPP_
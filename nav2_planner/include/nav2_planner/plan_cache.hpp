@@ -0,0 +1,127 @@
+// Copyright (c) 2019 Samsung Research America
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef NAV2_PLANNER__PLAN_CACHE_HPP_
+#define NAV2_PLANNER__PLAN_CACHE_HPP_
+
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+#include "geometry_msgs/msg/pose_stamped.hpp"
+#include "nav_msgs/msg/path.hpp"
+
+namespace nav2_planner
+{
+
+/**
+ * @class nav2_planner::PlanCache
+ * @brief Cache of the latest plans per planner and goal, reused for starts lying on
+ * them while they are still collision free. Plans are keyed on the revision of the
+ * costmap they were checked against, so unchanged costmaps skip the check altogether.
+ * Not thread safe.
+ */
+class PlanCache
+{
+public:
+  /**
+   * @brief Check of a path from one of its poses, true if still valid
+   */
+  using PathValidator = std::function<bool (const nav_msgs::msg::Path &, unsigned int)>;
+
+  /**
+   * @brief A constructor for nav2_planner::PlanCache
+   * @param capacity Maximum number of plans cached, the least recently used are evicted
+   * @param start_tolerance Maximum distance of a start to a cached plan to reuse it (m)
+   * @param goal_tolerance Maximum distance between goals to reuse a plan (m)
+   * @param goal_yaw_tolerance Maximum yaw difference between goals to reuse a plan (rad)
+   */
+  PlanCache(
+    size_t capacity, double start_tolerance, double goal_tolerance,
+    double goal_yaw_tolerance);
+
+  /**
+   * @brief Find a cached plan from start to goal, validating it if the costmap changed
+   * since it was last checked. Plans failing the validation are evicted.
+   * @param planner_id ID of the planner requested
+   * @param start Start pose, in the frame of the plans
+   * @param goal Goal pose, in the frame of the plans
+   * @param revision Current revision of the costmap
+   * @param is_valid Check of a plan from the pose of the start projection
+   * @param path Output suffix of the cached plan from the projection of the start
+   * @return True on a cache hit
+   */
+  bool lookup(
+    const std::string & planner_id,
+    const geometry_msgs::msg::PoseStamped & start,
+    const geometry_msgs::msg::PoseStamped & goal,
+    uint64_t revision,
+    const PathValidator & is_valid,
+    nav_msgs::msg::Path & path);
+
+  /**
+   * @brief Cache a new plan, replacing the one to the same goal if any
+   * @param planner_id ID of the planner that generated the plan
+   * @param goal Goal pose of the plan
+   * @param revision Revision of the costmap the plan was computed on
+   * @param path Plan to cache
+   */
+  void insert(
+    const std::string & planner_id,
+    const geometry_msgs::msg::PoseStamped & goal,
+    uint64_t revision,
+    const nav_msgs::msg::Path & path);
+
+  /**
+   * @brief Remove all cached plans, keeping the hit and miss counts
+   */
+  void clear();
+
+  uint64_t getHits() const {return hits_;}
+  uint64_t getMisses() const {return misses_;}
+
+protected:
+  struct Entry
+  {
+    std::string planner_id;
+    geometry_msgs::msg::PoseStamped goal;
+    uint64_t revision;
+    nav_msgs::msg::Path path;
+    // Index of the last start projection, later starts are searched from there
+    unsigned int projection;
+    uint64_t last_used;
+  };
+
+  /**
+   * @brief Entry of a planner to a goal, entries_.end() if none
+   */
+  std::vector<Entry>::iterator find(
+    const std::string & planner_id,
+    const geometry_msgs::msg::PoseStamped & goal);
+
+  size_t capacity_;
+  double start_tolerance_;
+  double goal_tolerance_;
+  double goal_yaw_tolerance_;
+
+  std::vector<Entry> entries_;
+  uint64_t uses_{0};
+  uint64_t hits_{0};
+  uint64_t misses_{0};
+};
+
+}  // namespace nav2_planner
+
+#endif  // NAV2_PLANNER__PLAN_CACHE_HPP_
@@ -20,6 +20,7 @@
 #include <memory>
 #include <vector>
 #include <unordered_map>
+#include <unordered_set>
 #include <mutex>
 
 #include "geometry_msgs/msg/point.hpp"
@@ -28,9 +29,11 @@
 #include "nav2_util/lifecycle_node.hpp"
 #include "nav2_msgs/action/compute_path_to_pose.hpp"
 #include "nav2_msgs/action/compute_path_through_poses.hpp"
+#include "nav2_msgs/action/compute_paths_to_poses.hpp"
 #include "nav2_msgs/msg/costmap.hpp"
 #include "nav2_util/robot_utils.hpp"
 #include "nav2_util/simple_action_server.hpp"
+#include "nav2_util/thread_pool.hpp"
 #include "visualization_msgs/msg/marker.hpp"
 #include "tf2_ros/transform_listener.h"
 #include "tf2_ros/create_timer_ros.h"
@@ -39,8 +42,11 @@
 #include "pluginlib/class_list_macros.hpp"
 #include "nav2_core/global_planner.hpp"
 #include "nav2_msgs/srv/is_path_valid.hpp"
+#include "nav2_msgs/srv/get_cost_to_go.hpp"
 #include "nav2_costmap_2d/footprint_collision_checker.hpp"
 #include "nav2_core/planner_exceptions.hpp"
+#include "nav2_planner/cost_to_go_field.hpp"
+#include "nav2_planner/plan_cache.hpp"
 
 namespace nav2_planner
 {
@@ -116,6 +122,9 @@ protected:
   using ActionThroughPosesResult = ActionThroughPoses::Result;
   using ActionServerToPose = nav2_util::SimpleActionServer<ActionToPose>;
   using ActionServerThroughPoses = nav2_util::SimpleActionServer<ActionThroughPoses>;
+  using ActionToPoses = nav2_msgs::action::ComputePathsToPoses;
+  using ActionToPosesResult = ActionToPoses::Result;
+  using ActionServerToPoses = nav2_util::SimpleActionServer<ActionToPoses>;
 
   /**
    * @brief Check if an action server is valid / active
@@ -199,6 +208,74 @@ protected:
    */
   void computePlanThroughPoses();
 
+  /**
+   * @brief The action server callback which calls planners to get the paths
+   * to each of the goals ComputePathsToPoses, concurrently over the planner
+   * instances of the batch planning pool
+   */
+  void computePlansToPoses();
+
+  /**
+   * @brief Plan to a goal of a ComputePathsToPoses request, catching the planning
+   * errors so that they only affect this goal
+   * @param planner Planner instance to plan with
+   * @param start Starting pose, in the global frame
+   * @param goal Goal pose, in the global frame
+   * @param planner_id The planner ID used to generate the path
+   * @param cancel_checker A function to check if the action has been canceled
+   * @param path Output path
+   * @return Error code of the goal, NONE if a path was found
+   */
+  uint16_t planToBatchGoal(
+    nav2_core::GlobalPlanner & planner,
+    const geometry_msgs::msg::PoseStamped & start,
+    const geometry_msgs::msg::PoseStamped & goal,
+    const std::string & planner_id,
+    std::function<bool()> cancel_checker,
+    nav_msgs::msg::Path & path);
+
+  /**
+   * @brief Get the ID of the planner to use for a request
+   * @param planner_id The planner ID of the request, may be empty with a single planner
+   * @return ID of a loaded planner
+   * @throws nav2_core::InvalidPlanner if no loaded planner matches
+   */
+  std::string resolvePlannerId(const std::string & planner_id);
+
+  /**
+   * @brief Configure a planner instance
+   * @param planner_id ID of the planner
+   * @param planner Planner instance to configure
+   */
+  void configurePlanner(const std::string & planner_id, nav2_core::GlobalPlanner & planner);
+
+  /**
+   * @brief Configure the instances of a planner created but left unconfigured with
+   * lazy_plugin_loading, and activate them if the server is active
+   * @param planner_id ID of the planner
+   * @throws nav2_core::InvalidPlanner if the planner fails to configure
+   */
+  void loadPlannerIfUnconfigured(const std::string & planner_id);
+
+  /**
+   * @brief Check a path for collisions on a costmap snapshot, from one of its poses
+   * @param costmap Snapshot of the costmap to check against
+   * @param path Path to check
+   * @param start_index Index of the first pose to check
+   * @param changed_bounds If set, only the poses whose footprint may overlap these
+   * cells are checked, the others being known collision free
+   * @return True if the path is collision free from start_index
+   */
+  bool isPathCollisionFree(
+    const nav2_costmap_2d::CostmapSnapshot::ConstPtr & costmap,
+    const nav_msgs::msg::Path & path, unsigned int start_index,
+    const nav2_costmap_2d::CellRegion * changed_bounds = nullptr);
+
+  /**
+   * @brief Hash of the frame and poses of a path, identifying it across validations
+   */
+  static uint64_t hashPath(const nav_msgs::msg::Path & path);
+
   /**
    * @brief The service callback to determine if the path is still valid
    * @param request to the service
@@ -208,12 +285,29 @@ protected:
     const std::shared_ptr<nav2_msgs::srv::IsPathValid::Request> request,
     std::shared_ptr<nav2_msgs::srv::IsPathValid::Response> response);
 
+  /**
+   * @brief The service callback to get the distances and paths of many starts to a goal,
+   * from its cost-to-go field. The field is only recomputed for new goals or costmaps.
+   * @param request to the service
+   * @param response from the service
+   */
+  void getCostToGo(
+    const std::shared_ptr<nav2_msgs::srv::GetCostToGo::Request> request,
+    std::shared_ptr<nav2_msgs::srv::GetCostToGo::Response> response);
+
   /**
    * @brief Publish a path for visualization purposes
    * @param path Reference to Global Path
    */
   void publishPlan(const nav_msgs::msg::Path & path);
 
+  /**
+   * @brief Publish a provisional prefix of the path being planned as feedback of the
+   * current ComputePathToPose goal, if it is the one being planned
+   * @param path Provisional prefix of the path
+   */
+  void publishPartialPath(const nav_msgs::msg::Path & path);
+
   void exceptionWarning(
     const geometry_msgs::msg::PoseStamped & start,
     const geometry_msgs::msg::PoseStamped & goal,
@@ -230,6 +324,7 @@ protected:
   // Our action server implements the ComputePathToPose action
   std::unique_ptr<ActionServerToPose> action_server_pose_;
   std::unique_ptr<ActionServerThroughPoses> action_server_poses_;
+  std::unique_ptr<ActionServerToPoses> action_server_paths_;
 
   // Dynamic parameters handler
   rclcpp::node_interfaces::OnSetParametersCallbackHandle::SharedPtr dyn_params_handler_;
@@ -245,6 +340,27 @@ protected:
   double max_planner_duration_;
   std::string planner_ids_concat_;
 
+  // Planners left unconfigured until their first use with lazy_plugin_loading, those
+  // that failed to configure, and whether configured planners are active, all guarded
+  // by plugin_load_mutex_
+  std::unordered_set<std::string> unconfigured_planners_;
+  std::unordered_set<std::string> failed_planners_;
+  bool planners_active_{false};
+  std::mutex plugin_load_mutex_;
+
+  // Additional planner instances per planner ID to plan batches of goals concurrently
+  int batch_planner_instances_;
+  std::unordered_map<std::string, std::vector<nav2_core::GlobalPlanner::Ptr>> batch_planners_;
+  std::unique_ptr<nav2_util::ThreadPool> batch_pool_;
+
+  // Plans reused while valid for repeated requests to the same goals, nullptr if disabled
+  std::unique_ptr<PlanCache> plan_cache_;
+
+  // Whether the planners stream provisional path prefixes, and whether the ComputePathToPose
+  // goal is being planned for them to go to, guarded by dynamic_params_lock_
+  bool stream_partial_paths_{false};
+  bool streaming_to_pose_{false};
+
   // TF buffer
   std::shared_ptr<tf2_ros::Buffer> tf_;
 
@@ -252,14 +368,30 @@ protected:
   std::shared_ptr<nav2_costmap_2d::Costmap2DROS> costmap_ros_;
   std::unique_ptr<nav2_util::NodeThread> costmap_thread_;
   nav2_costmap_2d::Costmap2D * costmap_;
-  std::unique_ptr<nav2_costmap_2d::FootprintCollisionChecker<nav2_costmap_2d::Costmap2D *>>
-  collision_checker_;
+
+  // Latest successful validations of paths, to only check them again where the costmap changed
+  struct PathValidation
+  {
+    uint64_t hash;
+    uint64_t revision;
+    unsigned int start_index;
+    uint64_t stamp;
+  };
+  static constexpr size_t kPathValidationsSize = 8;
+  std::vector<PathValidation> path_validations_;
+  uint64_t path_validations_stamp_{0};
+  std::mutex path_validations_mutex_;
 
   // Publishers for the path
   rclcpp_lifecycle::LifecyclePublisher<nav_msgs::msg::Path>::SharedPtr plan_publisher_;
 
   // Service to determine if the path is valid
   rclcpp::Service<nav2_msgs::srv::IsPathValid>::SharedPtr is_path_valid_service_;
+
+  // Service to get distances to a goal from its cost-to-go field
+  rclcpp::Service<nav2_msgs::srv::GetCostToGo>::SharedPtr cost_to_go_service_;
+  std::unique_ptr<CostToGoField> cost_to_go_field_;
+  std::mutex cost_to_go_mutex_;
 };
 
 }  // namespace nav2_planner
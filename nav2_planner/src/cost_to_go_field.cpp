@@ -0,0 +1,180 @@
+// Copyright (c) 2019 Samsung Research America
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <queue>
+#include <utility>
+#include <vector>
+
+#include "nav2_costmap_2d/cost_values.hpp"
+#include "nav2_planner/cost_to_go_field.hpp"
+
+namespace nav2_planner
+{
+
+CostToGoField::CostToGoField(bool allow_unknown)
+: allow_unknown_(allow_unknown)
+{
+}
+
+bool CostToGoField::isTraversable(unsigned char cost) const
+{
+  if (cost == nav2_costmap_2d::NO_INFORMATION) {
+    return allow_unknown_;
+  }
+  return cost < nav2_costmap_2d::INSCRIBED_INFLATED_OBSTACLE;
+}
+
+bool CostToGoField::update(
+  const nav2_costmap_2d::CostmapSnapshot::ConstPtr & costmap,
+  double goal_x, double goal_y)
+{
+  unsigned int mx, my;
+  if (!costmap->worldToMap(goal_x, goal_y, mx, my)) {
+    return false;
+  }
+
+  const unsigned int goal_index = costmap->getIndex(mx, my);
+  if (costmap_ && costmap_->getRevision() == costmap->getRevision() &&
+    goal_index_ == goal_index)
+  {
+    return true;
+  }
+
+  costmap_ = costmap;
+  goal_index_ = goal_index;
+
+  const int size_x = static_cast<int>(costmap->getSizeInCellsX());
+  const int size_y = static_cast<int>(costmap->getSizeInCellsY());
+  const float resolution = static_cast<float>(costmap->getResolution());
+  const unsigned char * charmap = costmap->getCharMap();
+  distances_.assign(
+    static_cast<size_t>(size_x) * size_y, std::numeric_limits<float>::infinity());
+
+  // Lazy deletion Dijkstra: outdated queue entries are skipped when popped
+  using QueueEntry = std::pair<float, unsigned int>;
+  std::priority_queue<QueueEntry, std::vector<QueueEntry>, std::greater<QueueEntry>> queue;
+  distances_[goal_index] = 0.0f;
+  queue.emplace(0.0f, goal_index);
+
+  const float diagonal = resolution * static_cast<float>(M_SQRT2);
+  const int dx[8] = {1, -1, 0, 0, 1, 1, -1, -1};
+  const int dy[8] = {0, 0, 1, -1, 1, -1, 1, -1};
+
+  while (!queue.empty()) {
+    const auto [distance, index] = queue.top();
+    queue.pop();
+    if (distance > distances_[index]) {
+      continue;
+    }
+
+    const int x = static_cast<int>(index) % size_x;
+    const int y = static_cast<int>(index) / size_x;
+    for (unsigned int i = 0; i != 8; i++) {
+      const int nx = x + dx[i];
+      const int ny = y + dy[i];
+      if (nx < 0 || ny < 0 || nx >= size_x || ny >= size_y) {
+        continue;
+      }
+      const unsigned int neighbor = static_cast<unsigned int>(ny * size_x + nx);
+      if (!isTraversable(charmap[neighbor])) {
+        continue;
+      }
+      const float neighbor_distance = distance + (i < 4 ? resolution : diagonal);
+      if (neighbor_distance < distances_[neighbor]) {
+        distances_[neighbor] = neighbor_distance;
+        queue.emplace(neighbor_distance, neighbor);
+      }
+    }
+  }
+
+  return true;
+}
+
+float CostToGoField::getDistance(double wx, double wy) const
+{
+  unsigned int mx, my;
+  if (!costmap_ || !costmap_->worldToMap(wx, wy, mx, my)) {
+    return std::numeric_limits<float>::infinity();
+  }
+  return distances_[costmap_->getIndex(mx, my)];
+}
+
+bool CostToGoField::getPath(double wx, double wy, nav_msgs::msg::Path & path) const
+{
+  path.poses.clear();
+  unsigned int mx, my;
+  if (!costmap_ || !costmap_->worldToMap(wx, wy, mx, my) ||
+    std::isinf(distances_[costmap_->getIndex(mx, my)]))
+  {
+    return false;
+  }
+
+  // Steepest descent to the goal, each step strictly decreasing the distance
+  const int size_x = static_cast<int>(costmap_->getSizeInCellsX());
+  const int size_y = static_cast<int>(costmap_->getSizeInCellsY());
+  int x = static_cast<int>(mx), y = static_cast<int>(my);
+  geometry_msgs::msg::PoseStamped pose;
+  pose.pose.orientation.w = 1.0;
+  while (true) {
+    costmap_->mapToWorld(
+      static_cast<unsigned int>(x), static_cast<unsigned int>(y),
+      pose.pose.position.x, pose.pose.position.y);
+    path.poses.push_back(pose);
+
+    const unsigned int index = static_cast<unsigned int>(y * size_x + x);
+    if (index == goal_index_) {
+      break;
+    }
+
+    int best_x = x, best_y = y;
+    float best_distance = distances_[index];
+    for (int ny = std::max(y - 1, 0); ny <= std::min(y + 1, size_y - 1); ny++) {
+      for (int nx = std::max(x - 1, 0); nx <= std::min(x + 1, size_x - 1); nx++) {
+        const float distance = distances_[ny * size_x + nx];
+        if (distance < best_distance) {
+          best_distance = distance;
+          best_x = nx;
+          best_y = ny;
+        }
+      }
+    }
+
+    if (best_x == x && best_y == y) {
+      // Cannot happen on a complete field, but never loop forever
+      path.poses.clear();
+      return false;
+    }
+    x = best_x;
+    y = best_y;
+  }
+
+  // Orient the poses along the path, the last one keeping the orientation of the previous
+  for (size_t i = 0; i + 1 < path.poses.size(); i++) {
+    const auto & a = path.poses[i].pose.position;
+    const auto & b = path.poses[i + 1].pose.position;
+    const double yaw = std::atan2(b.y - a.y, b.x - a.x);
+    path.poses[i].pose.orientation.z = std::sin(yaw / 2.0);
+    path.poses[i].pose.orientation.w = std::cos(yaw / 2.0);
+  }
+  if (path.poses.size() > 1) {
+    path.poses.back().pose.orientation = path.poses[path.poses.size() - 2].pose.orientation;
+  }
+
+  return true;
+}
+
+}  // namespace nav2_planner
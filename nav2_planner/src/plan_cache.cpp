@@ -0,0 +1,134 @@
+// Copyright (c) 2019 Samsung Research America
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <string>
+
+#include "nav2_planner/plan_cache.hpp"
+#include "nav2_util/geometry_utils.hpp"
+#include "tf2/utils.h"
+
+namespace nav2_planner
+{
+
+PlanCache::PlanCache(
+  size_t capacity, double start_tolerance, double goal_tolerance,
+  double goal_yaw_tolerance)
+: capacity_(std::max<size_t>(capacity, 1)),
+  start_tolerance_(start_tolerance),
+  goal_tolerance_(goal_tolerance),
+  goal_yaw_tolerance_(goal_yaw_tolerance)
+{
+  entries_.reserve(capacity_);
+}
+
+std::vector<PlanCache::Entry>::iterator PlanCache::find(
+  const std::string & planner_id,
+  const geometry_msgs::msg::PoseStamped & goal)
+{
+  const double goal_yaw = tf2::getYaw(goal.pose.orientation);
+  return std::find_if(
+    entries_.begin(), entries_.end(),
+    [&](const Entry & entry) {
+      return entry.planner_id == planner_id &&
+             entry.goal.header.frame_id == goal.header.frame_id &&
+             nav2_util::geometry_utils::euclidean_distance(entry.goal.pose, goal.pose) <=
+             goal_tolerance_ &&
+             std::abs(std::remainder(tf2::getYaw(entry.goal.pose.orientation) - goal_yaw,
+             2.0 * M_PI)) <= goal_yaw_tolerance_;
+    });
+}
+
+bool PlanCache::lookup(
+  const std::string & planner_id,
+  const geometry_msgs::msg::PoseStamped & start,
+  const geometry_msgs::msg::PoseStamped & goal,
+  uint64_t revision,
+  const PathValidator & is_valid,
+  nav_msgs::msg::Path & path)
+{
+  auto entry = find(planner_id, goal);
+  if (entry == entries_.end() || entry->path.header.frame_id != start.header.frame_id) {
+    misses_++;
+    return false;
+  }
+
+  // Project the start on the plan, from the last projection onwards as robots progress
+  const auto & poses = entry->path.poses;
+  unsigned int projection = entry->projection;
+  double closest_distance = std::numeric_limits<double>::max();
+  for (unsigned int i = entry->projection; i < poses.size(); ++i) {
+    const double distance =
+      nav2_util::geometry_utils::euclidean_distance(poses[i].pose, start.pose);
+    if (distance < closest_distance) {
+      closest_distance = distance;
+      projection = i;
+    }
+  }
+
+  if (closest_distance > start_tolerance_) {
+    misses_++;
+    return false;
+  }
+
+  if (entry->revision != revision) {
+    if (!is_valid(entry->path, projection)) {
+      entries_.erase(entry);
+      misses_++;
+      return false;
+    }
+    entry->revision = revision;
+  }
+
+  entry->projection = projection;
+  entry->last_used = ++uses_;
+  path.header = entry->path.header;
+  path.poses.assign(poses.begin() + projection, poses.end());
+  hits_++;
+  return true;
+}
+
+void PlanCache::insert(
+  const std::string & planner_id,
+  const geometry_msgs::msg::PoseStamped & goal,
+  uint64_t revision,
+  const nav_msgs::msg::Path & path)
+{
+  auto entry = find(planner_id, goal);
+  if (entry == entries_.end()) {
+    if (entries_.size() < capacity_) {
+      entry = entries_.emplace(entries_.end());
+    } else {
+      entry = std::min_element(
+        entries_.begin(), entries_.end(),
+        [](const Entry & a, const Entry & b) {return a.last_used < b.last_used;});
+    }
+  }
+
+  entry->planner_id = planner_id;
+  entry->goal = goal;
+  entry->revision = revision;
+  entry->path = path;
+  entry->projection = 0;
+  entry->last_used = ++uses_;
+}
+
+void PlanCache::clear()
+{
+  entries_.clear();
+}
+
+}  // namespace nav2_planner
@@ -13,8 +13,11 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+#include <algorithm>
+#include <atomic>
 #include <chrono>
 #include <cmath>
+#include <exception>
 #include <iomanip>
 #include <iostream>
 #include <limits>
@@ -29,6 +32,7 @@
 #include "nav2_util/costmap.hpp"
 #include "nav2_util/node_utils.hpp"
 #include "nav2_util/geometry_utils.hpp"
+#include "nav2_util/tracing.hpp"
 #include "nav2_costmap_2d/cost_values.hpp"
 
 #include "nav2_planner/planner_server.hpp"
@@ -53,6 +57,14 @@ PlannerServer::PlannerServer(const rclcpp::NodeOptions & options)
   declare_parameter("planner_plugins", default_ids_);
   declare_parameter("expected_planner_frequency", 1.0);
   declare_parameter("action_server_result_timeout", 10.0);
+  declare_parameter("batch_planner_instances", 1);
+  declare_parameter("plan_cache_size", 0);
+  declare_parameter("plan_cache_start_tolerance", 0.5);
+  declare_parameter("plan_cache_goal_tolerance", 0.05);
+  declare_parameter("plan_cache_goal_yaw_tolerance", 0.1);
+  declare_parameter("cost_to_go_allow_unknown", true);
+  declare_parameter("stream_partial_paths", false);
+  declare_parameter("lazy_plugin_loading", false);
 
   get_parameter("planner_plugins", planner_ids_);
   if (planner_ids_ == default_ids_) {
@@ -64,7 +76,7 @@ PlannerServer::PlannerServer(const rclcpp::NodeOptions & options)
   // Setup the global costmap
   costmap_ros_ = std::make_shared<nav2_costmap_2d::Costmap2DROS>(
     "global_costmap", std::string{get_namespace()}, "global_costmap",
-    get_parameter("use_sim_time").as_bool());
+    get_parameter("use_sim_time").as_bool(), get_node_options().use_intra_process_comms());
 }
 
 PlannerServer::~PlannerServer()
@@ -73,6 +85,8 @@ PlannerServer::~PlannerServer()
    * Backstop ensuring this state is destroyed, even if deactivate/cleanup are
    * never called.
    */
+  batch_pool_.reset();
+  batch_planners_.clear();
   planners_.clear();
   costmap_thread_.reset();
 }
@@ -85,14 +99,9 @@ PlannerServer::on_configure(const rclcpp_lifecycle::State & /*state*/)
   costmap_ros_->configure();
   costmap_ = costmap_ros_->getCostmap();
 
-  if (!costmap_ros_->getUseRadius()) {
-    collision_checker_ =
-      std::make_unique<nav2_costmap_2d::FootprintCollisionChecker<nav2_costmap_2d::Costmap2D *>>(
-      costmap_);
-  }
-
   // Launch a thread to run the costmap node
-  costmap_thread_ = std::make_unique<nav2_util::NodeThread>(costmap_ros_);
+  costmap_thread_ = std::make_unique<nav2_util::NodeThread>(
+    costmap_ros_, getThreadSettings("costmap_thread"));
 
   RCLCPP_DEBUG(
     get_logger(), "Costmap size: %d,%d",
@@ -104,6 +113,10 @@ PlannerServer::on_configure(const rclcpp_lifecycle::State & /*state*/)
 
   auto node = shared_from_this();
 
+  // Lazily, plugins are created now but only configured and activated on their first use
+  const bool lazy_plugin_loading = get_parameter("lazy_plugin_loading").as_bool();
+  stream_partial_paths_ = get_parameter("stream_partial_paths").as_bool();
+
   for (size_t i = 0; i != planner_ids_.size(); i++) {
     try {
       planner_types_[i] = nav2_util::get_plugin_type_param(
@@ -113,7 +126,11 @@ PlannerServer::on_configure(const rclcpp_lifecycle::State & /*state*/)
       RCLCPP_INFO(
         get_logger(), "Created global planner plugin %s of type %s",
         planner_ids_[i].c_str(), planner_types_[i].c_str());
-      planner->configure(node, planner_ids_[i], tf_, costmap_ros_);
+      if (lazy_plugin_loading) {
+        unconfigured_planners_.insert(planner_ids_[i]);
+      } else {
+        configurePlanner(planner_ids_[i], *planner);
+      }
       planners_.insert({planner_ids_[i], planner});
     } catch (const std::exception & ex) {
       RCLCPP_FATAL(
@@ -123,10 +140,56 @@ PlannerServer::on_configure(const rclcpp_lifecycle::State & /*state*/)
     }
   }
 
+  // Additional instances of each planner, so that goals of a batch plan concurrently
+  get_parameter("batch_planner_instances", batch_planner_instances_);
+  if (batch_planner_instances_ < 1) {
+    RCLCPP_WARN(
+      get_logger(), "batch_planner_instances must be at least 1, got %d. Using 1.",
+      batch_planner_instances_);
+    batch_planner_instances_ = 1;
+  }
+
+  for (size_t i = 0; i != planner_ids_.size(); i++) {
+    auto & instances = batch_planners_[planner_ids_[i]];
+    for (int j = 1; j < batch_planner_instances_; j++) {
+      try {
+        nav2_core::GlobalPlanner::Ptr planner =
+          gp_loader_.createUniqueInstance(planner_types_[i]);
+        if (!lazy_plugin_loading) {
+          planner->configure(node, planner_ids_[i], tf_, costmap_ros_);
+        }
+        instances.push_back(planner);
+      } catch (const std::exception & ex) {
+        RCLCPP_FATAL(
+          get_logger(), "Failed to create batch instance of global planner. Exception: %s",
+          ex.what());
+        return nav2_util::CallbackReturn::FAILURE;
+      }
+    }
+  }
+
+  if (batch_planner_instances_ > 1) {
+    // The thread calling parallelFor plans as well
+    batch_pool_ = std::make_unique<nav2_util::ThreadPool>(batch_planner_instances_ - 1);
+  }
+
   for (size_t i = 0; i != planner_ids_.size(); i++) {
     planner_ids_concat_ += planner_ids_[i] + std::string(" ");
   }
 
+  cost_to_go_field_ = std::make_unique<CostToGoField>(
+    get_parameter("cost_to_go_allow_unknown").as_bool());
+
+  int plan_cache_size;
+  get_parameter("plan_cache_size", plan_cache_size);
+  if (plan_cache_size > 0) {
+    plan_cache_ = std::make_unique<PlanCache>(
+      static_cast<size_t>(plan_cache_size),
+      get_parameter("plan_cache_start_tolerance").as_double(),
+      get_parameter("plan_cache_goal_tolerance").as_double(),
+      get_parameter("plan_cache_goal_yaw_tolerance").as_double());
+  }
+
   RCLCPP_INFO(
     get_logger(),
     "Planner Server has %s planners available.", planner_ids_concat_.c_str());
@@ -168,6 +231,14 @@ PlannerServer::on_configure(const rclcpp_lifecycle::State & /*state*/)
     std::chrono::milliseconds(500),
     true, server_options);
 
+  action_server_paths_ = std::make_unique<ActionServerToPoses>(
+    shared_from_this(),
+    "compute_paths_to_poses",
+    std::bind(&PlannerServer::computePlansToPoses, this),
+    nullptr,
+    std::chrono::milliseconds(500),
+    true, server_options);
+
   return nav2_util::CallbackReturn::SUCCESS;
 }
 
@@ -179,14 +250,28 @@ PlannerServer::on_activate(const rclcpp_lifecycle::State & /*state*/)
   plan_publisher_->on_activate();
   action_server_pose_->activate();
   action_server_poses_->activate();
+  action_server_paths_->activate();
   const auto costmap_ros_state = costmap_ros_->activate();
   if (costmap_ros_state.id() != lifecycle_msgs::msg::State::PRIMARY_STATE_ACTIVE) {
     return nav2_util::CallbackReturn::FAILURE;
   }
 
-  PlannerMap::iterator it;
-  for (it = planners_.begin(); it != planners_.end(); ++it) {
-    it->second->activate();
+  {
+    std::lock_guard<std::mutex> lock(plugin_load_mutex_);
+    planners_active_ = true;
+    PlannerMap::iterator it;
+    for (it = planners_.begin(); it != planners_.end(); ++it) {
+      if (unconfigured_planners_.count(it->first) == 0) {
+        it->second->activate();
+      }
+    }
+    for (auto & instances : batch_planners_) {
+      if (unconfigured_planners_.count(instances.first) == 0) {
+        for (auto & planner : instances.second) {
+          planner->activate();
+        }
+      }
+    }
   }
 
   auto node = shared_from_this();
@@ -197,6 +282,12 @@ PlannerServer::on_activate(const rclcpp_lifecycle::State & /*state*/)
       &PlannerServer::isPathValid, this,
       std::placeholders::_1, std::placeholders::_2));
 
+  cost_to_go_service_ = node->create_service<nav2_msgs::srv::GetCostToGo>(
+    "get_cost_to_go",
+    std::bind(
+      &PlannerServer::getCostToGo, this,
+      std::placeholders::_1, std::placeholders::_2));
+
   // Add callback for dynamic parameters
   dyn_params_handler_ = node->add_on_set_parameters_callback(
     std::bind(&PlannerServer::dynamicParametersCallback, this, _1));
@@ -214,6 +305,7 @@ PlannerServer::on_deactivate(const rclcpp_lifecycle::State & /*state*/)
 
   action_server_pose_->deactivate();
   action_server_poses_->deactivate();
+  action_server_paths_->deactivate();
   plan_publisher_->on_deactivate();
 
   /*
@@ -225,13 +317,31 @@ PlannerServer::on_deactivate(const rclcpp_lifecycle::State & /*state*/)
    */
   costmap_ros_->deactivate();
 
-  PlannerMap::iterator it;
-  for (it = planners_.begin(); it != planners_.end(); ++it) {
-    it->second->deactivate();
+  {
+    std::lock_guard<std::mutex> lock(plugin_load_mutex_);
+    planners_active_ = false;
+    PlannerMap::iterator it;
+    for (it = planners_.begin(); it != planners_.end(); ++it) {
+      if (unconfigured_planners_.count(it->first) == 0) {
+        it->second->deactivate();
+      }
+    }
+    for (auto & instances : batch_planners_) {
+      if (unconfigured_planners_.count(instances.first) == 0) {
+        for (auto & planner : instances.second) {
+          planner->deactivate();
+        }
+      }
+    }
   }
 
   dyn_params_handler_.reset();
 
+  // Plans may have been invalidated while inactive
+  if (plan_cache_) {
+    plan_cache_->clear();
+  }
+
   // destroy bond connection
   destroyBond();
 
@@ -245,6 +355,7 @@ PlannerServer::on_cleanup(const rclcpp_lifecycle::State & /*state*/)
 
   action_server_pose_.reset();
   action_server_poses_.reset();
+  action_server_paths_.reset();
   plan_publisher_.reset();
   tf_.reset();
 
@@ -252,9 +363,24 @@ PlannerServer::on_cleanup(const rclcpp_lifecycle::State & /*state*/)
 
   PlannerMap::iterator it;
   for (it = planners_.begin(); it != planners_.end(); ++it) {
-    it->second->cleanup();
+    if (unconfigured_planners_.count(it->first) == 0) {
+      it->second->cleanup();
+    }
   }
+  for (auto & instances : batch_planners_) {
+    if (unconfigured_planners_.count(instances.first) == 0) {
+      for (auto & planner : instances.second) {
+        planner->cleanup();
+      }
+    }
+  }
+  unconfigured_planners_.clear();
+  failed_planners_.clear();
 
+  batch_pool_.reset();
+  batch_planners_.clear();
+  plan_cache_.reset();
+  cost_to_go_field_.reset();
   planners_.clear();
   costmap_thread_.reset();
   costmap_ = nullptr;
@@ -398,37 +524,88 @@ void PlannerServer::computePlanThroughPoses()
         return action_server_poses_->is_cancel_requested();
       };
 
-    // Get consecutive paths through these points
-    for (unsigned int i = 0; i != goal->goals.size(); i++) {
-      // Get starting point
-      if (i == 0) {
-        curr_start = start;
-      } else {
-        // pick the end of the last planning task as the start for the next one
-        // to allow for path tolerance deviations
-        curr_start = concat_path.poses.back();
-        curr_start.header = concat_path.header;
+    // Each segment past the first starts from the previous goal, known up front, so that
+    // with additional planner instances the segments are planned concurrently
+    const std::string planner_id = resolvePlannerId(goal->planner_id);
+    std::vector<nav2_core::GlobalPlanner *> instances{planners_[planner_id].get()};
+    for (auto & planner : batch_planners_[planner_id]) {
+      instances.push_back(planner.get());
+    }
+
+    const size_t segments_count = goal->goals.size();
+    if (batch_pool_ && instances.size() > 1 && segments_count > 1) {
+      std::vector<geometry_msgs::msg::PoseStamped> starts(segments_count);
+      std::vector<geometry_msgs::msg::PoseStamped> goals(goal->goals.begin(), goal->goals.end());
+      for (size_t i = 0; i != segments_count; i++) {
+        starts[i] = i == 0 ? start : goal->goals[i - 1];
+        if (!transformPosesToGlobalFrame(starts[i], goals[i])) {
+          curr_start = starts[i];
+          curr_goal = goals[i];
+          throw nav2_core::PlannerTFError("Unable to transform poses to global frame");
+        }
       }
-      curr_goal = goal->goals[i];
 
-      // Transform them into the global frame
-      if (!transformPosesToGlobalFrame(curr_start, curr_goal)) {
-        throw nav2_core::PlannerTFError("Unable to transform poses to global frame");
+      std::vector<nav_msgs::msg::Path> paths(segments_count);
+      std::vector<std::exception_ptr> errors(segments_count);
+      std::atomic<size_t> next_segment{0};
+      auto plan_segments = [&](size_t instance) {
+          for (size_t i = next_segment++; i < segments_count; i = next_segment++) {
+            try {
+              paths[i] = instances[instance]->createPlan(starts[i], goals[i], cancel_checker);
+              if (!validatePath<ActionThroughPoses>(goals[i], paths[i], planner_id)) {
+                throw nav2_core::NoValidPathCouldBeFound(planner_id + " generated a empty path");
+              }
+            } catch (...) {
+              errors[i] = std::current_exception();
+            }
+          }
+        };
+      batch_pool_->parallelFor(0, std::min(instances.size(), segments_count), plan_segments);
+
+      // Concatenated in order, the error of the first failing segment being reported
+      for (size_t i = 0; i != segments_count; i++) {
+        curr_start = starts[i];
+        curr_goal = goals[i];
+        if (errors[i]) {
+          std::rethrow_exception(errors[i]);
+        }
+        concat_path.poses.insert(
+          concat_path.poses.end(), paths[i].poses.begin(), paths[i].poses.end());
+        concat_path.header = paths[i].header;
       }
+    } else {
+      // Get consecutive paths through these points
+      for (unsigned int i = 0; i != goal->goals.size(); i++) {
+        // Get starting point
+        if (i == 0) {
+          curr_start = start;
+        } else {
+          // pick the end of the last planning task as the start for the next one
+          // to allow for path tolerance deviations
+          curr_start = concat_path.poses.back();
+          curr_start.header = concat_path.header;
+        }
+        curr_goal = goal->goals[i];
+
+        // Transform them into the global frame
+        if (!transformPosesToGlobalFrame(curr_start, curr_goal)) {
+          throw nav2_core::PlannerTFError("Unable to transform poses to global frame");
+        }
 
-      // Get plan from start -> goal
-      nav_msgs::msg::Path curr_path = getPlan(
-        curr_start, curr_goal, goal->planner_id,
-        cancel_checker);
+        // Get plan from start -> goal
+        nav_msgs::msg::Path curr_path = getPlan(
+          curr_start, curr_goal, goal->planner_id,
+          cancel_checker);
 
-      if (!validatePath<ActionThroughPoses>(curr_goal, curr_path, goal->planner_id)) {
-        throw nav2_core::NoValidPathCouldBeFound(goal->planner_id + " generated a empty path");
-      }
+        if (!validatePath<ActionThroughPoses>(curr_goal, curr_path, goal->planner_id)) {
+          throw nav2_core::NoValidPathCouldBeFound(goal->planner_id + " generated a empty path");
+        }
 
-      // Concatenate paths together
-      concat_path.poses.insert(
-        concat_path.poses.end(), curr_path.poses.begin(), curr_path.poses.end());
-      concat_path.header = curr_path.header;
+        // Concatenate paths together
+        concat_path.poses.insert(
+          concat_path.poses.end(), curr_path.poses.begin(), curr_path.poses.end());
+        concat_path.header = curr_path.header;
+      }
     }
 
     // Publish the plan for visualization purposes
@@ -529,7 +706,14 @@ PlannerServer::computePlan()
         return action_server_pose_->is_cancel_requested();
       };
 
-    result->path = getPlan(start, goal_pose, goal->planner_id, cancel_checker);
+    streaming_to_pose_ = stream_partial_paths_;
+    try {
+      result->path = getPlan(start, goal_pose, goal->planner_id, cancel_checker);
+    } catch (...) {
+      streaming_to_pose_ = false;
+      throw;
+    }
+    streaming_to_pose_ = false;
 
     if (!validatePath<ActionThroughPoses>(goal_pose, result->path, goal->planner_id)) {
       throw nav2_core::NoValidPathCouldBeFound(goal->planner_id + " generated a empty path");
@@ -590,6 +774,181 @@ PlannerServer::computePlan()
   }
 }
 
+void
+PlannerServer::computePlansToPoses()
+{
+  std::lock_guard<std::mutex> lock(dynamic_params_lock_);
+
+  auto start_time = this->now();
+
+  // Initialize the ComputePathsToPoses goal and result
+  auto goal = action_server_paths_->get_current_goal();
+  auto result = std::make_shared<ActionToPoses::Result>();
+
+  // Poses in the warnings of the errors common to the batch
+  geometry_msgs::msg::PoseStamped start, no_goal;
+
+  try {
+    if (isServerInactive(action_server_paths_) || isCancelRequested(action_server_paths_)) {
+      return;
+    }
+
+    waitForCostmap();
+
+    getPreemptedGoalIfRequested(action_server_paths_, goal);
+
+    if (goal->goals.empty()) {
+      throw nav2_core::NoViapointsGiven("No goals given");
+    }
+
+    // Use start pose if provided otherwise use current robot pose
+    if (!getStartPose<ActionToPoses>(goal, start)) {
+      throw nav2_core::PlannerTFError("Unable to get start pose");
+    }
+    if (!costmap_ros_->transformPoseToGlobalFrame(start, start)) {
+      throw nav2_core::PlannerTFError("Unable to transform start pose to global frame");
+    }
+
+    const std::string planner_id = resolvePlannerId(goal->planner_id);
+
+    // Goals failing to transform are reported in their error codes, not planned
+    const size_t goals_count = goal->goals.size();
+    std::vector<geometry_msgs::msg::PoseStamped> goals(goal->goals.begin(), goal->goals.end());
+    result->paths.resize(goals_count);
+    result->lengths.assign(goals_count, std::numeric_limits<float>::infinity());
+    result->error_codes.assign(goals_count, ActionToPosesResult::NONE);
+    for (size_t i = 0; i != goals_count; i++) {
+      if (!costmap_ros_->transformPoseToGlobalFrame(goals[i], goals[i])) {
+        exceptionWarning(
+          start, goal->goals[i], planner_id,
+          nav2_core::PlannerTFError("Unable to transform goal pose to global frame"));
+        result->error_codes[i] = ActionToPosesResult::TF_ERROR;
+      }
+    }
+
+    // Each instance plans the next goal left until there is none
+    std::vector<nav2_core::GlobalPlanner *> instances{planners_[planner_id].get()};
+    for (auto & planner : batch_planners_[planner_id]) {
+      instances.push_back(planner.get());
+    }
+
+    auto cancel_checker = [this]() {
+        return action_server_paths_->is_cancel_requested();
+      };
+
+    std::atomic<size_t> next_goal{0};
+    auto plan_goals = [&](size_t instance) {
+        for (size_t i = next_goal++; i < goals_count; i = next_goal++) {
+          if (result->error_codes[i] != ActionToPosesResult::NONE) {
+            continue;
+          }
+          result->error_codes[i] = planToBatchGoal(
+            *instances[instance], start, goals[i], planner_id, cancel_checker,
+            result->paths[i]);
+          if (result->error_codes[i] == ActionToPosesResult::NONE) {
+            result->lengths[i] = static_cast<float>(
+              nav2_util::geometry_utils::calculate_path_length(result->paths[i]));
+          }
+        }
+      };
+
+    const size_t instances_count = std::min(instances.size(), goals_count);
+    if (batch_pool_ && instances_count > 1) {
+      batch_pool_->parallelFor(0, instances_count, plan_goals);
+    } else {
+      plan_goals(0);
+    }
+
+    // The batch succeeds as long as a goal is reachable
+    if (std::none_of(
+        result->error_codes.begin(), result->error_codes.end(),
+        [](uint16_t error_code) {return error_code == ActionToPosesResult::NONE;}))
+    {
+      result->error_code = result->error_codes.front();
+      result->error_msg = "No path found to any of the goals";
+      RCLCPP_WARN(get_logger(), "%s", result->error_msg.c_str());
+      action_server_paths_->terminate_current(result);
+      return;
+    }
+
+    auto cycle_duration = this->now() - start_time;
+    result->planning_time = cycle_duration;
+
+    if (max_planner_duration_ && cycle_duration.seconds() > max_planner_duration_) {
+      RCLCPP_WARN(
+        get_logger(),
+        "Planner loop missed its desired rate of %.4f Hz. Current loop rate is %.4f Hz",
+        1 / max_planner_duration_, 1 / cycle_duration.seconds());
+    }
+
+    action_server_paths_->succeeded_current(result);
+  } catch (nav2_core::InvalidPlanner & ex) {
+    exceptionWarning(start, no_goal, goal->planner_id, ex);
+    result->error_code = ActionToPosesResult::INVALID_PLANNER;
+    action_server_paths_->terminate_current(result);
+  } catch (nav2_core::PlannerTFError & ex) {
+    exceptionWarning(start, no_goal, goal->planner_id, ex);
+    result->error_code = ActionToPosesResult::TF_ERROR;
+    action_server_paths_->terminate_current(result);
+  } catch (nav2_core::NoViapointsGiven & ex) {
+    exceptionWarning(start, no_goal, goal->planner_id, ex);
+    result->error_code = ActionToPosesResult::NO_VIAPOINTS_GIVEN;
+    action_server_paths_->terminate_current(result);
+  } catch (nav2_core::PlannerCancelled &) {
+    RCLCPP_INFO(get_logger(), "Goal was canceled. Canceling planning action.");
+    action_server_paths_->terminate_all();
+  } catch (std::exception & ex) {
+    exceptionWarning(start, no_goal, goal->planner_id, ex);
+    result->error_code = ActionToPosesResult::UNKNOWN;
+    action_server_paths_->terminate_current(result);
+  }
+}
+
+uint16_t
+PlannerServer::planToBatchGoal(
+  nav2_core::GlobalPlanner & planner,
+  const geometry_msgs::msg::PoseStamped & start,
+  const geometry_msgs::msg::PoseStamped & goal,
+  const std::string & planner_id,
+  std::function<bool()> cancel_checker,
+  nav_msgs::msg::Path & path)
+{
+  try {
+    path = planner.createPlan(start, goal, cancel_checker);
+    if (!validatePath<ActionToPoses>(goal, path, planner_id)) {
+      throw nav2_core::NoValidPathCouldBeFound(planner_id + " generated a empty path");
+    }
+    return ActionToPosesResult::NONE;
+  } catch (nav2_core::StartOccupied & ex) {
+    exceptionWarning(start, goal, planner_id, ex);
+    return ActionToPosesResult::START_OCCUPIED;
+  } catch (nav2_core::GoalOccupied & ex) {
+    exceptionWarning(start, goal, planner_id, ex);
+    return ActionToPosesResult::GOAL_OCCUPIED;
+  } catch (nav2_core::NoValidPathCouldBeFound & ex) {
+    exceptionWarning(start, goal, planner_id, ex);
+    return ActionToPosesResult::NO_VALID_PATH;
+  } catch (nav2_core::PlannerTimedOut & ex) {
+    exceptionWarning(start, goal, planner_id, ex);
+    return ActionToPosesResult::TIMEOUT;
+  } catch (nav2_core::StartOutsideMapBounds & ex) {
+    exceptionWarning(start, goal, planner_id, ex);
+    return ActionToPosesResult::START_OUTSIDE_MAP;
+  } catch (nav2_core::GoalOutsideMapBounds & ex) {
+    exceptionWarning(start, goal, planner_id, ex);
+    return ActionToPosesResult::GOAL_OUTSIDE_MAP;
+  } catch (nav2_core::PlannerTFError & ex) {
+    exceptionWarning(start, goal, planner_id, ex);
+    return ActionToPosesResult::TF_ERROR;
+  } catch (nav2_core::PlannerCancelled &) {
+    // Cancels the whole batch
+    throw;
+  } catch (std::exception & ex) {
+    exceptionWarning(start, goal, planner_id, ex);
+    return ActionToPosesResult::UNKNOWN;
+  }
+}
+
 nav_msgs::msg::Path
 PlannerServer::getPlan(
   const geometry_msgs::msg::PoseStamped & start,
@@ -597,30 +956,112 @@ PlannerServer::getPlan(
   const std::string & planner_id,
   std::function<bool()> cancel_checker)
 {
+  NAV2_TRACE_SCOPE("planner.getPlan");
   RCLCPP_DEBUG(
     get_logger(), "Attempting to a find path from (%.2f, %.2f) to "
     "(%.2f, %.2f).", start.pose.position.x, start.pose.position.y,
     goal.pose.position.x, goal.pose.position.y);
 
-  if (planners_.find(planner_id) != planners_.end()) {
-    return planners_[planner_id]->createPlan(start, goal, cancel_checker);
+  const std::string id = resolvePlannerId(planner_id);
+  if (!plan_cache_) {
+    return planners_[id]->createPlan(start, goal, cancel_checker);
+  }
+
+  // Taken before planning, so that updates during the search trigger a validation
+  const auto snapshot = costmap_ros_->getCostmapSnapshot();
+  const uint64_t revision = snapshot->getRevision();
+  nav_msgs::msg::Path path;
+  if (plan_cache_->lookup(
+      id, start, goal, revision,
+      [this, &snapshot](const nav_msgs::msg::Path & cached_path, unsigned int start_index) {
+        return isPathCollisionFree(snapshot, cached_path, start_index);
+      }, path))
+  {
+    path.header.stamp = now();
   } else {
-    if (planners_.size() == 1 && planner_id.empty()) {
-      RCLCPP_WARN_ONCE(
-        get_logger(), "No planners specified in action call. "
-        "Server will use only plugin %s in server."
-        " This warning will appear once.", planner_ids_concat_.c_str());
-      return planners_[planners_.begin()->first]->createPlan(start, goal, cancel_checker);
-    } else {
-      RCLCPP_ERROR(
-        get_logger(), "planner %s is not a valid planner. "
-        "Planner names are: %s", planner_id.c_str(),
-        planner_ids_concat_.c_str());
-      throw nav2_core::InvalidPlanner("Planner id " + planner_id + " is invalid");
+    path = planners_[id]->createPlan(start, goal, cancel_checker);
+    if (!path.poses.empty()) {
+      plan_cache_->insert(id, goal, revision, path);
     }
   }
 
-  return nav_msgs::msg::Path();
+  RCLCPP_DEBUG(
+    get_logger(), "Plan cache hits: %lu, misses: %lu",
+    plan_cache_->getHits(), plan_cache_->getMisses());
+  return path;
+}
+
+std::string
+PlannerServer::resolvePlannerId(const std::string & planner_id)
+{
+  if (planners_.find(planner_id) != planners_.end()) {
+    loadPlannerIfUnconfigured(planner_id);
+    return planner_id;
+  }
+
+  if (planners_.size() == 1 && planner_id.empty()) {
+    RCLCPP_WARN_ONCE(
+      get_logger(), "No planners specified in action call. "
+      "Server will use only plugin %s in server."
+      " This warning will appear once.", planner_ids_concat_.c_str());
+    loadPlannerIfUnconfigured(planners_.begin()->first);
+    return planners_.begin()->first;
+  }
+
+  RCLCPP_ERROR(
+    get_logger(), "planner %s is not a valid planner. "
+    "Planner names are: %s", planner_id.c_str(),
+    planner_ids_concat_.c_str());
+  throw nav2_core::InvalidPlanner("Planner id " + planner_id + " is invalid");
+}
+
+void
+PlannerServer::configurePlanner(const std::string & planner_id, nav2_core::GlobalPlanner & planner)
+{
+  planner.configure(shared_from_this(), planner_id, tf_, costmap_ros_);
+  if (stream_partial_paths_) {
+    planner.setPartialPathCallback(
+      [this](const nav_msgs::msg::Path & path) {publishPartialPath(path);});
+  }
+}
+
+void
+PlannerServer::loadPlannerIfUnconfigured(const std::string & planner_id)
+{
+  std::lock_guard<std::mutex> lock(plugin_load_mutex_);
+  if (unconfigured_planners_.count(planner_id) == 0) {
+    return;
+  }
+  if (failed_planners_.count(planner_id) != 0) {
+    throw nav2_core::InvalidPlanner("Planner " + planner_id + " failed to configure");
+  }
+
+  RCLCPP_INFO(get_logger(), "Configuring planner %s on its first use", planner_id.c_str());
+  try {
+    auto & planner = planners_.at(planner_id);
+    configurePlanner(planner_id, *planner);
+    auto instances = batch_planners_.find(planner_id);
+    if (instances != batch_planners_.end()) {
+      for (auto & instance : instances->second) {
+        instance->configure(shared_from_this(), planner_id, tf_, costmap_ros_);
+      }
+    }
+    if (planners_active_) {
+      planner->activate();
+      if (instances != batch_planners_.end()) {
+        for (auto & instance : instances->second) {
+          instance->activate();
+        }
+      }
+    }
+  } catch (const std::exception & ex) {
+    RCLCPP_ERROR(
+      get_logger(), "Failed to configure planner %s. Exception: %s",
+      planner_id.c_str(), ex.what());
+    failed_planners_.insert(planner_id);
+    throw nav2_core::InvalidPlanner("Planner " + planner_id + " failed to configure");
+  }
+  unconfigured_planners_.erase(planner_id);
 }
 
 void
@@ -632,6 +1073,19 @@ PlannerServer::publishPlan(const nav_msgs::msg::Path & path)
   }
 }
 
+void
+PlannerServer::publishPartialPath(const nav_msgs::msg::Path & path)
+{
+  // Paths through poses and batches have no feedback to stream to
+  if (!streaming_to_pose_) {
+    return;
+  }
+
+  auto feedback = std::make_shared<ActionToPose::Feedback>();
+  feedback->partial_path = path;
+  action_server_pose_->publish_feedback(feedback);
+}
+
 void PlannerServer::isPathValid(
   const std::shared_ptr<nav2_msgs::srv::IsPathValid::Request> request,
   std::shared_ptr<nav2_msgs::srv::IsPathValid::Response> response)
@@ -664,40 +1118,173 @@ void PlannerServer::isPathValid(
 
     /**
      * The lethal check starts at the closest point to avoid points that have already been passed
-     * and may have become occupied. The method for collision detection is based on the shape of
-     * the footprint.
+     * and may have become occupied. Paths already validated from an earlier point are only
+     * checked again where the costmap changed since.
      */
-    std::unique_lock<nav2_costmap_2d::Costmap2D::mutex_t> lock(*(costmap_->getMutex()));
-    unsigned int mx = 0;
-    unsigned int my = 0;
-
-    bool use_radius = costmap_ros_->getUseRadius();
-
-    unsigned int cost = nav2_costmap_2d::FREE_SPACE;
-    for (unsigned int i = closest_point_index; i < request->path.poses.size(); ++i) {
-      auto & position = request->path.poses[i].pose.position;
-      if (use_radius) {
-        if (costmap_->worldToMap(position.x, position.y, mx, my)) {
-          cost = costmap_->getCost(mx, my);
-        } else {
-          cost = nav2_costmap_2d::LETHAL_OBSTACLE;
-        }
+    const auto snapshot = costmap_ros_->getCostmapSnapshot();
+    const uint64_t hash = hashPath(request->path);
+    nav2_costmap_2d::CellRegion changed_bounds;
+    bool validated = false;
+    {
+      std::lock_guard<std::mutex> lock(path_validations_mutex_);
+      auto validation = std::find_if(
+        path_validations_.begin(), path_validations_.end(),
+        [hash](const PathValidation & v) {return v.hash == hash;});
+      validated = validation != path_validations_.end() &&
+        validation->start_index <= closest_point_index &&
+        snapshot->getChangedBounds(validation->revision, changed_bounds);
+    }
+
+    if (!validated) {
+      response->is_valid = isPathCollisionFree(snapshot, request->path, closest_point_index);
+    } else if (changed_bounds.xn > changed_bounds.x0 && changed_bounds.yn > changed_bounds.y0) {
+      response->is_valid = isPathCollisionFree(
+        snapshot, request->path, closest_point_index, &changed_bounds);
+    }
+
+    std::lock_guard<std::mutex> lock(path_validations_mutex_);
+    auto validation = std::find_if(
+      path_validations_.begin(), path_validations_.end(),
+      [hash](const PathValidation & v) {return v.hash == hash;});
+    if (!response->is_valid) {
+      // Obstacles may clear anywhere, so invalid paths are always fully checked
+      if (validation != path_validations_.end()) {
+        path_validations_.erase(validation);
+      }
+      return;
+    }
+    if (validation == path_validations_.end()) {
+      if (path_validations_.size() < kPathValidationsSize) {
+        validation = path_validations_.emplace(path_validations_.end());
       } else {
-        nav2_costmap_2d::Footprint footprint = costmap_ros_->getRobotFootprint();
-        auto theta = tf2::getYaw(request->path.poses[i].pose.orientation);
-        cost = static_cast<unsigned int>(collision_checker_->footprintCostAtPose(
-            position.x, position.y, theta, footprint));
+        validation = std::min_element(
+          path_validations_.begin(), path_validations_.end(),
+          [](const PathValidation & a, const PathValidation & b) {return a.stamp < b.stamp;});
+      }
+    }
+    *validation = PathValidation{hash, snapshot->getRevision(), closest_point_index,
+      ++path_validations_stamp_};
+  }
+}
+
+uint64_t PlannerServer::hashPath(const nav_msgs::msg::Path & path)
+{
+  // FNV-1a over the frame and pose values
+  uint64_t hash = 14695981039346656037ull;
+  auto combine = [&hash](const void * data, size_t size) {
+      const unsigned char * bytes = static_cast<const unsigned char *>(data);
+      for (size_t i = 0; i != size; i++) {
+        hash = (hash ^ bytes[i]) * 1099511628211ull;
       }
+    };
+  combine(path.header.frame_id.data(), path.header.frame_id.size());
+  for (const auto & pose : path.poses) {
+    const double values[4] = {pose.pose.position.x, pose.pose.position.y,
+      pose.pose.orientation.z, pose.pose.orientation.w};
+    combine(values, sizeof(values));
+  }
+  return hash;
+}
+
+bool PlannerServer::isPathCollisionFree(
+  const nav2_costmap_2d::CostmapSnapshot::ConstPtr & costmap,
+  const nav_msgs::msg::Path & path, unsigned int start_index,
+  const nav2_costmap_2d::CellRegion * changed_bounds)
+{
+  // The method for collision detection is based on the shape of the footprint
+  nav2_costmap_2d::FootprintCollisionChecker<nav2_costmap_2d::CostmapSnapshot::ConstPtr>
+  collision_checker(costmap);
+  const bool use_radius = costmap_ros_->getUseRadius();
+  const nav2_costmap_2d::Footprint footprint = costmap_ros_->getRobotFootprint();
+
+  // Poses further than the footprint from the changed cells keep their previous cost
+  int margin = 0;
+  if (changed_bounds && !use_radius) {
+    margin = static_cast<int>(std::ceil(
+        costmap_ros_->getLayeredCostmap()->getCircumscribedRadius() /
+        costmap->getResolution())) + 1;
+  }
+
+  unsigned int mx = 0;
+  unsigned int my = 0;
+  unsigned int cost = nav2_costmap_2d::FREE_SPACE;
+  for (unsigned int i = start_index; i < path.poses.size(); ++i) {
+    auto & position = path.poses[i].pose.position;
+    const bool on_map = costmap->worldToMap(position.x, position.y, mx, my);
+    if (changed_bounds && on_map &&
+      (static_cast<int>(mx) + margin < static_cast<int>(changed_bounds->x0) ||
+      static_cast<int>(mx) - margin >= static_cast<int>(changed_bounds->xn) ||
+      static_cast<int>(my) + margin < static_cast<int>(changed_bounds->y0) ||
+      static_cast<int>(my) - margin >= static_cast<int>(changed_bounds->yn)))
+    {
+      continue;
+    }
+
+    if (use_radius) {
+      cost = on_map ? costmap->getCost(mx, my) : nav2_costmap_2d::LETHAL_OBSTACLE;
+    } else {
+      auto theta = tf2::getYaw(path.poses[i].pose.orientation);
+      cost = static_cast<unsigned int>(collision_checker.footprintCostAtPose(
+          position.x, position.y, theta, footprint));
+    }
+
+    if (use_radius &&
+      (cost == nav2_costmap_2d::LETHAL_OBSTACLE ||
+      cost == nav2_costmap_2d::INSCRIBED_INFLATED_OBSTACLE))
+    {
+      return false;
+    } else if (cost == nav2_costmap_2d::LETHAL_OBSTACLE) {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+void PlannerServer::getCostToGo(
+  const std::shared_ptr<nav2_msgs::srv::GetCostToGo::Request> request,
+  std::shared_ptr<nav2_msgs::srv::GetCostToGo::Response> response)
+{
+  const size_t starts_count = request->starts.size();
+  response->distances.assign(starts_count, std::numeric_limits<float>::infinity());
+  if (request->compute_paths) {
+    response->paths.resize(starts_count);
+  }
+
+  geometry_msgs::msg::PoseStamped goal;
+  if (!costmap_ros_->transformPoseToGlobalFrame(request->goal, goal)) {
+    RCLCPP_WARN(get_logger(), "Unable to transform the cost-to-go goal to the global frame");
+    return;
+  }
+
+  std::lock_guard<std::mutex> lock(cost_to_go_mutex_);
+  if (!cost_to_go_field_->update(
+      costmap_ros_->getCostmapSnapshot(), goal.pose.position.x, goal.pose.position.y))
+  {
+    RCLCPP_WARN(
+      get_logger(), "Cost-to-go goal (%.2f, %.2f) is off the costmap",
+      goal.pose.position.x, goal.pose.position.y);
+    return;
+  }
+  response->costmap_revision = cost_to_go_field_->getRevision();
+
+  geometry_msgs::msg::PoseStamped start;
+  for (size_t i = 0; i != starts_count; i++) {
+    if (!costmap_ros_->transformPoseToGlobalFrame(request->starts[i], start)) {
+      RCLCPP_WARN(get_logger(), "Unable to transform a cost-to-go start to the global frame");
+      continue;
+    }
 
-      if (use_radius &&
-        (cost == nav2_costmap_2d::LETHAL_OBSTACLE ||
-        cost == nav2_costmap_2d::INSCRIBED_INFLATED_OBSTACLE))
-      {
-        response->is_valid = false;
-        break;
-      } else if (cost == nav2_costmap_2d::LETHAL_OBSTACLE) {
-        response->is_valid = false;
-        break;
+    response->distances[i] =
+      cost_to_go_field_->getDistance(start.pose.position.x, start.pose.position.y);
+    if (request->compute_paths &&
+      cost_to_go_field_->getPath(
+        start.pose.position.x, start.pose.position.y, response->paths[i]))
+    {
+      response->paths[i].header.frame_id = costmap_ros_->getGlobalFrameID();
+      response->paths[i].header.stamp = now();
+      for (auto & pose : response->paths[i].poses) {
+        pose.header = response->paths[i].header;
       }
     }
   }
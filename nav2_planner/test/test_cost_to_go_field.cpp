@@ -0,0 +1,81 @@
+// Copyright (c) 2021, Samsung Research America
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License. Reserved.
+
+#include <cmath>
+#include <memory>
+
+#include "gtest/gtest.h"
+#include "nav2_costmap_2d/cost_values.hpp"
+#include "nav2_costmap_2d/costmap_2d.hpp"
+#include "nav2_planner/cost_to_go_field.hpp"
+
+nav2_costmap_2d::CostmapSnapshot::ConstPtr makeSnapshot(
+  const nav2_costmap_2d::Costmap2D & costmap, uint64_t revision)
+{
+  auto snapshot = std::make_shared<nav2_costmap_2d::CostmapSnapshot>();
+  snapshot->copyFrom(costmap, revision);
+  return snapshot;
+}
+
+TEST(CostToGoFieldTest, testDistancesInFreeSpace)
+{
+  nav2_costmap_2d::Costmap2D costmap(20, 20, 0.1, 0.0, 0.0, nav2_costmap_2d::FREE_SPACE);
+  nav2_planner::CostToGoField field(true);
+  ASSERT_TRUE(field.update(makeSnapshot(costmap, 1), 0.05, 0.05));
+  EXPECT_EQ(field.getRevision(), 1u);
+
+  EXPECT_FLOAT_EQ(field.getDistance(0.05, 0.05), 0.0f);
+  EXPECT_NEAR(field.getDistance(1.05, 0.05), 1.0f, 1e-5);
+  EXPECT_NEAR(field.getDistance(0.55, 0.55), 0.5f * M_SQRT2, 1e-5);
+  EXPECT_TRUE(std::isinf(field.getDistance(-1.0, 0.05)));
+
+  nav_msgs::msg::Path path;
+  ASSERT_TRUE(field.getPath(1.05, 0.55, path));
+  EXPECT_NEAR(path.poses.front().pose.position.x, 1.05, 1e-6);
+  EXPECT_NEAR(path.poses.back().pose.position.x, 0.05, 1e-6);
+  EXPECT_NEAR(path.poses.back().pose.position.y, 0.05, 1e-6);
+  EXPECT_EQ(path.poses.size(), 11u);
+
+  EXPECT_FALSE(field.update(makeSnapshot(costmap, 2), 5.0, 5.0));
+}
+
+TEST(CostToGoFieldTest, testDistancesAroundWalls)
+{
+  // Wall along x = 1m with a gap at its top, reachable only by going around it
+  nav2_costmap_2d::Costmap2D costmap(20, 20, 0.1, 0.0, 0.0, nav2_costmap_2d::FREE_SPACE);
+  for (unsigned int y = 0; y != 18; y++) {
+    costmap.setCost(10, y, nav2_costmap_2d::LETHAL_OBSTACLE);
+  }
+  nav2_planner::CostToGoField field(true);
+  ASSERT_TRUE(field.update(makeSnapshot(costmap, 1), 0.55, 0.05));
+
+  EXPECT_GT(field.getDistance(1.55, 0.05), 3.0f);
+  EXPECT_TRUE(std::isinf(field.getDistance(1.05, 0.05)));
+
+  nav_msgs::msg::Path path;
+  ASSERT_TRUE(field.getPath(1.55, 0.05, path));
+  for (const auto & pose : path.poses) {
+    EXPECT_FALSE(std::abs(pose.pose.position.x - 1.05) < 1e-3 && pose.pose.position.y < 1.8);
+  }
+
+  // Fully enclosing the goal makes the other side unreachable
+  costmap.setCost(10, 18, nav2_costmap_2d::LETHAL_OBSTACLE);
+  costmap.setCost(10, 19, nav2_costmap_2d::NO_INFORMATION);
+  nav2_planner::CostToGoField known_field(false);
+  ASSERT_TRUE(known_field.update(makeSnapshot(costmap, 2), 0.55, 0.05));
+  EXPECT_TRUE(std::isinf(known_field.getDistance(1.55, 0.05)));
+  EXPECT_FALSE(known_field.getPath(1.55, 0.05, path));
+  ASSERT_TRUE(field.update(makeSnapshot(costmap, 2), 0.55, 0.05));
+  EXPECT_FALSE(std::isinf(field.getDistance(1.55, 0.05)));
+}
@@ -0,0 +1,107 @@
+// Copyright (c) 2021, Samsung Research America
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License. Reserved.
+
+#include <string>
+
+#include "gtest/gtest.h"
+#include "nav2_planner/plan_cache.hpp"
+
+geometry_msgs::msg::PoseStamped makePose(double x, double y)
+{
+  geometry_msgs::msg::PoseStamped pose;
+  pose.header.frame_id = "map";
+  pose.pose.position.x = x;
+  pose.pose.position.y = y;
+  pose.pose.orientation.w = 1.0;
+  return pose;
+}
+
+nav_msgs::msg::Path makeStraightPath(unsigned int poses_count)
+{
+  nav_msgs::msg::Path path;
+  path.header.frame_id = "map";
+  for (unsigned int i = 0; i != poses_count; i++) {
+    path.poses.push_back(makePose(0.1 * i, 0.0));
+  }
+  return path;
+}
+
+TEST(PlanCacheTest, testReuseAlongPath)
+{
+  nav2_planner::PlanCache cache(4, 0.5, 0.05, 0.1);
+  auto path = makeStraightPath(50);
+  auto goal = path.poses.back();
+  unsigned int validations = 0;
+  auto is_valid = [&](const nav_msgs::msg::Path &, unsigned int) {
+      validations++;
+      return true;
+    };
+
+  nav_msgs::msg::Path cached;
+  EXPECT_FALSE(cache.lookup("GridBased", makePose(0.0, 0.0), goal, 1, is_valid, cached));
+  cache.insert("GridBased", goal, 1, path);
+
+  // Same revision: reused without validation, from the projection of the start
+  EXPECT_TRUE(cache.lookup("GridBased", makePose(1.0, 0.1), goal, 1, is_valid, cached));
+  EXPECT_EQ(validations, 0u);
+  EXPECT_EQ(cached.poses.size(), 40u);
+  EXPECT_NEAR(cached.poses.front().pose.position.x, 1.0, 1e-6);
+
+  // New revision: validated once, then reused as is
+  EXPECT_TRUE(cache.lookup("GridBased", makePose(2.0, 0.0), goal, 2, is_valid, cached));
+  EXPECT_TRUE(cache.lookup("GridBased", makePose(2.0, 0.0), goal, 2, is_valid, cached));
+  EXPECT_EQ(validations, 1u);
+  EXPECT_EQ(cached.poses.size(), 30u);
+
+  // Other planners, other goals and starts away from the path miss
+  EXPECT_FALSE(cache.lookup("Other", makePose(2.0, 0.0), goal, 2, is_valid, cached));
+  EXPECT_FALSE(
+    cache.lookup("GridBased", makePose(2.0, 0.0), makePose(1.0, 1.0), 2, is_valid, cached));
+  EXPECT_FALSE(cache.lookup("GridBased", makePose(2.0, 1.0), goal, 2, is_valid, cached));
+
+  EXPECT_EQ(cache.getHits(), 3u);
+  EXPECT_EQ(cache.getMisses(), 4u);
+}
+
+TEST(PlanCacheTest, testInvalidPlanEvicted)
+{
+  nav2_planner::PlanCache cache(4, 0.5, 0.05, 0.1);
+  auto path = makeStraightPath(50);
+  auto goal = path.poses.back();
+  auto is_invalid = [](const nav_msgs::msg::Path &, unsigned int) {return false;};
+  auto is_valid = [](const nav_msgs::msg::Path &, unsigned int) {return true;};
+
+  nav_msgs::msg::Path cached;
+  cache.insert("GridBased", goal, 1, path);
+  EXPECT_FALSE(cache.lookup("GridBased", makePose(0.0, 0.0), goal, 2, is_invalid, cached));
+  EXPECT_FALSE(cache.lookup("GridBased", makePose(0.0, 0.0), goal, 2, is_valid, cached));
+}
+
+TEST(PlanCacheTest, testLeastRecentlyUsedEvicted)
+{
+  nav2_planner::PlanCache cache(2, 0.5, 0.05, 0.1);
+  auto is_valid = [](const nav_msgs::msg::Path &, unsigned int) {return true;};
+  auto path = makeStraightPath(10);
+  auto goal_a = makePose(0.9, 0.0), goal_b = makePose(0.9, 1.0), goal_c = makePose(0.9, 2.0);
+
+  nav_msgs::msg::Path cached;
+  cache.insert("GridBased", goal_a, 1, path);
+  cache.insert("GridBased", goal_b, 1, path);
+  EXPECT_TRUE(cache.lookup("GridBased", makePose(0.0, 0.0), goal_a, 1, is_valid, cached));
+  cache.insert("GridBased", goal_c, 1, path);
+
+  EXPECT_TRUE(cache.lookup("GridBased", makePose(0.0, 0.0), goal_a, 1, is_valid, cached));
+  EXPECT_FALSE(cache.lookup("GridBased", makePose(0.0, 0.0), goal_b, 1, is_valid, cached));
+  EXPECT_TRUE(cache.lookup("GridBased", makePose(0.0, 0.0), goal_c, 1, is_valid, cached));
+}
@@ -19,10 +19,13 @@
 #include <vector>
 #include <memory>
 #include <algorithm>
+#include <limits>
 #include <mutex>
+#include <vector>
 
 #include "rclcpp/rclcpp.hpp"
 #include "nav2_costmap_2d/costmap_2d_ros.hpp"
+#include "nav2_costmap_2d/costmap_queries.hpp"
 #include "nav2_costmap_2d/footprint_collision_checker.hpp"
 #include "nav2_util/odometry_utils.hpp"
 #include "geometry_msgs/msg/pose2_d.hpp"
@@ -90,6 +93,20 @@ public:
   double costAtPose(const double & x, const double & y);
 
 protected:
+  /**
+   * @brief Forward project a command from the robot, filling arc_ with the poses
+   * relative to the robot up to the carrot or the maximum projection time
+   */
+  void projectArc(
+    const double & linear_vel, const double & angular_vel,
+    const double & carrot_dist, const double & projection_time);
+
+  /**
+   * @brief Get the footprint checker of the latest costmap snapshot if enabled,
+   * its footprint cache shared with the other plugins using this costmap
+   */
+  void updateFootprintCache();
+
   rclcpp::Logger logger_ {rclcpp::get_logger("RPPCollisionChecker")};
   std::shared_ptr<nav2_costmap_2d::Costmap2DROS> costmap_ros_;
   nav2_costmap_2d::Costmap2D * costmap_;
@@ -98,6 +115,15 @@ protected:
   Parameters * params_;
   std::shared_ptr<rclcpp_lifecycle::LifecyclePublisher<nav_msgs::msg::Path>> carrot_arc_pub_;
   rclcpp::Clock::SharedPtr clock_;
+
+  // Projected poses relative to the robot, and the command they were projected for
+  std::vector<geometry_msgs::msg::Pose2D> arc_;
+  double arc_linear_vel_{std::numeric_limits<double>::quiet_NaN()};
+  double arc_angular_vel_{0.0}, arc_carrot_dist_{0.0};
+  double arc_projection_time_{0.0}, arc_max_time_{0.0};
+
+  // Checker with the footprint cached on the costmap snapshot, null if not cached
+  std::shared_ptr<const nav2_costmap_2d::CostmapQueries::Checker> cached_checker_;
 };
 
 }  // namespace nav2_regulated_pure_pursuit_controller
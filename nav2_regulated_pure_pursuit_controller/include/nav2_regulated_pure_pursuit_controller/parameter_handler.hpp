@@ -60,6 +60,7 @@ struct Parameters
   double max_robot_pose_search_dist;
   bool interpolate_curvature_after_goal;
   bool use_collision_detection;
+  int collision_footprint_headings;
   double transform_tolerance;
 };
 
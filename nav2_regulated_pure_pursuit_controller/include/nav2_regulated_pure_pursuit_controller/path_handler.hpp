@@ -77,9 +77,23 @@ public:
     const geometry_msgs::msg::PoseStamped & in_pose,
     geometry_msgs::msg::PoseStamped & out_pose) const;
 
-  void setPlan(const nav_msgs::msg::Path & path) {global_plan_ = path;}
+  /**
+   * @brief Set a new global plan
+   * @param path Global plan
+   */
+  void setPlan(const nav_msgs::msg::Path & path);
 
-  nav_msgs::msg::Path getPlan() {return global_plan_;}
+  /**
+   * @brief Set a new global plan, kept without a copy
+   * @param path Global plan, not modified while set
+   */
+  void setPlan(const std::shared_ptr<const nav_msgs::msg::Path> & path);
+
+  /**
+   * @brief Get the global plan, without the poses pruned by transformGlobalPlan()
+   * @return Global plan from the closest pose to the robot
+   */
+  nav_msgs::msg::Path getPlan() const;
 
 protected:
   /**
@@ -92,7 +106,11 @@ protected:
   tf2::Duration transform_tolerance_;
   std::shared_ptr<tf2_ros::Buffer> tf_;
   std::shared_ptr<nav2_costmap_2d::Costmap2DROS> costmap_ros_;
-  nav_msgs::msg::Path global_plan_;
+  // Shared with the controller server, so never modified in place
+  std::shared_ptr<const nav_msgs::msg::Path> global_plan_{
+    std::make_shared<const nav_msgs::msg::Path>()};
+  // Index of the first pose of global_plan_ not yet passed by the robot
+  size_t plan_start_{0};
 };
 
 }  // namespace nav2_regulated_pure_pursuit_controller
@@ -105,6 +105,12 @@ public:
    */
   void setPlan(const nav_msgs::msg::Path & path) override;
 
+  /**
+   * @brief nav2_core setSharedPlan - Sets the global plan, without a copy
+   * @param path The global plan
+   */
+  void setSharedPlan(const std::shared_ptr<const nav_msgs::msg::Path> & path) override;
+
   /**
    * @brief Limits the maximum linear speed of the robot.
    * @param speed_limit expressed in absolute value (in m/s)
@@ -53,6 +53,8 @@ bool CollisionChecker::isCollisionImminent(
   // Note(stevemacenski): This may be a bit unusual, but the robot_pose is in
   // odom frame and the carrot_pose is in robot base frame. Just how the data comes to us
 
+  updateFootprintCache();
+
   // check current point is OK
   if (inCollision(
       robot_pose.pose.position.x, robot_pose.pose.position.y,
@@ -85,11 +87,55 @@ bool CollisionChecker::isCollisionImminent(
     projection_time = costmap_->getResolution() / fabs(linear_vel);
   }
 
-  const geometry_msgs::msg::Point & robot_xy = robot_pose.pose.position;
+  // The arc relative to the robot only changes with the command
+  if (linear_vel != arc_linear_vel_ || angular_vel != arc_angular_vel_ ||
+    carrot_dist != arc_carrot_dist_ || projection_time != arc_projection_time_ ||
+    params_->max_allowed_time_to_collision_up_to_carrot != arc_max_time_)
+  {
+    arc_linear_vel_ = linear_vel;
+    arc_angular_vel_ = angular_vel;
+    arc_carrot_dist_ = carrot_dist;
+    arc_projection_time_ = projection_time;
+    arc_max_time_ = params_->max_allowed_time_to_collision_up_to_carrot;
+    projectArc(linear_vel, angular_vel, carrot_dist, projection_time);
+  }
+
+  const double robot_x = robot_pose.pose.position.x;
+  const double robot_y = robot_pose.pose.position.y;
+  const double robot_yaw = tf2::getYaw(robot_pose.pose.orientation);
+  const double cos_yaw = cos(robot_yaw);
+  const double sin_yaw = sin(robot_yaw);
+  geometry_msgs::msg::Pose2D curr_pose;
+  arc_pts_msg.poses.reserve(arc_.size());
+  for (const auto & arc_pose : arc_) {
+    curr_pose.x = robot_x + arc_pose.x * cos_yaw - arc_pose.y * sin_yaw;
+    curr_pose.y = robot_y + arc_pose.x * sin_yaw + arc_pose.y * cos_yaw;
+    curr_pose.theta = robot_yaw + arc_pose.theta;
+
+    // store it for visualization
+    pose_msg.pose.position.x = curr_pose.x;
+    pose_msg.pose.position.y = curr_pose.y;
+    pose_msg.pose.position.z = 0.01;
+    arc_pts_msg.poses.push_back(pose_msg);
+
+    // check for collision at the projected pose
+    if (inCollision(curr_pose.x, curr_pose.y, curr_pose.theta)) {
+      carrot_arc_pub_->publish(arc_pts_msg);
+      return true;
+    }
+  }
+
+  carrot_arc_pub_->publish(arc_pts_msg);
+
+  return false;
+}
+
+void CollisionChecker::projectArc(
+  const double & linear_vel, const double & angular_vel,
+  const double & carrot_dist, const double & projection_time)
+{
+  arc_.clear();
   geometry_msgs::msg::Pose2D curr_pose;
-  curr_pose.x = robot_pose.pose.position.x;
-  curr_pose.y = robot_pose.pose.position.y;
-  curr_pose.theta = tf2::getYaw(robot_pose.pose.orientation);
 
   // only forward simulate within time requested
   int i = 1;
@@ -102,26 +148,25 @@ bool CollisionChecker::isCollisionImminent(
     curr_pose.theta += projection_time * angular_vel;
 
     // check if past carrot pose, where no longer a thoughtfully valid command
-    if (hypot(curr_pose.x - robot_xy.x, curr_pose.y - robot_xy.y) > carrot_dist) {
+    if (hypot(curr_pose.x, curr_pose.y) > carrot_dist) {
       break;
     }
 
-    // store it for visualization
-    pose_msg.pose.position.x = curr_pose.x;
-    pose_msg.pose.position.y = curr_pose.y;
-    pose_msg.pose.position.z = 0.01;
-    arc_pts_msg.poses.push_back(pose_msg);
-
-    // check for collision at the projected pose
-    if (inCollision(curr_pose.x, curr_pose.y, curr_pose.theta)) {
-      carrot_arc_pub_->publish(arc_pts_msg);
-      return true;
-    }
+    arc_.push_back(curr_pose);
   }
+}
 
-  carrot_arc_pub_->publish(arc_pts_msg);
+void CollisionChecker::updateFootprintCache()
+{
+  const int headings = params_->collision_footprint_headings;
+  if (headings <= 0) {
+    cached_checker_.reset();
+    return;
+  }
 
-  return false;
+  // Rasterized again by the queries if the footprint or the costmap resolution changed
+  cached_checker_ = costmap_ros_->getCostmapQueries()->getFootprintChecker(
+    costmap_ros_->getRobotFootprint(), static_cast<unsigned int>(headings));
 }
 
 bool CollisionChecker::inCollision(
@@ -140,8 +185,13 @@ bool CollisionChecker::inCollision(
     return false;
   }
 
-  double footprint_cost = footprint_collision_checker_->footprintCostAtPose(
-    x, y, theta, costmap_ros_->getRobotFootprint());
+  double footprint_cost;
+  if (cached_checker_) {
+    footprint_cost = cached_checker_->footprintCostAtPoseCached(x, y, theta);
+  } else {
+    footprint_cost = footprint_collision_checker_->footprintCostAtPose(
+      x, y, theta, costmap_ros_->getRobotFootprint());
+  }
   if (footprint_cost == static_cast<double>(NO_INFORMATION) &&
     costmap_ros_->getLayeredCostmap()->isTrackingUnknown())
   {
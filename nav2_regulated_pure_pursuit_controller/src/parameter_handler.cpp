@@ -100,6 +100,9 @@ ParameterHandler::ParameterHandler(
   declare_parameter_if_not_declared(
     node, plugin_name_ + ".use_collision_detection",
     rclcpp::ParameterValue(true));
+  declare_parameter_if_not_declared(
+    node, plugin_name_ + ".collision_footprint_headings",
+    rclcpp::ParameterValue(0));
 
   node->get_parameter(plugin_name_ + ".desired_linear_vel", params_.desired_linear_vel);
   params_.base_desired_linear_vel = params_.desired_linear_vel;
@@ -180,6 +183,9 @@ ParameterHandler::ParameterHandler(
   node->get_parameter(
     plugin_name_ + ".use_collision_detection",
     params_.use_collision_detection);
+  node->get_parameter(
+    plugin_name_ + ".collision_footprint_headings",
+    params_.collision_footprint_headings);
 
   if (params_.inflation_cost_scaling_factor <= 0.0) {
     RCLCPP_WARN(
@@ -272,6 +278,10 @@ ParameterHandler::dynamicParametersCallback(
         }
         params_.allow_reversing = parameter.as_bool();
       }
+    } else if (type == ParameterType::PARAMETER_INTEGER) {
+      if (name == plugin_name_ + ".collision_footprint_headings") {
+        params_.collision_footprint_headings = parameter.as_int();
+      }
     }
   }
 
@@ -23,6 +23,7 @@
 #include "nav2_core/controller_exceptions.hpp"
 #include "nav2_util/node_utils.hpp"
 #include "nav2_util/geometry_utils.hpp"
+#include "tf2_geometry_msgs/tf2_geometry_msgs.hpp"
 
 namespace nav2_regulated_pure_pursuit_controller
 {
@@ -50,30 +51,33 @@ nav_msgs::msg::Path PathHandler::transformGlobalPlan(
   double max_robot_pose_search_dist,
   bool reject_unit_path)
 {
-  if (global_plan_.poses.empty()) {
+  // The poses already passed are skipped rather than erased, the plan being possibly long
+  const auto plan_begin = global_plan_->poses.begin() + plan_start_;
+  const auto plan_end = global_plan_->poses.end();
+  if (plan_begin == plan_end) {
     throw nav2_core::InvalidPath("Received plan with zero length");
   }
 
-  if (reject_unit_path && global_plan_.poses.size() == 1) {
+  if (reject_unit_path && std::next(plan_begin) == plan_end) {
     throw nav2_core::InvalidPath("Received plan with length of one");
   }
 
   // let's get the pose of the robot in the frame of the plan
   geometry_msgs::msg::PoseStamped robot_pose;
-  if (!transformPose(global_plan_.header.frame_id, pose, robot_pose)) {
+  if (!transformPose(global_plan_->header.frame_id, pose, robot_pose)) {
     throw nav2_core::ControllerTFError("Unable to transform robot pose into global plan's frame");
   }
 
   auto closest_pose_upper_bound =
     nav2_util::geometry_utils::first_after_integrated_distance(
-    global_plan_.poses.begin(), global_plan_.poses.end(), max_robot_pose_search_dist);
+    plan_begin, plan_end, max_robot_pose_search_dist);
 
   // First find the closest pose on the path to the robot
   // bounded by when the path turns around (if it does) so we don't get a pose from a later
   // portion of the path
   auto transformation_begin =
     nav2_util::geometry_utils::min_by(
-    global_plan_.poses.begin(), closest_pose_upper_bound,
+    plan_begin, closest_pose_upper_bound,
     [&robot_pose](const geometry_msgs::msg::PoseStamped & ps) {
       return euclidean_distance(robot_pose, ps);
     });
@@ -81,7 +85,7 @@ nav_msgs::msg::Path PathHandler::transformGlobalPlan(
   // Make sure we always have at least 2 points on the transformed plan and that we don't prune
   // the global plan below 2 points in order to have always enough point to interpolate the
   // end of path direction
-  if (global_plan_.poses.begin() != closest_pose_upper_bound && global_plan_.poses.size() > 1 &&
+  if (plan_begin != closest_pose_upper_bound && std::next(plan_begin) != plan_end &&
     transformation_begin == std::prev(closest_pose_upper_bound))
   {
     transformation_begin = std::prev(std::prev(closest_pose_upper_bound));
@@ -90,26 +94,40 @@ nav_msgs::msg::Path PathHandler::transformGlobalPlan(
   // We'll discard points on the plan that are outside the local costmap
   const double max_costmap_extent = getCostmapMaxExtent();
   auto transformation_end = std::find_if(
-    transformation_begin, global_plan_.poses.end(),
+    transformation_begin, plan_end,
     [&](const auto & global_plan_pose) {
       return euclidean_distance(global_plan_pose, robot_pose) > max_costmap_extent;
     });
 
+  // All the plan poses are transformed at the robot pose time, so look the transform up once
+  geometry_msgs::msg::TransformStamped plan_to_local;
+  const std::string & base_frame = costmap_ros_->getBaseFrameID();
+  if (global_plan_->header.frame_id == base_frame) {
+    plan_to_local.transform.rotation.w = 1.0;
+  } else {
+    try {
+      plan_to_local = tf_->lookupTransform(
+        base_frame, global_plan_->header.frame_id, tf2_ros::fromMsg(robot_pose.header.stamp),
+        transform_tolerance_);
+    } catch (tf2::TransformException & ex) {
+      RCLCPP_ERROR(logger_, "Exception in transformPose: %s", ex.what());
+      throw nav2_core::ControllerTFError("Unable to transform plan pose into local frame");
+    }
+  }
+
   // Lambda to transform a PoseStamped from global frame to local
   auto transformGlobalPoseToLocal = [&](const auto & global_plan_pose) {
-      geometry_msgs::msg::PoseStamped stamped_pose, transformed_pose;
-      stamped_pose.header.frame_id = global_plan_.header.frame_id;
-      stamped_pose.header.stamp = robot_pose.header.stamp;
-      stamped_pose.pose = global_plan_pose.pose;
-      if (!transformPose(costmap_ros_->getBaseFrameID(), stamped_pose, transformed_pose)) {
-        throw nav2_core::ControllerTFError("Unable to transform plan pose into local frame");
-      }
+      geometry_msgs::msg::PoseStamped transformed_pose;
+      tf2::doTransform(global_plan_pose.pose, transformed_pose.pose, plan_to_local);
+      transformed_pose.header.frame_id = base_frame;
+      transformed_pose.header.stamp = robot_pose.header.stamp;
       transformed_pose.pose.position.z = 0.0;
       return transformed_pose;
     };
 
   // Transform the near part of the global plan into the robot's frame of reference.
   nav_msgs::msg::Path transformed_plan;
+  transformed_plan.poses.reserve(std::distance(transformation_begin, transformation_end));
   std::transform(
     transformation_begin, transformation_end,
     std::back_inserter(transformed_plan.poses),
@@ -119,7 +137,7 @@ nav_msgs::msg::Path PathHandler::transformGlobalPlan(
 
   // Remove the portion of the global plan that we've already passed so we don't
   // process it on the next iteration (this is called path pruning)
-  global_plan_.poses.erase(begin(global_plan_.poses), transformation_begin);
+  plan_start_ = std::distance(global_plan_->poses.begin(), transformation_begin);
 
   if (transformed_plan.poses.empty()) {
     throw nav2_core::InvalidPath("Resulting plan has 0 poses in it.");
@@ -128,6 +146,25 @@ nav_msgs::msg::Path PathHandler::transformGlobalPlan(
   return transformed_plan;
 }
 
+void PathHandler::setPlan(const nav_msgs::msg::Path & path)
+{
+  setPlan(std::make_shared<const nav_msgs::msg::Path>(path));
+}
+
+void PathHandler::setPlan(const std::shared_ptr<const nav_msgs::msg::Path> & path)
+{
+  global_plan_ = path;
+  plan_start_ = 0;
+}
+
+nav_msgs::msg::Path PathHandler::getPlan() const
+{
+  nav_msgs::msg::Path plan;
+  plan.header = global_plan_->header;
+  plan.poses.assign(global_plan_->poses.begin() + plan_start_, global_plan_->poses.end());
+  return plan;
+}
+
 bool PathHandler::transformPose(
   const std::string frame,
   const geometry_msgs::msg::PoseStamped & in_pose,
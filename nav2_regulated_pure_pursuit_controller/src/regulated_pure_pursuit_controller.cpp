@@ -465,6 +465,12 @@ void RegulatedPurePursuitController::setPlan(const nav_msgs::msg::Path & path)
   path_handler_->setPlan(path);
 }
 
+void RegulatedPurePursuitController::setSharedPlan(
+  const std::shared_ptr<const nav_msgs::msg::Path> & path)
+{
+  path_handler_->setPlan(path);
+}
+
 void RegulatedPurePursuitController::setSpeedLimit(
   const double & speed_limit,
   const bool & percentage)
@@ -29,6 +29,7 @@
 #include "nav2_core/controller.hpp"
 #include "nav2_core/controller_exceptions.hpp"
 #include "nav2_util/node_utils.hpp"
+#include "nav2_costmap_2d/costmap_queries.hpp"
 #include "nav2_costmap_2d/footprint_collision_checker.hpp"
 #include "angles/angles.h"
 
@@ -97,6 +98,12 @@ public:
    */
   void setPlan(const nav_msgs::msg::Path & path) override;
 
+  /**
+   * @brief nav2_core setSharedPlan - Sets the global plan, shared with the primary controller
+   * @param path The global plan
+   */
+  void setSharedPlan(const std::shared_ptr<const nav_msgs::msg::Path> & path) override;
+
   /**
    * @brief Limits the maximum linear speed of the robot.
    * @param speed_limit expressed in absolute value (in m/s)
@@ -152,6 +159,26 @@ protected:
     const double & angular_distance_to_heading,
     const geometry_msgs::msg::PoseStamped & pose);
 
+  /**
+   * @brief Checks the footprint swept by a rotation in place, with the footprint
+   * cached for each heading on the costmap snapshot
+   * @param pose Pose of the robot
+   * @param start_yaw First yaw of the rotation
+   * @param end_yaw Last yaw of the rotation, in the direction of the rotation
+   * @param direction Sign of the angular velocity
+   * @param checker Checker with the footprint cached
+   */
+  void checkSweptFootprint(
+    const geometry_msgs::msg::PoseStamped & pose,
+    double start_yaw, double end_yaw, double direction,
+    const nav2_costmap_2d::CostmapQueries::Checker & checker);
+
+  /**
+   * @brief Throws if a footprint cost is in collision
+   * @param footprint_cost Cost of the footprint at a pose
+   */
+  void checkFootprintCost(double footprint_cost);
+
   /**
    * @brief Callback executed when a parameter change is detected
    * @param event ParameterEvent message
@@ -171,11 +198,13 @@ protected:
   pluginlib::ClassLoader<nav2_core::Controller> lp_loader_;
   nav2_core::Controller::Ptr primary_controller_;
   bool path_updated_;
-  nav_msgs::msg::Path current_path_;
+  // Shared with the primary controller, so never modified in place
+  std::shared_ptr<const nav_msgs::msg::Path> current_path_;
   double forward_sampling_distance_, angular_dist_threshold_;
   double rotate_to_heading_angular_vel_, max_angular_accel_;
   double control_duration_, simulate_ahead_time_;
   bool rotate_to_goal_heading_;
+  int collision_footprint_headings_;
 
   // Dynamic parameters handler
   std::mutex mutex_;
@@ -13,6 +13,7 @@
 // limitations under the License.
 
 #include <algorithm>
+#include <cmath>
 #include <string>
 #include <memory>
 #include <vector>
@@ -29,7 +30,8 @@ namespace nav2_rotation_shim_controller
 RotationShimController::RotationShimController()
 : lp_loader_("nav2_core", "nav2_core::Controller"),
   primary_controller_(nullptr),
-  path_updated_(false)
+  path_updated_(false),
+  current_path_(std::make_shared<const nav_msgs::msg::Path>())
 {
 }
 
@@ -63,6 +65,8 @@ void RotationShimController::configure(
     node, plugin_name_ + ".primary_controller", rclcpp::PARAMETER_STRING);
   nav2_util::declare_parameter_if_not_declared(
     node, plugin_name_ + ".rotate_to_goal_heading", rclcpp::ParameterValue(false));
+  nav2_util::declare_parameter_if_not_declared(
+    node, plugin_name_ + ".collision_footprint_headings", rclcpp::ParameterValue(0));
 
   node->get_parameter(plugin_name_ + ".angular_dist_threshold", angular_dist_threshold_);
   node->get_parameter(plugin_name_ + ".forward_sampling_distance", forward_sampling_distance_);
@@ -77,6 +81,8 @@ void RotationShimController::configure(
   control_duration_ = 1.0 / control_frequency;
 
   node->get_parameter(plugin_name_ + ".rotate_to_goal_heading", rotate_to_goal_heading_);
+  node->get_parameter(
+    plugin_name_ + ".collision_footprint_headings", collision_footprint_headings_);
 
   try {
     primary_controller_ = lp_loader_.createUniqueInstance(primary_controller);
@@ -216,35 +222,37 @@ geometry_msgs::msg::TwistStamped RotationShimController::computeVelocityCommands
 
 geometry_msgs::msg::PoseStamped RotationShimController::getSampledPathPt()
 {
-  if (current_path_.poses.size() < 2) {
+  const nav_msgs::msg::Path & path = *current_path_;
+  if (path.poses.size() < 2) {
     throw nav2_core::ControllerException(
             "Path is too short to find a valid sampled path point for rotation.");
   }
 
-  geometry_msgs::msg::Pose start = current_path_.poses.front().pose;
+  geometry_msgs::msg::Pose start = path.poses.front().pose;
   double dx, dy;
 
   // Find the first point at least sampling distance away
-  for (unsigned int i = 1; i != current_path_.poses.size(); i++) {
-    dx = current_path_.poses[i].pose.position.x - start.position.x;
-    dy = current_path_.poses[i].pose.position.y - start.position.y;
+  for (unsigned int i = 1; i != path.poses.size(); i++) {
+    dx = path.poses[i].pose.position.x - start.position.x;
+    dy = path.poses[i].pose.position.y - start.position.y;
     if (hypot(dx, dy) >= forward_sampling_distance_) {
-      current_path_.poses[i].header.frame_id = current_path_.header.frame_id;
-      current_path_.poses[i].header.stamp = clock_->now();  // Get current time transformation
-      return current_path_.poses[i];
+      geometry_msgs::msg::PoseStamped sampled_pt = path.poses[i];
+      sampled_pt.header.frame_id = path.header.frame_id;
+      sampled_pt.header.stamp = clock_->now();  // Get current time transformation
+      return sampled_pt;
     }
   }
 
-  return current_path_.poses.back();
+  return path.poses.back();
 }
 
 geometry_msgs::msg::PoseStamped RotationShimController::getSampledPathGoal()
 {
-  if (current_path_.poses.empty()) {
+  if (current_path_->poses.empty()) {
     throw nav2_core::InvalidPath("Path is empty - cannot find a goal point");
   }
 
-  auto goal = current_path_.poses.back();
+  auto goal = current_path_->poses.back();
   goal.header.stamp = clock_->now();
   return goal;
 }
@@ -292,6 +300,15 @@ void RotationShimController::isCollisionFree(
   double remaining_rotation_before_thresh =
     fabs(angular_distance_to_heading) - angular_dist_threshold_;
 
+  // With the footprint cached per heading, the simulated yaws only bound the swept footprint
+  std::shared_ptr<const nav2_costmap_2d::CostmapQueries::Checker> checker;
+  if (collision_footprint_headings_ > 0) {
+    checker = costmap_ros_->getCostmapQueries()->getFootprintChecker(
+      costmap_ros_->getRobotFootprint(), static_cast<unsigned int>(collision_footprint_headings_));
+  }
+  double first_yaw = 0.0, last_yaw = 0.0;
+  bool swept = false;
+
   while (simulated_time < simulate_ahead_time_) {
     simulated_time += control_duration_;
     yaw = initial_yaw + cmd_vel.twist.angular.z * simulated_time;
@@ -301,29 +318,73 @@ void RotationShimController::isCollisionFree(
       break;
     }
 
-    using namespace nav2_costmap_2d;  // NOLINT
+    if (checker) {
+      if (!swept) {
+        first_yaw = yaw;
+        swept = true;
+      }
+      last_yaw = yaw;
+      continue;
+    }
+
     footprint_cost = collision_checker_->footprintCostAtPose(
       pose.pose.position.x, pose.pose.position.y,
       yaw, costmap_ros_->getRobotFootprint());
+    checkFootprintCost(footprint_cost);
+  }
 
-    if (footprint_cost == static_cast<double>(NO_INFORMATION) &&
-      costmap_ros_->getLayeredCostmap()->isTrackingUnknown())
-    {
-      throw nav2_core::NoValidControl(
-              "RotationShimController detected a potential collision ahead!");
-    }
+  if (swept) {
+    checkSweptFootprint(
+      pose, first_yaw, last_yaw, cmd_vel.twist.angular.z >= 0.0 ? 1.0 : -1.0, *checker);
+  }
+}
 
-    if (footprint_cost >= static_cast<double>(LETHAL_OBSTACLE)) {
-      throw nav2_core::NoValidControl("RotationShimController detected collision ahead!");
-    }
+void RotationShimController::checkSweptFootprint(
+  const geometry_msgs::msg::PoseStamped & pose,
+  double start_yaw, double end_yaw, double direction,
+  const nav2_costmap_2d::CostmapQueries::Checker & checker)
+{
+  // Every heading bin between the first and last yaw is checked once, so that the
+  // whole sweep is covered rather than the yaws at the control period only
+  const double bin_size = 2.0 * M_PI / collision_footprint_headings_;
+  const int steps = std::min(
+    static_cast<int>(std::ceil(std::abs(end_yaw - start_yaw) / bin_size)),
+    collision_footprint_headings_);
+  for (int i = 0; i < steps; i++) {
+    checkFootprintCost(
+      checker.footprintCostAtPoseCached(
+        pose.pose.position.x, pose.pose.position.y, start_yaw + direction * i * bin_size));
+  }
+  checkFootprintCost(
+    checker.footprintCostAtPoseCached(pose.pose.position.x, pose.pose.position.y, end_yaw));
+}
+
+void RotationShimController::checkFootprintCost(double footprint_cost)
+{
+  using namespace nav2_costmap_2d;  // NOLINT
+  if (footprint_cost == static_cast<double>(NO_INFORMATION) &&
+    costmap_ros_->getLayeredCostmap()->isTrackingUnknown())
+  {
+    throw nav2_core::NoValidControl(
+            "RotationShimController detected a potential collision ahead!");
+  }
+
+  if (footprint_cost >= static_cast<double>(LETHAL_OBSTACLE)) {
+    throw nav2_core::NoValidControl("RotationShimController detected collision ahead!");
   }
 }
 
 void RotationShimController::setPlan(const nav_msgs::msg::Path & path)
+{
+  setSharedPlan(std::make_shared<const nav_msgs::msg::Path>(path));
+}
+
+void RotationShimController::setSharedPlan(
+  const std::shared_ptr<const nav_msgs::msg::Path> & path)
 {
   path_updated_ = true;
   current_path_ = path;
-  primary_controller_->setPlan(path);
+  primary_controller_->setSharedPlan(path);
 }
 
 void RotationShimController::setSpeedLimit(const double & speed_limit, const bool & percentage)
@@ -357,6 +418,10 @@ RotationShimController::dynamicParametersCallback(std::vector<rclcpp::Parameter>
       if (name == plugin_name_ + ".rotate_to_goal_heading") {
         rotate_to_goal_heading_ = parameter.as_bool();
       }
+    } else if (type == ParameterType::PARAMETER_INTEGER) {
+      if (name == plugin_name_ + ".collision_footprint_headings") {
+        collision_footprint_headings_ = parameter.as_int();
+      }
     }
   }
 
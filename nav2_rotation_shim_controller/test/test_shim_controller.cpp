@@ -49,7 +49,7 @@ public:
 
   nav_msgs::msg::Path getPath()
   {
-    return current_path_;
+    return *current_path_;
   }
 
   bool isPathUpdated()
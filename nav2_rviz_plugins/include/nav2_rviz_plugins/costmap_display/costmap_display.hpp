@@ -0,0 +1,114 @@
+// Copyright (c) 2024 Open Navigation LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef NAV2_RVIZ_PLUGINS__COSTMAP_DISPLAY__COSTMAP_DISPLAY_HPP_
+#define NAV2_RVIZ_PLUGINS__COSTMAP_DISPLAY__COSTMAP_DISPLAY_HPP_
+
+#include <cstdint>
+#include <vector>
+
+#include <OgreMaterial.h>
+#include <OgreTexture.h>
+
+#include "nav2_msgs/msg/costmap.hpp"
+#include "nav2_msgs/msg/costmap_update.hpp"
+#include "nav2_msgs/msg/costmap_compressed_update.hpp"
+
+#include "rviz_common/message_filter_display.hpp"
+
+namespace Ogre
+{
+class ManualObject;
+}  // namespace Ogre
+
+namespace rviz_common
+{
+namespace properties
+{
+class BoolProperty;
+class FloatProperty;
+}  // namespace properties
+}  // namespace rviz_common
+
+namespace nav2_rviz_plugins
+{
+
+/**
+ * @brief Displays a nav2_msgs/Costmap with its raw costs, keeping the costs in a texture
+ * colored by a palette on the GPU. The <topic>_updates patches, or the deltas of the
+ * <topic>_compressed_updates stream, are uploaded to the region of the texture they cover
+ * instead of the whole costmap.
+ */
+class CostmapDisplay : public rviz_common::MessageFilterDisplay<nav2_msgs::msg::Costmap>
+{
+  Q_OBJECT
+
+public:
+  CostmapDisplay();
+  ~CostmapDisplay() override;
+
+  void processMessage(nav2_msgs::msg::Costmap::ConstSharedPtr msg) override;
+  void update(float wall_dt, float ros_dt) override;
+
+protected:
+  void onInitialize() override;
+  void reset() override;
+  void subscribe() override;
+  void unsubscribe() override;
+
+private Q_SLOTS:
+  /// Update the transparency of the costmap
+  void updateAlpha();
+
+  /// Switch between the full costmaps with their patches and the compressed stream
+  void updateCompressedUpdates();
+
+private:
+  void processUpdate(nav2_msgs::msg::CostmapUpdate::ConstSharedPtr update);
+  void processCompressedUpdate(nav2_msgs::msg::CostmapCompressedUpdate::ConstSharedPtr update);
+  bool decodeCompressedPatch(
+    const nav2_msgs::msg::CostmapCompressedUpdate & update, unsigned char * data);
+
+  /// Resize the texture and quad to the costmap, if it changed
+  void setGeometry(const nav2_msgs::msg::CostmapMetaData & metadata);
+  /// Upload a region of the costs to the texture
+  void uploadRegion(uint32_t x, uint32_t y, uint32_t size_x, uint32_t size_y);
+  void clear();
+
+  Ogre::ManualObject * manual_object_{nullptr};
+  Ogre::SceneNode * costmap_node_{nullptr};
+  Ogre::MaterialPtr material_;
+  Ogre::TexturePtr texture_;
+  Ogre::TexturePtr palette_texture_;
+
+  rclcpp::Subscription<nav2_msgs::msg::CostmapUpdate>::SharedPtr update_sub_;
+  rclcpp::Subscription<nav2_msgs::msg::CostmapCompressedUpdate>::SharedPtr
+    compressed_update_sub_;
+
+  // Costs shown, the deltas of the compressed stream applying on top of them
+  std::vector<unsigned char> costs_;
+  nav2_msgs::msg::CostmapMetaData metadata_;
+  std_msgs::msg::Header header_;
+  bool loaded_{false};
+  bool compressed_synced_{false};
+  uint64_t last_sequence_{0};
+  std::vector<unsigned char> compressed_patch_;
+
+  rviz_common::properties::FloatProperty * alpha_property_;
+  rviz_common::properties::BoolProperty * compressed_updates_property_;
+};
+
+}  // namespace nav2_rviz_plugins
+
+#endif  // NAV2_RVIZ_PLUGINS__COSTMAP_DISPLAY__COSTMAP_DISPLAY_HPP_
@@ -21,6 +21,7 @@
 
 #include <memory>
 #include <string>
+#include <thread>
 #include <vector>
 
 #include "nav2_lifecycle_manager/lifecycle_manager_client.hpp"
@@ -60,8 +61,19 @@ public:
   void load(const rviz_common::Config & config) override;
   void save(rviz_common::Config config) const override;
 
+Q_SIGNALS:
+  // Posted from the feedback executor thread when the action feedback or status changed
+  void navigationFeedbackChanged(QString label);
+  void navThroughPosesFeedbackChanged(QString label);
+  void navigationGoalStatusChanged(int status);
+  void navThroughPosesGoalStatusChanged(int status);
+
 private Q_SLOTS:
   void startThread();
+  void onNavigationFeedback(QString label);
+  void onNavThroughPosesFeedback(QString label);
+  void onNavigationGoalStatus(int status);
+  void onNavThroughPosesGoalStatus(int status);
   void onStartup();
   void onShutdown();
   void onCancel();
@@ -122,6 +134,17 @@ private:
   rclcpp_action::Client<nav2_msgs::action::NavigateThroughPoses>::SharedPtr
     nav_through_poses_action_client_;
 
+  // Node of the action feedback and status subscribers, spun by its own executor thread
+  // so that feedback bursts are processed away from the GUI thread
+  rclcpp::Node::SharedPtr feedback_node_;
+  rclcpp::executors::SingleThreadedExecutor::SharedPtr feedback_executor_;
+  std::thread feedback_thread_;
+  // Last feedback labels and goal statuses posted to the GUI, used on the feedback thread only
+  QString last_navigation_feedback_;
+  QString last_nav_through_poses_feedback_;
+  int last_navigation_goal_status_{-1};
+  int last_nav_through_poses_goal_status_{-1};
+
   // Navigation action feedback subscribers
   rclcpp::Subscription<nav2_msgs::action::NavigateToPose::Impl::FeedbackMessage>::SharedPtr
     navigation_feedback_sub_;
@@ -195,6 +218,9 @@ private:
 
   std::vector<geometry_msgs::msg::PoseStamped> acummulated_poses_;
   std::vector<geometry_msgs::msg::PoseStamped> store_poses_;
+  // Waypoints of the markers last published
+  std::vector<geometry_msgs::msg::PoseStamped> published_wp_poses_;
+  bool wp_markers_published_{false};
 
   // Publish the visual markers with the waypoints
   void updateWpNavigationMarkers();
@@ -66,6 +66,7 @@ namespace properties
 class EnumProperty;
 class ColorProperty;
 class FloatProperty;
+class IntProperty;
 }  // namespace properties
 }  // namespace rviz_common
 
@@ -144,6 +145,7 @@ private:
 
   rviz_common::properties::FloatProperty * arrow_min_length_property_;
   rviz_common::properties::FloatProperty * arrow_max_length_property_;
+  rviz_common::properties::IntProperty * max_particles_property_;
 
   float min_length_;
   float max_length_;
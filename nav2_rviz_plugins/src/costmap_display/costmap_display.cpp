@@ -0,0 +1,420 @@
+// Copyright (c) 2024 Open Navigation LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "nav2_rviz_plugins/costmap_display/costmap_display.hpp"
+
+#include <algorithm>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <OgreDataStream.h>
+#include <OgreHardwarePixelBuffer.h>
+#include <OgreManualObject.h>
+#include <OgreMaterialManager.h>
+#include <OgreSceneManager.h>
+#include <OgreSceneNode.h>
+#include <OgreTechnique.h>
+#include <OgreTextureManager.h>
+
+#include "rviz_common/display_context.hpp"
+#include "rviz_common/frame_manager_iface.hpp"
+#include "rviz_common/properties/bool_property.hpp"
+#include "rviz_common/properties/float_property.hpp"
+#include "rviz_common/properties/ros_topic_property.hpp"
+
+#include "nav2_costmap_2d/costmap_update_codec.hpp"
+
+namespace nav2_rviz_plugins
+{
+namespace
+{
+// Custom parameter of the rviz/Indexed8BitImage shader holding the alpha
+constexpr int ALPHA_PARAMETER = 0;
+
+// Colors of the raw costs: free transparent, costs from blue to red, inscribed in cyan,
+// lethal in purple and unknown in gray
+std::vector<unsigned char> makeCostPalette()
+{
+  std::vector<unsigned char> palette(256 * 4, 0);
+  for (int cost = 1; cost <= 252; ++cost) {
+    const unsigned char v = static_cast<unsigned char>((255 * cost) / 252);
+    palette[cost * 4] = v;
+    palette[cost * 4 + 1] = 0;
+    palette[cost * 4 + 2] = 255 - v;
+    palette[cost * 4 + 3] = 255;
+  }
+  const unsigned char special[3][4] = {
+    {0, 255, 255, 255}, {255, 0, 255, 255}, {0x70, 0x89, 0x86, 255}};
+  std::copy(&special[0][0], &special[0][0] + 12, &palette[253 * 4]);
+  return palette;
+}
+
+Ogre::TextureUnitState * getTextureUnit(Ogre::Pass * pass, unsigned int index)
+{
+  while (pass->getNumTextureUnitStates() <= index) {
+    pass->createTextureUnitState();
+  }
+  Ogre::TextureUnitState * unit = pass->getTextureUnitState(index);
+  unit->setTextureFiltering(Ogre::TFO_NONE);
+  unit->setTextureAddressingMode(Ogre::TextureUnitState::TAM_CLAMP);
+  return unit;
+}
+
+}  // namespace
+
+CostmapDisplay::CostmapDisplay()
+{
+  alpha_property_ = new rviz_common::properties::FloatProperty(
+    "Alpha", 0.7f, "Amount of transparency to apply to the costmap.",
+    this, SLOT(updateAlpha()));
+  alpha_property_->setMin(0);
+  alpha_property_->setMax(1);
+
+  compressed_updates_property_ = new rviz_common::properties::BoolProperty(
+    "Compressed Updates", false,
+    "Rebuild the costmap from the <topic>_compressed_updates stream, instead of the full "
+    "costmaps and their <topic>_updates patches.",
+    this, SLOT(updateCompressedUpdates()));
+}
+
+CostmapDisplay::~CostmapDisplay()
+{
+  unsubscribe();
+  if (manual_object_) {
+    scene_manager_->destroyManualObject(manual_object_);
+  }
+  if (texture_) {
+    Ogre::TextureManager::getSingleton().remove(texture_);
+  }
+  if (palette_texture_) {
+    Ogre::TextureManager::getSingleton().remove(palette_texture_);
+  }
+  if (material_) {
+    Ogre::MaterialManager::getSingleton().remove(material_);
+  }
+}
+
+void CostmapDisplay::onInitialize()
+{
+  MFDClass::onInitialize();
+
+  static int costmap_count = 0;
+  const std::string name = "Nav2Costmap" + std::to_string(costmap_count++);
+
+  material_ = Ogre::MaterialManager::getSingleton().getByName("rviz/Indexed8BitImage");
+  material_ = material_->clone(name + "Material");
+  material_->setReceiveShadows(false);
+  material_->getTechnique(0)->setLightingEnabled(false);
+  material_->setDepthBias(-16.0f, 0.0f);
+  material_->setCullingMode(Ogre::CULL_NONE);
+
+  std::vector<unsigned char> palette = makeCostPalette();
+  Ogre::DataStreamPtr palette_stream(
+    new Ogre::MemoryDataStream(palette.data(), palette.size()));
+  palette_texture_ = Ogre::TextureManager::getSingleton().loadRawData(
+    name + "Palette", "rviz_rendering", palette_stream, 256, 1,
+    Ogre::PF_BYTE_RGBA, Ogre::TEX_TYPE_1D, 0);
+  getTextureUnit(material_->getTechnique(0)->getPass(0), 1)->setTexture(palette_texture_);
+
+  // A unit quad, scaled to the size of the costmap
+  manual_object_ = scene_manager_->createManualObject(name + "Object");
+  manual_object_->begin(
+    material_->getName(), Ogre::RenderOperation::OT_TRIANGLE_LIST, "rviz_rendering");
+  const float corners[6][2] = {{0, 0}, {1, 1}, {0, 1}, {0, 0}, {1, 0}, {1, 1}};
+  for (const auto & corner : corners) {
+    manual_object_->position(corner[0], corner[1], 0.0f);
+    manual_object_->textureCoord(corner[0], corner[1]);
+    manual_object_->normal(0.0f, 0.0f, 1.0f);
+  }
+  manual_object_->end();
+  manual_object_->setVisible(false);
+
+  costmap_node_ = scene_node_->createChildSceneNode();
+  costmap_node_->attachObject(manual_object_);
+
+  updateAlpha();
+}
+
+void CostmapDisplay::subscribe()
+{
+  if (!isEnabled()) {
+    return;
+  }
+
+  const std::string topic = topic_property_->getTopicStd();
+  if (topic.empty()) {
+    return;
+  }
+
+  auto node = rviz_ros_node_.lock()->get_raw_node();
+  const auto update_qos =
+    rclcpp::QoS(rclcpp::KeepLast(10)).transient_local().reliable();
+  try {
+    if (compressed_updates_property_->getBool()) {
+      // The stream holds keyframes, the full costmaps are not needed
+      compressed_update_sub_ =
+        node->create_subscription<nav2_msgs::msg::CostmapCompressedUpdate>(
+        topic + "_compressed_updates", update_qos,
+        [this](nav2_msgs::msg::CostmapCompressedUpdate::ConstSharedPtr update) {
+          processCompressedUpdate(update);
+        });
+    } else {
+      MFDClass::subscribe();
+      update_sub_ = node->create_subscription<nav2_msgs::msg::CostmapUpdate>(
+        topic + "_updates", update_qos,
+        [this](nav2_msgs::msg::CostmapUpdate::ConstSharedPtr update) {
+          processUpdate(update);
+        });
+    }
+    setStatus(rviz_common::properties::StatusProperty::Ok, "Update Topic", "OK");
+  } catch (const rclcpp::exceptions::InvalidTopicNameError & e) {
+    setStatus(
+      rviz_common::properties::StatusProperty::Error, "Update Topic",
+      QString("Error subscribing: ") + e.what());
+  }
+}
+
+void CostmapDisplay::unsubscribe()
+{
+  MFDClass::unsubscribe();
+  update_sub_.reset();
+  compressed_update_sub_.reset();
+  compressed_synced_ = false;
+}
+
+void CostmapDisplay::reset()
+{
+  MFDClass::reset();
+  clear();
+}
+
+void CostmapDisplay::clear()
+{
+  loaded_ = false;
+  compressed_synced_ = false;
+  costs_.clear();
+  if (manual_object_) {
+    manual_object_->setVisible(false);
+  }
+}
+
+void CostmapDisplay::processMessage(nav2_msgs::msg::Costmap::ConstSharedPtr msg)
+{
+  const size_t size = static_cast<size_t>(msg->metadata.size_x) * msg->metadata.size_y;
+  if (msg->data.size() != size) {
+    setStatus(
+      rviz_common::properties::StatusProperty::Error, "Costmap",
+      "Costmap data does not match its size");
+    return;
+  }
+
+  header_ = msg->header;
+  setGeometry(msg->metadata);
+  costs_.assign(msg->data.begin(), msg->data.end());
+  uploadRegion(0, 0, msg->metadata.size_x, msg->metadata.size_y);
+  setStatus(rviz_common::properties::StatusProperty::Ok, "Costmap", "Costmap received");
+}
+
+void CostmapDisplay::processUpdate(nav2_msgs::msg::CostmapUpdate::ConstSharedPtr update)
+{
+  if (!loaded_) {
+    return;
+  }
+
+  if (update->x + update->size_x > metadata_.size_x ||
+    update->y + update->size_y > metadata_.size_y ||
+    update->data.size() != static_cast<size_t>(update->size_x) * update->size_y)
+  {
+    setStatus(
+      rviz_common::properties::StatusProperty::Warn, "Update",
+      "Update area outside of the costmap area");
+    return;
+  }
+
+  for (size_t y = 0; y < update->size_y; ++y) {
+    std::copy_n(
+      update->data.begin() + y * update->size_x, update->size_x,
+      costs_.begin() + (y + update->y) * metadata_.size_x + update->x);
+  }
+  uploadRegion(update->x, update->y, update->size_x, update->size_y);
+  setStatus(rviz_common::properties::StatusProperty::Ok, "Update", "Update received");
+}
+
+void CostmapDisplay::processCompressedUpdate(
+  nav2_msgs::msg::CostmapCompressedUpdate::ConstSharedPtr update)
+{
+  if (update->keyframe) {
+    header_ = update->header;
+    setGeometry(update->metadata);
+    costs_.resize(static_cast<size_t>(update->metadata.size_x) * update->metadata.size_y);
+    compressed_synced_ = update->x == 0 && update->y == 0 &&
+      update->size_x == update->metadata.size_x && update->size_y == update->metadata.size_y &&
+      decodeCompressedPatch(*update, costs_.data());
+    last_sequence_ = update->sequence;
+    if (compressed_synced_) {
+      uploadRegion(0, 0, update->size_x, update->size_y);
+    }
+    return;
+  }
+
+  if (!compressed_synced_ || update->sequence != last_sequence_ + 1) {
+    // A delta on top of an unknown state would corrupt the costmap, wait for a keyframe
+    compressed_synced_ = false;
+    setStatus(
+      rviz_common::properties::StatusProperty::Warn, "Update",
+      "Missed a compressed update, waiting for the next keyframe");
+    return;
+  }
+  last_sequence_ = update->sequence;
+
+  if (update->x + update->size_x > metadata_.size_x ||
+    update->y + update->size_y > metadata_.size_y)
+  {
+    compressed_synced_ = false;
+    return;
+  }
+
+  compressed_patch_.resize(static_cast<size_t>(update->size_x) * update->size_y);
+  if (!decodeCompressedPatch(*update, compressed_patch_.data())) {
+    compressed_synced_ = false;
+    return;
+  }
+
+  size_t i = 0;
+  for (size_t y = 0; y < update->size_y; ++y) {
+    unsigned char * row = costs_.data() + (y + update->y) * metadata_.size_x + update->x;
+    for (size_t x = 0; x < update->size_x; ++x) {
+      row[x] ^= compressed_patch_[i++];
+    }
+  }
+  uploadRegion(update->x, update->y, update->size_x, update->size_y);
+  setStatus(rviz_common::properties::StatusProperty::Ok, "Update", "Update received");
+}
+
+bool CostmapDisplay::decodeCompressedPatch(
+  const nav2_msgs::msg::CostmapCompressedUpdate & update, unsigned char * data)
+{
+  const size_t size = static_cast<size_t>(update.size_x) * update.size_y;
+  bool valid = false;
+  if (update.encoding == nav2_msgs::msg::CostmapCompressedUpdate::ENCODING_RLE) {
+    valid = nav2_costmap_2d::decodeRunLength(update.data, data, size);
+  } else if (update.encoding == nav2_msgs::msg::CostmapCompressedUpdate::ENCODING_RAW) {
+    valid = update.data.size() == size;
+    if (valid) {
+      std::copy(update.data.begin(), update.data.end(), data);
+    }
+  }
+
+  if (!valid) {
+    setStatus(
+      rviz_common::properties::StatusProperty::Warn, "Update",
+      "Received a malformed compressed update, ignoring it");
+  }
+  return valid;
+}
+
+void CostmapDisplay::setGeometry(const nav2_msgs::msg::CostmapMetaData & metadata)
+{
+  const bool resized = !texture_ ||
+    metadata.size_x != metadata_.size_x || metadata.size_y != metadata_.size_y;
+  metadata_ = metadata;
+  if (metadata.size_x == 0 || metadata.size_y == 0) {
+    clear();
+    return;
+  }
+
+  // The texture is only reallocated when the size changes, updates are uploaded into it
+  if (resized) {
+    if (texture_) {
+      Ogre::TextureManager::getSingleton().remove(texture_);
+    }
+    static int texture_count = 0;
+    texture_ = Ogre::TextureManager::getSingleton().createManual(
+      "Nav2CostmapTexture" + std::to_string(texture_count++), "rviz_rendering",
+      Ogre::TEX_TYPE_2D, metadata.size_x, metadata.size_y, 0, Ogre::PF_L8, Ogre::TU_DEFAULT);
+    getTextureUnit(material_->getTechnique(0)->getPass(0), 0)->setTexture(texture_);
+  }
+
+  costmap_node_->setScale(
+    metadata.size_x * metadata.resolution, metadata.size_y * metadata.resolution, 1.0f);
+  manual_object_->setVisible(true);
+  loaded_ = true;
+}
+
+void CostmapDisplay::uploadRegion(uint32_t x, uint32_t y, uint32_t size_x, uint32_t size_y)
+{
+  if (!texture_ || size_x == 0 || size_y == 0) {
+    return;
+  }
+
+  const Ogre::PixelBox costs(metadata_.size_x, metadata_.size_y, 1, Ogre::PF_L8, costs_.data());
+  const Ogre::Box region(x, y, x + size_x, y + size_y);
+  texture_->getBuffer()->blitFromMemory(costs.getSubVolume(region), region);
+  context_->queueRender();
+}
+
+void CostmapDisplay::update(float /*wall_dt*/, float /*ros_dt*/)
+{
+  if (!loaded_) {
+    return;
+  }
+
+  // Place the costmap at its origin, in the latest transform of its frame
+  Ogre::Vector3 position;
+  Ogre::Quaternion orientation;
+  if (!context_->getFrameManager()->transform(
+      header_.frame_id, rclcpp::Time(0, 0, context_->getClock()->get_clock_type()),
+      metadata_.origin, position, orientation))
+  {
+    setMissingTransformToFixedFrame(header_.frame_id);
+    scene_node_->setVisible(false);
+    return;
+  }
+  setTransformOk();
+  scene_node_->setVisible(true);
+  scene_node_->setPosition(position);
+  scene_node_->setOrientation(orientation);
+}
+
+void CostmapDisplay::updateAlpha()
+{
+  const float alpha = alpha_property_->getFloat();
+  Ogre::Technique * technique = material_ ? material_->getTechnique(0) : nullptr;
+  if (!technique) {
+    return;
+  }
+
+  // Free cells are transparent whatever the alpha
+  technique->setSceneBlending(Ogre::SBT_TRANSPARENT_ALPHA);
+  technique->setDepthWriteEnabled(false);
+  if (manual_object_ && manual_object_->getNumSections() > 0) {
+    manual_object_->getSection(0)->setCustomParameter(
+      ALPHA_PARAMETER, Ogre::Vector4(alpha, alpha, alpha, alpha));
+  }
+  context_->queueRender();
+}
+
+void CostmapDisplay::updateCompressedUpdates()
+{
+  unsubscribe();
+  clear();
+  subscribe();
+}
+
+}  // namespace nav2_rviz_plugins
+
+#include <pluginlib/class_list_macros.hpp>  // NOLINT
+PLUGINLIB_EXPORT_CLASS(nav2_rviz_plugins::CostmapDisplay, rviz_common::Display)
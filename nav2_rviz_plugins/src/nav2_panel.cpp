@@ -599,6 +599,12 @@ Nav2Panel::Nav2Panel(QWidget * parent)
 
 Nav2Panel::~Nav2Panel()
 {
+  if (feedback_executor_) {
+    feedback_executor_->cancel();
+  }
+  if (feedback_thread_.joinable()) {
+    feedback_thread_.join();
+  }
 }
 
 void Nav2Panel::initialStateHandler()
@@ -781,70 +787,137 @@ Nav2Panel::onInitialize()
   node->declare_parameter("base_frame", rclcpp::ParameterValue(std::string("base_footprint")));
   node->get_parameter("base_frame", base_frame_);
 
-  // create action feedback subscribers
+  // create action feedback and status subscribers, only posting the changes to the GUI thread
+  QObject::connect(
+    this, &Nav2Panel::navigationFeedbackChanged,
+    this, &Nav2Panel::onNavigationFeedback, Qt::QueuedConnection);
+  QObject::connect(
+    this, &Nav2Panel::navThroughPosesFeedbackChanged,
+    this, &Nav2Panel::onNavThroughPosesFeedback, Qt::QueuedConnection);
+  QObject::connect(
+    this, &Nav2Panel::navigationGoalStatusChanged,
+    this, &Nav2Panel::onNavigationGoalStatus, Qt::QueuedConnection);
+  QObject::connect(
+    this, &Nav2Panel::navThroughPosesGoalStatusChanged,
+    this, &Nav2Panel::onNavThroughPosesGoalStatus, Qt::QueuedConnection);
+
+  auto options = rclcpp::NodeOptions().arguments(
+    {"--ros-args", "--remap", "__node:=rviz_navigation_dialog_feedback", "--"});
+  feedback_node_ = std::make_shared<rclcpp::Node>("_", options);
+
   navigation_feedback_sub_ =
-    node->create_subscription<nav2_msgs::action::NavigateToPose::Impl::FeedbackMessage>(
+    feedback_node_->create_subscription<nav2_msgs::action::NavigateToPose::Impl::FeedbackMessage>(
     "navigate_to_pose/_action/feedback",
     rclcpp::SystemDefaultsQoS(),
     [this](const nav2_msgs::action::NavigateToPose::Impl::FeedbackMessage::SharedPtr msg) {
-      if (stoi(nr_of_loops_->displayText().toStdString()) > 0) {
-        if (goal_index_ == 0 && !loop_counter_stop_) {
-          loop_count_++;
-          loop_counter_stop_ = true;
-        }
-        if (goal_index_ != 0) {
-          loop_counter_stop_ = false;
-        }
-        navigation_feedback_indicator_->setText(
-          getNavToPoseFeedbackLabel(msg->feedback) + QString(
-            std::string(
-              "</td></tr><tr><td width=150>Waypoint:</td><td>" +
-              toString(goal_index_ + 1)).c_str()) + QString(
-            std::string(
-              "</td></tr><tr><td width=150>Loop:</td><td>" +
-              toString(loop_count_)).c_str()));
-      } else {
-        navigation_feedback_indicator_->setText(getNavToPoseFeedbackLabel(msg->feedback));
+      QString label = getNavToPoseFeedbackLabel(msg->feedback);
+      if (label != last_navigation_feedback_) {
+        last_navigation_feedback_ = label;
+        emit navigationFeedbackChanged(label);
       }
     });
   nav_through_poses_feedback_sub_ =
-    node->create_subscription<nav2_msgs::action::NavigateThroughPoses::Impl::FeedbackMessage>(
+    feedback_node_->create_subscription<
+    nav2_msgs::action::NavigateThroughPoses::Impl::FeedbackMessage>(
     "navigate_through_poses/_action/feedback",
     rclcpp::SystemDefaultsQoS(),
     [this](const nav2_msgs::action::NavigateThroughPoses::Impl::FeedbackMessage::SharedPtr msg) {
-      navigation_feedback_indicator_->setText(getNavThroughPosesFeedbackLabel(msg->feedback));
+      QString label = getNavThroughPosesFeedbackLabel(msg->feedback);
+      if (label != last_nav_through_poses_feedback_) {
+        last_nav_through_poses_feedback_ = label;
+        emit navThroughPosesFeedbackChanged(label);
+      }
     });
 
-  // create action goal status subscribers
-  navigation_goal_status_sub_ = node->create_subscription<action_msgs::msg::GoalStatusArray>(
+  navigation_goal_status_sub_ =
+    feedback_node_->create_subscription<action_msgs::msg::GoalStatusArray>(
     "navigate_to_pose/_action/status",
     rclcpp::SystemDefaultsQoS(),
     [this](const action_msgs::msg::GoalStatusArray::SharedPtr msg) {
-      navigation_goal_status_indicator_->setText(
-        getGoalStatusLabel(msg->status_list.back().status));
-      // Clearing all the stored values once reaching the final goal
-      if (
-        loop_count_ == stoi(nr_of_loops_->displayText().toStdString()) &&
-        goal_index_ == static_cast<int>(store_poses_.size()) - 1 &&
-        msg->status_list.back().status == action_msgs::msg::GoalStatus::STATUS_SUCCEEDED)
-      {
-        store_poses_.clear();
-        waypoint_status_indicator_->clear();
-        loop_no_ = "0";
-        loop_count_ = 0;
-        navigation_feedback_indicator_->setText(getNavToPoseFeedbackLabel());
+      if (msg->status_list.empty()) {
+        return;
+      }
+      const int status = msg->status_list.back().status;
+      if (status != last_navigation_goal_status_) {
+        last_navigation_goal_status_ = status;
+        emit navigationGoalStatusChanged(status);
       }
     });
-  nav_through_poses_goal_status_sub_ = node->create_subscription<action_msgs::msg::GoalStatusArray>(
+  nav_through_poses_goal_status_sub_ =
+    feedback_node_->create_subscription<action_msgs::msg::GoalStatusArray>(
     "navigate_through_poses/_action/status",
     rclcpp::SystemDefaultsQoS(),
     [this](const action_msgs::msg::GoalStatusArray::SharedPtr msg) {
-      navigation_goal_status_indicator_->setText(
-        getGoalStatusLabel(msg->status_list.back().status));
-      if (msg->status_list.back().status != action_msgs::msg::GoalStatus::STATUS_EXECUTING) {
-        navigation_feedback_indicator_->setText(getNavThroughPosesFeedbackLabel());
+      if (msg->status_list.empty()) {
+        return;
+      }
+      const int status = msg->status_list.back().status;
+      if (status != last_nav_through_poses_goal_status_) {
+        last_nav_through_poses_goal_status_ = status;
+        emit navThroughPosesGoalStatusChanged(status);
       }
     });
+
+  feedback_executor_ = std::make_shared<rclcpp::executors::SingleThreadedExecutor>();
+  feedback_executor_->add_node(feedback_node_);
+  feedback_thread_ = std::thread([this]() {feedback_executor_->spin();});
+}
+
+void
+Nav2Panel::onNavigationFeedback(QString label)
+{
+  if (stoi(nr_of_loops_->displayText().toStdString()) > 0) {
+    if (goal_index_ == 0 && !loop_counter_stop_) {
+      loop_count_++;
+      loop_counter_stop_ = true;
+    }
+    if (goal_index_ != 0) {
+      loop_counter_stop_ = false;
+    }
+    navigation_feedback_indicator_->setText(
+      label + QString(
+        std::string(
+          "</td></tr><tr><td width=150>Waypoint:</td><td>" +
+          toString(goal_index_ + 1)).c_str()) + QString(
+        std::string(
+          "</td></tr><tr><td width=150>Loop:</td><td>" +
+          toString(loop_count_)).c_str()));
+  } else {
+    navigation_feedback_indicator_->setText(label);
+  }
+}
+
+void
+Nav2Panel::onNavThroughPosesFeedback(QString label)
+{
+  navigation_feedback_indicator_->setText(label);
+}
+
+void
+Nav2Panel::onNavigationGoalStatus(int status)
+{
+  navigation_goal_status_indicator_->setText(getGoalStatusLabel(status));
+  // Clearing all the stored values once reaching the final goal
+  if (
+    loop_count_ == stoi(nr_of_loops_->displayText().toStdString()) &&
+    goal_index_ == static_cast<int>(store_poses_.size()) - 1 &&
+    status == action_msgs::msg::GoalStatus::STATUS_SUCCEEDED)
+  {
+    store_poses_.clear();
+    waypoint_status_indicator_->clear();
+    loop_no_ = "0";
+    loop_count_ = 0;
+    navigation_feedback_indicator_->setText(getNavToPoseFeedbackLabel());
+  }
+}
+
+void
+Nav2Panel::onNavThroughPosesGoalStatus(int status)
+{
+  navigation_goal_status_indicator_->setText(getGoalStatusLabel(status));
+  if (status != action_msgs::msg::GoalStatus::STATUS_EXECUTING) {
+    navigation_feedback_indicator_->setText(getNavThroughPosesFeedbackLabel());
+  }
 }
 
 void
@@ -1369,6 +1442,13 @@ Nav2Panel::getUniqueId()
 void
 Nav2Panel::updateWpNavigationMarkers()
 {
+  // Only publish the markers again once the waypoints changed
+  if (wp_markers_published_ && acummulated_poses_ == published_wp_poses_) {
+    return;
+  }
+  published_wp_poses_ = acummulated_poses_;
+  wp_markers_published_ = true;
+
   resetUniqueId();
 
   auto marker_array = std::make_unique<visualization_msgs::msg::MarkerArray>();
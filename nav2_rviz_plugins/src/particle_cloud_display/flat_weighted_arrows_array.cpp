@@ -81,14 +81,24 @@ void FlatWeightedArrowsArray::updateManualObject(
   float max_length,
   const std::vector<nav2_rviz_plugins::OgrePoseWithWeight> & poses)
 {
-  clear();
+  if (poses.empty()) {
+    clear();
+    return;
+  }
 
   color.a = alpha;
-  setManualObjectMaterial();
+  if (!material_) {
+    setManualObjectMaterial();
+  }
   rviz_rendering::MaterialManager::enableAlphaBlending(material_, alpha);
 
-  manual_object_->begin(
-    material_->getName(), Ogre::RenderOperation::OT_LINE_LIST, "rviz_rendering");
+  // Update the section in place, reusing its hardware buffers unless the arrows outgrow them
+  if (manual_object_->getNumSections() > 0) {
+    manual_object_->beginUpdate(0);
+  } else {
+    manual_object_->begin(
+      material_->getName(), Ogre::RenderOperation::OT_LINE_LIST, "rviz_rendering");
+  }
   setManualObjectVertices(color, min_length, max_length, poses);
   manual_object_->end();
 }
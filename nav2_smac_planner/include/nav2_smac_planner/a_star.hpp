@@ -23,17 +23,19 @@
 #include <queue>
 #include <utility>
 #include <tuple>
+#include <chrono>
 #include "Eigen/Core"
 
 #include "nav2_costmap_2d/costmap_2d.hpp"
 #include "nav2_core/planner_exceptions.hpp"
 
-#include "nav2_smac_planner/thirdparty/robin_hood.h"
 #include "nav2_smac_planner/analytic_expansion.hpp"
+#include "nav2_smac_planner/bucket_queue.hpp"
 #include "nav2_smac_planner/node_2d.hpp"
 #include "nav2_smac_planner/node_hybrid.hpp"
 #include "nav2_smac_planner/node_lattice.hpp"
 #include "nav2_smac_planner/node_basic.hpp"
+#include "nav2_smac_planner/node_graph.hpp"
 #include "nav2_smac_planner/types.hpp"
 #include "nav2_smac_planner/constants.hpp"
 
@@ -49,7 +51,7 @@ class AStarAlgorithm
 {
 public:
   typedef NodeT * NodePtr;
-  typedef robin_hood::unordered_node_map<uint64_t, NodeT> Graph;
+  typedef NodeGraph<NodeT> Graph;
   typedef std::vector<NodePtr> NodeVector;
   typedef std::pair<float, NodeBasic<NodeT>> NodeElement;
   typedef typename NodeT::Coordinates Coordinates;
@@ -116,6 +118,12 @@ public:
     std::function<bool()> cancel_checker,
     std::vector<std::tuple<float, float, float>> * expansions_log = nullptr);
 
+  /**
+   * @brief Clear the graph and queue of a search, keeping the start and goal, so that
+   * createPath may search again, such as after changing the collision checker
+   */
+  void resetSearch();
+
   /**
    * @brief Sets the collision checker to use
    * @param collision_checker Collision checker to use for checking state validity
@@ -133,6 +141,19 @@ public:
     const float & my,
     const unsigned int & dim_3);
 
+  /**
+   * @brief Add a goal to the goal set by setGoal, so that one search finds the cheapest
+   * path to any of them rather than searching for each. The path then starts at the goal
+   * reached. Goals must be added after setGoal and before createPath.
+   * @param mx The node X index of the goal
+   * @param my The node Y index of the goal
+   * @param dim_3 The node dim_3 index of the goal
+   */
+  void addGoal(
+    const float & mx,
+    const float & my,
+    const unsigned int & dim_3);
+
   /**
    * @brief Set the starting pose for planning, as a node index
    * @param mx The node X index of the goal
@@ -162,6 +183,12 @@ public:
    */
   NodePtr & getGoal();
 
+  /**
+   * @brief Get the goals of the search, the goal set by setGoal then those added
+   * @return Goal nodes
+   */
+  NodeVector & getGoals();
+
   /**
    * @brief Get maximum number of on-approach iterations after within threshold
    * @return Reference to Maximum on-appraoch iterations parameter
@@ -206,21 +233,74 @@ protected:
    */
   inline void addNode(const float & cost, NodePtr & node);
 
+  /**
+   * @brief Check if the open set is empty
+   * @return if no node is left to search
+   */
+  inline bool isQueueEmpty();
+
   /**
    * @brief Adds node to graph
    * @param index Node index to add
    */
   inline NodePtr addToGraph(const uint64_t & index);
 
+  /**
+   * @brief Run a search from the start to the goal
+   * @param path Reference to a vector of indicies of generated path
+   * @param iterations Reference to number of iterations, incremented by the search
+   * @param heuristic_weight Weight of the heuristic in the node costs, 1 for an A* search
+   * @param cancel_checker Function to check if the task has been canceled
+   * @param expansions_log Optional expansions logged for debug
+   * @param start_time Start time of the planning, for the timeout
+   * @param max_planning_time Maximum time (in seconds) since the start time, for the timeout
+   * @return if a path was found
+   */
+  bool searchPath(
+    CoordinateVector & path, int & iterations, const float & heuristic_weight,
+    std::function<bool()> cancel_checker,
+    std::vector<std::tuple<float, float, float>> * expansions_log,
+    const std::chrono::steady_clock::time_point & start_time,
+    const double & max_planning_time);
+
+  /**
+   * @brief Cost of a path, its length weighted by the costs of its cells as in the
+   * traversal costs, to compare the paths of searches with different heuristic weights
+   * @param path Path to get the cost of
+   * @return Path cost
+   */
+  float getPathCost(const CoordinateVector & path);
+
+  /**
+   * @brief Search from the start and from the goal at once, meeting in the middle.
+   * Only available for Node2D, whose moves can be costed in reverse.
+   * @param path Reference to a vector of indicies of generated path
+   * @param iterations Reference to number of iterations, incremented by the search
+   * @param cancel_checker Function to check if the task has been canceled
+   * @param start_time Start time of the planning, for the timeout
+   * @return if a path connecting the start and goal was found
+   */
+  bool createBidirectionalPath(
+    CoordinateVector & path, int & iterations,
+    std::function<bool()> cancel_checker,
+    const std::chrono::steady_clock::time_point & start_time);
+
   /**
    * @brief Check if this node is the goal node
    * @param node Node pointer to check if its the goal node
-   * @return if node is goal
+   * @return if node is any of the goals
    */
   inline bool isGoal(NodePtr & node);
 
   /**
-   * @brief Get cost of heuristic of node
+   * @brief Get the goal of smallest heuristic from a node, to expand analytically towards
+   * @param node Node pointer to get the goal for
+   * @return Goal node
+   */
+  inline NodePtr & getClosestGoal(const NodePtr & node);
+
+  /**
+   * @brief Get cost of heuristic of node, the smallest over the goals
    * @param node Node pointer to get heuristic for
    * @return Heuristic cost for node
    */
@@ -265,9 +345,16 @@ protected:
   Coordinates _goal_coordinates;
   NodePtr _start;
   NodePtr _goal;
+  // All goals of the search and their coordinates, the first being _goal
+  NodeVector _goals;
+  CoordinateVector _goals_coordinates;
 
   Graph _graph;
   NodeQueue _queue;
+  // Open set of the forward search instead of _queue when the search info asks for it
+  BucketQueue<NodeBasic<NodeT>> _bucket_queue;
+  // Nodes of the search from the goal in bidirectional searches, parents towards the goal
+  Graph _reverse_graph;
 
   MotionModel _motion_model;
   NodeHeuristicPair _best_heuristic_node;
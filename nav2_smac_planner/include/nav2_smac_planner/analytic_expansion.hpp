@@ -121,6 +121,13 @@ public:
   void cleanNode(const NodePtr & nodes);
 
 protected:
+  /**
+   * @brief Converts an angle bin of the search to an angle bin of the collision checker
+   * @param angle_bin Angle bin of the search
+   * @return Angle bin of the collision checker
+   */
+  float getCollisionCheckerBin(const float & angle_bin);
+
   MotionModel _motion_model;
   SearchInfo _search_info;
   bool _traverse_unknown;
@@ -0,0 +1,168 @@
+// Copyright (c) 2024 Open Navigation LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef NAV2_SMAC_PLANNER__BUCKET_QUEUE_HPP_
+#define NAV2_SMAC_PLANNER__BUCKET_QUEUE_HPP_
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <cstring>
+#include <utility>
+#include <vector>
+
+namespace nav2_smac_planner
+{
+
+/**
+ * @class nav2_smac_planner::BucketQueue
+ * @brief A monotone priority queue (radix heap) of non-negative float costs, popping the
+ * smallest cost first. Costs are bucketed by the highest bit of their binary
+ * representation differing from the last popped cost, so pushing and popping is
+ * amortized constant time. Costs pushed below the last popped one, which a consistent
+ * heuristic never gives but rounding may, are queued as the last popped cost. Buckets
+ * keep their storage when cleared, so searching does not allocate once warmed up.
+ */
+template<typename ValueT>
+class BucketQueue
+{
+public:
+  typedef std::pair<float, ValueT> Element;
+
+  /**
+   * @brief Whether the queue is empty
+   * @return If no element is queued
+   */
+  inline bool empty() const
+  {
+    return _size == 0;
+  }
+
+  /**
+   * @brief Get the number of elements queued
+   * @return Number of elements
+   */
+  inline std::size_t size() const
+  {
+    return _size;
+  }
+
+  /**
+   * @brief Queue an element
+   * @param cost Non-negative cost of the element
+   * @param value Value of the element
+   */
+  inline void emplace(const float & cost, const ValueT & value)
+  {
+    const uint32_t key = std::max(toKey(cost), _last_key);
+    _buckets[getBucket(key)].emplace_back(key, Element(cost, value));
+    _size++;
+  }
+
+  /**
+   * @brief Get the element of smallest cost, the queue not being empty
+   * @return Element of smallest cost
+   */
+  inline const Element & top()
+  {
+    refill();
+    return _buckets[0].back().second;
+  }
+
+  /**
+   * @brief Remove the element of smallest cost, the queue not being empty
+   */
+  inline void pop()
+  {
+    refill();
+    _buckets[0].pop_back();
+    _size--;
+  }
+
+  /**
+   * @brief Remove all elements, keeping the storage of the buckets
+   */
+  void clear()
+  {
+    for (auto & bucket : _buckets) {
+      bucket.clear();
+    }
+    _size = 0;
+    _last_key = 0;
+  }
+
+protected:
+  typedef std::vector<std::pair<uint32_t, Element>> Bucket;
+
+  /**
+   * @brief Get an integer key ordered as the non-negative costs are
+   * @param cost Cost to convert
+   * @return Binary representation of the cost
+   */
+  static inline uint32_t toKey(const float & cost)
+  {
+    if (!(cost > 0.0f)) {
+      return 0;
+    }
+    uint32_t key;
+    std::memcpy(&key, &cost, sizeof(key));
+    return key;
+  }
+
+  /**
+   * @brief Get the bucket of a key, not smaller than the last popped key
+   * @param key Key to bucket
+   * @return Index of the highest bit differing from the last popped key, plus one
+   */
+  inline unsigned int getBucket(const uint32_t & key) const
+  {
+    const uint32_t diff = key ^ _last_key;
+    return diff == 0 ? 0 : 32 - __builtin_clz(diff);
+  }
+
+  /**
+   * @brief Move the elements of the first non-empty bucket into the lower buckets, around
+   * their smallest key, if the first bucket is empty
+   */
+  void refill()
+  {
+    if (!_buckets[0].empty()) {
+      return;
+    }
+
+    unsigned int i = 1;
+    while (_buckets[i].empty()) {
+      i++;
+    }
+
+    uint32_t min_key = _buckets[i].front().first;
+    for (const auto & entry : _buckets[i]) {
+      min_key = std::min(min_key, entry.first);
+    }
+    _last_key = min_key;
+
+    for (auto & entry : _buckets[i]) {
+      _buckets[getBucket(entry.first)].push_back(std::move(entry));
+    }
+    _buckets[i].clear();
+  }
+
+  std::array<Bucket, 33> _buckets;
+  std::size_t _size{0};
+  uint32_t _last_key{0};
+};
+
+}  // namespace nav2_smac_planner
+
+#endif  // NAV2_SMAC_PLANNER__BUCKET_QUEUE_HPP_
@@ -14,10 +14,12 @@
 
 #include <vector>
 #include <memory>
+#include <utility>
 
 #include "nav2_costmap_2d/footprint_collision_checker.hpp"
 #include "nav2_costmap_2d/costmap_2d_ros.hpp"
 #include "nav2_smac_planner/constants.hpp"
+#include "nav2_smac_planner/types.hpp"
 #include "rclcpp_lifecycle/lifecycle_node.hpp"
 
 #ifndef NAV2_SMAC_PLANNER__COLLISION_CHECKER_HPP_
@@ -82,6 +84,20 @@ public:
     const float & theta,
     const bool & traverse_unknown);
 
+  /**
+   * @brief Check if any of a sequence of poses is in collision with costmap and footprint.
+   * The cells of all the pose centers are checked before any footprint, so that sequences
+   * crossing obstacles are rejected at the cost of a cell lookup per pose
+   * @param poses Poses to check against, with _theta an angle bin number (NOT radians)
+   * @param traverse_unknown Whether or not to traverse in unknown space
+   * @param costs Costs of the poses as getCost() would give, if none is in collision
+   * @return boolean if any in collision or not.
+   */
+  bool inCollision(
+    const MotionPoses & poses,
+    const bool & traverse_unknown,
+    std::vector<float> & costs);
+
   /**
    * @brief Check if in collision with costmap and footprint at pose
    * @param i Index to search collision status of
@@ -98,6 +114,14 @@ public:
    */
   float getCost();
 
+  /**
+   * @brief Restrict the valid poses to a corridor, the poses whose center cell is outside
+   * of it being in collision
+   * @param corridor Non-zero for the cells of the costmap in the corridor, nullptr for none.
+   * It must outlive its use and match the size of the costmap
+   */
+  void setCorridor(const std::vector<unsigned char> * corridor) {corridor_ = corridor;}
+
   /**
    * @brief Get the angles of the precomputed footprint orientations
    * @return the ordered vector of angles corresponding to footprints
@@ -123,14 +147,67 @@ private:
    */
   bool outsideRange(const unsigned int & max, const float & value);
 
+  /**
+   * @brief Check if the center cell of a pose is outside of the corridor, if any
+   * @param x X coordinate of pose to check
+   * @param y Y coordinate of pose to check
+   * @return boolean if outside or not
+   */
+  bool outsideCorridor(const float & x, const float & y);
+
 protected:
+  /**
+   * @struct nav2_smac_planner::GridCollisionChecker::FootprintCells
+   * @brief Cells of the footprint edges relative to the cell of the pose, for the poses
+   * of an orientation bin in a range of offsets within their cell
+   */
+  struct FootprintCells
+  {
+    // Sorted by row, then column, to read the costmap in memory order
+    std::vector<std::pair<int, int>> cells;
+    // Index offsets of the cells in a costmap of width footprint_cells_size_x_
+    std::vector<int> offsets;
+    int min_x{0}, max_x{0}, min_y{0}, max_y{0};
+  };
+
+  /**
+   * @struct nav2_smac_planner::GridCollisionChecker::OrientedFootprintCells
+   * @brief Footprint cells of an orientation bin. They only change with the offset of
+   * the pose in its cell where a vertex crosses a cell boundary, at the thresholds.
+   */
+  struct OrientedFootprintCells
+  {
+    std::vector<double> x_thresholds;
+    std::vector<double> y_thresholds;
+    // For each pair of offset ranges, X ranges first
+    std::vector<FootprintCells> cells;
+  };
+
+  /**
+   * @brief Rasterize the edges of the oriented footprints for the costmap resolution
+   */
+  void computeFootprintCells();
+
+  /**
+   * @brief Highest cost of the footprint edges at a pose, as footprintCost
+   * @param x X coordinate of pose to check against
+   * @param y Y coordinate of pose to check against
+   * @param angle_bin Orientation bin of the pose
+   * @return Highest cost, lethal once a lethal cell is found or off the costmap
+   */
+  float footprintCellsCost(const float & x, const float & y, const unsigned int & angle_bin);
+
   std::shared_ptr<nav2_costmap_2d::Costmap2DROS> costmap_ros_;
   std::vector<nav2_costmap_2d::Footprint> oriented_footprints_;
+  std::vector<OrientedFootprintCells> footprint_cells_;
+  double footprint_cells_resolution_{0.0};
+  unsigned int footprint_cells_size_x_{0};
   nav2_costmap_2d::Footprint unoriented_footprint_;
   float footprint_cost_;
   bool footprint_is_radius_;
   std::vector<float> angles_;
   float possible_collision_cost_{-1};
+  const std::vector<unsigned char> * corridor_{nullptr};
   rclcpp::Logger logger_{rclcpp::get_logger("SmacPlannerCollisionChecker")};
   rclcpp::Clock::SharedPtr clock_;
 };
@@ -21,6 +21,7 @@
 
 #include "nav2_costmap_2d/costmap_2d_ros.hpp"
 #include "nav2_smac_planner/constants.hpp"
+#include "nav2_util/thread_pool.hpp"
 
 namespace nav2_smac_planner
 {
@@ -50,6 +51,7 @@ public:
    * @param costmap The costmap we want to downsample
    * @param downsampling_factor Multiplier for the costmap resolution
    * @param use_min_cost_neighbor If true, min function is used instead of max for downsampling
+   * @param num_threads Number of threads downsampling, each over its own rows
    */
   void on_configure(
     const nav2_util::LifecycleNode::WeakPtr & node,
@@ -57,7 +59,8 @@ public:
     const std::string & topic_name,
     nav2_costmap_2d::Costmap2D * const costmap,
     const unsigned int & downsampling_factor,
-    const bool & use_min_cost_neighbor = false);
+    const bool & use_min_cost_neighbor = false,
+    const unsigned int & num_threads = 1);
 
   /**
    * @brief Activate the publisher of the downsampled costmap
@@ -93,13 +96,15 @@ protected:
   void updateCostmapSize();
 
   /**
-   * @brief Explore all subcells of the original costmap and assign the max cost to the new (downsampled) cell
-   * @param new_mx The X-coordinate of the cell in the new costmap
-   * @param new_my The Y-coordinate of the cell in the new costmap
+   * @brief Assign the max (or min) cost of their subcells of the original costmap to rows
+   * of the new (downsampled) costmap. The subcells are first pooled across the rows of the
+   * original costmap, reading it in memory order, then across the columns.
+   * @param new_my0 The first Y-coordinate of the rows in the new costmap
+   * @param new_myn The last Y-coordinate of the rows in the new costmap (exclusive)
    */
-  void setCostOfCell(
-    const unsigned int & new_mx,
-    const unsigned int & new_my);
+  void setCostOfRows(
+    const unsigned int & new_my0,
+    const unsigned int & new_myn);
 
   unsigned int _size_x;
   unsigned int _size_y;
@@ -111,6 +116,7 @@ protected:
   nav2_costmap_2d::Costmap2D * _costmap;
   std::unique_ptr<nav2_costmap_2d::Costmap2D> _downsampled_costmap;
   std::unique_ptr<nav2_costmap_2d::Costmap2DPublisher> _downsampled_costmap_pub;
+  std::unique_ptr<nav2_util::ThreadPool> _thread_pool;
 };
 
 }  // namespace nav2_smac_planner
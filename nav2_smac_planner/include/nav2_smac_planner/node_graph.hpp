@@ -0,0 +1,155 @@
+// Copyright (c) 2020, Samsung Research America
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License. Reserved.
+
+#ifndef NAV2_SMAC_PLANNER__NODE_GRAPH_HPP_
+#define NAV2_SMAC_PLANNER__NODE_GRAPH_HPP_
+
+#include <algorithm>
+#include <cstdint>
+#include <memory>
+#include <utility>
+#include <vector>
+
+namespace nav2_smac_planner
+{
+
+/**
+ * @class nav2_smac_planner::NodeGraph
+ * @brief Storage of the search nodes, indexed by node index. Nodes live in fixed size
+ * pages allocated on first use and kept across searches, so their addresses are stable
+ * and planning does not allocate once the searched area was visited before. Clearing
+ * the graph only increments a generation counter, each node being reset on its next use.
+ */
+template<typename NodeT>
+class NodeGraph
+{
+public:
+  typedef NodeT * NodePtr;
+
+  /**
+   * @brief Set the number of node indices, dropping all pages if it changed
+   * @param size Number of node indices, X cells * Y cells * dim 3 bins
+   */
+  void resize(const uint64_t & size)
+  {
+    if (size == _size) {
+      return;
+    }
+    _size = size;
+    std::vector<std::unique_ptr<Page>> pages((size + PAGE_SIZE - 1) / PAGE_SIZE);
+    std::swap(_pages, pages);
+    _generation = 1;
+    _nodes_count = 0;
+  }
+
+  /**
+   * @brief Remove all nodes, in constant time
+   */
+  void clear()
+  {
+    _nodes_count = 0;
+    if (++_generation != 0) {
+      return;
+    }
+
+    // Generations wrapped around, the stale nodes of older ones must not look current
+    for (auto & page : _pages) {
+      if (page) {
+        std::fill(page->generations.begin(), page->generations.end(), 0u);
+      }
+    }
+    _generation = 1;
+  }
+
+  /**
+   * @brief Get a node, adding it if not in the graph
+   * @param index Node index, less than the graph size
+   * @return Node pointer, valid until the graph is resized
+   */
+  inline NodePtr get(const uint64_t & index)
+  {
+    auto & page = _pages[index / PAGE_SIZE];
+    if (!page) {
+      page = std::make_unique<Page>(index - index % PAGE_SIZE);
+    }
+
+    const uint64_t offset = index % PAGE_SIZE;
+    NodeT & node = page->nodes[offset];
+    if (page->generations[offset] != _generation) {
+      node = NodeT(index);
+      page->generations[offset] = _generation;
+      _nodes_count++;
+    }
+    return &node;
+  }
+
+  /**
+   * @brief Find a node of the graph
+   * @param index Node index, less than the graph size
+   * @return Node pointer, nullptr if not in the graph
+   */
+  inline NodePtr find(const uint64_t & index) const
+  {
+    const auto & page = _pages[index / PAGE_SIZE];
+    const uint64_t offset = index % PAGE_SIZE;
+    if (!page || page->generations[offset] != _generation) {
+      return nullptr;
+    }
+    return &page->nodes[offset];
+  }
+
+  /**
+   * @brief Whether no node was added since the last clear
+   */
+  inline bool empty() const
+  {
+    return _nodes_count == 0;
+  }
+
+  /**
+   * @brief Number of nodes added since the last clear
+   */
+  inline uint64_t size() const
+  {
+    return _nodes_count;
+  }
+
+protected:
+  // 4096 nodes, 4096 cells of a 2D graph or 56 cells of 72 headings for Hybrid-A*
+  static constexpr uint64_t PAGE_SIZE = 4096;
+
+  struct Page
+  {
+    explicit Page(const uint64_t & first_index)
+    : generations(PAGE_SIZE, 0u)
+    {
+      nodes.reserve(PAGE_SIZE);
+      for (uint64_t i = 0; i != PAGE_SIZE; i++) {
+        nodes.emplace_back(first_index + i);
+      }
+    }
+
+    std::vector<NodeT> nodes;
+    std::vector<uint32_t> generations;
+  };
+
+  std::vector<std::unique_ptr<Page>> _pages;
+  uint64_t _size{0};
+  uint64_t _nodes_count{0};
+  uint32_t _generation{1};
+};
+
+}  // namespace nav2_smac_planner
+
+#endif  // NAV2_SMAC_PLANNER__NODE_GRAPH_HPP_
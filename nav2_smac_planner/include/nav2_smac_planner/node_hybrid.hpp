@@ -51,6 +51,36 @@ struct ObstacleHeuristicComparator
 
 typedef std::vector<ObstacleHeuristicElement> ObstacleHeuristicQueue;
 
+/**
+ * @struct nav2_smac_planner::ObstacleHeuristicKey
+ * @brief Inputs the obstacle heuristic was computed for, other than the costmap costs,
+ * which must all be the same to repair it rather than computing it again
+ */
+struct ObstacleHeuristicKey
+{
+  bool operator==(const ObstacleHeuristicKey & other) const
+  {
+    return costmap == other.costmap && size_x == other.size_x && size_y == other.size_y &&
+           goal_index == other.goal_index && cost_penalty == other.cost_penalty &&
+           downsample == other.downsample &&
+           use_quadratic_cost_penalty == other.use_quadratic_cost_penalty &&
+           is_circular == other.is_circular &&
+           cost_scaling_factor == other.cost_scaling_factor &&
+           inscribed_radius == other.inscribed_radius;
+  }
+
+  nav2_costmap_2d::Costmap2D * costmap{nullptr};
+  unsigned int size_x{0};
+  unsigned int size_y{0};
+  unsigned int goal_index{0};
+  float cost_penalty{-1.0f};
+  bool downsample{false};
+  bool use_quadratic_cost_penalty{false};
+  bool is_circular{false};
+  float cost_scaling_factor{0.0f};
+  float inscribed_radius{0.0f};
+};
+
 // Must forward declare
 class NodeHybrid;
 
@@ -94,9 +124,9 @@ struct HybridMotionTable
   /**
    * @brief Get projections of motion models
    * @param node Ptr to NodeHybrid
-   * @return A set of motion poses
+   * @param projection_list Motion poses to fill, keeping their storage
    */
-  MotionPoses getProjections(const NodeHybrid * node);
+  void getProjections(const NodeHybrid * node, MotionPoses & projection_list);
 
   /**
    * @brief Get the angular bin to use from a raw orientation
@@ -270,6 +300,15 @@ public:
     return _cell_cost;
   }
 
+  /**
+   * @brief Sets the costmap cost at this node, as found by a collision check of its pose
+   * @param cost Costmap cost
+   */
+  inline void setCost(const float & cost)
+  {
+    _cell_cost = cost;
+  }
+
   /**
    * @brief Gets if cell has been visited in search
    * @param If cell was visited
@@ -434,6 +473,31 @@ public:
     const unsigned int & start_x, const unsigned int & start_y,
     const unsigned int & goal_x, const unsigned int & goal_y);
 
+  /**
+   * @brief Repair the obstacle heuristic of the last plan for the costmap changes since,
+   * keeping the values of all the cells whose path to the goal did not change.
+   * Only possible if the goal and parameters are the same and no cost decreased,
+   * the heuristic must be reset otherwise.
+   * @param costmap_ros Costmap to use
+   * @param goal_x Goal X coordinate
+   * @param goal_y Goal Y coordinate
+   * @param cost_penalty Cost penalty the heuristic will be queried with
+   * @return whether the heuristic was repaired
+   */
+  static bool repairObstacleHeuristic(
+    std::shared_ptr<nav2_costmap_2d::Costmap2DROS> costmap_ros,
+    const unsigned int & goal_x, const unsigned int & goal_y,
+    const float & cost_penalty);
+
+  /**
+   * @brief Seed the obstacle heuristic reset for a goal from another goal, so that it
+   * gives the cost to the closest of them. It must be done before the heuristic is queried,
+   * and the heuristic is not repaired on the next plan.
+   * @param goal_x Goal X coordinate
+   * @param goal_y Goal Y coordinate
+   */
+  static void addObstacleHeuristicGoal(const unsigned int & goal_x, const unsigned int & goal_y);
+
   /**
    * @brief Using the inflation layer, find the footprint's adjusted cost
    * if the robot is non-circular
@@ -482,6 +546,10 @@ public:
   // Wavefront lookup and queue for continuing to expand as needed
   static LookupTable obstacle_heuristic_lookup_table;
   static ObstacleHeuristicQueue obstacle_heuristic_queue;
+  // Parent of each cell towards the goal, costmap costs and inputs it was computed with
+  static std::vector<unsigned int> obstacle_heuristic_parents;
+  static std::vector<unsigned char> obstacle_heuristic_costs;
+  static ObstacleHeuristicKey obstacle_heuristic_key;
 
   static std::shared_ptr<nav2_costmap_2d::Costmap2DROS> costmap_ros;
   static std::shared_ptr<nav2_costmap_2d::InflationLayer> inflation_layer;
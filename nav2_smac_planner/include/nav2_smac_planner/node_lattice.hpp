@@ -208,6 +208,15 @@ public:
     return _cell_cost;
   }
 
+  /**
+   * @brief Sets the costmap cost at this node, as found by a collision check of its pose
+   * @param cost Costmap cost
+   */
+  inline void setCost(const float & cost)
+  {
+    _cell_cost = cost;
+  }
+
   /**
    * @brief Gets if cell has been visited in search
    * @param If cell was visited
@@ -361,6 +370,32 @@ public:
     NodeHybrid::resetObstacleHeuristic(costmap_ros, start_x, start_y, goal_x, goal_y);
   }
 
+  /**
+   * @brief Repair the wavefront heuristic of the last plan for the costmap changes since
+   * @param costmap_ros Costmap to use
+   * @param goal_x Goal X coordinate
+   * @param goal_y Goal Y coordinate
+   * @param cost_penalty Cost penalty the heuristic will be queried with
+   * @return whether the heuristic was repaired, else it must be reset
+   */
+  static bool repairObstacleHeuristic(
+    std::shared_ptr<nav2_costmap_2d::Costmap2DROS> costmap_ros,
+    const unsigned int & goal_x, const unsigned int & goal_y,
+    const float & cost_penalty)
+  {
+    return NodeHybrid::repairObstacleHeuristic(costmap_ros, goal_x, goal_y, cost_penalty);
+  }
+
+  /**
+   * @brief Seed the wavefront heuristic from another goal
+   * @param goal_x Goal X coordinate
+   * @param goal_y Goal Y coordinate
+   */
+  static void addObstacleHeuristicGoal(const unsigned int & goal_x, const unsigned int & goal_y)
+  {
+    NodeHybrid::addObstacleHeuristicGoal(goal_x, goal_y);
+  }
+
   /**
    * @brief Compute the Obstacle heuristic
    * @param node_coords Coordinates to get heuristic at
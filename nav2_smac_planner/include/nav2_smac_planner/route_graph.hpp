@@ -0,0 +1,119 @@
+// Copyright (c) 2024 Open Navigation LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef NAV2_SMAC_PLANNER__ROUTE_GRAPH_HPP_
+#define NAV2_SMAC_PLANNER__ROUTE_GRAPH_HPP_
+
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace nav2_smac_planner
+{
+
+typedef std::unordered_map<std::string, std::string> RouteMetadata;
+
+/**
+ * @struct nav2_smac_planner::RouteEdge
+ * @brief A directed edge of a route graph
+ */
+struct RouteEdge
+{
+  unsigned int end;  ///< Index of the node the edge leads to
+  float cost;
+  RouteMetadata metadata;
+};
+
+/**
+ * @struct nav2_smac_planner::RouteNode
+ * @brief A node of a route graph, in the global frame of the planner
+ */
+struct RouteNode
+{
+  unsigned int id;  ///< Identifier of the node in the graph file
+  double x;
+  double y;
+  std::vector<RouteEdge> edges;
+  RouteMetadata metadata;
+};
+
+/**
+ * @struct nav2_smac_planner::RouteConnection
+ * @brief A node the start or the goal of a plan connects to, and the cost of connecting
+ */
+struct RouteConnection
+{
+  unsigned int node;
+  float cost;
+};
+
+/**
+ * @class nav2_smac_planner::RouteGraph
+ * @brief A sparse graph of routes, such as the roads and paths of a campus, loaded from
+ * a JSON file of the form:
+ * {"nodes": [{"id": 0, "x": 0.0, "y": 0.0, "metadata": {...}}, ...],
+ *  "edges": [{"start": 0, "end": 1, "cost": 10.0, "bidirectional": true,
+ *             "metadata": {...}}, ...]}
+ * An edge costs its length unless given a cost, and is bidirectional unless told
+ * otherwise. Metadata values are kept as strings.
+ */
+class RouteGraph
+{
+public:
+  /**
+   * @brief Load the graph from a file, replacing the current one
+   * @param filepath Path of the JSON file of the graph
+   * @throws std::runtime_error if the file cannot be read or is not a valid graph
+   */
+  void load(const std::string & filepath);
+
+  /**
+   * @brief Get the nodes of the graph
+   * @return Nodes, indexed as the edges and routes refer to them
+   */
+  const std::vector<RouteNode> & getNodes() const {return _nodes;}
+
+  /**
+   * @brief Get the nodes near a position
+   * @param x X coordinate of the position
+   * @param y Y coordinate of the position
+   * @param radius Distance within which to look for nodes
+   * @param max_nodes Maximum number of nodes to return
+   * @return Connections to the nearest nodes within radius, their cost being their
+   * distance, nearest first
+   */
+  std::vector<RouteConnection> getNodesWithin(
+    const double & x, const double & y, const double & radius,
+    const unsigned int & max_nodes) const;
+
+  /**
+   * @brief Find the cheapest route between any of the start connections and any of the
+   * goal connections, including the costs of the connections
+   * @param starts Nodes the start connects to
+   * @param goals Nodes the goal connects to
+   * @param route Indices of the nodes of the route, from start to goal
+   * @return Whether a route was found
+   */
+  bool findRoute(
+    const std::vector<RouteConnection> & starts,
+    const std::vector<RouteConnection> & goals,
+    std::vector<unsigned int> & route) const;
+
+protected:
+  std::vector<RouteNode> _nodes;
+};
+
+}  // namespace nav2_smac_planner
+
+#endif  // NAV2_SMAC_PLANNER__ROUTE_GRAPH_HPP_
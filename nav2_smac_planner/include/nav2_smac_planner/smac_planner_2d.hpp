@@ -108,6 +108,7 @@ protected:
   std::string _global_frame, _name;
   float _tolerance;
   int _downsampling_factor;
+  int _downsampling_threads;
   bool _downsample_costmap;
   rclcpp_lifecycle::LifecyclePublisher<nav_msgs::msg::Path>::SharedPtr _raw_plan_publisher;
   double _max_planning_time;
@@ -97,6 +97,21 @@ protected:
   rcl_interfaces::msg::SetParametersResult
   dynamicParametersCallback(std::vector<rclcpp::Parameter> parameters);
 
+  /**
+   * @brief Build the corridor the search is restricted to, from a 2D path planned
+   * on a coarser costmap
+   * @param start Start pose
+   * @param goal Goal pose
+   * @param costmap Costmap of the search, which the corridor covers
+   * @param cancel_checker Function to check if the action has been canceled
+   * @return Whether a coarse path was found and the corridor built
+   */
+  bool buildCorridor(
+    const geometry_msgs::msg::PoseStamped & start,
+    const geometry_msgs::msg::PoseStamped & goal,
+    nav2_costmap_2d::Costmap2D * costmap,
+    std::function<bool()> cancel_checker);
+
   std::unique_ptr<AStarAlgorithm<NodeHybrid>> _a_star;
   GridCollisionChecker _collision_checker;
   std::unique_ptr<Smoother> _smoother;
@@ -110,6 +125,7 @@ protected:
   float _tolerance;
   bool _downsample_costmap;
   int _downsampling_factor;
+  int _downsampling_threads;
   double _angle_bin_size;
   unsigned int _angle_quantizations;
   bool _allow_unknown;
@@ -123,6 +139,13 @@ protected:
   bool _debug_visualizations;
   std::string _motion_model_for_search;
   MotionModel _motion_model;
+  bool _corridor_search;
+  int _corridor_downsampling_factor;
+  double _corridor_width;
+  std::unique_ptr<AStarAlgorithm<Node2D>> _corridor_a_star;
+  GridCollisionChecker _corridor_collision_checker;
+  std::unique_ptr<CostmapDownsampler> _corridor_downsampler;
+  std::vector<unsigned char> _corridor;
   rclcpp_lifecycle::LifecyclePublisher<nav_msgs::msg::Path>::SharedPtr _raw_plan_publisher;
   rclcpp_lifecycle::LifecyclePublisher<visualization_msgs::msg::MarkerArray>::SharedPtr
     _planned_footprints_publisher;
@@ -0,0 +1,167 @@
+// Copyright (c) 2024 Open Navigation LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef NAV2_SMAC_PLANNER__SMAC_PLANNER_ROUTE_HPP_
+#define NAV2_SMAC_PLANNER__SMAC_PLANNER_ROUTE_HPP_
+
+#include <memory>
+#include <vector>
+#include <string>
+#include <mutex>
+
+#include "nav2_smac_planner/a_star.hpp"
+#include "nav2_smac_planner/route_graph.hpp"
+#include "nav2_smac_planner/utils.hpp"
+#include "nav2_core/global_planner.hpp"
+#include "nav_msgs/msg/path.hpp"
+#include "nav2_costmap_2d/costmap_2d_ros.hpp"
+#include "nav2_costmap_2d/costmap_2d.hpp"
+#include "geometry_msgs/msg/pose_stamped.hpp"
+#include "nav2_util/lifecycle_node.hpp"
+#include "nav2_util/node_utils.hpp"
+
+namespace nav2_smac_planner
+{
+
+/**
+ * @class nav2_smac_planner::SmacPlannerRoute
+ * @brief A planner over a sparse route graph, for campus-scale navigation. The start
+ * and goal are connected to nearby nodes of the graph with a 2D A* search in the
+ * costmap, which may then be a rolling window around the robot, and the graph is
+ * searched in between. The path is dense where it is within the costmap, and only
+ * follows the nodes of the graph beyond it.
+ */
+class SmacPlannerRoute : public nav2_core::GlobalPlanner
+{
+public:
+  /**
+   * @brief constructor
+   */
+  SmacPlannerRoute();
+
+  /**
+   * @brief destructor
+   */
+  ~SmacPlannerRoute();
+
+  /**
+   * @brief Configuring plugin
+   * @param parent Lifecycle node pointer
+   * @param name Name of plugin map
+   * @param tf Shared ptr of TF2 buffer
+   * @param costmap_ros Costmap2DROS object
+   */
+  void configure(
+    const rclcpp_lifecycle::LifecycleNode::WeakPtr & parent,
+    std::string name, std::shared_ptr<tf2_ros::Buffer> tf,
+    std::shared_ptr<nav2_costmap_2d::Costmap2DROS> costmap_ros) override;
+
+  /**
+   * @brief Cleanup lifecycle node
+   */
+  void cleanup() override;
+
+  /**
+   * @brief Activate lifecycle node
+   */
+  void activate() override;
+
+  /**
+   * @brief Deactivate lifecycle node
+   */
+  void deactivate() override;
+
+  /**
+   * @brief Creating a plan from start and goal poses
+   * @param start Start pose
+   * @param goal Goal pose
+   * @param cancel_checker Function to check if the action has been canceled
+   * @return nav2_msgs::Path of the generated path
+   */
+  nav_msgs::msg::Path createPlan(
+    const geometry_msgs::msg::PoseStamped & start,
+    const geometry_msgs::msg::PoseStamped & goal,
+    std::function<bool()> cancel_checker) override;
+
+  /**
+   * @brief Set the function called with the start connection and route of a plan, before
+   * its goal connection is searched
+   * @param callback Function to call with each provisional prefix
+   */
+  void setPartialPathCallback(
+    std::function<void(const nav_msgs::msg::Path &)> callback) override
+  {
+    _partial_path_callback = callback;
+  }
+
+protected:
+  /**
+   * @brief Plan between two positions with a 2D search in the costmap
+   * @param x0 X coordinate of the start
+   * @param y0 Y coordinate of the start
+   * @param x1 X coordinate of the goal
+   * @param y1 Y coordinate of the goal
+   * @param cancel_checker Function to check if the action has been canceled
+   * @param poses Poses of the path from start to goal, in the global frame
+   * @return Whether both positions are in the costmap and a path was found
+   */
+  bool planLocal(
+    const double & x0, const double & y0, const double & x1, const double & y1,
+    std::function<bool()> cancel_checker, std::vector<geometry_msgs::msg::Pose> & poses);
+
+  /**
+   * @brief Append the positions along a straight segment, at the costmap resolution
+   * where it is in the costmap
+   * @param x0 X coordinate of the start of the segment, already appended
+   * @param y0 Y coordinate of the start of the segment, already appended
+   * @param x1 X coordinate of the end of the segment
+   * @param y1 Y coordinate of the end of the segment
+   * @param poses Poses to append to
+   */
+  void appendSegment(
+    const double & x0, const double & y0, const double & x1, const double & y1,
+    std::vector<geometry_msgs::msg::Pose> & poses);
+
+  /**
+   * @brief Make a path of poses, each heading to the next one
+   * @param poses Poses of the path, in the global frame
+   * @return Path, its last pose heading as the one before it
+   */
+  nav_msgs::msg::Path toPath(const std::vector<geometry_msgs::msg::Pose> & poses);
+
+  std::unique_ptr<AStarAlgorithm<Node2D>> _a_star;
+  GridCollisionChecker _collision_checker;
+  RouteGraph _graph;
+  nav2_costmap_2d::Costmap2D * _costmap;
+  rclcpp::Clock::SharedPtr _clock;
+  rclcpp::Logger _logger{rclcpp::get_logger("SmacPlannerRoute")};
+  std::string _global_frame, _name;
+  std::string _graph_filepath;
+  double _connection_radius;
+  int _max_connection_candidates;
+  float _tolerance;
+  double _max_planning_time;
+  bool _allow_unknown;
+  int _max_iterations;
+  int _max_on_approach_iterations;
+  int _terminal_checking_interval;
+  SearchInfo _search_info;
+  std::mutex _mutex;
+  rclcpp_lifecycle::LifecycleNode::WeakPtr _node;
+  std::function<void(const nav_msgs::msg::Path &)> _partial_path_callback;
+};
+
+}  // namespace nav2_smac_planner
+
+#endif  // NAV2_SMAC_PLANNER__SMAC_PLANNER_ROUTE_HPP_
@@ -26,6 +26,7 @@
 #include "nav2_smac_planner/types.hpp"
 #include "nav2_smac_planner/constants.hpp"
 #include "nav2_util/geometry_utils.hpp"
+#include "nav2_util/thread_pool.hpp"
 #include "nav_msgs/msg/path.hpp"
 #include "angles/angles.h"
 #include "tf2/utils.h"
@@ -132,6 +133,21 @@ protected:
     const nav2_costmap_2d::Costmap2D * costmap,
     const double & max_time);
 
+  /**
+   * @brief Gradient descent on the positions of a segment, towards its initial positions
+   * and the midpoints of their neighbors. The end points are kept.
+   * @param x X coordinates of the segment, restored to the last admissible ones on failure
+   * @param y Y coordinates of the segment, restored to the last admissible ones on failure
+   * @param costmap Pointer to minimal costmap, no collision checks if null
+   * @param max_time Maximum time to compute, stop early if over limit
+   * @return If the descent converged without collision
+   */
+  bool smoothPositions(
+    std::vector<double> & x,
+    std::vector<double> & y,
+    const nav2_costmap_2d::Costmap2D * costmap,
+    const double & max_time);
+
   /**
    * @brief Get the field value for a given dimension
    * @param msg Current pose to sample
@@ -232,10 +248,11 @@ protected:
     bool & reversing_segment);
 
   double min_turning_rad_, tolerance_, data_w_, smooth_w_;
-  int max_its_, refinement_ctr_, refinement_num_;
+  int max_its_, refinement_num_;
   bool is_holonomic_, do_refinement_;
   MotionModel motion_model_;
   ompl::base::StateSpacePtr state_space_;
+  std::unique_ptr<nav2_util::ThreadPool> thread_pool_;
 };
 
 }  // namespace nav2_smac_planner
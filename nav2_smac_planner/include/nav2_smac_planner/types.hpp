@@ -46,11 +46,18 @@ struct SearchInfo
   float analytic_expansion_max_cost{200.0};
   bool analytic_expansion_max_cost_override{false};
   std::string lattice_filepath;
+  std::string distance_heuristic_cache_directory;
   bool cache_obstacle_heuristic{false};
   bool allow_reverse_expansion{false};
   bool allow_primitive_interpolation{false};
   bool downsample_obstacle_heuristic{true};
   bool use_quadratic_cost_penalty{false};
+  bool bidirectional_search{false};
+  bool use_bucket_queue{false};
+  bool anytime_search{false};
+  float anytime_initial_heuristic_weight{3.0};
+  float anytime_heuristic_weight_step{0.5};
+  float anytime_max_improvement_time{0.1};
 };
 
 /**
@@ -63,7 +70,7 @@ struct SmootherParams
    * @brief A constructor for nav2_smac_planner::SmootherParams
    */
   SmootherParams()
-  : holonomic_(false)
+  : holonomic_(false), num_threads_(1)
   {
   }
 
@@ -95,6 +102,9 @@ struct SmootherParams
     nav2_util::declare_parameter_if_not_declared(
       node, local_name + "refinement_num", rclcpp::ParameterValue(2));
     node->get_parameter(local_name + "refinement_num", refinement_num_);
+    nav2_util::declare_parameter_if_not_declared(
+      node, local_name + "threads", rclcpp::ParameterValue(1));
+    node->get_parameter(local_name + "threads", num_threads_);
   }
 
   double tolerance_;
@@ -104,6 +114,7 @@ struct SmootherParams
   bool holonomic_;
   bool do_refinement_;
   int refinement_num_;
+  int num_threads_;
 };
 
 /**
@@ -186,6 +197,10 @@ struct MotionPrimitive
   float straight_length;
   bool left_turn;
   MotionPoses poses;
+  // Poses collision checked along the primitive, relative to its end pose in grid
+  // coordinates with angles in radians, when driven forward and in reverse
+  MotionPoses collision_poses;
+  MotionPoses reverse_collision_poses;
 };
 
 typedef std::vector<MotionPrimitive> MotionPrimitives;
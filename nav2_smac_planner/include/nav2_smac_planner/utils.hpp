@@ -19,6 +19,11 @@
 #include <vector>
 #include <memory>
 #include <string>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <sstream>
 
 #include "nlohmann/json.hpp"
 #include "Eigen/Core"
@@ -217,6 +222,95 @@ inline visualization_msgs::msg::Marker createMarker(
   return marker;
 }
 
+/**
+ * @brief Path of the cache file of a distance heuristic lookup table, named after
+ * the inputs it is computed from
+ * @param directory Directory of the cache files
+ * @param name Name of the heuristic, for the file name
+ * @param key Inputs the table is computed from
+ * @return Cache file path
+ */
+inline std::string getDistanceHeuristicCachePath(
+  const std::string & directory, const std::string & name, const std::vector<float> & key)
+{
+  // FNV-1a of the key bytes, the file also holds the key to rule out collisions
+  uint64_t hash = 14695981039346656037ULL;
+  const unsigned char * bytes = reinterpret_cast<const unsigned char *>(key.data());
+  for (size_t i = 0; i != key.size() * sizeof(float); i++) {
+    hash = (hash ^ bytes[i]) * 1099511628211ULL;
+  }
+
+  std::ostringstream path;
+  path << directory << "/" << name << "_" << std::hex << hash << ".bin";
+  return path.str();
+}
+
+/**
+ * @brief Load a distance heuristic lookup table from a cache file
+ * @param filepath Cache file path
+ * @param key Inputs the table must have been computed from
+ * @param table Table to fill, already sized to the expected number of values
+ * @return Whether the file held a table of this key and size
+ */
+inline bool loadDistanceHeuristicCache(
+  const std::string & filepath, const std::vector<float> & key, std::vector<float> & table)
+{
+  std::ifstream file(filepath, std::ios::binary);
+  if (!file) {
+    return false;
+  }
+
+  // Layout: magic, key size, key, table size, table
+  char magic[8];
+  uint64_t key_size = 0, table_size = 0;
+  file.read(magic, sizeof(magic));
+  file.read(reinterpret_cast<char *>(&key_size), sizeof(key_size));
+  if (!file || std::memcmp(magic, "SMACDH01", sizeof(magic)) != 0 || key_size != key.size()) {
+    return false;
+  }
+
+  std::vector<float> file_key(key_size);
+  file.read(reinterpret_cast<char *>(file_key.data()), key_size * sizeof(float));
+  file.read(reinterpret_cast<char *>(&table_size), sizeof(table_size));
+  if (!file || file_key != key || table_size != table.size()) {
+    return false;
+  }
+
+  file.read(reinterpret_cast<char *>(table.data()), table_size * sizeof(float));
+  return static_cast<bool>(file);
+}
+
+/**
+ * @brief Save a distance heuristic lookup table to a cache file, replacing it atomically
+ * so concurrent readers never see a partial table
+ * @param filepath Cache file path
+ * @param key Inputs the table was computed from
+ * @param table Table to save
+ * @return Whether the file could be written
+ */
+inline bool saveDistanceHeuristicCache(
+  const std::string & filepath, const std::vector<float> & key, const std::vector<float> & table)
+{
+  const std::string tmp_filepath = filepath + ".tmp";
+  {
+    std::ofstream file(tmp_filepath, std::ios::binary | std::ios::trunc);
+    if (!file) {
+      return false;
+    }
+
+    const uint64_t key_size = key.size(), table_size = table.size();
+    file.write("SMACDH01", 8);
+    file.write(reinterpret_cast<const char *>(&key_size), sizeof(key_size));
+    file.write(reinterpret_cast<const char *>(key.data()), key_size * sizeof(float));
+    file.write(reinterpret_cast<const char *>(&table_size), sizeof(table_size));
+    file.write(reinterpret_cast<const char *>(table.data()), table_size * sizeof(float));
+    if (!file) {
+      std::remove(tmp_filepath.c_str());
+      return false;
+    }
+  }
+  return std::rename(tmp_filepath.c_str(), filepath.c_str()) == 0;
+}
 
 }  // namespace nav2_smac_planner
 
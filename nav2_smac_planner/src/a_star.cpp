@@ -48,7 +48,6 @@ AStarAlgorithm<NodeT>::AStarAlgorithm(
   _goal(nullptr),
   _motion_model(motion_model)
 {
-  _graph.reserve(100000);
 }
 
 template<typename NodeT>
@@ -112,13 +111,13 @@ void AStarAlgorithm<NodeT>::setCollisionChecker(GridCollisionChecker * collision
   unsigned int x_size = _costmap->getSizeInCellsX();
   unsigned int y_size = _costmap->getSizeInCellsY();
 
-  clearGraph();
-
   if (getSizeX() != x_size || getSizeY() != y_size) {
     _x_size = x_size;
     _y_size = y_size;
     NodeT::initMotionModel(_motion_model, _x_size, _y_size, _dim3_size, _search_info);
   }
+
+  clearGraph();
   _expander->setCollisionChecker(_collision_checker);
 }
 
@@ -126,12 +125,7 @@ template<typename NodeT>
 typename AStarAlgorithm<NodeT>::NodePtr AStarAlgorithm<NodeT>::addToGraph(
   const uint64_t & index)
 {
-  auto iter = _graph.find(index);
-  if (iter != _graph.end()) {
-    return &(iter->second);
-  }
-
-  return &(_graph.emplace(index, NodeT(index)).first->second);
+  return _graph.get(index);
 }
 
 template<>
@@ -204,6 +198,8 @@ void AStarAlgorithm<Node2D>::setGoal(
       static_cast<unsigned int>(my),
       getSizeX()));
   _goal_coordinates = Node2D::Coordinates(mx, my);
+  _goals.assign(1, _goal);
+  _goals_coordinates.assign(1, _goal_coordinates);
 }
 
 template<typename NodeT>
@@ -220,7 +216,12 @@ void AStarAlgorithm<NodeT>::setGoal(
 
   typename NodeT::Coordinates goal_coords(mx, my, dim_3);
 
-  if (!_search_info.cache_obstacle_heuristic || goal_coords != _goal_coordinates) {
+  // When caching, the heuristic of the last plan is kept for the same goal and only
+  // repaired where the costmap changed
+  if (!_search_info.cache_obstacle_heuristic ||
+    !NodeT::repairObstacleHeuristic(
+      _collision_checker->getCostmapROS(), mx, my, _search_info.cost_penalty))
+  {
     if (!_start) {
       throw std::runtime_error("Start must be set before goal.");
     }
@@ -231,6 +232,62 @@ void AStarAlgorithm<NodeT>::setGoal(
 
   _goal_coordinates = goal_coords;
   _goal->setPose(_goal_coordinates);
+  _goals.assign(1, _goal);
+  _goals_coordinates.assign(1, _goal_coordinates);
+}
+
+template<>
+void AStarAlgorithm<Node2D>::addGoal(
+  const float & mx,
+  const float & my,
+  const unsigned int & dim_3)
+{
+  if (dim_3 != 0) {
+    throw std::runtime_error("Node type Node2D cannot be given non-zero goal dim 3.");
+  }
+  if (!_goal) {
+    throw std::runtime_error("A goal must be set before adding goals.");
+  }
+
+  _goals.push_back(
+    addToGraph(
+      Node2D::getIndex(
+        static_cast<unsigned int>(mx),
+        static_cast<unsigned int>(my),
+        getSizeX())));
+  _goals_coordinates.emplace_back(mx, my);
+}
+
+template<typename NodeT>
+void AStarAlgorithm<NodeT>::addGoal(
+  const float & mx,
+  const float & my,
+  const unsigned int & dim_3)
+{
+  if (!_start || !_goal) {
+    throw std::runtime_error("Start and goal must be set before adding goals.");
+  }
+
+  NodePtr goal = addToGraph(
+    NodeT::getIndex(
+      static_cast<unsigned int>(mx),
+      static_cast<unsigned int>(my),
+      dim_3));
+
+  // The obstacle heuristic is seeded from every goal, as the distance to the closest.
+  // A heuristic repaired from the last plan may hold cells already closed for the first
+  // goal only, so it is computed again.
+  if (_goals.size() == 1 && _search_info.cache_obstacle_heuristic) {
+    NodeT::resetObstacleHeuristic(
+      _collision_checker->getCostmapROS(), _start->pose.x, _start->pose.y,
+      _goal_coordinates.x, _goal_coordinates.y);
+  }
+  NodeT::addObstacleHeuristicGoal(mx, my);
+
+  typename NodeT::Coordinates goal_coords(mx, my, dim_3);
+  goal->setPose(goal_coords);
+  _goals.push_back(goal);
+  _goals_coordinates.push_back(goal_coords);
 }
 
 template<typename NodeT>
@@ -246,9 +303,12 @@ bool AStarAlgorithm<NodeT>::areInputsValid()
     throw std::runtime_error("Failed to compute path, no valid start or goal given.");
   }
 
-  // Check if ending point is valid
+  // Check if ending point is valid, any of the goals sufficing
   if (getToleranceHeuristic() < 0.001 &&
-    !_goal->isNodeValid(_traverse_unknown, _collision_checker))
+    std::none_of(
+      _goals.begin(), _goals.end(), [this](NodePtr & goal) {
+        return goal->isNodeValid(_traverse_unknown, _collision_checker);
+      }))
   {
     throw nav2_core::GoalOccupied("Goal was in lethal cost");
   }
@@ -273,6 +333,69 @@ bool AStarAlgorithm<NodeT>::createPath(
     return false;
   }
 
+  // The search from the goal is only seeded from a single goal
+  if (_search_info.bidirectional_search && _goals.size() == 1) {
+    if (createBidirectionalPath(path, iterations, cancel_checker, start_time)) {
+      return true;
+    }
+
+    std::chrono::duration<double> planning_duration =
+      std::chrono::duration_cast<std::chrono::duration<double>>(steady_clock::now() - start_time);
+    if (iterations >= getMaxIterations() ||
+      static_cast<double>(planning_duration.count()) >= _max_planning_time ||
+      getToleranceHeuristic() < 0.001)
+    {
+      return false;
+    }
+
+    // The goal is unreachable, but a forward search may find a path within tolerance
+    resetSearch();
+  }
+
+  if (!_search_info.anytime_search) {
+    return searchPath(
+      path, iterations, 1.0f, cancel_checker, expansions_log, start_time, _max_planning_time);
+  }
+
+  // Anytime search: a first path is found quickly with an inflated heuristic, then the
+  // search is run again with decreasing weights while time remains, keeping the cheapest
+  float heuristic_weight = std::max(_search_info.anytime_initial_heuristic_weight, 1.0f);
+  const double max_improvement_time =
+    std::min(static_cast<double>(_search_info.anytime_max_improvement_time), _max_planning_time);
+  float best_path_cost = std::numeric_limits<float>::max();
+  CoordinateVector weighted_path;
+  bool path_found = false;
+  while (searchPath(
+      weighted_path, iterations, heuristic_weight, cancel_checker, expansions_log, start_time,
+      path_found ? max_improvement_time : _max_planning_time))
+  {
+    const float path_cost = getPathCost(weighted_path);
+    if (path_cost < best_path_cost) {
+      best_path_cost = path_cost;
+      std::swap(path, weighted_path);
+    }
+    path_found = true;
+
+    if (heuristic_weight <= 1.0f || _search_info.anytime_heuristic_weight_step <= 0.0f) {
+      break;
+    }
+    heuristic_weight =
+      std::max(heuristic_weight - _search_info.anytime_heuristic_weight_step, 1.0f);
+    weighted_path.clear();
+    resetSearch();
+  }
+
+  return path_found;
+}
+
+template<typename NodeT>
+bool AStarAlgorithm<NodeT>::searchPath(
+  CoordinateVector & path, int & iterations, const float & heuristic_weight,
+  std::function<bool()> cancel_checker,
+  std::vector<std::tuple<float, float, float>> * expansions_log,
+  const steady_clock::time_point & start_time,
+  const double & max_planning_time)
+{
   // 0) Add starting point to the open set
   addNode(0.0, getStart());
   getStart()->setAccumulatedCost(0.0);
@@ -303,7 +426,7 @@ bool AStarAlgorithm<NodeT>::createPath(
       return true;
     };
 
-  while (iterations < getMaxIterations() && !_queue.empty()) {
+  while (iterations < getMaxIterations() && !isQueueEmpty()) {
     // Check for planning timeout and cancel only on every Nth iteration
     if (iterations % _terminal_checking_interval == 0) {
       if (cancel_checker()) {
@@ -311,7 +434,7 @@ bool AStarAlgorithm<NodeT>::createPath(
       }
       std::chrono::duration<double> planning_duration =
         std::chrono::duration_cast<std::chrono::duration<double>>(steady_clock::now() - start_time);
-      if (static_cast<double>(planning_duration.count()) >= _max_planning_time) {
+      if (static_cast<double>(planning_duration.count()) >= max_planning_time) {
         return false;
       }
     }
@@ -338,7 +461,8 @@ bool AStarAlgorithm<NodeT>::createPath(
     // 2.1) Use an analytic expansion (if available) to generate a path
     expansion_result = nullptr;
     expansion_result = _expander->tryAnalyticExpansion(
-      current_node, getGoal(), neighborGetter, analytic_iterations, closest_distance);
+      current_node, getClosestGoal(current_node), neighborGetter, analytic_iterations,
+      closest_distance);
     if (expansion_result != nullptr) {
       current_node = expansion_result;
     }
@@ -350,7 +474,7 @@ bool AStarAlgorithm<NodeT>::createPath(
       // Optimization: Let us find when in tolerance and refine within reason
       approach_iterations++;
       if (approach_iterations >= getOnApproachMaxIterations()) {
-        return _graph.at(_best_heuristic_node.second).backtracePath(path);
+        return _graph.find(_best_heuristic_node.second)->backtracePath(path);
       }
     }
 
@@ -372,23 +496,231 @@ bool AStarAlgorithm<NodeT>::createPath(
         neighbor->parent = current_node;
 
         // 4.3) Add to queue with heuristic cost
-        addNode(g_cost + getHeuristicCost(neighbor), neighbor);
+        addNode(g_cost + heuristic_weight * getHeuristicCost(neighbor), neighbor);
       }
     }
   }
 
   if (_best_heuristic_node.first < getToleranceHeuristic()) {
     // If we run out of search options, return the path that is closest, if within tolerance.
-    return _graph.at(_best_heuristic_node.second).backtracePath(path);
+    return _graph.find(_best_heuristic_node.second)->backtracePath(path);
   }
 
   return false;
 }
 
+template<typename NodeT>
+bool AStarAlgorithm<NodeT>::createBidirectionalPath(
+  CoordinateVector &, int &, std::function<bool()>, const steady_clock::time_point &)
+{
+  throw std::runtime_error("Bidirectional search is only available for Node2D.");
+}
+
+template<>
+bool AStarAlgorithm<Node2D>::createBidirectionalPath(
+  CoordinateVector & path, int & iterations,
+  std::function<bool()> cancel_checker,
+  const steady_clock::time_point & start_time)
+{
+  // The search from the goal costs moves into the nodes it expands, so it needs their costs
+  if (!getGoal()->isNodeValid(_traverse_unknown, _collision_checker)) {
+    return false;
+  }
+
+  const uint64_t max_index = static_cast<uint64_t>(getSizeX()) *
+    static_cast<uint64_t>(getSizeY());
+  _reverse_graph.resize(max_index);
+  _reverse_graph.clear();
+  NodePtr reverse_start = _reverse_graph.get(getGoal()->getIndex());
+  reverse_start->isNodeValid(_traverse_unknown, _collision_checker);
+
+  NodeGetter forward_getter =
+    [&, this](const uint64_t & index, NodePtr & neighbor_rtn) -> bool
+    {
+      if (index >= max_index) {
+        return false;
+      }
+      neighbor_rtn = addToGraph(index);
+      return true;
+    };
+  NodeGetter reverse_getter =
+    [&, this](const uint64_t & index, NodePtr & neighbor_rtn) -> bool
+    {
+      if (index >= max_index) {
+        return false;
+      }
+      neighbor_rtn = _reverse_graph.get(index);
+      return true;
+    };
+
+  const Coordinates start_coords = Node2D::getCoords(getStart()->getIndex());
+  const Coordinates goal_coords = Node2D::getCoords(getGoal()->getIndex());
+  NodeQueue reverse_queue;
+  auto push = [](NodeQueue & queue, const float & cost, NodePtr & node) {
+      NodeBasic<Node2D> queued_node(node->getIndex());
+      queued_node.populateSearchNode(node);
+      queue.emplace(cost, queued_node);
+    };
+  auto drop_visited = [](NodeQueue & queue) {
+      while (!queue.empty() && queue.top().second.graph_node_ptr->wasVisited()) {
+        queue.pop();
+      }
+    };
+
+  getStart()->setAccumulatedCost(0.0);
+  push(_queue, 0.0, getStart());
+  reverse_start->setAccumulatedCost(0.0);
+  push(reverse_queue, 0.0, reverse_start);
+
+  // Cheapest path through a node reached by both searches so far
+  float best_cost = std::numeric_limits<float>::max();
+  uint64_t meeting_index = 0;
+  NodeVector neighbors;
+
+  while (iterations < getMaxIterations()) {
+    if (iterations % _terminal_checking_interval == 0) {
+      if (cancel_checker()) {
+        throw nav2_core::PlannerCancelled("Planner was cancelled");
+      }
+      std::chrono::duration<double> planning_duration =
+        std::chrono::duration_cast<std::chrono::duration<double>>(steady_clock::now() - start_time);
+      if (static_cast<double>(planning_duration.count()) >= _max_planning_time) {
+        return false;
+      }
+    }
+
+    drop_visited(_queue);
+    drop_visited(reverse_queue);
+    if (_queue.empty() || reverse_queue.empty()) {
+      break;
+    }
+
+    // With consistent heuristics, no path through an unexpanded node of a search can be
+    // cheaper than its smallest f, so either search reaching the best cost proves it optimal
+    if (_queue.top().first >= best_cost || reverse_queue.top().first >= best_cost) {
+      break;
+    }
+
+    // Expand the search with the smallest open set, to keep their frontiers balanced
+    const bool forward = _queue.size() <= reverse_queue.size();
+    NodeQueue & queue = forward ? _queue : reverse_queue;
+    Graph & other_graph = forward ? _reverse_graph : _graph;
+    NodePtr current_node = queue.top().second.graph_node_ptr;
+    queue.pop();
+    iterations++;
+    current_node->visited();
+
+    neighbors.clear();
+    current_node->getNeighbors(
+      forward ? forward_getter : reverse_getter, _collision_checker, _traverse_unknown, neighbors);
+
+    for (NodePtr & neighbor : neighbors) {
+      // Moves of the search from the goal are taken backwards, into the current node
+      const float g_cost = current_node->getAccumulatedCost() +
+        (forward ? current_node->getTraversalCost(neighbor) :
+        neighbor->getTraversalCost(current_node));
+      if (g_cost >= neighbor->getAccumulatedCost()) {
+        continue;
+      }
+
+      neighbor->setAccumulatedCost(g_cost);
+      neighbor->parent = current_node;
+      const Coordinates coords = Node2D::getCoords(neighbor->getIndex());
+      push(
+        queue, g_cost + Node2D::getHeuristicCost(coords, forward ? goal_coords : start_coords),
+        neighbor);
+
+      NodePtr other = other_graph.find(neighbor->getIndex());
+      if (other && g_cost + other->getAccumulatedCost() < best_cost) {
+        best_cost = g_cost + other->getAccumulatedCost();
+        meeting_index = neighbor->getIndex();
+      }
+    }
+  }
+
+  if (best_cost == std::numeric_limits<float>::max()) {
+    return false;
+  }
+
+  // Goal to meeting node from the search from the goal, then the meeting node to the start
+  CoordinateVector reverse_path;
+  for (NodePtr node = _reverse_graph.find(meeting_index)->parent; node; node = node->parent) {
+    reverse_path.push_back(Node2D::getCoords(node->getIndex()));
+  }
+  path.insert(path.end(), reverse_path.rbegin(), reverse_path.rend());
+  for (NodePtr node = _graph.find(meeting_index); node; node = node->parent) {
+    path.push_back(Node2D::getCoords(node->getIndex()));
+  }
+  return true;
+}
+
+template<>
+void AStarAlgorithm<Node2D>::resetSearch()
+{
+  // Nodes keep their addresses when cleared, so the start and goals are only reset
+  _graph.clear();
+  addToGraph(getStart()->getIndex());
+  for (NodePtr & goal : _goals) {
+    addToGraph(goal->getIndex());
+  }
+  clearQueue();
+  _best_heuristic_node = {std::numeric_limits<float>::max(), 0};
+}
+
+template<typename NodeT>
+void AStarAlgorithm<NodeT>::resetSearch()
+{
+  // Nodes keep their addresses when cleared, so the start and goals are reset in place
+  // and given back their poses, which may be off the centers of their cells
+  const Coordinates start_pose = getStart()->pose;
+  _graph.clear();
+  addToGraph(getStart()->getIndex())->setPose(start_pose);
+  for (unsigned int i = 0; i != _goals.size(); i++) {
+    addToGraph(_goals[i]->getIndex())->setPose(_goals_coordinates[i]);
+  }
+  clearQueue();
+  _best_heuristic_node = {std::numeric_limits<float>::max(), 0};
+}
+
+template<typename NodeT>
+float AStarAlgorithm<NodeT>::getPathCost(const CoordinateVector & path)
+{
+  float cost = 0.0f;
+  for (unsigned int i = 1; i < path.size(); i++) {
+    const float cell_cost = static_cast<float>(_costmap->getCost(
+        static_cast<unsigned int>(path[i].x + 0.5f), static_cast<unsigned int>(path[i].y + 0.5f)));
+    cost += hypotf(path[i].x - path[i - 1].x, path[i].y - path[i - 1].y) *
+      (1.0f + _search_info.cost_penalty * cell_cost / 252.0f);
+  }
+  return cost;
+}
+
 template<typename NodeT>
 bool AStarAlgorithm<NodeT>::isGoal(NodePtr & node)
 {
-  return node == getGoal();
+  return std::find(_goals.begin(), _goals.end(), node) != _goals.end();
+}
+
+template<typename NodeT>
+typename AStarAlgorithm<NodeT>::NodePtr & AStarAlgorithm<NodeT>::getClosestGoal(
+  const NodePtr & node)
+{
+  if (_goals.size() < 2) {
+    return getGoal();
+  }
+
+  const Coordinates node_coords =
+    NodeT::getCoords(node->getIndex(), getSizeX(), getSizeDim3());
+  unsigned int closest = 0;
+  float closest_heuristic = std::numeric_limits<float>::max();
+  for (unsigned int i = 0; i != _goals.size(); i++) {
+    const float heuristic = NodeT::getHeuristicCost(node_coords, _goals_coordinates[i]);
+    if (heuristic < closest_heuristic) {
+      closest_heuristic = heuristic;
+      closest = i;
+    }
+  }
+  return _goals[closest];
 }
 
 template<typename NodeT>
@@ -403,11 +735,22 @@ typename AStarAlgorithm<NodeT>::NodePtr & AStarAlgorithm<NodeT>::getGoal()
   return _goal;
 }
 
+template<typename NodeT>
+typename AStarAlgorithm<NodeT>::NodeVector & AStarAlgorithm<NodeT>::getGoals()
+{
+  return _goals;
+}
+
 template<typename NodeT>
 typename AStarAlgorithm<NodeT>::NodePtr AStarAlgorithm<NodeT>::getNextNode()
 {
-  NodeBasic<NodeT> node = _queue.top().second;
-  _queue.pop();
+  NodeBasic<NodeT> node = _search_info.use_bucket_queue ?
+    _bucket_queue.top().second : _queue.top().second;
+  if (_search_info.use_bucket_queue) {
+    _bucket_queue.pop();
+  } else {
+    _queue.pop();
+  }
   node.processSearchNode();
   return node.graph_node_ptr;
 }
@@ -417,7 +760,17 @@ void AStarAlgorithm<NodeT>::addNode(const float & cost, NodePtr & node)
 {
   NodeBasic<NodeT> queued_node(node->getIndex());
   queued_node.populateSearchNode(node);
-  _queue.emplace(cost, queued_node);
+  if (_search_info.use_bucket_queue) {
+    _bucket_queue.emplace(cost, queued_node);
+  } else {
+    _queue.emplace(cost, queued_node);
+  }
+}
+
+template<typename NodeT>
+bool AStarAlgorithm<NodeT>::isQueueEmpty()
+{
+  return _search_info.use_bucket_queue ? _bucket_queue.empty() : _queue.empty();
 }
 
 template<typename NodeT>
@@ -427,6 +780,9 @@ float AStarAlgorithm<NodeT>::getHeuristicCost(const NodePtr & node)
     NodeT::getCoords(node->getIndex(), getSizeX(), getSizeDim3());
   float heuristic = NodeT::getHeuristicCost(
     node_coords, _goal_coordinates);
+  for (unsigned int i = 1; i < _goals_coordinates.size(); i++) {
+    heuristic = std::min(heuristic, NodeT::getHeuristicCost(node_coords, _goals_coordinates[i]));
+  }
 
   if (heuristic < _best_heuristic_node.first) {
     _best_heuristic_node = {heuristic, node->getIndex()};
@@ -440,14 +796,16 @@ void AStarAlgorithm<NodeT>::clearQueue()
 {
   NodeQueue q;
   std::swap(_queue, q);
+  _bucket_queue.clear();
 }
 
 template<typename NodeT>
 void AStarAlgorithm<NodeT>::clearGraph()
 {
-  Graph g;
-  std::swap(_graph, g);
-  _graph.reserve(100000);
+  _graph.resize(
+    static_cast<uint64_t>(getSizeX()) * static_cast<uint64_t>(getSizeY()) *
+    static_cast<uint64_t>(getSizeDim3()));
+  _graph.clear();
 }
 
 template<typename NodeT>
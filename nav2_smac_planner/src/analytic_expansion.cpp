@@ -192,58 +192,80 @@ typename AnalyticExpansion<NodeT>::AnalyticExpansionNodes AnalyticExpansion<Node
 
   unsigned int num_intervals = static_cast<unsigned int>(std::floor(d / sqrt_2));
 
-  AnalyticExpansionNodes possible_nodes;
+  // Solve the analytic path once for all the interpolations along it, rather than
+  // at every interpolated pose as the generic state space interpolation does
+  const auto dubins_space = std::dynamic_pointer_cast<ompl::base::DubinsStateSpace>(state_space);
+  const auto reeds_shepp_space =
+    std::dynamic_pointer_cast<ompl::base::ReedsSheppStateSpace>(state_space);
+  ompl::base::DubinsStateSpace::DubinsPath dubins_path;
+  ompl::base::ReedsSheppStateSpace::ReedsSheppPath reeds_shepp_path;
+  bool first_time = true;
+
+  // Interpolate intermediary poses (non-goal, non-start)
   // When "from" and "to" are zero or one cell away,
   // num_intervals == 0
-  possible_nodes.reserve(num_intervals);  // We won't store this node or the goal
+  std::vector<Coordinates> proposed_coordinates;
+  proposed_coordinates.reserve(num_intervals);
+  MotionPoses collision_poses;
+  collision_poses.reserve(num_intervals);
   std::vector<double> reals;
   double theta;
-
-  // Pre-allocate
-  NodePtr prev(node);
-  uint64_t index = 0;
-  NodePtr next(nullptr);
   float angle = 0.0;
-  Coordinates proposed_coordinates;
-  bool failure = false;
-  std::vector<float> node_costs;
-  node_costs.reserve(num_intervals);
-
-  // Check intermediary poses (non-goal, non-start)
   for (float i = 1; i <= num_intervals; i++) {
-    state_space->interpolate(from(), to(), i / num_intervals, s());
+    const double t = i / num_intervals;
+    if (t >= 1.0) {
+      state_space->interpolate(from(), to(), t, s());
+    } else if (dubins_space) {
+      dubins_space->interpolate(from(), to(), t, first_time, dubins_path, s());
+    } else if (reeds_shepp_space) {
+      reeds_shepp_space->interpolate(from(), to(), t, first_time, reeds_shepp_path, s());
+    } else {
+      state_space->interpolate(from(), to(), t, s());
+    }
     reals = s.reals();
     // Make sure in range [0, 2PI)
     theta = (reals[2] < 0.0) ? (reals[2] + 2.0 * M_PI) : reals[2];
     theta = (theta > 2.0 * M_PI) ? (theta - 2.0 * M_PI) : theta;
     angle = node->motion_table.getClosestAngularBin(theta);
+    proposed_coordinates.emplace_back(
+      static_cast<float>(reals[0]), static_cast<float>(reals[1]), angle);
+    collision_poses.emplace_back(
+      static_cast<float>(reals[0]), static_cast<float>(reals[1]),
+      getCollisionCheckerBin(angle), TurnDirection::UNKNOWN);
+  }
+
+  // Check all the poses in a single query, before touching any node of the graph
+  std::vector<float> node_costs;
+  if (_collision_checker->inCollision(collision_poses, _traverse_unknown, node_costs)) {
+    return AnalyticExpansionNodes();
+  }
 
-    // Turn the pose into a node, and check if it is valid
+  AnalyticExpansionNodes possible_nodes;
+  possible_nodes.reserve(num_intervals);  // We won't store this node or the goal
+  NodePtr prev(node);
+  uint64_t index = 0;
+  NodePtr next(nullptr);
+  bool failure = false;
+  for (unsigned int i = 0; i != proposed_coordinates.size(); i++) {
+    // Turn the pose into a node
+    const Coordinates & proposed = proposed_coordinates[i];
     index = NodeT::getIndex(
-      static_cast<unsigned int>(reals[0]),
-      static_cast<unsigned int>(reals[1]),
-      static_cast<unsigned int>(angle));
+      static_cast<unsigned int>(proposed.x),
+      static_cast<unsigned int>(proposed.y),
+      static_cast<unsigned int>(proposed.theta));
     // Get the node from the graph
-    if (node_getter(index, next)) {
-      Coordinates initial_node_coords = next->pose;
-      proposed_coordinates = {static_cast<float>(reals[0]), static_cast<float>(reals[1]), angle};
-      next->setPose(proposed_coordinates);
-      if (next->isNodeValid(_traverse_unknown, _collision_checker) && next != prev) {
-        // Save the node, and its previous coordinates in case we need to abort
-        possible_nodes.emplace_back(next, initial_node_coords, proposed_coordinates);
-        node_costs.emplace_back(next->getCost());
-        prev = next;
-      } else {
-        // Abort
-        next->setPose(initial_node_coords);
-        failure = true;
-        break;
-      }
-    } else {
+    if (!node_getter(index, next) || next == prev) {
       // Abort
       failure = true;
       break;
     }
+
+    // Save the node, and its previous coordinates in case we need to abort
+    Coordinates initial_node_coords = next->pose;
+    next->setPose(proposed);
+    next->setCost(node_costs[i]);
+    possible_nodes.emplace_back(next, initial_node_coords, proposed_coordinates[i]);
+    prev = next;
   }
 
   if (!failure) {
@@ -323,6 +345,21 @@ typename AnalyticExpansion<NodeT>::NodePtr AnalyticExpansion<NodeT>::setAnalytic
   return goal_node;
 }
 
+template<>
+float AnalyticExpansion<NodeLattice>::getCollisionCheckerBin(const float & angle_bin)
+{
+  // Convert grid quantization of primitives to radians, then collision checker quantization
+  static const double bin_size =
+    2.0 * M_PI / _collision_checker->getPrecomputedAngles().size();
+  return NodeLattice::motion_table.getAngleFromBin(angle_bin) / bin_size;
+}
+
+template<typename NodeT>
+float AnalyticExpansion<NodeT>::getCollisionCheckerBin(const float & angle_bin)
+{
+  return angle_bin;
+}
+
 template<>
 void AnalyticExpansion<NodeLattice>::cleanNode(const NodePtr & node)
 {
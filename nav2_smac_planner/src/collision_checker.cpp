@@ -12,7 +12,14 @@
 // See the License for the specific language governing permissions and
 // limitations under the License. Reserved.
 
+#include <algorithm>
+#include <cmath>
+#include <utility>
+#include <vector>
+
+#include "nav2_costmap_2d/cost_values.hpp"
 #include "nav2_smac_planner/collision_checker.hpp"
+#include "nav2_util/line_iterator.hpp"
 
 namespace nav2_smac_planner
 {
@@ -89,6 +96,171 @@ void GridCollisionChecker::setFootprint(
   }
 
   unoriented_footprint_ = footprint;
+  // Rasterized on the next check, for the resolution of the costmap then
+  footprint_cells_resolution_ = 0.0;
+}
+
+void GridCollisionChecker::computeFootprintCells()
+{
+  const double resolution = costmap_->getResolution();
+  footprint_cells_.clear();
+  footprint_cells_.reserve(oriented_footprints_.size());
+
+  // Offsets in a cell at which the cell of a vertex changes, when it reaches the next one
+  auto get_thresholds = [](const std::vector<double> & vertices) {
+      std::vector<double> thresholds;
+      for (const double & vertex : vertices) {
+        const double threshold = std::ceil(vertex) - vertex;
+        if (threshold > 0.0 && threshold < 1.0) {
+          thresholds.push_back(threshold);
+        }
+      }
+      std::sort(thresholds.begin(), thresholds.end());
+      thresholds.erase(std::unique(thresholds.begin(), thresholds.end()), thresholds.end());
+      return thresholds;
+    };
+  auto get_range_offset = [](const std::vector<double> & thresholds, const unsigned int & i) {
+      const double low = i == 0 ? 0.0 : thresholds[i - 1];
+      const double high = i == thresholds.size() ? 1.0 : thresholds[i];
+      return (low + high) / 2.0;
+    };
+
+  for (const nav2_costmap_2d::Footprint & oriented_footprint : oriented_footprints_) {
+    OrientedFootprintCells oriented_cells;
+    std::vector<double> vertices_x, vertices_y;
+    for (const geometry_msgs::msg::Point & pt : oriented_footprint) {
+      vertices_x.push_back(pt.x / resolution);
+      vertices_y.push_back(pt.y / resolution);
+    }
+    oriented_cells.x_thresholds = get_thresholds(vertices_x);
+    oriented_cells.y_thresholds = get_thresholds(vertices_y);
+
+    const unsigned int vertices_size = oriented_footprint.size();
+    std::vector<int> cells_x(vertices_size), cells_y(vertices_size);
+    for (unsigned int j = 0; j <= oriented_cells.y_thresholds.size(); j++) {
+      const double offset_y = get_range_offset(oriented_cells.y_thresholds, j);
+      for (unsigned int i = 0; i <= oriented_cells.x_thresholds.size(); i++) {
+        const double offset_x = get_range_offset(oriented_cells.x_thresholds, i);
+        for (unsigned int v = 0; v != vertices_size; v++) {
+          cells_x[v] = static_cast<int>(std::floor(offset_x + vertices_x[v]));
+          cells_y[v] = static_cast<int>(std::floor(offset_y + vertices_y[v]));
+        }
+
+        // Same edges rasterization as footprintCost, closing the polygon
+        FootprintCells footprint_cells;
+        for (unsigned int v = 0; v != vertices_size; v++) {
+          const unsigned int w = (v + 1) % vertices_size;
+          for (nav2_util::LineIterator line(cells_x[v], cells_y[v], cells_x[w], cells_y[w]);
+            line.isValid(); line.advance())
+          {
+            footprint_cells.cells.emplace_back(line.getX(), line.getY());
+          }
+        }
+
+        auto & cells = footprint_cells.cells;
+        std::sort(
+          cells.begin(), cells.end(),
+          [](const std::pair<int, int> & a, const std::pair<int, int> & b) {
+            return a.second < b.second || (a.second == b.second && a.first < b.first);
+          });
+        cells.erase(std::unique(cells.begin(), cells.end()), cells.end());
+        if (!cells.empty()) {
+          footprint_cells.min_x = footprint_cells.max_x = cells.front().first;
+          footprint_cells.min_y = footprint_cells.max_y = cells.front().second;
+        }
+        for (const auto & cell : cells) {
+          footprint_cells.min_x = std::min(footprint_cells.min_x, cell.first);
+          footprint_cells.max_x = std::max(footprint_cells.max_x, cell.first);
+          footprint_cells.min_y = std::min(footprint_cells.min_y, cell.second);
+          footprint_cells.max_y = std::max(footprint_cells.max_y, cell.second);
+        }
+        oriented_cells.cells.push_back(std::move(footprint_cells));
+      }
+    }
+
+    footprint_cells_.push_back(std::move(oriented_cells));
+  }
+
+  footprint_cells_resolution_ = resolution;
+  footprint_cells_size_x_ = 0;
+}
+
+float GridCollisionChecker::footprintCellsCost(
+  const float & x, const float & y, const unsigned int & angle_bin)
+{
+  if (footprint_cells_resolution_ != costmap_->getResolution()) {
+    computeFootprintCells();
+  }
+
+  const unsigned int size_x = costmap_->getSizeInCellsX();
+  const unsigned int size_y = costmap_->getSizeInCellsY();
+  if (footprint_cells_size_x_ != size_x) {
+    for (auto & oriented_cells : footprint_cells_) {
+      for (auto & footprint_cells : oriented_cells.cells) {
+        footprint_cells.offsets.clear();
+        for (const auto & cell : footprint_cells.cells) {
+          footprint_cells.offsets.push_back(cell.second * static_cast<int>(size_x) + cell.first);
+        }
+      }
+    }
+    footprint_cells_size_x_ = size_x;
+  }
+
+  // The footprint vertices are at the pose relative to the center of its cell
+  const OrientedFootprintCells & oriented_cells = footprint_cells_[angle_bin];
+  const double pose_x = static_cast<double>(x) + 0.5;
+  const double pose_y = static_cast<double>(y) + 0.5;
+  const int cell_x = static_cast<int>(std::floor(pose_x));
+  const int cell_y = static_cast<int>(std::floor(pose_y));
+  const unsigned int range_x = std::upper_bound(
+    oriented_cells.x_thresholds.begin(), oriented_cells.x_thresholds.end(),
+    pose_x - cell_x) - oriented_cells.x_thresholds.begin();
+  const unsigned int range_y = std::upper_bound(
+    oriented_cells.y_thresholds.begin(), oriented_cells.y_thresholds.end(),
+    pose_y - cell_y) - oriented_cells.y_thresholds.begin();
+  const FootprintCells & footprint_cells =
+    oriented_cells.cells[range_y * (oriented_cells.x_thresholds.size() + 1) + range_x];
+
+  if (footprint_cells.offsets.empty()) {
+    return 0.0f;
+  }
+
+  if (cell_x + footprint_cells.min_x < 0 || cell_y + footprint_cells.min_y < 0 ||
+    cell_x + footprint_cells.max_x >= static_cast<int>(size_x) ||
+    cell_y + footprint_cells.max_y >= static_cast<int>(size_y))
+  {
+    return OCCUPIED;
+  }
+
+  // Highest cost over blocks of cells, only looking for lethal cells in the blocks having
+  // costs that high, so the common case is branchless
+  const unsigned char * pose_cost = costmap_->getCharMap() + cell_y * size_x + cell_x;
+  const int * offsets = footprint_cells.offsets.data();
+  const size_t cells_size = footprint_cells.offsets.size();
+  unsigned char cost = 0;
+  size_t i = 0;
+  for (; i + 8 <= cells_size; i += 8) {
+    unsigned char block_cost = pose_cost[offsets[i]];
+    for (size_t j = 1; j != 8; j++) {
+      block_cost = std::max(block_cost, pose_cost[offsets[i + j]]);
+    }
+    if (block_cost >= nav2_costmap_2d::LETHAL_OBSTACLE) {
+      for (size_t j = 0; j != 8; j++) {
+        if (pose_cost[offsets[i + j]] == nav2_costmap_2d::LETHAL_OBSTACLE) {
+          return OCCUPIED;
+        }
+      }
+    }
+    cost = std::max(cost, block_cost);
+  }
+  for (; i != cells_size; i++) {
+    if (pose_cost[offsets[i]] == nav2_costmap_2d::LETHAL_OBSTACLE) {
+      return OCCUPIED;
+    }
+    cost = std::max(cost, pose_cost[offsets[i]]);
+  }
+
+  return static_cast<float>(cost);
 }
 
 bool GridCollisionChecker::inCollision(
@@ -99,15 +271,13 @@ bool GridCollisionChecker::inCollision(
 {
   // Check to make sure cell is inside the map
   if (outsideRange(costmap_->getSizeInCellsX(), x) ||
-    outsideRange(costmap_->getSizeInCellsY(), y))
+    outsideRange(costmap_->getSizeInCellsY(), y) ||
+    outsideCorridor(x, y))
   {
     return true;
   }
 
   // Assumes setFootprint already set
-  double wx, wy;
-  costmap_->mapToWorld(static_cast<double>(x), static_cast<double>(y), wx, wy);
-
   if (!footprint_is_radius_) {
     // if footprint, then we check for the footprint's points, but first see
     // if the robot is even potentially in an inscribed collision
@@ -139,19 +309,8 @@ bool GridCollisionChecker::inCollision(
     }
 
     // if possible inscribed, need to check actual footprint pose.
-    // Use precomputed oriented footprints are done on initialization,
-    // offset by translation value to collision check
-    geometry_msgs::msg::Point new_pt;
-    const nav2_costmap_2d::Footprint & oriented_footprint = oriented_footprints_[angle_bin];
-    nav2_costmap_2d::Footprint current_footprint;
-    current_footprint.reserve(oriented_footprint.size());
-    for (unsigned int i = 0; i < oriented_footprint.size(); ++i) {
-      new_pt.x = wx + oriented_footprint[i].x;
-      new_pt.y = wy + oriented_footprint[i].y;
-      current_footprint.push_back(new_pt);
-    }
-
-    footprint_cost_ = static_cast<float>(footprintCost(current_footprint));
+    // Use the cells of the footprint edges precomputed for the orientation bin
+    footprint_cost_ = footprintCellsCost(x, y, static_cast<unsigned int>(angle_bin));
 
     if (footprint_cost_ == UNKNOWN && traverse_unknown) {
       return false;
@@ -173,10 +332,48 @@ bool GridCollisionChecker::inCollision(
   }
 }
 
+bool GridCollisionChecker::inCollision(
+  const MotionPoses & poses,
+  const bool & traverse_unknown,
+  std::vector<float> & costs)
+{
+  costs.clear();
+
+  // Whatever the footprint, a pose is in collision if its center cell is
+  for (const auto & pose : poses) {
+    if (outsideRange(costmap_->getSizeInCellsX(), pose._x) ||
+      outsideRange(costmap_->getSizeInCellsY(), pose._y) ||
+      outsideCorridor(pose._x, pose._y))
+    {
+      return true;
+    }
+
+    const float cost = static_cast<float>(costmap_->getCost(
+        static_cast<unsigned int>(pose._x + 0.5f), static_cast<unsigned int>(pose._y + 0.5f)));
+    if (cost == UNKNOWN ? !traverse_unknown : cost >= INSCRIBED) {
+      return true;
+    }
+  }
+
+  costs.reserve(poses.size());
+  for (const auto & pose : poses) {
+    if (inCollision(pose._x, pose._y, pose._theta, traverse_unknown)) {
+      return true;
+    }
+    costs.push_back(getCost());
+  }
+
+  return false;
+}
+
 bool GridCollisionChecker::inCollision(
   const unsigned int & i,
   const bool & traverse_unknown)
 {
+  if (corridor_ && (i >= corridor_->size() || !(*corridor_)[i])) {
+    return true;
+  }
+
   footprint_cost_ = costmap_->getCost(i);
   if (footprint_cost_ == UNKNOWN && traverse_unknown) {
     return false;
@@ -197,4 +394,16 @@ bool GridCollisionChecker::outsideRange(const unsigned int & max, const float &
   return value < 0.0f || value > max;
 }
 
+bool GridCollisionChecker::outsideCorridor(const float & x, const float & y)
+{
+  if (!corridor_) {
+    return false;
+  }
+
+  const uint64_t index =
+    static_cast<uint64_t>(y + 0.5f) * costmap_->getSizeInCellsX() +
+    static_cast<uint64_t>(x + 0.5f);
+  return index >= corridor_->size() || !(*corridor_)[index];
+}
+
 }  // namespace nav2_smac_planner
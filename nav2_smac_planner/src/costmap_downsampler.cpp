@@ -18,6 +18,7 @@
 #include <string>
 #include <memory>
 #include <algorithm>
+#include <vector>
 
 namespace nav2_smac_planner
 {
@@ -39,13 +40,20 @@ void CostmapDownsampler::on_configure(
   const std::string & topic_name,
   nav2_costmap_2d::Costmap2D * const costmap,
   const unsigned int & downsampling_factor,
-  const bool & use_min_cost_neighbor)
+  const bool & use_min_cost_neighbor,
+  const unsigned int & num_threads)
 {
   _costmap = costmap;
   _downsampling_factor = downsampling_factor;
   _use_min_cost_neighbor = use_min_cost_neighbor;
   updateCostmapSize();
 
+  _thread_pool.reset();
+  if (num_threads > 1) {
+    // The calling thread downsamples rows as well
+    _thread_pool = std::make_unique<nav2_util::ThreadPool>(num_threads - 1);
+  }
+
   _downsampled_costmap = std::make_unique<nav2_costmap_2d::Costmap2D>(
     _downsampled_size_x, _downsampled_size_y, _downsampled_resolution,
     _costmap->getOriginX(), _costmap->getOriginY(), UNKNOWN);
@@ -91,11 +99,18 @@ nav2_costmap_2d::Costmap2D * CostmapDownsampler::downsample(
     resizeCostmap();
   }
 
-  // Assign costs
-  for (unsigned int i = 0; i < _downsampled_size_x; ++i) {
-    for (unsigned int j = 0; j < _downsampled_size_y; ++j) {
-      setCostOfCell(i, j);
-    }
+  // Assign costs, in blocks of rows for the threads
+  if (_thread_pool) {
+    const unsigned int num_blocks = 4 * (_thread_pool->size() + 1);
+    const unsigned int block_size = (_downsampled_size_y + num_blocks - 1) / num_blocks;
+    _thread_pool->parallelFor(
+      0, num_blocks, [&](size_t i) {
+        const unsigned int new_my0 = std::min(
+          static_cast<unsigned int>(i) * block_size, _downsampled_size_y);
+        setCostOfRows(new_my0, std::min(new_my0 + block_size, _downsampled_size_y));
+      });
+  } else {
+    setCostOfRows(0, _downsampled_size_y);
   }
 
   if (_downsampled_costmap_pub) {
@@ -123,32 +138,61 @@ void CostmapDownsampler::resizeCostmap()
     _costmap->getOriginY());
 }
 
-void CostmapDownsampler::setCostOfCell(
-  const unsigned int & new_mx,
-  const unsigned int & new_my)
+namespace
 {
-  unsigned int mx, my;
-  unsigned char cost = _use_min_cost_neighbor ? 255 : 0;
-  unsigned int x_offset = new_mx * _downsampling_factor;
-  unsigned int y_offset = new_my * _downsampling_factor;
-
-  for (unsigned int i = 0; i < _downsampling_factor; ++i) {
-    mx = x_offset + i;
-    if (mx >= _size_x) {
-      continue;
+
+template<typename PoolT>
+void poolRows(
+  const unsigned char * costmap, unsigned int size_x, unsigned int size_y,
+  unsigned char * downsampled_costmap, unsigned int downsampled_size_x,
+  unsigned int downsampling_factor, unsigned int new_my0, unsigned int new_myn,
+  unsigned char initial_cost, PoolT pool)
+{
+  std::vector<unsigned char> row_costs(size_x);
+  for (unsigned int new_my = new_my0; new_my < new_myn; ++new_my) {
+    // Pool the rows of the subcells, element-wise over contiguous rows
+    const unsigned int my0 = new_my * downsampling_factor;
+    const unsigned int myn = std::min(my0 + downsampling_factor, size_y);
+    std::fill(row_costs.begin(), row_costs.end(), initial_cost);
+    for (unsigned int my = my0; my < myn; ++my) {
+      const unsigned char * row = costmap + static_cast<size_t>(my) * size_x;
+      for (unsigned int mx = 0; mx < size_x; ++mx) {
+        row_costs[mx] = pool(row_costs[mx], row[mx]);
+      }
     }
-    for (unsigned int j = 0; j < _downsampling_factor; ++j) {
-      my = y_offset + j;
-      if (my >= _size_y) {
-        continue;
+
+    // Then the columns, the last cell possibly having fewer subcells
+    unsigned char * new_row =
+      downsampled_costmap + static_cast<size_t>(new_my) * downsampled_size_x;
+    for (unsigned int new_mx = 0; new_mx < downsampled_size_x; ++new_mx) {
+      const unsigned int mx0 = new_mx * downsampling_factor;
+      const unsigned int mxn = std::min(mx0 + downsampling_factor, size_x);
+      unsigned char cost = initial_cost;
+      for (unsigned int mx = mx0; mx < mxn; ++mx) {
+        cost = pool(cost, row_costs[mx]);
       }
-      cost = _use_min_cost_neighbor ?
-        std::min(cost, _costmap->getCost(mx, my)) :
-        std::max(cost, _costmap->getCost(mx, my));
+      new_row[new_mx] = cost;
     }
   }
+}
+
+}  // namespace
 
-  _downsampled_costmap->setCost(new_mx, new_my, cost);
+void CostmapDownsampler::setCostOfRows(
+  const unsigned int & new_my0,
+  const unsigned int & new_myn)
+{
+  if (_use_min_cost_neighbor) {
+    poolRows(
+      _costmap->getCharMap(), _size_x, _size_y, _downsampled_costmap->getCharMap(),
+      _downsampled_size_x, _downsampling_factor, new_my0, new_myn, 255,
+      [](unsigned char a, unsigned char b) {return std::min(a, b);});
+  } else {
+    poolRows(
+      _costmap->getCharMap(), _size_x, _size_y, _downsampled_costmap->getCharMap(),
+      _downsampled_size_x, _downsampling_factor, new_my0, new_myn, 0,
+      [](unsigned char a, unsigned char b) {return std::max(a, b);});
+  }
 }
 
 }  // namespace nav2_smac_planner
@@ -125,20 +125,21 @@ void Node2D::getNeighbors(
   // 100 100 100   where lower-middle '100' is visited with same cost by both bottom '50' nodes
   // Therefore, it is valuable to have some low-potential across the entire map
   // rather than a small inflation around the obstacles
+  // X steps of the neighbors grid offsets, to check for wrap around conditions from
+  // the X coordinate of this node only, the neighbor getter rejecting indices off the grid
+  static constexpr int x_steps[8] = {-1, +1, 0, 0, -1, +1, -1, +1};
+  const int size_x = _neighbors_grid_offsets[3];
   uint64_t index;
   NodePtr neighbor;
   uint64_t node_i = this->getIndex();
-  const Coordinates parent = getCoords(this->getIndex());
-  Coordinates child;
+  const int parent_x = static_cast<int>(node_i % size_x);
 
   for (unsigned int i = 0; i != _neighbors_grid_offsets.size(); ++i) {
-    index = node_i + _neighbors_grid_offsets[i];
-
-    // Check for wrap around conditions
-    child = getCoords(index);
-    if (fabs(parent.x - child.x) > 1 || fabs(parent.y - child.y) > 1) {
+    const int child_x = parent_x + x_steps[i];
+    if (child_x < 0 || child_x >= size_x) {
       continue;
     }
+    index = node_i + _neighbors_grid_offsets[i];
 
     if (NeighborGetter(index, neighbor)) {
       if (neighbor->isNodeValid(traverse_unknown, collision_checker) && !neighbor->wasVisited()) {
@@ -28,6 +28,7 @@
 #include "ompl/base/spaces/ReedsSheppStateSpace.h"
 
 #include "nav2_smac_planner/node_hybrid.hpp"
+#include "nav2_smac_planner/utils.hpp"
 
 using namespace std::chrono;  // NOLINT
 
@@ -44,6 +45,9 @@ std::shared_ptr<nav2_costmap_2d::Costmap2DROS> NodeHybrid::costmap_ros = nullptr
 std::shared_ptr<nav2_costmap_2d::InflationLayer> NodeHybrid::inflation_layer = nullptr;
 
 ObstacleHeuristicQueue NodeHybrid::obstacle_heuristic_queue;
+std::vector<unsigned int> NodeHybrid::obstacle_heuristic_parents;
+std::vector<unsigned char> NodeHybrid::obstacle_heuristic_costs;
+ObstacleHeuristicKey NodeHybrid::obstacle_heuristic_key;
 
 // Each of these tables are the projected motion models through
 // time and space applied to the search on the current node in
@@ -299,10 +303,10 @@ void HybridMotionTable::initReedsShepp(
   }
 }
 
-MotionPoses HybridMotionTable::getProjections(const NodeHybrid * node)
+void HybridMotionTable::getProjections(
+  const NodeHybrid * node, MotionPoses & projection_list)
 {
-  MotionPoses projection_list;
-  projection_list.reserve(projections.size());
+  projection_list.clear();
 
   for (unsigned int i = 0; i != projections.size(); i++) {
     const MotionPose & motion_model = projections[i];
@@ -324,8 +328,6 @@ MotionPoses HybridMotionTable::getProjections(const NodeHybrid * node)
       delta_ys[i][node_heading] + node->pose.y,
       new_heading, motion_model._turn_dir);
   }
-
-  return projection_list;
 }
 
 unsigned int HybridMotionTable::getClosestAngularBin(const double & theta)
@@ -477,6 +479,93 @@ inline float distanceHeuristic2D(
   return std::sqrt(dx * dx + dy * dy);
 }
 
+// Cost of an obstacle heuristic cell, the lowest of its costmap cells if downsampled,
+// false if the cell cannot be traversed
+inline bool obstacleHeuristicCellCost(
+  nav2_costmap_2d::Costmap2D * costmap, const unsigned int idx, const unsigned int size_x,
+  const bool downsample_H, const bool is_circular, float & cost)
+{
+  if (downsample_H) {
+    // Get costmap values as if downsampled
+    unsigned int y_offset = (idx / size_x) * 2;
+    unsigned int x_offset = (idx - ((idx / size_x) * size_x)) * 2;
+    cost = costmap->getCost(x_offset, y_offset);
+    for (unsigned int i = 0; i < 2u; ++i) {
+      unsigned int mxd = x_offset + i;
+      if (mxd >= costmap->getSizeInCellsX()) {
+        continue;
+      }
+      for (unsigned int j = 0; j < 2u; ++j) {
+        unsigned int myd = y_offset + j;
+        if (myd >= costmap->getSizeInCellsY()) {
+          continue;
+        }
+        if (i == 0 && j == 0) {
+          continue;
+        }
+        cost = std::min(cost, static_cast<float>(costmap->getCost(mxd, myd)));
+      }
+    }
+  } else {
+    cost = static_cast<float>(costmap->getCost(idx));
+  }
+
+  if (!is_circular) {
+    // Adjust cost value if using SE2 footprint checks
+    cost = NodeHybrid::adjustedFootprintCost(cost);
+    return cost < OCCUPIED;
+  }
+  return cost < INSCRIBED;
+}
+
+// Cost to move into an obstacle heuristic cell of a given cost
+inline float obstacleHeuristicTravelCost(
+  const bool diagonal, const float cost, const float cost_penalty, const bool quadratic)
+{
+  if (quadratic) {
+    return (diagonal ? sqrtf(2.0f) : 1.0f) *
+           (1.0f + (cost_penalty * cost * cost / 63504.0f));  // 252^2
+  }
+  return (diagonal ? sqrtf(2.0f) : 1.0f) * (1.0f + (cost_penalty * cost / 252.0f));
+}
+
+// Whether an obstacle heuristic cell is too close to the costmap edges to be expanded
+inline bool isObstacleHeuristicBorder(
+  const unsigned int idx, const unsigned int size_x, const unsigned int size_y)
+{
+  const unsigned int my = idx / size_x;
+  const unsigned int mx = idx - (my * size_x);
+  return mx >= size_x - 3 || mx <= 3 || my >= size_y - 3 || my <= 3;
+}
+
+// Key of the obstacle heuristic inputs, with the cost penalty not known yet
+inline ObstacleHeuristicKey makeObstacleHeuristicKey(
+  const std::shared_ptr<nav2_costmap_2d::Costmap2DROS> & costmap_ros,
+  const std::shared_ptr<nav2_costmap_2d::InflationLayer> & inflation_layer,
+  const bool downsample_H, const bool use_quadratic_cost_penalty,
+  const unsigned int & goal_x, const unsigned int & goal_y)
+{
+  ObstacleHeuristicKey key;
+  key.costmap = costmap_ros->getCostmap();
+  key.downsample = downsample_H;
+  key.use_quadratic_cost_penalty = use_quadratic_cost_penalty;
+  key.is_circular = costmap_ros->getUseRadius();
+  if (downsample_H) {
+    key.size_x = ceil(static_cast<float>(key.costmap->getSizeInCellsX()) / 2.0f);
+    key.size_y = ceil(static_cast<float>(key.costmap->getSizeInCellsY()) / 2.0f);
+    key.goal_index = floor(goal_y / 2.0f) * key.size_x + floor(goal_x / 2.0f);
+  } else {
+    key.size_x = key.costmap->getSizeInCellsX();
+    key.size_y = key.costmap->getSizeInCellsY();
+    key.goal_index = floor(goal_y) * key.size_x + floor(goal_x);
+  }
+  if (inflation_layer && !key.is_circular) {
+    key.cost_scaling_factor = inflation_layer->getCostScalingFactor();
+    key.inscribed_radius = costmap_ros->getLayeredCostmap()->getInscribedRadius();
+  }
+  return key;
+}
+
 void NodeHybrid::resetObstacleHeuristic(
   std::shared_ptr<nav2_costmap_2d::Costmap2DROS> costmap_ros_i,
   const unsigned int & start_x, const unsigned int & start_y,
@@ -489,18 +578,13 @@ void NodeHybrid::resetObstacleHeuristic(
   costmap_ros = costmap_ros_i;
   inflation_layer = nav2_costmap_2d::InflationLayer::getInflationLayer(costmap_ros);
   auto costmap = costmap_ros->getCostmap();
+  obstacle_heuristic_key = makeObstacleHeuristicKey(
+    costmap_ros, inflation_layer, motion_table.downsample_obstacle_heuristic,
+    motion_table.use_quadratic_cost_penalty, goal_x, goal_y);
 
   // Clear lookup table
-  unsigned int size = 0u;
-  unsigned int size_x = 0u;
-  if (motion_table.downsample_obstacle_heuristic) {
-    size_x = ceil(static_cast<float>(costmap->getSizeInCellsX()) / 2.0f);
-    size = size_x *
-      ceil(static_cast<float>(costmap->getSizeInCellsY()) / 2.0f);
-  } else {
-    size_x = costmap->getSizeInCellsX();
-    size = size_x * costmap->getSizeInCellsY();
-  }
+  const unsigned int size_x = obstacle_heuristic_key.size_x;
+  const unsigned int size = size_x * obstacle_heuristic_key.size_y;
 
   if (obstacle_heuristic_lookup_table.size() == size) {
     // must reset all values
@@ -517,14 +601,15 @@ void NodeHybrid::resetObstacleHeuristic(
 
   obstacle_heuristic_queue.clear();
   obstacle_heuristic_queue.reserve(size);
+  obstacle_heuristic_parents.assign(size, std::numeric_limits<unsigned int>::max());
+
+  // Keep the costs the heuristic is computed on, to find what changed on later plans
+  const unsigned char * charmap = costmap->getCharMap();
+  obstacle_heuristic_costs.assign(
+    charmap, charmap + costmap->getSizeInCellsX() * costmap->getSizeInCellsY());
 
   // Set initial goal point to queue from. Divided by 2 due to downsampled costmap.
-  unsigned int goal_index;
-  if (motion_table.downsample_obstacle_heuristic) {
-    goal_index = floor(goal_y / 2.0f) * size_x + floor(goal_x / 2.0f);
-  } else {
-    goal_index = floor(goal_y) * size_x + floor(goal_x);
-  }
+  const unsigned int goal_index = obstacle_heuristic_key.goal_index;
 
   obstacle_heuristic_queue.emplace_back(
     distanceHeuristic2D(goal_index, size_x, start_x, start_y), goal_index);
@@ -534,6 +619,159 @@ void NodeHybrid::resetObstacleHeuristic(
   obstacle_heuristic_lookup_table[goal_index] = -0.00001f;
 }
 
+bool NodeHybrid::repairObstacleHeuristic(
+  std::shared_ptr<nav2_costmap_2d::Costmap2DROS> costmap_ros_i,
+  const unsigned int & goal_x, const unsigned int & goal_y,
+  const float & cost_penalty)
+{
+  if (!costmap_ros_i || costmap_ros_i != costmap_ros) {
+    return false;
+  }
+
+  auto costmap = costmap_ros->getCostmap();
+  ObstacleHeuristicKey key = makeObstacleHeuristicKey(
+    costmap_ros, inflation_layer, motion_table.downsample_obstacle_heuristic,
+    motion_table.use_quadratic_cost_penalty, goal_x, goal_y);
+  key.cost_penalty = cost_penalty;
+  const unsigned int costmap_size_x = costmap->getSizeInCellsX();
+  const unsigned int costmap_size = costmap_size_x * costmap->getSizeInCellsY();
+  if (!(key == obstacle_heuristic_key) || obstacle_heuristic_costs.size() != costmap_size) {
+    return false;
+  }
+
+  const unsigned char * charmap = costmap->getCharMap();
+  if (std::equal(charmap, charmap + costmap_size, obstacle_heuristic_costs.begin())) {
+    return true;
+  }
+
+  // Find the cells whose cost rose. When costs only rise, no path got shorter and
+  // the cells whose path to the goal avoids them keep their values. Lower costs could
+  // shorten the paths of any cell, which only a new search finds.
+  const unsigned int size_x = key.size_x;
+  const unsigned int size = size_x * key.size_y;
+  const bool & downsample_H = key.downsample;
+  enum : unsigned char {UNKNOWN = 0, VALID = 1, INVALID = 2};
+  std::vector<unsigned char> states(size, UNKNOWN);
+  for (unsigned int i = 0; i != costmap_size; i++) {
+    if (charmap[i] == obstacle_heuristic_costs[i]) {
+      continue;
+    }
+    if (charmap[i] < obstacle_heuristic_costs[i]) {
+      return false;
+    }
+    const unsigned int my = i / costmap_size_x;
+    const unsigned int mx = i - my * costmap_size_x;
+    states[downsample_H ? (my / 2) * size_x + mx / 2 : i] = INVALID;
+  }
+
+  const unsigned int goal_index = key.goal_index;
+  if (states[goal_index] == INVALID) {
+    return false;
+  }
+  states[goal_index] = VALID;
+
+  // Cells reached through a changed cell are invalid, resolved once per chain of parents
+  std::vector<unsigned int> chain;
+  std::vector<unsigned int> invalidated;
+  const unsigned int no_parent = std::numeric_limits<unsigned int>::max();
+  for (unsigned int idx = 0; idx != size; idx++) {
+    if (obstacle_heuristic_lookup_table[idx] == 0.0f) {
+      continue;
+    }
+
+    chain.clear();
+    unsigned int n = idx;
+    while (states[n] == UNKNOWN && obstacle_heuristic_parents[n] != no_parent) {
+      chain.push_back(n);
+      n = obstacle_heuristic_parents[n];
+    }
+    const unsigned char state = states[n] == UNKNOWN ? INVALID : states[n];
+    for (const unsigned int & c : chain) {
+      states[c] = state;
+    }
+    if (states[idx] == UNKNOWN) {
+      states[idx] = INVALID;
+    }
+    if (states[idx] == INVALID) {
+      invalidated.push_back(idx);
+    }
+  }
+
+  for (const unsigned int & idx : invalidated) {
+    obstacle_heuristic_lookup_table[idx] = 0.0f;
+    obstacle_heuristic_parents[idx] = no_parent;
+  }
+  obstacle_heuristic_queue.erase(
+    std::remove_if(
+      obstacle_heuristic_queue.begin(), obstacle_heuristic_queue.end(),
+      [](const ObstacleHeuristicElement & n) {
+        return obstacle_heuristic_lookup_table[n.second] == 0.0f;
+      }),
+    obstacle_heuristic_queue.end());
+
+  // Open the invalidated cells again next to the valid closed ones, from where the
+  // search continues as needed. Queue priorities are set on the next query.
+  const bool is_circular = costmap_ros->getUseRadius();
+  const int size_x_int = static_cast<int>(size_x);
+  const std::vector<int> neighborhood = {1, -1,  // left right
+    size_x_int, -size_x_int,  // up down
+    size_x_int + 1, size_x_int - 1,  // upper diagonals
+    -size_x_int + 1, -size_x_int - 1};  // lower diagonals
+  float cost;
+  for (const unsigned int & idx : invalidated) {
+    if (isObstacleHeuristicBorder(idx, size_x, key.size_y) ||
+      !obstacleHeuristicCellCost(costmap, idx, size_x, downsample_H, is_circular, cost))
+    {
+      continue;
+    }
+
+    float best_cost = std::numeric_limits<float>::max();
+    unsigned int best_parent = no_parent;
+    for (unsigned int i = 0; i != neighborhood.size(); i++) {
+      const unsigned int n = static_cast<unsigned int>(static_cast<int>(idx) + neighborhood[i]);
+      if (n >= size || obstacle_heuristic_lookup_table[n] <= 0.0f) {
+        continue;
+      }
+      const float new_cost = obstacle_heuristic_lookup_table[n] + obstacleHeuristicTravelCost(
+        i > 3, cost, cost_penalty, motion_table.use_quadratic_cost_penalty);
+      if (new_cost < best_cost) {
+        best_cost = new_cost;
+        best_parent = n;
+      }
+    }
+
+    if (best_parent != no_parent) {
+      // the negative value means the cell is in the open set
+      obstacle_heuristic_lookup_table[idx] = -best_cost;
+      obstacle_heuristic_parents[idx] = best_parent;
+      obstacle_heuristic_queue.emplace_back(best_cost, idx);
+    }
+  }
+
+  std::copy(charmap, charmap + costmap_size, obstacle_heuristic_costs.begin());
+  return true;
+}
+
+void NodeHybrid::addObstacleHeuristicGoal(
+  const unsigned int & goal_x, const unsigned int & goal_y)
+{
+  const unsigned int goal_index = obstacle_heuristic_key.downsample ?
+    (goal_y / 2) * obstacle_heuristic_key.size_x + goal_x / 2 :
+    goal_y * obstacle_heuristic_key.size_x + goal_x;
+  if (goal_index >= obstacle_heuristic_lookup_table.size()) {
+    return;
+  }
+
+  // Queue priorities are set on the next query
+  if (obstacle_heuristic_lookup_table[goal_index] == 0.0f) {
+    obstacle_heuristic_lookup_table[goal_index] = -0.00001f;
+    obstacle_heuristic_queue.emplace_back(0.0f, goal_index);
+  }
+
+  // The repair only knows of the tree grown from a single goal
+  obstacle_heuristic_key.costmap = nullptr;
+}
+
 float NodeHybrid::adjustedFootprintCost(const float & cost)
 {
   if (!inflation_layer) {
@@ -587,6 +825,7 @@ float NodeHybrid::getObstacleHeuristic(
   }
 
   const unsigned int start_index = start_y * size_x + start_x;
+  obstacle_heuristic_key.cost_penalty = cost_penalty;
   const float & requested_node_cost = obstacle_heuristic_lookup_table[start_index];
   if (requested_node_cost > 0.0f) {
     // costs are doubled due to downsampling
@@ -610,9 +849,7 @@ float NodeHybrid::getObstacleHeuristic(
     ObstacleHeuristicComparator{});
 
   const int size_x_int = static_cast<int>(size_x);
-  const float sqrt2 = sqrtf(2.0f);
   float c_cost, cost, travel_cost, new_cost, existing_cost;
-  unsigned int mx, my;
   unsigned int idx, new_idx = 0;
 
   const std::vector<int> neighborhood = {1, -1,  // left right
@@ -641,65 +878,24 @@ float NodeHybrid::getObstacleHeuristic(
 
       // if neighbor path is better and non-lethal, set new cost and add to queue
       if (new_idx < size_x * size_y) {
-        if (downsample_H) {
-          // Get costmap values as if downsampled
-          unsigned int y_offset = (new_idx / size_x) * 2;
-          unsigned int x_offset = (new_idx - ((new_idx / size_x) * size_x)) * 2;
-          cost = costmap->getCost(x_offset, y_offset);
-          for (unsigned int i = 0; i < 2u; ++i) {
-            unsigned int mxd = x_offset + i;
-            if (mxd >= costmap->getSizeInCellsX()) {
-              continue;
-            }
-            for (unsigned int j = 0; j < 2u; ++j) {
-              unsigned int myd = y_offset + j;
-              if (myd >= costmap->getSizeInCellsY()) {
-                continue;
-              }
-              if (i == 0 && j == 0) {
-                continue;
-              }
-              cost = std::min(cost, static_cast<float>(costmap->getCost(mxd, myd)));
-            }
-          }
-        } else {
-          cost = static_cast<float>(costmap->getCost(new_idx));
-        }
-
-        if (!is_circular) {
-          // Adjust cost value if using SE2 footprint checks
-          cost = adjustedFootprintCost(cost);
-          if (cost >= OCCUPIED) {
-            continue;
-          }
-        } else if (cost >= INSCRIBED) {
+        if (!obstacleHeuristicCellCost(costmap, new_idx, size_x, downsample_H, is_circular, cost)) {
           continue;
         }
 
-        my = new_idx / size_x;
-        mx = new_idx - (my * size_x);
-
-        if (mx >= size_x - 3 || mx <= 3) {
-          continue;
-        }
-        if (my >= size_y - 3 || my <= 3) {
+        if (isObstacleHeuristicBorder(new_idx, size_x, size_y)) {
           continue;
         }
 
         existing_cost = obstacle_heuristic_lookup_table[new_idx];
         if (existing_cost <= 0.0f) {
-          if (motion_table.use_quadratic_cost_penalty) {
-            travel_cost =
-              (i <= 3 ? 1.0f : sqrt2) * (1.0f + (cost_penalty * cost * cost / 63504.0f));  // 252^2
-          } else {
-            travel_cost =
-              ((i <= 3) ? 1.0f : sqrt2) * (1.0f + (cost_penalty * cost / 252.0f));
-          }
+          travel_cost = obstacleHeuristicTravelCost(
+            i > 3, cost, cost_penalty, motion_table.use_quadratic_cost_penalty);
 
           new_cost = c_cost + travel_cost;
           if (existing_cost == 0.0f || -existing_cost > new_cost) {
             // the negative value means the cell is in the open set
             obstacle_heuristic_lookup_table[new_idx] = -new_cost;
+            obstacle_heuristic_parents[new_idx] = idx;
             obstacle_heuristic_queue.emplace_back(
               new_cost + distanceHeuristic2D(new_idx, size_x, start_x, start_y), new_idx);
             std::push_heap(
@@ -841,6 +1037,19 @@ void NodeHybrid::precomputeDistanceHeuristic(
   // around the X axis any relative node lookup. This reduces memory overhead and increases
   // the size of a window a platform can store in memory.
   dist_heuristic_lookup_table.resize(size_lookup * ceil(size_lookup / 2.0) * dim_3_size_int);
+
+  // Computing the table takes seconds on large windows, so it may be cached on disk
+  std::string cache_filepath;
+  const std::vector<float> cache_key = {static_cast<float>(motion_model),
+    search_info.minimum_turning_radius, lookup_table_dim, static_cast<float>(dim_3_size)};
+  if (!search_info.distance_heuristic_cache_directory.empty()) {
+    cache_filepath = getDistanceHeuristicCachePath(
+      search_info.distance_heuristic_cache_directory, "hybrid", cache_key);
+    if (loadDistanceHeuristicCache(cache_filepath, cache_key, dist_heuristic_lookup_table)) {
+      return;
+    }
+  }
+
   for (float x = ceil(-size_lookup / 2.0); x <= floor(size_lookup / 2.0); x += 1.0) {
     for (float y = 0.0; y <= floor(size_lookup / 2.0); y += 1.0) {
       for (int heading = 0; heading != dim_3_size_int; heading++) {
@@ -853,6 +1062,10 @@ void NodeHybrid::precomputeDistanceHeuristic(
       }
     }
   }
+
+  if (!cache_filepath.empty()) {
+    saveDistanceHeuristicCache(cache_filepath, cache_key, dist_heuristic_lookup_table);
+  }
 }
 
 void NodeHybrid::getNeighbors(
@@ -865,7 +1078,9 @@ void NodeHybrid::getNeighbors(
   uint64_t index = 0;
   NodePtr neighbor = nullptr;
   Coordinates initial_node_coords;
-  const MotionPoses motion_projections = motion_table.getProjections(this);
+  // Reused across expansions so that they do not allocate
+  static thread_local MotionPoses motion_projections;
+  motion_table.getProjections(this, motion_projections);
 
   for (unsigned int i = 0; i != motion_projections.size(); i++) {
     index = NodeHybrid::getIndex(
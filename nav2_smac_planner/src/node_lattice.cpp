@@ -92,10 +92,32 @@ void LatticeMotionTable::initMotionModel(
   float prev_start_angle = 0.0;
   std::vector<MotionPrimitive> primitives;
   nlohmann::json json_primitives = json["primitives"];
+  const float & grid_resolution = lattice_metadata.grid_resolution;
+  const float resolution_diag_sq = 2.0 * grid_resolution * grid_resolution;
   for (unsigned int i = 0; i < json_primitives.size(); ++i) {
     MotionPrimitive new_primitive;
     fromJsonToMotionPrimitive(json_primitives[i], new_primitive);
 
+    // Precompute the intermediary poses to check, > 1 cell apart
+    const MotionPose & end_pose = new_primitive.poses.back();
+    MotionPose last_pose(1e9, 1e9, 1e9, TurnDirection::UNKNOWN);
+    MotionPose pose_dist(0.0, 0.0, 0.0, TurnDirection::UNKNOWN);
+    for (auto it = new_primitive.poses.begin(); it != new_primitive.poses.end(); ++it) {
+      // poses are in metric coordinates from (0, 0), not grid space yet
+      pose_dist = *it - last_pose;
+      // Avoid square roots by (hypot(x, y) > res) == (x*x+y*y > diag*diag)
+      if (pose_dist._x * pose_dist._x + pose_dist._y * pose_dist._y > resolution_diag_sq) {
+        last_pose = *it;
+        const float x = (it->_x - end_pose._x) / grid_resolution;
+        const float y = (it->_y - end_pose._y) / grid_resolution;
+        new_primitive.collision_poses.emplace_back(x, y, it->_theta, TurnDirection::UNKNOWN);
+        // If reversing, invert the angle because the robot is backing into the primitive
+        // not driving forward with it
+        new_primitive.reverse_collision_poses.emplace_back(
+          x, y, std::fmod(it->_theta + M_PI, 2.0 * M_PI), TurnDirection::UNKNOWN);
+      }
+    }
+
     if (prev_start_angle != new_primitive.start_angle) {
       motion_primitives.push_back(primitives);
       primitives.clear();
@@ -220,58 +242,38 @@ bool NodeLattice::isNodeValid(
   // Convert grid quantization of primitives to radians, then collision checker quantization
   static const double bin_size = 2.0 * M_PI / collision_checker->getPrecomputedAngles().size();
   const double & angle = motion_table.getAngleFromBin(this->pose.theta) / bin_size;
-  if (collision_checker->inCollision(
-      this->pose.x, this->pose.y, angle /*bin in collision checker*/, traverse_unknown))
-  {
-    return false;
-  }
-
-  // Set the cost of a node to the highest cost across the primitive
-  float max_cell_cost = collision_checker->getCost();
-
-  // If valid motion primitives are set, check intermediary poses > 1 cell apart
-  if (motion_primitive) {
-    const float & grid_resolution = motion_table.lattice_metadata.grid_resolution;
-    const float & resolution_diag_sq = 2.0 * grid_resolution * grid_resolution;
-    MotionPose last_pose(1e9, 1e9, 1e9, TurnDirection::UNKNOWN);
-    MotionPose pose_dist(0.0, 0.0, 0.0, TurnDirection::UNKNOWN);
+  if (!motion_primitive) {
+    if (collision_checker->inCollision(
+        this->pose.x, this->pose.y, angle /*bin in collision checker*/, traverse_unknown))
+    {
+      return false;
+    }
 
-    // Back out the initial node starting point to move motion primitive relative to
-    MotionPose initial_pose, prim_pose;
-    initial_pose._x = this->pose.x - (motion_primitive->poses.back()._x / grid_resolution);
-    initial_pose._y = this->pose.y - (motion_primitive->poses.back()._y / grid_resolution);
-    initial_pose._theta = motion_table.getAngleFromBin(motion_primitive->start_angle);
+    _cell_cost = collision_checker->getCost();
+    return true;
+  }
 
-    for (auto it = motion_primitive->poses.begin(); it != motion_primitive->poses.end(); ++it) {
-      // poses are in metric coordinates from (0, 0), not grid space yet
-      pose_dist = *it - last_pose;
-      // Avoid square roots by (hypot(x, y) > res) == (x*x+y*y > diag*diag)
-      if (pose_dist._x * pose_dist._x + pose_dist._y * pose_dist._y > resolution_diag_sq) {
-        last_pose = *it;
-        // Convert primitive pose into grid space if it should be checked
-        prim_pose._x = initial_pose._x + (it->_x / grid_resolution);
-        prim_pose._y = initial_pose._y + (it->_y / grid_resolution);
-        // If reversing, invert the angle because the robot is backing into the primitive
-        // not driving forward with it
-        if (is_backwards) {
-          prim_pose._theta = std::fmod(it->_theta + M_PI, 2.0 * M_PI);
-        } else {
-          prim_pose._theta = it->_theta;
-        }
-        if (collision_checker->inCollision(
-            prim_pose._x,
-            prim_pose._y,
-            prim_pose._theta / bin_size /*bin in collision checker*/,
-            traverse_unknown))
-        {
-          return false;
-        }
-        max_cell_cost = std::max(max_cell_cost, collision_checker->getCost());
-      }
-    }
+  // If valid motion primitives are set, check the end pose and the precomputed
+  // intermediary poses at once, the cells of all their centers being checked first
+  static thread_local MotionPoses poses;
+  static thread_local std::vector<float> costs;
+  const MotionPoses & primitive_poses =
+    is_backwards ? motion_primitive->reverse_collision_poses : motion_primitive->collision_poses;
+  poses.clear();
+  poses.emplace_back(this->pose.x, this->pose.y, angle, TurnDirection::UNKNOWN);
+  for (const MotionPose & primitive_pose : primitive_poses) {
+    poses.emplace_back(
+      this->pose.x + primitive_pose._x,
+      this->pose.y + primitive_pose._y,
+      primitive_pose._theta / bin_size /*bin in collision checker*/,
+      TurnDirection::UNKNOWN);
+  }
+  if (collision_checker->inCollision(poses, traverse_unknown, costs)) {
+    return false;
   }
 
-  _cell_cost = max_cell_cost;
+  // Set the cost of a node to the highest cost across the primitive
+  _cell_cost = *std::max_element(costs.begin(), costs.end());
   return true;
 }
 
@@ -454,6 +456,23 @@ void NodeLattice::precomputeDistanceHeuristic(
   // around the X axis any relative node lookup. This reduces memory overhead and increases
   // the size of a window a platform can store in memory.
   dist_heuristic_lookup_table.resize(size_lookup * ceil(size_lookup / 2.0) * dim_3_size_int);
+
+  // Computing the table takes seconds on large windows, so it may be cached on disk.
+  // Lattice headings are not uniform, so they are part of the key
+  std::string cache_filepath;
+  std::vector<float> cache_key = {static_cast<float>(motion_table.motion_model),
+    search_info.minimum_turning_radius, lookup_table_dim, static_cast<float>(dim_3_size)};
+  for (int heading = 0; heading != dim_3_size_int; heading++) {
+    cache_key.push_back(motion_table.getAngleFromBin(heading));
+  }
+  if (!search_info.distance_heuristic_cache_directory.empty()) {
+    cache_filepath = getDistanceHeuristicCachePath(
+      search_info.distance_heuristic_cache_directory, "lattice", cache_key);
+    if (loadDistanceHeuristicCache(cache_filepath, cache_key, dist_heuristic_lookup_table)) {
+      return;
+    }
+  }
+
   for (float x = ceil(-size_lookup / 2.0); x <= floor(size_lookup / 2.0); x += 1.0) {
     for (float y = 0.0; y <= floor(size_lookup / 2.0); y += 1.0) {
       for (int heading = 0; heading != dim_3_size_int; heading++) {
@@ -466,6 +485,10 @@ void NodeLattice::precomputeDistanceHeuristic(
       }
     }
   }
+
+  if (!cache_filepath.empty()) {
+    saveDistanceHeuristicCache(cache_filepath, cache_key, dist_heuristic_lookup_table);
+  }
 }
 
 void NodeLattice::getNeighbors(
@@ -0,0 +1,206 @@
+// Copyright (c) 2024 Open Navigation LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <functional>
+#include <limits>
+#include <queue>
+#include <stdexcept>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "nav2_smac_planner/route_graph.hpp"
+#include "nlohmann/json.hpp"
+
+namespace nav2_smac_planner
+{
+
+namespace
+{
+
+RouteMetadata fromJsonToMetadata(const nlohmann::json & json)
+{
+  RouteMetadata metadata;
+  if (json.contains("metadata")) {
+    for (const auto & item : json.at("metadata").items()) {
+      metadata[item.key()] =
+        item.value().is_string() ? item.value().get<std::string>() : item.value().dump();
+    }
+  }
+  return metadata;
+}
+
+}  // namespace
+
+void RouteGraph::load(const std::string & filepath)
+{
+  std::ifstream graph_file(filepath);
+  if (!graph_file.is_open()) {
+    throw std::runtime_error("Could not open route graph file " + filepath);
+  }
+
+  std::vector<RouteNode> nodes;
+  try {
+    nlohmann::json json;
+    graph_file >> json;
+
+    std::unordered_map<unsigned int, unsigned int> indices;
+    for (const auto & json_node : json.at("nodes")) {
+      RouteNode node;
+      json_node.at("id").get_to(node.id);
+      json_node.at("x").get_to(node.x);
+      json_node.at("y").get_to(node.y);
+      node.metadata = fromJsonToMetadata(json_node);
+      if (!indices.emplace(node.id, static_cast<unsigned int>(nodes.size())).second) {
+        throw std::runtime_error("duplicate node " + std::to_string(node.id));
+      }
+      nodes.push_back(std::move(node));
+    }
+
+    auto index_of = [&](const nlohmann::json & id) {
+        auto it = indices.find(id.get<unsigned int>());
+        if (it == indices.end()) {
+          throw std::runtime_error("edge to unknown node " + id.dump());
+        }
+        return it->second;
+      };
+
+    if (json.contains("edges")) {
+      for (const auto & json_edge : json.at("edges")) {
+        const unsigned int start = index_of(json_edge.at("start"));
+        RouteEdge edge;
+        edge.end = index_of(json_edge.at("end"));
+        edge.cost = json_edge.contains("cost") ?
+          json_edge.at("cost").get<float>() :
+          static_cast<float>(
+          std::hypot(nodes[edge.end].x - nodes[start].x, nodes[edge.end].y - nodes[start].y));
+        if (edge.cost < 0.0f) {
+          throw std::runtime_error("negative edge cost");
+        }
+        edge.metadata = fromJsonToMetadata(json_edge);
+
+        if (json_edge.value("bidirectional", true)) {
+          RouteEdge reverse = edge;
+          reverse.end = start;
+          nodes[edge.end].edges.push_back(std::move(reverse));
+        }
+        nodes[start].edges.push_back(std::move(edge));
+      }
+    }
+  } catch (const nlohmann::json::exception & e) {
+    throw std::runtime_error("Invalid route graph file " + filepath + ": " + e.what());
+  } catch (const std::runtime_error & e) {
+    throw std::runtime_error("Invalid route graph file " + filepath + ": " + e.what());
+  }
+
+  _nodes = std::move(nodes);
+}
+
+std::vector<RouteConnection> RouteGraph::getNodesWithin(
+  const double & x, const double & y, const double & radius,
+  const unsigned int & max_nodes) const
+{
+  std::vector<RouteConnection> connections;
+  const double radius_sq = radius * radius;
+  for (unsigned int i = 0; i != _nodes.size(); i++) {
+    const double dx = _nodes[i].x - x;
+    const double dy = _nodes[i].y - y;
+    if (dx * dx + dy * dy <= radius_sq) {
+      connections.push_back({i, static_cast<float>(std::hypot(dx, dy))});
+    }
+  }
+
+  auto by_cost = [](const RouteConnection & a, const RouteConnection & b) {
+      return a.cost < b.cost;
+    };
+  if (connections.size() > max_nodes) {
+    std::partial_sort(
+      connections.begin(), connections.begin() + max_nodes, connections.end(), by_cost);
+    connections.resize(max_nodes);
+  } else {
+    std::sort(connections.begin(), connections.end(), by_cost);
+  }
+  return connections;
+}
+
+bool RouteGraph::findRoute(
+  const std::vector<RouteConnection> & starts,
+  const std::vector<RouteConnection> & goals,
+  std::vector<unsigned int> & route) const
+{
+  route.clear();
+  constexpr float inf = std::numeric_limits<float>::max();
+  constexpr unsigned int none = std::numeric_limits<unsigned int>::max();
+  std::vector<float> costs(_nodes.size(), inf);
+  std::vector<unsigned int> parents(_nodes.size(), none);
+  std::unordered_map<unsigned int, float> goal_costs;
+  for (const auto & goal : goals) {
+    auto it = goal_costs.emplace(goal.node, goal.cost).first;
+    it->second = std::min(it->second, goal.cost);
+  }
+
+  // Dijkstra from all the starts, ending at the goal connection of least total cost
+  typedef std::pair<float, unsigned int> QueueEntry;
+  std::priority_queue<QueueEntry, std::vector<QueueEntry>, std::greater<QueueEntry>> queue;
+  for (const auto & start : starts) {
+    if (start.cost < costs[start.node]) {
+      costs[start.node] = start.cost;
+      queue.emplace(start.cost, start.node);
+    }
+  }
+
+  float best_cost = inf;
+  unsigned int best_goal = none;
+  while (!queue.empty()) {
+    const auto [cost, index] = queue.top();
+    queue.pop();
+    if (cost > costs[index]) {
+      continue;
+    }
+    if (cost >= best_cost) {
+      break;
+    }
+
+    auto goal = goal_costs.find(index);
+    if (goal != goal_costs.end() && cost + goal->second < best_cost) {
+      best_cost = cost + goal->second;
+      best_goal = index;
+    }
+
+    for (const auto & edge : _nodes[index].edges) {
+      const float new_cost = cost + edge.cost;
+      if (new_cost < costs[edge.end]) {
+        costs[edge.end] = new_cost;
+        parents[edge.end] = index;
+        queue.emplace(new_cost, edge.end);
+      }
+    }
+  }
+
+  if (best_goal == none) {
+    return false;
+  }
+
+  for (unsigned int index = best_goal; index != none; index = parents[index]) {
+    route.push_back(index);
+  }
+  std::reverse(route.begin(), route.end());
+  return true;
+}
+
+}  // namespace nav2_smac_planner
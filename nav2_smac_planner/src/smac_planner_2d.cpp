@@ -70,6 +70,9 @@ void SmacPlanner2D::configure(
   nav2_util::declare_parameter_if_not_declared(
     node, name + ".downsampling_factor", rclcpp::ParameterValue(1));
   node->get_parameter(name + ".downsampling_factor", _downsampling_factor);
+  nav2_util::declare_parameter_if_not_declared(
+    node, name + ".downsampling_threads", rclcpp::ParameterValue(1));
+  node->get_parameter(name + ".downsampling_threads", _downsampling_threads);
   nav2_util::declare_parameter_if_not_declared(
     node, name + ".cost_travel_multiplier", rclcpp::ParameterValue(1.0));
   node->get_parameter(name + ".cost_travel_multiplier", _search_info.cost_penalty);
@@ -90,6 +93,13 @@ void SmacPlanner2D::configure(
     node, name + ".use_final_approach_orientation", rclcpp::ParameterValue(false));
   node->get_parameter(name + ".use_final_approach_orientation", _use_final_approach_orientation);
 
+  nav2_util::declare_parameter_if_not_declared(
+    node, name + ".bidirectional_search", rclcpp::ParameterValue(false));
+  node->get_parameter(name + ".bidirectional_search", _search_info.bidirectional_search);
+  nav2_util::declare_parameter_if_not_declared(
+    node, name + ".use_bucket_queue", rclcpp::ParameterValue(false));
+  node->get_parameter(name + ".use_bucket_queue", _search_info.use_bucket_queue);
+
   nav2_util::declare_parameter_if_not_declared(
     node, name + ".max_planning_time", rclcpp::ParameterValue(2.0));
   node->get_parameter(name + ".max_planning_time", _max_planning_time);
@@ -140,7 +150,8 @@ void SmacPlanner2D::configure(
     std::string topic_name = "downsampled_costmap";
     _costmap_downsampler = std::make_unique<CostmapDownsampler>();
     _costmap_downsampler->on_configure(
-      node, _global_frame, topic_name, _costmap, _downsampling_factor);
+      node, _global_frame, topic_name, _costmap, _downsampling_factor, false,
+      static_cast<unsigned int>(std::max(_downsampling_threads, 1)));
   }
 
   _raw_plan_publisher = node->create_publisher<nav_msgs::msg::Path>("unsmoothed_plan", 1);
@@ -369,11 +380,20 @@ SmacPlanner2D::dynamicParametersCallback(std::vector<rclcpp::Parameter> paramete
         _allow_unknown = parameter.as_bool();
       } else if (name == _name + ".use_final_approach_orientation") {
         _use_final_approach_orientation = parameter.as_bool();
+      } else if (name == _name + ".bidirectional_search") {
+        reinit_a_star = true;
+        _search_info.bidirectional_search = parameter.as_bool();
+      } else if (name == _name + ".use_bucket_queue") {
+        reinit_a_star = true;
+        _search_info.use_bucket_queue = parameter.as_bool();
       }
     } else if (type == ParameterType::PARAMETER_INTEGER) {
       if (name == _name + ".downsampling_factor") {
         reinit_downsampler = true;
         _downsampling_factor = parameter.as_int();
+      } else if (name == _name + ".downsampling_threads") {
+        reinit_downsampler = true;
+        _downsampling_threads = parameter.as_int();
       } else if (name == _name + ".max_iterations") {
         reinit_a_star = true;
         _max_iterations = parameter.as_int();
@@ -421,7 +441,8 @@ SmacPlanner2D::dynamicParametersCallback(std::vector<rclcpp::Parameter> paramete
         std::string topic_name = "downsampled_costmap";
         _costmap_downsampler = std::make_unique<CostmapDownsampler>();
         _costmap_downsampler->on_configure(
-          node, _global_frame, topic_name, _costmap, _downsampling_factor);
+          node, _global_frame, topic_name, _costmap, _downsampling_factor, false,
+          static_cast<unsigned int>(std::max(_downsampling_threads, 1)));
       }
     }
   }
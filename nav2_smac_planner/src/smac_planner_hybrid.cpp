@@ -37,7 +37,10 @@ SmacPlannerHybrid::SmacPlannerHybrid()
   _smoother(nullptr),
   _costmap(nullptr),
   _costmap_ros(nullptr),
-  _costmap_downsampler(nullptr)
+  _costmap_downsampler(nullptr),
+  _corridor_a_star(nullptr),
+  _corridor_collision_checker(nullptr, 1, nullptr),
+  _corridor_downsampler(nullptr)
 {
 }
 
@@ -75,6 +78,9 @@ void SmacPlannerHybrid::configure(
   nav2_util::declare_parameter_if_not_declared(
     node, name + ".downsampling_factor", rclcpp::ParameterValue(1));
   node->get_parameter(name + ".downsampling_factor", _downsampling_factor);
+  nav2_util::declare_parameter_if_not_declared(
+    node, name + ".downsampling_threads", rclcpp::ParameterValue(1));
+  node->get_parameter(name + ".downsampling_threads", _downsampling_threads);
 
   nav2_util::declare_parameter_if_not_declared(
     node, name + ".angle_quantization_bins", rclcpp::ParameterValue(72));
@@ -156,9 +162,39 @@ void SmacPlannerHybrid::configure(
   nav2_util::declare_parameter_if_not_declared(
     node, name + ".max_planning_time", rclcpp::ParameterValue(5.0));
   node->get_parameter(name + ".max_planning_time", _max_planning_time);
+  nav2_util::declare_parameter_if_not_declared(
+    node, name + ".anytime_search", rclcpp::ParameterValue(false));
+  node->get_parameter(name + ".anytime_search", _search_info.anytime_search);
+  nav2_util::declare_parameter_if_not_declared(
+    node, name + ".anytime_initial_heuristic_weight", rclcpp::ParameterValue(3.0));
+  node->get_parameter(
+    name + ".anytime_initial_heuristic_weight", _search_info.anytime_initial_heuristic_weight);
+  nav2_util::declare_parameter_if_not_declared(
+    node, name + ".anytime_heuristic_weight_step", rclcpp::ParameterValue(0.5));
+  node->get_parameter(
+    name + ".anytime_heuristic_weight_step", _search_info.anytime_heuristic_weight_step);
+  nav2_util::declare_parameter_if_not_declared(
+    node, name + ".anytime_max_improvement_time", rclcpp::ParameterValue(0.1));
+  node->get_parameter(
+    name + ".anytime_max_improvement_time", _search_info.anytime_max_improvement_time);
   nav2_util::declare_parameter_if_not_declared(
     node, name + ".lookup_table_size", rclcpp::ParameterValue(20.0));
   node->get_parameter(name + ".lookup_table_size", _lookup_table_size);
+  nav2_util::declare_parameter_if_not_declared(
+    node, name + ".distance_heuristic_cache_directory", rclcpp::ParameterValue(std::string("")));
+  node->get_parameter(
+    name + ".distance_heuristic_cache_directory",
+    _search_info.distance_heuristic_cache_directory);
+
+  nav2_util::declare_parameter_if_not_declared(
+    node, name + ".corridor_search", rclcpp::ParameterValue(false));
+  node->get_parameter(name + ".corridor_search", _corridor_search);
+  nav2_util::declare_parameter_if_not_declared(
+    node, name + ".corridor_downsampling_factor", rclcpp::ParameterValue(4));
+  node->get_parameter(name + ".corridor_downsampling_factor", _corridor_downsampling_factor);
+  nav2_util::declare_parameter_if_not_declared(
+    node, name + ".corridor_width", rclcpp::ParameterValue(2.0));
+  node->get_parameter(name + ".corridor_width", _corridor_width);
 
   nav2_util::declare_parameter_if_not_declared(
     node, name + ".debug_visualizations", rclcpp::ParameterValue(false));
@@ -249,7 +285,32 @@ void SmacPlannerHybrid::configure(
     _costmap_downsampler = std::make_unique<CostmapDownsampler>();
     std::string topic_name = "downsampled_costmap";
     _costmap_downsampler->on_configure(
-      node, _global_frame, topic_name, _costmap, _downsampling_factor);
+      node, _global_frame, topic_name, _costmap, _downsampling_factor, false,
+      static_cast<unsigned int>(std::max(_downsampling_threads, 1)));
+  }
+
+  // Initialize the coarse 2D search of the corridor, on an optimistic costmap so that
+  // narrow passages of the full costmap are not closed
+  if (_corridor_search) {
+    SearchInfo corridor_info;
+    corridor_info.cost_penalty = _search_info.cost_penalty;
+    _corridor_a_star =
+      std::make_unique<AStarAlgorithm<Node2D>>(MotionModel::TWOD, corridor_info);
+    _corridor_a_star->initialize(
+      _allow_unknown,
+      _max_iterations,
+      std::numeric_limits<int>::max(),
+      _terminal_checking_interval,
+      _max_planning_time,
+      0.0 /*unused for 2D*/,
+      1.0 /*unused for 2D*/);
+    _corridor_collision_checker = GridCollisionChecker(_costmap_ros, 1, node);
+    _corridor_collision_checker.setFootprint(_costmap_ros->getRobotFootprint(), true, 0.0);
+    _corridor_downsampler = std::make_unique<CostmapDownsampler>();
+    _corridor_downsampler->on_configure(
+      node, _global_frame, "corridor_costmap", _costmap,
+      static_cast<unsigned int>(std::max(_corridor_downsampling_factor, 1)), true,
+      static_cast<unsigned int>(std::max(_downsampling_threads, 1)));
   }
 
   _raw_plan_publisher = node->create_publisher<nav_msgs::msg::Path>("unsmoothed_plan", 1);
@@ -282,6 +343,9 @@ void SmacPlannerHybrid::activate()
   if (_costmap_downsampler) {
     _costmap_downsampler->on_activate();
   }
+  if (_corridor_downsampler) {
+    _corridor_downsampler->on_activate();
+  }
   auto node = _node.lock();
   // Add callback for dynamic parameters
   _dyn_params_handler = node->add_on_set_parameters_callback(
@@ -311,6 +375,9 @@ void SmacPlannerHybrid::deactivate()
   if (_costmap_downsampler) {
     _costmap_downsampler->on_deactivate();
   }
+  if (_corridor_downsampler) {
+    _corridor_downsampler->on_deactivate();
+  }
   _dyn_params_handler.reset();
 }
 
@@ -326,6 +393,11 @@ void SmacPlannerHybrid::cleanup()
     _costmap_downsampler->on_cleanup();
     _costmap_downsampler.reset();
   }
+  _corridor_a_star.reset();
+  if (_corridor_downsampler) {
+    _corridor_downsampler->on_cleanup();
+    _corridor_downsampler.reset();
+  }
   _raw_plan_publisher.reset();
   _expansions_publisher.reset();
   _planned_footprints_publisher.reset();
@@ -391,6 +463,11 @@ nav_msgs::msg::Path SmacPlannerHybrid::createPlan(
   orientation_bin_id = static_cast<unsigned int>(floor(orientation_bin));
   _a_star->setGoal(mx, my, orientation_bin_id);
 
+  // Restrict the search to the corridor of a coarse 2D path, if found
+  const bool use_corridor =
+    _corridor_a_star && buildCorridor(start, goal, costmap, cancel_checker);
+  _collision_checker.setCorridor(use_corridor ? &_corridor : nullptr);
+
   // Setup message
   nav_msgs::msg::Path plan;
   plan.header.stamp = _clock->now();
@@ -412,10 +489,27 @@ nav_msgs::msg::Path SmacPlannerHybrid::createPlan(
     expansions = std::make_unique<std::vector<std::tuple<float, float, float>>>();
   }
   // Note: All exceptions thrown are handled by the planner server and returned to the action
-  if (!_a_star->createPath(
+  bool found = _a_star->createPath(
+    path, num_iterations,
+    _tolerance / static_cast<float>(costmap->getResolution()), cancel_checker, expansions.get());
+  if (!found && use_corridor) {
+    // The coarse path may not be drivable, fall back to a search of the whole costmap
+    RCLCPP_DEBUG(_logger, "No path found in the corridor, searching the whole costmap.");
+    _collision_checker.setCorridor(nullptr);
+    _a_star->resetSearch();
+    path.clear();
+    num_iterations = 0;
+    if (expansions) {
+      expansions->clear();
+    }
+    found = _a_star->createPath(
       path, num_iterations,
-      _tolerance / static_cast<float>(costmap->getResolution()), cancel_checker, expansions.get()))
-  {
+      _tolerance / static_cast<float>(costmap->getResolution()), cancel_checker,
+      expansions.get());
+  }
+  _collision_checker.setCorridor(nullptr);
+
+  if (!found) {
     if (_debug_visualizations) {
       geometry_msgs::msg::PoseArray msg;
       geometry_msgs::msg::Pose msg_pose;
@@ -512,6 +606,84 @@ nav_msgs::msg::Path SmacPlannerHybrid::createPlan(
   return plan;
 }
 
+bool SmacPlannerHybrid::buildCorridor(
+  const geometry_msgs::msg::PoseStamped & start,
+  const geometry_msgs::msg::PoseStamped & goal,
+  nav2_costmap_2d::Costmap2D * costmap,
+  std::function<bool()> cancel_checker)
+{
+  nav2_costmap_2d::Costmap2D * coarse = _corridor_downsampler->downsample(
+    static_cast<unsigned int>(std::max(_corridor_downsampling_factor, 1)));
+  const unsigned int coarse_x = coarse->getSizeInCellsX();
+  const unsigned int coarse_y = coarse->getSizeInCellsY();
+  float start_x, start_y, goal_x, goal_y;
+  if (!coarse->worldToMapContinuous(
+      start.pose.position.x, start.pose.position.y, start_x, start_y) ||
+    !coarse->worldToMapContinuous(goal.pose.position.x, goal.pose.position.y, goal_x, goal_y))
+  {
+    return false;
+  }
+
+  Node2D::CoordinateVector path;
+  int num_iterations = 0;
+  _corridor_collision_checker.setCostmap(coarse);
+  _corridor_a_star->setCollisionChecker(&_corridor_collision_checker);
+  try {
+    _corridor_a_star->setStart(start_x, start_y, 0);
+    _corridor_a_star->setGoal(goal_x, goal_y, 0);
+    if (!_corridor_a_star->createPath(
+        path, num_iterations,
+        _tolerance / static_cast<float>(coarse->getResolution()), cancel_checker))
+    {
+      return false;
+    }
+  } catch (const nav2_core::PlannerCancelled &) {
+    throw;
+  } catch (const std::exception & e) {
+    // The full search reports the failures of its own
+    RCLCPP_DEBUG(_logger, "No corridor found: %s", e.what());
+    return false;
+  }
+  path.push_back({start_x, start_y});
+  path.push_back({goal_x, goal_y});
+
+  // Mark the coarse cells within the corridor width of the path
+  std::vector<unsigned char> coarse_corridor(coarse_x * coarse_y, 0);
+  const int radius = static_cast<int>(std::ceil(_corridor_width / coarse->getResolution()));
+  const int max_x = static_cast<int>(coarse_x) - 1;
+  const int max_y = static_cast<int>(coarse_y) - 1;
+  for (const auto & coord : path) {
+    const int cx = static_cast<int>(coord.x);
+    const int cy = static_cast<int>(coord.y);
+    for (int y = std::max(cy - radius, 0); y <= std::min(cy + radius, max_y); y++) {
+      for (int x = std::max(cx - radius, 0); x <= std::min(cx + radius, max_x); x++) {
+        if ((x - cx) * (x - cx) + (y - cy) * (y - cy) <= radius * radius) {
+          coarse_corridor[y * coarse_x + x] = 1;
+        }
+      }
+    }
+  }
+
+  // Both costmaps share their origin, map each cell of the search to its coarse cell
+  const unsigned int size_x = costmap->getSizeInCellsX();
+  const unsigned int size_y = costmap->getSizeInCellsY();
+  const double ratio = costmap->getResolution() / coarse->getResolution();
+  std::vector<unsigned int> coarse_columns(size_x);
+  for (unsigned int x = 0; x < size_x; x++) {
+    coarse_columns[x] = std::min(static_cast<unsigned int>((x + 0.5) * ratio), coarse_x - 1);
+  }
+  _corridor.resize(size_x * size_y);
+  for (unsigned int y = 0; y < size_y; y++) {
+    const unsigned char * coarse_row = &coarse_corridor[
+      std::min(static_cast<unsigned int>((y + 0.5) * ratio), coarse_y - 1) * coarse_x];
+    unsigned char * row = &_corridor[y * size_x];
+    for (unsigned int x = 0; x < size_x; x++) {
+      row[x] = coarse_row[coarse_columns[x]];
+    }
+  }
+  return true;
+}
+
 rcl_interfaces::msg::SetParametersResult
 SmacPlannerHybrid::dynamicParametersCallback(std::vector<rclcpp::Parameter> parameters)
 {
@@ -571,6 +743,17 @@ SmacPlannerHybrid::dynamicParametersCallback(std::vector<rclcpp::Parameter> para
       } else if (name == _name + ".analytic_expansion_max_cost") {
         reinit_a_star = true;
         _search_info.analytic_expansion_max_cost = static_cast<float>(parameter.as_double());
+      } else if (name == _name + ".anytime_initial_heuristic_weight") {
+        reinit_a_star = true;
+        _search_info.anytime_initial_heuristic_weight = static_cast<float>(parameter.as_double());
+      } else if (name == _name + ".anytime_heuristic_weight_step") {
+        reinit_a_star = true;
+        _search_info.anytime_heuristic_weight_step = static_cast<float>(parameter.as_double());
+      } else if (name == _name + ".corridor_width") {
+        _corridor_width = parameter.as_double();
+      } else if (name == _name + ".anytime_max_improvement_time") {
+        reinit_a_star = true;
+        _search_info.anytime_max_improvement_time = static_cast<float>(parameter.as_double());
       } else if (name == "resolution") {
         // Special case: When the costmap's resolution changes, need to reinitialize
         // the controller to have new resolution information
@@ -602,12 +785,18 @@ SmacPlannerHybrid::dynamicParametersCallback(std::vector<rclcpp::Parameter> para
       } else if (name == _name + ".analytic_expansion_max_cost_override") {
         _search_info.analytic_expansion_max_cost_override = parameter.as_bool();
         reinit_a_star = true;
+      } else if (name == _name + ".anytime_search") {
+        reinit_a_star = true;
+        _search_info.anytime_search = parameter.as_bool();
       }
     } else if (type == ParameterType::PARAMETER_INTEGER) {
       if (name == _name + ".downsampling_factor") {
         reinit_a_star = true;
         reinit_downsampler = true;
         _downsampling_factor = parameter.as_int();
+      } else if (name == _name + ".downsampling_threads") {
+        reinit_downsampler = true;
+        _downsampling_threads = parameter.as_int();
       } else if (name == _name + ".max_iterations") {
         reinit_a_star = true;
         _max_iterations = parameter.as_int();
@@ -696,7 +885,8 @@ SmacPlannerHybrid::dynamicParametersCallback(std::vector<rclcpp::Parameter> para
         std::string topic_name = "downsampled_costmap";
         _costmap_downsampler = std::make_unique<CostmapDownsampler>();
         _costmap_downsampler->on_configure(
-          node, _global_frame, topic_name, _costmap, _downsampling_factor);
+          node, _global_frame, topic_name, _costmap, _downsampling_factor, false,
+          static_cast<unsigned int>(std::max(_downsampling_threads, 1)));
       }
     }
 
@@ -0,0 +1,351 @@
+// Copyright (c) 2024 Open Navigation LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "nav2_smac_planner/smac_planner_route.hpp"
+#include "nav2_util/geometry_utils.hpp"
+
+namespace nav2_smac_planner
+{
+
+SmacPlannerRoute::SmacPlannerRoute()
+: _a_star(nullptr),
+  _collision_checker(nullptr, 1, nullptr),
+  _costmap(nullptr)
+{
+}
+
+SmacPlannerRoute::~SmacPlannerRoute()
+{
+  RCLCPP_INFO(
+    _logger, "Destroying plugin %s of type SmacPlannerRoute",
+    _name.c_str());
+}
+
+void SmacPlannerRoute::configure(
+  const rclcpp_lifecycle::LifecycleNode::WeakPtr & parent,
+  std::string name, std::shared_ptr<tf2_ros::Buffer>/*tf*/,
+  std::shared_ptr<nav2_costmap_2d::Costmap2DROS> costmap_ros)
+{
+  _node = parent;
+  auto node = parent.lock();
+  _logger = node->get_logger();
+  _clock = node->get_clock();
+  _costmap = costmap_ros->getCostmap();
+  _name = name;
+  _global_frame = costmap_ros->getGlobalFrameID();
+
+  RCLCPP_INFO(_logger, "Configuring %s of type SmacPlannerRoute", name.c_str());
+
+  nav2_util::declare_parameter_if_not_declared(
+    node, name + ".graph_filepath", rclcpp::ParameterValue(std::string("")));
+  node->get_parameter(name + ".graph_filepath", _graph_filepath);
+  nav2_util::declare_parameter_if_not_declared(
+    node, name + ".connection_radius", rclcpp::ParameterValue(5.0));
+  node->get_parameter(name + ".connection_radius", _connection_radius);
+  nav2_util::declare_parameter_if_not_declared(
+    node, name + ".max_connection_candidates", rclcpp::ParameterValue(3));
+  node->get_parameter(name + ".max_connection_candidates", _max_connection_candidates);
+
+  // Local search params, as the 2D planner
+  nav2_util::declare_parameter_if_not_declared(
+    node, name + ".tolerance", rclcpp::ParameterValue(0.125));
+  _tolerance = static_cast<float>(node->get_parameter(name + ".tolerance").as_double());
+  nav2_util::declare_parameter_if_not_declared(
+    node, name + ".cost_travel_multiplier", rclcpp::ParameterValue(1.0));
+  node->get_parameter(name + ".cost_travel_multiplier", _search_info.cost_penalty);
+  nav2_util::declare_parameter_if_not_declared(
+    node, name + ".allow_unknown", rclcpp::ParameterValue(true));
+  node->get_parameter(name + ".allow_unknown", _allow_unknown);
+  nav2_util::declare_parameter_if_not_declared(
+    node, name + ".max_iterations", rclcpp::ParameterValue(1000000));
+  node->get_parameter(name + ".max_iterations", _max_iterations);
+  nav2_util::declare_parameter_if_not_declared(
+    node, name + ".max_on_approach_iterations", rclcpp::ParameterValue(1000));
+  node->get_parameter(name + ".max_on_approach_iterations", _max_on_approach_iterations);
+  nav2_util::declare_parameter_if_not_declared(
+    node, name + ".terminal_checking_interval", rclcpp::ParameterValue(5000));
+  node->get_parameter(name + ".terminal_checking_interval", _terminal_checking_interval);
+  nav2_util::declare_parameter_if_not_declared(
+    node, name + ".max_planning_time", rclcpp::ParameterValue(2.0));
+  node->get_parameter(name + ".max_planning_time", _max_planning_time);
+
+  if (_max_on_approach_iterations <= 0) {
+    RCLCPP_INFO(
+      _logger, "On approach iteration selected as <= 0, "
+      "disabling tolerance and on approach iterations.");
+    _max_on_approach_iterations = std::numeric_limits<int>::max();
+  }
+
+  if (_max_iterations <= 0) {
+    RCLCPP_INFO(
+      _logger, "maximum iteration selected as <= 0, "
+      "disabling maximum iterations.");
+    _max_iterations = std::numeric_limits<int>::max();
+  }
+
+  if (_graph_filepath.empty()) {
+    RCLCPP_WARN(
+      _logger, "No route graph file given, only planning within the connection radius.");
+  } else {
+    _graph.load(_graph_filepath);
+  }
+
+  // Initialize collision checker
+  _collision_checker = GridCollisionChecker(costmap_ros, 1 /*for 2D, most be 1*/, node);
+  _collision_checker.setFootprint(
+    costmap_ros->getRobotFootprint(),
+    true /*for 2D, most use radius*/,
+    0.0 /*for 2D cost at inscribed isn't relevent*/);
+
+  // Initialize A* template
+  _a_star = std::make_unique<AStarAlgorithm<Node2D>>(MotionModel::TWOD, _search_info);
+  _a_star->initialize(
+    _allow_unknown,
+    _max_iterations,
+    _max_on_approach_iterations,
+    _terminal_checking_interval,
+    _max_planning_time,
+    0.0 /*unused for 2D*/,
+    1.0 /*unused for 2D*/);
+
+  RCLCPP_INFO(
+    _logger, "Configured plugin %s of type SmacPlannerRoute with a graph of %zu nodes, "
+    "connection radius %.2f and %s.",
+    _name.c_str(), _graph.getNodes().size(), _connection_radius,
+    _allow_unknown ? "allowing unknown traversal" : "not allowing unknown traversal");
+}
+
+void SmacPlannerRoute::activate()
+{
+  RCLCPP_INFO(
+    _logger, "Activating plugin %s of type SmacPlannerRoute",
+    _name.c_str());
+}
+
+void SmacPlannerRoute::deactivate()
+{
+  RCLCPP_INFO(
+    _logger, "Deactivating plugin %s of type SmacPlannerRoute",
+    _name.c_str());
+}
+
+void SmacPlannerRoute::cleanup()
+{
+  RCLCPP_INFO(
+    _logger, "Cleaning up plugin %s of type SmacPlannerRoute",
+    _name.c_str());
+  _a_star.reset();
+  _graph = RouteGraph();
+}
+
+nav_msgs::msg::Path SmacPlannerRoute::createPlan(
+  const geometry_msgs::msg::PoseStamped & start,
+  const geometry_msgs::msg::PoseStamped & goal,
+  std::function<bool()> cancel_checker)
+{
+  std::lock_guard<std::mutex> lock_reinit(_mutex);
+  std::unique_lock<nav2_costmap_2d::Costmap2D::mutex_t> lock(*(_costmap->getMutex()));
+
+  _a_star->setCollisionChecker(&_collision_checker);
+
+  const double & sx = start.pose.position.x;
+  const double & sy = start.pose.position.y;
+  const double & gx = goal.pose.position.x;
+  const double & gy = goal.pose.position.y;
+  unsigned int mx, my;
+  if (!_costmap->worldToMap(sx, sy, mx, my)) {
+    throw nav2_core::StartOutsideMapBounds(
+            "Start Coordinates of(" + std::to_string(sx) + ", " +
+            std::to_string(sy) + ") was outside bounds");
+  }
+  const bool goal_in_costmap = _costmap->worldToMap(gx, gy, mx, my);
+
+  std::vector<geometry_msgs::msg::Pose> poses;
+
+  // Nearby goals are planned to directly, without the graph
+  const bool direct = goal_in_costmap && std::hypot(gx - sx, gy - sy) <= _connection_radius &&
+    planLocal(sx, sy, gx, gy, cancel_checker, poses);
+
+  if (!direct) {
+    const unsigned int max_candidates =
+      static_cast<unsigned int>(std::max(_max_connection_candidates, 1));
+    std::vector<RouteConnection> starts =
+      _graph.getNodesWithin(sx, sy, _connection_radius, max_candidates);
+    std::vector<RouteConnection> goals =
+      _graph.getNodesWithin(gx, gy, _connection_radius, max_candidates);
+    if (starts.empty() || goals.empty()) {
+      throw nav2_core::NoValidPathCouldBeFound(
+              "No route graph node within the connection radius of the " +
+              std::string(starts.empty() ? "start" : "goal"));
+    }
+
+    // Search the graph, then check the connections of the route in the costmap,
+    // searching again without those that cannot be driven
+    const auto & nodes = _graph.getNodes();
+    std::vector<unsigned int> route;
+    std::vector<geometry_msgs::msg::Pose> goal_poses;
+    while (true) {
+      if (!_graph.findRoute(starts, goals, route)) {
+        throw nav2_core::NoValidPathCouldBeFound("no valid route found");
+      }
+
+      const RouteNode & first = nodes[route.front()];
+      poses.clear();
+      if (!planLocal(sx, sy, first.x, first.y, cancel_checker, poses)) {
+        starts.erase(
+          std::find_if(
+            starts.begin(), starts.end(),
+            [&](const RouteConnection & c) {return c.node == route.front();}));
+        continue;
+      }
+
+      for (unsigned int i = 1; i < route.size(); i++) {
+        const RouteNode & from = nodes[route[i - 1]];
+        const RouteNode & to = nodes[route[i]];
+        appendSegment(from.x, from.y, to.x, to.y, poses);
+      }
+
+      const RouteNode & last = nodes[route.back()];
+      if (!goal_in_costmap) {
+        appendSegment(last.x, last.y, gx, gy, poses);
+        break;
+      }
+
+      // The route may be followed while its goal connection is searched
+      if (_partial_path_callback) {
+        _partial_path_callback(toPath(poses));
+      }
+
+      goal_poses.clear();
+      if (!planLocal(last.x, last.y, gx, gy, cancel_checker, goal_poses)) {
+        goals.erase(
+          std::find_if(
+            goals.begin(), goals.end(),
+            [&](const RouteConnection & c) {return c.node == route.back();}));
+        continue;
+      }
+      poses.insert(poses.end(), goal_poses.begin() + 1, goal_poses.end());
+      break;
+    }
+  }
+
+  nav_msgs::msg::Path plan = toPath(poses);
+  if (!plan.poses.empty()) {
+    plan.poses.back().pose.orientation = goal.pose.orientation;
+  }
+  return plan;
+}
+
+nav_msgs::msg::Path SmacPlannerRoute::toPath(const std::vector<geometry_msgs::msg::Pose> & poses)
+{
+  // Each pose heads to the next one, and the last one as the one before it
+  nav_msgs::msg::Path plan;
+  plan.header.stamp = _clock->now();
+  plan.header.frame_id = _global_frame;
+  plan.poses.resize(poses.size());
+  for (unsigned int i = 0; i != poses.size(); i++) {
+    plan.poses[i].header = plan.header;
+    plan.poses[i].pose = poses[i];
+    if (i + 1 < poses.size()) {
+      plan.poses[i].pose.orientation = nav2_util::geometry_utils::orientationAroundZAxis(
+        std::atan2(
+          poses[i + 1].position.y - poses[i].position.y,
+          poses[i + 1].position.x - poses[i].position.x));
+    } else if (i > 0) {
+      plan.poses[i].pose.orientation = plan.poses[i - 1].pose.orientation;
+    }
+  }
+  return plan;
+}
+
+bool SmacPlannerRoute::planLocal(
+  const double & x0, const double & y0, const double & x1, const double & y1,
+  std::function<bool()> cancel_checker, std::vector<geometry_msgs::msg::Pose> & poses)
+{
+  float mx0, my0, mx1, my1;
+  if (!_costmap->worldToMapContinuous(x0, y0, mx0, my0) ||
+    !_costmap->worldToMapContinuous(x1, y1, mx1, my1))
+  {
+    return false;
+  }
+
+  geometry_msgs::msg::Pose pose;
+  pose.position.x = x0;
+  pose.position.y = y0;
+  poses.push_back(pose);
+
+  // Corner case of start and goal being on the same cell
+  if (std::floor(mx0) != std::floor(mx1) || std::floor(my0) != std::floor(my1)) {
+    Node2D::CoordinateVector path;
+    int num_iterations = 0;
+    try {
+      _a_star->setStart(mx0, my0, 0);
+      _a_star->setGoal(mx1, my1, 0);
+      if (!_a_star->createPath(
+          path, num_iterations,
+          _tolerance / static_cast<float>(_costmap->getResolution()), cancel_checker))
+      {
+        poses.pop_back();
+        return false;
+      }
+    } catch (const nav2_core::PlannerCancelled &) {
+      throw;
+    } catch (const nav2_core::PlannerException &) {
+      poses.pop_back();
+      return false;
+    }
+
+    // The path goes from goal to start, whose cells are replaced by the exact positions
+    for (int i = static_cast<int>(path.size()) - 2; i > 0; --i) {
+      poses.push_back(getWorldCoords(path[i].x, path[i].y, _costmap));
+    }
+  }
+
+  pose.position.x = x1;
+  pose.position.y = y1;
+  poses.push_back(pose);
+  return true;
+}
+
+void SmacPlannerRoute::appendSegment(
+  const double & x0, const double & y0, const double & x1, const double & y1,
+  std::vector<geometry_msgs::msg::Pose> & poses)
+{
+  const double length = std::hypot(x1 - x0, y1 - y0);
+  const int steps = static_cast<int>(std::ceil(length / _costmap->getResolution()));
+  geometry_msgs::msg::Pose pose;
+  unsigned int mx, my;
+  for (int i = 1; i < steps; i++) {
+    pose.position.x = x0 + (x1 - x0) * i / steps;
+    pose.position.y = y0 + (y1 - y0) * i / steps;
+    if (_costmap->worldToMap(pose.position.x, pose.position.y, mx, my)) {
+      poses.push_back(pose);
+    }
+  }
+  pose.position.x = x1;
+  pose.position.y = y1;
+  poses.push_back(pose);
+}
+
+}  // namespace nav2_smac_planner
+
+#include "pluginlib/class_list_macros.hpp"
+PLUGINLIB_EXPORT_CLASS(nav2_smac_planner::SmacPlannerRoute, nav2_core::GlobalPlanner)
@@ -14,6 +14,8 @@
 
 #include <ompl/base/ScopedState.h>
 #include <ompl/base/spaces/DubinsStateSpace.h>
+#include <algorithm>
+#include <cmath>
 #include <vector>
 #include <memory>
 #include "nav2_smac_planner/smoother.hpp"
@@ -32,6 +34,11 @@ Smoother::Smoother(const SmootherParams & params)
   is_holonomic_ = params.holonomic_;
   do_refinement_ = params.do_refinement_;
   refinement_num_ = params.refinement_num_;
+
+  if (params.num_threads_ > 1) {
+    // The calling thread smooths segments as well
+    thread_pool_ = std::make_unique<nav2_util::ThreadPool>(params.num_threads_ - 1);
+  }
 }
 
 void Smoother::initialize(const double & min_turning_radius)
@@ -51,16 +58,20 @@ bool Smoother::smooth(
   }
 
   steady_clock::time_point start = steady_clock::now();
-  double time_remaining = max_time;
-  bool success = true, reversing_segment;
-  nav_msgs::msg::Path curr_path_segment;
-  curr_path_segment.header = path.header;
   std::vector<PathSegment> path_segments = findDirectionalPathSegments(path);
 
-  for (unsigned int i = 0; i != path_segments.size(); i++) {
-    if (path_segments[i].end - path_segments[i].start > 10) {
+  // Segments only share their cusp poses, which are kept by smoothing,
+  // so they are smoothed independently and assembled afterwards
+  std::vector<nav_msgs::msg::Path> smoothed_segments(path_segments.size());
+  std::vector<char> segments_success(path_segments.size(), true);
+  auto smooth_segment = [&](size_t i) {
+      if (path_segments[i].end - path_segments[i].start <= 10) {
+        return;
+      }
+
       // Populate path segment
-      curr_path_segment.poses.clear();
+      nav_msgs::msg::Path & curr_path_segment = smoothed_segments[i];
+      curr_path_segment.header = path.header;
       std::copy(
         path.poses.begin() + path_segments[i].start,
         path.poses.begin() + path_segments[i].end + 1,
@@ -68,30 +79,41 @@ bool Smoother::smooth(
 
       // Make sure we're still able to smooth with time remaining
       steady_clock::time_point now = steady_clock::now();
-      time_remaining = max_time - duration_cast<duration<double>>(now - start).count();
-      refinement_ctr_ = 0;
+      double time_remaining = max_time - duration_cast<duration<double>>(now - start).count();
 
       // Smooth path segment naively
       const geometry_msgs::msg::Pose start_pose = curr_path_segment.poses.front().pose;
       const geometry_msgs::msg::Pose goal_pose = curr_path_segment.poses.back().pose;
+      bool reversing_segment;
       bool local_success =
         smoothImpl(curr_path_segment, reversing_segment, costmap, time_remaining);
-      success = success && local_success;
+      segments_success[i] = local_success;
 
       // Enforce boundary conditions
       if (!is_holonomic_ && local_success) {
         enforceStartBoundaryConditions(start_pose, curr_path_segment, costmap, reversing_segment);
         enforceEndBoundaryConditions(goal_pose, curr_path_segment, costmap, reversing_segment);
       }
+    };
 
-      // Assemble the path changes to the main path
-      std::copy(
-        curr_path_segment.poses.begin(),
-        curr_path_segment.poses.end(),
-        path.poses.begin() + path_segments[i].start);
+  if (thread_pool_ && path_segments.size() > 1) {
+    thread_pool_->parallelFor(0, path_segments.size(), smooth_segment);
+  } else {
+    for (unsigned int i = 0; i != path_segments.size(); i++) {
+      smooth_segment(i);
     }
   }
 
+  // Assemble the path changes to the main path
+  bool success = true;
+  for (unsigned int i = 0; i != path_segments.size(); i++) {
+    success = success && segments_success[i];
+    std::copy(
+      smoothed_segments[i].poses.begin(),
+      smoothed_segments[i].poses.end(),
+      path.poses.begin() + path_segments[i].start);
+  }
+
   return success;
 }
 
@@ -100,18 +122,52 @@ bool Smoother::smoothImpl(
   bool & reversing_segment,
   const nav2_costmap_2d::Costmap2D * costmap,
   const double & max_time)
+{
+  // Smooth contiguous coordinates rather than the pose messages
+  const unsigned int & path_size = path.poses.size();
+  std::vector<double> x(path_size), y(path_size);
+  for (unsigned int i = 0; i != path_size; i++) {
+    x[i] = path.poses[i].pose.position.x;
+    y[i] = path.poses[i].pose.position.y;
+  }
+
+  bool success = smoothPositions(x, y, costmap, max_time);
+
+  // Lets do additional refinement, it shouldn't take more than a couple milliseconds
+  // but really puts the path quality over the top.
+  if (success && do_refinement_) {
+    for (int i = 0; i < refinement_num_; i++) {
+      if (!smoothPositions(x, y, costmap, max_time)) {
+        break;
+      }
+    }
+  }
+
+  for (unsigned int i = 0; i != path_size; i++) {
+    path.poses[i].pose.position.x = x[i];
+    path.poses[i].pose.position.y = y[i];
+  }
+  updateApproximatePathOrientations(path, reversing_segment);
+  return success;
+}
+
+bool Smoother::smoothPositions(
+  std::vector<double> & x,
+  std::vector<double> & y,
+  const nav2_costmap_2d::Costmap2D * costmap,
+  const double & max_time)
 {
   steady_clock::time_point a = steady_clock::now();
   rclcpp::Duration max_dur = rclcpp::Duration::from_seconds(max_time);
 
   int its = 0;
   double change = tolerance_;
-  const unsigned int & path_size = path.poses.size();
-  double x_i, y_i, y_m1, y_ip1, y_i_org;
+  const unsigned int path_size = x.size();
+  double x_i_org, y_i_org;
   unsigned int mx, my;
 
-  nav_msgs::msg::Path new_path = path;
-  nav_msgs::msg::Path last_path = path;
+  const std::vector<double> x_data = x, y_data = y;
+  std::vector<double> last_x = x, last_y = y;
 
   while (change >= tolerance_) {
     its += 1;
@@ -122,8 +178,8 @@ bool Smoother::smoothImpl(
       RCLCPP_DEBUG(
         rclcpp::get_logger("SmacPlannerSmoother"),
         "Number of iterations has exceeded limit of %i.", max_its_);
-      path = last_path;
-      updateApproximatePathOrientations(path, reversing_segment);
+      x = last_x;
+      y = last_y;
       return false;
     }
 
@@ -134,58 +190,41 @@ bool Smoother::smoothImpl(
       RCLCPP_DEBUG(
         rclcpp::get_logger("SmacPlannerSmoother"),
         "Smoothing time exceeded allowed duration of %0.2f.", max_time);
-      path = last_path;
-      updateApproximatePathOrientations(path, reversing_segment);
+      x = last_x;
+      y = last_y;
       return false;
     }
 
+    // Smooth based on local 3 point neighborhood and original data locations
     for (unsigned int i = 1; i != path_size - 1; i++) {
-      for (unsigned int j = 0; j != 2; j++) {
-        x_i = getFieldByDim(path.poses[i], j);
-        y_i = getFieldByDim(new_path.poses[i], j);
-        y_m1 = getFieldByDim(new_path.poses[i - 1], j);
-        y_ip1 = getFieldByDim(new_path.poses[i + 1], j);
-        y_i_org = y_i;
-
-        // Smooth based on local 3 point neighborhood and original data locations
-        y_i += data_w_ * (x_i - y_i) + smooth_w_ * (y_ip1 + y_m1 - (2.0 * y_i));
-        setFieldByDim(new_path.poses[i], j, y_i);
-        change += abs(y_i - y_i_org);
-      }
-
-      // validate update is admissible, only checks cost if a valid costmap pointer is provided
-      float cost = 0.0;
-      if (costmap) {
-        costmap->worldToMap(
-          getFieldByDim(new_path.poses[i], 0),
-          getFieldByDim(new_path.poses[i], 1),
-          mx, my);
-        cost = static_cast<float>(costmap->getCost(mx, my));
-      }
+      x_i_org = x[i];
+      y_i_org = y[i];
+      x[i] += data_w_ * (x_data[i] - x[i]) + smooth_w_ * (x[i + 1] + x[i - 1] - (2.0 * x[i]));
+      y[i] += data_w_ * (y_data[i] - y[i]) + smooth_w_ * (y[i + 1] + y[i - 1] - (2.0 * y[i]));
+      change += std::abs(x[i] - x_i_org) + std::abs(y[i] - y_i_org);
+    }
 
-      if (cost > MAX_NON_OBSTACLE && cost != UNKNOWN) {
-        RCLCPP_DEBUG(
-          rclcpp::get_logger("SmacPlannerSmoother"),
-          "Smoothing process resulted in an infeasible collision. "
-          "Returning the last path before the infeasibility was introduced.");
-        path = last_path;
-        updateApproximatePathOrientations(path, reversing_segment);
-        return false;
+    // validate update is admissible, only checks cost if a valid costmap pointer is provided
+    if (costmap) {
+      for (unsigned int i = 1; i != path_size - 1; i++) {
+        costmap->worldToMap(x[i], y[i], mx, my);
+        const float cost = static_cast<float>(costmap->getCost(mx, my));
+        if (cost > MAX_NON_OBSTACLE && cost != UNKNOWN) {
+          RCLCPP_DEBUG(
+            rclcpp::get_logger("SmacPlannerSmoother"),
+            "Smoothing process resulted in an infeasible collision. "
+            "Returning the last path before the infeasibility was introduced.");
+          x = last_x;
+          y = last_y;
+          return false;
+        }
       }
     }
 
-    last_path = new_path;
-  }
-
-  // Lets do additional refinement, it shouldn't take more than a couple milliseconds
-  // but really puts the path quality over the top.
-  if (do_refinement_ && refinement_ctr_ < refinement_num_) {
-    refinement_ctr_++;
-    smoothImpl(new_path, reversing_segment, costmap, max_time);
+    last_x = x;
+    last_y = y;
   }
 
-  updateApproximatePathOrientations(new_path, reversing_segment);
-  path = new_path;
   return true;
 }
 
@@ -328,7 +367,8 @@ void Smoother::findBoundaryExpansion(
   BoundaryExpansion & expansion,
   const nav2_costmap_2d::Costmap2D * costmap)
 {
-  static ompl::base::ScopedState<> from(state_space_), to(state_space_), s(state_space_);
+  static thread_local ompl::base::ScopedState<> from(state_space_), to(state_space_),
+    s(state_space_);
 
   from[0] = start.position.x;
   from[1] = start.position.y;
@@ -13,6 +13,7 @@
 // limitations under the License. Reserved.
 
 #include <math.h>
+#include <cmath>
 #include <memory>
 #include <string>
 #include <vector>
@@ -141,6 +142,233 @@ TEST(AStarTest, test_a_star_2d)
   delete costmapA;
 }
 
+TEST(AStarTest, test_a_star_2d_bidirectional)
+{
+  auto lnode = std::make_shared<rclcpp_lifecycle::LifecycleNode>("test");
+  nav2_smac_planner::SearchInfo info;
+  nav2_smac_planner::SearchInfo bidirectional_info;
+  bidirectional_info.bidirectional_search = true;
+  nav2_smac_planner::AStarAlgorithm<nav2_smac_planner::Node2D> a_star(
+    nav2_smac_planner::MotionModel::TWOD, info);
+  nav2_smac_planner::AStarAlgorithm<nav2_smac_planner::Node2D> a_star_bidirectional(
+    nav2_smac_planner::MotionModel::TWOD, bidirectional_info);
+  int max_iterations = 10000;
+  a_star.initialize(false, max_iterations, 10, 5000, 120.0, 0.0, 1);
+  a_star_bidirectional.initialize(false, max_iterations, 10, 5000, 120.0, 0.0, 1);
+
+  nav2_costmap_2d::Costmap2D * costmapA =
+    new nav2_costmap_2d::Costmap2D(100, 100, 0.1, 0.0, 0.0, 0);
+  for (unsigned int i = 40; i <= 60; ++i) {
+    for (unsigned int j = 40; j <= 60; ++j) {
+      costmapA->setCost(i, j, 254);
+    }
+  }
+
+  auto costmap_ros = std::make_shared<nav2_costmap_2d::Costmap2DROS>();
+  costmap_ros->on_configure(rclcpp_lifecycle::State());
+  *costmap_ros->getCostmap() = *costmapA;
+
+  auto dummy_cancel_checker = []() {
+      return false;
+    };
+
+  std::unique_ptr<nav2_smac_planner::GridCollisionChecker> checker =
+    std::make_unique<nav2_smac_planner::GridCollisionChecker>(costmap_ros, 1, lnode);
+  checker->setFootprint(nav2_costmap_2d::Footprint(), true, 0.0);
+
+  auto path_length = [](const nav2_smac_planner::Node2D::CoordinateVector & path) {
+      float length = 0.0;
+      for (unsigned int i = 1; i < path.size(); i++) {
+        length += std::hypot(path[i].x - path[i - 1].x, path[i].y - path[i - 1].y);
+      }
+      return length;
+    };
+
+  nav2_smac_planner::Node2D::CoordinateVector path, bidirectional_path;
+  int num_it = 0, bidirectional_num_it = 0;
+  a_star.setCollisionChecker(checker.get());
+  a_star.setStart(20u, 20u, 0);
+  a_star.setGoal(80u, 80u, 0);
+  EXPECT_TRUE(a_star.createPath(path, num_it, 0.0, dummy_cancel_checker));
+  a_star_bidirectional.setCollisionChecker(checker.get());
+  a_star_bidirectional.setStart(20u, 20u, 0);
+  a_star_bidirectional.setGoal(80u, 80u, 0);
+  EXPECT_TRUE(
+    a_star_bidirectional.createPath(
+      bidirectional_path, bidirectional_num_it, 0.0, dummy_cancel_checker));
+
+  // Same optimal path length, goal first, through adjacent free cells
+  EXPECT_NEAR(path_length(bidirectional_path), path_length(path), 1e-3);
+  EXPECT_EQ(bidirectional_path.front().x, 80.0);
+  EXPECT_EQ(bidirectional_path.front().y, 80.0);
+  EXPECT_EQ(bidirectional_path.back().x, 20.0);
+  EXPECT_EQ(bidirectional_path.back().y, 20.0);
+  for (unsigned int i = 0; i != bidirectional_path.size(); i++) {
+    EXPECT_EQ(costmapA->getCost(bidirectional_path[i].x, bidirectional_path[i].y), 0);
+    if (i > 0) {
+      EXPECT_LE(std::abs(bidirectional_path[i].x - bidirectional_path[i - 1].x), 1.0);
+      EXPECT_LE(std::abs(bidirectional_path[i].y - bidirectional_path[i - 1].y), 1.0);
+    }
+  }
+
+  // Goals in collision fall back to the search from the start, to plan within tolerance
+  bidirectional_path.clear();
+  bidirectional_num_it = 0;
+  a_star_bidirectional.setGoal(50u, 50u, 0);
+  EXPECT_TRUE(
+    a_star_bidirectional.createPath(
+      bidirectional_path, bidirectional_num_it, 20.0, dummy_cancel_checker));
+  EXPECT_EQ(bidirectional_path.size(), 21u);
+
+  delete costmapA;
+}
+
+TEST(AStarTest, test_a_star_2d_bucket_queue)
+{
+  nav2_smac_planner::BucketQueue<int> queue;
+  queue.emplace(3.0, 0);
+  queue.emplace(1.0, 1);
+  queue.emplace(2.0, 2);
+  EXPECT_EQ(queue.size(), 3u);
+  EXPECT_EQ(queue.top().second, 1);
+  queue.pop();
+  // Costs below the last popped one are popped next
+  queue.emplace(0.5, 3);
+  EXPECT_EQ(queue.top().second, 3);
+  queue.pop();
+  EXPECT_EQ(queue.top().second, 2);
+  queue.clear();
+  EXPECT_TRUE(queue.empty());
+
+  auto lnode = std::make_shared<rclcpp_lifecycle::LifecycleNode>("test");
+  nav2_smac_planner::SearchInfo info;
+  nav2_smac_planner::SearchInfo bucket_info;
+  bucket_info.use_bucket_queue = true;
+  nav2_smac_planner::AStarAlgorithm<nav2_smac_planner::Node2D> a_star(
+    nav2_smac_planner::MotionModel::TWOD, info);
+  nav2_smac_planner::AStarAlgorithm<nav2_smac_planner::Node2D> a_star_bucket(
+    nav2_smac_planner::MotionModel::TWOD, bucket_info);
+  int max_iterations = 10000;
+  a_star.initialize(false, max_iterations, 10, 5000, 120.0, 0.0, 1);
+  a_star_bucket.initialize(false, max_iterations, 10, 5000, 120.0, 0.0, 1);
+
+  nav2_costmap_2d::Costmap2D * costmapA =
+    new nav2_costmap_2d::Costmap2D(100, 100, 0.1, 0.0, 0.0, 0);
+  for (unsigned int i = 40; i <= 60; ++i) {
+    for (unsigned int j = 40; j <= 60; ++j) {
+      costmapA->setCost(i, j, 254);
+    }
+  }
+
+  auto costmap_ros = std::make_shared<nav2_costmap_2d::Costmap2DROS>();
+  costmap_ros->on_configure(rclcpp_lifecycle::State());
+  *costmap_ros->getCostmap() = *costmapA;
+
+  auto dummy_cancel_checker = []() {
+      return false;
+    };
+
+  std::unique_ptr<nav2_smac_planner::GridCollisionChecker> checker =
+    std::make_unique<nav2_smac_planner::GridCollisionChecker>(costmap_ros, 1, lnode);
+  checker->setFootprint(nav2_costmap_2d::Footprint(), true, 0.0);
+
+  nav2_smac_planner::Node2D::CoordinateVector path, bucket_path;
+  int num_it = 0, bucket_num_it = 0;
+  a_star.setCollisionChecker(checker.get());
+  a_star.setStart(20u, 20u, 0);
+  a_star.setGoal(80u, 80u, 0);
+  EXPECT_TRUE(a_star.createPath(path, num_it, 0.0, dummy_cancel_checker));
+  a_star_bucket.setCollisionChecker(checker.get());
+  a_star_bucket.setStart(20u, 20u, 0);
+  a_star_bucket.setGoal(80u, 80u, 0);
+  EXPECT_TRUE(a_star_bucket.createPath(bucket_path, bucket_num_it, 0.0, dummy_cancel_checker));
+
+  auto path_length = [](const nav2_smac_planner::Node2D::CoordinateVector & path) {
+      float length = 0.0;
+      for (unsigned int i = 1; i < path.size(); i++) {
+        length += std::hypot(path[i].x - path[i - 1].x, path[i].y - path[i - 1].y);
+      }
+      return length;
+    };
+
+  // Same optimal path length, from goal to start
+  EXPECT_NEAR(path_length(bucket_path), path_length(path), 1e-3);
+  EXPECT_EQ(bucket_path.front().x, 80.0);
+  EXPECT_EQ(bucket_path.back().x, 20.0);
+
+  delete costmapA;
+}
+
+TEST(AStarTest, test_a_star_2d_multi_goal)
+{
+  auto lnode = std::make_shared<rclcpp_lifecycle::LifecycleNode>("test");
+  nav2_smac_planner::SearchInfo info;
+  nav2_smac_planner::AStarAlgorithm<nav2_smac_planner::Node2D> a_star(
+    nav2_smac_planner::MotionModel::TWOD, info);
+  int max_iterations = 10000;
+  a_star.initialize(false, max_iterations, 10, 5000, 120.0, 0.0, 1);
+
+  nav2_costmap_2d::Costmap2D * costmapA =
+    new nav2_costmap_2d::Costmap2D(100, 100, 0.1, 0.0, 0.0, 0);
+  for (unsigned int i = 40; i <= 60; ++i) {
+    for (unsigned int j = 40; j <= 60; ++j) {
+      costmapA->setCost(i, j, 254);
+    }
+  }
+
+  auto costmap_ros = std::make_shared<nav2_costmap_2d::Costmap2DROS>();
+  costmap_ros->on_configure(rclcpp_lifecycle::State());
+  *costmap_ros->getCostmap() = *costmapA;
+
+  auto dummy_cancel_checker = []() {
+      return false;
+    };
+
+  std::unique_ptr<nav2_smac_planner::GridCollisionChecker> checker =
+    std::make_unique<nav2_smac_planner::GridCollisionChecker>(costmap_ros, 1, lnode);
+  checker->setFootprint(nav2_costmap_2d::Footprint(), true, 0.0);
+  a_star.setCollisionChecker(checker.get());
+
+  // Goals can only be added to a goal
+  EXPECT_THROW(a_star.addGoal(30u, 30u, 0), std::runtime_error);
+
+  // One search reaches the closest goal, whichever goal was set first
+  nav2_smac_planner::Node2D::CoordinateVector path;
+  int num_it = 0;
+  a_star.setStart(20u, 20u, 0);
+  a_star.setGoal(80u, 80u, 0);
+  a_star.addGoal(20u, 70u, 0);
+  EXPECT_EQ(a_star.getGoals().size(), 2u);
+  EXPECT_THROW(a_star.addGoal(0, 0, 10), std::runtime_error);
+  EXPECT_TRUE(a_star.createPath(path, num_it, 0.0, dummy_cancel_checker));
+  EXPECT_EQ(path.front().x, 20.0);
+  EXPECT_EQ(path.front().y, 70.0);
+  EXPECT_EQ(path.back().x, 20.0);
+  EXPECT_EQ(path.back().y, 20.0);
+  EXPECT_EQ(path.size(), 51u);
+
+  // Occupied goals are skipped as long as one goal is free
+  path.clear();
+  num_it = 0;
+  a_star.setCollisionChecker(checker.get());
+  a_star.setStart(20u, 20u, 0);
+  a_star.setGoal(50u, 50u, 0);
+  a_star.addGoal(80u, 80u, 0);
+  EXPECT_TRUE(a_star.createPath(path, num_it, 0.0, dummy_cancel_checker));
+  EXPECT_EQ(path.front().x, 80.0);
+  EXPECT_EQ(path.front().y, 80.0);
+  for (unsigned int i = 0; i != path.size(); i++) {
+    EXPECT_EQ(costmapA->getCost(path[i].x, path[i].y), 0);
+  }
+
+  // Setting a goal drops the added goals
+  a_star.setGoal(50u, 50u, 0);
+  EXPECT_EQ(a_star.getGoals().size(), 1u);
+  EXPECT_THROW(a_star.createPath(path, num_it, 0.0, dummy_cancel_checker), std::runtime_error);
+
+  delete costmapA;
+}
+
 TEST(AStarTest, test_a_star_se2)
 {
   auto lnode = std::make_shared<rclcpp_lifecycle::LifecycleNode>("test");
@@ -218,6 +446,166 @@ TEST(AStarTest, test_a_star_se2)
   nav2_smac_planner::NodeHybrid::destroyStaticAssets();
 }
 
+TEST(AStarTest, test_a_star_se2_anytime)
+{
+  auto lnode = std::make_shared<rclcpp_lifecycle::LifecycleNode>("test");
+  nav2_smac_planner::SearchInfo info;
+  info.change_penalty = 0.1;
+  info.non_straight_penalty = 1.1;
+  info.reverse_penalty = 2.0;
+  info.minimum_turning_radius = 8;  // in grid coordinates
+  info.retrospective_penalty = 0.015;
+  info.analytic_expansion_max_length = 20.0;  // in grid coordinates
+  info.analytic_expansion_ratio = 3.5;
+  info.cost_penalty = 1.7;
+  info.anytime_search = true;
+  info.anytime_initial_heuristic_weight = 3.0;
+  info.anytime_heuristic_weight_step = 1.0;
+  unsigned int size_theta = 72;
+  int max_iterations = 10000;
+  float tolerance = 10.0;
+  int it_on_approach = 10;
+  int terminal_checking_interval = 1;
+  double max_planning_time = 120.0;
+
+  nav2_costmap_2d::Costmap2D * costmapA =
+    new nav2_costmap_2d::Costmap2D(100, 100, 0.1, 0.0, 0.0, 0);
+  // island in the middle of lethal cost to cross
+  for (unsigned int i = 40; i <= 60; ++i) {
+    for (unsigned int j = 40; j <= 60; ++j) {
+      costmapA->setCost(i, j, 254);
+    }
+  }
+
+  // Convert raw costmap into a costmap ros object
+  auto costmap_ros = std::make_shared<nav2_costmap_2d::Costmap2DROS>();
+  costmap_ros->on_configure(rclcpp_lifecycle::State());
+  auto costmap = costmap_ros->getCostmap();
+  *costmap = *costmapA;
+
+  std::unique_ptr<nav2_smac_planner::GridCollisionChecker> checker =
+    std::make_unique<nav2_smac_planner::GridCollisionChecker>(costmap_ros, size_theta, lnode);
+  checker->setFootprint(nav2_costmap_2d::Footprint(), true, 0.0);
+
+  auto dummy_cancel_checker = []() {
+      return false;
+    };
+
+  // No time to improve: only the search with the inflated heuristic is done
+  info.anytime_max_improvement_time = 0.0;
+  nav2_smac_planner::AStarAlgorithm<nav2_smac_planner::NodeHybrid> first_a_star(
+    nav2_smac_planner::MotionModel::DUBIN, info);
+  first_a_star.initialize(
+    false, max_iterations, it_on_approach, terminal_checking_interval,
+    max_planning_time, 401, size_theta);
+  first_a_star.setCollisionChecker(checker.get());
+  first_a_star.setStart(10u, 10u, 0u);
+  first_a_star.setGoal(80u, 80u, 40u);
+  nav2_smac_planner::NodeHybrid::CoordinateVector first_path;
+  int first_num_it = 0;
+  EXPECT_TRUE(
+    first_a_star.createPath(first_path, first_num_it, tolerance, dummy_cancel_checker));
+
+  // Searches with heuristic weights 3, 2 and 1, keeping the cheapest path
+  info.anytime_max_improvement_time = 120.0;
+  nav2_smac_planner::AStarAlgorithm<nav2_smac_planner::NodeHybrid> a_star(
+    nav2_smac_planner::MotionModel::DUBIN, info);
+  a_star.initialize(
+    false, max_iterations, it_on_approach, terminal_checking_interval,
+    max_planning_time, 401, size_theta);
+  a_star.setCollisionChecker(checker.get());
+  a_star.setStart(10u, 10u, 0u);
+  a_star.setGoal(80u, 80u, 40u);
+  nav2_smac_planner::NodeHybrid::CoordinateVector path;
+  int num_it = 0;
+  EXPECT_TRUE(a_star.createPath(path, num_it, tolerance, dummy_cancel_checker));
+  EXPECT_GT(num_it, first_num_it);
+
+  // check paths are collision free, with no skipped nodes
+  for (const auto & p : {first_path, path}) {
+    ASSERT_GT(p.size(), 1u);
+    for (unsigned int i = 0; i != p.size(); i++) {
+      EXPECT_EQ(costmapA->getCost(p[i].x, p[i].y), 0);
+    }
+    for (unsigned int i = 1; i != p.size(); i++) {
+      EXPECT_LT(hypotf(p[i].x - p[i - 1].x, p[i].y - p[i - 1].y), 2.1f);
+    }
+  }
+
+  delete costmapA;
+  nav2_smac_planner::NodeHybrid::destroyStaticAssets();
+}
+
+TEST(AStarTest, test_a_star_se2_multi_goal)
+{
+  auto lnode = std::make_shared<rclcpp_lifecycle::LifecycleNode>("test");
+  nav2_smac_planner::SearchInfo info;
+  info.change_penalty = 0.1;
+  info.non_straight_penalty = 1.1;
+  info.reverse_penalty = 2.0;
+  info.minimum_turning_radius = 8;  // in grid coordinates
+  info.retrospective_penalty = 0.015;
+  info.analytic_expansion_max_length = 20.0;  // in grid coordinates
+  info.analytic_expansion_ratio = 3.5;
+  info.cost_penalty = 1.7;
+  unsigned int size_theta = 72;
+  int max_iterations = 10000;
+  float tolerance = 0.0;
+  int it_on_approach = 10;
+  int terminal_checking_interval = 5000;
+  double max_planning_time = 120.0;
+
+  nav2_costmap_2d::Costmap2D * costmapA =
+    new nav2_costmap_2d::Costmap2D(100, 100, 0.1, 0.0, 0.0, 0);
+  // island in the middle of lethal cost to cross
+  for (unsigned int i = 40; i <= 60; ++i) {
+    for (unsigned int j = 40; j <= 60; ++j) {
+      costmapA->setCost(i, j, 254);
+    }
+  }
+
+  // Convert raw costmap into a costmap ros object
+  auto costmap_ros = std::make_shared<nav2_costmap_2d::Costmap2DROS>();
+  costmap_ros->on_configure(rclcpp_lifecycle::State());
+  auto costmap = costmap_ros->getCostmap();
+  *costmap = *costmapA;
+
+  std::unique_ptr<nav2_smac_planner::GridCollisionChecker> checker =
+    std::make_unique<nav2_smac_planner::GridCollisionChecker>(costmap_ros, size_theta, lnode);
+  checker->setFootprint(nav2_costmap_2d::Footprint(), true, 0.0);
+
+  auto dummy_cancel_checker = []() {
+      return false;
+    };
+
+  nav2_smac_planner::AStarAlgorithm<nav2_smac_planner::NodeHybrid> a_star(
+    nav2_smac_planner::MotionModel::DUBIN, info);
+  a_star.initialize(
+    false, max_iterations, it_on_approach, terminal_checking_interval,
+    max_planning_time, 401, size_theta);
+  a_star.setCollisionChecker(checker.get());
+
+  // The goal across the island and the same place at other headings, the goal straight
+  // ahead of the start being the cheapest to reach
+  a_star.setStart(10u, 10u, 0u);
+  a_star.setGoal(80u, 80u, 40u);
+  a_star.addGoal(30u, 10u, 36u);
+  a_star.addGoal(30u, 10u, 0u);
+  nav2_smac_planner::NodeHybrid::CoordinateVector path;
+  int num_it = 0;
+  EXPECT_TRUE(a_star.createPath(path, num_it, tolerance, dummy_cancel_checker));
+  ASSERT_GT(path.size(), 1u);
+  EXPECT_NEAR(path.front().x, 30.0, 0.01);
+  EXPECT_NEAR(path.front().y, 10.0, 0.01);
+  EXPECT_NEAR(path.front().theta, 0.0, 0.01);
+  for (unsigned int i = 0; i != path.size(); i++) {
+    EXPECT_EQ(costmapA->getCost(path[i].x, path[i].y), 0);
+  }
+
+  delete costmapA;
+  nav2_smac_planner::NodeHybrid::destroyStaticAssets();
+}
+
 TEST(AStarTest, test_a_star_lattice)
 {
   auto lnode = std::make_shared<rclcpp_lifecycle::LifecycleNode>("test");
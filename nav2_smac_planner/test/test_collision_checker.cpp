@@ -16,6 +16,8 @@
 #include <string>
 #include <vector>
 #include <memory>
+#include <algorithm>
+#include <random>
 
 #include "gtest/gtest.h"
 #include "nav2_smac_planner/collision_checker.hpp"
@@ -213,3 +215,148 @@ TEST(collision_footprint, test_point_and_line_cost)
   EXPECT_NEAR(right_value, 254.0, 0.001);
   delete costmap_;
 }
+
+TEST(collision_footprint, test_footprint_cells_match_footprint_cost)
+{
+  auto node = std::make_shared<rclcpp_lifecycle::LifecycleNode>("testF");
+  auto costmap_ros = std::make_shared<nav2_costmap_2d::Costmap2DROS>();
+  costmap_ros->on_configure(rclcpp_lifecycle::State());
+  auto costmap = costmap_ros->getCostmap();
+  *costmap = nav2_costmap_2d::Costmap2D(100, 100, 0.05, 0.0, 0.0, 0);
+
+  std::mt19937 generator(42);
+  std::uniform_int_distribution<int> cost_distribution(0, 260);
+  for (unsigned int i = 0; i != 100; ++i) {
+    for (unsigned int j = 0; j != 100; ++j) {
+      // Mostly free, a few lethal cells
+      const int cost = cost_distribution(generator);
+      costmap->setCost(i, j, cost > 252 ? 254 : cost / 4);
+    }
+  }
+
+  geometry_msgs::msg::Point p1, p2, p3, p4;
+  p1.x = 0.43;
+  p1.y = 0.21;
+  p2.x = 0.43;
+  p2.y = -0.21;
+  p3.x = -0.27;
+  p3.y = -0.21;
+  p4.x = -0.27;
+  p4.y = 0.21;
+  nav2_costmap_2d::Footprint footprint = {p1, p2, p3, p4};
+
+  nav2_smac_planner::GridCollisionChecker collision_checker(costmap_ros, 72, node);
+  collision_checker.setFootprint(footprint, false /*use footprint*/, 0.0);
+  std::vector<float> & angles = collision_checker.getPrecomputedAngles();
+
+  // The edges cells must be those rasterized by footprintCost, anywhere in the cells
+  std::uniform_real_distribution<float> position_distribution(-5.0, 105.0);
+  std::uniform_int_distribution<unsigned int> bin_distribution(0, 71);
+  for (unsigned int i = 0; i != 2000; ++i) {
+    const float x = position_distribution(generator);
+    const float y = position_distribution(generator);
+    const unsigned int bin = bin_distribution(generator);
+    if (x < 0.0f || y < 0.0f || x > 99.0f || y > 99.0f ||
+      costmap->getCost(
+        static_cast<unsigned int>(x + 0.5f), static_cast<unsigned int>(y + 0.5f)) >= 253)
+    {
+      continue;
+    }
+
+    double wx, wy;
+    costmap->mapToWorld(static_cast<double>(x), static_cast<double>(y), wx, wy);
+    collision_checker.inCollision(x, y, static_cast<float>(bin), false);
+    EXPECT_EQ(
+      collision_checker.getCost(),
+      static_cast<float>(collision_checker.footprintCostAtPose(wx, wy, angles[bin], footprint)));
+  }
+}
+
+
+TEST(collision_footprint, test_poses_collision)
+{
+  auto node = std::make_shared<rclcpp_lifecycle::LifecycleNode>("testG");
+  auto costmap_ros = std::make_shared<nav2_costmap_2d::Costmap2DROS>();
+  costmap_ros->on_configure(rclcpp_lifecycle::State());
+  auto costmap = costmap_ros->getCostmap();
+  *costmap = nav2_costmap_2d::Costmap2D(100, 100, 0.05, 0.0, 0.0, 0);
+  for (unsigned int i = 40; i != 60; ++i) {
+    costmap->setCost(i, 70, 254);
+    costmap->setCost(i, 30, 100);
+  }
+
+  geometry_msgs::msg::Point p1, p2, p3, p4;
+  p1.x = 0.3;
+  p1.y = 0.2;
+  p2.x = 0.3;
+  p2.y = -0.2;
+  p3.x = -0.3;
+  p3.y = -0.2;
+  p4.x = -0.3;
+  p4.y = 0.2;
+  nav2_costmap_2d::Footprint footprint = {p1, p2, p3, p4};
+
+  nav2_smac_planner::GridCollisionChecker collision_checker(costmap_ros, 72, node);
+  collision_checker.setFootprint(footprint, false /*use footprint*/, 0.0);
+
+  // Poses along x = 50: the footprint reaches the costed row, then the lethal one
+  nav2_smac_planner::MotionPoses poses;
+  for (float y = 10.0f; y < 50.0f; y += 1.0f) {
+    poses.emplace_back(50.0f, y, 18.0f, nav2_smac_planner::TurnDirection::UNKNOWN);
+  }
+  std::vector<float> costs;
+  EXPECT_FALSE(collision_checker.inCollision(poses, false, costs));
+  ASSERT_EQ(costs.size(), poses.size());
+  for (unsigned int i = 0; i != poses.size(); ++i) {
+    collision_checker.inCollision(poses[i]._x, poses[i]._y, poses[i]._theta, false);
+    EXPECT_EQ(costs[i], collision_checker.getCost());
+  }
+  EXPECT_EQ(*std::max_element(costs.begin(), costs.end()), 100.0f);
+
+  poses.emplace_back(50.0f, 60.0f, 18.0f, nav2_smac_planner::TurnDirection::UNKNOWN);
+  EXPECT_FALSE(collision_checker.inCollision(poses, false, costs));
+  poses.emplace_back(50.0f, 65.0f, 18.0f, nav2_smac_planner::TurnDirection::UNKNOWN);
+  EXPECT_TRUE(collision_checker.inCollision(poses, false, costs));
+  poses.pop_back();
+  poses.emplace_back(50.0f, 70.0f, 18.0f, nav2_smac_planner::TurnDirection::UNKNOWN);
+  EXPECT_TRUE(collision_checker.inCollision(poses, false, costs));
+  poses.back()._x = 101.0f;
+  EXPECT_TRUE(collision_checker.inCollision(poses, false, costs));
+}
+
+TEST(collision_footprint, test_corridor)
+{
+  auto node = std::make_shared<rclcpp_lifecycle::LifecycleNode>("testH");
+  auto costmap_ros = std::make_shared<nav2_costmap_2d::Costmap2DROS>();
+  costmap_ros->on_configure(rclcpp_lifecycle::State());
+  auto costmap = costmap_ros->getCostmap();
+  *costmap = nav2_costmap_2d::Costmap2D(100, 100, 0.05, 0.0, 0.0, 0);
+
+  nav2_smac_planner::GridCollisionChecker collision_checker(costmap_ros, 72, node);
+  nav2_costmap_2d::Footprint footprint;
+  collision_checker.setFootprint(footprint, true /*radius / pointcose*/, 0.0);
+
+  // Only the left half of the costmap is in the corridor
+  std::vector<unsigned char> corridor(100 * 100, 0);
+  for (unsigned int y = 0; y != 100; ++y) {
+    for (unsigned int x = 0; x != 50; ++x) {
+      corridor[y * 100 + x] = 1;
+    }
+  }
+  collision_checker.setCorridor(&corridor);
+  EXPECT_FALSE(collision_checker.inCollision(20.0, 20.0, 0.0, false));
+  EXPECT_TRUE(collision_checker.inCollision(70.0, 20.0, 0.0, false));
+  EXPECT_FALSE(collision_checker.inCollision(20 * 100 + 20, false));
+  EXPECT_TRUE(collision_checker.inCollision(20 * 100 + 70, false));
+
+  nav2_smac_planner::MotionPoses poses;
+  std::vector<float> costs;
+  poses.emplace_back(20.0f, 20.0f, 0.0f, nav2_smac_planner::TurnDirection::UNKNOWN);
+  EXPECT_FALSE(collision_checker.inCollision(poses, false, costs));
+  poses.emplace_back(70.0f, 20.0f, 0.0f, nav2_smac_planner::TurnDirection::UNKNOWN);
+  EXPECT_TRUE(collision_checker.inCollision(poses, false, costs));
+
+  collision_checker.setCorridor(nullptr);
+  EXPECT_FALSE(collision_checker.inCollision(70.0, 20.0, 0.0, false));
+  EXPECT_FALSE(collision_checker.inCollision(poses, false, costs));
+}
@@ -12,6 +12,7 @@
 // See the License for the specific language governing permissions and
 // limitations under the License. Reserved.
 
+#include <algorithm>
 #include <memory>
 #include <vector>
 
@@ -65,3 +66,41 @@ TEST(CostmapDownsampler, costmap_downsample_test)
 
   downsampler.resizeCostmap();
 }
+
+TEST(CostmapDownsampler, costmap_downsample_threads_test)
+{
+  nav2_util::LifecycleNode::SharedPtr node = std::make_shared<nav2_util::LifecycleNode>(
+    "CostmapDownsamplerThreadsTest");
+
+  // Odd sizes, for partial blocks of subcells on the last row and column
+  nav2_costmap_2d::Costmap2D costmap(103, 77, 0.05, 0.0, 0.0, 0);
+  for (unsigned int i = 0; i < 103; ++i) {
+    for (unsigned int j = 0; j < 77; ++j) {
+      costmap.setCost(i, j, static_cast<unsigned char>((i * 7 + j * 13) % 256));
+    }
+  }
+
+  for (bool use_min_cost_neighbor : {false, true}) {
+    nav2_smac_planner::CostmapDownsampler downsampler;
+    downsampler.on_configure(
+      node, "map", "unused_topic", &costmap, 3, use_min_cost_neighbor, 3);
+    nav2_costmap_2d::Costmap2D * downsampled = downsampler.downsample(3);
+    ASSERT_EQ(downsampled->getSizeInCellsX(), 35u);
+    ASSERT_EQ(downsampled->getSizeInCellsY(), 26u);
+
+    for (unsigned int i = 0; i < 35; ++i) {
+      for (unsigned int j = 0; j < 26; ++j) {
+        unsigned char expected = use_min_cost_neighbor ? 255 : 0;
+        for (unsigned int mx = 3 * i; mx < std::min(3 * i + 3, 103u); ++mx) {
+          for (unsigned int my = 3 * j; my < std::min(3 * j + 3, 77u); ++my) {
+            expected = use_min_cost_neighbor ?
+              std::min(expected, costmap.getCost(mx, my)) :
+              std::max(expected, costmap.getCost(mx, my));
+          }
+        }
+        EXPECT_EQ(downsampled->getCost(i, j), expected);
+      }
+    }
+  }
+}
+
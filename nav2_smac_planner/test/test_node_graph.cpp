@@ -0,0 +1,61 @@
+// Copyright (c) 2020, Samsung Research America
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License. Reserved.
+
+#include <limits>
+
+#include "gtest/gtest.h"
+#include "nav2_smac_planner/node_2d.hpp"
+#include "nav2_smac_planner/node_hybrid.hpp"
+#include "nav2_smac_planner/node_graph.hpp"
+
+TEST(NodeGraphTest, test_node_graph)
+{
+  nav2_smac_planner::NodeGraph<nav2_smac_planner::Node2D> graph;
+  graph.resize(10000);
+  EXPECT_TRUE(graph.empty());
+  EXPECT_EQ(graph.find(5000), nullptr);
+
+  nav2_smac_planner::Node2D * node = graph.get(5000);
+  EXPECT_EQ(node->getIndex(), 5000u);
+  EXPECT_EQ(graph.find(5000), node);
+  EXPECT_EQ(graph.get(5000), node);
+  EXPECT_EQ(graph.size(), 1u);
+  EXPECT_EQ(graph.find(5001), nullptr);
+
+  // Cleared nodes keep their address, but are reset on their next use
+  node->setAccumulatedCost(1.0);
+  node->visited();
+  graph.clear();
+  EXPECT_TRUE(graph.empty());
+  EXPECT_EQ(graph.find(5000), nullptr);
+  EXPECT_EQ(graph.get(5000), node);
+  EXPECT_EQ(node->getIndex(), 5000u);
+  EXPECT_FALSE(node->wasVisited());
+  EXPECT_EQ(node->getAccumulatedCost(), std::numeric_limits<float>::max());
+
+  // Resizing to the same size keeps the nodes, to another size drops them
+  graph.get(9999);
+  graph.resize(10000);
+  EXPECT_NE(graph.find(9999), nullptr);
+  graph.resize(20000);
+  EXPECT_EQ(graph.find(9999), nullptr);
+  EXPECT_EQ(graph.get(19999)->getIndex(), 19999u);
+
+  nav2_smac_planner::NodeGraph<nav2_smac_planner::NodeHybrid> hybrid_graph;
+  hybrid_graph.resize(100 * 100 * 72);
+  auto hybrid_node = hybrid_graph.get(100 * 100 * 72 - 1);
+  hybrid_node->setPose(nav2_smac_planner::NodeHybrid::Coordinates(99.0, 99.0, 71.0));
+  hybrid_graph.clear();
+  EXPECT_EQ(hybrid_graph.get(100 * 100 * 72 - 1)->pose.x, 0.0);
+}
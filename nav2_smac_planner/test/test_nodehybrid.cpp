@@ -239,6 +239,60 @@ TEST(NodeHybridTest, test_obstacle_heuristic)
   nav2_smac_planner::NodeHybrid::destroyStaticAssets();
 }
 
+TEST(NodeHybridTest, test_obstacle_heuristic_repair)
+{
+  nav2_smac_planner::SearchInfo info;
+  info.minimum_turning_radius = 8;
+  info.cost_penalty = 1.7;
+  unsigned int size_x = 100;
+  unsigned int size_y = 100;
+  unsigned int size_theta = 72;
+  nav2_smac_planner::NodeHybrid::initMotionModel(
+    nav2_smac_planner::MotionModel::DUBIN, size_x, size_y, size_theta, info);
+
+  auto costmap_ros = std::make_shared<nav2_costmap_2d::Costmap2DROS>();
+  costmap_ros->on_configure(rclcpp_lifecycle::State());
+  auto costmap = costmap_ros->getCostmap();
+  *costmap = nav2_costmap_2d::Costmap2D(100, 100, 0.1, 0.0, 0.0, 0);
+
+  nav2_smac_planner::NodeHybrid::Coordinates start(10.0, 50.0, 0.0), goal(90.0, 50.0, 0.0);
+  nav2_smac_planner::NodeHybrid::resetObstacleHeuristic(costmap_ros, 10, 50, 90, 50);
+  const float free_cost = nav2_smac_planner::NodeHybrid::getObstacleHeuristic(
+    start, goal, info.cost_penalty);
+  EXPECT_TRUE(
+    nav2_smac_planner::NodeHybrid::repairObstacleHeuristic(
+      costmap_ros, 90, 50, info.cost_penalty));
+
+  // A new wall across the straight path makes the repaired heuristic go around it
+  for (unsigned int j = 30; j <= 70; ++j) {
+    costmap->setCost(50, j, 254);
+  }
+  EXPECT_TRUE(
+    nav2_smac_planner::NodeHybrid::repairObstacleHeuristic(
+      costmap_ros, 90, 50, info.cost_penalty));
+  const float repaired_cost = nav2_smac_planner::NodeHybrid::getObstacleHeuristic(
+    start, goal, info.cost_penalty);
+  EXPECT_GT(repaired_cost, free_cost);
+
+  nav2_smac_planner::NodeHybrid::resetObstacleHeuristic(costmap_ros, 10, 50, 90, 50);
+  EXPECT_NEAR(
+    nav2_smac_planner::NodeHybrid::getObstacleHeuristic(start, goal, info.cost_penalty),
+    repaired_cost, 1e-3);
+
+  // Other goals and penalties, and lowered costs, cannot be repaired
+  EXPECT_FALSE(
+    nav2_smac_planner::NodeHybrid::repairObstacleHeuristic(
+      costmap_ros, 80, 50, info.cost_penalty));
+  EXPECT_FALSE(
+    nav2_smac_planner::NodeHybrid::repairObstacleHeuristic(costmap_ros, 90, 50, 2.0));
+  costmap->setCost(50, 50, 0);
+  EXPECT_FALSE(
+    nav2_smac_planner::NodeHybrid::repairObstacleHeuristic(
+      costmap_ros, 90, 50, info.cost_penalty));
+
+  nav2_smac_planner::NodeHybrid::destroyStaticAssets();
+}
+
 TEST(NodeHybridTest, test_node_debin_neighbors)
 {
   nav2_smac_planner::SearchInfo info;
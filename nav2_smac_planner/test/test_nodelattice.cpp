@@ -397,3 +397,91 @@ TEST(NodeLatticeTest, test_node_lattice_custom_footprint)
 
   delete costmap;
 }
+
+TEST(NodeLatticeTest, test_node_lattice_primitive_collision_poses)
+{
+  auto lnode = std::make_shared<rclcpp_lifecycle::LifecycleNode>("test");
+  std::string pkg_share_dir = ament_index_cpp::get_package_share_directory("nav2_smac_planner");
+  std::string filePath =
+    pkg_share_dir +
+    "/sample_primitives/5cm_resolution/0.5m_turning_radius/ackermann" +
+    "/output.json";
+
+  nav2_smac_planner::SearchInfo info;
+  info.minimum_turning_radius = 0.5;
+  info.non_straight_penalty = 1;
+  info.change_penalty = 1;
+  info.reverse_penalty = 1;
+  info.cost_penalty = 1;
+  info.retrospective_penalty = 0.1;
+  info.analytic_expansion_ratio = 1;
+  info.lattice_filepath = filePath;
+  info.cache_obstacle_heuristic = true;
+  info.allow_reverse_expansion = true;
+
+  unsigned int x = 100;
+  unsigned int y = 100;
+  unsigned int angle_quantization = 16;
+
+  nav2_smac_planner::NodeLattice::initMotionModel(
+    nav2_smac_planner::MotionModel::STATE_LATTICE, x, y, angle_quantization, info);
+
+  nav2_smac_planner::NodeLattice node(49);
+  node.pose.x = 20;
+  node.pose.y = 20;
+  node.pose.theta = 0;
+
+  // Pick the primitive with the most poses to check
+  unsigned int direction_change_index = 0;
+  nav2_smac_planner::MotionPrimitivePtrs motion_primitives =
+    nav2_smac_planner::NodeLattice::motion_table.getMotionPrimitives(&node, direction_change_index);
+  ASSERT_GT(motion_primitives.size(), 0u);
+  nav2_smac_planner::MotionPrimitive * primitive = motion_primitives[0];
+  for (unsigned int i = 0; i < direction_change_index; i++) {
+    EXPECT_EQ(
+      motion_primitives[i]->collision_poses.size(),
+      motion_primitives[i]->reverse_collision_poses.size());
+    if (motion_primitives[i]->collision_poses.size() > primitive->collision_poses.size()) {
+      primitive = motion_primitives[i];
+    }
+  }
+  ASSERT_GT(primitive->collision_poses.size(), 2u);
+
+  // Child at the end of the primitive, the first pose to check being the parent
+  const float & grid_resolution =
+    nav2_smac_planner::NodeLattice::motion_table.lattice_metadata.grid_resolution;
+  nav2_smac_planner::NodeLattice child(50);
+  child.pose.x = node.pose.x + primitive->poses.back()._x / grid_resolution;
+  child.pose.y = node.pose.y + primitive->poses.back()._y / grid_resolution;
+  child.pose.theta = primitive->end_angle;
+  EXPECT_NEAR(child.pose.x + primitive->collision_poses.front()._x, node.pose.x, 1e-4);
+  EXPECT_NEAR(child.pose.y + primitive->collision_poses.front()._y, node.pose.y, 1e-4);
+
+  // Obstacle on a pose in the middle of the primitive only
+  const nav2_smac_planner::MotionPose & middle_pose =
+    primitive->collision_poses[primitive->collision_poses.size() / 2];
+  const unsigned int obstacle_x = static_cast<unsigned int>(child.pose.x + middle_pose._x + 0.5f);
+  const unsigned int obstacle_y = static_cast<unsigned int>(child.pose.y + middle_pose._y + 0.5f);
+  nav2_costmap_2d::Costmap2D * costmap = new nav2_costmap_2d::Costmap2D(
+    40, 40, 0.05, 0.0, 0.0, 0);
+  costmap->setCost(obstacle_x, obstacle_y, 254);
+
+  // Convert raw costmap into a costmap ros object
+  auto costmap_ros = std::make_shared<nav2_costmap_2d::Costmap2DROS>();
+  costmap_ros->on_configure(rclcpp_lifecycle::State());
+  auto costmapi = costmap_ros->getCostmap();
+  *costmapi = *costmap;
+
+  std::unique_ptr<nav2_smac_planner::GridCollisionChecker> checker =
+    std::make_unique<nav2_smac_planner::GridCollisionChecker>(costmap_ros, 72, lnode);
+  checker->setFootprint(nav2_costmap_2d::Footprint(), true, 0.0);
+
+  EXPECT_TRUE(child.isNodeValid(true, checker.get()));
+  EXPECT_FALSE(child.isNodeValid(true, checker.get(), primitive, false));
+
+  costmapi->setCost(obstacle_x, obstacle_y, 100);
+  EXPECT_TRUE(child.isNodeValid(true, checker.get(), primitive, false));
+  EXPECT_EQ(child.getCost(), 100.0f);
+
+  delete costmap;
+}
@@ -0,0 +1,106 @@
+// Copyright (c) 2024 Open Navigation LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <cstdio>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "nav2_smac_planner/route_graph.hpp"
+
+using namespace nav2_smac_planner;  // NOLINT
+
+std::string writeGraph(const std::string & name, const std::string & contents)
+{
+  std::string filepath = "/tmp/" + name + ".json";
+  std::ofstream file(filepath);
+  file << contents;
+  return filepath;
+}
+
+TEST(RouteGraphTest, test_load)
+{
+  RouteGraph graph;
+  EXPECT_THROW(graph.load("/not/a/route/graph.json"), std::runtime_error);
+
+  std::string filepath = writeGraph(
+    "route_graph_load",
+    R"({"nodes": [{"id": 4, "x": 0.0, "y": 0.0, "metadata": {"name": "gate", "floor": 1}},
+                  {"id": 7, "x": 3.0, "y": 4.0}],
+        "edges": [{"start": 4, "end": 7, "bidirectional": false,
+                   "metadata": {"speed_limit": 1.5}}]})");
+  graph.load(filepath);
+  std::remove(filepath.c_str());
+
+  const auto & nodes = graph.getNodes();
+  ASSERT_EQ(nodes.size(), 2u);
+  EXPECT_EQ(nodes[0].id, 4u);
+  EXPECT_EQ(nodes[0].metadata.at("name"), "gate");
+  EXPECT_EQ(nodes[0].metadata.at("floor"), "1");
+  ASSERT_EQ(nodes[0].edges.size(), 1u);
+  EXPECT_EQ(nodes[0].edges[0].end, 1u);
+  EXPECT_FLOAT_EQ(nodes[0].edges[0].cost, 5.0f);
+  EXPECT_EQ(nodes[0].edges[0].metadata.at("speed_limit"), "1.5");
+  EXPECT_TRUE(nodes[1].edges.empty());
+
+  filepath = writeGraph(
+    "route_graph_invalid",
+    R"({"nodes": [{"id": 0, "x": 0.0, "y": 0.0}],
+        "edges": [{"start": 0, "end": 1}]})");
+  EXPECT_THROW(graph.load(filepath), std::runtime_error);
+  std::remove(filepath.c_str());
+  // A failed load keeps the graph
+  EXPECT_EQ(graph.getNodes().size(), 2u);
+}
+
+TEST(RouteGraphTest, test_find_route)
+{
+  // A square of 10m sides, its direct edge 0 -> 2 costing more than going around
+  std::string filepath = writeGraph(
+    "route_graph_square",
+    R"({"nodes": [{"id": 0, "x": 0.0, "y": 0.0}, {"id": 1, "x": 10.0, "y": 0.0},
+                  {"id": 2, "x": 10.0, "y": 10.0}, {"id": 3, "x": 0.0, "y": 10.0}],
+        "edges": [{"start": 0, "end": 1}, {"start": 1, "end": 2},
+                  {"start": 2, "end": 3}, {"start": 3, "end": 0},
+                  {"start": 0, "end": 2, "cost": 50.0}]})");
+  RouteGraph graph;
+  graph.load(filepath);
+  std::remove(filepath.c_str());
+
+  auto starts = graph.getNodesWithin(1.0, 0.0, 5.0, 3);
+  ASSERT_EQ(starts.size(), 1u);
+  EXPECT_EQ(starts[0].node, 0u);
+  EXPECT_FLOAT_EQ(starts[0].cost, 1.0f);
+  EXPECT_EQ(graph.getNodesWithin(5.0, 5.0, 8.0, 2).size(), 2u);
+  EXPECT_TRUE(graph.getNodesWithin(5.0, 5.0, 1.0, 2).empty());
+
+  std::vector<unsigned int> route;
+  ASSERT_TRUE(graph.findRoute({{0, 0.0f}}, {{2, 0.0f}}, route));
+  ASSERT_EQ(route.size(), 3u);
+  EXPECT_EQ(route.front(), 0u);
+  EXPECT_EQ(route.back(), 2u);
+
+  // The goal connection of least total cost is chosen
+  ASSERT_TRUE(graph.findRoute({{0, 0.0f}}, {{1, 30.0f}, {3, 1.0f}}, route));
+  EXPECT_EQ(route, std::vector<unsigned int>({0, 3}));
+
+  // A route may be a single node
+  ASSERT_TRUE(graph.findRoute({{1, 2.0f}}, {{1, 2.0f}}, route));
+  EXPECT_EQ(route, std::vector<unsigned int>({1}));
+
+  EXPECT_FALSE(graph.findRoute({}, {{1, 0.0f}}, route));
+  EXPECT_TRUE(route.empty());
+}
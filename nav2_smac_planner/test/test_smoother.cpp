@@ -148,6 +148,7 @@ TEST(SmootherTest, test_full_smoother)
   // Test smoother, should succeed with same number of points
   // and shorter overall length, while still being collision free.
   auto path_size_in = plan.poses.size();
+  nav_msgs::msg::Path threaded_plan = plan;
   EXPECT_TRUE(smoother->smooth(plan, costmap, maxtime));
   EXPECT_EQ(plan.poses.size(), path_size_in);  // Should have same number of poses
   double length = 0.0;
@@ -162,6 +163,18 @@ TEST(SmootherTest, test_full_smoother)
   }
   EXPECT_LT(length, initial_length);  // Should be shorter
 
+  // Smoothing the segments concurrently should give the same path
+  params.num_threads_ = 3;
+  auto smoother_threaded = std::make_unique<SmootherWrapper>(params);
+  smoother_threaded->initialize(0.4 /*turning radius*/);
+  EXPECT_TRUE(smoother_threaded->smooth(threaded_plan, costmap, maxtime));
+  ASSERT_EQ(threaded_plan.poses.size(), plan.poses.size());
+  for (unsigned int i = 0; i != plan.poses.size(); i++) {
+    EXPECT_NEAR(threaded_plan.poses[i].pose.position.x, plan.poses[i].pose.position.x, 1e-9);
+    EXPECT_NEAR(threaded_plan.poses[i].pose.position.y, plan.poses[i].pose.position.y, 1e-9);
+  }
+  params.num_threads_ = 1;
+
   // Try again but with failure modes
 
   // Failure mode: not enough iterations to complete
@@ -147,3 +147,25 @@ TEST(create_marker, test_createMarker)
   EXPECT_EQ(marker2.id, 8u);
   EXPECT_EQ(marker2.points.size(), 0u);
 }
+
+TEST(distance_heuristic_cache, test_save_and_load)
+{
+  const std::string directory = "/tmp";
+  const std::vector<float> key = {1.0f, 8.0f, 400.0f, 72.0f};
+  const std::vector<float> table = {0.0f, 1.5f, 2.5f, 3.5f};
+  const std::string filepath = getDistanceHeuristicCachePath(directory, "test", key);
+  EXPECT_NE(filepath, getDistanceHeuristicCachePath(directory, "test", {1.0f, 8.0f, 400.0f}));
+  std::remove(filepath.c_str());
+
+  std::vector<float> loaded(table.size());
+  EXPECT_FALSE(loadDistanceHeuristicCache(filepath, key, loaded));
+  EXPECT_TRUE(saveDistanceHeuristicCache(filepath, key, table));
+  EXPECT_TRUE(loadDistanceHeuristicCache(filepath, key, loaded));
+  EXPECT_EQ(loaded, table);
+
+  // Other keys and sizes are not loaded
+  EXPECT_FALSE(loadDistanceHeuristicCache(filepath, {1.0f, 4.0f, 400.0f, 72.0f}, loaded));
+  std::vector<float> larger(table.size() + 1);
+  EXPECT_FALSE(loadDistanceHeuristicCache(filepath, key, larger));
+  std::remove(filepath.c_str());
+}
@@ -143,6 +143,37 @@ protected:
    */
   bool validate(const nav_msgs::msg::Path & path);
 
+  /**
+   * @struct nav2_smoother::SmootherServer::SmoothedPath
+   * @brief Last path smoothed by a smoother, to smooth the next one incrementally
+   */
+  struct SmoothedPath
+  {
+    nav_msgs::msg::Path input;
+    nav_msgs::msg::Path output;
+    // Duration of the last smoothing of a whole path
+    rclcpp::Duration full_duration{0, 0};
+  };
+
+  /**
+   * @brief Smooth only the part of a path which changed since the last path smoothed,
+   * when the path ends like it. The changed part is smoothed with a blending window
+   * of the shared end, joining the end of the last smoothed path which is reused.
+   * @param smoother_id Smoother to use
+   * @param last Last path smoothed by the smoother
+   * @param path In-out path to smooth
+   * @param max_time Maximum duration smoothing should take
+   * @param was_completed Output whether the smoother completed smoothing in time
+   * @return Number of poses reused at the end of the path, 0 if the path
+   * could not be smoothed incrementally and was left as it was
+   */
+  size_t smoothIncrementally(
+    const std::string & smoother_id,
+    const SmoothedPath & last,
+    nav_msgs::msg::Path & path,
+    const rclcpp::Duration & max_time,
+    bool & was_completed);
+
   // Our action server implements the SmoothPath action
   std::unique_ptr<ActionServer> action_server_;
 
@@ -162,6 +193,12 @@ protected:
   std::vector<std::string> smoother_types_;
   std::string smoother_ids_concat_, current_smoother_;
 
+  // Incremental smoothing
+  bool incremental_smoothing_;
+  double incremental_tolerance_;
+  int incremental_blend_poses_;
+  std::unordered_map<std::string, SmoothedPath> smoothed_paths_;
+
   // Utilities
   std::shared_ptr<nav2_costmap_2d::CostmapSubscriber> costmap_sub_;
   std::shared_ptr<nav2_costmap_2d::FootprintSubscriber> footprint_sub_;
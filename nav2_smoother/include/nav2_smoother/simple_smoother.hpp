@@ -101,27 +101,23 @@ protected:
     const double & max_time);
 
   /**
-   * @brief Get the field value for a given dimension
-   * @param msg Current pose to sample
-   * @param dim Dimension ID of interest
-   * @return dim value
-   */
-  inline double getFieldByDim(
-    const geometry_msgs::msg::PoseStamped & msg,
-    const unsigned int & dim);
-
-  /**
-   * @brief Set the field value for a given dimension
-   * @param msg Current pose to sample
-   * @param dim Dimension ID of interest
-   * @param value to set the dimention to for the pose
+   * @brief Smooth the positions of a segment until convergence, using them as
+   * the original data locations. The end points are kept.
+   * @param x In-out x coordinates of the segment
+   * @param y In-out y coordinates of the segment
+   * @param costmap Pointer to minimal costmap
+   * @param max_time Maximum time to compute, stop early if over limit
+   * @return If smoothing converged, the positions being left at the last
+   * admissible ones otherwise
    */
-  inline void setFieldByDim(
-    geometry_msgs::msg::PoseStamped & msg, const unsigned int dim,
-    const double & value);
+  bool smoothPoints(
+    std::vector<double> & x,
+    std::vector<double> & y,
+    const nav2_costmap_2d::Costmap2D * costmap,
+    const double & max_time);
 
   double tolerance_, data_w_, smooth_w_;
-  int max_its_, refinement_ctr_, refinement_num_;
+  int max_its_, refinement_num_;
   bool do_refinement_;
   std::shared_ptr<nav2_costmap_2d::CostmapSubscriber> costmap_sub_;
   rclcpp::Logger logger_{rclcpp::get_logger("SimpleSmoother")};
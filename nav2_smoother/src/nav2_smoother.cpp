@@ -14,7 +14,9 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+#include <algorithm>
 #include <chrono>
+#include <cmath>
 #include <memory>
 #include <string>
 #include <utility>
@@ -32,6 +34,9 @@ using namespace std::chrono_literals;
 namespace nav2_smoother
 {
 
+// Fewest poses smoothed when smoothing a path incrementally
+static constexpr size_t MIN_INCREMENTAL_POSES = 11;
+
 SmootherServer::SmootherServer(const rclcpp::NodeOptions & options)
 : LifecycleNode("smoother_server", "", options),
   lp_loader_("nav2_core", "nav2_core::Smoother"),
@@ -55,6 +60,10 @@ SmootherServer::SmootherServer(const rclcpp::NodeOptions & options)
   declare_parameter("smoother_plugins", default_ids_);
 
   declare_parameter("action_server_result_timeout", 10.0);
+
+  declare_parameter("incremental_smoothing", rclcpp::ParameterValue(false));
+  declare_parameter("incremental_tolerance", rclcpp::ParameterValue(0.01));
+  declare_parameter("incremental_blend_poses", rclcpp::ParameterValue(10));
 }
 
 SmootherServer::~SmootherServer()
@@ -90,6 +99,9 @@ SmootherServer::on_configure(const rclcpp_lifecycle::State &)
   this->get_parameter("footprint_topic", footprint_topic);
   this->get_parameter("transform_tolerance", transform_tolerance);
   this->get_parameter("robot_base_frame", robot_base_frame);
+  this->get_parameter("incremental_smoothing", incremental_smoothing_);
+  this->get_parameter("incremental_tolerance", incremental_tolerance_);
+  this->get_parameter("incremental_blend_poses", incremental_blend_poses_);
   costmap_sub_ = std::make_shared<nav2_costmap_2d::CostmapSubscriber>(
     shared_from_this(), costmap_topic);
   footprint_sub_ = std::make_shared<nav2_costmap_2d::FootprintSubscriber>(
@@ -208,6 +220,7 @@ SmootherServer::on_cleanup(const rclcpp_lifecycle::State &)
     it->second->cleanup();
   }
   smoothers_.clear();
+  smoothed_paths_.clear();
 
   // Release any allocated resources
   action_server_.reset();
@@ -281,9 +294,40 @@ void SmootherServer::smoothPlan()
       throw nav2_core::InvalidPath("Requested path to smooth is invalid");
     }
 
-    result->was_completed = smoothers_[current_smoother_]->smooth(
-      result->path, goal->max_smoothing_duration);
-    result->smoothing_duration = this->now() - start_time;
+    // The last path smoothed is forgotten until this one is smoothed successfully
+    SmoothedPath last_smoothed;
+    bool has_last_smoothed = false;
+    auto last_smoothed_it = smoothed_paths_.find(current_smoother_);
+    if (last_smoothed_it != smoothed_paths_.end()) {
+      last_smoothed = std::move(last_smoothed_it->second);
+      has_last_smoothed = true;
+      smoothed_paths_.erase(last_smoothed_it);
+    }
+
+    result->reused_poses = 0;
+    if (incremental_smoothing_ && has_last_smoothed) {
+      result->reused_poses = smoothIncrementally(
+        current_smoother_, last_smoothed, result->path, goal->max_smoothing_duration,
+        result->was_completed);
+    }
+    if (result->reused_poses == 0) {
+      result->was_completed = smoothers_[current_smoother_]->smooth(
+        result->path, goal->max_smoothing_duration);
+    }
+    rclcpp::Duration smoothing_duration = this->now() - start_time;
+    result->smoothing_duration = smoothing_duration;
+
+    SmoothedPath smoothed;
+    smoothed.full_duration = smoothing_duration;
+    if (result->reused_poses > 0) {
+      smoothed.full_duration = last_smoothed.full_duration;
+      if (last_smoothed.full_duration > smoothing_duration) {
+        result->smoothing_duration_saved = last_smoothed.full_duration - smoothing_duration;
+      }
+      RCLCPP_DEBUG(
+        get_logger(), "Smoothed the path incrementally, reusing %u poses",
+        result->reused_poses);
+    }
 
     if (!result->was_completed) {
       RCLCPP_INFO(
@@ -325,6 +369,12 @@ void SmootherServer::smoothPlan()
       get_logger(), "Smoother succeeded (time: %lf), setting result",
       rclcpp::Duration(result->smoothing_duration).seconds());
 
+    if (incremental_smoothing_) {
+      smoothed.input = goal->path;
+      smoothed.output = result->path;
+      smoothed_paths_[current_smoother_] = std::move(smoothed);
+    }
+
     action_server_->succeeded_current(result);
   } catch (nav2_core::InvalidSmoother & ex) {
     RCLCPP_ERROR(this->get_logger(), "%s", ex.what());
@@ -364,6 +414,64 @@ void SmootherServer::smoothPlan()
   }
 }
 
+size_t SmootherServer::smoothIncrementally(
+  const std::string & smoother_id,
+  const SmoothedPath & last,
+  nav_msgs::msg::Path & path,
+  const rclcpp::Duration & max_time,
+  bool & was_completed)
+{
+  // Poses of the last path are mapped to the smoothed ones by their index
+  const auto & last_input = last.input.poses;
+  const auto & last_output = last.output.poses;
+  if (last_input.size() != last_output.size() ||
+    last.input.header.frame_id != path.header.frame_id)
+  {
+    return 0;
+  }
+
+  // Number of poses the path ends with like the last one
+  const size_t size = path.poses.size();
+  const size_t last_size = last_input.size();
+  size_t shared = 0;
+  while (shared < size && shared < last_size) {
+    const auto & position = path.poses[size - 1 - shared].pose.position;
+    const auto & last_position = last_input[last_size - 1 - shared].pose.position;
+    if (std::hypot(position.x - last_position.x, position.y - last_position.y) >
+      incremental_tolerance_)
+    {
+      break;
+    }
+    shared++;
+  }
+  if (shared == 0) {
+    return 0;
+  }
+
+  // Smooth the changed poses and a blending window of the shared ones, leaving
+  // enough poses for the smoother to work with
+  const size_t changed = size - shared;
+  const size_t end = std::max(
+    changed + static_cast<size_t>(std::max(incremental_blend_poses_, 0)),
+    MIN_INCREMENTAL_POSES - 1);
+  if (end >= size - 1) {
+    return 0;
+  }
+  const size_t last_end = end + last_size - size;
+
+  // The smoothed part ends at a pose of the last smoothed path, to join its end
+  nav_msgs::msg::Path head;
+  head.header = path.header;
+  head.poses.assign(path.poses.begin(), path.poses.begin() + end);
+  head.poses.push_back(last_output[last_end]);
+  was_completed = smoothers_[smoother_id]->smooth(head, max_time);
+
+  head.poses.insert(
+    head.poses.end(), last_output.begin() + last_end + 1, last_output.end());
+  path.poses = std::move(head.poses);
+  return last_size - last_end - 1;
+}
+
 bool SmootherServer::validate(const nav_msgs::msg::Path & path)
 {
   if (path.poses.empty()) {
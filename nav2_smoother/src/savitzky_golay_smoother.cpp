@@ -12,8 +12,11 @@
 // See the License for the specific language governing permissions and
 // limitations under the License. Reserved.
 
+#include <algorithm>
+#include <future>
 #include <vector>
 #include <memory>
+#include <utility>
 #include "nav2_smoother/savitzky_golay_smoother.hpp"
 #include "nav2_core/smoother_exceptions.hpp"
 
@@ -49,41 +52,57 @@ bool SavitzkyGolaySmoother::smooth(
   steady_clock::time_point start = steady_clock::now();
   double time_remaining = max_time.seconds();
 
-  bool success = true, reversing_segment;
-  nav_msgs::msg::Path curr_path_segment;
-  curr_path_segment.header = path.header;
+  bool success = true;
 
   std::vector<PathSegment> path_segments = findDirectionalPathSegments(path);
 
+  // Populate path segments. They only share their end points, which are not smoothed,
+  // so they are smoothed in parallel before being assembled to the main path.
+  std::vector<PathSegment> smoothed_segments;
+  std::vector<nav_msgs::msg::Path> curr_path_segments;
   for (unsigned int i = 0; i != path_segments.size(); i++) {
     if (path_segments[i].end - path_segments[i].start > 9) {
-      // Populate path segment
-      curr_path_segment.poses.clear();
+      nav_msgs::msg::Path curr_path_segment;
+      curr_path_segment.header = path.header;
       std::copy(
         path.poses.begin() + path_segments[i].start,
         path.poses.begin() + path_segments[i].end + 1,
         std::back_inserter(curr_path_segment.poses));
+      smoothed_segments.push_back(path_segments[i]);
+      curr_path_segments.push_back(std::move(curr_path_segment));
+    }
+  }
 
-      // Make sure we're still able to smooth with time remaining
-      steady_clock::time_point now = steady_clock::now();
-      time_remaining = max_time.seconds() - duration_cast<duration<double>>(now - start).count();
+  // Make sure we're still able to smooth with time remaining
+  steady_clock::time_point now = steady_clock::now();
+  time_remaining = max_time.seconds() - duration_cast<duration<double>>(now - start).count();
 
-      if (time_remaining <= 0.0) {
-        RCLCPP_WARN(
-          logger_,
-          "Smoothing time exceeded allowed duration of %0.2f.", max_time.seconds());
-        throw nav2_core::SmootherTimedOut("Smoothing time exceed allowed duration");
-      }
+  if (!curr_path_segments.empty() && time_remaining <= 0.0) {
+    RCLCPP_WARN(
+      logger_,
+      "Smoothing time exceeded allowed duration of %0.2f.", max_time.seconds());
+    throw nav2_core::SmootherTimedOut("Smoothing time exceed allowed duration");
+  }
 
-      // Smooth path segment
-      success = success && smoothImpl(curr_path_segment, reversing_segment);
+  auto smooth_segment = [this, &curr_path_segments](size_t i) {
+      bool reversing_segment;
+      return smoothImpl(curr_path_segments[i], reversing_segment);
+    };
+  std::vector<std::future<bool>> results;
+  for (size_t i = 1; i < curr_path_segments.size(); i++) {
+    results.push_back(std::async(std::launch::async, smooth_segment, i));
+  }
+  bool first_segment_was_smoothed = curr_path_segments.empty() || smooth_segment(0);
 
-      // Assemble the path changes to the main path
-      std::copy(
-        curr_path_segment.poses.begin(),
-        curr_path_segment.poses.end(),
-        path.poses.begin() + path_segments[i].start);
-    }
+  for (size_t i = 0; i != curr_path_segments.size(); i++) {
+    // Smooth path segment
+    success = success && (i == 0 ? first_segment_was_smoothed : results[i - 1].get());
+
+    // Assemble the path changes to the main path
+    std::copy(
+      curr_path_segments[i].poses.begin(),
+      curr_path_segments[i].poses.end(),
+      path.poses.begin() + smoothed_segments[i].start);
   }
 
   return success;
@@ -106,87 +125,47 @@ bool SavitzkyGolaySmoother::smoothImpl(
     3.0 / 21.0,
     -2.0 / 21.0};
 
-  auto applyFilter = [&](const std::vector<geometry_msgs::msg::Point> & data)
-    -> geometry_msgs::msg::Point
+  // Filter the sample of an axis at idx. Samples are filtered in place, so the
+  // previous ones are already filtered. Boundary conditions: the first and last
+  // points are fixed, and repeated where the window goes past them.
+  auto applyFilter = [&](std::vector<double> & data, unsigned int idx) -> void
     {
-      geometry_msgs::msg::Point val;
+      double val = 0.0;
       for (unsigned int i = 0; i != filter.size(); i++) {
-        val.x += filter[i] * data[i].x;
-        val.y += filter[i] * data[i].y;
+        const int j = std::clamp<int>(static_cast<int>(idx + i) - 3, 0, path_size - 1);
+        val += filter[i] * data[j];
       }
-      return val;
+      data[idx] = val;
     };
 
-  auto applyFilterOverAxes =
-    [&](std::vector<geometry_msgs::msg::PoseStamped> & plan_pts) -> void
+  auto applyFilterOverAxis = [&](std::vector<double> & data) -> void
     {
-      // Handle initial boundary conditions, first point is fixed
-      unsigned int idx = 1;
-      plan_pts[idx].pose.position = applyFilter(
-      {
-        plan_pts[idx - 1].pose.position,
-        plan_pts[idx - 1].pose.position,
-        plan_pts[idx - 1].pose.position,
-        plan_pts[idx].pose.position,
-        plan_pts[idx + 1].pose.position,
-        plan_pts[idx + 2].pose.position,
-        plan_pts[idx + 3].pose.position});
-
-      idx++;
-      plan_pts[idx].pose.position = applyFilter(
-      {
-        plan_pts[idx - 2].pose.position,
-        plan_pts[idx - 2].pose.position,
-        plan_pts[idx - 1].pose.position,
-        plan_pts[idx].pose.position,
-        plan_pts[idx + 1].pose.position,
-        plan_pts[idx + 2].pose.position,
-        plan_pts[idx + 3].pose.position});
-
-      // Apply nominal filter
-      for (idx = 3; idx < path_size - 4; ++idx) {
-        plan_pts[idx].pose.position = applyFilter(
-        {
-          plan_pts[idx - 3].pose.position,
-          plan_pts[idx - 2].pose.position,
-          plan_pts[idx - 1].pose.position,
-          plan_pts[idx].pose.position,
-          plan_pts[idx + 1].pose.position,
-          plan_pts[idx + 2].pose.position,
-          plan_pts[idx + 3].pose.position});
+      for (unsigned int idx = 1; idx != path_size - 1; ++idx) {
+        // The nominal filter stops short of the terminal boundary conditions,
+        // leaving this sample as it is
+        if (idx != path_size - 4) {
+          applyFilter(data, idx);
+        }
       }
-
-      // Handle terminal boundary conditions, last point is fixed
-      idx++;
-      plan_pts[idx].pose.position = applyFilter(
-      {
-        plan_pts[idx - 3].pose.position,
-        plan_pts[idx - 2].pose.position,
-        plan_pts[idx - 1].pose.position,
-        plan_pts[idx].pose.position,
-        plan_pts[idx + 1].pose.position,
-        plan_pts[idx + 2].pose.position,
-        plan_pts[idx + 2].pose.position});
-
-      idx++;
-      plan_pts[idx].pose.position = applyFilter(
-      {
-        plan_pts[idx - 3].pose.position,
-        plan_pts[idx - 2].pose.position,
-        plan_pts[idx - 1].pose.position,
-        plan_pts[idx].pose.position,
-        plan_pts[idx + 1].pose.position,
-        plan_pts[idx + 1].pose.position,
-        plan_pts[idx + 1].pose.position});
     };
 
-  applyFilterOverAxes(path.poses);
+  // Filter contiguous arrays of each axis, written back to the path once done
+  std::vector<double> x(path_size), y(path_size);
+  for (unsigned int i = 0; i != path_size; i++) {
+    x[i] = path.poses[i].pose.position.x;
+    y[i] = path.poses[i].pose.position.y;
+  }
 
   // Lets do additional refinement, it shouldn't take more than a couple milliseconds
-  if (do_refinement_) {
-    for (int i = 0; i < refinement_num_; i++) {
-      applyFilterOverAxes(path.poses);
-    }
+  const int passes = do_refinement_ ? refinement_num_ + 1 : 1;
+  for (int pass = 0; pass != passes; pass++) {
+    applyFilterOverAxis(x);
+    applyFilterOverAxis(y);
+  }
+
+  for (unsigned int i = 0; i != path_size; i++) {
+    path.poses[i].pose.position.x = x[i];
+    path.poses[i].pose.position.y = y[i];
   }
 
   updateApproximatePathOrientations(path, reversing_segment);
@@ -12,8 +12,10 @@
 // See the License for the specific language governing permissions and
 // limitations under the License. Reserved.
 
+#include <future>
 #include <vector>
 #include <memory>
+#include <utility>
 #include "nav2_smoother/simple_smoother.hpp"
 #include "nav2_core/smoother_exceptions.hpp"
 
@@ -65,45 +67,58 @@ bool SimpleSmoother::smooth(
   steady_clock::time_point start = steady_clock::now();
   double time_remaining = max_time.seconds();
 
-  bool success = true, reversing_segment;
+  bool success = true;
   unsigned int segments_smoothed = 0;
-  nav_msgs::msg::Path curr_path_segment;
-  curr_path_segment.header = path.header;
 
   std::vector<PathSegment> path_segments = findDirectionalPathSegments(path);
 
   std::lock_guard<nav2_costmap_2d::Costmap2D::mutex_t> lock(*(costmap->getMutex()));
 
+  // Populate path segments. They only share their end points, which are not smoothed,
+  // so they are smoothed in parallel before being assembled to the main path.
+  std::vector<PathSegment> smoothed_segments;
+  std::vector<nav_msgs::msg::Path> curr_path_segments;
   for (unsigned int i = 0; i != path_segments.size(); i++) {
     if (path_segments[i].end - path_segments[i].start > 9) {
-      // Populate path segment
-      curr_path_segment.poses.clear();
+      nav_msgs::msg::Path curr_path_segment;
+      curr_path_segment.header = path.header;
       std::copy(
         path.poses.begin() + path_segments[i].start,
         path.poses.begin() + path_segments[i].end + 1,
         std::back_inserter(curr_path_segment.poses));
+      smoothed_segments.push_back(path_segments[i]);
+      curr_path_segments.push_back(std::move(curr_path_segment));
+    }
+  }
 
-      // Make sure we're still able to smooth with time remaining
-      steady_clock::time_point now = steady_clock::now();
-      time_remaining = max_time.seconds() - duration_cast<duration<double>>(now - start).count();
-      refinement_ctr_ = 0;
-
-      bool segment_was_smoothed = smoothImpl(
-        curr_path_segment, reversing_segment, costmap.get(), time_remaining);
+  // Make sure we're still able to smooth with time remaining
+  steady_clock::time_point now = steady_clock::now();
+  time_remaining = max_time.seconds() - duration_cast<duration<double>>(now - start).count();
+
+  auto smooth_segment = [&](size_t i) {
+      bool reversing_segment;
+      return smoothImpl(curr_path_segments[i], reversing_segment, costmap.get(), time_remaining);
+    };
+  std::vector<std::future<bool>> results;
+  for (size_t i = 1; i < curr_path_segments.size(); i++) {
+    results.push_back(std::async(std::launch::async, smooth_segment, i));
+  }
+  bool first_segment_was_smoothed = curr_path_segments.empty() || smooth_segment(0);
 
-      if (segment_was_smoothed) {
-        segments_smoothed++;
-      }
+  for (size_t i = 0; i != curr_path_segments.size(); i++) {
+    bool segment_was_smoothed = i == 0 ? first_segment_was_smoothed : results[i - 1].get();
+    if (segment_was_smoothed) {
+      segments_smoothed++;
+    }
 
-      // Smooth path segment naively
-      success = success && segment_was_smoothed;
+    // Smooth path segment naively
+    success = success && segment_was_smoothed;
 
-      // Assemble the path changes to the main path
-      std::copy(
-        curr_path_segment.poses.begin(),
-        curr_path_segment.poses.end(),
-        path.poses.begin() + path_segments[i].start);
-    }
+    // Assemble the path changes to the main path
+    std::copy(
+      curr_path_segments[i].poses.begin(),
+      curr_path_segments[i].poses.end(),
+      path.poses.begin() + smoothed_segments[i].start);
   }
 
   if (segments_smoothed == 0) {
@@ -118,18 +133,52 @@ bool SimpleSmoother::smoothImpl(
   bool & reversing_segment,
   const nav2_costmap_2d::Costmap2D * costmap,
   const double & max_time)
+{
+  // Smooth contiguous arrays of the positions, written back to the path once done
+  const unsigned int path_size = path.poses.size();
+  std::vector<double> x(path_size), y(path_size);
+  for (unsigned int i = 0; i != path_size; i++) {
+    x[i] = path.poses[i].pose.position.x;
+    y[i] = path.poses[i].pose.position.y;
+  }
+
+  // Lets do additional refinement passes, they shouldn't take more than a couple
+  // milliseconds but really put the path quality over the top.
+  // Only a failure of the first pass fails the smoothing.
+  bool success = true;
+  const int passes = do_refinement_ ? refinement_num_ + 1 : 1;
+  for (int pass = 0; pass != passes; pass++) {
+    if (!smoothPoints(x, y, costmap, max_time)) {
+      success = pass != 0;
+      break;
+    }
+  }
+
+  for (unsigned int i = 0; i != path_size; i++) {
+    path.poses[i].pose.position.x = x[i];
+    path.poses[i].pose.position.y = y[i];
+  }
+  updateApproximatePathOrientations(path, reversing_segment);
+  return success;
+}
+
+bool SimpleSmoother::smoothPoints(
+  std::vector<double> & x,
+  std::vector<double> & y,
+  const nav2_costmap_2d::Costmap2D * costmap,
+  const double & max_time)
 {
   steady_clock::time_point a = steady_clock::now();
   rclcpp::Duration max_dur = rclcpp::Duration::from_seconds(max_time);
 
   int its = 0;
   double change = tolerance_;
-  const unsigned int & path_size = path.poses.size();
-  double x_i, y_i, y_m1, y_ip1, y_i_org;
+  const size_t path_size = x.size();
+  double x_i_org, y_i_org;
   unsigned int mx, my;
 
-  nav_msgs::msg::Path new_path = path;
-  nav_msgs::msg::Path last_path = path;
+  const std::vector<double> data_x = x, data_y = y;
+  std::vector<double> last_x = x, last_y = y;
 
   while (change >= tolerance_) {
     its += 1;
@@ -140,8 +189,8 @@ bool SimpleSmoother::smoothImpl(
       RCLCPP_WARN(
         logger_,
         "Number of iterations has exceeded limit of %i.", max_its_);
-      path = last_path;
-      updateApproximatePathOrientations(path, reversing_segment);
+      x = last_x;
+      y = last_y;
       return false;
     }
 
@@ -152,32 +201,22 @@ bool SimpleSmoother::smoothImpl(
       RCLCPP_WARN(
         logger_,
         "Smoothing time exceeded allowed duration of %0.2f.", max_time);
-      path = last_path;
-      updateApproximatePathOrientations(path, reversing_segment);
       throw nav2_core::SmootherTimedOut("Smoothing time exceed allowed duration");
     }
 
-    for (unsigned int i = 1; i != path_size - 1; i++) {
-      for (unsigned int j = 0; j != 2; j++) {
-        x_i = getFieldByDim(path.poses[i], j);
-        y_i = getFieldByDim(new_path.poses[i], j);
-        y_m1 = getFieldByDim(new_path.poses[i - 1], j);
-        y_ip1 = getFieldByDim(new_path.poses[i + 1], j);
-        y_i_org = y_i;
-
-        // Smooth based on local 3 point neighborhood and original data locations
-        y_i += data_w_ * (x_i - y_i) + smooth_w_ * (y_ip1 + y_m1 - (2.0 * y_i));
-        setFieldByDim(new_path.poses[i], j, y_i);
-        change += abs(y_i - y_i_org);
-      }
+    for (size_t i = 1; i != path_size - 1; i++) {
+      x_i_org = x[i];
+      y_i_org = y[i];
+
+      // Smooth based on local 3 point neighborhood and original data locations
+      x[i] += data_w_ * (data_x[i] - x[i]) + smooth_w_ * (x[i + 1] + x[i - 1] - (2.0 * x[i]));
+      y[i] += data_w_ * (data_y[i] - y[i]) + smooth_w_ * (y[i + 1] + y[i - 1] - (2.0 * y[i]));
+      change += std::abs(x[i] - x_i_org) + std::abs(y[i] - y_i_org);
 
       // validate update is admissible, only checks cost if a valid costmap pointer is provided
       float cost = 0.0;
       if (costmap) {
-        costmap->worldToMap(
-          getFieldByDim(new_path.poses[i], 0),
-          getFieldByDim(new_path.poses[i], 1),
-          mx, my);
+        costmap->worldToMap(x[i], y[i], mx, my);
         cost = static_cast<float>(costmap->getCost(mx, my));
       }
 
@@ -186,52 +225,19 @@ bool SimpleSmoother::smoothImpl(
           rclcpp::get_logger("SmacPlannerSmoother"),
           "Smoothing process resulted in an infeasible collision. "
           "Returning the last path before the infeasibility was introduced.");
-        path = last_path;
-        updateApproximatePathOrientations(path, reversing_segment);
+        x = last_x;
+        y = last_y;
         return false;
       }
     }
 
-    last_path = new_path;
-  }
-
-  // Lets do additional refinement, it shouldn't take more than a couple milliseconds
-  // but really puts the path quality over the top.
-  if (do_refinement_ && refinement_ctr_ < refinement_num_) {
-    refinement_ctr_++;
-    smoothImpl(new_path, reversing_segment, costmap, max_time);
+    last_x = x;
+    last_y = y;
   }
 
-  updateApproximatePathOrientations(new_path, reversing_segment);
-  path = new_path;
   return true;
 }
 
-double SimpleSmoother::getFieldByDim(
-  const geometry_msgs::msg::PoseStamped & msg, const unsigned int & dim)
-{
-  if (dim == 0) {
-    return msg.pose.position.x;
-  } else if (dim == 1) {
-    return msg.pose.position.y;
-  } else {
-    return msg.pose.position.z;
-  }
-}
-
-void SimpleSmoother::setFieldByDim(
-  geometry_msgs::msg::PoseStamped & msg, const unsigned int dim,
-  const double & value)
-{
-  if (dim == 0) {
-    msg.pose.position.x = value;
-  } else if (dim == 1) {
-    msg.pose.position.y = value;
-  } else {
-    msg.pose.position.z = value;
-  }
-}
-
 }  // namespace nav2_smoother
 
 #include "pluginlib/class_list_macros.hpp"
@@ -0,0 +1,306 @@
+#! /usr/bin/env python3
+# Copyright (c) 2024 Open Navigation LLC
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+# Drives the navigation stack through a list of goals and records its performance: scan to
+# cmd_vel latency, planning time, costmap update time, and the CPU and memory of each node.
+# The metrics are written as a JSON report, compared across versions by compare_reports.py.
+
+import argparse
+import json
+import os
+import sys
+import time
+
+from action_msgs.msg import GoalStatus
+from geometry_msgs.msg import PoseStamped, PoseWithCovarianceStamped, Twist
+from lifecycle_msgs.srv import GetState
+from nav2_msgs.action import ComputePathToPose, NavigateToPose
+import rclpy
+from rclpy.action import ActionClient
+from rclpy.duration import Duration
+from rclpy.node import Node
+from rclpy.qos import qos_profile_sensor_data
+from rclpy.qos import QoSDurabilityPolicy, QoSProfile, QoSReliabilityPolicy
+from sensor_msgs.msg import LaserScan
+from std_msgs.msg import Float64
+
+NODES = [
+    'controller_server', 'planner_server', 'bt_navigator', 'behavior_server',
+    'velocity_smoother', 'collision_monitor', 'smoother_server', 'amcl', 'map_server',
+]
+
+
+def summarize(samples):
+    """Summarize a list of durations in seconds as milliseconds."""
+    if not samples:
+        return {'count': 0}
+    ordered = sorted(samples)
+
+    def percentile(p):
+        return 1e3 * ordered[min(len(ordered) - 1, int(p * len(ordered)))]
+
+    return {
+        'count': len(ordered),
+        'mean_ms': 1e3 * sum(ordered) / len(ordered),
+        'p50_ms': percentile(0.5),
+        'p95_ms': percentile(0.95),
+        'max_ms': 1e3 * ordered[-1],
+    }
+
+
+class ProcessSampler:
+    """Samples the CPU and resident memory of the node processes from /proc."""
+
+    def __init__(self, nodes):
+        self.ticks_per_second = os.sysconf('SC_CLK_TCK')
+        self.page_size = os.sysconf('SC_PAGE_SIZE')
+        self.pids = {}
+        for pid in filter(str.isdigit, os.listdir('/proc')):
+            try:
+                with open(f'/proc/{pid}/cmdline', 'rb') as f:
+                    args = f.read().split(b'\0')
+            except OSError:
+                continue
+            for node in nodes:
+                if f'__node:={node}'.encode() in args:
+                    self.pids[node] = pid
+        self.stats = {node: {'cpu_ticks': None, 'max_rss_mb': 0.0} for node in self.pids}
+        self.start = None
+        self.end = None
+
+    def sample(self):
+        now = time.monotonic()
+        for node, pid in self.pids.items():
+            try:
+                with open(f'/proc/{pid}/stat') as f:
+                    # Skip the command name, which may hold spaces
+                    fields = f.read().rsplit(')', 1)[1].split()
+            except OSError:
+                continue
+            ticks = int(fields[11]) + int(fields[12])
+            rss_mb = int(fields[21]) * self.page_size / 1e6
+            stats = self.stats[node]
+            if stats['cpu_ticks'] is None:
+                stats['start_ticks'] = ticks
+            stats['cpu_ticks'] = ticks
+            stats['max_rss_mb'] = max(stats['max_rss_mb'], rss_mb)
+        if self.start is None:
+            self.start = now
+        self.end = now
+
+    def report(self):
+        elapsed = max(self.end - self.start, 1e-9) if self.start is not None else 1e-9
+        report = {}
+        for node, stats in self.stats.items():
+            if stats['cpu_ticks'] is None:
+                continue
+            cpu = (stats['cpu_ticks'] - stats['start_ticks']) / self.ticks_per_second
+            report[node] = {
+                'cpu_percent': 100.0 * cpu / elapsed,
+                'max_rss_mb': stats['max_rss_mb'],
+            }
+        return report
+
+
+class BenchmarkTester(Node):
+
+    def __init__(self, initial_pose, goals):
+        super().__init__(node_name='nav2_benchmark_tester')
+        self.initial_pose = initial_pose
+        self.goals = goals
+
+        self.initial_pose_pub = self.create_publisher(
+            PoseWithCovarianceStamped, 'initialpose', 10)
+        pose_qos = QoSProfile(
+            durability=QoSDurabilityPolicy.TRANSIENT_LOCAL,
+            reliability=QoSReliabilityPolicy.RELIABLE,
+            depth=1,
+        )
+        self.initial_pose_received = False
+        self.create_subscription(
+            PoseWithCovarianceStamped, 'amcl_pose', self.poseCallback, pose_qos)
+        self.navigate_client = ActionClient(self, NavigateToPose, 'navigate_to_pose')
+        self.planner_client = ActionClient(self, ComputePathToPose, 'compute_path_to_pose')
+
+        # Latencies are measured on the wall clock, as the stack runs on the simulated one
+        self.pending_scan_time = None
+        self.scan_latencies = []
+        self.planning_times = []
+        self.update_times = {'local_costmap': [], 'global_costmap': []}
+        self.recording = False
+        self.create_subscription(
+            LaserScan, 'scan', self.scanCallback, qos_profile_sensor_data)
+        self.create_subscription(Twist, 'cmd_vel', self.cmdVelCallback, 10)
+        for costmap in self.update_times:
+            self.create_subscription(
+                Float64, f'{costmap}/{costmap}/update_time',
+                lambda msg, costmap=costmap: self.updateTimeCallback(costmap, msg), 10)
+
+        self.sampler = None
+
+    def info_msg(self, msg: str):
+        self.get_logger().info('\033[1;37;44m' + msg + '\033[0m')
+
+    def error_msg(self, msg: str):
+        self.get_logger().error('\033[1;37;41m' + msg + '\033[0m')
+
+    def getStampedPoseMsg(self, x, y):
+        msg = PoseStamped()
+        msg.header.frame_id = 'map'
+        msg.pose.position.x = x
+        msg.pose.position.y = y
+        msg.pose.orientation.w = 1.0
+        return msg
+
+    def poseCallback(self, msg):
+        self.initial_pose_received = True
+
+    def scanCallback(self, msg):
+        if self.recording and self.pending_scan_time is None:
+            self.pending_scan_time = time.monotonic()
+
+    def cmdVelCallback(self, msg):
+        if self.pending_scan_time is not None:
+            self.scan_latencies.append(time.monotonic() - self.pending_scan_time)
+            self.pending_scan_time = None
+
+    def updateTimeCallback(self, costmap, msg):
+        if self.recording:
+            self.update_times[costmap].append(msg.data)
+
+    def sampleProcesses(self):
+        if self.recording:
+            self.sampler.sample()
+
+    def waitForNodeActive(self, node_name):
+        state_client = self.create_client(GetState, f'{node_name}/get_state')
+        while not state_client.wait_for_service(timeout_sec=1.0):
+            self.info_msg(f'Waiting for {node_name} to come up')
+        state = ''
+        while state != 'active':
+            future = state_client.call_async(GetState.Request())
+            rclpy.spin_until_future_complete(self, future)
+            state = future.result().current_state.label if future.result() else ''
+            if state != 'active':
+                time.sleep(1.0)
+
+    def setInitialPose(self, timeout):
+        msg = PoseWithCovarianceStamped()
+        msg.header.frame_id = 'map'
+        msg.pose.pose = self.getStampedPoseMsg(*self.initial_pose).pose
+        start_time = time.time()
+        while not self.initial_pose_received:
+            if time.time() - start_time > timeout:
+                self.error_msg('Timeout waiting for the initial pose to be set')
+                return False
+            self.initial_pose_pub.publish(msg)
+            rclpy.spin_once(self, timeout_sec=1.0)
+        return True
+
+    def runAction(self, client, goal):
+        client.wait_for_server()
+        send_goal_future = client.send_goal_async(goal)
+        rclpy.spin_until_future_complete(self, send_goal_future)
+        goal_handle = send_goal_future.result()
+        if not goal_handle.accepted:
+            return None
+        result_future = goal_handle.get_result_async()
+        rclpy.spin_until_future_complete(self, result_future)
+        return result_future.result()
+
+    def runGoals(self, sample_period):
+        self.sampler = ProcessSampler(NODES)
+        self.info_msg(f'Sampling the processes of {", ".join(sorted(self.sampler.pids))}')
+        self.create_timer(sample_period, self.sampleProcesses)
+
+        self.recording = True
+        self.sampler.sample()
+        results = []
+        for x, y in self.goals:
+            # Plan separately first, the navigator does not report its planning time
+            plan_goal = ComputePathToPose.Goal()
+            plan_goal.goal = self.getStampedPoseMsg(x, y)
+            plan_goal.planner_id = 'GridBased'
+            plan = self.runAction(self.planner_client, plan_goal)
+            if plan is not None and plan.status == GoalStatus.STATUS_SUCCEEDED:
+                planning_time = Duration.from_msg(plan.result.planning_time)
+                self.planning_times.append(planning_time.nanoseconds * 1e-9)
+
+            navigate_goal = NavigateToPose.Goal()
+            navigate_goal.pose = self.getStampedPoseMsg(x, y)
+            start_time = time.monotonic()
+            navigation = self.runAction(self.navigate_client, navigate_goal)
+            succeeded = navigation is not None and \
+                navigation.status == GoalStatus.STATUS_SUCCEEDED
+            results.append({
+                'goal': [x, y],
+                'succeeded': succeeded,
+                'wall_time_s': time.monotonic() - start_time,
+            })
+            self.info_msg(f'Goal ({x}, {y}) {"succeeded" if succeeded else "failed"}')
+        self.sampler.sample()
+        self.recording = False
+        return results
+
+    def report(self, goal_results):
+        return {
+            'goals': goal_results,
+            'metrics': {
+                'scan_to_cmd_vel_latency': summarize(self.scan_latencies),
+                'planning_time': summarize(self.planning_times),
+                'local_costmap_update_time': summarize(self.update_times['local_costmap']),
+                'global_costmap_update_time': summarize(self.update_times['global_costmap']),
+            },
+            'nodes': self.sampler.report(),
+        }
+
+
+def main(argv=sys.argv[1:]):
+    parser = argparse.ArgumentParser(description='Navigation stack benchmark')
+    parser.add_argument('-r', '--robot', nargs=2, type=float, required=True,
+                        metavar=('init_x', 'init_y'), help='The robot starting position.')
+    parser.add_argument('-g', '--goal', nargs=2, type=float, action='append', required=True,
+                        metavar=('x', 'y'), help='A goal, repeated for several goals.')
+    parser.add_argument('-o', '--output', default='nav2_benchmark_report.json',
+                        help='Path of the JSON report')
+    parser.add_argument('--sample-period', type=float, default=1.0,
+                        help='Period of the CPU and memory sampling, in seconds')
+    args, unknown = parser.parse_known_args()
+
+    rclpy.init()
+    tester = BenchmarkTester(tuple(args.robot), [tuple(goal) for goal in args.goal])
+
+    tester.waitForNodeActive('amcl')
+    passed = tester.setInitialPose(timeout=30.0)
+    if passed:
+        tester.waitForNodeActive('bt_navigator')
+        results = tester.runGoals(args.sample_period)
+        report = tester.report(results)
+        with open(args.output, 'w') as f:
+            json.dump(report, f, indent=2)
+        tester.info_msg(f'Report written to {os.path.abspath(args.output)}')
+        for name, metric in report['metrics'].items():
+            if metric['count']:
+                tester.info_msg(
+                    f'{name}: mean {metric["mean_ms"]:.3f}ms, p95 {metric["p95_ms"]:.3f}ms')
+        passed = all(result['succeeded'] for result in results)
+
+    tester.destroy_node()
+    rclpy.try_shutdown()
+    sys.exit(0 if passed else 1)
+
+
+if __name__ == '__main__':
+    main()
@@ -0,0 +1,78 @@
+#!/usr/bin/python3
+# Copyright (c) 2024 Open Navigation LLC
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+# This tool compares the JSON report of a navigation benchmark run against the report of
+# a baseline version, and fails if any timing, node CPU or memory regressed beyond a
+# tolerance. Run compare_reports.py -h for instructions
+
+import argparse
+import json
+import sys
+
+
+def load_report(filename):
+    with open(filename) as f:
+        report = json.load(f)
+
+    values = {}
+    for name, metric in report['metrics'].items():
+        for key in ('mean_ms', 'p95_ms'):
+            if key in metric:
+                values[f'{name}.{key}'] = metric[key]
+    for node, stats in report['nodes'].items():
+        for key, value in stats.items():
+            values[f'{node}.{key}'] = value
+    failed = [result['goal'] for result in report['goals'] if not result['succeeded']]
+    return values, failed
+
+
+def main():
+    parser = argparse.ArgumentParser(
+        description='Compare navigation benchmark reports, produced by benchmark_tester.py')
+    parser.add_argument('report', help='JSON report of the run to check')
+    parser.add_argument('baseline', help='JSON report of the baseline run')
+    parser.add_argument('--tolerance', type=float, default=0.2,
+                        help='Allowed relative increase over the baseline (default 0.2)')
+    parser.add_argument('--min-delta', type=float, default=0.5,
+                        help='Ignore increases smaller than this, in ms, percent of CPU or MB')
+    args = parser.parse_args()
+
+    values, failed_goals = load_report(args.report)
+    baseline, _ = load_report(args.baseline)
+
+    failures = [f'goal {goal} failed' for goal in failed_goals]
+    print(f'{"metric":<50} {"baseline":>10} {"result":>10} {"change":>8}')
+    for name, value in sorted(values.items()):
+        reference = baseline.get(name)
+        if reference is None:
+            print(f'{name:<50} not in baseline')
+            continue
+        change = (value - reference) / reference if reference > 0.0 else 0.0
+        print(f'{name:<50} {reference:>10.3f} {value:>10.3f} {change:>+8.1%}')
+        if change > args.tolerance and value - reference > args.min_delta:
+            failures.append(f'{name}: {reference:.3f} -> {value:.3f} ({change:+.1%})')
+
+    if failures:
+        print('\nRegressions:')
+        for failure in failures:
+            print('  ' + failure)
+        return 1
+
+    print('\nNo regression')
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
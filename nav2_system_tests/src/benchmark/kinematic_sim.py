@@ -0,0 +1,202 @@
+#! /usr/bin/env python3
+# Copyright (c) 2024 Open Navigation LLC
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+# Headless kinematic simulator for the navigation benchmark: integrates cmd_vel into the
+# odometry, ray casts laser scans in a map-server map and drives /clock, faster than real
+# time with a real_time_factor above 1.
+
+import math
+import os
+import sys
+
+from geometry_msgs.msg import TransformStamped, Twist, TwistStamped
+from nav_msgs.msg import Odometry
+import numpy as np
+import rclpy
+from rclpy.node import Node
+from rclpy.qos import qos_profile_sensor_data
+from rosgraph_msgs.msg import Clock
+from sensor_msgs.msg import LaserScan
+from tf2_ros import TransformBroadcaster
+import yaml
+
+
+def load_occupancy(map_yaml):
+    """Load a map-server map as a boolean occupancy grid, row 0 at the origin."""
+    with open(map_yaml) as f:
+        info = yaml.safe_load(f)
+
+    image = os.path.join(os.path.dirname(map_yaml), info['image'])
+    with open(image, 'rb') as f:
+        if f.readline().strip() != b'P5':
+            raise RuntimeError(f'{image} is not a binary PGM map')
+        fields = []
+        while len(fields) < 3:
+            line = f.readline()
+            if not line.startswith(b'#'):
+                fields += line.split()
+        width, height, max_value = (int(v) for v in fields)
+        pixels = np.frombuffer(f.read(width * height), dtype=np.uint8).reshape(height, width)
+
+    occupancy = (max_value - pixels.astype(float)) / max_value
+    if info.get('negate', 0):
+        occupancy = 1.0 - occupancy
+    return np.flipud(occupancy > info['occupied_thresh']), info['resolution'], info['origin']
+
+
+def yaw_to_quaternion(yaw, q):
+    q.z = math.sin(yaw / 2.0)
+    q.w = math.cos(yaw / 2.0)
+
+
+class KinematicSim(Node):
+
+    def __init__(self):
+        super().__init__('kinematic_sim')
+        self.declare_parameter('map', '')
+        self.declare_parameter('x_pose', 0.0)
+        self.declare_parameter('y_pose', 0.0)
+        self.declare_parameter('yaw', 0.0)
+        self.declare_parameter('real_time_factor', 1.0)
+        self.declare_parameter('step_frequency', 100.0)
+        self.declare_parameter('scan_frequency', 10.0)
+        self.declare_parameter('scan_beams', 360)
+        self.declare_parameter('scan_range', 3.5)
+        self.declare_parameter('scan_offset_x', -0.064)
+        self.declare_parameter('scan_frame', 'base_scan')
+        self.declare_parameter('base_frame', 'base_footprint')
+        self.declare_parameter('odom_frame', 'odom')
+        self.declare_parameter('enable_stamped_cmd_vel', False)
+
+        self.occupied, self.resolution, self.origin = load_occupancy(
+            self.get_parameter('map').value)
+        self.x = self.get_parameter('x_pose').value
+        self.y = self.get_parameter('y_pose').value
+        self.yaw = self.get_parameter('yaw').value
+        self.twist = Twist()
+
+        self.step = 1.0 / self.get_parameter('step_frequency').value
+        self.sim_step = self.step * self.get_parameter('real_time_factor').value
+        self.scan_period = 1.0 / self.get_parameter('scan_frequency').value
+        self.sim_time = 0.0
+        self.next_scan_time = 0.0
+
+        beams = self.get_parameter('scan_beams').value
+        self.scan_range = self.get_parameter('scan_range').value
+        self.scan_offset_x = self.get_parameter('scan_offset_x').value
+        self.beam_angles = np.linspace(0.0, 2.0 * math.pi, beams, endpoint=False)
+        self.ray_steps = np.arange(0.0, self.scan_range, self.resolution / 2.0)
+
+        self.clock_pub = self.create_publisher(Clock, '/clock', 10)
+        self.odom_pub = self.create_publisher(Odometry, 'odom', 10)
+        self.scan_pub = self.create_publisher(LaserScan, 'scan', qos_profile_sensor_data)
+        self.tf_broadcaster = TransformBroadcaster(self)
+        if self.get_parameter('enable_stamped_cmd_vel').value:
+            self.create_subscription(
+                TwistStamped, 'cmd_vel', lambda msg: setattr(self, 'twist', msg.twist), 10)
+        else:
+            self.create_subscription(
+                Twist, 'cmd_vel', lambda msg: setattr(self, 'twist', msg), 10)
+
+        # Runs on the wall clock, the nodes under test follow the /clock it publishes
+        self.create_timer(self.step, self.stepCallback)
+
+    def stepCallback(self):
+        # Integrate the commanded velocity along the exact arc
+        vx, vy, wz = self.twist.linear.x, self.twist.linear.y, self.twist.angular.z
+        dt = self.sim_step
+        if abs(wz) > 1e-6:
+            new_yaw = self.yaw + wz * dt
+            sin_delta = math.sin(new_yaw) - math.sin(self.yaw)
+            cos_delta = math.cos(new_yaw) - math.cos(self.yaw)
+            self.x += (vx * sin_delta + vy * cos_delta) / wz
+            self.y += (-vx * cos_delta + vy * sin_delta) / wz
+            self.yaw = math.atan2(math.sin(new_yaw), math.cos(new_yaw))
+        else:
+            self.x += (vx * math.cos(self.yaw) - vy * math.sin(self.yaw)) * dt
+            self.y += (vx * math.sin(self.yaw) + vy * math.cos(self.yaw)) * dt
+        self.sim_time += dt
+
+        stamp = rclpy.time.Time(nanoseconds=int(self.sim_time * 1e9)).to_msg()
+        self.clock_pub.publish(Clock(clock=stamp))
+        self.publishOdometry(stamp)
+        if self.sim_time >= self.next_scan_time:
+            self.next_scan_time += self.scan_period
+            self.publishScan(stamp)
+
+    def publishOdometry(self, stamp):
+        odom_frame = self.get_parameter('odom_frame').value
+        base_frame = self.get_parameter('base_frame').value
+
+        transform = TransformStamped()
+        transform.header.stamp = stamp
+        transform.header.frame_id = odom_frame
+        transform.child_frame_id = base_frame
+        transform.transform.translation.x = self.x
+        transform.transform.translation.y = self.y
+        yaw_to_quaternion(self.yaw, transform.transform.rotation)
+        self.tf_broadcaster.sendTransform(transform)
+
+        odom = Odometry()
+        odom.header = transform.header
+        odom.child_frame_id = base_frame
+        odom.pose.pose.position.x = self.x
+        odom.pose.pose.position.y = self.y
+        odom.pose.pose.orientation = transform.transform.rotation
+        odom.twist.twist = self.twist
+        self.odom_pub.publish(odom)
+
+    def publishScan(self, stamp):
+        # March all the beams at once through the map, at half a cell per step
+        origin_x = self.x + self.scan_offset_x * math.cos(self.yaw)
+        origin_y = self.y + self.scan_offset_x * math.sin(self.yaw)
+        angles = self.yaw + self.beam_angles
+        xs = origin_x + np.outer(np.cos(angles), self.ray_steps)
+        ys = origin_y + np.outer(np.sin(angles), self.ray_steps)
+        mx = np.floor((xs - self.origin[0]) / self.resolution).astype(int)
+        my = np.floor((ys - self.origin[1]) / self.resolution).astype(int)
+        inside = (mx >= 0) & (my >= 0) & (mx < self.occupied.shape[1]) & \
+            (my < self.occupied.shape[0])
+        hits = np.zeros(mx.shape, dtype=bool)
+        hits[inside] = self.occupied[my[inside], mx[inside]]
+        first_hit = np.where(hits.any(axis=1), hits.argmax(axis=1), -1)
+
+        scan = LaserScan()
+        scan.header.stamp = stamp
+        scan.header.frame_id = self.get_parameter('scan_frame').value
+        scan.angle_min = 0.0
+        scan.angle_max = float(self.beam_angles[-1])
+        scan.angle_increment = float(self.beam_angles[1] - self.beam_angles[0])
+        scan.scan_time = self.scan_period
+        scan.range_min = 0.12
+        scan.range_max = self.scan_range
+        scan.ranges = [
+            float(self.ray_steps[i]) if i >= 0 else math.inf for i in first_hit]
+        self.scan_pub.publish(scan)
+
+
+def main(argv=sys.argv[1:]):
+    rclpy.init()
+    sim = KinematicSim()
+    try:
+        rclpy.spin(sim)
+    except KeyboardInterrupt:
+        pass
+    sim.destroy_node()
+    rclpy.try_shutdown()
+
+
+if __name__ == '__main__':
+    main()
@@ -0,0 +1,137 @@
+#!/usr/bin/env python3
+
+# Copyright (c) 2024 Open Navigation LLC
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+import os
+import sys
+
+from ament_index_python.packages import get_package_share_directory
+
+from launch import LaunchDescription
+from launch import LaunchService
+from launch.actions import ExecuteProcess, IncludeLaunchDescription, SetEnvironmentVariable
+from launch.launch_context import LaunchContext
+from launch.launch_description_sources import PythonLaunchDescriptionSource
+from launch_ros.actions import Node
+from launch_testing.legacy import LaunchTestService
+
+from nav2_common.launch import RewrittenYaml
+
+INITIAL_POSE = ['-2.0', '-0.5']
+GOALS = [['0.0', '2.0'], ['-0.52', '-0.54'], ['1.78', '-0.57'], ['-2.0', '-0.5']]
+
+
+def generate_launch_description():
+    sim_dir = get_package_share_directory('nav2_minimal_tb3_sim')
+    nav2_bringup_dir = get_package_share_directory('nav2_bringup')
+
+    urdf = os.path.join(sim_dir, 'urdf', 'turtlebot3_waffle.urdf')
+    with open(urdf, 'r') as infp:
+        robot_description = infp.read()
+
+    map_yaml_file = os.path.join(nav2_bringup_dir, 'maps', 'tb3_sandbox.yaml')
+
+    bt_navigator_xml = os.path.join(
+        get_package_share_directory('nav2_bt_navigator'),
+        'behavior_trees',
+        os.getenv('BT_NAVIGATOR_XML', 'navigate_to_pose_w_replanning_and_recovery.xml'),
+    )
+
+    # Use the system test parameters, publishing the costmap update times
+    params_file = os.path.join(os.getenv('TEST_DIR'), '..', 'system', 'nav2_system_params.yaml')
+    param_substitutions = {
+        'local_costmap.local_costmap.ros__parameters.publish_update_time': 'True',
+        'global_costmap.global_costmap.ros__parameters.publish_update_time': 'True',
+    }
+    if os.getenv('PLANNER'):
+        param_substitutions['planner_server.ros__parameters.GridBased.plugin'] = \
+            os.getenv('PLANNER')
+    if os.getenv('CONTROLLER'):
+        param_substitutions['controller_server.ros__parameters.FollowPath.plugin'] = \
+            os.getenv('CONTROLLER')
+
+    configured_params = RewrittenYaml(
+        source_file=params_file,
+        root_key='',
+        param_rewrites=param_substitutions,
+        convert_types=True,
+    )
+    new_yaml = configured_params.perform(LaunchContext())
+
+    return LaunchDescription(
+        [
+            SetEnvironmentVariable('RCUTILS_LOGGING_BUFFERED_STREAM', '1'),
+            SetEnvironmentVariable('RCUTILS_LOGGING_USE_STDOUT', '1'),
+            # Headless kinematic simulation in place of Gazebo, driving /clock
+            Node(
+                package='nav2_system_tests',
+                executable='kinematic_sim.py',
+                name='kinematic_sim',
+                output='screen',
+                parameters=[
+                    {
+                        'map': map_yaml_file,
+                        'x_pose': float(INITIAL_POSE[0]),
+                        'y_pose': float(INITIAL_POSE[1]),
+                        'real_time_factor': float(os.getenv('REAL_TIME_FACTOR', '2.0')),
+                    }
+                ],
+            ),
+            Node(
+                package='robot_state_publisher',
+                executable='robot_state_publisher',
+                name='robot_state_publisher',
+                output='screen',
+                parameters=[
+                    {'use_sim_time': True, 'robot_description': robot_description}
+                ],
+            ),
+            IncludeLaunchDescription(
+                PythonLaunchDescriptionSource(
+                    os.path.join(nav2_bringup_dir, 'launch', 'bringup_launch.py')
+                ),
+                launch_arguments={
+                    'namespace': '',
+                    'use_namespace': 'False',
+                    'map': map_yaml_file,
+                    'use_sim_time': 'True',
+                    'params_file': new_yaml,
+                    'bt_xml_file': bt_navigator_xml,
+                    'use_composition': 'False',
+                    'autostart': 'True',
+                }.items(),
+            ),
+        ]
+    )
+
+
+def main(argv=sys.argv[1:]):
+    ld = generate_launch_description()
+
+    cmd = [os.path.join(os.getenv('TEST_DIR'), 'benchmark_tester.py'), '-r'] + INITIAL_POSE
+    for goal in GOALS:
+        cmd += ['-g'] + goal
+    cmd += ['-o', os.getenv('BENCHMARK_REPORT', 'nav2_benchmark_report.json')]
+    test1_action = ExecuteProcess(cmd=cmd, name='benchmark_tester', output='screen')
+
+    lts = LaunchTestService()
+    lts.add_test_action(ld, test1_action)
+    ls = LaunchService(argv=argv)
+    ls.include_launch_description(ld)
+    return lts.run(ls)
+
+
+if __name__ == '__main__':
+    sys.exit(main())
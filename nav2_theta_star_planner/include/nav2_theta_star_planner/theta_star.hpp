@@ -20,6 +20,7 @@
 #include <vector>
 #include <queue>
 #include <algorithm>
+#include <array>
 #include "rclcpp/rclcpp.hpp"
 #include "nav2_costmap_2d/costmap_2d_ros.hpp"
 
@@ -56,6 +57,16 @@ struct comp
   }
 };
 
+/**
+ * @class NodeQueue
+ * @brief Open list of the nodes to expand, keeping its storage when cleared
+ */
+class NodeQueue : public std::priority_queue<tree_node *, std::vector<tree_node *>, comp>
+{
+public:
+  void clear() {c.clear();}
+};
+
 namespace theta_star
 {
 class ThetaStar
@@ -97,9 +108,8 @@ public:
    */
   inline bool isSafe(const int & cx, const int & cy) const
   {
-    return (costmap_->getCost(
-             cx,
-             cy) == UNKNOWN_COST && allow_unknown_) || costmap_->getCost(cx, cy) < LETHAL_COST;
+    const unsigned char cost = costmap_->getCost(cx, cy);
+    return (cost == UNKNOWN_COST && allow_unknown_) || cost < LETHAL_COST;
   }
 
   /**
@@ -132,6 +142,11 @@ protected:
   /// and its number of elements increases to account for a change in map size
   std::vector<tree_node *> node_position_;
 
+  /// generation of the pointer stored at the same index of node_position_, which is
+  /// only valid if equal to generation_, so that the whole map is invalidated in constant time
+  std::vector<unsigned int> node_generation_;
+  unsigned int generation_{1};
+
   /// the vector nodes_data_ stores the coordinates, costs and index of the parent node,
   /// and whether or not the node is present in queue_, for all the nodes searched
   /// it is initialised with no elements
@@ -139,7 +154,13 @@ protected:
   std::vector<tree_node> nodes_data_;
 
   /// this is the priority queue (open_list) to select the next node to be expanded
-  std::priority_queue<tree_node *, std::vector<tree_node *>, comp> queue_;
+  NodeQueue queue_;
+
+  /// traversal costs and safety of the costmap cost values, updated on each plan
+  /// so that the line of sight checks are a single lookup per cell
+  std::array<double, 256> traversal_costs_{};
+  std::array<double, 256> los_costs_{};
+  std::array<bool, 256> safe_costs_{};
 
   /// it is a counter like variable used to generate consecutive indices
   /// such that the data for all the nodes (in open and closed lists) could be stored
@@ -195,14 +216,11 @@ protected:
    * @param cost denotes the total straight line traversal cost; it adds the traversal cost for the node (cx, cy) at every instance; it is also being returned
    * @return false if the traversal cost is greater than / equal to the LETHAL_COST and true otherwise
    */
-  bool isSafe(const int & cx, const int & cy, double & cost) const
+  inline bool isSafe(const int & cx, const int & cy, double & cost) const
   {
-    double curr_cost = getCost(cx, cy);
-    if ((costmap_->getCost(cx, cy) == UNKNOWN_COST && allow_unknown_) || curr_cost < LETHAL_COST) {
-      if (costmap_->getCost(cx, cy) == UNKNOWN_COST) {
-        curr_cost = OBS_COST - 1;
-      }
-      cost += w_traversal_cost_ * curr_cost * curr_cost / LETHAL_COST / LETHAL_COST;
+    const unsigned char cell_cost = costmap_->getCost(cx, cy);
+    if (safe_costs_[cell_cost]) {
+      cost += los_costs_[cell_cost];
       return true;
     } else {
       return false;
@@ -225,10 +243,15 @@ protected:
    */
   inline double getTraversalCost(const int & cx, const int & cy)
   {
-    double curr_cost = getCost(cx, cy);
-    return w_traversal_cost_ * curr_cost * curr_cost / LETHAL_COST / LETHAL_COST;
+    return traversal_costs_[costmap_->getCost(cx, cy)];
   }
 
+  /**
+   * @brief computes the traversal costs and safety of every costmap cost value,
+   *                    from the current weights and allow_unknown_
+   */
+  void updateCostTables();
+
   /**
    * @brief calculates the piecewise straight line euclidean distances by
    *                    <euc_cost_parameter>*<euclidean distance between the points (ax, ay) and (bx, by)>
@@ -268,7 +291,8 @@ protected:
   }
 
   /**
-   * @brief initialises the node_position_ vector by storing -1 as index for all points(x, y) within the limits of the map
+   * @brief invalidates the node_position_ entries of all points(x, y) within the limits of the map,
+   *            in constant time by moving to the next generation
    * @param size_inc is used to increase the number of elements in node_position_ in case the size of the map increases
    */
   void initializePosn(int size_inc = 0);
@@ -280,6 +304,7 @@ protected:
   inline void addIndex(const int & cx, const int & cy, tree_node * node_this)
   {
     node_position_[size_x_ * cy + cx] = node_this;
+    node_generation_[size_x_ * cy + cx] = generation_;
   }
 
   /**
@@ -288,7 +313,8 @@ protected:
    */
   inline tree_node * getIndex(const int & cx, const int & cy)
   {
-    return node_position_[size_x_ * cy + cx];
+    const int index = size_x_ * cy + cx;
+    return node_generation_[index] == generation_ ? node_position_[index] : nullptr;
   }
 
   /**
@@ -314,7 +340,7 @@ protected:
    */
   void clearQueue()
   {
-    queue_ = std::priority_queue<tree_node *, std::vector<tree_node *>, comp>();
+    queue_.clear();
   }
 };
 }   //  namespace theta_star
@@ -31,6 +31,7 @@ ThetaStar::ThetaStar()
   index_generated_(0)
 {
   exp_node = new tree_node;
+  updateCostTables();
 }
 
 void ThetaStar::setStartAndGoal(
@@ -234,9 +235,21 @@ bool ThetaStar::losCheck(
   return true;
 }
 
+void ThetaStar::updateCostTables()
+{
+  for (int i = 0; i != 256; i++) {
+    const double cost = 26 + 0.9 * i;
+    traversal_costs_[i] = w_traversal_cost_ * cost * cost / LETHAL_COST / LETHAL_COST;
+    safe_costs_[i] = (i == UNKNOWN_COST && allow_unknown_) || cost < LETHAL_COST;
+    const double los_cost = i == UNKNOWN_COST ? OBS_COST - 1 : cost;
+    los_costs_[i] = w_traversal_cost_ * los_cost * los_cost / LETHAL_COST / LETHAL_COST;
+  }
+}
+
 void ThetaStar::resetContainers()
 {
   index_generated_ = 0;
+  updateCostTables();
   int last_size_x = size_x_;
   int last_size_y = size_y_;
   int curr_size_x = static_cast<int>(costmap_->getSizeInCellsX());
@@ -255,14 +268,15 @@ void ThetaStar::resetContainers()
 
 void ThetaStar::initializePosn(int size_inc)
 {
-  if (!node_position_.empty()) {
-    for (int i = 0; i < size_x_ * size_y_; i++) {
-      node_position_[i] = nullptr;
-    }
+  if (++generation_ == 0) {
+    // generations wrapped around, stale entries of older ones must not look current
+    std::fill(node_generation_.begin(), node_generation_.end(), 0u);
+    generation_ = 1;
   }
 
   for (int i = 0; i < size_inc; i++) {
     node_position_.push_back(nullptr);
+    node_generation_.push_back(0u);
   }
 }
 
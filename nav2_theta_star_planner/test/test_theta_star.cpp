@@ -135,10 +135,20 @@ TEST(ThetaStarTest, test_theta_star) {
   EXPECT_FALSE(planner_->ulosCheck(2, 2, 18, 18, sl_cost));
 
   planner_->uresetContainers();
+  /// Check that resetting the containers removes the nodes of the previous search
+  EXPECT_EQ(planner_->ugetIndex(c.x, c.y), nullptr);
   std::vector<coordsW> path;
   /// Check if the planner returns a path for the case where a path exists
   EXPECT_TRUE(planner_->runAlgo(path));
   EXPECT_GT(static_cast<int>(path.size()), 0);
+  /// and the same one when planning again on the reused containers
+  std::vector<coordsW> replanned_path;
+  EXPECT_TRUE(planner_->runAlgo(replanned_path));
+  ASSERT_EQ(replanned_path.size(), path.size());
+  for (unsigned int i = 0; i != path.size(); i++) {
+    EXPECT_DOUBLE_EQ(replanned_path[i].x, path[i].x);
+    EXPECT_DOUBLE_EQ(replanned_path[i].y, path[i].y);
+  }
   /// and where it doesn't exist
   path.clear();
   planner_->src_ = {10, 10};
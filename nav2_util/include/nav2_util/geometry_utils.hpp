@@ -179,6 +179,39 @@ inline double calculate_path_length(const nav_msgs::msg::Path & path, size_t sta
   return path_length;
 }
 
+/**
+ * @brief Project a pose moving with a constant twist, in closed form along the arc it
+ * follows rather than by integration steps, so that any time can be projected directly
+ * @param pose Pose to project
+ * @param vx Linear velocity along the X axis of the robot
+ * @param vy Linear velocity along the Y axis of the robot
+ * @param wz Angular velocity
+ * @param time Time to project by
+ * @return Projected pose
+ */
+inline geometry_msgs::msg::Pose2D projectTwist(
+  const geometry_msgs::msg::Pose2D & pose, double vx, double vy, double wz, double time)
+{
+  // Displacement in the frame of the pose
+  double dx = vx * time;
+  double dy = vy * time;
+  const double dtheta = wz * time;
+  if (std::fabs(dtheta) > 1e-9) {
+    const double sin_dtheta = std::sin(dtheta);
+    const double cos_dtheta = std::cos(dtheta);
+    dx = (vx * sin_dtheta + vy * (cos_dtheta - 1.0)) / wz;
+    dy = (vx * (1.0 - cos_dtheta) + vy * sin_dtheta) / wz;
+  }
+
+  const double cos_theta = std::cos(pose.theta);
+  const double sin_theta = std::sin(pose.theta);
+  geometry_msgs::msg::Pose2D projected;
+  projected.x = pose.x + dx * cos_theta - dy * sin_theta;
+  projected.y = pose.y + dx * sin_theta + dy * cos_theta;
+  projected.theta = pose.theta + dtheta;
+  return projected;
+}
+
 }  // namespace geometry_utils
 }  // namespace nav2_util
 
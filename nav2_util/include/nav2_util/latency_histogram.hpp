@@ -0,0 +1,134 @@
+// Copyright (c) 2022 Samsung Research America, @artofnothingness Alexey Budyakov
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef NAV2_UTIL__LATENCY_HISTOGRAM_HPP_
+#define NAV2_UTIL__LATENCY_HISTOGRAM_HPP_
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+
+namespace nav2_util
+{
+
+/**
+ * @struct nav2_util::LatencySummary
+ * @brief Statistics of the latencies recorded by a histogram since its last collection
+ */
+struct LatencySummary
+{
+  uint32_t count{0};
+  float mean_ms{0.0f};
+  float p50_ms{0.0f};
+  float p99_ms{0.0f};
+  float max_ms{0.0f};
+};
+
+/**
+ * @class nav2_util::LatencyHistogram
+ * @brief Histogram of latencies in buckets of a half power of 2 microseconds, from 1us
+ * to about 10 minutes. Recording is lock-free and does not allocate, so that it can be
+ * done from a control loop and its worker threads while being collected.
+ */
+class LatencyHistogram
+{
+public:
+  static constexpr size_t kBuckets = 40;
+
+  /**
+   * @brief Record a latency
+   * @param seconds Latency to record (s)
+   */
+  void record(double seconds)
+  {
+    const double us = seconds * 1e6;
+    size_t bucket = 0;
+    if (us > 1.0) {
+      bucket = std::min(kBuckets - 1, static_cast<size_t>(std::ceil(2.0 * std::log2(us))));
+    }
+    const uint64_t ns = static_cast<uint64_t>(std::max(seconds, 0.0) * 1e9);
+
+    buckets_[bucket].fetch_add(1, std::memory_order_relaxed);
+    sum_ns_.fetch_add(ns, std::memory_order_relaxed);
+    uint64_t max_ns = max_ns_.load(std::memory_order_relaxed);
+    while (ns > max_ns &&
+      !max_ns_.compare_exchange_weak(max_ns, ns, std::memory_order_relaxed)) {}
+  }
+
+  /**
+   * @brief Record the latency since a time point
+   * @param start Start of the latency
+   */
+  void recordSince(const std::chrono::steady_clock::time_point & start)
+  {
+    record(std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count());
+  }
+
+  /**
+   * @brief Summarize the latencies recorded since the last collection and restart
+   * recording. Percentiles are the upper bounds of their buckets. Latencies recorded
+   * during the collection may be accounted to either window.
+   * @return Summary of the latencies
+   */
+  LatencySummary collect()
+  {
+    std::array<uint32_t, kBuckets> counts;
+    uint64_t count = 0;
+    for (size_t i = 0; i != kBuckets; i++) {
+      counts[i] = buckets_[i].exchange(0, std::memory_order_relaxed);
+      count += counts[i];
+    }
+    const uint64_t sum_ns = sum_ns_.exchange(0, std::memory_order_relaxed);
+    const uint64_t max_ns = max_ns_.exchange(0, std::memory_order_relaxed);
+
+    LatencySummary summary;
+    if (count == 0) {
+      return summary;
+    }
+    summary.count = static_cast<uint32_t>(count);
+    summary.mean_ms = static_cast<float>(sum_ns * 1e-6 / count);
+    summary.max_ms = static_cast<float>(max_ns * 1e-6);
+    summary.p50_ms = std::min(percentile(counts, count, 0.5), summary.max_ms);
+    summary.p99_ms = std::min(percentile(counts, count, 0.99), summary.max_ms);
+    return summary;
+  }
+
+protected:
+  static float percentile(
+    const std::array<uint32_t, kBuckets> & counts, uint64_t count, double fraction)
+  {
+    const uint64_t rank = static_cast<uint64_t>(std::ceil(fraction * count));
+    uint64_t cumulated = 0;
+    size_t bucket = 0;
+    for (; bucket != kBuckets - 1; bucket++) {
+      cumulated += counts[bucket];
+      if (cumulated >= rank) {
+        break;
+      }
+    }
+    return static_cast<float>(std::exp2(0.5 * bucket) * 1e-3);
+  }
+
+  std::array<std::atomic<uint32_t>, kBuckets> buckets_{};
+  std::atomic<uint64_t> sum_ns_{0};
+  std::atomic<uint64_t> max_ns_{0};
+};
+
+}  // namespace nav2_util
+
+#endif  // NAV2_UTIL__LATENCY_HISTOGRAM_HPP_
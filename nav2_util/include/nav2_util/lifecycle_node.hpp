@@ -25,6 +25,7 @@
 #include "rclcpp/rclcpp.hpp"
 #include "bondcpp/bond.hpp"
 #include "bond/msg/constants.hpp"
+#include "std_msgs/msg/empty.hpp"
 
 namespace nav2_util
 {
@@ -145,6 +146,14 @@ public:
     declare_parameter(descriptor.name, default_value, descriptor);
   }
 
+  /**
+   * @brief Declares and gets the scheduling of a thread of the node, from the
+   * "<name>.num_threads", "<name>.cpu" and "<name>.priority" parameters
+   * @param name Name of the thread
+   * @return Scheduling of the thread, the default one when not set
+   */
+  ThreadSettings getThreadSettings(const std::string & name);
+
   /**
    * @brief Get a shared pointer of this
    */
@@ -207,6 +216,12 @@ protected:
   // Connection to tell that server is still up
   std::unique_ptr<bond::Bond> bond_{nullptr};
   double bond_heartbeat_period;
+
+  // Liveliness asserted instead of the bond, without publishing any message
+  bool use_liveliness_heartbeat_{false};
+  double liveliness_lease_duration_;
+  rclcpp::Publisher<std_msgs::msg::Empty>::SharedPtr liveliness_pub_;
+  rclcpp::TimerBase::SharedPtr liveliness_timer_;
 };
 
 }  // namespace nav2_util
@@ -35,6 +35,10 @@
 
 #include <stdlib.h>
 
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
 namespace nav2_util
 {
 
@@ -195,6 +199,116 @@ private:
   int den_, num_, numadd_, numpixels_;
 };
 
+/**
+ * @brief Number of cells of the line between two cells, as iterated by LineIterator
+ * @param x0 Starting x
+ * @param y0 Starting y
+ * @param x1 Ending x
+ * @param y1 Ending y
+ * @return Number of cells, endpoints included
+ */
+inline unsigned int getLineLength(int x0, int y0, int x1, int y1)
+{
+  return static_cast<unsigned int>(std::max(abs(x1 - x0), abs(y1 - y0))) + 1;
+}
+
+/**
+ * @brief Rasterizes a whole line at once, into the same cells as LineIterator.
+ * Each cell is computed from its position along the line rather than from the
+ * previous one, so that the loop has no dependency between iterations and can be
+ * vectorized.
+ * @param x0 Starting x
+ * @param y0 Starting y
+ * @param x1 Ending x
+ * @param y1 Ending y
+ * @param xs Output x of the cells, of getLineLength() elements at least
+ * @param ys Output y of the cells, of getLineLength() elements at least
+ * @return Number of cells written
+ */
+inline unsigned int rasterizeLine(int x0, int y0, int x1, int y1, int * xs, int * ys)
+{
+  const int deltax = abs(x1 - x0);
+  const int deltay = abs(y1 - y0);
+  const int xinc = x1 >= x0 ? 1 : -1;
+  const int yinc = y1 >= y0 ? 1 : -1;
+  const bool x_major = deltax >= deltay;
+  const int64_t den = x_major ? deltax : deltay;
+  const int64_t numadd = x_major ? deltay : deltax;
+  const unsigned int length = static_cast<unsigned int>(den) + 1;
+  if (den == 0) {
+    xs[0] = x0;
+    ys[0] = y0;
+    return 1;
+  }
+
+  // The minor coordinate steps each time the accumulated numerator reaches the denominator
+  const int64_t num0 = den / 2;
+  const int major_inc = x_major ? xinc : yinc;
+  const int minor_inc = x_major ? yinc : xinc;
+  int * major = x_major ? xs : ys;
+  int * minor = x_major ? ys : xs;
+  const int major0 = x_major ? x0 : y0;
+  const int minor0 = x_major ? y0 : x0;
+  for (unsigned int i = 0; i < length; ++i) {
+    major[i] = major0 + static_cast<int>(i) * major_inc;
+    minor[i] = minor0 + static_cast<int>((num0 + i * numadd) / den) * minor_inc;
+  }
+  return length;
+}
+
+/**
+ * @brief Rasterizes a whole line at once into the indices of its cells in a grid
+ * @param x0 Starting x
+ * @param y0 Starting y
+ * @param x1 Ending x
+ * @param y1 Ending y
+ * @param size_x Width of the grid, the cells being indexed as y * size_x + x
+ * @param indices Output indices of the cells, of getLineLength() elements at least
+ * @return Number of cells written
+ */
+inline unsigned int rasterizeLine(
+  int x0, int y0, int x1, int y1, unsigned int size_x, unsigned int * indices)
+{
+  const unsigned int length = getLineLength(x0, y0, x1, y1);
+  thread_local std::vector<int> xs, ys;
+  xs.resize(length);
+  ys.resize(length);
+  rasterizeLine(x0, y0, x1, y1, xs.data(), ys.data());
+  for (unsigned int i = 0; i < length; ++i) {
+    indices[i] = static_cast<unsigned int>(ys[i]) * size_x + static_cast<unsigned int>(xs[i]);
+  }
+  return length;
+}
+
+/**
+ * @brief Rasterizes rays from one origin into the indices of their cells in a grid,
+ * such as to raytrace a scan
+ * @param x0 Origin x
+ * @param y0 Origin y
+ * @param x1s Ending x of the rays
+ * @param y1s Ending y of the rays
+ * @param size_x Width of the grid, the cells being indexed as y * size_x + x
+ * @param indices Output indices of the cells of all the rays, one ray after the other
+ * @param offsets Output offsets of the rays in indices, with one more element
+ * for the end of the last ray
+ */
+inline void rasterizeRays(
+  int x0, int y0, const std::vector<int> & x1s, const std::vector<int> & y1s,
+  unsigned int size_x, std::vector<unsigned int> & indices, std::vector<size_t> & offsets)
+{
+  const size_t rays = std::min(x1s.size(), y1s.size());
+  offsets.resize(rays + 1);
+  offsets[0] = 0;
+  for (size_t r = 0; r < rays; ++r) {
+    offsets[r + 1] = offsets[r] + getLineLength(x0, y0, x1s[r], y1s[r]);
+  }
+
+  indices.resize(offsets[rays]);
+  for (size_t r = 0; r < rays; ++r) {
+    rasterizeLine(x0, y0, x1s[r], y1s[r], size_x, indices.data() + offsets[r]);
+  }
+}
+
 }  // end namespace nav2_util
 
 #endif  // NAV2_UTIL__LINE_ITERATOR_HPP_
@@ -21,6 +21,20 @@
 
 namespace nav2_util
 {
+
+/**
+ * @brief Scheduling of the threads spinning an executor
+ */
+struct ThreadSettings
+{
+  // Threads spinning the executor of a node, multi-threaded above 1
+  size_t num_threads{1};
+  // CPU core the threads are pinned to, -1 not to pin them
+  int cpu{-1};
+  // SCHED_FIFO priority of the threads, 0 to keep the default scheduling
+  int priority{0};
+};
+
 /**
  * @class nav2_util::NodeThread
  * @brief A background thread to process node/executor callbacks
@@ -31,24 +45,39 @@ public:
   /**
    * @brief A background thread to process node callbacks constructor
    * @param node_base Interface to Node to spin in thread
+   * @param settings Scheduling of the threads spinning the node
    */
   explicit NodeThread(
-    rclcpp::node_interfaces::NodeBaseInterface::SharedPtr node_base);
+    rclcpp::node_interfaces::NodeBaseInterface::SharedPtr node_base,
+    const ThreadSettings & settings = ThreadSettings());
 
   /**
    * @brief A background thread to process executor's callbacks constructor
    * @param executor Interface to executor to spin in thread
+   * @param settings Scheduling of the thread, the number of threads being ignored
+   */
+  explicit NodeThread(
+    rclcpp::executors::SingleThreadedExecutor::SharedPtr executor,
+    const ThreadSettings & settings = ThreadSettings());
+
+  /**
+   * @brief A background thread to process a multi-threaded executor's callbacks constructor
+   * @param executor Interface to executor to spin in thread
+   * @param settings Scheduling of the threads, inherited by the threads of the executor,
+   * the number of threads being the executor's
    */
   explicit NodeThread(
-    rclcpp::executors::SingleThreadedExecutor::SharedPtr executor);
+    rclcpp::executors::MultiThreadedExecutor::SharedPtr executor,
+    const ThreadSettings & settings = ThreadSettings());
 
   /**
    * @brief A background thread to process node callbacks constructor
    * @param node Node pointer to spin in thread
+   * @param settings Scheduling of the threads spinning the node
    */
   template<typename NodeT>
-  explicit NodeThread(NodeT node)
-  : NodeThread(node->get_node_base_interface())
+  explicit NodeThread(NodeT node, const ThreadSettings & settings = ThreadSettings())
+  : NodeThread(node->get_node_base_interface(), settings)
   {}
 
   /**
@@ -57,9 +86,15 @@ public:
   ~NodeThread();
 
 protected:
+  /**
+   * @brief Spins the executor in the thread, with the scheduling of the settings
+   */
+  void startThread();
+
   rclcpp::node_interfaces::NodeBaseInterface::SharedPtr node_;
   std::unique_ptr<std::thread> thread_;
   rclcpp::Executor::SharedPtr executor_;
+  ThreadSettings settings_;
 };
 
 }  // namespace nav2_util
@@ -160,6 +160,21 @@ std::string get_plugin_type_param(
  */
 void setSoftRealTimePriority();
 
+/**
+ * @brief Sets the caller thread to the SCHED_FIFO policy with a priority level.
+ * May throw exception if unable to set prioritization successfully
+ * @param priority Priority level, from 1 to 99
+ */
+void setThreadPriority(int priority);
+
+/**
+ * @brief Pins the caller thread to a CPU core, such as to keep a realtime
+ * control loop away from the cores of other work.
+ * May throw exception if unable to set the affinity successfully
+ * @param cpu Index of the core
+ */
+void setThreadAffinity(int cpu);
+
 }  // namespace nav2_util
 
 #endif  // NAV2_UTIL__NODE_UTILS_HPP_
@@ -21,8 +21,9 @@
 #include <memory>
 #include <mutex>
 #include <string>
-#include <deque>
+#include <vector>
 
+#include "geometry_msgs/msg/pose_stamped.hpp"
 #include "geometry_msgs/msg/twist.hpp"
 #include "geometry_msgs/msg/twist_stamped.hpp"
 #include "nav_msgs/msg/odometry.hpp"
@@ -36,7 +37,8 @@ namespace nav2_util
 /**
  * @class OdomSmoother
  * Wrapper for getting smooth odometry readings using a simple moving avergae.
- * Subscribes to the topic with a mutex.
+ * Subscribes to the topic with a mutex. The odometry of the window is kept in a ring
+ * buffer with running sums, so that each reading is smoothed in constant time.
  */
 class OdomSmoother
 {
@@ -68,13 +70,35 @@ public:
    * @brief Get twist msg from smoother
    * @return twist Twist msg
    */
-  inline geometry_msgs::msg::Twist getTwist() {return vel_smooth_.twist;}
+  inline geometry_msgs::msg::Twist getTwist()
+  {
+    std::lock_guard<std::mutex> lock(odom_mutex_);
+    return vel_smooth_.twist;
+  }
 
   /**
    * @brief Get twist stamped msg from smoother
    * @return twist TwistStamped msg
    */
-  inline geometry_msgs::msg::TwistStamped getTwistStamped() {return vel_smooth_;}
+  inline geometry_msgs::msg::TwistStamped getTwistStamped()
+  {
+    std::lock_guard<std::mutex> lock(odom_mutex_);
+    return vel_smooth_;
+  }
+
+  /**
+   * @brief Predict the robot twist and pose at a given time, e.g. when a command sent now
+   * will be actuated. The twist is extrapolated with the acceleration over the history
+   * window, and the pose integrated from the last odometry pose with it.
+   * @param time Time to predict the state at
+   * @param pose Output pose predicted, in the odometry frame
+   * @param twist Output twist predicted
+   * @return False if no odometry was received yet
+   */
+  bool predict(
+    const rclcpp::Time & time,
+    geometry_msgs::msg::PoseStamped & pose,
+    geometry_msgs::msg::TwistStamped & twist);
 
 protected:
   /**
@@ -88,13 +112,49 @@ protected:
    */
   void updateState();
 
+  /**
+   * @struct nav2_util::OdomSmoother::OdomSample
+   * @brief Odometry kept in the history window
+   */
+  struct OdomSample
+  {
+    rclcpp::Time stamp;
+    // Time of the sample since the first odometry received (s)
+    double time;
+    geometry_msgs::msg::Twist twist;
+  };
+
+  /**
+   * @brief Add odometry at the end of the history ring buffer, growing it when full
+   * @param sample Odometry to add
+   */
+  void pushSample(const OdomSample & sample);
+
+  /**
+   * @brief Get odometry of the history, from the earliest one
+   * @param i Index of the odometry in the history
+   * @return Odometry sample
+   */
+  inline const OdomSample & sampleAt(size_t i) const
+  {
+    return odom_history_[(odom_history_head_ + i) % odom_history_.size()];
+  }
+
   rclcpp::Subscription<nav_msgs::msg::Odometry>::SharedPtr odom_sub_;
   nav_msgs::msg::Odometry odom_cumulate_;
   geometry_msgs::msg::TwistStamped vel_smooth_;
   std::mutex odom_mutex_;
 
   rclcpp::Duration odom_history_duration_;
-  std::deque<nav_msgs::msg::Odometry> odom_history_;
+  // Ring buffer of the odometry in the window, from odom_history_head_
+  std::vector<OdomSample> odom_history_;
+  size_t odom_history_head_;
+  size_t odom_history_size_;
+  // Sum of the times of the odometry in the window, and first odometry time they are from
+  double time_cumulate_;
+  rclcpp::Time time_origin_;
+  // Pose of the last odometry received
+  geometry_msgs::msg::PoseStamped last_pose_;
 };
 
 }  // namespace nav2_util
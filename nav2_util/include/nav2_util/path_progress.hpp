@@ -0,0 +1,167 @@
+// Copyright (c) 2024 Open Navigation LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef NAV2_UTIL__PATH_PROGRESS_HPP_
+#define NAV2_UTIL__PATH_PROGRESS_HPP_
+
+#include <cstddef>
+#include <limits>
+#include <vector>
+
+#include "geometry_msgs/msg/pose_stamped.hpp"
+#include "nav_msgs/msg/path.hpp"
+#include "nav2_util/geometry_utils.hpp"
+
+namespace nav2_util
+{
+
+/**
+ * @class nav2_util::PathProgress
+ * @brief Progress of a robot along a path, for feedback computed at every loop. The
+ * cumulative lengths of the path are computed once when it changes, and the closest pose
+ * is searched from the last one found, over the search window ahead of it only, so that
+ * the distance remaining does not depend on the length of the path.
+ */
+class PathProgress
+{
+public:
+  /**
+   * @brief A constructor for nav2_util::PathProgress
+   * @param search_window Length of path searched for the closest pose beyond the distance
+   * between the robot and the last one found (m)
+   */
+  explicit PathProgress(double search_window = 2.0)
+  : search_window_(search_window)
+  {}
+
+  /**
+   * @brief Whether a path is the one tracked. Compares the headers, sizes and ends of the
+   * paths, as planners stamp every path they compute
+   * @param path The path to compare
+   * @return bool true if the path is the tracked one
+   */
+  bool isSamePath(const nav_msgs::msg::Path & path) const
+  {
+    if (path.header != header_ || path.poses.size() != lengths_.size()) {
+      return false;
+    }
+    return path.poses.empty() ||
+           (path.poses.front().pose == front_ && path.poses.back().pose == back_);
+  }
+
+  /**
+   * @brief Track a new path, from its start. The next update searches all of it
+   * @param path The path to track
+   */
+  void setPath(const nav_msgs::msg::Path & path)
+  {
+    header_ = path.header;
+    poses_.resize(path.poses.size());
+    lengths_.resize(path.poses.size());
+    double length = 0.0;
+    for (size_t idx = 0; idx < path.poses.size(); ++idx) {
+      poses_[idx] = path.poses[idx].pose.position;
+      if (idx > 0) {
+        length += geometry_utils::euclidean_distance(
+          path.poses[idx - 1].pose, path.poses[idx].pose);
+      }
+      lengths_[idx] = length;
+    }
+    if (!path.poses.empty()) {
+      front_ = path.poses.front().pose;
+      back_ = path.poses.back().pose;
+    }
+    closest_idx_ = 0;
+    searched_ = false;
+  }
+
+  /**
+   * @brief Track a path if it is not the tracked one already
+   * @param path The path to track
+   */
+  void updatePath(const nav_msgs::msg::Path & path)
+  {
+    if (!isSamePath(path)) {
+      setPath(path);
+    }
+  }
+
+  /**
+   * @brief Find the pose of the path closest to the robot
+   * @param pose The pose of the robot
+   * @return size_t The index of the closest pose, 0 if the path is empty
+   */
+  size_t update(const geometry_msgs::msg::PoseStamped & pose)
+  {
+    if (poses_.empty()) {
+      return 0;
+    }
+
+    size_t end_idx = poses_.size();
+    if (searched_) {
+      // Poses beyond the window are further than the last closest one, unless the path
+      // comes back near the robot, which is to be reached later on
+      const double max_length = lengths_[closest_idx_] + search_window_ +
+        geometry_utils::euclidean_distance(pose.pose.position, poses_[closest_idx_]);
+      end_idx = closest_idx_ + 1;
+      while (end_idx < poses_.size() && lengths_[end_idx] <= max_length) {
+        ++end_idx;
+      }
+    }
+
+    const size_t start_idx = searched_ ? closest_idx_ : 0;
+    double min_dist = std::numeric_limits<double>::max();
+    for (size_t idx = start_idx; idx < end_idx; ++idx) {
+      const double dist = geometry_utils::euclidean_distance(pose.pose.position, poses_[idx]);
+      if (dist < min_dist) {
+        min_dist = dist;
+        closest_idx_ = idx;
+      }
+    }
+    searched_ = true;
+    return closest_idx_;
+  }
+
+  /**
+   * @brief Get the length of the path from the closest pose found to its end
+   * @return double Distance remaining (m)
+   */
+  double distanceRemaining() const
+  {
+    return lengths_.empty() ? 0.0 : lengths_.back() - lengths_[closest_idx_];
+  }
+
+  /**
+   * @brief Whether no path, or an empty one, is tracked
+   */
+  bool empty() const
+  {
+    return lengths_.empty();
+  }
+
+protected:
+  double search_window_;
+  std_msgs::msg::Header header_;
+  geometry_msgs::msg::Pose front_;
+  geometry_msgs::msg::Pose back_;
+  std::vector<geometry_msgs::msg::Point> poses_;
+  // Length of the path from its start to each pose
+  std::vector<double> lengths_;
+  size_t closest_idx_{0};
+  bool searched_{false};
+};
+
+}  // namespace nav2_util
+
+#endif  // NAV2_UTIL__PATH_PROGRESS_HPP_
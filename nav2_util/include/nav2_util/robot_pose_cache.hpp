@@ -0,0 +1,116 @@
+// Copyright (c) 2024 Open Navigation LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef NAV2_UTIL__ROBOT_POSE_CACHE_HPP_
+#define NAV2_UTIL__ROBOT_POSE_CACHE_HPP_
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+
+#include "geometry_msgs/msg/pose_stamped.hpp"
+#include "tf2_ros/buffer.h"
+
+namespace nav2_util
+{
+
+/**
+ * @class nav2_util::RobotPoseCache
+ * @brief Latest pose of a robot frame in a global frame, shared by all the servers of a
+ * process. Rather than every costmap, server and behavior looking the transform up on
+ * its own, the first caller after the pose got older than its maximum age looks it up
+ * and publishes it in a lock-free slot, which the other callers read until it gets old.
+ * A failed lookup is not cached.
+ */
+class RobotPoseCache
+{
+public:
+  /**
+   * @brief Get the cache of a pair of frames, created on first use
+   * @param global_frame Frame of the pose
+   * @param robot_frame Frame of the robot
+   * @return The cache shared by the process for these frames
+   */
+  static std::shared_ptr<RobotPoseCache> get(
+    const std::string & global_frame, const std::string & robot_frame);
+
+  /**
+   * @brief A constructor for nav2_util::RobotPoseCache, use get() for the shared ones
+   * @param global_frame Frame of the pose
+   * @param robot_frame Frame of the robot
+   */
+  RobotPoseCache(const std::string & global_frame, const std::string & robot_frame);
+
+  /**
+   * @brief Get the pose of the robot, from the cache if it was looked up less than
+   * max_age ago, else from the TF buffer of the caller
+   * @param tf_buffer TF buffer to look the pose up in
+   * @param pose Pose of the robot, stamped with its transform
+   * @param transform_timeout TF timeout of a lookup
+   * @param max_age Age from which the cached pose is looked up again (s), 0 to always
+   * look it up
+   * @return Whether a pose was found
+   */
+  bool getPose(
+    tf2_ros::Buffer & tf_buffer, geometry_msgs::msg::PoseStamped & pose,
+    double transform_timeout, double max_age);
+
+protected:
+  /**
+   * @brief A pose and the steady time it was looked up at
+   */
+  struct Entry
+  {
+    double position[3];
+    double orientation[4];
+    int32_t sec;
+    uint32_t nanosec;
+    int64_t lookup_time;
+  };
+  static constexpr size_t kWords = (sizeof(Entry) + sizeof(uint64_t) - 1) / sizeof(uint64_t);
+
+  /**
+   * @brief Read the latest entry, retrying while it is being written
+   * @return Whether an entry was written yet
+   */
+  bool read(Entry & entry) const;
+
+  /**
+   * @brief Publish a new entry, with refresh_mutex_ held
+   */
+  void write(const Entry & entry);
+
+  /**
+   * @brief Fill a pose from an entry if it is younger than max_age
+   */
+  bool fromEntry(
+    const Entry & entry, int64_t now, double max_age,
+    geometry_msgs::msg::PoseStamped & pose) const;
+
+  std::string global_frame_;
+  std::string robot_frame_;
+
+  // Seqlock: odd while the entry is being written, 0 before the first one
+  std::atomic<uint64_t> sequence_{0};
+  std::array<std::atomic<uint64_t>, kWords> words_{};
+  // Serializes the lookups, so that concurrent callers only look up once
+  std::mutex refresh_mutex_;
+};
+
+}  // namespace nav2_util
+
+#endif  // NAV2_UTIL__ROBOT_POSE_CACHE_HPP_
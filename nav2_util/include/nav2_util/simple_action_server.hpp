@@ -15,11 +15,12 @@
 #ifndef NAV2_UTIL__SIMPLE_ACTION_SERVER_HPP_
 #define NAV2_UTIL__SIMPLE_ACTION_SERVER_HPP_
 
+#include <atomic>
+#include <condition_variable>
 #include <memory>
 #include <mutex>
 #include <string>
 #include <thread>
-#include <future>
 #include <chrono>
 
 #include "rclcpp/rclcpp.hpp"
@@ -50,6 +51,10 @@ public:
   // ExecuteCallback.
   typedef std::function<void ()> CompletionCallback;
 
+  // Callback function to notify the user of a new goal or cancel request, from the
+  // executor thread, so that an execution waiting on events can check for them at once
+  typedef std::function<void ()> RequestCallback;
+
   /**
    * @brief An constructor for SimpleActionServer
    * @param node Ptr to node to make actions
@@ -137,6 +142,21 @@ public:
     }
   }
 
+  /**
+   * @brief A destructor for SimpleActionServer, waiting for the goal executing to return
+   */
+  ~SimpleActionServer()
+  {
+    {
+      std::lock_guard<std::recursive_mutex> lock(update_mutex_);
+      stop_worker_ = true;
+    }
+    work_cv_.notify_all();
+    if (worker_thread_.joinable()) {
+      worker_thread_.join();
+    }
+  }
+
   /**
    * @brief handle the goal requested: accept or reject. This implementation always accepts.
    * @param uuid Goal ID
@@ -176,6 +196,9 @@ public:
     }
 
     debug_msg("Received request for goal cancellation");
+    if (request_callback_) {
+      request_callback_();
+    }
     return rclcpp_action::CancelResponse::ACCEPT;
   }
 
@@ -190,6 +213,17 @@ public:
     }
   }
 
+  /**
+   * @brief Pins the worker thread executing the goals to a CPU core, from the next goal
+   * @param cpu Index of the core, negative not to pin it
+   */
+  void setCpuAffinity(int cpu)
+  {
+    std::lock_guard<std::recursive_mutex> lock(update_mutex_);
+    cpu_affinity_ = cpu;
+    cpu_affinity_changed_ = true;
+  }
+
   /**
    * @brief Handles accepted goals and adds to preempted queue to switch to
    * @param Goal A server goal handle to cancel
@@ -210,6 +244,9 @@ public:
       }
       pending_handle_ = handle;
       preempt_requested_ = true;
+      if (request_callback_) {
+        request_callback_();
+      }
     } else {
       if (is_active(pending_handle_)) {
         // Shouldn't reach a state with a pending goal but no current one.
@@ -220,13 +257,14 @@ public:
 
       current_handle_ = handle;
 
-      // Return quickly to avoid blocking the executor, so spin up a new thread
+      // Return quickly to avoid blocking the executor, so hand the goal to the worker thread
       debug_msg("Executing goal asynchronously.");
-      execution_future_ = std::async(
-        std::launch::async, [this]() {
-          setSoftRealTimePriority();
-          work();
-        });
+      running_ = true;
+      work_requested_ = true;
+      if (!worker_thread_.joinable()) {
+        worker_thread_ = std::thread(&SimpleActionServer::workerLoop, this);
+      }
+      work_cv_.notify_one();
     }
   }
 
@@ -275,6 +313,16 @@ public:
     debug_msg("Worker thread done.");
   }
 
+  /**
+   * @brief Sets the callback notified of preempting goals and cancel requests
+   * @param request_callback Callback, called with the server mutex held
+   */
+  void setRequestCallback(RequestCallback request_callback)
+  {
+    std::lock_guard<std::recursive_mutex> lock(update_mutex_);
+    request_callback_ = request_callback;
+  }
+
   /**
    * @brief Active action server
    */
@@ -298,24 +346,25 @@ public:
       stop_execution_ = true;
     }
 
-    if (!execution_future_.valid()) {
+    if (!is_running()) {
       return;
     }
 
-    if (is_running()) {
-      warn_msg(
-        "Requested to deactivate server but goal is still executing."
-        " Should check if action server is running before deactivating.");
-    }
+    warn_msg(
+      "Requested to deactivate server but goal is still executing."
+      " Should check if action server is running before deactivating.");
 
     using namespace std::chrono;  //NOLINT
     auto start_time = steady_clock::now();
-    while (execution_future_.wait_for(milliseconds(100)) != std::future_status::ready) {
+    std::unique_lock<std::recursive_mutex> lock(update_mutex_);
+    while (!work_done_cv_.wait_for(lock, milliseconds(100), [this]() {return !running_;})) {
       info_msg("Waiting for async process to finish.");
       if (steady_clock::now() - start_time >= server_timeout_) {
         terminate_all();
+        lock.unlock();
         if (completion_callback_) {completion_callback_();}
         error_msg("Action callback is still running and missed deadline to stop");
+        lock.lock();
       }
     }
 
@@ -328,9 +377,7 @@ public:
    */
   bool is_running()
   {
-    return execution_future_.valid() &&
-           (execution_future_.wait_for(std::chrono::milliseconds(0)) ==
-           std::future_status::timeout);
+    return running_;
   }
 
   /**
@@ -531,10 +578,20 @@ protected:
 
   ExecuteCallback execute_callback_;
   CompletionCallback completion_callback_;
-  std::future<void> execution_future_;
+  RequestCallback request_callback_;
   bool stop_execution_{false};
   bool use_realtime_prioritization_{false};
 
+  // Worker thread executing the goals, kept for the lifetime of the server
+  std::thread worker_thread_;
+  std::condition_variable_any work_cv_;
+  std::condition_variable_any work_done_cv_;
+  bool work_requested_{false};
+  bool stop_worker_{false};
+  std::atomic<bool> running_{false};
+  int cpu_affinity_{-1};
+  bool cpu_affinity_changed_{false};
+
   mutable std::recursive_mutex update_mutex_;
   bool server_active_{false};
   bool preempt_requested_{false};
@@ -549,6 +606,50 @@ protected:
   rclcpp::executors::SingleThreadedExecutor::SharedPtr executor_;
   std::unique_ptr<nav2_util::NodeThread> executor_thread_;
 
+  /**
+   * @brief Worker thread, executing the goals handed to it until the server is destroyed
+   */
+  void workerLoop()
+  {
+    try {
+      setSoftRealTimePriority();
+    } catch (const std::runtime_error & e) {
+      warn_msg(e.what());
+    }
+
+    std::unique_lock<std::recursive_mutex> lock(update_mutex_);
+    while (true) {
+      work_cv_.wait(lock, [this]() {return work_requested_ || stop_worker_;});
+      if (stop_worker_) {
+        break;
+      }
+      work_requested_ = false;
+
+      if (cpu_affinity_changed_ && cpu_affinity_ >= 0) {
+        try {
+          nav2_util::setThreadAffinity(cpu_affinity_);
+        } catch (const std::runtime_error & e) {
+          warn_msg(e.what());
+        }
+      }
+      cpu_affinity_changed_ = false;
+
+      lock.unlock();
+      work();
+      lock.lock();
+
+      // A goal may have been accepted as pending after the last check of work()
+      if (!stop_execution_ && is_active(pending_handle_)) {
+        debug_msg("Executing a pending handle accepted while finishing the previous goal.");
+        accept_pending_goal();
+        work_requested_ = true;
+        continue;
+      }
+      running_ = false;
+      work_done_cv_.notify_all();
+    }
+  }
+
   /**
    * @brief Generate an empty result object for an action type
    */
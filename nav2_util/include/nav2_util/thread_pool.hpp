@@ -0,0 +1,108 @@
+// Copyright (c) 2024 Open Navigation LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef NAV2_UTIL__THREAD_POOL_HPP_
+#define NAV2_UTIL__THREAD_POOL_HPP_
+
+#include <condition_variable>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace nav2_util
+{
+
+/**
+ * @class nav2_util::ThreadPool
+ * @brief A fixed size pool of worker threads to run short compute tasks on,
+ * such as per-layer, per-critic or per-segment work in a server's update cycle,
+ * without the cost of spawning threads on every cycle.
+ */
+class ThreadPool
+{
+public:
+  /**
+   * @brief A constructor
+   * @param num_threads Number of worker threads to spawn. If 0, the number of
+   * hardware threads is used.
+   */
+  explicit ThreadPool(unsigned int num_threads = 0);
+
+  /**
+   * @brief A destructor, waits for queued tasks to finish before joining the workers
+   */
+  ~ThreadPool();
+
+  ThreadPool(const ThreadPool &) = delete;
+  ThreadPool & operator=(const ThreadPool &) = delete;
+
+  /**
+   * @brief Queue a task for execution on a worker thread
+   * @param task Callable to run
+   * @return Future holding the task's result or the exception it threw
+   */
+  template<typename F>
+  auto enqueue(F && task) -> std::future<std::invoke_result_t<std::decay_t<F>>>
+  {
+    using ResultT = std::invoke_result_t<std::decay_t<F>>;
+    auto packaged = std::make_shared<std::packaged_task<ResultT()>>(std::forward<F>(task));
+    std::future<ResultT> result = packaged->get_future();
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      tasks_.emplace([packaged]() {(*packaged)();});
+    }
+    cv_.notify_one();
+    return result;
+  }
+
+  /**
+   * @brief Run fn(i) for every i in [begin, end), distributed over the workers
+   * and the calling thread. Blocks until all iterations completed and rethrows
+   * the first exception raised by any iteration.
+   * @param begin First index
+   * @param end One past the last index
+   * @param fn Function to call for each index
+   */
+  void parallelFor(size_t begin, size_t end, const std::function<void(size_t)> & fn);
+
+  /**
+   * @brief Number of worker threads in the pool
+   */
+  unsigned int size() const
+  {
+    return static_cast<unsigned int>(workers_.size());
+  }
+
+protected:
+  /**
+   * @brief Worker thread main loop
+   */
+  void work();
+
+  std::vector<std::thread> workers_;
+  std::queue<std::function<void()>> tasks_;
+  std::mutex mutex_;
+  std::condition_variable cv_;
+  bool stop_{false};
+};
+
+}  // namespace nav2_util
+
+#endif  // NAV2_UTIL__THREAD_POOL_HPP_
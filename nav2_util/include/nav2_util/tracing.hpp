@@ -0,0 +1,171 @@
+// Copyright (c) 2024 Open Navigation LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#ifndef NAV2_UTIL__TRACING_HPP_
+#define NAV2_UTIL__TRACING_HPP_
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace nav2_util
+{
+
+/**
+ * @class nav2_util::Tracer
+ * @brief Process wide trace session, recording the spans of the hot paths of the servers
+ * into a ring buffer, the oldest spans being overwritten. Recording is lock free, and the
+ * spans are written as a Chrome trace (chrome://tracing, Perfetto) once stopped.
+ *
+ * A session is started from the NAV2_TRACE_FILE environment variable, with
+ * NAV2_TRACE_CAPACITY spans (65536 by default), and written to the file at the end of
+ * the process. The trace points are only compiled with the NAV2_TRACING option.
+ */
+class Tracer
+{
+public:
+  using Clock = std::chrono::steady_clock;
+
+  /// @brief A span of a trace point
+  struct Span
+  {
+    // Name of the trace point, a string literal
+    const char * name{nullptr};
+    int64_t start_ns{0};
+    int64_t end_ns{0};
+    // Identifier of the data processed, such as the stamp of a sensor message,
+    // to follow it from stage to stage
+    uint64_t id{0};
+    uint64_t thread{0};
+  };
+
+  /**
+   * @brief Gets the trace session of the process
+   */
+  static Tracer & instance();
+
+  /**
+   * @brief A destructor, writing the session started from NAV2_TRACE_FILE
+   */
+  ~Tracer();
+
+  /**
+   * @brief Starts recording spans
+   * @param capacity Number of spans kept
+   */
+  void start(size_t capacity);
+
+  /**
+   * @brief Stops recording spans
+   */
+  void stop();
+
+  /**
+   * @brief Whether spans are recorded
+   */
+  bool enabled() const {return enabled_.load(std::memory_order_relaxed);}
+
+  /**
+   * @brief Records a span
+   * @param name Name of the trace point, a string literal
+   * @param start Start of the span
+   * @param end End of the span
+   * @param id Identifier of the data processed, 0 if none
+   */
+  void record(const char * name, Clock::time_point start, Clock::time_point end, uint64_t id);
+
+  /**
+   * @brief Gets the spans recorded, from the oldest one. Should be called once stopped.
+   */
+  std::vector<Span> getSpans() const;
+
+  /**
+   * @brief Writes the spans recorded as a Chrome trace. Should be called once stopped.
+   * @param stream Stream to write to
+   */
+  void write(std::ostream & stream) const;
+
+protected:
+  Tracer();
+
+  std::atomic<bool> enabled_{false};
+  std::atomic<uint64_t> next_span_{0};
+  std::vector<Span> spans_;
+  std::string file_;
+};
+
+/**
+ * @class nav2_util::TraceScope
+ * @brief Records the span of a scope, when a session is started
+ */
+class TraceScope
+{
+public:
+  /**
+   * @brief A constructor, starting the span
+   * @param name Name of the trace point, a string literal
+   * @param id Identifier of the data processed, 0 if none
+   */
+  explicit TraceScope(const char * name, uint64_t id = 0)
+  : name_(name), id_(id), enabled_(Tracer::instance().enabled())
+  {
+    if (enabled_) {
+      start_ = Tracer::Clock::now();
+    }
+  }
+
+  /**
+   * @brief A destructor, recording the span
+   */
+  ~TraceScope()
+  {
+    if (enabled_) {
+      Tracer::instance().record(name_, start_, Tracer::Clock::now(), id_);
+    }
+  }
+
+  /**
+   * @brief Sets the identifier of the data processed, once known
+   */
+  void setId(uint64_t id) {id_ = id;}
+
+protected:
+  const char * name_;
+  uint64_t id_;
+  bool enabled_;
+  Tracer::Clock::time_point start_;
+};
+
+}  // namespace nav2_util
+
+#define NAV2_TRACE_CONCAT_(a, b) a ## b
+#define NAV2_TRACE_CONCAT(a, b) NAV2_TRACE_CONCAT_(a, b)
+
+#ifdef NAV2_TRACING
+/// @brief Records the span of the enclosing scope
+#define NAV2_TRACE_SCOPE(name) \
+  nav2_util::TraceScope NAV2_TRACE_CONCAT(nav2_trace_scope_, __LINE__)(name)
+/// @brief Records the span of the enclosing scope, for the data of an identifier
+#define NAV2_TRACE_SCOPE_ID(name, id) \
+  nav2_util::TraceScope NAV2_TRACE_CONCAT(nav2_trace_scope_, __LINE__)(name, id)
+#else
+#define NAV2_TRACE_SCOPE(name)
+#define NAV2_TRACE_SCOPE_ID(name, id)
+#endif
+
+#endif  // NAV2_UTIL__TRACING_HPP_
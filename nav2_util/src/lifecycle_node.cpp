@@ -14,6 +14,7 @@
 
 #include "nav2_util/lifecycle_node.hpp"
 
+#include <algorithm>
 #include <memory>
 #include <string>
 #include <vector>
@@ -39,6 +40,12 @@ LifecycleNode::LifecycleNode(
   nav2_util::declare_parameter_if_not_declared(
     this, "bond_heartbeat_period", rclcpp::ParameterValue(0.1));
   this->get_parameter("bond_heartbeat_period", bond_heartbeat_period);
+  nav2_util::declare_parameter_if_not_declared(
+    this, "use_liveliness_heartbeat", rclcpp::ParameterValue(false));
+  nav2_util::declare_parameter_if_not_declared(
+    this, "liveliness_lease_duration", rclcpp::ParameterValue(4.0));
+  this->get_parameter("use_liveliness_heartbeat", use_liveliness_heartbeat_);
+  this->get_parameter("liveliness_lease_duration", liveliness_lease_duration_);
 
   printLifecycleNodeNotification();
 
@@ -58,8 +65,44 @@ LifecycleNode::~LifecycleNode()
   }
 }
 
+ThreadSettings LifecycleNode::getThreadSettings(const std::string & name)
+{
+  nav2_util::declare_parameter_if_not_declared(
+    this, name + ".num_threads", rclcpp::ParameterValue(1));
+  nav2_util::declare_parameter_if_not_declared(
+    this, name + ".cpu", rclcpp::ParameterValue(-1));
+  nav2_util::declare_parameter_if_not_declared(
+    this, name + ".priority", rclcpp::ParameterValue(0));
+
+  ThreadSettings settings;
+  settings.num_threads = static_cast<size_t>(
+    std::max<int64_t>(1, get_parameter(name + ".num_threads").as_int()));
+  settings.cpu = get_parameter(name + ".cpu").as_int();
+  settings.priority = get_parameter(name + ".priority").as_int();
+  return settings;
+}
+
 void LifecycleNode::createBond()
 {
+  if (use_liveliness_heartbeat_ && liveliness_lease_duration_ > 0.0) {
+    RCLCPP_INFO(
+      get_logger(), "Asserting liveliness (%s) to lifecycle manager.", this->get_name());
+
+    // Assertions from the executor of the node, so that a stuck node is detected as a
+    // bond would, a few times per lease
+    const auto lease = rclcpp::Duration::from_seconds(liveliness_lease_duration_);
+    liveliness_pub_ = create_publisher<std_msgs::msg::Empty>(
+      std::string(get_name()) + "/liveliness",
+      rclcpp::QoS(1)
+      .liveliness(RMW_QOS_POLICY_LIVELINESS_MANUAL_BY_TOPIC)
+      .liveliness_lease_duration(lease));
+    liveliness_pub_->assert_liveliness();
+    liveliness_timer_ = create_wall_timer(
+      lease.to_chrono<std::chrono::nanoseconds>() / 4,
+      [this]() {liveliness_pub_->assert_liveliness();});
+    return;
+  }
+
   if (bond_heartbeat_period > 0.0) {
     RCLCPP_INFO(get_logger(), "Creating bond (%s) to lifecycle manager.", this->get_name());
 
@@ -117,6 +160,13 @@ void LifecycleNode::register_rcl_preshutdown_callback()
 
 void LifecycleNode::destroyBond()
 {
+  if (liveliness_pub_) {
+    RCLCPP_INFO(
+      get_logger(), "Destroying liveliness (%s) to lifecycle manager.", this->get_name());
+    liveliness_timer_.reset();
+    liveliness_pub_.reset();
+  }
+
   if (bond_heartbeat_period > 0.0) {
     RCLCPP_INFO(get_logger(), "Destroying bond (%s) to lifecycle manager.", this->get_name());
 
@@ -13,31 +13,67 @@
 // limitations under the License.
 
 #include <memory>
+#include <stdexcept>
 #include "nav2_util/node_thread.hpp"
+#include "nav2_util/node_utils.hpp"
 
 namespace nav2_util
 {
 
 NodeThread::NodeThread(
-  rclcpp::node_interfaces::NodeBaseInterface::SharedPtr node_base)
-: node_(node_base)
+  rclcpp::node_interfaces::NodeBaseInterface::SharedPtr node_base,
+  const ThreadSettings & settings)
+: node_(node_base), settings_(settings)
 {
-  executor_ = std::make_shared<rclcpp::executors::SingleThreadedExecutor>();
-  thread_ = std::make_unique<std::thread>(
-    [&]()
-    {
-      executor_->add_node(node_);
-      executor_->spin();
-      executor_->remove_node(node_);
-    });
+  if (settings_.num_threads > 1) {
+    executor_ = std::make_shared<rclcpp::executors::MultiThreadedExecutor>(
+      rclcpp::ExecutorOptions(), settings_.num_threads);
+  } else {
+    executor_ = std::make_shared<rclcpp::executors::SingleThreadedExecutor>();
+  }
+  startThread();
 }
 
-NodeThread::NodeThread(rclcpp::executors::SingleThreadedExecutor::SharedPtr executor)
-: executor_(executor)
+NodeThread::NodeThread(
+  rclcpp::executors::SingleThreadedExecutor::SharedPtr executor,
+  const ThreadSettings & settings)
+: executor_(executor), settings_(settings)
+{
+  startThread();
+}
+
+NodeThread::NodeThread(
+  rclcpp::executors::MultiThreadedExecutor::SharedPtr executor,
+  const ThreadSettings & settings)
+: executor_(executor), settings_(settings)
+{
+  startThread();
+}
+
+void NodeThread::startThread()
 {
   thread_ = std::make_unique<std::thread>(
-    [&]() {
-      executor_->spin();
+    [&]()
+    {
+      // Threads of a multi-threaded executor inherit the affinity and scheduling
+      try {
+        if (settings_.cpu >= 0) {
+          setThreadAffinity(settings_.cpu);
+        }
+        if (settings_.priority > 0) {
+          setThreadPriority(settings_.priority);
+        }
+      } catch (const std::runtime_error & e) {
+        RCLCPP_WARN(rclcpp::get_logger("nav2_util"), "%s", e.what());
+      }
+
+      if (node_) {
+        executor_->add_node(node_);
+        executor_->spin();
+        executor_->remove_node(node_);
+      } else {
+        executor_->spin();
+      }
     });
 }
 
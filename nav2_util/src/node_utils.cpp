@@ -14,6 +14,9 @@
 // limitations under the License.
 
 #include "nav2_util/node_utils.hpp"
+#include <pthread.h>
+#include <sched.h>
+#include <cstring>
 #include <chrono>
 #include <string>
 #include <algorithm>
@@ -91,9 +94,14 @@ rclcpp::Node::SharedPtr generate_internal_node(const std::string & prefix)
 }
 
 void setSoftRealTimePriority()
+{
+  setThreadPriority(49);
+}
+
+void setThreadPriority(int priority)
 {
   sched_param sch;
-  sch.sched_priority = 49;
+  sch.sched_priority = priority;
   if (sched_setscheduler(0, SCHED_FIFO, &sch) == -1) {
     std::string errmsg(
       "Cannot set as real-time thread. Users must set: <username> hard rtprio 99 and "
@@ -103,4 +111,16 @@ void setSoftRealTimePriority()
   }
 }
 
+void setThreadAffinity(int cpu)
+{
+  cpu_set_t cpu_set;
+  CPU_ZERO(&cpu_set);
+  CPU_SET(cpu, &cpu_set);
+  const int error = pthread_setaffinity_np(pthread_self(), sizeof(cpu_set), &cpu_set);
+  if (error != 0) {
+    throw std::runtime_error(
+            "Cannot pin the thread to CPU " + std::to_string(cpu) + ": " + std::strerror(error));
+  }
+}
+
 }  // namespace nav2_util
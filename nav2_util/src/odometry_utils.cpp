@@ -14,8 +14,12 @@
 // limitations under the License.
 
 #include <string>
+#include <utility>
+#include <vector>
 
 #include "nav2_util/odometry_utils.hpp"
+#include "nav2_util/geometry_utils.hpp"
+#include "tf2/utils.h"
 
 using namespace std::chrono;  // NOLINT
 using namespace std::chrono_literals;  // NOLINT
@@ -23,11 +27,16 @@ using namespace std::chrono_literals;  // NOLINT
 namespace nav2_util
 {
 
+// Odometry the history ring buffer is first sized for
+static constexpr size_t INITIAL_HISTORY_CAPACITY = 16;
+
 OdomSmoother::OdomSmoother(
   const rclcpp::Node::WeakPtr & parent,
   double filter_duration,
   const std::string & odom_topic)
-: odom_history_duration_(rclcpp::Duration::from_seconds(filter_duration))
+: odom_history_duration_(rclcpp::Duration::from_seconds(filter_duration)),
+  odom_history_(INITIAL_HISTORY_CAPACITY), odom_history_head_(0), odom_history_size_(0),
+  time_cumulate_(0.0)
 {
   auto node = parent.lock();
   odom_sub_ = node->create_subscription<nav_msgs::msg::Odometry>(
@@ -47,7 +56,9 @@ OdomSmoother::OdomSmoother(
   const nav2_util::LifecycleNode::WeakPtr & parent,
   double filter_duration,
   const std::string & odom_topic)
-: odom_history_duration_(rclcpp::Duration::from_seconds(filter_duration))
+: odom_history_duration_(rclcpp::Duration::from_seconds(filter_duration)),
+  odom_history_(INITIAL_HISTORY_CAPACITY), odom_history_head_(0), odom_history_size_(0),
+  time_cumulate_(0.0)
 {
   auto node = parent.lock();
   odom_sub_ = node->create_subscription<nav_msgs::msg::Odometry>(
@@ -67,55 +78,140 @@ void OdomSmoother::odomCallback(const nav_msgs::msg::Odometry::SharedPtr msg)
 {
   std::lock_guard<std::mutex> lock(odom_mutex_);
 
-  // update cumulated odom only if history is not empty
-  if (!odom_history_.empty()) {
-    // to store current time
-    auto current_time = rclcpp::Time(msg->header.stamp);
-
-    // to store time of the first odom in history
-    auto front_time = rclcpp::Time(odom_history_.front().header.stamp);
-
-    // update cumulated odom when duration has exceeded and pop earliest msg
-    while (current_time - front_time > odom_history_duration_) {
-      const auto & odom = odom_history_.front();
-      odom_cumulate_.twist.twist.linear.x -= odom.twist.twist.linear.x;
-      odom_cumulate_.twist.twist.linear.y -= odom.twist.twist.linear.y;
-      odom_cumulate_.twist.twist.linear.z -= odom.twist.twist.linear.z;
-      odom_cumulate_.twist.twist.angular.x -= odom.twist.twist.angular.x;
-      odom_cumulate_.twist.twist.angular.y -= odom.twist.twist.angular.y;
-      odom_cumulate_.twist.twist.angular.z -= odom.twist.twist.angular.z;
-      odom_history_.pop_front();
-
-      if (odom_history_.empty()) {
-        break;
-      }
-
-      // update with the timestamp of earliest odom message in history
-      front_time = rclcpp::Time(odom_history_.front().header.stamp);
-    }
+  // to store current time
+  const rclcpp::Time current_time(msg->header.stamp);
+  if (odom_history_size_ == 0 && time_origin_.nanoseconds() == 0) {
+    time_origin_ = current_time;
+  }
+
+  // update cumulated odom when duration has exceeded and pop earliest msg
+  while (odom_history_size_ > 0 &&
+    current_time - sampleAt(0).stamp > odom_history_duration_)
+  {
+    const auto & odom = sampleAt(0);
+    odom_cumulate_.twist.twist.linear.x -= odom.twist.linear.x;
+    odom_cumulate_.twist.twist.linear.y -= odom.twist.linear.y;
+    odom_cumulate_.twist.twist.linear.z -= odom.twist.linear.z;
+    odom_cumulate_.twist.twist.angular.x -= odom.twist.angular.x;
+    odom_cumulate_.twist.twist.angular.y -= odom.twist.angular.y;
+    odom_cumulate_.twist.twist.angular.z -= odom.twist.angular.z;
+    time_cumulate_ -= odom.time;
+    odom_history_head_ = (odom_history_head_ + 1) % odom_history_.size();
+    odom_history_size_--;
   }
 
-  odom_history_.push_back(*msg);
+  pushSample({current_time, (current_time - time_origin_).seconds(), msg->twist.twist});
+  vel_smooth_.header = msg->header;
+  last_pose_.header = msg->header;
+  last_pose_.pose = msg->pose.pose;
   updateState();
 }
 
+void OdomSmoother::pushSample(const OdomSample & sample)
+{
+  if (odom_history_size_ == odom_history_.size()) {
+    // Unroll the ring buffer into a larger one
+    std::vector<OdomSample> history;
+    history.reserve(2 * odom_history_.size());
+    for (size_t i = 0; i < odom_history_size_; i++) {
+      history.push_back(sampleAt(i));
+    }
+    history.resize(2 * odom_history_.size());
+    odom_history_ = std::move(history);
+    odom_history_head_ = 0;
+  }
+
+  odom_history_[(odom_history_head_ + odom_history_size_) % odom_history_.size()] = sample;
+  odom_history_size_++;
+}
+
 void OdomSmoother::updateState()
 {
-  const auto & odom = odom_history_.back();
-  odom_cumulate_.twist.twist.linear.x += odom.twist.twist.linear.x;
-  odom_cumulate_.twist.twist.linear.y += odom.twist.twist.linear.y;
-  odom_cumulate_.twist.twist.linear.z += odom.twist.twist.linear.z;
-  odom_cumulate_.twist.twist.angular.x += odom.twist.twist.angular.x;
-  odom_cumulate_.twist.twist.angular.y += odom.twist.twist.angular.y;
-  odom_cumulate_.twist.twist.angular.z += odom.twist.twist.angular.z;
-
-  vel_smooth_.header = odom.header;
-  vel_smooth_.twist.linear.x = odom_cumulate_.twist.twist.linear.x / odom_history_.size();
-  vel_smooth_.twist.linear.y = odom_cumulate_.twist.twist.linear.y / odom_history_.size();
-  vel_smooth_.twist.linear.z = odom_cumulate_.twist.twist.linear.z / odom_history_.size();
-  vel_smooth_.twist.angular.x = odom_cumulate_.twist.twist.angular.x / odom_history_.size();
-  vel_smooth_.twist.angular.y = odom_cumulate_.twist.twist.angular.y / odom_history_.size();
-  vel_smooth_.twist.angular.z = odom_cumulate_.twist.twist.angular.z / odom_history_.size();
+  const auto & odom = sampleAt(odom_history_size_ - 1);
+  odom_cumulate_.twist.twist.linear.x += odom.twist.linear.x;
+  odom_cumulate_.twist.twist.linear.y += odom.twist.linear.y;
+  odom_cumulate_.twist.twist.linear.z += odom.twist.linear.z;
+  odom_cumulate_.twist.twist.angular.x += odom.twist.angular.x;
+  odom_cumulate_.twist.twist.angular.y += odom.twist.angular.y;
+  odom_cumulate_.twist.twist.angular.z += odom.twist.angular.z;
+  time_cumulate_ += odom.time;
+
+  vel_smooth_.twist.linear.x = odom_cumulate_.twist.twist.linear.x / odom_history_size_;
+  vel_smooth_.twist.linear.y = odom_cumulate_.twist.twist.linear.y / odom_history_size_;
+  vel_smooth_.twist.linear.z = odom_cumulate_.twist.twist.linear.z / odom_history_size_;
+  vel_smooth_.twist.angular.x = odom_cumulate_.twist.twist.angular.x / odom_history_size_;
+  vel_smooth_.twist.angular.y = odom_cumulate_.twist.twist.angular.y / odom_history_size_;
+  vel_smooth_.twist.angular.z = odom_cumulate_.twist.twist.angular.z / odom_history_size_;
+}
+
+bool OdomSmoother::predict(
+  const rclcpp::Time & time,
+  geometry_msgs::msg::PoseStamped & pose,
+  geometry_msgs::msg::TwistStamped & twist)
+{
+  std::lock_guard<std::mutex> lock(odom_mutex_);
+
+  if (odom_history_size_ == 0) {
+    return false;
+  }
+
+  // Acceleration over the window, from its earliest to its last odometry
+  const OdomSample & first = sampleAt(0);
+  const OdomSample & last = sampleAt(odom_history_size_ - 1);
+  geometry_msgs::msg::Twist accel;
+  const double window = last.time - first.time;
+  if (window > 0.0) {
+    accel.linear.x = (last.twist.linear.x - first.twist.linear.x) / window;
+    accel.linear.y = (last.twist.linear.y - first.twist.linear.y) / window;
+    accel.linear.z = (last.twist.linear.z - first.twist.linear.z) / window;
+    accel.angular.x = (last.twist.angular.x - first.twist.angular.x) / window;
+    accel.angular.y = (last.twist.angular.y - first.twist.angular.y) / window;
+    accel.angular.z = (last.twist.angular.z - first.twist.angular.z) / window;
+  }
+
+  // The smoothed twist is the one of the mean time of the window
+  const double mean_time = time_cumulate_ / odom_history_size_;
+  auto extrapolate = [&](const double t, geometry_msgs::msg::Twist & out) {
+      const double dt = t - mean_time;
+      out.linear.x = vel_smooth_.twist.linear.x + accel.linear.x * dt;
+      out.linear.y = vel_smooth_.twist.linear.y + accel.linear.y * dt;
+      out.linear.z = vel_smooth_.twist.linear.z + accel.linear.z * dt;
+      out.angular.x = vel_smooth_.twist.angular.x + accel.angular.x * dt;
+      out.angular.y = vel_smooth_.twist.angular.y + accel.angular.y * dt;
+      out.angular.z = vel_smooth_.twist.angular.z + accel.angular.z * dt;
+    };
+
+  const double target_time = (time - time_origin_).seconds();
+  twist.header = vel_smooth_.header;
+  twist.header.stamp = time;
+  extrapolate(target_time, twist.twist);
+
+  // Integrate the pose from the last odometry, with the twist of the middle of the interval
+  // held constant in the robot frame
+  geometry_msgs::msg::Twist mid_twist;
+  extrapolate(0.5 * (last.time + target_time), mid_twist);
+  const double dt = target_time - last.time;
+  const double vx = mid_twist.linear.x;
+  const double vy = mid_twist.linear.y;
+  const double wz = mid_twist.angular.z;
+  const double yaw = tf2::getYaw(last_pose_.pose.orientation);
+  const double new_yaw = yaw + wz * dt;
+
+  pose = last_pose_;
+  pose.header.stamp = time;
+  if (std::fabs(wz) < 1e-6) {
+    pose.pose.position.x += (vx * cos(yaw) - vy * sin(yaw)) * dt;
+    pose.pose.position.y += (vx * sin(yaw) + vy * cos(yaw)) * dt;
+  } else {
+    pose.pose.position.x +=
+      (vx * (sin(new_yaw) - sin(yaw)) + vy * (cos(new_yaw) - cos(yaw))) / wz;
+    pose.pose.position.y +=
+      (-vx * (cos(new_yaw) - cos(yaw)) + vy * (sin(new_yaw) - sin(yaw))) / wz;
+  }
+  pose.pose.position.z += mid_twist.linear.z * dt;
+  pose.pose.orientation = geometry_utils::orientationAroundZAxis(new_yaw);
+
+  return true;
 }
 
 }  // namespace nav2_util
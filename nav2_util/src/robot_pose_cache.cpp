@@ -0,0 +1,156 @@
+// Copyright (c) 2024 Open Navigation LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "nav2_util/robot_pose_cache.hpp"
+
+#include <chrono>
+#include <cstring>
+#include <map>
+#include <memory>
+#include <string>
+#include <thread>
+#include <utility>
+
+#include "nav2_util/robot_utils.hpp"
+
+namespace nav2_util
+{
+
+namespace
+{
+
+int64_t steadyNow()
+{
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(
+    std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+}  // namespace
+
+std::shared_ptr<RobotPoseCache>
+RobotPoseCache::get(const std::string & global_frame, const std::string & robot_frame)
+{
+  static std::mutex mutex;
+  static std::map<std::pair<std::string, std::string>, std::shared_ptr<RobotPoseCache>> caches;
+
+  std::lock_guard<std::mutex> lock(mutex);
+  auto & cache = caches[{global_frame, robot_frame}];
+  if (!cache) {
+    cache = std::make_shared<RobotPoseCache>(global_frame, robot_frame);
+  }
+  return cache;
+}
+
+RobotPoseCache::RobotPoseCache(const std::string & global_frame, const std::string & robot_frame)
+: global_frame_(global_frame), robot_frame_(robot_frame)
+{
+}
+
+bool
+RobotPoseCache::getPose(
+  tf2_ros::Buffer & tf_buffer, geometry_msgs::msg::PoseStamped & pose,
+  double transform_timeout, double max_age)
+{
+  Entry entry;
+  if (read(entry) && fromEntry(entry, steadyNow(), max_age, pose)) {
+    return true;
+  }
+
+  // Another caller may have looked it up while this one waited
+  std::lock_guard<std::mutex> lock(refresh_mutex_);
+  if (read(entry) && fromEntry(entry, steadyNow(), max_age, pose)) {
+    return true;
+  }
+
+  const int64_t lookup_time = steadyNow();
+  if (!getCurrentPose(pose, tf_buffer, global_frame_, robot_frame_, transform_timeout)) {
+    return false;
+  }
+
+  entry.position[0] = pose.pose.position.x;
+  entry.position[1] = pose.pose.position.y;
+  entry.position[2] = pose.pose.position.z;
+  entry.orientation[0] = pose.pose.orientation.x;
+  entry.orientation[1] = pose.pose.orientation.y;
+  entry.orientation[2] = pose.pose.orientation.z;
+  entry.orientation[3] = pose.pose.orientation.w;
+  entry.sec = pose.header.stamp.sec;
+  entry.nanosec = pose.header.stamp.nanosec;
+  entry.lookup_time = lookup_time;
+  write(entry);
+  return true;
+}
+
+bool
+RobotPoseCache::read(Entry & entry) const
+{
+  std::array<uint64_t, kWords> words;
+  while (true) {
+    const uint64_t sequence = sequence_.load(std::memory_order_acquire);
+    if (sequence == 0) {
+      return false;
+    }
+    if (sequence & 1) {
+      std::this_thread::yield();
+      continue;
+    }
+    for (size_t i = 0; i < kWords; i++) {
+      words[i] = words_[i].load(std::memory_order_relaxed);
+    }
+    std::atomic_thread_fence(std::memory_order_acquire);
+    if (sequence_.load(std::memory_order_relaxed) == sequence) {
+      std::memcpy(&entry, words.data(), sizeof(Entry));
+      return true;
+    }
+  }
+}
+
+void
+RobotPoseCache::write(const Entry & entry)
+{
+  std::array<uint64_t, kWords> words{};
+  std::memcpy(words.data(), &entry, sizeof(Entry));
+
+  const uint64_t sequence = sequence_.load(std::memory_order_relaxed);
+  sequence_.store(sequence + 1, std::memory_order_relaxed);
+  std::atomic_thread_fence(std::memory_order_release);
+  for (size_t i = 0; i < kWords; i++) {
+    words_[i].store(words[i], std::memory_order_relaxed);
+  }
+  sequence_.store(sequence + 2, std::memory_order_release);
+}
+
+bool
+RobotPoseCache::fromEntry(
+  const Entry & entry, int64_t now, double max_age,
+  geometry_msgs::msg::PoseStamped & pose) const
+{
+  if (static_cast<double>(now - entry.lookup_time) >= max_age * 1e9) {
+    return false;
+  }
+
+  pose.header.frame_id = global_frame_;
+  pose.header.stamp.sec = entry.sec;
+  pose.header.stamp.nanosec = entry.nanosec;
+  pose.pose.position.x = entry.position[0];
+  pose.pose.position.y = entry.position[1];
+  pose.pose.position.z = entry.position[2];
+  pose.pose.orientation.x = entry.orientation[0];
+  pose.pose.orientation.y = entry.orientation[1];
+  pose.pose.orientation.z = entry.orientation[2];
+  pose.pose.orientation.w = entry.orientation[3];
+  return true;
+}
+
+}  // namespace nav2_util
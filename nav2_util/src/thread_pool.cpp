@@ -0,0 +1,110 @@
+// Copyright (c) 2024 Open Navigation LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "nav2_util/thread_pool.hpp"
+
+#include <algorithm>
+#include <atomic>
+
+namespace nav2_util
+{
+
+ThreadPool::ThreadPool(unsigned int num_threads)
+{
+  if (num_threads == 0) {
+    num_threads = std::max(1u, std::thread::hardware_concurrency());
+  }
+
+  workers_.reserve(num_threads);
+  for (unsigned int i = 0; i < num_threads; ++i) {
+    workers_.emplace_back([this]() {work();});
+  }
+}
+
+ThreadPool::~ThreadPool()
+{
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stop_ = true;
+  }
+  cv_.notify_all();
+  for (auto & worker : workers_) {
+    worker.join();
+  }
+}
+
+void ThreadPool::work()
+{
+  while (true) {
+    std::function<void()> task;
+    {
+      std::unique_lock<std::mutex> lock(mutex_);
+      cv_.wait(lock, [this]() {return stop_ || !tasks_.empty();});
+      if (stop_ && tasks_.empty()) {
+        return;
+      }
+      task = std::move(tasks_.front());
+      tasks_.pop();
+    }
+    task();
+  }
+}
+
+void ThreadPool::parallelFor(
+  size_t begin, size_t end, const std::function<void(size_t)> & fn)
+{
+  if (end <= begin) {
+    return;
+  }
+
+  // Iterations are claimed one at a time so uneven work balances itself out
+  std::atomic<size_t> next{begin};
+  auto run = [&]() {
+      for (size_t i = next++; i < end; i = next++) {
+        fn(i);
+      }
+    };
+
+  const size_t helpers = std::min(static_cast<size_t>(size()), end - begin - 1);
+  std::vector<std::future<void>> futures;
+  futures.reserve(helpers);
+  for (size_t i = 0; i < helpers; ++i) {
+    futures.push_back(enqueue(run));
+  }
+
+  // The calling thread works too rather than idling until the helpers finish
+  std::exception_ptr error;
+  try {
+    run();
+  } catch (...) {
+    error = std::current_exception();
+    next = end;
+  }
+
+  for (auto & future : futures) {
+    try {
+      future.get();
+    } catch (...) {
+      if (!error) {
+        error = std::current_exception();
+      }
+    }
+  }
+
+  if (error) {
+    std::rethrow_exception(error);
+  }
+}
+
+}  // namespace nav2_util
@@ -0,0 +1,126 @@
+// Copyright (c) 2024 Open Navigation LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include "nav2_util/tracing.hpp"
+
+#include <unistd.h>
+
+#include <algorithm>
+#include <cstdlib>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace nav2_util
+{
+
+Tracer & Tracer::instance()
+{
+  static Tracer tracer;
+  return tracer;
+}
+
+Tracer::Tracer()
+{
+  const char * file = std::getenv("NAV2_TRACE_FILE");
+  if (file == nullptr || file[0] == '\0') {
+    return;
+  }
+  file_ = file;
+
+  size_t capacity = 65536;
+  const char * capacity_env = std::getenv("NAV2_TRACE_CAPACITY");
+  if (capacity_env != nullptr) {
+    capacity = std::max<size_t>(1, std::strtoull(capacity_env, nullptr, 10));
+  }
+  start(capacity);
+}
+
+Tracer::~Tracer()
+{
+  if (file_.empty()) {
+    return;
+  }
+  stop();
+  std::ofstream stream(file_);
+  write(stream);
+}
+
+void Tracer::start(size_t capacity)
+{
+  enabled_ = false;
+  spans_.assign(std::max<size_t>(1, capacity), Span());
+  next_span_ = 0;
+  enabled_ = true;
+}
+
+void Tracer::stop()
+{
+  enabled_ = false;
+}
+
+void Tracer::record(
+  const char * name, Clock::time_point start, Clock::time_point end, uint64_t id)
+{
+  const uint64_t index = next_span_.fetch_add(1, std::memory_order_relaxed);
+  Span & span = spans_[index % spans_.size()];
+  span.name = name;
+  span.start_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+    start.time_since_epoch()).count();
+  span.end_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+    end.time_since_epoch()).count();
+  span.id = id;
+  span.thread = std::hash<std::thread::id>()(std::this_thread::get_id());
+}
+
+std::vector<Tracer::Span> Tracer::getSpans() const
+{
+  std::vector<Span> spans;
+  if (spans_.empty()) {
+    return spans;
+  }
+  const uint64_t end = next_span_.load();
+  const uint64_t begin = end > spans_.size() ? end - spans_.size() : 0;
+  spans.reserve(end - begin);
+  for (uint64_t i = begin; i < end; ++i) {
+    spans.push_back(spans_[i % spans_.size()]);
+  }
+  return spans;
+}
+
+void Tracer::write(std::ostream & stream) const
+{
+  // Microseconds of the monotonic clock, shared by the processes of a host
+  stream << std::fixed << std::setprecision(3) << "{\"traceEvents\":[";
+  bool first = true;
+  for (const auto & span : getSpans()) {
+    if (span.name == nullptr) {
+      continue;
+    }
+    stream << (first ? "\n" : ",\n") <<
+      "{\"name\":\"" << span.name << "\",\"ph\":\"X\",\"pid\":" << getpid() << ",\"tid\":" <<
+      span.thread % 1000000 <<
+      ",\"ts\":" << span.start_ns / 1000.0 <<
+      ",\"dur\":" << (span.end_ns - span.start_ns) / 1000.0 <<
+      ",\"args\":{\"id\":" << span.id << "}}";
+    first = false;
+  }
+  stream << "\n]}\n";
+}
+
+}  // namespace nav2_util
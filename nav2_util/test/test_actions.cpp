@@ -12,8 +12,11 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+#include <atomic>
 #include <chrono>
 #include <memory>
+#include <mutex>
+#include <set>
 #include <thread>
 
 #include "gtest/gtest.h"
@@ -28,6 +31,13 @@ using GoalHandle = rclcpp_action::ServerGoalHandle<Fibonacci>;
 using std::placeholders::_1;
 using namespace std::chrono_literals;
 
+// Preemptions and cancels notified by the server
+std::atomic<int> g_requests{0};
+
+// Threads the goals were executed on
+std::mutex g_threads_mutex;
+std::set<std::thread::id> g_execution_threads;
+
 class FibonacciServerNode : public rclcpp::Node
 {
 public:
@@ -46,6 +56,7 @@ public:
       shared_from_this(),
       "fibonacci",
       std::bind(&FibonacciServerNode::execute, this));
+    action_server_->setRequestCallback([]() {g_requests++;});
 
     deactivate_subs_ = create_subscription<std_msgs::msg::Empty>(
       "deactivate_server",
@@ -93,6 +104,10 @@ public:
 
   void execute()
   {
+    {
+      std::lock_guard<std::mutex> lock(g_threads_mutex);
+      g_execution_threads.insert(std::this_thread::get_id());
+    }
     rclcpp::Rate loop_rate(10);
 
 preempted:
@@ -293,6 +308,36 @@ TEST_F(ActionTest, test_simple_action)
   SUCCEED();
 }
 
+TEST_F(ActionTest, test_simple_action_thread_reuse)
+{
+  node_->activate_server();
+  {
+    std::lock_guard<std::mutex> lock(g_threads_mutex);
+    g_execution_threads.clear();
+  }
+
+  // Goals executed one after the other are executed by the same worker thread
+  for (int i = 0; i < 3; ++i) {
+    auto goal = Fibonacci::Goal();
+    goal.order = 2;
+
+    auto future_goal_handle = node_->action_client_->async_send_goal(goal);
+    EXPECT_EQ(
+      rclcpp::spin_until_future_complete(
+        node_,
+        future_goal_handle), rclcpp::FutureReturnCode::SUCCESS);
+
+    auto future_result = node_->action_client_->async_get_result(future_goal_handle.get());
+    EXPECT_EQ(
+      rclcpp::spin_until_future_complete(node_, future_result),
+      rclcpp::FutureReturnCode::SUCCESS);
+    EXPECT_EQ(future_result.get().code, rclcpp_action::ResultCode::SUCCEEDED);
+  }
+
+  std::lock_guard<std::mutex> lock(g_threads_mutex);
+  EXPECT_EQ(g_execution_threads.size(), 1u);
+}
+
 TEST_F(ActionTest, test_simple_action_with_feedback)
 {
   int feedback_sum = 0;
@@ -449,6 +494,7 @@ TEST_F(ActionTest, test_simple_action_preemption)
   }
 
   EXPECT_EQ(sum, 1);
+  EXPECT_GE(g_requests.load(), 1);
   SUCCEED();
 }
 
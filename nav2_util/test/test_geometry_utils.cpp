@@ -21,6 +21,7 @@
 
 using nav2_util::geometry_utils::euclidean_distance;
 using nav2_util::geometry_utils::calculate_path_length;
+using nav2_util::geometry_utils::projectTwist;
 
 TEST(GeometryUtils, euclidean_distance_point_3d)
 {
@@ -128,3 +129,33 @@ TEST(GeometryUtils, calculate_path_length)
     calculate_path_length(circle_path),
     2 * pi * polar_distance, 1e-1);
 }
+
+TEST(GeometryUtils, project_twist)
+{
+  geometry_msgs::msg::Pose2D pose;
+  pose.x = 1.0;
+  pose.y = 2.0;
+  pose.theta = M_PI_2;
+
+  // Straight motion, forward and sideways in the frame of the pose
+  auto projected = projectTwist(pose, 1.0, 0.5, 0.0, 2.0);
+  EXPECT_NEAR(projected.x, 0.0, 1e-9);
+  EXPECT_NEAR(projected.y, 4.0, 1e-9);
+  EXPECT_NEAR(projected.theta, M_PI_2, 1e-9);
+
+  // Half a turn on a circle of radius 1 ends 2 m to the left
+  projected = projectTwist(pose, 1.0, 0.0, 1.0, M_PI);
+  EXPECT_NEAR(projected.x, -1.0, 1e-9);
+  EXPECT_NEAR(projected.y, 2.0, 1e-9);
+  EXPECT_NEAR(projected.theta, 1.5 * M_PI, 1e-9);
+
+  // Projecting at once matches projecting in many small steps
+  geometry_msgs::msg::Pose2D stepped = pose;
+  for (int i = 0; i < 1000; ++i) {
+    stepped = projectTwist(stepped, 0.8, -0.3, -0.7, 0.002);
+  }
+  projected = projectTwist(pose, 0.8, -0.3, -0.7, 2.0);
+  EXPECT_NEAR(projected.x, stepped.x, 1e-9);
+  EXPECT_NEAR(projected.y, stepped.y, 1e-9);
+  EXPECT_NEAR(projected.theta, stepped.theta, 1e-9);
+}
@@ -0,0 +1,63 @@
+// Copyright (c) 2024 Open Navigation LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "nav2_util/line_iterator.hpp"
+
+using nav2_util::LineIterator;
+
+TEST(LineIterator, RasterizeLineMatchesIterator)
+{
+  const std::vector<std::vector<int>> lines = {
+    {0, 0, 0, 0}, {0, 0, 10, 0}, {0, 0, 0, -7}, {3, 4, 17, 9}, {3, 4, -5, 21},
+    {-8, 2, 6, -3}, {5, 5, -5, -5}, {0, 0, 1, 100}, {12, -3, 11, 40}};
+
+  for (const auto & l : lines) {
+    const unsigned int length = nav2_util::getLineLength(l[0], l[1], l[2], l[3]);
+    std::vector<int> xs(length), ys(length);
+    EXPECT_EQ(nav2_util::rasterizeLine(l[0], l[1], l[2], l[3], xs.data(), ys.data()), length);
+
+    unsigned int i = 0;
+    for (LineIterator line(l[0], l[1], l[2], l[3]); line.isValid(); line.advance(), ++i) {
+      ASSERT_LT(i, length);
+      EXPECT_EQ(xs[i], line.getX());
+      EXPECT_EQ(ys[i], line.getY());
+    }
+    EXPECT_EQ(i, length);
+  }
+}
+
+TEST(LineIterator, RasterizeRays)
+{
+  const unsigned int size_x = 50;
+  const std::vector<int> x1s = {40, 20, 20, 2};
+  const std::vector<int> y1s = {20, 45, 20, 3};
+  std::vector<unsigned int> indices;
+  std::vector<size_t> offsets;
+  nav2_util::rasterizeRays(20, 20, x1s, y1s, size_x, indices, offsets);
+
+  ASSERT_EQ(offsets.size(), x1s.size() + 1);
+  EXPECT_EQ(offsets.back(), indices.size());
+  for (size_t r = 0; r < x1s.size(); ++r) {
+    size_t i = offsets[r];
+    for (LineIterator line(20, 20, x1s[r], y1s[r]); line.isValid(); line.advance(), ++i) {
+      ASSERT_LT(i, offsets[r + 1]);
+      EXPECT_EQ(indices[i], static_cast<unsigned int>(line.getY() * size_x + line.getX()));
+    }
+    EXPECT_EQ(i, offsets[r + 1]);
+  }
+}
@@ -19,6 +19,7 @@
 #include "nav2_util/odometry_utils.hpp"
 #include "nav_msgs/msg/odometry.hpp"
 #include "geometry_msgs/msg/twist.hpp"
+#include "tf2/utils.h"
 #include "gtest/gtest.h"
 
 using namespace std::chrono;  // NOLINT
@@ -113,3 +114,52 @@ TEST(OdometryUtils, test_smoothed_velocity)
   EXPECT_EQ(twist_msg.linear.y, 5.0);
   EXPECT_EQ(twist_msg.angular.z, 5.0);
 }
+
+TEST(OdometryUtils, test_predicted_state)
+{
+  auto node = std::make_shared<rclcpp::Node>("test_node");
+  auto odom_pub = node->create_publisher<nav_msgs::msg::Odometry>("odom", 10);
+
+  nav2_util::OdomSmoother odom_smoother(node, 0.3, "odom");
+  geometry_msgs::msg::PoseStamped pose;
+  geometry_msgs::msg::TwistStamped twist;
+  auto time = node->now();
+  EXPECT_FALSE(odom_smoother.predict(time, pose, twist));
+
+  // Accelerating along x by 1 m/s^2, from 1 m/s
+  nav_msgs::msg::Odometry odom_msg;
+  odom_msg.header.frame_id = "odom";
+  odom_msg.pose.pose.orientation.w = 1.0;
+  for (int i = 0; i <= 2; i++) {
+    odom_msg.header.stamp = time + rclcpp::Duration::from_seconds(0.1 * i);
+    odom_msg.twist.twist.linear.x = 1.0 + 0.1 * i;
+    odom_msg.pose.pose.position.x = 2.0 + 0.1 * i;
+    odom_pub->publish(odom_msg);
+    std::this_thread::sleep_for(20ms);
+    rclcpp::spin_some(node);
+  }
+
+  // Half a second after the last odometry
+  auto future = time + rclcpp::Duration::from_seconds(0.7);
+  ASSERT_TRUE(odom_smoother.predict(future, pose, twist));
+  EXPECT_NEAR(twist.twist.linear.x, 1.7, 1e-6);
+  EXPECT_NEAR(twist.twist.angular.z, 0.0, 1e-6);
+  EXPECT_EQ(rclcpp::Time(twist.header.stamp), future);
+  // Integrated with the twist of the middle of the interval, 1.45 m/s
+  EXPECT_NEAR(pose.pose.position.x, 2.2 + 0.5 * 1.45, 1e-6);
+  EXPECT_NEAR(pose.pose.position.y, 0.0, 1e-6);
+  EXPECT_EQ(pose.header.frame_id, "odom");
+
+  // Turning on the spot
+  odom_msg.header.stamp = time + rclcpp::Duration::from_seconds(1.0);
+  odom_msg.twist.twist.linear.x = 0.0;
+  odom_msg.twist.twist.angular.z = 1.0;
+  odom_pub->publish(odom_msg);
+  std::this_thread::sleep_for(20ms);
+  rclcpp::spin_some(node);
+
+  ASSERT_TRUE(odom_smoother.predict(time + rclcpp::Duration::from_seconds(1.5), pose, twist));
+  EXPECT_NEAR(twist.twist.angular.z, 1.0, 1e-6);
+  EXPECT_NEAR(pose.pose.position.x, 2.2, 1e-6);
+  EXPECT_NEAR(tf2::getYaw(pose.pose.orientation), 0.5, 1e-6);
+}
@@ -0,0 +1,81 @@
+// Copyright (c) 2024 Open Navigation LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "nav2_util/path_progress.hpp"
+#include "nav2_util/geometry_utils.hpp"
+#include "nav_msgs/msg/path.hpp"
+#include "gtest/gtest.h"
+
+using nav2_util::geometry_utils::calculate_path_length;
+
+nav_msgs::msg::Path makePath(int size, int sec = 0)
+{
+  // Straight along x then back along y = 1, passing near the start again
+  nav_msgs::msg::Path path;
+  path.header.stamp.sec = sec;
+  for (int i = 0; i < size; ++i) {
+    geometry_msgs::msg::PoseStamped pose;
+    pose.pose.position.x = i < size / 2 ? 0.1 * i : 0.1 * (size - 1 - i);
+    pose.pose.position.y = i < size / 2 ? 0.0 : 1.0;
+    path.poses.push_back(pose);
+  }
+  return path;
+}
+
+geometry_msgs::msg::PoseStamped makePose(double x, double y)
+{
+  geometry_msgs::msg::PoseStamped pose;
+  pose.pose.position.x = x;
+  pose.pose.position.y = y;
+  return pose;
+}
+
+TEST(PathProgress, distance_remaining)
+{
+  auto path = makePath(200);
+  nav2_util::PathProgress progress(1.0);
+  EXPECT_TRUE(progress.empty());
+  EXPECT_FALSE(progress.isSamePath(path));
+
+  progress.updatePath(path);
+  EXPECT_TRUE(progress.isSamePath(path));
+  EXPECT_EQ(progress.update(makePose(0.0, 0.0)), 0u);
+  EXPECT_NEAR(progress.distanceRemaining(), calculate_path_length(path), 1e-9);
+
+  for (size_t idx = 1; idx < 100; ++idx) {
+    EXPECT_EQ(progress.update(path.poses[idx]), idx);
+    EXPECT_NEAR(progress.distanceRemaining(), calculate_path_length(path, idx), 1e-9);
+  }
+
+  // Equally close poses keep the one reached first, then the way back is followed
+  EXPECT_EQ(progress.update(makePose(9.9, 0.5)), 99u);
+  EXPECT_EQ(progress.update(path.poses[100]), 100u);
+}
+
+TEST(PathProgress, new_path)
+{
+  auto path = makePath(200);
+  nav2_util::PathProgress progress;
+  progress.updatePath(path);
+  progress.update(path.poses[50]);
+
+  // The same path keeps its progress, a new one is searched fully
+  progress.updatePath(path);
+  EXPECT_EQ(progress.update(path.poses[50]), 50u);
+  auto replanned = makePath(200, 1);
+  EXPECT_FALSE(progress.isSamePath(replanned));
+  progress.updatePath(replanned);
+  EXPECT_EQ(progress.update(replanned.poses[150]), 150u);
+  EXPECT_NEAR(progress.distanceRemaining(), calculate_path_length(replanned, 150), 1e-9);
+}
@@ -16,6 +16,7 @@
 #include <cmath>
 #include "rclcpp/rclcpp.hpp"
 #include "nav2_util/robot_utils.hpp"
+#include "nav2_util/robot_pose_cache.hpp"
 #include "tf2_ros/transform_listener.h"
 #include "tf2_ros/transform_broadcaster.h"
 #include "geometry_msgs/msg/pose_stamped.hpp"
@@ -58,3 +59,39 @@ TEST(RobotUtils, validateTwist)
   msg.angular.z = NAN;
   EXPECT_FALSE(nav2_util::validateTwist(msg));
 }
+
+TEST(RobotUtils, RobotPoseCache)
+{
+  auto node = std::make_shared<rclcpp::Node>("pose_cache", rclcpp::NodeOptions());
+  tf2_ros::Buffer tf(node->get_clock());
+  nav2_util::RobotPoseCache cache("map", "base_link");
+  geometry_msgs::msg::PoseStamped pose;
+
+  // Failed lookups are not cached
+  ASSERT_FALSE(cache.getPose(tf, pose, 0.1, 10.0));
+
+  geometry_msgs::msg::TransformStamped transform;
+  transform.header.frame_id = "map";
+  transform.child_frame_id = "base_link";
+  transform.transform.translation.x = 1.0;
+  transform.transform.rotation.w = 1.0;
+  tf.setTransform(transform, "test", true);
+  ASSERT_TRUE(cache.getPose(tf, pose, 0.1, 10.0));
+  EXPECT_EQ(pose.header.frame_id, "map");
+  EXPECT_DOUBLE_EQ(pose.pose.position.x, 1.0);
+
+  // Read from the cache until it is older than its maximum age
+  transform.transform.translation.x = 2.0;
+  tf.setTransform(transform, "test", true);
+  ASSERT_TRUE(cache.getPose(tf, pose, 0.1, 10.0));
+  EXPECT_DOUBLE_EQ(pose.pose.position.x, 1.0);
+  ASSERT_TRUE(cache.getPose(tf, pose, 0.1, 0.0));
+  EXPECT_DOUBLE_EQ(pose.pose.position.x, 2.0);
+
+  EXPECT_EQ(
+    nav2_util::RobotPoseCache::get("map", "base_link"),
+    nav2_util::RobotPoseCache::get("map", "base_link"));
+  EXPECT_NE(
+    nav2_util::RobotPoseCache::get("map", "base_link"),
+    nav2_util::RobotPoseCache::get("odom", "base_link"));
+}
@@ -0,0 +1,62 @@
+// Copyright (c) 2024 Open Navigation LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <atomic>
+#include <stdexcept>
+#include <vector>
+
+#include "nav2_util/thread_pool.hpp"
+#include "gtest/gtest.h"
+
+using nav2_util::ThreadPool;
+
+TEST(ThreadPool, EnqueueReturnsResult)
+{
+  ThreadPool pool(2);
+  EXPECT_EQ(pool.size(), 2u);
+  auto result = pool.enqueue([]() {return 21 * 2;});
+  EXPECT_EQ(result.get(), 42);
+}
+
+TEST(ThreadPool, ParallelForVisitsEveryIndexOnce)
+{
+  ThreadPool pool(3);
+  std::vector<std::atomic<int>> visits(1000);
+  pool.parallelFor(
+    0, visits.size(), [&](size_t i) {
+      visits[i]++;
+    });
+  for (auto & visit : visits) {
+    EXPECT_EQ(visit.load(), 1);
+  }
+
+  // Empty ranges are a no-op
+  pool.parallelFor(5, 5, [](size_t) {FAIL();});
+}
+
+TEST(ThreadPool, ParallelForRethrows)
+{
+  ThreadPool pool(2);
+  EXPECT_THROW(
+    pool.parallelFor(
+      0, 100, [](size_t i) {
+        if (i == 50) {
+          throw std::runtime_error("failure");
+        }
+      }),
+    std::runtime_error);
+
+  // Pool remains usable after a failure
+  EXPECT_EQ(pool.enqueue([]() {return 1;}).get(), 1);
+}
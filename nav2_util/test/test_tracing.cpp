@@ -0,0 +1,53 @@
+// Copyright (c) 2024 Open Navigation LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <sstream>
+#include <string>
+
+#include "gtest/gtest.h"
+#include "nav2_util/tracing.hpp"
+
+using nav2_util::Tracer;
+using nav2_util::TraceScope;
+
+TEST(Tracer, RecordsScopesInRingBuffer)
+{
+  Tracer & tracer = Tracer::instance();
+  tracer.start(3);
+  for (uint64_t i = 1; i <= 5; ++i) {
+    TraceScope scope("test.scope", i);
+  }
+  tracer.stop();
+
+  // Scopes after the session are not recorded
+  {
+    TraceScope scope("test.stopped");
+  }
+
+  // Only the last spans are kept, from the oldest one
+  const auto spans = tracer.getSpans();
+  ASSERT_EQ(spans.size(), 3u);
+  for (size_t i = 0; i < spans.size(); ++i) {
+    EXPECT_STREQ(spans[i].name, "test.scope");
+    EXPECT_EQ(spans[i].id, i + 3);
+    EXPECT_LE(spans[i].start_ns, spans[i].end_ns);
+  }
+
+  std::stringstream stream;
+  tracer.write(stream);
+  const std::string trace = stream.str();
+  EXPECT_NE(trace.find("\"traceEvents\""), std::string::npos);
+  EXPECT_NE(trace.find("\"name\":\"test.scope\""), std::string::npos);
+  EXPECT_EQ(trace.find("test.stopped"), std::string::npos);
+}
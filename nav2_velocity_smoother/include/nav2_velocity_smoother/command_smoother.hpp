@@ -0,0 +1,170 @@
+// Copyright (c) 2022 Samsung Research
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef NAV2_VELOCITY_SMOOTHER__COMMAND_SMOOTHER_HPP_
+#define NAV2_VELOCITY_SMOOTHER__COMMAND_SMOOTHER_HPP_
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "nav2_util/lifecycle_node.hpp"
+#include "nav2_util/odometry_utils.hpp"
+#include "geometry_msgs/msg/twist_stamped.hpp"
+
+namespace nav2_velocity_smoother
+{
+
+/**
+ * @class nav2_velocity_smoother::CommandSmoother
+ * @brief Applies the velocity, acceleration and deadband limits to the velocity commands
+ * received, apart from the node receiving and publishing them. It is used by the
+ * VelocitySmoother node, and by nodes fusing velocity smoothing with further stages.
+ */
+class CommandSmoother
+{
+public:
+  /**
+   * @brief A constructor for nav2_velocity_smoother::CommandSmoother
+   */
+  CommandSmoother();
+
+  /**
+   * @brief Declares and gets the smoothing parameters, and subscribes to odometry
+   * in closed loop
+   * @param node Node to get the parameters of and subscribe from
+   * @param prefix Prefix of the parameter names, e.g. "velocity_smoother."
+   * @throw std::runtime_error When the parameters are invalid
+   */
+  void configure(
+    const nav2_util::LifecycleNode::SharedPtr & node, const std::string & prefix = "");
+
+  /**
+   * @brief Unsubscribes from odometry and forgets the last command
+   */
+  void cleanup();
+
+  /**
+   * @brief Sets the command to smooth
+   * @param command Velocity command received
+   * @param now Current time, used when the command is not stamped
+   */
+  void setCommand(geometry_msgs::msg::TwistStamped::UniquePtr command, const rclcpp::Time & now);
+
+  /**
+   * @brief Applies the limits to the last command, for the velocity changes of a period
+   * @param now Current time, to check the command timeout
+   * @param update_frequency Frequency of the updates the velocity changes are bounded for
+   * @param cmd_vel Output smoothed command
+   * @return Whether there is a command to publish
+   */
+  bool smooth(
+    const rclcpp::Time & now, const double update_frequency,
+    geometry_msgs::msg::TwistStamped & cmd_vel);
+
+  /**
+   * @brief Sets a smoothing parameter changed at runtime
+   * @param parameter Parameter changed
+   * @return False if the value of the parameter was rejected
+   */
+  bool setParameter(const rclcpp::Parameter & parameter);
+
+  /**
+   * @brief Find the scale factor, eta, which scales axis into acceleration range
+   * @param v_curr current velocity
+   * @param v_cmd commanded velocity
+   * @param accel maximum acceleration
+   * @param decel maximum deceleration
+   * @return Scale factor, eta
+   */
+  double findEtaConstraint(
+    const double v_curr, const double v_cmd,
+    const double accel, const double decel) const;
+
+  /**
+   * @brief Apply acceleration and scale factor constraints
+   * @param v_curr current velocity
+   * @param v_cmd commanded velocity
+   * @param accel maximum acceleration
+   * @param decel maximum deceleration
+   * @param eta Scale factor
+   * @return Velocity command
+   */
+  double applyConstraints(
+    const double v_curr, const double v_cmd,
+    const double accel, const double decel, const double eta) const;
+
+  /**
+   * @brief Gets the frequency of the velocity changes of a command smoothed as it is
+   * received, rather than on a timer
+   * @param elapsed Time elapsed since the last command smoothed
+   * @return Frequency, no lower than the smoothing frequency
+   */
+  double getEventFrequency(const rclcpp::Duration & elapsed) const;
+
+  /**
+   * @brief Gets the smoothing frequency
+   */
+  double getSmoothingFrequency() const {return smoothing_frequency_;}
+
+  /**
+   * @brief Gets the last command received, nullptr if none was
+   */
+  geometry_msgs::msg::TwistStamped::SharedPtr getCommand() const {return command_;}
+
+  /**
+   * @brief Gets the time of the last command received, zero if none was
+   */
+  const rclcpp::Time & getCommandTime() const {return last_command_time_;}
+
+  /**
+   * @brief Whether the current velocity is taken from odometry
+   */
+  bool isClosedLoop() const {return odom_smoother_ != nullptr;}
+
+protected:
+  /**
+   * @brief Subscribes to odometry with the current topic and duration
+   */
+  void createOdomSmoother();
+
+  nav2_util::LifecycleNode::WeakPtr node_;
+  std::string prefix_;
+  rclcpp::Logger logger_{rclcpp::get_logger("velocity_smoother")};
+
+  std::unique_ptr<nav2_util::OdomSmoother> odom_smoother_;
+  geometry_msgs::msg::TwistStamped last_cmd_;
+  geometry_msgs::msg::TwistStamped::SharedPtr command_;
+  rclcpp::Time last_command_time_;
+  bool stopped_{true};
+
+  // Parameters
+  double smoothing_frequency_;
+  // Frequency the velocity changes of the current command are bounded for
+  double update_frequency_;
+  double odom_duration_;
+  std::string odom_topic_;
+  bool open_loop_;
+  bool scale_velocities_;
+  std::vector<double> max_velocities_;
+  std::vector<double> min_velocities_;
+  std::vector<double> max_accels_;
+  std::vector<double> max_decels_;
+  std::vector<double> deadband_velocities_;
+  rclcpp::Duration velocity_timeout_{0, 0};
+};
+
+}  // namespace nav2_velocity_smoother
+
+#endif  // NAV2_VELOCITY_SMOOTHER__COMMAND_SMOOTHER_HPP_
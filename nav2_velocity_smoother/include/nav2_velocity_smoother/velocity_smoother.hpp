@@ -24,12 +24,12 @@
 
 #include "nav2_util/lifecycle_node.hpp"
 #include "nav2_util/node_utils.hpp"
-#include "nav2_util/odometry_utils.hpp"
 #include "nav2_util/robot_utils.hpp"
 #include "nav2_util/twist_publisher.hpp"
 #include "nav2_util/twist_subscriber.hpp"
 #include "geometry_msgs/msg/twist.hpp"
 #include "geometry_msgs/msg/twist_stamped.hpp"
+#include "nav2_velocity_smoother/command_smoother.hpp"
 
 namespace nav2_velocity_smoother
 {
@@ -118,13 +118,19 @@ protected:
    * @param msg Twist message
    */
   void inputCommandCallback(const geometry_msgs::msg::Twist::SharedPtr msg);
-  void inputCommandStampedCallback(const geometry_msgs::msg::TwistStamped::SharedPtr msg);
+  void inputCommandStampedCallback(geometry_msgs::msg::TwistStamped::UniquePtr msg);
 
   /**
-   * @brief Main worker timer function
+   * @brief Main worker timer function. In event-driven mode, it only smooths
+   * the command when none was smoothed for a period, as a watchdog
    */
   void smootherTimer();
 
+  /**
+   * @brief Apply the constraints to the last command received and publish it
+   */
+  void smoothCommand();
+
   /**
    * @brief Dynamic reconfigure callback
    * @param parameters Parameter list to change
@@ -132,30 +138,22 @@ protected:
   rcl_interfaces::msg::SetParametersResult dynamicParametersCallback(
     std::vector<rclcpp::Parameter> parameters);
 
+  /**
+   * @brief Creates the smoothing timer at the smoothing frequency
+   */
+  void createTimer();
+
   // Network interfaces
-  std::unique_ptr<nav2_util::OdomSmoother> odom_smoother_;
   std::unique_ptr<nav2_util::TwistPublisher> smoothed_cmd_pub_;
   std::unique_ptr<nav2_util::TwistSubscriber> cmd_sub_;
   rclcpp::TimerBase::SharedPtr timer_;
 
-  rclcpp::Clock::SharedPtr clock_;
-  geometry_msgs::msg::TwistStamped last_cmd_;
-  geometry_msgs::msg::TwistStamped::SharedPtr command_;
+  // Limits applied to the commands, with their odometry in closed loop
+  CommandSmoother smoother_;
 
   // Parameters
-  double smoothing_frequency_;
-  double odom_duration_;
-  std::string odom_topic_;
-  bool open_loop_;
-  bool stopped_{true};
-  bool scale_velocities_;
-  std::vector<double> max_velocities_;
-  std::vector<double> min_velocities_;
-  std::vector<double> max_accels_;
-  std::vector<double> max_decels_;
-  std::vector<double> deadband_velocities_;
-  rclcpp::Duration velocity_timeout_{0, 0};
-  rclcpp::Time last_command_time_;
+  bool event_driven_;
+  rclcpp::Time last_smoothing_time_;
 
   rclcpp::node_interfaces::OnSetParametersCallbackHandle::SharedPtr dyn_params_handler_;
 };
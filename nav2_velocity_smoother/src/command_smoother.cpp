@@ -0,0 +1,408 @@
+// Copyright (c) 2022 Samsung Research
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <algorithm>
+#include <cmath>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "nav2_velocity_smoother/command_smoother.hpp"
+#include "nav2_util/node_utils.hpp"
+
+using nav2_util::declare_parameter_if_not_declared;
+using rcl_interfaces::msg::ParameterType;
+
+namespace nav2_velocity_smoother
+{
+
+// Shortest period the velocity changes are bounded for when smoothing commands as received
+static constexpr double MIN_EVENT_PERIOD = 0.001;
+
+CommandSmoother::CommandSmoother()
+: smoothing_frequency_(20.0), update_frequency_(20.0)
+{
+}
+
+void CommandSmoother::configure(
+  const nav2_util::LifecycleNode::SharedPtr & node, const std::string & prefix)
+{
+  node_ = node;
+  prefix_ = prefix;
+  logger_ = node->get_logger();
+  last_command_time_ = rclcpp::Time(0, 0, node->get_clock()->get_clock_type());
+  std::string feedback_type;
+  double velocity_timeout_dbl;
+
+  // Smoothing metadata
+  declare_parameter_if_not_declared(
+    node, prefix + "smoothing_frequency", rclcpp::ParameterValue(20.0));
+  declare_parameter_if_not_declared(
+    node, prefix + "feedback", rclcpp::ParameterValue(std::string("OPEN_LOOP")));
+  declare_parameter_if_not_declared(
+    node, prefix + "scale_velocities", rclcpp::ParameterValue(false));
+  node->get_parameter(prefix + "smoothing_frequency", smoothing_frequency_);
+  node->get_parameter(prefix + "feedback", feedback_type);
+  node->get_parameter(prefix + "scale_velocities", scale_velocities_);
+  update_frequency_ = smoothing_frequency_;
+
+  // Kinematics
+  declare_parameter_if_not_declared(
+    node, prefix + "max_velocity", rclcpp::ParameterValue(std::vector<double>{0.50, 0.0, 2.5}));
+  declare_parameter_if_not_declared(
+    node, prefix + "min_velocity",
+    rclcpp::ParameterValue(std::vector<double>{-0.50, 0.0, -2.5}));
+  declare_parameter_if_not_declared(
+    node, prefix + "max_accel", rclcpp::ParameterValue(std::vector<double>{2.5, 0.0, 3.2}));
+  declare_parameter_if_not_declared(
+    node, prefix + "max_decel", rclcpp::ParameterValue(std::vector<double>{-2.5, 0.0, -3.2}));
+  node->get_parameter(prefix + "max_velocity", max_velocities_);
+  node->get_parameter(prefix + "min_velocity", min_velocities_);
+  node->get_parameter(prefix + "max_accel", max_accels_);
+  node->get_parameter(prefix + "max_decel", max_decels_);
+
+  for (unsigned int i = 0; i != 3; i++) {
+    if (max_decels_[i] > 0.0) {
+      throw std::runtime_error(
+              "Positive values set of deceleration! These should be negative to slow down!");
+    }
+    if (max_accels_[i] < 0.0) {
+      throw std::runtime_error(
+              "Negative values set of acceleration! These should be positive to speed up!");
+    }
+    if (min_velocities_[i] > 0.0) {
+      throw std::runtime_error(
+              "Positive values set of min_velocities! These should be negative!");
+    }
+    if (max_velocities_[i] < 0.0) {
+      throw std::runtime_error(
+              "Negative values set of max_velocities! These should be positive!");
+    }
+    if (min_velocities_[i] > max_velocities_[i]) {
+      throw std::runtime_error(
+              "Min velocities are higher than max velocities!");
+    }
+  }
+
+  // Get feature parameters
+  declare_parameter_if_not_declared(node, prefix + "odom_topic", rclcpp::ParameterValue("odom"));
+  declare_parameter_if_not_declared(node, prefix + "odom_duration", rclcpp::ParameterValue(0.1));
+  declare_parameter_if_not_declared(
+    node, prefix + "deadband_velocity",
+    rclcpp::ParameterValue(std::vector<double>{0.0, 0.0, 0.0}));
+  declare_parameter_if_not_declared(
+    node, prefix + "velocity_timeout", rclcpp::ParameterValue(1.0));
+  node->get_parameter(prefix + "odom_topic", odom_topic_);
+  node->get_parameter(prefix + "odom_duration", odom_duration_);
+  node->get_parameter(prefix + "deadband_velocity", deadband_velocities_);
+  node->get_parameter(prefix + "velocity_timeout", velocity_timeout_dbl);
+  velocity_timeout_ = rclcpp::Duration::from_seconds(velocity_timeout_dbl);
+
+  if (max_velocities_.size() != 3 || min_velocities_.size() != 3 ||
+    max_accels_.size() != 3 || max_decels_.size() != 3 || deadband_velocities_.size() != 3)
+  {
+    throw std::runtime_error(
+            "Invalid setting of kinematic and/or deadband limits!"
+            " All limits must be size of 3 representing (x, y, theta).");
+  }
+
+  // Get control type
+  if (feedback_type == "OPEN_LOOP") {
+    open_loop_ = true;
+  } else if (feedback_type == "CLOSED_LOOP") {
+    open_loop_ = false;
+    createOdomSmoother();
+  } else {
+    throw std::runtime_error("Invalid feedback_type, options are OPEN_LOOP and CLOSED_LOOP.");
+  }
+}
+
+void CommandSmoother::cleanup()
+{
+  odom_smoother_.reset();
+  command_.reset();
+  last_cmd_ = geometry_msgs::msg::TwistStamped();
+  stopped_ = true;
+}
+
+void CommandSmoother::createOdomSmoother()
+{
+  auto node = node_.lock();
+  if (!node) {
+    throw std::runtime_error{"Failed to lock node"};
+  }
+  odom_smoother_ = std::make_unique<nav2_util::OdomSmoother>(node, odom_duration_, odom_topic_);
+}
+
+void CommandSmoother::setCommand(
+  geometry_msgs::msg::TwistStamped::UniquePtr command, const rclcpp::Time & now)
+{
+  if (command->header.stamp.sec == 0 && command->header.stamp.nanosec == 0) {
+    last_command_time_ = now;
+  } else {
+    last_command_time_ = command->header.stamp;
+  }
+  command_ = std::move(command);
+}
+
+double CommandSmoother::getEventFrequency(const rclcpp::Duration & elapsed) const
+{
+  return 1.0 / std::clamp(elapsed.seconds(), MIN_EVENT_PERIOD, 1.0 / smoothing_frequency_);
+}
+
+double CommandSmoother::findEtaConstraint(
+  const double v_curr, const double v_cmd, const double accel, const double decel) const
+{
+  // Exploiting vector scaling properties
+  double dv = v_cmd - v_curr;
+
+  double v_component_max;
+  double v_component_min;
+
+  // Accelerating if magnitude of v_cmd is above magnitude of v_curr
+  // and if v_cmd and v_curr have the same sign (i.e. speed is NOT passing through 0.0)
+  // Decelerating otherwise
+  if (abs(v_cmd) >= abs(v_curr) && v_curr * v_cmd >= 0.0) {
+    v_component_max = accel / update_frequency_;
+    v_component_min = -accel / update_frequency_;
+  } else {
+    v_component_max = -decel / update_frequency_;
+    v_component_min = decel / update_frequency_;
+  }
+
+  if (dv > v_component_max) {
+    return v_component_max / dv;
+  }
+
+  if (dv < v_component_min) {
+    return v_component_min / dv;
+  }
+
+  return -1.0;
+}
+
+double CommandSmoother::applyConstraints(
+  const double v_curr, const double v_cmd,
+  const double accel, const double decel, const double eta) const
+{
+  double dv = v_cmd - v_curr;
+
+  double v_component_max;
+  double v_component_min;
+
+  // Accelerating if magnitude of v_cmd is above magnitude of v_curr
+  // and if v_cmd and v_curr have the same sign (i.e. speed is NOT passing through 0.0)
+  // Decelerating otherwise
+  if (abs(v_cmd) >= abs(v_curr) && v_curr * v_cmd >= 0.0) {
+    v_component_max = accel / update_frequency_;
+    v_component_min = -accel / update_frequency_;
+  } else {
+    v_component_max = -decel / update_frequency_;
+    v_component_min = decel / update_frequency_;
+  }
+
+  return v_curr + std::clamp(eta * dv, v_component_min, v_component_max);
+}
+
+bool CommandSmoother::smooth(
+  const rclcpp::Time & now, const double update_frequency,
+  geometry_msgs::msg::TwistStamped & cmd_vel)
+{
+  // Wait until the first command is received
+  if (!command_) {
+    return false;
+  }
+
+  update_frequency_ = update_frequency;
+  cmd_vel = geometry_msgs::msg::TwistStamped();
+  cmd_vel.header = command_->header;
+
+  // Check for velocity timeout. If nothing received, publish zeros to apply deceleration
+  if (now - last_command_time_ > velocity_timeout_) {
+    if (last_cmd_ == geometry_msgs::msg::TwistStamped() || stopped_) {
+      stopped_ = true;
+      return false;
+    }
+    *command_ = geometry_msgs::msg::TwistStamped();
+  }
+
+  stopped_ = false;
+
+  // Get current velocity based on feedback type
+  geometry_msgs::msg::TwistStamped current_;
+  if (open_loop_) {
+    current_ = last_cmd_;
+  } else {
+    current_ = odom_smoother_->getTwistStamped();
+  }
+
+  // Apply absolute velocity restrictions to the command
+  command_->twist.linear.x = std::clamp(
+    command_->twist.linear.x, min_velocities_[0],
+    max_velocities_[0]);
+  command_->twist.linear.y = std::clamp(
+    command_->twist.linear.y, min_velocities_[1],
+    max_velocities_[1]);
+  command_->twist.angular.z = std::clamp(
+    command_->twist.angular.z, min_velocities_[2],
+    max_velocities_[2]);
+
+  // Find if any component is not within the acceleration constraints. If so, store the most
+  // significant scale factor to apply to the vector <dvx, dvy, dvw>, eta, to reduce all axes
+  // proportionally to follow the same direction, within change of velocity bounds.
+  // In case eta reduces another axis out of its own limit, apply accel constraint to guarantee
+  // output is within limits, even if it deviates from requested command slightly.
+  double eta = 1.0;
+  if (scale_velocities_) {
+    double curr_eta = -1.0;
+
+    curr_eta = findEtaConstraint(
+      current_.twist.linear.x, command_->twist.linear.x, max_accels_[0], max_decels_[0]);
+    if (curr_eta > 0.0 && std::fabs(1.0 - curr_eta) > std::fabs(1.0 - eta)) {
+      eta = curr_eta;
+    }
+
+    curr_eta = findEtaConstraint(
+      current_.twist.linear.y, command_->twist.linear.y, max_accels_[1], max_decels_[1]);
+    if (curr_eta > 0.0 && std::fabs(1.0 - curr_eta) > std::fabs(1.0 - eta)) {
+      eta = curr_eta;
+    }
+
+    curr_eta = findEtaConstraint(
+      current_.twist.angular.z, command_->twist.angular.z, max_accels_[2], max_decels_[2]);
+    if (curr_eta > 0.0 && std::fabs(1.0 - curr_eta) > std::fabs(1.0 - eta)) {
+      eta = curr_eta;
+    }
+  }
+
+  cmd_vel.twist.linear.x = applyConstraints(
+    current_.twist.linear.x, command_->twist.linear.x, max_accels_[0], max_decels_[0], eta);
+  cmd_vel.twist.linear.y = applyConstraints(
+    current_.twist.linear.y, command_->twist.linear.y, max_accels_[1], max_decels_[1], eta);
+  cmd_vel.twist.angular.z = applyConstraints(
+    current_.twist.angular.z, command_->twist.angular.z, max_accels_[2], max_decels_[2], eta);
+  last_cmd_ = cmd_vel;
+
+  // Apply deadband restrictions
+  cmd_vel.twist.linear.x =
+    fabs(cmd_vel.twist.linear.x) < deadband_velocities_[0] ? 0.0 : cmd_vel.twist.linear.x;
+  cmd_vel.twist.linear.y =
+    fabs(cmd_vel.twist.linear.y) < deadband_velocities_[1] ? 0.0 : cmd_vel.twist.linear.y;
+  cmd_vel.twist.angular.z =
+    fabs(cmd_vel.twist.angular.z) < deadband_velocities_[2] ? 0.0 : cmd_vel.twist.angular.z;
+
+  return true;
+}
+
+bool CommandSmoother::setParameter(const rclcpp::Parameter & parameter)
+{
+  const auto & type = parameter.get_type();
+  const std::string & name = parameter.get_name();
+
+  if (type == ParameterType::PARAMETER_DOUBLE) {
+    if (name == prefix_ + "smoothing_frequency") {
+      smoothing_frequency_ = parameter.as_double();
+      update_frequency_ = smoothing_frequency_;
+    } else if (name == prefix_ + "velocity_timeout") {
+      velocity_timeout_ = rclcpp::Duration::from_seconds(parameter.as_double());
+    } else if (name == prefix_ + "odom_duration") {
+      odom_duration_ = parameter.as_double();
+      createOdomSmoother();
+    }
+  } else if (type == ParameterType::PARAMETER_DOUBLE_ARRAY) {
+    if (name.compare(0, prefix_.size(), prefix_) != 0) {
+      return true;
+    }
+    if (parameter.as_double_array().size() != 3) {
+      RCLCPP_WARN(logger_, "Invalid size of parameter %s. Must be size 3", name.c_str());
+      return false;
+    }
+
+    bool valid = true;
+    if (name == prefix_ + "max_velocity") {
+      for (unsigned int i = 0; i != 3; i++) {
+        if (parameter.as_double_array()[i] < 0.0) {
+          RCLCPP_WARN(logger_, "Negative values set of max_velocity! These should be positive!");
+          valid = false;
+        }
+      }
+      if (valid) {
+        max_velocities_ = parameter.as_double_array();
+      }
+    } else if (name == prefix_ + "min_velocity") {
+      for (unsigned int i = 0; i != 3; i++) {
+        if (parameter.as_double_array()[i] > 0.0) {
+          RCLCPP_WARN(logger_, "Positive values set of min_velocity! These should be negative!");
+          valid = false;
+        }
+      }
+      if (valid) {
+        min_velocities_ = parameter.as_double_array();
+      }
+    } else if (name == prefix_ + "max_accel") {
+      for (unsigned int i = 0; i != 3; i++) {
+        if (parameter.as_double_array()[i] < 0.0) {
+          RCLCPP_WARN(
+            logger_,
+            "Negative values set of acceleration! These should be positive to speed up!");
+          valid = false;
+        }
+      }
+      if (valid) {
+        max_accels_ = parameter.as_double_array();
+      }
+    } else if (name == prefix_ + "max_decel") {
+      for (unsigned int i = 0; i != 3; i++) {
+        if (parameter.as_double_array()[i] > 0.0) {
+          RCLCPP_WARN(
+            logger_,
+            "Positive values set of deceleration! These should be negative to slow down!");
+          valid = false;
+        }
+      }
+      if (valid) {
+        max_decels_ = parameter.as_double_array();
+      }
+    } else if (name == prefix_ + "deadband_velocity") {
+      deadband_velocities_ = parameter.as_double_array();
+    }
+    return valid;
+  } else if (type == ParameterType::PARAMETER_STRING) {
+    if (name == prefix_ + "feedback") {
+      if (parameter.as_string() == "OPEN_LOOP") {
+        open_loop_ = true;
+        odom_smoother_.reset();
+      } else if (parameter.as_string() == "CLOSED_LOOP") {
+        open_loop_ = false;
+        createOdomSmoother();
+      } else {
+        RCLCPP_WARN(logger_, "Invalid feedback_type, options are OPEN_LOOP and CLOSED_LOOP.");
+        return false;
+      }
+    } else if (name == prefix_ + "odom_topic") {
+      odom_topic_ = parameter.as_string();
+      createOdomSmoother();
+    }
+  } else if (type == ParameterType::PARAMETER_BOOL) {
+    if (name == prefix_ + "scale_velocities") {
+      scale_velocities_ = parameter.as_bool();
+    }
+  }
+
+  return true;
+}
+
+}  // namespace nav2_velocity_smoother
@@ -46,9 +46,9 @@ public:
   void cleanup(const rclcpp_lifecycle::State & state) {this->on_cleanup(state);}
   void shutdown(const rclcpp_lifecycle::State & state) {this->on_shutdown(state);}
 
-  bool isOdomSmoother() {return odom_smoother_ ? true : false;}
-  bool hasCommandMsg() {return last_command_time_.nanoseconds() != 0;}
-  geometry_msgs::msg::TwistStamped::SharedPtr lastCommandMsg() {return command_;}
+  bool isOdomSmoother() {return smoother_.isClosedLoop();}
+  bool hasCommandMsg() {return smoother_.getCommandTime().nanoseconds() != 0;}
+  geometry_msgs::msg::TwistStamped::SharedPtr lastCommandMsg() {return smoother_.getCommand();}
 
   void sendCommandMsg(geometry_msgs::msg::Twist::SharedPtr msg) {inputCommandCallback(msg);}
 };
@@ -178,6 +178,54 @@ TEST(VelocitySmootherTest, approxClosedLoopTestTimer)
   }
 }
 
+TEST(VelocitySmootherTest, eventDrivenTest)
+{
+  auto smoother =
+    std::make_shared<VelSmootherShim>();
+  smoother->declare_parameter("event_driven", rclcpp::ParameterValue(true));
+  smoother->set_parameter(rclcpp::Parameter("event_driven", true));
+  rclcpp_lifecycle::State state;
+  smoother->configure(state);
+  smoother->activate(state);
+
+  std::vector<double> linear_vels;
+  auto subscription = nav2_util::TwistSubscriber(
+    smoother,
+    "cmd_vel_smoothed",
+    1,
+    [&](geometry_msgs::msg::Twist::SharedPtr msg) {
+      linear_vels.push_back(msg->linear.x);
+    }, [&](geometry_msgs::msg::TwistStamped::SharedPtr msg) {
+      linear_vels.push_back(msg->twist.linear.x);
+    });
+
+  // A command is published as soon as it is received, before the timer runs
+  auto cmd = std::make_shared<geometry_msgs::msg::Twist>();
+  cmd->linear.x = 0.5;
+  smoother->sendCommandMsg(cmd);
+  auto start = smoother->now();
+  while (linear_vels.empty() && smoother->now() - start < 0.02s) {
+    rclcpp::spin_some(smoother->get_node_base_interface());
+  }
+  ASSERT_FALSE(linear_vels.empty());
+  EXPECT_GT(linear_vels.front(), 0.0);
+
+  // The timer keeps on publishing while no commands are received, until the timeout
+  start = smoother->now();
+  while (smoother->now() - start < 1.5s) {
+    rclcpp::spin_some(smoother->get_node_base_interface());
+  }
+  EXPECT_GT(linear_vels.size(), 19u);
+  EXPECT_LT(linear_vels.size(), 30u);
+  EXPECT_EQ(linear_vels.back(), 0.0);
+
+  // Velocity changes are still bounded by the acceleration, default of 2.5 / 20 hz
+  for (unsigned int i = 1; i < linear_vels.size(); i++) {
+    EXPECT_LT(std::fabs(linear_vels[i] - linear_vels[i - 1]), 0.126);
+    EXPECT_TRUE(linear_vels[i] <= 0.5);
+  }
+}
+
 TEST(VelocitySmootherTest, testfindEtaConstraint)
 {
   auto smoother =
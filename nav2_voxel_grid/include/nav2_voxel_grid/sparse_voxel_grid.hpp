@@ -0,0 +1,191 @@
+// Copyright (c) 2024 Open Navigation LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef NAV2_VOXEL_GRID__SPARSE_VOXEL_GRID_HPP_
+#define NAV2_VOXEL_GRID__SPARSE_VOXEL_GRID_HPP_
+
+#include <stdint.h>
+#include <limits.h>
+#include <array>
+#include <memory>
+#include <unordered_map>
+
+#include "nav2_voxel_grid/voxel_grid.hpp"
+#include "rclcpp/rclcpp.hpp"
+
+namespace nav2_voxel_grid
+{
+
+/**
+ * @class SparseVoxelGrid
+ * @brief A voxel grid with the column encoding of VoxelGrid, storing its columns in
+ *        blocks of 16x16 columns hashed by their position. Only the blocks observed,
+ *        marked or cleared, are allocated, the others being unknown. Resetting the grid
+ *        drops all blocks, and moving the grid drops the blocks left outside of it
+ *        rather than moving the columns.
+ */
+class SparseVoxelGrid
+{
+public:
+  /**
+   * @brief  Constructor for a sparse voxel grid
+   * @param size_x The x size of the grid
+   * @param size_y The y size of the grid
+   * @param size_z The z size of the grid, only sizes <= 16 are supported
+   */
+  SparseVoxelGrid(unsigned int size_x, unsigned int size_y, unsigned int size_z);
+
+  /**
+   * @brief  Resizes the grid to the desired size, leaving it unknown
+   * @param size_x The x size of the grid
+   * @param size_y The y size of the grid
+   * @param size_z The z size of the grid, only sizes <= 16 are supported
+   */
+  void resize(unsigned int size_x, unsigned int size_y, unsigned int size_z);
+
+  /**
+   * @brief  Makes the whole grid unknown, dropping all blocks
+   */
+  void reset();
+
+  /**
+   * @brief  Moves the grid by a number of cells, the columns moving in the grid as the
+   *         columns of a VoxelGrid would, and those entering it being unknown
+   * @param cell_ox The x offset of the new origin of the grid in cells
+   * @param cell_oy The y offset of the new origin of the grid in cells
+   */
+  void updateOrigin(int cell_ox, int cell_oy);
+
+  /**
+   * @brief  Marks a voxel
+   * @return Whether the column of the voxel has more marked voxels than marked_threshold
+   */
+  inline bool markVoxelInMap(
+    unsigned int x, unsigned int y, unsigned int z,
+    unsigned int marked_threshold)
+  {
+    if (x >= size_x_ || y >= size_y_ || z >= size_z_) {
+      RCLCPP_DEBUG(logger_, "Error, voxel out of bounds.\n");
+      return false;
+    }
+
+    uint32_t * col = getColumn(x, y);
+    uint32_t full_mask = ((uint32_t)1 << z << 16) | (1 << z);
+    *col |= full_mask;  // clear unknown and mark cell
+
+    unsigned int marked_bits = *col >> 16;
+    return !VoxelGrid::bitsBelowThreshold(marked_bits, marked_threshold);
+  }
+
+  /**
+   * @brief  Clears the voxels along a line, as VoxelGrid::clearVoxelLineInMap does
+   */
+  void clearVoxelLineInMap(
+    double x0, double y0, double z0, double x1, double y1, double z1, unsigned char * map_2d,
+    unsigned int unknown_threshold, unsigned int mark_threshold,
+    unsigned char free_cost = 0, unsigned char unknown_cost = 255,
+    unsigned int max_length = UINT_MAX, unsigned int min_length = 0);
+
+  VoxelStatus getVoxel(unsigned int x, unsigned int y, unsigned int z) const;
+
+  VoxelStatus getVoxelColumn(
+    unsigned int x, unsigned int y,
+    unsigned int unknown_threshold = 0, unsigned int marked_threshold = 0) const;
+
+  /**
+   * @brief  Copies a window of columns, in the layout of VoxelGrid::getData()
+   * @param x0 The x of the first column of the window
+   * @param y0 The y of the first column of the window
+   * @param xn The x past the last column of the window
+   * @param yn The y past the last column of the window
+   * @param columns The (xn - x0) * (yn - y0) columns to fill, row by row
+   */
+  void copyColumns(
+    unsigned int x0, unsigned int y0, unsigned int xn, unsigned int yn,
+    uint32_t * columns) const;
+
+  unsigned int sizeX() const {return size_x_;}
+  unsigned int sizeY() const {return size_y_;}
+  unsigned int sizeZ() const {return size_z_;}
+
+  /**
+   * @brief  Gets the number of blocks allocated
+   * @return Number of blocks
+   */
+  size_t numBlocks() const {return blocks_.size();}
+
+  static constexpr uint32_t kUnknownColumn = ~((uint32_t)0) >> 16;
+  static constexpr int kBlockBits = 4;
+  static constexpr int kBlockSize = 1 << kBlockBits;
+
+protected:
+  typedef std::array<uint32_t, kBlockSize * kBlockSize> Block;
+
+  /**
+   * @brief  Gets the key of the block of a column of the grid, and the index of the
+   *         column in the block
+   */
+  inline uint64_t getBlockKey(unsigned int x, unsigned int y, unsigned int & index) const
+  {
+    const int gx = static_cast<int>(x) + origin_x_;
+    const int gy = static_cast<int>(y) + origin_y_;
+    // Arithmetic shifts floor the coordinates of the blocks at negative positions
+    const int bx = gx >> kBlockBits, by = gy >> kBlockBits;
+    index = ((gy - by * kBlockSize) << kBlockBits) + (gx - bx * kBlockSize);
+    return (static_cast<uint64_t>(static_cast<uint32_t>(bx)) << 32) |
+           static_cast<uint32_t>(by);
+  }
+
+  /**
+   * @brief  Gets a column of the grid for writing, allocating its block if needed
+   */
+  inline uint32_t * getColumn(unsigned int x, unsigned int y)
+  {
+    unsigned int index;
+    const uint64_t key = getBlockKey(x, y, index);
+    if (!last_block_ || key != last_key_) {
+      auto & block = blocks_[key];
+      if (!block) {
+        block = std::make_unique<Block>();
+        block->fill(kUnknownColumn);
+      }
+      last_key_ = key;
+      last_block_ = block.get();
+    }
+    return &(*last_block_)[index];
+  }
+
+  /**
+   * @brief  Gets the value of a column of the grid, unknown if its block is not allocated
+   */
+  inline uint32_t getColumnValue(unsigned int x, unsigned int y) const
+  {
+    unsigned int index;
+    const uint64_t key = getBlockKey(x, y, index);
+    auto it = blocks_.find(key);
+    return it == blocks_.end() ? kUnknownColumn : (*it->second)[index];
+  }
+
+  unsigned int size_x_, size_y_, size_z_;
+  // Position of the grid in cells, columns being bucketed in blocks by their position
+  int origin_x_{0}, origin_y_{0};
+  std::unordered_map<uint64_t, std::unique_ptr<Block>> blocks_;
+  uint64_t last_key_{0};
+  Block * last_block_{nullptr};
+  rclcpp::Logger logger_;
+};
+
+}  // namespace nav2_voxel_grid
+
+#endif  // NAV2_VOXEL_GRID__SPARSE_VOXEL_GRID_HPP_
@@ -152,26 +152,15 @@ public:
     }
   }
 
-  inline bool bitsBelowThreshold(unsigned int n, unsigned int bit_threshold)
+  static inline bool bitsBelowThreshold(unsigned int n, unsigned int bit_threshold)
   {
-    unsigned int bit_count;
-    for (bit_count = 0; n; ) {
-      ++bit_count;
-      if (bit_count > bit_threshold) {
-        return false;
-      }
-      n &= n - 1;  // clear the least significant bit set
-    }
-    return true;
+    return numBits(n) <= bit_threshold;
   }
 
   static inline unsigned int numBits(unsigned int n)
   {
-    unsigned int bit_count;
-    for (bit_count = 0; n; ++bit_count) {
-      n &= n - 1;  // clear the least significant bit set
-    }
-    return bit_count;
+    // a single instruction on targets with popcnt, called for every traced voxel
+    return static_cast<unsigned int>(__builtin_popcount(n));
   }
 
   static VoxelStatus getVoxel(
@@ -403,19 +392,6 @@ public:
     }
 
 private:
-    inline bool bitsBelowThreshold(unsigned int n, unsigned int bit_threshold)
-    {
-      unsigned int bit_count;
-      for (bit_count = 0; n; ) {
-        ++bit_count;
-        if (bit_count > bit_threshold) {
-          return false;
-        }
-        n &= n - 1;  // clear the least significant bit set
-      }
-      return true;
-    }
-
     uint32_t * data_;
     unsigned char * costmap_;
     unsigned int unknown_clear_threshold_, marked_clear_threshold_;
@@ -0,0 +1,297 @@
+// Copyright (c) 2024 Open Navigation LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "nav2_voxel_grid/sparse_voxel_grid.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+
+namespace nav2_voxel_grid
+{
+
+namespace
+{
+
+inline int sign(int i)
+{
+  return i > 0 ? 1 : -1;
+}
+
+/**
+ * @brief The 3D bresenham of VoxelGrid, stepping through the coordinates of the voxels
+ * rather than through offsets in a dense grid
+ */
+template<class ActionType, class StepA, class StepB, class StepC>
+inline void bresenham3D(
+  ActionType & at, StepA step_a, StepB step_b, StepC step_c,
+  unsigned int abs_da, unsigned int abs_db, unsigned int abs_dc,
+  int error_b, int error_c, unsigned int max_length)
+{
+  unsigned int end = std::min(max_length, abs_da);
+  for (unsigned int i = 0; i < end; ++i) {
+    at();
+    step_a();
+    error_b += abs_db;
+    error_c += abs_dc;
+    if ((unsigned int)error_b >= abs_da) {
+      step_b();
+      error_b -= abs_da;
+    }
+    if ((unsigned int)error_c >= abs_da) {
+      step_c();
+      error_c -= abs_da;
+    }
+  }
+  at();
+}
+
+/**
+ * @brief Raytrace a line as VoxelGrid::raytraceLine does, calling an action with the
+ * x and y of each column traversed and the z mask of the voxel
+ */
+template<class ActionType>
+void raytraceLine(
+  ActionType at, double x0, double y0, double z0,
+  double x1, double y1, double z1, unsigned int max_length, unsigned int min_length)
+{
+  double dist = sqrt((x0 - x1) * (x0 - x1) + (y0 - y1) * (y0 - y1) + (z0 - z1) * (z0 - z1));
+  if ((unsigned int)(dist) < min_length) {
+    return;
+  }
+  double scale, min_x0, min_y0, min_z0;
+  if (dist > 0.0) {
+    scale = std::min(1.0, max_length / dist);
+    min_x0 = x0 + (x1 - x0) / dist * min_length;
+    min_y0 = y0 + (y1 - y0) / dist * min_length;
+    min_z0 = z0 + (z1 - z0) / dist * min_length;
+  } else {
+    scale = 1.0;
+    min_x0 = x0;
+    min_y0 = y0;
+    min_z0 = z0;
+  }
+
+  int dx = int(x1) - int(min_x0);  // NOLINT
+  int dy = int(y1) - int(min_y0);  // NOLINT
+  int dz = int(z1) - int(min_z0);  // NOLINT
+
+  unsigned int abs_dx = abs(dx);
+  unsigned int abs_dy = abs(dy);
+  unsigned int abs_dz = abs(dz);
+
+  const int offset_dx = sign(dx);
+  const int offset_dy = sign(dy);
+  const int offset_dz = sign(dz);
+
+  unsigned int x = (unsigned int)min_x0;
+  unsigned int y = (unsigned int)min_y0;
+  uint32_t z_mask = ((1 << 16) | 1) << (unsigned int)min_z0;
+
+  auto action = [&]() {at(x, y, z_mask);};
+  auto step_x = [&]() {x += offset_dx;};
+  auto step_y = [&]() {y += offset_dy;};
+  auto step_z = [&]() {offset_dz > 0 ? z_mask <<= 1 : z_mask >>= 1;};
+
+  // is x dominant
+  if (abs_dx >= std::max(abs_dy, abs_dz)) {
+    bresenham3D(
+      action, step_x, step_y, step_z, abs_dx, abs_dy, abs_dz, abs_dx / 2, abs_dx / 2,
+      (unsigned int)(scale * abs_dx));
+    return;
+  }
+
+  // y is dominant
+  if (abs_dy >= abs_dz) {
+    bresenham3D(
+      action, step_y, step_x, step_z, abs_dy, abs_dx, abs_dz, abs_dy / 2, abs_dy / 2,
+      (unsigned int)(scale * abs_dy));
+    return;
+  }
+
+  // otherwise, z is dominant
+  bresenham3D(
+    action, step_z, step_x, step_y, abs_dz, abs_dx, abs_dy, abs_dz / 2, abs_dz / 2,
+    (unsigned int)(scale * abs_dz));
+}
+
+}  // namespace
+
+SparseVoxelGrid::SparseVoxelGrid(unsigned int size_x, unsigned int size_y, unsigned int size_z)
+: logger_(rclcpp::get_logger("sparse_voxel_grid"))
+{
+  resize(size_x, size_y, size_z);
+}
+
+void SparseVoxelGrid::resize(unsigned int size_x, unsigned int size_y, unsigned int size_z)
+{
+  size_x_ = size_x;
+  size_y_ = size_y;
+  size_z_ = size_z;
+
+  if (size_z_ > 16) {
+    RCLCPP_INFO(
+      logger_, "Error, this implementation can only support up to 16 z values (%d)",
+      size_z);
+    size_z_ = 16;
+  }
+
+  origin_x_ = 0;
+  origin_y_ = 0;
+  reset();
+}
+
+void SparseVoxelGrid::reset()
+{
+  blocks_.clear();
+  last_block_ = nullptr;
+}
+
+void SparseVoxelGrid::updateOrigin(int cell_ox, int cell_oy)
+{
+  origin_x_ += cell_ox;
+  origin_y_ += cell_oy;
+  last_block_ = nullptr;
+
+  // Columns leaving the grid are forgotten, so that they are unknown if they enter it again
+  const int min_x = origin_x_, max_x = origin_x_ + static_cast<int>(size_x_);
+  const int min_y = origin_y_, max_y = origin_y_ + static_cast<int>(size_y_);
+  for (auto it = blocks_.begin(); it != blocks_.end(); ) {
+    const int bx = static_cast<int32_t>(static_cast<uint32_t>(it->first >> 32)) * kBlockSize;
+    const int by = static_cast<int32_t>(static_cast<uint32_t>(it->first)) * kBlockSize;
+    const int x0 = std::max(bx, min_x), xn = std::min(bx + kBlockSize, max_x);
+    const int y0 = std::max(by, min_y), yn = std::min(by + kBlockSize, max_y);
+    if (x0 >= xn || y0 >= yn) {
+      it = blocks_.erase(it);
+      continue;
+    }
+
+    if (xn - x0 < kBlockSize || yn - y0 < kBlockSize) {
+      Block & block = *it->second;
+      for (int j = 0; j < kBlockSize; ++j) {
+        for (int i = 0; i < kBlockSize; ++i) {
+          if (bx + i < x0 || bx + i >= xn || by + j < y0 || by + j >= yn) {
+            block[(j << kBlockBits) + i] = kUnknownColumn;
+          }
+        }
+      }
+    }
+    ++it;
+  }
+}
+
+void SparseVoxelGrid::clearVoxelLineInMap(
+  double x0, double y0, double z0, double x1, double y1, double z1, unsigned char * map_2d,
+  unsigned int unknown_threshold, unsigned int mark_threshold, unsigned char free_cost,
+  unsigned char unknown_cost, unsigned int max_length, unsigned int min_length)
+{
+  if (x0 >= size_x_ || y0 >= size_y_ || z0 >= size_z_ || x1 >= size_x_ || y1 >= size_y_ ||
+    z1 >= size_z_)
+  {
+    RCLCPP_DEBUG(
+      logger_,
+      "Error, line endpoint out of bounds. "
+      "(%.2f, %.2f, %.2f) to (%.2f, %.2f, %.2f),  size: (%d, %d, %d)",
+      x0, y0, z0, x1, y1, z1, size_x_, size_y_, size_z_);
+    return;
+  }
+
+  auto clear = [&](unsigned int x, unsigned int y, uint32_t z_mask) {
+      uint32_t * col = getColumn(x, y);
+      *col &= ~(z_mask);  // clear unknown and clear cell
+      if (map_2d == NULL) {
+        return;
+      }
+
+      unsigned int unknown_bits = uint16_t(*col >> 16) ^ uint16_t(*col);
+      unsigned int marked_bits = *col >> 16;
+
+      // make sure the number of bits in each is below our thresholds
+      if (VoxelGrid::bitsBelowThreshold(marked_bits, mark_threshold)) {
+        if (VoxelGrid::bitsBelowThreshold(unknown_bits, unknown_threshold)) {
+          map_2d[y * size_x_ + x] = free_cost;
+        } else {
+          map_2d[y * size_x_ + x] = unknown_cost;
+        }
+      }
+    };
+  raytraceLine(clear, x0, y0, z0, x1, y1, z1, max_length, min_length);
+}
+
+VoxelStatus SparseVoxelGrid::getVoxel(unsigned int x, unsigned int y, unsigned int z) const
+{
+  if (x >= size_x_ || y >= size_y_ || z >= size_z_) {
+    RCLCPP_DEBUG(logger_, "Error, voxel out of bounds. (%d, %d, %d)\n", x, y, z);
+    return UNKNOWN;
+  }
+  uint32_t full_mask = ((uint32_t)1 << z << 16) | (1 << z);
+  unsigned int bits = VoxelGrid::numBits(getColumnValue(x, y) & full_mask);
+
+  // known marked: 11 = 2 bits, unknown: 01 = 1 bit, known free: 00 = 0 bits
+  if (bits < 2) {
+    if (bits < 1) {
+      return FREE;
+    }
+    return UNKNOWN;
+  }
+  return MARKED;
+}
+
+VoxelStatus SparseVoxelGrid::getVoxelColumn(
+  unsigned int x, unsigned int y,
+  unsigned int unknown_threshold, unsigned int marked_threshold) const
+{
+  if (x >= size_x_ || y >= size_y_) {
+    RCLCPP_DEBUG(logger_, "Error, voxel out of bounds. (%d, %d)\n", x, y);
+    return UNKNOWN;
+  }
+
+  const uint32_t col = getColumnValue(x, y);
+  unsigned int unknown_bits = uint16_t(col >> 16) ^ uint16_t(col);
+  unsigned int marked_bits = col >> 16;
+
+  if (!VoxelGrid::bitsBelowThreshold(marked_bits, marked_threshold)) {
+    return MARKED;
+  }
+  if (!VoxelGrid::bitsBelowThreshold(unknown_bits, unknown_threshold)) {
+    return UNKNOWN;
+  }
+  return FREE;
+}
+
+void SparseVoxelGrid::copyColumns(
+  unsigned int x0, unsigned int y0, unsigned int xn, unsigned int yn,
+  uint32_t * columns) const
+{
+  const unsigned int width = xn - x0;
+  std::fill_n(columns, static_cast<size_t>(width) * (yn - y0), kUnknownColumn);
+
+  // Only the allocated blocks overlapping the window are copied
+  const int min_x = origin_x_ + static_cast<int>(x0), max_x = origin_x_ + static_cast<int>(xn);
+  const int min_y = origin_y_ + static_cast<int>(y0), max_y = origin_y_ + static_cast<int>(yn);
+  for (const auto & entry : blocks_) {
+    const int bx = static_cast<int32_t>(static_cast<uint32_t>(entry.first >> 32)) * kBlockSize;
+    const int by = static_cast<int32_t>(static_cast<uint32_t>(entry.first)) * kBlockSize;
+    const int bx0 = std::max(bx, min_x), bxn = std::min(bx + kBlockSize, max_x);
+    const int by0 = std::max(by, min_y), byn = std::min(by + kBlockSize, max_y);
+    for (int gy = by0; gy < byn; ++gy) {
+      for (int gx = bx0; gx < bxn; ++gx) {
+        columns[static_cast<size_t>(gy - min_y) * width + (gx - min_x)] =
+          (*entry.second)[((gy - by) << kBlockBits) + (gx - bx)];
+      }
+    }
+  }
+}
+
+}  // namespace nav2_voxel_grid
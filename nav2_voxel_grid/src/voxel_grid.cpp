@@ -53,12 +53,7 @@ VoxelGrid::VoxelGrid(unsigned int size_x, unsigned int size_y, unsigned int size
   }
 
   data_ = new uint32_t[size_x_ * size_y_];
-  uint32_t unknown_col = ~((uint32_t)0) >> 16;
-  uint32_t * col = data_;
-  for (unsigned int i = 0; i < size_x_ * size_y_; ++i) {
-    *col = unknown_col;
-    ++col;
-  }
+  reset();
 }
 
 void VoxelGrid::resize(unsigned int size_x, unsigned int size_y, unsigned int size_z)
@@ -82,12 +77,7 @@ void VoxelGrid::resize(unsigned int size_x, unsigned int size_y, unsigned int si
   }
 
   data_ = new uint32_t[size_x_ * size_y_];
-  uint32_t unknown_col = ~((uint32_t)0) >> 16;
-  uint32_t * col = data_;
-  for (unsigned int i = 0; i < size_x_ * size_y_; ++i) {
-    *col = unknown_col;
-    ++col;
-  }
+  reset();
 }
 
 VoxelGrid::~VoxelGrid()
@@ -97,12 +87,8 @@ VoxelGrid::~VoxelGrid()
 
 void VoxelGrid::reset()
 {
-  uint32_t unknown_col = ~((uint32_t)0) >> 16;
-  uint32_t * col = data_;
-  for (unsigned int i = 0; i < size_x_ * size_y_; ++i) {
-    *col = unknown_col;
-    ++col;
-  }
+  const uint32_t unknown_col = ~((uint32_t)0) >> 16;
+  std::fill_n(data_, size_x_ * size_y_, unknown_col);
 }
 
 void VoxelGrid::markVoxelLine(
@@ -35,8 +35,12 @@
 * Author: Eitan Marder-Eppstein
 *********************************************************************/
 #include <nav2_voxel_grid/voxel_grid.hpp>
+#include <nav2_voxel_grid/sparse_voxel_grid.hpp>
 #include <gtest/gtest.h>
 
+#include <random>
+#include <vector>
+
 TEST(voxel_grid, basicMarkingAndClearing) {
   int size_x = 50, size_y = 10, size_z = 16;
   nav2_voxel_grid::VoxelGrid vg(size_x, size_y, size_z);
@@ -197,6 +201,80 @@ TEST(voxel_grid, GetVoxelData) {
   delete[] data;
 }
 
+TEST(voxel_grid, BitCounting) {
+  EXPECT_EQ(nav2_voxel_grid::VoxelGrid::numBits(0u), 0u);
+  EXPECT_EQ(nav2_voxel_grid::VoxelGrid::numBits(0x10001u), 2u);
+  EXPECT_EQ(nav2_voxel_grid::VoxelGrid::numBits(~0u), 32u);
+
+  EXPECT_TRUE(nav2_voxel_grid::VoxelGrid::bitsBelowThreshold(0u, 0));
+  EXPECT_FALSE(nav2_voxel_grid::VoxelGrid::bitsBelowThreshold(1u, 0));
+  EXPECT_TRUE(nav2_voxel_grid::VoxelGrid::bitsBelowThreshold(0x7u, 3));
+  EXPECT_FALSE(nav2_voxel_grid::VoxelGrid::bitsBelowThreshold(0xFu, 3));
+}
+
+TEST(voxel_grid, sparseMatchesDense) {
+  const unsigned int size_x = 70, size_y = 45, size_z = 12;
+  nav2_voxel_grid::VoxelGrid dense(size_x, size_y, size_z);
+  nav2_voxel_grid::SparseVoxelGrid sparse(size_x, size_y, size_z);
+  std::vector<unsigned char> dense_map(size_x * size_y, 254), sparse_map(dense_map);
+  std::vector<uint32_t> columns(size_x * size_y);
+
+  std::mt19937 gen(7);
+  std::uniform_real_distribution<double> x_dist(0.0, size_x - 0.01);
+  std::uniform_real_distribution<double> y_dist(0.0, size_y - 0.01);
+  std::uniform_real_distribution<double> z_dist(0.0, size_z - 0.01);
+  std::uniform_int_distribution<int> shift_dist(-20, 20);
+
+  for (int round = 0; round < 20; ++round) {
+    for (int i = 0; i < 50; ++i) {
+      const unsigned int x = x_dist(gen), y = y_dist(gen), z = z_dist(gen);
+      ASSERT_EQ(dense.markVoxelInMap(x, y, z, 1), sparse.markVoxelInMap(x, y, z, 1));
+    }
+    for (int i = 0; i < 50; ++i) {
+      const double x0 = x_dist(gen), y0 = y_dist(gen), z0 = z_dist(gen);
+      const double x1 = x_dist(gen), y1 = y_dist(gen), z1 = z_dist(gen);
+      dense.clearVoxelLineInMap(x0, y0, z0, x1, y1, z1, dense_map.data(), 2, 0, 0, 255, 40, 2);
+      sparse.clearVoxelLineInMap(x0, y0, z0, x1, y1, z1, sparse_map.data(), 2, 0, 0, 255, 40, 2);
+    }
+    ASSERT_EQ(dense_map, sparse_map);
+
+    // Move the dense grid as the voxel layer does for a rolling window
+    const int dx = shift_dist(gen), dy = shift_dist(gen);
+    std::vector<uint32_t> moved(size_x * size_y, nav2_voxel_grid::SparseVoxelGrid::kUnknownColumn);
+    for (unsigned int y = 0; y < size_y; ++y) {
+      for (unsigned int x = 0; x < size_x; ++x) {
+        const int old_x = x + dx, old_y = y + dy;
+        if (old_x >= 0 && old_x < static_cast<int>(size_x) &&
+          old_y >= 0 && old_y < static_cast<int>(size_y))
+        {
+          moved[y * size_x + x] = dense.getData()[old_y * size_x + old_x];
+        }
+      }
+    }
+    std::copy(moved.begin(), moved.end(), dense.getData());
+    sparse.updateOrigin(dx, dy);
+
+    sparse.copyColumns(0, 0, size_x, size_y, columns.data());
+    ASSERT_TRUE(std::equal(columns.begin(), columns.end(), dense.getData()));
+    for (unsigned int y = 0; y < size_y; y += 3) {
+      for (unsigned int x = 0; x < size_x; x += 3) {
+        ASSERT_EQ(dense.getVoxelColumn(x, y, 2, 1), sparse.getVoxelColumn(x, y, 2, 1));
+        ASSERT_EQ(dense.getVoxel(x, y, 3), sparse.getVoxel(x, y, 3));
+      }
+    }
+  }
+
+  // A window of columns is laid out as the dense data
+  std::vector<uint32_t> window(10 * 5);
+  sparse.copyColumns(30, 20, 40, 25, window.data());
+  EXPECT_EQ(window[2 * 10 + 3], dense.getData()[22 * size_x + 33]);
+
+  EXPECT_GT(sparse.numBlocks(), 0u);
+  sparse.reset();
+  EXPECT_EQ(sparse.numBlocks(), 0u);
+  EXPECT_EQ(sparse.getVoxelColumn(5, 5, 0, 0), nav2_voxel_grid::UNKNOWN);
+}
+
 int main(int argc, char ** argv)
 {
   testing::InitGoogleTest(&argc, argv);
@@ -22,10 +22,14 @@
 #define _LIBCPP_NO_EXPERIMENTAL_DEPRECATION_WARNING_FILESYSTEM
 
 
+#include <condition_variable>
+#include <deque>
 #include <filesystem>
 #include <mutex>
 #include <string>
 #include <exception>
+#include <thread>
+#include <vector>
 
 #include "rclcpp/rclcpp.hpp"
 #include "rclcpp_components/register_node_macro.hpp"
@@ -93,7 +97,36 @@ public:
    */
   static void deepCopyMsg2Mat(const sensor_msgs::msg::Image::SharedPtr & msg, cv::Mat & mat);
 
+  /**
+   * @brief Waits until the photos queued are saved
+   */
+  void waitForSaves();
+
 protected:
+  /**
+   * @brief A photo to save in the background
+   */
+  struct SaveRequest
+  {
+    sensor_msgs::msg::Image::SharedPtr frame;
+    std::filesystem::path path;
+    int waypoint_index;
+  };
+
+  /**
+   * @brief Converts and writes a photo to disk
+   * @param frame Image to save
+   * @param path Path of the image file
+   */
+  static void savePhoto(
+    const sensor_msgs::msg::Image::SharedPtr & frame,
+    const std::filesystem::path & path);
+
+  /**
+   * @brief Saves the photos queued, until the plugin is destroyed
+   */
+  void saveWorker();
+
   // to ensure safety when accessing global var curr_frame_
   std::mutex global_mutex_;
   // the taken photos will be saved under this directory
@@ -110,6 +143,19 @@ protected:
   rclcpp::Logger logger_{rclcpp::get_logger("nav2_waypoint_follower")};
   // ros subscriber to get camera image
   rclcpp::Subscription<sensor_msgs::msg::Image>::SharedPtr camera_image_subscriber_;
+
+  // whether photos are encoded and written by background workers
+  bool async_save_{false};
+  // maximum number of photos waiting to be saved, capturing waits beyond it
+  size_t save_queue_size_;
+  // photos waiting to be saved, and number of them being saved
+  std::deque<SaveRequest> save_queue_;
+  size_t saves_in_progress_{0};
+  std::mutex save_mutex_;
+  std::condition_variable save_cv_;
+  std::condition_variable save_done_cv_;
+  bool stop_workers_{false};
+  std::vector<std::thread> save_workers_;
 };
 }  // namespace nav2_waypoint_follower
 
@@ -26,6 +26,8 @@
 #include "geographic_msgs/msg/geo_pose.hpp"
 #include "nav2_util/lifecycle_node.hpp"
 #include "nav2_msgs/action/navigate_to_pose.hpp"
+#include "nav2_msgs/action/compute_path_to_pose.hpp"
+#include "nav2_msgs/action/follow_path.hpp"
 #include "nav2_msgs/action/follow_waypoints.hpp"
 #include "nav2_msgs/msg/missed_waypoint.hpp"
 #include "nav_msgs/msg/path.hpp"
@@ -71,6 +73,10 @@ public:
   using ActionServer = nav2_util::SimpleActionServer<ActionT>;
   using ActionClient = rclcpp_action::Client<ClientT>;
 
+  // Shorten the types for pipelined waypoint following
+  using PlanClientT = nav2_msgs::action::ComputePathToPose;
+  using FollowClientT = nav2_msgs::action::FollowPath;
+
   // Shorten the types for GPS waypoint following
   using ActionTGPS = nav2_msgs::action::FollowGPSWaypoints;
   using ActionServerGPS = nav2_util::SimpleActionServer<ActionTGPS>;
@@ -161,6 +167,36 @@ protected:
    */
   void goalResponseCallback(const rclcpp_action::ClientGoalHandle<ClientT>::SharedPtr & goal);
 
+  /**
+   * @brief Plan the path to a waypoint from the previous one in the background,
+   * while the robot drives to the previous one or executes its task
+   * @param start Previous waypoint, the path start
+   * @param goal Waypoint to plan to
+   * @param goal_index Index of the waypoint to plan to
+   */
+  void planAhead(
+    const geometry_msgs::msg::PoseStamped & start,
+    const geometry_msgs::msg::PoseStamped & goal, uint32_t goal_index);
+
+  /**
+   * @brief Send the path planned ahead to a waypoint to the controller, if it is ready
+   * @param goal_index Index of the waypoint to go to
+   * @return False if no path was planned to this waypoint, or it is not ready yet
+   */
+  bool followPlannedPath(uint32_t goal_index);
+
+  /**
+   * @brief Forget the path planned ahead, if any
+   */
+  void resetPlannedPath();
+
+  /**
+   * @brief Follow path action client result callback
+   * @param result Result of action server updated asynchronously
+   */
+  void followPathResultCallback(
+    const rclcpp_action::ClientGoalHandle<FollowClientT>::WrappedResult & result);
+
   /**
    * @brief given some gps_poses, converts them to map frame using robot_localization's service `fromLL`.
    *        Constructs a vector of stamped poses in map frame and returns them.
@@ -171,6 +207,30 @@ protected:
   std::vector<geometry_msgs::msg::PoseStamped> convertGPSPosesToMapPoses(
     const std::vector<geographic_msgs::msg::GeoPose> & gps_poses);
 
+  /**
+   * @brief Converts the whole route locally, fitting the transform from a local geodetic
+   * frame to the map frame on a few waypoints converted by the `fromLL` service, and
+   * validating it on another one
+   *
+   * @param gps_poses, from the action server
+   * @param poses, converted poses in map frame
+   * @return False if the route is too short or the transform could not be validated,
+   * in which case every waypoint has to be converted by the service
+   */
+  bool convertGPSPosesLocally(
+    const std::vector<geographic_msgs::msg::GeoPose> & gps_poses,
+    std::vector<geometry_msgs::msg::PoseStamped> & poses);
+
+  /**
+   * @brief Converts a GPS position to map frame with robot_localization's `fromLL` service
+   *
+   * @param gps_pose, to convert
+   * @param map_point, converted position in map frame
+   * @return False if the service could not convert it
+   */
+  bool convertGPSPoseWithService(
+    const geographic_msgs::msg::GeoPose & gps_pose, geometry_msgs::msg::Point & map_point);
+
 
   /**
    * @brief get the latest poses on the action server goal. If they are GPS poses,
@@ -211,8 +271,25 @@ protected:
 
   bool stop_on_failure_;
   int loop_rate_;
+  bool local_gps_conversion_;
+  double local_gps_conversion_tolerance_;
   GoalStatus current_goal_status_;
 
+  // Pipelined waypoint following: the path to the next waypoint is planned ahead,
+  // and followed right away once the current waypoint is done
+  bool pipelined_execution_;
+  rclcpp_action::Client<PlanClientT>::SharedPtr compute_path_client_;
+  rclcpp_action::Client<FollowClientT>::SharedPtr follow_path_client_;
+  std::shared_future<rclcpp_action::ClientGoalHandle<PlanClientT>::SharedPtr>
+  future_plan_handle_;
+  std::shared_future<rclcpp_action::ClientGoalHandle<FollowClientT>::SharedPtr>
+  future_follow_handle_;
+  // Index of the waypoint planned ahead to, -1 if none
+  int planned_index_{-1};
+  nav_msgs::msg::Path planned_path_;
+  // Whether the current waypoint is reached by following a path planned ahead
+  bool following_planned_path_{false};
+
   // Task Execution At Waypoint Plugin
   pluginlib::ClassLoader<nav2_core::WaypointTaskExecutor>
   waypoint_task_executor_loader_;
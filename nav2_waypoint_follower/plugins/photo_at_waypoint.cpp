@@ -14,8 +14,10 @@
 
 #include "nav2_waypoint_follower/plugins/photo_at_waypoint.hpp"
 
+#include <algorithm>
 #include <string>
 #include <memory>
+#include <stdexcept>
 
 #include "pluginlib/class_list_macros.hpp"
 
@@ -29,6 +31,15 @@ PhotoAtWaypoint::PhotoAtWaypoint()
 
 PhotoAtWaypoint::~PhotoAtWaypoint()
 {
+  // Photos queued are still saved before the workers stop
+  {
+    std::lock_guard<std::mutex> lock(save_mutex_);
+    stop_workers_ = true;
+  }
+  save_cv_.notify_all();
+  for (auto & worker : save_workers_) {
+    worker.join();
+  }
 }
 
 void PhotoAtWaypoint::initialize(
@@ -51,12 +62,25 @@ void PhotoAtWaypoint::initialize(
   nav2_util::declare_parameter_if_not_declared(
     node, plugin_name + ".image_format",
     rclcpp::ParameterValue("png"));
+  nav2_util::declare_parameter_if_not_declared(
+    node, plugin_name + ".async_save",
+    rclcpp::ParameterValue(false));
+  nav2_util::declare_parameter_if_not_declared(
+    node, plugin_name + ".save_threads",
+    rclcpp::ParameterValue(1));
+  nav2_util::declare_parameter_if_not_declared(
+    node, plugin_name + ".save_queue_size",
+    rclcpp::ParameterValue(4));
 
   std::string save_dir_as_string;
   node->get_parameter(plugin_name + ".enabled", is_enabled_);
   node->get_parameter(plugin_name + ".image_topic", image_topic_);
   node->get_parameter(plugin_name + ".save_dir", save_dir_as_string);
   node->get_parameter(plugin_name + ".image_format", image_format_);
+  node->get_parameter(plugin_name + ".async_save", async_save_);
+  int save_threads = node->get_parameter(plugin_name + ".save_threads").as_int();
+  save_queue_size_ = static_cast<size_t>(
+    std::max(1, static_cast<int>(node->get_parameter(plugin_name + ".save_queue_size").as_int())));
 
   // get inputted save directory and make sure it exists, if not log and create  it
   save_dir_ = save_dir_as_string;
@@ -95,6 +119,12 @@ void PhotoAtWaypoint::initialize(
     camera_image_subscriber_ = node->create_subscription<sensor_msgs::msg::Image>(
       image_topic_, rclcpp::SystemDefaultsQoS(),
       std::bind(&PhotoAtWaypoint::imageCallback, this, std::placeholders::_1));
+
+    if (async_save_) {
+      for (int i = 0; i < std::max(1, save_threads); ++i) {
+        save_workers_.emplace_back(&PhotoAtWaypoint::saveWorker, this);
+      }
+    }
   }
 }
 
@@ -115,11 +145,36 @@ bool PhotoAtWaypoint::processAtWaypoint(
       std::to_string(curr_pose.header.stamp.sec) + "." + image_format_;
     std::filesystem::path full_path_image_path = save_dir_ / file_name;
 
+    if (async_save_) {
+      // only keep a reference to the latest frame, received messages are not modified
+      sensor_msgs::msg::Image::SharedPtr frame;
+      {
+        std::lock_guard<std::mutex> guard(global_mutex_);
+        frame = curr_frame_msg_;
+      }
+      if (frame->data.empty()) {
+        throw std::runtime_error("No image received yet");
+      }
+
+      std::unique_lock<std::mutex> lock(save_mutex_);
+      if (save_queue_.size() >= save_queue_size_) {
+        RCLCPP_WARN(
+          logger_, "%zu photos are waiting to be saved, waiting for one of them to be saved",
+          save_queue_.size());
+        save_done_cv_.wait(lock, [this]() {return save_queue_.size() < save_queue_size_;});
+      }
+      save_queue_.push_back({frame, full_path_image_path, curr_waypoint_index});
+      lock.unlock();
+      save_cv_.notify_one();
+      RCLCPP_INFO(
+        logger_, "Photo has been taken at waypoint %i, saving it in the background",
+        curr_waypoint_index);
+      return true;
+    }
+
     // save the taken photo at this waypoint to given directory
     std::lock_guard<std::mutex> guard(global_mutex_);
-    cv::Mat curr_frame_mat;
-    deepCopyMsg2Mat(curr_frame_msg_, curr_frame_mat);
-    cv::imwrite(full_path_image_path.c_str(), curr_frame_mat);
+    savePhoto(curr_frame_msg_, full_path_image_path);
     RCLCPP_INFO(
       logger_,
       "Photo has been taken sucessfully at waypoint %i", curr_waypoint_index);
@@ -153,6 +208,55 @@ void PhotoAtWaypoint::deepCopyMsg2Mat(
   frame.copyTo(mat);
 }
 
+void PhotoAtWaypoint::savePhoto(
+  const sensor_msgs::msg::Image::SharedPtr & frame,
+  const std::filesystem::path & path)
+{
+  cv::Mat frame_mat;
+  deepCopyMsg2Mat(frame, frame_mat);
+  if (!cv::imwrite(path.c_str(), frame_mat)) {
+    throw std::runtime_error("Failed to write " + path.string());
+  }
+}
+
+void PhotoAtWaypoint::saveWorker()
+{
+  std::unique_lock<std::mutex> lock(save_mutex_);
+  while (true) {
+    save_cv_.wait(lock, [this]() {return stop_workers_ || !save_queue_.empty();});
+    if (save_queue_.empty()) {
+      return;
+    }
+    SaveRequest request = std::move(save_queue_.front());
+    save_queue_.pop_front();
+    saves_in_progress_++;
+    lock.unlock();
+    save_done_cv_.notify_all();
+
+    try {
+      savePhoto(request.frame, request.path);
+      RCLCPP_INFO(
+        logger_, "Photo taken at waypoint %i has been saved to %s",
+        request.waypoint_index, request.path.c_str());
+    } catch (const std::exception & e) {
+      RCLCPP_ERROR(
+        logger_, "Couldn't save photo taken at waypoint %i! Caught exception: %s",
+        request.waypoint_index, e.what());
+    }
+
+    lock.lock();
+    saves_in_progress_--;
+    save_done_cv_.notify_all();
+  }
+}
+
+void PhotoAtWaypoint::waitForSaves()
+{
+  std::unique_lock<std::mutex> lock(save_mutex_);
+  save_done_cv_.wait(
+    lock, [this]() {return save_queue_.empty() && saves_in_progress_ == 0;});
+}
+
 }      // namespace nav2_waypoint_follower
 PLUGINLIB_EXPORT_CLASS(
   nav2_waypoint_follower::PhotoAtWaypoint,
@@ -14,6 +14,9 @@
 
 #include "nav2_waypoint_follower/waypoint_follower.hpp"
 
+#include <algorithm>
+#include <cmath>
+#include <complex>
 #include <fstream>
 #include <memory>
 #include <streambuf>
@@ -27,6 +30,49 @@ namespace nav2_waypoint_follower
 using rcl_interfaces::msg::ParameterType;
 using std::placeholders::_1;
 
+namespace
+{
+
+/**
+ * @brief Converts a WGS84 position to the local East-North-Up frame of an origin
+ * @param gps_point Position to convert
+ * @param origin Origin of the local frame
+ * @return East and North coordinates (m), as a complex number
+ */
+std::complex<double> geodeticToEastNorth(
+  const geographic_msgs::msg::GeoPoint & gps_point,
+  const geographic_msgs::msg::GeoPoint & origin)
+{
+  constexpr double a = 6378137.0;
+  constexpr double f = 1.0 / 298.257223563;
+  constexpr double e2 = f * (2.0 - f);
+
+  auto to_ecef = [&](const geographic_msgs::msg::GeoPoint & point, double ecef[3]) {
+      const double lat = point.latitude * M_PI / 180.0;
+      const double lon = point.longitude * M_PI / 180.0;
+      const double n = a / std::sqrt(1.0 - e2 * std::sin(lat) * std::sin(lat));
+      ecef[0] = (n + point.altitude) * std::cos(lat) * std::cos(lon);
+      ecef[1] = (n + point.altitude) * std::cos(lat) * std::sin(lon);
+      ecef[2] = (n * (1.0 - e2) + point.altitude) * std::sin(lat);
+    };
+
+  double point_ecef[3], origin_ecef[3];
+  to_ecef(gps_point, point_ecef);
+  to_ecef(origin, origin_ecef);
+  const double dx = point_ecef[0] - origin_ecef[0];
+  const double dy = point_ecef[1] - origin_ecef[1];
+  const double dz = point_ecef[2] - origin_ecef[2];
+
+  const double lat0 = origin.latitude * M_PI / 180.0;
+  const double lon0 = origin.longitude * M_PI / 180.0;
+  const double east = -std::sin(lon0) * dx + std::cos(lon0) * dy;
+  const double north = -std::sin(lat0) * std::cos(lon0) * dx -
+    std::sin(lat0) * std::sin(lon0) * dy + std::cos(lat0) * dz;
+  return {east, north};
+}
+
+}  // namespace
+
 WaypointFollower::WaypointFollower(const rclcpp::NodeOptions & options)
 : nav2_util::LifecycleNode("waypoint_follower", "", options),
   waypoint_task_executor_loader_("nav2_waypoint_follower",
@@ -36,6 +82,9 @@ WaypointFollower::WaypointFollower(const rclcpp::NodeOptions & options)
 
   declare_parameter("stop_on_failure", true);
   declare_parameter("loop_rate", 20);
+  declare_parameter("pipelined_execution", false);
+  declare_parameter("local_gps_conversion", true);
+  declare_parameter("local_gps_conversion_tolerance", 0.1);
 
   declare_parameter("action_server_result_timeout", 900.0);
 
@@ -62,6 +111,9 @@ WaypointFollower::on_configure(const rclcpp_lifecycle::State & /*state*/)
 
   stop_on_failure_ = get_parameter("stop_on_failure").as_bool();
   loop_rate_ = get_parameter("loop_rate").as_int();
+  pipelined_execution_ = get_parameter("pipelined_execution").as_bool();
+  local_gps_conversion_ = get_parameter("local_gps_conversion").as_bool();
+  local_gps_conversion_tolerance_ = get_parameter("local_gps_conversion_tolerance").as_double();
   waypoint_task_executor_id_ = get_parameter("waypoint_task_executor_plugin").as_string();
   global_frame_id_ = get_parameter("global_frame_id").as_string();
   global_frame_id_ = nav2_util::strip_leading_slash(global_frame_id_);
@@ -78,6 +130,21 @@ WaypointFollower::on_configure(const rclcpp_lifecycle::State & /*state*/)
     get_node_waitables_interface(),
     "navigate_to_pose", callback_group_);
 
+  if (pipelined_execution_) {
+    compute_path_client_ = rclcpp_action::create_client<PlanClientT>(
+      get_node_base_interface(),
+      get_node_graph_interface(),
+      get_node_logging_interface(),
+      get_node_waitables_interface(),
+      "compute_path_to_pose", callback_group_);
+    follow_path_client_ = rclcpp_action::create_client<FollowClientT>(
+      get_node_base_interface(),
+      get_node_graph_interface(),
+      get_node_logging_interface(),
+      get_node_waitables_interface(),
+      "follow_path", callback_group_);
+  }
+
   double action_server_result_timeout = get_parameter("action_server_result_timeout").as_double();
   rcl_action_server_options_t server_options = rcl_action_server_get_default_options();
   server_options.result_timeout.nanoseconds = RCL_S_TO_NS(action_server_result_timeout);
@@ -168,6 +235,8 @@ WaypointFollower::on_cleanup(const rclcpp_lifecycle::State & /*state*/)
 
   xyz_action_server_.reset();
   nav_to_pose_client_.reset();
+  compute_path_client_.reset();
+  follow_path_client_.reset();
   gps_action_server_.reset();
   from_ll_to_map_client_.reset();
 
@@ -250,6 +319,11 @@ void WaypointFollower::followWaypointsHandler(
     if (action_server->is_cancel_requested()) {
       auto cancel_future = nav_to_pose_client_->async_cancel_all_goals();
       callback_group_executor_.spin_until_future_complete(cancel_future);
+      if (following_planned_path_) {
+        auto follow_cancel_future = follow_path_client_->async_cancel_all_goals();
+        callback_group_executor_.spin_until_future_complete(follow_cancel_future);
+      }
+      resetPlannedPath();
       // for result callback processing
       callback_group_executor_.spin_some();
       action_server->terminate_all();
@@ -271,11 +345,16 @@ void WaypointFollower::followWaypointsHandler(
       }
       goal_index = 0;
       new_goal = true;
+      resetPlannedPath();
     }
 
     // Check if we need to send a new goal
-    if (new_goal) {
+    if (new_goal && followPlannedPath(goal_index)) {
       new_goal = false;
+      current_goal_status_.status = ActionStatus::PROCESSING;
+    } else if (new_goal) {
+      new_goal = false;
+      following_planned_path_ = false;
       ClientT::Goal client_goal;
       client_goal.pose = poses[goal_index];
       client_goal.pose.header.stamp = this->now();
@@ -293,6 +372,30 @@ void WaypointFollower::followWaypointsHandler(
       current_goal_status_.status = ActionStatus::PROCESSING;
     }
 
+    // Plan ahead to the next waypoint, while driving to this one and executing its task
+    if (pipelined_execution_ && planned_index_ < 0) {
+      if (goal_index + 1 < poses.size()) {
+        planAhead(poses[goal_index], poses[goal_index + 1], goal_index + 1);
+      } else if (current_loop_no < no_of_loops) {
+        planAhead(poses[goal_index], poses[0], 0);
+      }
+    }
+
+    // A planned path may no longer be followable, e.g. if blocked since it was planned.
+    // Navigate to the waypoint instead, with replanning and recoveries.
+    if (following_planned_path_ &&
+      current_goal_status_.status == ActionStatus::FAILED)
+    {
+      RCLCPP_INFO(
+        get_logger(), "Failed to follow the path planned to waypoint %i, "
+        "navigating to it instead.", goal_index);
+      following_planned_path_ = false;
+      new_goal = true;
+      callback_group_executor_.spin_some();
+      r.sleep();
+      continue;
+    }
+
     feedback->current_waypoint = goal_index;
     action_server->publish_feedback(feedback);
 
@@ -434,6 +537,107 @@ WaypointFollower::resultCallback(
   }
 }
 
+void WaypointFollower::planAhead(
+  const geometry_msgs::msg::PoseStamped & start,
+  const geometry_msgs::msg::PoseStamped & goal, uint32_t goal_index)
+{
+  if (!compute_path_client_->action_server_is_ready()) {
+    return;
+  }
+
+  PlanClientT::Goal plan_goal;
+  plan_goal.goal = goal;
+  plan_goal.start = start;
+  plan_goal.use_start = true;
+
+  planned_index_ = static_cast<int>(goal_index);
+  planned_path_.poses.clear();
+  auto send_goal_options = rclcpp_action::Client<PlanClientT>::SendGoalOptions();
+  send_goal_options.result_callback =
+    [this](const rclcpp_action::ClientGoalHandle<PlanClientT>::WrappedResult & result) {
+      // Ignore the paths planned ahead before a reset
+      if (planned_index_ < 0 || !future_plan_handle_.valid() ||
+        !future_plan_handle_.get() ||
+        result.goal_id != future_plan_handle_.get()->get_goal_id())
+      {
+        return;
+      }
+      if (result.code == rclcpp_action::ResultCode::SUCCEEDED) {
+        planned_path_ = result.result->path;
+      }
+    };
+  future_plan_handle_ = compute_path_client_->async_send_goal(plan_goal, send_goal_options);
+}
+
+bool WaypointFollower::followPlannedPath(uint32_t goal_index)
+{
+  if (!pipelined_execution_ || planned_index_ != static_cast<int>(goal_index)) {
+    return false;
+  }
+
+  // Not waiting for a path still being planned, navigating to the waypoint instead
+  const bool path_ready = !planned_path_.poses.empty();
+  nav_msgs::msg::Path path = planned_path_;
+  resetPlannedPath();
+  if (!path_ready || !follow_path_client_->action_server_is_ready()) {
+    return false;
+  }
+
+  FollowClientT::Goal follow_goal;
+  follow_goal.path = path;
+  auto send_goal_options = rclcpp_action::Client<FollowClientT>::SendGoalOptions();
+  send_goal_options.result_callback = std::bind(
+    &WaypointFollower::followPathResultCallback, this, std::placeholders::_1);
+  send_goal_options.goal_response_callback =
+    [this](const rclcpp_action::ClientGoalHandle<FollowClientT>::SharedPtr & goal) {
+      if (!goal) {
+        RCLCPP_ERROR(
+          get_logger(), "follow_path action client failed to send goal to server.");
+        current_goal_status_.status = ActionStatus::FAILED;
+      }
+    };
+
+  RCLCPP_INFO(get_logger(), "Following the path planned ahead to waypoint %i", goal_index);
+  future_follow_handle_ = follow_path_client_->async_send_goal(follow_goal, send_goal_options);
+  following_planned_path_ = true;
+  return true;
+}
+
+void WaypointFollower::resetPlannedPath()
+{
+  planned_index_ = -1;
+  planned_path_.poses.clear();
+}
+
+void
+WaypointFollower::followPathResultCallback(
+  const rclcpp_action::ClientGoalHandle<FollowClientT>::WrappedResult & result)
+{
+  if (!following_planned_path_ ||
+    result.goal_id != future_follow_handle_.get()->get_goal_id())
+  {
+    RCLCPP_DEBUG(
+      get_logger(),
+      "Goal IDs do not match for the current path followed and received result."
+      "Ignoring likely due to receiving result for an old goal.");
+    return;
+  }
+
+  switch (result.code) {
+    case rclcpp_action::ResultCode::SUCCEEDED:
+      current_goal_status_.status = ActionStatus::SUCCEEDED;
+      return;
+    case rclcpp_action::ResultCode::ABORTED:
+    case rclcpp_action::ResultCode::CANCELED:
+      current_goal_status_.status = ActionStatus::FAILED;
+      return;
+    default:
+      RCLCPP_ERROR(get_logger(), "Received an UNKNOWN result code from follow path action!");
+      current_goal_status_.status = ActionStatus::FAILED;
+      return;
+  }
+}
+
 void
 WaypointFollower::goalResponseCallback(
   const rclcpp_action::ClientGoalHandle<ClientT>::SharedPtr & goal)
@@ -480,16 +684,18 @@ WaypointFollower::convertGPSPosesToMapPoses(
     global_frame_id_.c_str());
 
   std::vector<geometry_msgs::msg::PoseStamped> poses_in_map_frame_vector;
+  if (local_gps_conversion_ && convertGPSPosesLocally(gps_poses, poses_in_map_frame_vector)) {
+    RCLCPP_INFO(
+      this->get_logger(),
+      "Converted all %i GPS waypoint to %s frame locally",
+      static_cast<int>(poses_in_map_frame_vector.size()), global_frame_id_.c_str());
+    return poses_in_map_frame_vector;
+  }
+
   int waypoint_index = 0;
   for (auto && curr_geopose : gps_poses) {
-    auto request = std::make_shared<robot_localization::srv::FromLL::Request>();
-    auto response = std::make_shared<robot_localization::srv::FromLL::Response>();
-    request->ll_point.latitude = curr_geopose.position.latitude;
-    request->ll_point.longitude = curr_geopose.position.longitude;
-    request->ll_point.altitude = curr_geopose.position.altitude;
-
-    from_ll_to_map_client_->wait_for_service((std::chrono::seconds(1)));
-    if (!from_ll_to_map_client_->invoke(request, response)) {
+    geometry_msgs::msg::Point map_point;
+    if (!convertGPSPoseWithService(curr_geopose, map_point)) {
       RCLCPP_ERROR(
         this->get_logger(),
         "fromLL service of robot_localization could not convert %i th GPS waypoint to"
@@ -510,7 +716,7 @@ WaypointFollower::convertGPSPosesToMapPoses(
       geometry_msgs::msg::PoseStamped curr_pose_map_frame;
       curr_pose_map_frame.header.frame_id = global_frame_id_;
       curr_pose_map_frame.header.stamp = this->now();
-      curr_pose_map_frame.pose.position = response->map_point;
+      curr_pose_map_frame.pose.position = map_point;
       curr_pose_map_frame.pose.orientation = curr_geopose.orientation;
       poses_in_map_frame_vector.push_back(curr_pose_map_frame);
     }
@@ -523,6 +729,99 @@ WaypointFollower::convertGPSPosesToMapPoses(
   return poses_in_map_frame_vector;
 }
 
+bool WaypointFollower::convertGPSPosesLocally(
+  const std::vector<geographic_msgs::msg::GeoPose> & gps_poses,
+  std::vector<geometry_msgs::msg::PoseStamped> & poses)
+{
+  // Converting a few waypoints with the service is as fast
+  if (gps_poses.size() < 4) {
+    return false;
+  }
+
+  // Local coordinates of the route, around its first waypoint
+  const auto & origin = gps_poses.front().position;
+  std::vector<std::complex<double>> local(gps_poses.size());
+  for (size_t i = 0; i < gps_poses.size(); ++i) {
+    local[i] = geodeticToEastNorth(gps_poses[i].position, origin);
+  }
+
+  // Fit the transform on the first and farthest waypoints, and validate it
+  // on the waypoint farthest from both
+  size_t far = 0, check = 0;
+  for (size_t i = 1; i < local.size(); ++i) {
+    if (std::abs(local[i]) > std::abs(local[far])) {
+      far = i;
+    }
+  }
+  double check_dist = -1.0;
+  for (size_t i = 1; i < local.size(); ++i) {
+    const double dist = std::min(std::abs(local[i]), std::abs(local[i] - local[far]));
+    if (i != far && dist > check_dist) {
+      check = i;
+      check_dist = dist;
+    }
+  }
+  if (std::abs(local[far]) < 1.0) {
+    return false;
+  }
+
+  geometry_msgs::msg::Point origin_map, far_map, check_map;
+  if (!convertGPSPoseWithService(gps_poses.front(), origin_map) ||
+    !convertGPSPoseWithService(gps_poses[far], far_map) ||
+    !convertGPSPoseWithService(gps_poses[check], check_map))
+  {
+    return false;
+  }
+
+  // Map point = scale * rotation * local point + translation, as complex numbers
+  const std::complex<double> origin_xy(origin_map.x, origin_map.y);
+  const std::complex<double> scaled_rotation =
+    (std::complex<double>(far_map.x, far_map.y) - origin_xy) / local[far];
+  const double error = std::abs(
+    scaled_rotation * local[check] + origin_xy -
+    std::complex<double>(check_map.x, check_map.y));
+  if (error > local_gps_conversion_tolerance_) {
+    RCLCPP_WARN(
+      this->get_logger(),
+      "Local GPS conversion is off by %.3f m, converting every waypoint with fromLL", error);
+    return false;
+  }
+
+  poses.clear();
+  poses.reserve(gps_poses.size());
+  const rclcpp::Time stamp = this->now();
+  for (size_t i = 0; i < gps_poses.size(); ++i) {
+    const std::complex<double> map_xy = scaled_rotation * local[i] + origin_xy;
+    geometry_msgs::msg::PoseStamped curr_pose_map_frame;
+    curr_pose_map_frame.header.frame_id = global_frame_id_;
+    curr_pose_map_frame.header.stamp = stamp;
+    curr_pose_map_frame.pose.position.x = map_xy.real();
+    curr_pose_map_frame.pose.position.y = map_xy.imag();
+    curr_pose_map_frame.pose.position.z =
+      origin_map.z + gps_poses[i].position.altitude - origin.altitude;
+    curr_pose_map_frame.pose.orientation = gps_poses[i].orientation;
+    poses.push_back(curr_pose_map_frame);
+  }
+  return true;
+}
+
+bool WaypointFollower::convertGPSPoseWithService(
+  const geographic_msgs::msg::GeoPose & gps_pose, geometry_msgs::msg::Point & map_point)
+{
+  auto request = std::make_shared<robot_localization::srv::FromLL::Request>();
+  auto response = std::make_shared<robot_localization::srv::FromLL::Response>();
+  request->ll_point.latitude = gps_pose.position.latitude;
+  request->ll_point.longitude = gps_pose.position.longitude;
+  request->ll_point.altitude = gps_pose.position.altitude;
+
+  from_ll_to_map_client_->wait_for_service((std::chrono::seconds(1)));
+  if (!from_ll_to_map_client_->invoke(request, response)) {
+    return false;
+  }
+  map_point = response->map_point;
+  return true;
+}
+
 }  // namespace nav2_waypoint_follower
 
 #include "rclcpp_components/register_node_macro.hpp"
@@ -162,3 +162,37 @@ TEST(WaypointFollowerTest, PhotoAtWaypoint)
   // plugin is not enabled, should exit
   EXPECT_TRUE(paw->processAtWaypoint(pose, 0));
 }
+
+TEST(WaypointFollowerTest, PhotoAtWaypointAsync)
+{
+  auto node = std::make_shared<rclcpp_lifecycle::LifecycleNode>("testWaypointNode");
+  node->declare_parameter("PAW.async_save", true);
+  node->declare_parameter("PAW.save_queue_size", 1);
+
+  std::unique_ptr<nav2_waypoint_follower::PhotoAtWaypoint> paw(
+    new nav2_waypoint_follower::PhotoAtWaypoint
+  );
+  paw->initialize(node, std::string("PAW"));
+
+  // no images, fails before queueing anything
+  geometry_msgs::msg::PoseStamped pose;
+  pose.header.stamp.sec = 42;
+  EXPECT_FALSE(paw->processAtWaypoint(pose, 0));
+
+  auto msg = std::make_shared<sensor_msgs::msg::Image>();
+  msg->encoding = "rgb8";
+  msg->height = 240;
+  msg->width = 320;
+  msg->step = 960;
+  msg->data.resize(msg->height * msg->step, 128);
+  paw->imageCallback(msg);
+
+  // queue is bounded to a single photo, capturing waits for the previous one
+  std::filesystem::remove("/tmp/waypoint_images/1_42.png");
+  std::filesystem::remove("/tmp/waypoint_images/2_42.png");
+  EXPECT_TRUE(paw->processAtWaypoint(pose, 1));
+  EXPECT_TRUE(paw->processAtWaypoint(pose, 2));
+  paw->waitForSaves();
+  EXPECT_TRUE(std::filesystem::exists("/tmp/waypoint_images/1_42.png"));
+  EXPECT_TRUE(std::filesystem::exists("/tmp/waypoint_images/2_42.png"));
+}